@@ -0,0 +1,200 @@
+import functools
+import operator
+import os
+import os.path
+import sys
+import numpy as np
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Data
+np.random.seed(20261014)
+_num_queries = 5
+_num_keys = 7
+_num_heads = 2
+_head_size = 3
+_vector_size = _num_heads * _head_size
+_query_size = _num_queries * _vector_size
+_key_size = _num_keys * _vector_size
+_sample_size = _query_size + 2 * _key_size
+_num_samples = 11
+_samples = np.random.normal(size=(_num_samples,_sample_size)).astype(np.float32)
+
+# Sample access functions
+def get_sample(index):
+    return _samples[index,:]
+def num_samples():
+    return _num_samples
+def sample_dims():
+    return (_sample_size,)
+
+# ==============================================
+# NumPy implementation
+# ==============================================
+
+def numpy_attention(q, k, v, causal):
+    q = q.astype(np.float64).reshape(_num_queries, _num_heads, _head_size)
+    k = k.astype(np.float64).reshape(_num_keys, _num_heads, _head_size)
+    v = v.astype(np.float64).reshape(_num_keys, _num_heads, _head_size)
+    y = np.zeros(q.shape)
+    for h in range(_num_heads):
+        s = np.matmul(q[:,h,:], k[:,h,:].T) / np.sqrt(_head_size)
+        if causal:
+            mask = np.triu(np.ones(s.shape, dtype=bool), k=1)
+            s[mask] = -np.inf
+        p = np.exp(s - np.max(s, axis=1, keepdims=True))
+        p /= np.sum(p, axis=1, keepdims=True)
+        y[:,h,:] = np.matmul(p, v[:,h,:])
+    return y.reshape(_num_queries, _vector_size)
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, weekly):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    mini_batch_size = num_samples() // 2
+    trainer = lbann.Trainer(mini_batch_size)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer, None # Don't request any specific number of nodes
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Input data
+    # Note: Sum with a weights layer so that gradient checking will
+    # verify that error signals are correct.
+    x_weights = lbann.Weights(optimizer=lbann.SGD(),
+                              initializer=lbann.ConstantInitializer(value=0.0),
+                              name='input_weights')
+    x = lbann.Sum(lbann.Input(data_field='samples'),
+                  lbann.WeightsLayer(weights=x_weights,
+                                     dims=[_sample_size]))
+    x_slice = lbann.Slice(x,
+                          slice_points=[0,
+                                        _query_size,
+                                        _query_size+_key_size,
+                                        _sample_size])
+    q = lbann.Reshape(x_slice, dims=[_num_queries, _vector_size])
+    k = lbann.Reshape(x_slice, dims=[_num_keys, _vector_size])
+    v = lbann.Reshape(x_slice, dims=[_num_keys, _vector_size])
+    x_lbann = x
+
+    # Objects for LBANN model
+    obj = []
+    metrics = []
+    callbacks = []
+
+    for causal in (False, True):
+        name = 'causal' if causal else 'non-causal'
+
+        # LBANN implementation
+        y = lbann.Attention(q, k, v,
+                            num_heads=_num_heads,
+                            causal=causal,
+                            data_layout='data_parallel')
+        z = lbann.L2Norm2(y)
+        obj.append(z)
+        metrics.append(lbann.Metric(z, name=name))
+
+        # NumPy implementation
+        vals = []
+        for i in range(num_samples()):
+            x = get_sample(i)
+            y = numpy_attention(x[:_query_size],
+                                x[_query_size:_query_size+_key_size],
+                                x[_query_size+_key_size:],
+                                causal)
+            z = tools.numpy_l2norm2(y)
+            vals.append(z)
+        val = np.mean(vals)
+        tol = 8 * val * np.finfo(np.float32).eps
+        callbacks.append(lbann.CallbackCheckMetric(
+            metric=metrics[-1].name,
+            lower_bound=val-tol,
+            upper_bound=val+tol,
+            error_on_failure=True,
+            execution_modes='test'))
+
+    # ------------------------------------------
+    # Gradient checking
+    # ------------------------------------------
+
+    callbacks.append(lbann.CallbackCheckGradients(error_on_failure=True))
+
+    # ------------------------------------------
+    # Construct model
+    # ------------------------------------------
+
+    num_epochs = 0
+    return lbann.Model(num_epochs,
+                       layers=lbann.traverse_layer_graph(x_lbann),
+                       objective_function=obj,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Note: The training data reader should be removed when
+    # https://github.com/LLNL/lbann/issues/1098 is resolved.
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train'
+        )
+    ])
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'test'
+        )
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+# Create test functions that can interact with PyTest
+for _test_func in tools.create_tests(setup_experiment, __file__):
+    globals()[_test_func.__name__] = _test_func
@@ -204,6 +204,66 @@ def construct_model(lbann):
         error_on_failure=True,
         execution_modes='test'))
 
+    # ------------------------------------------
+    # NN GEMM with broadcast first input
+    # ------------------------------------------
+
+    # LBANN implementation
+    x0 = lbann.Reshape(x0_lbann, dims=[_N*_m, _k])
+    x1 = lbann.Reshape(x1_lbann, dims=[_N, _k, _n])
+    y = lbann.MatMul(x0, x1, data_layout='data_parallel')
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='NN GEMM with broadcast'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = get_sample(i).astype(np.float64)
+        x0 = x[:_N*_m*_k].reshape([_N*_m,_k])
+        x1 = x[_N*_m*_k:].reshape([_N,_k,_n])
+        y = np.matmul(x0, x1)
+        z = tools.numpy_l2norm2(y)
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    # ------------------------------------------
+    # TN GEMM with broadcast second input
+    # ------------------------------------------
+
+    # LBANN implementation
+    x0 = lbann.Reshape(x0_lbann, dims=[_N, _k, _m])
+    x1 = lbann.Reshape(x1_lbann, dims=[1, _k, _N*_n])
+    y = lbann.MatMul(x0, x1, transpose_a=True, data_layout='data_parallel')
+    z = lbann.L2Norm2(y)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='TN GEMM with broadcast'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = get_sample(i).astype(np.float64)
+        x0 = x[:_N*_m*_k].reshape([_N,_k,_m])
+        x1 = x[_N*_m*_k:].reshape([1,_k,_N*_n])
+        y = np.matmul(x0.transpose((0,2,1)), x1)
+        z = tools.numpy_l2norm2(y)
+        vals.append(z)
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
     # ------------------------------------------
     # Gradient checking
     # ------------------------------------------
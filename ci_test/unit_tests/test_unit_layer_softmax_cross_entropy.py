@@ -0,0 +1,219 @@
+import functools
+import operator
+import os
+import os.path
+import sys
+import numpy as np
+
+# Bamboo utilities
+current_file = os.path.realpath(__file__)
+current_dir = os.path.dirname(current_file)
+sys.path.insert(0, os.path.join(os.path.dirname(current_dir), 'common_python'))
+import tools
+
+# ==============================================
+# Objects for Python data reader
+# ==============================================
+# Note: The Python data reader imports this file as a module and calls
+# the functions below to ingest data.
+
+# Data
+np.random.seed(202310141)
+NUM_CLASSES = 1031
+NUM_SAMPLES = 23
+_logits = np.random.normal(size=(NUM_SAMPLES, NUM_CLASSES)).astype(np.float32)
+_truth = np.random.uniform(size=(NUM_SAMPLES, NUM_CLASSES)).astype(np.float32)
+_truth /= _truth.sum(axis=1, keepdims=True)
+_labels = np.random.randint(NUM_CLASSES, size=(NUM_SAMPLES, 1)).astype(np.float32)
+
+# Sample access functions
+def get_sample(index):
+    return np.concatenate([_logits[index], _truth[index], _labels[index]])
+def num_samples():
+    return NUM_SAMPLES
+def sample_dims():
+    return (2*NUM_CLASSES + 1,)
+
+# ==============================================
+# NumPy softmax cross entropy
+# ==============================================
+
+def numpy_log_softmax(x):
+    """Log-softmax, computed with NumPy
+
+    The computation is performed with 64-bit floats.
+
+    """
+    if x.dtype is not np.float64:
+        x = x.astype(np.float64)
+    shift = np.max(x)
+    return x - shift - np.log(np.sum(np.exp(x - shift)))
+
+# ==============================================
+# Setup LBANN experiment
+# ==============================================
+
+def setup_experiment(lbann, weekly):
+    """Construct LBANN experiment.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+    mini_batch_size = num_samples() // 2
+    trainer = lbann.Trainer(mini_batch_size)
+    model = construct_model(lbann)
+    data_reader = construct_data_reader(lbann)
+    optimizer = lbann.NoOptimizer()
+    return trainer, model, data_reader, optimizer, None # Don't request any specific number of nodes
+
+def construct_model(lbann):
+    """Construct LBANN model.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Input data
+    # Note: Sum with weights layers so that gradient checking will
+    # verify that error signals are correct.
+    x_weights = lbann.Weights(optimizer=lbann.SGD(),
+                              initializer=lbann.ConstantInitializer(value=0.0),
+                              name='input_weights')
+    y_weights = lbann.Weights(optimizer=lbann.SGD(),
+                              initializer=lbann.ConstantInitializer(value=0.0),
+                              name='truth_weights')
+    x_slice = lbann.Slice(
+        lbann.Input(data_field='samples'),
+        slice_points=[0, NUM_CLASSES, 2*NUM_CLASSES, 2*NUM_CLASSES+1])
+    x = lbann.Sum(x_slice,
+                  lbann.WeightsLayer(weights=x_weights, dims=[NUM_CLASSES]))
+    y = lbann.Sum(x_slice,
+                  lbann.WeightsLayer(weights=y_weights, dims=[NUM_CLASSES]))
+    labels = lbann.Identity(x_slice)
+    x_lbann = x
+    y_lbann = y
+
+    # Objects for LBANN model
+    obj = []
+    metrics = []
+    callbacks = []
+
+    # ------------------------------------------
+    # Ground truth distribution
+    # ------------------------------------------
+
+    # LBANN implementation
+    z = lbann.SoftmaxCrossEntropy(x_lbann, y_lbann,
+                                  data_layout='data_parallel')
+    z = lbann.L2Norm2(z)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='distribution'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = _logits[i].astype(np.float64)
+        y = _truth[i].astype(np.float64)
+        z = -np.inner(y, numpy_log_softmax(x))
+        vals.append(tools.numpy_l2norm2(z))
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    # ------------------------------------------
+    # Class labels
+    # ------------------------------------------
+
+    # LBANN implementation
+    z = lbann.SoftmaxCrossEntropy(x_lbann, labels,
+                                  use_labels=True,
+                                  data_layout='data_parallel')
+    z = lbann.L2Norm2(z)
+    obj.append(z)
+    metrics.append(lbann.Metric(z, name='labels'))
+
+    # NumPy implementation
+    vals = []
+    for i in range(num_samples()):
+        x = _logits[i].astype(np.float64)
+        label = int(_labels[i][0])
+        z = -numpy_log_softmax(x)[label]
+        vals.append(tools.numpy_l2norm2(z))
+    val = np.mean(vals)
+    tol = 8 * val * np.finfo(np.float32).eps
+    callbacks.append(lbann.CallbackCheckMetric(
+        metric=metrics[-1].name,
+        lower_bound=val-tol,
+        upper_bound=val+tol,
+        error_on_failure=True,
+        execution_modes='test'))
+
+    # ------------------------------------------
+    # Gradient checking
+    # ------------------------------------------
+
+    callbacks.append(lbann.CallbackCheckGradients(error_on_failure=True))
+
+    # ------------------------------------------
+    # Construct model
+    # ------------------------------------------
+
+    num_epochs = 0
+    return lbann.Model(num_epochs,
+                       layers=lbann.traverse_layer_graph(x_lbann),
+                       objective_function=obj,
+                       metrics=metrics,
+                       callbacks=callbacks)
+
+def construct_data_reader(lbann):
+    """Construct Protobuf message for Python data reader.
+
+    The Python data reader will import the current Python file to
+    access the sample access functions.
+
+    Args:
+        lbann (module): Module for LBANN Python frontend
+
+    """
+
+    # Note: The training data reader should be removed when
+    # https://github.com/LLNL/lbann/issues/1098 is resolved.
+    message = lbann.reader_pb2.DataReader()
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'train'
+        )
+    ])
+    message.reader.extend([
+        tools.create_python_data_reader(
+            lbann,
+            current_file,
+            'get_sample',
+            'num_samples',
+            'sample_dims',
+            'test'
+        )
+    ])
+    return message
+
+# ==============================================
+# Setup PyTest
+# ==============================================
+
+# Create test functions that can interact with PyTest
+# Note: Create test name by removing ".py" from file name
+_test_name = os.path.splitext(os.path.basename(current_file))[0]
+for _test_func in tools.create_tests(setup_experiment, _test_name):
+    globals()[_test_func.__name__] = _test_func
@@ -39,9 +39,17 @@
 #include <conduit/conduit_schema.hpp>
 #include <conduit/conduit_utils.hpp>
 
+#include <mpi.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -50,6 +58,7 @@ using namespace std;
 
 string const sample_list_inclusive_fn("inclusive.sample_list");
 string const sample_list_exclusive_fn("exclusive.sample_list");
+string const sample_list_binary_fn("inclusive.sample_list.bin");
 string const yaml_fn("data_schema.yaml");
 
 Node build_node_from_file(string const& filename, string const& protocol = "")
@@ -62,22 +71,60 @@ Node build_node_from_file(string const& filename, string const& protocol = "")
   return node;
 }
 
+// Files are dealt out round-robin so that consecutive (often similarly
+// sized) files land on different ranks.
 map<string, vector<string>> get_all_sample_ids(conduit::Schema const& schema,
                                                vector<string> const& filelist,
-                                               std::string const& protocol)
+                                               std::string const& protocol,
+                                               int rank,
+                                               int num_ranks)
 {
   map<string, vector<string>> sample_ids;
-  for (auto const& filename : filelist) {
+  for (size_t i = rank; i < filelist.size(); i += num_ranks) {
+    auto const& filename = filelist[i];
     if (filename.size() < 2) {
       continue;
     }
-    cout << "  loading: " << filename << endl;
+    cout << "  [" << rank << "] loading: " << filename << endl;
     Node nd = build_node_from_file(filename, protocol);
     sample_ids[filename] = data_utils::get_matching_node_paths(nd, schema);
   }
   return sample_ids;
 }
 
+// Merge every rank's sample IDs into sample_ids on rank 0.
+void gather_sample_ids(map<string, vector<string>> const& local_ids,
+                       map<string, vector<string>>& sample_ids,
+                       int rank,
+                       int num_ranks)
+{
+  string const buffer = data_utils::pack_sample_ids(local_ids);
+  int const size = static_cast<int>(buffer.size());
+  vector<int> sizes(rank == 0 ? num_ranks : 0);
+  MPI_Gather(&size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  vector<int> displs(sizes.size(), 0);
+  for (size_t i = 1; i < sizes.size(); ++i) {
+    displs[i] = displs[i - 1] + sizes[i - 1];
+  }
+  string all_buffers;
+  if (rank == 0) {
+    all_buffers.resize(displs.back() + sizes.back());
+  }
+  MPI_Gatherv(buffer.data(),
+              size,
+              MPI_CHAR,
+              all_buffers.data(),
+              sizes.data(),
+              displs.data(),
+              MPI_CHAR,
+              0,
+              MPI_COMM_WORLD);
+  if (rank == 0) {
+    data_utils::unpack_sample_ids(all_buffers, sample_ids);
+  }
+}
+
 void print_leading_spaces(ostream& out, size_t n) { out << string(n, ' '); }
 
 bool is_leaf(Node const& nd) noexcept { return nd.number_of_children() == 0L; }
@@ -186,6 +233,144 @@ void write_inclusive_sample_list(ostream& out,
   }
 }
 
+// Must match lbann::sample_list_binary_header (see
+// tools/convert_sample_list.cpp)
+struct sample_list_binary_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t num_files;
+  uint64_t num_samples;
+  uint64_t files_offset;
+  uint64_t samples_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t file_dir;
+  uint64_t file_dir_length;
+  uint64_t label_filename;
+  uint64_t label_filename_length;
+  uint64_t reserved[4];
+};
+static_assert(sizeof(sample_list_binary_header) == 128,
+              "unexpected header size");
+
+// Must match lbann::sample_list_binary_flags
+uint32_t const multi_sample = 1u;
+uint32_t const integral_names = 2u;
+uint32_t const unused_sample_fields = 4u;
+
+// Must match lbann::sample_list_binary_file
+struct sample_list_binary_file
+{
+  uint64_t name;
+  uint32_t name_length;
+  uint32_t reserved;
+  uint64_t first_sample;
+};
+
+struct sample_record
+{
+  uint64_t value;
+  uint64_t length;
+};
+
+bool is_integer(string const& s)
+{
+  size_t i = (!s.empty() && s[0] == '-') ? 1 : 0;
+  if (i == s.size() || s.size() - i > 18) {
+    return false;
+  }
+  for (; i < s.size(); ++i) {
+    if (!isdigit(static_cast<unsigned char>(s[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void write_padded(ostream& out, void const* data, size_t size)
+{
+  static char const zeros[8] = {};
+  out.write(static_cast<char const*>(data), size);
+  out.write(zeros, (8 - size % 8) % 8);
+}
+
+// Write the inclusive sample list in the indexed binary format, so
+// that readers can locate any file's samples without parsing the
+// whole list.
+void write_binary_sample_list(ostream& out,
+                              map<string, vector<string>> const& sample_ids,
+                              string const& base_dir)
+{
+  sample_list_binary_header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "LBSMPLST", sizeof(h.magic));
+  h.version = 1;
+  h.flags = multi_sample | unused_sample_fields;
+
+  bool all_integers = true;
+  for (auto const& t : sample_ids) {
+    all_integers = all_integers && all_of(t.second.cbegin(),
+                                          t.second.cend(),
+                                          is_integer);
+  }
+  if (all_integers) {
+    h.flags |= integral_names;
+  }
+
+  string strings(base_dir);
+  h.file_dir_length = base_dir.size();
+  size_t const idx = (base_dir == "." ? 0 : base_dir.size());
+
+  vector<sample_list_binary_file> files;
+  vector<sample_record> samples;
+  vector<int64_t> values;
+  files.reserve(sample_ids.size() + 1);
+  for (auto const& [filename, ids] : sample_ids) {
+    sample_list_binary_file f = {};
+    f.name = strings.size();
+    f.name_length = filename.size() - idx;
+    f.first_sample = (all_integers ? values.size() : samples.size());
+    strings.append(filename, idx, string::npos);
+    files.push_back(f);
+    for (auto const& sample_id : ids) {
+      if (all_integers) {
+        values.push_back(stoll(sample_id));
+      }
+      else {
+        samples.push_back({strings.size(), sample_id.size()});
+        strings += sample_id;
+      }
+    }
+  }
+
+  h.num_files = files.size();
+  h.num_samples = (all_integers ? values.size() : samples.size());
+  sample_list_binary_file end = {};
+  end.first_sample = h.num_samples;
+  files.push_back(end);
+
+  size_t const sample_size =
+    (all_integers ? sizeof(int64_t) : sizeof(sample_record));
+  auto padded = [](size_t n) { return (n + 7) / 8 * 8; };
+  h.files_offset = sizeof(h);
+  h.samples_offset =
+    h.files_offset + padded(files.size() * sizeof(sample_list_binary_file));
+  h.strings_offset = h.samples_offset + padded(h.num_samples * sample_size);
+  h.strings_size = strings.size();
+
+  out.write(reinterpret_cast<char const*>(&h), sizeof(h));
+  write_padded(out, files.data(), files.size() * sizeof(files[0]));
+  if (all_integers) {
+    write_padded(out, values.data(), values.size() * sizeof(values[0]));
+  }
+  else {
+    write_padded(out, samples.data(), samples.size() * sizeof(samples[0]));
+  }
+  out.write(strings.data(), strings.size());
+}
+
 // get vector containing hdf5 filenames
 vector<string> get_file_names(std::string const& file_list_file_name)
 {
@@ -201,11 +386,13 @@ vector<string> get_file_names(std::string const& file_list_file_name)
   return file_list;
 }
 
-int main(int argc, char** argv)
+int run(int argc, char** argv, int rank, int num_ranks)
 {
   string filelist;
   string sample_id;
   string protocol;
+  string existing_list;
+  bool write_binary = false;
   bool print_help = false;
 
   auto cli =
@@ -217,87 +404,178 @@ int main(int argc, char** argv)
       "The path to a prototypical sample in the first HDF5 file")
       .required() |
     clara::Opt(protocol, "data protocol")["-p"]["--protocol"](
-      "The conduit-compatible protocol string for these files");
+      "The conduit-compatible protocol string for these files") |
+    clara::Opt(existing_list, "inclusive sample list")["-u"]["--update"](
+      "Only scan files that are not already in this inclusive sample list "
+      "and write the merged sample lists; the schema is not rewritten") |
+    clara::Opt(write_binary)["-b"]["--binary"](
+      "Also write the inclusive sample list in the indexed binary format");
 
   auto result = cli.parse({argc, argv});
   if (!result) {
-    cerr << "Error: Parsing arguments failed with message: "
-         << result.errorMessage() << endl;
+    if (rank == 0) {
+      cerr << "Error: Parsing arguments failed with message: "
+           << result.errorMessage() << endl;
+    }
     return EXIT_FAILURE;
   }
 
   if (print_help || sample_id.empty() || filelist.empty()) {
-    auto const& exe_name = cli.m_exeName.name();
-    cout << cli << endl
-         << "example invocations:\n"
-         << "  " << exe_name << " filelist_PROBIES.txt RUN_ID/000000000\n"
-         << "  " << exe_name << " filelist_carbon.txt e1/s100\n"
-         << "  " << exe_name << " filelist_jag.txt 0.0.96.7.0:1\n"
-         << endl;
+    if (rank == 0) {
+      auto const& exe_name = cli.m_exeName.name();
+      cout << cli << endl
+           << "example invocations:\n"
+           << "  " << exe_name << " filelist_PROBIES.txt RUN_ID/000000000\n"
+           << "  " << exe_name << " filelist_carbon.txt e1/s100\n"
+           << "  " << exe_name << " filelist_jag.txt 0.0.96.7.0:1\n"
+           << "  mpirun -n 16 " << exe_name
+           << " -b -u inclusive.sample_list filelist_jag.txt 0.0.96.7.0:1\n"
+           << endl;
+    }
     return EXIT_FAILURE;
   }
 
   // Get the list of sample files
   auto const file_names = get_file_names(filelist);
+  if (file_names.empty()) {
+    if (rank == 0) {
+      cerr << "Error: no HDF5 files listed in " << filelist << endl;
+    }
+    return EXIT_FAILURE;
+  }
 
   // Since every file is expected to be the same format, and the list
   // of files may be long, we do this once up front.
   if (protocol.empty())
     conduit::relay::io::identify_protocol(file_names.front(), protocol);
 
-  // Get base directory, which is the longest common prefix
-  string const base_dir = data_utils::get_longest_common_prefix(file_names);
-  cout << "Common base dir: " << base_dir << endl;
-
-  // open output files
+  // When updating, start from the existing list and only scan the
+  // files it does not already cover.
+  map<string, vector<string>> sample_ids;
+  vector<string> new_file_names;
+  try {
+    if (!existing_list.empty()) {
+      ifstream in(existing_list);
+      if (!in) {
+        throw runtime_error("can't open " + existing_list);
+      }
+      sample_ids = data_utils::read_inclusive_sample_list(in);
+    }
+  }
+  catch (exception const& e) {
+    if (rank == 0) {
+      cerr << "Error reading existing sample list:\n" << e.what() << endl;
+    }
+    return EXIT_FAILURE;
+  }
+  copy_if(file_names.cbegin(),
+          file_names.cend(),
+          back_inserter(new_file_names),
+          [&sample_ids](string const& f) { return !sample_ids.count(f); });
+  if (rank == 0 && !existing_list.empty()) {
+    cout << "Found " << sample_ids.size() << " files in " << existing_list
+         << "; scanning " << new_file_names.size() << " new files" << endl;
+  }
 
-  // load the first hdf5 file from the filelist
+  // Every rank needs the prototype schema to match samples in its
+  // share of the files.
+  int status = EXIT_SUCCESS;
+  map<string, vector<string>> local_ids;
   try {
     string const& filename = file_names.front();
 
-    cout << "Searching for sample ID \"" << sample_id
-         << "\" in file: " << filename << endl;
+    if (rank == 0) {
+      cout << "Searching for sample ID \"" << sample_id
+           << "\" in file: " << filename << endl;
+    }
 
     Node node = build_node_from_file(filename, protocol);
     auto const& prototype_sample =
       data_utils::get_prototype_sample(node, sample_id);
 
-    {
+    if (rank == 0 && existing_list.empty()) {
       cout << "Writing yaml file (\"" << yaml_fn << "\")... ";
       ofstream out_yaml(yaml_fn);
       write_yaml_file(out_yaml, prototype_sample);
       cout << "done." << endl;
     }
 
-    // get pathnames for all sample IDs
-    auto sample_ids =
-      get_all_sample_ids(prototype_sample.schema(), file_names, protocol);
+    // get pathnames for the sample IDs in this rank's files
+    local_ids = get_all_sample_ids(prototype_sample.schema(),
+                                   new_file_names,
+                                   protocol,
+                                   rank,
+                                   num_ranks);
+  }
+  catch (conduit::Error const& e) {
+    cerr << "Error detected by Conduit on rank " << rank << ":\n"
+         << e.what() << endl;
+    status = EXIT_FAILURE;
+  }
 
-    // write the sample lists
-    {
-      cout << "Writing exclusive sample list (\"" << sample_list_exclusive_fn
-           << "\")... ";
-      ofstream out_sample_list_exclusive(sample_list_exclusive_fn);
+  // Don't enter the gather unless every rank made it this far.
+  MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  if (status != EXIT_SUCCESS) {
+    return status;
+  }
+  gather_sample_ids(local_ids, sample_ids, rank, num_ranks);
+  if (rank != 0) {
+    return EXIT_SUCCESS;
+  }
 
-      write_exclusive_sample_list(out_sample_list_exclusive,
-                                  sample_ids,
-                                  base_dir);
-      cout << "done." << endl;
-    }
-    {
-      cout << "Writing inclusive sample list (\"" << sample_list_inclusive_fn
-           << "\")... ";
-      ofstream out_sample_list_inclusive(sample_list_inclusive_fn);
-      write_inclusive_sample_list(out_sample_list_inclusive,
-                                  sample_ids,
-                                  base_dir);
-      cout << "done." << endl;
-    }
+  // Get base directory, which is the longest common prefix
+  vector<string> all_file_names;
+  all_file_names.reserve(sample_ids.size());
+  for (auto const& t : sample_ids) {
+    all_file_names.push_back(t.first);
   }
-  catch (conduit::Error const& e) {
-    cerr << "Error detected by Conduit:\n" << e.what() << endl;
-    return EXIT_FAILURE;
+  string const base_dir = data_utils::get_longest_common_prefix(all_file_names);
+  cout << "Common base dir: " << base_dir << endl;
+
+  // write the sample lists
+  {
+    cout << "Writing exclusive sample list (\"" << sample_list_exclusive_fn
+         << "\")... ";
+    ofstream out_sample_list_exclusive(sample_list_exclusive_fn);
+
+    write_exclusive_sample_list(out_sample_list_exclusive,
+                                sample_ids,
+                                base_dir);
+    cout << "done." << endl;
+  }
+  {
+    cout << "Writing inclusive sample list (\"" << sample_list_inclusive_fn
+         << "\")... ";
+    ofstream out_sample_list_inclusive(sample_list_inclusive_fn);
+    write_inclusive_sample_list(out_sample_list_inclusive,
+                                sample_ids,
+                                base_dir);
+    cout << "done." << endl;
+  }
+  if (write_binary) {
+    cout << "Writing binary sample list (\"" << sample_list_binary_fn
+         << "\")... ";
+    ofstream out_sample_list_binary(sample_list_binary_fn, ios::binary);
+    write_binary_sample_list(out_sample_list_binary, sample_ids, base_dir);
+    if (!out_sample_list_binary) {
+      cerr << "Error: failed writing " << sample_list_binary_fn << endl;
+      return EXIT_FAILURE;
+    }
+    cout << "done." << endl;
   }
 
   return EXIT_SUCCESS;
 }
+
+int main(int argc, char** argv)
+{
+  MPI_Init(&argc, &argv);
+  int rank = 0, num_ranks = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &num_ranks);
+
+  int const status = run(argc, argv, rank, num_ranks);
+
+  MPI_Finalize();
+  return status;
+}
@@ -1,6 +1,7 @@
 #include "helpers.hpp"
 
 #include <regex>
+#include <sstream>
 #include <stdexcept>
 
 namespace {
@@ -148,3 +149,81 @@ std::string data_utils::normalize_path(std::string path, char delimiter_char)
     return ".";
   return path;
 }
+
+std::string data_utils::pack_sample_ids(sample_id_map const& sample_ids)
+{
+  std::string buffer;
+  for (auto const& [filename, samples] : sample_ids) {
+    buffer.append(filename).append(1, '\n');
+    buffer.append(std::to_string(samples.size())).append(1, '\n');
+    for (auto const& sample_id : samples)
+      buffer.append(sample_id).append(1, '\n');
+  }
+  return buffer;
+}
+
+void data_utils::unpack_sample_ids(std::string_view const& buffer,
+                                   sample_id_map& sample_ids)
+{
+  using SizeT = std::string_view::size_type;
+  SizeT pos = 0;
+  auto next_line = [&buffer, &pos]() {
+    auto const stop = buffer.find('\n', pos);
+    if (stop == buffer.npos)
+      throw std::runtime_error("truncated sample ID buffer");
+    auto const line = buffer.substr(pos, stop - pos);
+    pos = stop + 1;
+    return line;
+  };
+
+  while (pos < buffer.size()) {
+    auto& samples = sample_ids[std::string(next_line())];
+    auto const count = std::stoull(std::string(next_line()));
+    samples.reserve(samples.size() + count);
+    for (size_t i = 0; i < count; ++i)
+      samples.emplace_back(next_line());
+  }
+}
+
+data_utils::sample_id_map
+data_utils::read_inclusive_sample_list(std::istream& in)
+{
+  std::string type, counts, base_dir;
+  if (!(in >> type) || type != "CONDUIT_HDF5_INCLUSION")
+    throw std::runtime_error("expected a CONDUIT_HDF5_INCLUSION sample list");
+  in >> std::ws;
+  std::getline(in, counts);
+  size_t num_included = 0, num_excluded = 0, num_files = 0;
+  if (!(std::istringstream(counts) >> num_included >> num_excluded >>
+        num_files))
+    throw std::runtime_error("malformed sample list count line");
+  if (!(in >> base_dir))
+    throw std::runtime_error("missing sample list base directory");
+
+  // Relative names keep their leading delimiter (see
+  // get_longest_common_prefix), except when the base is "."
+  std::string const prefix = (base_dir == "." ? "" : base_dir);
+
+  sample_id_map sample_ids;
+  std::string line;
+  while (sample_ids.size() < num_files && std::getline(in, line)) {
+    std::istringstream ss(line);
+    std::string filename;
+    size_t included = 0, excluded = 0;
+    if (!(ss >> filename))
+      continue;
+    if (!(ss >> included >> excluded))
+      throw std::runtime_error("malformed sample list entry for " + filename);
+    auto& samples = sample_ids[normalize_path(prefix + filename)];
+    samples.reserve(included);
+    std::string sample_id;
+    while (ss >> sample_id)
+      samples.push_back(sample_id);
+    if (samples.size() != included)
+      throw std::runtime_error("sample list entry for " + filename +
+                               " has the wrong number of samples");
+  }
+  if (sample_ids.size() != num_files)
+    throw std::runtime_error("sample list has fewer files than its header");
+  return sample_ids;
+}
@@ -4,6 +4,8 @@
 #include <conduit/conduit_node.hpp>
 
 #include <conduit/conduit_schema.hpp>
+#include <istream>
+#include <map>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -44,5 +46,30 @@ std::string get_longest_common_prefix(std::vector<std::string> const& paths);
  */
 std::string normalize_path(std::string path, char delimiter = '/');
 
+/** @brief The sample IDs found in each (normalized) HDF5 file. */
+using sample_id_map = std::map<std::string, std::vector<std::string>>;
+
+/** @brief Serialize a sample ID map into a flat buffer.
+ *
+ *  The buffer is newline-delimited: for each file, its name, the
+ *  number of samples and then one sample ID per line. This is used to
+ *  ship per-rank results to the root rank.
+ */
+std::string pack_sample_ids(sample_id_map const& sample_ids);
+
+/** @brief Add the contents of a buffer produced by pack_sample_ids to
+ *         the given map.
+ *  @throws std::runtime_error if the buffer is truncated.
+ */
+void unpack_sample_ids(std::string_view const& buffer,
+                       sample_id_map& sample_ids);
+
+/** @brief Read a CONDUIT_HDF5_INCLUSION sample list.
+ *  @details File names are prefixed with the list's base directory so
+ *           that they match the names produced by normalize_path.
+ *  @throws std::runtime_error if the list is malformed.
+ */
+sample_id_map read_inclusive_sample_list(std::istream& in);
+
 } // namespace data_utils
 #endif // LBANN_DATA_UTILS_HDF5_HELPERS_HPP_INCLUDED
@@ -30,7 +30,9 @@
 #endif // LBANN_USE_CATCH2_V3
 
 #include <conduit/conduit_error.hpp>
+#include <iterator>
 #include <regex>
+#include <sstream>
 
 #include "helpers.hpp"
 
@@ -177,3 +179,97 @@ TEST_CASE("Splitting a string", "[data_utils][string]")
     CHECK(tokens == correct);
   }
 }
+
+TEST_CASE("Packing sample IDs", "[data_utils][sample_list]")
+{
+  data_utils::sample_id_map const ids = {
+    {"/a/b/file_1.h5", {"RUN_ID/000", "RUN_ID/001"}},
+    {"/a/b/file_2.h5", {}},
+    {"/a/c/file_3.h5", {"e1/s100"}}};
+
+  SECTION("round trip")
+  {
+    data_utils::sample_id_map out;
+    data_utils::unpack_sample_ids(data_utils::pack_sample_ids(ids), out);
+    CHECK(out == ids);
+  }
+
+  SECTION("merging buffers from several ranks")
+  {
+    data_utils::sample_id_map first, second, out;
+    first.insert(*ids.begin());
+    second.insert(std::next(ids.begin()), ids.end());
+    data_utils::unpack_sample_ids(data_utils::pack_sample_ids(second), out);
+    data_utils::unpack_sample_ids(data_utils::pack_sample_ids(first), out);
+    CHECK(out == ids);
+  }
+
+  SECTION("empty buffer")
+  {
+    data_utils::sample_id_map out;
+    data_utils::unpack_sample_ids("", out);
+    CHECK(out.empty());
+  }
+
+  SECTION("truncated buffer")
+  {
+    auto const buffer = data_utils::pack_sample_ids(ids);
+    data_utils::sample_id_map out;
+    CHECK_THROWS(data_utils::unpack_sample_ids(
+      std::string_view(buffer).substr(0, buffer.size() - 1),
+      out));
+  }
+}
+
+TEST_CASE("Reading inclusive sample lists", "[data_utils][sample_list]")
+{
+  SECTION("rooted base directory")
+  {
+    std::istringstream in("CONDUIT_HDF5_INCLUSION\n"
+                          "3 0 2\n"
+                          "/p/vast1/data\n"
+                          "/file_1.h5 2 0 runid/002 runid/005\n"
+                          "/run2/file_2.h5 1 0 runid/000\n");
+    data_utils::sample_id_map const correct = {
+      {"/p/vast1/data/file_1.h5", {"runid/002", "runid/005"}},
+      {"/p/vast1/data/run2/file_2.h5", {"runid/000"}}};
+    CHECK(data_utils::read_inclusive_sample_list(in) == correct);
+  }
+
+  SECTION("current directory base")
+  {
+    std::istringstream in("CONDUIT_HDF5_INCLUSION\n"
+                          "1 0 1\n"
+                          ".\n"
+                          "file_1.h5 1 0 e1/s100\n");
+    data_utils::sample_id_map const correct = {{"file_1.h5", {"e1/s100"}}};
+    CHECK(data_utils::read_inclusive_sample_list(in) == correct);
+  }
+
+  SECTION("wrong list type")
+  {
+    std::istringstream in("CONDUIT_HDF5_EXCLUSION\n"
+                          "1 0 1\n"
+                          ".\n"
+                          "file_1.h5 1 0\n");
+    CHECK_THROWS(data_utils::read_inclusive_sample_list(in));
+  }
+
+  SECTION("sample count mismatch")
+  {
+    std::istringstream in("CONDUIT_HDF5_INCLUSION\n"
+                          "2 0 1\n"
+                          ".\n"
+                          "file_1.h5 2 0 e1/s100\n");
+    CHECK_THROWS(data_utils::read_inclusive_sample_list(in));
+  }
+
+  SECTION("missing files")
+  {
+    std::istringstream in("CONDUIT_HDF5_INCLUSION\n"
+                          "1 0 2\n"
+                          ".\n"
+                          "file_1.h5 1 0 e1/s100\n");
+    CHECK_THROWS(data_utils::read_inclusive_sample_list(in));
+  }
+}
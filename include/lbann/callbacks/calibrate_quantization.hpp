@@ -0,0 +1,109 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_CALIBRATE_QUANTIZATION_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_CALIBRATE_QUANTIZATION_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Post-training int8 quantization of a model for inference
+ *
+ *  Testing the model on a calibration data set records the largest
+ *  magnitude of the input of each convolution and fully connected
+ *  layer (or of the chosen layers). At the end of testing, the
+ *  weights of these layers are rounded to a symmetric int8 grid with
+ *  one scale per output channel (see
+ *  Layer::quantize_inference_weights), so the model computes what an
+ *  int8 deployment would, up to the rounding of its inputs. Biases
+ *  are kept.
+ *
+ *  The trainer master writes the calibration table to @c output_file,
+ *  one line per layer with its name, the input range and scale, and
+ *  the weight scales, for int8 inference runtimes:
+ *
+ *  @verbatim
+ *  <layer> <input range> <input scale> <channels> <scale 0> ...
+ *  @endverbatim
+ *
+ *  The input scale is the range divided by 127.
+ */
+class calibrate_quantization : public callback_base
+{
+public:
+  using callback_base::on_evaluate_forward_prop_end;
+
+  /**
+   *  @param layer_names Layers to quantize. Default: all convolution
+   *                     and fully connected layers.
+   *  @param output_file Calibration table. Default: not written.
+   */
+  calibrate_quantization(std::set<std::string> layer_names,
+                         std::string output_file)
+    : callback_base(1),
+      m_layer_names(std::move(layer_names)),
+      m_output_file(std::move(output_file))
+  {}
+  calibrate_quantization(const calibrate_quantization&) = default;
+  calibrate_quantization&
+  operator=(const calibrate_quantization&) = default;
+  calibrate_quantization* copy() const override
+  {
+    return new calibrate_quantization(*this);
+  }
+  std::string name() const override { return "calibrate quantization"; }
+  void setup(model* m) override;
+  void on_test_begin(model* m) override;
+  void on_evaluate_forward_prop_end(model* m, Layer* l) override;
+  void on_test_end(model* m) override;
+
+private:
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Layers to quantize. */
+  std::set<std::string> m_layer_names;
+  /** Calibration table. */
+  std::string m_output_file;
+  /** Largest input magnitude of each layer seen by this rank. */
+  std::map<std::string, double> m_ranges;
+};
+
+// Builder function
+std::unique_ptr<callback_base> build_calibrate_quantization_callback_from_pbuf(
+  const google::protobuf::Message&,
+  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_CALIBRATE_QUANTIZATION_HPP_INCLUDED
@@ -196,6 +196,14 @@ public:
   /** @brief Return this callback's name. */
   virtual std::string name() const = 0;
 
+  /** @brief Whether the training step may be captured in a GPU graph.
+   *  @details The kernels of a captured step only run after the
+   *  forward prop, backward prop and optimization hooks have
+   *  returned, so callbacks that read or modify tensors in those
+   *  hooks must return false.
+   */
+  virtual bool supports_gpu_graph_capture() const { return true; }
+
   /** @brief Human-readable description. */
   virtual description get_description() const;
 
@@ -57,6 +57,7 @@ public:
   void add_to_set(model* m, Layer* l, int64_t step, std::set<long>& set);
 
   std::string name() const override { return "check data set indices"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
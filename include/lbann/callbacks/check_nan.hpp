@@ -30,6 +30,14 @@
 #define LBANN_CALLBACKS_CALLBACK_CHECK_NAN_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace lbann {
 namespace callback {
@@ -37,6 +45,19 @@ namespace callback {
 /**
  * Check matrices for whether they include any NaNs or infs to help debugging.
  * This will kill the rank if such values are discovered.
+ *
+ * By default every matrix is copied to the host and scanned on every
+ * step, which is too slow to leave on in production. With an
+ * interval, matrices are instead checked where they live, by a kernel
+ * for GPU matrices, which ORs NaN and inf bits into a small buffer
+ * with one flag per layer output and input, weights gradient and
+ * weights. Every @c interval steps the flags are copied to the host
+ * in the background and zeroed, and they are read at the next step,
+ * so the device is not synchronized. A bad value is reported with the
+ * steps it occurred between, and the network is not dumped, since it
+ * has moved on. Weights and their gradients are checked in the steps
+ * that end an interval. With sampling, only @c sample_layers layers
+ * are checked per step, in rotation.
  */
 class check_nan : public callback_base
 {
@@ -44,10 +65,25 @@ public:
   using callback_base::on_backward_prop_end;
   using callback_base::on_forward_prop_end;
 
-  check_nan() = default;
-  check_nan(const check_nan&) = default;
-  check_nan& operator=(const check_nan&) = default;
+  /**
+   *  @param interval Training steps between reads of the flags. Zero
+   *                  checks on the host as values are computed.
+   *  @param sample_layers Layers checked per step with an interval.
+   *                       Zero checks every layer.
+   */
+  check_nan(int interval = 0, int sample_layers = 0)
+    : m_interval(std::max(interval, 0)),
+      m_sample_layers(std::max(sample_layers, 0))
+  {}
+  /** Copies the parameters, not the flags. */
+  check_nan(const check_nan& other)
+    : check_nan(other.m_interval, other.m_sample_layers)
+  {}
+  check_nan& operator=(const check_nan& other);
   check_nan* copy() const override { return new check_nan(*this); }
+  void setup(model* m) override;
+  void on_train_begin(model* m) override;
+  void on_train_end(model* m) override;
   /** Check that activations are good. */
   void on_forward_prop_end(model* m, Layer* l) override;
   /** Check that error signals are good. */
@@ -57,6 +93,7 @@ public:
   /** Check that weights are good. */
   void on_batch_end(model* m) override;
   std::string name() const override { return "check_nan"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
@@ -70,11 +107,70 @@ public:
 private:
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Whether a layer is checked in the current step. */
+  bool is_sampled(size_t layer) const;
+  /** Flag a matrix's non-finite values in a slot. */
+  void flag_nonfinite(const AbsDistMat& mat, size_t slot);
+  /** Copy the flags of the steps before @c step to the host and
+   *  zero them. */
+  void start_read(size_t step);
+  /** Report the flags copied by start_read. */
+  void finish_read(model& m);
+
+  /** Training steps between reads of the flags; zero for host
+   *  checks. */
+  int m_interval;
+  /** Layers checked per step; zero for all. */
+  int m_sample_layers;
+
+  /** Names of the checked matrices, by slot. */
+  std::vector<std::string> m_slot_names;
+  /** Slot of the first output of each layer. Inputs follow the
+   *  outputs. */
+  std::unordered_map<const Layer*, size_t> m_layer_slots;
+  /** Index of each layer, for sampling. */
+  std::unordered_map<const Layer*, size_t> m_layer_indices;
+  /** Slot of the gradient of each weights, followed by its values. */
+  std::unordered_map<const weights*, size_t> m_weights_slots;
+  /** Flags of CPU matrices. */
+  std::vector<int> m_cpu_flags;
+  /** Flags being read. */
+  std::vector<int> m_read_flags;
+  /** Whether a read is in flight. */
+  bool m_reading = false;
+  /** First step of the flags being set. */
+  size_t m_flags_begin = 0;
+  /** Steps of the flags being read, from the first to one past the
+   *  last. */
+  size_t m_read_begin = 0;
+  size_t m_read_end = 0;
+  /** Index of the first layer sampled in the current step. */
+  size_t m_sample_offset = 0;
+#ifdef LBANN_HAS_GPU
+  /** Flags of GPU matrices. */
+  El::Matrix<int, El::Device::GPU> m_device_flags;
+  /** Pinned host copy of the flags being read. */
+  El::Matrix<int, El::Device::CPU> m_host_flags;
+  /** Completes when the flags being read have been copied. */
+  gpu_lib::event_wrapper m_read_event;
+#endif // LBANN_HAS_GPU
 };
 
+#ifdef LBANN_HAS_GPU
+/** OR the NaN (1) and inf (2) bits of a GPU matrix's entries into
+ *  @c flags(slot,0), in stream order. */
+void flag_nonfinite_gpu(const El::Matrix<DataType, El::Device::GPU>& mat,
+                        El::Matrix<int, El::Device::GPU>& flags,
+                        size_t slot);
+/** Zero flags, in stream order. */
+void zero_flags_gpu(El::Matrix<int, El::Device::GPU>& flags);
+#endif // LBANN_HAS_GPU
+
 // Builder function
-LBANN_ADD_DEFAULT_CALLBACK_BUILDER(check_nan,
-                                   build_check_nan_callback_from_pbuf)
+std::unique_ptr<callback_base>
+build_check_nan_callback_from_pbuf(const google::protobuf::Message&,
+                                   std::shared_ptr<lbann_summary> const&);
 
 } // namespace callback
 } // namespace lbann
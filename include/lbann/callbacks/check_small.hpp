@@ -59,6 +59,7 @@ public:
   /** Check that weights are good. */
   void on_batch_end(model* m) override;
   std::string name() const override { return "check_small"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
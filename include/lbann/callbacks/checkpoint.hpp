@@ -32,6 +32,12 @@
 #include "lbann/io/persist.hpp"
 #include "lbann/utils/visitor_hooks.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <string>
+#include <vector>
+
 namespace lbann {
 
 // Forward-declarations
@@ -153,6 +159,92 @@ public:
     m_ckpt_dist_steps = ckpt_dist_steps;
   }
 
+  /** @brief Write checkpoints from a background thread.
+   *
+   *  The checkpoint is serialized into host memory, which copies the
+   *  device data, and training resumes while the files are written.
+   *  The "latest" file is only updated once every process of the
+   *  trainer has written its files.
+   */
+  inline void set_async_writes(bool async) { m_async_writes = async; }
+
+  /** @brief Write each rank's distributed checkpoint as one file.
+   *  @details The files of the rank's checkpoint directory are packed
+   *  into a file container with an index, so a checkpoint creates one
+   *  file per rank instead of one per component. Restarts read both
+   *  layouts.
+   */
+  inline void set_aggregate_files(bool aggregate)
+  {
+    m_aggregate_files = aggregate;
+  }
+
+  /** @brief Copy every n-th distributed checkpoint from the per-rank
+   *         directory to the checkpoint directory.
+   *
+   *  The per-rank directory is typically node-local storage, which is
+   *  fast but lost with its node. Flushed checkpoints are written as
+   *  file containers in the background, and restarts fall back to
+   *  them when the per-rank checkpoint is incomplete. Zero disables
+   *  flushing.
+   */
+  inline void set_flush_interval(size_t interval)
+  {
+    m_flush_interval = interval;
+  }
+
+  /** @brief Have every rank read its part of the model's matrices
+   *         when restarting from a shared checkpoint, rather than the
+   *         trainer master reading and scattering them.
+   */
+  inline void set_parallel_restart(bool parallel)
+  {
+    m_parallel_restart = parallel;
+  }
+
+  /** @brief Have shared checkpoints refer to the values of frozen
+   *         weights written by an earlier checkpoint, as long as they
+   *         have not changed.
+   *  @details Earlier checkpoints must be kept as long as later ones
+   *  refer to them.
+   */
+  inline void set_incremental_weights(bool incremental)
+  {
+    m_incremental_weights = incremental;
+  }
+
+  /** @brief Number of checkpoints that may be written in the
+   *         background at once.
+   *  @details A new checkpoint waits for the oldest one beyond this
+   *  bound, which also bounds the host memory holding snapshots.
+   */
+  inline void set_max_inflight_checkpoints(size_t max_inflight)
+  {
+    m_max_inflight_checkpoints = std::max(max_inflight, size_t{1});
+  }
+
+  /** @brief Stop training at the next step once this file exists.
+   *
+   *  The trainer master checks for the file before each training
+   *  step. When it appears, a shared checkpoint of the current step
+   *  is written and training stops, so that the job can be relaunched
+   *  with a different number of ranks: shared checkpoints do not
+   *  depend on the number of ranks, and the restart resumes at the
+   *  same step. See finish_resize_request.
+   */
+  inline void set_resize_request_file(std::string filename)
+  {
+    m_resize_request_file = std::move(filename);
+  }
+
+  inline const std::string& get_resize_request_file() const
+  {
+    return m_resize_request_file;
+  }
+
+  /** @brief Whether training was stopped by a resize request. */
+  inline bool resize_requested() const { return m_resize_requested; }
+
   inline std::string get_shared_checkpoint_rootdir()
   {
     return get_restart_dir();
@@ -170,6 +262,14 @@ public:
     }
   }
 
+  /** @brief Whether distributed checkpoints are flushed from the
+   *         per-rank directory, see set_flush_interval.
+   */
+  inline bool has_flushed_checkpoints() const
+  {
+    return m_per_rank_dir.length() != 0 && m_flush_interval > 0;
+  }
+
   bool need_checkpoint(model* m, callback_phase phase);
   std::string find_latest_checkpoint(lbann_comm& comm,
                                      const std::string& trainer_name,
@@ -178,7 +278,8 @@ public:
                                      execution_mode& mode,
                                      size_t& epoch,
                                      size_t& step,
-                                     bool& shared);
+                                     bool& shared,
+                                     bool node_local = true);
   bool open_latest_checkpoint(
     lbann_comm& comm,
     const std::string& task_label,
@@ -213,6 +314,47 @@ private:
                             size_t epoch,
                             size_t step);
 
+  /** @brief Write a "latest" file now, or once the background writes
+   *         of the current checkpoint are done.
+   */
+  void record_latest(const std::string& filename,
+                     visitor_hook hook,
+                     execution_mode mode,
+                     size_t epoch,
+                     size_t step);
+  /** @brief Wait for background checkpoints until at most
+   *         @c max_inflight remain, and write their "latest" files.
+   *  @details Collective over the trainer.
+   */
+  void wait_for_checkpoint_writes(lbann_comm& comm, size_t max_inflight);
+  /** @brief Write a distributed checkpoint's file container to the
+   *         checkpoint directory in the background.
+   */
+  void flush_distributed_checkpoint(lbann_comm& comm,
+                                    trainer& t,
+                                    visitor_hook hook,
+                                    execution_mode mode,
+                                    size_t epoch,
+                                    size_t step,
+                                    persist::deferred_file container);
+
+private:
+  /** @brief Arguments of a deferred write_latest. */
+  struct latest_entry
+  {
+    std::string filename;
+    visitor_hook hook;
+    execution_mode mode;
+    size_t epoch;
+    size_t step;
+  };
+  /** @brief A checkpoint being written in the background. */
+  struct inflight_checkpoint
+  {
+    std::shared_future<void> done;
+    std::vector<latest_entry> latest;
+  };
+
 private:
   trainer* m_active_trainer;
   TrainingAlgorithm* m_active_training_algorithm;
@@ -229,6 +371,19 @@ private:
   EvalType m_checkpoint_last;
   bool m_checkpoint_dist;
   bool m_checkpoint_shared;
+  bool m_async_writes = false;
+  bool m_aggregate_files = false;
+  size_t m_flush_interval = 0;
+  bool m_parallel_restart = false;
+  bool m_incremental_weights = false;
+  std::string m_resize_request_file;
+  bool m_resize_requested = false;
+  size_t m_num_distributed_checkpoints = 0;
+  size_t m_max_inflight_checkpoints = 1;
+  /** @brief "latest" files of the checkpoint being taken. */
+  std::vector<latest_entry> m_pending_latest;
+  /** @brief Checkpoints being written, oldest first. */
+  std::deque<inflight_checkpoint> m_inflight;
 
   template <size_t _max_dir_len>
   struct header_t
@@ -57,6 +57,7 @@ public:
   debug& operator=(const debug&) = default;
   debug* copy() const override { return new debug(*this); }
   std::string name() const override { return "debug"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @brief Print that a batch is beginning. */
   void on_batch_begin(model* m) override;
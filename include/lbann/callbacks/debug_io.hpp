@@ -78,6 +78,7 @@ public:
   void print_phase_start(model* m, execution_mode mode);
 
   std::string name() const override { return "debug_io"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
@@ -0,0 +1,188 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_DETECT_STRAGGLERS_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_DETECT_STRAGGLERS_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Report ranks that are persistently slower than the others
+ *
+ *  A slow GPU or node makes every rank wait for it in the gradient
+ *  allreduces, so only an overall slowdown is seen. Each rank times
+ *  its compute in each training step, from the start of forward prop
+ *  to the end of backward prop, which is when the last gradient
+ *  allreduces are started. GPU work is timed with device events on
+ *  the compute stream, resolved a few steps later so the device is
+ *  not synchronized; CPU work with host timestamps.
+ *
+ *  Every @c interval steps the world master gathers the compute time
+ *  of every rank over the last interval. A rank whose time is more
+ *  than @c threshold above the median over all ranks, in
+ *  @c persistence consecutive intervals, is reported with its
+ *  trainer, host and GPU, so the node can be drained. Ranks of all
+ *  trainers are compared, which assumes they train the same model.
+ *
+ *  With @c layers, each layer's forward and backward prop are also
+ *  timed, and a straggler is reported with the layer whose time is
+ *  furthest above that layer's median. All the models must have the
+ *  same layers.
+ */
+class detect_stragglers : public callback_base
+{
+public:
+  /**
+   *  @param interval Training steps between comparisons.
+   *  @param threshold Fraction above the median a straggler's time is.
+   *  @param persistence Consecutive intervals a rank must straggle in
+   *                     before it is reported.
+   *  @param layers Attribute stragglers to layers.
+   */
+  detect_stragglers(int interval,
+                    double threshold,
+                    int persistence,
+                    bool layers)
+    : callback_base(1),
+      m_interval(std::max(interval, 1)),
+      m_threshold(threshold),
+      m_persistence(std::max(persistence, 1)),
+      m_layers(layers)
+  {}
+  /** Copies the parameters, not the measurements. */
+  detect_stragglers(const detect_stragglers& other)
+    : detect_stragglers(other.m_interval,
+                        other.m_threshold,
+                        other.m_persistence,
+                        other.m_layers)
+  {}
+  detect_stragglers& operator=(const detect_stragglers& other);
+  detect_stragglers* copy() const override
+  {
+    return new detect_stragglers(*this);
+  }
+  std::string name() const override { return "detect stragglers"; }
+  bool supports_gpu_graph_capture() const override { return false; }
+  void setup(model* m) override;
+  void on_batch_end(model* m) override;
+  void on_train_end(model* m) override;
+
+  using callback_base::on_backward_prop_begin;
+  using callback_base::on_backward_prop_end;
+  using callback_base::on_forward_prop_begin;
+  using callback_base::on_forward_prop_end;
+
+  void on_forward_prop_begin(model* m) override;
+  void on_backward_prop_end(model* m) override;
+  void on_forward_prop_begin(model* m, Layer* l) override;
+  void on_forward_prop_end(model* m, Layer* l) override;
+  void on_backward_prop_begin(model* m, Layer* l) override;
+  void on_backward_prop_end(model* m, Layer* l) override;
+
+private:
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Start timing a slot: 0 for the step's compute, 1+i for layer i.
+   *  @param device Time with device events. */
+  void begin_interval(size_t slot, bool device);
+  /** Stop timing a slot. */
+  void end_interval(size_t slot, bool device);
+  /** Add the device intervals of the steps before @c step to the
+   *  window. */
+  void resolve_device_intervals(size_t step);
+  /** Gather the window, report stragglers and start a new window. */
+  void compare(model& m);
+
+  /** Training steps between comparisons. */
+  int m_interval;
+  /** Fraction above the median a straggler's time is. */
+  double m_threshold;
+  /** Consecutive straggling intervals before a rank is reported. */
+  int m_persistence;
+  /** Attribute stragglers to layers. */
+  bool m_layers;
+
+  /** Slot of each layer's time. */
+  std::unordered_map<const Layer*, size_t> m_layer_slots;
+  /** Names of the layers, by slot. */
+  std::vector<std::string> m_layer_names;
+  /** Whether the step's compute is timed with device events. */
+  bool m_step_on_device = false;
+  /** Seconds timed in the current window, by slot. */
+  std::vector<double> m_window;
+  /** Host start times of the open intervals, by slot. */
+  std::vector<double> m_host_start;
+  /** Training steps taken. */
+  size_t m_step = 0;
+
+  /** Host names and GPUs of the world ranks; world master only. */
+  std::vector<std::string> m_hosts;
+  std::vector<int> m_gpus;
+  /** Consecutive straggling intervals of each world rank. */
+  std::vector<int> m_strikes;
+
+#ifdef LBANN_HAS_GPU
+  using event_ptr = std::unique_ptr<gpu_lib::event_wrapper>;
+  /** GPU work between two device events. */
+  struct device_interval
+  {
+    size_t slot = 0;
+    /** Step the interval was recorded in. */
+    size_t step = 0;
+    event_ptr start;
+    event_ptr end;
+  };
+  /** Intervals being recorded, by slot. */
+  std::vector<device_interval> m_open;
+  /** Recorded intervals that are not resolved yet. */
+  std::deque<device_interval> m_pending;
+  /** Resolved events, which are reused. */
+  std::vector<event_ptr> m_free_events;
+#endif // LBANN_HAS_GPU
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_detect_stragglers_callback_from_pbuf(
+  const google::protobuf::Message&,
+  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_DETECT_STRAGGLERS_HPP_INCLUDED
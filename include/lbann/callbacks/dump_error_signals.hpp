@@ -51,6 +51,7 @@ public:
     return new dump_error_signals(*this);
   }
   std::string name() const override { return "dump error signals"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** Write error signals to file after each backward prop step. */
   void on_backward_prop_end(model* m, Layer* l) override;
@@ -62,6 +62,7 @@ public:
   dump_gradients* copy() const override { return new dump_gradients(*this); }
   void on_backward_prop_end(model* m) override;
   std::string name() const override { return "dump gradients"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
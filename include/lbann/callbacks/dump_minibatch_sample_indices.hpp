@@ -70,6 +70,7 @@ public:
   void dump_to_file(model* m, Layer* l, int64_t step);
 
   std::string name() const override { return "dump minibatch sample indices"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
@@ -75,6 +75,7 @@ public:
 
   dump_outputs* copy() const override { return new dump_outputs(*this); }
   std::string name() const override { return "dump outputs"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   void on_forward_prop_end(model* m, Layer* l) override
   {
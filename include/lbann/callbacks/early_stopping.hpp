@@ -30,6 +30,8 @@
 #define LBANN_CALLBACKS_EARLY_STOPPING_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/weights/weights_snapshot.hpp"
+#include <memory>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -44,10 +46,12 @@ class early_stopping : public callback_base
 public:
   /**
    * Continue training until score has not improved for patience epochs.
+   * If restore_best is set, the weights with the best score are kept
+   * in memory and restored when training stops early.
    */
-  early_stopping(int64_t patience);
-  early_stopping(const early_stopping&) = default;
-  early_stopping& operator=(const early_stopping&) = default;
+  early_stopping(int64_t patience, bool restore_best = false);
+  early_stopping(const early_stopping& other);
+  early_stopping& operator=(const early_stopping& other);
   early_stopping* copy() const override { return new early_stopping(*this); }
   /** Update validation score and check for early stopping. */
   void on_validation_end(model* m) override;
@@ -75,6 +79,12 @@ private:
   EvalType m_last_score = std::numeric_limits<EvalType>::max();
   /** Current number of epochs without improvement. */
   int64_t m_wait = 0;
+  /** Whether to restore the best weights when stopping. */
+  bool m_restore_best = false;
+  /** Weights with the best score.
+   *  Not copied with the callback, nor checkpointed.
+   */
+  std::unique_ptr<weights_snapshot> m_best_weights;
 };
 
 // Builder function
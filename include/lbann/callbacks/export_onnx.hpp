@@ -54,12 +54,17 @@ public:
    *  @param output_filename Output filename (default = lbann.onnx)
    *  @param debug_string_filename Name of file to which debug string is
    *  printed. If not set, the debug string is not output.
+   *  @param external_data Write the weights values in parallel to
+   *  ONNX external data files instead of the model file.
    */
-  export_onnx(std::string output_filename, std::string debug_string_filename)
+  export_onnx(std::string output_filename,
+              std::string debug_string_filename,
+              bool external_data = false)
     : callback_base(/*batch_interval=*/1),
       m_output_filename{output_filename.size() ? std::move(output_filename)
                                                : std::string("lbann.onnx")},
-      m_debug_string_filename{std::move(debug_string_filename)}
+      m_debug_string_filename{std::move(debug_string_filename)},
+      m_external_data{external_data}
   {}
 
   /** @brief Copy interface */
@@ -81,6 +86,10 @@ private:
   /* @brief option to print onnx debug file. Default = none */
   std::string m_debug_string_filename;
 
+  /* @brief option to write weights values to external data files in
+   * the directory <output_filename>.data. Default = false */
+  bool m_external_data;
+
 }; // class export_onnx
 
 std::unique_ptr<callback_base>
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_EXPORT_TELEMETRY_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_EXPORT_TELEMETRY_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Export production telemetry of the training run
+ *
+ *  Enables the telemetry counters (see lbann/utils/telemetry.hpp),
+ *  which are otherwise not updated, and every @c interval training
+ *  steps, and at the end of each epoch and of training, reduces them
+ *  over the ranks of the trainer. The trainer master exports them to
+ *  @c directory as:
+ *
+ *  - Prometheus text, telemetry.m\<trainer\>.prom, replaced
+ *    atomically so it can be read by a textfile collector at any time.
+ *  - JSON lines, telemetry.m\<trainer\>.jsonl, one object per export
+ *    with the epoch and step it was made at.
+ *
+ *  Counters accumulate over the run. The counters of a rank are
+ *  shared by all its models.
+ */
+class export_telemetry : public callback_base
+{
+public:
+  /**
+   *  @param interval Training steps between exports.
+   *  @param directory Directory the files are written to.
+   *  @param prometheus Write Prometheus text.
+   *  @param json_lines Append JSON lines.
+   */
+  export_telemetry(int interval,
+                   std::string directory,
+                   bool prometheus,
+                   bool json_lines)
+    : callback_base(1),
+      m_interval(std::max(interval, 1)),
+      m_directory(std::move(directory)),
+      m_prometheus(prometheus),
+      m_json_lines(json_lines)
+  {}
+  export_telemetry(const export_telemetry&) = default;
+  export_telemetry& operator=(const export_telemetry&) = default;
+  export_telemetry* copy() const override
+  {
+    return new export_telemetry(*this);
+  }
+  std::string name() const override { return "export telemetry"; }
+  void setup(model* m) override;
+  void on_batch_end(model* m) override;
+  void on_epoch_end(model* m) override;
+  void on_train_end(model* m) override;
+
+private:
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Reduce the counters over the trainer and export them. */
+  void export_values(model& m);
+
+  /** Training steps between exports. */
+  int m_interval;
+  /** Directory the files are written to. */
+  std::string m_directory;
+  /** Write Prometheus text. */
+  bool m_prometheus;
+  /** Append JSON lines. */
+  bool m_json_lines;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_export_telemetry_callback_from_pbuf(
+  const google::protobuf::Message&,
+  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_EXPORT_TELEMETRY_HPP_INCLUDED
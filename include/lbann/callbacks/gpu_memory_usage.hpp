@@ -31,23 +31,53 @@
 
 #include "lbann/callbacks/callback.hpp"
 
+#include <array>
+
 namespace lbann {
 namespace callback {
 
-/** Callback hooks for printing GPU memory usage. */
+/** Callback hooks for printing GPU memory usage.
+ *
+ *  Optionally reports the high-water marks of the GPU memory pool
+ *  in forward prop, backprop and the optimizer, sampled after each
+ *  layer and weights update, and the memory it caches for reuse. It
+ *  can also return the cached memory to the device when switching
+ *  between training and evaluation.
+ */
 class gpu_memory_usage : public callback_base
 {
 public:
   /** Constructor.
+   *  @param phase_high_water Report pool high-water marks per phase.
+   *  @param trim_pool        Trim the pool before and after
+   *                          validation and testing.
    */
-  gpu_memory_usage() = default;
+  gpu_memory_usage(bool phase_high_water = false, bool trim_pool = false)
+    : m_phase_high_water(phase_high_water), m_trim_pool(trim_pool)
+  {}
   gpu_memory_usage(const gpu_memory_usage&) = default;
   gpu_memory_usage& operator=(const gpu_memory_usage&) = default;
   gpu_memory_usage* copy() const override
   {
     return new gpu_memory_usage(*this);
   }
+  bool supports_gpu_graph_capture() const override
+  {
+    return !m_phase_high_water;
+  }
+
+  using callback_base::on_backward_prop_end;
+  using callback_base::on_forward_prop_end;
+  using callback_base::on_optimize_end;
+
   void on_epoch_begin(model* m) override;
+  void on_forward_prop_end(model* m, Layer* l) override;
+  void on_backward_prop_end(model* m, Layer* l) override;
+  void on_optimize_end(model* m, weights* w) override;
+  void on_validation_begin(model* m) override;
+  void on_validation_end(model* m) override;
+  void on_test_begin(model* m) override;
+  void on_test_end(model* m) override;
   std::string name() const override { return "GPU memory usage"; }
 
   /** @name Serialization */
@@ -62,11 +92,37 @@ public:
 private:
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** @brief Phases with separate high-water marks. */
+  enum phase
+  {
+    FORWARD_PROP = 0,
+    BACKWARD_PROP,
+    OPTIMIZER,
+    NUM_PHASES
+  };
+
+  /** @brief Update the high-water mark of a phase. */
+  void sample(phase p);
+  /** @brief Print and reset the high-water marks. */
+  void report_high_water(model* m);
+  /** @brief Return the pool's cached memory to the device. */
+  void trim();
+
+  /** @brief Whether to track pool high-water marks. */
+  bool m_phase_high_water;
+  /** @brief Whether to trim the pool between modes. */
+  bool m_trim_pool;
+  /** @brief Most bytes in use in the pool in each phase since the
+   *         last report.
+   */
+  std::array<size_t, NUM_PHASES> m_high_water = {};
 };
 
 // Builder function
-LBANN_ADD_DEFAULT_CALLBACK_BUILDER(gpu_memory_usage,
-                                   build_gpu_memory_usage_callback_from_pbuf);
+std::unique_ptr<callback_base> build_gpu_memory_usage_callback_from_pbuf(
+  const google::protobuf::Message&,
+  std::shared_ptr<lbann_summary> const&);
 
 } // namespace callback
 } // namespace lbann
@@ -30,8 +30,10 @@
 #define LBANN_CALLBACKS_CALLBACK_IMCOMM_HPP_INCLUDED
 
 #include "lbann/callbacks/callback.hpp"
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 namespace lbann {
@@ -44,6 +46,11 @@ namespace callback {
 /**
  * @brief Support inter-model communication after each mini-batch to
  *        synchronize gradient updates.
+ *
+ * The compressed comm types reduce the bytes exchanged over slow
+ * inter-trainer links. TOPK and POWERSGD keep the part of the
+ * gradient they did not send and add it to the next gradient (error
+ * feedback). Compression is done on the host.
  */
 class imcomm : public callback_base
 {
@@ -54,6 +61,9 @@ public:
   {
     NONE = 0, /** Do no gradient updates. */
     NORMAL,   /** Simply sum gradient updates. */
+    FP16,     /** Sum gradient updates cast to half precision. */
+    TOPK,     /** Sum the largest entries of gradient updates. */
+    POWERSGD, /** Sum low-rank approximations of gradient updates. */
   };
 
   /**
@@ -76,6 +86,15 @@ public:
 
   /** @brief Choose comm type ct for weights. */
   void set_weights_comm(weights* w, comm_type ct);
+  /** @brief Choose comm type ct for the weights with a given name.
+   *  @details Applied when the model is set up.
+   */
+  void set_weights_comm(std::string const& name, comm_type ct);
+
+  /** @brief Fraction of the entries sent by TOPK. */
+  void set_topk_fraction(double fraction);
+  /** @brief Rank of the approximations sent by POWERSGD. */
+  void set_powersgd_rank(El::Int rank);
 
   /** @brief Do initialization for this model. */
   void setup(model* m) override;
@@ -87,6 +106,7 @@ public:
   void on_backward_prop_end(model* m) override;
 
   std::string name() const override { return "imcomm"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
 private:
   /** Add callback specific data to prototext */
@@ -94,7 +114,11 @@ private:
 
   /** @brief Summarize relevant statistics. */
   template <typename T>
-  void do_summary(model const& m, data_type_weights<T>& w, EvalType im_time);
+  void do_summary(model const& m,
+                  data_type_weights<T>& w,
+                  EvalType im_time,
+                  size_t bytes_sent,
+                  size_t bytes_received);
 
 private:
   /** @brief Parameters for a given set of weights. */
@@ -102,11 +126,34 @@ private:
   {
     /** @brief Type of communication done. */
     comm_type ct = NONE;
+    /** @brief Part of the gradient not sent yet (TOPK, POWERSGD). */
+    CPUMat error;
+    /** @brief Right factor of the low-rank approximation, reused as
+     *         the starting point of the next step (POWERSGD).
+     */
+    CPUMat q;
   };
 
+  /** @brief Sum local gradients over trainers with a compressed
+   *         comm type.
+   *  @returns The bytes sent and received.
+   */
+  std::pair<size_t, size_t> compressed_sum(lbann_comm const& comm,
+                                           imcomm_params& params,
+                                           CPUMat& gradient) const;
+
   /** @brief Default communication type. */
   comm_type m_default_ct;
 
+  /** @brief Comm types of weights chosen by name. */
+  std::unordered_map<std::string, comm_type> m_weights_names_ct;
+
+  /** @brief Fraction of the entries sent by TOPK. */
+  double m_topk_fraction = 0.01;
+
+  /** @brief Rank of the approximations sent by POWERSGD. */
+  El::Int m_powersgd_rank = 4;
+
   /** @brief Per-weights parameters. */
   std::unordered_map<weights*, imcomm_params> m_weights_params;
 
@@ -117,6 +164,9 @@ private:
 /** @brief returns a string representation of the weight_initialization */
 std::string get_comm_type_name(typename imcomm::comm_type m);
 
+/** @brief Parse the string representation of a comm type */
+typename imcomm::comm_type get_comm_type(std::string const& name);
+
 // Builder function
 std::unique_ptr<callback_base>
 build_imcomm_callback_from_pbuf(const google::protobuf::Message&,
@@ -89,6 +89,14 @@ protected:
    */
   virtual float optimizer_schedule(model* m, optimizer& opt);
 
+  /**
+   * Whether optimizer_schedule is applied after each mini-batch.
+   * Schedules that only change the learning rate at the end of an
+   * epoch skip the per-step pass, which would read the learning rate
+   * of every optimizer, possibly waiting for the device.
+   */
+  virtual bool has_optimizer_schedule() const { return false; }
+
   const std::unordered_set<weights*>& get_weights() const noexcept
   {
     return m_weights;
@@ -367,6 +375,7 @@ public:
 protected:
   float global_schedule(model* m) override;
   float optimizer_schedule(model* m, optimizer& opt) override;
+  bool has_optimizer_schedule() const override { return true; }
 
 private:
   /** Add callback specific data to prototext */
@@ -417,6 +426,7 @@ public:
 
 protected:
   float optimizer_schedule(model* m, optimizer& opt) override;
+  bool has_optimizer_schedule() const override { return true; }
 
 private:
   /** Add callback specific data to prototext */
@@ -28,6 +28,9 @@
 #define LBANN_CALLBACKS_MIXUP_HPP
 
 #include "lbann/callbacks/callback.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 #include <string>
 #include <unordered_set>
@@ -54,15 +57,30 @@ namespace callback {
  * This recommendation comes from https://docs.fast.ai/callbacks.mixup.html
  *
  * The recommended default alpha (from the paper) is 0.4.
+ *
+ * With @c cutmix, a box of each sample is replaced by the same box
+ * of its partner instead, and labels are mixed by the area of the
+ * box:
+ *
+ *     Yun, S. et al. "CutMix: Regularization Strategy to Train Strong
+ *     Classifiers with Localizable Features." ICCV, 2019.
+ *
+ * The partners, mixing values and boxes are drawn on the host. The
+ * samples and labels are then mixed in one pass on the device that
+ * holds them, so GPU input buffers are not copied to the host.
  */
 class mixup : public callback_base
 {
 public:
-  /** Apply mixup to layers named in layers with mixup parameter alpha. */
-  mixup(std::unordered_set<std::string> layers, float alpha);
+  /** Apply mixup, or cutmix, to layers named in layers with mixup
+   *  parameter alpha. */
+  mixup(std::unordered_set<std::string> layers,
+        float alpha,
+        bool cutmix = false);
 
   mixup* copy() const override { return new mixup(*this); }
   std::string name() const override { return "mixup"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   void on_forward_prop_end(model* m, Layer* l) override;
 
@@ -82,12 +100,56 @@ private:
   friend class cereal::access;
   mixup();
 
+  /** Draw the partner, mixing values and box of each sample. */
+  void draw_parameters(El::Int mbsize, El::Int height, El::Int width);
+
   /** Names of input layers to apply mixup to. */
   std::unordered_set<std::string> m_layers;
   /** mixup parameter. */
   float m_alpha;
+  /** Whether to apply cutmix instead of mixup. */
+  bool m_cutmix;
+
+  /** Partner and box (first row, last row, first column and last
+   *  column, exclusive) of each sample. */
+  El::Matrix<int, El::Device::CPU> m_indices;
+  /** Weights of a sample outside the box and of its label. */
+  CPUMat m_lambdas;
+  /** Copies of the samples and labels being mixed. */
+  CPUMat m_samples_copy;
+  CPUMat m_labels_copy;
+#ifdef LBANN_HAS_GPU
+  GPUMat m_device_samples_copy;
+  GPUMat m_device_labels_copy;
+  /** Device copies of the parameters. */
+  El::Matrix<int, El::Device::GPU> m_device_indices;
+  GPUMat m_device_lambdas;
+  /** Completes when the parameters have been copied to the device. */
+  gpu_lib::event_wrapper m_copy_event;
+  bool m_copying = false;
+#endif // LBANN_HAS_GPU
 };
 
+#ifdef LBANN_HAS_GPU
+/** Mix the samples and labels of a mini-batch in stream order.
+ *
+ *  Column @c i of @c samples becomes
+ *  @c lambdas(0,i)*x1+(1-lambdas(0,i))*x2, except within its box,
+ *  which is @c x2. @c x1 and @c x2 are columns @c i and
+ *  @c indices(0,i) of @c samples_copy. Labels are mixed with
+ *  @c lambdas(1,i). Samples are @c channels x @c height x @c width
+ *  tensors.
+ */
+void apply_mixup_gpu(const GPUMat& samples_copy,
+                     const GPUMat& labels_copy,
+                     GPUMat& samples,
+                     GPUMat& labels,
+                     const El::Matrix<int, El::Device::GPU>& indices,
+                     const GPUMat& lambdas,
+                     El::Int height,
+                     El::Int width);
+#endif // LBANN_HAS_GPU
+
 // Builder function
 std::unique_ptr<callback_base>
 build_mixup_callback_from_pbuf(const google::protobuf::Message&,
@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_MODEL_AVERAGING_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_MODEL_AVERAGING_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/comm_nb_request.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+template <typename T>
+class data_type_weights;
+
+namespace callback {
+
+/** @brief Average weights between trainers every few steps
+ *
+ *  Trainers train independently (local SGD) and average the values
+ *  of their weights every @c interval training steps. Synchronous
+ *  averaging sums the weights over the trainers and replaces them
+ *  with the average. Asynchronous averaging starts the sum in the
+ *  background and keeps training; when the sum arrives, the average
+ *  replaces the values the weights had when it started, keeping the
+ *  updates made since. A sum still in flight at the next averaging
+ *  step, or at the end of training, is waited for.
+ */
+class model_averaging : public callback_base
+{
+public:
+  /**
+   *  @param interval Training steps between averages.
+   *  @param async Average in the background.
+   *  @param weights_names Weights to average. Default is all.
+   */
+  model_averaging(int interval,
+                  bool async,
+                  std::vector<std::string> weights_names = {})
+    : callback_base(1),
+      m_interval(std::max(interval, 1)),
+      m_async(async),
+      m_weights_names(std::move(weights_names))
+  {}
+  /** Copies the parameters, not averages in flight. */
+  model_averaging(const model_averaging& other)
+    : model_averaging(other.m_interval, other.m_async, other.m_weights_names)
+  {}
+  model_averaging& operator=(const model_averaging& other);
+  model_averaging* copy() const override { return new model_averaging(*this); }
+  std::string name() const override { return "model averaging"; }
+  void setup(model* m) override;
+  void on_batch_end(model* m) override;
+  void on_train_end(model* m) override;
+
+private:
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Start summing the values of the weights over the trainers. */
+  void start_average(model& m);
+  /** Finish the sum and apply the average. */
+  void finish_average(model& m);
+
+  /** Training steps between averages. */
+  int m_interval;
+  /** Average in the background. */
+  bool m_async;
+  /** Weights to average. All weights if empty. */
+  std::vector<std::string> m_weights_names;
+
+  /** An average of some weights. */
+  struct average
+  {
+    data_type_weights<DataType>* weights;
+    /** Sum of the values over the trainers. */
+    std::unique_ptr<AbsDistMat> sum;
+    /** Values when the sum started, if asynchronous. */
+    std::unique_ptr<AbsDistMat> start;
+    Al::request req;
+  };
+  std::vector<average> m_averages;
+  /** Whether sums are in flight. */
+  bool m_in_flight = false;
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_model_averaging_callback_from_pbuf(const google::protobuf::Message&,
+                                         std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_MODEL_AVERAGING_HPP_INCLUDED
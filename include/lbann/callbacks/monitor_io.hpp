@@ -51,11 +51,21 @@ public:
   monitor_io(std::vector<std::string> const& layers)
     : m_layers(layers.begin(), layers.end())
   {}
+  /** Also trace every file operation of the data readers and write
+   *  the trace of each rank to @c trace_file.<rank> at the end of
+   *  training and testing. See tools/replay_io_trace.cpp. */
+  monitor_io(std::vector<std::string> const& layers, std::string trace_file)
+    : m_layers(layers.begin(), layers.end()),
+      m_trace_file(std::move(trace_file))
+  {}
 
   monitor_io(const monitor_io&) = default;
   monitor_io& operator=(const monitor_io&) = default;
   monitor_io* copy() const override { return new monitor_io(*this); }
-  /** Report how much I/O has occured per data reader */
+  void setup(model* m) override;
+  void on_train_end(model* m) override;
+  /** Report how much I/O has occured per data reader, and where the
+   *  time of the input pipeline goes */
   void on_epoch_end(model* m) override;
   void on_test_end(model* m) override;
   std::string name() const override { return "monitor_io"; }
@@ -73,8 +83,15 @@ private:
   /** Add callback specific data to prototext */
   void write_specific_proto(lbann_data::Callback& proto) const final;
 
+  /** Print the timings of each I/O stage for an execution mode */
+  void report_io_stages(model* m, execution_mode mode);
+  /** Write the I/O trace recorded so far, if tracing */
+  void write_trace(model* m);
+
   /** Indicies of layers to monitor. */
   std::unordered_set<std::string> m_layers;
+  /** Prefix of the I/O trace files; empty if not tracing */
+  std::string m_trace_file;
 };
 
 // Builder function
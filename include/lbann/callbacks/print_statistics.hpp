@@ -31,6 +31,8 @@
 
 #include "lbann/callbacks/callback.hpp"
 
+#include <map>
+
 namespace lbann {
 namespace callback {
 
@@ -54,7 +56,9 @@ public:
   void setup(model* m) override;
   void on_epoch_begin(model* m) override;
   void on_epoch_end(model* m) override;
+  void on_validation_begin(model* m) override;
   void on_validation_end(model* m) override;
+  void on_test_begin(model* m) override;
   void on_test_end(model* m) override;
   std::string name() const override { return "print_statistics"; }
 
@@ -73,7 +77,15 @@ private:
 
   /** Print objective function and metrics to standard output. */
   void report_results(model* m);
+  /** Record the start of an epoch or evaluation. */
+  void start_io_report(execution_mode mode);
+  /** Print the fraction of step time spent blocked on data. */
+  void report_io_stall(model* m, execution_mode mode);
   bool m_print_global_stat_only;
+  /** Start time of the current epoch or evaluation, per mode. */
+  std::map<execution_mode, double> m_start_time;
+  /** Time blocked on data when the epoch or evaluation started. */
+  std::map<execution_mode, double> m_start_blocked_time;
 };
 
 // Builder function
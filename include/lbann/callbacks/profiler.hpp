@@ -34,7 +34,12 @@
 namespace lbann {
 namespace callback {
 
-/**
+/** @brief Annotate epochs, steps, layers and optimizers as profiling
+ *         regions
+ *
+ *  Regions are NVTX or roctx ranges, or Caliper regions when LBANN is
+ *  built with Caliper. Caliper aggregates regions by name, so epochs
+ *  and steps are not numbered then.
  */
 class profiler : public callback_base
 {
@@ -70,6 +75,7 @@ public:
   void on_optimize_begin(model* m, weights* w) override;
   void on_optimize_end(model* m, weights* w) override;
   std::string name() const override { return "profiler"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   /** @name Serialization */
   ///@{
@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
+#define LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
+
+#include "lbann/callbacks/callback.hpp"
+#include "lbann/layers/layer.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+/** @brief Report the work and achieved throughput of each layer
+ *
+ *  The forward and backward prop of every layer are timed for
+ *  @c num_steps training steps, after @c skip_steps warm-up steps.
+ *  GPU work is timed with device events on the compute stream,
+ *  resolved a step later; CPU work with host timestamps. The work of
+ *  each layer is estimated by its performance model, see
+ *  Layer::get_forward_prop_cost, from its dimensions and data type.
+ *
+ *  The trainer's master then prints one line per layer, sorted by
+ *  share of the time: time per step, floating-point operations and
+ *  bytes moved per step, achieved GFLOP/s and GB/s and arithmetic
+ *  intensity. Rates are per rank, averaged over the trainer. Given
+ *  the device's peak throughputs, the fraction of the peak each
+ *  layer achieves is printed, and whether it is bound by compute or
+ *  by bandwidth in the roofline model. Bandwidth-bound layers with a
+ *  large share of the time are candidates for fusion.
+ */
+class roofline : public callback_base
+{
+public:
+  /**
+   *  @param skip_steps Training steps before timing starts.
+   *  @param num_steps Training steps timed.
+   *  @param peak_gflops Peak GFLOP/s of a rank's device, or 0.
+   *  @param peak_gbps Peak GB/s of a rank's device memory, or 0.
+   */
+  roofline(int skip_steps,
+           int num_steps,
+           double peak_gflops,
+           double peak_gbps)
+    : callback_base(1),
+      m_skip_steps(std::max(skip_steps, 0)),
+      m_num_steps(std::max(num_steps, 1)),
+      m_peak_gflops(peak_gflops),
+      m_peak_gbps(peak_gbps)
+  {}
+  /** Copies the parameters, not the measurements. */
+  roofline(const roofline& other)
+    : roofline(other.m_skip_steps,
+               other.m_num_steps,
+               other.m_peak_gflops,
+               other.m_peak_gbps)
+  {}
+  roofline& operator=(const roofline& other);
+  roofline* copy() const override { return new roofline(*this); }
+  std::string name() const override { return "roofline"; }
+  bool supports_gpu_graph_capture() const override { return false; }
+  void setup(model* m) override;
+  void on_batch_end(model* m) override;
+
+  using callback_base::on_backward_prop_begin;
+  using callback_base::on_backward_prop_end;
+  using callback_base::on_forward_prop_begin;
+  using callback_base::on_forward_prop_end;
+
+  void on_forward_prop_begin(model* m, Layer* l) override;
+  void on_forward_prop_end(model* m, Layer* l) override;
+  void on_backward_prop_begin(model* m, Layer* l) override;
+  void on_backward_prop_end(model* m, Layer* l) override;
+
+private:
+  void write_specific_proto(lbann_data::Callback& proto) const final;
+
+  /** Whether the current step is timed. */
+  bool is_timed() const noexcept
+  {
+    return (m_step >= m_skip_steps && m_step < m_skip_steps + m_num_steps);
+  }
+  /** Start timing a layer's forward prop (slot 2i) or backprop
+   *  (slot 2i+1). */
+  void begin_interval(const Layer& l, size_t slot);
+  /** Stop timing a slot and add the layer's work to it. */
+  void end_interval(const Layer& l, size_t slot, const compute_cost& cost);
+  /** Add the device intervals recorded in a step to the times. */
+  void resolve_device_intervals(size_t step);
+  /** Print the report on the trainer master. */
+  void report(model& m);
+
+  /** Training steps before timing starts. */
+  size_t m_skip_steps;
+  /** Training steps timed. */
+  size_t m_num_steps;
+  /** Peak GFLOP/s of a rank's device, or 0 if unknown. */
+  double m_peak_gflops;
+  /** Peak GB/s of a rank's device memory, or 0 if unknown. */
+  double m_peak_gbps;
+
+  /** Index of each layer. */
+  std::unordered_map<const Layer*, size_t> m_layer_indices;
+  /** Names and types of the layers, by index. */
+  std::vector<std::string> m_layer_names;
+  std::vector<std::string> m_layer_types;
+  /** Seconds, operations and bytes timed, by slot. */
+  std::vector<double> m_seconds;
+  std::vector<double> m_flops;
+  std::vector<double> m_bytes;
+  /** Host start times of the open intervals, by slot. */
+  std::vector<double> m_host_start;
+  /** Training steps taken. */
+  size_t m_step = 0;
+
+#ifdef LBANN_HAS_GPU
+  using event_ptr = std::unique_ptr<gpu_lib::event_wrapper>;
+  /** Events of each slot in even and odd steps, so a step's events
+   *  are resolved while the next step records. */
+  struct device_interval
+  {
+    event_ptr start;
+    event_ptr end;
+    bool recorded = false;
+  };
+  std::vector<device_interval> m_intervals[2];
+#endif // LBANN_HAS_GPU
+};
+
+// Builder function
+std::unique_ptr<callback_base>
+build_roofline_callback_from_pbuf(const google::protobuf::Message&,
+                                  std::shared_ptr<lbann_summary> const&);
+
+} // namespace callback
+} // namespace lbann
+
+#endif // LBANN_CALLBACKS_CALLBACK_ROOFLINE_HPP_INCLUDED
@@ -60,6 +60,7 @@ public:
   sync_layers& operator=(const sync_layers&) = default;
   sync_layers* copy() const override { return new sync_layers(*this); }
   std::string name() const override { return "sync_layers"; }
+  bool supports_gpu_graph_capture() const override { return false; }
 
   using callback_base::on_backward_prop_end;
   using callback_base::on_forward_prop_end;
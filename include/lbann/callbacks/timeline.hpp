@@ -31,7 +31,14 @@
 
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/utils/timer.hpp"
-
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -44,17 +51,40 @@ namespace callback {
  * The logfile is named timeline.m\<model-rank\>.\<rank\>.txt.
  * Each line is a separate event, written as name:start-time:end-time.
  * Times are relative to the beginning of training.
+ *
+ * Communication operations are written as
+ * comm-name:start-time:end-time:wait-time:bytes, where the host was
+ * blocked on the operation from wait-time to end-time, and bytes were
+ * sent by this rank. Each step is summarized as
+ * step:start-time:end-time:exposed-time, where exposed-time is the
+ * time the host was blocked on communication during the step.
+ *
+ * The trainer master also gathers the events of all the trainer's
+ * ranks into a Chrome trace, timeline.m\<model-rank\>.json, which can
+ * be viewed in Perfetto or chrome://tracing. Each rank is a process.
+ *
+ * With device events, the forward and backward passes of GPU layers
+ * and the optimization of weights that are not offloaded are timed
+ * with events on the compute stream instead of host timestamps, so
+ * they measure when the GPU ran them rather than when their kernels
+ * were launched. The events are resolved a few steps later, so the
+ * device is not synchronized.
  */
 class timeline : public callback_base
 {
 public:
-  timeline(std::string outdir) : callback_base(1), m_outdir(outdir) {}
+  timeline(std::string outdir, bool device_events = false)
+    : callback_base(1), m_outdir(outdir), m_device_events(device_events)
+  {}
   timeline(const timeline&) = default;
   timeline& operator=(const timeline&) = default;
   timeline* copy() const override { return new timeline(*this); }
   std::string name() const override { return "timeline"; }
+  bool supports_gpu_graph_capture() const override { return false; }
   void on_train_begin(model* m) override;
   void on_train_end(model* m) override;
+  void on_batch_begin(model* m) override;
+  void on_batch_end(model* m) override;
 
   using callback_base::on_backward_prop_begin;
   using callback_base::on_backward_prop_end;
@@ -89,6 +119,29 @@ private:
   /// Get time relative to the start time.
   EvalType get_rel_time() const { return get_time() - m_start_time; }
 
+  /// Kinds of timed intervals.
+  enum interval_kind
+  {
+    forward_prop = 0,
+    backward_prop,
+    optimize,
+    num_interval_kinds
+  };
+  /// Whether a layer's passes are timed with device events.
+  bool times_on_device(const Layer& l) const;
+  /// Whether a weights' optimization is timed with device events.
+  bool times_on_device(const weights& w) const;
+  /// Record the device event that starts an interval.
+  void begin_device_interval(interval_kind kind);
+  /// Record the device event that ends an interval, which is added
+  /// to @c times once it is resolved.
+  void end_device_interval(interval_kind kind,
+                           std::vector<std::pair<EvalType, EvalType>>& times);
+  /// Resolve the device intervals of the steps before @c step.
+  void resolve_device_intervals(size_t step);
+  /// This rank's events, as Chrome trace events of process @c pid.
+  std::string get_trace_events(int pid) const;
+
   /// Directory to write output to.
   std::string m_outdir;
   /// Time training started; all times are relative to this.
@@ -106,6 +159,76 @@ private:
     m_bp_times;
   std::unordered_map<std::string, std::vector<std::pair<EvalType, EvalType>>>
     m_opt_times;
+
+  /// A communication operation, see lbann_comm::comm_event.
+  struct comm_record
+  {
+    EvalType start;
+    EvalType wait;
+    EvalType end;
+    size_t bytes;
+    template <class Archive>
+    void serialize(Archive& ar)
+    {
+      ar(start, wait, end, bytes);
+    }
+  };
+  /// Time the current step started.
+  EvalType m_step_start_time = EvalType(0);
+  /// Communication operations, by name.
+  std::unordered_map<std::string, std::vector<comm_record>> m_comm_times;
+  /// Start and end of each step.
+  std::vector<std::pair<EvalType, EvalType>> m_step_times;
+  /// Time the host was blocked on communication during each step.
+  std::vector<EvalType> m_exposed_comm_times;
+
+  /// Whether GPU work is timed with device events.
+  bool m_device_events;
+#ifdef LBANN_HAS_GPU
+  using event_ptr = std::unique_ptr<gpu_lib::event_wrapper>;
+  /// Interval of GPU work between two device events.
+  struct device_interval
+  {
+    /// Times the interval is added to once it is resolved.
+    std::vector<std::pair<EvalType, EvalType>>* times = nullptr;
+    /// Step the interval was recorded in.
+    size_t step = 0;
+    event_ptr start;
+    event_ptr end;
+  };
+  /// Device events in flight. A copy starts without any.
+  struct device_timing
+  {
+    device_timing() = default;
+    device_timing(const device_timing&) {}
+    device_timing& operator=(const device_timing&)
+    {
+      clear();
+      return *this;
+    }
+    void clear()
+    {
+      reference.reset();
+      for (auto& interval : open) {
+        interval = device_interval();
+      }
+      pending.clear();
+      free_events.clear();
+      step = 0;
+    }
+    /// Completed at the start time; device times are relative to it.
+    event_ptr reference;
+    /// Interval being recorded, by kind.
+    std::array<device_interval, num_interval_kinds> open;
+    /// Recorded intervals that are not resolved yet.
+    std::deque<device_interval> pending;
+    /// Resolved events, which are reused.
+    std::vector<event_ptr> free_events;
+    /// Number of steps since training started.
+    size_t step = 0;
+  };
+  device_timing m_device;
+#endif // LBANN_HAS_GPU
 };
 
 // Builder function
@@ -37,10 +37,12 @@
 #endif // LBANN_HAS_ALUMINUM
 
 #include "lbann/comm_nb_request.hpp"
+#include "lbann/utils/telemetry.hpp"
 
 #include "detect_El_mpi.hpp"
 
 #include <map>
+#include <mutex>
 #include <typeindex>
 #include <vector>
 
@@ -59,6 +61,19 @@ enum class GridType
   SECONDARY_GRID = 2
 };
 
+/** Placement of world ranks in trainers */
+enum class TrainerPlacement
+{
+  /** Consecutive world ranks are in the same trainer */
+  CONSECUTIVE = 0,
+  /** Ranks are ordered by compute node, so trainers fill nodes */
+  NODE = 1,
+  /** Nodes are ordered by the integer in the LBANN_TOPOLOGY_GROUP
+   *  environment variable, e.g. a switch number provided by the
+   *  scheduler, so trainers fill groups of nodes */
+  GROUP = 2
+};
+
 /* Notes on Synchronization
  *
  * The updated interface exposes a synchronization handle/device
@@ -126,8 +141,14 @@ public:
    *  @param trainer_grid_height Height of 2D process grid for each
    *  trainer. Must divide @c procs_per_trainer. Default grid is
    *  approximately square.
+   *  @param placement How world ranks are placed in trainers. Trainers
+   *  that fit in a node or group of nodes stay within it, so their
+   *  collectives avoid the slower links between nodes or groups.
    */
-  void split_trainers(int procs_per_trainer = -1, int trainer_grid_height = -1);
+  void
+  split_trainers(int procs_per_trainer = -1,
+                 int trainer_grid_height = -1,
+                 TrainerPlacement placement = TrainerPlacement::CONSECUTIVE);
 
   /** Split the commicator for the given trainer into primary and secondary
    *
@@ -163,24 +184,28 @@ public:
   /** Return the COMM_WORLD rank of the rank'th processor in trainer. */
   inline int get_world_rank(int trainer, int rank) const noexcept
   {
+    int position;
     if (m_secondary_grid_ranks.size() == 0) {
-      return m_procs_per_trainer * trainer + rank;
+      position = m_procs_per_trainer * trainer + rank;
     }
     else {
-      return (m_secondary_grid_ranks.size() + m_primary_grid_ranks.size()) *
-               trainer +
-             rank;
+      position =
+        (m_secondary_grid_ranks.size() + m_primary_grid_ranks.size()) *
+          trainer +
+        rank;
     }
+    return (m_placed_world_ranks.empty() ? position
+                                         : m_placed_world_ranks[position]);
   }
   /** Return the "rank" of the trainer that this rank is in */
   inline int map_world_rank_to_trainer_rank(int world_rank) const noexcept
   {
-    return (world_rank / m_procs_per_trainer);
+    return (get_placement_position(world_rank) / m_procs_per_trainer);
   }
   /** Return the "rank" within the trainer that this rank is in */
   inline int map_world_rank_to_rank_in_trainer(int world_rank) const noexcept
   {
-    return (world_rank % m_procs_per_trainer);
+    return (get_placement_position(world_rank) % m_procs_per_trainer);
   }
   /** Return the rank of the master process in this trainer. */
   inline int get_trainer_master() const noexcept { return 0; }
@@ -259,6 +284,18 @@ public:
   /** Broadcast mat over the inter-trainer communicator starting from root. */
   void intertrainer_broadcast_matrix(AbsMat& mat, int root) const;
   void intertrainer_broadcast_matrix(AbsDistMat& mat, int root) const;
+  /** Non-blocking intertrainer_sum_matrix. mat must not change until
+   *  req is waited for. */
+  void nb_intertrainer_sum_matrix(AbsMat& mat, Al::request& req) const;
+  void nb_intertrainer_sum_matrix(AbsDistMat& mat, Al::request& req) const;
+  /** Non-blocking intertrainer_broadcast_matrix. Broadcasts of GPU
+   *  matrices are only non-blocking with NCCL. */
+  void nb_intertrainer_broadcast_matrix(AbsMat& mat,
+                                        int root,
+                                        Al::request& req) const;
+  void nb_intertrainer_broadcast_matrix(AbsDistMat& mat,
+                                        int root,
+                                        Al::request& req) const;
 
   /// Broadcast a scalar value over an arbitrary communicator
   template <typename T, bool S = is_instantiated_El_mpi_type<T>::value>
@@ -409,6 +446,20 @@ public:
   template <typename T>
   void trainer_all_gather(T const& src, std::vector<T>& data) const;
 
+  /**
+   * All-to-all with variable counts over an arbitrary communicator;
+   * counts and displacements are in units of T and must be sized to
+   * the communicator size.
+   */
+  template <typename T>
+  void all_to_all(const T* src,
+                  std::vector<int> const& src_counts,
+                  std::vector<int> const& src_disp,
+                  T* rcv,
+                  std::vector<int> const& rcv_counts,
+                  std::vector<int> const& rcv_disp,
+                  const El::mpi::Comm& c) const;
+
   /** Within-trainer scalar gather (for non-root processes). */
   template <typename T>
   void trainer_gather(T snd, int root) const;
@@ -618,6 +669,46 @@ public:
                     const El::mpi::Comm& c,
                     Al::request& req,
                     El::mpi::Op op = El::mpi::SUM) const;
+  /** @brief Set up a persistent in-place allreduce of a matrix.
+   *
+   *  Setup costs, such as algorithm selection and registration of the
+   *  buffer, are paid once. start_persistent_allreduce then launches
+   *  the allreduce, which wait and test complete as for
+   *  nb_allreduce. The buffer of the matrix must not change until
+   *  free_persistent_allreduce.
+   *
+   *  @returns Whether the allreduce is persistent. Only contiguous
+   *  CPU matrices are supported, with MPI 4, and large matrices are
+   *  not if allreduces are hierarchical.
+   */
+  template <typename TensorDataType>
+  bool init_persistent_allreduce(El::AbstractMatrix<TensorDataType>& m,
+                                 const El::mpi::Comm& c,
+                                 Al::request& req,
+                                 El::mpi::Op op = El::mpi::SUM) const;
+  /** @brief Launch a persistent allreduce. */
+  void start_persistent_allreduce(Al::request& req) const;
+  /** @brief Free a persistent allreduce, once it has completed. */
+  void free_persistent_allreduce(Al::request& req) const;
+
+  /** @brief Use a hierarchical algorithm for large matrix allreduces.
+   *
+   *  The allreduce is a reduce-scatter within each compute node, an
+   *  allreduce across nodes of one part per process, and an allgather
+   *  within the node. With G processes per node, inter-node links
+   *  carry 1/G of the data. Used for contiguous matrices with at
+   *  least hierarchical_allreduce_min_size entries, over
+   *  communicators with the same number of processes on each of
+   *  several nodes. Non-blocking allreduces of CPU matrices are not
+   *  affected.
+   */
+  void set_hierarchical_allreduce(bool enable) noexcept
+  {
+    m_hierarchical_allreduce = enable;
+  }
+  /** Smallest matrix with hierarchical allreduces. */
+  static constexpr El::Int hierarchical_allreduce_min_size = 1 << 16;
+
   /** Non-blocking in-place scalar-array allreduce.
    *  If LBANN has not been built with Aluminum, then this calls a blocking
    *  allreduce.
@@ -859,6 +950,39 @@ public:
     m_bytes_received = 0;
   }
 
+  /** @brief A profiled communication operation
+   *
+   *  Times are from get_time(). The host is blocked from @c wait to
+   *  @c end: for the whole of a blocking operation, and while it is
+   *  in wait() on a non-blocking one, whose remaining time overlaps
+   *  computation. GPU operations end when the host sees them
+   *  complete, since their waits do not block the host.
+   */
+  struct comm_event
+  {
+    /** Operation, e.g. "nb_allreduce". */
+    char const* name;
+    /** Bytes sent by this process. */
+    size_t bytes;
+    /** When the operation was started. */
+    double start;
+    /** When the host began waiting for the operation. */
+    double wait;
+    /** When the operation was seen to complete. */
+    double end;
+    /** Whether the operation has completed. */
+    bool complete;
+  };
+  /** Record the communication operations of this process.
+   *  Collectives, broadcasts, send-receives and inter-trainer
+   *  operations are recorded. */
+  void set_comm_profiling(bool enable) noexcept { m_comm_profiling = enable; }
+  /** Whether communication operations are recorded. */
+  bool get_comm_profiling() const noexcept { return m_comm_profiling; }
+  /** Remove and return the recorded operations. Operations still in
+   *  flight are returned incomplete and no longer recorded. */
+  std::vector<comm_event> take_comm_events() const;
+
   /** Return true if mat can be transmitted. */
   static inline bool is_sendable(const AbsMat& mat) noexcept
   {
@@ -927,6 +1051,17 @@ public:
    */
   const El::mpi::Comm& get_packed_group_comm(int num_per_group) const;
 
+  /** Return a communicator over a block of num_splits consecutive
+   *  ranks in this trainer, ordered by rank in trainer. These are the
+   *  ranks holding the shards of a sequence, see
+   *  ParallelStrategy::sequence_splits. Created on first use, which is
+   *  collective over the trainer.
+   *
+   *  num_splits must evenly divide the number of processes in the
+   *  trainer.
+   */
+  const El::mpi::Comm& get_sequence_comm(int num_splits) const;
+
   /** Return true if rank (in comm) is on the local node. */
   bool is_rank_node_local(int rank, const El::mpi::Comm& comm) const
   {
@@ -955,6 +1090,25 @@ private:
   El::mpi::Comm m_combined_grid_comm;
   /** Packed group communicators. */
   mutable std::unordered_map<int, El::mpi::Comm> m_group_communicators;
+  /** Sequence shard communicators, by number of splits. */
+  mutable std::unordered_map<int, El::mpi::Comm> m_sequence_comms;
+  /** Communicators of the processes of a communicator in the same
+   *  compute node, and of those with the same rank in their node. */
+  struct hierarchical_comms
+  {
+    El::mpi::Comm node;
+    El::mpi::Comm internode;
+    bool usable = false;
+  };
+  /** Hierarchical allreduce communicators, by parent communicator. */
+  mutable std::map<MPI_Comm, hierarchical_comms> m_hierarchical_comms;
+  /** Whether large allreduces are hierarchical. */
+  bool m_hierarchical_allreduce = false;
+  /** World rank of each position in the trainers, which are blocks
+   *  of consecutive positions. Empty if ranks are placed in order. */
+  std::vector<int> m_placed_world_ranks;
+  /** Position in the trainers of each world rank. */
+  std::vector<int> m_world_rank_positions;
   /** Grid for this trainer. */
   std::unique_ptr<El::Grid> m_grid;
   /** Number of trainers. */
@@ -998,9 +1152,65 @@ private:
   mutable size_t m_bytes_sent;
   mutable size_t m_bytes_received;
 
+  /** Whether communication operations are recorded. */
+  bool m_comm_profiling = false;
+  /** Recorded communication operations. */
+  mutable std::vector<comm_event> m_comm_events;
+  /** Identifier of the first of m_comm_events. */
+  mutable size_t m_first_comm_event = 1;
+  /** Protects m_comm_events, which background threads may add to. */
+  mutable std::mutex m_comm_events_mutex;
+
+  /** Record the start of an operation. Returns its identifier, or
+   *  zero if operations are not recorded. Its bytes are also counted
+   *  in the telemetry. */
+  size_t begin_comm_event(char const* name, size_t bytes) const;
+  /** Record the end of an operation the host waited for since
+   *  wait_start, or since the operation started if it is negative. */
+  void end_comm_event(size_t id, double wait_start) const;
+
+  /** Records a blocking operation over the lifetime of the object. */
+  class blocking_comm_event
+  {
+  public:
+    blocking_comm_event(lbann_comm const& comm,
+                        char const* name,
+                        size_t bytes)
+      : m_comm(comm),
+        m_id(comm.begin_comm_event(name, bytes)),
+        m_wait(telemetry_value::comm_wait_seconds)
+    {}
+    ~blocking_comm_event() { m_comm.end_comm_event(m_id, -1.); }
+
+  private:
+    lbann_comm const& m_comm;
+    size_t m_id;
+    telemetry_timer m_wait;
+  };
+
   /** Setup communicator for processes in the same compute node. */
   void setup_node_comm();
 
+  /** Position in the trainers of a world rank. */
+  int get_placement_position(int world_rank) const noexcept
+  {
+    return (m_world_rank_positions.empty()
+              ? world_rank
+              : m_world_rank_positions[world_rank]);
+  }
+  /** Order the world ranks for a placement. */
+  void place_world_ranks(TrainerPlacement placement);
+
+  /** Hierarchical allreduce communicators of c, or null if c does
+   *  not have the same number of processes on each of several nodes.
+   *  Created on first use, which is collective over c. */
+  hierarchical_comms const*
+  get_hierarchical_comms(const El::mpi::Comm& c) const;
+  /** Free the hierarchical allreduce communicators. */
+  void clear_hierarchical_comms();
+  /** Free the sequence shard communicators. */
+  void clear_sequence_comms();
+
   /** Initialize the default number of threads per process.
    *  This is the number of OpenMP threads to use for parallel
    *  regions, provided omp_set_num_threads has not been called or the
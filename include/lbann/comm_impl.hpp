@@ -270,6 +270,37 @@ void lbann_comm::trainer_all_gather(T const& src, std::vector<T>& data) const
   all_gather(src, data, get_trainer_comm());
 }
 
+/**
+ * All-to-all with variable counts over an arbitrary communicator;
+ * counts and displacements are in units of T and must be sized to
+ * the communicator size.
+ */
+template <typename T>
+void lbann_comm::all_to_all(const T* const src,
+                            std::vector<int> const& src_counts,
+                            std::vector<int> const& src_disp,
+                            T* const rcv,
+                            std::vector<int> const& rcv_counts,
+                            std::vector<int> const& rcv_disp,
+                            const El::mpi::Comm& c) const
+{
+  const auto status = MPI_Alltoallv(src,
+                                    src_counts.data(),
+                                    src_disp.data(),
+                                    El::mpi::TypeMap<T>(),
+                                    rcv,
+                                    rcv_counts.data(),
+                                    rcv_disp.data(),
+                                    El::mpi::TypeMap<T>(),
+                                    c.GetMPIComm());
+  if (status != MPI_SUCCESS) {
+    std::ostringstream err;
+    err << __FILE__ << " " << __LINE__ << " :: "
+        << "MPI_Alltoallv failed with error code " << status;
+    lbann_comm_abort(err.str());
+  }
+}
+
 /** Within-trainer scalar gather (for non-root processes). */
 template <typename T>
 void lbann_comm::trainer_gather(const T snd, const int root) const
@@ -663,6 +694,7 @@ void lbann_comm::allreduce(T const* const snd,
 {
   auto const size_c = El::mpi::Size(c);
   m_bytes_sent += count * sizeof(T);
+  blocking_comm_event event(*this, "allreduce", count * sizeof(T));
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
   ::Al::MPIAllreduceAlgorithm algo =
@@ -691,6 +723,7 @@ void lbann_comm::allreduce(T* const data,
 {
   auto const size_c = El::mpi::Size(c);
   m_bytes_sent += count * sizeof(T);
+  blocking_comm_event event(*this, "allreduce", count * sizeof(T));
 #ifdef LBANN_HAS_ALUMINUM
 #ifdef LBANN_ALUMINUM_MPI_PASSTHROUGH
   ::Al::MPIAllreduceAlgorithm algo =
@@ -722,6 +755,7 @@ void lbann_comm::nb_allreduce(T* data,
                               const El::mpi::Op op) const
 {
   m_bytes_sent += count * sizeof(T);
+  req.profile_event = begin_comm_event("nb_allreduce", count * sizeof(T));
 #ifdef LBANN_HAS_ALUMINUM
   req.mpi_req = Al::mpi_null_req;
   ::Al::NonblockingAllreduce<::Al::MPIBackend>(
@@ -971,6 +1005,7 @@ void lbann_comm::sendrecv(const T* const snd,
 {
   m_bytes_sent += sizeof(T) * send_count;
   m_bytes_received += sizeof(T) * recv_count;
+  blocking_comm_event event(*this, "sendrecv", sizeof(T) * send_count);
   El::mpi::SendRecv(snd,
                     send_count,
                     get_world_rank(send_trainer, send_rank),
@@ -1021,6 +1056,9 @@ template <typename T, bool S>
 void lbann_comm::broadcast(const int root, T& val, const El::mpi::Comm& c) const
 {
   auto const rank_c = El::mpi::Rank(c);
+  blocking_comm_event event(*this,
+                            "broadcast",
+                            (rank_c == root ? sizeof(T) : 0));
   if (S) {
     // Avoid linking error from uninstantiated El::mpi routine if !S by
     // converting T to El::byte
@@ -1066,6 +1104,9 @@ void lbann_comm::broadcast(const int root,
   // Avoid linking error from uninstantiated El::mpi routine if !S by converting
   // T to El::byte
   using TT = typename interpret_as_byte_if_needed<S, T>::type;
+  blocking_comm_event event(*this,
+                            "broadcast",
+                            (rank_c == root ? sizeof(T) * count : 0));
   El::mpi::Broadcast<TT>(reinterpret_cast<TT*>(data), size, root, c, syncInfo);
   count_bytes_broadcast(sizeof(T) * count, rank_c, root);
 }
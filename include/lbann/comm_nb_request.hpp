@@ -78,6 +78,12 @@ struct request
   nccl_req_type nccl_req = nccl_null_req;
   hosttransfer_req_type hosttransfer_req = hosttransfer_null_req;
   MPI_Request raw_mpi_req = MPI_REQUEST_NULL;
+  /** Bytes of each start of a persistent request, which stays in
+   *  raw_mpi_req until it is freed. Zero if not persistent. */
+  size_t persistent_size = 0;
+  /** Identifier of the profiled communication event of the request,
+   *  or zero if it is not profiled. */
+  size_t profile_event = 0;
 };
 } // namespace Al
 
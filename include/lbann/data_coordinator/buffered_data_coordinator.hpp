@@ -29,6 +29,9 @@
 
 #include "lbann/data_coordinator/data_coordinator.hpp"
 #include "lbann/data_coordinator/io_data_buffer.hpp"
+#include "lbann/data_coordinator/io_worker_pool.hpp"
+#include "lbann/data_readers/data_reader.hpp"
+#include "lbann/utils/exception.hpp"
 
 namespace lbann {
 
@@ -53,11 +56,24 @@ public:
     data_buffer_map_t;
 
 public:
-  buffered_data_coordinator(lbann_comm* comm) : data_coordinator(comm)
+  /** @brief Construct a coordinator with a ring of @c num_buffers
+   *  buffers per execution mode
+   *
+   *  Background I/O runs up to <tt>num_buffers - 1</tt> mini-batches
+   *  ahead of the model, so deeper rings absorb slow mini-batches.
+   */
+  buffered_data_coordinator(lbann_comm* comm, int num_buffers = 2)
+    : data_coordinator(comm)
   {
+    if (num_buffers < 2) {
+      LBANN_ERROR("buffered data coordinator requires at least two I/O "
+                  "buffers, but ",
+                  num_buffers,
+                  " were requested");
+    }
 
-    // Initialize two buffers
-    m_data_buffers.resize(2);
+    // Initialize the ring of buffers
+    m_data_buffers.resize(num_buffers);
     for (size_t i = 0; i < m_data_buffers.size(); i++) {
       for (auto m : execution_mode_iterator()) {
         if (m != execution_mode::invalid) {
@@ -70,11 +86,22 @@ public:
     for (auto m : execution_mode_iterator()) {
       if (m != execution_mode::invalid) {
         this->m_active_buffer[m].store(-1);
+        m_last_queued_buffer[m] = -1;
       }
     }
   }
 
-  ~buffered_data_coordinator() {}
+  ~buffered_data_coordinator()
+  {
+    // Fetches may be queued past the last step that runs
+    for (auto& buffer_map : m_data_buffers) {
+      for (auto& [mode, buf] : buffer_map) {
+        if (buf != nullptr && buf->is_data_fetched_in_background()) {
+          buf->get_data_fetch_future().wait();
+        }
+      }
+    }
+  }
 
   // Data Coordinators copy their data readers.
   buffered_data_coordinator(const buffered_data_coordinator& other)
@@ -88,6 +115,13 @@ public:
         buffer_map[b.first].reset(b.second ? b.second->copy() : nullptr);
       }
     }
+    for (const auto& q : other.m_last_queued_buffer) {
+      m_last_queued_buffer[q.first] = -1;
+    }
+    // Workers hold a copy of the other coordinator's reader, so this
+    // one forks its own
+    m_num_io_worker_processes = other.m_num_io_worker_processes;
+    m_mini_batch_cache_budget = other.m_mini_batch_cache_budget;
   }
 
   buffered_data_coordinator& operator=(const buffered_data_coordinator& other)
@@ -102,6 +136,15 @@ public:
         buffer_map[b.first].reset(b.second ? b.second->copy() : nullptr);
       }
     }
+    m_last_queued_buffer.clear();
+    for (const auto& q : other.m_last_queued_buffer) {
+      m_last_queued_buffer[q.first] = -1;
+    }
+    m_io_worker_pools.clear();
+    m_num_io_worker_processes = other.m_num_io_worker_processes;
+    m_mini_batch_cache.clear();
+    m_mini_batch_cache_size = 0;
+    m_mini_batch_cache_budget = other.m_mini_batch_cache_budget;
     return *this;
   }
 
@@ -110,7 +153,7 @@ public:
   void serialize(Archive& ar);
 
   /** @brief After registering the active data field, allocate storage for each
-   *  data field in the context maps within the double buffer.
+   *  data field in the context maps within the ring of buffers.
    */
   void register_active_data_field(data_field_type const data_field) override;
 
@@ -129,6 +172,8 @@ public:
   get_sample_indices_per_mb(execution_mode mode) const override;
   El::Matrix<El::Int>* get_sample_indices_per_mb(execution_mode mode) override;
 
+  int get_max_sample_length(execution_mode mode) const override;
+
   /** @brief Complete any background I/O data fetch for the execution
       mode requested */
   void collect_background_data_fetch(execution_mode mode) override;
@@ -146,10 +191,52 @@ public:
                                     AbsDistMatrixType& input_buffer);
 
 protected:
+  using mini_batch_cursor = generic_data_reader::mini_batch_cursor;
+
   int fetch_to_local_matrix(data_buffer_map_t& buffer_map,
+                            const mini_batch_cursor& cursor,
                             const execution_mode mode);
 
-  void fetch_data_in_background(int future_active_buffer, execution_mode mode);
+  /** @brief Returns the I/O workers of an execution mode, forking
+   *  them on first use, or nullptr if samples are loaded in threads */
+  io_worker_pool*
+  get_io_worker_pool(generic_data_reader* dr,
+                     const std::map<data_field_type, CPUMat*>& local_buffers,
+                     execution_mode mode);
+
+  /** @brief Whether mini-batches of the mode are kept in, or loaded
+   *  from, the mini-batch cache */
+  bool use_mini_batch_cache(generic_data_reader* dr, execution_mode mode) const;
+
+  /** @brief Copy a cached mini-batch at the cursor's position into
+   *  the local buffers; returns false on a miss */
+  bool load_cached_mini_batch(data_buffer<IODataType>& buf,
+                              std::map<data_field_type, CPUMat*>& local_buffers,
+                              const mini_batch_cursor& cursor,
+                              El::Int mb_size,
+                              execution_mode mode);
+
+  /** @brief Keep a copy of a fetched mini-batch if the budget allows */
+  void cache_mini_batch(const data_buffer<IODataType>& buf,
+                        const std::map<data_field_type, CPUMat*>& local_buffers,
+                        const mini_batch_cursor& cursor,
+                        execution_mode mode);
+
+  void fetch_data_in_background(int future_active_buffer,
+                                mini_batch_cursor cursor,
+                                execution_mode mode);
+
+  /** @brief Queue background fetches into the free buffers of the ring
+   *
+   *  Called once the data reader has advanced past the active
+   *  mini-batch. Stops at the end of the epoch, unless the reader
+   *  supports shuffling the next epoch ahead of time.
+   */
+  void queue_background_fetches(execution_mode mode);
+
+  /** @brief Queue the first validation mini-batches during the last
+   *  training steps of an epoch */
+  void queue_validation_fetches();
 
   int get_active_buffer_idx(execution_mode m) const
   {
@@ -190,8 +277,42 @@ protected:
    */
   io_buffer_map_t m_active_buffer;
 
+  /**
+   * Map from execution context to the (unwrapped) index of the last
+   * buffer that has been queued for fetching
+   */
+  std::map<execution_mode, int> m_last_queued_buffer;
+
+  /** Ship uint8 data fields of GPU input layers without converting
+   *  them on the CPU (see data_packer::convert_raw_data_field) */
+  bool m_raw_input_transfer = false;
+
+  /** Number of I/O worker processes forked for each execution mode */
+  int m_num_io_worker_processes = 0;
+
+  /** I/O workers of each execution mode, forked on the first fetch
+   *  while no background fetch is running */
+  std::map<execution_mode, std::unique_ptr<io_worker_pool>> m_io_worker_pools;
+
+  /** A packed mini-batch kept for later passes over the data set */
+  struct cached_mini_batch
+  {
+    El::Int num_samples;
+    El::Matrix<El::Int> indices;
+    std::map<data_field_type, CPUMat> fields;
+  };
+
+  /** Packed mini-batches of each execution mode, keyed by their
+   *  position in the reader's indices */
+  std::map<execution_mode, std::map<int, cached_mini_batch>>
+    m_mini_batch_cache;
+  /** Bytes held by, and allowed for, m_mini_batch_cache */
+  size_t m_mini_batch_cache_size = 0;
+  size_t m_mini_batch_cache_budget = 0;
+
   /** Vector of input data buffers
-   *  There are two sets of buffer maps to allow for double buffered execution
+   *  The buffer maps form a ring, indexed modulo its size, so that
+   *  background I/O can run several mini-batches ahead of execution.
    *  Within each buffer map there is a buffer for each phase of execution.
    *  Each matrix column corresponds to a flattened mini-batch sample
    *  or label or responase.
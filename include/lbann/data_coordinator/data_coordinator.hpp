@@ -28,6 +28,7 @@
 #define LBANN_DATA_COORDINATOR_HPP
 
 #include "lbann/data_coordinator/data_coordinator_metadata.hpp"
+#include "lbann/data_coordinator/io_statistics.hpp"
 #include "lbann/data_readers/utils/input_data_type.hpp"
 #include "lbann/utils/dataset.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
@@ -76,7 +77,13 @@ public:
       m_data_set_processed(false),
       m_execution_context(nullptr),
       m_io_thread_pool(nullptr)
-  {}
+  {
+    // Every mode is present up front so that the training loop and
+    // background fetches never insert concurrently
+    for (auto m : execution_mode_iterator()) {
+      m_io_statistics[m];
+    }
+  }
 
   virtual ~data_coordinator();
 
@@ -101,6 +108,25 @@ public:
    */
   virtual void setup_data_fields(int max_mini_batch_size) = 0;
 
+  /** @brief Load the data reader of an execution mode if its load was
+   *  deferred, and set it up.
+   *
+   *  Readers of evaluation modes can be loaded when they are first
+   *  used (see --defer_eval_reader_load) so that training starts
+   *  sooner. This is collective over the trainer, or over the world
+   *  if evaluation sets are split across trainers, and does nothing
+   *  once the reader is loaded.
+   */
+  void load_deferred_reader(execution_mode mode);
+
+  /** @brief Whether the data set of an execution mode is split across
+   *  trainers (see --shard_eval_across_trainers).
+   *
+   *  Each trainer then only evaluates its share of the samples, and
+   *  evaluation statistics must be reduced across trainers.
+   */
+  bool is_sharded_across_trainers(execution_mode mode) const;
+
   void set_trainer(trainer& trainer) { m_trainer = &trainer; }
 
   /** Check to see if there is a valid training context for the data coordinator
@@ -157,6 +183,13 @@ public:
   virtual El::Matrix<El::Int>*
   get_sample_indices_per_mb(execution_mode mode) = 0;
 
+  /**
+   * Return the length of the longest sample in the current mini-batch,
+   * for readers of padded variable-length samples; 0 otherwise.
+   * Layers may skip entries past it, which are all padding.
+   */
+  virtual int get_max_sample_length(execution_mode mode) const = 0;
+
   virtual size_t get_num_iterations_per_epoch(execution_mode mode) const;
 
   virtual int get_current_step_in_epoch(execution_mode mode) const;
@@ -167,6 +200,22 @@ public:
 
   virtual int get_current_mini_batch_size(execution_mode mode) const;
 
+  /** @brief Restrict the model inputs to one micro-batch.
+   *
+   *  The current mini-batch is split into @c num_micro_batches
+   *  consecutive column ranges of nearly equal size, and only range
+   *  @c index is distributed to the input layers.
+   */
+  void set_micro_batch(int index, int num_micro_batches);
+
+  /** @brief Columns of the current mini-batch in the current
+   *         micro-batch.
+   */
+  El::IR get_current_micro_batch_range(execution_mode mode) const;
+
+  /** @brief Number of samples in the current micro-batch. */
+  int get_current_micro_batch_size(execution_mode mode) const;
+
   virtual int get_global_mini_batch_size(execution_mode mode) const;
 
   virtual int get_current_global_mini_batch_size(execution_mode mode) const;
@@ -283,6 +332,21 @@ public:
 
   virtual void register_active_data_field(data_field_type const data_field);
 
+  //************************************************************************
+  // I/O statistics
+  //************************************************************************
+
+  /** @brief Timings of an I/O stage in an execution mode, merged over
+   *  the reader's I/O threads and the data coordinator
+   *
+   *  Waits for a background fetch that is in progress.
+   */
+  io_stage_summary get_io_stage_summary(execution_mode mode, io_stage stage);
+
+  /** @brief Timings of an I/O stage on each of the reader's I/O threads */
+  std::vector<io_stage_summary> get_io_thread_summaries(execution_mode mode,
+                                                        io_stage stage);
+
   //************************************************************************
   //
   //************************************************************************
@@ -306,8 +370,24 @@ protected:
   data_reader_map_t m_data_readers;
   //  std::map<execution_mode, dataset_stats> m_dataset_stats;
 
+  /** Mini-batch size the data readers were set up with */
+  int m_max_mini_batch_size = 0;
+
+  /** Whether the validation and testing sets are split across
+   *  trainers */
+  bool m_shard_eval_across_trainers = false;
+
   std::set<data_field_type> m_active_data_fields;
 
+  /** Stages timed by the data coordinator itself. The blocked and
+   *  exchange stages are recorded by the training loop; the fetch and
+   *  pack stages by background fetches, under dr_mutex. */
+  std::map<execution_mode, io_statistics> m_io_statistics;
+
+  /** @brief Micro-batch distributed to the input layers */
+  int m_micro_batch_index = 0;
+  int m_num_micro_batches = 1;
+
 public: // @todo BVE FIXME
   bool m_data_set_processed;
   std::mutex dr_mutex;
@@ -83,6 +83,72 @@ size_t extract_data_field_from_sample(data_field_type const& data_field,
                                       CPUMat& X,
                                       size_t sample_idx);
 
+/** @brief Copies a uint8 data field from Conduit nodes into a byte
+ *         matrix without converting it.
+ *
+ *  This is the raw counterpart of extract_data_fields_from_samples,
+ *  used to ship image-like data to the GPU at a quarter of the size
+ *  and convert it there (see convert_raw_data_field).
+ *
+ *  @param[in] samples The list of Conduit nodes holding sample data.
+ *  @param[in] data_field The identifier of the field to extract.
+ *  @param[in,out] X Byte matrix with height equal to the linearized
+ *         size of the field and width of at least the number of
+ *         samples.
+ *  @returns False, without writing anything, if the field is not
+ *         stored as uint8.
+ */
+bool extract_raw_data_field_from_samples(
+  std::vector<conduit::Node> const& samples,
+  data_field_type const& data_field,
+  El::Matrix<uint8_t>& X);
+
+/** @brief How the GPU turns a raw uint8 image into a sample.
+ *
+ *  An image is stored height x width x channels with interleaved
+ *  channels, as decoded by OpenCV. Channel c of pixel (row, col) is
+ *  written to c * height * width + row + col * height of the sample,
+ *  as by transform::to_lbann_layout, after mapping x to
+ *  scales[c] * x + shifts[c].
+ */
+struct raw_image_conversion
+{
+  static constexpr int max_channels = 4;
+  int channels = 0;
+  int height = 0;
+  int width = 0;
+  DataType scales[max_channels];
+  DataType shifts[max_channels];
+};
+
+#ifdef LBANN_HAS_GPU
+/** @brief Converts a packed, column-major uint8 batch on the GPU.
+ *
+ *  @param[in] raw Device pointer to a height x width batch with
+ *         leading dimension height.
+ *  @param[in,out] X Output matrix, resized to height x width. The
+ *         kernel runs on the stream of X.
+ */
+void convert_raw_data_field(uint8_t const* raw,
+                            El::Int height,
+                            El::Int width,
+                            El::Matrix<DataType, El::Device::GPU>& X);
+
+/** @brief Converts a batch of raw uint8 images on the GPU.
+ *
+ *  @param[in] raw Device pointer to @c num_samples images, each
+ *         stored as described by @c conv and packed one after another.
+ *  @param[in] conv The layout and channel-wise map of the images.
+ *  @param[in] num_samples Number of images.
+ *  @param[in,out] X Output matrix, resized to (channels * height *
+ *         width) x num_samples. The kernel runs on the stream of X.
+ */
+void convert_raw_image_batch(uint8_t const* raw,
+                             raw_image_conversion const& conv,
+                             El::Int num_samples,
+                             El::Matrix<DataType, El::Device::GPU>& X);
+#endif // LBANN_HAS_GPU
+
 } // namespace data_packer
 
 } // namespace lbann
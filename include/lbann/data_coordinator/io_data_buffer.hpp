@@ -27,7 +27,11 @@
 #ifndef LBANN_IO_BUFFER_HPP_INCLUDED
 #define LBANN_IO_BUFFER_HPP_INCLUDED
 
+#include "lbann/data_coordinator/data_packer.hpp"
 #include "lbann/data_readers/utils/input_data_type.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 namespace lbann {
 
@@ -52,6 +56,30 @@ public:
   std::future<void> m_data_fetch_future;
   /// 1-D Matrix of which indices were fetched in this mini-batch
   El::Matrix<El::Int> m_indices_fetched_per_mb;
+  /// Longest unpadded sample of the mini-batch; 0 if the data reader
+  /// does not know sample lengths
+  int m_max_sample_length = 0;
+#ifdef LBANN_HAS_GPU
+  /** Device copies of the (pinned) input buffers, copied on a
+   *  dedicated stream when a fetch completes */
+  std::map<data_field_type, std::unique_ptr<AbsDistMatrixType>>
+    m_device_buffers;
+  /** Data fields whose device copy holds the fetched mini-batch */
+  std::map<data_field_type, bool> m_staged_on_device;
+  /** Pinned uint8 copies of fields fetched without conversion; these
+   *  are shipped as is and converted to TensorDataType on the GPU */
+  std::map<data_field_type, El::Matrix<uint8_t>> m_raw_input_buffers;
+  /** Device scratch holding the raw bytes of each raw field */
+  std::map<data_field_type, El::Matrix<TensorDataType, El::Device::GPU>>
+    m_raw_device_buffers;
+  /** Data fields whose fetched mini-batch is in m_raw_input_buffers */
+  std::map<data_field_type, bool> m_fetched_raw;
+  /** Raw fields holding images, with how to convert them */
+  std::map<data_field_type, data_packer::raw_image_conversion>
+    m_raw_image_conversions;
+  /** Data fields that the data reader generated in the device buffer */
+  std::map<data_field_type, bool> m_fetched_on_device;
+#endif // LBANN_HAS_GPU
 
   data_buffer(lbann_comm* comm)
     : m_num_samples_fetched(0), m_fetch_data_in_background(false)
@@ -78,8 +106,28 @@ public:
     // for (const auto& ptr : other.m_input_buffers) {
     //   m_input_buffers.emplace_back(ptr ? ptr->Copy() : nullptr);
     // }
+#ifdef LBANN_HAS_GPU
+    m_device_buffers.clear();
+    m_staged_on_device.clear();
+    m_raw_input_buffers.clear();
+    m_raw_device_buffers.clear();
+    m_fetched_raw.clear();
+    m_raw_image_conversions.clear();
+    m_fetched_on_device.clear();
+#endif // LBANN_HAS_GPU
     return *this;
   }
+  ~data_buffer()
+  {
+#ifdef LBANN_HAS_GPU
+    // The device matrices use the staging stream
+    m_device_buffers.clear();
+    m_raw_device_buffers.clear();
+    if (m_has_copy_sync_info) {
+      El::DestroySyncInfo(m_copy_sync_info);
+    }
+#endif // LBANN_HAS_GPU
+  }
   data_buffer* copy() const { return new data_buffer(*this); }
 
   /** Archive for checkpoint and restart */
@@ -91,6 +139,73 @@ public:
   void initialize_buffer_for_data_field(data_field_type const data_field,
                                         lbann_comm* comm);
 
+#ifdef LBANN_HAS_GPU
+  /** @brief Create a device matrix that mirrors the input buffer of
+   *  the field */
+  void initialize_device_buffer_for_data_field(data_field_type const data_field,
+                                               lbann_comm* comm);
+
+  bool has_device_buffer(data_field_type const data_field) const
+  {
+    return m_device_buffers.count(data_field) > 0;
+  }
+
+  bool is_staged_on_device(data_field_type const data_field) const
+  {
+    auto it = m_staged_on_device.find(data_field);
+    return it != m_staged_on_device.end() && it->second;
+  }
+
+  /** @brief Wait until the host buffers may be overwritten and mark
+   *  the device copies as stale */
+  void release_device_staging();
+
+  /** @brief Start asynchronous host-to-device copies of the fetched
+   *  data into every device buffer */
+  void stage_to_device();
+
+  /** @brief Start the host-to-device copy for one data field */
+  void stage_to_device(data_field_type const data_field);
+
+  /** @brief Pinned byte matrix that receives a raw uint8 fetch of the
+   *  field; it is resized like the field's input buffer */
+  El::Matrix<uint8_t>& get_raw_input_buffer(data_field_type const data_field);
+
+  /** @brief Record whether the last fetch of the field went to its
+   *  raw input buffer */
+  void set_fetched_raw(data_field_type const data_field, bool flag)
+  {
+    m_fetched_raw[data_field] = flag;
+  }
+
+  /** @brief Record that the raw input buffer of the field holds images
+   *  of the given layout, so staging converts them with
+   *  data_packer::convert_raw_image_batch */
+  void set_raw_image_conversion(data_field_type const data_field,
+                                data_packer::raw_image_conversion const& conv)
+  {
+    m_raw_image_conversions[data_field] = conv;
+  }
+
+  /** @brief Device matrix that receives a fetch_to_device() of the
+   *  field; it is resized like the field's input buffer */
+  El::Matrix<TensorDataType, El::Device::GPU>&
+  get_device_output(data_field_type const data_field);
+
+  /** @brief Record whether the last fetch of the field was generated
+   *  in its device buffer, so that staging does not overwrite it */
+  void set_fetched_on_device(data_field_type const data_field, bool flag)
+  {
+    m_fetched_on_device[data_field] = flag;
+  }
+
+  /** @brief Synchronization object of the stream used for staging */
+  El::SyncInfo<El::Device::GPU> const& get_copy_sync_info() const
+  {
+    return m_copy_sync_info;
+  }
+#endif // LBANN_HAS_GPU
+
   void set_fetch_data_in_background(bool flag)
   {
     m_fetch_data_in_background = flag;
@@ -124,6 +239,17 @@ public:
   {
     return std::move(m_data_fetch_future);
   }
+
+#ifdef LBANN_HAS_GPU
+private:
+  /** Stream and event used for host-to-device staging; lazily created
+   *  so that CPU-only input layers do not allocate GPU resources */
+  El::SyncInfo<El::Device::GPU> m_copy_sync_info;
+  bool m_has_copy_sync_info = false;
+  /** Recorded after the staging copies, before the host buffers may
+   *  be refilled */
+  gpu_lib::event_wrapper m_copy_done;
+#endif // LBANN_HAS_GPU
 };
 
 } // namespace lbann
@@ -27,7 +27,9 @@
 #ifndef LBANN_IO_BUFFER_HPP_IMPL_INCLUDED
 #define LBANN_IO_BUFFER_HPP_IMPL_INCLUDED
 
+#include "lbann/data_coordinator/data_packer.hpp"
 #include "lbann/data_coordinator/io_data_buffer.hpp"
+#include "lbann/utils/exception.hpp"
 
 namespace lbann {
 
@@ -58,6 +60,149 @@ void data_buffer<TensorDataType>::initialize_buffer_for_data_field(
   }
 }
 
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+void data_buffer<TensorDataType>::initialize_device_buffer_for_data_field(
+  data_field_type const data_field,
+  lbann_comm* comm)
+{
+  if (!m_has_copy_sync_info) {
+    m_copy_sync_info = El::CreateNewSyncInfo<El::Device::GPU>();
+    m_has_copy_sync_info = true;
+  }
+  if (m_device_buffers.find(data_field) == m_device_buffers.end()) {
+    m_device_buffers[data_field] =
+      std::make_unique<StarVCMatDT<TensorDataType, El::Device::GPU>>(
+        comm->get_trainer_grid());
+    El::SetSyncInfo(m_device_buffers[data_field]->Matrix(), m_copy_sync_info);
+    m_staged_on_device[data_field] = false;
+  }
+}
+
+template <typename TensorDataType>
+void data_buffer<TensorDataType>::release_device_staging()
+{
+  // The host buffers are pinned, so the staging copies read them
+  // asynchronously
+  m_copy_done.synchronize();
+  for (auto& [data_field, staged] : m_staged_on_device) {
+    staged = false;
+  }
+  for (auto& [data_field, raw] : m_fetched_raw) {
+    raw = false;
+  }
+  m_raw_image_conversions.clear();
+  for (auto& [data_field, on_device] : m_fetched_on_device) {
+    on_device = false;
+  }
+}
+
+template <typename TensorDataType>
+El::Matrix<TensorDataType, El::Device::GPU>&
+data_buffer<TensorDataType>::get_device_output(data_field_type const data_field)
+{
+  auto host_it = m_input_buffers.find(data_field);
+  auto dev_it = m_device_buffers.find(data_field);
+  if (host_it == m_input_buffers.end() || dev_it == m_device_buffers.end()) {
+    LBANN_ERROR("no staging buffers for data field ", data_field);
+  }
+  // Fetches run on an I/O thread, which starts on device 0
+  hydrogen::gpu::SetDevice(hydrogen::gpu::DefaultDevice());
+  const auto& host = *host_it->second;
+  auto& dev = *dev_it->second;
+  dev.Resize(host.Height(), host.Width());
+  return static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+    dev.Matrix());
+}
+
+template <typename TensorDataType>
+El::Matrix<uint8_t>& data_buffer<TensorDataType>::get_raw_input_buffer(
+  data_field_type const data_field)
+{
+  auto it = m_raw_input_buffers.find(data_field);
+  if (it == m_raw_input_buffers.end()) {
+    it = m_raw_input_buffers.emplace(data_field, El::Matrix<uint8_t>()).first;
+    // Pin the memory so that the staging copy is asynchronous
+    it->second.SetMemoryMode(1);
+  }
+  const auto& host = *m_input_buffers.at(data_field);
+  it->second.Resize(host.LocalHeight(), host.LocalWidth());
+  return it->second;
+}
+
+template <typename TensorDataType>
+void data_buffer<TensorDataType>::stage_to_device()
+{
+  for (auto& [data_field, buffer] : m_device_buffers) {
+    stage_to_device(data_field);
+  }
+}
+
+template <typename TensorDataType>
+void data_buffer<TensorDataType>::stage_to_device(
+  data_field_type const data_field)
+{
+  auto host_it = m_input_buffers.find(data_field);
+  auto dev_it = m_device_buffers.find(data_field);
+  if (host_it == m_input_buffers.end() || dev_it == m_device_buffers.end()) {
+    LBANN_ERROR("no staging buffers for data field ", data_field);
+  }
+  // Staging may run on an I/O thread, which starts on device 0
+  hydrogen::gpu::SetDevice(hydrogen::gpu::DefaultDevice());
+  const auto& host = *host_it->second;
+  auto& dev = *dev_it->second;
+  auto on_device_it = m_fetched_on_device.find(data_field);
+  if (on_device_it != m_fetched_on_device.end() && on_device_it->second) {
+    // The data reader already wrote the mini-batch on this stream
+    m_copy_done.record(m_copy_sync_info.Stream());
+    m_staged_on_device[data_field] = true;
+    return;
+  }
+  dev.Resize(host.Height(), host.Width());
+  auto raw_it = m_fetched_raw.find(data_field);
+  if (raw_it != m_fetched_raw.end() && raw_it->second) {
+    if constexpr (std::is_same_v<TensorDataType, DataType>) {
+      // Ship the bytes and widen them on the staging stream
+      const auto& raw = m_raw_input_buffers.at(data_field);
+      const El::Int num_bytes = raw.Height() * raw.Width();
+      auto& scratch = m_raw_device_buffers[data_field];
+      El::SetSyncInfo(scratch, m_copy_sync_info);
+      scratch.Resize(
+        (num_bytes + sizeof(TensorDataType) - 1) / sizeof(TensorDataType),
+        1);
+      auto* raw_d = reinterpret_cast<uint8_t*>(scratch.Buffer());
+      hydrogen::gpu::Copy1DToDevice(raw.LockedBuffer(),
+                                    raw_d,
+                                    num_bytes,
+                                    m_copy_sync_info);
+      auto& dev_mat =
+        static_cast<El::Matrix<DataType, El::Device::GPU>&>(dev.Matrix());
+      auto conv_it = m_raw_image_conversions.find(data_field);
+      if (conv_it != m_raw_image_conversions.end()) {
+        data_packer::convert_raw_image_batch(raw_d,
+                                             conv_it->second,
+                                             raw.Width(),
+                                             dev_mat);
+      }
+      else {
+        data_packer::convert_raw_data_field(raw_d,
+                                            raw.Height(),
+                                            raw.Width(),
+                                            dev_mat);
+      }
+    }
+    else {
+      LBANN_ERROR("raw input transfer requires buffers of DataType");
+    }
+  }
+  else {
+    El::Copy(host.LockedMatrix(), dev.Matrix());
+  }
+  m_copy_done.record(m_copy_sync_info.Stream());
+  m_staged_on_device[data_field] = true;
+}
+#endif // LBANN_HAS_GPU
+
 } // namespace lbann
 
 #endif // LBANN_IO_BUFFER_HPP_IMPL_INCLUDED
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_COORDINATOR_IO_STATISTICS_HPP_INCLUDED
+#define LBANN_DATA_COORDINATOR_IO_STATISTICS_HPP_INCLUDED
+
+#include "lbann_config.hpp"
+
+#include "lbann/utils/accumulating_timer.hpp"
+#ifdef LBANN_HAS_CALIPER
+#include "lbann/utils/profiling.hpp"
+#endif // LBANN_HAS_CALIPER
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace lbann {
+
+/** @brief Stages of the input pipeline that are timed separately */
+enum class io_stage
+{
+  /** Reading a sample from its source; includes decoding when the
+   *  reader cannot separate the two */
+  read,
+  /** Decoding a sample that has already been read */
+  decode,
+  /** Applying the transform pipeline to a sample */
+  transform,
+  /** All work done on an I/O thread for one sample */
+  sample,
+  /** Packing Conduit samples into the I/O buffers */
+  pack,
+  /** Data store exchange of a mini-batch */
+  exchange,
+  /** A whole background fetch of a mini-batch */
+  fetch,
+  /** Time the training loop waits for a fetch to complete */
+  blocked,
+  NUM_IO_STAGES
+};
+
+constexpr size_t num_io_stages = static_cast<size_t>(io_stage::NUM_IO_STAGES);
+
+std::string to_string(io_stage stage);
+/** @brief Name of the profiling region of a stage */
+const char* get_io_stage_region(io_stage stage);
+
+/** @class io_stage_timer
+ *  @brief Accumulating timer that also bins each duration into a
+ *         logarithmic histogram.
+ *
+ *  Bin 0 holds durations below 1 microsecond and bin k holds
+ *  durations in [2^(k-1), 2^k) microseconds; the last bin is open.
+ */
+class io_stage_timer
+{
+public:
+  constexpr static size_t num_bins = 28;
+  using histogram_type = std::array<size_t, num_bins>;
+
+  void start() noexcept { m_timer.start(); }
+  /** @brief Stop the timer and record the duration, in seconds */
+  double stop() noexcept;
+
+  size_t samples() const noexcept { return m_timer.samples(); }
+  double total_time() const noexcept { return m_timer.total_time(); }
+  double max() const noexcept { return m_timer.max(); }
+  const histogram_type& histogram() const noexcept { return m_histogram; }
+
+  void reset_statistics() noexcept;
+
+  /** @brief Histogram bin of a duration, in seconds */
+  static size_t bin(double seconds) noexcept;
+  /** @brief Upper bound of a histogram bin, in seconds */
+  static double bin_upper_bound(size_t bin) noexcept;
+
+private:
+  AccumulatingTimer m_timer;
+  histogram_type m_histogram = {};
+}; // class io_stage_timer
+
+/** @class io_statistics
+ *  @brief One timer per I/O stage.
+ *
+ *  Not thread-safe: each I/O thread records into its own instance.
+ */
+class io_statistics
+{
+public:
+  io_stage_timer& operator[](io_stage stage)
+  {
+    return m_timers[static_cast<size_t>(stage)];
+  }
+  const io_stage_timer& operator[](io_stage stage) const
+  {
+    return m_timers[static_cast<size_t>(stage)];
+  }
+  void reset_statistics() noexcept;
+
+private:
+  std::array<io_stage_timer, num_io_stages> m_timers;
+}; // class io_statistics
+
+/** @brief Statistics of one stage merged over several timers */
+struct io_stage_summary
+{
+  size_t samples = 0;
+  double total_time = 0.;
+  double max = 0.;
+  io_stage_timer::histogram_type histogram = {};
+
+  void add(const io_stage_timer& timer);
+  void add(const io_stage_summary& other);
+  double mean() const { return samples > 0 ? total_time / samples : 0.; }
+  /** @brief Upper bound of the histogram bin holding the given
+   *         quantile, in seconds */
+  double quantile(double q) const;
+};
+
+/** @brief Statistics the calling I/O thread records into
+ *
+ *  Null unless the thread is fetching a mini-batch for a data reader.
+ */
+io_statistics* get_thread_io_statistics() noexcept;
+
+/** @brief Direct the calling thread's records for the scope's lifetime */
+class thread_io_statistics_scope
+{
+public:
+  thread_io_statistics_scope(io_statistics& stats) noexcept;
+  ~thread_io_statistics_scope() noexcept;
+  thread_io_statistics_scope(const thread_io_statistics_scope&) = delete;
+  thread_io_statistics_scope&
+  operator=(const thread_io_statistics_scope&) = delete;
+
+private:
+  io_statistics* m_previous;
+};
+
+/** @class io_stage_scope
+ *  @brief Time a stage on the calling thread, if it is recording.
+ *
+ *  With Caliper, the stage is also annotated as a profiling region,
+ *  so the input pipeline's CPU time can be measured in production
+ *  runs.
+ */
+class io_stage_scope
+{
+public:
+  io_stage_scope(io_stage stage) noexcept
+    : io_stage_scope(get_thread_io_statistics(), stage)
+  {}
+  io_stage_scope(io_statistics* stats, io_stage stage) noexcept
+    : m_timer(stats != nullptr ? &(*stats)[stage] : nullptr)
+  {
+#ifdef LBANN_HAS_CALIPER
+    m_region = get_io_stage_region(stage);
+    prof_region_begin(m_region, prof_colors[0], false);
+#endif // LBANN_HAS_CALIPER
+    if (m_timer != nullptr) {
+      m_timer->start();
+    }
+  }
+  ~io_stage_scope() noexcept
+  {
+    if (m_timer != nullptr) {
+      m_timer->stop();
+    }
+#ifdef LBANN_HAS_CALIPER
+    prof_region_end(m_region, false);
+#endif // LBANN_HAS_CALIPER
+  }
+  io_stage_scope(const io_stage_scope&) = delete;
+  io_stage_scope& operator=(const io_stage_scope&) = delete;
+
+private:
+  io_stage_timer* m_timer;
+#ifdef LBANN_HAS_CALIPER
+  const char* m_region;
+#endif // LBANN_HAS_CALIPER
+};
+
+} // namespace lbann
+#endif // LBANN_DATA_COORDINATOR_IO_STATISTICS_HPP_INCLUDED
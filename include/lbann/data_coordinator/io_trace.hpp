@@ -0,0 +1,162 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_COORDINATOR_IO_TRACE_HPP_INCLUDED
+#define LBANN_DATA_COORDINATOR_IO_TRACE_HPP_INCLUDED
+
+#include "lbann/utils/timer.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace lbann {
+
+/** @brief File operations recorded by the I/O trace */
+enum class io_trace_op : uint8_t
+{
+  open,
+  read,
+  close
+};
+
+std::string to_string(io_trace_op op);
+
+/** @brief Offset of a read whose position in the file is not known */
+constexpr uint64_t io_trace_unknown_offset = UINT64_MAX;
+
+/** @brief Binary I/O trace file header
+ *
+ *  A trace file holds the header, then the file names and the events
+ *  at the offsets given here. Each file name is a uint32 length
+ *  followed by its characters. Events are sorted by start time.
+ */
+struct io_trace_header
+{
+  char magic[8]; // "LBIOTRCE"
+  uint32_t version;
+  uint32_t num_threads;
+  uint64_t num_files;
+  uint64_t num_events;
+  uint64_t files_offset;
+  uint64_t events_offset;
+  uint64_t reserved[2];
+};
+static_assert(sizeof(io_trace_header) == 64, "unexpected header size");
+
+/** @brief One traced file operation */
+struct io_trace_event
+{
+  /** Seconds since the trace was started */
+  double start;
+  /** Duration in seconds */
+  float latency;
+  /** Index in the file names of the trace */
+  uint32_t file;
+  uint64_t offset;
+  uint64_t length;
+  /** Recording thread, numbered in order of first use */
+  uint32_t thread;
+  uint8_t op;
+  uint8_t reserved[3];
+};
+static_assert(sizeof(io_trace_event) == 40, "unexpected event size");
+
+namespace details {
+extern std::atomic<bool> io_trace_on;
+} // namespace details
+
+/** @brief Whether file operations are being traced
+ *  @details Cheap enough to check on every read. */
+inline bool io_trace_enabled() noexcept
+{
+  return details::io_trace_on.load(std::memory_order_relaxed);
+}
+
+/** @brief Start tracing the file operations of this process
+ *  @details Events already recorded are kept. */
+void io_trace_start();
+/** @brief Stop tracing */
+void io_trace_stop();
+/** @brief Record a completed file operation
+ *
+ *  Thread safe. Does nothing unless tracing is enabled.
+ *  @param start Time the operation started, from @c get_time
+ */
+void io_trace_record(io_trace_op op,
+                     const std::string& file,
+                     uint64_t offset,
+                     uint64_t length,
+                     double start,
+                     double latency);
+/** @brief Write the events recorded so far to a binary trace file */
+void io_trace_write(const std::string& path);
+
+/** @class io_trace_scope
+ *  @brief Records a file operation that lasts for its lifetime
+ *
+ *  @c file must outlive the scope.
+ */
+class io_trace_scope
+{
+public:
+  io_trace_scope(io_trace_op op,
+                 const std::string& file,
+                 uint64_t offset = io_trace_unknown_offset,
+                 uint64_t length = 0) noexcept
+    : m_file(io_trace_enabled() ? &file : nullptr),
+      m_op(op),
+      m_offset(offset),
+      m_length(length),
+      m_start(m_file != nullptr ? get_time() : 0.)
+  {}
+  ~io_trace_scope()
+  {
+    if (m_file != nullptr) {
+      io_trace_record(m_op,
+                      *m_file,
+                      m_offset,
+                      m_length,
+                      m_start,
+                      get_time() - m_start);
+    }
+  }
+  io_trace_scope(const io_trace_scope&) = delete;
+  io_trace_scope& operator=(const io_trace_scope&) = delete;
+
+  /** Set the length once it is known */
+  void set_length(uint64_t length) noexcept { m_length = length; }
+
+private:
+  const std::string* m_file;
+  io_trace_op m_op;
+  uint64_t m_offset;
+  uint64_t m_length;
+  double m_start;
+};
+
+} // namespace lbann
+#endif // LBANN_DATA_COORDINATOR_IO_TRACE_HPP_INCLUDED
@@ -0,0 +1,119 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_COORDINATOR_IO_WORKER_POOL_HPP_INCLUDED
+#define LBANN_DATA_COORDINATOR_IO_WORKER_POOL_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/data_readers/data_reader.hpp"
+
+#include <sys/types.h>
+
+#include <map>
+#include <vector>
+
+namespace lbann {
+
+/** @class io_worker_pool
+ *  @brief Node-local processes that load samples for one data reader
+ *
+ *  The workers are forked from the training process, so each one
+ *  holds a copy of the reader as it was when the pool was created.
+ *  A mini-batch is split into contiguous runs of samples, one per
+ *  worker; each worker loads its run with
+ *  generic_data_reader::fetch_samples() into a shared memory region
+ *  and the training process copies the samples into its buffers.
+ *  Decoding and transforms thus run outside the training process
+ *  and do not compete with it for its cores or its allocator.
+ *
+ *  Workers never make MPI or GPU calls. Indices are sent with each
+ *  request, so the workers follow the shuffle of the training
+ *  process. A sample matches the one fetch() would load, since both
+ *  seed its I/O RNGs from its position in the mini-batch.
+ */
+class io_worker_pool
+{
+public:
+  /** @brief Fork @c num_workers processes for @c reader
+   *
+   *  @param field_heights Height of each data field that is fetched
+   *  @param max_samples   Largest number of samples in a fetch
+   *
+   *  Must be called while no I/O thread of the reader is running.
+   */
+  io_worker_pool(generic_data_reader& reader,
+                 int num_workers,
+                 const std::map<data_field_type, El::Int>& field_heights,
+                 El::Int max_samples);
+  ~io_worker_pool();
+
+  io_worker_pool(const io_worker_pool&) = delete;
+  io_worker_pool& operator=(const io_worker_pool&) = delete;
+
+  int get_num_workers() const { return m_workers.size(); }
+
+  /** @brief Load the samples with the given indices
+   *
+   *  Sample @c s is copied into column @c s of each buffer, which
+   *  must have the height given to the constructor and at least
+   *  <tt>indices.size()</tt> columns.
+   */
+  void fetch(std::map<data_field_type, CPUMat*>& input_buffers,
+             const std::vector<int>& indices,
+             size_t fetch_sequence);
+
+private:
+  struct worker
+  {
+    pid_t pid;
+    /** Socket connected to the worker */
+    int fd;
+  };
+
+  /** Location of a data field in the shared memory region */
+  struct field_layout
+  {
+    El::Int height;
+    size_t offset;
+  };
+
+  /** @brief Serve requests until the training process goes away */
+  [[noreturn]] void run_worker(generic_data_reader& reader, int fd);
+
+  /** @brief Views of columns [first, first + count) of each field */
+  std::map<data_field_type, CPUMat> get_shared_views(El::Int first,
+                                                     El::Int count);
+
+  std::vector<worker> m_workers;
+  std::map<data_field_type, field_layout> m_fields;
+  El::Int m_max_samples;
+  void* m_shared = nullptr;
+  size_t m_shared_size = 0;
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_COORDINATOR_IO_WORKER_POOL_HPP_INCLUDED
@@ -31,15 +31,19 @@
 
 #include "lbann/base.hpp"
 #include "lbann/data_coordinator/data_coordinator_metadata.hpp"
+#include "lbann/data_coordinator/io_statistics.hpp"
 #include "lbann/data_readers/utils/input_data_type.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/transforms/transform_pipeline.hpp"
 #include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/feistel_permutation.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/random_number_generators.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <functional>
 #include <string>
 #include <unistd.h>
 #include <unordered_set>
@@ -62,6 +66,9 @@ namespace lbann {
 // Forward declarations
 class Layer;
 class data_store_conduit;
+namespace data_packer {
+struct raw_image_conversion;
+}
 class thread_pool;
 class trainer;
 class persist;
@@ -86,6 +93,7 @@ public:
       m_comm(nullptr),
       m_mini_batch_size(0),
       m_current_pos(0),
+      m_fetch_pos(0),
       m_stride_to_next_mini_batch(0),
       m_base_offset(0),
       m_model_offset(0),
@@ -180,6 +188,16 @@ public:
    */
   std::string get_data_sample_list() const;
 
+  /**
+   * Returns where --sample_list_cache keeps the binary copy of a
+   * sample list, and whether that copy exists. The path is empty if
+   * the option is not set or the list is already binary. The trainer
+   * master checks for the copy, so that every rank of a trainer loads
+   * the same list.
+   */
+  std::pair<std::string, bool>
+  find_sample_list_cache(const std::string& sample_list_file) const;
+
   /**
    * To facilictate the testing, maintain the order of loaded samples
    * in the sample list as it is in the list file.
@@ -282,6 +300,13 @@ public:
    */
   std::string get_role() const { return m_role; }
 
+  /**
+   * Whether load() is deferred until the data set is first used, see
+   * data_coordinator::load_deferred_reader.
+   */
+  void set_load_deferred(bool deferred) { m_load_deferred = deferred; }
+  bool is_load_deferred() const { return m_load_deferred; }
+
   /**
    * Load the dataset.
    * Each data reader implementation should implement this to initialize its
@@ -312,6 +337,59 @@ public:
             El::Matrix<El::Int>& indices_fetched,
             size_t mb_size);
 
+  /** @brief Fetch the mini-batch that starts at position 'pos'
+   *
+   * Used by the data coordinator to load mini-batches ahead of the
+   * reader's current position; see get_mini_batch_cursor().
+   */
+  int fetch(std::map<data_field_type, CPUMat*>& input_buffers,
+            El::Matrix<El::Int>& indices_fetched,
+            size_t mb_size,
+            int pos,
+            bool next_epoch = false);
+
+  int fetch(std::vector<conduit::Node>& samples,
+            El::Matrix<El::Int>& indices_fetched,
+            size_t mb_size,
+            int pos,
+            bool next_epoch = false);
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Returns true if the reader can generate the samples field
+   *  of a mini-batch in GPU memory with fetch_to_device() */
+  virtual bool supports_device_fetch() const { return false; }
+
+  /** @brief Generate the samples of the mini-batch that starts at
+   *  position 'pos' directly into a device matrix
+   *
+   * Only the samples field is produced. Kernels are launched on
+   * the sync info of @c X, so the caller must not read the host
+   * copy of the field.
+   */
+  int fetch_to_device(El::Matrix<DataType, El::Device::GPU>& X,
+                      El::Matrix<El::Int>& indices_fetched,
+                      size_t mb_size,
+                      int pos,
+                      bool next_epoch = false);
+
+  /** @brief Returns true if fetch() can leave the samples field as
+   *  uint8 images that the GPU converts as described by @c conv
+   *
+   *  The images are written to the buffer given to
+   *  set_raw_samples_buffer(), which has one byte per element of the
+   *  samples field.
+   */
+  virtual bool
+  get_raw_image_conversion(data_packer::raw_image_conversion& conv) const
+  {
+    return false;
+  }
+
+  /** @brief Byte matrix that fetch() writes the samples field to
+   *  instead of its input buffer, or nullptr to fetch it normally */
+  void set_raw_samples_buffer(El::Matrix<uint8_t>* X) { m_raw_samples = X; }
+#endif // LBANN_HAS_GPU
+
   /** @brief Check to see if the data reader supports this specific data field
    */
   virtual bool has_data_field(data_field_type data_field) const
@@ -351,9 +429,163 @@ public:
     m_supported_input_types[INPUT_DATA_TYPE_RESPONSES] = b;
   }
 
-  void start_data_store_mini_batch_exchange();
+  /** @brief Start the data store exchange for the mini-batch that is
+   *  'steps_ahead' steps after the current one */
+  void start_data_store_mini_batch_exchange(int steps_ahead = 0);
   void finish_data_store_mini_batch_exchange();
 
+  /** @brief Position and sizes of one mini-batch of the current epoch */
+  struct mini_batch_cursor
+  {
+    /** @brief Position of the mini-batch in the shuffled indices */
+    int pos;
+    /** @brief Number of samples this reader loads for the mini-batch */
+    int loaded_mini_batch_size;
+    /** @brief Mini-batch size seen by the model for the mini-batch */
+    int current_mini_batch_size;
+    /** @brief Whether the mini-batch belongs to the next epoch, whose
+     *  indices are prepared by shuffle_next_epoch_indices() */
+    bool next_epoch;
+  };
+
+  /** @brief Returns the cursor of the mini-batch 'n' steps after the
+   *  current one
+   *
+   * Replays update() without modifying the reader's state, so for
+   * n == 0 this is the current mini-batch. Returns false if the
+   * mini-batch falls past the end of the current epoch, or, when
+   * cross_epoch is set, past the end of the next one.
+   */
+  bool get_mini_batch_cursor(int n,
+                             mini_batch_cursor& cursor,
+                             bool cross_epoch = false) const;
+
+  /** @brief Returns true if mini-batches of the next epoch may be
+   *  fetched before the current epoch ends
+   *
+   * Readers whose shuffle has side effects, or whose samples come
+   * from a data store, must see the shuffle happen in update().
+   */
+  virtual bool supports_cross_epoch_fetch() const
+  {
+    return m_data_store == nullptr;
+  }
+
+  /** @brief Returns true if forked I/O worker processes may load
+   *  samples with fetch_samples()
+   *
+   * Workers hold a copy of the reader taken when they are forked, so
+   * readers that share open files, interpreter state or a data store
+   * across samples must load them in the training process.
+   */
+  virtual bool supports_io_worker_processes()
+  {
+    return m_data_store == nullptr && !has_conduit_output();
+  }
+
+  /** @brief Indices of the samples that a fetch at @c pos reads
+   *
+   * Returns no indices if @c pos is overrun, as fetch() does.
+   */
+  std::vector<int>
+  get_mini_batch_indices(int pos, El::Int mb_size, bool next_epoch = false);
+
+  /** @brief Starts a new mini-batch; the returned value seeds the
+   *  per-sample I/O RNGs of fetch_samples() */
+  size_t claim_fetch_sequence() { return ++m_fetch_sequence; }
+
+  /** @brief Loads @c count samples on the calling thread
+   *
+   * Sample @c s is written to column @c s of each buffer and draws
+   * its random transforms as the sample at <tt>first_sample + s</tt>
+   * of mini-batch @c fetch_sequence would in fetch().
+   */
+  void fetch_samples(std::map<data_field_type, CPUMat*>& input_buffers,
+                     const int* indices,
+                     El::Int count,
+                     size_t fetch_sequence,
+                     El::Int first_sample);
+
+  /** @brief Shuffles the indices of the next epoch ahead of time
+   *
+   * update() installs them at the end of the epoch instead of
+   * shuffling, so the random sequence matches an unprefetched run.
+   */
+  void shuffle_next_epoch_indices();
+
+  /** @brief Whether the next epoch's indices have been prepared */
+  bool next_epoch_is_shuffled() const { return m_next_epoch_is_shuffled; }
+
+  /** @brief Whether epochs are shuffled by a seeded permutation of
+   *  sample positions rather than by reordering the indices
+   *
+   * Set with --permutation_shuffle. Each position is then mapped to
+   * an index on demand, so an epoch is shuffled in constant time and
+   * every rank computes the same order without storing it. Not used
+   * by readers whose shuffle has side effects, by the data store or
+   * with length bucketing, which all need the order materialized,
+   * nor by readers that draw their own order in shuffle_index_order().
+   */
+  virtual bool use_permutation_shuffle() const;
+
+  /** @brief Index of the sample at position @c pos of the current
+   *  epoch's order */
+  int get_shuffled_index(int pos) const
+  {
+    return m_permutation.size() == 0 ? m_shuffled_indices[pos]
+                                     : m_shuffled_indices[m_permutation(pos)];
+  }
+
+  /** @brief Returns true if the reader knows the unpadded length of
+   *  each sample (see get_sample_length()) */
+  virtual bool has_sample_lengths() const { return false; }
+
+  /** @brief Number of leading, non-padding entries of a sample */
+  virtual int get_sample_length(int index) const
+  {
+    NOT_IMPLEMENTED("get_sample_length");
+    return 0;
+  }
+
+  /** @brief Returns true if samples are stored several to a file (see
+   *  get_sample_file_id()) */
+  virtual bool has_sample_files() const { return false; }
+
+  /** @brief Identifier of the file that holds a sample */
+  virtual size_t get_sample_file_id(int index) const
+  {
+    NOT_IMPLEMENTED("get_sample_file_id");
+    return 0;
+  }
+
+  /** @brief Group the shuffled indices into mini-batches of samples of
+   *  similar length
+   *
+   * A no-op unless --sequence_bucket_window is set and the reader has
+   * sample lengths. Called by shuffle_indices(), and by the data
+   * coordinator once the mini-batch stride is known.
+   */
+  virtual void bucket_shuffled_indices();
+
+  /** @brief Returns the data store positions and sizes of (up to) the next
+   *  'n' mini-batches this reader will load in the current epoch
+   *
+   * Positions are relative to the base and model offsets, as passed to
+   * data_store_conduit::start_exchange_mini_batch_data(). The list stops
+   * at the end of the epoch, since the indices are reshuffled there.
+   */
+  std::vector<std::pair<size_t, size_t>>
+  get_upcoming_mini_batches(int n) const;
+
+  /** @brief Per-stage timings recorded by each I/O thread
+   *
+   *  Only read them while no fetch is running.
+   */
+  const std::vector<io_statistics>& get_io_thread_statistics() const
+  {
+    return m_io_thread_statistics;
+  }
+
   /**
    * During the network's update phase, the data reader will
    * advanced the current position pointer.  If the pointer wraps
@@ -397,18 +629,22 @@ public:
   }
 
   /// True if the data reader's current position is valid.
-  virtual bool position_valid() const
-  {
-    return (m_current_pos < get_num_data());
-  }
+  virtual bool position_valid() const { return position_valid(m_current_pos); }
+  /// True if the given position is valid.
+  bool position_valid(int pos) const { return (pos < get_num_data()); }
   /// True if the data reader's current position is not valid but within # ranks
   /// per model of the end of the data set (e.g. it is a rank with no valid data
   /// on the last iteration)
   virtual bool position_is_overrun() const
+  {
+    return position_is_overrun(m_current_pos);
+  }
+  /// True if the given position is overrun, as for position_is_overrun()
+  bool position_is_overrun(int pos) const
   {
     int end_pos = (int)m_shuffled_indices.size();
-    return (m_current_pos >= end_pos &&
-            (m_current_pos - end_pos) < m_comm->get_procs_per_trainer());
+    return (pos >= end_pos &&
+            (pos - end_pos) < m_comm->get_procs_per_trainer());
   }
   /// True if the data reader is at the start of an epoch.
   bool at_new_epoch() const
@@ -573,6 +809,13 @@ public:
    */
   virtual void use_unused_index_set(execution_mode m);
 
+  /**
+   * Keep only this trainer's share of the samples, so that the
+   * trainers together cover the data set once. Every trainer must
+   * hold the same samples. This is collective over the world.
+   */
+  void shard_across_trainers();
+
   /// Does the data reader have a unique sample list per model
   virtual bool has_list_per_model() const { return false; }
   /// Does the data reader have a unique sample list per trainer
@@ -610,6 +853,21 @@ public:
 
   virtual void preload_data_store();
 
+  /** @brief Shared driver for threaded do_preload_data_store()
+   *  implementations
+   *
+   *  The indices this rank owns are grouped by @c group_of (typically
+   *  the file a sample lives in) and whole groups are handed to the I/O
+   *  threads, so each file is opened by one thread, once. @c load_group
+   *  is called once per group with its indices in shuffled order.
+   *  Groups are loaded on the calling thread when @c allow_threads is
+   *  false or --data_store_no_thread is given.
+   */
+  void preload_data_store_in_parallel(
+    const std::function<size_t(int)>& group_of,
+    const std::function<void(const std::vector<int>&)>& load_group,
+    bool allow_threads = true);
+
   void set_gan_labelling(bool has_gan_labelling)
   {
     m_gan_labelling = has_gan_labelling;
@@ -626,6 +884,10 @@ public:
 
   virtual bool priming_data_store() const;
 
+  /** @brief Returns true if this reader can load samples the data store
+   *  did not cache (see --data_store_mem_budget_mb) from file itself */
+  virtual bool supports_partial_data_store() const { return false; }
+
   /// experimental; used to ensure all readers for jag_conduit_hdf5
   /// have identical shuffled indices
   virtual void post_update() {}
@@ -673,6 +935,14 @@ protected:
 
   lbann_comm* m_comm;
 
+  /** @brief Loads samples of the mini-batch being fetched
+   *
+   *  Every I/O thread runs this with its own block_offset (the thread
+   *  index, which selects its I/O RNG). Samples are not statically
+   *  strided across threads: each one claims the next unloaded sample
+   *  (see claim_next_sample()), so one slow sample does not leave the
+   *  other threads idle.
+   */
   virtual bool
   fetch_data_block(std::map<data_field_type, CPUMat*>& input_buffers,
                    El::Int block_offset,
@@ -680,12 +950,71 @@ protected:
                    El::Int mb_size,
                    El::Matrix<El::Int>& indices_fetched);
 
+#ifdef LBANN_HAS_GPU
+  /** @brief Generates @c mb_size samples into @c X on its stream;
+   *  called by fetch_to_device() */
+  virtual bool fetch_data_block_to_device(
+    El::Matrix<DataType, El::Device::GPU>& X,
+    El::Int mb_size,
+    El::Matrix<El::Int>& indices_fetched)
+  {
+    NOT_IMPLEMENTED("fetch_data_block_to_device");
+    return false;
+  }
+#endif // LBANN_HAS_GPU
+
+  /** @brief Called by fetch() before the I/O threads load the
+   *  @c mb_size samples at m_fetch_pos
+   *
+   *  Passes the indices of this mini-batch, and of the next one of the
+   *  pass, to prepare_samples().
+   */
+  void prepare_mini_batch(El::Int mb_size);
+
+  /** @brief Called on the fetching thread with the indices of the
+   *  samples about to be fetched, and of those expected next
+   *
+   *  Readers can load the samples that share a file together, or start
+   *  reading ahead. Compound readers forward the indices to the readers
+   *  they hold, so that those see whole mini-batches too.
+   */
+  virtual void prepare_samples(const std::vector<int>& indices,
+                               const std::vector<int>& next_indices)
+  {}
+
+  /** @brief Loads every field of one sample into column @c mb_idx */
+  void fetch_sample_fields(std::map<data_field_type, CPUMat*>& input_buffers,
+                           int index,
+                           El::Int mb_idx);
+
   bool fetch_data_block_conduit(std::vector<conduit::Node>& samples,
                                 El::Int block_offset,
                                 El::Int block_stride,
                                 El::Int mb_size,
                                 El::Matrix<El::Int>& indices_fetched);
 
+  /** @brief Returns the next sample of the mini-batch being fetched
+   *  that no I/O thread has claimed yet
+   *
+   *  The I/O RNGs of the calling thread are reseeded from the sample's
+   *  position, so random transforms do not depend on which thread
+   *  loads a sample.
+   */
+  El::Int claim_next_sample();
+
+  /** @brief Points the fetch at the order of the current or next
+   *  epoch */
+  void select_fetch_epoch(bool next_epoch);
+
+  /** @brief Index of the sample at position @c pos of the order
+   *  being fetched */
+  int get_fetch_index(int pos) const
+  {
+    return m_fetch_permutation->size() == 0
+             ? (*m_fetch_indices)[pos]
+             : (*m_fetch_indices)[(*m_fetch_permutation)(pos)];
+  }
+
   /** @brief Called by fetch_data, fetch_label, fetch_response
    *
    * Fetch data from a single data field into a matrix.
@@ -774,9 +1103,75 @@ protected:
   /// Shuffle indices and profide a random number generator
   virtual void shuffle_indices(rng_gen& gen);
 
+  /** @brief Generator of the shuffle at the start of an epoch
+   *
+   * Seeded from the shuffle seed and the number of epochs since setup,
+   * and applied to the sorted indices, so the order of an epoch can be
+   * drawn again from the index set after a restart.
+   */
+  rng_gen get_epoch_shuffle_generator(uint64_t epoch) const;
+
+  /// Draw again the order of the current epoch after a restart
+  void restore_epoch_order();
+
+  /** @brief Draws a shuffled order of @c indices
+   *
+   * Used for the first shuffle and for each epoch's reshuffle. The
+   * default is a uniform shuffle followed by length bucketing; readers
+   * whose samples are laid out in large files may keep neighbouring
+   * samples close together instead.
+   */
+  virtual void shuffle_index_order(std::vector<int>& indices,
+                                   rng_gen& gen) const;
+
+  /** @brief Shuffle indices file by file
+   *
+   * Files are visited in a random order and the samples of each are
+   * shuffled. The output then draws each sample from a random one of
+   * a sliding window of --shuffle_file_window files, which is refilled
+   * in file order as files run out. Returns false, leaving the indices
+   * untouched, if the option is not set or samples are not grouped by
+   * file.
+   */
+  bool shuffle_indices_by_file(std::vector<int>& indices, rng_gen& gen) const;
+
+  /** @brief Reorder indices so that each window of
+   *  --sequence_bucket_window mini-batches is sorted by sample length
+   *
+   * Returns true if the indices were reordered.
+   */
+  bool bucket_indices_by_length(std::vector<int>& indices) const;
+
 public:
   int m_mini_batch_size;
   int m_current_pos;
+  /// Position of the mini-batch being fetched; it leads m_current_pos
+  /// when the data coordinator loads mini-batches ahead of the model
+  int m_fetch_pos;
+  /// Next unclaimed sample of the mini-batch being fetched; only
+  /// valid while fetch() runs
+  std::atomic<El::Int>* m_fetch_cursor = nullptr;
+  /// Indices of the mini-batch being fetched; either
+  /// m_shuffled_indices or m_next_shuffled_indices
+  const std::vector<int>* m_fetch_indices = nullptr;
+  /// Order of the mini-batch being fetched; either m_permutation or
+  /// m_next_permutation
+  const feistel_permutation* m_fetch_permutation = nullptr;
+  /// Shuffled indices of the next epoch, when prepared early
+  std::vector<int> m_next_shuffled_indices;
+  /// Order of the current and next epochs under a permutation
+  /// shuffle; empty when m_shuffled_indices holds the order itself
+  feistel_permutation m_permutation;
+  feistel_permutation m_next_permutation;
+  bool m_next_epoch_is_shuffled = false;
+  /// Seed of the epoch shuffles, drawn during setup
+  uint64_t m_shuffle_seed = 0;
+  /// Number of epochs completed since setup
+  uint64_t m_shuffle_epoch = 0;
+  /// Number of mini-batches fetched, used to seed per-sample I/O RNGs
+  size_t m_fetch_sequence = 0;
+  /// Per-stage timings, indexed by the I/O thread's block offset
+  std::vector<io_statistics> m_io_thread_statistics;
   /// Batch Stride is typically batch_size, but may be a multiple of batch size
   /// if there are multiple readers
   int m_stride_to_next_mini_batch;
@@ -854,6 +1249,9 @@ private:
 protected:
   bool m_use_data_store = false;
 
+  /** Whether load() has not been called yet, see set_load_deferred */
+  bool m_load_deferred = false;
+
   /** @brief Holds a true value for each input data type that is supported.
    *  Use an ordered map so that checkpoints are stable. */
   std::map<data_field_type, bool> m_supported_input_types;
@@ -873,6 +1271,11 @@ protected:
   /** Transform pipeline for preprocessing data. */
   transform::transform_pipeline m_transform_pipeline;
 
+#ifdef LBANN_HAS_GPU
+  /** Where fetch() writes raw samples; see set_raw_samples_buffer() */
+  El::Matrix<uint8_t>* m_raw_samples = nullptr;
+#endif // LBANN_HAS_GPU
+
   /// for use with data_store: issue a warning a single time if m_data_store !=
   /// nullptr, but we're not retrieving a conduit::Node from the store. This
   /// typically occurs during the test phase
@@ -70,6 +70,13 @@ public:
 
   bool fetch_conduit_node(conduit::Node& sample, int data_id) override;
 
+  /** Loads the samples of the mini-batch that the data store left on
+   *  disk, one file at a time */
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
+  bool supports_partial_data_store() const override { return true; }
+
   /** @brief Sets the name of the yaml experiment file */
   void set_experiment_schema_filename(std::string fn)
   {
@@ -200,6 +207,36 @@ private:
   /** maps: Node's path -> the Node */
   std::unordered_map<std::string, conduit::Node> m_useme_node_map;
 
+  /** Processing directives of a field that is read from disk, resolved
+   *  from its metadata node once by compile_field_plans() so that
+   *  load_sample() does not walk the schema for every sample */
+  struct field_plan
+  {
+    enum class coercion
+    {
+      none,
+      to_float,
+      to_double
+    };
+    std::string pathname;
+    coercion coerce_to = coercion::none;
+    /** one entry per channel; empty when the field is not normalized */
+    std::vector<double> scale;
+    std::vector<double> bias;
+    /** HWC images with more than one channel are repacked to CHW */
+    bool repack = false;
+    int64_t channels = 1;
+    int64_t rows = 0;
+    int64_t cols = 0;
+  };
+
+  /** One entry per non-composite field of m_useme_node_map */
+  std::vector<field_plan> m_field_plans;
+
+  /** Samples of the mini-batch being fetched that are not in the data
+   *  store; filled by prepare_samples() */
+  std::unordered_map<int, conduit::Node> m_mini_batch_samples;
+
   /** Schema supplied by the user; this contains a listing of the fields
    *  that will be used in an experiment; additionally may contain processing
    *  directives related to type coercion, packing, etc.
@@ -238,6 +275,14 @@ private:
    */
   void parse_schemas();
 
+  /** Fills in m_field_plans from m_useme_node_map; schema errors are
+   *  reported here rather than while loading samples */
+  void compile_field_plans();
+
+  /** Resolves the processing directives of one field */
+  field_plan compile_field_plan(const std::string& pathname,
+                                const conduit::Node& metadata) const;
+
   /** get pointers to all nodes in the subtree rooted at the 'starting_node;'
    *  keys are the pathnames; recursive. However, ignores any nodes named
    *  "metadata" (or whatever 's_metadata_node_name' is set to).
@@ -273,6 +318,14 @@ private:
   void
   load_sample(conduit::Node& node, size_t index, bool ignore_failure = false);
 
+  /** As above, but reads from an already open file that contains the
+   *  sample; used by the threaded preload */
+  void load_sample(conduit::Node& node,
+                   hid_t file_handle,
+                   const std::string& sample_name,
+                   size_t index,
+                   bool ignore_failure = false);
+
   /** Performs packing, normalization, etc. Called by load_sample. */
   void pack_data(conduit::Node& node_in_out);
 
@@ -304,6 +357,15 @@ private:
               const std::string& new_pathname,
               conduit::Node& node);
 
+  /** As above, with the target type already resolved */
+  void coerce(field_plan::coercion coerce_to,
+              hid_t file_handle,
+              const std::string& original_path,
+              conduit::Node& leaf);
+
+  /** Applies the normalization and repacking of a compiled plan */
+  void process_field(conduit::Node& leaf, const field_plan& plan);
+
   void normalize(conduit::Node& node,
                  const std::string& path,
                  const conduit::Node& metadata);
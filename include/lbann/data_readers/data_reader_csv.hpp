@@ -30,10 +30,58 @@
 #define LBANN_DATA_READER_CSV_HPP
 
 #include "data_reader.hpp"
+#include <cstdint>
+#include <memory>
 #include <unordered_map>
 
 namespace lbann {
 
+/** @brief Header of the columnar cache that csv_reader writes next to
+ *  a CSV file (<file>.lbcol)
+ *
+ *  The header is followed by a table of @c num_columns entries and the
+ *  columns themselves, each holding one value per row and starting on
+ *  a 64 byte boundary. The rest of the header records the CSV file and
+ *  the reader settings the cache was built from.
+ */
+struct csv_column_header
+{
+  char magic[8];         ///< "LBCSVCOL"
+  uint32_t version;      ///< Format version (1)
+  uint32_t value_size;   ///< sizeof(DataType) of the build
+  uint64_t csv_size;     ///< Size of the CSV file in bytes
+  int64_t csv_mtime;     ///< Modification time of the CSV file
+  uint64_t num_rows;     ///< Number of samples
+  uint32_t num_cols;     ///< Number of columns in the CSV file
+  uint32_t num_columns;  ///< Number of columns in the cache
+  int32_t skip_rows;     ///< Reader settings, as set before load()
+  int32_t skip_cols;
+  int32_t label_col;
+  int32_t response_col;
+  int32_t num_labels;    ///< Number of label classes
+  uint8_t has_header;
+  uint8_t disable_labels;
+  uint8_t disable_responses;
+  char separator;
+  char reader_type[32];  ///< get_type() of the reader that built it
+  uint64_t reserved[3];
+};
+
+/// Entry of the column table of a csv_column_header
+struct csv_column_entry
+{
+  /// Data and response columns hold DataType values, labels int32_t
+  enum kind_t : uint32_t
+  {
+    DATA = 0,
+    LABEL = 1,
+    RESPONSE = 2
+  };
+  uint32_t kind;
+  int32_t source_col; ///< Column of the CSV file
+  uint64_t offset;    ///< Byte offset of the column in the cache
+};
+
 /**
  * Data reader for CSV (and similar) files.
  * This will parse a header to determine how many columns of data there are, and
@@ -56,6 +104,9 @@ public:
 
   std::string get_type() const override { return "csv_reader"; }
 
+  /// Forked workers would share the offsets of the open ifstreams
+  bool supports_io_worker_processes() override { return false; }
+
   /// Set the label column.
   void set_label_col(int col) { m_label_col = col; }
   /// Set the response column.
@@ -161,6 +212,21 @@ protected:
   /// Skip rows in an ifstream.
   void skip_rows(std::ifstream& s, int rows);
 
+  /**
+   * Memory map the columnar cache next to the CSV file, building it first
+   * if it is missing or stale. Returns false if the cache could not be
+   * written, in which case load() parses the text as usual.
+   */
+  bool load_column_cache();
+  /// Header that a cache of the CSV file with the current settings has.
+  csv_column_header expected_column_header(const std::string& csv_path) const;
+  /// Whether the cache was built from the CSV file with these settings.
+  bool is_column_cache_current(const std::string& csv_path,
+                               const std::string& cache_path) const;
+  /// Parse the CSV file with a pool of threads and write the cache.
+  void write_column_cache(const std::string& csv_path,
+                          const std::string& cache_path);
+
   /// Initialize the ifstreams vector.
   void setup_ifstreams();
 
@@ -207,6 +273,11 @@ protected:
   std::vector<int> m_labels;
   /// Store responses.
   std::vector<DataType> m_responses;
+  /// Memory mapped columnar cache, when it is used.
+  std::shared_ptr<const void> m_column_cache;
+  /// Data columns of the cache, in the order fetch_line_label_response
+  /// returns them.
+  std::vector<const DataType*> m_columns;
   /// Per-column transformation functions.
   std::unordered_map<int, std::function<DataType(const std::string&)>>
     m_col_transforms;
@@ -92,7 +92,7 @@ public:
 
   void do_preload_data_store() override;
 
-  void load_conduit_node_from_file(int data_id, conduit::Node& node);
+  virtual void load_conduit_node_from_file(int data_id, conduit::Node& node);
 
 protected:
   void copy_members(const image_data_reader& rhs);
@@ -0,0 +1,141 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_image_shards .hpp .cpp - data reader class for image datasets
+//                                      packed into shard files
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READER_IMAGE_SHARDS_HPP
+#define LBANN_DATA_READER_IMAGE_SHARDS_HPP
+
+#include "data_reader_imagenet.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lbann {
+
+/**
+ * Reads encoded images that are concatenated into large shard files, so
+ * that a mini-batch is loaded with a few large sequential reads rather
+ * than one file open per sample.
+ *
+ * The data file is a text index, as written by tools/build_image_shards:
+ *
+ *     image_shards 1
+ *     <number of shards>
+ *     <shard file> <number of records>
+ *     <offset> <size> <label>
+ *     ...
+ *
+ * where each shard line is followed by the offset, size and label of
+ * each of its records. Shard files are relative to the index's directory.
+ *
+ * When shuffling, the shards are visited in a random order, each front to
+ * back, and a shuffle buffer of --shard_shuffle_buffer samples mixes the
+ * samples of neighbouring records. Each I/O thread reads
+ * --shard_readahead_size bytes at once and serves the following records
+ * from that block. The data store is not used by this reader.
+ */
+class image_shard_reader : public imagenet_reader
+{
+public:
+  image_shard_reader(bool shuffle = true);
+  image_shard_reader(const image_shard_reader&) = default;
+  image_shard_reader& operator=(const image_shard_reader&) = default;
+  ~image_shard_reader() override = default;
+
+  image_shard_reader* copy() const override
+  {
+    return new image_shard_reader(*this);
+  }
+
+  std::string get_type() const override { return "image_shard_reader"; }
+
+  void load() override;
+
+  void setup(int num_io_threads,
+             observer_ptr<thread_pool> io_thread_pool) override;
+
+  /// The order of each epoch is drawn by shuffle_index_order()
+  bool use_permutation_shuffle() const override { return false; }
+
+protected:
+  bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
+
+  void shuffle_index_order(std::vector<int>& indices,
+                           rng_gen& gen) const override;
+
+private:
+  /// Location of an encoded image in a shard file
+  struct shard_record
+  {
+    int shard;
+    uint64_t offset;
+    uint64_t size;
+  };
+
+  /// File descriptors of the shards, opened on first use and shared by
+  /// the copies of the reader
+  struct shard_files
+  {
+    std::vector<std::string> paths;
+    std::vector<int> fds;
+    std::mutex mutex;
+
+    ~shard_files();
+    int get(int shard);
+  };
+
+  /// Block of a shard most recently read by an I/O thread
+  struct readahead_block
+  {
+    int shard = -1;
+    uint64_t begin = 0;
+    std::vector<uint8_t> data;
+  };
+
+  /// Parses the shard index into m_records and m_labels
+  void read_shard_index(const std::string& index_file);
+
+  /** Returns a pointer to the encoded image of a record, which stays
+   *  valid until the calling thread reads its next record */
+  uint8_t* read_record(const shard_record& record);
+
+  std::shared_ptr<shard_files> m_shard_files;
+  /// One past the last byte of each shard that holds a record
+  std::vector<uint64_t> m_shard_ends;
+  std::vector<shard_record> m_records;
+  std::vector<readahead_block> m_readahead;
+  size_t m_readahead_size = 0;
+  size_t m_shuffle_buffer_size = 0;
+};
+
+} // namespace lbann
+
+#endif // LBANN_DATA_READER_IMAGE_SHARDS_HPP
@@ -44,10 +44,36 @@ public:
 
   std::string get_type() const override { return "imagenet_reader"; }
 
+#ifdef LBANN_HAS_GPU
+  /** Available when the transforms end in to_lbann_layout (or
+   *  normalize_to_lbann_layout) and affine transforms */
+  bool get_raw_image_conversion(
+    data_packer::raw_image_conversion& conv) const override;
+#endif // LBANN_HAS_GPU
+
+  /** Decode and shrink the image if --image_cache_short_side is set */
+  void load_conduit_node_from_file(int data_id, conduit::Node& node) override;
+
 protected:
   void set_defaults() override;
   virtual CPUMat create_datum_view(CPUMat& X, const int mb_idx) const;
   bool fetch_datum(CPUMat& X, int data_id, int mb_idx) override;
+  /** Decode an image, apply the transforms and write it to column
+   *  mb_idx of X, or of the raw samples buffer if one is set */
+  void decode_datum(El::Matrix<uint8_t>& encoded_image, CPUMat& X, int mb_idx);
+  /** Apply the transforms from begin to a decoded image and write it to
+   *  column mb_idx of X, or of the raw samples buffer if one is set */
+  void transform_datum(El::Matrix<uint8_t>& image,
+                       std::vector<size_t>& dims,
+                       size_t begin,
+                       CPUMat& X,
+                       int mb_idx);
+
+  /** Fuse decoding with the first transform (see --fused_image_decode) */
+  bool m_fused_decode;
+  /** Short side of the decoded images cached in the data store, or 0 to
+   *  cache encoded images (see --image_cache_short_side) */
+  int m_image_cache_short_side;
 };
 
 } // namespace lbann
@@ -32,6 +32,8 @@
 #include "conduit/conduit.hpp"
 #include "hdf5.h"
 #include "lbann/data_readers/data_reader.hpp"
+#include <future>
+#include <list>
 #include <map>
 #include <memory>
 #include <set>
@@ -312,12 +314,31 @@ protected:
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_label(CPUMat& X, int data_id, int mb_idx) override;
 
+  /** Read the samples of the mini-batch bundle by bundle before the I/O
+   *  threads run, and start reading the next mini-batch in the background
+   */
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
 #ifndef _JAG_OFFLINE_TOOL_MODE_
   using generic_data_reader::shuffle_indices;
 
   /// Shuffle sammple indices using a different RNG
   void shuffle_indices(rng_gen& gen) override;
 
+  /// Samples are bundled into files
+  bool has_sample_files() const override { return true; }
+  size_t get_sample_file_id(int index) const override
+  {
+    return m_sample_list[index].first;
+  }
+
+  /// The shuffle updates the file usage, so it cannot run early
+  bool supports_cross_epoch_fetch() const override { return false; }
+
+  /// Samples are read through the sample list's file handles
+  bool supports_io_worker_processes() override { return false; }
+
   /**
    * Compute the number of parallel readers based on the type of io_buffer,
    * the mini batch size, the requested number of parallel readers.
@@ -489,6 +510,25 @@ protected:
                       const std::string& field_name,
                       int data_id,
                       conduit::Node& node);
+
+  using mini_batch_samples_t = std::unordered_map<int, conduit::Node>;
+  /// Samples of the mini-batch being fetched, read by prepare_samples
+  mini_batch_samples_t m_mini_batch_samples;
+  /// Samples of the next mini-batch being read in the background
+  std::future<mini_batch_samples_t> m_readahead;
+  /// Bundles kept open between mini-batches, most recently used first
+  std::list<std::pair<sample_file_id_t, hid_t>> m_open_bundles;
+
+  /** Read all the fields of the given samples, visiting each bundle once.
+   *  Samples whose bundle or path cannot be found are left out, so that
+   *  fetch_datum falls back to loading them one by one.
+   */
+  void load_mini_batch_samples(std::vector<int> indices,
+                               mini_batch_samples_t& samples);
+  /// Return an open handle to a bundle, closing the least recently used
+  hid_t get_open_bundle(sample_file_id_t id);
+  /// Wait for the background read and close the bundles kept open
+  void release_open_bundles();
 };
 
 /**
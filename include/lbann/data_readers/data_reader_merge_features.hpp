@@ -84,6 +84,10 @@ protected:
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /// Pass the whole mini-batch on to each subsidiary reader.
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
   /// Reader providing label data.
   generic_data_reader* m_label_reader;
   /// Sum of the size of data from all the data readers.
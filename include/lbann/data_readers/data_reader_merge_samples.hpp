@@ -55,6 +55,9 @@ public:
   /// Load subsidiary data readers.
   void load() override;
 
+  void setup(int num_io_threads,
+             observer_ptr<thread_pool> io_thread_pool) override;
+
   int get_num_labels() const override
   {
     return m_data_readers[0]->get_num_labels();
@@ -88,6 +91,13 @@ protected:
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /// Pass each subsidiary reader its share of the mini-batch.
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
+  /// Return the reader holding data_id, and make data_id local to it.
+  size_t find_reader(int& data_id) const;
+
   /// Partial sums of the number of samples in each reader.
   std::vector<int> m_num_samples_psum;
 
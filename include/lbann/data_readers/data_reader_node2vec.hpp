@@ -44,6 +44,10 @@ class EdgeWeightData;
 class RandomWalker;
 } // namespace node2vec_reader_impl
 
+#ifdef LBANN_HAS_GPU
+class node2vec_gpu_walker;
+#endif // LBANN_HAS_GPU
+
 /** Adapter for HavoqGT distributed node2vec walker.
  *
  *  This is an experimental data reader intended for large-scale graph
@@ -56,6 +60,12 @@ class RandomWalker;
  *  periodically recomputed based on the number of times each vertex
  *  is visited.
  *
+ *  With @c gpu_walks, every rank copies the whole graph to the GPU
+ *  in CSR format and generates the mini-batch there (see
+ *  node2vec_gpu_walker), writing it into the data coordinator's
+ *  device buffer. The HavoqGT walker is still used for the first
+ *  mini-batch, before that buffer exists.
+ *
  *  @warning This is experimental.
  *
  */
@@ -67,7 +77,8 @@ public:
                   size_t walk_length,
                   double return_param,
                   double inout_param,
-                  size_t num_negative_samples);
+                  size_t num_negative_samples,
+                  bool gpu_walks = false);
   node2vec_reader(const node2vec_reader&) = delete;
   node2vec_reader& operator=(const node2vec_reader&) = delete;
   ~node2vec_reader() override;
@@ -75,6 +86,16 @@ public:
 
   std::string get_type() const override;
 
+  /// Random walks are generated by fetch_data_block
+  bool supports_io_worker_processes() override { return false; }
+
+#ifdef LBANN_HAS_GPU
+  bool supports_device_fetch() const override
+  {
+    return m_gpu_walker != nullptr;
+  }
+#endif // LBANN_HAS_GPU
+
   const std::vector<int> get_data_dims() const override;
   int get_num_labels() const override;
   int get_linearized_data_size() const override;
@@ -89,6 +110,12 @@ protected:
                         El::Int mb_size,
                         El::Matrix<El::Int>& indices_fetched) override;
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
+#ifdef LBANN_HAS_GPU
+  bool fetch_data_block_to_device(
+    El::Matrix<DataType, El::Device::GPU>& X,
+    El::Int mb_size,
+    El::Matrix<El::Int>& indices_fetched) override;
+#endif // LBANN_HAS_GPU
 
 private:
   /** Perform random walks, starting from random local vertices.
@@ -114,6 +141,10 @@ private:
   std::unique_ptr<node2vec_reader_impl::EdgeWeightData> m_edge_weight_data;
   /** Manager for node2vec random walks on distributed graph. */
   std::unique_ptr<node2vec_reader_impl::RandomWalker> m_random_walker;
+#ifdef LBANN_HAS_GPU
+  /** Walker on a device copy of the graph; null unless @c gpu_walks */
+  std::unique_ptr<node2vec_gpu_walker> m_gpu_walker;
+#endif // LBANN_HAS_GPU
 
   /** Cache of random walks.
    *
@@ -183,6 +214,8 @@ private:
   double m_inout_param;
   /** @brief Number of negative samples per data sample. */
   size_t m_num_negative_samples;
+  /** @brief Whether to generate walks on the GPU. */
+  bool m_gpu_walks;
 };
 
 } // namespace lbann
@@ -31,6 +31,7 @@
 #define LBANN_DATA_READER_NUMPY_HPP
 
 #include "data_reader.hpp"
+#include "lbann/utils/cnpy_utils.hpp"
 #include <cnpy.h>
 
 namespace lbann {
@@ -41,6 +42,8 @@ namespace lbann {
  * axes can be flattened to form a sample.
  * This supports fetching labels, but only from the last column. (This can be
  * relaxed if necessary.) Ditto responses.
+ * With --mmap_numpy, the file is memory mapped rather than loaded, and
+ * samples are copied straight from the mapped pages.
  */
 class numpy_reader : public generic_data_reader
 {
@@ -76,6 +79,19 @@ protected:
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /** Asks the kernel to read ahead the mapped rows of this mini-batch
+   *  and the next one */
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
+  /// Start of the array's data, whether it is mapped or loaded
+  template <typename T>
+  const T* data_ptr()
+  {
+    return m_mapped_data.is_mapped() ? m_mapped_data.as<T>()
+                                     : m_data.data<T>();
+  }
+
   /// Number of samples.
   int m_num_samples = 0;
   /// Number of features in each sample.
@@ -88,6 +104,8 @@ protected:
    * for copying).
    */
   cnpy::NpyArray m_data;
+  /// The file's mapping with --mmap_numpy; m_data then only holds the header
+  cnpy_utils::mapped_array m_mapped_data;
 };
 
 } // namespace lbann
@@ -32,6 +32,7 @@
 
 #include "data_reader.hpp"
 #include "data_reader_numpy.hpp"
+#include "lbann/utils/cnpy_utils.hpp"
 #include <cnpy.h>
 
 namespace lbann {
@@ -40,6 +41,9 @@ namespace lbann {
  * This assumes that the file contains "data", "labels" (optional),
  * and "responses" (optional) whose the zero'th axis is the sample axis.
  * float, double, int16 data-types is accepted for "data".
+ * With --mmap_numpy, the members of an archive written by numpy.savez are
+ * memory mapped rather than loaded, and samples are copied straight from
+ * the mapped pages.
  */
 class numpy_npz_reader : public generic_data_reader
 {
@@ -85,6 +89,19 @@ protected:
   bool fetch_label(CPUMat& Y, int data_id, int mb_idx) override;
   bool fetch_response(CPUMat& Y, int data_id, int mb_idx) override;
 
+  /** Asks the kernel to read ahead the mapped rows of this mini-batch
+   *  and the next one */
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
+  /// Start of the data of ary, whether it is mapped or loaded
+  template <typename T>
+  static const T* data_ptr(cnpy::NpyArray& ary,
+                           const cnpy_utils::mapped_array& mapped)
+  {
+    return mapped.is_mapped() ? mapped.as<T>() : ary.data<T>();
+  }
+
   /// Number of samples.
   int m_num_samples = 0;
   /// Number of features in each sample.
@@ -99,6 +116,9 @@ protected:
    * for copying).
    */
   cnpy::NpyArray m_data, m_labels, m_responses;
+  /// The members' mappings with --mmap_numpy; the arrays above then only
+  /// hold their headers
+  cnpy_utils::mapped_array m_mapped_data, m_mapped_labels, m_mapped_responses;
 
   // A constant to be multiplied when data is converted
   // from int16 to DataType.
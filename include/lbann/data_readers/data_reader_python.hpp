@@ -41,7 +41,8 @@ public:
                 std::string sample_function,
                 std::string num_samples_function,
                 std::string sample_dims_function,
-                bool shuffle);
+                bool shuffle,
+                std::string sample_batch_function = "");
   python_reader(const python_reader&) = default;
   python_reader& operator=(const python_reader&) = default;
   ~python_reader() override;
@@ -49,6 +50,9 @@ public:
 
   std::string get_type() const override { return "python_reader"; }
 
+  /// Samples are already loaded by Python worker processes
+  bool supports_io_worker_processes() override { return false; }
+
   const std::vector<int> get_data_dims() const override;
   int get_num_labels() const override;
   int get_linearized_data_size() const override;
@@ -80,14 +84,34 @@ private:
    */
   python::object m_sample_function;
 
-  /** @brief Wrapper function around sample access function.
+  /** @brief Optional user-provided Python function to access a batch
+   *  of data samples.
+   *
+   *  The function is expected to take a list of sample indices. It
+   *  should return an object that supports the buffer protocol (e.g.
+   *  a C-contiguous NumPy array of DataType) holding the samples one
+   *  after the other; otherwise, it must return an iterator over the
+   *  samples.
+   */
+  python::object m_sample_batch_function;
+
+  /** @brief Wrapper function around sample access functions.
    *
    *  This function will be executed on worker processes (see @c
-   *  m_process_pool). It will obtain a data sample from @c
-   *  m_sample_function and copy it into a @c m_shared_memory_array.
+   *  m_process_pool). It takes a list of sample indices, obtains the
+   *  samples from @c m_sample_batch_function (or, if there is none,
+   *  from @c m_sample_function), and copies them into @c
+   *  m_shared_memory_array.
    */
   python::object m_sample_function_wrapper;
 
+  /** @brief Number of processes in @c m_process_pool.
+   *
+   *  Each mini-batch is split into this many tasks, so that the cost
+   *  of a task is paid once per worker rather than once per sample.
+   */
+  El::Int m_num_worker_processes = 0;
+
   /** @brief Pool of worker processes.
    *
    *  From the Python @c multiprocessing module.
@@ -70,6 +70,31 @@ public:
    */
   void shuffle_indices(rng_gen& gen) override;
 
+  /** Recompute the file usage when the order changes */
+  void bucket_shuffled_indices() override;
+
+  /** Advance the sample list's file usage to this mini-batch and open
+   *  the files of this and the next mini-batch before the I/O threads
+   *  fetch from them */
+  void prepare_samples(const std::vector<int>& indices,
+                       const std::vector<int>& next_indices) override;
+
+  bool has_sample_files() const override
+  {
+    return m_sample_list.get_header().is_multi_sample();
+  }
+  size_t get_sample_file_id(int index) const override
+  {
+    return m_sample_list[index].first;
+  }
+
+  /** The file usage must follow the installed shuffle, so the next
+   *  epoch is never shuffled early */
+  bool supports_cross_epoch_fetch() const override { return false; }
+
+  /** Workers would not see the file handles opened after the fork */
+  bool supports_io_worker_processes() override { return false; }
+
   /** Developer's note: derived classes that override load() should
    * explicitly call data_reader_sample_list::load() at the
    * beginning of their method load() method
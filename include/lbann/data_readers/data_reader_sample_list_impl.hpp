@@ -82,6 +82,30 @@ void data_reader_sample_list<SampleListT>::shuffle_indices(rng_gen& gen)
   }
 }
 
+template <typename SampleListT>
+void data_reader_sample_list<SampleListT>::bucket_shuffled_indices()
+{
+  if (bucket_indices_by_length(m_shuffled_indices) &&
+      get_mini_batch_size() != 0) {
+    m_sample_list.compute_epochs_file_usage(get_shuffled_indices(),
+                                            get_mini_batch_size(),
+                                            *m_comm);
+  }
+}
+
+template <typename SampleListT>
+void data_reader_sample_list<SampleListT>::prepare_samples(
+  const std::vector<int>& indices,
+  const std::vector<int>& next_indices)
+{
+  m_sample_list.advance_file_usage_step();
+  if (data_store_active()) {
+    return;
+  }
+  m_sample_list.open_samples_file_handles(indices);
+  m_sample_list.open_samples_file_handles(next_indices);
+}
+
 template <typename SampleListT>
 void data_reader_sample_list<SampleListT>::load()
 {
@@ -113,22 +137,26 @@ void data_reader_sample_list<SampleListT>::load_list_of_samples(
     m_sample_list.keep_sample_order(false);
   }
 
-  // Load the sample list
-  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE)) {
+  // Load the sample list, or its binary copy if one is cached
+  const auto [cache_file, cached] = find_sample_list_cache(sample_list_file);
+  const std::string& list_file = cached ? cache_file : sample_list_file;
+  // A binary sample list is memory mapped by every rank instead
+  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE) &&
+      !sample_list_binary::is_binary(list_file)) {
     std::vector<char> buffer;
     if (m_comm->am_trainer_master()) {
-      load_file(sample_list_file, buffer);
+      load_file(list_file, buffer);
     }
     m_comm->trainer_broadcast(m_comm->get_trainer_master(), buffer);
 
     vectorwrapbuf<char> strmbuf(buffer);
     std::istream iss(&strmbuf);
 
-    m_sample_list.set_sample_list_name(sample_list_file);
+    m_sample_list.set_sample_list_name(list_file);
     m_sample_list.load(iss, *(this->m_comm), true);
   }
   else {
-    m_sample_list.load(sample_list_file, *(this->m_comm), true);
+    m_sample_list.load(list_file, *(this->m_comm), true);
   }
   if (get_comm()->am_world_master()) {
     std::cout << "Time to load sample list '" << sample_list_file
@@ -144,8 +172,29 @@ void data_reader_sample_list<SampleListT>::load_list_of_samples(
               << "': " << get_time() - tm3 << std::endl;
   }
 
+  if (!cache_file.empty() && !cached && get_comm()->am_world_master() &&
+      m_sample_list.get_header().is_multi_sample()) {
+    try {
+      m_sample_list.write_binary(cache_file);
+    }
+    catch (lbann_exception const& e) {
+      LBANN_WARNING("could not cache sample list ",
+                    sample_list_file,
+                    ": ",
+                    e.what());
+    }
+  }
+
   // Set base directory for your data.
   generic_data_reader::set_file_dir(m_sample_list.get_samples_dirname());
+
+  const std::string stage_dir = arg_parser.get<std::string>(
+    LBANN_OPTION_STAGE_DIR);
+  if (!stage_dir.empty()) {
+    m_sample_list.stage_files(stage_dir,
+                              m_comm->get_procs_per_trainer(),
+                              m_comm->get_rank_in_trainer());
+  }
 }
 
 template <typename SampleListT>
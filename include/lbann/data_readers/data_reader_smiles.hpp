@@ -31,7 +31,32 @@
 #include "lbann/data_readers/data_reader_sample_list.hpp"
 #include "lbann/data_readers/sample_list_ifstream.hpp"
 
+#include <cstdint>
+#include <memory>
+
 namespace lbann {
+
+/** @brief Header of a pre-tokenized SMILES corpus
+ *
+ *  The file, written by tools/tokenize_smiles, is little-endian: this
+ *  header, then one uint32 encoded length per sample (the number of
+ *  tokens before the padding), then one row of @c row_width tokens of
+ *  @c token_size bytes per sample. Rows hold <bos>, the encoded
+ *  SMILES string, <eos> and <pad> up to the row width.
+ */
+struct smiles_token_header
+{
+  char magic[8]; // "LBSMITOK"
+  uint32_t version;
+  uint32_t token_size;
+  uint64_t num_samples;
+  uint64_t row_width;
+  int32_t pad;
+  int32_t unk;
+  int32_t bos;
+  int32_t eos;
+  uint64_t reserved[2];
+};
 /**
  * Data reader for SMILES (string) data. The string data is converted to
  * a vector of shorts according to an arbitrary mapping.
@@ -40,6 +65,11 @@ namespace lbann {
  *   "local_id" (or similar name): refers to a line number in a file.
  *   "global_id" (aka, sample_id, etc) refers to an index from the
  *               m_shuffled_indices vector.
+ *
+ * When the reader is given a data_filename, it reads a pre-tokenized
+ * corpus (see smiles_token_header) instead: the file is memory mapped,
+ * there is no sample list, vocabulary or data store, and a sample is
+ * copied straight out of its fixed-width row.
  */
 class smiles_data_reader
   : public data_reader_sample_list<sample_list_ifstream<long long>>
@@ -88,6 +118,33 @@ public:
   }
   int get_sequence_length() { return m_sequence_length; }
 
+  /** @brief Read a pre-tokenized corpus from the data filename */
+  void set_pretokenized(bool b) { m_pretokenized = b; }
+  bool is_pretokenized() const { return m_pretokenized; }
+
+  /** A pre-tokenized corpus has no sample list to keep up to date,
+   *  so it is shuffled as any other reader */
+  void shuffle_indices(rng_gen& gen) override;
+  void bucket_shuffled_indices() override;
+  bool supports_cross_epoch_fetch() const override
+  {
+    return m_pretokenized && generic_data_reader::supports_cross_epoch_fetch();
+  }
+  bool supports_io_worker_processes() override
+  {
+    return m_pretokenized &&
+           generic_data_reader::supports_io_worker_processes();
+  }
+
+  bool has_sample_lengths() const override
+  {
+    return m_token_lengths != nullptr || !m_sample_offsets.empty();
+  }
+  /** Upper bound on the number of tokens of the encoded sample,
+   *  including <bos> and <eos>; the rest of the sample is <pad>.
+   *  Computed from the line length in the offsets file. */
+  int get_sample_length(int index) const override;
+
   void use_unused_index_set(execution_mode m) override;
 
   /** This method is for use during testing and development */
@@ -180,6 +237,13 @@ private:
 
   std::string m_metadata_filename;
 
+  bool m_pretokenized = false;
+  /** Mapping of the pre-tokenized corpus; shared by copies */
+  std::shared_ptr<const void> m_token_mapping;
+  const uint32_t* m_token_lengths = nullptr;
+  const char* m_tokens = nullptr;
+  size_t m_token_size = 0;
+
   std::unordered_map<char, short> m_vocab;
   std::unordered_map<short, std::string> m_vocab_inv;
 
@@ -224,6 +288,9 @@ private:
 
   void print_statistics() const;
 
+  /** Maps the pre-tokenized corpus and sets up the indices */
+  void load_pretokenized();
+
   // load "offset" and "length" for samples from a binary file;
   // the (offset, length) specify the location of a sample within
   // the data file
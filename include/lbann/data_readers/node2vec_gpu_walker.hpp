@@ -0,0 +1,115 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_DATA_READERS_NODE2VEC_GPU_WALKER_HPP_INCLUDED
+#define LBANN_DATA_READERS_NODE2VEC_GPU_WALKER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#ifdef LBANN_HAS_GPU
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+/** @brief node2vec random walks on a device copy of a graph
+ *
+ *  The graph is stored in compressed sparse row format, indexed by
+ *  global vertex index, with the neighbors of each vertex sorted.
+ *  Every rank holds the whole graph in GPU memory.
+ *
+ *  Walks are biased second-order walks. The next vertex is drawn in
+ *  proportion to the edge weight and accepted with probability
+ *  proportional to the node2vec bias (1/p to return to the previous
+ *  vertex, 1 for a neighbor of the previous vertex, 1/q otherwise),
+ *  so the transition probabilities are never materialized. A walk
+ *  that reaches a vertex without out-edges stays there.
+ */
+class node2vec_gpu_walker
+{
+public:
+  /** @param offsets     Row offsets; size is the number of vertices + 1.
+   *  @param targets     Neighbors of each vertex, sorted within a row.
+   *  @param weights     Edge weights, aligned with @c targets.
+   *  @param local_vertices Global indices of the local vertices, which
+   *                     start walks and are drawn as negative samples.
+   */
+  node2vec_gpu_walker(const std::vector<El::Int>& offsets,
+                      const std::vector<El::Int>& targets,
+                      const std::vector<float>& weights,
+                      const std::vector<El::Int>& local_vertices,
+                      size_t walk_length,
+                      double return_param,
+                      double inout_param,
+                      size_t num_negative_samples);
+  ~node2vec_gpu_walker();
+  node2vec_gpu_walker(const node2vec_gpu_walker&) = delete;
+  node2vec_gpu_walker& operator=(const node2vec_gpu_walker&) = delete;
+
+  size_t get_num_vertices() const { return m_num_vertices; }
+
+  /** @brief Set the noise distribution for negative sampling
+   *
+   *  @c cdf is the cumulative distribution over the local vertices.
+   */
+  void set_noise_distribution(const std::vector<double>& cdf);
+
+  /** @brief Write @c mb_size samples into the columns of @c X
+   *
+   *  Each column holds the negative samples followed by a walk from
+   *  a random local vertex, as in node2vec_reader. Visits to local
+   *  vertices are counted on the device. Runs on the stream of @c X.
+   */
+  void generate(El::Matrix<DataType, El::Device::GPU>& X,
+                El::Int mb_size,
+                uint64_t seed);
+
+  /** @brief Add the visits counted since the last call to @c counts
+   *  (indexed by local vertex) and reset the device counts
+   *
+   *  Synchronizes with the stream of the last generate().
+   */
+  void accumulate_visit_counts(std::vector<size_t>& counts);
+
+private:
+  struct device_data;
+  std::unique_ptr<device_data> m_data;
+
+  size_t m_num_vertices;
+  size_t m_num_local_vertices;
+  size_t m_walk_length;
+  float m_return_param;
+  float m_inout_param;
+  size_t m_num_negative_samples;
+};
+
+} // namespace lbann
+
+#endif // LBANN_HAS_GPU
+#endif // LBANN_DATA_READERS_NODE2VEC_GPU_WALKER_HPP_INCLUDED
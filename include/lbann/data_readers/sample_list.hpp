@@ -38,6 +38,7 @@ namespace lbann {
 
 // Forward Declarations
 class lbann_comm;
+class sample_list_binary;
 
 static const std::string multi_sample_exclusion = "MULTI-SAMPLE_EXCLUSION";
 static const std::string multi_sample_inclusion = "MULTI-SAMPLE_INCLUSION";
@@ -122,7 +123,8 @@ public:
 
   /** Load a sample list file using the stride as the number of processes per
    *  trainer and the offset as the current rank within the trainer if
-   *  interleaving option is on.
+   *  interleaving option is on. A binary sample list (see
+   *  sample_list_binary) is loaded whole, without gathering.
    */
   void load(const std::string& samplelist_file,
             const lbann_comm& comm,
@@ -135,6 +137,16 @@ public:
             const lbann_comm& comm,
             bool interleave);
 
+  /** Load a binary sample list, taking the files at offset of every
+   *  stride ones. With all_slices, every rank's files are loaded in the
+   *  order all_gather_packed_lists() would leave them, which then has
+   *  nothing left to do.
+   */
+  void load_binary(const std::string& samplelist_file,
+                   size_t stride,
+                   size_t offset,
+                   bool all_slices);
+
   /// Restore a sample list from a serialized string
   void load_from_string(const std::string& samplelist,
                         const lbann_comm& comm,
@@ -221,6 +233,12 @@ protected:
   virtual void
   read_sample_list(std::istream& istrm, size_t stride = 1, size_t offset = 0);
 
+  /// read the body of a binary sample list
+  virtual void read_binary_sample_list(const sample_list_binary& bin,
+                                       size_t stride,
+                                       size_t offset,
+                                       bool all_slices);
+
   /// Assign names to samples when there is only one sample per file without a
   /// name.
   virtual void assign_samples_name();
@@ -256,6 +274,9 @@ protected:
   /// Whether to check the existence of data file
   bool m_check_data_file;
 
+  /// Whether the list already holds the samples of every rank
+  bool m_has_all_slices;
+
   /// List of all samples with a file identifier and sample name for each sample
   samples_t m_sample_list;
 
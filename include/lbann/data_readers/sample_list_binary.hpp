@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_DATA_READERS_SAMPLE_LIST_BINARY_HPP
+#define LBANN_DATA_READERS_SAMPLE_LIST_BINARY_HPP
+
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lbann {
+
+/** @brief Header of a binary sample list
+ *
+ *  The file, written by tools/convert_sample_list, is little-endian:
+ *  this header, then num_files + 1 sample_list_binary_file records
+ *  (the last one only closes the sample range of the file before it),
+ *  then one record per sample, then a string table that holds the file
+ *  names, the data file directory and the label file name. A sample
+ *  record is an int64 name if SAMPLE_LIST_BINARY_INTEGRAL_NAMES is set,
+ *  and a sample_list_binary_string into the string table otherwise.
+ *  Every section starts on an 8 byte boundary.
+ */
+struct sample_list_binary_header
+{
+  char magic[8]; // "LBSMPLST"
+  uint32_t version;
+  uint32_t flags;
+  uint64_t num_files;
+  uint64_t num_samples;
+  uint64_t files_offset;
+  uint64_t samples_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t file_dir;
+  uint64_t file_dir_length;
+  uint64_t label_filename;
+  uint64_t label_filename_length;
+  uint64_t reserved[4];
+};
+static_assert(sizeof(sample_list_binary_header) == 128,
+              "unexpected binary sample list header size");
+
+enum sample_list_binary_flags : uint32_t
+{
+  SAMPLE_LIST_BINARY_MULTI_SAMPLE = 1u,
+  SAMPLE_LIST_BINARY_INTEGRAL_NAMES = 2u,
+  SAMPLE_LIST_BINARY_UNUSED_SAMPLE_FIELDS = 4u,
+  SAMPLE_LIST_BINARY_LABEL_HEADER = 8u
+};
+
+struct sample_list_binary_file
+{
+  uint64_t name;
+  uint32_t name_length;
+  uint32_t reserved;
+  uint64_t first_sample;
+};
+static_assert(sizeof(sample_list_binary_file) == 24,
+              "unexpected binary sample list file record size");
+
+struct sample_list_binary_string
+{
+  uint64_t offset;
+  uint64_t length;
+};
+
+/** @brief Read-only view of a memory mapped binary sample list
+ *
+ *  Nothing is parsed up front, so a rank only touches the pages of the
+ *  files and samples it actually asks for.
+ */
+class sample_list_binary
+{
+public:
+  explicit sample_list_binary(const std::string& path) : m_path(path)
+  {
+    const auto mapped = file::map_read_only(path);
+    m_map = mapped.first;
+    m_base = static_cast<const char*>(m_map.get());
+    const size_t size = mapped.second;
+    if (size < sizeof(sample_list_binary_header) ||
+        !is_binary_magic(m_base)) {
+      LBANN_ERROR("file ", path, " is not a binary sample list");
+    }
+    std::memcpy(&m_header, m_base, sizeof(m_header));
+    if (m_header.version != 1u) {
+      LBANN_ERROR("binary sample list ",
+                  path,
+                  " has unsupported version ",
+                  m_header.version);
+    }
+    const size_t sample_size = (integral_names()
+                                  ? sizeof(int64_t)
+                                  : sizeof(sample_list_binary_string));
+    if (m_header.files_offset +
+            (m_header.num_files + 1) * sizeof(sample_list_binary_file) >
+          size ||
+        m_header.samples_offset + m_header.num_samples * sample_size > size ||
+        m_header.strings_offset + m_header.strings_size > size) {
+      LBANN_ERROR("binary sample list ", path, " is truncated");
+    }
+    m_files = reinterpret_cast<const sample_list_binary_file*>(
+      m_base + m_header.files_offset);
+    if (m_files[m_header.num_files].first_sample != m_header.num_samples) {
+      LBANN_ERROR("binary sample list ", path, " has an inconsistent index");
+    }
+  }
+
+  /// Whether the file at path starts with the binary sample list magic
+  static bool is_binary(const std::string& path)
+  {
+    char magic[sizeof(sample_list_binary_header::magic)] = {};
+    std::ifstream in(path, std::ios::binary);
+    in.read(magic, sizeof(magic));
+    return in.good() && is_binary_magic(magic);
+  }
+
+  const std::string& path() const { return m_path; }
+  bool is_multi_sample() const
+  {
+    return (m_header.flags & SAMPLE_LIST_BINARY_MULTI_SAMPLE) != 0u;
+  }
+  bool integral_names() const
+  {
+    return (m_header.flags & SAMPLE_LIST_BINARY_INTEGRAL_NAMES) != 0u;
+  }
+  bool has_unused_sample_fields() const
+  {
+    return (m_header.flags & SAMPLE_LIST_BINARY_UNUSED_SAMPLE_FIELDS) != 0u;
+  }
+  bool use_label_header() const
+  {
+    return (m_header.flags & SAMPLE_LIST_BINARY_LABEL_HEADER) != 0u;
+  }
+  size_t num_files() const { return m_header.num_files; }
+  size_t num_samples() const { return m_header.num_samples; }
+  std::string file_dir() const
+  {
+    return string_at(m_header.file_dir, m_header.file_dir_length);
+  }
+  std::string label_filename() const
+  {
+    return string_at(m_header.label_filename, m_header.label_filename_length);
+  }
+
+  std::string file_name(size_t f) const
+  {
+    return string_at(m_files[f].name, m_files[f].name_length);
+  }
+  /// The samples of file f are [first_sample(f), first_sample(f + 1))
+  size_t first_sample(size_t f) const { return m_files[f].first_sample; }
+
+  /// Name of sample s when integral_names() is set
+  int64_t sample_value(size_t s) const
+  {
+    int64_t v;
+    std::memcpy(&v,
+                m_base + m_header.samples_offset + s * sizeof(int64_t),
+                sizeof(v));
+    return v;
+  }
+  /// Name of sample s when integral_names() is not set
+  std::string sample_name(size_t s) const
+  {
+    sample_list_binary_string r;
+    std::memcpy(&r,
+                m_base + m_header.samples_offset + s * sizeof(r),
+                sizeof(r));
+    return string_at(r.offset, r.length);
+  }
+
+  /** Visit the file ids that rank offset of stride ranks owns. With
+   *  all_slices, visit every rank's files in the order the per-rank
+   *  lists are gathered: all of them in list order if in_order, or
+   *  rank-major otherwise.
+   */
+  template <typename F>
+  void for_each_file(size_t stride,
+                     size_t offset,
+                     bool all_slices,
+                     bool in_order,
+                     F&& f) const
+  {
+    const size_t n = num_files();
+    if (all_slices && in_order) {
+      for (size_t i = 0; i < n; ++i) {
+        f(i);
+      }
+      return;
+    }
+    const size_t first = (all_slices ? 0ul : offset);
+    const size_t last = (all_slices ? stride : offset + 1);
+    for (size_t r = first; r < last; ++r) {
+      for (size_t i = r; i < n; i += stride) {
+        f(i);
+      }
+    }
+  }
+
+private:
+  static bool is_binary_magic(const char* p)
+  {
+    return std::memcmp(p, "LBSMPLST", 8) == 0;
+  }
+
+  std::string string_at(uint64_t offset, uint64_t length) const
+  {
+    if (offset + length > m_header.strings_size) {
+      LBANN_ERROR("binary sample list ", m_path, " has a corrupt string");
+    }
+    return std::string(m_base + m_header.strings_offset + offset, length);
+  }
+
+  std::string m_path;
+  std::shared_ptr<const void> m_map;
+  const char* m_base = nullptr;
+  sample_list_binary_header m_header;
+  const sample_list_binary_file* m_files = nullptr;
+};
+
+/** @brief Builds a binary sample list in memory and writes it out
+ *
+ *  Call add_file() before the samples of each file.
+ */
+class sample_list_binary_writer
+{
+public:
+  sample_list_binary_writer(uint32_t flags,
+                            const std::string& file_dir,
+                            const std::string& label_filename)
+  {
+    std::memset(&m_header, 0, sizeof(m_header));
+    std::memcpy(m_header.magic, "LBSMPLST", sizeof(m_header.magic));
+    m_header.version = 1u;
+    m_header.flags = flags;
+    m_header.file_dir = add_string(file_dir);
+    m_header.file_dir_length = file_dir.size();
+    m_header.label_filename = add_string(label_filename);
+    m_header.label_filename_length = label_filename.size();
+  }
+
+  void add_file(const std::string& name)
+  {
+    sample_list_binary_file f = {};
+    f.name = add_string(name);
+    f.name_length = name.size();
+    f.first_sample = num_samples();
+    m_files.push_back(f);
+  }
+  void add_sample(int64_t value) { m_values.push_back(value); }
+  void add_sample(const std::string& name)
+  {
+    m_names.push_back({add_string(name), name.size()});
+  }
+
+  /// Write the list to a temporary file that is then renamed to path
+  void write(const std::string& path) const
+  {
+    const bool integral =
+      (m_header.flags & SAMPLE_LIST_BINARY_INTEGRAL_NAMES) != 0u;
+    if ((integral && !m_names.empty()) || (!integral && !m_values.empty())) {
+      LBANN_ERROR("binary sample list ",
+                  path,
+                  " mixes integral and string sample names");
+    }
+    sample_list_binary_header h = m_header;
+    std::vector<sample_list_binary_file> files = m_files;
+    h.num_files = files.size();
+    h.num_samples = num_samples();
+    sample_list_binary_file end = {};
+    end.first_sample = h.num_samples;
+    files.push_back(end);
+    h.files_offset = sizeof(h);
+    h.samples_offset =
+      h.files_offset + padded(files.size() * sizeof(sample_list_binary_file));
+    h.strings_offset =
+      h.samples_offset +
+      padded(integral ? m_values.size() * sizeof(int64_t)
+                      : m_names.size() * sizeof(sample_list_binary_string));
+    h.strings_size = m_strings.size();
+
+    const std::string tmp = path + ".tmp" + std::to_string(getpid());
+    {
+      std::ofstream out(tmp, std::ios::binary);
+      write_padded(out, &h, sizeof(h));
+      write_padded(out, files.data(), files.size() * sizeof(files[0]));
+      if (integral) {
+        write_padded(out, m_values.data(), m_values.size() * sizeof(int64_t));
+      }
+      else {
+        write_padded(out, m_names.data(), m_names.size() * sizeof(m_names[0]));
+      }
+      out.write(m_strings.data(), m_strings.size());
+      out.close();
+      if (!out) {
+        std::remove(tmp.c_str());
+        LBANN_ERROR("failed to write binary sample list ", tmp);
+      }
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0) {
+      std::remove(tmp.c_str());
+      LBANN_ERROR("failed to rename ", tmp, " to ", path);
+    }
+  }
+
+private:
+  size_t num_samples() const { return m_values.size() + m_names.size(); }
+
+  uint64_t add_string(const std::string& s)
+  {
+    const uint64_t offset = m_strings.size();
+    m_strings += s;
+    return offset;
+  }
+
+  static size_t padded(size_t n) { return (n + 7) / 8 * 8; }
+
+  static void write_padded(std::ofstream& out, const void* data, size_t size)
+  {
+    static const char zeros[8] = {};
+    out.write(static_cast<const char*>(data), size);
+    out.write(zeros, padded(size) - size);
+  }
+
+  sample_list_binary_header m_header;
+  std::vector<sample_list_binary_file> m_files;
+  std::vector<int64_t> m_values;
+  std::vector<sample_list_binary_string> m_names;
+  std::string m_strings;
+};
+
+/** @brief Path of the binary copy of a text sample list in cache_dir
+ *
+ *  The name is keyed by the list's path, size and modification time,
+ *  so an edited list is loaded again rather than taken from the cache.
+ */
+inline std::string sample_list_cache_path(const std::string& cache_dir,
+                                          const std::string& list_path)
+{
+  struct stat st;
+  if (stat(list_path.c_str(), &st) != 0) {
+    LBANN_ERROR("cannot stat sample list ", list_path);
+  }
+  std::ostringstream key;
+  key << list_path << ':' << st.st_size << ':' << st.st_mtime;
+  std::ostringstream name;
+  name << add_delimiter(cache_dir) << get_basename_without_ext(list_path)
+       << '.' << std::hex << std::hash<std::string>{}(key.str()) << ".bin";
+  return name.str();
+}
+
+} // namespace lbann
+
+#endif // LBANN_DATA_READERS_SAMPLE_LIST_BINARY_HPP
@@ -44,6 +44,7 @@
 
 #include "lbann/comm_impl.hpp"
 #include "lbann/data_readers/sample_list.hpp"
+#include "lbann/data_readers/sample_list_binary.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -291,7 +292,10 @@ inline const std::string& sample_list_header::get_label_filename() const
 
 template <typename sample_name_t>
 sample_list<sample_name_t>::sample_list()
-  : m_stride(1ul), m_keep_order(true), m_check_data_file(false)
+  : m_stride(1ul),
+    m_keep_order(true),
+    m_check_data_file(false),
+    m_has_all_slices(false)
 {}
 
 template <typename sample_name_t>
@@ -339,6 +343,7 @@ inline void sample_list<sample_name_t>::copy_members(const sample_list& rhs)
   m_stride = rhs.m_stride;
   m_keep_order = rhs.m_keep_order;
   m_check_data_file = rhs.m_check_data_file;
+  m_has_all_slices = rhs.m_has_all_slices;
   m_sample_list = rhs.m_sample_list;
 
   /// Keep track of existing filenames
@@ -351,6 +356,7 @@ inline void sample_list<sample_name_t>::load(std::istream& istrm,
                                              size_t offset)
 {
   m_stride = stride;
+  m_has_all_slices = false;
   get_samples_per_file(istrm, stride, offset);
 }
 
@@ -359,6 +365,12 @@ inline void sample_list<sample_name_t>::load(const std::string& samplelist_file,
                                              const lbann_comm& comm,
                                              bool interleave)
 {
+  if (sample_list_binary::is_binary(samplelist_file)) {
+    const size_t stride = interleave ? comm.get_procs_per_trainer() : 1ul;
+    const size_t offset = interleave ? comm.get_rank_in_trainer() : 0ul;
+    load_binary(samplelist_file, stride, offset, true);
+    return;
+  }
   m_header.set_sample_list_name(samplelist_file);
   zstr::ifstream istrm(samplelist_file);
   // std::ifstream istrm(samplelist_file);
@@ -391,6 +403,41 @@ inline void sample_list<sample_name_t>::load(const sample_list_header& header,
   read_sample_list(istrm, stride, offset);
 }
 
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::load_binary(const std::string& samplelist_file,
+                                        size_t stride,
+                                        size_t offset,
+                                        bool all_slices)
+{
+  const sample_list_binary bin(samplelist_file);
+
+  m_header.set_sample_list_name(samplelist_file);
+  m_header.m_is_multi_sample = bin.is_multi_sample();
+  m_header.m_is_exclusive = false;
+  m_header.m_no_label_header = !bin.use_label_header();
+  m_header.m_has_unused_sample_fields = bin.has_unused_sample_fields();
+  m_header.m_included_sample_count = bin.num_samples();
+  m_header.m_excluded_sample_count = 0ul;
+  m_header.m_num_files = bin.num_files();
+  m_header.m_file_dir = bin.file_dir();
+  m_header.m_label_filename = bin.label_filename();
+
+  if (m_header.get_file_dir().empty() ||
+      (m_check_data_file && !check_if_dir_exists(m_header.get_file_dir()))) {
+    LBANN_ERROR("file ",
+                samplelist_file,
+                " :: data root directory '",
+                m_header.get_file_dir(),
+                "' does not exist.");
+  }
+
+  // The list is complete, so there is no interleaving left to undo
+  m_stride = (all_slices && m_keep_order) ? 1ul : stride;
+  m_has_all_slices = all_slices;
+  read_binary_sample_list(bin, stride, offset, all_slices);
+}
+
 template <typename sample_name_t>
 inline void
 sample_list<sample_name_t>::load_from_string(const std::string& samplelist,
@@ -542,6 +589,45 @@ inline void sample_list<sample_name_t>::read_sample_list(std::istream& istrm,
   }
 }
 
+template <typename sample_name_t>
+inline void
+sample_list<sample_name_t>::read_binary_sample_list(
+  const sample_list_binary& bin,
+  size_t stride,
+  size_t offset,
+  bool all_slices)
+{
+  if (bin.is_multi_sample()) {
+    LBANN_ERROR("binary sample list ",
+                bin.path(),
+                " lists multiple samples per file, which this reader does "
+                "not support");
+  }
+  const size_t num_files =
+    (all_slices ? bin.num_files() : bin.num_files() / stride + 1);
+  m_sample_list.clear();
+  m_file_id_stats_map.clear();
+  m_sample_list.reserve(num_files);
+  m_file_id_stats_map.reserve(num_files);
+
+  static const auto sn0 = uninitialized_sample_name<sample_name_t>();
+  bin.for_each_file(stride, offset, all_slices, m_keep_order, [&](size_t f) {
+    std::string filename = bin.file_name(f);
+    if (m_check_data_file &&
+        !check_if_file_exists(add_delimiter(m_header.get_file_dir()) +
+                              filename)) {
+      LBANN_ERROR("data file '", filename, "' does not exist.");
+    }
+    const sample_file_id_t index = m_file_id_stats_map.size();
+    m_sample_list.emplace_back(std::make_pair(index, sn0));
+    m_file_id_stats_map.emplace_back(std::move(filename));
+  });
+
+  if (all_slices) {
+    assign_samples_name();
+  }
+}
+
 template <typename sample_name_t>
 inline size_t
 sample_list<sample_name_t>::get_samples_per_file(std::istream& istrm,
@@ -945,6 +1031,9 @@ template <typename sample_name_t>
 inline void
 sample_list<sample_name_t>::all_gather_packed_lists(lbann_comm& comm)
 {
+  if (m_has_all_slices) {
+    return;
+  }
   std::cerr
     << "starting sample_list<sample_name_t> ::all_gather_packed_lists\n";
   int num_ranks = comm.get_procs_per_trainer();
@@ -28,8 +28,10 @@
 #define LBANN_DATA_READERS_SAMPLE_LIST_OPEN_FILES_HPP
 
 #include "sample_list.hpp"
+#include "lbann/utils/file_stager.hpp"
 
 #include <deque>
+#include <memory>
 
 /// Number of system and other files that may be open during execution
 #define LBANN_MAX_OPEN_FILE_MARGIN 128
@@ -99,8 +101,22 @@ public:
   /// Serialize this sample list into an std::string object
   bool to_string(std::string& sstr) const override;
 
+  /// Write this list in the binary format read by load()
+  void write_binary(const std::string& path) const;
+
   const std::string& get_samples_filename(sample_file_id_t id) const override;
 
+  /** Path to read a file from: its node-local copy once stage_files()
+   *  has made one, otherwise its location in the sample list directory */
+  std::string get_samples_file_path(sample_file_id_t id) const;
+
+  /** Copy the files of the list to @c stage_dir in the background. The
+   *  files are split among the ranks that call this with the same
+   *  @c stride, each copying the ids equal to @c offset modulo it; the
+   *  ranks of a node share the copies made by the others.
+   */
+  void stage_files(const std::string& stage_dir, size_t stride, size_t offset);
+
   file_handle_t get_samples_file_handle(sample_file_id_t id) const;
 
   void set_files_handle(const std::string& filename, file_handle_t h);
@@ -118,6 +134,17 @@ public:
                                  int mini_batch_size,
                                  const lbann_comm& comm);
 
+  /** Move on to the next mini-batch step of the usage computed by
+   *  compute_epochs_file_usage(). Uses in earlier steps are dropped, so
+   *  eviction sees when each open file is actually needed next.
+   */
+  void advance_file_usage_step();
+
+  /** Open the files of the given samples ahead of their fetch, as long
+   *  as that does not evict a file that is needed sooner.
+   */
+  void open_samples_file_handles(const std::vector<int>& indices);
+
   virtual bool is_file_handle_valid(const file_handle_t& h) const = 0;
 
   void all_gather_packed_lists(lbann_comm& comm) override;
@@ -169,6 +196,13 @@ protected:
                         size_t stride = 1,
                         size_t offset = 0) override;
 
+  /** read the body of a binary sample list. The files are not opened;
+   *  open_samples_file_handle() opens them on first use. */
+  void read_binary_sample_list(const sample_list_binary& bin,
+                               size_t stride,
+                               size_t offset,
+                               bool all_slices) override;
+
   void assign_samples_name() override {}
 
   /// Get the number of total/included/excluded samples
@@ -176,6 +210,9 @@ protected:
                        size_t& included,
                        size_t& excluded) const override;
 
+  /// The step and substep of the next use of a file, if there is one
+  std::pair<int, int> next_file_use(sample_file_id_t id);
+
   static bool pq_cmp(fd_use_map_t left, fd_use_map_t right)
   {
     return ((left.second).first < (right.second).first) ||
@@ -203,9 +240,16 @@ private:
   /// Track the number of samples per file
   std::unordered_map<std::string, size_t> m_file_map;
 
-  /// Track the number of open file descriptors and when they will be used next
+  /** The open files in the order they were opened, with when they will
+   *  be used next as of the last eviction */
   std::deque<fd_use_map_t> m_open_fd_pq;
 
+  /// The current mini-batch step of the file usage
+  int m_file_usage_step;
+
+  /// Background copy of the files to node-local storage, if any
+  std::shared_ptr<file_stager> m_stager;
+
   size_t m_max_open_files;
 };
 
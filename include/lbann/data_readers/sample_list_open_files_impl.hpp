@@ -28,6 +28,7 @@
 #define LBANN_DATA_READERS_SAMPLE_LIST_OPEN_FILES_IMPL_HPP
 
 #include "lbann/data_readers/sample_list_impl.hpp" // to_sample_name_t
+#include "lbann/data_coordinator/io_trace.hpp"
 #include "lbann/data_readers/sample_list_open_files.hpp"
 #include <conduit/conduit.hpp>
 
@@ -36,6 +37,7 @@ namespace lbann {
 template <typename sample_name_t, typename file_handle_t>
 inline sample_list_open_files<sample_name_t,
                               file_handle_t>::sample_list_open_files()
+  : m_file_usage_step(-1)
 {
   m_max_open_files = getdtablesize() - LBANN_MAX_OPEN_FILE_MARGIN;
 }
@@ -91,6 +93,8 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>::copy_members(
   sample_list<sample_name_t>::copy_members(rhs);
   m_file_map = rhs.m_file_map;
   m_max_open_files = rhs.m_max_open_files;
+  m_file_usage_step = rhs.m_file_usage_step;
+  m_stager = rhs.m_stager;
 
   /// Keep track of existing filenames but do not copy any file
   /// descriptor information
@@ -456,6 +460,78 @@ sample_list_open_files<sample_name_t, file_handle_t>::read_sample_list(
   }
 }
 
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::read_binary_sample_list(
+  const sample_list_binary& bin,
+  size_t stride,
+  size_t offset,
+  bool all_slices)
+{
+  if (!bin.is_multi_sample()) {
+    LBANN_ERROR("binary sample list ",
+                bin.path(),
+                " lists one sample per file, which this reader does not "
+                "support");
+  }
+  this->m_sample_list.clear();
+  m_file_id_stats_map.clear();
+  m_file_map.clear();
+  m_open_fd_pq.clear();
+  this->m_sample_list.reserve(all_slices ? bin.num_samples()
+                                         : bin.num_samples() / stride + 1);
+
+  bin.for_each_file(
+    stride,
+    offset,
+    all_slices,
+    this->m_keep_order,
+    [&](size_t f) {
+      const std::string filename = bin.file_name(f);
+      const size_t first = bin.first_sample(f);
+      const size_t last = bin.first_sample(f + 1);
+      if (this->m_check_data_file &&
+          !check_if_file_exists(add_delimiter(m_header.get_file_dir()) +
+                                filename)) {
+        LBANN_ERROR("data file '", filename, "' does not exist.");
+      }
+      auto it = m_file_map.find(filename);
+      if (it != m_file_map.end() && it->second != last - first) {
+        LBANN_ERROR("The same file ",
+                    filename,
+                    " is listed multiple times with different sizes: ",
+                    last - first,
+                    " and ",
+                    it->second);
+      }
+      m_file_map[filename] = last - first;
+
+      const sample_file_id_t index = m_file_id_stats_map.size();
+      m_file_id_stats_map.emplace_back(
+        std::make_tuple(filename,
+                        uninitialized_file_handle<file_handle_t>(),
+                        std::deque<std::pair<int, int>>{}));
+      for (size_t s = first; s < last; ++s) {
+        if (!bin.integral_names()) {
+          this->m_sample_list.emplace_back(
+            index,
+            to_sample_name_t<sample_name_t>(bin.sample_name(s)));
+        }
+        else if constexpr (std::is_integral_v<sample_name_t>) {
+          this->m_sample_list.emplace_back(
+            index,
+            static_cast<sample_name_t>(bin.sample_value(s)));
+        }
+        else {
+          this->m_sample_list.emplace_back(
+            index,
+            to_sample_name_t<sample_name_t>(
+              std::to_string(bin.sample_value(s))));
+        }
+      }
+    });
+}
+
 template <typename sample_name_t, typename file_handle_t>
 template <class Archive>
 void sample_list_open_files<sample_name_t, file_handle_t>::save(
@@ -596,6 +672,48 @@ inline bool sample_list_open_files<sample_name_t, file_handle_t>::to_string(
   return true;
 }
 
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>::write_binary(
+  const std::string& path) const
+{
+  // Samples are grouped by file, as to_string() does
+  std::vector<sample_file_id_t> file_sequence;
+  std::unordered_map<sample_file_id_t, std::vector<sample_name_t>> by_file;
+  for (const auto& s : this->m_sample_list) {
+    auto& samples = by_file[s.first];
+    if (samples.empty()) {
+      file_sequence.push_back(s.first);
+    }
+    samples.push_back(s.second);
+  }
+
+  uint32_t flags = SAMPLE_LIST_BINARY_MULTI_SAMPLE;
+  if constexpr (std::is_integral_v<sample_name_t>) {
+    flags |= SAMPLE_LIST_BINARY_INTEGRAL_NAMES;
+  }
+  if (m_header.has_unused_sample_fields()) {
+    flags |= SAMPLE_LIST_BINARY_UNUSED_SAMPLE_FIELDS;
+  }
+  if (m_header.use_label_header()) {
+    flags |= SAMPLE_LIST_BINARY_LABEL_HEADER;
+  }
+  sample_list_binary_writer writer(flags,
+                                   m_header.get_file_dir(),
+                                   m_header.get_label_filename());
+  for (const auto id : file_sequence) {
+    writer.add_file(get_samples_filename(id));
+    for (const auto& s : by_file[id]) {
+      if constexpr (std::is_integral_v<sample_name_t>) {
+        writer.add_sample(static_cast<int64_t>(s));
+      }
+      else {
+        writer.add_sample(lbann::to_string(s));
+      }
+    }
+  }
+  writer.write(path);
+}
+
 template <typename sample_name_t, typename file_handle_t>
 inline void
 sample_list_open_files<sample_name_t, file_handle_t>::get_num_samples(
@@ -696,6 +814,7 @@ inline file_handle_t
 sample_list_open_files<sample_name_t, file_handle_t>::open_file_handle(
   std::string file_path)
 {
+  io_trace_scope trace(io_trace_op::open, file_path);
   file_handle_t file_hnd;
   clear_file_handle(file_hnd);
   bool retry = false;
@@ -792,6 +911,9 @@ inline void
 sample_list_open_files<sample_name_t, file_handle_t>::all_gather_packed_lists(
   lbann_comm& comm)
 {
+  if (this->m_has_all_slices) {
+    return;
+  }
   int num_ranks = comm.get_procs_per_trainer();
   typename std::vector<samples_t> per_rank_samples(num_ranks);
   typename std::vector<std::vector<std::string>> per_rank_files(num_ranks);
@@ -809,6 +931,8 @@ sample_list_open_files<sample_name_t, file_handle_t>::all_gather_packed_lists(
     my_files.emplace_back(std::get<FID_STATS_NAME>(e));
   }
   m_open_fd_pq.clear();
+  // File ids change below
+  m_stager.reset();
 
   size_t num_samples =
     this->all_gather_field(this->m_sample_list, per_rank_samples, comm);
@@ -884,6 +1008,7 @@ sample_list_open_files<sample_name_t, file_handle_t>::compute_epochs_file_usage(
   }
   // Once all of the file handles are closed, clear the priority queue
   m_open_fd_pq.clear();
+  m_file_usage_step = -1;
   for (size_t i = 0; i < shuffled_indices.size(); i++) {
     int idx = shuffled_indices[i];
     const auto& s = this->m_sample_list[idx];
@@ -915,47 +1040,106 @@ inline void sample_list_open_files<sample_name_t, file_handle_t>::
   return;
 }
 
+template <typename sample_name_t, typename file_handle_t>
+inline std::pair<int, int>
+sample_list_open_files<sample_name_t, file_handle_t>::next_file_use(
+  sample_file_id_t id)
+{
+  auto& file_access_queue =
+    std::get<FID_STATS_DEQUE>(m_file_id_stats_map[id]);
+  while (!file_access_queue.empty() &&
+         file_access_queue.front().first < m_file_usage_step) {
+    file_access_queue.pop_front();
+  }
+  if (file_access_queue.empty()) {
+    return std::make_pair(INT_MAX, INT_MAX);
+  }
+  return file_access_queue.front();
+}
+
 template <typename sample_name_t, typename file_handle_t>
 inline void
 sample_list_open_files<sample_name_t, file_handle_t>::manage_open_file_handles(
   sample_file_id_t id)
 {
-  /// When we enter this function the priority queue is either empty or a heap
-  if (!m_open_fd_pq.empty()) {
-    if (m_open_fd_pq.size() > m_max_open_files) {
-      auto& f = m_open_fd_pq.front();
-      auto& victim = m_file_id_stats_map[f.first];
-      auto& victim_fd = std::get<FID_STATS_HANDLE>(victim);
-      std::pop_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-      m_open_fd_pq.pop_back();
-      close_file_handle(victim_fd);
-      clear_file_handle(victim_fd);
+  /// Make room by closing the file whose next use is the furthest away.
+  /// Files that are not used again have the furthest use of all and go
+  /// first, oldest first.
+  while (!m_open_fd_pq.empty() && m_open_fd_pq.size() >= m_max_open_files) {
+    auto victim = m_open_fd_pq.begin();
+    for (auto it = m_open_fd_pq.begin(); it != m_open_fd_pq.end(); ++it) {
+      it->second = next_file_use(it->first);
+      if (pq_cmp(*victim, *it)) {
+        victim = it;
+      }
     }
-
-    /// Before we can enqueue the any new access times for this descriptor,
-    /// remove any earlier descriptor
-    std::sort_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-    if (m_open_fd_pq.front().first == id) {
-      m_open_fd_pq.pop_front();
+    auto& victim_fd =
+      std::get<FID_STATS_HANDLE>(m_file_id_stats_map[victim->first]);
+    {
+      const std::string file_path = io_trace_enabled()
+                                      ? get_samples_file_path(victim->first)
+                                      : std::string{};
+      io_trace_scope trace(io_trace_op::close, file_path);
+      close_file_handle(victim_fd);
     }
-    std::make_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
+    clear_file_handle(victim_fd);
+    m_open_fd_pq.erase(victim);
   }
 
-  auto& e = m_file_id_stats_map[id];
-  auto& file_access_queue = std::get<FID_STATS_DEQUE>(e);
-  if (!file_access_queue.empty()) {
-    file_access_queue.pop_front();
+  m_open_fd_pq.emplace_back(std::make_pair(id, next_file_use(id)));
+  return;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline std::string
+sample_list_open_files<sample_name_t, file_handle_t>::get_samples_file_path(
+  sample_file_id_t id) const
+{
+  if (m_stager) {
+    return m_stager->path(id);
   }
-  if (!file_access_queue.empty()) {
-    m_open_fd_pq.emplace_back(std::make_pair(id, file_access_queue.front()));
+  return add_delimiter(this->get_samples_dirname()) + get_samples_filename(id);
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void sample_list_open_files<sample_name_t, file_handle_t>::stage_files(
+  const std::string& stage_dir,
+  size_t stride,
+  size_t offset)
+{
+  std::vector<std::string> files;
+  std::vector<size_t> to_copy;
+  files.reserve(m_file_id_stats_map.size());
+  for (size_t id = 0; id < m_file_id_stats_map.size(); ++id) {
+    files.emplace_back(std::get<FID_STATS_NAME>(m_file_id_stats_map[id]));
+    if (id % stride == offset) {
+      to_copy.push_back(id);
+    }
   }
-  else {
-    /// If there are no future access of the file place a terminator entry to
-    /// track the open file, but is always sorted to the top of the heap
-    m_open_fd_pq.emplace_back(std::make_pair(id, std::make_pair(INT_MAX, id)));
+  m_stager = std::make_shared<file_stager>(this->get_samples_dirname(),
+                                           stage_dir,
+                                           std::move(files),
+                                           std::move(to_copy));
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::advance_file_usage_step()
+{
+  ++m_file_usage_step;
+}
+
+template <typename sample_name_t, typename file_handle_t>
+inline void
+sample_list_open_files<sample_name_t, file_handle_t>::open_samples_file_handles(
+  const std::vector<int>& indices)
+{
+  for (const int i : indices) {
+    if (m_open_fd_pq.size() >= m_max_open_files) {
+      return;
+    }
+    open_samples_file_handle(i);
   }
-  std::push_heap(m_open_fd_pq.begin(), m_open_fd_pq.end(), pq_cmp);
-  return;
 }
 
 template <typename sample_name_t, typename file_handle_t>
@@ -968,8 +1152,7 @@ sample_list_open_files<sample_name_t, file_handle_t>::open_samples_file_handle(
   file_handle_t h = get_samples_file_handle(id);
   if (!is_file_handle_valid(h)) {
     const std::string& file_name = get_samples_filename(id);
-    const std::string& file_dir = this->get_samples_dirname();
-    const std::string file_path = add_delimiter(file_dir) + file_name;
+    const std::string file_path = get_samples_file_path(id);
     if (file_name.empty() || !check_if_file_exists(file_path)) {
       LBANN_ERROR("data file '", file_path, "' does not exist.");
     }
@@ -997,10 +1180,14 @@ sample_list_open_files<sample_name_t, file_handle_t>::close_samples_file_handle(
   auto h = get_samples_file_handle(id);
   if (is_file_handle_valid(h)) {
     auto& e = m_file_id_stats_map[id];
-    auto& file_access_queue = std::get<FID_STATS_DEQUE>(e);
-    if (!check_if_in_use || file_access_queue.empty()) {
+    if (!check_if_in_use || next_file_use(id).first == INT_MAX) {
       auto& fh = std::get<FID_STATS_HANDLE>(e);
-      close_file_handle(fh);
+      {
+        const std::string file_path =
+          io_trace_enabled() ? get_samples_file_path(id) : std::string{};
+        io_trace_scope trace(io_trace_op::close, file_path);
+        close_file_handle(fh);
+      }
       clear_file_handle(fh);
       delete_file_handle_pq_entry(id);
     }
@@ -34,6 +34,10 @@
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
 #include "lbann/utils/exception.hpp"
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
@@ -158,13 +162,26 @@ public:
   /** @brief Returns "true" is running in local cache mode
    *
    * In local cache mode, each node contains a complete copy
-   * of the data set. This is stored in a shared memory segment,
-   * but part of the set may be spilled to disk if memory is
-   * insufficient. Local cache mode is activated via the cmd line
+   * of the data set. This is stored in a shared memory segment
+   * that is created once per <trainer, node> pair and mapped
+   * read-only by every rank of the trainer on that node, so
+   * node memory does not grow with the number of ranks per node.
+   * Local cache mode is activated via the cmd line
    * flag: --data_store_cache
    */
   bool is_local_cache() const { return m_is_local_cache; }
 
+  /** @brief Returns true if preloaded samples are packed into arena slabs
+   *
+   * In arena mode, fixed-size samples are copied into a few large,
+   * contiguous slabs (stride = m_compacted_sample_size) and m_data
+   * holds conduit::Node views over that memory, rather than owning
+   * one heap allocation per sample. Arena mode is activated via the
+   * cmd line flag: --data_store_arena, and only applies when
+   * preloading with uniform sample sizes and without spilling.
+   */
+  bool is_using_arena() const { return m_use_arena; }
+
   /** @brief Turn preloading on or off */
   void set_is_preloading(bool flag);
 
@@ -202,6 +219,18 @@ public:
   /// fills in m_owner, which maps index -> owning processor
   void build_preloaded_owner_map(const std::vector<int>& per_rank_list_sizes);
 
+  /** @brief Permutes each mini-batch so samples land on their owners
+   *
+   * Only the order of samples within a mini-batch window of @c indices
+   * changes, so mini-batch membership is left as shuffled. Each sample
+   * is moved to a slot consumed by the rank that owns it, or failing
+   * that by a rank on the owner's node. A fraction of each window,
+   * set by --data_store_locality_randomness, keeps its shuffled slot.
+   * No-op unless --data_store_locality_aware is given and the owner map
+   * is complete. Collective over the trainer the first time it runs.
+   */
+  void localize_shuffled_indices(std::vector<int>& indices);
+
   /// fills in m_owner, which maps index -> owning processor
   void set_preloaded_owner_map(const std::unordered_map<int, int>& owner)
   {
@@ -247,13 +276,58 @@ public:
    */
   void preload_local_cache();
 
-  void start_exchange_mini_batch_data(size_t current_pos, size_t mb_size);
+  /** @brief Starts the exchange of the samples for a mini-batch
+   *
+   * @param current_pos,mb_size  The mini-batch that is exchanged next;
+   *        finish_exchange_mini_batch_data() completes this exchange
+   * @param upcoming  (position, size) of the mini-batches that follow
+   *        in this epoch; exchanges are started for as many of them as
+   *        the lookahead depth permits. Every rank in the trainer must
+   *        pass the same list.
+   */
+  void start_exchange_mini_batch_data(
+    size_t current_pos,
+    size_t mb_size,
+    const std::vector<std::pair<size_t, size_t>>& upcoming = {});
   void finish_exchange_mini_batch_data();
 
+  /** @brief Returns the maximum number of mini-batch exchanges in flight
+   *
+   * Set via the cmd line flag: --data_store_exchange_lookahead=\<n\>;
+   * the default of 1 overlaps a single exchange. Lookahead is disabled
+   * when spilling.
+   */
+  int get_exchange_lookahead() const
+  {
+    return m_spill ? 1 : m_exchange_lookahead;
+  }
+
+  /** @brief Returns the number of upcoming mini-batches, beyond the
+   *  current one, the data store wants to know about
+   *
+   *  Covers both exchanges kept in flight and samples prefetched from
+   *  spill segments.
+   */
+  int get_num_upcoming_mini_batches() const
+  {
+    const int n = get_exchange_lookahead() - 1;
+    return (m_spill_segments && m_spill_prefetch_depth > n)
+             ? m_spill_prefetch_depth
+             : n;
+  }
+
   void set_node_sizes_vary() { m_node_sizes_vary = true; }
 
   bool has_conduit_node(int data_id) const;
 
+  /** @brief Returns false if the sample was left out of the data store
+   *  because of --data_store_mem_budget_mb; the reader must then load it
+   *  from file */
+  bool is_cached(int data_id) const
+  {
+    return m_uncached.find(data_id) == m_uncached.end();
+  }
+
   /// only used for debugging; pass --debug on cmd line to get
   /// each data store to print to a different file. This is made
   /// public so data readers can also print to the file
@@ -361,6 +435,48 @@ private:
   /** @brief maps data_id to m_m_cur_spill_dir_integer. */
   map_ii_t m_spilled_nodes;
 
+  /** @brief if true, spilled samples are appended to large segment files
+   *  (--data_store_spill_segments) instead of one file per sample */
+  bool m_spill_segments = false;
+
+  /** @brief Location of one packed sample in the spill segments */
+  struct spill_extent
+  {
+    int segment = -1;
+    size_t offset = 0;
+    size_t length = 0;
+  };
+
+  /** @brief maps data_id to where its packed sample was spilled */
+  std::unordered_map<int, spill_extent> m_spill_index;
+
+  /** @brief Segment currently being appended to, and its descriptor */
+  int m_spill_cur_segment = -1;
+  int m_spill_write_fd = -1;
+  size_t m_spill_segment_bytes = 0;
+
+  /** @brief Segments are closed once they reach this size */
+  static constexpr size_t m_spill_max_segment_bytes = size_t(1) << 30;
+
+  /** @brief Read-only descriptors, indexed by segment; opened lazily */
+  std::vector<int> m_spill_read_fds;
+
+  /** @brief DRAM tier: packed samples read back from the segments,
+   *  most recently used first */
+  std::list<std::pair<int, std::vector<El::byte>>> m_spill_cache;
+  std::unordered_map<int, decltype(m_spill_cache)::iterator>
+    m_spill_cache_map;
+  size_t m_spill_cache_bytes = 0;
+  size_t m_spill_cache_capacity = 0;
+
+  /** @brief Number of upcoming mini-batches whose spilled samples are
+   *  read into the DRAM tier in the background */
+  int m_spill_prefetch_depth = 1;
+  std::future<void> m_spill_prefetch;
+
+  /// guards m_spill_cache, m_spill_cache_map and m_spill_read_fds
+  std::mutex m_spill_mutex;
+
   /// used in set_conduit_node(...)
   std::mutex m_mutex;
   std::mutex m_mutex_2;
@@ -370,6 +486,24 @@ private:
   size_t m_mem_seg_length = 0;
   std::string m_seg_name;
 
+  /// for use in local cache mode: ranks of this trainer on this node
+  El::mpi::Comm m_trainer_node_comm;
+  /// for use in local cache mode: rank 0 of each m_trainer_node_comm
+  El::mpi::Comm m_node_leaders_comm;
+  /// true if m_trainer_node_comm and m_node_leaders_comm must be freed
+  bool m_have_node_local_comms = false;
+  /// rank of this process in m_trainer_node_comm
+  int m_rank_in_trainer_node = 0;
+  /// maps rank in trainer -> rank of its node leader in m_node_leaders_comm
+  std::vector<int> m_node_leader_of_rank;
+  /// for use in local cache mode: the segment is shared by every rank
+  /// of the node rather than by the ranks of this trainer, see
+  /// --data_store_cache_shared
+  bool m_share_cache_across_trainers = false;
+  /// for use in local cache mode: whether this rank's trainer fills
+  /// the segment; only false when it is shared with other trainers
+  bool m_is_cache_writer = true;
+
   const std::string m_debug_filename_base = "debug";
   std::string m_debug_filename;
 
@@ -492,8 +626,6 @@ private:
    */
   std::unordered_map<int, conduit::Node> m_data_cache;
 
-  /// Contains the list of data IDs that will be received
-  std::vector<int> m_recv_data_ids;
   map_ii_t m_recv_sample_sizes;
 
   /// This vector contains Nodes that this processor needs for
@@ -503,12 +635,77 @@ private:
   /// work space; used in exchange_data
   std::vector<conduit::Node> m_send_buffer;
   std::vector<conduit::Node> m_send_buffer_2;
-  std::vector<El::mpi::Request<El::byte>> m_send_requests;
-  std::vector<El::mpi::Request<El::byte>> m_recv_requests;
-  std::vector<conduit::Node> m_recv_buffer;
   std::vector<size_t> m_outgoing_msg_sizes;
   std::vector<size_t> m_incoming_msg_sizes;
 
+  /** @brief MPI tag used for packed exchange messages
+   *
+   * A single tag suffices even with several exchanges in flight: all
+   * ranks start exchanges in the same order, and MPI does not let
+   * messages with the same source, tag and communicator overtake.
+   */
+  static constexpr int m_packed_exchange_tag = 0;
+
+  /** @brief Buffers and requests for one mini-batch exchange */
+  struct exchange_state
+  {
+    size_t current_pos = 0;
+    size_t mb_size = 0;
+    /// True if samples are packed per peer; see: use_packed_exchange()
+    bool is_packed = false;
+    std::vector<El::mpi::Request<El::byte>> send_requests;
+    std::vector<El::mpi::Request<El::byte>> recv_requests;
+    /// per-sample exchange: one receive buffer and data_id per sample
+    std::vector<conduit::Node> recv_buffer;
+    std::vector<int> recv_data_ids;
+    /// packed exchange: entry p holds the single message that is sent
+    /// to (or received from) P_p
+    std::vector<std::vector<El::byte>> packed_send_buffers;
+    std::vector<std::vector<El::byte>> packed_recv_buffers;
+    std::vector<std::unordered_set<int>> indices_to_recv;
+    /// inflated receive buffers, when samples are stored compressed
+    std::vector<std::vector<El::byte>> decompressed;
+  };
+
+  /** @brief Exchanges that have been started but not finished, oldest
+   *  first; holds at most get_exchange_lookahead() entries */
+  std::deque<exchange_state> m_exchanges_in_flight;
+
+  /** @brief The most recently finished exchange
+   *
+   * m_minibatch_data holds views into its receive buffers, so it is
+   * kept alive until the next exchange finishes.
+   */
+  exchange_state m_finished_exchange;
+
+  /** @brief See: get_exchange_lookahead() */
+  int m_exchange_lookahead = 1;
+
+  /** @brief Bytes of preloaded samples this rank may hold; 0 means no
+   *  limit. Derived from the per-node --data_store_mem_budget_mb */
+  size_t m_mem_budget_per_rank = 0;
+
+  /** @brief Bytes of preloaded samples this rank holds */
+  size_t m_cached_bytes = 0;
+
+  /** @brief Samples this rank owned but dropped for lack of budget;
+   *  shared with the trainer by finalize_partial_cache() */
+  std::vector<int> m_dropped_samples;
+
+  /** @brief Samples no rank in the trainer caches */
+  std::unordered_set<int> m_uncached;
+
+  /** @brief if true, preloaded samples are kept zlib-compressed in m_data
+   *  (--data_store_compress) and inflated by the receiving rank */
+  bool m_compress = false;
+
+  /** @brief See: localize_shuffled_indices() */
+  bool m_locality_aware = false;
+
+  /** @brief Fraction of each mini-batch left in shuffled order by
+   *  localize_shuffled_indices() */
+  double m_locality_randomness = 0.;
+
   /** @brief Maps a data_id to its image size
    *
    * Used when conduit Nodes have non-uniform size, e.g, imagenet;
@@ -519,6 +716,40 @@ private:
   /** @brief Maps a data_id to the image location in a shared memory segment */
   map_is_t m_image_offsets;
 
+  //===========================================================
+  // arena storage for preloaded samples; see: is_using_arena()
+  //===========================================================
+
+  /** @brief if true, preloaded samples are packed into m_arena_slabs */
+  bool m_use_arena = false;
+
+  /** @brief Number of samples this rank is expected to own when preloading
+   *
+   * Set by build_preloaded_owner_map(); used to size the first slab so
+   * that, in the common case, all samples live in a single allocation.
+   */
+  size_t m_arena_expected_num_samples = 0;
+
+  /** @brief Minimum number of samples in each additional slab */
+  const size_t m_arena_min_slab_samples = 1024;
+
+  /** @brief Slabs of packed samples; each sample occupies
+   *  m_compacted_sample_size bytes.
+   *
+   * Shared pointers are used so that copies of the data store (which
+   * share the views in m_data) keep the memory alive.
+   */
+  std::vector<std::shared_ptr<El::byte[]>> m_arena_slabs;
+
+  /** @brief Number of samples each entry in m_arena_slabs can hold */
+  std::vector<size_t> m_arena_slab_capacity;
+
+  /** @brief Number of samples stored in the last entry of m_arena_slabs */
+  size_t m_arena_slab_fill = 0;
+
+  /** @brief Maps a data_id to the start of its packed buffer in the arena */
+  std::unordered_map<int, El::byte*> m_arena_ptrs;
+
   /// maps processor id -> set of indices (whose associated samples)
   /// this proc needs to send. (formerly called "proc_to_indices);
   /// this is filled in by build_indices_i_will_send()
@@ -535,6 +766,39 @@ private:
   void start_exchange_data_by_sample(size_t current_pos, size_t mb_size);
   void finish_exchange_data_by_sample();
 
+  /** @brief Returns true if samples should be exchanged in one message
+   *  per peer, rather than one message per sample
+   *
+   * Packing requires uniform sample sizes; the decision depends only on
+   * values that are identical on all ranks, so senders and receivers
+   * always agree.
+   */
+  bool use_packed_exchange(size_t mb_size) const;
+
+  /** @brief Returns the size of a packed message holding 'n' samples
+   *
+   * A packed message is laid out as: [n][data_id_0 ... data_id_n-1]
+   * followed by the n samples, each m_compacted_sample_size bytes;
+   * the header entries are int64.
+   */
+  size_t get_packed_msg_size(size_t n) const;
+
+  /// packs and posts one send (and one recv) per peer
+  void start_exchange_packed_data(exchange_state& x);
+  void finish_exchange_packed_data(exchange_state& x);
+
+  /** @brief Waits for, then drops, every exchange in flight
+   *
+   * Used when the mini-batch requested does not match the one that was
+   * prefetched; all ranks make the same decision, as they are passed
+   * the same positions.
+   */
+  void discard_exchanges_in_flight();
+
+  /** @brief Sets 'node' to an external view of the sample held in
+   *  'buf', which has the layout produced by build_node_for_sending() */
+  void unpack_sample(const conduit::uint8* buf, conduit::Node& node);
+
   void setup_data_store_buffers();
 
   /// called by exchange_data
@@ -552,8 +816,43 @@ private:
   /// that will be received
   int build_indices_i_will_recv(int current_pos, int mb_size);
 
+  /** @brief Deflates a node built by build_node_for_sending(); the output
+   *  starts with the inflated length as an int64 */
+  static void compress_packed_node(const conduit::Node& packed,
+                                   std::vector<El::byte>& out);
+
+  /** @brief Inverse of compress_packed_node(); returns false on error */
+  static bool decompress_packed_node(const conduit::Node& in,
+                                     std::vector<El::byte>& out);
+
+  /** @brief Tells every rank which samples were dropped during a
+   *  budgeted preload and removes them from the owner map */
+  void finalize_partial_cache();
+
+  /// returns the rank in the trainer that consumes the sample at position
+  /// pos of the shuffled indices
+  int get_consumer_rank(int pos) const;
+
   void error_check_compacted_node(const conduit::Node& nd, int data_id);
 
+  /** @brief Copies a packed node into the arena and replaces m_data[data_id]
+   *  with an external view over the copy
+   *
+   * Caller must hold m_mutex.
+   */
+  void set_arena_node(int data_id, const conduit::Node& packed);
+
+  /** @brief Returns the address of m_compacted_sample_size free bytes in the
+   *  arena, allocating a new slab if necessary
+   *
+   * Caller must hold m_mutex.
+   */
+  El::byte* allocate_arena_slot();
+
+  /** @brief Returns the packed (contiguous) buffer for a sample owned by
+   *  this rank, whether it lives in the arena or in an owned node */
+  const El::byte* get_packed_sample_ptr(int data_id);
+
   /** @brief All ranks exchange their cached data */
   void exchange_local_caches();
 
@@ -566,25 +865,26 @@ private:
   void allocate_shared_segment(map_is_t& sizes,
                                std::vector<std::vector<int>>& indices);
 
-  /// for use in local cache mode
-  void read_files(std::vector<char>& work,
-                  map_is_t& sizes,
-                  std::vector<int>& indices);
+  /// for use in local cache mode; sets up m_trainer_node_comm,
+  /// m_node_leaders_comm and m_node_leader_of_rank, and chooses the
+  /// trainer that fills a segment shared across trainers
+  void setup_node_local_comms();
+
+  /// for use in local cache mode; reads files directly into the
+  /// shared segment, at the offsets given by m_image_offsets
+  void read_files(map_is_t& sizes, std::vector<int>& indices);
 
   /// fills in m_image_offsets for use in local cache mode
   void compute_image_offsets(map_is_t& image_sizes,
                              std::vector<std::vector<int>>& indices);
 
-  /// for use in local cache mode
-  void exchange_images(std::vector<char>& work,
-                       map_is_t& image_sizes,
+  /// for use in local cache mode; only node leaders communicate,
+  /// and they broadcast directly from and into the shared segment
+  void exchange_images(map_is_t& image_sizes,
                        std::vector<std::vector<int>>& indices);
 
   void build_conduit_nodes(map_is_t& sizes);
 
-  /// for use in local cache mode
-  void fillin_shared_images(char* images, size_t size, size_t offset);
-
   /** @brief For testing during development
    *
    * At the beginning of the 2nd epoch, calls write_checkpoint(),
@@ -616,6 +916,27 @@ private:
   /** @brief Loads conduit nodes from file into m_data */
   void load_spilled_conduit_nodes();
 
+  /** @brief Appends a packed node to the current spill segment
+   *
+   * Caller must hold m_mutex.
+   */
+  void spill_to_segment(const conduit::Node& packed, int data_id);
+
+  std::string get_spill_segment_fn(int segment) const;
+
+  /** @brief Reads the packed sample for data_id, from the DRAM tier if
+   *  it is there and from its segment otherwise */
+  void read_spilled_sample(int data_id, std::vector<El::byte>& buf);
+
+  /** @brief Reads the samples this rank owns in the upcoming mini-batches
+   *  into the DRAM tier, in the background */
+  void start_spill_prefetch(
+    const std::vector<std::pair<size_t, size_t>>& upcoming);
+
+  /** @brief Inserts a packed sample at the front of the DRAM tier, then
+   *  evicts from the back down to m_spill_cache_capacity */
+  void cache_spilled_sample(int data_id, std::vector<El::byte>&& buf);
+
   /** @brief Creates directory structure, opens metadata file for output, etc
    *
    * This method is called for both --data_store_spill and
@@ -630,6 +951,25 @@ private:
    */
   void save_state();
 
+  /** @brief Writes the arena as one sequential snapshot file
+   *
+   * Layout: a header of five int64 (magic, version, number of samples,
+   * packed sample size, offset of the sample data), the data_ids in
+   * arena order, then the packed samples starting at a page boundary.
+   * The owner map and sample sizes are saved by save_state().
+   */
+  void write_snapshot();
+
+  /** @brief Maps a snapshot written by write_snapshot() back in as the
+   *  arena; returns false if there is no snapshot for this rank */
+  bool load_snapshot();
+
+  std::string get_snapshot_fn() const;
+
+  /** @brief Rebuilds the schema of a node built by build_node_for_sending()
+   *  from its packed bytes */
+  static void get_packed_schema(const El::byte* buf, conduit::Schema& s);
+
   /** @brief Optionally open debug and profiling files
    *
    * A debug file is opened for every <rank, data reader role> pair;
@@ -115,6 +115,55 @@ public:
     return labels;
   }
 
+  /** @brief Run model inference on samples and return the output
+   *         tensors.
+   * @param[in] model A trained model
+   * @param[in] samples A distributed matrix containing samples for model input
+   * @param[in] mbs The max mini-batch size
+   * @param[in] output_layer Name of the layer whose activations are
+   *            returned. The softmax layer is used if empty.
+   * @return Matrix with the flattened output tensor of each sample in
+   *         a row
+   */
+  template <typename DataT,
+            El::Dist CDist,
+            El::Dist RDist,
+            El::DistWrap DistView,
+            El::Device Device>
+  El::Matrix<float, El::Device::CPU>
+  infer_outputs(
+    observer_ptr<model> model,
+    El::DistMatrix<DataT, CDist, RDist, DistView, Device> const& samples,
+    size_t mbs,
+    std::string const& output_layer = "")
+  {
+    if (mbs <= 0) {
+      LBANN_ERROR("mini-batch size must be larger than 0");
+    }
+
+    size_t samples_size = samples.Height();
+    El::Matrix<float, El::Device::CPU> outputs;
+
+    auto c = SGDExecutionContext(execution_mode::inference, mbs);
+    model->reset_mode(c, execution_mode::inference);
+
+    for (size_t i = 0; i < samples_size; i += mbs) {
+      size_t mb_idx = std::min(i + mbs, samples_size);
+      auto mb_range = El::IR(i, mb_idx);
+      auto mb_samples = El::LockedView(samples, mb_range, El::ALL);
+
+      infer_mini_batch(*model, mb_samples);
+      const auto& activations = get_output_layer(*model, output_layer);
+      if (outputs.Height() == 0) {
+        outputs.Resize(samples_size, activations.Height());
+      }
+      auto mb_outputs = El::View(outputs, mb_range, El::ALL);
+      get_outputs(activations, mb_outputs);
+    }
+
+    return outputs;
+  }
+
 protected:
   /** @brief Run model inference on a single mini-batch of samples
    * This method takes a mini-batch of samples, inserts them into the input
@@ -142,6 +191,42 @@ protected:
     model.forward_prop(execution_mode::inference);
   }
 
+  /** @brief Finds the activations of a model's output layer
+   * @param[in] model A model that has been used for inference
+   * @param[in] name The name of the output layer, or empty for the
+   *            softmax layer
+   */
+  El::AbstractDistMatrix<float> const&
+  get_output_layer(model const& model, std::string const& name) const
+  {
+    for (const auto* l : model.get_layers()) {
+      if (name.empty() ? l->get_type() == "softmax" : l->get_name() == name) {
+        auto const* dtl = dynamic_cast<data_type_layer<float> const*>(l);
+        if (dtl == nullptr) {
+          LBANN_ERROR("output layer ", l->get_name(), " is not a float layer");
+        }
+        return dtl->get_activations();
+      }
+    }
+    LBANN_ERROR("could not find output layer ",
+                name.empty() ? std::string("of type softmax") : name);
+  }
+
+  /** @brief Copies the activations of a mini-batch, one sample per
+   *         row
+   * @param[in] activations Output layer activations, one sample per
+   *            column
+   * @param[in] outputs A matrix to place the outputs in
+   */
+  void get_outputs(El::AbstractDistMatrix<float> const& activations,
+                   El::Matrix<float, El::Device::CPU>& outputs)
+  {
+    El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+      local(activations.Grid(), activations.Root());
+    El::Copy(activations, local);
+    El::Transpose(local.LockedMatrix(), outputs);
+  }
+
   /** @brief Finds the predicted category in a models softmax layer
    * @param[in] model A model that has been used for inference
    * @param[in] labels A matrix to place predicted category labels
@@ -0,0 +1,157 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_INFERENCE_SERVER_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_INFERENCE_SERVER_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Settings of an inference server */
+struct inference_server_config
+{
+  /** TCP port the world master listens on */
+  int port = 8245;
+  /** Most samples run in one forward pass. Must match the mini-batch
+   *  size the model was set up with. */
+  size_t max_batch = 32;
+  /** Longest time, in seconds, that a request waits for more requests
+   *  to be batched with it */
+  double max_latency = 0.005;
+  /** Layer whose activations are returned; the softmax layer if empty */
+  std::string output_layer;
+};
+
+/** @class inference_server
+ *  @brief Serves inference requests with a resident model
+ *
+ *  The world master accepts TCP connections, each carrying a stream
+ *  of requests. A request is the little-endian header
+ *  <tt>uint32 magic ("LBIR"), uint32 num_samples, uint32 sample_size</tt>
+ *  followed by @c num_samples rows of @c sample_size floats. The reply
+ *  to each request is <tt>uint32 status, uint32 num_samples,
+ *  uint32 output_size</tt> followed by the output tensor of each
+ *  sample, in order. A status of 0 means success. A request with no
+ *  samples stops the server.
+ *
+ *  Requests are batched dynamically: a forward pass starts when
+ *  @c max_batch samples are queued, or when the oldest request has
+ *  waited for @c max_latency. The batch is broadcast to the trainer,
+ *  so every rank of the trainer must call run().
+ */
+class inference_server
+{
+public:
+  /** @param comm The LBANN communicator
+   *  @param m A model set up for inference, see load_inference_model
+   *  @param sample_size Number of entries in a flattened input sample
+   *  @param config Server settings
+   */
+  inference_server(lbann_comm* comm,
+                   observer_ptr<model> m,
+                   size_t sample_size,
+                   inference_server_config config);
+  ~inference_server();
+  inference_server(const inference_server&) = delete;
+  inference_server& operator=(const inference_server&) = delete;
+
+  /** @brief Serve requests until a shutdown request is received
+   *  @details Collective over the trainer. */
+  void run();
+
+  /** @brief Stop serving once the current batch is done
+   *  @details May be called from any thread of the world master. */
+  void stop();
+
+private:
+  /** Reply to a request */
+  struct response
+  {
+    uint32_t status = 0;
+    uint32_t output_size = 0;
+    std::vector<float> outputs;
+  };
+  /** Request waiting to be batched */
+  struct pending_request
+  {
+    std::vector<float> samples;
+    size_t num_samples;
+    double arrival;
+    std::promise<response> reply;
+  };
+
+  /** Wait for the next batch of requests; empty if stopping */
+  std::vector<std::unique_ptr<pending_request>> next_batch();
+  /** Run a batch of num_samples samples already in m_samples */
+  void run_batch(size_t num_samples);
+  /** Accept connections until stopped */
+  void listen_loop();
+  /** Serve the requests of a connection until it is closed */
+  void serve_connection(int fd);
+  /** Queue a request and wait for its reply */
+  response submit(std::vector<float> samples, size_t num_samples);
+
+  lbann_comm* m_comm;
+  observer_ptr<model> m_model;
+  size_t m_sample_size;
+  inference_server_config m_config;
+  batch_functional_inference_algorithm m_algorithm;
+
+  /** Input buffer, kept between batches */
+  El::DistMatrix<float, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+    m_samples;
+  /** Outputs of the last batch, on the world master */
+  El::Matrix<float, El::Device::CPU> m_outputs;
+
+  /** Protects the state shared with the connection threads */
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::unique_ptr<pending_request>> m_pending;
+  size_t m_num_pending_samples = 0;
+  bool m_stop = false;
+
+  int m_listen_fd = -1;
+  std::thread m_listener;
+  std::vector<std::thread> m_connections;
+  std::vector<int> m_connection_fds;
+};
+
+} // namespace lbann
+
+#endif // LBANN_EXECUTION_ALGORITHMS_INFERENCE_SERVER_HPP_INCLUDED
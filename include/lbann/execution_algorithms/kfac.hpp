@@ -91,7 +91,12 @@ public:
        bool distribute_precondition_compute,
        bool use_eigen_decomposition,
        bool enable_copy_errors,
-       bool enable_copy_activations);
+       bool enable_copy_activations,
+       bool split_large_inverses,
+       bool async_inverse,
+       size_t eigenbasis_update_interval,
+       kfac::kfac_communication_precision communication_precision,
+       size_t max_batched_inverse_size);
 
   ~KFAC() noexcept = default;
   KFAC(KFAC const& other) = delete;
@@ -201,6 +206,27 @@ private:
   void allgather_precondition_gradient(lbann_comm& comm,
                                        ExeContextType& context);
 
+  /** @brief Invert the Kronecker factors of the blocks assigned to
+   *  this process. */
+  void update_kronecker_inverses(ExeContextType& context, lbann_comm& comm);
+
+  /** @brief Invert the factors and start gathering the inverses.
+   *
+   *  The gathered inverses are copied into the blocks in the next
+   *  step, so the gradients of steps in between are preconditioned
+   *  with the inverses of the previous update.
+   */
+  void start_async_inverse(ExeContextType& context, lbann_comm& comm);
+
+  /** @brief Assign the inverses of the blocks to processes.
+   *
+   *  Longest-processing-time first: inverses are taken in order of
+   *  decreasing estimated cost and each is given to the process with
+   *  the smallest load so far. Nothing is done if the costs are the
+   *  same as in the last call.
+   */
+  void balance_inverse_proc_ranks(ExeContextType& context, lbann_comm& comm);
+
   /** @brief The KFAC stopping criteria. */
   std::unique_ptr<TermCriteriaType> m_stopping_criteria;
 
@@ -261,6 +287,18 @@ private:
   /** @brief use eigen value decomposition for inversing the matrix. */
   bool m_use_eigen_decomposition;
 
+  /** @brief Inverse updates between eigendecompositions of the
+   *  Kronecker factors. */
+  size_t m_eigenbasis_update_interval;
+
+  /** @brief Precision of the Kronecker factor and inverse
+   *  communication. */
+  kfac::kfac_communication_precision m_communication_precision;
+
+  /** @brief Largest BN, channel-wise FC and GRU factor inverted in a
+   *  batch, or 0 to invert each factor separately. */
+  size_t m_max_batched_inverse_size;
+
   El::Matrix<double, El::Device::CPU> m_inverse_matrices_size;
 
   int m_global_inverse_buffer_size = 0, m_weight_matrices_buffer_size = 0;
@@ -278,6 +316,27 @@ private:
 
   std::vector<bool> m_use_KFAC_epoch;
 
+  /** @brief Invert the factors of blocks costing more than an even
+   *  share of the inverses on separate processes. */
+  bool m_split_large_inverses;
+
+  /** @brief Inverse costs of the blocks at the last assignment. */
+  std::vector<std::vector<double>> m_inverse_costs;
+
+  /** @brief Overlap the inversion and gathering of the factors with
+   *  the next step, see start_async_inverse. */
+  bool m_async_inverse;
+
+  /** @brief State of the asynchronous gathering of the inverses. */
+  bool m_async_inverse_pending = false;
+  Al::request m_async_inverse_req;
+  int m_async_inverse_buffer_size = 0;
+
+  /** @brief Whether the secondary grid updated its inverses since
+   *  they were last sent, and whether they are being sent. */
+  bool m_inverse_exchange_required = false;
+  bool m_inverse_exchange_started = false;
+
 }; // class KFAC
 
 } // namespace lbann
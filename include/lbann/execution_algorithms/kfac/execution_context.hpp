@@ -116,6 +116,15 @@ public:
 
   void print_workspace_size(model& model);
 
+  /** @brief Queue the inverse of a damped symmetric matrix for
+   *  flush_inverse_requests.
+   *  @returns false if the matrix is too large to be batched, in which
+   *  case it must be inverted by the caller. */
+  bool defer_inverse(const inverse_request& request);
+
+  /** @brief Invert the queued matrices in batches. */
+  void flush_inverse_requests(bool report_time);
+
 private:
   SGDExecutionContext m_sgd_execution_context;
 
@@ -131,6 +140,13 @@ private:
   /** @brief Workspace matrices that are used by m_blocks. */
   std::unordered_map<std::string, El::Matrix<DataType, Device>> m_workspace;
 
+  /** @brief Largest matrix inverted in a batch, or 0 to disable
+   *  batching. */
+  size_t m_max_batched_inverse_size = 0;
+
+  /** @brief Inverses queued by defer_inverse. */
+  std::vector<inverse_request> m_inverse_requests;
+
 }; // class ExecutionContext
 
 } // namespace kfac
@@ -30,6 +30,9 @@
 #include "lbann/execution_algorithms/kfac/execution_context.hpp"
 #include "lbann/layers/layer.hpp"
 
+#include <algorithm>
+#include <unordered_map>
+
 namespace lbann {
 
 // Forward declaration
@@ -169,6 +172,33 @@ public:
 
   size_t get_inverse_proc_rank() const { return m_inverse_proc_rank; }
 
+  /** @brief Get the estimated flops of inverting each Kronecker
+   *  factor. Factors that cannot be inverted on separate processes
+   *  are reported as one entry. */
+  virtual std::vector<double> get_inverse_costs() const = 0;
+
+  /** @brief Set the process which inverts each entry of
+   *  get_inverse_costs. The first one also preconditions the
+   *  gradients. */
+  virtual void set_inverse_proc_ranks(const std::vector<size_t>& ranks)
+  {
+    m_inverse_proc_rank = ranks.at(0);
+  }
+
+  /** @brief Whether a process inverts any of the Kronecker factors. */
+  virtual bool is_inverse_proc_rank(size_t rank) const
+  {
+    return rank == get_inverse_proc_rank();
+  }
+
+  /** @brief Set the number of inverse updates between the
+   *  eigendecompositions of the Kronecker factors, see
+   *  get_matrix_inverse_cached_eigen. */
+  void set_eigenbasis_update_interval(size_t interval)
+  {
+    m_eigenbasis_update_interval = std::max(interval, size_t(1));
+  }
+
   DataType* get_local_activation_buffer(int index)
   {
     return m_parent_local_activations[index]->Buffer();
@@ -210,6 +240,36 @@ protected:
   /** @brief Return the default sync info that may used in update functions. */
   El::SyncInfo<Device> get_sync_info();
 
+  /** @brief Gets the inverse matrix of A as kfac::get_matrix_inverse
+   *  does, or queues it in the execution context to be inverted in a
+   *  batch with other small factors at the end of the inverse update.
+   *  Ainv must not be used before then. Linv is a workspace of the
+   *  size of A. */
+  void get_matrix_inverse_batched(El::AbstractMatrix<DataType>& Ainv,
+                                  El::AbstractMatrix<DataType>& Linv,
+                                  const El::AbstractMatrix<DataType>& A,
+                                  bool report_time,
+                                  DataType damping,
+                                  DataType damping_bn_err,
+                                  bool is_bn);
+
+  /** @brief Gets the inverse matrix of A using a cached eigenbasis.
+   *
+   *  The eigendecomposition of A is only recomputed every
+   *  m_eigenbasis_update_interval calls with the same key. In
+   *  between, the eigenvalues of A are re-estimated in the cached
+   *  eigenbasis and the damping is applied to them, which costs two
+   *  GEMMs instead of a syevd. W is a workspace of the size of A.
+   */
+  void get_matrix_inverse_cached_eigen(const std::string& key,
+                                       El::AbstractMatrix<DataType>& Ainv,
+                                       El::Matrix<DataType, Device>& W,
+                                       const El::AbstractMatrix<DataType>& A,
+                                       bool report_time,
+                                       DataType damping,
+                                       DataType damping_bn_err,
+                                       bool is_bn);
+
   /** @brief The target layer. */
   Layer* m_layer;
 
@@ -218,7 +278,7 @@ protected:
   const size_t m_layer_id;
 
   /** @brief The process ID which perform inverse on Kronecker. */
-  const int m_inverse_proc_rank;
+  int m_inverse_proc_rank;
 
   /** @brief distributed martices for activations and gradients. */
   std::vector<std::unique_ptr<AbsDistMat>> m_parent_local_activations,
@@ -245,6 +305,13 @@ protected:
   /** @brief Whether this block already has an inverse history. */
   bool m_has_kronecker_inverse;
 
+  /** @brief Inverse updates between eigendecompositions. */
+  size_t m_eigenbasis_update_interval = 1;
+
+  /** @brief Inverse updates since the eigendecomposition of each
+   *  cached eigenbasis. */
+  std::unordered_map<std::string, size_t> m_eigenbasis_age;
+
 private:
   /** @brief The execution context that created this block.
    *  TODO: Use its own workspace and remove this pointer. */
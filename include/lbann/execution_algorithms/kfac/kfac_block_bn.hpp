@@ -179,6 +179,8 @@ public:
   /** @brief Get inverse matrices size (offset). */
   int get_inverse_matrices_size(lbann_comm* comm) override;
 
+  std::vector<double> get_inverse_costs() const override;
+
   /** @brief Get inverse matrices size vector */
   std::vector<int> get_inverse_matrices_size_vector(lbann_comm* comm) override
   {
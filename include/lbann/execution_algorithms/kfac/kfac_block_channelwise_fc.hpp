@@ -134,6 +134,8 @@ public:
 
   int get_inverse_matrices_size(lbann_comm* comm) final;
 
+  std::vector<double> get_inverse_costs() const final;
+
   std::vector<int> get_inverse_matrices_size_vector(lbann_comm* comm) final;
 
   void resize_inverse_matrices_size(
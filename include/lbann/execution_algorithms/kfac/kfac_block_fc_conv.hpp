@@ -91,7 +91,8 @@ public:
                          input_size,
                          output_size),
       m_is_conv(is_conv),
-      m_has_bias(layer->num_weights() > 1)
+      m_has_bias(layer->num_weights() > 1),
+      m_inverse_proc_rank_G(inverse_proc_rank)
   {
     if (m_is_conv) {
       m_conv_input_spatial_prod = 1;
@@ -201,6 +202,14 @@ public:
 
   int get_inverse_matrices_size(lbann_comm* comm) override;
 
+  /** @brief The costs of inverting A and G, which may be inverted
+   *  on separate processes. */
+  std::vector<double> get_inverse_costs() const override;
+
+  void set_inverse_proc_ranks(const std::vector<size_t>& ranks) override;
+
+  bool is_inverse_proc_rank(size_t rank) const override;
+
   std::vector<int> get_inverse_matrices_size_vector(lbann_comm* comm) override;
 
   void resize_inverse_matrices_size(
@@ -215,6 +224,8 @@ public:
   {
     std::ostringstream oss;
     oss << kfac_block<Device>::get_info() << ", is_conv=" << m_is_conv;
+    if (m_inverse_proc_rank_G != this->get_inverse_proc_rank())
+      oss << ", inverse_proc_rank_G=" << m_inverse_proc_rank_G;
     return oss.str();
   }
 
@@ -279,6 +290,14 @@ private:
   size_t m_Ainv_height = 0, m_Ainv_width = 0, m_Ginv_height = 0,
          m_Ginv_width = 0;
 
+  /** @brief The process which inverts G. A is inverted by the
+   *  inverse_proc_rank. */
+  size_t m_inverse_proc_rank_G;
+
+  /** @brief Whether this process inverted A and G in the last
+   *  update. */
+  bool m_own_inverse_A = true, m_own_inverse_G = true;
+
   /** @brief Vectorized gradient buffer (only for fully-connecter layers). */
   El::Matrix<DataType, Device> m_grad_buffer_v;
 };
@@ -196,6 +196,8 @@ public:
   /** @brief Get inverse matrices size (offset). */
   int get_inverse_matrices_size(lbann_comm* comm) override;
 
+  std::vector<double> get_inverse_costs() const override;
+
   int set_inverse_matrices(El::Matrix<DataType, Device>& workspace,
                            int offset,
                            lbann_comm* comm) override;
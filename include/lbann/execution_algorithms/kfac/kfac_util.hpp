@@ -62,6 +62,8 @@ enum class kfac_inverse_strategy
   EACH, // Apply round-robin assingment to every type of layers. may
   // not work well for small networks.
   ROOT, // Use only the root GPU. This is only for testing.
+  BALANCED, // Assign blocks by estimated inverse cost, largest first, to
+            // the least loaded process.
 };
 
 enum class kfac_reduce_scatter_mode
@@ -71,6 +73,12 @@ enum class kfac_reduce_scatter_mode
   REDUCE,         // Use El::Reduce for each block
 };
 
+enum class kfac_communication_precision
+{
+  FULL, // Communicate in DataType
+  HALF, // Communicate in fp16
+};
+
 enum class kfac_allgather_mode
 {
   ALLREDUCE, // Use lbann_comm::allreduce
@@ -89,6 +97,41 @@ void get_matrix_inverse(El::AbstractMatrix<DataType>& Ainv,
                         bool is_bn,
                         const El::SyncInfo<Device>& sync_info);
 
+/** @brief A damped symmetric matrix to be inverted in a batch. **/
+struct inverse_request
+{
+  El::AbstractMatrix<DataType>* Ainv;
+  const El::AbstractMatrix<DataType>* A;
+  DataType damping;
+  DataType damping_bn_err;
+  bool is_bn;
+};
+
+/** @brief Gets the inverse matrices of several damped symmetric
+ *  matrices, as get_matrix_inverse does.
+ *  @details Matrices with the same size and damping are factored and
+ *  inverted together with one kernel and one strided-batched GEMM,
+ *  which saves the launch and synchronization overheads of many
+ *  small Cholesky factorizations. **/
+template <El::Device Device>
+void get_matrix_inverses_batched(const std::vector<inverse_request>& requests,
+                                 El::Matrix<DataType, Device>& workspace,
+                                 bool report_time,
+                                 const El::SyncInfo<Device>& sync_info);
+
+/** @brief Factor and invert a batch of damped n x n matrices stored
+ *  contiguously in A. A is overwritten with the Cholesky factors and
+ *  Linv with their inverses. Only implemented on GPU. **/
+template <El::Device Device>
+void batched_cholesky_inverse(El::Matrix<DataType, Device>& A,
+                              El::Matrix<DataType, Device>& Linv,
+                              El::Int n,
+                              El::Int batch_size,
+                              DataType damping,
+                              DataType damping_bn_err,
+                              bool is_bn,
+                              const El::SyncInfo<Device>& sync_info);
+
 /** @brief Gets the inverse matrix of A using Eigen Value Decomposition. **/
 template <El::Device Device>
 void get_matrix_inverse_eigen(El::AbstractMatrix<DataType>& Ainv,
@@ -100,6 +143,37 @@ void get_matrix_inverse_eigen(El::AbstractMatrix<DataType>& Ainv,
                               bool is_bn,
                               const El::SyncInfo<Device>& sync_info);
 
+/** @brief Gets the eigenvectors Q and eigenvalues w of a symmetric
+ *  matrix A. W is overwritten. **/
+template <El::Device Device>
+void get_matrix_eigen_decomposition(El::Matrix<DataType, Device>& Q,
+                                    El::Matrix<DataType, Device>& w,
+                                    El::Matrix<DataType, Device>& W,
+                                    const El::AbstractMatrix<DataType>& A,
+                                    bool report_time,
+                                    const El::SyncInfo<Device>& sync_info);
+
+/** @brief Re-estimates the eigenvalues w of A in a previous
+ *  eigenbasis Q as the diagonal of Q^T A Q. W is overwritten. **/
+template <El::Device Device>
+void get_matrix_eigenvalues_in_basis(El::Matrix<DataType, Device>& w,
+                                     El::Matrix<DataType, Device>& W,
+                                     const El::Matrix<DataType, Device>& Q,
+                                     const El::AbstractMatrix<DataType>& A,
+                                     const El::SyncInfo<Device>& sync_info);
+
+/** @brief Gets the inverse matrix of A from its eigenvectors Q and
+ *  eigenvalues w as Q diag(1/(w+damping)) Q^T. W is overwritten. **/
+template <El::Device Device>
+void get_matrix_inverse_from_eigen(El::AbstractMatrix<DataType>& Ainv,
+                                   El::Matrix<DataType, Device>& W,
+                                   const El::Matrix<DataType, Device>& Q,
+                                   const El::Matrix<DataType, Device>& w,
+                                   DataType damping,
+                                   DataType damping_bn_err,
+                                   bool is_bn,
+                                   const El::SyncInfo<Device>& sync_info);
+
 /** @brief Gets statistics of a given matrix. **/
 template <El::Device Device>
 std::string get_matrix_stat(const El::Matrix<DataType, Device>& X,
@@ -115,13 +189,24 @@ void allreduce_lower_tri(El::AbstractMatrix<DataType>& A,
 /** @brief Get whether a global buffer is needed. **/
 bool is_reduce_scatter_buffer_required(kfac_reduce_scatter_mode mode);
 
+/** @brief Perform all-reduce on a buffer in the given precision.
+ *  @details With half precision and @c scale, the buffer is divided
+ *  by the number of processes before the reduction and multiplied
+ *  back after it, so that sums stay in the fp16 range. **/
+template <El::Device Device>
+void allreduce_buffer(El::Matrix<DataType, Device>& buffer,
+                      lbann_comm* comm,
+                      kfac_communication_precision precision,
+                      bool scale);
+
 /** @brief Perform reduce-scatter on one or more blocks. **/
 template <El::Device Device>
 void reduce_scatter_blocks(
   const std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
   lbann_comm* comm,
-  kfac_reduce_scatter_mode mode);
+  kfac_reduce_scatter_mode mode,
+  kfac_communication_precision precision);
 
 /** @brief Get whether local and global buffers are needed. **/
 std::pair<bool, bool> is_allgather_buffer_required(kfac_allgather_mode mode);
@@ -140,7 +225,27 @@ template <El::Device Device>
 void allgather_inverse_matrices(
   const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
-  lbann_comm* comm);
+  lbann_comm* comm,
+  kfac_communication_precision precision);
+
+/** @brief Start a non-blocking allgather for inverse matrices
+ *  @details The buffer must not be changed until
+ *  end_allgather_inverse_matrices is called with the same request. **/
+template <El::Device Device>
+void start_allgather_inverse_matrices(
+  const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
+  El::Matrix<DataType, Device>& global_buffer,
+  lbann_comm* comm,
+  Al::request& req);
+
+/** @brief Wait for a non-blocking allgather for inverse matrices and
+ *  copy them into the blocks **/
+template <El::Device Device>
+void end_allgather_inverse_matrices(
+  const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
+  El::Matrix<DataType, Device>& global_buffer,
+  lbann_comm* comm,
+  Al::request& req);
 
 /** @brief Perform allgather for inverse matrices size**/
 template <El::Device Device>
@@ -166,6 +271,23 @@ void make_diagonal(El::Matrix<DataType, Device>& A,
                    bool is_bn,
                    const El::SyncInfo<Device>& sync_info);
 
+/** @brief Scale the columns of A by the inverses of the damped
+ *  values of B. **/
+template <El::Device Device>
+void scale_columns_by_inverse(El::Matrix<DataType, Device>& A,
+                              const El::Matrix<DataType, Device>& B,
+                              DataType value,
+                              DataType value_bn_err,
+                              bool is_bn,
+                              const El::SyncInfo<Device>& sync_info);
+
+/** @brief Compute the dot products of the columns of A and B. **/
+template <El::Device Device>
+void column_dots(El::Matrix<DataType, Device>& dots,
+                 const El::Matrix<DataType, Device>& A,
+                 const El::Matrix<DataType, Device>& B,
+                 const El::SyncInfo<Device>& sync_info);
+
 /** @brief Add the damping value to the diagonal elements of A. **/
 template <El::Device Device>
 void get_matrix_entrywise_inverse(El::Matrix<DataType, Device>& input,
@@ -47,6 +47,12 @@ public:
    *  @param[in] step The current execution step in LTFB
    */
   virtual void mutate(model& m, const int& step) = 0;
+
+  /** @brief Whether mutate may change the layers of the model.
+   *  @details If not, a winning model with the same weights layout
+   *  can be copied into the local model without setting it up again.
+   */
+  virtual bool changes_model() const noexcept { return true; }
 };
 
 // No Mutation
@@ -56,6 +62,7 @@ class NullMutation final : public Cloneable<NullMutation, MutationStrategy>
 public:
   NullMutation() = default;
   void mutate(model& m, const int& step) final {}
+  bool changes_model() const noexcept final { return false; }
 };
 
 // Replace activation layers
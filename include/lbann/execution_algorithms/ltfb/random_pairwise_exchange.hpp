@@ -94,9 +94,50 @@ public:
      */
     virtual std::unique_ptr<model>
     get_partner_model(model const& m, El::Int partner_trainer, size_t step) = 0;
+
+    /** @brief Return a model from get_partner_model once the
+     *         tournament is done with it.
+     *
+     *  Strategies may keep it to receive later partner models, which
+     *  saves copying and setting up the local model every
+     *  tournament. This is only called if the local model's layers
+     *  do not change between tournaments.
+     */
+    virtual void release_partner_model(std::unique_ptr<model> /*m*/) {}
     // Better API, but complicates "sendrecv_weights":
     // virtual std::unique_ptr<model> get_partner_model(
     //   lbann_comm const& c, El::Int partner_trainer);
+
+    /** @brief Whether models are exchanged in the background.
+     *
+     *  If true, the tournament uses start_partner_exchange and
+     *  finish_partner_exchange instead of get_partner_model.
+     */
+    virtual bool is_asynchronous() const noexcept { return false; }
+
+    /** @brief Start sending the local model to a partner trainer and
+     *         receiving its model, without waiting for the transfer.
+     *  @param[in] m The local model. It may change once this returns.
+     *  @param[in] partner_trainer The ID of the partner trainer.
+     */
+    virtual void start_partner_exchange(model const& /*m*/,
+                                        El::Int /*partner_trainer*/)
+    {
+      LBANN_ERROR("exchange strategy is not asynchronous");
+    }
+
+    /** @brief Wait for the exchange started by start_partner_exchange.
+     *  @param[out] partner_trainer The ID of the partner trainer.
+     *  @returns The partner's model, as it was when the exchange
+     *           started, or null if no exchange was started. It is
+     *           owned by the strategy and reused by later exchanges.
+     */
+    virtual model* finish_partner_exchange(El::Int& /*partner_trainer*/)
+    {
+      LBANN_ERROR("exchange strategy is not asynchronous");
+      return nullptr;
+    }
+
   protected:
     /** @brief Access weights_names. */
     std::set<std::string> const& weights_names() const noexcept
@@ -163,6 +204,13 @@ public:
                    data_coordinator& dc) const final;
 
 private:
+  /** @brief Tournament with a model exchange started by the previous
+   *         tournament, see ExchangeStrategy::is_asynchronous.
+   */
+  void select_next_async(model& m,
+                         ltfb::LTFBExecutionContext& ctxt,
+                         data_coordinator& dc,
+                         std::string const& message_prefix) const;
   /** @brief Get the value of the given metric from the model. */
   std::unordered_map<std::string, EvalType>
   evaluate_model(model& m,
@@ -230,28 +278,70 @@ public:
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] asynchronous Exchange flat weights state in the
+   *                          background, see is_asynchronous.
+   *  @param[in] half_precision Round flat weights state to fp16 for
+   *                            blocking exchanges.
    */
   SendRecvWeights(std::set<std::string> const& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool asynchronous = false,
+                  bool half_precision = false);
 
   /** @brief Construct from weights names
    *  @param[in] weights_names Names of weights to exchange. If empty,
    *                           then all weights are exchanged.
    *  @param[in] exchange_hyperparameters Exchange optimizer
    *                                      hyperparameters.
+   *  @param[in] asynchronous Exchange flat weights state in the
+   *                          background, see is_asynchronous.
+   *  @param[in] half_precision Round flat weights state to fp16 for
+   *                            blocking exchanges.
    */
   SendRecvWeights(std::set<std::string>&& weights_names,
-                  bool exchange_hyperparameters);
+                  bool exchange_hyperparameters,
+                  bool asynchronous = false,
+                  bool half_precision = false);
 
-  SendRecvWeights(SendRecvWeights const&) = default;
+  /** @brief Copy the settings; the shadow model is not copied. */
+  SendRecvWeights(SendRecvWeights const& other);
   SendRecvWeights(SendRecvWeights&&) = default;
 
   std::unique_ptr<model> get_partner_model(model const& m,
                                            El::Int partner_trainer,
                                            size_t /*step*/) final;
 
+  /** @brief Keep the model to receive the next flat weights state
+   *         exchange.
+   */
+  void release_partner_model(std::unique_ptr<model> m) final;
+
+  bool is_asynchronous() const noexcept final { return asynchronous_; }
+
+  /** @brief Start exchanging flat weights state into the shadow
+   *         model.
+   *
+   *  The shadow model is a copy of the local model made by the first
+   *  exchange, and again only if the local model's layout changes.
+   *  The local state is sent from a snapshot, so training continues
+   *  while the messages are in flight. If the flat state cannot be
+   *  exchanged, the models are exchanged with get_partner_model
+   *  instead, which blocks.
+   */
+  void start_partner_exchange(model const& m, El::Int partner_trainer) final;
+
+  model* finish_partner_exchange(El::Int& partner_trainer) final;
+
 private:
   bool exchange_hyperparams_;
+  bool asynchronous_;
+  bool half_precision_;
+  /** @brief Receives the partner's model in asynchronous exchanges. */
+  std::unique_ptr<model> shadow_model_;
+  /** @brief Model returned by release_partner_model. */
+  std::unique_ptr<model> pooled_model_;
+  /** @brief Partner of the exchange in progress, or -1. */
+  El::Int pending_partner_ = -1;
 }; // class SendRecvWeights
 
 /// See @c lbann::callbacks::ltfb::communication_algorithm::checkpoint_file
@@ -273,6 +363,12 @@ private:
   std::string ckpt_basedir_;
 }; // class CheckpointFile
 
+/** @brief Exchange the whole model as a cereal binary archive
+ *
+ *  If @c compress is set, the archive is compressed with zlib before
+ *  it is sent, which trades CPU time on the trainer masters for less
+ *  network traffic.
+ */
 class CheckpointBinary final
   : public Cloneable<CheckpointBinary, RandomPairwiseExchange::ExchangeStrategy>
 {
@@ -280,11 +376,17 @@ class CheckpointBinary final
     Cloneable<CheckpointBinary, RandomPairwiseExchange::ExchangeStrategy>;
 
 public:
-  CheckpointBinary(std::set<std::string> const& weights_names);
-  CheckpointBinary(std::set<std::string>&& weights_names);
+  CheckpointBinary(std::set<std::string> const& weights_names,
+                   bool compress = false);
+  CheckpointBinary(std::set<std::string>&& weights_names,
+                   bool compress = false);
   std::unique_ptr<model> get_partner_model(model const& m,
                                            El::Int partner_trainer,
                                            size_t /*step*/) final;
+
+private:
+  /** @brief Whether to compress the exchanged archive. */
+  bool compress_;
 }; // class CheckpointBinary
 
 } // namespace ltfb
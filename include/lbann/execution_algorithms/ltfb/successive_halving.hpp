@@ -0,0 +1,164 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_EXECUTION_ALGORITHMS_LTFB_SUCCESSIVE_HALVING_HPP_INCLUDED
+#define LBANN_EXECUTION_ALGORITHMS_LTFB_SUCCESSIVE_HALVING_HPP_INCLUDED
+
+#include "mutation_strategy.hpp"
+
+#include "meta_learning_strategy.hpp"
+
+#include <google/protobuf/message.h>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace ltfb {
+
+/** @class SuccessiveHalving
+ *  @brief Asynchronous successive halving (ASHA) of a population of
+ *         trainers.
+ *
+ *  Each trainer runs one trial. A trial reaches rung @c k after
+ *  @c min_rounds*reduction_factor^k metalearning rounds, where its
+ *  score is recorded. It continues if the score is in the top
+ *  @c 1/reduction_factor of the scores recorded at that rung so far,
+ *  and otherwise it is terminated. Decisions never wait for other
+ *  trials to reach a rung, which is what makes the halving
+ *  asynchronous. Trials at the last rung are never terminated.
+ *
+ *  The trainer of a terminated trial copies the model of the best
+ *  surviving trainer in the round, mutates it and starts a new
+ *  trial, so poor candidates stop consuming their ranks as soon as
+ *  they fall behind.
+ *
+ *  Every process keeps the state of all trials, which stays
+ *  consistent since all scores are gathered each round.
+ */
+class SuccessiveHalving final
+  : public Cloneable<SuccessiveHalving, MetaLearningStrategy>
+{
+public:
+  enum class metric_strategy
+  {
+    LOWER_IS_BETTER,
+    HIGHER_IS_BETTER,
+  }; // enum class metric_strategy
+
+public:
+  /** @name Life-cycle management */
+  ///@{
+  /** @brief Constructor
+   *  @param[in] metric_name The name of the metric to use for
+   *                         evaluation. A metric with this name must
+   *                         exist in the model passed to apply().
+   *  @param[in] winner_strategy Strategy for comparing scores.
+   *  @param[in] mutate_algo Algorithm for mutating the models of new
+   *                         trials.
+   *  @param[in] reduction_factor Only the top 1/reduction_factor
+   *                              trials continue at each rung. Must
+   *                              be at least 2.
+   *  @param[in] min_rounds Rounds before the first rung.
+   *  @param[in] max_rungs Number of rungs where trials can be
+   *                       terminated.
+   */
+  SuccessiveHalving(std::string metric_name,
+                    metric_strategy winner_strategy,
+                    std::unique_ptr<MutationStrategy> mutate_algo,
+                    size_t reduction_factor,
+                    size_t min_rounds,
+                    size_t max_rungs);
+  ~SuccessiveHalving() = default;
+  SuccessiveHalving(SuccessiveHalving const& other);
+  ///@}
+
+  /** @brief Record the local trial's score and replace it if it is
+   *         terminated.
+   *
+   *  @param[in,out] m On input, the locally computed model. On
+   *                 output, the model of the trainer's trial.
+   *  @param[in,out] ctxt The execution context for the outer LTFB
+   *                 wrapper.
+   *  @param[in,out] dc The data source for the tournament.
+   */
+  void select_next(model& m,
+                   ltfb::LTFBExecutionContext& ctxt,
+                   data_coordinator& dc) const final;
+
+private:
+  /** @brief Get the value of the metric from the model. */
+  EvalType evaluate_model(model& m,
+                          LTFBExecutionContext& ctxt,
+                          data_coordinator& dc) const;
+
+  /** @brief Whether score @c a is better than score @c b. */
+  bool is_better(EvalType a, EvalType b) const noexcept;
+
+  /** @brief Whether a score is good enough to continue from a
+   *         rung.
+   *  @details The score must have already been recorded.
+   */
+  bool is_promoted(EvalType score, size_t rung) const;
+
+private:
+  /** @brief The strategy for mutation of the models of new trials */
+  std::unique_ptr<MutationStrategy> m_mutate_algo;
+
+  /** @brief Name of the metric for evaluation */
+  std::string m_metric_name;
+
+  /** @brief Strategy for comparing scores */
+  metric_strategy m_metric_strategy;
+
+  size_t m_reduction_factor;
+  size_t m_min_rounds;
+  size_t m_max_rungs;
+
+  /** @brief Rounds completed by the trial of each trainer. */
+  mutable std::vector<size_t> m_trial_rounds;
+
+  /** @brief Scores recorded at each rung by every trial so far. */
+  mutable std::vector<std::vector<EvalType>> m_rung_scores;
+
+}; // class SuccessiveHalving
+
+} // namespace ltfb
+
+/** @name Builder functions */
+///@{
+
+/** @brief Concrete builder for SuccessiveHalving. */
+template <>
+std::unique_ptr<ltfb::SuccessiveHalving>
+make(google::protobuf::Message const&);
+
+///@}
+
+} // namespace lbann
+#endif // LBANN_EXECUTION_ALGORITHMS_LTFB_SUCCESSIVE_HALVING_HPP_INCLUDED
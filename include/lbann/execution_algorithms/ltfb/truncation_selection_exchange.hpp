@@ -101,6 +101,20 @@ public:
                    ltfb::LTFBExecutionContext& ctxt,
                    data_coordinator& dc) const final;
 
+  /** @brief Evaluate models on this many tournament mini-batches.
+   *
+   *  Zero, the default, evaluates the whole tournament set. A
+   *  smaller number makes each tournament cheaper; consecutive
+   *  tournaments continue through the set, so every sample is used
+   *  over time. The standard error of a mean metric shrinks as the
+   *  square root of the number of samples, so a few mini-batches
+   *  usually rank models as well as the full set.
+   */
+  void set_tournament_mini_batches(size_t num_batches) noexcept
+  {
+    m_tournament_mini_batches = num_batches;
+  }
+
 private:
   /** @brief Get the value of the given metric from the model. */
   EvalType evaluate_model(model& m,
@@ -121,6 +135,11 @@ private:
    */
   int m_truncation_k;
 
+  /** @brief Tournament mini-batches per evaluation, or zero for
+   *         the whole tournament set.
+   */
+  size_t m_tournament_mini_batches = 0;
+
 }; // class TruncationSelectionExchange
 
 } // namespace ltfb
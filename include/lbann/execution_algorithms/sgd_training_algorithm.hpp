@@ -37,8 +37,13 @@
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/timer_map.hpp"
 
+#ifdef LBANN_HAS_CUDA
+#include "lbann/utils/gpu/cuda.hpp"
+#endif // LBANN_HAS_CUDA
+
 #include <google/protobuf/message.h>
 
+#include <array>
 #include <memory>
 
 namespace lbann {
@@ -88,6 +93,21 @@ public:
                 execution_mode mode,
                 SGDTerminationCriteria const& term);
 
+  /** @brief Evaluate several models on the same mini-batches.
+   *
+   *  Each mini-batch is fetched once from the data coordinator and
+   *  forward propagated through every model in turn, without waiting
+   *  for the previous model's kernels to finish. The models must use
+   *  the same data fields. Model @c i uses execution context
+   *  @c contexts[i]; the termination criteria are checked on the
+   *  first one.
+   */
+  void evaluate_ensemble(std::vector<SGDExecutionContext*> const& contexts,
+                         std::vector<model*> const& models,
+                         data_coordinator& dc,
+                         execution_mode mode,
+                         SGDTerminationCriteria const& term);
+
   /** @brief Get a default-initialized execution context.
    *  @note This method participates in the
    *        "covariant-smart-pointer-return" pattern. In particular,
@@ -96,6 +116,53 @@ public:
    */
   std::unique_ptr<SGDExecutionContext> get_new_execution_context() const;
 
+  /** @brief Enable dynamic loss scaling.
+   *  @details The objective function gradient is multiplied by the
+   *  loss scale and weight gradients are divided by it. Steps with
+   *  non-finite gradients are skipped and the scale is multiplied by
+   *  @c backoff_factor. After @c growth_interval good steps, the
+   *  scale is multiplied by @c growth_factor.
+   */
+  void set_loss_scaling(EvalType initial_scale,
+                        EvalType growth_factor,
+                        EvalType backoff_factor,
+                        size_t growth_interval);
+
+  /** @brief Current loss scale (1 if loss scaling is disabled). */
+  EvalType get_loss_scale() const noexcept { return m_loss_scale; }
+
+  /** @brief Split each training mini-batch into micro-batches.
+   *  @details Micro-batches are forward and backward propagated in
+   *  turn and their weight gradients are accumulated before a single
+   *  weight update. Activations are only kept for one micro-batch, so
+   *  this reduces memory use and, with pipeline stages on separate
+   *  sub-grids, lets a stage start on the next micro-batch while
+   *  later stages are busy.
+   */
+  void set_num_micro_batches(size_t num_micro_batches);
+
+  /** @brief Number of micro-batches per training mini-batch. */
+  size_t get_num_micro_batches() const noexcept
+  {
+    return m_num_micro_batches;
+  }
+
+  /** @brief Accumulate the gradients of several mini-batches.
+   *  @details Each weight update averages the gradients of
+   *  @c num_steps mini-batches, fetched in turn from the data
+   *  coordinator, or fewer at the end of an epoch. Weight gradients
+   *  are only allreduced after the last one, so this increases the
+   *  effective mini-batch size without more memory and reduces the
+   *  communication per sample.
+   */
+  void set_num_accumulation_steps(size_t num_steps);
+
+  /** @brief Number of mini-batches per weight update. */
+  size_t get_num_accumulation_steps() const noexcept
+  {
+    return m_num_accumulation_steps;
+  }
+
 protected:
   /** Train model on one step / mini-batch of an SGD forward pass */
   bool train_mini_batch(SGDExecutionContext& c,
@@ -135,6 +202,19 @@ protected:
   SGDExecutionContext* do_get_new_execution_context() const override;
 
 private:
+  /** @brief Whether this training step runs in GPU graphs.
+   *  @details The first step at each mini-batch size runs eagerly so
+   *  that lazily allocated buffers and handles exist before capture.
+   */
+  bool use_gpu_graph(size_t mini_batch_size);
+
+  /** @brief Run @c f, capturing its GPU work in a graph if
+   *         @c capture is set and then launching the graph.
+   *  @details @c f is passed a function that begins the capture.
+   */
+  template <typename F>
+  void run_training_phase(bool capture, size_t phase, F&& f);
+
   TimerMap m_timers;
   std::unique_ptr<SGDTerminationCriteria> m_stopping_criteria;
 
@@ -151,6 +231,34 @@ private:
    *              future.
    */
   bool m_suppress_timer = false;
+
+  /** @name Dynamic loss scaling */
+  ///@{
+  bool m_loss_scaling = false;
+  EvalType m_loss_scale = 1;
+  EvalType m_loss_scale_growth = 2;
+  EvalType m_loss_scale_backoff = 0.5;
+  size_t m_loss_scale_interval = 2000;
+  size_t m_good_steps = 0;
+  ///@}
+
+  /** @brief Number of micro-batches per training mini-batch. */
+  size_t m_num_micro_batches = 1;
+
+  /** @brief Number of mini-batches per weight update. */
+  size_t m_num_accumulation_steps = 1;
+
+  /** @name GPU graph capture of training steps */
+  ///@{
+  /** @brief Whether the model and callbacks allow graph capture. */
+  bool m_gpu_graph = false;
+  /** @brief Mini-batch size of the last training step. */
+  size_t m_gpu_graph_mini_batch_size = 0;
+#ifdef LBANN_HAS_CUDA
+  /** @brief Forward prop, backward prop and weight update graphs. */
+  std::array<cuda::ExecutableGraph, 3> m_gpu_graphs;
+#endif // LBANN_HAS_CUDA
+  ///@}
 };
 
 template <>
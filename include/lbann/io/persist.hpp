@@ -32,7 +32,12 @@
 #include "El.hpp"
 #include "lbann/base.hpp"
 #include "lbann/utils/enum_iterator.hpp"
+#include <istream>
+#include <map>
+#include <memory>
+#include <ostream>
 #include <sstream>
+#include <vector>
 
 namespace lbann {
 
@@ -71,10 +76,39 @@ enum class callback_type
 
 class persist
 {
+public:
+  /** @brief A checkpoint file kept in memory, see open_output. */
+  struct deferred_file
+  {
+    std::string filename;
+    std::shared_ptr<std::stringbuf> data;
+  };
+
 private:
   std::map<persist_type, uint64_t> m_bytes;
   std::map<persist_type, std::string> m_filenames;
   callback_type ckpt_type;
+  /** @brief Whether open_output keeps files in memory. */
+  bool m_defer_writes = false;
+  std::vector<deferred_file> m_deferred_files;
+  /** @brief Whether every rank reads shared checkpoints. */
+  bool m_parallel_reads = false;
+  /** @brief Whether shared checkpoints skip unchanged frozen
+   *         weights.
+   */
+  bool m_incremental_weights = false;
+  /** @brief Checkpoint directories of the ranks that wrote a
+   *         distributed checkpoint being resharded. */
+  std::vector<std::string> m_reshard_dirs;
+  /** @brief Rank whose non-matrix state is restored while
+   *         resharding. */
+  int m_reshard_source_rank = -1;
+  /** @brief Directory whose files are read from a file container. */
+  std::string m_container_dir;
+  std::string m_container_filename;
+  /** @brief Offset and size of the container's files, by path
+   *         relative to m_container_dir. */
+  std::map<std::string, std::pair<uint64_t, uint64_t>> m_container_index;
 
 public:
   std::string m_checkpoint_dir;
@@ -95,6 +129,92 @@ public:
   void open_checkpoint(const std::string& dir, bool create_dir);
   void close_checkpoint();
 
+  /** @brief Open a stream to write a checkpoint file.
+   *
+   *  If deferred writes are enabled, the data is kept in memory
+   *  until take_deferred_files, so the file can be written later,
+   *  e.g. while training continues. Otherwise the file is opened.
+   */
+  std::unique_ptr<std::ostream> open_output(const std::string& filename);
+
+  void set_deferred_writes(bool defer) noexcept { m_defer_writes = defer; }
+  bool get_deferred_writes() const noexcept { return m_defer_writes; }
+
+  /** @brief Files kept in memory by open_output since the last
+   *         call.
+   */
+  std::vector<deferred_file> take_deferred_files();
+
+  /** @brief Keep a file in memory as if it was written with
+   *         open_output.
+   */
+  void defer_file(deferred_file file);
+
+  /** @brief Read the files of a directory from its file container.
+   *
+   *  Only the container index is read here. open_input then reads
+   *  the byte range of a file instead of opening it.
+   */
+  void open_file_container(const std::string& dir);
+  void close_file_container();
+
+  /** @brief Open a stream to read a checkpoint file, which is either
+   *         in the open file container or on its own.
+   */
+  std::unique_ptr<std::istream> open_input(const std::string& filename);
+
+  /** @brief Have every rank read its part of shared checkpoints.
+   *  @details Instead of the trainer master reading each matrix and
+   *  scattering it, every rank reads the entries it owns from the
+   *  checkpoint file.
+   */
+  void set_parallel_reads(bool parallel) noexcept
+  {
+    m_parallel_reads = parallel;
+  }
+  bool get_parallel_reads() const noexcept { return m_parallel_reads; }
+
+  /** @brief Have shared checkpoints refer to the values of frozen
+   *         weights written by an earlier checkpoint, as long as they
+   *         have not changed.
+   */
+  void set_incremental_weights(bool incremental) noexcept
+  {
+    m_incremental_weights = incremental;
+  }
+  bool get_incremental_weights() const noexcept
+  {
+    return m_incremental_weights;
+  }
+
+  /** @brief Restart from a distributed checkpoint written by a
+   *         different number of ranks.
+   *
+   *  @param dirs        Checkpoint directories of the ranks that wrote
+   *                     the checkpoint, in rank order.
+   *  @param source_rank Rank whose directory is open, and whose state
+   *                     other than distributed matrices is restored.
+   */
+  void set_reshard_sources(std::vector<std::string> dirs, int source_rank)
+  {
+    m_reshard_dirs = std::move(dirs);
+    m_reshard_source_rank = source_rank;
+  }
+  void clear_reshard_sources() noexcept
+  {
+    m_reshard_dirs.clear();
+    m_reshard_source_rank = -1;
+  }
+  bool is_resharding() const noexcept { return !m_reshard_dirs.empty(); }
+  std::vector<std::string> const& get_reshard_dirs() const noexcept
+  {
+    return m_reshard_dirs;
+  }
+  int get_reshard_source_rank() const noexcept
+  {
+    return m_reshard_source_rank;
+  }
+
   void open_restart(const std::string& dir);
   void close_restart();
   void set_restart_dir(const std::string& dir) { m_checkpoint_dir = dir; }
@@ -138,6 +258,38 @@ public:
   std::string get_filename(persist_type type) const;
 };
 
+/** @brief Write files kept in memory by persist::open_output.
+ *  @details Does not use MPI, so it can run in a background thread.
+ */
+void write_deferred_files(std::vector<persist::deferred_file> const& files);
+
+/** @brief Name of the file container of a checkpoint directory. */
+std::string get_file_container_filename(const std::string& dir);
+
+/** @brief Find the bytes of a checkpoint file in directory @c dir.
+ *
+ *  If the directory has a file container, @c path is the container
+ *  and @c offset and @c size give the file's byte range in it.
+ *  Otherwise @c path is @c filename and the range is the whole file.
+ */
+void locate_checkpoint_file(const std::string& dir,
+                            const std::string& filename,
+                            std::string& path,
+                            uint64_t& offset,
+                            uint64_t& size);
+
+/** @brief Write files kept in memory by persist::open_output as one
+ *         file container.
+ *
+ *  The files' contents are written back to back, followed by an
+ *  index of their paths relative to @c dir, so a checkpoint
+ *  directory becomes a single large file. Files outside @c dir are
+ *  an error.
+ */
+void write_file_container(std::ostream& os,
+                          const std::string& dir,
+                          std::vector<persist::deferred_file> const& files);
+
 bool write_bytes(int fd, const char* name, const void* buf, size_t size);
 bool read_bytes(int fd, const char* name, void* buf, size_t size);
 
@@ -94,12 +94,8 @@ void persist::serialize(Archive& ar)
 }
 
 template <typename C>
-void write_cereal_archive(C& obj, const std::string& filename)
+void write_cereal_archive(C& obj, std::ostream& os)
 {
-  std::ofstream os(filename);
-  if (!os.is_open()) {
-    throw NonexistentArchiveFile(filename);
-  }
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
   cereal::XMLOutputArchive archive(os);
 #else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
@@ -108,10 +104,35 @@ void write_cereal_archive(C& obj, const std::string& filename)
   archive(obj);
 }
 
+template <typename C>
+void write_cereal_archive(C& obj, const std::string& filename)
+{
+  std::ofstream os(filename);
+  if (!os.is_open()) {
+    throw NonexistentArchiveFile(filename);
+  }
+  write_cereal_archive<C>(obj, os);
+}
+
+/** @brief Write an archive with persist::open_output. */
+template <typename C>
+void write_persist_cereal_archive(C& obj,
+                                  persist& p,
+                                  const std::string& filename)
+{
+  auto os = p.open_output(filename);
+  if (!os->good()) {
+    throw NonexistentArchiveFile(filename);
+  }
+  write_cereal_archive<C>(obj, *os);
+}
+
 template <typename C>
 void write_cereal_archive(C& obj, persist& p, const std::string& filename)
 {
-  write_cereal_archive<C>(obj, p.get_checkpoint_dir() + "/" + filename);
+  write_persist_cereal_archive<C>(obj,
+                                  p,
+                                  p.get_checkpoint_dir() + "/" + filename);
 }
 
 template <typename C>
@@ -120,7 +141,7 @@ void write_cereal_archive(C& obj,
                           persist_type pt,
                           const std::string& suffix)
 {
-  write_cereal_archive<C>(obj, p.get_filename(pt) + suffix);
+  write_persist_cereal_archive<C>(obj, p, p.get_filename(pt) + suffix);
 }
 
 template <typename C>
@@ -134,12 +155,8 @@ void write_cereal_archive(C& obj,
 }
 
 template <typename C>
-void read_cereal_archive(C& obj, const std::string& filename)
+void read_cereal_archive(C& obj, std::istream& is)
 {
-  std::ifstream is(filename);
-  if (!is.is_open()) {
-    throw NonexistentArchiveFile(filename);
-  }
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
   cereal::XMLInputArchive archive(is);
 #else  // defined LBANN_HAS_CEREAL_BINARY_ARCHIVES
@@ -148,10 +165,35 @@ void read_cereal_archive(C& obj, const std::string& filename)
   archive(obj);
 }
 
+template <typename C>
+void read_cereal_archive(C& obj, const std::string& filename)
+{
+  std::ifstream is(filename);
+  if (!is.is_open()) {
+    throw NonexistentArchiveFile(filename);
+  }
+  read_cereal_archive<C>(obj, is);
+}
+
+/** @brief Read an archive with persist::open_input. */
+template <typename C>
+void read_persist_cereal_archive(C& obj,
+                                 persist& p,
+                                 const std::string& filename)
+{
+  auto is = p.open_input(filename);
+  if (!is->good()) {
+    throw NonexistentArchiveFile(filename);
+  }
+  read_cereal_archive<C>(obj, *is);
+}
+
 template <typename C>
 void read_cereal_archive(C& obj, persist& p, const std::string& filename)
 {
-  read_cereal_archive(obj, p.get_checkpoint_dir() + "/" + filename);
+  read_persist_cereal_archive<C>(obj,
+                                 p,
+                                 p.get_checkpoint_dir() + "/" + filename);
 }
 
 template <typename C>
@@ -160,7 +202,7 @@ void read_cereal_archive(C& obj,
                          persist_type pt,
                          const std::string& suffix)
 {
-  read_cereal_archive(obj, p.get_filename(pt) + suffix);
+  read_persist_cereal_archive<C>(obj, p, p.get_filename(pt) + suffix);
 }
 
 template <typename C>
@@ -97,6 +97,7 @@ public:
   std::string get_type() const override { return "leaky ReLU"; }
   data_layout get_data_layout() const override { return Layout; }
   El::Device get_device_allocation() const override { return Device; }
+  bool supports_inplace_backprop() const override { return true; }
 
   description get_description() const override
   {
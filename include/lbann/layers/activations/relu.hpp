@@ -75,6 +75,7 @@ public:
   std::string get_type() const override { return "ReLU"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_inplace_backprop() const override { return true; }
 
 #ifdef LBANN_HAS_ONNX
   std::string get_onnx_op_type() const override { return "Relu"; }
@@ -112,10 +113,32 @@ protected:
 #endif // LBANN_HAS_DISTCONV
 };
 
+/** @brief Apply a ReLU in place to the outputs of a layer.
+ *
+ *  Used by layers with a fused ReLU (see Layer::set_fused_relu).
+ */
+template <typename TensorDataType, El::Device Device>
+void fused_relu_fp_compute(El::AbstractDistMatrix<TensorDataType>& activations);
+
+/** @brief Backprop through a fused ReLU.
+ *
+ *  Zeroes the gradient w.r.t. the outputs of a layer wherever its
+ *  (already rectified) outputs are not positive.
+ */
+template <typename TensorDataType, El::Device Device>
+void fused_relu_bp_compute(
+  const El::AbstractDistMatrix<TensorDataType>& activations,
+  El::AbstractDistMatrix<TensorDataType>& gradient_wrt_output);
+
 #ifndef LBANN_RELU_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)                                                \
   extern template class relu_layer<T, data_layout::DATA_PARALLEL, Device>;     \
-  extern template class relu_layer<T, data_layout::MODEL_PARALLEL, Device>
+  extern template class relu_layer<T, data_layout::MODEL_PARALLEL, Device>;    \
+  extern template void fused_relu_fp_compute<T, Device>(                       \
+    El::AbstractDistMatrix<T>&);                                               \
+  extern template void fused_relu_bp_compute<T, Device>(                       \
+    const El::AbstractDistMatrix<T>&,                                          \
+    El::AbstractDistMatrix<T>&)
 
 #include "lbann/macros/instantiate_device.hpp"
 #undef PROTO_DEVICE
@@ -64,6 +64,35 @@ using supported_layer_data_type = h2::meta::TL<
   float,
   double>;
 
+/** @brief Datatype for weights created by a layer.
+ *
+ *  Half-precision layers keep single-precision master weights and
+ *  access them through a half-precision proxy, so that optimization
+ *  steps that are small relative to the weights are not rounded
+ *  away.
+ */
+template <typename TensorDataType>
+struct master_weights_type
+{
+  using type = TensorDataType;
+};
+#ifdef LBANN_HAS_HALF
+template <>
+struct master_weights_type<cpu_fp16>
+{
+  using type = float;
+};
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+struct master_weights_type<fp16>
+{
+  using type = float;
+};
+#endif // LBANN_HAS_GPU_FP16
+template <typename TensorDataType>
+using MasterWeightsType = typename master_weights_type<TensorDataType>::type;
+
 template <typename InputTensorDataType,
           typename OutputTensorDataType = InputTensorDataType>
 class data_type_layer : public Layer
@@ -175,6 +204,28 @@ public:
    */
   void set_keep_error_signals(bool) override;
 
+  void free_activations() override;
+  bool has_activation_views() const override;
+  size_t get_activations_memory() const override;
+  /** One operation per output entry; reads the inputs and weights
+   *  and writes the outputs. */
+  compute_cost get_forward_prop_cost() const override;
+  /** One operation per input entry; reads the inputs, weights and
+   *  output error signals and writes the input error signals and
+   *  weights gradients. */
+  compute_cost get_backward_prop_cost() const override;
+  void refresh_inputs() override;
+#ifdef LBANN_HAS_GPU
+  bool
+  offload_activations(El::SyncInfo<El::Device::GPU> const& copy) override;
+  void free_offloaded_activations(
+    El::SyncInfo<El::Device::GPU> const& copy) override;
+  void
+  restore_activations(El::SyncInfo<El::Device::GPU> const& copy) override;
+  void wait_for_restored_activations(
+    El::SyncInfo<El::Device::GPU> const& copy) override;
+#endif // LBANN_HAS_GPU
+
   El::mpi::Comm& get_subgrid_comm() { return *m_interSubGridVCComm; }
 
   /** @name Serialization */
@@ -318,6 +369,19 @@ private:
   void view_or_copy_prev_error_signal_(const Layer& child,
                                        const El::BaseDistMatrix& signal) final;
 
+  /** @brief Attempt to reuse the previous error signal as the error
+   *  signal.
+   *
+   *  Possible if the layer supports in-place backprop, it is the only
+   *  consumer of the previous error signal, and it owns that signal
+   *  with the distribution of the input tensor. The previous error
+   *  signal then becomes a view of the error signal, which saves an
+   *  allocation and, when moved to the parent, a buffer.
+   *
+   *  @returns Whether the previous error signal is reused.
+   */
+  bool reuse_prev_error_signal_();
+
   /** @brief Deep copy the error signal.
    *
    *  In some cases, it can be determined that neither viewing nor
@@ -352,6 +416,26 @@ private:
    */
   void clear_prev_error_signals_() final;
 
+  /** @brief Move the tensors and weights proxies to the layer's
+   *         stream, if it has one.
+   *
+   *  Views are reset in each step, so this is called after the
+   *  tensors are set up. Tensors on the layer's stream do not make
+   *  the streams of other layers wait on this one.
+   */
+  void apply_gpu_sync_info_();
+
+  /** @brief Apply the fused ReLU to the output tensor. */
+  void fp_fused_relu_();
+
+  /** @brief Backprop the fused ReLU through the gradient w.r.t. the
+   *         output tensor.
+   *
+   *  The gradient is deep-copied first if it views a child's error
+   *  signal.
+   */
+  void bp_fused_relu_();
+
   /** Backward propagation step.
    *  Given the objective function gradients w.r.t. the output
    *  tensors, compute the gradients w.r.t. the input tensors and
@@ -413,6 +497,21 @@ private:
    */
   bool m_persistent_error_signals = false;
 
+  /** @brief Whether the error signal of the current backprop step
+   *         overwrites the previous error signal.
+   */
+  bool m_inplace_error_signals = false;
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Pinned host copies of offloaded output tensors */
+  std::vector<El::Matrix<OutputTensorDataType, El::Device::CPU>>
+    m_offloaded_outputs;
+  /** @brief Global dimensions of each offloaded output tensor
+   *  @details Zero for outputs that are not offloaded.
+   */
+  std::vector<std::pair<El::Int, El::Int>> m_offloaded_output_dims;
+#endif // LBANN_HAS_GPU
+
 #ifdef LBANN_HAS_DISTCONV
   friend class data_type_distconv_adapter<InputTensorDataType,
                                           OutputTensorDataType>;
@@ -79,6 +79,13 @@ public:
   /** Get error signal tensor corresponding to parent layer. */
   virtual const dc::AbsTensor& get_error_signals(const Layer& parent) const = 0;
 
+  /** Choose the process decomposition from measured costs.
+   *
+   *  Called on the layers in order before the distributions are set
+   *  up. By default, the decomposition of the first Distconv-enabled
+   *  parent is adopted, so no shuffle is needed in between.
+   */
+  virtual void autotune_parallel_strategy();
   virtual void setup_distributions(tensor_overlap_constraints& constraints);
   void
   impose_adjacent_overlap_constraints(tensor_overlap_constraints& constraints);
@@ -117,6 +124,11 @@ protected:
   virtual const Layer& layer() const;
   std::string get_name() const;
 
+  /** Set the sample and spatial process groups, without channel or
+   *  filter decomposition.
+   */
+  void set_decomposition(int samples, int depth, int height, int width);
+
   virtual void setup_prev_activations() = 0;
   virtual void setup_original_prev_activations() = 0;
   virtual void setup_activations() = 0;
@@ -46,8 +46,6 @@ class composite_image_transformation_layer
   static_assert(
     Layout == data_layout::DATA_PARALLEL,
     "composite_image_transformation_layer only supports DATA_PARALLEL");
-  static_assert(Device == El::Device::CPU,
-                "composite_image_transformation_layer only supports CPU");
 
 public:
   /** @name Public Types */
@@ -108,6 +106,16 @@ protected:
 
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
+#ifdef LBANN_HAS_GPU
+#define PROTO(T)                                                               \
+  extern template class composite_image_transformation_layer<                  \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    El::Device::GPU>
+
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#endif // LBANN_HAS_GPU
 #endif // LBANN_COMPOSITE_IMAGE_TRANSFORMATION_LAYER_INSTANTIATE
 
 } // namespace lbann
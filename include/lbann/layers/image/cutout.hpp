@@ -28,20 +28,40 @@
 #define LBANN_LAYERS_IMAGE_CUTOUT_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/utils/philox.hpp"
+#include "lbann/utils/random.hpp"
 
 namespace lbann {
 
+/** @brief Center of the cutout square of a sample
+ *
+ *  Drawn from entry @c sample of a counter-based stream, so the CPU
+ *  and GPU implementations cut out the same square and the center
+ *  does not depend on the number of processes.
+ */
+LBANN_PHILOX_FUNC void cutout_center(const philox::stream& stream,
+                                     uint64_t sample,
+                                     El::Int height,
+                                     El::Int width,
+                                     El::Int& row_center,
+                                     El::Int& col_center)
+{
+  const auto x = stream(sample);
+  row_center = static_cast<El::Int>(philox::to_unit_float(x.x[0]) * height);
+  col_center = static_cast<El::Int>(philox::to_unit_float(x.x[1]) * width);
+}
+
 /** @brief Cutout a square from an image
  *
  *  Expects two inputs: a 3D image tensor in CHW format and a scalar
- *  length of the cutout square.
+ *  length of the cutout square. Each sample has its own randomly
+ *  placed square.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class cutout_layer : public data_type_layer<TensorDataType>
 {
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "cutout_layer only supports DATA_PARALLEL");
-  static_assert(Device == El::Device::CPU, "cutou_layer only supports CPU");
 
 public:
   /** @name Public Types */
@@ -80,7 +100,17 @@ protected:
 
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
+  void setup_data(size_t max_mini_batch_size) override
+  {
+    data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+    m_seed = draw_philox_seed(*this->get_comm());
+  }
+
   void write_specific_proto(lbann_data::Layer& proto) const final;
+
+private:
+  /** Seed of the counter-based stream of cutout centers. */
+  uint64_t m_seed = 0;
 };
 
 #ifndef LBANN_CUTOUT_LAYER_INSTANTIATE
@@ -91,6 +121,15 @@ protected:
 
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
+#ifdef LBANN_HAS_GPU
+#define PROTO(T)                                                               \
+  extern template class cutout_layer<T,                                        \
+                                     data_layout::DATA_PARALLEL,               \
+                                     El::Device::GPU>
+
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#endif // LBANN_HAS_GPU
 #endif // LBANN_CUTOUT_LAYER_INSTANTIATE
 
 } // namespace lbann
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_IMAGE_CUTOUT_IMPL_HPP_INCLUDED
+#define LBANN_LAYERS_IMAGE_CUTOUT_IMPL_HPP_INCLUDED
+
+#include "lbann/layers/image/cutout.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/proto/layers.pb.h"
+#include "lbann/utils/exception.hpp"
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void cutout_layer<TensorDataType, Layout, Device>::setup_dims(
+  DataReaderMetaData& dr_metadata)
+{
+  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
+
+  // Get input dimensions
+  auto dims = this->get_input_dims(0);
+  const auto& cutout_length = this->get_input_dims(1);
+
+  // Check that dimensions are valid
+  if (dims.size() != 3) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < dims.size(); ++i) {
+      ss << (i > 0 ? " x " : "") << dims[i];
+    }
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "expects a 3D input in CHW format, ",
+                "but input dimensions are ",
+                ss.str());
+  }
+  if (cutout_length.size() > 1 || cutout_length[0] != 1) {
+    std::ostringstream ss;
+    for (size_t i = 0; i < cutout_length.size(); ++i) {
+      ss << (i > 0 ? " x " : "") << cutout_length[i];
+    }
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "expects a scalar input for the cutout length, ",
+                "but input dimensions are ",
+                ss.str());
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void cutout_layer<TensorDataType, Layout, Device>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<TensorDataType>);
+  proto.mutable_cutout();
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_IMAGE_CUTOUT_IMPL_HPP_INCLUDED
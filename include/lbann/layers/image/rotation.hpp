@@ -41,7 +41,6 @@ class rotation_layer : public data_type_layer<TensorDataType>
 {
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "rotation_layer only supports DATA_PARALLEL");
-  static_assert(Device == El::Device::CPU, "rotation_layer only supports CPU");
 
 public:
   /** @name Public Types */
@@ -92,6 +91,15 @@ protected:
 
 #include "lbann/macros/instantiate.hpp"
 #undef PROTO
+#ifdef LBANN_HAS_GPU
+#define PROTO(T)                                                               \
+  extern template class rotation_layer<T,                                      \
+                                       data_layout::DATA_PARALLEL,             \
+                                       El::Device::GPU>
+
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#endif // LBANN_HAS_GPU
 #endif // LBANN_ROTATION_LAYER_INSTANTIATE
 
 } // namespace lbann
@@ -113,8 +113,15 @@ public:
   ///@}
 public:
   /// @todo make the map and vector references
-  input_layer(lbann_comm* comm, std::string const data_field = "")
-    : data_type_layer<TensorDataType>(comm), m_data_field(data_field)
+  /** @param synthetic Output a fixed random mini-batch, generated on
+   *  the layer's device, instead of data from the data coordinator
+   */
+  input_layer(lbann_comm* comm,
+              std::string const data_field = "",
+              bool synthetic = false)
+    : data_type_layer<TensorDataType>(comm),
+      m_data_field(data_field),
+      m_synthetic(synthetic)
   {
 
     // Input layers have no parents
@@ -122,8 +129,8 @@ public:
     this->m_expected_num_child_layers = 1;
   }
 
-  input_layer(const input_layer&) = default;
-  input_layer& operator=(const input_layer&) = default;
+  input_layer(const input_layer& other);
+  input_layer& operator=(const input_layer& other);
   input_layer* copy() const override { return new input_layer(*this); }
 
   std::string get_type() const override { return "input"; }
@@ -183,6 +190,14 @@ private:
 
   data_field_type m_data_field;
 
+  /** @brief Whether outputs view m_synthetic_outputs */
+  bool m_synthetic = false;
+  /** @brief Fixed random mini-batch of the maximum size */
+  std::unique_ptr<AbsDistMatrixType> m_synthetic_outputs;
+
+  /** @brief Generate m_synthetic_outputs on the layer's device */
+  void setup_synthetic_outputs(size_t max_mini_batch_size);
+
 #ifdef LBANN_HAS_DISTCONV
 public:
   /** @brief Extensions for distributed convolutions */
@@ -29,6 +29,7 @@
 
 #include "lbann/base.hpp"
 #include "lbann/utils/typename.hpp"
+#include <optional>
 #include <string>
 #include <vector>
 #ifdef LBANN_HAS_ONNX
@@ -132,6 +133,15 @@ using OwningLayerPtr = std::shared_ptr<Layer>;
  */
 using ViewingLayerPtr = std::weak_ptr<Layer>;
 
+/** @brief Estimated work of a layer's forward or backward prop */
+struct compute_cost
+{
+  /** Floating-point operations. */
+  double flops = 0.;
+  /** Bytes read from and written to memory. */
+  double bytes = 0.;
+};
+
 /** Represents a parallel strategy for a layer. */
 struct ParallelStrategy
 {
@@ -161,6 +171,16 @@ struct ParallelStrategy
   int filter_splits = 0;
   /** Number of times the layer is replicated (for FC layers right now). */
   int replications = 0;
+  /** Number of ranks the sequence dimension is split over.
+   *
+   *  A value greater than one shards sequences over blocks of
+   *  consecutive ranks in the trainer: each sample of the mini-batch
+   *  is one shard, and consecutive samples are consecutive shards of
+   *  the same sequence. Position-wise layers need no changes, while
+   *  layers coupling positions combine the shards, see
+   *  Layer::get_sequence_comm.
+   */
+  int sequence_splits = 0;
   /** Enable subgraph for the layer. */
   bool enable_subgraph = false;
   /** Branch number in the sub graph. */
@@ -180,6 +200,7 @@ struct ParallelStrategy
            filter_groups == ps.filter_groups &&
            filter_splits == ps.filter_splits &&
            replications == ps.replications &&
+           sequence_splits == ps.sequence_splits &&
            sub_branch_tag == ps.sub_branch_tag &&
            sub_branch_resource_percentage ==
              ps.sub_branch_resource_percentage &&
@@ -198,6 +219,7 @@ inline std::ostream& operator<<(std::ostream& os, const ParallelStrategy& ps)
      << "W: " << ps.width_groups << "/" << ps.width_splits << ", "
      << "F: " << ps.filter_groups << "/" << ps.filter_splits << ", "
      << "R: " << ps.replications << ", "
+     << "S: " << ps.sequence_splits << ", "
      << "T: " << ps.sub_branch_tag << ", "
      << "%: " << ps.sub_branch_resource_percentage << ", "
      << "e: " << ps.enable_subgraph << "}";
@@ -213,6 +235,8 @@ inline std::ostream& print_parallel_strategy_header(std::ostream& os)
      << "\tFilters (F)\n"
      << "\tReplications (R): Number of times the layer is replicated (for FC "
         "layers right now)\n"
+     << "\tSequence splits (S): Number of ranks each sequence is sharded "
+        "over\n"
      << "\tBranch number in the subgraph (T)\n"
      << "\tPercentage of parent resources to be allocated to this branch (%)\n"
      << "\tEnable subgraph for the layer (e)\n"
@@ -411,6 +435,14 @@ public:
   {
     return m_parallel_strategy;
   }
+  /** @brief Communicator over the ranks holding the shards of this
+   *         rank's sequences.
+   *
+   *  Null if the sequence dimension is not split. Layers that couple
+   *  sequence positions reduce or exchange data over it. The first
+   *  call is collective over the trainer.
+   */
+  const El::mpi::Comm* get_sequence_comm() const;
 
   /** @brief Forward propagation step.
    *  Apply a mathematical operation to input tensors to obtain output
@@ -647,6 +679,238 @@ public:
   void unfreeze();
   bool is_frozen() const;
 
+  ///@}
+  /** @name Activation fusion functions */
+  ///@{
+
+  /** @brief Whether a ReLU can be fused into this layer.
+   *
+   *  A fused ReLU is applied in place to the output tensor after
+   *  fp_compute and the gradient w.r.t. the output is masked before
+   *  bp_compute. Only layers whose backprop does not read their
+   *  output tensor may return true.
+   */
+  virtual bool supports_fused_relu() const { return false; }
+  /** @brief Apply a ReLU to the output tensor of this layer. */
+  void set_fused_relu(bool fused);
+  bool has_fused_relu() const { return m_fused_relu; }
+
+  ///@}
+  /** @name Error signal reuse functions */
+  ///@{
+
+  /** @brief Whether backprop may write the gradient w.r.t. the input
+   *  over the gradient w.r.t. the output.
+   *
+   *  Only layers whose backprop computes each entry of the gradient
+   *  w.r.t. the input from the same entry of the gradient w.r.t. the
+   *  output may return true, e.g. element-wise layers.
+   */
+  virtual bool supports_inplace_backprop() const { return false; }
+
+  ///@}
+  /** @name Inference folding functions */
+  ///@{
+
+  /** @brief The per-channel affine map this layer computes in
+   *  inference, y = scale*x + shift.
+   *
+   *  Returns false if the layer is not such a map or if its weights
+   *  values are not known yet. See model::setup_inference_graph.
+   */
+  virtual bool get_inference_affine(std::vector<double>& /*scale*/,
+                                    std::vector<double>& /*shift*/) const
+  {
+    return false;
+  }
+  /** @brief Apply a per-channel affine map to the output tensor by
+   *  changing the weights of this layer.
+   *
+   *  Called before setup, on weights whose values are known. Returns
+   *  false, leaving the layer unchanged, if it does not support it.
+   */
+  virtual bool fold_inference_affine(std::vector<double> const& /*scale*/,
+                                     std::vector<double> const& /*shift*/)
+  {
+    return false;
+  }
+  /** @brief Round the weights of this layer to a symmetric int8 grid
+   *  with one scale per output channel.
+   *
+   *  Returns false, leaving the layer unchanged, if it does not
+   *  support it. See callback::calibrate_quantization.
+   */
+  virtual bool quantize_inference_weights(std::vector<double>& /*scale*/)
+  {
+    return false;
+  }
+
+  ///@}
+  /** @name Layout propagation functions */
+  ///@{
+
+  /** @brief Row-major permutation of the tensor axes this layer
+   *  applies to its input.
+   *
+   *  Output dimension i is input dimension perm[i]. Empty if the
+   *  layer does not just permute its input. See
+   *  model::fold_permute_layers.
+   */
+  virtual std::vector<int> get_axis_permutation() const { return {}; }
+  /** @brief Swap the last two axes of an input tensor before using
+   *  it.
+   *
+   *  Called before setup, to fold a permute layer into this layer.
+   *  Returns false, leaving the layer unchanged, if it does not
+   *  support it.
+   */
+  virtual bool fold_input_transpose(int /*input_index*/) { return false; }
+
+  ///@}
+  /** @name Activation recomputation functions */
+  ///@{
+
+  /** @brief Whether output tensors may be discarded after forward
+   *  prop and recomputed before backprop.
+   *
+   *  The model decides which outputs are discarded, see
+   *  model::setup_activation_recomputation.
+   */
+  void set_recompute_activations(bool recompute)
+  {
+    m_recompute_activations = recompute;
+  }
+  bool get_recompute_activations() const noexcept
+  {
+    return m_recompute_activations;
+  }
+  /** @brief Free the memory of output tensors that do not view
+   *  other matrices.
+   *
+   *  Output tensors are reallocated in the next forward prop.
+   */
+  virtual void free_activations() {}
+  /** @brief Whether any output tensor views another matrix.
+   *
+   *  Used by the activation memory planner, which must not free a
+   *  tensor while a neighboring layer's output still views it.
+   */
+  virtual bool has_activation_views() const { return false; }
+  /** @brief Local memory, in bytes, of the output tensors that do
+   *  not view other matrices.
+   */
+  virtual size_t get_activations_memory() const { return 0; }
+
+  ///@}
+  /** @name Performance model */
+  ///@{
+  /** @brief Estimated local work of the last forward prop.
+   *
+   *  Computed from the local sizes of the tensors and the layer's
+   *  dimensions. It is not exact, e.g. caches and library algorithms
+   *  are ignored, but is close enough to tell compute-bound layers
+   *  from bandwidth-bound ones.
+   */
+  virtual compute_cost get_forward_prop_cost() const { return {}; }
+  /** @brief Estimated local work of the last backprop. */
+  virtual compute_cost get_backward_prop_cost() const { return {}; }
+
+  ///@}
+  /** @name Activation offload functions */
+  ///@{
+
+  /** @brief Whether output tensors may be copied to host memory
+   *  after forward prop and copied back before backprop.
+   *
+   *  The model decides when the copies are made, see
+   *  model::setup_activation_offload.
+   */
+  void set_offload_activations(bool offload)
+  {
+    m_offload_activations = offload;
+  }
+  bool get_offload_activations() const noexcept
+  {
+    return m_offload_activations;
+  }
+  /** @brief Set up the input tensors again.
+   *
+   *  Input tensors that view a parent's outputs must be set up again
+   *  after the parent has reallocated them.
+   */
+  virtual void refresh_inputs() {}
+#ifdef LBANN_HAS_GPU
+  /** @brief Begin copying output tensors to pinned host memory.
+   *
+   *  The copies are launched on @c copy after the layer's own GPU
+   *  work. Outputs that view other matrices, or whose local data is
+   *  not contiguous, are not copied.
+   *
+   *  @returns Whether any output tensor is copied.
+   */
+  virtual bool
+  offload_activations(El::SyncInfo<El::Device::GPU> const& /*copy*/)
+  {
+    return false;
+  }
+  /** @brief Free the output tensors copied by offload_activations.
+   *
+   *  The memory is returned once the copies on @c copy are done.
+   */
+  virtual void
+  free_offloaded_activations(El::SyncInfo<El::Device::GPU> const& /*copy*/)
+  {}
+  /** @brief Reallocate the freed output tensors and begin copying
+   *  them back from host memory on @c copy.
+   */
+  virtual void
+  restore_activations(El::SyncInfo<El::Device::GPU> const& /*copy*/)
+  {}
+  /** @brief Make the layer's GPU work wait on the copies launched by
+   *  restore_activations.
+   */
+  virtual void
+  wait_for_restored_activations(El::SyncInfo<El::Device::GPU> const& /*copy*/)
+  {}
+#endif // LBANN_HAS_GPU
+
+  ///@}
+#ifdef LBANN_HAS_GPU
+  /** @name GPU stream functions */
+  ///@{
+
+  /** @brief Launch the layer's GPU work on a given stream.
+   *
+   *  Set by the model when independent branches run concurrently,
+   *  see model::setup_branch_streams. The model orders the stream
+   *  after the streams of the parent layers in forward prop and of
+   *  the child layers in backprop.
+   */
+  void set_gpu_sync_info(El::SyncInfo<El::Device::GPU> const& sync_info)
+  {
+    m_gpu_sync_info = sync_info;
+  }
+
+  ///@}
+#endif // LBANN_HAS_GPU
+  /** @name In-place output functions */
+  ///@{
+
+  /** @brief Matrix that a parent layer can write its output into.
+   *
+   *  A layer that stores its inputs side by side, e.g. a
+   *  concatenation, can return its output matrix so that @c parent
+   *  views the @c rows range of it instead of allocating its own
+   *  output tensor. Returns nullptr if the parent should allocate its
+   *  own output tensor.
+   */
+  virtual BaseDistMat* get_parent_output_buffer(const Layer& parent,
+                                                El::Int mini_batch_size,
+                                                El::Range<El::Int>& rows)
+  {
+    return nullptr;
+  }
+
   ///@}
 
   /** @brief Set whether to keep or dynamically reallocate error signals.
@@ -802,6 +1066,20 @@ protected:
   /** @brief Avoid back prop if frozen */
   bool m_frozen;
 
+  /** @brief Whether a ReLU is applied to the output tensor */
+  bool m_fused_relu = false;
+
+  /** @brief Whether output tensors may be recomputed in backprop */
+  bool m_recompute_activations = false;
+
+  /** @brief Whether output tensors may be offloaded to host memory */
+  bool m_offload_activations = false;
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Stream for GPU work, if not the tensors' own */
+  std::optional<El::SyncInfo<El::Device::GPU>> m_gpu_sync_info;
+#endif // LBANN_HAS_GPU
+
   /** @brief Time spent in forward propagation. */
   EvalType m_fp_time;
   /** @brief Time spent in the forward propagation computation. */
@@ -64,6 +64,10 @@ public:
   {}
   virtual ~base_convolution_adapter() = default;
 
+  /** Minimize the modelled time of a training step over the sample
+   *  and spatial decompositions, see dc::get_cost_measurements.
+   */
+  void autotune_parallel_strategy() override;
   void setup_fp_tensors() override;
   void setup_bp_tensors() override;
   void setup_layer(size_t workspace_capacity) override;
@@ -136,6 +140,12 @@ protected:
    *  depthwise convolution has as many groups as there are input channels.
    */
   int m_groups;
+  /** @brief Whether tensors are stored channels-last.
+   *  @details The input and output tensors, and the kernel, are
+   *  stored with the channel index varying fastest (e.g. NHWC rather
+   *  than NCHW). Only supported with the DNN library.
+   */
+  bool m_channels_last = false;
 
   /** Scaling factor for bias term.
    *  If the scaling factor is zero, bias is not applied.
@@ -188,6 +198,14 @@ public:
   void set_dnn_math_mode(dnn_lib::dnnMathType_t math_type) noexcept;
 #endif // LBANN_HAS_DNN_LIB
 
+  /** Whether tensors are stored channels-last. */
+  bool get_channels_last() const noexcept { return m_channels_last; }
+  /** Store tensors channels-last, e.g. NHWC rather than NCHW. */
+  void set_channels_last(bool channels_last) noexcept
+  {
+    m_channels_last = channels_last;
+  }
+
   description get_description() const override;
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
@@ -233,6 +251,14 @@ protected:
 private:
 #ifdef LBANN_HAS_DNN_LIB
 
+  /** @brief Key of an algorithm in the convolution algorithm cache.
+   *  @details Identifies the pass, the layer's shapes and settings, the
+   *  mini-batch size, the workspace size and the DNN library and device.
+   */
+  std::string get_algo_cache_key(const std::string& pass,
+                                 int local_mini_batch_size,
+                                 size_t ws_size) const;
+
   /** Get the DNN library algorithm to use for forward prop. */
   fwd_conv_alg
   get_forward_algo_dnn(const int local_mini_batch_size,
@@ -275,6 +301,16 @@ private:
     TensorDataType* ws);
 #endif // LBANN_HAS_DNN_LIB
 
+  /** @brief im2col matrices of a block of samples.
+   *  @details Kept between calls of the im2col GEMM algorithm so it
+   *  is only reallocated when the mini-batch grows.
+   */
+  DMatDT<Device> m_im2col_workspace;
+  /** @brief Sample channels stacked for a block GEMM.
+   *  @details Kept between calls, like m_im2col_workspace.
+   */
+  DMatDT<Device> m_gemm_workspace;
+
 #ifdef LBANN_HAS_DISTCONV
   friend class base_convolution_adapter<TensorDataType, Device>;
 
@@ -111,6 +111,20 @@ public:
 
   El::Device get_device_allocation() const override { return Device; }
 
+  bool supports_fused_relu() const override { return true; }
+
+  /** Scales the kernel by output channel and folds the shift into
+   *  the bias, which is added if the layer has none. */
+  bool fold_inference_affine(std::vector<double> const& scale,
+                             std::vector<double> const& shift) override;
+  /** Quantizes the kernel by output channel. The bias is kept. */
+  bool quantize_inference_weights(std::vector<double>& scale) override;
+
+  /** Two operations per multiply-add with the kernel. */
+  compute_cost get_forward_prop_cost() const override;
+  /** The data and kernel gradients cost a forward prop each. */
+  compute_cost get_backward_prop_cost() const override;
+
 #ifdef LBANN_HAS_ONNX
   std::string get_onnx_op_type() const override { return "Conv"; }
   void fill_onnx_node(onnx::GraphProto& graph) const override;
@@ -99,6 +99,11 @@ public:
 
   El::Device get_device_allocation() const override { return Device; }
 
+  /** Two operations per multiply-add with the kernel. */
+  compute_cost get_forward_prop_cost() const override;
+  /** The data and kernel gradients cost a forward prop each. */
+  compute_cost get_backward_prop_cost() const override;
+
   void setup_dims(DataReaderMetaData& dr_metadata) override;
 
   /** @name Serialization */
@@ -29,9 +29,16 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/optimizers/sgd.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/layers.pb.h"
+#include "lbann/utils/md5.hpp"
 #include "lbann/utils/memory.hpp"
+#include "lbann/weights/weights_helpers.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace lbann {
 
@@ -48,6 +55,19 @@ namespace lbann {
  *  @f$ \text{embedding\_dim} \times \text{num\_embeddings} @f$
  *  weights matrix. Note that this is the transpose of the weights in
  *  the PyTorch embedding layer.
+ *
+ *  With sparse SGD, only the embedding vectors touched by the
+ *  mini-batch are updated. The gradients w.r.t. these vectors are
+ *  gathered across the trainer and every process applies the same SGD
+ *  steps to its copy of the embeddings in the "update" phase (i.e. in
+ *  the virtual update_compute function). This bypasses the optimizer
+ *  class, so no dense gradient w.r.t. the whole dictionary is formed.
+ *
+ *  With hashed indices, each input value is mapped to an embedding
+ *  vector by its MD5 hash (as in the uniform hash layer) modulo the
+ *  number of embeddings. This fuses the hashing trick into the
+ *  lookup, without an intermediate tensor of float indices that
+ *  cannot represent every row of a large dictionary.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class embedding_layer : public data_type_layer<TensorDataType>
@@ -78,10 +98,18 @@ public:
    *                        vector is initialized with zeros. The
    *                        objective function gradient w.r.t. this
    *                        embedding vector is always zero.
+   *  @param sparse_sgd     Apply sparse SGD steps to the touched
+   *                        embedding vectors instead of using the
+   *                        embeddings' optimizer.
+   *  @param learning_rate  SGD learning rate for sparse SGD.
+   *  @param hash_indices   Hash input values to embedding indices.
    */
   embedding_layer(size_t num_embeddings,
                   size_t embedding_dim,
-                  El::Int padding_idx = -1);
+                  El::Int padding_idx = -1,
+                  bool sparse_sgd = false,
+                  DataType learning_rate = -1.0,
+                  bool hash_indices = false);
 
   embedding_layer(const embedding_layer& other);
   embedding_layer& operator=(const embedding_layer& other);
@@ -114,8 +142,36 @@ protected:
 
   void fp_compute() override;
   void bp_compute() override;
+  bool update_compute() override;
 
 private:
+  /** Embedding index of an input value.
+   *
+   *  The value is floored, or hashed with hashed indices. The index
+   *  may be out-of-range.
+   */
+  El::Int get_index(TensorDataType x) const;
+  /** Gather gradients w.r.t. touched embedding vectors.
+   *
+   *  Each process finds the embedding vectors touched by its local
+   *  mini-batch and accumulates their gradients. The indices and
+   *  gradients are then gathered across the trainer.
+   */
+  void gather_sparse_gradients();
+  /** Get embedding indices of local mini-batch on host.
+   *
+   *  Out-of-range indices and the padding index are set to -1.
+   */
+  void get_local_indices(std::vector<El::Int>& indices);
+  /** Accumulate gradients w.r.t. touched embedding vectors.
+   *  @param positions  Column in @c local_grads for each input entry,
+   *                    or -1 if the entry is ignored.
+   */
+  void accumulate_sparse_gradients(const std::vector<int>& positions,
+                                   El::Matrix<TensorDataType, Device>& grads);
+  /** Apply SGD steps with the gathered sparse gradients. */
+  void apply_sparse_sgd_step(El::Matrix<TensorDataType, Device>& embeddings);
+
   /** Size of dictionary of embeddings. */
   size_t m_num_embeddings;
   /** Size of embedding vectors. */
@@ -125,9 +181,23 @@ private:
    *  gradient w.r.t. this embedding vector is always zero.
    */
   El::Int m_padding_idx;
+  /** Whether to use sparse SGD instead of the embeddings' optimizer. */
+  bool m_sparse_sgd;
+  /** SGD learning rate for sparse SGD. */
+  DataType m_learning_rate;
+  /** Whether input values are hashed to embedding indices. */
+  bool m_hash_indices;
 
   /** Gradient w.r.t. embedding weights. */
   std::unique_ptr<AbsDistMatrixType> m_embeddings_grad;
+
+  /** Embedding indices of the gathered sparse gradients.
+   *
+   *  Negative indices are padding.
+   */
+  std::vector<El::Int> m_sparse_indices;
+  /** Gathered gradients w.r.t. touched embedding vectors. */
+  El::Matrix<TensorDataType, Device> m_sparse_grads;
 };
 
 // =========================================================
@@ -143,18 +213,31 @@ void embedding_layer<T, L, D>::write_specific_proto(
   msg->set_num_embeddings(m_num_embeddings);
   msg->set_embedding_dim(m_embedding_dim);
   msg->mutable_padding_idx()->set_value(m_padding_idx);
+  msg->set_sparse_sgd(m_sparse_sgd);
+  msg->set_learning_rate(m_learning_rate);
+  msg->set_hash_indices(m_hash_indices);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 embedding_layer<TensorDataType, Layout, Device>::embedding_layer(
   size_t num_embeddings,
   size_t embedding_dim,
-  El::Int padding_idx)
+  El::Int padding_idx,
+  bool sparse_sgd,
+  DataType learning_rate,
+  bool hash_indices)
   : data_type_layer<TensorDataType>(nullptr),
     m_num_embeddings{num_embeddings},
     m_embedding_dim{embedding_dim},
-    m_padding_idx{padding_idx}
-{}
+    m_padding_idx{padding_idx},
+    m_sparse_sgd{sparse_sgd},
+    m_learning_rate{learning_rate},
+    m_hash_indices{hash_indices}
+{
+  if (!m_sparse_sgd) {
+    m_learning_rate = -1.0;
+  }
+}
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 embedding_layer<TensorDataType, Layout, Device>::embedding_layer()
@@ -168,6 +251,9 @@ embedding_layer<TensorDataType, Layout, Device>::embedding_layer(
     m_num_embeddings{other.m_num_embeddings},
     m_embedding_dim{other.m_embedding_dim},
     m_padding_idx{other.m_padding_idx},
+    m_sparse_sgd{other.m_sparse_sgd},
+    m_learning_rate{other.m_learning_rate},
+    m_hash_indices{other.m_hash_indices},
     m_embeddings_grad(other.m_embeddings_grad ? other.m_embeddings_grad->Copy()
                                               : nullptr)
 {}
@@ -181,8 +267,12 @@ embedding_layer<TensorDataType, Layout, Device>::operator=(
   m_num_embeddings = other.m_num_embeddings;
   m_embedding_dim = other.m_embedding_dim;
   m_padding_idx = other.m_padding_idx;
+  m_sparse_sgd = other.m_sparse_sgd;
+  m_learning_rate = other.m_learning_rate;
+  m_hash_indices = other.m_hash_indices;
   m_embeddings_grad.reset(
     other.m_embeddings_grad ? other.m_embeddings_grad->Copy() : nullptr);
+  m_sparse_indices.clear();
   return *this;
 }
 
@@ -221,9 +311,25 @@ embedding_layer<TensorDataType, Layout, Device>::get_description() const
   desc.add("Num embeddings", m_num_embeddings);
   desc.add("Embedding dim", m_embedding_dim);
   desc.add("Padding index", m_padding_idx);
+  desc.add("Using sparse SGD", m_sparse_sgd);
+  desc.add("SGD learning rate", m_learning_rate);
+  desc.add("Hashed indices", m_hash_indices);
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Int embedding_layer<TensorDataType, Layout, Device>::get_index(
+  TensorDataType x) const
+{
+  if (m_hash_indices) {
+    if (m_num_embeddings == 0) {
+      return -1;
+    }
+    return static_cast<El::Int>(md5::hash64(x) % m_num_embeddings);
+  }
+  return static_cast<El::Int>(std::floor(x));
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void embedding_layer<TensorDataType, Layout, Device>::setup_dims(
   DataReaderMetaData& dr_metadata)
@@ -291,6 +397,34 @@ void embedding_layer<TensorDataType, Layout, Device>::setup_data(
     El::Zero(*pad_embedding);
   }
 
+  // Destroy embedding optimizer and create dummy weights
+  // Note: This layer manually performs sparse SGD on embedding
+  // weights, so the embedding optimizer isn't needed. However, the
+  // layer must send gradients to some optimizer to prevent the model
+  // from optimizing the layer out of compute graph during backprop.
+  // We get around this by creating dummy weights with no entries.
+  if (m_sparse_sgd) {
+    if (m_learning_rate <= 0.0) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" uses sparse SGD with an invalid learning rate (",
+                  m_learning_rate,
+                  ")");
+    }
+    embeddings.set_optimizer(nullptr);
+    auto w = std::make_shared<WeightsType>(*this->get_comm());
+    auto opt = std::make_unique<sgd<TensorDataType>>(0.);
+    w->set_name(this->get_name() + "_dummy_weights");
+    w->set_optimizer(std::move(opt));
+    w->set_dims(1);
+    w->set_matrix_distribution(embeddings.get_matrix_distribution());
+    w->setup();
+    this->add_weights(w);
+    this->m_model->add_weights(std::move(w));
+    return;
+  }
+
   // Initialize gradient w.r.t. embeddings
   {
     auto& embedding_values =
@@ -302,6 +436,83 @@ void embedding_layer<TensorDataType, Layout, Device>::setup_data(
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void embedding_layer<TensorDataType, Layout, Device>::gather_sparse_gradients()
+{
+  auto& comm = *this->get_comm();
+
+  // Find embedding vectors touched by local mini-batch
+  // Note: Gradient for padding index is always zero.
+  std::vector<El::Int> indices;
+  get_local_indices(indices);
+  std::vector<El::Int> local_rows;
+  local_rows.reserve(indices.size());
+  for (const auto& ind : indices) {
+    if (ind >= 0) {
+      local_rows.push_back(ind);
+    }
+  }
+  std::sort(local_rows.begin(), local_rows.end());
+  local_rows.erase(std::unique(local_rows.begin(), local_rows.end()),
+                   local_rows.end());
+  std::vector<int> positions(indices.size(), -1);
+  for (size_t k = 0; k < indices.size(); ++k) {
+    if (indices[k] >= 0) {
+      const auto it =
+        std::lower_bound(local_rows.begin(), local_rows.end(), indices[k]);
+      positions[k] = std::distance(local_rows.begin(), it);
+    }
+  }
+
+  // Pad gradients to the largest number of touched vectors in trainer
+  const int num_procs = comm.get_procs_per_trainer();
+  std::vector<int> counts(num_procs);
+  comm.trainer_all_gather(static_cast<int>(local_rows.size()), counts);
+  const int max_count = *std::max_element(counts.begin(), counts.end());
+  m_sparse_indices.clear();
+  if (max_count == 0) {
+    return;
+  }
+  local_rows.resize(max_count, -1);
+
+  // Accumulate local gradients
+  El::Matrix<TensorDataType, Device> local_grads(m_embedding_dim,
+                                                 max_count,
+                                                 m_embedding_dim);
+  El::Zero(local_grads);
+  accumulate_sparse_gradients(positions, local_grads);
+
+  // Gather sparse gradients across trainer
+  m_sparse_indices.resize(max_count * num_procs);
+  comm.all_gather(local_rows.data(),
+                  max_count,
+                  m_sparse_indices.data(),
+                  max_count,
+                  comm.get_trainer_comm());
+  m_sparse_grads.Resize(m_embedding_dim,
+                        max_count * num_procs,
+                        m_embedding_dim);
+  comm.all_gather(local_grads.LockedBuffer(),
+                  local_grads.Height() * local_grads.Width(),
+                  m_sparse_grads.Buffer(),
+                  local_grads.Height() * local_grads.Width(),
+                  comm.get_trainer_comm(),
+                  El::SyncInfoFromMatrix(local_grads));
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool embedding_layer<TensorDataType, Layout, Device>::update_compute()
+{
+  if (m_sparse_sgd && !m_sparse_indices.empty()) {
+    using ValuesGetter = weights_details::SafeWeightsAccessor<TensorDataType>;
+    auto& embeddings = ValuesGetter::mutable_values(this->get_weights(0));
+    apply_sparse_sgd_step(
+      dynamic_cast<El::Matrix<TensorDataType, Device>&>(embeddings.Matrix()));
+    m_sparse_indices.clear();
+  }
+  return true;
+}
+
 LBANN_DEFINE_LAYER_BUILDER(embedding);
 
 #ifndef LBANN_EMBEDDING_LAYER_INSTANTIATE
@@ -30,10 +30,37 @@
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 
+#include <memory>
 #include <string>
 
 namespace lbann {
 
+/** @brief Tensor parallel partitioning of a fully-connected layer
+ *
+ *  With the model-parallel data layout, features are split over the
+ *  processes in each column of the process grid and samples over the
+ *  grid columns. A column-parallel layer followed by a row-parallel
+ *  layer (e.g. a transformer MLP block) keeps the intermediate
+ *  features split, so each direction of the pair only needs an
+ *  allgather and a reduce-scatter, i.e. one allreduce. See:
+ *
+ *  Mohammad Shoeybi, Mostofa Patwary, Raul Puri, Patrick LeGresley,
+ *  Jared Casper, and Bryan Catanzaro. "Megatron-LM: Training
+ *  multi-billion parameter language models using model parallelism."
+ *  arXiv preprint arXiv:1909.08053 (2019).
+ */
+enum class tensor_parallel_mode
+{
+  /** Distributed GEMM over the whole process grid. */
+  NONE,
+  /** Output features are split. The input is gathered and multiplied
+   *  by the local rows of the weights. */
+  COLUMN,
+  /** Input features are split. Local products with the local columns
+   *  of the weights are reduce-scattered into the output. */
+  ROW,
+};
+
 /** @brief Affine transformation
  *
  *  Flattens the input tensor, multiplies with a weights matrix, and
@@ -51,6 +78,9 @@ namespace lbann {
  *  PyTorch's linear operation. However, it implicitly flattens
  *  multi-dimensional data. To avoid this flattening, consider the
  *  channel-wise fully-connected layer.
+ *
+ *  With the model-parallel data layout, the layer can be tensor
+ *  parallel, see tensor_parallel_mode.
  */
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 class fully_connected_layer : public data_type_layer<TensorDataType>
@@ -72,10 +102,12 @@ public:
 
 public:
   /** @todo Accept a vector for output_size */
-  fully_connected_layer(int output_size,
-                        bool transpose = false,
-                        WeightsType* weight = nullptr,
-                        bool has_bias = true);
+  fully_connected_layer(
+    int output_size,
+    bool transpose = false,
+    WeightsType* weight = nullptr,
+    bool has_bias = true,
+    tensor_parallel_mode tensor_parallel = tensor_parallel_mode::NONE);
 
   fully_connected_layer(const fully_connected_layer& other);
 
@@ -91,6 +123,14 @@ public:
   std::string get_type() const override { return "fully connected"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_fused_relu() const override { return true; }
+
+  /** Scales the linearity by output channel and folds the shift into
+   *  the bias, which is added if the layer has none. */
+  bool fold_inference_affine(std::vector<double> const& scale,
+                             std::vector<double> const& shift) override;
+  /** Quantizes the linearity by output. The bias is kept. */
+  bool quantize_inference_weights(std::vector<double>& scale) override;
 
 #ifdef LBANN_HAS_ONNX
   void fill_onnx_node(onnx::GraphProto& graph) const override;
@@ -98,6 +138,11 @@ public:
 
   description get_description() const override;
 
+  /** Two operations per multiply-add with the linearity. */
+  compute_cost get_forward_prop_cost() const override;
+  /** The data and linearity gradients cost a forward prop each. */
+  compute_cost get_backward_prop_cost() const override;
+
   /** @name Serialization */
   ///@{
 
@@ -133,6 +178,14 @@ private:
   /** Whether the transpose of the linearity matrix is applied. */
   bool m_transpose;
 
+  /** Tensor parallel partitioning of the linearity. */
+  tensor_parallel_mode m_tensor_parallel;
+
+  /** Input gathered over the grid columns in forward prop.
+   *  Only used by column-parallel layers, which reuse it in backprop.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_gathered_input;
+
   /** Deallocate distributed matrices. */
   void deallocate_matrices()
   {
@@ -46,6 +46,11 @@ namespace lbann {
  *  and a 2D initial hidden state (
  *  @f$ \text{num\_layers}times\text{hidden\_size} @f$ ).
  *
+ *  An optional third input gives the length of each sample's
+ *  sequence as a tensor with one entry. Timesteps past a sample's
+ *  length are skipped: their outputs and input gradients are
+ *  zero. This requires cuDNN.
+ *
  *  Uses four weights per GRU cell: "ih\_matrix" (
  *  @f$ 3 \text{hidden\_size}\times\text{input\_size} @f$ for layer 0
  *  and @f$ 3 \text{hidden\_size}\times\text{hidden\_size} @f$ for other
@@ -147,6 +152,16 @@ private:
     TensorDesc hh_matrix_weights_grad;
     TensorDesc bias_weights_grad;
     TensorDesc workspace;
+
+    /** @brief Weights values versions in the packed weights
+     *
+     *  See weights::get_values_version. The weights are only
+     *  repacked when they have changed.
+     */
+    std::vector<size_t> packed_weights_versions;
+    /** @brief Whether the backward weights must be reordered from
+     *         the forward weights */
+    bool backward_weights_stale = true;
   };
 
   /** @brief Storage for oneDNN CPU objects */
@@ -191,6 +206,15 @@ private:
     ByteBuffer workspace;
     ByteBuffer reserve_space;
     IntBuffer gpu_sequence_lengths;
+    /** @brief Sequence lengths in @c gpu_sequence_lengths */
+    std::vector<int32_t> cpu_sequence_lengths;
+
+    /** @brief Weights values versions in @c weights_workspace
+     *
+     *  See weights::get_values_version. The weights are only
+     *  repacked when they have changed.
+     */
+    std::vector<size_t> packed_weights_versions;
 
     /** The cache is a map from mini-batch sizes to (hash, graph)
      *  pairs. The hash is generated from the cuDNN function
@@ -72,6 +72,13 @@ public:
  *  Given a predicted distribution @f$y@f$ and ground truth
  *  distribution @f$\hat{y}@f$,
  *  @f[ CE(y,\hat{y}) = - \sum\limits_{i} \hat{y}_i \log y_i @f]
+ *
+ *  With @c use_labels, the ground truth is a tensor of integer labels
+ *  (e.g. a scalar class index for a 1-D prediction) instead of a
+ *  one-hot tensor. Only the prediction of each label is read, and
+ *  the one-hot tensor is never formed, so feed the index to this
+ *  layer rather than through a one-hot layer for large numbers of
+ *  classes.
  */
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 class cross_entropy_layer : public data_type_layer<TensorDataType>
@@ -89,12 +89,11 @@ void cross_entropy_layer<TensorDataType, T_layout, Dev>::setup_dims(
     // Check if the number of dimensions match for predictions and labels
     // tensors
 
-    if (predictions_dims.size() != labels_dims.size() ||
-        predictions_dims.size() < 2) {
+    if (predictions_dims.size() != labels_dims.size()) {
       std::stringstream err;
       err << get_type() << " layer \"" << this->get_name() << "\" "
           << "expects both input tensors to have the same number of dimensions "
-          << "and have >2 dimensions when use_lables is enabled. "
+          << "when use_lables is enabled. "
           << "Found tensors with shape (";
 
       // TODO: Put this loop in util as it's used frequently to
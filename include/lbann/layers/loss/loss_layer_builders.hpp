@@ -36,6 +36,7 @@ LBANN_DEFINE_LAYER_BUILDER(l1_norm);
 LBANN_DEFINE_LAYER_BUILDER(l2_norm2);
 LBANN_DEFINE_LAYER_BUILDER(mean_absolute_error);
 LBANN_DEFINE_LAYER_BUILDER(mean_squared_error);
+LBANN_DEFINE_LAYER_BUILDER(softmax_cross_entropy);
 LBANN_DEFINE_LAYER_BUILDER(top_k_categorical_accuracy);
 
 } // namespace lbann
@@ -0,0 +1,223 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+#define LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
+
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+
+#include "lbann/proto/layers.pb.h"
+
+#include <type_traits>
+
+namespace lbann {
+
+/** @brief Cross entropy of the softmax of a vector of logits
+ *
+ *  Given logits @f$x@f$ and a ground truth distribution
+ *  @f$\hat{y}@f$,
+ *  @f[
+ *    SCE(x,\hat{y}) = - \sum\limits_{i} \hat{y}_i \log
+ *                       \frac{e^{x_i}}{\sum_j e^{x_j}}
+ *  @f]
+ *  This is equivalent to a softmax layer followed by a cross entropy
+ *  layer, but each sample's logits are read once in forward prop
+ *  (with an online softmax) and once in backprop.
+ *
+ *  If @c use_labels is set, the ground truth is one class index per
+ *  sample instead of a distribution, so no one-hot tensor needs to
+ *  be built. Samples whose index is not a valid class contribute
+ *  zero loss and zero gradient.
+ */
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+class softmax_cross_entropy_layer : public data_type_layer<TensorDataType>
+{
+  static_assert(Layout == data_layout::DATA_PARALLEL,
+                "softmax_cross_entropy_layer only supports "
+                "data-parallel data layout");
+
+public:
+  /** @brief Type for softmax statistics and accumulations. */
+  using AccumulateDataType =
+    std::conditional_t<std::is_same_v<TensorDataType, double>, double, float>;
+
+public:
+  /** @brief Constructor
+   *  @param comm        LBANN communicator.
+   *  @param use_labels  If true, the ground truth is a class index
+   *                     per sample.
+   */
+  softmax_cross_entropy_layer(lbann_comm* comm, bool use_labels);
+
+  softmax_cross_entropy_layer(const softmax_cross_entropy_layer& other) =
+    default;
+  softmax_cross_entropy_layer&
+  operator=(const softmax_cross_entropy_layer& other) = default;
+  softmax_cross_entropy_layer* copy() const override;
+
+  /** @name Serialization */
+  ///@{
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+
+  std::string get_type() const override;
+  data_layout get_data_layout() const override;
+  El::Device get_device_allocation() const override;
+
+  description get_description() const override;
+
+protected:
+  /** Add layer specific data to prototext */
+  void write_specific_proto(lbann_data::Layer& proto) const final;
+
+  friend class cereal::access;
+  softmax_cross_entropy_layer() : softmax_cross_entropy_layer(nullptr, false)
+  {}
+
+  void setup_dims(DataReaderMetaData& dr_metadata) override;
+
+  void fp_compute() override;
+  void bp_compute() override;
+
+private:
+  /** Whether the ground truth is a class index per sample. */
+  bool m_use_labels;
+
+  /** Per-sample statistics for backprop.
+   *
+   *  The first row is the log-sum-exp of the logits and the second
+   *  row is the sum of the ground truth. Dimensions are
+   *  2 x local_mini_batch_size.
+   */
+  El::Matrix<AccumulateDataType, Device> m_statistics;
+};
+
+// =========================================================
+// Implementation
+// =========================================================
+
+template <typename T, data_layout L, El::Device D>
+void softmax_cross_entropy_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  auto* msg = proto.mutable_softmax_cross_entropy();
+  msg->set_use_labels(m_use_labels);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>::
+  softmax_cross_entropy_layer(lbann_comm* comm, bool use_labels)
+  : data_type_layer<TensorDataType>(comm), m_use_labels{use_labels}
+{
+  this->m_expected_num_parent_layers = 2;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>*
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>::copy() const
+{
+  return new softmax_cross_entropy_layer(*this);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::string
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>::get_type() const
+{
+  return "softmax cross entropy";
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+data_layout
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>::get_data_layout()
+  const
+{
+  return Layout;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Device softmax_cross_entropy_layer<TensorDataType, Layout, Device>::
+  get_device_allocation() const
+{
+  return Device;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+description
+softmax_cross_entropy_layer<TensorDataType, Layout, Device>::get_description()
+  const
+{
+  auto desc = data_type_layer<TensorDataType>::get_description();
+  desc.add("Use labels", m_use_labels);
+  return desc;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void softmax_cross_entropy_layer<TensorDataType, Layout, Device>::setup_dims(
+  DataReaderMetaData& dr_metadata)
+{
+  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
+  this->set_output_dims({1});
+
+  // Check input dimensions
+  const auto& parents = this->get_parent_layers();
+  const auto expected_size = (m_use_labels ? 1 : this->get_input_size(0));
+  if (this->get_input_size(1) != expected_size) {
+    std::ostringstream err;
+    err << this->get_type() << " layer \"" << this->get_name() << "\" "
+        << "expects a ground truth tensor with " << expected_size << " "
+        << "entries, but layer \"" << parents[1]->get_name() << "\" "
+        << "outputs ";
+    const auto& dims = this->get_input_dims(1);
+    for (size_t j = 0; j < dims.size(); ++j) {
+      err << (j > 0 ? " x " : "") << dims[j];
+    }
+    LBANN_ERROR(err.str());
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#ifndef LBANN_SOFTMAX_CROSS_ENTROPY_LAYER_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class softmax_cross_entropy_layer<                           \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    Device>;
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_SOFTMAX_CROSS_ENTROPY_LAYER_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_LOSS_SOFTMAX_CROSS_ENTROPY_HPP_INCLUDED
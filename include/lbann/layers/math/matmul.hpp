@@ -71,7 +71,11 @@ public:
  *  Performs matrix product of two 2D input tensors. If the input
  *  tensors are 3D, then matrix products are computed independently
  *  over the first dimension, in a similar manner as NumPy's matmul
- *  function.
+ *  function. A 2D input, or a 3D input whose first dimension is 1,
+ *  is broadcast over the first dimension of the other input.
+ *
+ *  The products for all mini-batch samples are computed with
+ *  strided-batched GEMMs.
  *
  *  @todo Support >3 dimensions, matvecs, and dot products
  *
@@ -98,6 +102,7 @@ public:
   El::Device get_device_allocation() const override;
 
   description get_description() const override;
+  bool fold_input_transpose(int input_index) override;
 
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
@@ -133,10 +138,10 @@ private:
    *  before multiplication. */
   bool m_transpose_b;
 
-  template <typename U>
-  friend void fp_compute_impl(matmul_layer<U, Layout, Device>&, bool, bool);
-  template <typename U>
-  friend void bp_compute_impl(matmul_layer<U, Layout, Device>&, bool, bool);
+  template <typename U, El::Device D>
+  friend void fp_compute_impl(matmul_layer<U, Layout, D>&, bool, bool);
+  template <typename U, El::Device D>
+  friend void bp_compute_impl(matmul_layer<U, Layout, D>&, bool, bool);
 };
 
 // =========================================================
@@ -191,6 +196,22 @@ matmul_layer<TensorDataType, Layout, Device>::get_description() const
   return desc;
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool matmul_layer<TensorDataType, Layout, Device>::fold_input_transpose(
+  int input_index)
+{
+  switch (input_index) {
+  case 0:
+    m_transpose_a = !m_transpose_a;
+    return true;
+  case 1:
+    m_transpose_b = !m_transpose_b;
+    return true;
+  default:
+    return false;
+  }
+}
+
 // =========================================================
 // Explicit template instantiation
 // =========================================================
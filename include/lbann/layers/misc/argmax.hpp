@@ -35,14 +35,14 @@ namespace lbann {
 /** @brief Get index of maximum-value tensor entry
  *
  *  Expects a 1D input tensor. If multiple entries have the same
- *  maximum value, outputs the index of the first one.
+ *  maximum value, outputs the index of the first one. On GPU, each
+ *  sample is reduced by one thread block.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class argmax_layer : public data_type_layer<TensorDataType>
 {
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "argmax layer only supports data parallel layout");
-  static_assert(Device == El::Device::CPU, "argmax layer only supports CPU");
 
 public:
   argmax_layer(lbann_comm* comm) : data_type_layer<TensorDataType>(comm) {}
@@ -73,15 +73,11 @@ protected:
 };
 
 #ifndef LBANN_ARGMAX_LAYER_INSTANTIATE
-#define PROTO(T)                                                               \
-  extern template class argmax_layer<T,                                        \
-                                     data_layout::DATA_PARALLEL,               \
-                                     El::Device::CPU>
-
-#define LBANN_INSTANTIATE_CPU_HALF
-#include "lbann/macros/instantiate.hpp"
-#undef PROTO
-#undef LBANN_INSTANTIATE_CPU_HALF
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class argmax_layer<T, data_layout::DATA_PARALLEL, Device>
+
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
 #endif // LBANN_ARGMAX_LAYER_INSTANTIATE
 
 } // namespace lbann
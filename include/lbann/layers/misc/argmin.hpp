@@ -34,14 +34,14 @@ namespace lbann {
 /** @brief Get index of minimum-value tensor entry
  *
  *  Expects a 1D input tensor. If multiple entries have the same
- *  minimum value, outputs the index of the first one.
+ *  minimum value, outputs the index of the first one. On GPU, each
+ *  sample is reduced by one thread block.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class argmin_layer : public data_type_layer<TensorDataType>
 {
   static_assert(Layout == data_layout::DATA_PARALLEL,
                 "argmin layer only supports data parallel layout");
-  static_assert(Device == El::Device::CPU, "argmin layer only supports CPU");
 
 public:
   argmin_layer(lbann_comm* comm) : data_type_layer<TensorDataType>(comm) {}
@@ -72,15 +72,11 @@ protected:
 };
 
 #ifndef LBANN_ARGMIN_LAYER_INSTANTIATE
-#define PROTO(T)                                                               \
-  extern template class argmin_layer<T,                                        \
-                                     data_layout::DATA_PARALLEL,               \
-                                     El::Device::CPU>
-
-#define LBANN_INSTANTIATE_CPU_HALF
-#include "lbann/macros/instantiate.hpp"
-#undef PROTO
-#undef LBANN_INSTANTIATE_CPU_HALF
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class argmin_layer<T, data_layout::DATA_PARALLEL, Device>
+
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
 #endif // LBANN_ARGMIN_LAYER_INSTANTIATE
 } // namespace lbann
 
@@ -0,0 +1,324 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_LAYERS_MISC_ATTENTION_HPP_INCLUDED
+#define LBANN_LAYERS_MISC_ATTENTION_HPP_INCLUDED
+
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+
+#include "lbann/proto/layers.pb.h"
+
+#include <type_traits>
+
+namespace lbann {
+
+/** @brief Multi-head scaled dot-product attention
+ *
+ *  Expects three input tensors: queries, keys, and values. Each is
+ *  interpreted as a sequence of vectors, where the first tensor
+ *  dimension is the sequence dimension. The vectors are split into
+ *  @c num_heads contiguous slices and attention is applied to each
+ *  head independently:
+ *  @f[
+ *    \text{Attention}(Q,K,V) = \text{softmax}(QK^T / \sqrt{d}) V
+ *  @f]
+ *  where @f$ d @f$ is the size of each head. The output has the same
+ *  dimensions as the queries.
+ *
+ *  The attention scores are computed in tiles and are never stored.
+ *  Forward prop uses an online softmax and saves the log-sum-exp of
+ *  each query's scores, and backprop recomputes the scores from it.
+ *  Memory use is linear in the sequence length.
+ *
+ *  If the parallel strategy splits sequences, the queries, keys, and
+ *  values are shards of sequences held by a ring of ranks. The key
+ *  and value shards are passed around the ring, each rank attends its
+ *  queries to every shard, and the partial results are merged with
+ *  their log-sum-exps. In backprop, the key and value gradients
+ *  travel around the ring with their shards until they return to
+ *  their owners. With a causal mask, queries and keys have the same
+ *  shard length and shards after a rank's own shard are skipped.
+ *
+ *  See:
+ *
+ *  Hao Liu, Matei Zaharia, and Pieter Abbeel. "Ring attention with
+ *  blockwise transformers for near-infinite context." arXiv preprint
+ *  arXiv:2310.01889 (2023).
+ *
+ *  See:
+ *
+ *  Tri Dao, Daniel Y. Fu, Stefano Ermon, Atri Rudra, and Christopher
+ *  Re. "FlashAttention: Fast and memory-efficient exact attention
+ *  with IO-awareness." In Advances in Neural Information Processing
+ *  Systems. 2022.
+ */
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+class attention_layer : public data_type_layer<TensorDataType>
+{
+  static_assert(Layout == data_layout::DATA_PARALLEL,
+                "attention_layer only supports "
+                "data-parallel data layout");
+
+public:
+  /** @brief Type for softmax statistics and accumulations. */
+  using AccumulateDataType =
+    std::conditional_t<std::is_same_v<TensorDataType, double>, double, float>;
+
+public:
+  /** @brief Constructor
+   *  @param comm       LBANN communicator.
+   *  @param num_heads  Number of attention heads. Must evenly divide
+   *                    the size of the query, key, and value vectors.
+   *  @param causal     If true, then each query only attends to keys
+   *                    at the same or earlier sequence positions.
+   */
+  attention_layer(lbann_comm* comm, size_t num_heads, bool causal);
+
+  attention_layer(const attention_layer& other) = default;
+  attention_layer& operator=(const attention_layer& other) = default;
+  attention_layer* copy() const override;
+
+  /** @name Serialization */
+  ///@{
+
+  template <typename ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+
+  std::string get_type() const override;
+  data_layout get_data_layout() const override;
+  El::Device get_device_allocation() const override;
+
+  description get_description() const override;
+
+protected:
+  /** Add layer specific data to prototext */
+  void write_specific_proto(lbann_data::Layer& proto) const final;
+
+  friend class cereal::access;
+  attention_layer() : attention_layer(nullptr, 1, false) {}
+
+  void setup_dims(DataReaderMetaData& dr_metadata) override;
+
+  void fp_compute() override;
+  void bp_compute() override;
+
+private:
+  using LocalMat = El::Matrix<TensorDataType, Device>;
+  using LocalAccMat = El::Matrix<AccumulateDataType, Device>;
+
+  /** @brief Attend queries to a block of keys and values
+   *
+   *  Writes the output and the log-sum-exp of the scores, which is
+   *  infinite for queries that attend to no keys.
+   */
+  void fp_block(const LocalMat& queries,
+                const LocalMat& keys,
+                const LocalMat& values,
+                bool causal,
+                LocalMat& output,
+                LocalAccMat& logsumexp);
+  /** @brief Merge the attention to another block into the output
+   *
+   *  The output and log-sum-exp become those of attention to the
+   *  union of the blocks.
+   */
+  void fp_merge(const LocalMat& block_output,
+                const LocalAccMat& block_logsumexp,
+                LocalMat& output,
+                LocalAccMat& logsumexp);
+  /** @brief Dot products between outputs and output gradients */
+  void bp_dots(const LocalMat& output,
+               const LocalMat& output_grad,
+               LocalAccMat& dots);
+  /** @brief Gradients from the attention to a block of keys and
+   *         values
+   *
+   *  The probabilities are recomputed from the log-sum-exp saved in
+   *  forward prop. If @c accumulate is true, then the gradients are
+   *  added to the existing ones.
+   */
+  void bp_block(const LocalMat& queries,
+                const LocalMat& keys,
+                const LocalMat& values,
+                const LocalMat& output_grad,
+                const LocalAccMat& dots,
+                bool causal,
+                bool accumulate,
+                LocalMat& queries_grad,
+                LocalMat& keys_grad,
+                LocalMat& values_grad);
+
+  /** Number of attention heads. */
+  size_t m_num_heads;
+  /** Whether queries only attend to earlier keys. */
+  bool m_causal;
+
+  /** Log-sum-exp of attention scores.
+   *
+   *  Computed in forward prop and used to recompute the attention
+   *  probabilities in backprop. Dimensions are
+   *  (num_queries * num_heads) x local_mini_batch_size.
+   */
+  El::Matrix<AccumulateDataType, Device> m_logsumexp;
+};
+
+// =========================================================
+// Implementation
+// =========================================================
+
+template <typename T, data_layout L, El::Device D>
+void attention_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  auto* msg = proto.mutable_attention();
+  msg->set_num_heads(m_num_heads);
+  msg->set_causal(m_causal);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+attention_layer<TensorDataType, Layout, Device>::attention_layer(
+  lbann_comm* comm,
+  size_t num_heads,
+  bool causal)
+  : data_type_layer<TensorDataType>(comm),
+    m_num_heads{num_heads},
+    m_causal{causal}
+{
+  this->m_expected_num_parent_layers = 3;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+attention_layer<TensorDataType, Layout, Device>*
+attention_layer<TensorDataType, Layout, Device>::copy() const
+{
+  return new attention_layer(*this);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::string attention_layer<TensorDataType, Layout, Device>::get_type() const
+{
+  return "attention";
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+data_layout
+attention_layer<TensorDataType, Layout, Device>::get_data_layout() const
+{
+  return Layout;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+El::Device
+attention_layer<TensorDataType, Layout, Device>::get_device_allocation() const
+{
+  return Device;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+description
+attention_layer<TensorDataType, Layout, Device>::get_description() const
+{
+  auto desc = data_type_layer<TensorDataType>::get_description();
+  desc.add("Heads", m_num_heads);
+  desc.add("Causal", m_causal);
+  return desc;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::setup_dims(
+  DataReaderMetaData& dr_metadata)
+{
+  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
+
+  // Check input dimensions
+  const auto& query_dims = this->get_input_dims(0);
+  const auto& key_dims = this->get_input_dims(1);
+  const auto& value_dims = this->get_input_dims(2);
+  auto dims_to_str = [](const std::vector<int>& dims) -> std::string {
+    std::ostringstream ss;
+    for (size_t i = 0; i < dims.size(); ++i) {
+      ss << (i > 0 ? "x" : "") << dims[i];
+    }
+    return ss.str();
+  };
+  if (query_dims.size() != 2 || key_dims != value_dims ||
+      key_dims.size() != 2 || query_dims[1] != key_dims[1]) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" expects queries, keys, and values as 2D tensors ",
+                "with the same vector size, and keys and values with ",
+                "the same sequence length, but got ",
+                dims_to_str(query_dims),
+                ", ",
+                dims_to_str(key_dims),
+                ", and ",
+                dims_to_str(value_dims));
+  }
+  if (this->get_parallel_strategy().sequence_splits > 1 && m_causal &&
+      query_dims[0] != key_dims[0]) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" splits sequences with a causal mask, which requires ",
+                "query and key shards of the same length, but got ",
+                dims_to_str(query_dims),
+                " and ",
+                dims_to_str(key_dims));
+  }
+  if (m_num_heads == 0 || query_dims[1] % m_num_heads != 0) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" has ",
+                m_num_heads,
+                " heads, which does not evenly divide the vector size (",
+                query_dims[1],
+                ")");
+  }
+
+  this->set_output_dims(query_dims);
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#ifndef LBANN_ATTENTION_LAYER_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class attention_layer<T, data_layout::DATA_PARALLEL, Device>;
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_ATTENTION_LAYER_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_MISC_ATTENTION_HPP_INCLUDED
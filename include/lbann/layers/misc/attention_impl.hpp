@@ -0,0 +1,329 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_MISC_ATTENTION_IMPL_HPP_INCLUDED
+#define LBANN_LAYERS_MISC_ATTENTION_IMPL_HPP_INCLUDED
+
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/misc/attention.hpp"
+
+namespace lbann {
+
+namespace attention_details {
+
+/** @brief Ring of ranks holding the shards of this rank's sequences
+ *
+ *  Neighbors are ranks in the trainer.
+ */
+struct sequence_ring
+{
+  int num_shards;
+  int shard;
+  int trainer;
+  int next;
+  int prev;
+};
+
+inline sequence_ring get_sequence_ring(lbann_comm& comm,
+                                       const El::mpi::Comm& sequence_comm,
+                                       El::Int mini_batch_size,
+                                       const std::string& layer_name)
+{
+  sequence_ring ring;
+  ring.num_shards = El::mpi::Size(sequence_comm);
+  ring.shard = El::mpi::Rank(sequence_comm);
+  if (mini_batch_size % ring.num_shards != 0) {
+    LBANN_ERROR("attention layer \"",
+                layer_name,
+                "\" got a mini-batch of ",
+                mini_batch_size,
+                " sequence shards, which is not a multiple of the ",
+                ring.num_shards,
+                " shards per sequence");
+  }
+  const int first = comm.get_rank_in_trainer() - ring.shard;
+  ring.trainer = comm.get_trainer_rank();
+  ring.next = first + (ring.shard + 1) % ring.num_shards;
+  ring.prev = first + (ring.shard + ring.num_shards - 1) % ring.num_shards;
+  return ring;
+}
+
+/** @brief Use the stream of a layer matrix in a workspace matrix */
+template <typename T, El::Device D>
+void setup_workspace(El::Matrix<T, D>& workspace,
+                     El::SyncInfo<D> const& sync_info)
+{
+#ifdef LBANN_HAS_GPU
+  if constexpr (D == El::Device::GPU) {
+#ifdef HYDROGEN_HAVE_CUB
+    workspace.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                          // HYDROGEN_HAVE_CUB
+    El::SetSyncInfo(workspace, sync_info);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+} // namespace attention_details
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  using attention_details::setup_workspace;
+
+  // Local matrices
+  const auto& local_queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& local_values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  auto& local_output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Attend to local keys if sequences are not split
+  const auto* sequence_comm = this->get_sequence_comm();
+  if (sequence_comm == nullptr) {
+    fp_block(local_queries,
+             local_keys,
+             local_values,
+             m_causal,
+             local_output,
+             m_logsumexp);
+    return;
+  }
+
+  // Ring of ranks holding the shards of each sequence
+  auto& comm = *this->get_comm();
+  const auto ring = attention_details::get_sequence_ring(
+    comm,
+    *sequence_comm,
+    this->get_prev_activations(0).Width(),
+    this->get_name());
+  const El::Int block_height = local_keys.Height();
+  const El::Int local_mini_batch_size = local_keys.Width();
+  const auto sync_info = El::SyncInfoFromMatrix(local_output);
+
+  // Workspaces
+  // Note: Blocks hold keys followed by values so each step is a
+  // single exchange.
+  LocalMat blocks[2], block_output;
+  LocalAccMat block_logsumexp;
+  for (auto& block : blocks) {
+    setup_workspace(block, sync_info);
+    block.Resize(2 * block_height, local_mini_batch_size);
+  }
+  setup_workspace(block_output, sync_info);
+  setup_workspace(block_logsumexp, sync_info);
+  block_output.Resize(local_output.Height(), local_mini_batch_size);
+  {
+    auto keys = El::View(blocks[0], El::IR(0, block_height), El::ALL);
+    auto values =
+      El::View(blocks[0], El::IR(block_height, 2 * block_height), El::ALL);
+    El::Copy(local_keys, keys);
+    El::Copy(local_values, values);
+  }
+
+  // Attend to each block as it passes around the ring
+  // Note: With a causal mask, queries only attend to earlier shards
+  // and to their own shard, where the mask applies.
+  const int block_count = static_cast<int>(blocks[0].Height() *
+                                           blocks[0].Width());
+  int current = 0;
+  for (int step = 0; step < ring.num_shards; ++step) {
+    const int block_shard =
+      (ring.shard + ring.num_shards - step) % ring.num_shards;
+    if (!(m_causal && block_shard > ring.shard)) {
+      const auto& block = blocks[current];
+      const auto keys =
+        El::LockedView(block, El::IR(0, block_height), El::ALL);
+      const auto values =
+        El::LockedView(block, El::IR(block_height, 2 * block_height), El::ALL);
+      const bool causal = (m_causal && block_shard == ring.shard);
+      if (step == 0) {
+        fp_block(local_queries,
+                 keys,
+                 values,
+                 causal,
+                 local_output,
+                 m_logsumexp);
+      }
+      else {
+        fp_block(local_queries,
+                 keys,
+                 values,
+                 causal,
+                 block_output,
+                 block_logsumexp);
+        fp_merge(block_output, block_logsumexp, local_output, m_logsumexp);
+      }
+    }
+    if (step + 1 < ring.num_shards && block_count > 0) {
+      comm.sendrecv(blocks[current].LockedBuffer(),
+                    block_count,
+                    ring.trainer,
+                    ring.next,
+                    blocks[1 - current].Buffer(),
+                    block_count,
+                    ring.trainer,
+                    ring.prev,
+                    sync_info);
+      current = 1 - current;
+    }
+  }
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  using attention_details::setup_workspace;
+
+  // Local matrices
+  const auto& local_queries =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_keys =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& local_values =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(2));
+  const auto& local_output =
+    dynamic_cast<const LocalMat&>(this->get_local_activations());
+  const auto& local_output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+  auto& local_queries_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+  auto& local_keys_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+  auto& local_values_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(2));
+
+  // Dot products between outputs and output gradients
+  // Note: These are over the attention to all keys, so they are
+  // shared by every block.
+  const auto sync_info = El::SyncInfoFromMatrix(local_queries_grad);
+  LocalAccMat dots;
+  setup_workspace(dots, sync_info);
+  bp_dots(local_output, local_output_grad, dots);
+
+  // Backprop through local keys if sequences are not split
+  const auto* sequence_comm = this->get_sequence_comm();
+  if (sequence_comm == nullptr) {
+    bp_block(local_queries,
+             local_keys,
+             local_values,
+             local_output_grad,
+             dots,
+             m_causal,
+             false,
+             local_queries_grad,
+             local_keys_grad,
+             local_values_grad);
+    return;
+  }
+
+  // Ring of ranks holding the shards of each sequence
+  auto& comm = *this->get_comm();
+  const auto ring = attention_details::get_sequence_ring(
+    comm,
+    *sequence_comm,
+    this->get_prev_activations(0).Width(),
+    this->get_name());
+  const El::Int block_height = local_keys.Height();
+  const El::Int local_mini_batch_size = local_keys.Width();
+
+  // Workspaces
+  // Note: Blocks hold keys, values, and their gradients, which are
+  // accumulated as the block passes around the ring.
+  LocalMat blocks[2];
+  for (auto& block : blocks) {
+    setup_workspace(block, sync_info);
+    block.Resize(4 * block_height, local_mini_batch_size);
+  }
+  auto get_rows = [block_height](LocalMat& block, El::Int i) {
+    return El::View(block,
+                    El::IR(i * block_height, (i + 1) * block_height),
+                    El::ALL);
+  };
+  {
+    auto keys = get_rows(blocks[0], 0);
+    auto values = get_rows(blocks[0], 1);
+    El::Copy(local_keys, keys);
+    El::Copy(local_values, values);
+  }
+
+  // Backprop through each block as it passes around the ring
+  // Note: A rank's own block comes first, so every block's gradients
+  // are initialized by its owner. After one more exchange than in
+  // forward prop, the blocks and their gradients are back with their
+  // owners.
+  const int block_count = static_cast<int>(blocks[0].Height() *
+                                           blocks[0].Width());
+  int current = 0;
+  for (int step = 0; step < ring.num_shards; ++step) {
+    const int block_shard =
+      (ring.shard + ring.num_shards - step) % ring.num_shards;
+    if (!(m_causal && block_shard > ring.shard)) {
+      auto& block = blocks[current];
+      const auto keys = get_rows(block, 0);
+      const auto values = get_rows(block, 1);
+      auto keys_grad = get_rows(block, 2);
+      auto values_grad = get_rows(block, 3);
+      bp_block(local_queries,
+               keys,
+               values,
+               local_output_grad,
+               dots,
+               m_causal && block_shard == ring.shard,
+               step > 0,
+               local_queries_grad,
+               keys_grad,
+               values_grad);
+    }
+    if (block_count > 0) {
+      comm.sendrecv(blocks[current].LockedBuffer(),
+                    block_count,
+                    ring.trainer,
+                    ring.next,
+                    blocks[1 - current].Buffer(),
+                    block_count,
+                    ring.trainer,
+                    ring.prev,
+                    sync_info);
+      current = 1 - current;
+    }
+  }
+  El::Copy(get_rows(blocks[current], 2), local_keys_grad);
+  El::Copy(get_rows(blocks[current], 3), local_values_grad);
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_MISC_ATTENTION_IMPL_HPP_INCLUDED
@@ -45,6 +45,11 @@ namespace lbann {
  *  @f]
  *  Scaling by @f$ 1/n @f$ instead of @f$ 1/(n-1) @f$ is a biased
  *  estimator.
+ *
+ *  The means and covariance are computed in one pass over the
+ *  inputs, shifted by one of their entries. When the inputs are
+ *  split between processes, each process's count, means and
+ *  co-moment are combined pairwise after one allreduce.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class covariance_layer : public data_type_layer<TensorDataType>
@@ -68,7 +73,8 @@ public:
     : data_type_layer<TensorDataType>(other),
       m_biased(other.m_biased),
       m_means(other.m_means ? other.m_means->Copy() : nullptr),
-      m_workspace(other.m_workspace ? other.m_workspace->Copy() : nullptr)
+      m_workspace(other.m_workspace ? other.m_workspace->Copy() : nullptr),
+      m_partials(other.m_partials ? other.m_partials->Copy() : nullptr)
   {}
   covariance_layer& operator=(const covariance_layer& other)
   {
@@ -76,6 +82,7 @@ public:
     m_biased = other.m_biased;
     m_means.reset(other.m_means ? other.m_means->Copy() : nullptr);
     m_workspace.reset(other.m_workspace ? other.m_workspace->Copy() : nullptr);
+    m_partials.reset(other.m_partials ? other.m_partials->Copy() : nullptr);
     return *this;
   }
 
@@ -125,6 +132,9 @@ private:
   std::unique_ptr<AbsDistMatrixType> m_means;
   /** Workspace. */
   std::unique_ptr<AbsDistMatrixType> m_workspace;
+  /** Count, means and co-moment of each process's part of the
+   *  inputs, packed for one allreduce. */
+  std::unique_ptr<AbsDistMatrixType> m_partials;
 };
 
 template <typename T, data_layout L, El::Device D>
@@ -29,7 +29,6 @@
 #include "lbann/base.hpp"
 #include "lbann/layers/layer.hpp"
 
-#if defined(LBANN_HAS_SHMEM) || defined(LBANN_HAS_NVSHMEM)
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/sgd.hpp"
@@ -38,6 +37,8 @@
 #include "lbann/utils/memory.hpp"
 #include "lbann/weights/weights_helpers.hpp"
 
+#include <vector>
+
 namespace lbann {
 
 /** @brief Embedding layer with distributed weights
@@ -46,7 +47,9 @@ namespace lbann {
  *  indices and returns embedding vectors from a lookup table.
  *  However, the embedding vectors are distributed between processes
  *  and one-sided inter-process communication is performed with
- *  OpenSHMEM (on CPU) or NVSHMEM (on GPU).
+ *  OpenSHMEM (on CPU) or NVSHMEM (on GPU). If LBANN is built without
+ *  OpenSHMEM, the CPU layer instead exchanges embedding vectors and
+ *  gradients with MPI all-to-all collectives.
  *
  *  The main benefit of this model-parallel approach is to handle
  *  cases where the embedding vectors don't fit on one process. It
@@ -164,6 +167,28 @@ private:
   /** Allocated size of @c m_metadata_buffer. */
   size_t m_metadata_buffer_size{0};
 
+  /** @name MPI backend
+   *
+   *  Used on CPU if LBANN is built without OpenSHMEM.
+   */
+  ///@{
+
+  /** Number of embedding vectors requested from each process. */
+  std::vector<int> m_send_counts;
+  /** Number of embedding vectors requested by each process. */
+  std::vector<int> m_recv_counts;
+  /** Position in local input of each requested embedding vector.
+   *
+   *  Ordered by owner process.
+   */
+  std::vector<size_t> m_request_positions;
+  /** Local indices of embedding vectors requested by processes. */
+  std::vector<El::Int> m_requested_indices;
+  /** Gradients w.r.t. embedding vectors requested by processes. */
+  LocalMat m_requested_grads;
+
+  ///@}
+
   /** Request to synchronize non-blocking barriers.
    *
    *  Careful synchronization is required to ensure the correctness of
@@ -428,11 +453,9 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::nb_barrier(
 // Explicit template instantiation
 // ---------------------------------------------
 
-#ifdef LBANN_HAS_SHMEM
 extern template class dist_embedding_layer<float,
                                            data_layout::DATA_PARALLEL,
                                            El::Device::CPU>;
-#endif // LBANN_HAS_SHMEM
 #if defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
 extern template class dist_embedding_layer<float,
                                            data_layout::DATA_PARALLEL,
@@ -440,7 +463,6 @@ extern template class dist_embedding_layer<float,
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
 
 } // namespace lbann
-#endif // defined(LBANN_HAS_SHMEM) || defined(LBANN_HAS_NVSHMEM)
 
 // ---------------------------------------------
 // Builder function
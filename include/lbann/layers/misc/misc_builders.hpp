@@ -32,6 +32,7 @@ namespace lbann {
 
 LBANN_DEFINE_LAYER_BUILDER(argmax);
 LBANN_DEFINE_LAYER_BUILDER(argmin);
+LBANN_DEFINE_LAYER_BUILDER(attention);
 LBANN_DEFINE_LAYER_BUILDER(channelwise_mean);
 LBANN_DEFINE_LAYER_BUILDER(channelwise_softmax);
 LBANN_DEFINE_LAYER_BUILDER(covariance);
@@ -40,6 +40,10 @@ namespace lbann {
  *  is interpreted as an index, and output entries are one if they
  *  correspond to that index and zero otherwise. Out-of-range indices
  *  are ignored.
+ *
+ *  Losses and lookups can often take the index directly: the cross
+ *  entropy layer with @c use_labels and the gather layer avoid
+ *  forming the one-hot tensor.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class one_hot_layer : public data_type_layer<TensorDataType>
@@ -87,10 +87,11 @@ protected:
 
 private:
   using LocalMat = El::Matrix<TensorDataType, Device>;
-  LocalMat m_local_norms;
 
-  static void row_sqsums(const LocalMat& mat, LocalMat& row_sqsums);
-  static void sqrt(LocalMat& mat);
+  /** Norms of the local rows of the weights matrix, which are cached
+   *  by the weights. */
+  const LocalMat& get_local_norms() const;
+
   static void divide(LocalMat& numer, const LocalMat& denom);
   static void row_axpy(TensorDataType alpha,
                        const LocalMat& a_vec,
@@ -93,6 +93,27 @@ void rowwise_weights_norms_layer<T, L, D>::setup_dims(
   const auto& dims_ = this->get_weights(0).get_matrix_height_dims();
   std::vector<int> dims(dims_.begin(), dims_.end());
   this->set_output_dims(dims);
+
+  // The weights compute the norms of their rows
+  this->get_weights(0).enable_row_norms();
+}
+
+template <typename T, data_layout L, El::Device D>
+auto rowwise_weights_norms_layer<T, L, D>::get_local_norms() const
+  -> const LocalMat&
+{
+  using WeightsType = data_type_weights<T>;
+  const auto& w = dynamic_cast<const WeightsType&>(this->get_weights(0));
+  const auto& norms = w.get_row_norms();
+  if (norms.GetDevice() != D) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" and weights \"",
+                w.get_name(),
+                "\" are on different devices");
+  }
+  return static_cast<const LocalMat&>(norms);
 }
 
 template <typename T, data_layout L, El::Device D>
@@ -118,19 +139,15 @@ void rowwise_weights_norms_layer<T, L, D>::fp_compute()
   }
 
   // Workspace buffers
-  /// @todo Synchronize
-  m_local_norms.Resize(weights_matrix.LocalHeight(), 1);
   LocalMat ones;
   El::Ones(ones, output.LocalWidth(), 1);
 
-  // Compute norm of each row in weights matrix
-  this->row_sqsums(weights_matrix.LockedMatrix(), m_local_norms);
-  El::AllReduce(m_local_norms, weights_matrix.RowComm(), El::mpi::SUM);
-  this->sqrt(m_local_norms);
+  // Norm of each row in weights matrix, computed at most once for
+  // each version of the weights
   El::Gemm(El::NORMAL,
            El::TRANSPOSE,
            El::TypeTraits<T>::One(),
-           m_local_norms,
+           get_local_norms(),
            ones,
            El::TypeTraits<T>::Zero(),
            output.Matrix());
@@ -143,7 +160,9 @@ void rowwise_weights_norms_layer<T, L, D>::bp_compute()
   // Weights data
   using WeightsType = data_type_weights<T>;
   auto& w = dynamic_cast<WeightsType&>(this->get_weights(0));
-  const auto& weights_matrix = w.get_values();
+  // Note: Non-const access would mark the values, and hence the
+  // cached norms, as modified
+  const auto& weights_matrix = static_cast<const WeightsType&>(w).get_values();
   auto&& opt = w.get_optimizer();
   if (opt == nullptr) {
     return;
@@ -178,7 +197,7 @@ void rowwise_weights_norms_layer<T, L, D>::bp_compute()
            El::TypeTraits<T>::Zero(),
            workspace);
   El::AllReduce(workspace, output_grad.RowComm(), El::mpi::SUM);
-  this->divide(workspace, m_local_norms);
+  this->divide(workspace, get_local_norms());
   this->row_axpy(alpha,
                  workspace,
                  weights_matrix.LockedMatrix(),
@@ -44,6 +44,11 @@ namespace lbann {
  *  @f]
  *  Scaling by @f$ 1/n @f$ instead of @f$ 1/(n-1) @f$ is a biased
  *  estimator.
+ *
+ *  The mean and variance are computed in one pass over the input,
+ *  shifted by one of its entries. When the input is split between
+ *  processes, each process's count, mean and sum of squared
+ *  deviations are combined pairwise after one allreduce.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class variance_layer : public data_type_layer<TensorDataType>
@@ -65,7 +70,8 @@ public:
     : data_type_layer<TensorDataType>(other),
       m_biased(other.m_biased),
       m_means(other.m_means ? other.m_means->Copy() : nullptr),
-      m_workspace(other.m_workspace ? other.m_workspace->Copy() : nullptr)
+      m_workspace(other.m_workspace ? other.m_workspace->Copy() : nullptr),
+      m_partials(other.m_partials ? other.m_partials->Copy() : nullptr)
   {}
   variance_layer& operator=(const variance_layer& other)
   {
@@ -73,6 +79,7 @@ public:
     m_biased = other.m_biased;
     m_means.reset(other.m_means ? other.m_means->Copy() : nullptr);
     m_workspace.reset(other.m_workspace ? other.m_workspace->Copy() : nullptr);
+    m_partials.reset(other.m_partials ? other.m_partials->Copy() : nullptr);
     return *this;
   }
 
@@ -119,6 +126,9 @@ private:
   std::unique_ptr<AbsDistMatrixType> m_means;
   /** Workspace. */
   std::unique_ptr<AbsDistMatrixType> m_workspace;
+  /** Count, mean and sum of squared deviations of each process's
+   *  part of the input, packed for one allreduce. */
+  std::unique_ptr<AbsDistMatrixType> m_partials;
 };
 
 template <typename T, data_layout L, El::Device D>
@@ -41,6 +41,7 @@ void variance_layer<TensorDataType, Layout, Device>::setup_data(
   dist_data.colDist = El::STAR;
   m_means.reset(AbsDistMatrixType::Instantiate(dist_data));
   m_workspace.reset(AbsDistMatrixType::Instantiate(dist_data));
+  m_partials.reset(AbsDistMatrixType::Instantiate(dist_data));
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
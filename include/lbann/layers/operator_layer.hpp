@@ -41,7 +41,17 @@ namespace lbann {
 
 /** @brief Layer composed of one or more operator objects
  *
- *  Operators are applied sequentially.
+ *  Operators are applied sequentially. The first operator takes the
+ *  layer's input tensors, each following operator takes the single
+ *  output of the operator before it, and the last operator produces
+ *  the layer's output tensors. Intermediate tensors have the same
+ *  dimensions as the output tensor, so every operator after the first
+ *  should be an elementwise operator with one input and one output.
+ *
+ *  A chain avoids the per-layer overheads of one layer per operator:
+ *  intermediate tensors are not exposed as layer outputs, no split
+ *  layers or error signal copies are needed, and backprop reuses two
+ *  gradient workspaces for the whole chain.
  */
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 class OperatorLayer final : public data_type_layer<InputT, OutputT>
@@ -50,8 +60,19 @@ class OperatorLayer final : public data_type_layer<InputT, OutputT>
   using OperatorType = Operator<InputT, OutputT, D>;
   using OperatorPtr = std::unique_ptr<OperatorType>;
 
+  using MatrixPtr = std::unique_ptr<El::AbstractDistMatrix<OutputT>>;
+
   std::vector<OperatorPtr> m_ops;
 
+  /** @brief Outputs of all operators but the last
+   *  @details Saved for backprop.
+   */
+  std::vector<MatrixPtr> m_intermediate_outputs;
+  /** @brief Gradients w.r.t. intermediate outputs
+   *  @details Operators alternate between the two workspaces.
+   */
+  std::vector<MatrixPtr> m_intermediate_gradients;
+
 public:
   /** @name Lifecycle functions */
   ///@{
@@ -80,6 +101,7 @@ public:
   std::string get_type() const final;
   data_layout get_data_layout() const final;
   El::Device get_device_allocation() const final;
+  bool supports_inplace_backprop() const final;
 
   void fp_compute() final;
   void bp_compute() final;
@@ -108,6 +130,9 @@ private:
   get_grad_wrt_outputs() const;
   std::vector<utils::DistTensorView<InputT, D>> get_grad_wrt_inputs();
 
+  /** @brief Allocate intermediate tensors that match the output. */
+  void setup_intermediates(std::vector<MatrixPtr>& mats, size_t count);
+
 }; // class OperatorLayer
 
 template <typename InputT,
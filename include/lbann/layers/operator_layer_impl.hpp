@@ -35,8 +35,10 @@
 #include "lbann/utils/exception.hpp"
 
 #include "lbann/proto/layers.pb.h"
+#include <algorithm>
 #include <cereal/types/base_class.hpp>
 #include <memory>
+#include <type_traits>
 
 namespace lbann {
 
@@ -57,8 +59,14 @@ OperatorLayer<InputT, OutputT, Layout, D>::OperatorLayer(
   std::vector<OperatorPtr> operators)
   : DataTypeLayer(&comm), m_ops{std::move(operators)}
 {
-  LBANN_ASSERT(m_ops.size() == 1UL); // For starters.
-  LBANN_ASSERT(m_ops[0]);
+  LBANN_ASSERT(!m_ops.empty());
+  for (auto const& op : m_ops) {
+    LBANN_ASSERT(op);
+  }
+  if (m_ops.size() > 1UL && !std::is_same_v<InputT, OutputT>) {
+    LBANN_ERROR("operator chains require the same input and output "
+                "data type");
+  }
   this->m_expected_num_parent_layers = -1; // No limit on parents
 }
 
@@ -75,6 +83,8 @@ auto OperatorLayer<InputT, OutputT, Layout, D>::operator=(
   // This is self-assignment safe
   data_type_layer<InputT, OutputT>::operator=(other);
   m_ops = clone_ops(other.m_ops);
+  m_intermediate_outputs.clear();
+  m_intermediate_gradients.clear();
   return *this;
 }
 
@@ -103,18 +113,91 @@ OperatorLayer<InputT, OutputT, Layout, D>::get_device_allocation() const
   return D;
 }
 
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+bool OperatorLayer<InputT, OutputT, Layout, D>::supports_inplace_backprop()
+  const
+{
+  // Only the first operator writes the gradient w.r.t. the input and
+  // only the last one reads the gradient w.r.t. the output
+  using ElementwiseType = ElementwiseOperator<InputT, OutputT, D>;
+  if (m_ops.size() != 1UL) {
+    return m_ops.size() > 1UL;
+  }
+  return dynamic_cast<ElementwiseType const*>(m_ops.front().get()) != nullptr;
+}
+
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::fp_compute()
 {
-  return m_ops[0]->fp_compute(this->get_inputs(), this->get_outputs());
+  const size_t num_ops = m_ops.size();
+  if (num_ops == 1UL) {
+    return m_ops[0]->fp_compute(this->get_inputs(), this->get_outputs());
+  }
+  if constexpr (std::is_same_v<InputT, OutputT>) {
+    using ConstTensorType = utils::ConstDistTensorView<InputT, D>;
+    using TensorType = utils::DistTensorView<OutputT, D>;
+    setup_intermediates(m_intermediate_outputs, num_ops - 1);
+    const auto& dims = this->get_output_dims();
+    auto view = [&dims](auto& mat) {
+      return std::vector<TensorType>{
+        TensorType(mat, splice_dims(mat.Width(), dims))};
+    };
+    auto const_view = [&dims](const auto& mat) {
+      return std::vector<ConstTensorType>{
+        ConstTensorType(mat, splice_dims(mat.Width(), dims))};
+    };
+
+    m_ops[0]->fp_compute(this->get_inputs(), view(*m_intermediate_outputs[0]));
+    for (size_t i = 1; i < num_ops - 1; ++i) {
+      m_ops[i]->fp_compute(const_view(*m_intermediate_outputs[i - 1]),
+                           view(*m_intermediate_outputs[i]));
+    }
+    m_ops.back()->fp_compute(const_view(*m_intermediate_outputs.back()),
+                             this->get_outputs());
+  }
 }
 
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
 void OperatorLayer<InputT, OutputT, Layout, D>::bp_compute()
 {
-  return m_ops[0]->bp_compute(this->get_inputs(),
-                              this->get_grad_wrt_outputs(),
-                              this->get_grad_wrt_inputs());
+  const size_t num_ops = m_ops.size();
+  if (num_ops == 1UL) {
+    return m_ops[0]->bp_compute(this->get_inputs(),
+                                this->get_grad_wrt_outputs(),
+                                this->get_grad_wrt_inputs());
+  }
+  if constexpr (std::is_same_v<InputT, OutputT>) {
+    using ConstTensorType = utils::ConstDistTensorView<InputT, D>;
+    using TensorType = utils::DistTensorView<OutputT, D>;
+    setup_intermediates(m_intermediate_gradients,
+                        std::min<size_t>(num_ops - 1, 2));
+    const auto& dims = this->get_output_dims();
+    auto view = [&dims](auto& mat) {
+      return std::vector<TensorType>{
+        TensorType(mat, splice_dims(mat.Width(), dims))};
+    };
+    auto const_view = [&dims](const auto& mat) {
+      return std::vector<ConstTensorType>{
+        ConstTensorType(mat, splice_dims(mat.Width(), dims))};
+    };
+
+    // Gradient w.r.t. the output of operator i is stored in
+    // workspace i % 2
+    auto grad = [this](size_t i) -> auto& {
+      return *m_intermediate_gradients[i % 2];
+    };
+    m_ops.back()->bp_compute(const_view(*m_intermediate_outputs.back()),
+                             this->get_grad_wrt_outputs(),
+                             view(grad(num_ops - 2)));
+    for (size_t i = num_ops - 2; i > 0; --i) {
+      m_ops[i]->bp_compute(const_view(*m_intermediate_outputs[i - 1]),
+                           const_view(grad(i)),
+                           view(grad(i - 1)));
+    }
+    m_ops[0]->bp_compute(this->get_inputs(),
+                         const_view(grad(0)),
+                         this->get_grad_wrt_inputs());
+  }
 }
 
 template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
@@ -159,6 +242,23 @@ OperatorLayer<InputT, OutputT, Layout, D>::fix_type(std::vector<int> const& in)
   return std::vector<size_t>{cbegin(in), cend(in)};
 }
 
+template <typename InputT, typename OutputT, data_layout Layout, El::Device D>
+void OperatorLayer<InputT, OutputT, Layout, D>::setup_intermediates(
+  std::vector<MatrixPtr>& mats,
+  size_t count)
+{
+  const auto& output = this->get_activations();
+  mats.resize(count);
+  for (auto& mat : mats) {
+    if (mat == nullptr) {
+      mat.reset(output.Construct(output.Grid(), output.Root()));
+    }
+    mat->Empty(false);
+    mat->AlignWith(output);
+    mat->Resize(output.Height(), output.Width());
+  }
+}
+
 // WARNING: The next 4 functions all assume the minibatch dim is the
 // width of the matrix.
 
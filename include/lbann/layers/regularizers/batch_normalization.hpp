@@ -136,6 +136,11 @@ private:
    *  is local. If it is 0, statistics are aggregated globally.
    */
   int m_statistics_group_size;
+  /** @brief Whether tensors are stored channels-last.
+   *  @details The channel index varies fastest in memory (e.g. NHWC
+   *  rather than NCHW).
+   */
+  bool m_channels_last;
   /**
    * Cache of node-local num_per_sum results for node-local stats.
    * Indexed by effective mini-batch size.
@@ -173,14 +178,18 @@ public:
    *  @param epsilon A small number to avoid division by zero.
    *  @param statistics_group_size Number of processors to aggregate
    *         statistics over. Defaults to 1 (i.e. local aggregation).
+   *  @param channels_last Whether tensors are stored with the channel
+   *         index varying fastest.
    */
   batch_normalization_layer(TensorDataType decay = 0.9,
                             TensorDataType epsilon = 1e-5,
-                            int statistics_group_size = 1)
+                            int statistics_group_size = 1,
+                            bool channels_last = false)
     : data_type_layer<TensorDataType>(nullptr),
       m_decay(decay),
       m_epsilon(epsilon),
-      m_statistics_group_size(statistics_group_size)
+      m_statistics_group_size(statistics_group_size),
+      m_channels_last(channels_last)
   {
 #ifdef LBANN_DETERMINISTIC
     // Force global computation.
@@ -193,6 +202,7 @@ public:
       m_decay(other.m_decay),
       m_epsilon(other.m_epsilon),
       m_statistics_group_size(other.m_statistics_group_size),
+      m_channels_last(other.m_channels_last),
       m_num_per_sum_cache(other.m_num_per_sum_cache),
       m_mean_and_var(other.m_mean_and_var ? other.m_mean_and_var->Copy()
                                           : nullptr),
@@ -217,6 +227,7 @@ public:
     m_decay = other.m_decay;
     m_epsilon = other.m_epsilon;
     m_statistics_group_size = other.m_statistics_group_size;
+    m_channels_last = other.m_channels_last;
     m_num_per_sum_cache = other.m_num_per_sum_cache;
 
     // Deep copy matrices
@@ -246,6 +257,12 @@ public:
   std::string get_type() const override { return "batch normalization"; }
   data_layout get_data_layout() const override { return T_layout; }
   El::Device get_device_allocation() const override { return Dev; }
+  bool supports_fused_relu() const override { return true; }
+
+  /** scale = gamma / sqrt(running variance + epsilon) and
+   *  shift = beta - running mean * scale. */
+  bool get_inference_affine(std::vector<double>& scale,
+                            std::vector<double>& shift) const override;
 
   description get_description() const override
   {
@@ -253,6 +270,7 @@ public:
     desc.add("Decay", m_decay);
     desc.add("Epsilon", m_epsilon);
     desc.add("Statistics group size", m_statistics_group_size);
+    desc.add("Channels last", m_channels_last);
     return desc;
   }
 
@@ -437,7 +455,8 @@ protected:
 protected:
   bool is_distconv_supported() const override
   {
-    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL;
+    return Dev == El::Device::GPU && T_layout == data_layout::DATA_PARALLEL &&
+           !m_channels_last;
   }
   void setup_distconv_adapter(const DataReaderMetaData& dr_metadata) override
   {
@@ -28,6 +28,10 @@
 #define LBANN_LAYER_REGULARIZER_BATCH_NORMALIZATION_IMPL_HPP_INCLUDED
 
 #include "lbann/layers/regularizers/batch_normalization.hpp"
+#include "lbann/weights/weights_helpers.hpp"
+
+#include <cmath>
+#include <type_traits>
 
 #ifdef LBANN_HAS_DISTCONV
 #include "lbann/layers/data_type_distconv_adapter.hpp"
@@ -44,6 +48,42 @@ void batch_normalization_layer<T, L, D>::write_specific_proto(
   msg->set_decay(m_decay);
   msg->set_epsilon(m_epsilon);
   msg->set_statistics_group_size(m_statistics_group_size);
+  msg->set_channels_last(m_channels_last);
+}
+
+template <typename T, data_layout L, El::Device D>
+bool batch_normalization_layer<T, L, D>::get_inference_affine(
+  std::vector<double>& scale,
+  std::vector<double>& shift) const
+{
+  if constexpr (!std::is_floating_point_v<T>) {
+    return false;
+  }
+  else {
+    // Channels-last tensors do not match the channel order of the
+    // weights of the producing layer
+    if (m_channels_last || this->num_weights() != 4) {
+      return false;
+    }
+    for (size_t i = 0; i < 4; ++i) {
+      if (!this->has_weights(i) || !this->get_weights(i).has_values()) {
+        return false;
+      }
+    }
+    using weights_details::replicated_values;
+    const auto gamma = replicated_values<T>(this->get_weights(0));
+    const auto beta = replicated_values<T>(this->get_weights(1));
+    const auto mean = replicated_values<T>(this->get_weights(2));
+    const auto var = replicated_values<T>(this->get_weights(3));
+    const El::Int num_channels = gamma.Height();
+    scale.resize(num_channels);
+    shift.resize(num_channels);
+    for (El::Int c = 0; c < num_channels; ++c) {
+      scale[c] = gamma(c, 0) / std::sqrt(double(var(c, 0)) + m_epsilon);
+      shift[c] = beta(c, 0) - mean(c, 0) * scale[c];
+    }
+    return true;
+  }
 }
 
 #ifdef LBANN_HAS_DISTCONV
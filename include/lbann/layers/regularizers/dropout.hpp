@@ -28,11 +28,7 @@
 #define LBANN_LAYER_REGULARIZER_DROPOUT_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
-#ifdef LBANN_HAS_DNN_LIB
-#include "lbann/utils/dnn_lib/dropout.hpp"
-#include "lbann/utils/dnn_lib/helpers.hpp"
-#endif // LBANN_HAS_DNN_LIB
-#include "lbann/utils/random_number_generators.hpp"
+#include "lbann/utils/random.hpp"
 
 namespace lbann {
 
@@ -62,52 +58,9 @@ public:
 public:
   /** Keep units with probabiliy keep_prob. */
   dropout(EvalType keep_prob = EvalType(0.5))
-    : data_type_layer<TensorDataType>(nullptr),
-      m_keep_prob(keep_prob)
-#ifdef LBANN_HAS_DNN_LIB
-      ,
-      m_tensors_dnn_desc(this)
-#endif // LBANN_HAS_DNN_LIB
+    : data_type_layer<TensorDataType>(nullptr), m_keep_prob(keep_prob)
   {}
 
-  dropout(const dropout& other)
-    : data_type_layer<TensorDataType>(other),
-      m_keep_prob(other.m_keep_prob),
-      m_mask(other.m_mask ? other.m_mask->Copy() : nullptr)
-#ifdef LBANN_HAS_DNN_LIB
-      ,
-      m_tensors_dnn_desc(other.m_tensors_dnn_desc)
-#endif // LBANN_HAS_DNN_LIB
-  {
-#ifdef LBANN_HAS_DNN_LIB
-    m_tensors_dnn_desc.set_layer(this);
-    m_states = other.m_states;
-    m_reserve_space = other.m_reserve_space;
-    if (other.m_dropout_dnn_desc != nullptr) {
-      setup_dropout_dnn_desc();
-    }
-#endif // LBANN_HAS_DNN_LIB
-  }
-
-  dropout& operator=(const dropout& other)
-  {
-    data_type_layer<TensorDataType>::operator=(other);
-    m_keep_prob = other.m_keep_prob;
-    m_mask = other.m_mask
-               ? std::unique_ptr<AbsDistMatrixType>(other.m_mask->Copy())
-               : nullptr;
-#ifdef LBANN_HAS_DNN_LIB
-    m_tensors_dnn_desc = other.m_tensors_dnn_desc;
-    m_tensors_dnn_desc.set_layer(this);
-    m_states = other.m_states;
-    m_reserve_space = other.m_reserve_space;
-    if (other.m_dropout_dnn_desc != nullptr) {
-      setup_dropout_dnn_desc();
-    }
-#endif // LBANN_HAS_DNN_LIB
-    return *this;
-  }
-
   ~dropout() override = default;
 
   dropout* copy() const override { return new dropout(*this); }
@@ -147,98 +100,23 @@ protected:
   void setup_data(size_t max_mini_batch_size) override
   {
     data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
-    m_mask = std::unique_ptr<AbsDistMatrixType>(this->get_activations().Copy());
-  }
-
-  void setup_gpu() override
-  {
-    data_type_layer<TensorDataType>::setup_gpu();
-#ifndef LBANN_HAS_DNN_LIB
-    LBANN_ERROR("DNN library not detected");
-#else
-
-#ifdef LBANN_DETERMINISTIC
-    /// @todo GPU implementation of dropout with sequential consistency
-    if (this->get_comm()->am_trainer_master()) {
-      LBANN_WARNING(this->get_type(),
-                    " layer \"",
-                    this->get_name(),
-                    "\" ",
-                    "does not guarantee sequential consistency");
-    }
-#endif // LBANN_DETERMINISTIC
-
-    // Initialize DNN library objects
-    setup_dropout_dnn_desc();
-
-#endif // LBANN_HAS_DNN_LIB
-  }
-
-  void fp_compute() override
-  {
-    if (this->using_gpus()) {
-      fp_compute_gpu();
-    }
-    else {
-      fp_compute_cpu();
-    }
+    m_seed = draw_philox_seed(*this->get_comm());
   }
 
-  void bp_compute() override
-  {
-    if (this->using_gpus()) {
-      bp_compute_gpu();
-    }
-    else {
-      bp_compute_cpu();
-    }
-  }
-
-private:
-  void fp_compute_cpu();
+  void fp_compute() override;
 
   /** Adjust gradients for dropout in backprop. */
-  void bp_compute_cpu();
-
-  void fp_compute_gpu();
-
-  void bp_compute_gpu();
-
-#ifdef LBANN_HAS_DNN_LIB
-  /** Setup DNN library dropout descriptor and RNG state.
-   */
-  void setup_dropout_dnn_desc()
-  {
-
-    // Setup RNG state
-    size_t size = dnn_lib::get_dropout_states_size();
-    m_states.Resize((size + sizeof(TensorDataType) - 1) /
-                      sizeof(TensorDataType),
-                    1);
-
-    // Setup dropout descriptor
-    m_dropout_dnn_desc.set(float(1 - m_keep_prob),
-                           m_states.Buffer(),
-                           m_states.Height() * sizeof(TensorDataType),
-                           get_generator()());
-  }
-#endif // LBANN_HAS_DNN_LIB
+  void bp_compute() override;
 
+private:
   /** Probability of keeping each unit. */
   EvalType m_keep_prob;
-  /** Current dropout mask (a scaled Bernoulli random matrix). */
-  std::unique_ptr<AbsDistMatrixType> m_mask;
-
-#ifdef LBANN_HAS_DNN_LIB
-  /** Dropout DNN library descriptor. */
-  dnn_lib::DropoutDescriptor m_dropout_dnn_desc;
-  /** Tensor DNN library descriptors. */
-  dnn_lib::entrywise_layer_tensor_manager<TensorDataType> m_tensors_dnn_desc;
-  /** RNG state for DNN library dropout. */
-  El::Matrix<TensorDataType, El::Device::GPU> m_states;
-  /** Work space for DNN library dropout. */
-  El::Matrix<TensorDataType, El::Device::GPU> m_reserve_space;
-#endif // LBANN_HAS_DNN_LIB
+  /** Seed of the counter-based random stream.
+   *
+   *  The mask of a step is drawn from this stream in forward prop and
+   *  drawn again in backprop, so it is never stored.
+   */
+  uint64_t m_seed = 0;
 };
 
 template <typename T, data_layout L, El::Device D>
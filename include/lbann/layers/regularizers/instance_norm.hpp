@@ -90,7 +90,11 @@ private:
   /** Small number to avoid division by zero. */
   TensorDataType m_epsilon;
 
-  /** Contains per-channel sums and sums of squares. */
+  /** Contains per-channel sums and sums of squares.
+   *
+   *  Only used on CPU. The GPU kernels compute the statistics on the
+   *  fly.
+   */
   El::Matrix<TensorDataType, Device> m_workspace;
 };
 
@@ -48,6 +48,8 @@ namespace lbann {
  *  like in the paper. Use the entry-wise scale/bias layer to
  *  reproduce that functionality.
  *
+ *  If the parallel strategy splits sequences, the shards of a
+ *  sequence are normalized together.
  */
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 class layer_norm_layer : public data_type_layer<TensorDataType>
@@ -102,7 +104,8 @@ private:
 
   /** @brief Per-sample statistics.
    *
-   *  The means and variances are fused for performance.
+   *  The means and variances are fused for performance. Not used
+   *  on GPU if samples are not split between ranks.
    */
   std::unique_ptr<AbsDistMatType> m_statistics;
   /** @brief Gradients w.r.t. per-sample statistics.
@@ -205,6 +208,13 @@ void layer_norm_layer<TensorDataType, Layout, Device>::setup_data(
   size_t max_mini_batch_size)
 {
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+  if (this->get_sequence_comm() != nullptr &&
+      Layout != data_layout::DATA_PARALLEL) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" splits sequences, which requires a data-parallel layout");
+  }
   auto dist = this->get_prev_activations().DistData();
   dist.colDist = El::STAR;
   m_statistics.reset(AbsDistMatrixType::Instantiate(dist));
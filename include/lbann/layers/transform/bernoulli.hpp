@@ -83,11 +83,19 @@ protected:
   friend class cereal::access;
   bernoulli_layer() : bernoulli_layer(nullptr, {1}, 0.5) {}
 
+  void setup_data(size_t max_mini_batch_size) override
+  {
+    data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+    m_seed = draw_philox_seed(*this->get_comm());
+  }
+
   void fp_compute() override;
 
 private:
   /** Probability of outputting 1. */
   ProbabilityType m_prob;
+  /** Seed of the counter-based random stream. */
+  uint64_t m_seed = 0;
 };
 
 #ifndef LBANN_BERNOULLI_LAYER_INSTANTIATE
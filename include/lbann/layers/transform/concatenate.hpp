@@ -88,6 +88,19 @@ public:
 
   description get_description() const override;
 
+  /** @brief Let parents write their outputs into the output tensor.
+   *
+   *  This only applies to data-parallel layers where each input is
+   *  contiguous within an output sample, i.e. all dimensions before
+   *  the concatenation dimension are 1. The copy in forward prop is
+   *  skipped when every input is already in place.
+   */
+  void set_view_inputs(bool view_inputs) { m_view_inputs = view_inputs; }
+
+  BaseDistMat* get_parent_output_buffer(const Layer& parent,
+                                        El::Int mini_batch_size,
+                                        El::Range<El::Int>& rows) override;
+
 protected:
   /** Add layer specific data to prototext */
   void write_specific_proto(lbann_data::Layer& proto) const final;
@@ -109,6 +122,17 @@ private:
   /** @brief Tensor dimension to concatenate along. */
   size_t m_concat_dim;
 
+  /** @brief Whether parents may write into the output tensor. */
+  bool m_view_inputs = false;
+  /** @brief Whether parents can write into the output tensor. */
+  bool m_can_view_inputs = false;
+  /** @brief Whether a parent allocated the output tensor for the
+   *         current forward prop. */
+  bool m_output_allocated = false;
+
+  /** @brief Whether every input is a view into the output tensor. */
+  bool inputs_in_place() const;
+
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
    *
@@ -303,6 +327,55 @@ void concatenate_layer<TensorDataType, Layout, Device>::setup_dims(
   this->set_output_dims(output_dims);
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+BaseDistMat*
+concatenate_layer<TensorDataType, Layout, Device>::get_parent_output_buffer(
+  const Layer& parent,
+  El::Int mini_batch_size,
+  El::Range<El::Int>& rows)
+{
+  const auto parents = this->get_parent_layers();
+  if (!m_can_view_inputs ||
+      std::count(parents.begin(), parents.end(), &parent) != 1) {
+    return nullptr;
+  }
+
+  // Allocate the output tensor when the first parent asks for it
+  auto& output = this->get_activations();
+  if (!m_output_allocated) {
+    output.Empty(false);
+    output.Resize(this->get_output_size(), mini_batch_size);
+    m_output_allocated = true;
+  }
+
+  const size_t index = this->find_parent_layer_index(parent);
+  El::Int offset = 0;
+  for (size_t j = 0; j < index; ++j) {
+    offset += this->get_input_size(j);
+  }
+  rows = El::IR(offset, offset + this->get_input_size(index));
+  return &output;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool concatenate_layer<TensorDataType, Layout, Device>::inputs_in_place() const
+{
+  if (!m_can_view_inputs) {
+    return false;
+  }
+  const auto& local_output = this->get_activations().LockedMatrix();
+  El::Int offset = 0;
+  for (int j = 0; j < this->get_num_parents(); ++j) {
+    const auto& local_input = this->get_prev_activations(j).LockedMatrix();
+    if (local_input.LockedBuffer() != local_output.LockedBuffer(offset, 0) ||
+        local_input.LDim() != local_output.LDim()) {
+      return false;
+    }
+    offset += local_input.Height();
+  }
+  return true;
+}
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void concatenate_layer<TensorDataType, Layout, Device>::fp_setup_outputs(
   El::Int mini_batch_size)
@@ -313,6 +386,25 @@ void concatenate_layer<TensorDataType, Layout, Device>::fp_setup_outputs(
 #endif // LBANN_HAS_DISTCONV
   const auto& input0 = this->get_prev_activations(0);
   auto& output = this->get_activations();
+
+  // Parents can write into the output tensor once it is set up
+  const auto& output_dims = this->get_output_dims();
+  m_can_view_inputs =
+    (m_view_inputs && Layout == data_layout::DATA_PARALLEL &&
+     this->get_num_parents() > 1 &&
+     get_linear_size(m_concat_dim, output_dims.data()) <= 1 &&
+     !(this->is_subgraph_parallelism_enabled() &&
+       this->get_parallel_strategy().enable_subgraph));
+#ifdef LBANN_HAS_DISTCONV
+  m_can_view_inputs = m_can_view_inputs && !this->distconv_enabled();
+#endif // LBANN_HAS_DISTCONV
+  if (m_output_allocated) {
+    m_output_allocated = false;
+    if (output.Width() == mini_batch_size) {
+      return;
+    }
+  }
+
   output.Empty(false);
   if (this->get_num_parents() == 1) {
     El::LockedView(output, input0);
@@ -411,6 +503,11 @@ void concatenate_layer<TensorDataType, Layout, Device>::fp_compute()
     return;
   }
 
+  // Nothing to do if the parents wrote into the output tensor
+  if (inputs_in_place()) {
+    return;
+  }
+
   // Perform concatenation
   if (m_concat_dim == num_dims - 1 && this->is_subgraph_parallelism_enabled() &&
       this->get_parallel_strategy().enable_subgraph == true) {
@@ -115,26 +115,8 @@ private:
     auto& input = this->get_prev_activations(rank);
     El::Copy(input, output);
 
-    auto* const output_cast = dynamic_cast<
-      El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>*>(
-      &output);
-
-    auto const syncInfoOutput =
-      El::SyncInfoFromMatrix(output_cast->LockedMatrix());
-
-    const El::Int mloc = output_cast->LocalHeight();
-    const El::Int nloc = output_cast->LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> temp_output(mloc, nloc);
-
-    El::Copy(output_cast->LockedMatrix(), temp_output);
-
-    El::mpi::AllReduce(temp_output.Buffer(),
-                       output_cast->Buffer(),
-                       mloc * nloc,
-                       El::mpi::SUM,
-                       this->get_subgrid_comm(),
-                       syncInfoOutput);
+    // In-place, so the branches' buffers are reduced directly
+    El::AllReduce(output.Matrix(), this->get_subgrid_comm(), El::mpi::SUM);
   }
 
   void fp_setup_outputs(El::Int mini_batch_size) final
@@ -159,19 +141,9 @@ private:
     const auto& gradient_wrt_output = this->get_prev_error_signals(rank);
     auto& gradient_wrt_input = this->get_error_signals(rank);
     El::Copy(gradient_wrt_output, gradient_wrt_input);
-
-    auto* const gradient_wrt_input_cast = dynamic_cast<
-      El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>*>(
-      &gradient_wrt_input);
-
-    const El::Int mloc = gradient_wrt_input_cast->LocalHeight();
-    const El::Int nloc = gradient_wrt_input_cast->LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> temp_output(mloc, nloc);
-
-    El::Copy(gradient_wrt_input_cast->LockedMatrix(), temp_output);
-
-    El::AllReduce(gradient_wrt_input, this->get_subgrid_comm(), El::mpi::SUM);
+    El::AllReduce(gradient_wrt_input.Matrix(),
+                  this->get_subgrid_comm(),
+                  El::mpi::SUM);
   }
 
   void bp_compute() final {}
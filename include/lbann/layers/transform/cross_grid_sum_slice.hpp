@@ -58,7 +58,13 @@ protected:
   /** Add layer specific data to prototext */
   void write_specific_proto(lbann_data::Layer& proto) const final;
 
-  El::SyncInfo<Dev> syncSubGridCommunication = El::SyncInfo<Dev>();
+  /** Length of the last input dimension. */
+  int m_last_dim = 0;
+  /** Length of the slice of the last dimension in each branch. */
+  int m_slice_size = 0;
+  /** The slices of every branch, packed in contiguous blocks so they
+   *  are reduced and gathered in place. */
+  El::Matrix<TensorDataType, Dev> m_workspace;
 
   void setup_pointers() override
   {
@@ -78,13 +84,37 @@ protected:
     // Slice along last dimension
     int subgridCommSize = El::mpi::Size(this->get_subgrid_comm());
     const auto input_dims = this->get_input_dims();
+    m_last_dim = input_dims.back();
+    if (m_last_dim % subgridCommSize != 0) {
+      LBANN_ERROR("cross_grid_sum_slice layer: last dimension should be "
+                  "divided by the number of branches in subgraph");
+    }
+    m_slice_size = m_last_dim / subgridCommSize;
     std::vector<int> output_dims_slice(input_dims);
-    output_dims_slice.back() = int(output_dims_slice.back() / subgridCommSize);
+    output_dims_slice.back() = m_slice_size;
 
     for (int i = 0; i < this->get_num_children(); ++i)
       this->set_output_dims(output_dims_slice, i);
   }
 
+  /** Rows of the last dimension in a local matrix. */
+  El::Int get_num_rows(El::AbstractMatrix<TensorDataType> const& mat) const
+  {
+    return mat.Width() * (mat.Height() / m_last_dim);
+  }
+
+  /** Buffer of mat, copied to tmp if its columns are not contiguous. */
+  static TensorDataType const*
+  get_contiguous_buffer(El::AbstractMatrix<TensorDataType> const& mat,
+                        El::Matrix<TensorDataType, Dev>& tmp)
+  {
+    if (mat.Width() > 1 && mat.LDim() != mat.Height()) {
+      El::Copy(mat, tmp);
+      return tmp.LockedBuffer();
+    }
+    return mat.LockedBuffer();
+  }
+
   void fp_compute() override
   {
     auto const subgrid_comm_rank = El::mpi::Rank(this->get_subgrid_comm());
@@ -92,55 +122,35 @@ protected:
 
     auto& output = this->get_activations(subgrid_comm_rank);
     auto& input = this->get_prev_activations(subgrid_comm_rank);
-    // El::Copy(input, output);
-
-    auto* const output_cast = dynamic_cast<
-      El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>*>(
-      &output);
-
-    auto const sync_info_output =
-      El::SyncInfoFromMatrix(output_cast->LockedMatrix());
-
-    const El::Int mloc = input.LocalHeight();
-    const El::Int nloc = input.LocalWidth();
-
-    El::Matrix<TensorDataType, Dev> prev_allreduce(mloc, nloc),
-      after_allreduce(mloc, nloc);
-
-    El::Copy(input.LockedMatrix(), prev_allreduce);
-
-    El::mpi::AllReduce(prev_allreduce.Buffer(),
-                       after_allreduce.Buffer(),
-                       mloc * nloc,
-                       El::mpi::SUM,
-                       this->get_subgrid_comm(),
-                       sync_info_output);
-
-    const auto input_dims = this->get_input_dims();
-    int last_dim = input_dims.back();
-
-    int last_dim_start_point = 1;
-    for (int i = 0; i < int(input_dims.size()) - 1; ++i) {
-      last_dim_start_point = last_dim_start_point * input_dims[i];
+    auto& local_output = output.Matrix();
+    auto const sync_info_output = El::SyncInfoFromMatrix(local_output);
+
+    El::Matrix<TensorDataType, Dev> tmp;
+    auto const* const input_buffer =
+      get_contiguous_buffer(input.LockedMatrix(), tmp);
+    const El::Int num_rows = get_num_rows(input.LockedMatrix());
+    const El::Int block_size = num_rows * m_slice_size;
+
+    // Pack the slice of each branch, then reduce every slice onto
+    // its branch
+    m_workspace.Resize(block_size, subgrid_comm_size);
+    for (int i = 0; i < subgrid_comm_size; ++i) {
+      El::copy::util::InterleaveMatrix(m_slice_size,
+                                       num_rows,
+                                       input_buffer + i * m_slice_size,
+                                       1,
+                                       m_last_dim,
+                                       m_workspace.Buffer(0, i),
+                                       1,
+                                       m_slice_size,
+                                       sync_info_output);
     }
-
-    if (last_dim % subgrid_comm_size != 0)
-      LBANN_ERROR("cross_grid_sum_slice layer: last dimension should be "
-                  "divided by the number of branches in subgraph");
-
-    int const last_dim_index =
-      int(last_dim / subgrid_comm_size) * subgrid_comm_rank;
-
-    El::copy::util::InterleaveMatrix(
-      (last_dim / subgrid_comm_size),
-      input.LocalWidth() * last_dim_start_point,
-      after_allreduce.LockedBuffer(last_dim_index, 0),
-      1,
-      last_dim,
-      output_cast->Buffer(),
-      1,
-      (last_dim / subgrid_comm_size),
-      sync_info_output);
+    El::mpi::ReduceScatter(m_workspace.LockedBuffer(),
+                           local_output.Buffer(),
+                           block_size,
+                           El::mpi::SUM,
+                           this->get_subgrid_comm(),
+                           sync_info_output);
   }
 
   void fp_setup_outputs(El::Int mini_batch_size) override
@@ -163,47 +173,40 @@ protected:
   {
     auto const subgrid_comm_rank = El::mpi::Rank(this->get_subgrid_comm());
     auto const subgrid_comm_size = El::mpi::Size(this->get_subgrid_comm());
-    const auto input_dims = this->get_input_dims();
-    int last_dim = input_dims.back();
 
     auto& input_grad = this->get_error_signals(subgrid_comm_rank);
     const auto& gradient_wrt_output =
       this->get_prev_error_signals(subgrid_comm_rank);
-
-    using MatrixType =
-      El::DistMatrix<TensorDataType, El::STAR, El::VC, El::ELEMENT, Dev>;
-    auto const* const gradient_wrt_output_cast =
-      dynamic_cast<const MatrixType*>(&gradient_wrt_output);
-
-    auto* const gradient_wrt_input_cast =
-      dynamic_cast<MatrixType*>(&input_grad);
-
-    int mloc = gradient_wrt_output_cast->LocalHeight();
-    int nloc = gradient_wrt_output_cast->LocalWidth();
-    int per_grid_last_dim = last_dim / subgrid_comm_size;
-
-    El::Matrix<TensorDataType, Dev> temp_input(nloc, mloc),
-      temp_output(nloc * (mloc / per_grid_last_dim), last_dim),
-      transposed(nloc * (mloc / per_grid_last_dim), per_grid_last_dim),
-      transposed_output(last_dim, nloc * (mloc / per_grid_last_dim));
-
-    El::Copy(gradient_wrt_output_cast->LockedMatrix(), temp_input);
-    temp_input.Resize(per_grid_last_dim, nloc * (mloc / per_grid_last_dim));
-
-    El::Transpose(temp_input, transposed);
-
-    El::mpi::AllGather(transposed.Buffer(),
-                       mloc * nloc,
-                       temp_output.Buffer(),
-                       mloc * nloc,
+    input_grad.Resize(this->get_input_size(), mini_batch_size);
+    auto& local_input_grad = input_grad.Matrix();
+    auto const sync_info = El::SyncInfoFromMatrix(local_input_grad);
+
+    El::Matrix<TensorDataType, Dev> tmp;
+    auto const* const output_grad_buffer =
+      get_contiguous_buffer(gradient_wrt_output.LockedMatrix(), tmp);
+    const El::Int num_rows = get_num_rows(local_input_grad);
+    const El::Int block_size = num_rows * m_slice_size;
+
+    // Gather the slice of each branch, then unpack the slices
+    m_workspace.Resize(block_size, subgrid_comm_size);
+    El::mpi::AllGather(output_grad_buffer,
+                       block_size,
+                       m_workspace.Buffer(),
+                       block_size,
                        this->get_subgrid_comm(),
-                       syncSubGridCommunication);
-
-    El::Transpose(temp_output, transposed_output);
-    transposed_output.Resize(mloc * subgrid_comm_size, nloc);
-
-    gradient_wrt_input_cast->Resize(this->get_input_size(), mini_batch_size);
-    El::Copy(transposed_output, gradient_wrt_input_cast->Matrix());
+                       sync_info);
+    for (int i = 0; i < subgrid_comm_size; ++i) {
+      El::copy::util::InterleaveMatrix(m_slice_size,
+                                       num_rows,
+                                       m_workspace.LockedBuffer(0, i),
+                                       1,
+                                       m_slice_size,
+                                       local_input_grad.Buffer() +
+                                         i * m_slice_size,
+                                       1,
+                                       m_last_dim,
+                                       sync_info);
+    }
   }
 
   void bp_compute() final {}
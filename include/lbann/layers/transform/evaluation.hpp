@@ -29,8 +29,84 @@
 
 #include "lbann/layers/data_type_layer.hpp"
 
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
 namespace lbann {
 
+/** @brief Reduces the values of a model's evaluation layers together.
+ *
+ *  Each evaluation layer gets a slot in a packed buffer for its
+ *  device and process communicator. In forward prop a layer writes
+ *  the local mean of its input to its slot, and at the end of
+ *  forward prop each buffer is allreduced with one non-blocking
+ *  collective. A model with many loss and metric terms then does one
+ *  small allreduce per step instead of one per term.
+ */
+class evaluation_reducer
+{
+public:
+  /** Position of a value in a packed buffer. */
+  struct slot
+  {
+    size_t group = 0;
+    El::Int row = -1;
+  };
+
+  evaluation_reducer(lbann_comm& comm) : m_comm{comm} {}
+  evaluation_reducer(const evaluation_reducer&) = delete;
+  evaluation_reducer& operator=(const evaluation_reducer&) = delete;
+
+  /** Add a slot for a value that is reduced over @c comm. */
+  slot add_slot(El::Device device, const El::mpi::Comm& comm);
+
+  /** Set the local contribution to a value. */
+  void set_local_value(const slot& s, EvalType value);
+  /** Reduced value. Starts the reduction if needed and waits for it. */
+  EvalType get_value(const slot& s);
+#ifdef LBANN_HAS_GPU
+  /** Set the local contribution to a value from a 1x1 matrix. */
+  void set_local_value(const slot& s,
+                       const El::Matrix<EvalType, El::Device::GPU>& value);
+  /** Copy a reduced value to a 1x1 matrix.
+   *  Starts the reduction if needed. This does not synchronize with
+   *  the device.
+   */
+  void get_value(const slot& s, El::Matrix<EvalType, El::Device::GPU>& value);
+#endif // LBANN_HAS_GPU
+
+  /** Start reducing the values set since the last reduction. */
+  void start();
+
+private:
+  struct group
+  {
+    El::Device device;
+    const El::mpi::Comm* comm;
+    /** Values. Stored in pinned memory if the group is on a GPU. */
+    El::Matrix<EvalType, El::Device::CPU> values;
+    Al::request req;
+#ifdef LBANN_HAS_GPU
+    El::Matrix<EvalType, El::Device::GPU> values_d;
+    /** Recorded after the reduced values are copied to the host. */
+    gpu_lib::event_wrapper copy_event;
+#endif // LBANN_HAS_GPU
+    /** Whether the reduction of the current values has started. */
+    bool started = false;
+    /** Whether the reduced values are in @c values. */
+    bool done = false;
+  };
+
+  void start(group& g);
+  void wait(group& g);
+
+  lbann_comm& m_comm;
+  std::vector<std::unique_ptr<group>> m_groups;
+  std::map<std::pair<El::Device, const El::mpi::Comm*>, size_t> m_group_ids;
+};
+
 /** @brief Interface with objective function and metrics */
 template <typename TensorDataType>
 class abstract_evaluation_layer : public data_type_layer<TensorDataType>
@@ -48,9 +124,37 @@ public:
   EvalType get_scale() const { return m_scale; }
   /** Set scaling factor. */
   void set_scale(EvalType scale) { m_scale = scale; }
-  /** Get evaluated value. */
+  /** Get evaluated value.
+   *  The value is reduced over the layer's processes when it is
+   *  first requested. Later forward props reduce it eagerly, so it
+   *  overlaps with the rest of the step.
+   */
   EvalType get_value(bool scaled = true);
 
+  /** Reduce the evaluated value in every forward prop. */
+  void set_value_required(bool required) { m_value_required = required; }
+  /** Add the sum of the local input entries in the last forward prop
+   *  to the accumulated local sum.
+   *  This does not synchronize with the device or communicate.
+   */
+  void accumulate_local_sum();
+  /** Get and clear the accumulated local sum.
+   *  The sum is not reduced over the layer's processes, so the
+   *  caller must sum it over the trainer. This synchronizes with the
+   *  device.
+   */
+  EvalType take_accumulated_local_sum();
+#ifdef LBANN_HAS_GPU
+  /** Add the scaled value of the last forward prop, times
+   *  @c weight, to a running sum on the device.
+   *  This does not synchronize with the device.
+   *  @returns Whether the value was added. It is not if the layer is
+   *  not on a GPU or did not reduce its value in forward prop.
+   */
+  bool accumulate_value(El::Matrix<EvalType, El::Device::GPU>& sum,
+                        EvalType weight);
+#endif // LBANN_HAS_GPU
+
   /** Construct an evaluation layer.
    *  The caller is responsible for deallocating the layer.
    */
@@ -84,9 +188,34 @@ private:
   CPUMatType m_value;
   /** Non-blocking allreduce request. */
   Al::request m_allreduce_req;
+  /** Whether the evaluated value is reduced in forward prop. */
+  bool m_value_required = false;
+  /** Whether the last forward prop reduced the evaluated value. */
+  bool m_value_computed = false;
+  /** Reduction shared with the model's other evaluation layers.
+   *  Null if the layer reduces its own value.
+   */
+  evaluation_reducer* m_reducer = nullptr;
+  /** Slot of the evaluated value in @c m_reducer. */
+  evaluation_reducer::slot m_reducer_slot;
+  /** Whether the evaluated value is still in @c m_reducer. */
+  bool m_value_pending = false;
+  /** Sum of the local input entries in the last forward prop. */
+  EvalType m_local_sum = 0;
+  /** Local sums added by accumulate_local_sum. */
+  EvalType m_accumulated_local_sum = 0;
 #ifdef LBANN_HAS_GPU
   /** CUDA event after a non-blocking GPU-CPU memory copy. */
   gpu_lib::event_wrapper m_copy_event;
+  /** Sum of the local input entries in the last forward prop, on
+   *  the device. */
+  El::Matrix<EvalType, El::Device::GPU> m_local_sum_d;
+  /** Local sums added by accumulate_local_sum, on the device. */
+  El::Matrix<EvalType, El::Device::GPU> m_accumulated_local_sum_d;
+  /** Evaluated value, on the device.
+   *  Only set if the value was reduced in forward prop.
+   */
+  El::Matrix<EvalType, El::Device::GPU> m_value_d;
 #endif // LBANN_HAS_GPU
 };
 
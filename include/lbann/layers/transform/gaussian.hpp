@@ -50,6 +50,8 @@ private:
    *  evaluation.
    */
   bool m_training_only;
+  /** Seed of the counter-based random stream. */
+  uint64_t m_seed = 0;
 
 public:
   gaussian_layer(lbann_comm* comm,
@@ -95,6 +97,12 @@ protected:
   friend class cereal::access;
   gaussian_layer() : gaussian_layer(nullptr, {1}) {}
 
+  void setup_data(size_t max_mini_batch_size) override
+  {
+    data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
+    m_seed = draw_philox_seed(*this->get_comm());
+  }
+
   void fp_compute() override;
 };
 
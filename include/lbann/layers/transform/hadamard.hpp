@@ -28,12 +28,19 @@
 #define LBANN_LAYER_HADAMARD_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/utils/exception.hpp"
 #include <vector>
 
+#include "lbann/proto/layers.pb.h"
+
 namespace lbann {
 
-/** @brief Entry-wise tensor product */
+/** @brief Entry-wise tensor product
+ *
+ *  On GPU, the product and its gradients are computed in one kernel
+ *  that reads each input once.
+ */
 template <typename TensorDataType,
           data_layout T_layout = data_layout::DATA_PARALLEL,
           El::Device Dev = El::Device::CPU>
@@ -104,52 +111,19 @@ protected:
     }
   }
 
-  void fp_compute() override
-  {
-    auto& output = this->get_activations();
-    switch (this->get_num_parents()) {
-    case 0:
-      El::Fill(output, El::TypeTraits<TensorDataType>::One());
-      break;
-    case 1:
-      El::LockedView(output, this->get_prev_activations());
-      break;
-    default:
-      El::Hadamard(this->get_prev_activations(0),
-                   this->get_prev_activations(1),
-                   output);
-      for (int i = 2; i < this->get_num_parents(); ++i) {
-        El::Hadamard(this->get_prev_activations(i), output, output);
-      }
-    }
-  }
+  void fp_compute() override;
 
-  void bp_compute() override
-  {
-    const int num_parents = this->get_num_parents();
-    const auto& gradient_wrt_output = this->get_prev_error_signals();
-    switch (num_parents) {
-    case 0:
-      break;
-    case 1:
-      El::LockedView(this->get_error_signals(), gradient_wrt_output);
-      break;
-    default:
-      for (int i = 0; i < num_parents; ++i) {
-        auto& gradient_wrt_input = this->get_error_signals(i);
-        El::Copy(gradient_wrt_output, gradient_wrt_input);
-        for (int j = 0; j < num_parents; ++j) {
-          if (i != j) {
-            El::Hadamard(this->get_prev_activations(j),
-                         gradient_wrt_input,
-                         gradient_wrt_input);
-          }
-        }
-      }
-    }
-  }
+  void bp_compute() override;
 };
 
+template <typename T, data_layout L, El::Device D>
+void hadamard_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  proto.mutable_hadamard();
+}
+
 #ifndef LBANN_HADAMARD_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)                                                \
   extern template class hadamard_layer<T, data_layout::DATA_PARALLEL, Device>; \
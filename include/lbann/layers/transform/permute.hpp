@@ -43,7 +43,10 @@ namespace lbann {
  *  index must be accounted for in the permuted array.
  *
  *  The current implementation of this layer is written for
- *  CUDA. Other implementations will be added as needed.
+ *  CUDA. Other implementations will be added as needed. Permutations
+ *  that amount to a batched matrix transpose, e.g. swapping two axes
+ *  of a 2D or 3D tensor, use a tiled transpose kernel; others use the
+ *  tensor library.
  */
 template <typename T>
 class PermuteLayer final : public data_type_layer<T>
@@ -75,6 +78,7 @@ public:
   data_layout get_data_layout() const final;
   El::Device get_device_allocation() const final;
   description get_description() const final;
+  std::vector<int> get_axis_permutation() const final;
 
 protected:
   friend class cereal::access;
@@ -122,6 +122,11 @@ private:
   std::vector<int> m_pads;
   /** Pooling strides. */
   std::vector<int> m_strides;
+  /** @brief Whether tensors are stored channels-last.
+   *  @details The channel index varies fastest in memory (e.g. NHWC
+   *  rather than NCHW). Only supported with the DNN library.
+   */
+  bool m_channels_last;
 
   /** Input indices for max pooling.
    *  Each entry corresponds to a local entry in the activations
@@ -146,13 +151,15 @@ public:
                 int pool_dim,
                 int pad,
                 int stride,
-                pooling_mode mode)
+                pooling_mode mode,
+                bool channels_last = false)
     : pooling_layer(comm,
                     num_data_dims,
                     std::vector<int>(num_data_dims, pool_dim),
                     std::vector<int>(num_data_dims, pad),
                     std::vector<int>(num_data_dims, stride),
-                    mode)
+                    mode,
+                    channels_last)
   {}
 
   pooling_layer(lbann_comm* comm,
@@ -160,12 +167,14 @@ public:
                 std::vector<int> pool_dims,
                 std::vector<int> pads,
                 std::vector<int> strides,
-                pooling_mode mode)
+                pooling_mode mode,
+                bool channels_last = false)
     : data_type_layer<TensorDataType>(comm),
       m_pool_mode(mode),
       m_pool_dims(pool_dims),
       m_pads(pads),
-      m_strides(strides)
+      m_strides(strides),
+      m_channels_last(channels_last)
 #ifdef LBANN_HAS_DNN_LIB
       ,
       m_tensors_dnn_desc(this)
@@ -182,6 +191,7 @@ public:
       m_pool_size(other.m_pool_size),
       m_pads(other.m_pads),
       m_strides(other.m_strides),
+      m_channels_last(other.m_channels_last),
       m_max_pool_indices(other.m_max_pool_indices)
 #ifdef LBANN_HAS_DNN_LIB
       ,
@@ -202,6 +212,7 @@ public:
     m_pool_size = other.m_pool_size;
     m_pads = other.m_pads;
     m_strides = other.m_strides;
+    m_channels_last = other.m_channels_last;
     m_max_pool_indices = other.m_max_pool_indices;
 #ifdef LBANN_HAS_DNN_LIB
     m_pooling_dnn_desc = other.m_pooling_dnn_desc;
@@ -281,6 +292,9 @@ public:
     }
     desc.add("Pads", ss.str());
 
+    // Memory layout
+    desc.add("Channels last", m_channels_last);
+
     // Result
     return desc;
   }
@@ -303,6 +317,13 @@ protected:
       output_dims[i + 1] = (effective_dim + m_strides[i] - 1) / m_strides[i];
     }
     this->set_output_dims(output_dims);
+    if (Dev == El::Device::CPU && m_channels_last) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" stores tensors channels-last, ",
+                  "which is not yet supported on CPU");
+    }
   }
 
   /// Initialize GPU objects
@@ -320,6 +341,7 @@ protected:
                            m_pool_dims.data(),
                            m_pads.data(),
                            m_strides.data());
+    m_tensors_dnn_desc.set_channels_last(m_channels_last);
 
 #endif // #ifndef LBANN_HAS_DNN_LIB
   }
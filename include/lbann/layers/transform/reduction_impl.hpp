@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_LAYERS_TRANSFORM_REDUCTION_IMPL_HPP_INCLUDED
+#define LBANN_LAYERS_TRANSFORM_REDUCTION_IMPL_HPP_INCLUDED
+
+#include "lbann/layers/transform/reduction.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/proto/proto_common.hpp"
+
+#include "lbann/proto/layers.pb.h"
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+reduction_layer<TensorDataType, Layout, Device>::reduction_layer(
+  reduction_mode mode)
+  : data_type_layer<TensorDataType>(nullptr), m_mode(mode)
+{
+  if (mode == reduction_mode::INVALID) {
+    LBANN_ERROR("invalid reduction mode");
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+std::unique_ptr<Layer>
+build_reduction_layer_from_pbuf(lbann_comm* comm,
+                                lbann_data::Layer const& proto_layer)
+{
+  using LayerType = reduction_layer<TensorDataType, Layout, Device>;
+  LBANN_ASSERT_MSG_HAS_FIELD(proto_layer, reduction);
+  const auto& params = proto_layer.reduction();
+  const std::string mode_str = params.mode();
+  reduction_mode mode = reduction_mode::INVALID;
+  if (mode_str == "sum" || mode_str.empty()) {
+    mode = reduction_mode::SUM;
+  }
+  if (mode_str == "mean" || mode_str == "average") {
+    mode = reduction_mode::AVERAGE;
+  }
+  return std::make_unique<LayerType>(mode);
+}
+
+template <typename T, data_layout L, El::Device D>
+void reduction_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  auto* msg = proto.mutable_reduction();
+  switch (m_mode) {
+  case reduction_mode::SUM:
+    msg->set_mode("sum");
+    break;
+  case reduction_mode::AVERAGE:
+    msg->set_mode("mean");
+    break;
+  default:
+    msg->set_mode("invalid");
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void reduction_layer<TensorDataType, Layout, Device>::setup_dims(
+  DataReaderMetaData& dr_metadata)
+{
+  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
+  this->set_output_dims({1});
+}
+
+} // namespace lbann
+
+#endif // LBANN_LAYERS_TRANSFORM_REDUCTION_IMPL_HPP_INCLUDED
@@ -85,6 +85,14 @@ public:
     m_var_category = var_category;
   }
 
+  /** @brief Output views of the input tensor.
+   *
+   *  This only applies to data-parallel layers where each output is
+   *  contiguous within an input sample, i.e. all dimensions before
+   *  the slice dimension are 1. The copy in forward prop is skipped.
+   */
+  void set_view_outputs(bool view_outputs) { m_view_outputs = view_outputs; }
+
 protected:
   /** Add layer specific data to prototext */
   void write_specific_proto(lbann_data::Layer& proto) const final;
@@ -112,6 +120,10 @@ private:
   bool m_set_slice_points_from_data_reader;
   /** Category for retrieving slice points from data reader */
   slice_points_mode m_var_category;
+  /** Whether outputs may be views of the input tensor. */
+  bool m_view_outputs = false;
+  /** Whether outputs are views of the input tensor. */
+  bool m_outputs_are_views = false;
 
 #ifdef LBANN_HAS_GPU
   /** @brief Workspace buffer.
@@ -280,6 +292,12 @@ void slice_layer<TensorDataType, Layout, Device>::setup_dims(
                 "but model-parallel slice layer only supports flat data");
   }
 
+  // Outputs can be views if they are contiguous in each input sample
+  m_outputs_are_views =
+    (m_view_outputs && Layout == data_layout::DATA_PARALLEL &&
+     get_linear_size(m_slice_dim, input_dims.data()) <= 1 &&
+     !this->get_parallel_strategy().enable_subgraph);
+
   // Set output tensor dimensions
   auto output_dims = input_dims;
   for (size_t i = 0; i < num_outputs; ++i) {
@@ -316,6 +334,20 @@ void fp_setup_outputs_impl(
 
   const size_t num_outputs = l.get_num_children();
   const auto& input = l.get_prev_activations();
+  if (l.m_outputs_are_views) {
+    const auto& input_dims = l.get_input_dims();
+    const El::Int slice_size =
+      l.get_input_size() / input_dims[l.m_slice_dim];
+    for (size_t j = 0; j < num_outputs; ++j) {
+      auto& output = l.get_activations(j);
+      const El::Int offset = l.m_slice_points[j] * slice_size;
+      El::LockedView(output,
+                     input,
+                     El::IR(offset, offset + l.get_output_size(j)),
+                     El::ALL);
+    }
+    return;
+  }
   for (size_t j = 0; j < num_outputs; ++j) {
     auto& output = l.get_activations(j);
     // output.AlignWith(input);
@@ -401,6 +433,11 @@ void slice_layer<TensorDataType, Layout, Device>::fp_compute()
   const auto& input_dims = this->get_input_dims();
   const size_t num_dims = input_dims.size();
 
+  // Outputs are views of the input tensor
+  if (m_outputs_are_views) {
+    return;
+  }
+
   if (this->m_slice_dim == num_dims - 1 &&
       this->get_parallel_strategy().enable_subgraph == true) {
     fp_compute_subgrid();
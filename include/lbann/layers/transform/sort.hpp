@@ -97,6 +97,13 @@ private:
    *  in Hydrogen.
    */
   std::unique_ptr<El::AbstractMatrix<El::Int>> m_indices;
+
+  /** @name Workspaces for sorting all local columns at once (GPU) */
+  ///@{
+  El::Matrix<TensorDataType, Dev> m_sort_values;
+  El::Matrix<El::Int, Dev> m_sort_indices;
+  El::Matrix<El::Int, Dev> m_sort_columns;
+  ///@}
 };
 
 template <typename T, data_layout L, El::Device D>
@@ -29,18 +29,24 @@
 
 #include "lbann/layers/layer.hpp"
 #include "lbann/layers/transform/pooling.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/im2col.hpp"
+
+#include "lbann/proto/layers.pb.h"
 #include <vector>
 
 namespace lbann {
 
 /** @brief Transpose of pooling layer
  *
- *  Requires that a pooling layer is set as the hint layer.
+ *  Requires that a max pooling layer is set as the hint layer. On
+ *  CPU, the locations of the maxima are the indices recorded by the
+ *  pooling layer. The DNN library does not expose them, so on GPU
+ *  they are recovered from the pooling layer's input, with the same
+ *  tie-breaking as the CPU pooling layer.
  *
  *  @warning This has not been well maintained and is probably broken.
- *  @todo GPU support.
  */
 template <typename TensorDataType,
           data_layout T_layout = data_layout::DATA_PARALLEL,
@@ -49,7 +55,6 @@ class unpooling_layer : public data_type_layer<TensorDataType>
 {
   static_assert(T_layout == data_layout::DATA_PARALLEL,
                 "unpooling only supports DATA_PARALLEL");
-  static_assert(Dev == El::Device::CPU, "unpooling only supports CPU");
 
 private:
   /** Type of corresponding pooling layer */
@@ -90,8 +95,9 @@ public:
         hint_layer->m_pool_mode != pooling_mode::MAX_DETERMINISTIC) {
       LBANN_ERROR("unpooling layer is only supported with max pooling");
     }
-    if (hint_layer->using_gpus()) {
-      LBANN_ERROR("unpooling layer is not supported on GPUs");
+    if (hint_layer->m_channels_last) {
+      LBANN_ERROR("unpooling layer is not supported with channels-last ",
+                  "pooling layers");
     }
   }
 
@@ -121,6 +127,13 @@ public:
 
     // Initialize output tensor based on corresponding pooling layer
     this->set_output_dims(hint_layer->get_input_dims());
+    if (Dev != El::Device::CPU && input_dims.size() > 4) {
+      LBANN_ERROR(get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" ",
+                  "only supports up to 3 spatial dimensions on GPU");
+    }
   }
 
 protected:
@@ -130,158 +143,34 @@ protected:
   friend class cereal::access;
   unpooling_layer() : unpooling_layer(nullptr) {}
 
-  void fp_compute() override
-  {
-    if (this->using_gpus()) {
-      throw lbann_exception("unpooling_layer: GPU version not yet implemented");
-    }
-    else {
-      fp_compute_im2col();
-    }
-  }
+  void fp_compute() override;
 
-  void bp_compute() override
-  {
-    if (this->using_gpus()) {
-      throw lbann_exception("unpooling_layer: GPU version not yet implemented");
-    }
-    else {
-      bp_compute_im2col();
-    }
-  }
+  void bp_compute() override;
 
 private:
   /// Unpooling forward propagation with im2col
-  void fp_compute_im2col()
-  {
-
-    using DMatDT = El::Matrix<TensorDataType, Dev>;
-
-    // Get pooling layer
-    const auto& hint_layer =
-      dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
-
-    // Get local matrices
-    const DMatDT& prev_activations_local = this->get_local_prev_activations();
-    DMatDT& activations_local = this->get_local_activations();
-
-    // Get parameters
-    const int local_width = prev_activations_local.Width();
-    const auto& output_dims = this->get_output_dims();
-    const int num_channels = output_dims[0];
-    const int num_per_input_channel = this->get_input_size() / num_channels;
-    const int pool_size = hint_layer.m_pool_size;
-
-    // Initialize im2col matrix
-    DMatDT im2col_mat(pool_size * num_channels, num_per_input_channel);
-
-    // Iterate through data samples
-    for (int sample = 0; sample < local_width; ++sample) {
-
-      // Clear im2col matrix
-      El::Zero(im2col_mat);
-
-      // Populate im2col matrix
-      const TensorDataType* prev_activations_buffer =
-        prev_activations_local.LockedBuffer(0, sample);
-      const int* indices_buffer =
-        &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_input_channel; ++j) {
-          const int input_index = j + channel * num_per_input_channel;
-          const int max_index = indices_buffer[input_index];
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * pool_size, j);
-          im2col_buffer[max_index] = prev_activations_buffer[input_index];
-        }
-      }
-
-      // Convert im2col matrix to output matrix
-      DMatDT output_mat = El::View(activations_local, El::ALL, El::IR(sample));
-      col2im<TensorDataType>(
-        im2col_mat,
-        output_mat,
-        num_channels,
-        output_dims.size() - 1,
-        &output_dims[1],
-        hint_layer.m_pads.data(),
-        hint_layer.m_pool_dims.data(),
-        hint_layer.m_strides.data(),
-        [](TensorDataType const& a, TensorDataType const& b) {
-          return std::max(a, b);
-        });
-    }
-  }
+  void fp_compute_im2col();
 
   /// Unpooling backward propagation with im2col
-  void bp_compute_im2col()
-  {
-
-    using DMatDT = El::Matrix<TensorDataType, Dev>;
-
-    // Get pooling layer
-    const auto& hint_layer =
-      dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
-
-    // Get local matrices
-    const DMatDT& prev_error_signal_local =
-      this->get_local_prev_error_signals();
-    DMatDT& error_signal_local = this->get_local_error_signals();
-
-    // Get parameters
-    const int local_width = prev_error_signal_local.Width();
-    const auto& output_dims = this->get_output_dims();
-    const int num_channels = output_dims[0];
-    const int num_per_output_channel = this->get_input_size() / num_channels;
-    const int pool_size = hint_layer.m_pool_size;
-
-    // Initialize im2col matrix
-    DMatDT im2col_mat(pool_size * num_channels, num_per_output_channel);
-
-    // Iterate through data samples
-    for (int sample = 0; sample < local_width; ++sample) {
-
-      // Construct im2col matrix from input
-      const DMatDT& input_mat =
-        El::LockedView(prev_error_signal_local, El::ALL, El::IR(sample));
-      im2col<TensorDataType>(input_mat,
-                             im2col_mat,
-                             num_channels,
-                             output_dims.size() - 1,
-                             &output_dims[1],
-                             hint_layer.m_pads.data(),
-                             hint_layer.m_pool_dims.data(),
-                             hint_layer.m_strides.data());
-
-      // Propagate error signal based on pooling layer
-      TensorDataType* output_buffer = error_signal_local.Buffer(0, sample);
-      const int* indices_buffer =
-        &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
-      LBANN_OMP_PARALLEL_FOR
-      for (int channel = 0; channel < num_channels; ++channel) {
-        for (int j = 0; j < num_per_output_channel; ++j) {
-          const int output_index = j + channel * num_per_output_channel;
-          const int max_index = indices_buffer[output_index];
-          TensorDataType* im2col_buffer =
-            im2col_mat.Buffer(channel * pool_size, j);
-          output_buffer[output_index] = im2col_buffer[max_index];
-        }
-      }
-    }
-  }
+  void bp_compute_im2col();
 };
 
+template <typename T, data_layout L, El::Device D>
+void unpooling_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  proto.mutable_unpooling();
+  // Unused
+  // msg->set_num_dims(this->get_output_dims().size());
+}
+
 #ifndef LBANN_UNPOOLING_LAYER_INSTANTIATE
-#define PROTO(T)                                                               \
-  extern template class unpooling_layer<T,                                     \
-                                        data_layout::DATA_PARALLEL,            \
-                                        El::Device::CPU>
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template class unpooling_layer<T, data_layout::DATA_PARALLEL, Device>
 
-#define LBANN_INSTANTIATE_CPU_HALF
-#include "lbann/macros/instantiate.hpp"
-#undef PROTO
-#undef LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
 #endif // LBANN_UNPOOLING_LAYER_INSTANTIATE
 
 } // namespace lbann
@@ -28,12 +28,20 @@
 #define LBANN_LAYER_WEIGHTED_SUM_HPP_INCLUDED
 
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/protobuf.hpp"
 #include <vector>
 
+#include "lbann/proto/layers.pb.h"
+
 namespace lbann {
 
-/** @brief Add tensors with scaling factors */
+/** @brief Add tensors with scaling factors
+ *
+ *  On GPU, the sum and the gradients are each computed in one kernel
+ *  that reads each tensor once.
+ */
 template <typename TensorDataType,
           data_layout T_layout = data_layout::DATA_PARALLEL,
           El::Device Dev = El::Device::CPU>
@@ -130,26 +138,21 @@ protected:
     }
   }
 
-  void fp_compute() override
-  {
-    auto& output = this->get_activations();
-    El::Zero(output);
-    for (int i = 0; i < this->get_num_parents(); ++i) {
-      El::Axpy(m_scaling_factors[i], this->get_prev_activations(i), output);
-    }
-  }
+  void fp_compute() override;
 
-  void bp_compute() override
-  {
-    const auto& gradient_wrt_output = this->get_prev_error_signals();
-    for (int i = 0; i < this->get_num_parents(); ++i) {
-      auto& gradient_wrt_input = this->get_error_signals(i);
-      El::Zero(gradient_wrt_input);
-      El::Axpy(m_scaling_factors[i], gradient_wrt_output, gradient_wrt_input);
-    }
-  }
+  void bp_compute() override;
 };
 
+template <typename T, data_layout L, El::Device D>
+void weighted_sum_layer<T, L, D>::write_specific_proto(
+  lbann_data::Layer& proto) const
+{
+  proto.set_datatype(proto::ProtoDataType<T>);
+  auto* msg = proto.mutable_weighted_sum();
+  protobuf::assign_to_repeated(*msg->mutable_scaling_factors(),
+                               m_scaling_factors);
+}
+
 #ifndef LBANN_WEIGHTED_SUM_LAYER_INSTANTIATE
 #define PROTO_DEVICE(T, Device)                                                \
   extern template class weighted_sum_layer<T,                                  \
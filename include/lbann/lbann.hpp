@@ -35,6 +35,7 @@
 
 /// Training Algorithms
 #include "lbann/execution_algorithms/batch_functional_inference_algorithm.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
 #include "lbann/execution_algorithms/training_algorithm.hpp"
 
 /// Models
@@ -66,6 +67,7 @@
 #include "lbann/layers/loss/l2_norm2.hpp"
 #include "lbann/layers/loss/mean_absolute_error.hpp"
 #include "lbann/layers/loss/mean_squared_error.hpp"
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
 #include "lbann/layers/loss/top_k_categorical_accuracy.hpp"
 
 /// Math layers
@@ -113,6 +115,7 @@
 /// Miscellaneous layers
 #include "lbann/layers/misc/argmax.hpp"
 #include "lbann/layers/misc/argmin.hpp"
+#include "lbann/layers/misc/attention.hpp"
 #include "lbann/layers/misc/channelwise_mean.hpp"
 #include "lbann/layers/misc/channelwise_softmax.hpp"
 #include "lbann/layers/misc/covariance.hpp"
@@ -136,6 +139,7 @@
 #include "lbann/data_readers/data_reader_python.hpp"
 #include "lbann/data_readers/data_reader_synthetic.hpp"
 #ifdef LBANN_HAS_OPENCV
+#include "lbann/data_readers/data_reader_image_shards.hpp"
 #include "lbann/data_readers/data_reader_imagenet.hpp"
 #endif // LBANN_HAS_OPENCV
 #ifdef LBANN_HAS_CNPY
@@ -158,6 +162,7 @@
 
 /// Callbacks
 #include "lbann/callbacks/alternate_updates.hpp"
+#include "lbann/callbacks/calibrate_quantization.hpp"
 #include "lbann/callbacks/check_dataset.hpp"
 #include "lbann/callbacks/check_gradients.hpp"
 #include "lbann/callbacks/check_init.hpp"
@@ -169,12 +174,14 @@
 #include "lbann/callbacks/confusion_matrix.hpp"
 #include "lbann/callbacks/debug.hpp"
 #include "lbann/callbacks/debug_io.hpp"
+#include "lbann/callbacks/detect_stragglers.hpp"
 #include "lbann/callbacks/dump_error_signals.hpp"
 #include "lbann/callbacks/dump_gradients.hpp"
 #include "lbann/callbacks/dump_minibatch_sample_indices.hpp"
 #include "lbann/callbacks/dump_outputs.hpp"
 #include "lbann/callbacks/dump_weights.hpp"
 #include "lbann/callbacks/early_stopping.hpp"
+#include "lbann/callbacks/export_telemetry.hpp"
 #include "lbann/callbacks/gpu_memory_usage.hpp"
 #include "lbann/callbacks/hang.hpp"
 #include "lbann/callbacks/imcomm.hpp"
@@ -182,6 +189,7 @@
 #include "lbann/callbacks/load_model.hpp"
 #include "lbann/callbacks/ltfb.hpp"
 #include "lbann/callbacks/mixup.hpp"
+#include "lbann/callbacks/model_averaging.hpp"
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/callbacks/perturb_adam.hpp"
 #include "lbann/callbacks/perturb_dropout.hpp"
@@ -189,6 +197,7 @@
 #include "lbann/callbacks/print_statistics.hpp"
 #include "lbann/callbacks/profiler.hpp"
 #include "lbann/callbacks/replace_weights.hpp"
+#include "lbann/callbacks/roofline.hpp"
 #include "lbann/callbacks/save_images.hpp"
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/callbacks/save_topk_models.hpp"
@@ -207,6 +216,8 @@
 #include "lbann/optimizers/adagrad.hpp"
 #include "lbann/optimizers/adam.hpp"
 #include "lbann/optimizers/hypergradient_adam.hpp"
+#include "lbann/optimizers/lamb.hpp"
+#include "lbann/optimizers/lars.hpp"
 #include "lbann/optimizers/rmsprop.hpp"
 #include "lbann/optimizers/sgd.hpp"
 
@@ -72,6 +72,11 @@ public:
   bool save_to_checkpoint_distributed(persist& p) override;
   bool load_from_checkpoint_distributed(persist& p) override;
 
+  /** The layer's local sum is accumulated on its device until the
+   *  statistics are flushed. */
+  void pack_pending_statistics(std::vector<EvalType>& buffer) override;
+  size_t unpack_pending_statistics(const EvalType* buffer) override;
+
 protected:
   void setup(model& m) override;
   EvalType evaluate(execution_mode mode, int mini_batch_size) override;
@@ -92,6 +97,13 @@ private:
   std::string m_unit;
   /** Corresponding layer. */
   ViewingLayerPtr m_layer;
+  /** Execution mode of the pending statistics. */
+  execution_mode m_pending_mode = execution_mode::invalid;
+  /** Number of samples in the pending statistics. */
+  int m_pending_num_samples = 0;
+
+  /** Add the pending statistics to the statistics. */
+  void flush_pending_statistics();
 
   /** Get corresponding evaluation layer. */
   /*abstract_evaluation_*/ Layer& get_evaluation_layer();
@@ -77,6 +77,8 @@ struct metric_statistics
   int get_num_samples() const { return m_num_samples; }
   /** Reset statistics. */
   void reset();
+  /** Sum statistics over a communicator. */
+  void allreduce(const lbann_comm& comm, const El::mpi::Comm& c);
 };
 
 /** Abstract base class for metric functions.
@@ -118,7 +120,8 @@ public:
    *  This function takes the model's current mini-batch size. If
    *  multiple models are being trained, the current mini-batch size
    *  may be different from the effective mini-batch size. The result
-   *  is stored in history.
+   *  is stored in history. Metrics with pending statistics return
+   *  zero, since the value has not been reduced yet.
    */
   virtual EvalType evaluate(execution_mode mode, int mini_batch_size) = 0;
 
@@ -139,6 +142,28 @@ public:
   EvalType get_mean_value(execution_mode mode) const;
   /** Get number of samples for statistics. */
   int get_statistics_num_samples(execution_mode mode) const;
+  /** Sum statistics for an execution mode across trainers. */
+  void reduce_statistics_across_trainers(execution_mode mode);
+
+  /** @name Pending statistics
+   *  A metric may accumulate values locally (e.g. on a device) across
+   *  mini-batches and only add them to its statistics once they are
+   *  summed over the trainer. Every process in the trainer must pack
+   *  and unpack the pending statistics of the same metrics in the
+   *  same order.
+   */
+  ///@{
+  /** Append locally accumulated values to a buffer that will be
+   *  summed over the trainer. */
+  virtual void pack_pending_statistics(std::vector<EvalType>& buffer) {}
+  /** Add values summed over the trainer to the statistics.
+   *  @returns Number of values used from @c buffer.
+   */
+  virtual size_t unpack_pending_statistics(const EvalType* buffer)
+  {
+    return 0;
+  }
+  ///@}
 
   /** Get list of pointers to layers. */
   virtual std::vector<ViewingLayerPtr> get_layer_pointers() const;
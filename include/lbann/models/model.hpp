@@ -72,6 +72,10 @@ class callback_base;
 class metric;
 class weights;
 class optimizer;
+class flat_weights_state;
+class weights_snapshot;
+class gradient_bucket_manager;
+class evaluation_reducer;
 class objective_function;
 class ExecutionContext;
 class persist;
@@ -138,19 +142,66 @@ public:
   std::vector<weights const*> get_weights() const;
   std::vector<ViewingWeightsPtr> get_weights_pointers() const;
 
+  /** @brief Flat buffers holding the values and optimizer state of
+   *         the weights.
+   *  @details Null unless --flat_weights_state is set.
+   */
+  flat_weights_state* get_flat_weights_state() noexcept
+  {
+    return m_flat_weights_state.get();
+  }
+  /** @brief Move the values and optimizer state of the weights into
+   *         flat buffers.
+   *
+   *  Called in setup function, and after the weights of a copied
+   *  model are set up. Does nothing unless --flat_weights_state is
+   *  set.
+   */
+  void setup_flat_weights_state();
+
+  /** @brief Copy the values, and optionally the optimizer state, of
+   *         the weights into an in-memory snapshot.
+   *
+   *  Nothing is serialized, and the snapshot's buffers are reused if
+   *  it was taken before from a model with the same weights.
+   */
+  void take_weights_snapshot(weights_snapshot& snapshot,
+                             bool optimizer_state = false);
+  /** @brief Restore the weights from a snapshot.
+   *  @details The snapshot must have been taken from a model with
+   *  the same weights, e.g. this model or a copy of it.
+   */
+  void restore_weights_snapshot(weights_snapshot& snapshot);
+
   /** @brief Mathematical function to be minimized during training. */
   observer_ptr<objective_function const>
   get_objective_function() const noexcept;
 
   observer_ptr<objective_function> get_objective_function() noexcept;
 
+  /** @brief Shared reduction of the evaluation layers' values.
+   *  @details Null if each evaluation layer reduces its own value.
+   */
+  evaluation_reducer* get_evaluation_reducer() const noexcept
+  {
+    return m_evaluation_reducer.get();
+  }
+
   /** @brief Return the model's metrics. */
   std::vector<metric*> get_metrics();
   std::vector<metric const*> get_metrics() const;
 
 #ifdef LBANN_HAS_ONNX
-  /** @brief Serialize model to Onnx format */
-  void serialize_to_onnx(onnx::ModelProto& mp);
+  /** @brief Serialize model to Onnx format
+   *
+   *  If @c data_dir is set, the values of the weights are not stored
+   *  in the message. They are written in parallel, each weights by a
+   *  different rank, to ONNX external data files in @c data_dir,
+   *  whose path relative to the ONNX model file is @c data_location.
+   */
+  void serialize_to_onnx(onnx::ModelProto& mp,
+                         std::string const& data_dir = "",
+                         std::string const& data_location = "");
 #endif // LBANN_HAS_ONNX
 
   // ===========================================
@@ -213,6 +264,12 @@ public:
   /** @brief Are background I/O activities enabled by the input layers */
   bool background_io_activity_allowed() const noexcept;
 
+  /** @brief Compile the model for inference only when it is set up
+   *  @details See setup_inference_graph. The model can no longer be
+   *  trained. */
+  void set_inference_only(bool inference_only) noexcept;
+  bool is_inference_only() const noexcept;
+
   // ===========================================
   // Setup
   // ===========================================
@@ -304,6 +361,24 @@ private:
    */
   void reorder_layers(const std::vector<El::Int>& gather_indices);
 
+  /** @brief Position of the layer with a given name, or -1.
+   *
+   *  Looked up in a hash table that is rebuilt when the layer list
+   *  changes. Layers are assumed to keep their names once they are
+   *  added to the model.
+   */
+  El::Int find_layer_index(std::string const& name) const;
+
+  /** @brief Position of the weights with a given name, or -1. */
+  El::Int find_weights_index(std::string const& name) const;
+
+  /** @brief Connect the parent and child of a layer with one parent
+   *         and one child and remove its weights.
+   *
+   *  The layer is left in the layer list.
+   */
+  void unlink_layer(El::Int index);
+
   /** @brief Remap pointers.
    *
    *  Layer and weights pointers are remapped using the provided
@@ -322,6 +397,51 @@ private:
    */
   void setup_layer_topology();
 
+  /** @brief Fold ReLU layers into the layers that produce their input.
+   *
+   *  Called in setup function if the fuse_relu option is set. A ReLU
+   *  layer is removed and its parent applies the ReLU in place if
+   *  the parent supports it (see Layer::supports_fused_relu), the
+   *  ReLU is its only child, both have the same data type, layout
+   *  and device, and no other layer, metric or objective function
+   *  term refers to the ReLU layer.
+   */
+  void fuse_relu_layers();
+
+  /** @brief Remove permute layers that can be done without a copy.
+   *
+   *  Called in setup function if the fold_permutes option is set,
+   *  after ReLU fusion. A permute layer followed by its inverse is
+   *  removed together with it. A permute layer that swaps the last
+   *  two axes is folded into its child if the child can transpose
+   *  that input itself (see Layer::fold_input_transpose), e.g. a
+   *  matmul layer. Only permute layers with one parent and one
+   *  child, that no metric or objective function term refers to,
+   *  are removed.
+   */
+  void fold_permute_layers();
+
+  /** @brief Layers that are referred to by something other than
+   *  their parents and children.
+   */
+  std::unordered_set<const Layer*> get_referenced_layers() const;
+
+  /** @brief Rewrite the layer graph for inference.
+   *
+   *  Called in setup function if the model is inference only, before
+   *  ReLU fusion. Optimizers are dropped and all layers and weights
+   *  are frozen, so no backprop state is allocated. Dropout layers,
+   *  which are identities in inference, are removed. A batch
+   *  normalization layer is folded into the convolution or fully
+   *  connected layer that produces its input (see
+   *  Layer::fold_inference_affine) when the values of both layers'
+   *  weights are already known, e.g. restored from a checkpoint, and
+   *  it is the only child of that layer. Activation memory is always
+   *  planned (see setup_activation_memory_plan) and layers run on a
+   *  single GPU stream.
+   */
+  void setup_inference_graph();
+
   /** @brief Set up layer execution order.
    *
    *  Called in setup function. A topological sort applied is to the
@@ -338,6 +458,105 @@ private:
                     DataReaderMetaData& dr_metadata,
                     const std::vector<El::Grid*>& grids);
 
+  /** @brief Set up activation recomputation.
+   *
+   *  Called in setup function after the layers are set up. Runs of
+   *  consecutive layers that are marked with
+   *  Layer::set_recompute_activations form segments. In training,
+   *  outputs that are only consumed within their segment are freed
+   *  after the segment's forward prop, and the segment is forward
+   *  propagated again just before its backprop.
+   */
+  void setup_activation_recomputation();
+
+  /** @brief Free the discardable outputs of a recompute segment. */
+  void discard_activations(El::Int segment);
+
+  /** @brief Forward propagate a recompute segment again. */
+  void recompute_activations(El::Int segment);
+
+  /** @brief Set up the activation memory plan.
+   *
+   *  Called in setup function after the layers are set up, if the
+   *  plan_activation_memory option is set. The lifetime of each
+   *  layer's outputs is computed from the execution order: in
+   *  evaluation modes they are last used by the forward prop of the
+   *  last child, and in training by the layer's own backprop. The
+   *  outputs are freed at the end of their lifetime, so that the
+   *  memory pool can reuse the buffers for later tensors. The planned
+   *  peak is reported by assigning the tensors of each device to
+   *  offsets in a shared arena.
+   */
+  void setup_activation_memory_plan();
+
+  /** @brief Free a layer's outputs at the end of their lifetime.
+   *
+   *  The outputs are kept until every neighboring layer whose outputs
+   *  view other matrices (e.g. split, identity, or a parent writing
+   *  into a concatenate layer output) has been released.
+   */
+  void release_activations(El::Int layer);
+
+  /** @brief Set up offloading of activations to host memory.
+   *
+   *  Called in setup function after the layers are set up. In
+   *  training, the outputs of GPU layers marked with
+   *  Layer::set_offload_activations are copied to pinned host memory
+   *  on a dedicated stream after their forward prop, and freed once
+   *  the last child has been forward propagated. The copy back is
+   *  launched before the backprop of the layer that follows the last
+   *  child, so that it overlaps that layer's compute, and is waited
+   *  on just before the last child's backprop. Layers that are
+   *  recomputed, have no children, or whose outputs are viewed by a
+   *  child, are not offloaded.
+   */
+  void setup_activation_offload();
+
+  /** @brief Free the outputs of an offloaded layer after its last
+   *         child's forward prop.
+   */
+  void free_offloaded_activations(El::Int layer);
+
+  /** @brief Wait on the copy back of an offloaded layer's outputs,
+   *         and set up the inputs of its children again.
+   */
+  void wait_for_restored_activations(El::Int layer);
+
+  /** @brief Set up concurrent execution of layer branches.
+   *
+   *  Called in setup function after the layers are set up, if the
+   *  num_branch_streams option is at least 2. A GPU layer continues
+   *  the stream of its first parent, unless an earlier child of that
+   *  parent already does, in which case it begins a branch on the
+   *  next stream of a small pool, so that the kernels of independent
+   *  branches can overlap. Streams are ordered with events: a layer
+   *  waits on the streams of its parents before forward prop and of
+   *  its children before backprop, and forward prop and backprop
+   *  begin and end on the default stream.
+   */
+  void setup_branch_streams();
+
+  /** @brief Assign layers to pipeline stages.
+   *
+   *  With @c --pipeline_stages, layers without a grid tag, other than
+   *  the input layers, are split into contiguous runs of the
+   *  execution order, one per sub-grid, with roughly equal numbers of
+   *  layers. Grid 0 is the whole trainer and keeps the
+   *  input layers. Tensors crossing a stage boundary are copied
+   *  between the sub-grids.
+   */
+  void setup_pipeline_stages(const std::vector<El::Grid*>& grids);
+
+  /** @brief Make a layer's stream wait on the streams of its parents
+   *         (forward prop) or children (@c backward).
+   */
+  void wait_for_branch_streams(El::Int layer, bool backward);
+
+  /** @brief Make the branch streams wait on the default stream, or
+   *         the default stream wait on all of them (@c join).
+   */
+  void sync_branch_streams(bool join);
+
   /** @brief Set up weights.
    *
    *  Called in setup function. All weights being used by layers or
@@ -346,6 +565,20 @@ private:
    */
   void setup_weights();
 
+  /** @brief Pack the gradients of the weights into buckets.
+   *
+   *  Called in setup function. Does nothing unless
+   *  --gradient_bucket_mb is set.
+   */
+  void setup_gradient_buckets();
+
+  /** @brief Reduce the values of the evaluation layers together.
+   *
+   *  Called in setup function, before the layers are set up. Does
+   *  nothing unless --pack_evaluation_values is set.
+   */
+  void setup_evaluation_reducer();
+
   ///@}
   /** @name Subgraph parallelism implementation */
   ///@{
@@ -404,9 +637,27 @@ public:
   void reset_mode(ExecutionContext& context, execution_mode mode);
   /** @brief Reset model statistics for an epoch. */
   void reset_epoch_statistics(execution_mode mode);
+  /** @brief Sum model statistics for an epoch across trainers.
+   *  @details Used when each trainer evaluated a share of the data
+   *  set. All trainers must hold the same model.
+   */
+  void reduce_epoch_statistics_across_trainers(execution_mode mode);
+  /** @brief Add the pending statistics of the objective function
+   *         and metrics to their statistics.
+   *  @details Objective function values still on the device are
+   *  waited for. The pending values of all metrics are summed over
+   *  the trainer in a single allreduce, so every process in the
+   *  trainer must call this. Callbacks that read statistics in the
+   *  middle of an epoch should call this first.
+   */
+  void flush_statistics();
 
-  /** @brief Forward propagation step. */
-  void forward_prop(execution_mode mode);
+  /** @brief Forward propagation step.
+   *  @param after_inputs If set, called once the input layers have
+   *  been forward propagated and before any other layer is.
+   */
+  void forward_prop(execution_mode mode,
+                    std::function<void()> const& after_inputs = {});
   /** @brief Backward propagation step. */
   void backward_prop();
   /** Evaluate any metrics in the model */
@@ -417,6 +668,29 @@ public:
    *  set an optimizer flag during forward prop.
    */
   void clear_gradients();
+  /** @brief Defer the weights gradient allreduces.
+   *
+   *  While deferred, backprop accumulates each optimizer's gradient
+   *  locally instead of launching its allreduce, so gradients can be
+   *  summed over several backprops with a single allreduce at the
+   *  end of the last one.
+   */
+  void defer_gradient_allreduces(bool defer);
+  /** @brief Undo loss scaling of the weights gradients.
+   *
+   *  Returns false if any gradient in the trainer has non-finite
+   *  values, in which case the update step should be skipped.
+   */
+  bool unscale_gradients(EvalType scale);
+  /** @brief Clip the weights gradients by their global norm.
+   *
+   *  The gradients of the optimizers with a positive clip_gradient_norm
+   *  are scaled so that their global L2 norm does not exceed it. This
+   *  waits for their allreduces. The norm is computed with one pass
+   *  over the gradients per optimizer type and one scalar allreduce,
+   *  and the scale is applied in the next optimization step.
+   */
+  void clip_gradients();
   /** @brief Update weights step. */
   void update_weights();
   /** @brief Update layers step. */
@@ -427,6 +701,13 @@ public:
    *  are set to the average across the processes.
    */
   void reconcile_weight_values();
+  /** @brief Compute the stale row norms of weights.
+   *
+   *  Weights with row norms (see weights::enable_row_norms) whose
+   *  values changed, e.g. in an optimization step, are computed in a
+   *  batch before forward propagation.
+   */
+  void update_weights_row_norms();
 
   // ===========================================
   // Callbacks
@@ -529,6 +810,13 @@ private:
   /** @brief Trainable parameters. */
   std::vector<OwningWeightsPtr> m_weights;
 
+  /** @brief Positions of layers and weights by name.
+   *  @details See find_layer_index. Cleared whenever entries of the
+   *  layer or weights list are moved.
+   */
+  mutable std::unordered_map<std::string, El::Int> m_layer_indices;
+  mutable std::unordered_map<std::string, El::Int> m_weights_indices;
+
   /** @details If a layer needs to construct an optimizer during
    *  setup, it will make a copy of the default optimizer. This object
    *  is just used to create copies and is not actually used for
@@ -555,7 +843,112 @@ private:
    */
   bool m_model_is_setup = false;
 
+  /** @brief Whether the model is compiled for inference only */
+  bool m_inference_only = false;
+
+  /** @brief Recompute segments
+   *  @details Each segment is a [begin, end) range of layer indices
+   *  in execution order.
+   */
+  std::vector<std::pair<El::Int, El::Int>> m_recompute_segments;
+  /** @brief Recompute segment of each layer, or -1 if none */
+  std::vector<El::Int> m_recompute_segment_of_layer;
+  /** @brief Whether each layer's outputs are freed after forward
+   *         prop */
+  std::vector<bool> m_discard_activations;
+
+  /** @brief Whether layer outputs are freed at the end of their
+   *         planned lifetime */
+  bool m_plan_activation_memory = false;
+  /** @brief Layers whose outputs are released after the forward
+   *         prop of each layer, in evaluation modes */
+  std::vector<std::vector<El::Int>> m_release_after_fp;
+  /** @brief Parents and children of each layer */
+  std::vector<std::vector<El::Int>> m_release_neighbors;
+  /** @brief Whether each layer's outputs were released in this step */
+  std::vector<bool> m_activations_released;
+  /** @brief Releases waiting for each layer's release */
+  std::vector<std::vector<El::Int>> m_deferred_releases;
+
+  /** @brief Layers whose outputs are offloaded in training */
+  std::vector<bool> m_offload_activations;
+  /** @brief Children of each offloaded layer */
+  std::vector<std::vector<El::Int>> m_offload_children;
+  /** @brief Layers whose outputs are freed after the forward prop of
+   *         each layer */
+  std::vector<std::vector<El::Int>> m_offload_free_after_fp;
+  /** @brief Layers whose outputs are copied back before the backprop
+   *         of each layer */
+  std::vector<std::vector<El::Int>> m_offload_restore_before_bp;
+  /** @brief Layers whose copies back are waited on before the
+   *         backprop of each layer */
+  std::vector<std::vector<El::Int>> m_offload_wait_before_bp;
+  /** @brief Whether each layer's outputs are in host memory, or being
+   *         copied back, in this step */
+  std::vector<bool> m_activations_offloaded;
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Streams of concurrent layer branches
+   *  @details Empty if every layer runs on the default stream, which
+   *  is otherwise the first entry.
+   */
+  std::vector<El::SyncInfo<El::Device::GPU>> m_branch_streams;
+  /** @brief Index in m_branch_streams of each layer's stream */
+  std::vector<size_t> m_stream_of_layer;
+  /** @brief Streams each layer waits on before forward prop */
+  std::vector<std::vector<size_t>> m_fp_stream_waits;
+  /** @brief Streams each layer waits on before backprop */
+  std::vector<std::vector<size_t>> m_bp_stream_waits;
+#endif // LBANN_HAS_GPU
+
+  /** @brief Buckets for the gradients of the weights
+   *  @details Null if every gradient is allreduced on its own.
+   */
+  std::shared_ptr<gradient_bucket_manager> m_gradient_buckets;
+
+  /** @brief Packed reduction of the evaluation layers' values
+   *  @details Null if each evaluation layer reduces its own value.
+   */
+  std::shared_ptr<evaluation_reducer> m_evaluation_reducer;
+
+  /** @brief Flat buffers of the values and optimizer state
+   *  @details Null if the tensors are stored separately.
+   */
+  std::shared_ptr<flat_weights_state> m_flat_weights_state;
+
+  /** @brief Checkpoint file holding the values of frozen weights */
+  struct frozen_values_file
+  {
+    /** @brief Values version when the file was written. */
+    size_t version;
+    std::string filename;
+  };
+  /** @brief Files of frozen weights that later shared checkpoints
+   *         refer to instead of writing the values again.
+   *  @details Keyed by weights name. Not copied with the model.
+   */
+  std::unordered_map<std::string, frozen_values_file> m_frozen_values_files;
+
 private:
+  // ===========================================
+  // Checkpoint helpers
+  // ===========================================
+
+  /** @brief Write the values of frozen weights that have changed
+   *         since the last shared checkpoint to their own files.
+   *
+   *  Writes an index of the files holding the values of every frozen
+   *  weights to the checkpoint.
+   *
+   *  @returns The frozen weights, whose values must not be written to
+   *  the model archive.
+   */
+  std::vector<weights*> save_frozen_weights_values(persist& p);
+  /** @brief Read the values of the frozen weights listed in a shared
+   *         checkpoint's index.
+   */
+  void load_frozen_weights_values(persist& p);
+
   // ===========================================
   // Functions to add utility layers
   // ===========================================
@@ -678,6 +1071,16 @@ inline bool model::background_io_activity_allowed() const noexcept
   return m_background_io_allowed;
 }
 
+inline void model::set_inference_only(bool inference_only) noexcept
+{
+  m_inference_only = inference_only;
+}
+
+inline bool model::is_inference_only() const noexcept
+{
+  return m_inference_only;
+}
+
 inline void model::set_subgrid_communication_type(int type) noexcept
 {
   vector_communication_subgraph = type;
@@ -51,6 +51,10 @@ public:
   void start_evaluation() override;
 
   EvalType finish_evaluation() override;
+#ifdef LBANN_HAS_GPU
+  bool accumulate_value(El::Matrix<EvalType, El::Device::GPU>& sum,
+                        EvalType weight) override;
+#endif // LBANN_HAS_GPU
 
   void differentiate() override;
 
@@ -29,6 +29,9 @@
 
 #include "lbann/metrics/metric.hpp"
 #include "lbann/objective_functions/objective_function_term.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 namespace lbann {
 
@@ -74,25 +77,34 @@ public:
    */
   EvalType finish_evaluation(execution_mode mode, int mini_batch_size);
 
+  /** Complete evaluation of the objective function without waiting
+   *  for the device.
+   *  Values of terms that are on a device are added to a running sum
+   *  there, which is read asynchronously. The statistics may lag a
+   *  few mini-batches behind until flush_statistics is called.
+   */
+  void finish_evaluation_deferred(execution_mode mode, int mini_batch_size);
+
+  /** Wait for values that are still on a device and add them to the
+   *  statistics. */
+  void flush_statistics();
+
   /** Compute the objective function gradient.
-   *  The gradient is with respect to the objective function inputs
+   *  The gradient is with respect to the objective function inputs.
+   *  It is multiplied by @c gradient_scale, e.g. for loss scaling.
    */
-  void differentiate();
+  void differentiate(EvalType gradient_scale = EvalType(1));
 
   /** Compute the gradient of the weight regularization term.
-   *  The gradient is computed w.r.t. the weights.
+   *  The gradient is computed w.r.t. the weights. It is multiplied
+   *  by @c gradient_scale, e.g. for loss scaling.
    */
-  void compute_weight_regularization();
+  void compute_weight_regularization(EvalType gradient_scale = EvalType(1));
 
   /** Clear all statistics. */
-  void reset_statistics()
-  {
-    for (auto& stats : m_statistics) {
-      stats.second.reset();
-    }
-  }
+  void reset_statistics();
   /** Clear statistics for an execution mode. */
-  void reset_statistics(execution_mode mode) { m_statistics[mode].reset(); }
+  void reset_statistics(execution_mode mode);
 
   /** Get mean objective function value.
    *  This is a weighted average such that each mini-batch sample makes
@@ -101,6 +113,9 @@ public:
   EvalType get_mean_value(execution_mode mode) const;
   /** Get number of samples for statistics. */
   int get_statistics_num_samples(execution_mode mode) const;
+  /** Sum statistics for an execution mode across trainers. */
+  void reduce_statistics_across_trainers(execution_mode mode,
+                                         const lbann_comm& comm);
 
   /** Get list of pointers to layers. */
   std::vector<ViewingLayerPtr> get_layer_pointers() const;
@@ -136,6 +151,33 @@ private:
   EvalType m_evaluation_time = EvalType(0);
   /** Time spent computing the objective function gradient. */
   EvalType m_differentiation_time = EvalType(0);
+
+#ifdef LBANN_HAS_GPU
+  /** Statistics that have not been read from the device. */
+  struct device_statistics
+  {
+    /** Running sum of values. */
+    El::Matrix<EvalType, El::Device::GPU> sum;
+    /** Copy of the running sum being read, in pinned memory. */
+    El::Matrix<EvalType, El::Device::CPU> readback;
+    /** Event after the copy to @c readback. */
+    gpu_lib::event_wrapper readback_event;
+    /** Whether a copy to @c readback is in progress. */
+    bool reading = false;
+  };
+  /** Statistics on the device for each execution mode.
+   *  They are not copied with the objective function.
+   */
+  std::map<execution_mode, device_statistics> m_device_statistics;
+
+  /** Get the device statistics for an execution mode. */
+  device_statistics& get_device_statistics(execution_mode mode);
+  /** Add the running sum to the statistics once it has been read.
+   *  A copy of the running sum is started if none is in progress. If
+   *  @c wait is set, the sum is read before returning.
+   */
+  void read_device_statistics(execution_mode mode, bool wait);
+#endif // LBANN_HAS_GPU
 };
 
 } // namespace lbann
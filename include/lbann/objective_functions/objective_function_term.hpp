@@ -79,6 +79,21 @@ public:
   /** Complete evaluation of the objective function term. */
   virtual EvalType finish_evaluation() = 0;
 
+#ifdef LBANN_HAS_GPU
+  /** Add the value of the objective function term, times
+   *  @c weight, to a running sum on the device.
+   *  This does not synchronize with the device. This is called
+   *  instead of finish_evaluation.
+   *  @returns Whether the value was added. If not, the value must be
+   *  read with finish_evaluation.
+   */
+  virtual bool accumulate_value(El::Matrix<EvalType, El::Device::GPU>& sum,
+                                EvalType weight)
+  {
+    return false;
+  }
+#endif // LBANN_HAS_GPU
+
   /** Compute the gradient of the objective function term.
    *  The gradient is computed w.r.t. the objective function term
    *  inputs. This should include the scaling factor.
@@ -90,6 +105,14 @@ public:
    */
   virtual void compute_weight_regularization() = 0;
 
+  /** Get scaling factor for objective function term. */
+  EvalType get_scale_factor() const noexcept { return m_scale_factor; }
+  /** Set scaling factor for objective function term. */
+  void set_scale_factor(EvalType scale_factor) noexcept
+  {
+    m_scale_factor = scale_factor;
+  }
+
   /** Get list of pointers to layers. */
   std::vector<ViewingLayerPtr> get_layer_pointers() const;
   /** Set list of pointers to layers. */
@@ -46,6 +46,10 @@ class data_type_weights;
  *  Given a weights tensor @f$ w @f$,
  *  @f[ L2(w) = \frac{1}{2} \sum\limits_{i} w(i)^2 @f]
  *  Note the @f$ 1/2 @f$ scaling factor.
+ *
+ *  If the term is not needed in the objective function value, the
+ *  optimizer can apply its gradient in the update kernel instead;
+ *  see optimizer::get_l2_regularization.
  */
 class l2_weight_regularization : public objective_function_term
 {
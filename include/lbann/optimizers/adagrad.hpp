@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_ADAGRAD_HPP_INCLUDED
 
 #include "lbann/io/persist.hpp"
+#include "lbann/optimizers/compressed_state.hpp"
 #include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/proto/optimizers.pb.h"
 
@@ -64,7 +65,9 @@ public:
   ///@}
 
 public:
-  adagrad(TensorDataType learning_rate, TensorDataType eps = 1e-8);
+  adagrad(TensorDataType learning_rate,
+          TensorDataType eps = 1e-8,
+          optimizer_state_format state_format = optimizer_state_format::full);
   adagrad(const adagrad& other);
   adagrad& operator=(const adagrad& other);
   ~adagrad() override = default;
@@ -78,9 +81,20 @@ public:
   /** Human-readable description. */
   description get_description() const override;
 
+  /** Storage format of the cache. */
+  optimizer_state_format get_state_format() const noexcept
+  {
+    return m_state_format;
+  }
+
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_cache.get()};
+  }
+
   /** Add optimizer data to prototext */
   void write_proto(lbann_data::Optimizer& opt) const final;
 
@@ -98,11 +112,29 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  bool supports_fused_step() const override { return true; }
+  bool add_fused_step_entry(
+    AbsDistMatrixType& values,
+    const AbsDistMatrixType& gradient,
+    std::vector<fused_step_entry<TensorDataType>>& entries) override;
+#ifdef LBANN_HAS_GPU
+  void fused_step_gpu(
+    std::vector<fused_step_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Small factor to avoid division by zero. */
   TensorDataType m_eps;
   /** AdaGrad cache. */
   std::unique_ptr<AbsDistMatrixType> m_cache;
+  /** Storage format of the cache. */
+  optimizer_state_format m_state_format;
+  /** @brief AdaGrad cache in a compressed format.
+   *  @details Replaces @c m_cache, which is then only filled while
+   *  checkpointing.
+   */
+  std::unique_ptr<compressed_state> m_compressed_cache;
 
   /** CPU implementation of optimization step. */
   void step_compute_cpu(AbsDistMatrixType& values,
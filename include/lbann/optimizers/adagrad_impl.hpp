@@ -36,9 +36,27 @@ template <typename TensorDataType>
 template <class Archive>
 void adagrad<TensorDataType>::serialize(Archive& ar)
 {
+  // A compressed cache is checkpointed in the data type of the
+  // weights
+  if constexpr (!utils::IsInputArchive<Archive>) {
+    if (m_compressed_cache != nullptr) {
+      m_compressed_cache->decompress(*m_cache);
+    }
+  }
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_eps),
-     CEREAL_NVP(m_cache));
+     CEREAL_NVP(m_cache),
+     CEREAL_NVP(m_state_format));
+  if (m_state_format != optimizer_state_format::full && m_cache != nullptr) {
+    if constexpr (utils::IsInputArchive<Archive>) {
+      m_compressed_cache =
+        std::make_unique<compressed_state>(m_state_format, false);
+      m_compressed_cache->compress(*m_cache);
+    }
+    else {
+      m_cache->Empty();
+    }
+  }
 }
 
 } // namespace lbann
@@ -28,6 +28,7 @@
 #define LBANN_OPTIMIZERS_ADAM_HPP_INCLUDED
 
 #include "lbann/io/persist.hpp"
+#include "lbann/optimizers/compressed_state.hpp"
 #include "lbann/optimizers/data_type_optimizer.hpp"
 #include "lbann/proto/optimizers.pb.h"
 
@@ -72,7 +73,8 @@ public:
   adam(TensorDataType learning_rate,
        TensorDataType beta1 = 0.9,
        TensorDataType beta2 = 0.99,
-       TensorDataType eps = 1e-8);
+       TensorDataType eps = 1e-8,
+       optimizer_state_format state_format = optimizer_state_format::full);
   adam(const adam& other);
   adam& operator=(const adam& other);
   ~adam() = default;
@@ -109,14 +111,38 @@ public:
   /** Small factor to avoid division by zero. */
   void set_eps(TensorDataType eps) { m_eps = eps; }
 
-  /** First moment estimates. */
+  /** Storage format of the moment estimates. */
+  optimizer_state_format get_state_format() const noexcept
+  {
+    return m_state_format;
+  }
+
+  /** @brief First moment estimates.
+   *  @details Empty if the state format is not full.
+   */
   const AbsDistMatrixType& get_moment1() const;
   /** First moment estimates. */
   AbsDistMatrixType& get_moment1();
-  /** Second moment estimates. */
+  /** @brief Second moment estimates.
+   *  @details Empty if the state format is not full.
+   */
   const AbsDistMatrixType& get_moment2() const;
   /** Second moment estimates. */
   AbsDistMatrixType& get_moment2();
+  /** @brief Compressed first moment estimates.
+   *  @details Null if the state format is full.
+   */
+  compressed_state* get_compressed_moment1() noexcept
+  {
+    return m_compressed_moment1.get();
+  }
+  /** @brief Compressed second moment estimates.
+   *  @details Null if the state format is full.
+   */
+  compressed_state* get_compressed_moment2() noexcept
+  {
+    return m_compressed_moment2.get();
+  }
 
   /** beta1 ^ iteration.
    *  @todo This probably shouldn't be exposed.
@@ -149,6 +175,11 @@ public:
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_moment1.get(), m_moment2.get()};
+  }
+
   ///@}
 
   /** Add optimizer data to prototext */
@@ -172,6 +203,17 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  bool supports_fused_step() const override { return true; }
+  bool add_fused_step_entry(
+    AbsDistMatrixType& values,
+    const AbsDistMatrixType& gradient,
+    std::vector<fused_step_entry<TensorDataType>>& entries) override;
+#ifdef LBANN_HAS_GPU
+  void fused_step_gpu(
+    std::vector<fused_step_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** Update factor for first moment estimate. */
   TensorDataType m_beta1;
@@ -187,10 +229,26 @@ private:
   std::unique_ptr<AbsDistMatrixType> m_moment1;
   /** Second moment estimates. */
   std::unique_ptr<AbsDistMatrixType> m_moment2;
+  /** Storage format of the moment estimates. */
+  optimizer_state_format m_state_format;
+  /** @brief First moment estimates in a compressed format.
+   *  @details Replace @c m_moment1, which is then only filled while
+   *  checkpointing.
+   */
+  std::unique_ptr<compressed_state> m_compressed_moment1;
+  /** @brief Second moment estimates in a compressed format.
+   *  @details Replace @c m_moment2, which is then only filled while
+   *  checkpointing.
+   */
+  std::unique_ptr<compressed_state> m_compressed_moment2;
 
   /** Hyperparameter exploration. */
   friend class callback::perturb_adam;
 
+  /** Advance the bias correction and return the scaled learning
+   *  rate of the step. */
+  TensorDataType advance_correction();
+
   /** CPU implementation of optimization step. */
   void step_compute_cpu(AbsDistMatrixType& values,
                         const AbsDistMatrixType& gradient,
@@ -36,6 +36,14 @@ template <typename TensorDataType>
 template <class Archive>
 void adam<TensorDataType>::serialize(Archive& ar)
 {
+  // Compressed moments are checkpointed in the data type of the
+  // weights
+  if constexpr (!utils::IsInputArchive<Archive>) {
+    if (m_compressed_moment1 != nullptr) {
+      m_compressed_moment1->decompress(*m_moment1);
+      m_compressed_moment2->decompress(*m_moment2);
+    }
+  }
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_beta1),
      CEREAL_NVP(m_beta2),
@@ -43,7 +51,22 @@ void adam<TensorDataType>::serialize(Archive& ar)
      CEREAL_NVP(m_current_beta1),
      CEREAL_NVP(m_current_beta2),
      CEREAL_NVP(m_moment1),
-     CEREAL_NVP(m_moment2));
+     CEREAL_NVP(m_moment2),
+     CEREAL_NVP(m_state_format));
+  if (m_state_format != optimizer_state_format::full && m_moment1 != nullptr) {
+    if constexpr (utils::IsInputArchive<Archive>) {
+      m_compressed_moment1 =
+        std::make_unique<compressed_state>(m_state_format, true);
+      m_compressed_moment2 =
+        std::make_unique<compressed_state>(m_state_format, false);
+      m_compressed_moment1->compress(*m_moment1);
+      m_compressed_moment2->compress(*m_moment2);
+    }
+    else {
+      m_moment1->Empty();
+      m_moment2->Empty();
+    }
+  }
 }
 
 } // namespace lbann
@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_COMPRESSED_STATE_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_COMPRESSED_STATE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_COMPRESSED_STATE_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_COMPRESSED_STATE_FUNC inline
+#endif // defined __CUDACC__ || defined __HIPCC__
+
+namespace lbann {
+
+/** @brief Storage format of optimizer state tensors
+ *  @details Matches lbann_data::OptimizerStateFormat.
+ */
+enum class optimizer_state_format
+{
+  /** Same data type as the weights */
+  full = 0,
+  /** bfloat16 */
+  bf16 = 1,
+  /** 8-bit codes with a scale per block of entries */
+  int8 = 2,
+};
+
+std::string to_string(optimizer_state_format f);
+
+/** @brief Entries that share a scale in @c optimizer_state_format::int8
+ *  @details Also the number of threads per block of the GPU kernels
+ *  that update compressed state, which handle one scale block each.
+ */
+constexpr size_t compressed_state_block_size = 256;
+
+/** @brief Compressed state passed to update kernels
+ *
+ *  A bf16 entry is the upper half of the fp32 value, rounded to
+ *  nearest even. An int8 entry is relative to the largest magnitude
+ *  in its block. Signed states are coded in [-127,127]. Non-negative
+ *  states, e.g. second moments, store their square root in [0,255],
+ *  which halves their dynamic range, rounded up so a decoded value
+ *  never underestimates the true one and cannot collapse a
+ *  denominator.
+ */
+struct compressed_state_view
+{
+  void* codes;
+  float* scales;
+  optimizer_state_format format;
+  bool is_signed;
+
+  /** Magnitude of an entry in the coded domain */
+  LBANN_COMPRESSED_STATE_FUNC float magnitude(float x) const
+  {
+    return is_signed ? fabsf(x) : sqrtf(x > 0.f ? x : 0.f);
+  }
+
+  /** Decode entry @c pos */
+  LBANN_COMPRESSED_STATE_FUNC float decode(size_t pos) const
+  {
+    if (format == optimizer_state_format::bf16) {
+      const uint32_t bits =
+        static_cast<uint32_t>(static_cast<const uint16_t*>(codes)[pos]) << 16;
+      float x;
+      memcpy(&x, &bits, sizeof(x));
+      return x;
+    }
+    const float scale = scales[pos / compressed_state_block_size];
+    if (is_signed) {
+      return static_cast<const int8_t*>(codes)[pos] * (scale / 127.f);
+    }
+    const float r = static_cast<const uint8_t*>(codes)[pos] * (scale / 255.f);
+    return r * r;
+  }
+
+  /** @brief Encode entry @c pos
+   *  @param scale Largest magnitude in the block of @c pos. Ignored
+   *  for bf16.
+   */
+  LBANN_COMPRESSED_STATE_FUNC void
+  encode(size_t pos, float x, float scale) const
+  {
+    if (format == optimizer_state_format::bf16) {
+      uint32_t bits;
+      memcpy(&bits, &x, sizeof(bits));
+      if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        bits |= 0x00400000u; // Keep NaNs quiet after truncation
+      }
+      else {
+        bits += 0x7fffu + ((bits >> 16) & 1u);
+      }
+      static_cast<uint16_t*>(codes)[pos] = static_cast<uint16_t>(bits >> 16);
+      return;
+    }
+    const float inv_scale = (scale > 0.f ? 1.f / scale : 0.f);
+    if (is_signed) {
+      float c = roundf(x * inv_scale * 127.f);
+      c = (c < -127.f ? -127.f : (c > 127.f ? 127.f : c));
+      static_cast<int8_t*>(codes)[pos] = static_cast<int8_t>(c);
+    }
+    else {
+      float c = ceilf(magnitude(x) * inv_scale * 255.f);
+      c = (c > 255.f ? 255.f : c);
+      static_cast<uint8_t*>(codes)[pos] = static_cast<uint8_t>(c);
+    }
+  }
+};
+
+/** @brief Local entries of an optimizer state tensor in a compressed
+ *         format
+ *
+ *  The codes and, for int8, the block scales live in float matrices
+ *  on the same device as the weights. Blocks follow the column-major
+ *  order of the local entries.
+ */
+class compressed_state
+{
+public:
+  compressed_state(optimizer_state_format format, bool is_signed);
+  compressed_state(const compressed_state& other);
+  compressed_state& operator=(const compressed_state& other);
+  ~compressed_state() = default;
+
+  optimizer_state_format get_format() const noexcept { return m_format; }
+  /** Number of local entries */
+  size_t size() const noexcept { return m_size; }
+  /** Bytes of device memory used by the codes and scales */
+  size_t get_memory_usage() const;
+
+  /** @brief Allocate zero-valued storage
+   *  @param like Tensor with the distribution and the device of the
+   *  state, e.g. the gradient.
+   *  @throws lbann::exception If the data type is not float or double.
+   */
+  template <typename TensorDataType>
+  void setup(const El::AbstractDistMatrix<TensorDataType>& like);
+
+  /** @brief Compress a full state tensor and free it
+   *  @details E.g. after loading a checkpoint. The storage is set up
+   *  like @c state.
+   */
+  template <typename TensorDataType>
+  void compress(El::AbstractDistMatrix<TensorDataType>& state);
+  /** @brief Decompress into a full state tensor
+   *  @details E.g. to checkpoint it. @c state must have the
+   *  distribution it was compressed from.
+   */
+  template <typename TensorDataType>
+  void decompress(El::AbstractDistMatrix<TensorDataType>& state) const;
+
+  /** View for update kernels */
+  compressed_state_view get_view();
+
+  /** Codes, packed into floats */
+  El::AbstractMatrix<float>& get_codes() { return *m_codes; }
+  /** Block scales. Empty unless the format is int8. */
+  El::AbstractMatrix<float>& get_scales() { return *m_scales; }
+
+private:
+  optimizer_state_format m_format;
+  bool m_signed;
+  /** Global dimensions of the state tensor */
+  El::Int m_global_height = 0;
+  El::Int m_global_width = 0;
+  /** Local dimensions of the state tensor */
+  El::Int m_height = 0;
+  El::Int m_width = 0;
+  size_t m_size = 0;
+  std::unique_ptr<El::AbstractMatrix<float>> m_codes;
+  std::unique_ptr<El::AbstractMatrix<float>> m_scales;
+};
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_COMPRESSED_STATE_HPP_INCLUDED
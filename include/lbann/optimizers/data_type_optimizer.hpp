@@ -41,6 +41,42 @@ namespace lbann {
 template <typename TensorDataType>
 class data_type_weights;
 
+/** @brief Local tensors of one optimizer in a fused step.
+ *
+ *  The tensors are contiguous and have @c size entries. The meaning
+ *  of the state tensors and scalars depends on the optimizer. The
+ *  gradient is multiplied by @c gradient_scale, e.g. for gradient
+ *  clipping, and @c l2_scale times the value is added to it (L2
+ *  regularization). The value is then multiplied by @c decay_scale
+ *  (decoupled weight decay).
+ */
+template <typename TensorDataType>
+struct fused_step_entry
+{
+  TensorDataType* values;
+  const TensorDataType* gradient;
+  TensorDataType* state[2];
+  size_t size;
+  TensorDataType scalars[4];
+  TensorDataType gradient_scale = TensorDataType(1.);
+  TensorDataType l2_scale = TensorDataType(0.);
+  TensorDataType decay_scale = TensorDataType(1.);
+};
+
+/** @brief Rounding of the values updated by a fused step
+ *
+ *  With stochastic rounding, each updated fp16 value is rounded up
+ *  or down with random bits hashed from @c seed, the position of the
+ *  entry, and its old value and update, so every process holding a
+ *  copy of the entry makes the same choice.
+ */
+struct fused_step_rounding
+{
+  bool stochastic = false;
+  /** @brief Changes with every step. */
+  uint64_t seed = 0;
+};
+
 template <typename TensorDataType>
 class data_type_optimizer
   : public Cloneable<HasAbstractFunction<data_type_optimizer<TensorDataType>>,
@@ -102,10 +138,56 @@ public:
 
   /** @brief Optimization step. */
   void step() override;
+
+  /** @brief Whether the step can be fused.
+   *
+   *  The values must be on GPU and the optimizer must support fused
+   *  steps, see add_fused_step_entry.
+   */
+  bool can_fuse_step() const final;
+
+  /** @brief Whether the step can be overlapped.
+   *
+   *  The values must not be distributed over several processes,
+   *  so that the step is purely local, and the gradient must not
+   *  be sharded.
+   */
+  bool can_overlap_step() const final;
+
+  /** @brief Optimization steps of a group of optimizers.
+   *
+   *  The local tensors of every optimizer are updated with a single
+   *  multi-tensor kernel launch, or with a few if there are many
+   *  tensors or they are large. Optimizers whose tensors are not
+   *  contiguous perform their own step.
+   */
+  void fused_step(std::vector<optimizer*> const& group) final;
+
+  /** @brief Local contribution to the squared norm of the gradients
+   *         of a group of optimizers.
+   *
+   *  GPU gradients are reduced with a single multi-tensor kernel
+   *  launch, or with a few if there are many tensors or they are
+   *  large.
+   */
+  EvalType
+  get_local_gradient_sqnorm(std::vector<optimizer*> const& group) final;
+
+  /** @brief Undo loss scaling of the gradient. */
+  bool unscale_gradient(EvalType scale) override;
+
+  /** @brief State tensors, which have the distribution of the
+   *         gradient.
+   *
+   *  Null entries are state that has not been allocated. Compressed
+   *  state is not included. Used to pack the state of several
+   *  optimizers into flat buffers, see flat_weights_state.
+   */
+  virtual std::vector<AbsDistMatrixType*> get_state_tensors() { return {}; }
   ///@}
 
   /** @brief Access the scaling factor for optimization step sizes. */
-  double get_learning_rate() const final;
+  double get_learning_rate() const override;
   /** @brief Set the scaling factor for optimization step sizes. */
   void set_learning_rate(double learning_rate) override;
 
@@ -129,12 +211,72 @@ protected:
   virtual void step_compute(AbsDistMatrixType& values,
                             const AbsDistMatrixType& gradient) = 0;
 
+  /** @brief Whether the optimizer implements fused steps. */
+  virtual bool supports_fused_step() const { return false; }
+
+  /** @brief Add the tensors of an optimization step to a fused step.
+   *
+   *  @c values and @c gradient are contiguous. Any state of the
+   *  optimizer is advanced as in step_compute.
+   *
+   *  @returns Whether an entry was added. If not, the step has not
+   *  been advanced and step_compute is used instead.
+   */
+  virtual bool add_fused_step_entry(
+    AbsDistMatrixType& /*values*/,
+    const AbsDistMatrixType& /*gradient*/,
+    std::vector<fused_step_entry<TensorDataType>>& /*entries*/)
+  {
+    return false;
+  }
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Launch a fused step on the entries of a group.
+   *
+   *  The entries were added by optimizers of this type.
+   */
+  virtual void fused_step_gpu(
+    std::vector<fused_step_entry<TensorDataType>> const& /*entries*/,
+    El::SyncInfo<El::Device::GPU> const& /*sync_info*/)
+  {}
+
+  /** @brief Rounding of the next fused step launched by this
+   *         optimizer.
+   */
+  fused_step_rounding next_fused_step_rounding() noexcept
+  {
+    return {this->get_stochastic_rounding(), m_rounding_step++};
+  }
+#endif // LBANN_HAS_GPU
+
   /** @brief Get the info needed to construct a new gradient matrix.
    *  @return Tuple of height, width, and DistData.
    */
   std::tuple<El::Int, El::Int, El::DistData> get_matrix_info() const final;
 
+  /** @brief The distribution of the values of sharded weights. */
+  std::optional<El::DistData> get_gradient_shard_distribution() const final;
+
 private:
+  /** @brief Apply L2 regularization and weight decay outside of the
+   *         update kernel.
+   *
+   *  Used by steps that are not fused. The L2 term is added to the
+   *  gradient contributions, which is an extra pass over them.
+   */
+  void regularize(AbsDistMatrixType& values);
+
+#ifdef LBANN_HAS_GPU
+  /** @brief Sum of squares of the gradients of fused step entries.
+   *
+   *  Only the gradients and sizes of the entries are used. The host
+   *  waits for the result.
+   */
+  static EvalType gradient_sqsum_gpu(
+    std::vector<fused_step_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info);
+#endif // LBANN_HAS_GPU
+
   /** @brief Weights being optimized. */
   data_type_weights<TensorDataType>* m_weights = nullptr;
 
@@ -149,6 +291,14 @@ private:
    */
   std::unique_ptr<AbsDistMatrixType> m_gradient_v;
 
+  /** @brief Host copy of the values of weights on GPU.
+   *
+   *  Only set if the weights offload the optimizer (see
+   *  weights::set_offload_optimizer). The gradient, and hence the
+   *  optimizer state, is then in host memory as well.
+   */
+  std::unique_ptr<AbsDistMatrixType> m_host_values;
+
   /** @brief Communication request object for gradient allreduce.
    *
    *  Used to synchronize non-blocking allreduce.
@@ -165,6 +315,13 @@ private:
    *  @todo Consider moving this to the derived classes.
    */
   double m_learning_rate;
+
+  /** @brief Fused steps launched, which seed stochastic rounding.
+   *
+   *  Not checkpointed, so rounding after a restart differs from an
+   *  uninterrupted run.
+   */
+  uint64_t m_rounding_step = 0;
 };
 
 #ifndef LBANN_DATA_TYPE_OPTIMIZER_INSTANTIATE
@@ -27,12 +27,20 @@
 #ifndef LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_IMPL_HPP_INCLUDED
 #define LBANN_OPTIMIZERS_DATA_TYPE_OPTIMIZER_IMPL_HPP_INCLUDED
 
+#include "lbann/utils/omp_pragma.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
 #include "lbann/weights/data_type_weights.hpp"
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/sync_info_helpers.hpp"
+#endif // LBANN_HAS_GPU
 
 #include "lbann/optimizers/data_type_optimizer.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
 namespace lbann {
 
 template <typename TensorDataType>
@@ -48,7 +56,10 @@ data_type_optimizer<TensorDataType>::data_type_optimizer(
     m_weights(other.m_weights),
     m_gradient(other.m_gradient ? other.m_gradient->Copy() : nullptr),
     m_gradient_v(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr),
-    m_learning_rate(other.m_learning_rate)
+    m_host_values(other.m_host_values ? other.m_host_values->Copy()
+                                      : nullptr),
+    m_learning_rate(other.m_learning_rate),
+    m_rounding_step(other.m_rounding_step)
 {}
 
 template <typename TensorDataType>
@@ -60,7 +71,10 @@ data_type_optimizer<TensorDataType>::operator=(
   m_weights = other.m_weights;
   m_gradient.reset(other.m_gradient ? other.m_gradient->Copy() : nullptr);
   m_gradient_v.reset(other.m_gradient_v ? other.m_gradient_v->Copy() : nullptr);
+  m_host_values.reset(other.m_host_values ? other.m_host_values->Copy()
+                                          : nullptr);
   m_learning_rate = other.m_learning_rate;
+  m_rounding_step = other.m_rounding_step;
   return *this;
 }
 
@@ -68,7 +82,7 @@ template <typename TensorDataType>
 description data_type_optimizer<TensorDataType>::get_description() const
 {
   description desc = optimizer::get_description();
-  desc.add("Learning rate", m_learning_rate);
+  desc.add("Learning rate", get_learning_rate());
   return desc;
 }
 
@@ -144,7 +158,30 @@ void data_type_optimizer<TensorDataType>::setup_base(WeightsType* w)
   const auto& height = m_weights->get_matrix_height();
   const auto& width = m_weights->get_matrix_width();
   const AbsDistMatrixType& values = m_weights->get_values();
-  m_gradient.reset(AbsDistMatrixType::Instantiate(values.DistData()));
+  auto gradient_dist = values.DistData();
+  m_host_values.reset();
+#ifdef LBANN_HAS_GPU
+  // Optimizers create their state with the gradient's distribution,
+  // so an offloaded optimizer keeps it in host memory
+  if (m_weights->get_offload_optimizer() &&
+      values.GetLocalDevice() == El::Device::GPU) {
+    gradient_dist.device = El::Device::CPU;
+    m_host_values.reset(AbsDistMatrixType::Instantiate(gradient_dist));
+    m_host_values->AlignWith(values);
+    m_host_values->Resize(height, width);
+  }
+#endif // LBANN_HAS_GPU
+#ifdef LBANN_HAS_GPU_FP16
+  // Stochastic rounding is implemented in the fused update kernels
+  if (std::is_same_v<TensorDataType, fp16> &&
+      this->get_stochastic_rounding() && !this->can_fuse_step()) {
+    LBANN_ERROR("stochastic rounding of the fp16 weights \"",
+                w->get_name(),
+                "\" requires an SGD, Adam, AdaGrad or RMSprop optimizer ",
+                "whose state is kept on GPU");
+  }
+#endif // LBANN_HAS_GPU_FP16
+  m_gradient.reset(AbsDistMatrixType::Instantiate(gradient_dist));
   m_gradient->AlignWith(values);
   m_gradient->Resize(height, width);
   m_gradient_v.reset(AbsDistMatrixType::Instantiate(values.DistData()));
@@ -175,11 +212,224 @@ void data_type_optimizer<TensorDataType>::step()
   if (m_weights == nullptr) {
     LBANN_ERROR("attempted to perform optimization step without weights");
   }
+#ifdef LBANN_HAS_GPU
+  // Only fused updates can round stochastically
+  if (this->get_stochastic_rounding() && this->can_fuse_step()) {
+    this->fused_step({this});
+    return;
+  }
+#endif // LBANN_HAS_GPU
   const auto start_time = get_time();
-  this->step_compute(m_weights->get_values(), this->get_gradient());
+  if (this->m_gradient_scale != EvalType(1)) {
+    this->get_gradient();
+    this->scale_gradient_contributions(this->m_gradient_scale);
+    this->m_gradient_scale = 1;
+  }
+  this->regularize(m_weights->get_values());
+  if (m_host_values != nullptr) {
+    // Run the CPU kernels on a host copy of the values
+    auto& gradient = this->get_gradient();
+    auto& values = m_weights->get_values();
+    El::Copy(values, *m_host_values);
+    this->step_compute(*m_host_values, gradient);
+    El::Copy(*m_host_values, values);
+  }
+  else {
+    this->step_compute(m_weights->get_values(), this->get_gradient());
+  }
   this->inc_step_time(get_time() - start_time);
 }
 
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::regularize(AbsDistMatrixType& values)
+{
+  const double l2 = this->get_l2_regularization();
+  if (l2 != 0.) {
+    this->get_gradient();
+    this->add_to_gradient(values,
+                          El::To<TensorDataType>(l2),
+                          /*allreduce_needed=*/false);
+  }
+  const double decay = this->get_decoupled_weight_decay();
+  if (decay != 0.) {
+    El::Scale(El::To<TensorDataType>(1. - get_learning_rate() * decay),
+              values);
+  }
+}
+
+template <typename TensorDataType>
+bool data_type_optimizer<TensorDataType>::can_fuse_step() const
+{
+#ifdef LBANN_HAS_GPU
+  return (m_weights != nullptr && m_host_values == nullptr &&
+          m_weights->get_values().GetLocalDevice() == El::Device::GPU &&
+          this->supports_fused_step());
+#else
+  return false;
+#endif // LBANN_HAS_GPU
+}
+
+template <typename TensorDataType>
+bool data_type_optimizer<TensorDataType>::can_overlap_step() const
+{
+  return (m_weights != nullptr && m_weights->get_values().DistSize() == 1 &&
+          !this->get_gradient_shard_distribution());
+}
+
+template <typename TensorDataType>
+void data_type_optimizer<TensorDataType>::fused_step(
+  std::vector<optimizer*> const& group)
+{
+#ifdef LBANN_HAS_GPU
+  // The optimizers that round differently are fused separately
+  const auto same_rounding = [this](optimizer const* o) {
+    return o->get_stochastic_rounding() == this->get_stochastic_rounding();
+  };
+  if (!std::all_of(group.begin(), group.end(), same_rounding)) {
+    std::vector<optimizer*> others;
+    std::vector<optimizer*> members;
+    for (auto* o : group) {
+      (same_rounding(o) ? members : others).push_back(o);
+    }
+    others.front()->fused_step(others);
+    this->fused_step(members);
+    return;
+  }
+
+  const auto start_time = get_time();
+
+  // Gather the local tensors, after their gradients are ready
+  std::vector<fused_step_entry<TensorDataType>> entries;
+  std::vector<El::SyncInfo<El::Device::GPU>> sync_infos;
+  entries.reserve(group.size());
+  for (auto* o : group) {
+    auto& opt = dynamic_cast<data_type_optimizer<TensorDataType>&>(*o);
+    auto& values = opt.get_weights().get_values();
+    const auto& gradient = opt.get_gradient();
+    if (!values.Contiguous() || !gradient.Contiguous() ||
+        !opt.add_fused_step_entry(values, gradient, entries)) {
+      if (opt.m_gradient_scale != EvalType(1)) {
+        opt.scale_gradient_contributions(opt.m_gradient_scale);
+        opt.m_gradient_scale = 1;
+      }
+      opt.regularize(values);
+      opt.step_compute(values, opt.get_gradient());
+      continue;
+    }
+    auto& entry = entries.back();
+    entry.gradient_scale = El::To<TensorDataType>(opt.m_gradient_scale);
+    entry.l2_scale = El::To<TensorDataType>(opt.get_l2_regularization());
+    entry.decay_scale = El::To<TensorDataType>(
+      1. - opt.get_learning_rate() * opt.get_decoupled_weight_decay());
+    opt.m_gradient_scale = 1;
+    sync_infos.push_back(gpu::get_sync_info(values));
+    sync_infos.push_back(gpu::get_sync_info(gradient));
+  }
+  if (entries.empty()) {
+    this->inc_step_time(get_time() - start_time);
+    return;
+  }
+
+  // Launch on the stream of the first values, ordered with the
+  // streams of the other tensors
+  const auto sync_info = sync_infos.front();
+  for (const auto& si : sync_infos) {
+    if (si.Stream() != sync_info.Stream()) {
+      El::AddSynchronizationPoint(si, sync_info);
+    }
+  }
+  fused_step_gpu(entries, sync_info);
+  for (const auto& si : sync_infos) {
+    if (si.Stream() != sync_info.Stream()) {
+      El::AddSynchronizationPoint(sync_info, si);
+    }
+  }
+  this->inc_step_time(get_time() - start_time);
+#else
+  optimizer::fused_step(group);
+#endif // LBANN_HAS_GPU
+}
+
+template <typename TensorDataType>
+EvalType data_type_optimizer<TensorDataType>::get_local_gradient_sqnorm(
+  std::vector<optimizer*> const& group)
+{
+  EvalType sqnorm = 0;
+#ifdef LBANN_HAS_GPU
+  std::vector<fused_step_entry<TensorDataType>> entries;
+  std::vector<El::SyncInfo<El::Device::GPU>> sync_infos;
+#endif // LBANN_HAS_GPU
+  for (size_t i = 0; i < group.size(); ++i) {
+    auto& opt = dynamic_cast<data_type_optimizer<TensorDataType>&>(*group[i]);
+    const auto& gradient = opt.get_gradient();
+
+    // Only one of the processes holding a copy of an entry counts it
+    if (!gradient.Participating() ||
+        gradient.RedundantRank() != static_cast<int>(
+                                      i % gradient.RedundantSize())) {
+      continue;
+    }
+    const size_t local_height = gradient.LocalHeight();
+    const size_t local_width = gradient.LocalWidth();
+    const size_t ldim = gradient.LDim();
+    const auto* __restrict__ buffer = gradient.LockedBuffer();
+#ifdef LBANN_HAS_GPU
+    if (gradient.GetLocalDevice() == El::Device::GPU) {
+      // Columns of a non-contiguous gradient are separate tensors
+      const bool contiguous = gradient.Contiguous();
+      for (size_t col = 0; col < (contiguous ? 1 : local_width); ++col) {
+        fused_step_entry<TensorDataType> entry = {};
+        entry.gradient = buffer + col * ldim;
+        entry.size = (contiguous ? local_height * local_width : local_height);
+        entries.push_back(entry);
+      }
+      sync_infos.push_back(gpu::get_sync_info(gradient));
+      continue;
+    }
+#endif // LBANN_HAS_GPU
+    EvalType sqsum = 0;
+    LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : sqsum) collapse(2))
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        const auto g = El::To<EvalType>(buffer[row + col * ldim]);
+        sqsum += g * g;
+      }
+    }
+    sqnorm += sqsum;
+  }
+#ifdef LBANN_HAS_GPU
+  if (!entries.empty()) {
+    // Reduce on the stream of the first gradient
+    const auto sync_info = sync_infos.front();
+    for (const auto& si : sync_infos) {
+      if (si.Stream() != sync_info.Stream()) {
+        El::AddSynchronizationPoint(si, sync_info);
+      }
+    }
+    sqnorm += gradient_sqsum_gpu(entries, sync_info);
+  }
+#endif // LBANN_HAS_GPU
+  return sqnorm;
+}
+
+template <typename TensorDataType>
+bool data_type_optimizer<TensorDataType>::unscale_gradient(EvalType scale)
+{
+  // Check the accumulated gradient, which has the precision of the
+  // weights rather than of the layers that contributed to it
+  const auto norm = El::Nrm2(this->get_gradient());
+  if (!std::isfinite(static_cast<double>(norm))) {
+    return false;
+  }
+
+  // Scale the contributions, since the gradient may be a view of one
+  // of them. The gradient is accumulated again in the step.
+  if (scale != EvalType(1)) {
+    this->scale_gradient_contributions(EvalType(1) / scale);
+  }
+  return true;
+}
+
 template <typename TensorDataType>
 std::tuple<El::Int, El::Int, El::DistData>
 data_type_optimizer<TensorDataType>::get_matrix_info() const
@@ -190,6 +440,17 @@ data_type_optimizer<TensorDataType>::get_matrix_info() const
           w.get_matrix_distribution()};
 }
 
+template <typename TensorDataType>
+std::optional<El::DistData>
+data_type_optimizer<TensorDataType>::get_gradient_shard_distribution() const
+{
+  auto const& w = this->get_weights();
+  if (!w.is_sharded()) {
+    return std::nullopt;
+  }
+  return w.get_values().DistData();
+}
+
 template <typename TensorDataType>
 template <class Archive>
 void data_type_optimizer<TensorDataType>::serialize(Archive& ar)
@@ -40,6 +40,11 @@ namespace lbann {
  *
  *  Baydin et al. "Online Learning Rate Adaptation with Hypergradient
  *  Descent", 2017.
+ *
+ *  On GPU, the learning rate is kept on the device and updated there
+ *  by each step, so steps do not wait for the dot product of the
+ *  gradients. Reading the learning rate from the host waits for the
+ *  device.
  */
 template <typename TensorDataType>
 class hypergradient_adam : public Cloneable<hypergradient_adam<TensorDataType>,
@@ -98,6 +103,21 @@ public:
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_moment1.get(), m_moment2.get(), m_old_gradient.get()};
+  }
+
+  /** @brief Access the current learning rate.
+   *  @details Waits for the device if the learning rate is on the
+   *  device.
+   */
+  double get_learning_rate() const override;
+  /** @brief Set the learning rate, on the device if it is kept
+   *         there.
+   */
+  void set_learning_rate(double learning_rate) override;
+
   /** Add optimizer data to prototext */
   void write_proto(lbann_data::Optimizer& opt) const final;
 
@@ -106,6 +126,18 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+private:
+  /** @brief CPU implementation of optimization step. */
+  void step_compute_cpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient,
+                        const TensorDataType& correction);
+#ifdef LBANN_HAS_GPU
+  /** @brief GPU implementation of optimization step. */
+  void step_compute_gpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient,
+                        const TensorDataType& correction);
+#endif // LBANN_HAS_GPU
+
 private:
   /** @brief Hypergradient learning rate. */
   TensorDataType m_hyper_learning_rate;
@@ -125,6 +157,13 @@ private:
   std::unique_ptr<AbsDistMatrixType> m_moment2;
   /** @brief Gradient estimate from the prior step (for hypergradient). */
   std::unique_ptr<AbsDistMatrixType> m_old_gradient;
+#ifdef LBANN_HAS_GPU
+  /** @brief Learning rate on the device.
+   *  @details Empty unless the weights are on GPU, in which case it
+   *  supersedes the learning rate of the base class.
+   */
+  El::Matrix<EvalType, El::Device::GPU> m_device_learning_rate;
+#endif // LBANN_HAS_GPU
 };
 
 template <typename TensorDataType>
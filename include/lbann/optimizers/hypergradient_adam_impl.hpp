@@ -36,6 +36,8 @@ template <typename TensorDataType>
 template <class Archive>
 void hypergradient_adam<TensorDataType>::serialize(Archive& ar)
 {
+  // The base class archives the learning rate on the host
+  OptimizerType::set_learning_rate(this->get_learning_rate());
   ar(cereal::base_class<data_type_optimizer<TensorDataType>>(this),
      CEREAL_NVP(m_hyper_learning_rate),
      CEREAL_NVP(m_beta1),
@@ -46,6 +48,7 @@ void hypergradient_adam<TensorDataType>::serialize(Archive& ar)
      CEREAL_NVP(m_moment1),
      CEREAL_NVP(m_moment2),
      CEREAL_NVP(m_old_gradient));
+  this->set_learning_rate(OptimizerType::get_learning_rate());
 }
 
 } // namespace lbann
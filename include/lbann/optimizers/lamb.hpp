@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
+
+#include "lbann/io/persist.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/proto/optimizers.pb.h"
+
+namespace lbann {
+
+/** @brief Layer-wise adaptive moments (LAMB) optimizer.
+ *
+ *  Adam with decoupled weight decay, where the update @f$r@f$ of
+ *  each weights tensor is scaled by the trust ratio
+ *  @f$\lVert w \rVert / \lVert r \rVert@f$. The trust ratio is one
+ *  if either norm is zero. The norms are computed over the whole
+ *  tensor, even if it is distributed.
+ *
+ *  Reference:
+ *
+ *  Yang You, Jing Li, Sashank Reddi, Jonathan Hseu, Sanjiv Kumar,
+ *  Srinadh Bhojanapalli, Xiaodan Song, James Demmel, Kurt Keutzer,
+ *  and Cho-Jui Hsieh. "Large batch optimization for deep learning:
+ *  Training BERT in 76 minutes." arXiv preprint arXiv:1904.00962
+ *  (2019).
+ */
+template <typename TensorDataType>
+class lamb
+  : public Cloneable<lamb<TensorDataType>, data_type_optimizer<TensorDataType>>
+{
+  using BaseType =
+    Cloneable<lamb<TensorDataType>, data_type_optimizer<TensorDataType>>;
+
+public:
+  /** @name Public Types */
+  ///@{
+
+  /** @brief The tensor type expected in this object. */
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+
+  /** @brief The optimizer base type of this object. */
+  using OptimizerType = data_type_optimizer<TensorDataType>;
+
+  /** @brief The concrete weights type used by this object. */
+  using WeightsType = data_type_weights<TensorDataType>;
+
+  ///@}
+
+public:
+  /** @name Life cycle functions */
+  ///@{
+
+  lamb(TensorDataType learning_rate,
+       TensorDataType beta1 = 0.9,
+       TensorDataType beta2 = 0.999,
+       TensorDataType eps = 1e-6,
+       TensorDataType weight_decay = 0);
+  lamb(const lamb& other);
+  lamb& operator=(const lamb& other);
+  ~lamb() override = default;
+
+  ///@}
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Serialize to the archive. */
+  template <class ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+  /** @name Descriptions */
+  ///@{
+
+  /** Human-readable type name. */
+  std::string get_type() const override { return "LAMB"; }
+  /** Human-readable description. */
+  description get_description() const override;
+
+  ///@}
+  /** @name Access functions */
+  ///@{
+
+  /** First moment estimates. */
+  const AbsDistMatrixType& get_moment1() const;
+  /** First moment estimates. */
+  AbsDistMatrixType& get_moment1();
+  /** Second moment estimates. */
+  const AbsDistMatrixType& get_moment2() const;
+  /** Second moment estimates. */
+  AbsDistMatrixType& get_moment2();
+
+  ///@}
+  /** @name Setup */
+  ///@{
+
+  using OptimizerType::setup;
+  void setup(WeightsType* w = nullptr) override;
+
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_moment1.get(), m_moment2.get()};
+  }
+
+  ///@}
+
+  /** Add optimizer data to prototext */
+  void write_proto(lbann_data::Optimizer& opt) const final;
+
+protected:
+  /** @brief Default constructor.
+   *  @details This constructor exists as an implementation detail of
+   *  the serialization code. It is not for general use.
+   */
+  lamb() : lamb(El::To<TensorDataType>(0.f)) {}
+
+  /** Computation for an optimization step. */
+  void step_compute(AbsDistMatrixType& values,
+                    const AbsDistMatrixType& gradient) override;
+
+private:
+  /** Update factor for first moment estimate. */
+  TensorDataType m_beta1;
+  /** Update factor for second moment estimate. */
+  TensorDataType m_beta2;
+  /** Small factor to avoid division by zero. */
+  TensorDataType m_eps;
+  /** @brief Decoupled weight decay factor.
+   *  @details Added to the update before the trust ratio is applied.
+   */
+  TensorDataType m_weight_decay;
+  /** beta1 ^ iteration. */
+  TensorDataType m_current_beta1 = TensorDataType(1.);
+  /** beta2 ^ iteration. */
+  TensorDataType m_current_beta2 = TensorDataType(1.);
+  /** First moment estimates. */
+  std::unique_ptr<AbsDistMatrixType> m_moment1;
+  /** Second moment estimates. */
+  std::unique_ptr<AbsDistMatrixType> m_moment2;
+
+  /** CPU implementation of optimization step. */
+  void step_compute_cpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#ifdef LBANN_HAS_GPU
+  /** GPU implementation of optimization step. */
+  void step_compute_gpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#endif // LBANN_HAS_GPU
+
+  friend class cereal::access;
+};
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lamb_optimizer_from_pbuf(google::protobuf::Message const&);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_LAMB_HPP_INCLUDED
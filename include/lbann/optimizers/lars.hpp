@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
+#define LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
+
+#include "lbann/io/persist.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/proto/optimizers.pb.h"
+
+namespace lbann {
+
+/** @brief Layer-wise adaptive rate scaling (LARS) optimizer.
+ *
+ *  Momentum SGD where the learning rate of each weights tensor is
+ *  scaled by a trust ratio,
+ *  @f[
+ *    \text{trust} = \eta \frac{\lVert w \rVert}
+ *                      {\lVert g \rVert + \lambda \lVert w \rVert + \epsilon},
+ *  @f]
+ *  so that the step size follows the scale of the weights. The trust
+ *  ratio is one if either norm is zero. The norms are computed over
+ *  the whole tensor, even if it is distributed.
+ *
+ *  Reference:
+ *
+ *  Yang You, Igor Gitman, and Boris Ginsburg. "Large batch training
+ *  of convolutional networks." arXiv preprint arXiv:1708.03888
+ *  (2017).
+ */
+template <typename TensorDataType>
+class lars
+  : public Cloneable<lars<TensorDataType>, data_type_optimizer<TensorDataType>>
+{
+  using BaseType =
+    Cloneable<lars<TensorDataType>, data_type_optimizer<TensorDataType>>;
+
+public:
+  /** @name Public Types */
+  ///@{
+
+  /** @brief The tensor type expected in this object. */
+  using AbsDistMatrixType = El::AbstractDistMatrix<TensorDataType>;
+
+  /** @brief The optimizer base type of this object. */
+  using OptimizerType = data_type_optimizer<TensorDataType>;
+
+  /** @brief The concrete weights type used by this object. */
+  using WeightsType = data_type_weights<TensorDataType>;
+
+  ///@}
+
+public:
+  /** @name Life cycle functions */
+  ///@{
+
+  lars(TensorDataType learning_rate,
+       TensorDataType momentum = 0.9,
+       TensorDataType weight_decay = 0,
+       TensorDataType trust_coefficient = 0.001,
+       TensorDataType eps = 0);
+  lars(const lars& other);
+  lars& operator=(const lars& other);
+  ~lars() override = default;
+
+  ///@}
+  /** @name Serialization */
+  ///@{
+
+  /** @brief Serialize to the archive. */
+  template <class ArchiveT>
+  void serialize(ArchiveT& ar);
+
+  ///@}
+  /** @name Descriptions */
+  ///@{
+
+  /** Human-readable type name. */
+  std::string get_type() const override { return "LARS"; }
+  /** Human-readable description. */
+  description get_description() const override;
+
+  ///@}
+  /** @name Access functions */
+  ///@{
+
+  /** Decay rate for gradient accumulation. */
+  TensorDataType get_momentum() const noexcept { return m_momentum; }
+  /** Decay rate for gradient accumulation. */
+  void set_momentum(TensorDataType momentum) { m_momentum = momentum; }
+
+  /** Accumulated scaled gradients. */
+  const AbsDistMatrixType& get_velocity() const;
+  /** Accumulated scaled gradients. */
+  AbsDistMatrixType& get_velocity();
+
+  ///@}
+  /** @name Setup */
+  ///@{
+
+  using OptimizerType::setup;
+  void setup(WeightsType* w = nullptr) override;
+
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_velocity.get()};
+  }
+
+  ///@}
+
+  /** Add optimizer data to prototext */
+  void write_proto(lbann_data::Optimizer& opt) const final;
+
+protected:
+  /** @brief Default constructor.
+   *  @details This constructor exists as an implementation detail of
+   *  the serialization code. It is not for general use.
+   */
+  lars() : lars(El::To<TensorDataType>(0.f)) {}
+
+  /** Computation for an optimization step. */
+  void step_compute(AbsDistMatrixType& values,
+                    const AbsDistMatrixType& gradient) override;
+
+private:
+  /** Decay rate for gradient accumulation. */
+  TensorDataType m_momentum;
+  /** @brief L2 regularization factor.
+   *  @details Applied to the gradient before it is accumulated.
+   */
+  TensorDataType m_weight_decay;
+  /** Scaling factor of the trust ratio (@f$\eta@f$). */
+  TensorDataType m_trust_coefficient;
+  /** Small factor to avoid division by zero. */
+  TensorDataType m_eps;
+  /** Accumulated scaled gradients. */
+  std::unique_ptr<AbsDistMatrixType> m_velocity;
+
+  /** CPU implementation of optimization step. */
+  void step_compute_cpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#ifdef LBANN_HAS_GPU
+  /** GPU implementation of optimization step. */
+  void step_compute_gpu(AbsDistMatrixType& values,
+                        const AbsDistMatrixType& gradient);
+#endif // LBANN_HAS_GPU
+
+  friend class cereal::access;
+};
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lars_optimizer_from_pbuf(google::protobuf::Message const&);
+
+} // namespace lbann
+
+#endif // LBANN_OPTIMIZERS_LARS_HPP_INCLUDED
@@ -37,10 +37,14 @@
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/memory.hpp"
 
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <tuple>
 #include <typeindex>
 #include <unordered_set>
+#include <vector>
 
 namespace lbann_data {
 class Optimizer;
@@ -73,6 +77,7 @@ std::string to_string(optimizer_gradient_status status);
 class lbann_comm;
 class persist;
 class weights;
+class gradient_bucket_manager;
 
 /** @brief Abstract base class for gradient-based optimization algorithms.
  *
@@ -147,9 +152,150 @@ public:
    */
   void remove_gradient_source(const void* source);
 
+  /** @brief Do not launch the allreduce when the last gradient source
+   *         is removed.
+   *
+   *  Contributions keep accumulating locally until the allreduce is
+   *  started after the deferral ends, or when the gradient is
+   *  accessed.
+   */
+  void set_gradient_allreduce_deferred(bool deferred) noexcept
+  {
+    m_gradient_allreduce_deferred = deferred;
+  }
+
   /** @brief Perform optimization step. */
   virtual void step() = 0;
 
+  /** @brief Whether the step can be fused with the steps of other
+   *         optimizers of the same dynamic type.
+   *
+   *  See fused_step.
+   */
+  virtual bool can_fuse_step() const { return false; }
+
+  /** @brief Whether the step can run while the gradients of other
+   *         optimizers are being allreduced.
+   *
+   *  The step must not perform any collective communication, since
+   *  overlapped steps run in a different order on each process.
+   */
+  virtual bool can_overlap_step() const { return false; }
+
+  /** @brief Launch the non-blocking allreduces on the gradient.
+   *
+   *  Unlike the allreduce started when the last gradient source is
+   *  removed, a bucketed gradient is launched right away, so that
+   *  completing the allreduce never requires communication.
+   */
+  void launch_gradient_allreduce();
+
+  /** @brief Whether the allreduces on the gradient have completed.
+   *
+   *  Never launches communication. Returns false if an allreduce
+   *  has not been launched.
+   */
+  bool test_gradient_allreduce();
+
+  /** @brief Perform the optimization steps of a group of optimizers.
+   *
+   *  Every optimizer in @c group has the dynamic type of this one
+   *  and can fuse its step. The default performs the steps one by
+   *  one.
+   */
+  virtual void fused_step(std::vector<optimizer*> const& group);
+
+  /** @brief Threshold on the global gradient norm.
+   *
+   *  Zero disables clipping. See model::clip_gradients.
+   */
+  double get_clip_gradient_norm() const noexcept
+  {
+    return m_clip_gradient_norm;
+  }
+  /** @brief Set the threshold on the global gradient norm. */
+  void set_clip_gradient_norm(double norm) noexcept
+  {
+    m_clip_gradient_norm = norm;
+  }
+
+  /** @brief Coefficient of the L2 regularization term.
+   *
+   *  The gradient is increased by this times the weights before the
+   *  update, as for an objective function term of half this times
+   *  the squared L2 norm of the weights.
+   */
+  double get_l2_regularization() const noexcept
+  {
+    return m_l2_regularization;
+  }
+  /** @brief Set the coefficient of the L2 regularization term. */
+  void set_l2_regularization(double l2) noexcept { m_l2_regularization = l2; }
+
+  /** @brief Decoupled weight decay rate.
+   *
+   *  The weights are multiplied by one minus the learning rate times
+   *  this before the update, as in AdamW.
+   */
+  double get_decoupled_weight_decay() const noexcept
+  {
+    return m_decoupled_weight_decay;
+  }
+  /** @brief Set the decoupled weight decay rate. */
+  void set_decoupled_weight_decay(double decay) noexcept
+  {
+    m_decoupled_weight_decay = decay;
+  }
+
+  /** @brief Whether updated values are rounded stochastically.
+   *
+   *  Only affects fp16 weights, which are then updated without a
+   *  higher-precision copy: each new value is rounded up or down
+   *  with probability proportional to its distance from the two
+   *  nearest fp16 values, so small updates are not lost on average.
+   */
+  bool get_stochastic_rounding() const noexcept
+  {
+    return m_stochastic_rounding;
+  }
+  /** @brief Set whether updated values are rounded stochastically. */
+  void set_stochastic_rounding(bool stochastic) noexcept
+  {
+    m_stochastic_rounding = stochastic;
+  }
+
+  /** @brief Local contribution to the squared norm of the gradients
+   *         of a group of optimizers.
+   *
+   *  Every optimizer in @c group has the dynamic type of this
+   *  one. Entries replicated over several processes are counted by
+   *  one of them, so summing the contributions over the trainer
+   *  counts every entry once. There is no communication, but the
+   *  gradient allreduces are completed.
+   */
+  virtual EvalType
+  get_local_gradient_sqnorm(std::vector<optimizer*> const& group);
+
+  /** @brief Scale the gradient in the next optimization step.
+   *
+   *  The scale is applied inside the update kernel of fused steps,
+   *  and to the gradient contributions otherwise. It is reset to one
+   *  after the step.
+   */
+  void set_gradient_scale(EvalType scale) noexcept
+  {
+    m_gradient_scale = scale;
+  }
+
+  /** @brief Undo loss scaling of the gradient.
+   *
+   *  Divides the gradient by @c scale. If the gradient has non-finite
+   *  values, e.g. due to overflow during backprop, it is left as is
+   *  and false is returned, in which case the optimization step
+   *  should be skipped.
+   */
+  virtual bool unscale_gradient(EvalType scale) = 0;
+
   /** @brief Get the gradient buffer.
    *
    *  This provides access to the underlying gradient buffer, which
@@ -189,6 +335,16 @@ public:
   /** @brief Access LBANN communicator. */
   const lbann_comm& get_comm() const { return *m_comm; }
 
+  /** @brief Pack gradients that support it into shared buckets.
+   *
+   *  Only affects gradient buffers that have not been created yet.
+   *  Pass nullptr to allreduce every gradient buffer on its own.
+   */
+  void set_gradient_buckets(gradient_bucket_manager* buckets) noexcept
+  {
+    m_gradient_buckets = buckets;
+  }
+
   ///@}
   /** @brief Statistics access and management */
   ///@{
@@ -223,38 +379,155 @@ public:
     virtual El::BaseDistMatrix const& gradient() const noexcept = 0;
     virtual void start_allreduce(lbann_comm&) = 0;
     virtual void complete_allreduce(lbann_comm&) = 0;
+    virtual void launch_allreduce(lbann_comm&) = 0;
+    virtual bool test_allreduce(lbann_comm&) = 0;
     virtual void clear() = 0;
+    virtual void scale(EvalType alpha) = 0;
 
   private:
     optimizer_gradient_status status_ = optimizer_gradient_status::cleared;
   }; // class GradientHelper
 
+  /** @brief Type-erased gradient bucket. */
+  class GradientBucketBase
+  {
+  public:
+    virtual ~GradientBucketBase() = default;
+    /** @brief Stop accepting gradients.
+     *
+     *  The bucket is allreduced as soon as all of its gradients are
+     *  ready for it, or when one of them is accessed.
+     */
+    virtual void seal(lbann_comm& comm) = 0;
+  }; // class GradientBucketBase
+
+  template <typename TensorDataType>
+  class GradientBucket;
+
   template <typename TensorDataType>
   class GradientHelperImpl : public GradientHelper
   {
   public:
     using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+    using BucketType = GradientBucket<TensorDataType>;
 
   public:
-    GradientHelperImpl(El::Int height, El::Int width, El::DistData dist_data)
+    /** @param shard_dist If set, contributions are reduce-scattered
+     *                   into a matrix with this distribution rather
+     *                   than allreduced.
+     */
+    GradientHelperImpl(El::Int height,
+                       El::Int width,
+                       El::DistData dist_data,
+                       std::optional<El::DistData> shard_dist = std::nullopt)
       : gradient_{AbsDistMatType::Instantiate(dist_data)}
     {
       El::Zeros(*gradient_, height, width);
+      if (shard_dist) {
+        shard_.reset(AbsDistMatType::Instantiate(*shard_dist));
+        El::Zeros(*shard_, height, width);
+      }
+    }
+    ~GradientHelperImpl() override;
+    /** @brief Reduced gradient. */
+    AbsDistMatType& gradient() noexcept override
+    {
+      return shard_ ? *shard_ : *gradient_;
     }
-    AbsDistMatType& gradient() noexcept override { return *gradient_; }
     AbsDistMatType const& gradient() const noexcept override
     {
-      return *gradient_;
+      return shard_ ? *shard_ : *gradient_;
     }
+    /** @brief Buffer into which contributions are summed. */
+    AbsDistMatType& contributions() noexcept { return *gradient_; }
+    /** @brief Whether contributions are reduce-scattered. */
+    bool sharded() const noexcept { return shard_ != nullptr; }
+    /** @brief Move the contributions into a bucket. */
+    void set_bucket(std::shared_ptr<BucketType> bucket);
     void start_allreduce(lbann_comm& comm) override;
     void complete_allreduce(lbann_comm& comm) override;
+    void launch_allreduce(lbann_comm& comm) override;
+    bool test_allreduce(lbann_comm& comm) override;
     void clear() override;
+    void scale(EvalType alpha) override;
 
   private:
     std::unique_ptr<AbsDistMatType> gradient_;
+    /** @brief Shard of the reduced gradient owned by this process. */
+    std::unique_ptr<AbsDistMatType> shard_;
+    /** @brief Bucket that holds the contributions, if any. */
+    std::shared_ptr<BucketType> bucket_;
     Al::request allreduce_req_;
   }; // class GradientHelperImpl
 
+  /** @brief Contiguous buffer shared by several gradients.
+   *
+   *  The contribution buffers of the gradients are views into one
+   *  flat buffer, so they are allreduced together by a single
+   *  non-blocking allreduce. It is launched when the last gradient
+   *  is ready for it, or when any of them is accessed before that.
+   *  Gradients that are ready or cleared at that point are scaled or
+   *  zeroed so that the allreduce leaves them unchanged. The
+   *  allreduce is set up once, as a persistent allreduce, when the
+   *  bucket is sealed if the communicator supports it.
+   */
+  template <typename TensorDataType>
+  class GradientBucket : public GradientBucketBase
+  {
+  public:
+    using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+    using HelperType = GradientHelperImpl<TensorDataType>;
+
+  public:
+    /** @param like     Matrix with the distribution of the gradients.
+     *  @param capacity Number of entries in the bucket.
+     */
+    GradientBucket(AbsDistMatType const& like, El::Int capacity);
+    ~GradientBucket() override;
+    /** @brief Whether a gradient with @c size entries fits. */
+    bool has_room(El::Int size) const noexcept
+    {
+      return !sealed_ && size_ + size <= buffer_->Height();
+    }
+    /** @brief Attach the contributions of a gradient to the bucket. */
+    void add(HelperType& member);
+    void remove(HelperType const& member);
+    void seal(lbann_comm& comm) override;
+    /** @brief A gradient is ready to be allreduced. */
+    void start_allreduce(lbann_comm& comm);
+    /** @brief Wait until a gradient is allreduced.
+     *
+     *  Launches the allreduce if the gradient is not in flight.
+     */
+    void complete_allreduce(lbann_comm& comm, HelperType const& member);
+    /** @brief Launch the allreduce if a gradient is not in flight. */
+    void launch_allreduce(lbann_comm& comm, HelperType const& member);
+    /** @brief Whether a gradient is allreduced, without launching. */
+    bool test_allreduce(lbann_comm& comm, HelperType const& member);
+
+  private:
+    void launch(lbann_comm& comm);
+    void wait(lbann_comm& comm);
+    /** @brief Mark the gradients in flight as ready. */
+    void finish();
+
+    std::unique_ptr<AbsDistMatType> buffer_;
+    /** @brief Entries used by the gradients. */
+    El::Int size_ = 0;
+    /** @brief View of the used entries, for the allreduce. */
+    std::unique_ptr<AbsDistMatType> used_;
+    std::vector<HelperType*> members_;
+    /** @brief Gradients in the allreduce that is in progress. */
+    std::vector<HelperType*> in_flight_;
+    /** @brief Gradients waiting for the allreduce to be launched. */
+    size_t num_started_ = 0;
+    bool sealed_ = false;
+    bool launched_ = false;
+    Al::request allreduce_req_;
+    /** @brief Communicator of the persistent allreduce, if any. */
+    lbann_comm* persistent_comm_ = nullptr;
+  }; // class GradientBucket
+
   /** @brief Copy construct/copy assign */
   optimizer(const optimizer& other);
   optimizer& operator=(const optimizer& other);
@@ -281,6 +554,17 @@ public:
   virtual std::tuple<El::Int, El::Int, El::DistData>
   get_matrix_info() const = 0;
 
+  /** @brief Distribution of the reduced gradient if it is sharded.
+   *
+   *  Gradient contributions have the distribution of
+   *  get_matrix_info. If this returns a distribution, they are
+   *  reduce-scattered into it instead of being allreduced.
+   */
+  virtual std::optional<El::DistData> get_gradient_shard_distribution() const
+  {
+    return std::nullopt;
+  }
+
   template <typename TensorDataType>
   void accumulate_all_gradient_contributions(
     El::AbstractDistMatrix<TensorDataType>& gradient);
@@ -292,6 +576,9 @@ public:
    */
   void start_gradient_allreduce();
 
+  /** @brief Scale all gradient contributions. */
+  void scale_gradient_contributions(EvalType alpha);
+
   /** @brief Synchronize non-blocking allreduce on the gradient, if needed.
    *
    *  Does nothing if an allreduce isn't needed. Throws an exception
@@ -299,6 +586,9 @@ public:
    */
   void finish_gradient_allreduce();
 
+  /** @brief Scale of the gradient in the next optimization step. */
+  EvalType m_gradient_scale = 1;
+
 private:
   /** @brief LBANN communicator. */
   lbann_comm* m_comm;
@@ -319,15 +609,70 @@ private:
   optimizer_gradient_status m_gradient_status =
     optimizer_gradient_status::cleared;
 
+  /** @brief Whether removing gradient sources launches allreduces. */
+  bool m_gradient_allreduce_deferred = false;
+
   /** @brief Time spent in optimization step. */
   EvalType m_step_time = 0;
 
+  /** @brief Threshold on the global gradient norm, if positive. */
+  double m_clip_gradient_norm = 0.;
+
+  /** @brief Coefficient of the L2 regularization term. */
+  double m_l2_regularization = 0.;
+
+  /** @brief Decoupled weight decay rate. */
+  double m_decoupled_weight_decay = 0.;
+
+  /** @brief Whether updated values are rounded stochastically. */
+  bool m_stochastic_rounding = false;
+
   /** @brief Map from data types to gradient contributions.
    *  @todo Refactor this out. It's a hack.
    */
   using gradient_manager_type = GradientHelper;
   using gradient_manager_ptr = std::unique_ptr<gradient_manager_type>;
   std::unordered_map<std::type_index, gradient_manager_ptr> gradients_;
+
+  /** @brief Buckets for new gradient buffers. */
+  gradient_bucket_manager* m_gradient_buckets = nullptr;
+};
+
+/** @brief Packs the gradients of a model's weights into buckets.
+ *
+ *  Gradient buffers are created during the first backprop, in
+ *  reverse layer order, and are appended to the open bucket for
+ *  their data type, device and process grid until it is full. Only
+ *  unsharded gradients that are replicated over more than one
+ *  process, with a [STAR,STAR] distribution, are bucketed;
+ *  gradients larger than a bucket are allreduced on their own.
+ */
+class gradient_bucket_manager
+{
+public:
+  /** @param bucket_size Size of a bucket in bytes. */
+  gradient_bucket_manager(lbann_comm& comm, size_t bucket_size)
+    : m_comm{comm}, m_bucket_size{bucket_size}
+  {}
+
+  /** @brief Bucket with room for a gradient, or nullptr. */
+  template <typename TensorDataType>
+  std::shared_ptr<optimizer::GradientBucket<TensorDataType>>
+  get_bucket(El::AbstractDistMatrix<TensorDataType> const& gradient);
+
+  /** @brief Seal the open buckets.
+   *
+   *  Called at the end of backprop, so later gradient buffers start
+   *  new buckets.
+   */
+  void seal();
+
+private:
+  lbann_comm& m_comm;
+  size_t m_bucket_size;
+  using key_type = std::tuple<std::type_index, El::Device, El::Grid const*>;
+  std::map<key_type, std::shared_ptr<optimizer::GradientBucketBase>>
+    m_open_buckets;
 };
 
 } // namespace lbann
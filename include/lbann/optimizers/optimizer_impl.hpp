@@ -30,6 +30,8 @@
 #include "lbann/optimizers/optimizer.hpp"
 #include "lbann/utils/exception.hpp"
 
+#include <algorithm>
+
 namespace lbann {
 
 template <typename TensorDataType>
@@ -64,9 +66,18 @@ optimizer::get_gradient_buffer(TensorDataType& buf_scale,
   // If the manager hasn't been created, let's make it.
   if (!grad_mgr_ptr) {
     auto mat_info = this->get_matrix_info();
-    grad_mgr_ptr = std::make_unique<GradMgrType>(std::get<HEIGHT>(mat_info),
-                                                 std::get<WIDTH>(mat_info),
-                                                 std::get<DISTDATA>(mat_info));
+    auto new_mgr =
+      std::make_unique<GradMgrType>(std::get<HEIGHT>(mat_info),
+                                    std::get<WIDTH>(mat_info),
+                                    std::get<DISTDATA>(mat_info),
+                                    this->get_gradient_shard_distribution());
+    if (m_gradient_buckets != nullptr && !new_mgr->sharded()) {
+      auto bucket = m_gradient_buckets->get_bucket(new_mgr->contributions());
+      if (bucket != nullptr) {
+        new_mgr->set_bucket(std::move(bucket));
+      }
+    }
+    grad_mgr_ptr = std::move(new_mgr);
     grad_mgr_ptr->set_status(optimizer_gradient_status::cleared);
   }
   // Get the underlying matrix back out.
@@ -75,7 +86,18 @@ optimizer::get_gradient_buffer(TensorDataType& buf_scale,
   if (grad_mgr.get_status() == optimizer_gradient_status::allreduce_started) {
     grad_mgr.complete_allreduce(*(this->m_comm));
   }
-  auto& buffer = grad_mgr.gradient();
+  auto& buffer = grad_mgr.contributions();
+
+  // Sharded gradients are reduce-scattered from the sum of all
+  // contributions, so the buffer is never reduced in place and
+  // contributions that are already reduced are split among the
+  // processes.
+  const bool sharded = grad_mgr.sharded();
+  auto shard_scale = TensorDataType(1);
+  if (sharded && !allreduce_needed) {
+    shard_scale /= buffer.RedundantSize();
+    allreduce_needed = true;
+  }
 
   // Determine scaling factor and transition state.
   switch (grad_mgr.get_status()) {
@@ -83,7 +105,9 @@ optimizer::get_gradient_buffer(TensorDataType& buf_scale,
     buf_scale = DataType(1);
     in_scale = DataType(1);
     if (allreduce_needed) {
-      buf_scale /= buffer.RedundantSize();
+      if (!sharded) {
+        buf_scale /= buffer.RedundantSize();
+      }
       grad_mgr.set_status(optimizer_gradient_status::allreduce_needed);
     }
     break;
@@ -105,6 +129,7 @@ optimizer::get_gradient_buffer(TensorDataType& buf_scale,
     LBANN_ERROR("unexpected gradient status (" +
                 to_string(grad_mgr.get_status()) + ")");
   }
+  in_scale *= shard_scale;
   return buffer;
 }
 
@@ -147,7 +172,7 @@ void optimizer::accumulate_all_gradient_contributions(
       El::LockedView(gradient, contrib);
     }
     else {
-      LBANN_ERROR("Should never need this copy.");
+      // The gradient of an offloaded optimizer is in host memory
       El::Copy(contrib, gradient);
     }
     --num_updates;
@@ -192,8 +217,20 @@ void optimizer::GradientHelperImpl<TensorDataType>::start_allreduce(
 {
   switch (this->get_status()) {
   case optimizer_gradient_status::allreduce_needed:
-    comm.nb_allreduce(*gradient_, gradient_->RedundantComm(), allreduce_req_);
-    this->set_status(optimizer_gradient_status::allreduce_started);
+    if (shard_) {
+      El::Contract(*gradient_, *shard_);
+      this->set_status(optimizer_gradient_status::ready);
+    }
+    else if (bucket_) {
+      this->set_status(optimizer_gradient_status::allreduce_started);
+      bucket_->start_allreduce(comm);
+    }
+    else {
+      comm.nb_allreduce(*gradient_,
+                        gradient_->RedundantComm(),
+                        allreduce_req_);
+      this->set_status(optimizer_gradient_status::allreduce_started);
+    }
     break;
   case optimizer_gradient_status::ready:
   case optimizer_gradient_status::cleared:
@@ -212,8 +249,13 @@ void optimizer::GradientHelperImpl<TensorDataType>::complete_allreduce(
 {
   switch (this->get_status()) {
   case optimizer_gradient_status::allreduce_started:
-    comm.wait(allreduce_req_);
-    this->set_status(optimizer_gradient_status::ready);
+    if (bucket_) {
+      bucket_->complete_allreduce(comm, *this);
+    }
+    else {
+      comm.wait(allreduce_req_);
+      this->set_status(optimizer_gradient_status::ready);
+    }
     break;
   case optimizer_gradient_status::ready:
   case optimizer_gradient_status::cleared:
@@ -229,12 +271,280 @@ void optimizer::GradientHelperImpl<TensorDataType>::complete_allreduce(
   }
 }
 
+template <typename TensorDataType>
+void optimizer::GradientHelperImpl<TensorDataType>::launch_allreduce(
+  lbann_comm& comm)
+{
+  this->start_allreduce(comm);
+  if (bucket_ &&
+      this->get_status() == optimizer_gradient_status::allreduce_started) {
+    bucket_->launch_allreduce(comm, *this);
+  }
+}
+
+template <typename TensorDataType>
+bool optimizer::GradientHelperImpl<TensorDataType>::test_allreduce(
+  lbann_comm& comm)
+{
+  switch (this->get_status()) {
+  case optimizer_gradient_status::allreduce_started:
+    if (bucket_) {
+      return bucket_->test_allreduce(comm, *this);
+    }
+    if (comm.test(allreduce_req_)) {
+      this->set_status(optimizer_gradient_status::ready);
+      return true;
+    }
+    return false;
+  case optimizer_gradient_status::ready:
+  case optimizer_gradient_status::cleared:
+    return true;
+  case optimizer_gradient_status::allreduce_needed:
+    return false;
+  default:
+    LBANN_ERROR("unexpected gradient status "
+                "(" +
+                to_string(this->get_status()) + ")");
+  }
+  return false;
+}
+
+template <typename TensorDataType>
+optimizer::GradientHelperImpl<TensorDataType>::~GradientHelperImpl()
+{
+  if (bucket_) {
+    bucket_->remove(*this);
+  }
+}
+
+template <typename TensorDataType>
+void optimizer::GradientHelperImpl<TensorDataType>::set_bucket(
+  std::shared_ptr<BucketType> bucket)
+{
+  bucket_ = std::move(bucket);
+  bucket_->add(*this);
+}
+
 template <typename TensorDataType>
 void optimizer::GradientHelperImpl<TensorDataType>::clear()
 {
   this->set_status(optimizer_gradient_status::cleared);
 }
 
+template <typename TensorDataType>
+void optimizer::GradientHelperImpl<TensorDataType>::scale(EvalType alpha)
+{
+  if (this->get_status() == optimizer_gradient_status::ready) {
+    El::Scale(El::To<TensorDataType>(alpha), *gradient_);
+    if (shard_) {
+      El::Scale(El::To<TensorDataType>(alpha), *shard_);
+    }
+  }
+}
+
+template <typename TensorDataType>
+optimizer::GradientBucket<TensorDataType>::GradientBucket(
+  AbsDistMatType const& like,
+  El::Int capacity)
+  : buffer_{like.Construct(like.Grid(), like.Root())},
+    used_{like.Construct(like.Grid(), like.Root())}
+{
+  El::Zeros(*buffer_, capacity, 1);
+}
+
+template <typename TensorDataType>
+optimizer::GradientBucket<TensorDataType>::~GradientBucket()
+{
+  if (persistent_comm_ != nullptr) {
+    if (launched_) {
+      persistent_comm_->wait(allreduce_req_);
+    }
+    persistent_comm_->free_persistent_allreduce(allreduce_req_);
+  }
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::add(HelperType& member)
+{
+  auto& contrib = member.contributions();
+  const auto height = contrib.Height();
+  const auto width = contrib.Width();
+  contrib.Attach(height,
+                 width,
+                 buffer_->Grid(),
+                 0,
+                 0,
+                 buffer_->Buffer() + size_,
+                 std::max(height, El::Int(1)),
+                 buffer_->Root());
+  El::Zero(contrib);
+  size_ += height * width;
+  members_.push_back(&member);
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::remove(
+  HelperType const& member)
+{
+  auto erase = [&member](std::vector<HelperType*>& members) {
+    members.erase(std::remove(members.begin(), members.end(), &member),
+                  members.end());
+  };
+  erase(members_);
+  erase(in_flight_);
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::seal(lbann_comm& comm)
+{
+  sealed_ = true;
+  El::View(*used_, *buffer_, El::IR(0, size_), El::ALL);
+  if (!launched_ && size_ > 0 &&
+      comm.init_persistent_allreduce(used_->Matrix(),
+                                     used_->RedundantComm(),
+                                     allreduce_req_)) {
+    persistent_comm_ = &comm;
+  }
+  if (num_started_ > 0 && num_started_ >= members_.size()) {
+    launch(comm);
+  }
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::start_allreduce(
+  lbann_comm& comm)
+{
+  ++num_started_;
+  if (sealed_ && num_started_ >= members_.size()) {
+    launch(comm);
+  }
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::complete_allreduce(
+  lbann_comm& comm,
+  HelperType const& member)
+{
+  if (launched_) {
+    wait(comm);
+  }
+  // The gradient was started after the last launch
+  if (member.get_status() == optimizer_gradient_status::allreduce_started) {
+    launch(comm);
+    wait(comm);
+  }
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::launch_allreduce(
+  lbann_comm& comm,
+  HelperType const& member)
+{
+  if (std::find(in_flight_.begin(), in_flight_.end(), &member) ==
+      in_flight_.end()) {
+    launch(comm);
+  }
+}
+
+template <typename TensorDataType>
+bool optimizer::GradientBucket<TensorDataType>::test_allreduce(
+  lbann_comm& comm,
+  HelperType const& member)
+{
+  if (launched_ &&
+      std::find(in_flight_.begin(), in_flight_.end(), &member) !=
+        in_flight_.end() &&
+      comm.test(allreduce_req_)) {
+    finish();
+  }
+  return member.get_status() != optimizer_gradient_status::allreduce_started;
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::launch(lbann_comm& comm)
+{
+  if (launched_) {
+    wait(comm);
+  }
+
+  // Every gradient in the bucket is summed over the processes, so
+  // make the ones that are not waiting for it invariant under the sum
+  const auto redundant_scale =
+    El::TypeTraits<TensorDataType>::One() / buffer_->RedundantSize();
+  for (auto* member : members_) {
+    auto& contrib = member->contributions();
+    switch (member->get_status()) {
+    case optimizer_gradient_status::ready:
+      El::Scale(redundant_scale, contrib);
+      break;
+    case optimizer_gradient_status::allreduce_needed:
+    case optimizer_gradient_status::allreduce_started:
+      break;
+    case optimizer_gradient_status::cleared:
+    default:
+      El::Zero(contrib);
+      continue;
+    }
+    member->set_status(optimizer_gradient_status::allreduce_started);
+    in_flight_.push_back(member);
+  }
+  num_started_ = 0;
+
+  if (persistent_comm_ != nullptr) {
+    comm.start_persistent_allreduce(allreduce_req_);
+  }
+  else {
+    El::View(*used_, *buffer_, El::IR(0, size_), El::ALL);
+    comm.nb_allreduce(*used_, used_->RedundantComm(), allreduce_req_);
+  }
+  launched_ = true;
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::wait(lbann_comm& comm)
+{
+  comm.wait(allreduce_req_);
+  finish();
+}
+
+template <typename TensorDataType>
+void optimizer::GradientBucket<TensorDataType>::finish()
+{
+  for (auto* member : in_flight_) {
+    member->set_status(optimizer_gradient_status::ready);
+  }
+  in_flight_.clear();
+  launched_ = false;
+}
+
+template <typename TensorDataType>
+std::shared_ptr<optimizer::GradientBucket<TensorDataType>>
+gradient_bucket_manager::get_bucket(
+  El::AbstractDistMatrix<TensorDataType> const& gradient)
+{
+  using BucketType = optimizer::GradientBucket<TensorDataType>;
+  const El::Int capacity = m_bucket_size / sizeof(TensorDataType);
+  const El::Int size = gradient.Height() * gradient.Width();
+  if (gradient.ColDist() != El::STAR || gradient.RowDist() != El::STAR ||
+      gradient.RedundantSize() <= 1 || size == 0 || size > capacity) {
+    return nullptr;
+  }
+
+  // Start a new bucket if the open one is full
+  auto& open = m_open_buckets[key_type{std::type_index(typeid(TensorDataType)),
+                                       gradient.GetLocalDevice(),
+                                       &gradient.Grid()}];
+  auto bucket = std::static_pointer_cast<BucketType>(open);
+  if (bucket == nullptr || !bucket->has_room(size)) {
+    if (bucket != nullptr) {
+      bucket->seal(m_comm);
+    }
+    bucket = std::make_shared<BucketType>(gradient, capacity);
+    open = bucket;
+  }
+  return bucket;
+}
+
 } // namespace lbann
 
 #endif // LBANN_OPTIMIZERS_OPTIMIZER_IMPL_HPP_INCLUDED
@@ -118,6 +118,11 @@ public:
   using OptimizerType::setup;
   void setup(WeightsType* w = nullptr) override;
 
+  std::vector<AbsDistMatrixType*> get_state_tensors() override
+  {
+    return {m_velocity.get()};
+  }
+
   ///@}
 
   /** Add optimizer data to prototext */
@@ -135,6 +140,17 @@ protected:
   void step_compute(AbsDistMatrixType& values,
                     const AbsDistMatrixType& gradient) override;
 
+  bool supports_fused_step() const override { return true; }
+  bool add_fused_step_entry(
+    AbsDistMatrixType& values,
+    const AbsDistMatrixType& gradient,
+    std::vector<fused_step_entry<TensorDataType>>& entries) override;
+#ifdef LBANN_HAS_GPU
+  void fused_step_gpu(
+    std::vector<fused_step_entry<TensorDataType>> const& entries,
+    El::SyncInfo<El::Device::GPU> const& sync_info) override;
+#endif // LBANN_HAS_GPU
+
 private:
   /** @brief Decay rate for gradient accumulation.
    *  @details A momentum of zero corresponds to vanilla SGD.
@@ -88,7 +88,12 @@ void save_session(const lbann_comm& comm,
                   char* const* argv,
                   ::lbann_data::LbannPB& p);
 
-/** @brief Read prototext from a file into a protobuf message. */
+/** @brief Read prototext from a file into a protobuf message.
+ *
+ *  Files ending in ".binpb" or ".pb" hold a serialized (binary)
+ *  message, which is much faster to parse than text for very large
+ *  models.
+ */
 void read_prototext_file(const std::string& fn,
                          ::lbann_data::LbannPB& pb,
                          const bool master);
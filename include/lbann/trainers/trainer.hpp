@@ -238,6 +238,16 @@ public:
                 execution_mode mode,
                 El::Int num_batches = 0);
 
+  /** @brief Evaluate several models on one pass over the data.
+   *
+   *  Each mini-batch is fetched and decoded once and fed to all the
+   *  models, e.g. the members of an ensemble, rather than every model
+   *  reading the data set. See SGDTrainingAlgorithm::evaluate_ensemble.
+   */
+  void evaluate_ensemble(std::vector<observer_ptr<model>> const& models,
+                         execution_mode mode,
+                         El::Int num_batches = 0);
+
   ///@}
   /** @name Sub-grid management */
   ///@{
@@ -67,6 +67,12 @@ public:
              CPUMat& out,
              std::vector<size_t>& dims) override;
 
+  bool is_affine() const override { return true; }
+  void get_affine(size_t channel,
+                  size_t num_channels,
+                  DataType& a,
+                  DataType& b) const override;
+
 private:
   /** Channel-wise means. */
   std::vector<float> m_means;
@@ -48,6 +48,13 @@ public:
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
+  bool is_affine() const override { return true; }
+  void get_affine(size_t, size_t, DataType& a, DataType& b) const override
+  {
+    a = m_scale;
+    b = m_translate;
+  }
+
 private:
   /** Amount to scale data by. */
   float m_scale;
@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_TRANSFORMS_SCRATCH_ARENA_HPP_INCLUDED
+#define LBANN_TRANSFORMS_SCRATCH_ARENA_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/utils/type_erased_matrix.hpp"
+
+#include <vector>
+
+namespace lbann {
+namespace transform {
+
+/**
+ * Image buffers recycled between the transforms run by one thread.
+ *
+ * Transforms that cannot work in place take their outputs from the arena
+ * and hand back the inputs they replace, and the transform pipeline hands
+ * back the image once it has been written into the minibatch. Buffers only
+ * grow, so once a thread has seen its largest image the pipeline stops
+ * allocating.
+ */
+class scratch_arena
+{
+public:
+  /** The arena of the calling thread. */
+  static scratch_arena& get();
+
+  /** Get a buffer resized to size x 1. */
+  El::Matrix<uint8_t> acquire(El::Int size);
+  /** Return a buffer for reuse. Views are ignored. */
+  void release(El::Matrix<uint8_t>&& buf);
+  /**
+   * Replace the uint8 matrix held by data with buf and keep the old matrix
+   * for reuse.
+   */
+  void replace(utils::type_erased_matrix& data, El::Matrix<uint8_t>&& buf);
+
+private:
+  /**
+   * Most buffers kept. A pipeline needs at most an input, an output and a
+   * decoded image at a time.
+   */
+  static constexpr size_t max_buffers = 4;
+  /** Buffers available for reuse. */
+  std::vector<El::Matrix<uint8_t>> m_buffers;
+};
+
+} // namespace transform
+} // namespace lbann
+
+#endif // LBANN_TRANSFORMS_SCRATCH_ARENA_HPP_INCLUDED
@@ -69,6 +69,12 @@ public:
   /** True if the transform supports non-in-place apply. */
   virtual bool supports_non_inplace() const { return false; }
 
+  /** Set the tag of the transform's random stream.
+   *  Transforms that draw random numbers for the same sample must
+   *  have different tags, see draw_io_sample_block.
+   */
+  void set_rng_tag(uint32_t tag) noexcept { m_rng_tag = tag; }
+
   /**
    * Apply the transform to data.
    * @param data The input data to transform, which is modified in-place. The
@@ -91,25 +97,112 @@ public:
     LBANN_ERROR("Non-in-place apply not implemented.");
   }
 
+  /**
+   * True if the transform maps each value x of channel c of DataType data
+   * to a*x + b, with a and b given by get_affine(). Transform pipelines
+   * fuse consecutive affine transforms into one pass over the data.
+   */
+  virtual bool is_affine() const { return false; }
+
+  /**
+   * Get the coefficients of an affine transform for one channel.
+   * @param channel The channel.
+   * @param num_channels The number of channels of the data, which is one
+   * if it is not an image.
+   * @param a Set to the scale of the channel.
+   * @param b Set to the offset of the channel.
+   */
+  virtual void get_affine(size_t channel,
+                          size_t num_channels,
+                          DataType& a,
+                          DataType& b) const
+  {
+    LBANN_ERROR("Transform is not affine.");
+  }
+
+  /**
+   * True if the transform can be fused with decoding the image with
+   * apply_fused_decode(). It then has to be the first transform.
+   */
+  virtual bool supports_fused_decode() const { return false; }
+
+  /**
+   * Decode an encoded image and apply the transform, decoding no more of the
+   * image than the transform needs.
+   * @param encoded The encoded image.
+   * @param data Set to the transformed image, as uint8 in OpenCV format.
+   * @param dims Set to the dimensions of the transformed image.
+   */
+  virtual void apply_fused_decode(El::Matrix<uint8_t>& encoded,
+                                  utils::type_erased_matrix& data,
+                                  std::vector<size_t>& dims)
+  {
+    LBANN_ERROR("Fused decode not implemented.");
+  }
+
+  /**
+   * True if the transform converts an OpenCV uint8 image to LBANN's layout
+   * and maps each value x of channel c to a*x + b on the way, with a and b
+   * given by get_affine(). The GPU can then do the conversion.
+   */
+  virtual bool is_affine_layout_conversion() const { return false; }
+
+  /** True if the transform supports apply_with_affine(). */
+  virtual bool supports_affine_epilogue() const { return false; }
+
+  /**
+   * Non-in-place apply that also applies the channel-wise affine map
+   * x -> scales[c] * x + shifts[c] to its output, folding the affine
+   * transforms that follow this one into its own pass over the data.
+   */
+  virtual void apply_with_affine(utils::type_erased_matrix& data,
+                                 CPUMat& out,
+                                 std::vector<size_t>& dims,
+                                 const std::vector<DataType>& scales,
+                                 const std::vector<DataType>& shifts)
+  {
+    LBANN_ERROR("Affine epilogue not implemented.");
+  }
+
 protected:
+  /** @name Random numbers
+   *  Drawn from the current sample's counter-based stream, so they
+   *  depend on the sample and on the transform's position in its
+   *  pipeline but not on the I/O thread.
+   */
+  ///@{
   /** Return a value uniformly at random in [a, b). */
-  static inline float get_uniform_random(float a, float b)
+  float get_uniform_random(float a, float b) const
   {
-    fast_rng_gen& gen = get_fast_io_generator();
-    std::uniform_real_distribution<float> dist(a, b);
-    return dist(gen);
+    const auto x = draw_io_sample_block(m_rng_tag);
+    return a + (b - a) * (static_cast<float>(x.x[0] >> 8) *
+                          (1.f / 16777216.f));
+  }
+  /** Fill @c out with @c n values uniformly at random in [a, b). */
+  void get_uniform_random(float a, float b, float* out, size_t n) const
+  {
+    draw_io_sample_uniform(m_rng_tag, a, b, out, n);
   }
   /** Return true with probability p. */
-  static inline bool get_bool_random(float p)
+  bool get_bool_random(float p) const
   {
     return get_uniform_random(0.0, 1.0) < p;
   }
   /** Return an integer uniformly at random in [a, b). */
-  static inline El::Int get_uniform_random_int(El::Int a, El::Int b)
+  El::Int get_uniform_random_int(El::Int a, El::Int b) const
   {
-    fast_rng_gen& gen = get_fast_io_generator();
-    return fast_rand_int(gen, b - a) + a;
+    if (b <= a) {
+      LBANN_ERROR("get_uniform_random_int called with an empty range");
+    }
+    const auto x = draw_io_sample_block(m_rng_tag);
+    const uint64_t bits = (static_cast<uint64_t>(x.x[0]) << 32) | x.x[1];
+    return a + static_cast<El::Int>(bits % static_cast<uint64_t>(b - a));
   }
+  ///@}
+
+private:
+  /** Tag of the transform's random stream. */
+  uint32_t m_rng_tag = 0;
 };
 
 } // namespace transform
@@ -36,6 +36,10 @@ namespace transform {
 
 /**
  * Applies a sequence of transforms to input data.
+ *
+ * Consecutive affine transforms (see transform::is_affine) are fused into a
+ * single pass over the data, and into the preceding transform when it
+ * supports an affine epilogue (e.g. to_lbann_layout).
  */
 class transform_pipeline
 {
@@ -51,9 +55,11 @@ public:
 
   /**
    * Add trans as the next transform to apply.
+   * Its random stream is tagged with its position in the pipeline.
    */
   void add_transform(std::unique_ptr<transform>&& trans)
   {
+    trans->set_rng_tag(static_cast<uint32_t>(m_transforms.size()));
     m_transforms.push_back(std::move(trans));
   }
 
@@ -79,9 +85,50 @@ public:
    * @param data The data to transform. Will be modified in-place.
    * @param out_data Output will be placed here. It will not be reallocated.
    * @param dims Dimensions of data. Will be modified in-place.
+   * @param begin Index of the first transform to apply (see decode()).
    */
-  void
-  apply(El::Matrix<uint8_t>& data, CPUMat& out_data, std::vector<size_t>& dims);
+  void apply(El::Matrix<uint8_t>& data,
+             CPUMat& out_data,
+             std::vector<size_t>& dims,
+             size_t begin = 0);
+
+#ifdef LBANN_HAS_OPENCV
+  /**
+   * Decode an encoded image. If the first transform supports it (see
+   * transform::supports_fused_decode), it is applied while decoding, which
+   * can then skip the parts of the image it does not need.
+   * @param encoded The encoded image.
+   * @param data Set to the decoded image.
+   * @param dims Set to the dimensions of data.
+   * @returns The index of the first transform left to apply.
+   */
+  size_t decode(El::Matrix<uint8_t>& encoded,
+                El::Matrix<uint8_t>& data,
+                std::vector<size_t>& dims);
+#endif // LBANN_HAS_OPENCV
+
+  /**
+   * True if the transforms end with an affine layout conversion (see
+   * transform::is_affine_layout_conversion) followed only by affine
+   * transforms. This tail then maps channel c of an OpenCV image to
+   * scales[c] * x + shifts[c] in LBANN's layout, which the GPU can do.
+   * @param num_channels Channels of the images.
+   * @param scales Set to the scale of each channel.
+   * @param shifts Set to the offset of each channel.
+   */
+  bool get_raw_image_tail(size_t num_channels,
+                          std::vector<DataType>& scales,
+                          std::vector<DataType>& shifts) const;
+  /**
+   * Apply the transforms before the tail of get_raw_image_tail() to an
+   * OpenCV image, which stays uint8.
+   * @param data The image to transform. Will be modified in-place.
+   * @param dims Dimensions of data. Will be modified in-place.
+   * @param begin Index of the first transform to apply (see decode()).
+   */
+  void apply_raw_image_head(El::Matrix<uint8_t>& data,
+                            std::vector<size_t>& dims,
+                            size_t begin = 0);
 
 private:
   /** Ordered list of transforms to apply. */
@@ -91,6 +138,22 @@ private:
 
   /** Assert dims matches expected_out_dims (if set). */
   void assert_expected_out_dims(const std::vector<size_t>& dims);
+
+  /** Index of the layout conversion of get_raw_image_tail(), or the
+   *  number of transforms if there is none. */
+  size_t raw_image_tail() const;
+  /** Index one past the run of affine transforms starting at i. */
+  size_t affine_run_end(size_t i) const;
+  /** Compose the affine transforms in [begin, end) for each channel. */
+  void compose_affine(size_t begin,
+                      size_t end,
+                      const std::vector<size_t>& dims,
+                      std::vector<DataType>& scales,
+                      std::vector<DataType>& shifts) const;
+  /** Apply transforms i onwards to data, fusing affine runs. */
+  void apply_from(size_t i,
+                  utils::type_erased_matrix& data,
+                  std::vector<size_t>& dims);
 };
 
 } // namespace transform
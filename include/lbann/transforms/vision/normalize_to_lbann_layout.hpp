@@ -70,6 +70,13 @@ public:
              CPUMat& out,
              std::vector<size_t>& dims) override;
 
+  bool is_affine_layout_conversion() const override { return true; }
+
+  void get_affine(size_t channel,
+                  size_t num_channels,
+                  DataType& a,
+                  DataType& b) const override;
+
 private:
   /** Channel-wise means. */
   std::vector<float> m_means;
@@ -72,7 +72,23 @@ public:
   void apply(utils::type_erased_matrix& data,
              std::vector<size_t>& dims) override;
 
+  bool supports_fused_decode() const override { return true; }
+
+  /** Choose the crop from the JPEG header, then decode the image at the
+   *  largest DCT scale that keeps the crop at least h x w. */
+  void apply_fused_decode(El::Matrix<uint8_t>& encoded,
+                          utils::type_erased_matrix& data,
+                          std::vector<size_t>& dims) override;
+
 private:
+  /** Choose the crop (x, y, h, w) of a height x width image. */
+  void choose_crop(size_t height,
+                   size_t width,
+                   size_t& x,
+                   size_t& y,
+                   size_t& h,
+                   size_t& w) const;
+
   /** Height and width of the final crop. */
   size_t m_h, m_w;
   /** Range for the area of the random crop. */
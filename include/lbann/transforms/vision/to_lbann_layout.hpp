@@ -38,10 +38,19 @@ namespace transform {
  * Convert data to LBANN's native data layout.
  * Currently only supports converting from OpenCV layouts.
  * This will also rescale data from [0, 255] to [0, 1].
+ *
+ * If channels-last is requested, the channel index varies fastest, as
+ * expected by channels-last convolution, pooling and batch
+ * normalization layers. The data dimensions are unchanged.
  */
 class to_lbann_layout : public transform
 {
 public:
+  /** @param channels_last Whether to store the channel index fastest. */
+  to_lbann_layout(bool channels_last = false)
+    : transform(), m_channels_last(channels_last)
+  {}
+
   transform* copy() const override { return new to_lbann_layout(*this); }
 
   std::string get_type() const override { return "to_lbann_layout"; }
@@ -54,6 +63,26 @@ public:
   void apply(utils::type_erased_matrix& data,
              CPUMat& out,
              std::vector<size_t>& dims) override;
+
+  bool is_affine_layout_conversion() const override { return true; }
+
+  void get_affine(size_t, size_t, DataType& a, DataType& b) const override
+  {
+    a = 1.0f / 255.0f;
+    b = 0;
+  }
+
+  bool supports_affine_epilogue() const override { return true; }
+
+  void apply_with_affine(utils::type_erased_matrix& data,
+                         CPUMat& out,
+                         std::vector<size_t>& dims,
+                         const std::vector<DataType>& scales,
+                         const std::vector<DataType>& shifts) override;
+
+private:
+  /** Whether the channel index varies fastest in the output. */
+  bool m_channels_last;
 };
 
 std::unique_ptr<transform>
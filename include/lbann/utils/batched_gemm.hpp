@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_BATCHED_GEMM_HPP
+#define LBANN_UTILS_BATCHED_GEMM_HPP
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/** @brief Strided-batched GEMM on CPU.
+ *
+ *  Computes C_i = alpha * op(A_i) * op(B_i) + beta * C_i for each i
+ *  in [0, batch_count), where matrix i of X starts at X + i *
+ *  strideX. A stride of zero reuses the same matrix. Hydrogen does
+ *  not expose a batched BLAS interface on CPU, so the GEMMs are
+ *  distributed between OpenMP threads.
+ */
+template <typename T>
+void gemm_strided_batched(El::Orientation transa,
+                          El::Orientation transb,
+                          El::Int m,
+                          El::Int n,
+                          El::Int k,
+                          T alpha,
+                          const T* A,
+                          El::Int lda,
+                          El::Int strideA,
+                          const T* B,
+                          El::Int ldb,
+                          El::Int strideB,
+                          T beta,
+                          T* C,
+                          El::Int ldc,
+                          El::Int strideC,
+                          El::Int batch_count,
+                          const El::SyncInfo<El::Device::CPU>& sync_info);
+
+#ifdef LBANN_HAS_GPU
+/** @brief Strided-batched GEMM on GPU. */
+template <typename T>
+void gemm_strided_batched(El::Orientation transa,
+                          El::Orientation transb,
+                          El::Int m,
+                          El::Int n,
+                          El::Int k,
+                          T alpha,
+                          const T* A,
+                          El::Int lda,
+                          El::Int strideA,
+                          const T* B,
+                          El::Int ldb,
+                          El::Int strideB,
+                          T beta,
+                          T* C,
+                          El::Int ldc,
+                          El::Int strideC,
+                          El::Int batch_count,
+                          const El::SyncInfo<El::Device::GPU>& sync_info);
+#endif // LBANN_HAS_GPU
+
+/** @brief Apply a matrix to every channel of a mini-batch.
+ *
+ *  Each column of X is a sample made of @c num_channels channels of
+ *  equal size, stored one after the other, and likewise for Y. With
+ *  X_j the matrix whose columns are the channels of sample j,
+ *  computes Y_j = alpha * op(W) * X_j + beta * Y_j for each sample.
+ *  Packed mini-batches are done with one GEMM over the channels of
+ *  all samples. Otherwise one strided-batched GEMM over the samples
+ *  reads X and writes Y in place, without reshaping copies.
+ */
+template <typename T, El::Device D>
+void channelwise_gemm(El::Orientation transw,
+                      T alpha,
+                      const El::Matrix<T, D>& W,
+                      const El::Matrix<T, D>& X,
+                      T beta,
+                      El::Matrix<T, D>& Y,
+                      El::Int num_channels);
+
+/** @brief Set every channel of every sample to a bias vector.
+ *
+ *  Sets Y(i + c * bias.Height(), j) = bias(i). Followed by a GEMM
+ *  with beta = 1, this fuses the bias add into the GEMM.
+ */
+template <typename T>
+void fill_channelwise_bias(const El::Matrix<T, El::Device::CPU>& bias,
+                           El::Matrix<T, El::Device::CPU>& Y);
+#ifdef LBANN_HAS_GPU
+template <typename T>
+void fill_channelwise_bias(const El::Matrix<T, El::Device::GPU>& bias,
+                           El::Matrix<T, El::Device::GPU>& Y);
+#endif // LBANN_HAS_GPU
+
+/** @brief View a mini-batch with one column per channel.
+ *
+ *  @c X_channels has a column for each channel of each sample of X.
+ *  It is attached to X if X is packed, and is a copy otherwise.
+ */
+template <typename T, El::Device D>
+void get_channelwise_matrix(const El::Matrix<T, D>& X,
+                            El::Int num_channels,
+                            El::Matrix<T, D>& X_channels)
+{
+  const El::Int channel_size = X.Height() / num_channels;
+  if (X.Contiguous()) {
+    X_channels.LockedAttach(channel_size,
+                            X.Width() * num_channels,
+                            X.LockedBuffer(),
+                            channel_size);
+  }
+  else {
+    El::Copy(X, X_channels);
+    X_channels.Resize(channel_size, X.Width() * num_channels);
+  }
+}
+
+#ifndef LBANN_BATCHED_GEMM_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template void gemm_strided_batched(El::Orientation,                  \
+                                            El::Orientation,                  \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            T,                                \
+                                            const T*,                         \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            const T*,                         \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            T,                                \
+                                            T*,                               \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            El::Int,                          \
+                                            const El::SyncInfo<Device>&);     \
+  extern template void channelwise_gemm(El::Orientation,                      \
+                                        T,                                     \
+                                        const El::Matrix<T, Device>&,          \
+                                        const El::Matrix<T, Device>&,          \
+                                        T,                                     \
+                                        El::Matrix<T, Device>&,                \
+                                        El::Int);                              \
+  extern template void fill_channelwise_bias(const El::Matrix<T, Device>&,    \
+                                             El::Matrix<T, Device>&)
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_BATCHED_GEMM_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_BATCHED_GEMM_HPP
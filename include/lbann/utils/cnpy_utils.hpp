@@ -29,6 +29,8 @@
 
 #include "cnpy.h"
 #include "lbann/utils/exception.hpp"
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -105,6 +107,47 @@ void shrink_to_fit(cnpy::NpyArray& na, size_t sz);
 /// Show the dimensions of loaded data
 std::string show_shape(const cnpy::NpyArray& na);
 
+/**
+ * A numpy array that is read in place from a memory-mapped .npy file or
+ * stored (uncompressed) .npz member rather than loaded into memory by cnpy.
+ * The header carries the shape, word size and ordering of the array; its
+ * data_holder is left empty. Copies share the read-only mapping, whose pages
+ * are shared through the page cache with every process on the node.
+ */
+struct mapped_array
+{
+  cnpy::NpyArray header;
+  /// Keeps the file mapped; unmapped when the last copy goes away
+  std::shared_ptr<const void> mapping;
+  /// First byte of the array's data
+  const char* data = nullptr;
+
+  bool is_mapped() const { return data != nullptr; }
+
+  template <typename T>
+  const T* as() const
+  {
+    return reinterpret_cast<const T*>(data);
+  }
+
+  /**
+   * Passes the madvise advice (e.g., MADV_WILLNEED) for the pages holding
+   * the elements [first, first + count) of the array. Advice is only a hint,
+   * so failures are ignored.
+   */
+  void advise(size_t first, size_t count, int advice) const;
+};
+
+/// Maps an uncompressed .npy file
+mapped_array mmap_npy(const std::string& filename);
+
+/**
+ * Maps the members of an .npz file written by numpy.savez, keyed by the
+ * member name without the ".npy" suffix. Members compressed by
+ * numpy.savez_compressed cannot be mapped.
+ */
+std::map<std::string, mapped_array> mmap_npz(const std::string& filename);
+
 } // end of namespace cnpy_utils
 } // end of namespace lbann
 
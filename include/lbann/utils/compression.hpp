@@ -0,0 +1,52 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_COMPRESSION_HPP_INCLUDED
+#define LBANN_UTILS_COMPRESSION_HPP_INCLUDED
+
+#include <string>
+
+namespace lbann {
+namespace utils {
+
+/** @brief Compress a buffer with zlib.
+ *
+ *  The result starts with the uncompressed size, so it can only be
+ *  read by decompress_string. Serialized models, with their large
+ *  matrix buffers, are the intended use.
+ *
+ *  @param data Buffer to compress
+ *  @param level zlib compression level, from 1 (fastest) to 9
+ *               (smallest)
+ */
+std::string compress_string(std::string const& data, int level = 1);
+
+/** @brief Decompress a buffer written by compress_string. */
+std::string decompress_string(std::string const& data);
+
+} // namespace utils
+} // namespace lbann
+#endif // LBANN_UTILS_COMPRESSION_HPP_INCLUDED
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_CONV_ALGO_CACHE_HPP_INCLUDED
+#define LBANN_UTILS_CONV_ALGO_CACHE_HPP_INCLUDED
+
+#include <string>
+
+namespace lbann {
+
+class lbann_comm;
+
+/** @brief Convolution algorithms chosen by autotuning, kept across runs
+ *
+ *  Keys describe a convolution (direction, data type, shapes,
+ *  mini-batch size, DNN library version and device) and map to the
+ *  value of the chosen algorithm enum. With --conv_algo_cache, the
+ *  world master reads the cache file and broadcasts it during setup,
+ *  so no rank benchmarks a convolution that an earlier run has
+ *  already tuned. New choices of the world master are appended to the
+ *  file as they are made.
+ */
+namespace conv_algo_cache {
+
+/** @brief Load the cache file.
+ *
+ *  Collective over the world. Only the first call does anything, and
+ *  it does nothing without --conv_algo_cache.
+ */
+void load(lbann_comm& comm);
+
+/** Look up the algorithm cached for key. */
+bool find(const std::string& key, int& algo);
+
+/** Cache the algorithm for key, writing it to the file if comm is
+ *  the world master. */
+void insert(const lbann_comm& comm, const std::string& key, int algo);
+
+} // namespace conv_algo_cache
+} // namespace lbann
+
+#endif // LBANN_UTILS_CONV_ALGO_CACHE_HPP_INCLUDED
@@ -33,6 +33,10 @@
 
 #include <cufft.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 #define LBANN_CHECK_CUFFT(cmd)                                                 \
   do {                                                                         \
     auto const lbann_check_cufft_result_ = (cmd);                              \
@@ -125,6 +129,62 @@ struct cuFFTExecutor<El::Complex<double>, El::Complex<double>>
   }
 }; // struct cuFFTExecutor<Complex<double>, Complex<double>>
 
+template <>
+struct cuFFTExecutor<float, El::Complex<float>>
+{
+  static constexpr auto transform_type = CUFFT_R2C;
+  static void Execute(cufftHandle plan,
+                      float* input_data,
+                      El::Complex<float>* output_data,
+                      int /*direction*/)
+  {
+    LBANN_CHECK_CUFFT(
+      cufftExecR2C(plan, AsCUFFTType(input_data), AsCUFFTType(output_data)));
+  }
+}; // struct cuFFTExecutor<float, Complex<float>>
+
+template <>
+struct cuFFTExecutor<El::Complex<float>, float>
+{
+  static constexpr auto transform_type = CUFFT_C2R;
+  static void Execute(cufftHandle plan,
+                      El::Complex<float>* input_data,
+                      float* output_data,
+                      int /*direction*/)
+  {
+    LBANN_CHECK_CUFFT(
+      cufftExecC2R(plan, AsCUFFTType(input_data), AsCUFFTType(output_data)));
+  }
+}; // struct cuFFTExecutor<Complex<float>, float>
+
+template <>
+struct cuFFTExecutor<double, El::Complex<double>>
+{
+  static constexpr auto transform_type = CUFFT_D2Z;
+  static void Execute(cufftHandle plan,
+                      double* input_data,
+                      El::Complex<double>* output_data,
+                      int /*direction*/)
+  {
+    LBANN_CHECK_CUFFT(
+      cufftExecD2Z(plan, AsCUFFTType(input_data), AsCUFFTType(output_data)));
+  }
+}; // struct cuFFTExecutor<double, Complex<double>>
+
+template <>
+struct cuFFTExecutor<El::Complex<double>, double>
+{
+  static constexpr auto transform_type = CUFFT_Z2D;
+  static void Execute(cufftHandle plan,
+                      El::Complex<double>* input_data,
+                      double* output_data,
+                      int /*direction*/)
+  {
+    LBANN_CHECK_CUFFT(
+      cufftExecZ2D(plan, AsCUFFTType(input_data), AsCUFFTType(output_data)));
+  }
+}; // struct cuFFTExecutor<Complex<double>, double>
+
 /** @brief Wrapper around cuFFT
  *
  *  The main constraint is that the sample data to which the DFT will
@@ -134,6 +194,15 @@ struct cuFFTExecutor<El::Complex<double>, El::Complex<double>>
  *  maps of size HxW per sample, the input matrix must have width N
  *  and each column must be CHW-packed, in the cuDNN sense.
  *
+ *  If the input type is real, the forward transform is real-to-complex
+ *  and the backward transform is complex-to-real, with the usual
+ *  Hermitian-packed layout for the complex side (the last dimension
+ *  of each feature map is n/2+1).
+ *
+ *  Plans are cached by dimensions, number of samples and leading
+ *  dimensions, so alternating between minibatch sizes does not
+ *  rebuild them.
+ *
  *  This class is structured to match the FFTWWrapper, even though the
  *  cuFFT interface is simpler and better in many ways.
  */
@@ -155,7 +224,8 @@ public:
   using InputMatType = El::Matrix<InputType, El::Device::GPU>;
   using OutputMatType = El::Matrix<OutputType, El::Device::GPU>;
 
-  using ExecutorType = cuFFTExecutor<InputType, OutputType>;
+  using ForwardExecutorType = cuFFTExecutor<InputType, OutputType>;
+  using BackwardExecutorType = cuFFTExecutor<OutputType, InputType>;
   using PlanType = cufftHandle;
 
 private:
@@ -164,8 +234,24 @@ private:
     size_t worksize_ = 0ULL;
     PlanType plan_ = 0;
     int num_samples_ = -1; // It's just an int in the basic interface
-    InternalPlanType(PlanType plan, size_t worksize, int n)
-      : worksize_{worksize}, plan_{plan}, num_samples_{n}
+    std::vector<int> dims_;
+    El::Int in_height_ = 0;
+    El::Int in_ldim_ = 0;
+    El::Int out_ldim_ = 0;
+    InternalPlanType(PlanType plan,
+                     size_t worksize,
+                     int n,
+                     std::vector<int> dims,
+                     El::Int in_height,
+                     El::Int in_ldim,
+                     El::Int out_ldim)
+      : worksize_{worksize},
+        plan_{plan},
+        num_samples_{n},
+        dims_{std::move(dims)},
+        in_height_{in_height},
+        in_ldim_{in_ldim},
+        out_ldim_{out_ldim}
     {}
     ~InternalPlanType()
     {
@@ -177,12 +263,23 @@ private:
     InternalPlanType(InternalPlanType&& other) noexcept
       : worksize_{other.worksize_},
         plan_{other.plan_},
-        num_samples_{other.num_samples_}
+        num_samples_{other.num_samples_},
+        dims_{std::move(other.dims_)},
+        in_height_{other.in_height_},
+        in_ldim_{other.in_ldim_},
+        out_ldim_{other.out_ldim_}
     {
       other.worksize_ = 0ULL;
       other.plan_ = 0;
       other.num_samples_ = -1;
     }
+    /** @brief Whether the plan applies to these matrices. */
+    template <typename InMatT, typename OutMatT>
+    bool matches(InMatT const& in, OutMatT const& out) const
+    {
+      return (num_samples_ == in.Width() && in_height_ == in.Height() &&
+              in_ldim_ == in.LDim() && out_ldim_ == out.LDim());
+    }
   }; // struct InternalPlanType
 
 public:
@@ -202,7 +299,7 @@ public:
                      OutputMatType& out,
                      std::vector<int> const& full_dims)
   {
-    setup_common(in, out, full_dims);
+    setup_common<ForwardExecutorType>(in, out, full_dims, fwd_plans_);
   }
   /** @brief Setup an in-place forward transform.
    *  @param in Input array; must be allocated, could be overwritten.
@@ -227,7 +324,7 @@ public:
                       InputMatType& out,
                       std::vector<int> const& full_dims)
   {
-    return setup_common(in, out, full_dims);
+    setup_common<BackwardExecutorType>(in, out, full_dims, bwd_plans_);
   }
 
   /** @brief Setup the in-place backward (inverse) transform.
@@ -243,38 +340,42 @@ public:
 
   void compute_forward(InputMatType& in, OutputMatType& out) const
   {
-    return compute_common(in, out, CUFFT_FORWARD);
+    compute_common<ForwardExecutorType>(in, out, CUFFT_FORWARD, fwd_plans_);
   }
 
   void compute_forward(InputMatType& in) const
   {
-    return compute_common(in, in, CUFFT_FORWARD);
+    compute_forward(in, in);
   }
 
   void compute_backward(OutputMatType& in, InputMatType& out) const
   {
-    return compute_common(in, out, CUFFT_INVERSE);
+    compute_common<BackwardExecutorType>(in, out, CUFFT_INVERSE, bwd_plans_);
   }
 
   void compute_backward(OutputMatType& in) const
   {
-    return compute_common(in, in, CUFFT_INVERSE);
+    compute_backward(in, in);
   }
 
 private:
-  void compute_common(OutputMatType& in, InputMatType& out, int dir) const
+  template <typename ExecutorT, typename InMatT, typename OutMatT>
+  void compute_common(InMatT& in,
+                      OutMatT& out,
+                      int dir,
+                      std::vector<InternalPlanType> const& plans) const
   {
     auto const num_samples = in.Width();
     if (num_samples == 0)
       return;
 
     auto const good_plan =
-      std::find_if(cbegin(plans_),
-                   cend(plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
+      std::find_if(cbegin(plans),
+                   cend(plans),
+                   [&in, &out](InternalPlanType const& a) {
+                     return a.matches(in, out);
                    });
-    if (good_plan == cend(plans_))
+    if (good_plan == cend(plans))
       LBANN_ERROR("No valid cuFFT plan found.");
 
     // Setup the workspace
@@ -285,12 +386,12 @@ private:
     // Run the FFT
     bool const contiguous_samples = (in.Contiguous()) && (out.Contiguous());
     if (contiguous_samples) {
-      ExecutorType::Execute(good_plan->plan_, in.Buffer(), out.Buffer(), dir);
+      ExecutorT::Execute(good_plan->plan_, in.Buffer(), out.Buffer(), dir);
     }
     else {
       auto num_batches = in.Width();
       for (El::Int ii = 0; ii < num_batches; ++ii) {
-        ExecutorType::Execute(good_plan->plan_,
+        ExecutorT::Execute(good_plan->plan_,
                               in.Buffer() + ii * in.LDim(),
                               out.Buffer() + ii * out.LDim(),
                               dir);
@@ -298,8 +399,11 @@ private:
     }
   }
 
-  template <typename InMatT, typename OutMatT>
-  void setup_common(InMatT& in, OutMatT& out, std::vector<int> const& full_dims)
+  template <typename ExecutorT, typename InMatT, typename OutMatT>
+  void setup_common(InMatT& in,
+                    OutMatT& out,
+                    std::vector<int> const& full_dims,
+                    std::vector<InternalPlanType>& plans)
   {
     using in_data_type = typename InMatT::value_type;
     using out_data_type = typename OutMatT::value_type;
@@ -311,14 +415,14 @@ private:
       return;
 
     auto const good_plan =
-      std::find_if(cbegin(plans_),
-                   cend(plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
+      std::find_if(cbegin(plans),
+                   cend(plans),
+                   [&in, &out, &full_dims](InternalPlanType const& a) {
+                     return a.matches(in, out) && a.dims_ == full_dims;
                    });
 
     // We don't have a plan for this yet; let's create one!
-    if (good_plan == cend(plans_)) {
+    if (good_plan == cend(plans)) {
       PlanType plan;
       size_t workspace_size = 0ULL;
 
@@ -358,7 +462,7 @@ private:
                                             nullptr,
                                             1,
                                             output_feature_map_size,
-                                            ExecutorType::transform_type,
+                                            ExecutorT::transform_type,
                                             num_transforms,
                                             &workspace_size));
       }
@@ -378,7 +482,7 @@ private:
                                             nullptr,
                                             1,
                                             output_feature_map_size,
-                                            ExecutorType::transform_type,
+                                            ExecutorT::transform_type,
                                             num_transforms,
                                             &workspace_size));
       }
@@ -387,14 +491,21 @@ private:
         LBANN_ERROR("cuFFT plan construction failed "
                     "but cuFFT reported no errors.");
 
-      plans_.emplace_back(plan, workspace_size, num_samples);
+      plans.emplace_back(plan,
+                         workspace_size,
+                         num_samples,
+                         full_dims,
+                         in.Height(),
+                         in.LDim(),
+                         out.LDim());
     }
   }
 
 private:
   // These are likely to be so few in number that a linear search is
   // going to be fine.
-  std::vector<InternalPlanType> plans_;
+  std::vector<InternalPlanType> fwd_plans_;
+  std::vector<InternalPlanType> bwd_plans_;
 
 }; // class cuFFTWrapper
 
@@ -202,6 +202,36 @@ int get_number_of_io_partitions();
  */
 bool is_cosmoflow_parallel_io_enabled();
 
+/** Query if halo exchanges are overlapped with the computation on
+    the interior of local tensors.
+ */
+bool is_halo_exchange_overlapped();
+
+/** Query if the process decomposition of each layer is autotuned.
+ */
+bool is_decomposition_autotuned();
+
+/** Costs measured on this machine, used to choose process
+    decompositions
+ */
+struct cost_measurements
+{
+  /** Seconds to exchange an empty message with a neighbor */
+  double latency;
+  /** Seconds per byte exchanged with a neighbor */
+  double byte_time;
+  /** Seconds per flop of a dense GPU kernel */
+  double flop_time;
+};
+
+/** Get the measured costs.
+
+    The costs are measured on the first call, which is collective on
+    the Distconv communicator. They are maximized over the ranks, so
+    all ranks see the same values.
+ */
+const cost_measurements& get_cost_measurements();
+
 #ifdef DISTCONV_HAS_P2P
 /** Get p2p handle
  */
@@ -86,6 +86,31 @@ dnnHandle_t& get_handle();
 template <typename TensorDataType>
 dnnDataType_t get_data_type();
 
+/** @brief Strides of a fully-packed tensor.
+ *
+ *  Dimensions are given in (N, C, D1, ..., Dn) order. If @c
+ *  channels_last is set, the memory layout is (N, D1, ..., Dn, C),
+ *  i.e. the channel index varies fastest.
+ */
+inline std::vector<int> get_packed_strides(const std::vector<int>& dims,
+                                           bool channels_last = false)
+{
+  std::vector<int> strides(dims.size(), 1);
+  if (channels_last && dims.size() > 2) {
+    strides.back() = dims[1];
+    for (size_t i = strides.size() - 1; i > 2; --i) {
+      strides[i - 1] = strides[i] * dims[i];
+    }
+    strides[0] = strides[2] * dims[2];
+  }
+  else {
+    for (size_t i = strides.size() - 1; i > 0; --i) {
+      strides[i - 1] = strides[i] * dims[i];
+    }
+  }
+  return strides;
+}
+
 ////////////////////////////////////////////////////////////
 // Wrapper classes for DNN library types
 ////////////////////////////////////////////////////////////
@@ -142,10 +167,12 @@ public:
   }
 #if !(defined LBANN_HAS_CUDNN)
   void set(dnnDataType_t data_type,
-           dnnTensorFormat_t /*format*/,
+           dnnTensorFormat_t format,
            const std::vector<int>& dims)
   {
-    this->set(data_type, dims);
+    this->set(data_type,
+              dims,
+              get_packed_strides(dims, format == DNN_TENSOR_NHWC));
   }
 #endif // !LBANN_HAS_CUDNN
 
@@ -580,6 +607,17 @@ public:
   const LayerType* get_layer() const { return m_layer; }
   /** Set the layer being managed. */
   void set_layer(const LayerType* l);
+  /** Whether tensors are stored with the channel index fastest. */
+  bool get_channels_last() const noexcept { return m_channels_last; }
+  /** @brief Store tensors with the channel index fastest.
+   *  @details Tensor dimensions still start with the channel
+   *  dimension, but the memory layout is (D1, ..., Dn, C) within each
+   *  sample. Only respected by data-parallel tensor managers.
+   */
+  void set_channels_last(bool channels_last) noexcept
+  {
+    m_channels_last = channels_last;
+  }
 
   /** Get DNN library tensor descriptor for layer input. */
   virtual TensorDescriptor& get_prev_activations(int parent_index = 0) = 0;
@@ -603,6 +641,8 @@ protected:
 
   /** Layer being managed. */
   const LayerType* m_layer;
+  /** Whether tensors are stored with the channel index fastest. */
+  bool m_channels_last = false;
   /** DNN library tensor descriptors for layer inputs. */
   std::vector<TensorDescriptor> m_prev_activations;
   /** DNN library tensor descriptors for layer outputs. */
@@ -666,6 +706,13 @@ public:
 // DNN library algorithm selection
 ////////////////////////////////////////////////////////////
 
+/** @brief Identify the DNN library version and the current device.
+ *
+ *  Part of the keys of the convolution algorithm cache, so algorithms
+ *  tuned with one library or device are not reused with another.
+ */
+std::string get_algorithm_cache_tag();
+
 /**
  * Select a forward convolution algorithm.
  *
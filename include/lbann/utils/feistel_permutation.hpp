@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_FEISTEL_PERMUTATION_HPP_INCLUDED
+#define LBANN_UTILS_FEISTEL_PERMUTATION_HPP_INCLUDED
+
+#include <array>
+#include <cstdint>
+
+namespace lbann {
+
+/** @class feistel_permutation
+ *  @brief Seeded bijection of [0, size) evaluated one element at a time
+ *
+ *  A balanced Feistel network permutes the smallest domain of an even
+ *  number of bits that covers @c size; images that fall outside
+ *  [0, size) are fed back through the network ("cycle walking") until
+ *  they land inside it. The domain is less than four times @c size,
+ *  so an element takes fewer than four passes on average.
+ *
+ *  The permutation only depends on @c size and @c key, so every rank
+ *  that draws the same key computes the same order without storing
+ *  it. A default-constructed permutation is empty.
+ */
+class feistel_permutation
+{
+public:
+  feistel_permutation() = default;
+  feistel_permutation(uint64_t size, uint64_t key) : m_size(size), m_key(key)
+  {
+    while ((uint64_t{1} << (2 * m_half_bits)) < size) {
+      ++m_half_bits;
+    }
+    m_half_mask = (uint64_t{1} << m_half_bits) - 1;
+    for (auto& round_key : m_round_keys) {
+      key = mix(key + 0x9e3779b97f4a7c15ull);
+      round_key = key;
+    }
+  }
+
+  uint64_t size() const noexcept { return m_size; }
+  uint64_t key() const noexcept { return m_key; }
+
+  /** @brief Image of @c i, which must be less than size() */
+  uint64_t operator()(uint64_t i) const noexcept
+  {
+    do {
+      i = encrypt(i);
+    } while (i >= m_size);
+    return i;
+  }
+
+  /** Archive for checkpoint and restart; the round keys are derived
+   *  again on load */
+  template <class Archive>
+  void save(Archive& ar) const
+  {
+    ar(m_size, m_key);
+  }
+  template <class Archive>
+  void load(Archive& ar)
+  {
+    uint64_t size, key;
+    ar(size, key);
+    *this = feistel_permutation(size, key);
+  }
+
+private:
+  static constexpr int num_rounds = 4;
+
+  /** splitmix64 finalizer */
+  static uint64_t mix(uint64_t z) noexcept
+  {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+  }
+
+  uint64_t encrypt(uint64_t x) const noexcept
+  {
+    uint64_t left = x >> m_half_bits;
+    uint64_t right = x & m_half_mask;
+    for (const auto& round_key : m_round_keys) {
+      const uint64_t next = left ^ (mix(right ^ round_key) & m_half_mask);
+      left = right;
+      right = next;
+    }
+    return (left << m_half_bits) | right;
+  }
+
+  uint64_t m_size = 0;
+  uint64_t m_key = 0;
+  int m_half_bits = 1;
+  uint64_t m_half_mask = 1;
+  std::array<uint64_t, num_rounds> m_round_keys = {};
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_FEISTEL_PERMUTATION_HPP_INCLUDED
@@ -33,6 +33,10 @@
 
 #include <fftw3.h>
 
+#include <algorithm>
+#include <utility>
+#include <vector>
+
 namespace lbann {
 
 namespace fftw {
@@ -203,6 +207,10 @@ BUILD_FFTW_C2C_TRAITS(double, fftw);
  *  DFT of each feature map in a batch of N samples with C feature
  *  maps of size HxW per sample, the input matrix must have width N
  *  and each column must be CHW-packed, in the cuDNN sense.
+ *
+ *  Plans are cached by dimensions, number of samples and leading
+ *  dimensions, so alternating between minibatch sizes does not
+ *  rebuild them.
  */
 template <typename InputTypeT>
 class FFTWWrapper
@@ -228,7 +236,23 @@ private:
   {
     PlanType plan_ = nullptr;
     int num_samples_ = -1; // It's just an int in fftw
-    InternalPlanType(PlanType plan, int n) : plan_{plan}, num_samples_{n} {}
+    std::vector<int> dims_;
+    El::Int in_height_ = 0;
+    El::Int in_ldim_ = 0;
+    El::Int out_ldim_ = 0;
+    InternalPlanType(PlanType plan,
+                     int n,
+                     std::vector<int> dims,
+                     El::Int in_height,
+                     El::Int in_ldim,
+                     El::Int out_ldim)
+      : plan_{plan},
+        num_samples_{n},
+        dims_{std::move(dims)},
+        in_height_{in_height},
+        in_ldim_{in_ldim},
+        out_ldim_{out_ldim}
+    {}
     ~InternalPlanType()
     {
       if (plan_ != nullptr) {
@@ -237,11 +261,23 @@ private:
       }
     }
     InternalPlanType(InternalPlanType&& other) noexcept
-      : plan_{other.plan_}, num_samples_{other.num_samples_}
+      : plan_{other.plan_},
+        num_samples_{other.num_samples_},
+        dims_{std::move(other.dims_)},
+        in_height_{other.in_height_},
+        in_ldim_{other.in_ldim_},
+        out_ldim_{other.out_ldim_}
     {
       other.plan_ = nullptr;
       other.num_samples_ = -1;
     }
+    /** @brief Whether the plan applies to these matrices. */
+    template <typename InMatT, typename OutMatT>
+    bool matches(InMatT const& in, OutMatT const& out) const
+    {
+      return (num_samples_ == in.Width() && in_height_ == in.Height() &&
+              in_ldim_ == in.LDim() && out_ldim_ == out.LDim());
+    }
   }; // struct InternalPlanType
 
 public:
@@ -312,12 +348,11 @@ public:
 
   void compute_forward(InputMatType& in, OutputMatType& out) const
   {
-    auto const num_samples = in.Width();
     auto const good_plan =
       std::find_if(cbegin(fwd_plans_),
                    cend(fwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
+                   [&in, &out](InternalPlanType const& a) {
+                     return a.matches(in, out);
                    });
     if (good_plan == cend(fwd_plans_))
       LBANN_ERROR("No valid FFTW plan found.");
@@ -336,12 +371,11 @@ public:
 
   void compute_backward(OutputMatType& in, InputMatType& out) const
   {
-    auto const num_samples = in.Width();
     auto const good_plan =
       std::find_if(cbegin(bwd_plans_),
                    cend(bwd_plans_),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
+                   [&in, &out](InternalPlanType const& a) {
+                     return a.matches(in, out);
                    });
     if (good_plan == cend(bwd_plans_))
       LBANN_ERROR("No valid FFTW plan found.");
@@ -379,8 +413,8 @@ private:
     auto const good_plan =
       std::find_if(cbegin(plans),
                    cend(plans),
-                   [num_samples](InternalPlanType const& a) {
-                     return a.num_samples_ == num_samples;
+                   [&in, &out, &full_dims](InternalPlanType const& a) {
+                     return a.matches(in, out) && a.dims_ == full_dims;
                    });
 
     // We don't have a plan for this yet; let's create one!
@@ -452,7 +486,12 @@ private:
                     "  contiguous: ",
                     contiguous_samples);
 
-      plans.emplace_back(plan, num_samples);
+      plans.emplace_back(plan,
+                         num_samples,
+                         full_dims,
+                         in.Height(),
+                         in.LDim(),
+                         out.LDim());
     }
   }
 
@@ -0,0 +1,85 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_FILE_STAGER_HPP_INCLUDED
+#define LBANN_UTILS_FILE_STAGER_HPP_INCLUDED
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace lbann {
+
+/** @brief Copies data files to node-local storage in the background
+ *
+ *  One thread copies the files it is given, one after another, with
+ *  large sequential reads. Each copy is written under a temporary name
+ *  and renamed once complete, so a file in the local directory is
+ *  either missing or whole. Until a file is staged, path() returns its
+ *  original location, so readers can start before staging ends.
+ */
+class file_stager
+{
+public:
+  /** @param src_dir Directory the file names are relative to
+   *  @param dst_dir Node-local directory to copy them to
+   *  @param files   Names of all of the files
+   *  @param to_copy Indices into @c files of the files this rank copies
+   */
+  file_stager(const std::string& src_dir,
+              const std::string& dst_dir,
+              std::vector<std::string> files,
+              std::vector<size_t> to_copy);
+  ~file_stager();
+  file_stager(const file_stager&) = delete;
+  file_stager& operator=(const file_stager&) = delete;
+
+  /** Path to read file @c i from: the local copy if it exists, which
+   *  includes the copies made by other ranks of the node */
+  std::string path(size_t i) const;
+
+  /// Whether this rank has finished copying its files
+  bool done() const { return m_done; }
+
+private:
+  void run(std::vector<size_t> to_copy);
+  void copy_file(size_t i);
+
+  std::string m_src_dir;
+  std::string m_dst_dir;
+  std::vector<std::string> m_files;
+  /// Whether each file is known to have a local copy
+  std::unique_ptr<std::atomic<bool>[]> m_staged;
+  std::atomic<bool> m_stop;
+  std::atomic<bool> m_done;
+  std::thread m_thread;
+};
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_FILE_STAGER_HPP_INCLUDED
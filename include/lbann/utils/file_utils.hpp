@@ -32,6 +32,7 @@
 #include <fstream>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
@@ -178,6 +179,14 @@ void make_directory(const std::string& path);
 
 void remove_multiple_slashes(std::string& str);
 
+/** @brief Map a whole file read-only and shared.
+ *
+ *  Returns the mapping and its size in bytes. The file is unmapped
+ *  when the last copy of the pointer is released.
+ */
+std::pair<std::shared_ptr<const void>, size_t>
+map_read_only(const std::string& path);
+
 } // namespace file
 
 } // namespace lbann
@@ -93,6 +93,8 @@ namespace lbann {
 namespace cuda {
 
 constexpr cudaMemcpyKind GPU_MEMCPY_DEVICE_TO_DEVICE = cudaMemcpyDeviceToDevice;
+constexpr cudaMemcpyKind GPU_MEMCPY_DEVICE_TO_HOST = cudaMemcpyDeviceToHost;
+constexpr cudaMemcpyKind GPU_MEMCPY_HOST_TO_DEVICE = cudaMemcpyHostToDevice;
 
 // -------------------------------------------------------------
 // Wrapper classes
@@ -103,6 +105,9 @@ class event_wrapper
 {
 public:
   event_wrapper();
+  /** @param timing Whether the event records a timestamp, see
+   *                elapsed_time. */
+  explicit event_wrapper(bool timing);
   event_wrapper(const event_wrapper& other);
   event_wrapper& operator=(const event_wrapper& other);
   ~event_wrapper();
@@ -112,6 +117,10 @@ public:
   bool query() const;
   /** Wait until CUDA event has completed. */
   void synchronize();
+  /** Milliseconds from @c start to this event.
+   *  Both events must record timestamps and have completed.
+   */
+  float elapsed_time(const event_wrapper& start) const;
   /** Get CUDA event object. */
   cudaEvent_t& get_event();
 
@@ -120,6 +129,8 @@ private:
    *  The event object lifetime is managed internally.
    */
   cudaEvent_t m_event;
+  /** Whether the event records a timestamp. */
+  bool m_timing = false;
   /** CUDA stream object.
    *  The stream object lifetime is assumed to be managed externally.
    */
@@ -48,6 +48,29 @@ dim3 max_grid_dims();
 /** @brief Clip grid dims in GPU kernel to maximum size */
 void clip_grid_dims(dim3& grid_dims);
 
+// -------------------------------------------------------------
+// Memory pool
+// -------------------------------------------------------------
+
+/** @brief Usage of Hydrogen's GPU memory pool on a device. */
+struct memory_pool_usage
+{
+  /** @brief Bytes in allocations that are in use. */
+  size_t live_bytes = 0;
+  /** @brief Bytes in freed allocations kept for reuse. */
+  size_t cached_bytes = 0;
+};
+
+/** @brief Usage of the GPU memory pool on the current device.
+ *  @details Zero if Hydrogen is built without a memory pool.
+ */
+memory_pool_usage get_memory_pool_usage();
+
+/** @brief Return the cached blocks of the GPU memory pool to the
+ *         device.
+ */
+void trim_memory_pool();
+
 // -------------------------------------------------------------
 // Device functions
 // -------------------------------------------------------------
@@ -53,6 +53,39 @@ void decode_image(El::Matrix<uint8_t>& src,
                   El::Matrix<uint8_t>& dst,
                   std::vector<size_t>& dims);
 
+/**
+ * @brief Decode an image from buf at a reduced size.
+ * JPEG images are decoded at 1/reduction of their height and width (rounded
+ * up) by scaling the DCT, which is much cheaper than a full decode; other
+ * images are decoded at full size.
+ * @param src A buffer containing image data to be decoded.
+ * @param dst Image will be loaded into this matrix, in OpenCV format.
+ * @param dims Will contain the dimensions of the image as {channels, height,
+ * width}.
+ * @param reduction 1, 2, 4 or 8.
+ */
+void decode_image(El::Matrix<uint8_t>& src,
+                  El::Matrix<uint8_t>& dst,
+                  std::vector<size_t>& dims,
+                  int reduction);
+
+/**
+ * @brief Read an encoded image from filename without decoding it.
+ * @param filename The path to the image to load.
+ * @param buf Will hold the contents of the file.
+ */
+void load_encoded_image(const std::string& filename, El::Matrix<uint8_t>& buf);
+
+/**
+ * @brief Get the size of a JPEG image from its header.
+ * @param src A buffer containing an encoded image.
+ * @returns False if the image is not a JPEG or its size was not found.
+ */
+bool get_jpeg_size(const El::Matrix<uint8_t>& src,
+                   size_t& height,
+                   size_t& width,
+                   size_t& channels);
+
 /**
  * @brief Save an image to filename.
  * @param filename The path to the image to write.
@@ -35,6 +35,12 @@ namespace lbann {
 
 const int lbann_default_random_seed = 42;
 
+/** @brief Exit status of a run stopped by a resize request
+ *  @details EX_TEMPFAIL: the launcher should relaunch the job, with
+ *  the new number of ranks, to resume from its checkpoint.
+ */
+const int lbann_resize_exit_status = 75;
+
 /** @brief Loads a trained model from checkpoint for inference only
  * @param[in] lc An LBANN Communicator
  * @param[in] cp_dir The model checkpoint directory
@@ -77,6 +83,15 @@ trainer& construct_trainer(lbann_comm* comm,
                            lbann_data::Trainer* pb_trainer,
                            lbann_data::LbannPB& pb);
 
+/** @brief Whether a checkpoint callback of the trainer stopped
+ *         training for a resize request
+ *  @details Collective over the world, since trainers stop at
+ *  different steps. The world master then removes the request file,
+ *  so that the relaunched job trains. See
+ *  callback::checkpoint::set_resize_request_file.
+ */
+bool finish_resize_request(lbann_comm& comm, trainer& t);
+
 std::unique_ptr<thread_pool> construct_io_thread_pool(lbann_comm* comm,
                                                       bool serialized_io);
 
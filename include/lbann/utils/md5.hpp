@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_MD5_HPP_INCLUDED
+#define LBANN_UTILS_MD5_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_MD5_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_MD5_FUNC inline
+#endif // defined __CUDACC__ || defined __HIPCC__
+
+namespace lbann {
+namespace md5 {
+
+/** @brief MD5 digest as four little-endian words */
+struct digest
+{
+  uint32_t state[4];
+};
+
+/** @brief MD5 hash of a short message
+ *
+ *  The message must fit in one 64-byte block with its padding, i.e.
+ *  be at most 55 bytes long. This covers the hash of single tensor
+ *  entries without the buffering of a streaming implementation, so
+ *  the same code runs on host and device.
+ */
+LBANN_MD5_FUNC digest hash(const unsigned char* data, size_t len)
+{
+  constexpr uint32_t K[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a,
+    0xa8304613, 0xfd469501, 0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be,
+    0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821, 0xf61e2562, 0xc040b340,
+    0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8,
+    0x676f02d9, 0x8d2a4c8a, 0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c,
+    0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70, 0x289b7ec6, 0xeaa127fa,
+    0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92,
+    0xffeff47d, 0x85845dd1, 0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1,
+    0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391};
+  constexpr int S[16] =
+    {7, 12, 17, 22, 5, 9, 14, 20, 4, 11, 16, 23, 6, 10, 15, 21};
+
+  // Padded message block
+  // Note: MD5 reads the message as little-endian words.
+  uint32_t m[16] = {};
+  for (size_t i = 0; i < len; ++i) {
+    m[i / 4] |= static_cast<uint32_t>(data[i]) << (8 * (i % 4));
+  }
+  m[len / 4] |= uint32_t(0x80) << (8 * (len % 4));
+  const uint64_t bitlen = static_cast<uint64_t>(len) * 8;
+  m[14] = static_cast<uint32_t>(bitlen);
+  m[15] = static_cast<uint32_t>(bitlen >> 32);
+
+  // Compression function
+  digest out = {{0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476}};
+  uint32_t a = out.state[0], b = out.state[1];
+  uint32_t c = out.state[2], d = out.state[3];
+  for (int i = 0; i < 64; ++i) {
+    uint32_t f;
+    int g;
+    if (i < 16) {
+      f = (b & c) | (~b & d);
+      g = i;
+    }
+    else if (i < 32) {
+      f = (b & d) | (c & ~d);
+      g = (5 * i + 1) % 16;
+    }
+    else if (i < 48) {
+      f = b ^ c ^ d;
+      g = (3 * i + 5) % 16;
+    }
+    else {
+      f = c ^ (b | ~d);
+      g = (7 * i) % 16;
+    }
+    f += a + K[i] + m[g];
+    const int s = S[(i / 16) * 4 + (i % 4)];
+    a = d;
+    d = c;
+    c = b;
+    b += (f << s) | (f >> (32 - s));
+  }
+  out.state[0] += a;
+  out.state[1] += b;
+  out.state[2] += c;
+  out.state[3] += d;
+  return out;
+}
+
+/** @brief Upper 64 bits of the MD5 hash of a value's bytes
+ *
+ *  The 128-bit digest is read as a little-endian unsigned integer.
+ *  This is the word the uniform hash layer scales to [0,1).
+ */
+template <typename T>
+LBANN_MD5_FUNC uint64_t hash64(const T& x)
+{
+  static_assert(sizeof(T) <= 55, "MD5 message must fit in one block");
+  const auto h = hash(reinterpret_cast<const unsigned char*>(&x), sizeof(T));
+  return static_cast<uint64_t>(h.state[2]) |
+         (static_cast<uint64_t>(h.state[3]) << 32);
+}
+
+} // namespace md5
+} // namespace lbann
+
+#endif // LBANN_UTILS_MD5_HPP_INCLUDED
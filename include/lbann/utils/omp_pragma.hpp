@@ -32,6 +32,7 @@
 
 /// Allow OpenMP parallel for loops to be replaced with taskloop constructs
 /// Requires OpenMP 5.0 support for taskloop reduction clauses
+/// The SIMD variants also vectorize the loop, e.g. over contiguous data
 
 #ifndef LBANN_DETERMINISTIC
 
@@ -58,6 +59,13 @@
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE5                                       \
   _Pragma("omp taskloop collapse(5) default(shared) "                          \
           "num_tasks(omp_get_num_threads())")
+#define LBANN_OMP_PARALLEL_FOR_SIMD_TEXT(arg)                                  \
+  LBANN_OMP_PARALLEL_FOR_HELPER(omp taskloop simd default(shared)              \
+                                  num_tasks(omp_get_num_threads()) arg)
+#define LBANN_OMP_PARALLEL_FOR_SIMD_ARGS(arg)                                  \
+  _Pragma(LBANN_OMP_PARALLEL_FOR_SIMD_TEXT(arg))
+#define LBANN_OMP_PARALLEL_FOR_SIMD                                            \
+  _Pragma("omp taskloop simd default(shared) num_tasks(omp_get_num_threads())")
 #else
 #define LBANN_OMP_PARALLEL_FOR_HELPER(arg) #arg
 #define LBANN_OMP_PARALLEL_FOR_TEXT(arg) LBANN_OMP_PARALLEL_FOR_HELPER(omp parallel for arg)
@@ -69,6 +77,11 @@
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE3 _Pragma("omp parallel for collapse(3)")
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE4 _Pragma("omp parallel for collapse(4)")
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE5 _Pragma("omp parallel for collapse(5)")
+#define LBANN_OMP_PARALLEL_FOR_SIMD_TEXT(arg)                                  \
+  LBANN_OMP_PARALLEL_FOR_HELPER(omp parallel for simd arg)
+#define LBANN_OMP_PARALLEL_FOR_SIMD_ARGS(arg)                                  \
+  _Pragma(LBANN_OMP_PARALLEL_FOR_SIMD_TEXT(arg))
+#define LBANN_OMP_PARALLEL_FOR_SIMD _Pragma("omp parallel for simd")
 #endif
 
 #define LBANN_OMP_PARALLEL_HELPER(arg) #arg
@@ -88,6 +101,9 @@
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE3
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE4
 #define LBANN_OMP_PARALLEL_FOR_COLLAPSE5
+#define LBANN_OMP_PARALLEL_FOR_SIMD_TEXT(arg)
+#define LBANN_OMP_PARALLEL_FOR_SIMD_ARGS(arg)
+#define LBANN_OMP_PARALLEL_FOR_SIMD
 #define LBANN_OMP_PARALLEL_HELPER(arg)
 #define LBANN_OMP_PARALLEL_TEXT(arg)
 #define LBANN_OMP_PARALLEL_ARGS(arg)
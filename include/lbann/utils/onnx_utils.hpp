@@ -37,6 +37,8 @@
 
 #include <onnx/onnx_pb.h>
 
+#include <fstream>
+#include <string>
 #include <vector>
 
 namespace lbann {
@@ -120,6 +122,37 @@ void add_data(onnx::TensorProto& p, El::Complex<T> const& x)
   add_data(p, El::ImagPart(x));
 }
 
+// Type of the entries in external data files. FP16 types are stored
+// as float, as in the message.
+template <typename T>
+struct onnx_external_type
+{
+  using type = T;
+};
+#ifdef LBANN_HAS_HALF
+template <>
+struct onnx_external_type<cpu_half_type>
+{
+  using type = float;
+};
+#if defined LBANN_HAS_GPU && defined LBANN_HAS_GPU_FP16
+template <>
+struct onnx_external_type<gpu_half_type>
+{
+  using type = float;
+};
+#endif // defined LBANN_HAS_GPU && defined LBANN_HAS_GPU_FP16
+#endif // LBANN_HAS_HALF
+
+inline void add_external_data(onnx::TensorProto& p,
+                              std::string const& key,
+                              std::string const& value)
+{
+  auto* entry = p.add_external_data();
+  entry->set_key(key);
+  entry->set_value(value);
+}
+
 // Clear any data present in the message.
 template <typename T>
 void clear_msg_data(onnx::TensorProto& p, TypeTag<T>)
@@ -226,6 +259,83 @@ void serialize_to_onnx(El::AbstractDistMatrix<T> const& m,
   }
 }
 
+/** @brief Serialize a DistMatrix to an ONNX external data file.
+ *
+ *  The tensor is laid out as in serialize_to_onnx, but its values are
+ *  written to @c filename instead of the message. The matrix is
+ *  gathered on rank @c writer of its grid, which writes the file, so
+ *  only that process holds the whole matrix. All processes in the
+ *  grid must participate in the call, and the message is filled on
+ *  all of them.
+ *
+ *  @param[in] m The distributed matrix to serialize.
+ *  @param[in] height_dims The tensor dimensions represented in the
+ *                         height of the input matrix.
+ *  @param[in] width_dims The tensor dimensions represented in the
+ *                        width of the input matrix.
+ *  @param[in] writer Rank in the matrix's grid that writes the file.
+ *  @param[in] filename File to which the values are written.
+ *  @param[in] location Path of the file relative to the ONNX model
+ *                      file.
+ *  @param[out] p The protobuf message into which to serialize the
+ *                tensor description.
+ */
+template <typename T, typename SizeT>
+void serialize_to_onnx_external(El::AbstractDistMatrix<T> const& m,
+                                std::vector<SizeT> const& height_dims,
+                                std::vector<SizeT> const& width_dims,
+                                int writer,
+                                std::string const& filename,
+                                std::string const& location,
+                                onnx::TensorProto& p)
+{
+  using namespace El;
+  using StoredT = typename details::onnx_external_type<T>::type;
+  auto const height = m.Height();
+  auto const width = m.Width();
+
+  details::clear_msg_data(p, TypeTag<T>{});
+  if (width_dims.empty()) {
+    LBANN_ASSERT(lbann::get_linear_size(height_dims) ==
+                 static_cast<size_t>(height));
+    LBANN_ASSERT(width == static_cast<Int>(1));
+    for (auto const& d : height_dims)
+      p.add_dims(d);
+  }
+  else {
+    p.add_dims(height);
+    p.add_dims(width);
+  }
+  details::set_datatype(p, TypeTag<T>{});
+  p.set_data_location(onnx::TensorProto::EXTERNAL);
+  p.clear_external_data();
+  details::add_external_data(p, "location", location);
+  details::add_external_data(p, "offset", "0");
+  details::add_external_data(
+    p,
+    "length",
+    std::to_string(height * width * sizeof(StoredT)));
+
+  DistMatrix<T, CIRC, CIRC, ELEMENT, Device::CPU> gathered(m.Grid(), writer);
+  Copy(m, gathered);
+  if (gathered.CrossRank() != gathered.Root())
+    return;
+
+  // Write a row at a time in the row-major ordering ONNX expects
+  auto const& mat = gathered.LockedMatrix();
+  std::ofstream os(filename, std::ios::binary);
+  std::vector<StoredT> row(width);
+  for (auto r = decltype(height){0}; r < height; ++r) {
+    for (auto c = decltype(width){0}; c < width; ++c)
+      row[c] = static_cast<StoredT>(mat.CRef(r, c));
+    os.write(reinterpret_cast<char const*>(row.data()),
+             row.size() * sizeof(StoredT));
+  }
+  os.close();
+  if (os.fail())
+    LBANN_ERROR("failed to write ONNX external data file ", filename);
+}
+
 } // namespace lbann
 #endif // LBANN_HAS_ONNX
 #endif // LBANN_UTILS_ONNX_UTILS_HPP_INCLUDED
@@ -39,10 +39,17 @@ namespace lbann {
 // Bool flags
 #define LBANN_OPTION_DISABLE_BACKGROUND_IO_ACTIVITY                            \
   "disable_background_io_activity"
+#define LBANN_OPTION_CONCAT_SLICE_VIEWS "concat_slice_views"
 #define LBANN_OPTION_DISABLE_CUDA "disable_cuda"
 #define LBANN_OPTION_DISABLE_SIGNAL_HANDLER "disable_signal_handler"
 #define LBANN_OPTION_EXIT_AFTER_SETUP "exit_after_setup"
+#define LBANN_OPTION_FLAT_WEIGHTS_STATE "flat_weights_state"
+#define LBANN_OPTION_FOLD_PERMUTES "fold_permutes"
+#define LBANN_OPTION_FUSE_OPTIMIZER_STEPS "fuse_optimizer_steps"
+#define LBANN_OPTION_FUSE_RELU "fuse_relu"
 #define LBANN_OPTION_GENERATE_MULTI_PROTO "generate_multi_proto"
+#define LBANN_OPTION_GPU_GRAPH_TRAINING "gpu_graph_training"
+#define LBANN_OPTION_HIERARCHICAL_ALLREDUCE "hierarchical_allreduce"
 #define LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR_IS_COMPLETE                        \
   "load_model_weights_dir_is_complete"
 // Deprecated -- "LTFB Callback"
@@ -53,9 +60,14 @@ namespace lbann {
 #define LBANN_OPTION_ALLOW_MULTITRAINER_GLOBAL_STATISTICS                      \
   "Allow multitrainer global statistics"
 #define LBANN_OPTION_NO_IM_COMM "no_im_comm"
+#define LBANN_OPTION_OVERLAP_OPTIMIZER_STEPS "overlap_optimizer_steps"
+#define LBANN_OPTION_PACK_EVALUATION_VALUES "pack_evaluation_values"
+#define LBANN_OPTION_PLAN_ACTIVATION_MEMORY "plan_activation_memory"
+#define LBANN_OPTION_PIPELINE_STAGES "pipeline_stages"
 #define LBANN_OPTION_PRELOAD_DATA_STORE "preload_data_store"
 #define LBANN_OPTION_PRINT_AFFINITY "print_affinity"
 #define LBANN_OPTION_SERIALIZE_IO "serialize_io"
+#define LBANN_OPTION_SHARD_WEIGHTS "shard_weights"
 #define LBANN_OPTION_ST_ON "st_on"
 #define LBANN_OPTION_ST_FULL_TRACE "st_full_trace"
 #define LBANN_OPTION_STACK_TRACE_TO_FILE "stack_trace_to_file"
@@ -69,15 +81,23 @@ namespace lbann {
 #define LBANN_OPTION_INIT_NVSHMEM "Initialize NVSHMEM when initializing LBANN"
 
 // Input options
+#define LBANN_OPTION_CALIPER_CONFIG "caliper_config"
 #define LBANN_OPTION_CKPT_DIR "ckpt_dir"
+#define LBANN_OPTION_CONV_ALGO_CACHE "conv_algo_cache"
+#define LBANN_OPTION_GRADIENT_BUCKET_MB "Gradient bucket MB"
 #define LBANN_OPTION_HYDROGEN_BLOCK_SIZE "hydrogen_block_size"
+#define LBANN_OPTION_IO_THREAD_DEVICE "io_thread_device"
 #define LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR "load_model_weights_dir"
 #define LBANN_OPTION_MAX_RNG_SEEDS_DISPLAY "RNG seeds per trainer to display"
 #define LBANN_OPTION_METADATA "metadata"
+#define LBANN_OPTION_MINI_BATCH_CACHE_MB "Mini-batch cache MB"
 #define LBANN_OPTION_MINI_BATCH_SIZE "mini_batch_size"
 #define LBANN_OPTION_MODEL "model"
+#define LBANN_OPTION_NUM_BRANCH_STREAMS "Num. branch streams"
 #define LBANN_OPTION_NUM_EPOCHS "num_epochs"
+#define LBANN_OPTION_NUM_IO_BUFFERS "Num. IO buffers"
 #define LBANN_OPTION_NUM_IO_THREADS "Num. IO threads"
+#define LBANN_OPTION_NUM_IO_WORKER_PROCESSES "Num. IO worker processes"
 #define LBANN_OPTION_NUM_PARALLEL_READERS "num_parallel_readers"
 #define LBANN_OPTION_OPTIMIZER "optimizer"
 #define LBANN_OPTION_PROCS_PER_TRAINER "Processes per trainer"
@@ -90,6 +110,7 @@ namespace lbann {
 #define LBANN_OPTION_TRAINER_GRID_HEIGHT                                       \
   "Height of 2D process grid for each trainer"
 #define LBANN_OPTION_TRAINER_PRIMARY_GRID_SIZE "Primary Grid Size per trainer"
+#define LBANN_OPTION_TRAINER_PLACEMENT "trainer_placement"
 #define LBANN_OPTION_TRAINER_ENABLE_SUBGRID_ASYNC_COMM                         \
   "Enable async communication in Sub-grid parallelism"
 #define LBANN_OPTION_TRAINER_ENABLE_TOPO_AWARE_SUBGRID                         \
@@ -99,26 +120,45 @@ namespace lbann {
 
 /****** datastore options ******/
 // Bool flags
+#define LBANN_OPTION_DATA_STORE_ARENA "data_store_arena"
 #define LBANN_OPTION_DATA_STORE_CACHE "data_store_cache"
+#define LBANN_OPTION_DATA_STORE_CACHE_SHARED "data_store_cache_shared"
+#define LBANN_OPTION_DATA_STORE_COMPRESS "data_store_compress"
 #define LBANN_OPTION_DATA_STORE_DEBUG "data_store_debug"
 #define LBANN_OPTION_DATA_STORE_FAIL "data_store_fail"
+#define LBANN_OPTION_DATA_STORE_LOCALITY_AWARE "data_store_locality_aware"
 #define LBANN_OPTION_DATA_STORE_MIN_MAX_TIMING "data_store_min_max_timing"
 #define LBANN_OPTION_DATA_STORE_NO_THREAD "data_store_no_thread"
 #define LBANN_OPTION_DATA_STORE_PROFILE "data_store_profile"
+#define LBANN_OPTION_DATA_STORE_SPILL_SEGMENTS "data_store_spill_segments"
 #define LBANN_OPTION_DATA_STORE_TEST_CACHE "data_store_test_cache"
 #define LBANN_OPTION_NODE_SIZES_VARY "node_sizes_vary"
 
 // Input options
+#define LBANN_OPTION_DATA_STORE_EXCHANGE_LOOKAHEAD                             \
+  "data_store_exchange_lookahead"
+#define LBANN_OPTION_DATA_STORE_LOCALITY_RANDOMNESS                            \
+  "data_store_locality_randomness"
+#define LBANN_OPTION_DATA_STORE_MEM_BUDGET_MB "data_store_mem_budget_mb"
 #define LBANN_OPTION_DATA_STORE_SPILL "data_store_spill"
+#define LBANN_OPTION_DATA_STORE_SPILL_CACHE_MB "data_store_spill_cache_mb"
+#define LBANN_OPTION_DATA_STORE_SPILL_PREFETCH "data_store_spill_prefetch"
 #define LBANN_OPTION_DATA_STORE_TEST_CHECKPOINT "data_store_test_checkpoint"
 
 /****** datareader options ******/
 // Bool flags
 #define LBANN_OPTION_CHECK_DATA "check_data"
+#define LBANN_OPTION_CSV_COLUMN_CACHE "csv_column_cache"
+#define LBANN_OPTION_DEFER_EVAL_READER_LOAD "defer_eval_reader_load"
+#define LBANN_OPTION_FUSED_IMAGE_DECODE "fused_image_decode"
 #define LBANN_OPTION_KEEP_SAMPLE_ORDER "keep_sample_order"
 #define LBANN_OPTION_KEEP_PACKED_FIELDS "keep_packed_fields"
 #define LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE "load_full_sample_list_once"
+#define LBANN_OPTION_MMAP_NUMPY "mmap_numpy"
+#define LBANN_OPTION_PERMUTATION_SHUFFLE "permutation_shuffle"
 #define LBANN_OPTION_QUIET "quiet"
+#define LBANN_OPTION_RAW_INPUT_TRANSFER "raw_input_transfer"
+#define LBANN_OPTION_SHARD_EVAL_ACROSS_TRAINERS "shard_eval_across_trainers"
 #define LBANN_OPTION_WRITE_SAMPLE_LABEL_LIST "write_sample_label_list"
 #define LBANN_OPTION_WRITE_SAMPLE_LIST "write_sample_list"
 #define LBANN_OPTION_Z_SCORE "z_score"
@@ -133,17 +173,25 @@ namespace lbann {
 #define LBANN_OPTION_DATA_FILENAME_TRAIN "data_filename_train"
 #define LBANN_OPTION_DATA_FILENAME_VALIDATE "data_filename_validate"
 #define LBANN_OPTION_DATA_READER_PERCENT "data_reader_percent"
+#define LBANN_OPTION_IMAGE_CACHE_SHORT_SIDE "image_cache_short_side"
+#define LBANN_OPTION_JAG_OPEN_BUNDLES "jag_open_bundles"
 #define LBANN_OPTION_LABEL_FILENAME_TEST "label_filename_test"
 #define LBANN_OPTION_LABEL_FILENAME_TRAIN "label_filename_train"
 #define LBANN_OPTION_LABEL_FILENAME_VALIDATE "label_filename_validate"
 #define LBANN_OPTION_NORMALIZATION "normalization"
 #define LBANN_OPTION_PILOT2_READ_FILE_SIZES "pilot2_read_file_sizes"
 #define LBANN_OPTION_PILOT2_SAVE_FILE_SIZES "pilot2_save_file_sizes"
+#define LBANN_OPTION_SAMPLE_LIST_CACHE "sample_list_cache"
 #define LBANN_OPTION_SAMPLE_LIST_TEST "sample_list_test"
 #define LBANN_OPTION_SAMPLE_LIST_TRAIN "sample_list_train"
 #define LBANN_OPTION_SAMPLE_LIST_VALIDATE "sample_list_validate"
+#define LBANN_OPTION_SEQUENCE_BUCKET_WINDOW "sequence_bucket_window"
 #define LBANN_OPTION_SEQUENCE_LENGTH "sequence_length"
+#define LBANN_OPTION_SHARD_READAHEAD_SIZE "shard_readahead_size"
+#define LBANN_OPTION_SHARD_SHUFFLE_BUFFER "shard_shuffle_buffer"
+#define LBANN_OPTION_SHUFFLE_FILE_WINDOW "shuffle_file_window"
 #define LBANN_OPTION_SMILES_BUFFER_SIZE "smiles_buffer_size"
+#define LBANN_OPTION_STAGE_DIR "stage_dir"
 #define LBANN_OPTION_VOCAB "vocab"
 
 /****** jag options ******/
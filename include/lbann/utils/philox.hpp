@@ -0,0 +1,212 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_PHILOX_HPP_INCLUDED
+#define LBANN_UTILS_PHILOX_HPP_INCLUDED
+
+#include <cmath>
+#include <cstdint>
+
+#if defined __CUDACC__ || defined __HIPCC__
+#define LBANN_PHILOX_FUNC __host__ __device__ __forceinline__
+#else
+#define LBANN_PHILOX_FUNC inline
+#endif // defined __CUDACC__ || defined __HIPCC__
+
+namespace lbann {
+namespace philox {
+
+/** @brief Output of one Philox call */
+struct block
+{
+  uint32_t x[4];
+};
+
+/** @brief Philox4x32-10 counter-based random number generator
+ *
+ *  Maps a 128-bit counter and a 64-bit key to 128 random bits, so a
+ *  random number is a pure function of its indices and can be
+ *  computed again, in any order and on any device, instead of being
+ *  stored. See:
+ *
+ *  John K. Salmon, Mark A. Moraes, Ron O. Dror, and David E. Shaw.
+ *  "Parallel random numbers: as easy as 1, 2, 3." SC'11 (2011).
+ */
+LBANN_PHILOX_FUNC block
+philox4x32(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t c3, uint64_t key)
+{
+  constexpr uint32_t m0 = 0xD2511F53u, m1 = 0xCD9E8D57u;
+  constexpr uint32_t w0 = 0x9E3779B9u, w1 = 0xBB67AE85u;
+  uint32_t k0 = static_cast<uint32_t>(key);
+  uint32_t k1 = static_cast<uint32_t>(key >> 32);
+  for (int round = 0; round < 10; ++round) {
+    const uint64_t p0 = static_cast<uint64_t>(m0) * c0;
+    const uint64_t p1 = static_cast<uint64_t>(m1) * c2;
+    const uint32_t hi0 = static_cast<uint32_t>(p0 >> 32);
+    const uint32_t hi1 = static_cast<uint32_t>(p1 >> 32);
+    c0 = hi1 ^ c1 ^ k0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = hi0 ^ c3 ^ k1;
+    c3 = static_cast<uint32_t>(p0);
+    k0 += w0;
+    k1 += w1;
+  }
+  return {{c0, c1, c2, c3}};
+}
+
+/** @brief Identifies one sequence of random tensors
+ *
+ *  Entry @c i of the tensor drawn at @c step is
+ *  philox4x32(i, step, tag, seed). Each layer draws its own @c seed
+ *  once and regenerates the tensor of a step whenever it needs it
+ *  again (e.g. a dropout mask in backprop, or on recomputation).
+ *  @c tag separates tensors that share a seed and a step, such as
+ *  those of different execution modes.
+ */
+struct stream
+{
+  uint64_t seed = 0;
+  uint32_t step = 0;
+  uint32_t tag = 0;
+
+  LBANN_PHILOX_FUNC block operator()(uint64_t i) const
+  {
+    return philox4x32(static_cast<uint32_t>(i),
+                      static_cast<uint32_t>(i >> 32),
+                      step,
+                      tag,
+                      seed);
+  }
+};
+
+/** @brief Integer threshold of a Bernoulli trial with probability p
+ *
+ *  A trial succeeds if a 32-bit random word is below the threshold,
+ *  so p = 1 always succeeds.
+ */
+inline uint64_t bernoulli_threshold(double p)
+{
+  if (p <= 0.) {
+    return 0;
+  }
+  if (p >= 1.) {
+    return uint64_t{1} << 32;
+  }
+  return static_cast<uint64_t>(p * 4294967296.);
+}
+
+/** @brief Uniform float in (0,1] from the top 24 bits of a word */
+LBANN_PHILOX_FUNC float to_unit_float(uint32_t x)
+{
+  return static_cast<float>((x >> 8) + 1) * (1.f / 16777216.f);
+}
+
+/** @brief Uniform double in (0,1] from 53 bits of two words */
+LBANN_PHILOX_FUNC double to_unit_double(uint32_t hi, uint32_t lo)
+{
+  const uint64_t x = (static_cast<uint64_t>(hi) << 21) ^ (lo >> 11);
+  return static_cast<double>(x + 1) * (1. / 9007199254740992.);
+}
+
+/** @brief Standard normal float from two words (Box-Muller) */
+LBANN_PHILOX_FUNC float to_gaussian_float(const block& b)
+{
+  const float r = sqrtf(-2.f * logf(to_unit_float(b.x[0])));
+  return r * cosf(6.28318530717958647692f * to_unit_float(b.x[1]));
+}
+
+/** @brief Standard normal double from four words (Box-Muller) */
+LBANN_PHILOX_FUNC double to_gaussian_double(const block& b)
+{
+  const double r = sqrt(-2. * log(to_unit_double(b.x[0], b.x[1])));
+  return r * cos(6.28318530717958647692 * to_unit_double(b.x[2], b.x[3]));
+}
+
+/** @brief Distributions drawn from a stream */
+enum class distribution
+{
+  bernoulli,
+  uniform,
+  gaussian
+};
+
+/** @brief Draw one random variable from the bits of an entry
+ *
+ *  Bernoulli variables are @c a with probability threshold / 2^32
+ *  and zero otherwise; uniform variables lie in [a - b, a + b];
+ *  Gaussian variables have mean @c a and standard deviation @c b.
+ */
+template <typename Real>
+LBANN_PHILOX_FUNC Real
+sample(distribution dist, Real a, Real b, uint64_t threshold, const block& x)
+{
+  switch (dist) {
+  case distribution::bernoulli:
+    return x.x[0] < threshold ? a : Real(0);
+  case distribution::uniform:
+    if constexpr (sizeof(Real) > sizeof(float)) {
+      return a + b * (Real(2) * to_unit_double(x.x[0], x.x[1]) - Real(1));
+    }
+    else {
+      return a + b * (Real(2) * to_unit_float(x.x[0]) - Real(1));
+    }
+  default:
+    if constexpr (sizeof(Real) > sizeof(float)) {
+      return a + b * to_gaussian_double(x);
+    }
+    else {
+      return a + b * to_gaussian_float(x);
+    }
+  }
+}
+
+/** @brief Global position of the entries of a local matrix
+ *
+ *  Local entry (i,j) of a distributed matrix is entry
+ *  (col_shift + i * col_stride, row_shift + j * row_stride) of the
+ *  global matrix. Its stream index is its column-major position in
+ *  the global matrix, which does not depend on the distribution.
+ */
+struct index_map
+{
+  int64_t col_shift = 0;
+  int64_t col_stride = 1;
+  int64_t row_shift = 0;
+  int64_t row_stride = 1;
+  int64_t height = 0;
+
+  LBANN_PHILOX_FUNC uint64_t operator()(int64_t i, int64_t j) const
+  {
+    return static_cast<uint64_t>((col_shift + i * col_stride) +
+                                 (row_shift + j * row_stride) * height);
+  }
+};
+
+} // namespace philox
+} // namespace lbann
+
+#endif // LBANN_UTILS_PHILOX_HPP_INCLUDED
@@ -38,6 +38,19 @@ constexpr int prof_colors[num_prof_colors] = {
   0xDD4477, 0x66AA00, 0xB82E2E, 0x316395, 0x994499, 0x22AA99, 0xAAAA11,
   0x6633CC, 0xE67300, 0x8B0707, 0x329262, 0x5574A6, 0x3B3EAC};
 
+/** @brief Start the Caliper measurement given by --caliper_config.
+ *
+ *  Does nothing unless LBANN is built with Caliper. Reports are
+ *  aggregated across ranks, so this is called after MPI is
+ *  initialized.
+ */
+void prof_initialize();
+/** @brief Flush the Caliper measurement, e.g. print its reports.
+ *
+ *  Called before MPI is finalized.
+ */
+void prof_finalize();
+
 void prof_start();
 void prof_stop();
 void prof_region_begin(const char* s, int c, bool sync);
@@ -37,6 +37,8 @@ class LbannPB;
 
 namespace lbann {
 
+class lbann_comm;
+
 /** @file protobuf_utils.hpp
  *  @brief static methods for parsing command line for prototext
  *         filenames, reading in prototext files, etc.
@@ -62,6 +64,17 @@ namespace protobuf_utils {
 std::vector<std::unique_ptr<lbann_data::LbannPB>>
 load_prototext(const bool master, const int trainer_rank = 0);
 
+/** @brief Load the prototext files on one rank and broadcast them.
+ *
+ *  Like load_prototext(master, trainer_rank), but only a root rank
+ *  reads, parses and verifies the files, which are sent to the other
+ *  ranks in serialized form. The root is the world master, or each
+ *  trainer's master if @c per_trainer, in which case the trainer's
+ *  rank selects its files.
+ */
+std::vector<std::unique_ptr<lbann_data::LbannPB>>
+load_prototext(lbann_comm const& comm, bool per_trainer = false);
+
 /** @brief Parses the command line for special prototext flags
  *
  *  This looks for `--model=<string>`, `--reader=<string>`, and
@@ -31,6 +31,7 @@
 #include "lbann/comm.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/philox.hpp"
 #include "lbann/utils/random_number_generators.hpp"
 
 namespace lbann {
@@ -215,6 +216,90 @@ void gaussian_fill_parallel(El::AbstractDistMatrix<TensorDataType>& mat,
                             TensorDataType mean = 0.0,
                             TensorDataType stddev = 1.0);
 
+/** @name Counter-based random matrices
+ *
+ *  Entry (i,j) of @c mat is drawn from @c stream at the column-major
+ *  global index of (i,j) (see philox::index_map), so it only depends
+ *  on the stream and the global height of @c mat: it does not change
+ *  with the distribution or the number of processes, and it can be
+ *  regenerated instead of stored. Each process fills its local
+ *  matrix, on the device that holds it, without communication.
+ */
+///@{
+
+/** Seed of a counter-based stream, the same on every rank of the
+ *  trainer. It is drawn from get_generator() on the trainer master.
+ */
+uint64_t draw_philox_seed(const lbann_comm& comm);
+
+/** Seed of a counter-based stream, the same on every process of
+ *  @c grid. It is drawn from get_generator() on the grid's first
+ *  process.
+ */
+uint64_t draw_philox_seed(const El::Grid& grid);
+
+/** Stream of the tensors drawn at a step of an execution mode. */
+inline philox::stream
+make_philox_stream(uint64_t seed, size_t step, execution_mode mode)
+{
+  philox::stream stream;
+  stream.seed = seed;
+  stream.step = static_cast<uint32_t>(step);
+  stream.tag = static_cast<uint32_t>(mode);
+  return stream;
+}
+
+/** Fill mat with Bernoulli random variables with parameter p. */
+template <typename TensorDataType>
+void philox_bernoulli_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                           double p,
+                           const philox::stream& stream);
+/** Fill mat with uniform random variables in a ball. */
+template <typename TensorDataType>
+void philox_uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                         TensorDataType center,
+                         TensorDataType radius,
+                         const philox::stream& stream);
+/** Fill mat with Gaussian random variables. */
+template <typename TensorDataType>
+void philox_gaussian_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                          TensorDataType mean,
+                          TensorDataType stddev,
+                          const philox::stream& stream);
+/** Keep each entry of input with probability p and scale it by 1/p.
+ *
+ *  The mask is drawn as by philox_bernoulli_fill using the
+ *  distribution of output, so applying it again with the same
+ *  stream (e.g. to gradients in backprop) drops the same entries.
+ */
+template <typename TensorDataType>
+void philox_dropout(const El::AbstractDistMatrix<TensorDataType>& input,
+                    El::AbstractDistMatrix<TensorDataType>& output,
+                    double p,
+                    const philox::stream& stream);
+
+///@}
+
+#ifdef LBANN_HAS_GPU
+namespace details {
+/** GPU implementations of the counter-based random matrices. */
+template <typename TensorDataType>
+void philox_fill_gpu(El::Matrix<TensorDataType, El::Device::GPU>& mat,
+                     const philox::index_map& map,
+                     philox::distribution dist,
+                     double a,
+                     double b,
+                     const philox::stream& stream);
+template <typename TensorDataType>
+void philox_dropout_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  const philox::index_map& map,
+  double p,
+  const philox::stream& stream);
+} // namespace details
+#endif // LBANN_HAS_GPU
+
 bool save_rng_to_checkpoint_shared(persist& p, lbann_comm* comm);
 bool save_rng_to_checkpoint_distributed(persist& p, lbann_comm* comm);
 bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm);
@@ -294,7 +379,25 @@ void rng_bernoulli(const float p, DistMat* m)
                                                  El::Int m,                    \
                                                  El::Int n,                    \
                                                  T mean,                       \
-                                                 T stddev)
+                                                 T stddev);                    \
+  extern template void philox_bernoulli_fill<T>(El::AbstractDistMatrix<T> &    \
+                                                  mat,                         \
+                                                double p,                      \
+                                                const philox::stream& stream); \
+  extern template void philox_uniform_fill<T>(El::AbstractDistMatrix<T> & mat, \
+                                              T center,                        \
+                                              T radius,                        \
+                                              const philox::stream& stream);   \
+  extern template void philox_gaussian_fill<T>(El::AbstractDistMatrix<T> &     \
+                                                 mat,                          \
+                                               T mean,                         \
+                                               T stddev,                       \
+                                               const philox::stream& stream);  \
+  extern template void philox_dropout<T>(                                      \
+    const El::AbstractDistMatrix<T>& input,                                    \
+    El::AbstractDistMatrix<T>& output,                                         \
+    double p,                                                                  \
+    const philox::stream& stream)
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
@@ -29,7 +29,9 @@
 
 #include "lbann/comm.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/philox.hpp"
 #include <atomic>
+#include <cstdint>
 #include <random>
 #include <thread>
 
@@ -115,6 +117,42 @@ int get_num_io_generators();
 /** @brief Sets the local index for a thread to access the correct I/O RNGs. */
 locked_io_rng_ref set_io_generators_local_index(size_t idx);
 
+/** @brief Reseeds the calling thread's I/O RNGs from a key.
+ *
+ *  Used to tie random transforms to a sample rather than to the I/O
+ *  thread that loads it. The thread must hold its I/O RNGs (see
+ *  set_io_generators_local_index). The key takes effect at once for
+ *  draw_io_sample_block; the I/O generators are only reseeded if
+ *  they are used for the sample.
+ */
+void seed_io_generators_for_sample(size_t key);
+
+/** @brief Draw the next random block of a sample's stream.
+ *
+ *  Block @c n drawn with @c tag is philox4x32(n, n >> 32, tag, 0, k),
+ *  where @c k mixes the I/O seed with the key given to
+ *  seed_io_generators_for_sample (or is the I/O seed if no key was
+ *  given to the calling thread). Each tag, e.g. the position of a
+ *  transform in its pipeline, has its own counter, which restarts
+ *  with each key. No lock is needed, and a sample draws the same
+ *  numbers whichever thread loads it and however many I/O threads
+ *  there are.
+ */
+philox::block draw_io_sample_block(uint32_t tag);
+
+/** @brief Draw @c n uniform random values in [a, b) from a sample's
+ *         stream.
+ *
+ *  Value @c i comes from word <tt>i % 4</tt> of the block that
+ *  draw_io_sample_block would return <tt>i / 4</tt> calls later, so
+ *  the whole batch takes a single counter update.
+ */
+void draw_io_sample_uniform(uint32_t tag,
+                            float a,
+                            float b,
+                            float* out,
+                            size_t n);
+
 /**
  * Return a reference to the global LBANN random number generator used
  * for shuffling the data samples within each mini-batch
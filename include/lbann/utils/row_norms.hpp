@@ -0,0 +1,80 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_UTILS_ROW_NORMS_HPP
+#define LBANN_UTILS_ROW_NORMS_HPP
+
+#include "lbann/base.hpp"
+
+#include <vector>
+
+namespace lbann {
+
+/** @brief Squared norms of the rows of several local matrices.
+ *
+ *  Sets @c sqsums[i] to a column vector with the sum of squares of
+ *  each row of @c mats[i]. Used by weight normalization and by the
+ *  row-wise weights norms layer.
+ */
+template <typename T>
+void batched_row_sqsums(
+  std::vector<const El::Matrix<T, El::Device::CPU>*> const& mats,
+  std::vector<El::Matrix<T, El::Device::CPU>*> const& sqsums);
+/** @brief Entrywise square root of several local matrices. */
+template <typename T>
+void batched_sqrt(std::vector<El::Matrix<T, El::Device::CPU>*> const& mats);
+
+#ifdef LBANN_HAS_GPU
+/** @brief Squared norms of the rows of several local matrices on GPU.
+ *
+ *  The matrices are processed by one kernel launch, or one per 32
+ *  matrices, on the stream of the first output. The streams of the
+ *  other matrices are synchronized with it.
+ */
+template <typename T>
+void batched_row_sqsums(
+  std::vector<const El::Matrix<T, El::Device::GPU>*> const& mats,
+  std::vector<El::Matrix<T, El::Device::GPU>*> const& sqsums);
+/** @brief Entrywise square root of several contiguous local
+ *         matrices on GPU, in one kernel launch. */
+template <typename T>
+void batched_sqrt(std::vector<El::Matrix<T, El::Device::GPU>*> const& mats);
+#endif // LBANN_HAS_GPU
+
+#ifndef LBANN_ROW_NORMS_INSTANTIATE
+#define PROTO_DEVICE(T, Device)                                                \
+  extern template void batched_row_sqsums(                                     \
+    std::vector<const El::Matrix<T, Device>*> const&,                          \
+    std::vector<El::Matrix<T, Device>*> const&);                               \
+  extern template void batched_sqrt(std::vector<El::Matrix<T, Device>*> const&)
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+#endif // LBANN_ROW_NORMS_INSTANTIATE
+
+} // namespace lbann
+
+#endif // LBANN_UTILS_ROW_NORMS_HPP
@@ -0,0 +1,185 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_SERIALIZATION_DIST_MATRIX_INDEX_HPP_
+#define LBANN_UTILS_SERIALIZATION_DIST_MATRIX_INDEX_HPP_
+
+#include <El.hpp>
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace utils {
+
+/** @brief Where the local entries of a distributed matrix are in a
+ *         binary archive written by one process.
+ */
+struct dist_matrix_record
+{
+  El::Int height;
+  El::Int width;
+  El::Int local_height;
+  El::Int local_width;
+  El::Int col_shift;
+  El::Int col_stride;
+  El::Int row_shift;
+  El::Int row_stride;
+  /** Size of an entry in bytes. */
+  uint64_t type_size;
+  /** Position of the entries, in column-major order, in the archive
+   *  stream. */
+  uint64_t offset;
+};
+
+/** @brief Records the distributed matrices saved to a binary archive.
+ *
+ *  While a recorder exists, every distributed matrix saved to a
+ *  binary archive over its stream is recorded, in order. With the
+ *  records of every process, the archives can be loaded by a
+ *  different number of processes, see dist_matrix_resharder.
+ */
+class dist_matrix_recorder
+{
+public:
+  /** @param os Stream of the binary archive */
+  explicit dist_matrix_recorder(std::ostream& os);
+  ~dist_matrix_recorder();
+  dist_matrix_recorder(const dist_matrix_recorder&) = delete;
+  dist_matrix_recorder& operator=(const dist_matrix_recorder&) = delete;
+
+  /** @brief Record a matrix that is about to be saved. */
+  template <typename T>
+  void record(El::AbstractDistMatrix<T> const& mat);
+
+  std::vector<dist_matrix_record> const& records() const noexcept
+  {
+    return m_records;
+  }
+
+private:
+  std::ostream* m_os;
+  std::vector<dist_matrix_record> m_records;
+};
+
+/** @brief The recorder of the archive being saved, if any. */
+dist_matrix_recorder* get_dist_matrix_recorder() noexcept;
+
+/** @brief Write the records of a process's archive.
+ *  @param num_procs Number of processes that wrote archives
+ */
+void write_dist_matrix_index(std::ostream& os,
+                             std::vector<dist_matrix_record> const& records,
+                             El::Int num_procs);
+
+/** @brief Read records written by write_dist_matrix_index.
+ *  @param[out] num_procs Number of processes that wrote archives
+ */
+std::vector<dist_matrix_record> read_dist_matrix_index(std::istream& is,
+                                                       El::Int& num_procs);
+
+/** @brief Loads distributed matrices written by a different number of
+ *         processes.
+ *
+ *  While a resharder exists, loading a distributed matrix from a
+ *  binary archive skips its local entries in the archive, which was
+ *  written by one of the old processes. The entries this process
+ *  owns are then read from the archives of the old processes that
+ *  own them, wherever they are, using their records.
+ */
+class dist_matrix_resharder
+{
+public:
+  /** @brief Archive of an old process. */
+  struct source
+  {
+    /** File holding the archive. */
+    std::string filename;
+    /** Position of the archive in the file. */
+    uint64_t offset;
+    std::vector<dist_matrix_record> records;
+  };
+
+  /** @param primary Stream of the archive being loaded
+   *  @param sources Archives of the old processes
+   */
+  dist_matrix_resharder(std::istream& primary, std::vector<source> sources);
+  ~dist_matrix_resharder();
+  dist_matrix_resharder(const dist_matrix_resharder&) = delete;
+  dist_matrix_resharder& operator=(const dist_matrix_resharder&) = delete;
+
+  /** @brief Stream of the archive being loaded. */
+  std::istream& primary() noexcept { return *m_primary; }
+
+  size_t num_sources() const noexcept { return m_sources.size(); }
+
+  /** @brief Start loading the next matrix.
+   *  @returns Its position in the records
+   */
+  size_t next_matrix() noexcept { return m_next++; }
+
+  /** @brief Record of a matrix in an old process's archive. */
+  dist_matrix_record const& record(size_t src, size_t matrix) const;
+
+  /** @brief Read bytes of an old process's archive. */
+  void read(size_t src, uint64_t offset, void* data, size_t size);
+
+private:
+  std::istream* m_primary;
+  std::vector<source> m_sources;
+  /** Streams of the sources, opened on first use. */
+  std::vector<std::unique_ptr<std::ifstream>> m_streams;
+  size_t m_next = 0;
+};
+
+/** @brief The resharder of the archive being loaded, if any. */
+dist_matrix_resharder* get_dist_matrix_resharder() noexcept;
+
+// Implementation
+
+template <typename T>
+void dist_matrix_recorder::record(El::AbstractDistMatrix<T> const& mat)
+{
+  // The global and local dimensions precede the entries
+  const auto position = static_cast<uint64_t>(m_os->tellp());
+  m_records.push_back({mat.Height(),
+                       mat.Width(),
+                       mat.LocalHeight(),
+                       mat.LocalWidth(),
+                       mat.ColShift(),
+                       mat.ColStride(),
+                       mat.RowShift(),
+                       mat.RowStride(),
+                       sizeof(T),
+                       position + 4 * sizeof(El::Int)});
+}
+
+} // namespace utils
+} // namespace lbann
+#endif // LBANN_UTILS_SERIALIZATION_DIST_MATRIX_INDEX_HPP_
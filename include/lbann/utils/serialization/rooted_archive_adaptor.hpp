@@ -53,6 +53,11 @@ namespace lbann {
 
 // An archive that collects data to the root of a grid on save and
 // broadcasts/scatters it on load.
+//
+// An input archive may instead be read by every process of the grid,
+// each from its own stream over the same data. No data is broadcast
+// and distributed matrices are read directly into each process's
+// local matrix, seeking past the entries owned by other processes.
 template <typename OutputArchiveT>
 class RootedOutputArchiveAdaptor
   : public cereal::OutputArchive<RootedOutputArchiveAdaptor<OutputArchiveT>>
@@ -136,14 +141,21 @@ private:
   using BaseType_ = cereal::InputArchive<ThisType_>;
 
 public:
+  /** @param parallel_read Every process reads @c is, which must
+   *         then be a seekable stream over the whole archive.
+   */
   RootedInputArchiveAdaptor(std::istream& is,
                             El::Grid const& g,
-                            El::Int root = 0)
+                            El::Int root = 0,
+                            bool parallel_read = false)
     : BaseType_{this},
-      ar_(g.Rank() == root ? std::make_optional<archive_type>(is)
-                           : std::nullopt),
+      ar_(g.Rank() == root || parallel_read
+            ? std::make_optional<archive_type>(is)
+            : std::nullopt),
+      is_{&is},
       grid_{&g},
-      root_{root}
+      root_{root},
+      parallel_read_{parallel_read}
   {}
 
   El::Grid const& grid() const noexcept { return *grid_; }
@@ -152,37 +164,51 @@ public:
 
   bool am_root() const noexcept { return (this->root() == grid_->Rank()); }
 
+  /** @brief Whether every process reads the archive. */
+  bool parallel_read() const noexcept { return parallel_read_; }
+
+  /** @brief Whether this process reads the archive. */
+  bool am_reader() const noexcept { return parallel_read_ || am_root(); }
+
+  /** @brief The stream under the archive, for parallel reads.
+   *  @details Binary archives read it without buffering, so its
+   *  position is the archive's position.
+   */
+  std::istream& stream() noexcept { return *is_; }
+
   void set_next_name(char const* name)
   {
-    if (this->am_root())
+    if (this->am_reader())
       ::details::set_next_name(ar_.value(), name);
   }
 
   template <typename T>
   void load_on_root(T& data)
   {
-    if (this->am_root())
+    if (this->am_reader())
       ar_.value()(data);
   }
 
   template <typename T>
   void prologue_on_root(T const& data)
   {
-    if (this->am_root())
+    if (this->am_reader())
       prologue(ar_.value(), data);
   }
 
   template <typename T>
   void epilogue_on_root(T const& data)
   {
-    if (this->am_root())
+    if (this->am_reader())
       epilogue(ar_.value(), data);
   }
 
 private:
   std::optional<archive_type> ar_;
+  std::istream* is_;
   El::Grid const* grid_;
   El::Int root_;
+  bool parallel_read_;
 }; // RootedInputArchiveAdaptor
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
@@ -258,6 +284,8 @@ CEREAL_LOAD_FUNCTION_NAME(lbann::RootedInputArchiveAdaptor<InputArchiveT>& ar,
                 "Apparently Hydrogen doesn't support them.");
 
   ar.load_on_root(val);
+  if (ar.parallel_read())
+    return;
   El::mpi::Broadcast(val,
                      ar.root(),
                      ar.grid().Comm(),
@@ -270,6 +298,8 @@ void CEREAL_LOAD_FUNCTION_NAME(
   bool& b)
 {
   ar.load_on_root(b);
+  if (ar.parallel_read())
+    return;
   int val = b;
   El::mpi::Broadcast(val,
                      ar.root(),
@@ -292,6 +322,8 @@ void CEREAL_LOAD_FUNCTION_NAME(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
                                std::basic_string<CharT, TraitsT, AllocT>& str)
 {
   ar.load_on_root(str);
+  if (ar.parallel_read())
+    return;
   auto str_len = str.size();
   El::mpi::Broadcast(str_len,
                      ar.root(),
@@ -330,6 +362,8 @@ void CEREAL_LOAD_FUNCTION_NAME(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
                                SizeTag<T>& tag)
 {
   ar.load_on_root(tag);
+  if (ar.parallel_read())
+    return;
   El::mpi::Broadcast(tag.size,
                      ar.root(),
                      ar.grid().Comm(),
@@ -27,11 +27,16 @@
 #ifndef LBANN_UTILS_SERIALIZATION_SERIALIZE_MATRICES_IMPL_HPP_
 #define LBANN_UTILS_SERIALIZATION_SERIALIZE_MATRICES_IMPL_HPP_
 
+#include "lbann/utils/serialization/dist_matrix_index.hpp"
 #include "lbann/utils/serialization/serialize_matrices.hpp"
 
 #include <El/blas_like/level1/Copy/Translate.hpp>
 #include <El/blas_like/level1/Copy/TranslateBetweenGrids.hpp>
 
+#include <istream>
+#include <utility>
+#include <vector>
+
 // These really belong in Elemental; let's just extend that.
 namespace El {
 
@@ -179,6 +184,8 @@ void load(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
 
   // Restore the local matrix, then handle the Bcast
   ar.load_on_root(mat);
+  if (ar.parallel_read())
+    return;
 
   // First broadcast the size information.
   auto height = mat.Height();
@@ -226,12 +233,119 @@ void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat)
   mat.Resize(global_height, global_width);
 }
 
+namespace details {
+
+/** @brief Read the local entries of a distributed matrix saved by a
+ *         different number of processes.
+ *
+ *  The entries saved by this archive's process are skipped. Each old
+ *  process's archive is then searched, in order, for the local
+ *  entries it holds, reading the span of rows holding them in each
+ *  column it shares with this process's local matrix.
+ */
+template <typename T>
+void reshard_local_entries(lbann::utils::dist_matrix_resharder& resharder,
+                           ::El::AbstractDistMatrix<T>& mat)
+{
+  if (mat.Wrap() != ::El::ELEMENT) {
+    LBANN_ERROR("only elementwise distributions can be resharded");
+  }
+  auto& is = resharder.primary();
+  ::El::Int stored_height, stored_width;
+  is.read(reinterpret_cast<char*>(&stored_height), sizeof(stored_height));
+  is.read(reinterpret_cast<char*>(&stored_width), sizeof(stored_width));
+  is.seekg(static_cast<std::streamoff>(stored_height * stored_width *
+                                       sizeof(T)),
+           std::ios::cur);
+  if (!is) {
+    LBANN_ERROR("failed to skip the local entries of a ",
+                mat.Height(),
+                " x ",
+                mat.Width(),
+                " matrix");
+  }
+
+  const size_t matrix = resharder.next_matrix();
+  const ::El::Int local_height = mat.LocalHeight();
+  const ::El::Int local_width = mat.LocalWidth();
+  const ::El::Int local_size = local_height * local_width;
+  ::El::Matrix<T, ::El::Device::CPU> local(local_height, local_width);
+  std::vector<char> filled(local_size, 0);
+  ::El::Int num_filled = 0;
+  std::vector<std::pair<::El::Int, ::El::Int>> rows, cols;
+  std::vector<T> column;
+  for (size_t src = 0; src < resharder.num_sources() && num_filled < local_size;
+       ++src) {
+    const auto& record = resharder.record(src, matrix);
+    if (record.height != mat.Height() || record.width != mat.Width() ||
+        record.type_size != sizeof(T)) {
+      LBANN_ERROR("distributed matrix ",
+                  matrix,
+                  " does not match its record in the checkpoint");
+    }
+
+    // Local rows and columns held by the old process, with their
+    // positions in its local matrix
+    rows.clear();
+    for (::El::Int row = 0; row < local_height; ++row) {
+      const ::El::Int i = mat.GlobalRow(row) - record.col_shift;
+      if (i >= 0 && i % record.col_stride == 0 &&
+          i / record.col_stride < record.local_height) {
+        rows.emplace_back(row, i / record.col_stride);
+      }
+    }
+    cols.clear();
+    for (::El::Int col = 0; col < local_width; ++col) {
+      const ::El::Int j = mat.GlobalCol(col) - record.row_shift;
+      if (j >= 0 && j % record.row_stride == 0 &&
+          j / record.row_stride < record.local_width) {
+        cols.emplace_back(col, j / record.row_stride);
+      }
+    }
+    if (rows.empty() || cols.empty()) {
+      continue;
+    }
+
+    const ::El::Int first_row = rows.front().second;
+    column.resize(rows.back().second - first_row + 1);
+    for (const auto& [col, src_col] : cols) {
+      resharder.read(src,
+                     record.offset +
+                       (src_col * record.local_height + first_row) * sizeof(T),
+                     column.data(),
+                     column.size() * sizeof(T));
+      for (const auto& [row, src_row] : rows) {
+        auto& done = filled[row + col * local_height];
+        if (!done) {
+          local(row, col) = column[src_row - first_row];
+          done = 1;
+          ++num_filled;
+        }
+      }
+    }
+  }
+  if (num_filled != local_size) {
+    LBANN_ERROR("the checkpoint only holds ",
+                num_filled,
+                " of the ",
+                local_size,
+                " local entries of distributed matrix ",
+                matrix);
+  }
+  ::El::Copy(local, mat.Matrix());
+}
+
+} // namespace details
+
 template <typename ArchiveT,
           typename T,
           lbann::utils::WhenNotTextArchive<ArchiveT>>
 void save(ArchiveT& ar, ::El::AbstractDistMatrix<T> const& mat)
 {
   LBANN_ASSERT(!mat.Viewing());
+  if (auto* recorder = lbann::utils::get_dist_matrix_recorder()) {
+    recorder->record(mat);
+  }
   // Binary archives don't use NVPs, so there's no point in making
   // them here.
   ar(mat.Height(), mat.Width(), mat.LockedMatrix());
@@ -246,6 +360,10 @@ void load(ArchiveT& ar, ::El::AbstractDistMatrix<T>& mat)
   ::El::Int global_height, global_width;
   ar(global_height, global_width);
   mat.Resize(global_height, global_width);
+  if (auto* resharder = lbann::utils::get_dist_matrix_resharder()) {
+    details::reshard_local_entries(*resharder, mat);
+    return;
+  }
 #ifdef LBANN_DEBUG
   ::El::Matrix<T, ::El::Device::CPU> mat_cpu;
   ar(mat_cpu);
@@ -299,6 +417,60 @@ void save(lbann::RootedOutputArchiveAdaptor<ArchiveT>& ar,
   save(ar, circ_mat_ar);
 }
 
+namespace details {
+
+/** @brief Read the local entries of a distributed matrix saved by a
+ *         rooted archive, when every process reads the archive.
+ *
+ *  The matrix was saved as a column-major CIRC matrix. For each local
+ *  column, only the span of rows holding local rows is read, so no
+ *  process holds more than its local matrix and one column.
+ */
+template <typename ArchiveT, typename T>
+void load_local_entries(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
+                        ::El::AbstractDistMatrix<T>& mat,
+                        ::El::Int height,
+                        ::El::Int width)
+{
+  mat.Resize(height, width);
+  ::El::Int stored_height, stored_width;
+  ar.load_on_root(stored_height);
+  ar.load_on_root(stored_width);
+  LBANN_ASSERT(stored_height == height && stored_width == width);
+
+  auto& is = ar.stream();
+  const auto start = is.tellg();
+  const ::El::Int local_height = mat.LocalHeight();
+  const ::El::Int local_width = mat.LocalWidth();
+  ::El::Matrix<T, ::El::Device::CPU> local(local_height, local_width);
+  if (local_height > 0) {
+    const ::El::Int first_row = mat.GlobalRow(0);
+    const ::El::Int last_row = mat.GlobalRow(local_height - 1);
+    std::vector<T> column(last_row - first_row + 1);
+    for (::El::Int col = 0; col < local_width; ++col) {
+      const ::El::Int global_col = mat.GlobalCol(col);
+      is.seekg(start + static_cast<std::streamoff>(
+                         (global_col * height + first_row) * sizeof(T)));
+      is.read(reinterpret_cast<char*>(column.data()),
+              column.size() * sizeof(T));
+      for (::El::Int row = 0; row < local_height; ++row) {
+        local(row, col) = column[mat.GlobalRow(row) - first_row];
+      }
+    }
+  }
+  is.seekg(start + static_cast<std::streamoff>(height * width * sizeof(T)));
+  if (!is) {
+    LBANN_ERROR("failed to read the local entries of a ",
+                height,
+                " x ",
+                width,
+                " matrix");
+  }
+  ::El::Copy(local, mat.Matrix());
+}
+
+} // namespace details
+
 template <typename ArchiveT,
           typename T,
           lbann::utils::WhenNotTextArchive<ArchiveT>>
@@ -306,6 +478,14 @@ void load(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
           ::El::AbstractDistMatrix<T>& mat)
 {
   LBANN_ASSERT(!mat.Viewing());
+  // Saved as a CIRC matrix
+  if (ar.parallel_read()) {
+    ::El::Int height, width;
+    ar(::cereal::make_nvp("global_height", height),
+       ::cereal::make_nvp("global_width", width));
+    details::load_local_entries(ar, mat, height, width);
+    return;
+  }
   using CircMatType = ::El::
     DistMatrix<T, ::El::CIRC, ::El::CIRC, ::El::ELEMENT, ::El::Device::CPU>;
 
@@ -354,6 +534,10 @@ void load(lbann::RootedInputArchiveAdaptor<ArchiveT>& ar,
   ::El::Int height, width;
   ar(::cereal::make_nvp("global_height", height),
      ::cereal::make_nvp("global_width", width));
+  if (ar.parallel_read()) {
+    details::load_local_entries(ar, mat, height, width);
+    return;
+  }
 
   // Restore the matrix data on the root process.
   mat.Resize(height, width);
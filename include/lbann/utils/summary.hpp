@@ -31,11 +31,15 @@
 
 #include "lbann/base.hpp"
 #include "lbann/comm.hpp"
+#include <limits>
 #include <string>
 #include <vector>
 
 #ifdef LBANN_HAS_TBINF
 #include "TBinf.hpp"
+#include "lbann/utils/threads/thread_safe_queue.hpp"
+#include <functional>
+#include <thread>
 #endif
 
 namespace lbann {
@@ -57,6 +61,8 @@ using BiggerOf = typename std::conditional<(sizeof(T) > sizeof(U)), T, U>::type;
  * Distributed matrices should be distributed by model.
  * This class automatically prepends "modelN/" to each tag. The tag is only
  * relevant at the world master process.
+ * Events are written by a background thread on the world master, so
+ * training does not wait on the file system.
  *
  * @note WHEN YOU UPDATE THE PUBLIC API HERE, REMEMBER TO UPDATE THE KLUDGE FOR
  * NON-TENSORBOARD BUILDS BELOW!
@@ -111,6 +117,17 @@ public:
   void reduce_2norm(const std::string tag,
                     const El::AbstractDistMatrix<TensorDataType>& mat,
                     int step);
+  /** Report the mean, minimum, maximum, standard deviation and
+   *  squared 2-norm of mat as "<prefix>/mean", "<prefix>/min", etc.
+   *
+   *  The statistics are computed in a single pass over mat. GPU
+   *  matrices are reduced on the device and the results stay there
+   *  until flush, so this does not synchronize with the GPU.
+   */
+  template <typename TensorDataType>
+  void reduce_statistics(const std::string prefix,
+                         const El::AbstractDistMatrix<TensorDataType>& mat,
+                         int step);
   void report_image(std::string const& /*tag*/,
                     std::string const& /*img_format*/,
                     CPUMat const& /*image*/,
@@ -118,14 +135,20 @@ public:
                     int /*step*/);
   /**
    * Write all summaries out.
-   * @todo This can be made faster by combining collective operations element-
-   * wise for each type of summary.
+   * Pending summaries are combined into one sum and one minimum reduction
+   * within each trainer, and one gather over trainers. The events are
+   * queued for the writer thread.
    */
   void flush();
 
 private:
   lbann_comm* m_comm;
+  /** Only used by m_writer. */
   TBinf::SummaryWriter* m_sw;
+  /** Pending writes to m_sw, in order. */
+  thread_safe_queue<std::function<void()>> m_writes;
+  /** Background thread on the world master that runs m_writes. */
+  std::thread m_writer;
 
   /** Represent a pending summary operation.
    * Note that TensorBoard takes scalars as floats
@@ -189,6 +212,30 @@ private:
     /** Sum of the squares of the values in the data. */
     double sqsum;
   };
+  /** Represent a pending reduce_statistics operation. */
+  struct pending_statistics
+  {
+    pending_statistics(const std::string tag_, int step_, int num_)
+      : tag(tag_), step(step_), num(num_)
+    {}
+    /** Associated tag prefix. */
+    const std::string tag;
+    /** Global step. */
+    int step;
+    /** Size of matrix. */
+    int num;
+    /** Locally-computed sum. */
+    float sum = 0.0f;
+    /** Locally-computed sum of squares. */
+    float sqsum = 0.0f;
+    /** Locally-computed minimum. */
+    float min = std::numeric_limits<float>::infinity();
+    /** Locally-computed maximum. */
+    float max = -std::numeric_limits<float>::infinity();
+    /** Column of m_device_statistics holding the local results, or -1
+     *  if they were computed on the host. */
+    El::Int column = -1;
+  };
 
   /** Currently-pending reduce_means. */
   std::vector<pending_op> m_pending_means;
@@ -208,23 +255,24 @@ private:
   std::vector<double> m_histogram_buckets;
   /** Currently-pending reduce_histograms. */
   std::vector<pending_histogram> m_pending_histograms;
+  /** Currently-pending reduce_statistics. */
+  std::vector<pending_statistics> m_pending_statistics;
+#ifdef LBANN_HAS_GPU
+  /** Local sum, sum of squares, minimum and negated maximum of each
+   *  pending GPU reduce_statistics, four entries per column. */
+  El::Matrix<float, El::Device::GPU> m_device_statistics;
+  /** Number of columns of m_device_statistics in use. */
+  El::Int m_num_device_statistics = 0;
+#endif // LBANN_HAS_GPU
 
-  /** Execute all pending mean operations. */
-  void flush_means();
-  /** Execute all pending min operations. */
-  void flush_mins();
-  /** Execute all pending max operations. */
-  void flush_maxes();
-  /** Execute all pending stdev operations. */
-  void flush_stdevs();
-  /** Execute all pending scalar operations. */
-  void flush_scalars();
-  /** Execute all pending sum-scalar operations. */
-  void flush_sum_scalars();
+  /** Execute all pending operations other than scalar-alls. */
+  void flush_reductions();
   /** Execute all pending scalar-all operations. */
   void flush_scalar_alls();
-  /** Execute all pending histogram operations. */
-  void flush_histograms();
+  /** Queue an operation for the writer thread. */
+  void write(std::function<void()> op);
+  /** Queue a scalar for the writer thread. */
+  void write_scalar(std::string tag, float value, int step);
 
   /** Compute the sum of elements in mat. */
   template <typename TensorDataType>
@@ -247,13 +295,21 @@ private:
   template <typename TensorDataType>
   auto local_2norm(const El::AbstractMatrix<TensorDataType>& mat) const
     -> BiggerOf<TensorDataType, float>;
+  /** Compute the local statistics of a CPU matrix in op. */
+  template <typename TensorDataType>
+  void local_statistics(const El::AbstractMatrix<TensorDataType>& mat,
+                        pending_statistics& op) const;
+#ifdef LBANN_HAS_GPU
+  /** Launch the computation of the local statistics of a GPU matrix
+   *  into a new column of m_device_statistics. */
+  template <typename TensorDataType>
+  void local_statistics_gpu(const El::AbstractMatrix<TensorDataType>& mat,
+                            pending_statistics& op);
+  /** Copy the device statistics into the pending operations. */
+  void copy_device_statistics();
+#endif // LBANN_HAS_GPU
   /** Prepend "model<model>/" to tag. */
   std::string prepend_model(const std::string tag, int model) const;
-  /** Gather and write out a scalar summary for each model. */
-  void gather_scalar_summary(const std::string tag, float s, int step);
-  /** Gather and write out a scalar summary for each entry in a vector. */
-  void gather_scalar_summary(const std::vector<pending_op>& ops,
-                             std::vector<float>& scalars);
 };
 
 #else
@@ -310,6 +366,11 @@ public:
                     const El::AbstractDistMatrix<TensorDataType>& mat,
                     int step)
   {}
+  template <typename TensorDataType>
+  void reduce_statistics(const std::string prefix,
+                         const El::AbstractDistMatrix<TensorDataType>& mat,
+                         int step)
+  {}
   void flush() {}
 };
 
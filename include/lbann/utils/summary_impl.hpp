@@ -220,6 +220,40 @@ lbann_summary::reduce_2norm(const std::string tag,
   sum_reduce_scalar(tag, local_norm * local_norm, step);
 }
 
+template <typename TensorDataType>
+inline void lbann_summary::reduce_statistics(
+  const std::string prefix,
+  const El::AbstractDistMatrix<TensorDataType>& mat,
+  int step)
+{
+  pending_statistics op(prefix, step, mat.Height() * mat.Width());
+
+  // Only the master process contributes if matrix is Star,Star
+  // TODO: implement for matrices in Circ,Circ; MC,Star; or similar
+  // formats
+  El::DistData mat_format(mat);
+  if ((mat_format.colDist != El::STAR || mat_format.rowDist != El::STAR ||
+       m_comm->am_trainer_master()) &&
+      mat.LocalHeight() * mat.LocalWidth() > 0) {
+    const auto& local_mat = mat.LockedMatrix();
+    if (local_mat.GetDevice() == El::Device::CPU) {
+      local_statistics(local_mat, op);
+    }
+#ifdef LBANN_HAS_GPU
+    else if constexpr (El::IsComputeType<TensorDataType,
+                                         El::Device::GPU>::value) {
+      local_statistics_gpu(local_mat, op);
+    }
+    else {
+      El::Matrix<TensorDataType, El::Device::CPU> host_mat;
+      El::Copy(local_mat, host_mat);
+      local_statistics(host_mat, op);
+    }
+#endif // LBANN_HAS_GPU
+  }
+  m_pending_statistics.emplace_back(std::move(op));
+}
+
 template <typename TensorDataType>
 inline auto
 lbann_summary::local_sum(const El::AbstractMatrix<TensorDataType>& mat) const
@@ -372,6 +406,38 @@ lbann_summary::local_2norm(const El::AbstractMatrix<TensorDataType>& mat) const
   return El::Sqrt(norm);
 }
 
+template <typename TensorDataType>
+inline void
+lbann_summary::local_statistics(const El::AbstractMatrix<TensorDataType>& mat,
+                                pending_statistics& op) const
+{
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  const El::Int ldim = mat.LDim();
+  const auto* __restrict__ mat_buf = mat.LockedBuffer();
+  using AccumT = BiggerOf<TensorDataType, float>;
+  AccumT sum = AccumT(0);
+  AccumT sqsum = AccumT(0);
+  AccumT min = std::numeric_limits<AccumT>::infinity();
+  AccumT max = -std::numeric_limits<AccumT>::infinity();
+  LBANN_OMP_PARALLEL_FOR_ARGS(
+    reduction(+ : sum, sqsum) reduction(min : min) reduction(max : max)
+      collapse(2))
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      const AccumT val = mat_buf[row + col * ldim];
+      sum += val;
+      sqsum += val * val;
+      min = El::Min(min, val);
+      max = El::Max(max, val);
+    }
+  }
+  op.sum = sum;
+  op.sqsum = sqsum;
+  op.min = min;
+  op.max = max;
+}
+
 #endif // LBANN_HAS_TBINF
 
 } // namespace lbann
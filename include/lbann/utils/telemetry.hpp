@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_UTILS_TELEMETRY_HPP_INCLUDED
+#define LBANN_UTILS_TELEMETRY_HPP_INCLUDED
+
+#include "lbann/utils/timer.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+namespace lbann {
+
+/** @brief Values counted for production monitoring
+ *
+ *  Each rank counts into its own lock-free slots, which the
+ *  export_telemetry callback reduces over the trainer and exports.
+ */
+enum class telemetry_value
+{
+  /** Training steps taken */
+  training_steps,
+  /** Samples trained on by the trainer */
+  training_samples,
+  /** Host time spent in training steps */
+  step_seconds,
+  /** Time the training loop waited for the input pipeline */
+  data_wait_seconds,
+  /** Samples fetched by the input pipeline */
+  input_samples,
+  /** Bytes of samples fetched by the input pipeline */
+  input_bytes,
+  /** Bytes sent by communication operations */
+  comm_bytes_sent,
+  /** Time the host was blocked in communication operations */
+  comm_wait_seconds,
+  /** Host time spent in layer forward prop */
+  forward_prop_seconds,
+  /** Host time spent in layer back prop */
+  backward_prop_seconds,
+  /** Highest usage of the GPU memory pool seen after a layer */
+  gpu_memory_high_water_bytes,
+  NUM_TELEMETRY_VALUES
+};
+
+constexpr size_t num_telemetry_values =
+  static_cast<size_t>(telemetry_value::NUM_TELEMETRY_VALUES);
+
+/** @brief Description of a telemetry value */
+struct telemetry_info
+{
+  /** Name, without the exporter's prefix */
+  char const* name;
+  /** One-line description */
+  char const* help;
+  /** Whether the value only increases; otherwise it is a gauge */
+  bool counter;
+  /** Whether the value is summed over ranks; otherwise the maximum
+   *  over ranks is taken */
+  bool sum;
+  /** Factor converting the stored integer to the exported unit */
+  double scale;
+};
+
+telemetry_info const& get_telemetry_info(telemetry_value value) noexcept;
+
+/** @brief Values of every telemetry slot, in the exported units */
+using telemetry_snapshot = std::array<double, num_telemetry_values>;
+
+namespace details {
+extern std::atomic<bool> telemetry_enabled;
+extern std::array<std::atomic<uint64_t>, num_telemetry_values>
+  telemetry_slots;
+inline std::atomic<uint64_t>& telemetry_slot(telemetry_value value) noexcept
+{
+  return telemetry_slots[static_cast<size_t>(value)];
+}
+} // namespace details
+
+/** @brief Whether telemetry is being read
+ *
+ *  Updates are dropped while it is not, so their cost is a relaxed
+ *  load and a branch.
+ */
+inline bool telemetry_enabled() noexcept
+{
+  return details::telemetry_enabled.load(std::memory_order_relaxed);
+}
+void set_telemetry_enabled(bool enable) noexcept;
+
+/** @brief Add to a counter of this rank */
+inline void telemetry_add(telemetry_value value, uint64_t n) noexcept
+{
+  if (telemetry_enabled()) {
+    details::telemetry_slot(value).fetch_add(n, std::memory_order_relaxed);
+  }
+}
+
+/** @brief Add a duration to a time counter of this rank
+ *  @details Times are stored in nanoseconds.
+ */
+inline void telemetry_add_seconds(telemetry_value value,
+                                  double seconds) noexcept
+{
+  if (seconds > 0.) {
+    telemetry_add(value, static_cast<uint64_t>(seconds * 1e9));
+  }
+}
+
+/** @brief Raise a high-water gauge of this rank to @c n */
+inline void telemetry_update_max(telemetry_value value, uint64_t n) noexcept
+{
+  if (telemetry_enabled()) {
+    auto& slot = details::telemetry_slot(value);
+    auto current = slot.load(std::memory_order_relaxed);
+    while (current < n &&
+           !slot.compare_exchange_weak(current, n, std::memory_order_relaxed)) {
+    }
+  }
+}
+
+/** @brief Values of this rank, in the exported units */
+telemetry_snapshot read_telemetry() noexcept;
+
+/** @brief Zero the values of this rank */
+void reset_telemetry() noexcept;
+
+/** @brief Add the lifetime of the object to a time counter, if
+ *         telemetry is being read when it is created.
+ */
+class telemetry_timer
+{
+public:
+  telemetry_timer(telemetry_value value) noexcept
+    : m_value(value), m_start(telemetry_enabled() ? get_time() : -1.)
+  {}
+  ~telemetry_timer() noexcept
+  {
+    if (m_start >= 0.) {
+      telemetry_add_seconds(m_value, get_time() - m_start);
+    }
+  }
+  telemetry_timer(const telemetry_timer&) = delete;
+  telemetry_timer& operator=(const telemetry_timer&) = delete;
+
+private:
+  telemetry_value m_value;
+  double m_start;
+};
+
+/** @brief Write values in the Prometheus text exposition format
+ *
+ *  Each value is named @c prefix followed by its own name, with
+ *  @c labels (e.g. <tt>trainer="0"</tt>) attached if not empty.
+ */
+void write_telemetry_prometheus(std::ostream& os,
+                                telemetry_snapshot const& values,
+                                std::string const& prefix,
+                                std::string const& labels);
+
+/** @brief Write values as a line of JSON
+ *
+ *  The object holds @c fields (e.g. <tt>"step":10</tt>) followed by
+ *  the values, keyed by their names.
+ */
+void write_telemetry_json(std::ostream& os,
+                          telemetry_snapshot const& values,
+                          std::string const& fields);
+
+} // namespace lbann
+#endif // LBANN_UTILS_TELEMETRY_HPP_INCLUDED
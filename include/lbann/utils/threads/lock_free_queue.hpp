@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_UTILS_THREADS_LOCK_FREE_QUEUE_HPP_INCLUDED
+#define LBANN_UTILS_THREADS_LOCK_FREE_QUEUE_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+namespace lbann {
+
+/** @class lock_free_queue
+ *  @brief A bounded FIFO queue that any number of threads can push to
+ *  and pop from without locks.
+ *
+ *  Each slot of a ring buffer carries a sequence number that tells
+ *  whether it is free for the push of a given position or holds the
+ *  value for the pop of that position. A thread claims a position
+ *  with a compare-and-swap and then owns the slot, so values are
+ *  constructed in place and nothing is allocated after construction.
+ *  (D. Vyukov's bounded MPMC queue.)
+ *
+ *  @tparam T A move-constructible type
+ */
+template <typename T>
+class lock_free_queue
+{
+public:
+  /** @brief Construct a queue
+   *  @param capacity Maximum number of values, rounded up to a power
+   *                  of two.
+   */
+  explicit lock_free_queue(size_t capacity)
+  {
+    size_t size = 2;
+    while (size < capacity) {
+      size *= 2;
+    }
+    m_mask = size - 1;
+    m_cells.reset(new cell[size]);
+    for (size_t i = 0; i < size; ++i) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~lock_free_queue()
+  {
+    while (try_pop()) {
+    }
+  }
+
+  lock_free_queue(const lock_free_queue&) = delete;
+  lock_free_queue& operator=(const lock_free_queue&) = delete;
+
+  /** @brief Add a value to the back of the queue
+   *  @return false, leaving @c value untouched, if the queue is full
+   */
+  bool try_push(T& value)
+  {
+    size_t pos = m_push_pos.load(std::memory_order_relaxed);
+    cell* c;
+    while (true) {
+      c = &m_cells[pos & m_mask];
+      const size_t seq = c->sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (m_push_pos.compare_exchange_weak(pos,
+                                             pos + 1,
+                                             std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return false;
+      }
+      else {
+        pos = m_push_pos.load(std::memory_order_relaxed);
+      }
+    }
+    new (c->storage) T(std::move(value));
+    c->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /** @brief Remove the value at the front of the queue
+   *  @return An empty optional if the queue is empty
+   */
+  std::optional<T> try_pop()
+  {
+    size_t pos = m_pop_pos.load(std::memory_order_relaxed);
+    cell* c;
+    while (true) {
+      c = &m_cells[pos & m_mask];
+      const size_t seq = c->sequence.load(std::memory_order_acquire);
+      const auto diff =
+        static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (m_pop_pos.compare_exchange_weak(pos,
+                                            pos + 1,
+                                            std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      else if (diff < 0) {
+        return std::nullopt;
+      }
+      else {
+        pos = m_pop_pos.load(std::memory_order_relaxed);
+      }
+    }
+    T* held = std::launder(reinterpret_cast<T*>(c->storage));
+    std::optional<T> value(std::move(*held));
+    held->~T();
+    c->sequence.store(pos + m_mask + 1, std::memory_order_release);
+    return value;
+  }
+
+  /** @brief Check if the queue looks empty
+   *  @details Only a hint while other threads use the queue.
+   */
+  bool empty() const
+  {
+    return (m_pop_pos.load(std::memory_order_acquire) >=
+            m_push_pos.load(std::memory_order_acquire));
+  }
+
+private:
+  struct cell
+  {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+  };
+
+  std::unique_ptr<cell[]> m_cells;
+  size_t m_mask;
+  /** @brief Next position to push, on its own cache line */
+  alignas(64) std::atomic<size_t> m_push_pos{0};
+  /** @brief Next position to pop, on its own cache line */
+  alignas(64) std::atomic<size_t> m_pop_pos{0};
+
+}; // class lock_free_queue
+
+} // namespace lbann
+#endif /* LBANN_UTILS_THREADS_LOCK_FREE_QUEUE_HPP_INCLUDED */
@@ -29,7 +29,7 @@
 #include "lbann_config.hpp"
 
 #include "lbann/utils/exception.hpp"
-#include "thread_safe_queue.hpp"
+#include "lock_free_queue.hpp"
 #include "type_erased_function.hpp"
 
 #if defined(LBANN_TOPO_AWARE)
@@ -41,13 +41,30 @@
 
 #include <sched.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace lbann {
 
+/** @class thread_pool
+ *  @brief A pool of worker threads that steal work from each other
+ *
+ *  Each worker has its own lock-free job queue. Jobs submitted by a
+ *  worker go to its own queue and jobs submitted by other threads
+ *  are spread over the queues in turn. A worker runs the jobs of its
+ *  own queue first and then steals from the other queues, so threads
+ *  only contend when they touch the same queue. Jobs that do not fit
+ *  in the queues wait in a locked overflow queue. Idle workers sleep
+ *  until a job is submitted.
+ */
 class thread_pool
 {
 public:
@@ -106,7 +123,7 @@ public:
 
     std::packaged_task<return_type()> task(std::move(func));
     auto future = task.get_future();
-    global_work_queue_.push(std::move(task));
+    push_job_(type_erased_function(std::move(task)));
     return future;
   }
 
@@ -119,7 +136,7 @@ public:
 
     std::packaged_task<return_type()> task(std::move(func));
     m_work_group.emplace_back(task.get_future());
-    global_work_queue_.push(std::move(task));
+    push_job_(type_erased_function(std::move(task)));
 
     return;
   }
@@ -151,8 +168,15 @@ public:
   int get_threads_offset() { return m_threads_offset; }
 
 private:
-  /** @brief The task executed by each thread */
-  void do_thread_work_();
+  /** @brief The task executed by each thread: run jobs until the
+   *  pool is reaped */
+  void do_thread_work_(size_type tid);
+  /** @brief Create a job queue for each worker thread */
+  void setup_queues_(size_type num_threads);
+  /** @brief Queue a job and wake a sleeping worker */
+  void push_job_(type_erased_function job);
+  /** @brief Take a job from a worker's own queue, or steal one */
+  std::optional<type_erased_function> try_pop_job_(size_type tid);
 #if defined(LBANN_TOPO_AWARE)
   void do_thread_work_pinned_thread_(int tid,
                                      hwloc_topology_t topo,
@@ -162,8 +186,24 @@ private:
   /** @brief Container holding the threads */
   thread_container_type threads_;
 
-  /** @brief The thread-safe work queue */
-  thread_safe_queue<type_erased_function> global_work_queue_;
+  /** @brief Job queue of each worker thread */
+  std::vector<std::unique_ptr<lock_free_queue<type_erased_function>>> m_queues;
+
+  /** @brief Jobs that did not fit in the worker queues */
+  std::deque<type_erased_function> m_overflow_queue;
+  std::mutex m_overflow_mutex;
+  std::atomic<size_t> m_overflow_size{0};
+
+  /** @brief Queue that the next job from outside the pool goes to */
+  std::atomic<size_t> m_next_queue{0};
+
+  /** @brief Number of jobs submitted and not yet taken */
+  std::atomic<long> m_num_pending_jobs{0};
+
+  /** @brief Sleeping workers wait for jobs on this */
+  std::mutex m_sleep_mutex;
+  std::condition_variable m_job_available;
+  std::atomic<int> m_num_sleeping{0};
 
   /** @brief RAII "deleter" for the threads */
   thread_joiner thread_joiner_;
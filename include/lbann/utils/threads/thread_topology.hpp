@@ -46,10 +46,51 @@ namespace lbann {
  */
 void hwloc_print_topo();
 
-// Used in thread_pool.cpp and thread_topology.cpp
+/** @brief Make a topology discover PCI and OS devices (GPUs, NICs)
+ *  @details Call before the topology is loaded.
+ */
+void enable_io_device_discovery(hwloc_topology_t topo);
+
+/** @brief Cores near the device that feeds this rank
+ *
+ *  The device is the one named by --io_thread_device (a PCI bus id or
+ *  an OS device name such as a NIC), or else the rank's GPU. Falls
+ *  back to all the allowed cores. The caller frees the cpuset.
+ *
+ *  Used in thread_pool.cpp and thread_topology.cpp.
+ */
 hwloc_cpuset_t get_local_cpuset_for_current_thread(hwloc_topology_t topo);
 
 #endif // LBANN_TOPO_AWARE
+
+/** @class io_local_memory_scope
+ *  @brief Place the memory the calling thread allocates near the I/O
+ *         threads while in scope.
+ *
+ *  Pages are placed on the NUMA node of the thread that first touches
+ *  them, and pinned host buffers are touched when they are allocated.
+ *  Buffers that I/O threads fill should be allocated in this scope so
+ *  that they do not end up on another socket. Does nothing without
+ *  hwloc.
+ */
+class io_local_memory_scope
+{
+public:
+  io_local_memory_scope();
+  ~io_local_memory_scope();
+  io_local_memory_scope(const io_local_memory_scope&) = delete;
+  io_local_memory_scope& operator=(const io_local_memory_scope&) = delete;
+
+private:
+#if defined(LBANN_TOPO_AWARE)
+  hwloc_topology_t m_topo = nullptr;
+  /** @brief Memory binding of the thread before the scope */
+  hwloc_cpuset_t m_saved_cpuset = nullptr;
+  hwloc_membind_policy_t m_saved_policy = HWLOC_MEMBIND_DEFAULT;
+  bool m_bound = false;
+#endif // LBANN_TOPO_AWARE
+};
+
 } // namespace lbann
 
 #endif // LBANN_UTILS_HW_TOPOLOGY_HPP_INCLUDED
@@ -26,9 +26,8 @@
 #ifndef LBANN_UTILS_THREADS_TYPE_ERASED_FUNCTION_HPP_INCLUDED
 #define LBANN_UTILS_THREADS_TYPE_ERASED_FUNCTION_HPP_INCLUDED
 
-#include <lbann/utils/memory.hpp>
-
-#include <memory>
+#include <cstddef>
+#include <new>
 #include <type_traits>
 #include <utility>
 
@@ -36,24 +35,68 @@ namespace lbann {
 
 /** @class type_erased_function
  *  @brief A move-only callable type for wrapping functions
+ *
+ *  Functions of up to @c buffer_size bytes that can be moved without
+ *  throwing, such as the @c std::packaged_task of a thread pool job,
+ *  are stored in place, so wrapping them does not allocate. Larger
+ *  functions are held on the heap.
  */
 class type_erased_function
 {
 public:
+  /** @brief Size of the in-place storage */
+  static constexpr size_t buffer_size = 48;
+
   /** @brief Erase the type of input function F */
-  template <typename FunctionT>
+  template <typename FunctionT,
+            typename = std::enable_if_t<
+              !std::is_same<std::decay_t<FunctionT>,
+                            type_erased_function>::value>>
   type_erased_function(FunctionT&& F)
-    : held_function_(make_unique<Function<FunctionT>>(std::move(F)))
-  {}
+  {
+    using function_type = std::decay_t<FunctionT>;
+    static_assert(std::is_move_constructible<function_type>::value,
+                  "Given type is not move constructible!");
+    if constexpr (stored_in_place<function_type>()) {
+      new (&buffer_) function_type(std::forward<FunctionT>(F));
+      ops_ = &in_place_ops<function_type>;
+    }
+    else {
+      *reinterpret_cast<function_type**>(&buffer_) =
+        new function_type(std::forward<FunctionT>(F));
+      ops_ = &heap_ops<function_type>;
+    }
+  }
 
   /** @brief Move constructor */
-  type_erased_function(type_erased_function&& other) = default;
+  type_erased_function(type_erased_function&& other) noexcept
+    : ops_(other.ops_)
+  {
+    if (ops_ != nullptr) {
+      ops_->move(&buffer_, &other.buffer_);
+      other.ops_ = nullptr;
+    }
+  }
 
   /** @brief Move assignment */
-  type_erased_function& operator=(type_erased_function&& other) = default;
+  type_erased_function& operator=(type_erased_function&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      ops_ = other.ops_;
+      if (ops_ != nullptr) {
+        ops_->move(&buffer_, &other.buffer_);
+        other.ops_ = nullptr;
+      }
+    }
+    return *this;
+  }
+
+  /** @brief Destructor */
+  ~type_erased_function() { reset(); }
 
   /** @brief Make the function callable */
-  void operator()() { held_function_->call_held(); }
+  void operator()() { ops_->call(&buffer_); }
 
   /** @name Deleted functions */
   ///@{
@@ -70,48 +113,74 @@ public:
   ///@}
 
 private:
-  /** @name Type erasure template types */
+  /** @name Type erasure */
   ///@{
 
-  /** @class FunctionHolder
-   *  @brief Simple function object holder
-   */
-  struct FunctionHolder
+  /** @brief Operations on the held function */
+  struct operations
   {
-    /** @brief Destructor */
-    virtual ~FunctionHolder() = default;
-
     /** @brief Call the held function */
-    virtual void call_held() = 0;
+    void (*call)(void* buffer);
+    /** @brief Move the held function to another buffer */
+    void (*move)(void* dst, void* src);
+    /** @brief Destroy the held function */
+    void (*destroy)(void* buffer);
   };
 
-  /** @class Function
-   *  @brief A wrapper for a specific type of function
-   *
-   *  @tparam FunctionT Must be MoveConstructible and Callable
-   */
   template <typename FunctionT>
-  struct Function : FunctionHolder
+  static constexpr bool stored_in_place()
   {
-    static_assert(std::is_move_constructible<FunctionT>::value,
-                  "Given type is not move constructible!");
+    return (sizeof(FunctionT) <= buffer_size &&
+            alignof(FunctionT) <= alignof(std::max_align_t) &&
+            std::is_nothrow_move_constructible<FunctionT>::value);
+  }
 
-    /** @brief Construct by moving from the input function type */
-    Function(FunctionT&& f) : F__(std::move(f)) {}
+  template <typename FunctionT>
+  static FunctionT* in_place(void* buffer)
+  {
+    return std::launder(reinterpret_cast<FunctionT*>(buffer));
+  }
 
-    /** @brief Destructor */
-    ~Function() = default;
+  template <typename FunctionT>
+  static FunctionT*& on_heap(void* buffer)
+  {
+    return *reinterpret_cast<FunctionT**>(buffer);
+  }
 
-    /** @brief Call the held function */
-    void call_held() override { F__(); }
+  template <typename FunctionT>
+  static constexpr operations in_place_ops = {
+    [](void* buffer) { (*in_place<FunctionT>(buffer))(); },
+    [](void* dst, void* src) {
+      new (dst) FunctionT(std::move(*in_place<FunctionT>(src)));
+      in_place<FunctionT>(src)->~FunctionT();
+    },
+    [](void* buffer) { in_place<FunctionT>(buffer)->~FunctionT(); }};
+
+  template <typename FunctionT>
+  static constexpr operations heap_ops = {
+    [](void* buffer) { (*on_heap<FunctionT>(buffer))(); },
+    [](void* dst, void* src) {
+      on_heap<FunctionT>(dst) = on_heap<FunctionT>(src);
+    },
+    [](void* buffer) { delete on_heap<FunctionT>(buffer); }};
 
-    /** @brief The held function */
-    FunctionT F__;
-  };
   ///@}
 
-  /** @brief A type-erased function */
-  std::unique_ptr<FunctionHolder> held_function_;
+  /** @brief Destroy the held function, if any */
+  void reset() noexcept
+  {
+    if (ops_ != nullptr) {
+      ops_->destroy(&buffer_);
+      ops_ = nullptr;
+    }
+  }
+
+  /** @brief Storage for the function or a pointer to it */
+  alignas(std::max_align_t) unsigned char buffer_[buffer_size];
+
+  /** @brief Operations for the held function type; null once moved
+   *  from */
+  operations const* ops_ = nullptr;
 }; // class type_erased_function
 
 } // namespace lbann
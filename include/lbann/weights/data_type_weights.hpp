@@ -126,6 +126,7 @@ public:
   AbsDistMatrixType& get_values() override;
   /** Get the weight matrix. */
   const AbsDistMatrixType& get_values() const override;
+  bool has_values() const noexcept override { return m_values != nullptr; }
   using weights::set_values;
   /** Set the weight matrix. */
   void set_values(const AbsDistMatrixType& values);
@@ -148,6 +149,22 @@ public:
    */
   void reconcile_values(Al::request& req) override;
 
+  /** @brief Norms of the rows of the local weight matrix.
+   *
+   *  A column vector on the device of the values, with an entry for
+   *  each local row. Entries are reduced over the row communicator,
+   *  so each is the norm of a full matrix row. The norms are only
+   *  recomputed if the values have changed since they were cached.
+   */
+  const El::AbstractMatrix<TensorDataType>& get_row_norms() const;
+  void update_row_norms(std::vector<weights*> const& group) override;
+
+  void add_to_flat_state(flat_weights_state& state) override;
+  void add_to_snapshot(weights_snapshot& snapshot) override;
+
+  void save_values(std::ostream& os) const override;
+  void load_values(std::istream& is, bool parallel) override;
+
   bool load_from_save(std::string const& ckpt_dir,
                       std::vector<std::string> const& weight_list,
                       El::FileFormat el_mode);
@@ -176,6 +193,10 @@ public:
    *  will have the name of the corresponding weights object.
    */
   void fill_onnx_node(onnx::GraphProto& graph) const override;
+  void fill_onnx_node(onnx::GraphProto& graph,
+                      int writer,
+                      std::string const& filename,
+                      std::string const& location) const override;
 #endif // LBANN_HAS_ONNX
 
 private:
@@ -189,6 +210,10 @@ private:
   void do_move_values_(data_type_weights& other);
   void do_steal_values_(weights& other) override;
 
+  /** Compute the row norms of several weights in a batch. */
+  static void
+  compute_row_norms_(std::vector<const data_type_weights*> const& group);
+
 private:
   /** Weight matrix. */
   std::unique_ptr<AbsDistMatrixType> m_values;
@@ -202,6 +227,11 @@ private:
    */
   std::unique_ptr<OptimizerType> m_optimizer;
 
+  /** See get_row_norms. Cached, hence mutable. */
+  mutable std::unique_ptr<El::AbstractMatrix<TensorDataType>> m_row_norms;
+  /** Values version of the cached row norms. Zero if none. */
+  mutable size_t m_row_norms_version = 0;
+
   friend class data_type_optimizer<TensorDataType>;
 };
 
@@ -36,6 +36,16 @@ template <typename ArchiveT>
 void data_type_weights<TensorDataType>::serialize(ArchiveT& ar)
 #if !(defined __CUDACC__)
 {
+  if constexpr (utils::IsOutputArchive<ArchiveT>) {
+    if (this->is_values_by_reference() && m_values != nullptr) {
+      std::unique_ptr<AbsDistMatrixType> empty{
+        m_values->Construct(m_values->Grid(), m_values->Root())};
+      ar(cereal::base_class<weights>(this),
+         cereal::make_nvp("m_values", empty),
+         CEREAL_NVP(m_optimizer));
+      return;
+    }
+  }
   ar(cereal::base_class<weights>(this),
      CEREAL_NVP(m_values),
      CEREAL_NVP(m_optimizer));
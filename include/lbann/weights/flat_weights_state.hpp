@@ -0,0 +1,143 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_WEIGHTS_FLAT_WEIGHTS_STATE_HPP_INCLUDED
+#define LBANN_WEIGHTS_FLAT_WEIGHTS_STATE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class lbann_comm;
+class weights;
+
+/** @brief Contiguous storage for the values and optimizer state of
+ *         weights.
+ *
+ *  The local data of the tensors of a data type and device are moved
+ *  into one flat buffer, and each tensor becomes a view of its slice.
+ *  The state can then be exchanged with one message per buffer. The
+ *  layout only depends on the weights, their order and their
+ *  optimizers, so models built alike have the same layout.
+ *
+ *  Sharded values, block-distributed tensors and tensors that are
+ *  already views are left alone. A tensor that is reallocated later,
+ *  e.g. because its optimizer is replaced, leaves its buffer, and
+ *  is_packed becomes false.
+ */
+class flat_weights_state
+{
+public:
+  /** @brief Move the tensors of some weights into flat buffers.
+   *  @details The weights must outlive this object.
+   */
+  explicit flat_weights_state(std::vector<weights*> weights);
+  ~flat_weights_state();
+  flat_weights_state(const flat_weights_state&) = delete;
+  flat_weights_state& operator=(const flat_weights_state&) = delete;
+
+  /** @brief Add a tensor to the buffer of its data type and device.
+   *  @details Called from weights::add_to_flat_state.
+   */
+  template <typename TensorDataType>
+  void add(El::AbstractDistMatrix<TensorDataType>& tensor);
+
+  /** @brief Whether every tensor is still a view of its buffer. */
+  bool is_packed();
+
+  /** @brief Hash of the data types, devices and sizes of the
+   *         tensors.
+   */
+  size_t get_layout_hash() const;
+
+  /** @brief Local size of the buffers in bytes. */
+  size_t get_local_bytes() const;
+
+  /** @brief Exchange the buffers with a process in another trainer.
+   *
+   *  The partner must have the same layout, see get_layout_hash. If
+   *  @c half_precision is set, fp32 and fp64 buffers are rounded to
+   *  fp16 for the transfer, which quarters or halves the traffic at
+   *  the cost of precision.
+   */
+  void sendrecv(lbann_comm& comm,
+                El::Int partner_rank_in_world,
+                bool half_precision = false);
+
+  /** @brief Copy the buffers of another state into this one.
+   *
+   *  @c source must have the same layout. The tensors keep their
+   *  storage, so nothing has to be set up again.
+   */
+  void copy_from(flat_weights_state const& source);
+
+  /** @brief Start exchanging buffers with a process in another
+   *         trainer without blocking.
+   *
+   *  A snapshot of the buffers of @c source is sent, so its weights
+   *  can keep changing, and the partner's buffers are received into
+   *  host staging buffers that are kept for later exchanges. This
+   *  state is left alone until finish_sendrecv. @c source and the
+   *  partner must have the same layout as this state.
+   */
+  void start_sendrecv(flat_weights_state const& source,
+                      lbann_comm& comm,
+                      El::Int partner_rank_in_world);
+
+  /** @brief Wait for the exchange started by start_sendrecv and copy
+   *         the received buffers into the tensors.
+   */
+  void finish_sendrecv();
+
+  /** @brief Whether an exchange started by start_sendrecv is not
+   *         finished.
+   */
+  bool is_sendrecv_pending() const noexcept { return m_sendrecv_pending; }
+
+  class buffer_base;
+
+private:
+  std::vector<weights*> m_weights;
+  std::vector<std::unique_ptr<buffer_base>> m_buffers;
+  /** @brief Whether add checks tensors against the buffers instead
+   *         of adding them.
+   */
+  bool m_checking = false;
+  /** @brief Whether a checked tensor is not in its buffer. */
+  bool m_check_failed = false;
+  /** @brief Whether start_sendrecv was called without
+   *         finish_sendrecv.
+   */
+  bool m_sendrecv_pending = false;
+};
+
+} // namespace lbann
+
+#endif // LBANN_WEIGHTS_FLAT_WEIGHTS_STATE_HPP_INCLUDED
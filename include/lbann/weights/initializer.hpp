@@ -182,7 +182,12 @@ private:
   std::string m_file;
 };
 
-/** @brief Draw weights values from a uniform random distribution. */
+/** @brief Draw weights values from a uniform random distribution.
+ *
+ *  Each process draws its local entries in place, on the matrix's
+ *  device, from a counter-based stream (see philox_uniform_fill),
+ *  so the values do not depend on the matrix distribution.
+ */
 template <typename TensorDataType>
 class uniform_initializer
   : public Cloneable<uniform_initializer<TensorDataType>,
@@ -216,7 +221,12 @@ private:
   TensorDataType m_max;
 };
 
-/** @brief Draw weights values from a normal random distribution. */
+/** @brief Draw weights values from a normal random distribution.
+ *
+ *  Each process draws its local entries in place, on the matrix's
+ *  device, from a counter-based stream (see philox_gaussian_fill),
+ *  so the values do not depend on the matrix distribution.
+ */
 template <typename TensorDataType>
 class normal_initializer
   : public Cloneable<normal_initializer<TensorDataType>,
@@ -37,7 +37,8 @@ namespace lbann {
  *
  *  Weights values are randomly sampled from a probability
  *  distribution with a variance determined by a "fan-in" and a
- *  "fan-out" parameter.
+ *  "fan-out" parameter. As with uniform_initializer, each process
+ *  draws its local entries in place on the matrix's device.
  *
  *  Weights with variance scaling initialization are only compatible
  *  with layers that set fan-in and fan-out parameters, e.g. the
@@ -31,6 +31,7 @@
 #include "lbann/utils/cloneable.hpp"
 #include "lbann/utils/description.hpp"
 
+#include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,6 +51,8 @@ struct request;
 } // namespace Al
 
 // Forward declaration
+class flat_weights_state;
+class weights_snapshot;
 class lbann_comm;
 class weights;
 class weights_initializer;
@@ -176,6 +179,11 @@ public:
   // -----------------------------------------------
   El::DistData get_matrix_distribution() const;
   void set_matrix_distribution(El::DistData dist);
+  /** Whether the values are stored in shards across the processes
+   *  of the grid rather than with the matrix distribution. Layers
+   *  then see a gathered copy with the matrix distribution.
+   */
+  bool is_sharded() const noexcept { return m_sharded; }
 
   /** @name Matrix accessors */
   ///@{
@@ -197,6 +205,38 @@ public:
   /** @brief Access the matrix of weights values. */
   virtual El::BaseDistMatrix& get_values() = 0;
   virtual El::BaseDistMatrix const& get_values() const = 0;
+  /** @brief Whether the values matrix exists, i.e. the weights are
+   *  set up or were restored from a checkpoint. */
+  virtual bool has_values() const noexcept = 0;
+
+  /** @brief Identifier for the current contents of the values matrix.
+   *
+   *  Changes whenever the values may have been modified, e.g. on
+   *  non-const access to the values matrix, and is never reused by
+   *  another weights object. Layers use it to tell whether data
+   *  derived from the values, like a packed copy, is stale.
+   */
+  size_t get_values_version() const noexcept { return m_values_version; }
+  ///@}
+
+  /** @name Row norms */
+  ///@{
+  /** @brief Keep the norms of the weight matrix rows.
+   *
+   *  Used for weight normalization. The norms are cached for each
+   *  version of the values (see get_values_version), and the model
+   *  computes the stale norms of all such weights together before
+   *  forward propagation.
+   */
+  void enable_row_norms() noexcept { m_row_norms_enabled = true; }
+  /** @brief Whether the norms of the weight matrix rows are kept. */
+  bool has_row_norms() const noexcept { return m_row_norms_enabled; }
+  /** @brief Compute the stale row norms of several weights.
+   *
+   *  Called on a member of @c group. The norms of weights with the
+   *  same data type are computed in a batch.
+   */
+  virtual void update_row_norms(std::vector<weights*> const& group) = 0;
   ///@}
 
   // -----------------------------------------------
@@ -242,6 +282,19 @@ public:
   /** Whether weight optimization is enabled. */
   bool is_frozen() const { return m_frozen; }
 
+  // -----------------------------------------------
+  // Optimizer offload
+  // -----------------------------------------------
+  /** Whether the optimizer state is kept in host memory and the
+   *  optimization step runs on the CPU, for weights on GPU. Must be
+   *  set before setup.
+   */
+  void set_offload_optimizer(bool offload) noexcept
+  {
+    m_offload_optimizer = offload;
+  }
+  bool get_offload_optimizer() const noexcept { return m_offload_optimizer; }
+
   // -----------------------------------------------
   // Weight matrix accessors
   // -----------------------------------------------
@@ -274,9 +327,46 @@ public:
   template <typename ArchiveT>
   void serialize(ArchiveT& ar);
 
+  /** @brief Leave the values out of archives, e.g. because a
+   *         checkpoint stores them by reference to an earlier one.
+   *  @details An empty matrix with the distribution of the values is
+   *  archived instead. Not serialized.
+   */
+  void set_values_by_reference(bool by_reference) noexcept
+  {
+    m_values_by_reference = by_reference;
+  }
+  bool is_values_by_reference() const noexcept
+  {
+    return m_values_by_reference;
+  }
+
+  /** @brief Write the values to a rooted binary archive on the
+   *         trainer grid.
+   */
+  virtual void save_values(std::ostream& os) const = 0;
+  /** @brief Read values written by save_values.
+   *  @param is Stream of the file, which only has to be open on the
+   *            trainer master unless @c parallel is set
+   *  @param parallel Whether every rank reads the entries it owns
+   */
+  virtual void load_values(std::istream& is, bool parallel) = 0;
+
 #ifdef LBANN_HAS_ONNX
   /** @brief Add serialized weights initializers to onnx graph */
   virtual void fill_onnx_node(onnx::GraphProto& graph) const = 0;
+  /** @brief Add a weights initializer whose values are in an ONNX
+   *         external data file.
+   *
+   *  The values are gathered on one rank of the weights' grid, @c
+   *  writer modulo its size, which writes them to @c filename. The
+   *  initializer refers to the file by @c location, its path
+   *  relative to the ONNX model file.
+   */
+  virtual void fill_onnx_node(onnx::GraphProto& graph,
+                              int writer,
+                              std::string const& filename,
+                              std::string const& location) const = 0;
 #endif // LBANN_HAS_ONNX
 
   ///@}
@@ -300,11 +390,30 @@ public:
    */
   void steal_values(weights& other);
 
+  /** @brief Add the values and optimizer state tensors to flat
+   *         buffers.
+   *
+   *  See flat_weights_state.
+   */
+  virtual void add_to_flat_state(flat_weights_state& state) = 0;
+
+  /** @brief Copy the values, and the optimizer state if the snapshot
+   *         includes it, into or out of a snapshot.
+   *
+   *  See weights_snapshot.
+   */
+  virtual void add_to_snapshot(weights_snapshot& snapshot) = 0;
+
   ///@}
 protected:
   weights(const weights& other) = default;
   weights& operator=(const weights& other) = default;
 
+  /** @brief Record that the values matrix may have been modified. */
+  void mark_values_modified();
+
+  void set_sharded(bool sharded) noexcept { m_sharded = sharded; }
+
 private:
   virtual void do_augment_description_(description&) const = 0;
   virtual void do_setup_() = 0;
@@ -336,6 +445,21 @@ private:
 
   /** Whether weight optimization is disabled. */
   bool m_frozen;
+
+  /** See is_sharded. */
+  bool m_sharded = false;
+
+  /** See set_offload_optimizer. */
+  bool m_offload_optimizer = false;
+
+  /** See get_values_version. */
+  size_t m_values_version;
+
+  /** See set_values_by_reference. */
+  bool m_values_by_reference = false;
+
+  /** See enable_row_norms. */
+  bool m_row_norms_enabled = false;
 };
 
 } // namespace lbann
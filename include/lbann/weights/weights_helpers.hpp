@@ -31,6 +31,10 @@
 #include "lbann/weights/data_type_weights.hpp"
 #include "lbann/weights/weights.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 /** @file
  *
  *  A hacky utility for dealing with layers that require access to
@@ -67,6 +71,126 @@ struct SafeWeightsAccessor
   }
 }; // class SafeWeightsAccessor
 
+/** @brief Copy the values of weights to a local matrix on every
+ *         process.
+ */
+template <typename TensorDataType>
+El::Matrix<TensorDataType, El::Device::CPU> replicated_values(weights const& w)
+{
+  auto const* dtw = dynamic_cast<data_type_weights<TensorDataType> const*>(&w);
+  if (!dtw)
+    LBANN_ERROR("Weights object named \"",
+                w.get_name(),
+                "\" does not have weights of dynamic type \"",
+                TypeName<TensorDataType>(),
+                "\".");
+  auto const& values = dtw->get_values();
+  El::DistMatrix<TensorDataType,
+                 El::STAR,
+                 El::STAR,
+                 El::ELEMENT,
+                 El::Device::CPU>
+    local(values.Grid(), values.Root());
+  El::Copy(values, local);
+  return local.Matrix();
+}
+
+/** @brief Apply a per-channel affine map to the values of weights.
+ *
+ *  Each value x becomes scale[c]*x + shift[c], where the channel c of
+ *  row (or column, if @c by_column) i is i / (n / scale.size()) for a
+ *  matrix with n rows (or columns). The shift is optional.
+ */
+template <typename TensorDataType>
+void apply_channelwise_affine(weights& w,
+                              std::vector<double> const& scale,
+                              std::vector<double> const& shift,
+                              bool by_column)
+{
+  auto& values = SafeWeightsAccessor<TensorDataType>::mutable_values(w);
+  El::DistMatrix<TensorDataType,
+                 El::STAR,
+                 El::STAR,
+                 El::ELEMENT,
+                 El::Device::CPU>
+    local(values.Grid(), values.Root());
+  El::Copy(values, local);
+  auto& m = local.Matrix();
+  const El::Int n = (by_column ? m.Width() : m.Height());
+  const El::Int per_channel = n / static_cast<El::Int>(scale.size());
+  if (per_channel == 0 || per_channel * El::Int(scale.size()) != n)
+    LBANN_ERROR("Weights object named \"",
+                w.get_name(),
+                "\" cannot be split into ",
+                scale.size(),
+                " channels");
+  for (El::Int j = 0; j < m.Width(); ++j) {
+    for (El::Int i = 0; i < m.Height(); ++i) {
+      const size_t c = (by_column ? j : i) / per_channel;
+      const double x = static_cast<double>(m(i, j)) * scale[c] +
+                       (shift.empty() ? 0. : shift[c]);
+      m(i, j) = static_cast<TensorDataType>(x);
+    }
+  }
+  El::Copy(local, values);
+}
+
+/** @brief Round the values of weights to a symmetric int8 grid per
+ *         channel.
+ *
+ *  Channels are split as in apply_channelwise_affine. The values of
+ *  channel c become q*scale[c], with q an integer in [-127, 127] and
+ *  scale[c] the largest magnitude in the channel divided by 127. The
+ *  scales are returned. Rounding weights that are already on the grid
+ *  does not change them.
+ */
+template <typename TensorDataType>
+std::vector<double>
+quantize_channelwise_int8(weights& w, size_t num_channels, bool by_column)
+{
+  auto& values = SafeWeightsAccessor<TensorDataType>::mutable_values(w);
+  El::DistMatrix<TensorDataType,
+                 El::STAR,
+                 El::STAR,
+                 El::ELEMENT,
+                 El::Device::CPU>
+    local(values.Grid(), values.Root());
+  El::Copy(values, local);
+  auto& m = local.Matrix();
+  const El::Int n = (by_column ? m.Width() : m.Height());
+  const El::Int per_channel = n / static_cast<El::Int>(num_channels);
+  if (per_channel == 0 || per_channel * El::Int(num_channels) != n)
+    LBANN_ERROR("Weights object named \"",
+                w.get_name(),
+                "\" cannot be split into ",
+                num_channels,
+                " channels");
+  std::vector<double> scale(num_channels, 0.);
+  for (El::Int j = 0; j < m.Width(); ++j) {
+    for (El::Int i = 0; i < m.Height(); ++i) {
+      const size_t c = (by_column ? j : i) / per_channel;
+      scale[c] = std::max(scale[c], std::abs(static_cast<double>(m(i, j))));
+    }
+  }
+  for (auto& s : scale) {
+    s /= 127.;
+  }
+  for (El::Int j = 0; j < m.Width(); ++j) {
+    for (El::Int i = 0; i < m.Height(); ++i) {
+      const double s = scale[(by_column ? j : i) / per_channel];
+      if (s > 0.) {
+        const double q =
+          std::min(std::max(std::round(static_cast<double>(m(i, j)) / s),
+                            -127.),
+                   127.);
+        m(i, j) = static_cast<TensorDataType>(q * s);
+      }
+    }
+  }
+  El::Copy(local, values);
+  return scale;
+}
+
 } // namespace weights_details
 } // namespace lbann
 #endif // LBANN_WEIGHTS_WEIGHTS_HELPERS_HPP_INCLUDED
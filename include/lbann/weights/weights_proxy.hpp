@@ -32,6 +32,8 @@
 #include "lbann/weights/data_type_weights.hpp"
 #include "lbann/weights/weights.hpp"
 
+#include <utility>
+
 #if defined LBANN_DEBUG
 #define LBANN_DEBUG_ASSERT_POINTER(ptr)                                        \
   do {                                                                         \
@@ -216,7 +218,9 @@ public:
   void synchronize_with_master()
   {
     if (!empty()) {
-      const auto& master_values = master_weights_.lock()->get_values();
+      // Const access, so that the values version is not changed
+      const auto& master_values =
+        std::as_const(*master_weights_.lock()).get_values();
       if (values_->Viewing()) {
         El::LockedView(*values_,
                        dynamic_cast<const ValuesType&>(master_values));
@@ -227,6 +231,25 @@ public:
     }
   }
 
+#ifdef LBANN_HAS_GPU
+  /** @brief Use the values on a given stream.
+   *
+   *  Views are reset by synchronize_with_master, so this must be
+   *  called after it.
+   */
+  void set_sync_info(El::SyncInfo<El::Device::GPU> const& sync_info)
+  {
+    if constexpr (El::IsStorageType<TensorDataType, El::Device::GPU>::value) {
+      if (!empty() && values_->GetLocalDevice() == El::Device::GPU) {
+        El::SetSyncInfo(
+          static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+            values_->Matrix()),
+          sync_info);
+      }
+    }
+  }
+#endif // LBANN_HAS_GPU
+
   ///@}
   /** @name Queries and accessors */
   ///@{
@@ -286,6 +309,10 @@ private:
   ValuesPtrType
   setup_values_(data_type_weights<TensorDataType> const& dtw) const
   {
+    // Sharded values are gathered into a copy
+    if (dtw.is_sharded()) {
+      return setup_values_as_copy_(dtw);
+    }
     auto const& vals = dtw.get_values();
     ValuesPtrType ret(vals.Construct(vals.Grid(), vals.Root()));
     El::LockedView(*ret, vals);
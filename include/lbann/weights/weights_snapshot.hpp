@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_WEIGHTS_WEIGHTS_SNAPSHOT_HPP_INCLUDED
+#define LBANN_WEIGHTS_WEIGHTS_SNAPSHOT_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace lbann {
+
+// Forward declarations
+class weights;
+
+/** @brief In-memory copy of the values, and optionally the optimizer
+ *         state, of weights.
+ *
+ *  The local data of each tensor is copied into a buffer owned by the
+ *  snapshot, with no serialization. Buffers are kept between
+ *  snapshots, so taking another snapshot of weights with the same
+ *  layout does not allocate. A snapshot can be restored into any
+ *  weights with the layout it was taken from, e.g. those of a copy of
+ *  the model.
+ */
+class weights_snapshot
+{
+public:
+  /** @param host Keep the buffers in host memory instead of on the
+   *              devices of the tensors, which saves device memory at
+   *              the cost of slower copies.
+   */
+  explicit weights_snapshot(bool host = false);
+  ~weights_snapshot();
+  weights_snapshot(const weights_snapshot&) = delete;
+  weights_snapshot& operator=(const weights_snapshot&) = delete;
+
+  /** @brief Copy the tensors of some weights into the snapshot. */
+  void take(std::vector<weights*> const& weights,
+            bool optimizer_state = false);
+
+  /** @brief Copy the snapshot into the tensors of some weights.
+   *
+   *  The weights must have the layout of those the snapshot was
+   *  taken from.
+   */
+  void restore(std::vector<weights*> const& weights);
+
+  /** @brief Whether a snapshot has been taken. */
+  bool empty() const noexcept { return !m_taken; }
+
+  /** @brief Whether the optimizer state is included. */
+  bool has_optimizer_state() const noexcept { return m_optimizer_state; }
+
+  /** @brief Local size of the buffers in bytes. */
+  size_t get_local_bytes() const;
+
+  /** @brief Copy a tensor into, or out of, the snapshot.
+   *  @details Called from weights::add_to_snapshot.
+   */
+  template <typename TensorDataType>
+  void add(El::AbstractDistMatrix<TensorDataType>& tensor);
+
+  /** @brief Whether add copies out of the snapshot. */
+  bool is_restoring() const noexcept { return m_restoring; }
+
+  class buffer_base;
+
+private:
+  /** @brief Wait for copies to and from device tensors. */
+  void synchronize() const;
+
+  std::vector<std::unique_ptr<buffer_base>> m_buffers;
+  /** @brief Position of the next tensor to add. */
+  size_t m_next = 0;
+  bool m_host;
+  bool m_taken = false;
+  bool m_optimizer_state = false;
+  bool m_restoring = false;
+};
+
+} // namespace lbann
+
+#endif // LBANN_WEIGHTS_WEIGHTS_SNAPSHOT_HPP_INCLUDED
@@ -168,12 +168,11 @@ int main(int argc, char* argv[])
     // Split MPI into trainers
     allocate_trainer_resources(comm.get());
 
-    int trainer_rank = 0;
-    if (arg_parser.get<bool>(LBANN_OPTION_GENERATE_MULTI_PROTO)) {
-      trainer_rank = comm->get_trainer_rank();
-    }
-    // Load the prototexts specificed on the command line
-    auto pbs = protobuf_utils::load_prototext(master, trainer_rank);
+    // Load the prototexts specificed on the command line. Only one
+    // rank (per trainer, with per-trainer prototexts) reads them.
+    auto pbs = protobuf_utils::load_prototext(
+      *comm,
+      arg_parser.get<bool>(LBANN_OPTION_GENERATE_MULTI_PROTO));
     // Optionally over-ride some values in the prototext for each model
     for (size_t i = 0; i < pbs.size(); i++) {
       get_cmdline_overrides(*comm, *(pbs[i]));
@@ -209,6 +208,9 @@ int main(int argc, char* argv[])
 
       // Train model
       trainer.train(model.get(), pb_model->num_epochs());
+      if (finish_resize_request(*comm, trainer)) {
+        return lbann_resize_exit_status;
+      }
 
       // Evaluate model on test set
       trainer.evaluate(model.get(), execution_mode::testing);
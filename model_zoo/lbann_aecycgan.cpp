@@ -94,7 +94,7 @@ int main(int argc, char* argv[])
 
     std::ostringstream err;
 
-    auto pbs = protobuf_utils::load_prototext(master);
+    auto pbs = protobuf_utils::load_prototext(*comm);
     // Optionally over-ride some values in the prototext for each model
     for (size_t i = 0; i < pbs.size(); i++) {
       get_cmdline_overrides(*comm, *(pbs[i]));
@@ -0,0 +1,345 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// lbann_bench.cpp - input pipeline and model throughput benchmarks
+////////////////////////////////////////////////////////////////////////////////
+//
+// Times one part of a prototext experiment in isolation and writes one
+// JSON object per measurement, so results can be compared between
+// releases:
+//
+//   --bench_mode=data     Fetch training mini-batches through the data
+//                         coordinator, with the prototext's data reader
+//                         and transforms, without a model.
+//   --bench_mode=compute  Run training steps (forward prop, back prop
+//                         and the weight update) on a single fetched
+//                         mini-batch. Use a "synthetic" data reader in
+//                         the prototext to avoid reading a data set.
+//   --bench_mode=layers   Time the forward and back prop of each layer
+//                         on its own.
+//
+// Times are measured on the world master after synchronizing with the
+// GPU, over --bench_steps iterations that follow --bench_warmup
+// untimed ones.
+
+#include "lbann/lbann.hpp"
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/execution_algorithms/sgd_training_algorithm.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/protobuf_utils.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/lbann.pb.h"
+#include "lbann/proto/model.pb.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+
+using namespace lbann;
+
+namespace {
+
+/** Wait for all queued GPU work, so it is included in a time. */
+void synchronize()
+{
+#ifdef LBANN_HAS_GPU
+  hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+}
+
+/** Times of the timed iterations of a benchmark. */
+struct bench_result
+{
+  std::string benchmark;
+  std::string name;
+  std::vector<double> times;
+  /** Samples processed per iteration. */
+  double samples = 0.;
+};
+
+/** Run warmup untimed iterations of step, then steps timed ones. */
+bench_result time_steps(std::string benchmark,
+                        std::string name,
+                        int warmup,
+                        int steps,
+                        std::function<void()> const& step)
+{
+  bench_result result{std::move(benchmark), std::move(name)};
+  for (int i = 0; i < warmup; ++i) {
+    step();
+  }
+  synchronize();
+  result.times.reserve(steps);
+  for (int i = 0; i < steps; ++i) {
+    const double start = get_time();
+    step();
+    synchronize();
+    result.times.push_back(get_time() - start);
+  }
+  return result;
+}
+
+void write_result(std::ostream& os, bench_result const& result)
+{
+  const auto& times = result.times;
+  const double mean =
+    (times.empty() ? 0.
+                   : std::accumulate(times.begin(), times.end(), 0.) /
+                       times.size());
+  os << "{\"benchmark\": \"" << result.benchmark << "\", "
+     << "\"name\": \"" << result.name << "\", "
+     << "\"steps\": " << times.size() << ", "
+     << "\"mean_s\": " << mean << ", "
+     << "\"min_s\": "
+     << (times.empty() ? 0. : *std::min_element(times.begin(), times.end()))
+     << ", "
+     << "\"max_s\": "
+     << (times.empty() ? 0. : *std::max_element(times.begin(), times.end()));
+  if (result.samples > 0. && mean > 0.) {
+    os << ", \"samples_per_s\": " << result.samples / mean;
+  }
+  os << "}\n";
+}
+
+/** Fetch mini-batches without a model. */
+std::vector<bench_result> bench_data(trainer& trainer, int warmup, int steps)
+{
+  const auto mode = execution_mode::training;
+  auto& dc = trainer.get_data_coordinator();
+  auto* dr = dc.get_data_reader(mode);
+  if (dr == nullptr) {
+    LBANN_ERROR("data benchmark requires a training data reader");
+  }
+  for (auto const& field : {INPUT_DATA_TYPE_SAMPLES,
+                            INPUT_DATA_TYPE_LABELS,
+                            INPUT_DATA_TYPE_RESPONSES}) {
+    if (dr->has_data_field(field)) {
+      dc.register_active_data_field(field);
+    }
+  }
+
+  SGDExecutionContext c(mode, trainer.get_max_mini_batch_size());
+  dc.reset_mode(c);
+  double samples = 0.;
+  auto result = time_steps("data", "training", warmup, steps, [&]() {
+    dc.fetch_data(mode);
+    samples += dc.get_current_mini_batch_size(mode);
+    dc.epoch_complete(mode);
+  });
+  result.samples = samples / (warmup + steps);
+  return {std::move(result)};
+}
+
+/** Time training steps, or the layers of a training step, on one
+ *  mini-batch. */
+std::vector<bench_result>
+bench_model(trainer& trainer, model& m, bool layers, int warmup, int steps)
+{
+  const auto mode = execution_mode::training;
+  auto& dc = trainer.get_data_coordinator();
+  SGDTrainingAlgorithm alg("bench",
+                           std::make_unique<BatchTerminationCriteria>(steps),
+                           /*suppress_timer=*/true);
+  auto dr_metadata = dc.get_dr_metadata();
+  alg.setup_models({&m},
+                   trainer.get_max_mini_batch_size(),
+                   dr_metadata,
+                   trainer.get_grids());
+
+  SGDExecutionContext c(mode, trainer.get_max_mini_batch_size());
+  m.reset_mode(c, mode);
+  dc.reset_mode(c);
+  dc.fetch_data(mode);
+  const int samples = dc.get_current_mini_batch_size(mode);
+  auto& obj = *m.get_objective_function();
+  auto step = [&]() {
+    m.clear_gradients();
+    m.forward_prop(mode);
+    obj.start_evaluation(mode, samples);
+    obj.differentiate();
+    m.backward_prop();
+    obj.compute_weight_regularization();
+    obj.finish_evaluation(mode, samples);
+    m.update_weights();
+  };
+
+  std::vector<bench_result> results;
+  if (!layers) {
+    results.push_back(time_steps("compute", m.get_name(), warmup, steps, step));
+    results.back().samples = samples;
+    return results;
+  }
+
+  // One step allocates the activations and error signals
+  step();
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    auto& l = m.get_layer(i);
+    results.push_back(
+      time_steps("layer_fp", l.get_name(), warmup, steps, [&]() {
+        l.forward_prop();
+      }));
+    results.back().samples = samples;
+    results.push_back(
+      time_steps("layer_bp", l.get_name(), warmup, steps, [&]() {
+        l.back_prop();
+      }));
+    results.back().samples = samples;
+  }
+  m.clear_gradients();
+  return results;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_option("bench mode",
+                        {"--bench_mode"},
+                        "[STD] Benchmark to run: data, compute or layers",
+                        "compute");
+  arg_parser.add_option("bench steps",
+                        {"--bench_steps"},
+                        "[STD] Timed iterations of each benchmark",
+                        100);
+  arg_parser.add_option("bench warmup",
+                        {"--bench_warmup"},
+                        "[STD] Untimed iterations before each benchmark",
+                        10);
+  arg_parser.add_option("bench output",
+                        {"--bench_output"},
+                        "[STD] File for the results (default: stdout)",
+                        "");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+  auto comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    if (arg_parser.help_requested() or argc == 1) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    const auto bench_mode = arg_parser.get<std::string>("bench mode");
+    const int steps = arg_parser.get<int>("bench steps");
+    const int warmup = arg_parser.get<int>("bench warmup");
+    if (bench_mode != "data" && bench_mode != "compute" &&
+        bench_mode != "layers") {
+      LBANN_ERROR("unknown benchmark mode \"",
+                  bench_mode,
+                  "\" (expected data, compute or layers)");
+    }
+    if (steps <= 0 || warmup < 0) {
+      LBANN_ERROR("invalid benchmark iterations (steps=",
+                  steps,
+                  ", warmup=",
+                  warmup,
+                  ")");
+    }
+
+    // Split MPI into trainers
+    allocate_trainer_resources(comm.get());
+
+    auto pbs = protobuf_utils::load_prototext(*comm);
+    // Optionally over-ride some values in the prototext for each model
+    for (size_t i = 0; i < pbs.size(); i++) {
+      get_cmdline_overrides(*comm, *(pbs[i]));
+    }
+    lbann_data::LbannPB& pb = *(pbs[0]);
+    lbann_data::Trainer* pb_trainer = pb.mutable_trainer();
+
+    // Construct the trainer
+    auto& trainer = construct_trainer(comm.get(), pb_trainer, pb);
+
+    std::vector<bench_result> results;
+    if (bench_mode == "data") {
+      results = bench_data(trainer, warmup, steps);
+    }
+    else {
+      int training_dr_linearized_data_size = -1;
+      auto* dr = trainer.get_data_coordinator().get_data_reader(
+        execution_mode::training);
+      if (dr != nullptr) {
+        training_dr_linearized_data_size = dr->get_linearized_data_size();
+      }
+      auto model =
+        build_model_from_prototext(argc,
+                                   argv,
+                                   pb_trainer,
+                                   pb,
+                                   comm.get(),
+                                   trainer.get_io_thread_pool(),
+                                   trainer.get_callbacks_with_ownership(),
+                                   training_dr_linearized_data_size);
+      results = bench_model(trainer,
+                            *model,
+                            bench_mode == "layers",
+                            warmup,
+                            steps);
+    }
+
+    if (master) {
+      const auto output = arg_parser.get<std::string>("bench output");
+      if (output.empty()) {
+        for (auto const& result : results) {
+          write_result(std::cout, result);
+        }
+      }
+      else {
+        std::ofstream ofs(output);
+        if (!ofs) {
+          LBANN_ERROR("could not open benchmark output file ", output);
+        }
+        for (auto const& result : results) {
+          write_result(ofs, result);
+        }
+      }
+    }
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    // It's possible that a proper subset of ranks throw some
+    // exception. But we want to tear down the whole world.
+    El::mpi::Abort(El::mpi::COMM_WORLD, EXIT_FAILURE);
+  }
+
+  return EXIT_SUCCESS;
+}
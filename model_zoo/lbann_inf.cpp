@@ -68,7 +68,7 @@ int main(int argc, char* argv[])
 
     std::ostringstream err;
 
-    auto pbs = protobuf_utils::load_prototext(master);
+    auto pbs = protobuf_utils::load_prototext(*comm);
     // Optionally over-ride some values in the prototext for each model
     for (size_t i = 0; i < pbs.size(); i++) {
       get_cmdline_overrides(*comm, *(pbs[i]));
@@ -104,18 +104,17 @@ int main(int argc, char* argv[])
                                    training_dr_linearized_data_size));
     }
 
-    /// Interleave the inference between the models so that they can use a
-    /// shared data reader Enable shared testing data readers on the command
-    /// line via --share_testing_data_readers=1
+    /// Evaluate the models together, so that each mini-batch is read
+    /// once and fed to all of them
     El::Int num_samples = dr->get_num_iterations_per_epoch();
     if (num_samples == 0) {
       LBANN_ERROR("The testing data reader does not have any samples");
     }
-    for (El::Int s = 0; s < num_samples; s++) {
-      for (auto&& m : models) {
-        trainer.evaluate(m.get(), execution_mode::testing, 1);
-      }
+    std::vector<observer_ptr<model>> model_ptrs;
+    for (auto&& m : models) {
+      model_ptrs.push_back(m.get());
     }
+    trainer.evaluate_ensemble(model_ptrs, execution_mode::testing);
   }
   catch (std::exception& e) {
     El::ReportException(e);
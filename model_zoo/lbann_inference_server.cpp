@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// lbann_inference_server.cpp - serves a trained model over TCP
+////////////////////////////////////////////////////////////////////////////////
+//
+// Serves inference requests over TCP with a model loaded from a
+// checkpoint, see lbann::inference_server for the protocol:
+//
+//   lbann-inference-server --inference_model=<checkpoint dir>
+//     --inference_input_dims="1 28 28" --inference_output_dims=10
+//     [--inference_port=8245] [--inference_max_batch=32]
+//     [--inference_max_latency_ms=5] [--inference_output_layer=name]
+//
+// The model stays resident until a client sends a request with no
+// samples.
+
+#include "lbann/lbann.hpp"
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+
+#include "lbann/proto/lbann.pb.h"
+
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+
+using namespace lbann;
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_option("inference model",
+                        {"--inference_model"},
+                        "[STD] Directory of the model checkpoint to serve",
+                        "");
+  arg_parser.add_option("inference input dims",
+                        {"--inference_input_dims"},
+                        "[STD] Dimensions of an input sample, e.g. \"1 28 28\"",
+                        "");
+  arg_parser.add_option("inference output dims",
+                        {"--inference_output_dims"},
+                        "[STD] Dimensions of the model output",
+                        "");
+  arg_parser.add_option("inference port",
+                        {"--inference_port"},
+                        "[STD] TCP port to listen on",
+                        8245);
+  arg_parser.add_option("inference max batch",
+                        {"--inference_max_batch"},
+                        "[STD] Most samples run in one forward pass",
+                        32);
+  arg_parser.add_option("inference max latency ms",
+                        {"--inference_max_latency_ms"},
+                        "[STD] Longest time a request waits to be batched",
+                        (float)5);
+  arg_parser.add_option("inference output layer",
+                        {"--inference_output_layer"},
+                        "[STD] Layer whose activations are returned "
+                        "(default: the softmax layer)",
+                        "");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+  auto comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    if (arg_parser.help_requested() or argc == 1) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    const auto model_dir = arg_parser.get<std::string>("inference model");
+    const auto input_dims =
+      parse_list<int>(arg_parser.get<std::string>("inference input dims"));
+    const auto output_dims =
+      parse_list<int>(arg_parser.get<std::string>("inference output dims"));
+    if (model_dir.empty() || input_dims.empty() || output_dims.empty()) {
+      LBANN_ERROR("--inference_model, --inference_input_dims and "
+                  "--inference_output_dims are required");
+    }
+    inference_server_config config;
+    config.port = arg_parser.get<int>("inference port");
+    config.max_batch = arg_parser.get<int>("inference max batch");
+    config.max_latency =
+      arg_parser.get<float>("inference max latency ms") / 1.e3;
+    config.output_layer =
+      arg_parser.get<std::string>("inference output layer");
+
+    // Split MPI into trainers
+    allocate_trainer_resources(comm.get());
+
+    // The model is set up on the grids of a default trainer
+    lbann_data::LbannPB pb;
+    construct_trainer(comm.get(), pb.mutable_trainer(), pb);
+    auto model = load_inference_model(comm.get(),
+                                      model_dir,
+                                      config.max_batch,
+                                      input_dims,
+                                      output_dims);
+
+    const size_t sample_size = std::accumulate(input_dims.begin(),
+                                               input_dims.end(),
+                                               size_t{1},
+                                               std::multiplies<size_t>());
+    inference_server server(comm.get(), model.get(), sample_size, config);
+    if (master) {
+      std::cout << "Serving " << model_dir << " on port " << config.port
+                << std::endl;
+    }
+    server.run();
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    // It's possible that a proper subset of ranks throw some
+    // exception. But we want to tear down the whole world.
+    El::mpi::Abort(El::mpi::COMM_WORLD, EXIT_FAILURE);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,394 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// lbann_stats.cpp - single pass data set statistics
+////////////////////////////////////////////////////////////////////////////////
+//
+// Reads one epoch of a prototext experiment's data set through the data
+// coordinator, with the prototext's data reader and transforms and
+// without a model, and computes the per-channel count, mean, standard
+// deviation, minimum and maximum of the samples and responses.
+//
+// Each rank folds every sample it is given into running statistics
+// with Chan et al.'s pairwise (Welford) update, and the per-rank
+// results are merged the same way across the trainer, or across all
+// trainers when the data set is sharded between them. The statistics
+// are thus computed in one streaming pass over the data.
+//
+// One JSON object is written per data field. Besides the statistics it
+// holds the parameters that normalize the field to zero mean and unit
+// standard deviation:
+//
+//   "mean", "std"      The means and stddevs of a normalize transform.
+//   "scale", "bias"    The scale and bias metadata of an HDF5 schema
+//                      (see hdf5_data_reader::normalize()), i.e.
+//                      1/std and -mean/std.
+//
+// Fields with several dimensions have one channel per entry of the
+// first dimension; each entry of a one dimensional field (e.g. a
+// vector of responses) is its own channel. Any normalization already
+// in the prototext or schema is applied before the statistics are
+// taken, so remove it when computing new parameters.
+
+#include "lbann/lbann.hpp"
+#include "lbann/data_coordinator/buffered_data_coordinator.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+#include "lbann/utils/protobuf_utils.hpp"
+
+#include "lbann/proto/lbann.pb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+using namespace lbann;
+
+namespace {
+
+/** Streaming statistics of one channel. */
+struct channel_stats
+{
+  double count = 0.;
+  double mean = 0.;
+  /** Sum of squared differences from the mean. */
+  double m2 = 0.;
+  double min = std::numeric_limits<double>::infinity();
+  double max = -std::numeric_limits<double>::infinity();
+
+  /** Number of doubles in the packed representation. */
+  static constexpr int packed_size = 5;
+
+  /** Combine with the statistics of a disjoint set of values. */
+  void merge(channel_stats const& other)
+  {
+    if (other.count == 0.) {
+      return;
+    }
+    const double total = count + other.count;
+    const double delta = other.mean - mean;
+    mean += delta * other.count / total;
+    m2 += other.m2 + delta * delta * count * other.count / total;
+    count = total;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+  }
+
+  double stddev() const { return count > 0. ? std::sqrt(m2 / count) : 0.; }
+
+  void pack(double* buf) const
+  {
+    buf[0] = count;
+    buf[1] = mean;
+    buf[2] = m2;
+    buf[3] = min;
+    buf[4] = max;
+  }
+
+  void unpack(double const* buf)
+  {
+    count = buf[0];
+    mean = buf[1];
+    m2 = buf[2];
+    min = buf[3];
+    max = buf[4];
+  }
+};
+
+/** Statistics of one data field. */
+struct field_stats
+{
+  data_field_type field;
+  std::vector<channel_stats> channels;
+};
+
+/** Add each column of a local matrix to the channel statistics. The
+ *  values of a channel in a column are a contiguous block of rows.
+ */
+template <typename T>
+void accumulate(El::Matrix<T, El::Device::CPU> const& local,
+                std::vector<channel_stats>& channels)
+{
+  const El::Int num_channels = channels.size();
+  const El::Int channel_size = local.Height() / num_channels;
+  const El::Int width = local.Width();
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int c = 0; c < num_channels; ++c) {
+    for (El::Int j = 0; j < width; ++j) {
+      const T* x = local.LockedBuffer(c * channel_size, j);
+      channel_stats block;
+      block.count = channel_size;
+      double sum = 0.;
+      for (El::Int i = 0; i < channel_size; ++i) {
+        const double v = x[i];
+        sum += v;
+        block.min = std::min(block.min, v);
+        block.max = std::max(block.max, v);
+      }
+      block.mean = sum / channel_size;
+      for (El::Int i = 0; i < channel_size; ++i) {
+        const double d = x[i] - block.mean;
+        block.m2 += d * d;
+      }
+      channels[c].merge(block);
+    }
+  }
+}
+
+/** Accumulate the current mini-batch of every field, if the data
+ *  coordinator holds TensorDataType.
+ */
+template <typename TensorDataType>
+bool accumulate_mini_batch(lbann_comm& comm,
+                           data_coordinator& dc,
+                           execution_mode mode,
+                           std::vector<field_stats>& stats)
+{
+  auto* bdc = dynamic_cast<buffered_data_coordinator<TensorDataType>*>(&dc);
+  if (bdc == nullptr) {
+    return false;
+  }
+  const int mini_batch_size = dc.get_current_mini_batch_size(mode);
+  for (auto& s : stats) {
+    El::DistMatrix<TensorDataType,
+                   El::STAR,
+                   El::VC,
+                   El::ELEMENT,
+                   El::Device::CPU>
+      buffer(comm.get_trainer_grid());
+    bdc->distribute_from_local_matrix(mode, s.field, buffer);
+    El::DistMatrix<TensorDataType,
+                   El::STAR,
+                   El::VC,
+                   El::ELEMENT,
+                   El::Device::CPU>
+      mini_batch(comm.get_trainer_grid());
+    const El::Int width = std::min<El::Int>(mini_batch_size, buffer.Width());
+    El::LockedView(mini_batch, buffer, El::ALL, El::IR(0, width));
+    accumulate(mini_batch.LockedMatrix(), s.channels);
+  }
+  return true;
+}
+
+/** Stream one epoch of a mode's data through the statistics. */
+std::vector<field_stats> compute_stats(lbann_comm& comm,
+                                       trainer& trainer,
+                                       execution_mode mode)
+{
+  auto& dc = trainer.get_data_coordinator();
+  auto* dr = dc.get_data_reader(mode);
+  if (dr == nullptr) {
+    LBANN_ERROR("no ", to_string(mode), " data reader in the prototext");
+  }
+
+  std::vector<field_stats> stats;
+  auto add_field = [&](data_field_type const& field,
+                       std::vector<int> const& dims) {
+    if (!dr->has_data_field(field) || dims.empty()) {
+      return;
+    }
+    const int num_channels = dims.front();
+    if (num_channels <= 0 || dc.get_linearized_size(field) % num_channels) {
+      LBANN_ERROR("data field ",
+                  field,
+                  " with size ",
+                  dc.get_linearized_size(field),
+                  " can not be split into ",
+                  num_channels,
+                  " channels");
+    }
+    dc.register_active_data_field(field);
+    stats.push_back({field, std::vector<channel_stats>(num_channels)});
+  };
+  add_field(INPUT_DATA_TYPE_SAMPLES, dr->get_data_dims());
+  add_field(INPUT_DATA_TYPE_RESPONSES, {dr->get_num_responses()});
+  if (stats.empty()) {
+    LBANN_ERROR("the ", to_string(mode), " data reader has no samples");
+  }
+
+  SGDExecutionContext c(mode, trainer.get_max_mini_batch_size());
+  dc.reset_mode(c);
+  bool done = false;
+  while (!done) {
+    dc.fetch_data(mode);
+    if (!accumulate_mini_batch<float>(comm, dc, mode, stats) &&
+        !accumulate_mini_batch<double>(comm, dc, mode, stats)) {
+      LBANN_ERROR("unsupported data coordinator data type");
+    }
+    done = dc.epoch_complete(mode);
+  }
+
+  // Merge the per-rank statistics in rank order. Trainers that read
+  // disjoint shards of the data set are merged as well.
+  const bool sharded = dc.is_sharded_across_trainers(mode);
+  auto const& merge_comm =
+    (sharded ? comm.get_world_comm() : comm.get_trainer_comm());
+  const int num_procs = El::mpi::Size(merge_comm);
+  for (auto& s : stats) {
+    const int size = s.channels.size() * channel_stats::packed_size;
+    std::vector<double> local(size), all(size * num_procs);
+    for (size_t c = 0; c < s.channels.size(); ++c) {
+      s.channels[c].pack(&local[c * channel_stats::packed_size]);
+    }
+    comm.all_gather(local.data(), size, all.data(), size, merge_comm);
+    for (size_t c = 0; c < s.channels.size(); ++c) {
+      channel_stats merged;
+      for (int p = 0; p < num_procs; ++p) {
+        channel_stats other;
+        other.unpack(&all[p * size + c * channel_stats::packed_size]);
+        merged.merge(other);
+      }
+      s.channels[c] = merged;
+    }
+  }
+  return stats;
+}
+
+template <typename F>
+void write_array(std::ostream& os,
+                 char const* name,
+                 std::vector<channel_stats> const& channels,
+                 F value)
+{
+  os << ", \"" << name << "\": [";
+  for (size_t c = 0; c < channels.size(); ++c) {
+    os << (c > 0 ? ", " : "") << value(channels[c]);
+  }
+  os << "]";
+}
+
+void write_stats(std::ostream& os, field_stats const& s)
+{
+  // A constant channel is left unscaled
+  auto safe_std = [](channel_stats const& c) {
+    const double sd = c.stddev();
+    return sd > 0. ? sd : 1.;
+  };
+  os.precision(std::numeric_limits<double>::max_digits10);
+  os << "{\"field\": \"" << s.field << "\", "
+     << "\"channels\": " << s.channels.size() << ", "
+     << "\"count\": "
+     << static_cast<long long>(s.channels.empty() ? 0.
+                                                  : s.channels.front().count);
+  write_array(os, "mean", s.channels, [](auto const& c) { return c.mean; });
+  write_array(os, "std", s.channels, [](auto const& c) { return c.stddev(); });
+  write_array(os, "min", s.channels, [](auto const& c) { return c.min; });
+  write_array(os, "max", s.channels, [](auto const& c) { return c.max; });
+  write_array(os, "scale", s.channels, [&](auto const& c) {
+    return 1. / safe_std(c);
+  });
+  write_array(os, "bias", s.channels, [&](auto const& c) {
+    return -c.mean / safe_std(c);
+  });
+  os << "}\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  auto& arg_parser = global_argument_parser();
+  construct_all_options();
+  arg_parser.add_option("stats mode",
+                        {"--stats_mode"},
+                        "[STD] Data set to read: training, validation or "
+                        "testing",
+                        "training");
+  arg_parser.add_option("stats output",
+                        {"--stats_output"},
+                        "[STD] File for the statistics (default: stdout)",
+                        "");
+
+  try {
+    arg_parser.parse(argc, argv);
+  }
+  catch (std::exception const& e) {
+    std::cerr << "Error during argument parsing:\n\ne.what():\n\n  " << e.what()
+              << "\n\nProcess terminating." << std::endl;
+    std::terminate();
+  }
+  auto comm = initialize(argc, argv);
+  const bool master = comm->am_world_master();
+
+  try {
+    if (arg_parser.help_requested() or argc == 1) {
+      if (master)
+        std::cout << arg_parser << std::endl;
+      return EXIT_SUCCESS;
+    }
+
+    const auto mode =
+      exec_mode_from_string(arg_parser.get<std::string>("stats mode"));
+
+    // Split MPI into trainers
+    allocate_trainer_resources(comm.get());
+
+    auto pbs = protobuf_utils::load_prototext(*comm);
+    // Optionally over-ride some values in the prototext for each model
+    for (size_t i = 0; i < pbs.size(); i++) {
+      get_cmdline_overrides(*comm, *(pbs[i]));
+    }
+    lbann_data::LbannPB& pb = *(pbs[0]);
+    lbann_data::Trainer* pb_trainer = pb.mutable_trainer();
+
+    // Construct the trainer
+    auto& trainer = construct_trainer(comm.get(), pb_trainer, pb);
+
+    // Unless the data set is sharded, every trainer reads all of it
+    // and the first one reports
+    const auto stats = compute_stats(*comm, trainer, mode);
+
+    if (master) {
+      const auto output = arg_parser.get<std::string>("stats output");
+      if (output.empty()) {
+        for (auto const& s : stats) {
+          write_stats(std::cout, s);
+        }
+      }
+      else {
+        std::ofstream ofs(output);
+        if (!ofs) {
+          LBANN_ERROR("could not open statistics output file ", output);
+        }
+        for (auto const& s : stats) {
+          write_stats(ofs, s);
+        }
+      }
+    }
+  }
+  catch (std::exception& e) {
+    El::ReportException(e);
+    // It's possible that a proper subset of ranks throw some
+    // exception. But we want to tear down the whole world.
+    El::mpi::Abort(El::mpi::COMM_WORLD, EXIT_FAILURE);
+  }
+
+  return EXIT_SUCCESS;
+}
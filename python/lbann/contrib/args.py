@@ -106,7 +106,8 @@ def add_optimizer_arguments(parser, default_optimizer='momentum',
         raise TypeError('expected an argparse.ArgumentParser')
     parser.add_argument(
         '--optimizer', action='store', default=default_optimizer, type=str,
-        choices=('momentum', 'sgd', 'adam', 'adagrad', 'rmsprop'),
+        choices=('momentum', 'sgd', 'adam', 'adagrad', 'rmsprop', 'lars',
+                 'lamb'),
         help='optimizer (default: {})'.format(default_optimizer))
     parser.add_argument(
         '--optimizer-learning-rate',
@@ -151,5 +152,11 @@ def create_optimizer(args):
     elif opt == 'rmsprop':
         return lbann.core.optimizer.RMSprop(learn_rate=lr, decay_rate=0.99,
                                             eps=1e-8)
+    elif opt == 'lars':
+        return lbann.core.optimizer.LARS(learn_rate=lr, momentum=0.9,
+                                         trust_coefficient=0.001)
+    elif opt == 'lamb':
+        return lbann.core.optimizer.LAMB(learn_rate=lr, beta1=0.9,
+                                         beta2=0.999, eps=1e-6)
     else:
         raise ValueError('invalid optimizer type ({})'.format(opt))
@@ -21,6 +21,10 @@ class Layer(abc.ABC):
         datatype (lbann.DataType, optional): Data type used for activations and weights.
         hint_layer (Layer, optional): Hint for output dimensions.
         parallel_strategy (dictionary, optional): Data partitioning scheme.
+        recompute_activations (bool, optional): Discard output tensors
+            after forward prop and recompute them before backprop.
+        offload_activations (bool, optional): Copy output tensors to
+            host memory after forward prop and back before backprop.
 
     """
 
@@ -36,7 +40,9 @@ class Layer(abc.ABC):
                  data_layout=None,
                  datatype=None,
                  hint_layer=None,
-                 parallel_strategy={}):
+                 parallel_strategy={},
+                 recompute_activations=False,
+                 offload_activations=False):
         Layer.global_count += 1
         self.parents = []
         self.children = []
@@ -47,6 +53,8 @@ class Layer(abc.ABC):
         self.datatype = datatype
         self.hint_layer = hint_layer
         self.parallel_strategy = parallel_strategy if parallel_strategy else {}
+        self.recompute_activations = recompute_activations
+        self.offload_activations = offload_activations
 
         # Initialize parents, children, and weights
         for arg in args:
@@ -75,6 +83,10 @@ class Layer(abc.ABC):
                 proto.parallel_strategy,
                 **self.parallel_strategy)
             proto.parallel_strategy.SetInParent()
+        if self.recompute_activations:
+            proto.recompute_activations = True
+        if self.offload_activations:
+            proto.offload_activations = True
         return proto
 
     def add_parent(self, parent):
@@ -110,11 +122,13 @@ if layers_pb2:
         skip_fields = set([
             'name', 'parents', 'children', 'data_layout', 'device_allocation', 'datatype',
             'weights', 'num_neurons_from_data_reader', 'freeze', 'hint_layer',
-            'parallel_strategy', 'weights_data', 'top', 'bottom', 'type', 'motif_layer']),
+            'parallel_strategy', 'recompute_activations', 'offload_activations',
+            'weights_data', 'top', 'bottom', 'type', 'motif_layer']),
         base_class = Layer,
         base_kwargs = set([
             'parents', 'children', 'weights',
-            'name', 'device', 'data_layout', 'datatype', 'hint_layer', 'parallel_strategy']),
+            'name', 'device', 'data_layout', 'datatype', 'hint_layer', 'parallel_strategy',
+            'recompute_activations', 'offload_activations']),
         base_has_export_proto = True)
     for c in classes:
         globals()[c.__name__] = c
@@ -147,13 +161,15 @@ def traverse_layer_graph(layers):
             if not l.parents:
                 roots.append(l)
 
-    # DFS to traverse layer graph in topological order
-    visited = set()
+    # DFS to traverse layer graph in topological order. A layer is
+    # pushed once its last parent has been visited, so each edge is
+    # only processed once.
+    num_unvisited_parents = {l: len(l.parents) for l in visited}
     stack = roots
     while stack:
         l = stack.pop()
-        if (l not in visited
-            and all([(p in visited) for p in l.parents])):
-            visited.add(l)
-            stack.extend(l.children)
-            yield l
+        yield l
+        for child in l.children:
+            num_unvisited_parents[child] -= 1
+            if num_unvisited_parents[child] == 0:
+                stack.append(child)
@@ -3,18 +3,59 @@ from lbann import optimizers_pb2
 import lbann.core.util
 
 class Optimizer(abc.ABC):
-    """Optimization algorithm for a neural network's parameters."""
+    """Optimization algorithm for a neural network's parameters.
+
+    Args:
+        clip_gradient_norm (float, optional): If positive, gradients
+            are scaled so that the global norm of the gradients of all
+            clipped optimizers does not exceed this value.
+        l2_regularization (float, optional): Coefficient of an L2
+            regularization term, applied in the update kernel.
+        decoupled_weight_decay (float, optional): Decoupled weight
+            decay rate, as in AdamW. Weights are multiplied by
+            (1 - learning rate * decoupled_weight_decay) before the
+            update.
+        stochastic_rounding (bool, optional): Round updated fp16
+            weights stochastically, so that they can be trained
+            without a higher-precision copy.
+
+    """
+    def __init__(self,
+                 clip_gradient_norm=0.0,
+                 l2_regularization=0.0,
+                 decoupled_weight_decay=0.0,
+                 stochastic_rounding=False):
+        self.clip_gradient_norm = clip_gradient_norm
+        self.l2_regularization = l2_regularization
+        self.decoupled_weight_decay = decoupled_weight_decay
+        self.stochastic_rounding = stochastic_rounding
+
     def export_proto(self):
         """Construct and return a protobuf message."""
-        return optimizers_pb2.Optimizer()
+        proto = optimizers_pb2.Optimizer()
+        if self.clip_gradient_norm:
+            proto.clip_gradient_norm = self.clip_gradient_norm
+        if self.l2_regularization:
+            proto.l2_regularization = self.l2_regularization
+        if self.decoupled_weight_decay:
+            proto.decoupled_weight_decay = self.decoupled_weight_decay
+        if self.stochastic_rounding:
+            proto.stochastic_rounding = self.stochastic_rounding
+        return proto
 
 # Generate Optimizer sub-classes from lbann.proto
 # Note: The list of skip fields must be updated if any new fields are
 # added to the Optimizer message in lbann.proto
+_base_fields = set(['clip_gradient_norm',
+                    'l2_regularization',
+                    'decoupled_weight_decay',
+                    'stochastic_rounding'])
 if optimizers_pb2:
     classes = lbann.core.util.generate_classes_from_protobuf_message(
         optimizers_pb2.Optimizer,
+        skip_fields = _base_fields,
         base_class = Optimizer,
+        base_kwargs = _base_fields,
         base_has_export_proto = True)
     for c in classes:
         globals()[c.__name__] = c
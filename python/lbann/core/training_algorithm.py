@@ -102,7 +102,8 @@ class BatchedIterativeOptimizer(TrainingAlgorithm):
             return msg
 
     def __init__(self, name: str, num_iterations: int = 0, epoch_count: int = 0,
-                 max_seconds: float = 0.):
+                 max_seconds: float = 0., num_micro_batches: int = 1,
+                 num_accumulation_steps: int = 1):
         """Construct a new BatchedIterativeOptimizer instance.
 
         Args:
@@ -110,16 +111,26 @@ class BatchedIterativeOptimizer(TrainingAlgorithm):
             num_iterations: Number of minibatches.
             epoch_count: Number of epochs.
             max_seconds: Maximum training duration (seconds)
+            num_micro_batches: Number of micro-batches per minibatch,
+                whose gradients are accumulated before each update.
+            num_accumulation_steps: Number of minibatches whose
+                gradients are averaged in each update.
         """
         self.name = name
         self.stopping = self.StoppingCriteria(batch_count=num_iterations,
                                               epoch_count=epoch_count,
                                               seconds=max_seconds)
+        self.num_micro_batches = num_micro_batches
+        self.num_accumulation_steps = num_accumulation_steps
 
     def do_export_proto(self):
         """Get a protobuf representation of this object."""
         params = AlgoProto.SGD()
         params.stopping_criteria.CopyFrom(self.stopping.export_proto())
+        if self.num_micro_batches > 1:
+            params.num_micro_batches = self.num_micro_batches
+        if self.num_accumulation_steps > 1:
+            params.num_accumulation_steps = self.num_accumulation_steps
         return params
 
 class MetaLearningStrategy:
@@ -289,7 +300,8 @@ class RandomPairwiseExchange(MetaLearningStrategy):
         def __init__(self, strategy: str = "checkpoint_binary",
                      weights_names: list[str] = [],
                      exchange_hyperparameters: bool = False,
-                     checkpoint_dir: str = None):
+                     checkpoint_dir: str = None,
+                     compress: bool = False):
             """Construct a new exchange strategy.
 
             Args:
@@ -302,11 +314,15 @@ class RandomPairwiseExchange(MetaLearningStrategy):
                   the "sendrecv_weights" strategy.
                 checkpoint_dir: A path to a directory for storing the
                   checkpoint files. Only applies to "checkpoint_file".
+                compress:
+                  If True, compress the exchanged models with zlib. Only
+                  applies to the "checkpoint_binary" strategy.
             """
             self.strategy = strategy
             self.exchange_hyperparameters = exchange_hyperparameters
             self.weights_names = make_iterable(weights_names)
             self.checkpoint_dir = checkpoint_dir
+            self.compress = compress
 
         def export_proto(self):
             """Get a protobuf representation of this object."""
@@ -316,7 +332,8 @@ class RandomPairwiseExchange(MetaLearningStrategy):
             msg.weights_name.extend([n for n in self.weights_names])
             if self.strategy == "checkpoint_binary":
                 CheckpointBinaryMsg = ExchangeStrategyMsg.CheckpointBinary
-                msg.checkpoint_binary.CopyFrom(CheckpointBinaryMsg())
+                msg.checkpoint_binary.CopyFrom(
+                    CheckpointBinaryMsg(compress=self.compress))
             elif self.strategy == "checkpoint_file":
                 if self.checkpoint_dir:
                     msg.checkpoint_file.checkpoint_dir = self.checkpoint_dir
@@ -434,6 +451,48 @@ class RegularizedEvolution(MetaLearningStrategy):
         msg.sample_size = self.sample_size
         return msg 
 
+class SuccessiveHalving(MetaLearningStrategy):
+    """Asynchronous successive halving (ASHA) of a population of trainers.
+
+    Each trainer runs one trial. A trial reaches rung k after
+    min_rounds*reduction_factor^k metalearning rounds and continues
+    only if its score is in the top 1/reduction_factor of the scores
+    recorded at that rung so far. The trainer of a terminated trial
+    copies and mutates the model of the best surviving trainer.
+    """
+
+    class MetricStrategy:
+        LOWER_IS_BETTER: int = 0
+        HIGHER_IS_BETTER: int = 1
+
+    def __init__(self,
+                 metric_name,
+                 metric_strategy,
+                 mutation_strategy = MutationStrategy(),
+                 reduction_factor = 3,
+                 min_rounds = 1,
+                 max_rungs = 4):
+
+        self.metric_name = metric_name
+        self.metric_strategy = metric_strategy
+        self.mutation_strategy = mutation_strategy
+        self.reduction_factor = reduction_factor
+        self.min_rounds = min_rounds
+        self.max_rungs = max_rungs
+
+    def export_proto(self):
+        """Get a protobuf representation of this object."""
+
+        msg = AlgoProto.SuccessiveHalving()
+
+        msg.metric_name = self.metric_name
+        msg.metric_strategy = self.metric_strategy
+        msg.mutation_strategy.CopyFrom(self.mutation_strategy.export_proto())
+        msg.reduction_factor = self.reduction_factor
+        msg.min_rounds = self.min_rounds
+        msg.max_rungs = self.max_rungs
+        return msg
+
 class KFAC(TrainingAlgorithm):
     """Kronecker-Factored Approximate Curvature algorithm.
 
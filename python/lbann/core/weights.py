@@ -27,12 +27,14 @@ class Weights:
 
     global_count = 0  # Static counter, used for default names
 
-    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None):
+    def __init__(self, initializer=None, optimizer=None, name=None, datatype=None,
+                 offload_optimizer=False):
         Weights.global_count += 1
         self.name = name if name else 'weights{0}'.format(Weights.global_count)
         self.initializer = initializer
         self.optimizer = optimizer
         self.datatype = datatype
+        self.offload_optimizer = offload_optimizer
 
     def export_proto(self):
         """Construct and return a protobuf message."""
@@ -53,4 +55,8 @@ class Weights:
         if self.datatype:
             proto.datatype = self.datatype
 
+        # Run the optimizer on the CPU if needed
+        if self.offload_optimizer:
+            proto.offload_optimizer = True
+
         return proto
@@ -4,12 +4,21 @@ import google.protobuf.text_format
 import google.protobuf.message
 from lbann import lbann_pb2, NoOptimizer
 
-def save_prototext(filename, **kwargs):
+def save_prototext(filename, binary=None, **kwargs):
     """Save a prototext file.
 
     LbannPB fields (e.g. `model`, `data_reader`, `optimizer`) are
     accepted via `kwargs`.
 
+    Args:
+        filename (str): Output file.
+        binary (bool, optional): Whether to write a serialized
+            (binary) message instead of text. Binary files are much
+            faster to write and for LBANN to parse, which matters for
+            very large models. LBANN detects them by their extension,
+            so the default is to write binary if `filename` ends in
+            ".binpb" or ".pb".
+
     """
 
     # Construct protobuf message
@@ -40,6 +49,11 @@ def save_prototext(filename, **kwargs):
         message.optimizer.SetInParent()
 
     # Write to file
+    if binary is None:
+        binary = filename.endswith(('.binpb', '.pb'))
     with open(filename, 'wb') as f:
-        f.write(google.protobuf.text_format.MessageToString(
-            message, use_index_order=True).encode())
+        if binary:
+            f.write(message.SerializeToString())
+        else:
+            f.write(google.protobuf.text_format.MessageToString(
+                message, use_index_order=True).encode())
@@ -44,6 +44,7 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/options.hpp"
+#include "lbann/utils/profiling.hpp"
 #include "lbann/utils/stack_trace.hpp"
 
 #ifdef LBANN_HAS_DNN_LIB
@@ -97,6 +98,7 @@ auto lbann::initialize_lbann(El::mpi::Comm&& c) -> std::unique_ptr<lbann_comm>
   // Create a new comm object with provided MPI_Comm
   auto comm = std::make_unique<lbann_comm>(0, std::move(c));
   world_comm_ = comm.get();
+  prof_initialize();
 
   // Install MPI error handler
   // MPI_Comm_create_errhandler(lbann_mpi_err_handler, &err_handle);
@@ -164,6 +166,7 @@ auto lbann::initialize_lbann(int argc, char** argv)
 
 void lbann::finalize_lbann(lbann_comm* comm)
 {
+  prof_finalize();
 #ifdef LBANN_HAS_NVSHMEM
   nvshmem::finalize();
 #endif // LBANN_HAS_NVSHMEM
@@ -202,6 +205,7 @@ auto lbann::initialize(int& argc, char**& argv) -> world_comm_ptr
   // Initial creation with every process in one model.
   auto comm = world_comm_ptr{new lbann_comm(0), &lbann::finalize};
   world_comm_ = comm.get();
+  prof_initialize();
 
   // Install MPI error handler
   MPI_Comm_create_errhandler(lbann_mpi_err_handler, &err_handle);
@@ -258,6 +262,7 @@ auto lbann::initialize(int& argc, char**& argv) -> world_comm_ptr
 void lbann::finalize(lbann_comm* comm)
 {
   finalize_trainer();
+  prof_finalize();
 #ifdef LBANN_HAS_NVSHMEM
   nvshmem::finalize();
 #endif // LBANN_HAS_NVSHMEM
@@ -433,6 +438,7 @@ CEREAL_FORCE_DYNAMIC_INIT(data_type_layer);
 
 CEREAL_FORCE_DYNAMIC_INIT(argmax_layer);
 CEREAL_FORCE_DYNAMIC_INIT(argmin_layer);
+CEREAL_FORCE_DYNAMIC_INIT(attention_layer);
 CEREAL_FORCE_DYNAMIC_INIT(base_convolution_layer);
 CEREAL_FORCE_DYNAMIC_INIT(batch_normalization_layer);
 CEREAL_FORCE_DYNAMIC_INIT(batchwise_reduce_sum_layer);
@@ -491,6 +497,7 @@ CEREAL_FORCE_DYNAMIC_INIT(rowwise_weights_norms_layer);
 CEREAL_FORCE_DYNAMIC_INIT(scatter_layer);
 CEREAL_FORCE_DYNAMIC_INIT(selu_dropout);
 CEREAL_FORCE_DYNAMIC_INIT(slice_layer);
+CEREAL_FORCE_DYNAMIC_INIT(softmax_cross_entropy_layer);
 CEREAL_FORCE_DYNAMIC_INIT(softmax_layer);
 CEREAL_FORCE_DYNAMIC_INIT(sort_layer);
 CEREAL_FORCE_DYNAMIC_INIT(split_layer);
@@ -510,9 +517,7 @@ CEREAL_FORCE_DYNAMIC_INIT(OperatorLayer);
 #ifdef LBANN_HAS_FFTW
 CEREAL_FORCE_DYNAMIC_INIT(dft_abs_layer);
 #endif
-#if defined(LBANN_HAS_SHMEM) || defined(LBANN_HAS_NVSHMEM)
 CEREAL_FORCE_DYNAMIC_INIT(dist_embedding_layer);
-#endif
 #ifdef LBANN_HAS_GPU
 CEREAL_FORCE_DYNAMIC_INIT(uniform_hash_layer);
 #endif
@@ -655,6 +660,8 @@ CEREAL_FORCE_DYNAMIC_INIT(data_type_optimizer);
 CEREAL_FORCE_DYNAMIC_INIT(adagrad);
 CEREAL_FORCE_DYNAMIC_INIT(adam);
 CEREAL_FORCE_DYNAMIC_INIT(hypergradient_adam);
+CEREAL_FORCE_DYNAMIC_INIT(lamb);
+CEREAL_FORCE_DYNAMIC_INIT(lars);
 CEREAL_FORCE_DYNAMIC_INIT(rmsprop);
 CEREAL_FORCE_DYNAMIC_INIT(sgd);
 
@@ -0,0 +1,183 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/calibrate_quantization.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/layers/data_type_layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/protobuf.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+void calibrate_quantization::setup(model* m)
+{
+  m_ranges.clear();
+  for (auto const* l : m->get_layers()) {
+    const auto& type = l->get_type();
+    if ((m_layer_names.empty() &&
+         (type == "convolution" || type == "fully connected")) ||
+        m_layer_names.count(l->get_name()) > 0) {
+      m_ranges[l->get_name()] = 0.;
+    }
+  }
+  for (auto const& name : m_layer_names) {
+    if (m_ranges.count(name) == 0) {
+      LBANN_ERROR(this->name(),
+                  " callback could not find layer \"",
+                  name,
+                  "\" in model \"",
+                  m->get_name(),
+                  "\"");
+    }
+  }
+}
+
+void calibrate_quantization::on_test_begin(model* m)
+{
+  for (auto& r : m_ranges) {
+    r.second = 0.;
+  }
+}
+
+void calibrate_quantization::on_evaluate_forward_prop_end(model* m, Layer* l)
+{
+  const auto& c = m->get_execution_context();
+  if (c.get_execution_mode() != execution_mode::testing) {
+    return;
+  }
+  auto it = m_ranges.find(l->get_name());
+  auto* dtl = dynamic_cast<data_type_layer<DataType>*>(l);
+  if (it == m_ranges.end() || dtl == nullptr) {
+    return;
+  }
+
+  // Copy the local input to the host
+  CPUMat input;
+  El::Copy(dtl->get_local_prev_activations(), input);
+  double range = it->second;
+  for (El::Int col = 0; col < input.Width(); ++col) {
+    for (El::Int row = 0; row < input.Height(); ++row) {
+      range = std::max(range, std::abs(static_cast<double>(input(row, col))));
+    }
+  }
+  it->second = range;
+}
+
+void calibrate_quantization::on_test_end(model* m)
+{
+  if (m_ranges.empty()) {
+    return;
+  }
+
+  // Every rank has the same layers, in the same order
+  auto* comm = m->get_comm();
+  std::vector<double> local_ranges, ranges(m_ranges.size());
+  for (auto const& r : m_ranges) {
+    local_ranges.push_back(r.second);
+  }
+  comm->trainer_allreduce(local_ranges.data(),
+                          static_cast<int>(local_ranges.size()),
+                          ranges.data(),
+                          El::mpi::MAX);
+
+  // Quantize the weights of the calibrated layers
+  std::ofstream table;
+  if (comm->am_trainer_master() && !m_output_file.empty()) {
+    table.open(m_output_file);
+    if (!table) {
+      LBANN_ERROR("failed to open ", m_output_file);
+    }
+    table << "# layer input_range input_scale channels weight_scales...\n";
+  }
+  size_t num_quantized = 0, num_calibrated = 0;
+  std::vector<double> scale;
+  for (auto* l : m->get_layers()) {
+    auto it = m_ranges.find(l->get_name());
+    if (it == m_ranges.end()) {
+      continue;
+    }
+    const double range = ranges[std::distance(m_ranges.begin(), it)];
+    scale.clear();
+    if (l->quantize_inference_weights(scale)) {
+      ++num_quantized;
+    }
+    if (table.is_open()) {
+      table << l->get_name() << " " << range << " " << range / 127. << " "
+            << scale.size();
+      for (auto const& s : scale) {
+        table << " " << s;
+      }
+      table << "\n";
+    }
+    ++num_calibrated;
+  }
+  if (table.is_open()) {
+    table.close();
+    if (!table) {
+      LBANN_ERROR("failed to write ", m_output_file);
+    }
+  }
+  if (comm->am_trainer_master()) {
+    std::cout << name() << ": quantized the weights of " << num_quantized
+              << " of " << num_calibrated << " calibrated layers in model \""
+              << m->get_name() << "\"" << std::endl;
+  }
+}
+
+void calibrate_quantization::write_specific_proto(
+  lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_calibrate_quantization();
+  msg->set_layers(protobuf::to_space_sep_string(m_layer_names));
+  msg->set_output_file(m_output_file);
+}
+
+std::unique_ptr<callback_base> build_calibrate_quantization_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackCalibrateQuantization&>(
+      proto_msg);
+  return std::make_unique<calibrate_quantization>(
+    parse_set<std::string>(params.layers()),
+    params.output_file());
+}
+
+} // namespace callback
+} // namespace lbann
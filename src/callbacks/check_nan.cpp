@@ -29,6 +29,7 @@
 #include "lbann/layers/data_type_layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/weights/data_type_weights.hpp"
 
 #include "lbann/utils/serialize.hpp"
 
@@ -214,7 +215,182 @@ void check_nan::serialize(Archive& ar)
 
 void check_nan::write_specific_proto(lbann_data::Callback& proto) const
 {
-  proto.mutable_check_nan();
+  auto* msg = proto.mutable_check_nan();
+  msg->set_batch_interval(m_interval);
+  msg->set_sample_layers(m_sample_layers);
+}
+
+check_nan& check_nan::operator=(const check_nan& other)
+{
+  callback_base::operator=(other);
+  m_interval = other.m_interval;
+  m_sample_layers = other.m_sample_layers;
+  m_slot_names.clear();
+  m_layer_slots.clear();
+  m_layer_indices.clear();
+  m_weights_slots.clear();
+  m_cpu_flags.clear();
+  m_read_flags.clear();
+  m_reading = false;
+  return *this;
+}
+
+void check_nan::setup(model* m)
+{
+  m_slot_names.clear();
+  m_layer_slots.clear();
+  m_layer_indices.clear();
+  m_weights_slots.clear();
+  m_reading = false;
+  m_sample_offset = 0;
+  if (m_interval == 0) {
+    return;
+  }
+
+  // One slot per layer output and input, and two per weights
+  for (const auto* l : m->get_layers()) {
+    const size_t index = m_layer_indices.size();
+    m_layer_indices[l] = index;
+    m_layer_slots[l] = m_slot_names.size();
+    for (int i = 0; i < l->get_num_children(); ++i) {
+      m_slot_names.push_back(build_string("activations ",
+                                          i,
+                                          " of layer \"",
+                                          l->get_name(),
+                                          "\""));
+    }
+    for (int i = 0; i < l->get_num_parents(); ++i) {
+      m_slot_names.push_back(build_string("error signals ",
+                                          i,
+                                          " of layer \"",
+                                          l->get_name(),
+                                          "\""));
+    }
+  }
+  for (const auto* w : m->get_weights()) {
+    m_weights_slots[w] = m_slot_names.size();
+    m_slot_names.push_back("gradient w.r.t. weights \"" + w->get_name() +
+                           "\"");
+    m_slot_names.push_back("weights \"" + w->get_name() + "\"");
+  }
+  const size_t num_slots = m_slot_names.size();
+  m_cpu_flags.assign(num_slots, 0);
+  m_read_flags.assign(num_slots, 0);
+#ifdef LBANN_HAS_GPU
+  m_device_flags.Resize(num_slots, 1);
+  zero_flags_gpu(m_device_flags);
+  if (m_host_flags.IsEmpty()) {
+    m_host_flags.SetMemoryMode(1); // Pinned memory
+  }
+  m_host_flags.Resize(num_slots, 1);
+#endif // LBANN_HAS_GPU
+}
+
+void check_nan::on_train_begin(model* m)
+{
+  m_flags_begin = m->get_execution_context().get_step();
+}
+
+void check_nan::on_train_end(model* m)
+{
+  if (m_interval == 0) {
+    return;
+  }
+  // Report the steps since the last read
+  finish_read(*m);
+  const size_t step = m->get_execution_context().get_step();
+  if (step > m_flags_begin) {
+    start_read(step);
+    finish_read(*m);
+  }
+}
+
+bool check_nan::is_sampled(size_t layer) const
+{
+  const size_t num_layers = m_layer_indices.size();
+  if (m_sample_layers == 0 ||
+      static_cast<size_t>(m_sample_layers) >= num_layers) {
+    return true;
+  }
+  const size_t offset = m_sample_offset % num_layers;
+  return ((layer + num_layers - offset) % num_layers <
+          static_cast<size_t>(m_sample_layers));
+}
+
+void check_nan::flag_nonfinite(const AbsDistMat& mat, size_t slot)
+{
+  const auto& local = mat.LockedMatrix();
+  if (local.Height() == 0 || local.Width() == 0) {
+    return;
+  }
+#ifdef LBANN_HAS_GPU
+  if (local.GetDevice() == El::Device::GPU) {
+    using GPUMatType = El::Matrix<DataType, El::Device::GPU>;
+    flag_nonfinite_gpu(static_cast<const GPUMatType&>(local),
+                       m_device_flags,
+                       slot);
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  const auto& cpu_local = static_cast<const CPUMat&>(local);
+  int bits = 0;
+  for (El::Int j = 0; j < cpu_local.Width(); ++j) {
+    for (El::Int i = 0; i < cpu_local.Height(); ++i) {
+      const auto x = cpu_local(i, j);
+      bits |= (std::isnan(x) ? 1 : std::isinf(x) ? 2 : 0);
+    }
+  }
+  m_cpu_flags[slot] |= bits;
+}
+
+void check_nan::start_read(size_t step)
+{
+  m_read_flags = m_cpu_flags;
+  std::fill(m_cpu_flags.begin(), m_cpu_flags.end(), 0);
+#ifdef LBANN_HAS_GPU
+  // Stream-ordered after the checks, and before the flags are zeroed
+  const auto sync = El::SyncInfoFromMatrix(m_device_flags);
+  gpu_lib::mem_copy_async(m_host_flags.Buffer(),
+                          m_device_flags.LockedBuffer(),
+                          m_device_flags.Height() * sizeof(int),
+                          gpu_lib::GPU_MEMCPY_DEVICE_TO_HOST,
+                          sync.Stream());
+  m_read_event.record(sync.Stream());
+  zero_flags_gpu(m_device_flags);
+#endif // LBANN_HAS_GPU
+  m_reading = true;
+  m_read_begin = m_flags_begin;
+  m_read_end = step;
+  m_flags_begin = step;
+}
+
+void check_nan::finish_read(model& m)
+{
+  if (!m_reading) {
+    return;
+  }
+  m_reading = false;
+#ifdef LBANN_HAS_GPU
+  m_read_event.synchronize();
+  for (size_t slot = 0; slot < m_read_flags.size(); ++slot) {
+    m_read_flags[slot] |= m_host_flags(slot, 0);
+  }
+#endif // LBANN_HAS_GPU
+  for (size_t slot = 0; slot < m_read_flags.size(); ++slot) {
+    const int bits = m_read_flags[slot];
+    if (bits != 0) {
+      LBANN_ERROR("rank ",
+                  m.get_comm()->get_rank_in_world(),
+                  ": ",
+                  (bits & 1 ? "NaN" : "inf"),
+                  " found in ",
+                  m_slot_names[slot],
+                  " in training steps ",
+                  m_read_begin,
+                  " to ",
+                  m_read_end - 1);
+    }
+  }
 }
 
 void check_nan::on_forward_prop_end(model* m, Layer* l)
@@ -225,6 +401,17 @@ void check_nan::on_forward_prop_end(model* m, Layer* l)
   if (!m || !l)
     LBANN_ERROR("Model or layer pointer is null.");
 
+  if (m_interval > 0) {
+    auto const* dtl = dynamic_cast<data_type_layer<DataType> const*>(l);
+    if (dtl != nullptr && is_sampled(m_layer_indices.at(l))) {
+      const size_t slot = m_layer_slots.at(l);
+      for (int i = 0; i < l->get_num_children(); ++i) {
+        flag_nonfinite(dtl->get_activations(i), slot + i);
+      }
+    }
+    return;
+  }
+
   const auto& num_outputs = l->get_num_children();
   for (int i = 0; i < num_outputs; ++i) {
     El::Int row, col;
@@ -273,6 +460,16 @@ void check_nan::on_backward_prop_end(model* m, Layer* l)
 {
   using proxy_type =
     El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
+  if (m_interval > 0) {
+    auto const* dtl = dynamic_cast<data_type_layer<DataType> const*>(l);
+    if (dtl != nullptr && is_sampled(m_layer_indices.at(l))) {
+      const size_t slot = m_layer_slots.at(l) + l->get_num_children();
+      for (int i = 0; i < l->get_num_parents(); ++i) {
+        flag_nonfinite(dtl->get_error_signals(i), slot + i);
+      }
+    }
+    return;
+  }
   const auto& num_inputs = l->get_num_parents();
   for (int i = 0; i < num_inputs; ++i) {
     El::Int row, col;
@@ -319,6 +516,21 @@ void check_nan::on_backward_prop_end(model* m)
 {
   using proxy_type =
     El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
+  if (m_interval > 0) {
+    // Gradients are checked in the steps that end an interval
+    const size_t step = m->get_execution_context().get_step();
+    if ((step + 1) % m_interval != 0) {
+      return;
+    }
+    for (weights* w : m->get_weights()) {
+      auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+      auto* opt = (dtw != nullptr ? dtw->get_optimizer() : nullptr);
+      if (opt != nullptr) {
+        flag_nonfinite(opt->get_gradient(), m_weights_slots.at(w));
+      }
+    }
+    return;
+  }
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
     auto* opt = dtw.get_optimizer();
@@ -361,6 +573,23 @@ void check_nan::on_batch_end(model* m)
 {
   using proxy_type =
     El::AbstractDistMatrixReadDeviceProxy<DataType, El::Device::CPU>;
+  if (m_interval > 0) {
+    // The flags were copied during the last step, so this rarely
+    // waits
+    finish_read(*m);
+    m_sample_offset += m_sample_layers;
+    const size_t step = m->get_execution_context().get_step();
+    if (step % m_interval == 0) {
+      for (weights* w : m->get_weights()) {
+        auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+        if (dtw != nullptr) {
+          flag_nonfinite(dtw->get_values(), m_weights_slots.at(w) + 1);
+        }
+      }
+      start_read(step);
+    }
+    return;
+  }
   for (weights* w : m->get_weights()) {
     auto& dtw = dynamic_cast<data_type_weights<DataType>&>(*w);
     El::Int row, col;
@@ -396,6 +625,16 @@ void check_nan::on_batch_end(model* m)
   }
 }
 
+std::unique_ptr<callback_base>
+build_check_nan_callback_from_pbuf(const google::protobuf::Message& proto_msg,
+                                   const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackCheckNaN&>(proto_msg);
+  return std::make_unique<check_nan>(params.batch_interval(),
+                                     params.sample_layers());
+}
+
 } // namespace callback
 } // namespace lbann
 
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/check_nan.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+/** Grid-stride, so a large matrix is checked by a bounded grid. */
+__global__ void flag_nonfinite_kernel(El::Int height,
+                                      El::Int width,
+                                      const DataType* __restrict__ x,
+                                      El::Int ldx,
+                                      int* __restrict__ flag)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  int bits = 0;
+  for (El::Int i = gid; i < size; i += nthreads) {
+    const auto& val = x[(i % height) + (i / height) * ldx];
+    if (!gpu_lib::isfinite(val)) {
+      bits |= (gpu_lib::isnan(val) ? 1 : 2);
+    }
+  }
+  if (bits != 0) {
+    atomicOr(flag, bits);
+  }
+}
+
+__global__ void zero_flags_kernel(El::Int size, int* __restrict__ flags)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  if (gid < size) {
+    flags[gid] = 0;
+  }
+}
+
+} // namespace
+
+void flag_nonfinite_gpu(const El::Matrix<DataType, El::Device::GPU>& mat,
+                        El::Matrix<int, El::Device::GPU>& flags,
+                        size_t slot)
+{
+  const El::Int size = mat.Height() * mat.Width();
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  constexpr El::Int max_grid_size = 1024;
+  const El::Int grid_size =
+    std::min((size + block_size - 1) / block_size, max_grid_size);
+  auto multisync = El::MakeMultiSync(El::SyncInfoFromMatrix(flags),
+                                     El::SyncInfoFromMatrix(mat));
+  hydrogen::gpu::LaunchKernel(flag_nonfinite_kernel,
+                              grid_size,
+                              block_size,
+                              0,
+                              multisync,
+                              mat.Height(),
+                              mat.Width(),
+                              mat.LockedBuffer(),
+                              mat.LDim(),
+                              flags.Buffer(slot, 0));
+}
+
+void zero_flags_gpu(El::Matrix<int, El::Device::GPU>& flags)
+{
+  const El::Int size = flags.Height() * flags.Width();
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  hydrogen::gpu::LaunchKernel(zero_flags_kernel,
+                              (size + block_size - 1) / block_size,
+                              block_size,
+                              0,
+                              El::SyncInfoFromMatrix(flags),
+                              size,
+                              flags.Buffer());
+}
+
+} // namespace callback
+} // namespace lbann
@@ -36,8 +36,12 @@
 
 #include "lbann/proto/callbacks.pb.h"
 
+#include <algorithm>
+#include <fstream>
+#include <future>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace lbann {
 namespace {
@@ -79,6 +83,42 @@ size_t get_step_with_training_override(model& m, trainer& t)
 {
   return get_current_execution_context_with_training_override(m, t).get_step();
 }
+
+/** Name of the file recording the number of ranks in the trainer
+ *  that wrote a distributed checkpoint, in the directory of rank 0.
+ */
+constexpr char trainer_size_filename[] = "trainer_size.txt";
+
+/**
+ * Number of ranks in the trainer that wrote a distributed checkpoint,
+ * given the checkpoint directory of its rank 0. Checkpoints that do
+ * not record it are assumed to match the current trainer.
+ */
+int get_distributed_checkpoint_size(lbann_comm& comm,
+                                    const std::string& rank0_dir)
+{
+  int size = comm.get_procs_per_trainer();
+  if (comm.am_trainer_master()) {
+    try {
+      std::string path;
+      uint64_t offset, bytes;
+      locate_checkpoint_file(rank0_dir,
+                             file::join_path(rank0_dir, trainer_size_filename),
+                             path,
+                             offset,
+                             bytes);
+      std::ifstream is(path);
+      is.seekg(offset);
+      if (!(is >> size) || size <= 0) {
+        LBANN_ERROR("invalid trainer size in ", rank0_dir);
+      }
+    }
+    catch (NonexistentArchiveFile const&) {
+    }
+  }
+  comm.trainer_broadcast(0, size);
+  return size;
+}
 } // namespace
 
 namespace callback {
@@ -89,6 +129,9 @@ void checkpoint::setup(model* m) { reload_model(m); }
 void checkpoint::setup(trainer* t)
 {
   set_active_trainer(t);
+  if (!m_resize_request_file.empty() && get_checkpoint_dir().empty()) {
+    LBANN_ERROR("a resize request file requires a checkpoint directory");
+  }
   auto& p = get_active_trainer().get_persist_obj();
   p.set_cb_type(callback_type::invalid);
   reload_trainer(t);
@@ -111,6 +154,7 @@ void checkpoint::on_train_end(model* m)
     do_checkpoint(m, visitor_hook::execution_mode_end);
   }
   p.set_cb_type(callback_type::invalid);
+  wait_for_checkpoint_writes(*m->get_comm(), 0);
 }
 
 // Interval defined with checkpoint_epochs or ckpt_dist_epochs
@@ -138,6 +182,29 @@ void checkpoint::on_batch_begin(model* m)
 {
   auto& p = get_active_trainer().get_persist_obj();
   p.set_cb_type(callback_type::full_checkpoint);
+  if (!m_resize_request_file.empty()) {
+    lbann_comm& comm = *m->get_comm();
+    int requested = 0;
+    if (comm.am_trainer_master()) {
+      requested = file::file_exists(m_resize_request_file);
+    }
+    comm.trainer_broadcast(0, requested);
+    if (requested) {
+      if (comm.am_trainer_master()) {
+        std::cout << "[" << m->get_name() << "." << comm.get_trainer_rank()
+                  << "] Resize requested by " << m_resize_request_file
+                  << ", stopping after a checkpoint" << std::endl;
+      }
+      m_checkpoint_shared = true;
+      m_checkpoint_dist = false;
+      do_checkpoint(m, visitor_hook::execution_mode_batch_begin);
+      m_resize_requested = true;
+      auto& c = dynamic_cast<SGDExecutionContext&>(m->get_execution_context());
+      c.set_early_stop(true);
+      p.set_cb_type(callback_type::invalid);
+      return;
+    }
+  }
   if (need_checkpoint(m, callback_phase::batch)) {
     do_checkpoint(m, visitor_hook::execution_mode_batch_begin);
   }
@@ -250,6 +317,12 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
   comm->trainer_broadcast(0, epoch);
   comm->trainer_broadcast(0, step);
 
+  // Make room for this checkpoint, then keep its files in memory
+  wait_for_checkpoint_writes(*comm, m_max_inflight_checkpoints - 1);
+  if (m_async_writes) {
+    p.set_deferred_writes(true);
+  }
+
   // Distributed ckpt
   if (m_checkpoint_dist) {
     this->do_distributed_checkpoint(*comm,
@@ -273,6 +346,18 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
                                step);
   }
 
+  if (m_async_writes) {
+    p.set_deferred_writes(false);
+    auto files = p.take_deferred_files();
+    inflight_checkpoint ckpt;
+    ckpt.done = std::async(std::launch::async, [files = std::move(files)]() {
+                  write_deferred_files(files);
+                }).share();
+    ckpt.latest = std::move(m_pending_latest);
+    m_pending_latest.clear();
+    m_inflight.push_back(std::move(ckpt));
+  }
+
   uint64_t bytes_count = p.get_bytes();
 
   if (comm->am_trainer_master()) {
@@ -286,9 +371,11 @@ bool checkpoint::do_checkpoint(model* m, visitor_hook hook)
               << (is_execution_mode_hook(hook)
                     ? to_string(hook, c.get_execution_mode())
                     : to_string(hook))
-              << "] to " << get_checkpoint_dir() << " complete: Epoch=" << epoch
-              << " Step=" << step << " (" << secs << " secs, " << bytes_count
-              << " bytes, " << bw << " MB/sec)" << std::endl;
+              << "] to " << get_checkpoint_dir()
+              << (m_async_writes ? " snapshot" : "")
+              << " complete: Epoch=" << epoch << " Step=" << step << " ("
+              << secs << " secs, " << bytes_count << " bytes, " << bw
+              << " MB/sec)" << std::endl;
     fflush(stdout);
   }
   // record last checkpoint time in case checkpoint_secs interval defined.
@@ -304,7 +391,8 @@ std::string checkpoint::find_latest_checkpoint(lbann_comm& comm,
                                                execution_mode& mode,
                                                size_t& epoch,
                                                size_t& step,
-                                               bool& shared)
+                                               bool& shared,
+                                               bool node_local)
 {
   constexpr unsigned int max_len_dirname = 1024;
   std::string dir;
@@ -316,7 +404,9 @@ std::string checkpoint::find_latest_checkpoint(lbann_comm& comm,
   if (comm.am_trainer_master()) {
     std::string latest_file;
     if (m_per_rank_dir.length()) {
-      dir = get_distributed_checkpoint_rootdir();
+      // Flushed distributed checkpoints are in the restart directory
+      dir = (node_local ? get_distributed_checkpoint_rootdir()
+                        : get_restart_dir());
       latest_file =
         get_last_distributed_checkpoint_filename(trainer_name, alg_name, dir);
       read_latest(latest_file, &hook, &mode, &epoch_dist, &step_dist);
@@ -337,7 +427,8 @@ std::string checkpoint::find_latest_checkpoint(lbann_comm& comm,
       shared = 1;
     }
     else {
-      dir = get_distributed_checkpoint_rootdir();
+      dir = (node_local ? get_distributed_checkpoint_rootdir()
+                        : get_restart_dir());
       step = step_dist;
       epoch = epoch_dist;
       shared = 0;
@@ -404,6 +495,66 @@ bool checkpoint::open_latest_checkpoint(
                                            step,
                                            shared);
 
+  // Checkpoint directories of the ranks that wrote a distributed
+  // checkpoint
+  auto get_rank_dirs = [&]() {
+    const auto rank_dir = [&](int rank) {
+      return get_distributed_checkpoint_dirname(trainer_name,
+                                                alg_name,
+                                                rank,
+                                                dir,
+                                                hook,
+                                                mode,
+                                                epoch,
+                                                step);
+    };
+    const int size = get_distributed_checkpoint_size(comm, rank_dir(0));
+    std::vector<std::string> dirs;
+    for (int rank = 0; rank < size; ++rank) {
+      dirs.push_back(rank_dir(rank));
+    }
+    return dirs;
+  };
+
+  // A node-local checkpoint is lost with any of its nodes, so fall
+  // back to the flushed checkpoints unless every rank has the
+  // directories it reads
+  if (!shared && has_flushed_checkpoints()) {
+    int valid = 0;
+    if (epoch != std::numeric_limits<size_t>::max()) {
+      const auto rank_dirs = get_rank_dirs();
+      const int rank = comm.get_rank_in_trainer();
+      if (static_cast<int>(rank_dirs.size()) == comm.get_procs_per_trainer()) {
+        valid = file::directory_exists(rank_dirs[rank]);
+      }
+      else {
+        valid = std::all_of(rank_dirs.begin(),
+                            rank_dirs.end(),
+                            [](const std::string& d) {
+                              return file::directory_exists(d);
+                            });
+      }
+    }
+    if (comm.trainer_allreduce(valid, El::mpi::MIN) == 0) {
+      if (comm.am_trainer_master()) {
+        LBANN_WARNING("Incomplete checkpoint in ",
+                      dir,
+                      ", restarting from flushed checkpoints instead");
+      }
+      epoch = std::numeric_limits<size_t>::max();
+      step = std::numeric_limits<size_t>::max();
+      dir = find_latest_checkpoint(comm,
+                                   trainer_name,
+                                   alg_name,
+                                   hook,
+                                   mode,
+                                   epoch,
+                                   step,
+                                   shared,
+                                   /*node_local=*/false);
+    }
+  }
+
   // if we couldn't find the latest epoch, just return
   if (epoch == std::numeric_limits<size_t>::max()) {
     return false;
@@ -423,21 +574,35 @@ bool checkpoint::open_latest_checkpoint(
   // Create dir to restart from based off last recorded checkpoint (or overriden
   // values in last.shared[distributed].checkpoint
   if (!shared) {
-    epochdir = get_distributed_checkpoint_dirname(trainer_name,
-                                                  alg_name,
-                                                  comm.get_rank_in_trainer(),
-                                                  dir,
-                                                  hook,
-                                                  mode,
-                                                  epoch,
-                                                  step);
+    // A checkpoint written by a different number of ranks is
+    // resharded: each rank restores the state of an old rank, and
+    // reads the entries it owns of distributed matrices from the
+    // directories of the old ranks that own them
+    auto rank_dirs = get_rank_dirs();
+    const int num_old_ranks = rank_dirs.size();
+    const int rank = comm.get_rank_in_trainer();
+    const int source_rank = rank % num_old_ranks;
+    epochdir = rank_dirs[source_rank];
     if (!file::directory_exists(epochdir)) {
       LBANN_WARNING(epochdir + " does not exist");
       return false;
     }
+    if (num_old_ranks != comm.get_procs_per_trainer()) {
+      if (comm.am_trainer_master()) {
+        std::cout << "[" << trainer_name << "] Resharding a checkpoint of "
+                  << num_old_ranks << " ranks to "
+                  << comm.get_procs_per_trainer() << " ranks" << std::endl;
+      }
+      p.set_reshard_sources(std::move(rank_dirs), source_rank);
+    }
     p.open_restart(epochdir.c_str());
+    if (file::file_exists(get_file_container_filename(epochdir))) {
+      p.open_file_container(epochdir);
+    }
     if (!reload_distributed_ckpt(p))
       LBANN_WARNING("Unable to reload distributed checkpoint ", epochdir);
+    p.close_file_container();
+    p.clear_reshard_sources();
     p.close_restart();
   }
   else {
@@ -461,8 +626,10 @@ bool checkpoint::open_latest_checkpoint(
     // rank specific rng state
     //   p.m_checkpoint_dir = epochdir;
     // }
+    p.set_parallel_reads(m_parallel_restart);
     if (!reload_shared_ckpt(p))
       LBANN_WARNING("Unable to reload shared checkpoint ", epochdir);
+    p.set_parallel_reads(false);
     /// @todo For the moment let all ranks open the checkpoint files
     p.close_restart();
     // }
@@ -544,6 +711,13 @@ void checkpoint::write_specific_proto(lbann_data::Callback& proto) const
   msg->set_per_rank_dir(m_per_rank_dir);
   msg->set_ckpt_dist_epochs(m_ckpt_dist_epochs);
   msg->set_ckpt_dist_steps(m_ckpt_dist_steps);
+  msg->set_async_writes(m_async_writes);
+  msg->set_max_inflight_checkpoints(m_max_inflight_checkpoints);
+  msg->set_aggregate_files(m_aggregate_files);
+  msg->set_flush_interval(m_flush_interval);
+  msg->set_parallel_restart(m_parallel_restart);
+  msg->set_incremental_weights(m_incremental_weights);
+  msg->set_resize_request_file(m_resize_request_file);
 }
 
 void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
@@ -600,6 +774,16 @@ void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
   // Make sure that the master has had a chance to create the directories
   comm.trainer_barrier();
 
+  // Keep the files in memory to pack them into a container
+  const bool flush =
+    (has_flushed_checkpoints() &&
+     ++m_num_distributed_checkpoints % m_flush_interval == 0);
+  const bool keep_files = m_aggregate_files || flush;
+  const bool defer_writes = p.get_deferred_writes();
+  if (keep_files) {
+    p.set_deferred_writes(true);
+  }
+
   // Call top level save to checkpoint function in model, in turn
   // calls save to checkpoint functions for other model classes
   // (weights, layers)
@@ -611,15 +795,54 @@ void checkpoint::do_distributed_checkpoint(lbann_comm& comm,
       (p.get_cb_type() == callback_type::full_checkpoint)) {
     t.save_to_checkpoint_distributed();
   }
+  // Record the trainer size, so the checkpoint can be resharded
+  if (comm.am_trainer_master()) {
+    auto os = p.open_output(file::join_path(epochdir, trainer_size_filename));
+    *os << comm.get_procs_per_trainer() << std::endl;
+  }
   p.close_checkpoint();
 
+  if (keep_files) {
+    auto files = p.take_deferred_files();
+    p.set_deferred_writes(defer_writes);
+    // Paths in the container are relative to epochdir, so the same
+    // container can be flushed
+    persist::deferred_file container{get_file_container_filename(epochdir),
+                                     std::make_shared<std::stringbuf>()};
+    {
+      std::ostream os(container.data.get());
+      write_file_container(os, epochdir, files);
+    }
+    if (m_aggregate_files) {
+      files = {container};
+    }
+    // The files are written in the background in asynchronous mode
+    if (defer_writes) {
+      for (auto& file : files) {
+        p.defer_file(std::move(file));
+      }
+    }
+    else {
+      write_deferred_files(files);
+    }
+    if (flush) {
+      flush_distributed_checkpoint(comm,
+                                   t,
+                                   hook,
+                                   mode,
+                                   epoch,
+                                   step,
+                                   std::move(container));
+    }
+  }
+
   // Print latest checkpoint to file
   if (comm.am_trainer_master()) {
     auto const latest_file = get_last_distributed_checkpoint_filename(
       t.get_name(),
       this->get_active_training_algorithm().get_type(),
       dir);
-    write_latest(latest_file, hook, mode, epoch, step);
+    record_latest(latest_file, hook, mode, epoch, step);
   }
 }
 
@@ -652,7 +875,9 @@ void checkpoint::do_shared_checkpoint(lbann_comm& comm,
   comm.trainer_barrier();
   if ((p.get_cb_type() == callback_type::model_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
+    p.set_incremental_weights(m_incremental_weights);
     m.save_to_checkpoint_shared(p);
+    p.set_incremental_weights(false);
   }
   if ((p.get_cb_type() == callback_type::execution_context_only) ||
       (p.get_cb_type() == callback_type::full_checkpoint)) {
@@ -666,7 +891,75 @@ void checkpoint::do_shared_checkpoint(lbann_comm& comm,
       t.get_name(),
       this->get_active_training_algorithm().get_type(),
       dir);
-    write_latest(latest_file, hook, mode, epoch, step);
+    record_latest(latest_file, hook, mode, epoch, step);
+  }
+}
+
+void checkpoint::record_latest(const std::string& filename,
+                               visitor_hook hook,
+                               execution_mode mode,
+                               size_t epoch,
+                               size_t step)
+{
+  if (m_async_writes) {
+    m_pending_latest.push_back({filename, hook, mode, epoch, step});
+  }
+  else {
+    write_latest(filename, hook, mode, epoch, step);
+  }
+}
+
+void checkpoint::flush_distributed_checkpoint(
+  lbann_comm& comm,
+  trainer& t,
+  visitor_hook hook,
+  execution_mode mode,
+  size_t epoch,
+  size_t step,
+  persist::deferred_file container)
+{
+  auto const dir = this->get_checkpoint_dir();
+  auto const& alg_name = this->get_active_training_algorithm().get_type();
+  auto const epochdir =
+    get_distributed_checkpoint_dirname(t.get_name(),
+                                       alg_name,
+                                       comm.get_rank_in_trainer(),
+                                       dir,
+                                       hook,
+                                       mode,
+                                       epoch,
+                                       step);
+  makedir(epochdir.c_str());
+  container.filename = get_file_container_filename(epochdir);
+
+  inflight_checkpoint ckpt;
+  ckpt.done =
+    std::async(std::launch::async, [container = std::move(container)]() {
+      write_deferred_files({container});
+    }).share();
+  if (comm.am_trainer_master()) {
+    ckpt.latest.push_back(
+      {get_last_distributed_checkpoint_filename(t.get_name(), alg_name, dir),
+       hook,
+       mode,
+       epoch,
+       step});
+  }
+  m_inflight.push_back(std::move(ckpt));
+}
+
+void checkpoint::wait_for_checkpoint_writes(lbann_comm& comm,
+                                            size_t max_inflight)
+{
+  while (m_inflight.size() > max_inflight) {
+    auto ckpt = std::move(m_inflight.front());
+    m_inflight.pop_front();
+    ckpt.done.get();
+    // Every process must have written its files
+    comm.trainer_barrier();
+    for (auto const& l : ckpt.latest) {
+      write_latest(l.filename, l.hook, l.mode, l.epoch, l.step);
+    }
   }
 }
 
@@ -871,14 +1164,26 @@ build_checkpoint_callback_from_pbuf(const google::protobuf::Message& proto_msg)
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackCheckpoint&>(proto_msg);
-  return std::make_unique<checkpoint>(params.checkpoint_dir(),
-                                      params.restart_dir(),
-                                      params.checkpoint_epochs(),
-                                      params.checkpoint_steps(),
-                                      params.checkpoint_secs(),
-                                      params.per_rank_dir(),
-                                      params.ckpt_dist_epochs(),
-                                      params.ckpt_dist_steps());
+  auto cb = std::make_unique<checkpoint>(params.checkpoint_dir(),
+                                         params.restart_dir(),
+                                         params.checkpoint_epochs(),
+                                         params.checkpoint_steps(),
+                                         params.checkpoint_secs(),
+                                         params.per_rank_dir(),
+                                         params.ckpt_dist_epochs(),
+                                         params.ckpt_dist_steps());
+  cb->set_async_writes(params.async_writes());
+  cb->set_aggregate_files(params.aggregate_files());
+  cb->set_parallel_restart(params.parallel_restart());
+  cb->set_incremental_weights(params.incremental_weights());
+  cb->set_resize_request_file(params.resize_request_file());
+  if (params.flush_interval() > 0) {
+    cb->set_flush_interval(params.flush_interval());
+  }
+  if (params.max_inflight_checkpoints() > 0) {
+    cb->set_max_inflight_checkpoints(params.max_inflight_checkpoints());
+  }
+  return cb;
 }
 
 } // namespace callback
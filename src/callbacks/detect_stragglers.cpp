@@ -0,0 +1,372 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/detect_stragglers.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/layers/layer.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/system_info.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+namespace {
+
+/** Steps after which device events are resolved. They have almost
+ *  always completed by then, so resolving them does not stall. */
+constexpr size_t device_event_lag = 2;
+
+/** Bytes of a host name gathered to the world master. */
+constexpr int host_name_length = 64;
+
+#ifdef LBANN_HAS_GPU
+/** Stream that layers compute on */
+auto get_compute_stream()
+{
+#if defined LBANN_HAS_CUDA
+  return hydrogen::cuda::GetDefaultStream();
+#elif defined LBANN_HAS_ROCM
+  return hydrogen::rocm::GetDefaultStream();
+#endif
+}
+#endif // LBANN_HAS_GPU
+
+double median(std::vector<double> values)
+{
+  if (values.empty()) {
+    return 0.;
+  }
+  auto mid = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), mid, values.end());
+  return *mid;
+}
+
+} // namespace
+
+detect_stragglers&
+detect_stragglers::operator=(const detect_stragglers& other)
+{
+  callback_base::operator=(other);
+  m_interval = other.m_interval;
+  m_threshold = other.m_threshold;
+  m_persistence = other.m_persistence;
+  m_layers = other.m_layers;
+  m_layer_slots.clear();
+  m_layer_names.clear();
+  m_window.clear();
+  m_host_start.clear();
+  m_step = 0;
+  m_hosts.clear();
+  m_gpus.clear();
+  m_strikes.clear();
+#ifdef LBANN_HAS_GPU
+  m_open.clear();
+  m_pending.clear();
+  m_free_events.clear();
+#endif // LBANN_HAS_GPU
+  return *this;
+}
+
+void detect_stragglers::setup(model* m)
+{
+  auto* comm = m->get_comm();
+  const auto& world = comm->get_world_comm();
+
+  // Slot 0 is the step's compute, then one slot per layer
+  m_layer_slots.clear();
+  m_layer_names.clear();
+  m_step_on_device = false;
+  for (const auto* l : m->get_layers()) {
+    if (m_layers) {
+      m_layer_slots[l] = 1 + m_layer_names.size();
+      m_layer_names.push_back(l->get_name());
+    }
+#ifdef LBANN_HAS_GPU
+    m_step_on_device = m_step_on_device || l->using_gpus();
+#endif // LBANN_HAS_GPU
+  }
+  if (m_layers) {
+    const int num_layers = m_layer_names.size();
+    if (comm->allreduce(num_layers, world, El::mpi::MIN) !=
+        comm->allreduce(num_layers, world, El::mpi::MAX)) {
+      LBANN_ERROR("detect_stragglers with layers needs every model to "
+                  "have the same layers");
+    }
+  }
+  const size_t num_slots = 1 + m_layer_names.size();
+  m_window.assign(num_slots, 0.);
+  m_host_start.assign(num_slots, 0.);
+  m_step = 0;
+#ifdef LBANN_HAS_GPU
+  m_open.clear();
+  m_open.resize(num_slots);
+  m_pending.clear();
+#endif // LBANN_HAS_GPU
+
+  // Gather where each rank runs, to report stragglers by node
+  std::vector<El::byte> host(host_name_length, 0);
+  const auto name = utils::SystemInfo().host_name();
+  const size_t length = std::min(name.size(), host.size() - 1);
+  std::copy_n(name.begin(), length, host.begin());
+  int gpu = -1;
+#ifdef LBANN_HAS_GPU
+  gpu = hydrogen::gpu::DefaultDevice();
+#endif // LBANN_HAS_GPU
+  if (comm->am_world_master()) {
+    const int num_ranks = comm->get_procs_in_world();
+    std::vector<El::byte> hosts(host_name_length * num_ranks);
+    comm->gather(host.data(), host_name_length, hosts.data(), world);
+    m_gpus.resize(num_ranks);
+    comm->gather(gpu, m_gpus.data(), world);
+    m_hosts.clear();
+    for (int r = 0; r < num_ranks; ++r) {
+      m_hosts.emplace_back(
+        reinterpret_cast<const char*>(&hosts[r * host_name_length]));
+    }
+    m_strikes.assign(num_ranks, 0);
+  }
+  else {
+    comm->gather(host.data(), host_name_length, 0, world);
+    comm->gather(gpu, 0, world);
+  }
+}
+
+void detect_stragglers::on_forward_prop_begin(model* m)
+{
+  begin_interval(0, m_step_on_device);
+}
+
+void detect_stragglers::on_backward_prop_end(model* m)
+{
+  end_interval(0, m_step_on_device);
+}
+
+void detect_stragglers::on_forward_prop_begin(model* m, Layer* l)
+{
+  if (m_layers) {
+    begin_interval(m_layer_slots.at(l), l->using_gpus());
+  }
+}
+
+void detect_stragglers::on_forward_prop_end(model* m, Layer* l)
+{
+  if (m_layers) {
+    end_interval(m_layer_slots.at(l), l->using_gpus());
+  }
+}
+
+void detect_stragglers::on_backward_prop_begin(model* m, Layer* l)
+{
+  if (m_layers) {
+    begin_interval(m_layer_slots.at(l), l->using_gpus());
+  }
+}
+
+void detect_stragglers::on_backward_prop_end(model* m, Layer* l)
+{
+  if (m_layers) {
+    end_interval(m_layer_slots.at(l), l->using_gpus());
+  }
+}
+
+void detect_stragglers::on_batch_end(model* m)
+{
+  ++m_step;
+  if (m_step > device_event_lag) {
+    resolve_device_intervals(m_step - device_event_lag);
+  }
+  if (m_step % m_interval == 0) {
+    compare(*m);
+  }
+}
+
+void detect_stragglers::on_train_end(model* m)
+{
+  resolve_device_intervals(std::numeric_limits<size_t>::max());
+}
+
+void detect_stragglers::begin_interval(size_t slot, bool device)
+{
+#ifdef LBANN_HAS_GPU
+  if (device) {
+    auto get_event = [&]() {
+      if (m_free_events.empty()) {
+        return std::make_unique<gpu_lib::event_wrapper>(true);
+      }
+      auto event = std::move(m_free_events.back());
+      m_free_events.pop_back();
+      return event;
+    };
+    auto& interval = m_open[slot];
+    interval.slot = slot;
+    interval.step = m_step;
+    interval.start = get_event();
+    interval.end = get_event();
+    interval.start->record(get_compute_stream());
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  m_host_start[slot] = get_time();
+}
+
+void detect_stragglers::end_interval(size_t slot, bool device)
+{
+#ifdef LBANN_HAS_GPU
+  if (device) {
+    auto& interval = m_open[slot];
+    if (interval.start == nullptr) {
+      LBANN_ERROR("device interval ended before it began");
+    }
+    interval.end->record(get_compute_stream());
+    m_pending.push_back(std::move(interval));
+    interval = device_interval();
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  m_window[slot] += get_time() - m_host_start[slot];
+}
+
+void detect_stragglers::resolve_device_intervals(size_t step)
+{
+#ifdef LBANN_HAS_GPU
+  while (!m_pending.empty() && m_pending.front().step < step) {
+    auto& interval = m_pending.front();
+    interval.end->synchronize();
+    const auto ms = interval.end->elapsed_time(*interval.start);
+    m_window[interval.slot] += ms / 1e3;
+    m_free_events.push_back(std::move(interval.start));
+    m_free_events.push_back(std::move(interval.end));
+    m_pending.pop_front();
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void detect_stragglers::compare(model& m)
+{
+  auto* comm = m.get_comm();
+  const auto& world = comm->get_world_comm();
+  const int num_slots = m_window.size();
+  if (!comm->am_world_master()) {
+    comm->gather(m_window.data(), num_slots, 0, world);
+    std::fill(m_window.begin(), m_window.end(), 0.);
+    return;
+  }
+  const int num_ranks = comm->get_procs_in_world();
+  std::vector<double> times(num_slots * num_ranks);
+  comm->gather(m_window.data(), num_slots, times.data(), world);
+  std::fill(m_window.begin(), m_window.end(), 0.);
+
+  // Medians over the ranks, by slot
+  std::vector<double> medians(num_slots);
+  std::vector<double> values(num_ranks);
+  for (int s = 0; s < num_slots; ++s) {
+    for (int r = 0; r < num_ranks; ++r) {
+      values[r] = times[r * num_slots + s];
+    }
+    medians[s] = median(values);
+  }
+  if (medians[0] <= 0.) {
+    return;
+  }
+
+  for (int r = 0; r < num_ranks; ++r) {
+    const double* rank_times = &times[r * num_slots];
+    auto& strikes = m_strikes[r];
+    if (rank_times[0] <= medians[0] * (1. + m_threshold)) {
+      strikes = 0;
+      continue;
+    }
+    // Report when a rank first persists, then every persistence
+    // intervals while it still does
+    ++strikes;
+    if (strikes < m_persistence || strikes % m_persistence != 0) {
+      continue;
+    }
+    std::ostringstream msg;
+    msg << std::fixed << std::setprecision(3) << "detect stragglers: rank "
+        << r << " (trainer " << comm->map_world_rank_to_trainer_rank(r)
+        << ", host " << m_hosts[r];
+    if (m_gpus[r] >= 0) {
+      msg << ", GPU " << m_gpus[r];
+    }
+    msg << ") computed for " << rank_times[0] << " s in the last "
+        << m_interval << " steps, " << std::setprecision(0)
+        << 100. * (rank_times[0] / medians[0] - 1.)
+        << "% above the median of " << std::setprecision(3) << medians[0]
+        << " s, for " << strikes << " intervals";
+    int slowest = 0;
+    double slowest_ratio = 1.;
+    for (int s = 1; s < num_slots; ++s) {
+      if (medians[s] > 0. && rank_times[s] / medians[s] > slowest_ratio) {
+        slowest = s;
+        slowest_ratio = rank_times[s] / medians[s];
+      }
+    }
+    if (slowest > 0) {
+      msg << "; slowest layer " << m_layer_names[slowest - 1] << " ("
+          << std::setprecision(0) << 100. * (slowest_ratio - 1.)
+          << "% above its median)";
+    }
+    std::cout << msg.str() << std::endl;
+  }
+}
+
+void detect_stragglers::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_detect_stragglers();
+  msg->set_batch_interval(m_interval);
+  msg->set_threshold(m_threshold);
+  msg->set_persistence(m_persistence);
+  msg->set_layers(m_layers);
+}
+
+std::unique_ptr<callback_base> build_detect_stragglers_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackDetectStragglers&>(
+      proto_msg);
+  return std::make_unique<detect_stragglers>(
+    params.batch_interval() > 0 ? params.batch_interval() : 100,
+    params.threshold() > 0. ? params.threshold() : 0.1,
+    params.persistence() > 0 ? params.persistence() : 3,
+    params.layers());
+}
+
+} // namespace callback
+} // namespace lbann
@@ -39,10 +39,29 @@
 namespace lbann {
 namespace callback {
 
-early_stopping::early_stopping(int64_t patience)
-  : callback_base(), m_patience(patience)
+early_stopping::early_stopping(int64_t patience, bool restore_best)
+  : callback_base(), m_patience(patience), m_restore_best(restore_best)
 {}
 
+early_stopping::early_stopping(const early_stopping& other)
+  : callback_base(other),
+    m_patience(other.m_patience),
+    m_last_score(other.m_last_score),
+    m_wait(other.m_wait),
+    m_restore_best(other.m_restore_best)
+{}
+
+early_stopping& early_stopping::operator=(const early_stopping& other)
+{
+  callback_base::operator=(other);
+  m_patience = other.m_patience;
+  m_last_score = other.m_last_score;
+  m_wait = other.m_wait;
+  m_restore_best = other.m_restore_best;
+  m_best_weights.reset();
+  return *this;
+}
+
 early_stopping::early_stopping() : early_stopping(0) {}
 
 template <class Archive>
@@ -59,6 +78,7 @@ void early_stopping::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_early_stopping();
   msg->set_patience(m_patience);
+  msg->set_restore_best(m_restore_best);
 }
 
 /// Monitor the objective function to see if the validation score
@@ -76,6 +96,12 @@ void early_stopping::on_validation_end(model* m)
     }
     m_last_score = score;
     m_wait = 0;
+    if (m_restore_best) {
+      if (m_best_weights == nullptr) {
+        m_best_weights = std::make_unique<weights_snapshot>();
+      }
+      m->take_weights_snapshot(*m_best_weights);
+    }
   }
   else {
     if (m_wait >= m_patience) {
@@ -86,6 +112,9 @@ void early_stopping::on_validation_end(model* m)
                   << " score and " << m_last_score << " last score"
                   << std::endl;
       }
+      if (m_best_weights != nullptr) {
+        m->restore_weights_snapshot(*m_best_weights);
+      }
     }
     else {
       ++m_wait;
@@ -99,7 +128,8 @@ std::unique_ptr<callback_base> build_early_stopping_callback_from_pbuf(
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackEarlyStopping&>(proto_msg);
-  return std::make_unique<early_stopping>(params.patience());
+  return std::make_unique<early_stopping>(params.patience(),
+                                          params.restore_best());
 }
 
 } // namespace callback
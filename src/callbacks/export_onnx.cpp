@@ -28,6 +28,8 @@
 
 #include "lbann/callbacks/export_onnx.hpp"
 
+#include "lbann/utils/file_utils.hpp"
+
 #include "lbann/proto/callbacks.pb.h"
 
 #include <fstream>
@@ -42,7 +44,17 @@ void export_onnx::on_train_end(model* m)
   auto const rank = m->get_comm()->get_rank_in_trainer();
 
   onnx::ModelProto mp;
-  m->serialize_to_onnx(mp);
+  if (m_external_data) {
+    // Only the graph is gathered on the master: each weights is
+    // written by a different rank, and the model refers to the files
+    m->serialize_to_onnx(mp,
+                         m_output_filename + ".data",
+                         file::extract_base_name(m_output_filename) +
+                           ".data");
+  }
+  else {
+    m->serialize_to_onnx(mp);
+  }
 
   if (rank == 0) {
     std::ofstream onnx_out(m_output_filename);
@@ -60,6 +72,7 @@ void export_onnx::write_specific_proto(lbann_data::Callback& proto) const
   auto* msg = proto.mutable_export_onnx();
   msg->set_output_filename(m_output_filename);
   msg->set_debug_string_filename(m_debug_string_filename);
+  msg->set_external_data(m_external_data);
 }
 
 std::unique_ptr<callback_base>
@@ -69,7 +82,8 @@ build_export_onnx_callback_from_pbuf(const google::protobuf::Message& proto_msg,
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackExportOnnx&>(proto_msg);
   return std::make_unique<export_onnx>(params.output_filename(),
-                                       params.debug_string_filename());
+                                       params.debug_string_filename(),
+                                       params.external_data());
 }
 } // namespace callback
 } // namespace lbann
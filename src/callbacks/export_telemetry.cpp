@@ -0,0 +1,153 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/export_telemetry.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/telemetry.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace lbann {
+namespace callback {
+
+void export_telemetry::setup(model* m)
+{
+  if (m->get_comm()->am_trainer_master()) {
+    file::make_directory(m_directory);
+  }
+  set_telemetry_enabled(true);
+}
+
+void export_telemetry::on_batch_end(model* m)
+{
+  if (m->get_execution_context().get_step() % m_interval == 0) {
+    export_values(*m);
+  }
+}
+
+void export_telemetry::on_epoch_end(model* m) { export_values(*m); }
+
+void export_telemetry::on_train_end(model* m) { export_values(*m); }
+
+void export_telemetry::export_values(model& m)
+{
+  // Sum or take the maximum of each value over the trainer
+  auto* comm = m.get_comm();
+  const auto local = read_telemetry();
+  telemetry_snapshot sums, maxima;
+  comm->allreduce(local.data(),
+                  static_cast<int>(local.size()),
+                  sums.data(),
+                  comm->get_trainer_comm(),
+                  El::mpi::SUM);
+  comm->allreduce(local.data(),
+                  static_cast<int>(local.size()),
+                  maxima.data(),
+                  comm->get_trainer_comm(),
+                  El::mpi::MAX);
+  if (!comm->am_trainer_master()) {
+    return;
+  }
+  telemetry_snapshot values;
+  for (size_t i = 0; i < num_telemetry_values; ++i) {
+    const bool sum = get_telemetry_info(static_cast<telemetry_value>(i)).sum;
+    values[i] = (sum ? sums[i] : maxima[i]);
+  }
+
+  const auto trainer = std::to_string(comm->get_trainer_rank());
+  const std::string base = m_directory + "/telemetry.m" + trainer;
+  if (m_prometheus) {
+    // Replace the file so readers never see a partial export
+    const std::string path = base + ".prom";
+    const std::string tmp_path = path + ".tmp";
+    {
+      std::ofstream f(tmp_path);
+      write_telemetry_prometheus(f,
+                                 values,
+                                 "lbann_",
+                                 "trainer=\"" + trainer + "\"");
+      if (!f) {
+        LBANN_ERROR("failed to write telemetry to ", tmp_path);
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      LBANN_ERROR("failed to rename ", tmp_path, " to ", path);
+    }
+  }
+  if (m_json_lines) {
+    const auto& c =
+      static_cast<const SGDExecutionContext&>(m.get_execution_context());
+    const auto now = std::chrono::duration<double>(
+      std::chrono::system_clock::now().time_since_epoch());
+    std::ostringstream fields;
+    fields.precision(15);
+    fields << "\"time\":" << now.count() << ",\"trainer\":" << trainer
+           << ",\"epoch\":" << c.get_epoch() << ",\"step\":" << c.get_step();
+    std::ofstream f(base + ".jsonl", std::ios::app);
+    write_telemetry_json(f, values, fields.str());
+    if (!f) {
+      LBANN_ERROR("failed to write telemetry to ", base, ".jsonl");
+    }
+  }
+}
+
+void export_telemetry::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_export_telemetry();
+  msg->set_batch_interval(m_interval);
+  msg->set_directory(m_directory);
+  msg->set_prometheus(m_prometheus);
+  msg->set_json_lines(m_json_lines);
+}
+
+std::unique_ptr<callback_base> build_export_telemetry_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackExportTelemetry&>(
+      proto_msg);
+  // Prometheus text unless a format is chosen
+  const bool prometheus = params.prometheus() || !params.json_lines();
+  return std::make_unique<export_telemetry>(
+    params.batch_interval(),
+    params.directory().empty() ? "." : params.directory(),
+    prometheus,
+    params.json_lines());
+}
+
+} // namespace callback
+} // namespace lbann
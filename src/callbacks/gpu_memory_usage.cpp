@@ -30,6 +30,7 @@
 #include "lbann/models/model.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/serialize.hpp"
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 
@@ -68,12 +69,16 @@ template <class Archive>
 void gpu_memory_usage::serialize(Archive& ar)
 {
   ar(::cereal::make_nvp("BaseCallback",
-                        ::cereal::base_class<callback_base>(this)));
+                        ::cereal::base_class<callback_base>(this)),
+     CEREAL_NVP(m_phase_high_water),
+     CEREAL_NVP(m_trim_pool));
 }
 
 void gpu_memory_usage::write_specific_proto(lbann_data::Callback& proto) const
 {
-  proto.mutable_gpu_memory_usage();
+  auto* msg = proto.mutable_gpu_memory_usage();
+  msg->set_phase_high_water(m_phase_high_water);
+  msg->set_trim_pool(m_trim_pool);
 }
 
 void gpu_memory_usage::on_epoch_begin(model* m)
@@ -106,6 +111,92 @@ void gpu_memory_usage::on_epoch_begin(model* m)
     comm->trainer_gather(used, comm->get_trainer_master());
   }
 #endif
+  report_high_water(m);
+}
+
+void gpu_memory_usage::on_forward_prop_end(model* m, Layer* l)
+{
+  sample(FORWARD_PROP);
+}
+
+void gpu_memory_usage::on_backward_prop_end(model* m, Layer* l)
+{
+  sample(BACKWARD_PROP);
+}
+
+void gpu_memory_usage::on_optimize_end(model* m, weights* w)
+{
+  sample(OPTIMIZER);
+}
+
+void gpu_memory_usage::on_validation_begin(model* m) { trim(); }
+void gpu_memory_usage::on_validation_end(model* m) { trim(); }
+void gpu_memory_usage::on_test_begin(model* m) { trim(); }
+void gpu_memory_usage::on_test_end(model* m) { trim(); }
+
+void gpu_memory_usage::sample(phase p)
+{
+#ifdef LBANN_HAS_GPU
+  if (m_phase_high_water) {
+    m_high_water[p] =
+      std::max(m_high_water[p], gpu_lib::get_memory_pool_usage().live_bytes);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void gpu_memory_usage::report_high_water(model* m)
+{
+#ifdef LBANN_HAS_GPU
+  if (!m_phase_high_water) {
+    return;
+  }
+  auto comm = m->get_comm();
+  std::array<double, NUM_PHASES + 2> local, gib;
+  const auto usage = gpu_lib::get_memory_pool_usage();
+  const auto pool_size = usage.live_bytes + usage.cached_bytes;
+  for (size_t i = 0; i < NUM_PHASES; ++i) {
+    local[i] = m_high_water[i] / 1024.0 / 1024.0 / 1024.0;
+  }
+  local[NUM_PHASES] = usage.cached_bytes / 1024.0 / 1024.0 / 1024.0;
+  local[NUM_PHASES + 1] =
+    (pool_size > 0 ? 100.0 * usage.cached_bytes / pool_size : 0.0);
+  comm->trainer_allreduce(local.data(),
+                          static_cast<int>(local.size()),
+                          gib.data(),
+                          El::mpi::MAX);
+  if (comm->am_trainer_master()) {
+    std::cout << "Model " << comm->get_trainer_rank()
+              << " GPU memory pool high-water marks (max over ranks) : "
+              << std::setprecision(3) << gib[FORWARD_PROP]
+              << " GiB forward prop, " << std::setprecision(3)
+              << gib[BACKWARD_PROP] << " GiB backprop, "
+              << std::setprecision(3) << gib[OPTIMIZER]
+              << " GiB optimizer; " << std::setprecision(3)
+              << gib[NUM_PHASES] << " GiB cached (" << std::setprecision(3)
+              << gib[NUM_PHASES + 1] << "% of the pool)" << std::endl;
+  }
+  m_high_water.fill(0);
+#endif // LBANN_HAS_GPU
+}
+
+void gpu_memory_usage::trim()
+{
+#ifdef LBANN_HAS_GPU
+  if (m_trim_pool) {
+    gpu_lib::trim_memory_pool();
+  }
+#endif // LBANN_HAS_GPU
+}
+
+std::unique_ptr<callback_base> build_gpu_memory_usage_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackGPUMemoryUsage&>(
+      proto_msg);
+  return std::make_unique<gpu_memory_usage>(params.phase_high_water(),
+                                            params.trim_pool());
 }
 
 } // namespace callback
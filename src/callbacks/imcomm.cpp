@@ -32,6 +32,7 @@
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/optimizer_impl.hpp"
+#include "lbann/proto/proto_common.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/summary_impl.hpp"
 #include "lbann/utils/timer.hpp"
@@ -39,12 +40,199 @@
 
 #include "lbann/proto/callbacks.pb.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <tuple>
 #include <typeindex>
 #include <typeinfo>
 
 namespace lbann {
 namespace callback {
 
+namespace {
+
+#ifdef LBANN_HAS_HALF
+/** @brief Sum over trainers in half precision. */
+size_t fp16_sum(lbann_comm const& comm, CPUMat& gradient)
+{
+  const El::Int height = gradient.Height();
+  const El::Int width = gradient.Width();
+  std::vector<cpu_fp16> half(height * width);
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      half[row + col * height] = cpu_fp16(gradient(row, col));
+    }
+  }
+  El::mpi::AllReduce(half.data(),
+                     static_cast<int>(half.size()),
+                     comm.get_intertrainer_comm(),
+                     El::SyncInfo<El::Device::CPU>{});
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      gradient(row, col) = static_cast<DataType>(half[row + col * height]);
+    }
+  }
+  return half.size() * sizeof(cpu_fp16);
+}
+#endif // LBANN_HAS_HALF
+
+/** @brief Sum the largest entries over trainers.
+ *
+ *  Each trainer sends the indices and values of its largest entries,
+ *  after adding the entries it did not send before.
+ */
+size_t topk_sum(lbann_comm const& comm,
+                CPUMat& gradient,
+                CPUMat& error,
+                double fraction)
+{
+  const El::Int height = gradient.Height();
+  const El::Int width = gradient.Width();
+  const El::Int size = height * width;
+  if (size == 0) {
+    return 0;
+  }
+  if (error.Height() != height || error.Width() != width) {
+    El::Zeros(error, height, width);
+  }
+
+  // Pick the largest entries of the gradient with the error added
+  std::vector<DataType> acc(size);
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      acc[row + col * height] = gradient(row, col) + error(row, col);
+    }
+  }
+  const El::Int k = std::clamp(
+    static_cast<El::Int>(std::ceil(fraction * size)), El::Int(1), size);
+  std::vector<El::Int> indices(size);
+  std::iota(indices.begin(), indices.end(), El::Int(0));
+  std::nth_element(indices.begin(),
+                   indices.begin() + (k - 1),
+                   indices.end(),
+                   [&acc](El::Int a, El::Int b) {
+                     return std::abs(acc[a]) > std::abs(acc[b]);
+                   });
+  indices.resize(k);
+  std::vector<DataType> values(k);
+  for (El::Int i = 0; i < k; ++i) {
+    values[i] = acc[indices[i]];
+    acc[indices[i]] = DataType(0);
+  }
+  for (El::Int col = 0; col < width; ++col) {
+    for (El::Int row = 0; row < height; ++row) {
+      error(row, col) = acc[row + col * height];
+    }
+  }
+
+  // Gather and sum the entries of all trainers
+  const int num_trainers = comm.get_num_trainers();
+  std::vector<El::Int> all_indices(k * num_trainers);
+  std::vector<DataType> all_values(k * num_trainers);
+  El::mpi::AllGather(indices.data(),
+                     static_cast<int>(k),
+                     all_indices.data(),
+                     static_cast<int>(k),
+                     comm.get_intertrainer_comm(),
+                     El::SyncInfo<El::Device::CPU>{});
+  El::mpi::AllGather(values.data(),
+                     static_cast<int>(k),
+                     all_values.data(),
+                     static_cast<int>(k),
+                     comm.get_intertrainer_comm(),
+                     El::SyncInfo<El::Device::CPU>{});
+  El::Zero(gradient);
+  for (size_t i = 0; i < all_indices.size(); ++i) {
+    const El::Int pos = all_indices[i];
+    gradient(pos % height, pos / height) += all_values[i];
+  }
+  return k * (sizeof(El::Int) + sizeof(DataType));
+}
+
+/** @brief Orthonormalize the columns of a matrix with Gram-Schmidt. */
+void orthonormalize(CPUMat& mat)
+{
+  const El::Int height = mat.Height();
+  for (El::Int j = 0; j < mat.Width(); ++j) {
+    auto col = mat(El::ALL, El::IR(j));
+    for (El::Int i = 0; i < j; ++i) {
+      const auto prev = mat(El::ALL, El::IR(i));
+      El::Axpy(-El::Dot(prev, col), prev, col);
+    }
+    const DataType norm = El::Nrm2(col);
+    if (norm > DataType(0)) {
+      El::Scale(DataType(1) / norm, col);
+    }
+    else if (j < height) {
+      // Degenerate column, replace it with a unit vector
+      El::Zero(col);
+      col(j, 0) = DataType(1);
+    }
+  }
+}
+
+/** @brief Sum rank-r approximations over trainers.
+ *
+ *  One step of power iteration per mini-batch, warm-started from the
+ *  previous step. See Vogels et al. "PowerSGD: Practical Low-Rank
+ *  Gradient Compression for Distributed Optimization", 2019.
+ */
+size_t powersgd_sum(lbann_comm const& comm,
+                    CPUMat& gradient,
+                    CPUMat& error,
+                    CPUMat& q,
+                    El::Int rank)
+{
+  const El::Int height = gradient.Height();
+  const El::Int width = gradient.Width();
+  const auto& intertrainer_comm = comm.get_intertrainer_comm();
+
+  // Compression does not pay off for small or vector-shaped tensors
+  if (std::min(height, width) <= rank) {
+    El::AllReduce(gradient, intertrainer_comm, El::mpi::SUM);
+    return height * width * sizeof(DataType);
+  }
+
+  // Gradient with the error added
+  if (error.Height() != height || error.Width() != width) {
+    El::Zeros(error, height, width);
+  }
+  CPUMat m;
+  El::Copy(gradient, m);
+  El::Axpy(DataType(1), error, m);
+
+  // Every trainer starts from the same random right factor
+  if (q.Height() != width || q.Width() != rank) {
+    q.Resize(width, rank);
+    std::mt19937 gen(static_cast<std::mt19937::result_type>(width * rank));
+    std::normal_distribution<DataType> dist;
+    for (El::Int col = 0; col < rank; ++col) {
+      for (El::Int row = 0; row < width; ++row) {
+        q(row, col) = dist(gen);
+      }
+    }
+  }
+
+  // p = orth(sum(m q)), q = sum(m^T p)
+  CPUMat p;
+  El::Gemm(El::NORMAL, El::NORMAL, DataType(1), m, q, p);
+  El::AllReduce(p, intertrainer_comm, El::mpi::SUM);
+  orthonormalize(p);
+  El::Gemm(El::TRANSPOSE, El::NORMAL, DataType(1), m, p, q);
+  El::AllReduce(q, intertrainer_comm, El::mpi::SUM);
+
+  // The sum over trainers is approximated by p q^T, so each trainer
+  // keeps its share of the difference
+  El::Gemm(El::NORMAL, El::TRANSPOSE, DataType(1), p, q, gradient);
+  El::Copy(m, error);
+  El::Axpy(DataType(-1) / DataType(comm.get_num_trainers()), gradient, error);
+  return (height + width) * rank * sizeof(DataType);
+}
+
+} // namespace
+
 imcomm::imcomm(imcomm::comm_type ct,
                const std::shared_ptr<lbann_summary>& summarizer)
   : m_default_ct(ct), m_summarizer(summarizer)
@@ -67,10 +255,37 @@ void imcomm::set_weights_comm(weights* w, comm_type ct)
   m_weights_params[w].ct = ct;
 }
 
+void imcomm::set_weights_comm(std::string const& name, comm_type ct)
+{
+  m_weights_names_ct[name] = ct;
+}
+
+void imcomm::set_topk_fraction(double fraction)
+{
+  if (!(fraction > 0. && fraction <= 1.)) {
+    LBANN_ERROR("imcomm: top-k fraction must be in (0,1], got ", fraction);
+  }
+  m_topk_fraction = fraction;
+}
+
+void imcomm::set_powersgd_rank(El::Int rank)
+{
+  if (rank < 1) {
+    LBANN_ERROR("imcomm: PowerSGD rank must be positive, got ", rank);
+  }
+  m_powersgd_rank = rank;
+}
+
 void imcomm::setup(model* m)
 {
   for (weights* w : m->get_weights()) {
 
+    // Apply comm types chosen by name
+    const auto name_ct = m_weights_names_ct.find(w->get_name());
+    if (name_ct != m_weights_names_ct.end()) {
+      set_weights_comm(w, name_ct->second);
+    }
+
     // Add weights if not already in list
     if (m_weights_params.find(w) == m_weights_params.end()) {
       m_weights_params[w] = {};
@@ -85,6 +300,13 @@ void imcomm::setup(model* m)
           w->get_name(),
           ", which has no optimizer");
       }
+#ifndef LBANN_HAS_HALF
+      if (params.ct == FP16) {
+        LBANN_ERROR("imcomm: fp16 communication of ",
+                    w->get_name(),
+                    " requires half-precision support");
+      }
+#endif // LBANN_HAS_HALF
     }
   }
 }
@@ -122,24 +344,78 @@ void imcomm::on_backward_prop_end(model* m)
     auto& real_opt = dynamic_cast<data_type_optimizer<DataType>&>(*opt);
     auto gradient = to_unique_ptr(real_opt.get_gradient().Copy());
     auto& local_gradients = gradient->Matrix();
+    size_t bytes_sent =
+      sizeof(DataType) * local_gradients.Height() * local_gradients.Width();
+    size_t bytes_received = bytes_sent;
     switch (params.ct) {
     case NORMAL:
       comm->intertrainer_sum_matrix(local_gradients);
       break;
+    case FP16:
+    case TOPK:
+    case POWERSGD: {
+      CPUMat cpu_gradients;
+      El::Copy(local_gradients, cpu_gradients);
+      std::tie(bytes_sent, bytes_received) =
+        compressed_sum(*comm, params, cpu_gradients);
+      El::Copy(cpu_gradients, local_gradients);
+      break;
+    }
     default:
       LBANN_ERROR("imcomm: unknown comm type");
     }
     real_opt.clear_gradient();
     real_opt.add_to_gradient(*gradient);
     EvalType im_time = get_time() - start_time;
-    do_summary(*m, real_w, im_time);
+    do_summary(*m, real_w, im_time, bytes_sent, bytes_received);
   }
 }
 
+std::pair<size_t, size_t> imcomm::compressed_sum(lbann_comm const& comm,
+                                                 imcomm_params& params,
+                                                 CPUMat& gradient) const
+{
+  switch (params.ct) {
+#ifdef LBANN_HAS_HALF
+  case FP16: {
+    const size_t bytes = fp16_sum(comm, gradient);
+    return {bytes, bytes};
+  }
+#endif // LBANN_HAS_HALF
+  case TOPK: {
+    // Every other trainer sends as many entries
+    const size_t bytes =
+      topk_sum(comm, gradient, params.error, m_topk_fraction);
+    return {bytes, bytes * (comm.get_num_trainers() - 1)};
+  }
+  case POWERSGD: {
+    const size_t bytes = powersgd_sum(comm,
+                                      gradient,
+                                      params.error,
+                                      params.q,
+                                      m_powersgd_rank);
+    return {bytes, bytes};
+  }
+  default:
+    LBANN_ERROR("imcomm: ",
+                get_comm_type_name(params.ct),
+                " is not a compressed comm type");
+  }
+  return {0, 0};
+}
+
 void imcomm::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_imcomm();
   msg->set_intertrainer_comm_method(get_comm_type_name(m_default_ct));
+  std::string weights_comm_methods;
+  for (auto const& [name, ct] : m_weights_names_ct) {
+    weights_comm_methods += (weights_comm_methods.empty() ? "" : " ");
+    weights_comm_methods += name + ":" + get_comm_type_name(ct);
+  }
+  msg->set_weights_comm_methods(weights_comm_methods);
+  msg->set_topk_fraction(m_topk_fraction);
+  msg->set_powersgd_rank(m_powersgd_rank);
   // Unused
   // msg->set_all_optimizers(bool_value);
 }
@@ -147,7 +423,9 @@ void imcomm::write_specific_proto(lbann_data::Callback& proto) const
 template <typename TensorDataType>
 void imcomm::do_summary(model const& m,
                         data_type_weights<TensorDataType>& w,
-                        EvalType im_time)
+                        EvalType im_time,
+                        size_t bytes_sent,
+                        size_t bytes_received)
 {
   if (m_summarizer == nullptr) {
     return;
@@ -157,16 +435,18 @@ void imcomm::do_summary(model const& m,
   m_summarizer->reduce_scalar(prefix + "time", im_time, c.get_step());
   // Use the same approximation the comm layer does.
   auto const& local_gradients =
-    static_cast<const El::Matrix<TensorDataType, El::Device::CPU>&>(
-      w.get_optimizer()->get_gradient().LockedMatrix());
-  size_t bytes_sent =
-    sizeof(DataType) * local_gradients.Height() * local_gradients.Width();
-  size_t bytes_received =
+    w.get_optimizer()->get_gradient().LockedMatrix();
+  const size_t bytes_uncompressed =
     sizeof(DataType) * local_gradients.Height() * local_gradients.Width();
+  const size_t bytes_saved =
+    (bytes_uncompressed > bytes_sent ? bytes_uncompressed - bytes_sent : 0);
   m_summarizer->reduce_scalar(prefix + "bytes_sent", bytes_sent, c.get_step());
   m_summarizer->reduce_scalar(prefix + "bytes_received",
                               bytes_received,
                               c.get_step());
+  m_summarizer->reduce_scalar(prefix + "bytes_saved",
+                              bytes_saved,
+                              c.get_step());
 }
 
 /* Returns a string representation of the weight_initialization */
@@ -177,30 +457,58 @@ std::string get_comm_type_name(typename imcomm::comm_type m)
     return "none";
   case imcomm::NORMAL:
     return "normal";
+  case imcomm::FP16:
+    return "fp16";
+  case imcomm::TOPK:
+    return "topk";
+  case imcomm::POWERSGD:
+    return "powersgd";
   default:
     LBANN_ERROR("Unknown value for comm_type");
   }
 }
 
+typename imcomm::comm_type get_comm_type(std::string const& name)
+{
+  for (auto ct :
+       {imcomm::NONE, imcomm::NORMAL, imcomm::FP16, imcomm::TOPK,
+        imcomm::POWERSGD}) {
+    if (name == get_comm_type_name(ct)) {
+      return ct;
+    }
+  }
+  LBANN_ERROR("invalid inter-model communication type (", name, ")");
+  return imcomm::NONE;
+}
+
 std::unique_ptr<callback_base> build_imcomm_callback_from_pbuf(
   const google::protobuf::Message& proto_msg,
   const std::shared_ptr<lbann_summary>& summarizer)
 {
   using param_msg_type = lbann_data::Callback::CallbackImComm;
   const auto& params = dynamic_cast<const param_msg_type&>(proto_msg);
-  const auto& type_str = params.intertrainer_comm_method();
-  typename imcomm::comm_type type = imcomm::comm_type::NONE;
-  if (type_str == "none") {
-    type = imcomm::comm_type::NONE;
+  const auto type = get_comm_type(params.intertrainer_comm_method());
+  std::unordered_set<weights*> selected_weights; /// @todo Initialize weights
+  auto cb = std::make_unique<imcomm>(type, selected_weights, summarizer);
+  // Entries are "name:method"
+  for (auto const& entry :
+       parse_list<std::string>(params.weights_comm_methods())) {
+    const auto colon = entry.rfind(':');
+    if (colon == std::string::npos) {
+      LBANN_ERROR("imcomm: expected weights_comm_methods entries of the ",
+                  "form name:method, got ",
+                  entry);
+    }
+    cb->set_weights_comm(entry.substr(0, colon),
+                         get_comm_type(entry.substr(colon + 1)));
   }
-  else if (type_str == "normal") {
-    type = imcomm::comm_type::NORMAL;
+  if (params.topk_fraction() != 0.) {
+    cb->set_topk_fraction(params.topk_fraction());
   }
-  else {
-    LBANN_ERROR("invalid inter-model communication type (", type_str, ")");
+  if (params.powersgd_rank() != 0) {
+    cb->set_powersgd_rank(params.powersgd_rank());
   }
-  std::unordered_set<weights*> selected_weights; /// @todo Initialize weights
-  return std::make_unique<imcomm>(type, selected_weights, summarizer);
+  return cb;
 }
 
 } // namespace callback
@@ -107,13 +107,14 @@ void learning_rate::on_epoch_end(model* m)
 
 void learning_rate::on_backward_prop_end(model* m)
 {
+  if (!this->has_optimizer_schedule()) {
+    return;
+  }
+  // Set without comparing to the current learning rate, which may
+  // only be readable by waiting for the device
   for (weights* w : this->get_weights()) {
     auto& opt = *w->get_optimizer();
-    const float old_lr = opt.get_learning_rate();
-    const float new_lr = optimizer_schedule(m, opt);
-    if (old_lr != new_lr) {
-      opt.set_learning_rate(new_lr);
-    }
+    opt.set_learning_rate(optimizer_schedule(m, opt));
   }
 }
 
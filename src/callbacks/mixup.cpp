@@ -34,6 +34,8 @@
 #include "lbann/utils/protobuf.hpp"
 #include "lbann/utils/serialize.hpp"
 #include <algorithm>
+#include <cmath>
+#include <numeric>
 
 #include "lbann/proto/callbacks.pb.h"
 
@@ -42,8 +44,8 @@
 namespace lbann {
 namespace callback {
 
-mixup::mixup(std::unordered_set<std::string> layers, float alpha)
-  : callback_base(), m_layers(layers), m_alpha(alpha)
+mixup::mixup(std::unordered_set<std::string> layers, float alpha, bool cutmix)
+  : callback_base(), m_layers(layers), m_alpha(alpha), m_cutmix(cutmix)
 {
   if (alpha < 0.0f) {
     LBANN_ERROR("Mixup alpha must be non-negative.");
@@ -58,7 +60,8 @@ void mixup::serialize(Archive& ar)
   ar(::cereal::make_nvp("BaseCallback",
                         ::cereal::base_class<callback_base>(this)),
      CEREAL_NVP(m_layers),
-     CEREAL_NVP(m_alpha));
+     CEREAL_NVP(m_alpha),
+     CEREAL_NVP(m_cutmix));
 }
 
 void mixup::write_specific_proto(lbann_data::Callback& proto) const
@@ -66,6 +69,63 @@ void mixup::write_specific_proto(lbann_data::Callback& proto) const
   auto* msg = proto.mutable_mixup();
   msg->set_layers(protobuf::to_space_sep_string(m_layers));
   msg->set_alpha(m_alpha);
+  msg->set_cutmix(m_cutmix);
+}
+
+void mixup::draw_parameters(El::Int mbsize, El::Int height, El::Int width)
+{
+#ifdef LBANN_HAS_GPU
+  // The previous parameters may still be in flight to the device
+  if (m_copying) {
+    m_copy_event.synchronize();
+    m_copying = false;
+  }
+  if (m_indices.IsEmpty()) {
+    m_indices.SetMemoryMode(1);
+    m_lambdas.SetMemoryMode(1);
+  }
+#endif // LBANN_HAS_GPU
+  m_indices.Resize(5, mbsize);
+  m_lambdas.Resize(2, mbsize);
+  auto& gen = get_fast_generator();
+  beta_distribution<float> dist(m_alpha, m_alpha);
+
+  // Decide how to mix the mini-batch.
+  std::vector<El::Int> shuffled_indices(mbsize);
+  std::iota(shuffled_indices.begin(), shuffled_indices.end(), 0);
+  std::shuffle(shuffled_indices.begin(), shuffled_indices.end(), gen);
+
+  for (El::Int i = 0; i < mbsize; ++i) {
+    const El::Int j = shuffled_indices[i];
+    int* idx = m_indices.Buffer(0, i);
+    std::fill(idx, idx + 5, 0);
+    idx[0] = j;
+    m_lambdas(0, i) = El::TypeTraits<DataType>::One();
+    m_lambdas(1, i) = El::TypeTraits<DataType>::One();
+    if (i == j) {
+      continue;
+    }
+    float lambda = dist(gen);
+    if (!m_cutmix) {
+      lambda = std::max(lambda, 1.0f - lambda);
+      m_lambdas(0, i) = lambda;
+      m_lambdas(1, i) = lambda;
+      continue;
+    }
+    // Box covering a 1-lambda fraction of the sample, clipped to it
+    const float cut = std::sqrt(1.0f - lambda);
+    const El::Int cut_height = static_cast<El::Int>(height * cut);
+    const El::Int cut_width = static_cast<El::Int>(width * cut);
+    const El::Int center_row = fast_rand_int(gen, height);
+    const El::Int center_col = fast_rand_int(gen, width);
+    idx[1] = std::max(center_row - cut_height / 2, El::Int(0));
+    idx[2] = std::min(center_row + cut_height / 2, height);
+    idx[3] = std::max(center_col - cut_width / 2, El::Int(0));
+    idx[4] = std::min(center_col + cut_width / 2, width);
+    const float area =
+      static_cast<float>((idx[2] - idx[1]) * (idx[4] - idx[3]));
+    m_lambdas(1, i) = 1.0f - area / (height * width);
+  }
 }
 
 void mixup::on_forward_prop_end(model* m, Layer* l)
@@ -80,54 +140,104 @@ void mixup::on_forward_prop_end(model* m, Layer* l)
   }
 
   auto* dtl = dynamic_cast<data_type_layer<DataType>*>(l);
-  auto& samples_orig = dtl->get_local_activations(0);
-  auto& labels_orig = dtl->get_local_activations(1);
-  if (samples_orig.GetDevice() != El::Device::CPU ||
-      labels_orig.GetDevice() != El::Device::CPU) {
-    LBANN_ERROR("Mixup requires CPU data.");
+  auto& samples = dtl->get_local_activations(0);
+  auto& labels = dtl->get_local_activations(1);
+  if (samples.GetDevice() != labels.GetDevice()) {
+    LBANN_ERROR("mixup requires samples and labels on the same device");
   }
-  // Copy samples.
-  // Assumes data are on CPU.
-  CPUMat samples, labels;
-  El::Copy(samples_orig, samples);
-  El::Copy(labels_orig, labels);
-  El::Int mbsize = samples.Width();
+  const El::Int mbsize = samples.Width();
   const El::Int samples_height = samples.Height();
   const El::Int labels_height = labels.Height();
-  auto& gen = get_fast_generator();
-  beta_distribution<float> dist(m_alpha, m_alpha);
+  if (mbsize == 0) {
+    return;
+  }
 
-  // For now, data must be on the CPU.
-  if (samples.GetDevice() != El::Device::CPU ||
-      labels.GetDevice() != El::Device::CPU) {
-    LBANN_ERROR("mixup only works with CPU data");
+  // Boxes are drawn over the last two dimensions of the samples
+  El::Int height = 1, width = 1;
+  if (m_cutmix) {
+    const auto dims = l->get_output_dims(0);
+    if (dims.size() < 2) {
+      LBANN_ERROR("cutmix requires samples with at least two dimensions, "
+                  "but layer \"",
+                  l->get_name(),
+                  "\" outputs ",
+                  dims.size());
+    }
+    height = dims[dims.size() - 2];
+    width = dims[dims.size() - 1];
   }
+  draw_parameters(mbsize, height, width);
 
-  // Decide how to mix the mini-batch.
-  std::vector<El::Int> shuffled_indices(mbsize);
-  std::iota(shuffled_indices.begin(), shuffled_indices.end(), 0);
-  std::shuffle(shuffled_indices.begin(), shuffled_indices.end(), gen);
+#ifdef LBANN_HAS_GPU
+  if (samples.GetDevice() == El::Device::GPU) {
+    auto& gpu_samples = static_cast<GPUMat&>(samples);
+    auto& gpu_labels = static_cast<GPUMat&>(labels);
+    const auto sync = El::SyncInfoFromMatrix(gpu_samples);
+    m_device_indices.SetSyncInfo(sync);
+    m_device_lambdas.SetSyncInfo(sync);
+    m_device_samples_copy.SetSyncInfo(sync);
+    m_device_labels_copy.SetSyncInfo(sync);
+    m_device_indices.Resize(m_indices.Height(), mbsize);
+    m_device_lambdas.Resize(m_lambdas.Height(), mbsize);
+    gpu_lib::mem_copy_async(m_device_indices.Buffer(),
+                            m_indices.LockedBuffer(),
+                            m_indices.Height() * mbsize * sizeof(int),
+                            gpu_lib::GPU_MEMCPY_HOST_TO_DEVICE,
+                            sync.Stream());
+    gpu_lib::mem_copy_async(m_device_lambdas.Buffer(),
+                            m_lambdas.LockedBuffer(),
+                            m_lambdas.Height() * mbsize * sizeof(DataType),
+                            gpu_lib::GPU_MEMCPY_HOST_TO_DEVICE,
+                            sync.Stream());
+    m_copy_event.record(sync.Stream());
+    m_copying = true;
+    El::Copy(gpu_samples, m_device_samples_copy);
+    El::Copy(gpu_labels, m_device_labels_copy);
+    apply_mixup_gpu(m_device_samples_copy,
+                    m_device_labels_copy,
+                    gpu_samples,
+                    gpu_labels,
+                    m_device_indices,
+                    m_device_lambdas,
+                    height,
+                    width);
+    return;
+  }
+#endif // LBANN_HAS_GPU
 
+  auto& cpu_samples = static_cast<CPUMat&>(samples);
+  auto& cpu_labels = static_cast<CPUMat&>(labels);
+  El::Copy(cpu_samples, m_samples_copy);
+  El::Copy(cpu_labels, m_labels_copy);
+  const El::Int plane_size = height * width;
   LBANN_OMP_PARALLEL_FOR
   for (El::Int i = 0; i < mbsize; ++i) {
-    const El::Int j = shuffled_indices[i];
+    const int* idx = m_indices.LockedBuffer(0, i);
+    const El::Int j = idx[0];
     if (i == j) {
       continue;
     }
-    float lambda = dist(gen);
-    lambda = std::max(lambda, 1.0f - lambda);
-    const float lambda_sub = 1.0f - lambda;
-    const DataType* __restrict__ x1_buf = samples.LockedBuffer(0, i);
-    const DataType* __restrict__ x2_buf = samples.LockedBuffer(0, j);
-    DataType* __restrict__ x = samples_orig.Buffer(0, i);
-    const DataType* __restrict__ y1_buf = labels.LockedBuffer(0, i);
-    const DataType* __restrict__ y2_buf = labels.LockedBuffer(0, j);
-    DataType* __restrict__ y = labels_orig.Buffer(0, i);
+    const DataType lambda = m_lambdas(0, i);
+    const DataType lambda_sub = El::TypeTraits<DataType>::One() - lambda;
+    const DataType label_lambda = m_lambdas(1, i);
+    const DataType label_lambda_sub =
+      El::TypeTraits<DataType>::One() - label_lambda;
+    const DataType* __restrict__ x1_buf = m_samples_copy.LockedBuffer(0, i);
+    const DataType* __restrict__ x2_buf = m_samples_copy.LockedBuffer(0, j);
+    DataType* __restrict__ x = cpu_samples.Buffer(0, i);
+    const DataType* __restrict__ y1_buf = m_labels_copy.LockedBuffer(0, i);
+    const DataType* __restrict__ y2_buf = m_labels_copy.LockedBuffer(0, j);
+    DataType* __restrict__ y = cpu_labels.Buffer(0, i);
     for (El::Int k = 0; k < samples_height; ++k) {
-      x[k] = lambda * x1_buf[k] + lambda_sub * x2_buf[k];
+      const El::Int pos = k % plane_size;
+      const El::Int row = pos / width;
+      const El::Int col = pos % width;
+      const bool in_box =
+        (row >= idx[1] && row < idx[2] && col >= idx[3] && col < idx[4]);
+      x[k] = in_box ? x2_buf[k] : lambda * x1_buf[k] + lambda_sub * x2_buf[k];
     }
     for (El::Int k = 0; k < labels_height; ++k) {
-      y[k] = lambda * y1_buf[k] + lambda_sub * y2_buf[k];
+      y[k] = label_lambda * y1_buf[k] + label_lambda_sub * y2_buf[k];
     }
   }
 }
@@ -141,7 +251,7 @@ build_mixup_callback_from_pbuf(const google::protobuf::Message& proto_msg,
   const auto& layers_list = parse_list<std::string>(params.layers());
   std::unordered_set<std::string> layers(layers_list.begin(),
                                          layers_list.end());
-  return std::make_unique<mixup>(layers, params.alpha());
+  return std::make_unique<mixup>(layers, params.alpha(), params.cutmix());
 }
 
 } // namespace callback
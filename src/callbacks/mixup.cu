@@ -0,0 +1,145 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/mixup.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace callback {
+
+namespace {
+
+/** Block y dimension indexes samples, x dimension indexes the
+ *  entries of a sample followed by those of its label. Grid-stride
+ *  in both, so large mini-batches use a bounded grid. */
+__global__ void mixup_kernel(El::Int mbsize,
+                             El::Int samples_height,
+                             El::Int labels_height,
+                             El::Int height,
+                             El::Int width,
+                             const DataType* __restrict__ samples_copy,
+                             El::Int samples_copy_ldim,
+                             const DataType* __restrict__ labels_copy,
+                             El::Int labels_copy_ldim,
+                             DataType* __restrict__ samples,
+                             El::Int samples_ldim,
+                             DataType* __restrict__ labels,
+                             El::Int labels_ldim,
+                             const int* __restrict__ indices,
+                             El::Int indices_ldim,
+                             const DataType* __restrict__ lambdas,
+                             El::Int lambdas_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int plane_size = height * width;
+  const El::Int size = samples_height + labels_height;
+  for (El::Int i = blockIdx.y; i < mbsize; i += gridDim.y) {
+    const int* idx = &indices[i * indices_ldim];
+    const El::Int j = idx[0];
+    if (i == j) {
+      continue;
+    }
+    for (El::Int k = gidx; k < size; k += nthreadsx) {
+      if (k < samples_height) {
+        const auto& x1 = samples_copy[k + i * samples_copy_ldim];
+        const auto& x2 = samples_copy[k + j * samples_copy_ldim];
+        const auto& lambda = lambdas[i * lambdas_ldim];
+        const El::Int pos = k % plane_size;
+        const El::Int row = pos / width;
+        const El::Int col = pos % width;
+        const bool in_box =
+          (row >= idx[1] && row < idx[2] && col >= idx[3] && col < idx[4]);
+        samples[k + i * samples_ldim] =
+          in_box ? x2 : lambda * x1 + (DataType(1) - lambda) * x2;
+      }
+      else {
+        const El::Int kk = k - samples_height;
+        const auto& y1 = labels_copy[kk + i * labels_copy_ldim];
+        const auto& y2 = labels_copy[kk + j * labels_copy_ldim];
+        const auto& lambda = lambdas[1 + i * lambdas_ldim];
+        labels[kk + i * labels_ldim] =
+          lambda * y1 + (DataType(1) - lambda) * y2;
+      }
+    }
+  }
+}
+
+} // namespace
+
+void apply_mixup_gpu(const GPUMat& samples_copy,
+                     const GPUMat& labels_copy,
+                     GPUMat& samples,
+                     GPUMat& labels,
+                     const El::Matrix<int, El::Device::GPU>& indices,
+                     const GPUMat& lambdas,
+                     El::Int height,
+                     El::Int width)
+{
+  const El::Int mbsize = samples.Width();
+  const El::Int size = samples.Height() + labels.Height();
+  if (mbsize == 0 || size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  constexpr El::Int max_grid_size = 65535;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = std::min((size + block_size - 1) / block_size, El::Int(64));
+  grid_dims.y = std::min(mbsize, max_grid_size);
+  auto multisync = El::MakeMultiSync(El::SyncInfoFromMatrix(samples),
+                                     El::SyncInfoFromMatrix(labels),
+                                     El::SyncInfoFromMatrix(samples_copy),
+                                     El::SyncInfoFromMatrix(labels_copy),
+                                     El::SyncInfoFromMatrix(indices),
+                                     El::SyncInfoFromMatrix(lambdas));
+  hydrogen::gpu::LaunchKernel(mixup_kernel,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              mbsize,
+                              samples.Height(),
+                              labels.Height(),
+                              height,
+                              width,
+                              samples_copy.LockedBuffer(),
+                              samples_copy.LDim(),
+                              labels_copy.LockedBuffer(),
+                              labels_copy.LDim(),
+                              samples.Buffer(),
+                              samples.LDim(),
+                              labels.Buffer(),
+                              labels.LDim(),
+                              indices.LockedBuffer(),
+                              indices.LDim(),
+                              lambdas.LockedBuffer(),
+                              lambdas.LDim());
+}
+
+} // namespace callback
+} // namespace lbann
@@ -0,0 +1,178 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/model_averaging.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/protobuf.hpp"
+#include "lbann/weights/data_type_weights.hpp"
+
+#include "callback_helpers.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+
+model_averaging& model_averaging::operator=(const model_averaging& other)
+{
+  callback_base::operator=(other);
+  m_interval = other.m_interval;
+  m_async = other.m_async;
+  m_weights_names = other.m_weights_names;
+  m_averages.clear();
+  m_in_flight = false;
+  return *this;
+}
+
+void model_averaging::setup(model* m)
+{
+  m_averages.clear();
+  m_in_flight = false;
+  auto weights = m->get_weights();
+  if (!m_weights_names.empty()) {
+    weights = select_things_by_name(weights, m_weights_names);
+  }
+  for (auto* w : weights) {
+    auto* dtw = dynamic_cast<data_type_weights<DataType>*>(w);
+    if (dtw == nullptr) {
+      LBANN_ERROR("model averaging only supports weights of the default "
+                  "data type, but ",
+                  w->get_name(),
+                  " has another type");
+    }
+    m_averages.emplace_back();
+    m_averages.back().weights = dtw;
+  }
+}
+
+void model_averaging::on_batch_end(model* m)
+{
+  auto* comm = m->get_comm();
+  if (comm->get_num_trainers() == 1) {
+    return; // No point with only one model.
+  }
+
+  // Apply asynchronous averages as soon as they arrive
+  if (m_in_flight) {
+    bool done = true;
+    for (auto& a : m_averages) {
+      done = comm->test(a.req) && done;
+    }
+    if (done) {
+      finish_average(*m);
+    }
+  }
+
+  const auto& c = m->get_execution_context();
+  if (c.get_step() % m_interval == 0) {
+    if (m_in_flight) {
+      finish_average(*m);
+    }
+    start_average(*m);
+    if (!m_async) {
+      finish_average(*m);
+    }
+  }
+}
+
+void model_averaging::on_train_end(model* m)
+{
+  if (m_in_flight) {
+    finish_average(*m);
+  }
+}
+
+void model_averaging::start_average(model& m)
+{
+  auto* comm = m.get_comm();
+  for (auto& a : m_averages) {
+    const auto& values = a.weights->get_values();
+    if (a.sum == nullptr) {
+      a.sum.reset(values.Copy());
+    }
+    else {
+      El::Copy(values, *a.sum);
+    }
+    if (m_async) {
+      if (a.start == nullptr) {
+        a.start.reset(values.Copy());
+      }
+      else {
+        El::Copy(values, *a.start);
+      }
+    }
+    comm->nb_intertrainer_sum_matrix(*a.sum, a.req);
+  }
+  m_in_flight = true;
+}
+
+void model_averaging::finish_average(model& m)
+{
+  auto* comm = m.get_comm();
+  const auto scale = El::To<DataType>(1.0 / comm->get_num_trainers());
+  const auto one = El::TypeTraits<DataType>::One();
+  for (auto& a : m_averages) {
+    comm->wait(a.req);
+    El::Scale(scale, *a.sum);
+    if (m_async) {
+      // Keep the updates made since the sum started
+      El::Axpy(one, a.weights->get_values(), *a.sum);
+      El::Axpy(-one, *a.start, *a.sum);
+    }
+    a.weights->set_values(*a.sum);
+  }
+  m_in_flight = false;
+}
+
+void model_averaging::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_model_averaging();
+  msg->set_batch_interval(m_interval);
+  msg->set_async(m_async);
+  msg->set_weights(protobuf::to_space_sep_string(m_weights_names));
+}
+
+std::unique_ptr<callback_base> build_model_averaging_callback_from_pbuf(
+  const google::protobuf::Message& proto_msg,
+  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackModelAveraging&>(
+      proto_msg);
+  return std::make_unique<model_averaging>(
+    params.batch_interval(),
+    params.async(),
+    parse_list<std::string>(params.weights()));
+}
+
+} // namespace callback
+} // namespace lbann
@@ -26,10 +26,13 @@
 // monitor_io .hpp .cpp - Callback hooks for I/O monitoring
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <iomanip>
+#include <sstream>
 #include <utility>
 
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/data_coordinator/io_trace.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/proto/proto_common.hpp"
@@ -47,15 +50,26 @@ void monitor_io::serialize(Archive& ar)
 {
   ar(::cereal::make_nvp("BaseCallback",
                         ::cereal::base_class<callback_base>(this)),
-     CEREAL_NVP(m_layers));
+     CEREAL_NVP(m_layers),
+     CEREAL_NVP(m_trace_file));
 }
 
 void monitor_io::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_disp_io_stats();
   msg->set_layers(protobuf::to_space_sep_string(m_layers));
+  msg->set_trace_file(m_trace_file);
 }
 
+void monitor_io::setup(model*)
+{
+  if (!m_trace_file.empty()) {
+    io_trace_start();
+  }
+}
+
+void monitor_io::on_train_end(model* m) { write_trace(m); }
+
 void monitor_io::on_epoch_end(model* m)
 {
   const auto& c =
@@ -69,6 +83,7 @@ void monitor_io::on_epoch_end(model* m)
             << dc.get_total_num_samples(execution_mode::training) << " ("
             << dc.get_num_samples(execution_mode::training) / c.get_epoch()
             << " per epoch)" << std::endl;
+  report_io_stages(m, execution_mode::training);
 }
 
 void monitor_io::on_test_end(model* m)
@@ -84,6 +99,54 @@ void monitor_io::on_test_end(model* m)
             << dc.get_total_num_samples(execution_mode::testing) << " ("
             << dc.get_num_samples(execution_mode::testing) / c.get_epoch()
             << " per epoch)" << std::endl;
+  report_io_stages(m, execution_mode::testing);
+  write_trace(m);
+}
+
+void monitor_io::write_trace(model* m)
+{
+  if (m_trace_file.empty()) {
+    return;
+  }
+  const std::string path =
+    m_trace_file + "." + std::to_string(m->get_comm()->get_rank_in_world());
+  io_trace_write(path);
+}
+
+void monitor_io::report_io_stages(model* m, execution_mode mode)
+{
+  data_coordinator& dc = get_trainer().get_data_coordinator();
+  lbann_comm* comm = m->get_comm();
+  std::stringstream report;
+  const std::string prefix =
+    "Rank " + std::to_string(comm->get_trainer_rank()) + "." +
+    std::to_string(comm->get_rank_in_trainer()) + " " + to_string(mode) +
+    " I/O ";
+  report << std::fixed << std::setprecision(3);
+  for (size_t i = 0; i < num_io_stages; ++i) {
+    const auto stage = static_cast<io_stage>(i);
+    const auto summary = dc.get_io_stage_summary(mode, stage);
+    if (summary.samples == 0) {
+      continue;
+    }
+    report << prefix << to_string(stage) << " : " << summary.samples
+           << " timed, " << summary.total_time << "s total, mean "
+           << 1.e3 * summary.mean() << "ms, p50 < "
+           << 1.e3 * summary.quantile(0.5) << "ms, p99 < "
+           << 1.e3 * summary.quantile(0.99) << "ms, max "
+           << 1.e3 * summary.max << "ms" << std::endl;
+  }
+  // Uneven busy times across a large number of threads suggest that
+  // num_io_threads can be reduced
+  const auto threads = dc.get_io_thread_summaries(mode, io_stage::sample);
+  if (!threads.empty()) {
+    report << prefix << "thread busy time (s) :";
+    for (const auto& t : threads) {
+      report << " " << t.total_time;
+    }
+    report << std::endl;
+  }
+  std::cout << report.str() << std::flush;
 }
 
 std::unique_ptr<callback_base>
@@ -92,7 +155,8 @@ build_monitor_io_callback_from_pbuf(const google::protobuf::Message& proto_msg,
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackDispIOStats&>(proto_msg);
-  return std::make_unique<monitor_io>(parse_list<std::string>(params.layers()));
+  return std::make_unique<monitor_io>(parse_list<std::string>(params.layers()),
+                                      params.trace_file());
 }
 
 } // namespace callback
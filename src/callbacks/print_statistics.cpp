@@ -36,6 +36,7 @@
 #include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/timer.hpp"
 
 #include "lbann/proto/callbacks.pb.h"
 
@@ -43,6 +44,7 @@
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <sstream>
 #include <vector>
 
 namespace lbann {
@@ -80,6 +82,7 @@ void print_statistics::on_epoch_begin(model* m)
     static_cast<const SGDExecutionContext&>(m->get_execution_context());
   data_coordinator& dc = get_trainer().get_data_coordinator();
   lbann_comm* comm = m->get_comm();
+  start_io_report(execution_mode::training);
   if (comm->am_world_master()) {
     // Print message
     std::cout << "-------------------------------------------------------------"
@@ -147,11 +150,62 @@ void print_statistics::on_epoch_begin(model* m)
   }
 }
 
-void print_statistics::on_epoch_end(model* m) { report_results(m); }
+void print_statistics::on_epoch_end(model* m)
+{
+  report_results(m);
+  report_io_stall(m, execution_mode::training);
+}
+
+void print_statistics::on_validation_begin(model* m)
+{
+  start_io_report(execution_mode::validation);
+}
+
+void print_statistics::on_validation_end(model* m)
+{
+  report_results(m);
+  report_io_stall(m, execution_mode::validation);
+}
+
+void print_statistics::on_test_begin(model* m)
+{
+  start_io_report(execution_mode::testing);
+}
+
+void print_statistics::on_test_end(model* m)
+{
+  report_results(m);
+  report_io_stall(m, execution_mode::testing);
+}
 
-void print_statistics::on_validation_end(model* m) { report_results(m); }
+void print_statistics::start_io_report(execution_mode mode)
+{
+  data_coordinator& dc = get_trainer().get_data_coordinator();
+  m_start_blocked_time[mode] =
+    dc.get_io_stage_summary(mode, io_stage::blocked).total_time;
+  m_start_time[mode] = get_time();
+}
 
-void print_statistics::on_test_end(model* m) { report_results(m); }
+void print_statistics::report_io_stall(model* m, execution_mode mode)
+{
+  if (m_start_time.count(mode) == 0) {
+    return;
+  }
+  data_coordinator& dc = get_trainer().get_data_coordinator();
+  const double elapsed = get_time() - m_start_time[mode];
+  const double blocked =
+    dc.get_io_stage_summary(mode, io_stage::blocked).total_time -
+    m_start_blocked_time[mode];
+  lbann_comm* comm = m->get_comm();
+  if (comm->am_trainer_master() && elapsed > 0.) {
+    std::stringstream percent;
+    percent << std::fixed << std::setprecision(1) << 100. * blocked / elapsed;
+    std::cout << m->get_name() << " (instance " << comm->get_trainer_rank()
+              << ") " << to_string(mode) << " step time spent blocked on data"
+              << " : " << blocked << "s (" << percent.str() << "%)"
+              << std::endl;
+  }
+}
 
 void print_statistics::report_results(model* m)
 {
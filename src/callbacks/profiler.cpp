@@ -47,6 +47,20 @@
 
 namespace lbann {
 namespace callback {
+namespace {
+
+/** Name of the profiling region of an epoch or step. Caliper
+ *  aggregates regions by name, so the number is left out. */
+std::string numbered_region(const char* kind, size_t number)
+{
+#ifdef LBANN_HAS_CALIPER
+  return kind;
+#else
+  return std::string(kind) + " " + std::to_string(number);
+#endif // LBANN_HAS_CALIPER
+}
+
+} // namespace
 
 profiler::profiler(bool sync, bool skip_init)
   : callback_base(), m_sync(sync), m_skip_init(skip_init)
@@ -82,7 +96,7 @@ void profiler::on_epoch_begin(model* m)
   if (m_skip_init && c.get_epoch() == 1) {
     prof_start();
   }
-  prof_region_begin(("epoch " + std::to_string(c.get_epoch())).c_str(),
+  prof_region_begin(numbered_region("epoch", c.get_epoch()).c_str(),
                     prof_colors[0],
                     m_sync);
 }
@@ -90,13 +104,13 @@ void profiler::on_epoch_begin(model* m)
 void profiler::on_epoch_end(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
-  prof_region_end(("epoch " + std::to_string(c.get_epoch())).c_str(), m_sync);
+  prof_region_end(numbered_region("epoch", c.get_epoch()).c_str(), m_sync);
 }
 
 void profiler::on_validation_begin(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
-  prof_region_begin(("val " + std::to_string(c.get_epoch())).c_str(),
+  prof_region_begin(numbered_region("val", c.get_epoch()).c_str(),
                     prof_colors[0],
                     m_sync);
 }
@@ -104,13 +118,13 @@ void profiler::on_validation_begin(model* m)
 void profiler::on_validation_end(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
-  prof_region_end(("val " + std::to_string(c.get_epoch())).c_str(), m_sync);
+  prof_region_end(numbered_region("val", c.get_epoch()).c_str(), m_sync);
 }
 
 void profiler::on_test_begin(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
-  prof_region_begin(("test " + std::to_string(c.get_epoch())).c_str(),
+  prof_region_begin(numbered_region("test", c.get_epoch()).c_str(),
                     prof_colors[0],
                     m_sync);
 }
@@ -118,13 +132,13 @@ void profiler::on_test_begin(model* m)
 void profiler::on_test_end(model* m)
 {
   const auto& c = static_cast<SGDExecutionContext&>(m->get_execution_context());
-  prof_region_end(("test " + std::to_string(c.get_epoch())).c_str(), m_sync);
+  prof_region_end(numbered_region("test", c.get_epoch()).c_str(), m_sync);
 }
 
 void profiler::on_batch_begin(model* m)
 {
   const auto& c = m->get_execution_context();
-  prof_region_begin(("batch " + std::to_string(c.get_step())).c_str(),
+  prof_region_begin(numbered_region("batch", c.get_step()).c_str(),
                     prof_colors[1],
                     m_sync);
 }
@@ -132,13 +146,13 @@ void profiler::on_batch_begin(model* m)
 void profiler::on_batch_end(model* m)
 {
   const auto& c = m->get_execution_context();
-  prof_region_end(("batch " + std::to_string(c.get_step())).c_str(), m_sync);
+  prof_region_end(numbered_region("batch", c.get_step()).c_str(), m_sync);
 }
 
 void profiler::on_batch_evaluate_begin(model* m)
 {
   const auto& c = m->get_execution_context();
-  prof_region_begin(("batch eval " + std::to_string(c.get_step())).c_str(),
+  prof_region_begin(numbered_region("batch eval", c.get_step()).c_str(),
                     prof_colors[1],
                     m_sync);
 }
@@ -146,7 +160,7 @@ void profiler::on_batch_evaluate_begin(model* m)
 void profiler::on_batch_evaluate_end(model* m)
 {
   const auto& c = m->get_execution_context();
-  prof_region_end(("batch eval " + std::to_string(c.get_step())).c_str(),
+  prof_region_end(numbered_region("batch eval", c.get_step()).c_str(),
                   m_sync);
 }
 
@@ -0,0 +1,334 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/callbacks/roofline.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include "lbann/proto/callbacks.pb.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace callback {
+namespace {
+
+#ifdef LBANN_HAS_GPU
+/** Stream that layers compute on */
+auto get_compute_stream()
+{
+#if defined LBANN_HAS_CUDA
+  return hydrogen::cuda::GetDefaultStream();
+#elif defined LBANN_HAS_ROCM
+  return hydrogen::rocm::GetDefaultStream();
+#endif
+}
+#endif // LBANN_HAS_GPU
+
+} // namespace
+
+roofline& roofline::operator=(const roofline& other)
+{
+  callback_base::operator=(other);
+  m_skip_steps = other.m_skip_steps;
+  m_num_steps = other.m_num_steps;
+  m_peak_gflops = other.m_peak_gflops;
+  m_peak_gbps = other.m_peak_gbps;
+  m_layer_indices.clear();
+  m_layer_names.clear();
+  m_layer_types.clear();
+  m_seconds.clear();
+  m_flops.clear();
+  m_bytes.clear();
+  m_host_start.clear();
+  m_step = 0;
+#ifdef LBANN_HAS_GPU
+  m_intervals[0].clear();
+  m_intervals[1].clear();
+#endif // LBANN_HAS_GPU
+  return *this;
+}
+
+void roofline::setup(model* m)
+{
+  m_layer_indices.clear();
+  m_layer_names.clear();
+  m_layer_types.clear();
+  for (const auto* l : m->get_layers()) {
+    m_layer_indices[l] = m_layer_names.size();
+    m_layer_names.push_back(l->get_name());
+    m_layer_types.push_back(l->get_type());
+  }
+  const size_t num_slots = 2 * m_layer_names.size();
+  m_seconds.assign(num_slots, 0.);
+  m_flops.assign(num_slots, 0.);
+  m_bytes.assign(num_slots, 0.);
+  m_host_start.assign(num_slots, 0.);
+  m_step = 0;
+#ifdef LBANN_HAS_GPU
+  for (auto& intervals : m_intervals) {
+    intervals.clear();
+    intervals.resize(num_slots);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void roofline::on_forward_prop_begin(model* m, Layer* l)
+{
+  if (is_timed()) {
+    begin_interval(*l, 2 * m_layer_indices.at(l));
+  }
+}
+
+void roofline::on_forward_prop_end(model* m, Layer* l)
+{
+  if (is_timed()) {
+    end_interval(*l,
+                 2 * m_layer_indices.at(l),
+                 l->get_forward_prop_cost());
+  }
+}
+
+void roofline::on_backward_prop_begin(model* m, Layer* l)
+{
+  if (is_timed()) {
+    begin_interval(*l, 2 * m_layer_indices.at(l) + 1);
+  }
+}
+
+void roofline::on_backward_prop_end(model* m, Layer* l)
+{
+  if (is_timed()) {
+    end_interval(*l,
+                 2 * m_layer_indices.at(l) + 1,
+                 l->get_backward_prop_cost());
+  }
+}
+
+void roofline::on_batch_end(model* m)
+{
+  if (!is_timed()) {
+    ++m_step;
+    return;
+  }
+  if (m_step > m_skip_steps) {
+    resolve_device_intervals(m_step - 1);
+  }
+  ++m_step;
+  if (m_step == m_skip_steps + m_num_steps) {
+    resolve_device_intervals(m_step - 1);
+    report(*m);
+  }
+}
+
+void roofline::begin_interval(const Layer& l, size_t slot)
+{
+#ifdef LBANN_HAS_GPU
+  if (l.using_gpus()) {
+    auto& interval = m_intervals[m_step % 2][slot];
+    if (interval.start == nullptr) {
+      interval.start = std::make_unique<gpu_lib::event_wrapper>(true);
+      interval.end = std::make_unique<gpu_lib::event_wrapper>(true);
+    }
+    // A layer run twice in a step, e.g. to recompute its
+    // activations, is only timed the last time
+    interval.start->record(get_compute_stream());
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  m_host_start[slot] = get_time();
+}
+
+void roofline::end_interval(const Layer& l,
+                            size_t slot,
+                            const compute_cost& cost)
+{
+  m_flops[slot] += cost.flops;
+  m_bytes[slot] += cost.bytes;
+#ifdef LBANN_HAS_GPU
+  if (l.using_gpus()) {
+    auto& interval = m_intervals[m_step % 2][slot];
+    interval.end->record(get_compute_stream());
+    interval.recorded = true;
+    return;
+  }
+#endif // LBANN_HAS_GPU
+  m_seconds[slot] += get_time() - m_host_start[slot];
+}
+
+void roofline::resolve_device_intervals(size_t step)
+{
+#ifdef LBANN_HAS_GPU
+  for (size_t slot = 0; slot < m_seconds.size(); ++slot) {
+    auto& interval = m_intervals[step % 2][slot];
+    if (interval.recorded) {
+      interval.end->synchronize();
+      const auto ms = interval.end->elapsed_time(*interval.start);
+      m_seconds[slot] += ms / 1e3;
+      interval.recorded = false;
+    }
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void roofline::report(model& m)
+{
+  // Sum the measurements over the trainer
+  auto* comm = m.get_comm();
+  const auto& trainer_comm = comm->get_trainer_comm();
+  const int num_slots = m_seconds.size();
+  for (auto* values : {&m_seconds, &m_flops, &m_bytes}) {
+    std::vector<double> sums(num_slots);
+    comm->allreduce(values->data(),
+                    num_slots,
+                    sums.data(),
+                    trainer_comm,
+                    El::mpi::SUM);
+    *values = std::move(sums);
+  }
+  if (!comm->am_trainer_master()) {
+    return;
+  }
+
+  // Forward and backward prop of each layer, per rank and step
+  const double scale =
+    1. / (comm->get_procs_per_trainer() * static_cast<double>(m_num_steps));
+  const size_t num_layers = m_layer_names.size();
+  std::vector<double> seconds(num_layers), flops(num_layers),
+    bytes(num_layers);
+  for (size_t i = 0; i < num_layers; ++i) {
+    seconds[i] = (m_seconds[2 * i] + m_seconds[2 * i + 1]) * scale;
+    flops[i] = (m_flops[2 * i] + m_flops[2 * i + 1]) * scale;
+    bytes[i] = (m_bytes[2 * i] + m_bytes[2 * i + 1]) * scale;
+  }
+  const double total_seconds =
+    std::accumulate(seconds.begin(), seconds.end(), 0.);
+  std::vector<size_t> order(num_layers);
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return seconds[a] > seconds[b];
+  });
+
+  // The ridge point is the intensity at which a layer stops being
+  // bound by bandwidth
+  const bool have_peaks = (m_peak_gflops > 0. && m_peak_gbps > 0.);
+  const double ridge = have_peaks ? m_peak_gflops / m_peak_gbps : 0.;
+  std::ostringstream msg;
+  char line[256];
+  std::snprintf(line,
+                sizeof(line),
+                "roofline: model %s, %zu steps, %.3f ms of layer compute "
+                "per step and rank\n",
+                m.get_name().c_str(),
+                m_num_steps,
+                total_seconds * 1e3);
+  msg << line;
+  std::snprintf(line,
+                sizeof(line),
+                "%7s %9s %9s %9s %9s %9s %8s %6s %6s %-9s %s\n",
+                "share",
+                "ms/step",
+                "GFLOP",
+                "GB",
+                "GFLOP/s",
+                "GB/s",
+                "FLOP/B",
+                "%FLOP",
+                "%BW",
+                "bound",
+                "layer (type)");
+  msg << line;
+  for (const auto i : order) {
+    const double gflops = seconds[i] > 0. ? flops[i] / seconds[i] / 1e9 : 0.;
+    const double gbps = seconds[i] > 0. ? bytes[i] / seconds[i] / 1e9 : 0.;
+    const double intensity = bytes[i] > 0. ? flops[i] / bytes[i] : 0.;
+    const double share =
+      total_seconds > 0. ? 100. * seconds[i] / total_seconds : 0.;
+    std::string flop_peak = "-", bw_peak = "-", bound = "-";
+    if (m_peak_gflops > 0.) {
+      flop_peak = std::to_string(
+        static_cast<int>(100. * gflops / m_peak_gflops + 0.5));
+    }
+    if (m_peak_gbps > 0.) {
+      bw_peak =
+        std::to_string(static_cast<int>(100. * gbps / m_peak_gbps + 0.5));
+    }
+    if (have_peaks && bytes[i] > 0.) {
+      bound = intensity < ridge ? "bandwidth" : "compute";
+    }
+    std::snprintf(line,
+                  sizeof(line),
+                  "%6.1f%% %9.3f %9.3f %9.3f %9.1f %9.1f %8.2f %6s %6s "
+                  "%-9s %s (%s)\n",
+                  share,
+                  seconds[i] * 1e3,
+                  flops[i] / 1e9,
+                  bytes[i] / 1e9,
+                  gflops,
+                  gbps,
+                  intensity,
+                  flop_peak.c_str(),
+                  bw_peak.c_str(),
+                  bound.c_str(),
+                  m_layer_names[i].c_str(),
+                  m_layer_types[i].c_str());
+    msg << line;
+  }
+  std::cout << msg.str() << std::flush;
+}
+
+void roofline::write_specific_proto(lbann_data::Callback& proto) const
+{
+  auto* msg = proto.mutable_roofline();
+  msg->set_skip_steps(m_skip_steps);
+  msg->set_num_steps(m_num_steps);
+  msg->set_peak_gflops(m_peak_gflops);
+  msg->set_peak_gbps(m_peak_gbps);
+}
+
+std::unique_ptr<callback_base>
+build_roofline_callback_from_pbuf(const google::protobuf::Message& proto_msg,
+                                  const std::shared_ptr<lbann_summary>&)
+{
+  const auto& params =
+    dynamic_cast<const lbann_data::Callback::CallbackRoofline&>(proto_msg);
+  return std::make_unique<roofline>(
+    params.skip_steps() > 0 ? params.skip_steps() : 10,
+    params.num_steps() > 0 ? params.num_steps() : 10,
+    params.peak_gflops(),
+    params.peak_gbps());
+}
+
+} // namespace callback
+} // namespace lbann
@@ -254,8 +254,11 @@ autoencoder_strategy::get_image_indices(model const& m) const
   // called in the final epoch. This is the simplest hack around that,
   // though not very efficient.
   if (current_step == decltype(current_step){1}) {
-    auto const& tmp_inds = data_reader.get_shuffled_indices();
-    m_shuffled_indices[&m].assign(tmp_inds.cbegin(), tmp_inds.cend());
+    auto& inds = m_shuffled_indices[&m];
+    inds.resize(data_reader.get_shuffled_indices().size());
+    for (size_t i = 0; i < inds.size(); ++i) {
+      inds[i] = data_reader.get_shuffled_index(i);
+    }
   }
   auto const& shuffled_indices = m_shuffled_indices[&m];
 
@@ -28,6 +28,7 @@
 
 #include "lbann/callbacks/timeline.hpp"
 
+#include "lbann/comm_impl.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/serialize.hpp"
@@ -37,12 +38,47 @@
 #include "lbann/proto/callbacks.pb.h"
 
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
 
 namespace lbann {
 namespace callback {
+namespace {
+
+/** Steps after which device events are resolved. They have almost
+ *  always completed by then, so resolving them does not stall. */
+constexpr size_t device_event_lag = 2;
+
+#ifdef LBANN_HAS_GPU
+/** Stream that layers and optimizers compute on */
+auto get_compute_stream()
+{
+#if defined LBANN_HAS_CUDA
+  return hydrogen::cuda::GetDefaultStream();
+#elif defined LBANN_HAS_ROCM
+  return hydrogen::rocm::GetDefaultStream();
+#endif
+}
+#endif // LBANN_HAS_GPU
+
+/** Quote a string for JSON */
+std::string json_string(const std::string& s)
+{
+  std::string quoted = "\"";
+  for (const char c : s) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+} // namespace
 
 timeline::timeline() : timeline("") {}
 
@@ -58,13 +94,19 @@ void timeline::serialize(Archive& ar)
      CEREAL_NVP(m_opt_start_time),
      CEREAL_NVP(m_fp_times),
      CEREAL_NVP(m_bp_times),
-     CEREAL_NVP(m_opt_times));
+     CEREAL_NVP(m_opt_times),
+     CEREAL_NVP(m_step_start_time),
+     CEREAL_NVP(m_comm_times),
+     CEREAL_NVP(m_step_times),
+     CEREAL_NVP(m_exposed_comm_times),
+     CEREAL_NVP(m_device_events));
 }
 
 void timeline::write_specific_proto(lbann_data::Callback& proto) const
 {
   auto* msg = proto.mutable_timeline();
   msg->set_directory(m_outdir);
+  msg->set_device_events(m_device_events);
 }
 
 void timeline::on_train_begin(model* m)
@@ -81,8 +123,19 @@ void timeline::on_train_begin(model* m)
                         std::vector<std::pair<EvalType, EvalType>>());
   }
   // Ensure the model is synchronized at the start.
-  m->get_comm()->trainer_barrier();
+  auto* comm = m->get_comm();
+  comm->trainer_barrier();
+#ifdef LBANN_HAS_GPU
+  if (m_device_events) {
+    m_device.clear();
+    m_device.reference = std::make_unique<gpu_lib::event_wrapper>(true);
+    m_device.reference->record(get_compute_stream());
+    m_device.reference->synchronize();
+  }
+#endif // LBANN_HAS_GPU
   m_start_time = get_time();
+  comm->set_comm_profiling(true);
+  comm->take_comm_events();
 }
 
 void timeline::on_train_end(model* m)
@@ -91,6 +144,8 @@ void timeline::on_train_end(model* m)
     m_outdir + "/timeline.m" +
     std::to_string(m->get_comm()->get_trainer_rank()) + "." +
     std::to_string(m->get_comm()->get_rank_in_trainer()) + ".txt";
+  m->get_comm()->set_comm_profiling(false);
+  resolve_device_intervals(std::numeric_limits<size_t>::max());
   std::ofstream f(path);
   for (const auto& kv : m_fp_times) {
     const std::string layer_name = "fp-" + kv.first;
@@ -110,48 +165,296 @@ void timeline::on_train_end(model* m)
       f << weights_name << ":" << time.first << ":" << time.second << '\n';
     }
   }
+  for (const auto& kv : m_comm_times) {
+    const std::string comm_name = "comm-" + kv.first;
+    for (const auto& r : kv.second) {
+      f << comm_name << ":" << r.start << ":" << r.end << ":" << r.wait << ":"
+        << r.bytes << '\n';
+    }
+  }
+  for (size_t i = 0; i < m_step_times.size(); ++i) {
+    f << "step:" << m_step_times[i].first << ":" << m_step_times[i].second
+      << ":" << m_exposed_comm_times[i] << '\n';
+  }
+  f.close();
+
+  // Merge the ranks' events into one trace on the trainer master
+  auto* comm = m->get_comm();
+  const auto events = get_trace_events(comm->get_rank_in_trainer());
+  const auto* data = reinterpret_cast<const El::byte*>(events.data());
+  const int size = events.size();
+  if (!comm->am_trainer_master()) {
+    comm->trainer_gather(size, comm->get_trainer_master());
+    comm->trainer_gatherv(data, size, comm->get_trainer_master());
+    return;
+  }
+  const int num_ranks = comm->get_procs_per_trainer();
+  std::vector<int> sizes(num_ranks), displacements(num_ranks, 0);
+  comm->trainer_gather(size, sizes.data());
+  for (int i = 1; i < num_ranks; ++i) {
+    displacements[i] = displacements[i - 1] + sizes[i - 1];
+  }
+  std::string all_events(displacements.back() + sizes.back(), '\0');
+  comm->trainer_gatherv(data,
+                        size,
+                        reinterpret_cast<El::byte*>(&all_events[0]),
+                        sizes.data(),
+                        displacements.data());
+  std::ofstream trace(m_outdir + "/timeline.m" +
+                      std::to_string(comm->get_trainer_rank()) + ".json");
+  trace << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  for (int i = 0; i < num_ranks; ++i) {
+    trace << (i > 0 ? ",\n" : "")
+          << all_events.substr(displacements[i], sizes[i]);
+  }
+  trace << "\n]}\n";
+}
+
+std::string timeline::get_trace_events(int pid) const
+{
+  // Times are in microseconds. Compute, communication and steps are
+  // shown as separate threads of the rank.
+  std::ostringstream ss;
+  ss << std::fixed << std::setprecision(3);
+  auto metadata = [&](const char* what, int tid, const std::string& name) {
+    ss << "{\"name\":\"" << what << "\",\"ph\":\"M\",\"pid\":" << pid
+       << ",\"tid\":" << tid << ",\"args\":{\"name\":" << json_string(name)
+       << "}}";
+  };
+  auto event = [&](const std::string& name,
+                   const char* cat,
+                   int tid,
+                   EvalType start,
+                   EvalType end) {
+    ss << ",\n{\"name\":" << json_string(name) << ",\"cat\":\"" << cat
+       << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"ts\":" << start * 1e6 << ",\"dur\":" << (end - start) * 1e6;
+  };
+  metadata("process_name", 0, "rank " + std::to_string(pid));
+  ss << ",\n";
+  metadata("thread_name", 0, "compute");
+  ss << ",\n";
+  metadata("thread_name", 1, "communication");
+  ss << ",\n";
+  metadata("thread_name", 2, "steps");
+  for (const auto& kv : m_fp_times) {
+    for (const auto& time : kv.second) {
+      event("fp-" + kv.first, "fp", 0, time.first, time.second);
+      ss << "}";
+    }
+  }
+  for (const auto& kv : m_bp_times) {
+    for (const auto& time : kv.second) {
+      event("bp-" + kv.first, "bp", 0, time.first, time.second);
+      ss << "}";
+    }
+  }
+  for (const auto& kv : m_opt_times) {
+    for (const auto& time : kv.second) {
+      event("opt-" + kv.first, "opt", 0, time.first, time.second);
+      ss << "}";
+    }
+  }
+  for (const auto& kv : m_comm_times) {
+    for (const auto& r : kv.second) {
+      event("comm-" + kv.first, "comm", 1, r.start, r.end);
+      ss << ",\"args\":{\"wait\":" << r.wait * 1e6
+         << ",\"bytes\":" << r.bytes << "}}";
+    }
+  }
+  for (size_t i = 0; i < m_step_times.size(); ++i) {
+    event("step", "step", 2, m_step_times[i].first, m_step_times[i].second);
+    ss << ",\"args\":{\"exposed_comm\":" << m_exposed_comm_times[i] * 1e6
+       << "}}";
+  }
+  return ss.str();
+}
+
+void timeline::on_batch_begin(model* m)
+{
+  m_step_start_time = get_rel_time();
+}
+
+void timeline::on_batch_end(model* m)
+{
+  const EvalType end = get_rel_time();
+  EvalType exposed = EvalType(0);
+  for (const auto& event : m->get_comm()->take_comm_events()) {
+    if (!event.complete) {
+      continue;
+    }
+    m_comm_times[event.name].push_back({event.start - m_start_time,
+                                        event.wait - m_start_time,
+                                        event.end - m_start_time,
+                                        event.bytes});
+    exposed += event.end - event.wait;
+  }
+  m_step_times.emplace_back(m_step_start_time, end);
+  m_exposed_comm_times.push_back(exposed);
+#ifdef LBANN_HAS_GPU
+  if (m_device_events) {
+    ++m_device.step;
+    if (m_device.step > device_event_lag) {
+      resolve_device_intervals(m_device.step - device_event_lag);
+    }
+  }
+#endif // LBANN_HAS_GPU
 }
 
 void timeline::on_forward_prop_begin(model* m, Layer* l)
 {
-  m_fp_start_time = get_rel_time();
+  if (times_on_device(*l)) {
+    begin_device_interval(forward_prop);
+  }
+  else {
+    m_fp_start_time = get_rel_time();
+  }
 }
 
 void timeline::on_forward_prop_end(model* m, Layer* l)
 {
-  EvalType end = get_rel_time();
-  m_fp_times[l->get_name()].emplace_back(m_fp_start_time, end);
+  auto& times = m_fp_times[l->get_name()];
+  if (times_on_device(*l)) {
+    end_device_interval(forward_prop, times);
+  }
+  else {
+    EvalType end = get_rel_time();
+    times.emplace_back(m_fp_start_time, end);
+  }
 }
 
 void timeline::on_backward_prop_begin(model* m, Layer* l)
 {
-  m_bp_start_time = get_rel_time();
+  if (times_on_device(*l)) {
+    begin_device_interval(backward_prop);
+  }
+  else {
+    m_bp_start_time = get_rel_time();
+  }
 }
 
 void timeline::on_backward_prop_end(model* m, Layer* l)
 {
-  EvalType end = get_rel_time();
-  m_bp_times[l->get_name()].emplace_back(m_bp_start_time, end);
+  auto& times = m_bp_times[l->get_name()];
+  if (times_on_device(*l)) {
+    end_device_interval(backward_prop, times);
+  }
+  else {
+    EvalType end = get_rel_time();
+    times.emplace_back(m_bp_start_time, end);
+  }
 }
 
 void timeline::on_optimize_begin(model* m, weights* w)
 {
-  m_opt_start_time = get_rel_time();
+  if (times_on_device(*w)) {
+    begin_device_interval(optimize);
+  }
+  else {
+    m_opt_start_time = get_rel_time();
+  }
 }
 
 void timeline::on_optimize_end(model* m, weights* w)
 {
-  EvalType end = get_rel_time();
-  m_opt_times[w->get_name()].emplace_back(m_opt_start_time, end);
+  auto& times = m_opt_times[w->get_name()];
+  if (times_on_device(*w)) {
+    end_device_interval(optimize, times);
+  }
+  else {
+    EvalType end = get_rel_time();
+    times.emplace_back(m_opt_start_time, end);
+  }
+}
+
+bool timeline::times_on_device(const Layer& l) const
+{
+#ifdef LBANN_HAS_GPU
+  return m_device_events && l.get_device_allocation() == El::Device::GPU;
+#else
+  return false;
+#endif // LBANN_HAS_GPU
 }
 
+bool timeline::times_on_device(const weights& w) const
+{
+#ifdef LBANN_HAS_GPU
+  return m_device_events && !w.get_offload_optimizer();
+#else
+  return false;
+#endif // LBANN_HAS_GPU
+}
+
+#ifdef LBANN_HAS_GPU
+void timeline::begin_device_interval(interval_kind kind)
+{
+  auto get_event = [&]() {
+    if (m_device.free_events.empty()) {
+      return std::make_unique<gpu_lib::event_wrapper>(true);
+    }
+    auto event = std::move(m_device.free_events.back());
+    m_device.free_events.pop_back();
+    return event;
+  };
+  auto& interval = m_device.open[kind];
+  interval.step = m_device.step;
+  interval.start = get_event();
+  interval.end = get_event();
+  interval.start->record(get_compute_stream());
+}
+
+void timeline::end_device_interval(
+  interval_kind kind,
+  std::vector<std::pair<EvalType, EvalType>>& times)
+{
+  auto& interval = m_device.open[kind];
+  if (interval.start == nullptr) {
+    LBANN_ERROR("device interval ended before it began");
+  }
+  interval.end->record(get_compute_stream());
+  interval.times = &times;
+  m_device.pending.push_back(std::move(interval));
+  interval = device_interval();
+}
+
+void timeline::resolve_device_intervals(size_t step)
+{
+  auto& pending = m_device.pending;
+  while (!pending.empty() && pending.front().step < step) {
+    auto& interval = pending.front();
+    interval.end->synchronize();
+    const auto& reference = *m_device.reference;
+    interval.times->emplace_back(interval.start->elapsed_time(reference) / 1e3,
+                                 interval.end->elapsed_time(reference) / 1e3);
+    m_device.free_events.push_back(std::move(interval.start));
+    m_device.free_events.push_back(std::move(interval.end));
+    pending.pop_front();
+  }
+}
+#else
+void timeline::begin_device_interval(interval_kind kind)
+{
+  LBANN_ERROR("device events need a GPU build");
+}
+
+void timeline::end_device_interval(
+  interval_kind kind,
+  std::vector<std::pair<EvalType, EvalType>>& times)
+{
+  LBANN_ERROR("device events need a GPU build");
+}
+
+void timeline::resolve_device_intervals(size_t step) {}
+#endif // LBANN_HAS_GPU
+
 std::unique_ptr<callback_base>
 build_timeline_callback_from_pbuf(const google::protobuf::Message& proto_msg,
                                   std::shared_ptr<lbann_summary> const&)
 {
   const auto& params =
     dynamic_cast<const lbann_data::Callback::CallbackTimeline&>(proto_msg);
-  return std::make_unique<timeline>(params.directory());
+  return std::make_unique<timeline>(params.directory(),
+                                    params.device_events());
 }
 
 } // namespace callback
@@ -34,6 +34,9 @@
 #include "lbann/utils/timer.hpp"
 #include "mpi.h"
 #include "omp.h"
+#include <algorithm>
+#include <array>
+#include <cstdlib>
 #include <sstream>
 #include <thread>
 
@@ -73,14 +76,14 @@ lbann_comm::lbann_comm(int ppm, El::mpi::Comm world)
   char** argv_dummy = nullptr;
   ::Al::Initialize(argc_dummy, argv_dummy);
 #endif
-  // Set up the initial trainer split
-  split_trainers(m_procs_per_trainer);
-
   // Initialize node communicators
   setup_node_comm();
   m_procs_per_node = El::mpi::Size(m_node_comm);
   m_rank_in_node = El::mpi::Rank(m_node_comm);
 
+  // Set up the initial trainer split
+  split_trainers(m_procs_per_trainer);
+
   // Setup threads
   setup_threads();
 }
@@ -91,12 +94,16 @@ lbann_comm::~lbann_comm()
   El::mpi::Free(m_trainer_comm);
   El::mpi::Free(m_intertrainer_comm);
   El::mpi::Free(m_node_comm);
+  clear_hierarchical_comms();
+  clear_sequence_comms();
 #ifdef LBANN_HAS_ALUMINUM
   ::Al::Finalize();
 #endif
 }
 
-void lbann_comm::split_trainers(int procs_per_trainer, int trainer_grid_height)
+void lbann_comm::split_trainers(int procs_per_trainer,
+                                int trainer_grid_height,
+                                TrainerPlacement placement)
 {
   const int world_size = El::mpi::Size(get_world_comm());
   m_procs_per_trainer = procs_per_trainer;
@@ -119,9 +126,15 @@ void lbann_comm::split_trainers(int procs_per_trainer, int trainer_grid_height)
                 world_size);
   }
 
+  // Communicators may be freed and their handles reused
+  clear_hierarchical_comms();
+  clear_sequence_comms();
+
+  place_world_ranks(placement);
+  const int position = get_placement_position(get_rank_in_world());
   m_num_trainers = world_size / m_procs_per_trainer;
-  m_trainer_rank = El::mpi::Rank(get_world_comm()) / m_procs_per_trainer;
-  m_rank_in_trainer = El::mpi::Rank(get_world_comm()) % m_procs_per_trainer;
+  m_trainer_rank = position / m_procs_per_trainer;
+  m_rank_in_trainer = position % m_procs_per_trainer;
 
   // Initialize trainer and intertrainer communicators
   El::mpi::Split(get_world_comm(),
@@ -138,12 +151,60 @@ void lbann_comm::split_trainers(int procs_per_trainer, int trainer_grid_height)
                                       trainer_grid_height);
 }
 
+void lbann_comm::place_world_ranks(TrainerPlacement placement)
+{
+  m_placed_world_ranks.clear();
+  m_world_rank_positions.clear();
+  if (placement == TrainerPlacement::CONSECUTIVE) {
+    return;
+  }
+
+  // Sort ranks by group, then node, then world rank
+  const int world_size = get_procs_in_world();
+  std::array<int, 3> key = {0,
+                            *std::min_element(m_world_ranks_on_node.begin(),
+                                              m_world_ranks_on_node.end()),
+                            get_rank_in_world()};
+  if (placement == TrainerPlacement::GROUP) {
+    char const* group = std::getenv("LBANN_TOPOLOGY_GROUP");
+    if (group == nullptr) {
+      LBANN_ERROR("placing trainers by group requires the topology group "
+                  "of each node in LBANN_TOPOLOGY_GROUP");
+    }
+    key[0] = std::atoi(group);
+  }
+  std::vector<std::array<int, 3>> keys(world_size);
+  checkMPI(MPI_Allgather(key.data(),
+                         key.size(),
+                         MPI_INT,
+                         keys.data(),
+                         key.size(),
+                         MPI_INT,
+                         get_world_comm().GetMPIComm()));
+  std::sort(keys.begin(), keys.end());
+
+  bool in_order = true;
+  for (int i = 0; i < world_size; ++i) {
+    in_order = in_order && (keys[i][2] == i);
+  }
+  if (in_order) {
+    return;
+  }
+  m_placed_world_ranks.resize(world_size);
+  m_world_rank_positions.resize(world_size);
+  for (int i = 0; i < world_size; ++i) {
+    m_placed_world_ranks[i] = keys[i][2];
+    m_world_rank_positions[keys[i][2]] = i;
+  }
+}
+
 void lbann_comm::split_trainer_grid(int num_process_primary_grid,
                                     bool create_two_models,
                                     bool enable_async_comm,
                                     bool enable_topo_aware)
 {
   const int trainer_size = El::mpi::Size(m_trainer_comm);
+  clear_hierarchical_comms();
   m_create_two_models = create_two_models;
   m_subgrid_async_progress = enable_async_comm;
   bool enable_topology_aware = enable_topo_aware;
@@ -323,6 +384,9 @@ void lbann_comm::split_trainer_grid(int num_process_primary_grid,
 void lbann_comm::intertrainer_sum_matrix(AbsMat& mat) const
 {
   m_bytes_sent += sizeof(DataType) * mat.Height() * mat.Width();
+  blocking_comm_event event(*this,
+                            "intertrainer_sum_matrix",
+                            sizeof(DataType) * mat.Height() * mat.Width());
   El::AllReduce(mat, m_intertrainer_comm, El::mpi::SUM);
   m_bytes_received += sizeof(DataType) * mat.Height() * mat.Width();
 }
@@ -332,6 +396,43 @@ void lbann_comm::intertrainer_sum_matrix(AbsDistMat& mat) const
   allreduce(mat, m_intertrainer_comm, El::mpi::SUM);
 }
 
+size_t lbann_comm::begin_comm_event(char const* name, size_t bytes) const
+{
+  telemetry_add(telemetry_value::comm_bytes_sent, bytes);
+  if (!m_comm_profiling) {
+    return 0;
+  }
+  const double start = get_time();
+  std::lock_guard<std::mutex> lock(m_comm_events_mutex);
+  m_comm_events.push_back({name, bytes, start, start, start, false});
+  return m_first_comm_event + m_comm_events.size() - 1;
+}
+
+void lbann_comm::end_comm_event(size_t id, double wait_start) const
+{
+  if (id == 0) {
+    return;
+  }
+  const double end = get_time();
+  std::lock_guard<std::mutex> lock(m_comm_events_mutex);
+  if (id < m_first_comm_event) {
+    return; // Already taken
+  }
+  auto& event = m_comm_events[id - m_first_comm_event];
+  event.wait = (wait_start < 0. ? event.start : wait_start);
+  event.end = end;
+  event.complete = true;
+}
+
+std::vector<lbann_comm::comm_event> lbann_comm::take_comm_events() const
+{
+  std::vector<comm_event> events;
+  std::lock_guard<std::mutex> lock(m_comm_events_mutex);
+  events.swap(m_comm_events);
+  m_first_comm_event += events.size();
+  return events;
+}
+
 namespace {
 
 template <typename BackendT>
@@ -548,8 +649,165 @@ void nb_allreduce_impl(El::Matrix<T, El::Device::GPU>& m,
 }
 
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_HAS_ALUMINUM)
+
+template <typename T>
+void nb_broadcast_impl(El::Matrix<T, El::Device::CPU>& m,
+                       const El::mpi::Comm& c,
+                       int root,
+                       Al::request& req)
+{
+  if (m.Height() == m.LDim() || m.Width() == 1) {
+    MPI_Ibcast(m.Buffer(),
+               m.Height() * m.Width(),
+               El::mpi::TypeMap<T>(),
+               root,
+               c.GetMPIComm(),
+               &(req.raw_mpi_req));
+  }
+  else {
+    El::Broadcast(m, c, root);
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+#if defined(LBANN_HAS_ALUMINUM) && defined(AL_HAS_NCCL)
+template <typename T,
+          El::EnableWhen<
+            El::AluminumSupportsBackendAndCollective<T,
+                                                     El::Collective::BROADCAST,
+                                                     ::Al::NCCLBackend>,
+            int> = 0>
+void nb_broadcast_impl(El::Matrix<T, El::Device::GPU>& m,
+                       const El::mpi::Comm& c,
+                       int root,
+                       Al::request& req)
+{
+  if (m.Width() > 1 && m.Height() != m.LDim()) {
+    return El::Broadcast(m, c, root);
+  }
+  const auto& syncinfo = El::SyncInfoFromMatrix(m);
+  ::Al::NonblockingBcast<::Al::NCCLBackend>(
+    m.Buffer(),
+    m.Height() * m.Width(),
+    root,
+    c.template GetComm<::Al::NCCLBackend>(syncinfo),
+    req.nccl_req);
+  UpdateRequest(req.nccl_req, syncinfo);
+}
+
+template <typename T,
+          El::EnableUnless<
+            El::AluminumSupportsBackendAndCollective<T,
+                                                     El::Collective::BROADCAST,
+                                                     ::Al::NCCLBackend>,
+            int> = 0>
+void nb_broadcast_impl(El::Matrix<T, El::Device::GPU>& m,
+                       const El::mpi::Comm& c,
+                       int root,
+                       Al::request& req)
+{
+  El::Broadcast(m, c, root);
+}
+#else
+template <typename T>
+void nb_broadcast_impl(El::Matrix<T, El::Device::GPU>& m,
+                       const El::mpi::Comm& c,
+                       int root,
+                       Al::request& req)
+{
+  El::Broadcast(m, c, root);
+}
+#endif // defined(LBANN_HAS_ALUMINUM) && defined(AL_HAS_NCCL)
+#endif // LBANN_HAS_GPU
+
+template <typename T>
+bool is_hierarchical_allreduce_size(El::AbstractMatrix<T> const& m)
+{
+  return ((m.Height() == m.LDim() || m.Width() == 1) &&
+          m.Height() * m.Width() >=
+            lbann_comm::hierarchical_allreduce_min_size);
+}
+
+// Reduce-scatter within the node, allreduce across nodes and
+// allgather within the node. Entries past a multiple of the node size
+// are reduced over the parent communicator.
+template <typename T, El::Device D>
+void hierarchical_allreduce_impl(El::Matrix<T, D>& m,
+                                 const El::mpi::Comm& c,
+                                 const El::mpi::Comm& node_comm,
+                                 const El::mpi::Comm& internode_comm,
+                                 El::mpi::Op const& op)
+{
+  const auto sync_info = El::SyncInfoFromMatrix(m);
+  const int node_size = El::mpi::Size(node_comm);
+  const int size = m.Height() * m.Width();
+  const int part_size = size / node_size;
+  const int tail_size = size - part_size * node_size;
+  El::Matrix<T, D> part;
+#ifdef LBANN_HAS_GPU
+  if constexpr (D == El::Device::GPU) {
+#ifdef HYDROGEN_HAVE_CUB
+    part.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                     // HYDROGEN_HAVE_CUB
+    El::SetSyncInfo(part, sync_info);
+  }
+#endif // LBANN_HAS_GPU
+  part.Resize(part_size, 1);
+  El::mpi::ReduceScatter(m.LockedBuffer(),
+                         part.Buffer(),
+                         part_size,
+                         op,
+                         node_comm,
+                         sync_info);
+  El::mpi::AllReduce(part.Buffer(), part_size, op, internode_comm, sync_info);
+  El::mpi::AllGather(part.LockedBuffer(),
+                     part_size,
+                     m.Buffer(),
+                     part_size,
+                     node_comm,
+                     sync_info);
+  if (tail_size > 0) {
+    El::mpi::AllReduce(m.Buffer() + part_size * node_size,
+                       tail_size,
+                       op,
+                       c,
+                       sync_info);
+  }
+}
+
 } // namespace
 
+void lbann_comm::clear_hierarchical_comms()
+{
+  for (auto& [parent, comms] : m_hierarchical_comms) {
+    El::mpi::Free(comms.node);
+    El::mpi::Free(comms.internode);
+  }
+  m_hierarchical_comms.clear();
+}
+
+auto lbann_comm::get_hierarchical_comms(const El::mpi::Comm& c) const
+  -> hierarchical_comms const*
+{
+  auto it = m_hierarchical_comms.find(c.GetMPIComm());
+  if (it == m_hierarchical_comms.end()) {
+    // Processes on a node are identified by the lowest world rank on it
+    auto& comms = m_hierarchical_comms[c.GetMPIComm()];
+    const int node_id = *std::min_element(m_world_ranks_on_node.begin(),
+                                          m_world_ranks_on_node.end());
+    const int rank = El::mpi::Rank(c);
+    El::mpi::Split(c, node_id, rank, comms.node);
+    El::mpi::Split(c, El::mpi::Rank(comms.node), rank, comms.internode);
+    const int node_size = El::mpi::Size(comms.node);
+    const int min_node_size = allreduce(node_size, c, El::mpi::MIN);
+    const int max_node_size = allreduce(node_size, c, El::mpi::MAX);
+    comms.usable = (min_node_size == max_node_size && node_size > 1 &&
+                    El::mpi::Size(comms.internode) > 1);
+    it = m_hierarchical_comms.find(c.GetMPIComm());
+  }
+  return it->second.usable ? &it->second : nullptr;
+}
+
 template <typename TensorDataType>
 void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
                            const El::mpi::Comm& c,
@@ -562,6 +820,31 @@ void lbann_comm::allreduce(El::AbstractMatrix<TensorDataType>& m,
   const int local_size = m.Height() * m.Width();
   m_bytes_sent += sizeof(DataType) * local_size;
   m_bytes_received += sizeof(DataType) * local_size * (El::mpi::Size(c) - 1);
+  blocking_comm_event event(*this, "allreduce", sizeof(DataType) * local_size);
+
+  const bool hierarchical =
+    (m_hierarchical_allreduce && is_hierarchical_allreduce_size(m));
+  auto const* comms = (hierarchical ? get_hierarchical_comms(c) : nullptr);
+  if (comms != nullptr) {
+    switch (m.GetDevice()) {
+    case El::Device::CPU:
+      return hierarchical_allreduce_impl(
+        static_cast<El::Matrix<TensorDataType, El::Device::CPU>&>(m),
+        c,
+        comms->node,
+        comms->internode,
+        op);
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU:
+      return hierarchical_allreduce_impl(
+        static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(m),
+        c,
+        comms->node,
+        comms->internode,
+        op);
+#endif // LBANN_HAS_GPU
+    }
+  }
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
@@ -600,6 +883,25 @@ void lbann_comm::nb_allreduce(El::AbstractMatrix<TensorDataType>& m,
   const int local_size = m.Height() * m.Width();
   m_bytes_sent += sizeof(DataType) * local_size;
   m_bytes_received += sizeof(DataType) * local_size * (El::mpi::Size(c) - 1);
+  req.profile_event =
+    begin_comm_event("nb_allreduce", sizeof(DataType) * local_size);
+
+#ifdef LBANN_HAS_GPU
+  // Stream-ordered, so it does not block the host either
+  const bool hierarchical =
+    (m_hierarchical_allreduce && m.GetDevice() == El::Device::GPU &&
+     is_hierarchical_allreduce_size(m));
+  if (hierarchical) {
+    if (auto const* comms = get_hierarchical_comms(c)) {
+      return hierarchical_allreduce_impl(
+        static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(m),
+        c,
+        comms->node,
+        comms->internode,
+        op);
+    }
+  }
+#endif // LBANN_HAS_GPU
 
   switch (m.GetDevice()) {
   case El::Device::CPU:
@@ -628,8 +930,60 @@ void lbann_comm::nb_allreduce(El::AbstractDistMatrix<TensorDataType>& m,
   nb_allreduce(m.Matrix(), c, req, op);
 }
 
+template <typename TensorDataType>
+bool lbann_comm::init_persistent_allreduce(
+  El::AbstractMatrix<TensorDataType>& m,
+  const El::mpi::Comm& c,
+  Al::request& req,
+  El::mpi::Op op) const
+{
+#if MPI_VERSION >= 4
+  const int local_size = m.Height() * m.Width();
+  const bool contiguous = (m.Height() == m.LDim() || m.Width() == 1);
+  if (m.GetDevice() != El::Device::CPU || !contiguous || local_size < 1 ||
+      El::mpi::Size(c) == 1 ||
+      (m_hierarchical_allreduce && is_hierarchical_allreduce_size(m))) {
+    return false;
+  }
+  checkMPI(MPI_Allreduce_init(MPI_IN_PLACE,
+                              m.Buffer(),
+                              local_size,
+                              El::mpi::TypeMap<TensorDataType>(),
+                              op.op,
+                              c.GetMPIComm(),
+                              MPI_INFO_NULL,
+                              &(req.raw_mpi_req)));
+  req.persistent_size = sizeof(DataType) * local_size;
+  return true;
+#else
+  return false;
+#endif // MPI_VERSION >= 4
+}
+
+void lbann_comm::start_persistent_allreduce(Al::request& req) const
+{
+  if (req.persistent_size == 0) {
+    LBANN_ERROR("request is not a persistent allreduce");
+  }
+  m_bytes_sent += req.persistent_size;
+  m_bytes_received += req.persistent_size;
+  req.profile_event =
+    begin_comm_event("persistent_allreduce", req.persistent_size);
+  checkMPI(MPI_Start(&(req.raw_mpi_req)));
+}
+
+void lbann_comm::free_persistent_allreduce(Al::request& req) const
+{
+  if (req.persistent_size != 0) {
+    checkMPI(MPI_Request_free(&(req.raw_mpi_req)));
+    req.persistent_size = 0;
+  }
+}
+
 void lbann_comm::wait(Al::request& req) const
 {
+  const double wait_start = (req.profile_event != 0 ? get_time() : 0.);
+  telemetry_timer wait_timer(telemetry_value::comm_wait_seconds);
 #ifdef LBANN_HAS_ALUMINUM
   if (req.mpi_req != Al::mpi_null_req) {
     ::Al::Wait<::Al::MPIBackend>(req.mpi_req);
@@ -651,6 +1005,8 @@ void lbann_comm::wait(Al::request& req) const
     MPI_Wait(&(req.raw_mpi_req), MPI_STATUS_IGNORE);
     ;
   }
+  end_comm_event(req.profile_event, wait_start);
+  req.profile_event = 0;
 }
 
 bool lbann_comm::test(Al::request& req) const
@@ -677,19 +1033,83 @@ bool lbann_comm::test(Al::request& req) const
     MPI_Test(&(req.raw_mpi_req), &flag, MPI_STATUS_IGNORE);
     req_test = flag;
   }
+  if (req_test && req.profile_event != 0) {
+    end_comm_event(req.profile_event, get_time());
+    req.profile_event = 0;
+  }
   return req_test;
 }
 
 void lbann_comm::intertrainer_broadcast_matrix(AbsMat& mat, int root) const
 {
+  blocking_comm_event event(
+    *this,
+    "intertrainer_broadcast_matrix",
+    (get_trainer_rank() == root ? sizeof(DataType) * mat.Height() * mat.Width()
+                                : 0));
   El::Broadcast(mat, m_intertrainer_comm, root);
 }
 
 void lbann_comm::intertrainer_broadcast_matrix(AbsDistMat& mat, int root) const
 {
+  blocking_comm_event event(*this,
+                            "intertrainer_broadcast_matrix",
+                            (get_trainer_rank() == root
+                               ? sizeof(DataType) * mat.LocalHeight() *
+                                   mat.LocalWidth()
+                               : 0));
   El::Broadcast(mat, m_intertrainer_comm, root);
 }
 
+void lbann_comm::nb_intertrainer_sum_matrix(AbsMat& mat,
+                                            Al::request& req) const
+{
+  nb_allreduce(mat, m_intertrainer_comm, req, El::mpi::SUM);
+}
+
+void lbann_comm::nb_intertrainer_sum_matrix(AbsDistMat& mat,
+                                            Al::request& req) const
+{
+  nb_allreduce(mat, m_intertrainer_comm, req, El::mpi::SUM);
+}
+
+void lbann_comm::nb_intertrainer_broadcast_matrix(AbsMat& mat,
+                                                  int root,
+                                                  Al::request& req) const
+{
+  if (m_num_trainers == 1 || mat.Height() < 1 || mat.Width() < 1) {
+    return;
+  }
+  const size_t bytes = sizeof(DataType) * mat.Height() * mat.Width();
+  count_bytes_broadcast(bytes, get_trainer_rank(), root);
+  req.profile_event =
+    begin_comm_event("nb_intertrainer_broadcast_matrix",
+                     (get_trainer_rank() == root ? bytes : 0));
+  switch (mat.GetDevice()) {
+  case El::Device::CPU:
+    return nb_broadcast_impl(
+      static_cast<El::Matrix<DataType, El::Device::CPU>&>(mat),
+      m_intertrainer_comm,
+      root,
+      req);
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return nb_broadcast_impl(
+      static_cast<El::Matrix<DataType, El::Device::GPU>&>(mat),
+      m_intertrainer_comm,
+      root,
+      req);
+#endif // LBANN_HAS_GPU
+  }
+}
+
+void lbann_comm::nb_intertrainer_broadcast_matrix(AbsDistMat& mat,
+                                                  int root,
+                                                  Al::request& req) const
+{
+  nb_intertrainer_broadcast_matrix(mat.Matrix(), root, req);
+}
+
 template <>
 void lbann_comm::broadcast<std::string>(const int root,
                                         std::string& str,
@@ -703,6 +1123,7 @@ void lbann_comm::broadcast<std::string>(const int root,
 void lbann_comm::intertrainer_barrier() const
 {
   ++m_num_intertrainer_barriers;
+  blocking_comm_event event(*this, "intertrainer_barrier", 0);
   barrier(m_intertrainer_comm);
 }
 
@@ -895,6 +1316,35 @@ const El::mpi::Comm& lbann_comm::get_packed_group_comm(int num_per_group) const
   return m_group_communicators[num_per_group];
 }
 
+const El::mpi::Comm& lbann_comm::get_sequence_comm(int num_splits) const
+{
+  auto it = m_sequence_comms.find(num_splits);
+  if (it == m_sequence_comms.end()) {
+    if (num_splits <= 0 || m_procs_per_trainer % num_splits != 0) {
+      LBANN_ERROR("Cannot split sequences over ",
+                  num_splits,
+                  " ranks in a trainer with ",
+                  m_procs_per_trainer,
+                  " processes");
+    }
+    auto& c = m_sequence_comms[num_splits];
+    El::mpi::Split(m_trainer_comm,
+                   m_rank_in_trainer / num_splits,
+                   m_rank_in_trainer % num_splits,
+                   c);
+    return c;
+  }
+  return it->second;
+}
+
+void lbann_comm::clear_sequence_comms()
+{
+  for (auto& [num_splits, c] : m_sequence_comms) {
+    El::mpi::Free(c);
+  }
+  m_sequence_comms.clear();
+}
+
 void lbann_comm::lbann_comm_abort(std::string msg) const
 {
   throw lbann_exception(msg);
@@ -946,7 +1396,12 @@ int get_rank_in_world()
   template void lbann_comm::nb_allreduce(El::AbstractDistMatrix<T>& m,         \
                                          const El::mpi::Comm& c,               \
                                          Al::request& req,                     \
-                                         El::mpi::Op op) const
+                                         El::mpi::Op op) const;                \
+  template bool lbann_comm::init_persistent_allreduce(                         \
+    El::AbstractMatrix<T>& m,                                                  \
+    const El::mpi::Comm& c,                                                    \
+    Al::request& req,                                                          \
+    El::mpi::Op op) const
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
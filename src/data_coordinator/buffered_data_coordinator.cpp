@@ -33,11 +33,15 @@
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/io/persist_impl.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/telemetry.hpp"
 #include "lbann/utils/tensor_impl.hpp"
+#include "lbann/utils/threads/thread_topology.hpp"
 
 namespace lbann {
 
@@ -63,6 +67,14 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
     LBANN_ERROR(
       "Models have not registered data fields with the data coordinator");
   }
+  m_raw_input_transfer =
+    global_argument_parser().get<bool>(LBANN_OPTION_RAW_INPUT_TRANSFER);
+  m_num_io_worker_processes =
+    global_argument_parser().get<int>(LBANN_OPTION_NUM_IO_WORKER_PROCESSES);
+  m_mini_batch_cache_budget =
+    static_cast<size_t>(
+      global_argument_parser().get<int>(LBANN_OPTION_MINI_BATCH_CACHE_MB)) *
+    1024 * 1024;
 
 #ifdef LBANN_HAS_DISTCONV
   if (dc::is_cosmoflow_parallel_io_enabled()) {
@@ -108,6 +120,10 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
   }
 #endif // LBANN_HAS_DISTCONV
 
+  // The I/O threads fill the input buffers, so keep their pages on
+  // the I/O threads' NUMA node
+  io_local_memory_scope io_local_memory;
+
   // Check to see if there are any data fields with unallocated buffers
   for (auto& data_field : m_active_data_fields) {
     for (const auto& buf_map : m_data_buffers) {
@@ -136,6 +152,7 @@ void buffered_data_coordinator<TensorDataType>::setup_data_fields(
 template <typename TensorDataType>
 int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
   data_buffer_map_t& buffer_map,
+  const mini_batch_cursor& cursor,
   const execution_mode mode)
 {
   generic_data_reader* dr = get_data_reader(mode);
@@ -147,6 +164,7 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
   data_buffer<IODataType>& buf = get_data_buffer(buffer_map, mode);
 
   buf.m_num_samples_fetched = 0;
+  buf.m_max_sample_length = 0;
   /// BVE FIXME change the guard
   if (this->m_comm->get_rank_in_trainer() < num_parallel_readers &&
       (buf.m_input_buffers[INPUT_DATA_TYPE_SAMPLES]->LocalHeight() != 0 &&
@@ -160,30 +178,134 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
 
     // Compute the size of the current mini-batch
 
-    int loaded_batch_size = dr->get_loaded_mini_batch_size();
+    int loaded_batch_size = cursor.loaded_mini_batch_size;
     const int end_pos =
-      std::min(static_cast<size_t>(dr->m_current_pos + loaded_batch_size),
+      std::min(static_cast<size_t>(cursor.pos + loaded_batch_size),
                dr->m_shuffled_indices.size());
     const int mb_size = std::min(
-      El::Int{((end_pos - dr->m_current_pos) + dr->m_sample_stride - 1) /
+      El::Int{((end_pos - cursor.pos) + dr->m_sample_stride - 1) /
               dr->m_sample_stride},
       local_input_buffers[INPUT_DATA_TYPE_SAMPLES]->Width());
 
+    const bool use_cache = use_mini_batch_cache(dr, mode);
+    const bool cache_hit =
+      use_cache &&
+      load_cached_mini_batch(buf, local_input_buffers, cursor, mb_size, mode);
+
     /** @brief Each rank will fetch a mini-batch worth of data into it's buffer
      */
-    if (dr->has_conduit_output()) {
+    if (cache_hit) {
+      // Packed by an earlier pass over the data set
+    }
+#ifdef LBANN_HAS_GPU
+    else if (dr->supports_device_fetch() &&
+             buf.has_device_buffer(INPUT_DATA_TYPE_SAMPLES)) {
+      // The data reader generates the samples in the device buffer,
+      // so they never pass through the host buffer
+      buf.m_num_samples_fetched =
+        dr->fetch_to_device(buf.get_device_output(INPUT_DATA_TYPE_SAMPLES),
+                            buf.m_indices_fetched_per_mb,
+                            mb_size,
+                            cursor.pos,
+                            cursor.next_epoch);
+      buf.set_fetched_on_device(INPUT_DATA_TYPE_SAMPLES, true);
+      local_input_buffers.erase(INPUT_DATA_TYPE_SAMPLES);
+    }
+#endif // LBANN_HAS_GPU
+    else if (dr->has_conduit_output()) {
       std::vector<conduit::Node> samples(mb_size);
       buf.m_num_samples_fetched =
-        dr->fetch(samples, buf.m_indices_fetched_per_mb, mb_size);
+        dr->fetch(samples,
+                  buf.m_indices_fetched_per_mb,
+                  mb_size,
+                  cursor.pos,
+                  cursor.next_epoch);
+      io_stage_scope pack_timer(&m_io_statistics.at(mode), io_stage::pack);
+#ifdef LBANN_HAS_GPU
+      if (m_raw_input_transfer) {
+        // Fields consumed on the GPU and stored as uint8 are packed
+        // without conversion; stage_to_device() converts them
+        for (auto it = local_input_buffers.begin();
+             it != local_input_buffers.end();) {
+          const auto& data_field = it->first;
+          if (buf.has_device_buffer(data_field) &&
+              data_packer::extract_raw_data_field_from_samples(
+                samples,
+                data_field,
+                buf.get_raw_input_buffer(data_field))) {
+            buf.set_fetched_raw(data_field, true);
+            it = local_input_buffers.erase(it);
+          }
+          else {
+            ++it;
+          }
+        }
+      }
+#endif // LBANN_HAS_GPU
       data_packer::extract_data_fields_from_samples(samples,
                                                     local_input_buffers);
     }
+    else if (io_worker_pool* pool =
+               get_io_worker_pool(dr, local_input_buffers, mode)) {
+      const std::vector<int> indices =
+        dr->get_mini_batch_indices(cursor.pos, mb_size, cursor.next_epoch);
+      if (!indices.empty()) {
+        pool->fetch(local_input_buffers, indices, dr->claim_fetch_sequence());
+      }
+      for (size_t s = 0; s < indices.size(); ++s) {
+        buf.m_indices_fetched_per_mb.Set(s, 0, indices[s]);
+      }
+      buf.m_num_samples_fetched = indices.size();
+    }
     else {
-      buf.m_num_samples_fetched =
-        dr->fetch(local_input_buffers, buf.m_indices_fetched_per_mb, mb_size);
+#ifdef LBANN_HAS_GPU
+      // Images bound for the GPU are left as uint8 after the geometric
+      // transforms; stage_to_device() finishes them
+      data_packer::raw_image_conversion conv;
+      const bool raw_images =
+        m_raw_input_transfer && !use_cache &&
+        buf.has_device_buffer(INPUT_DATA_TYPE_SAMPLES) &&
+        dr->get_raw_image_conversion(conv);
+      if (raw_images) {
+        dr->set_raw_samples_buffer(
+          &buf.get_raw_input_buffer(INPUT_DATA_TYPE_SAMPLES));
+      }
+#endif // LBANN_HAS_GPU
+      buf.m_num_samples_fetched = dr->fetch(local_input_buffers,
+                                            buf.m_indices_fetched_per_mb,
+                                            mb_size,
+                                            cursor.pos,
+                                            cursor.next_epoch);
+#ifdef LBANN_HAS_GPU
+      if (raw_images) {
+        dr->set_raw_samples_buffer(nullptr);
+        buf.set_fetched_raw(INPUT_DATA_TYPE_SAMPLES, true);
+        buf.set_raw_image_conversion(INPUT_DATA_TYPE_SAMPLES, conv);
+      }
+#endif // LBANN_HAS_GPU
+    }
+
+    if (dr->has_sample_lengths()) {
+      for (El::Int s = 0; s < buf.m_num_samples_fetched; ++s) {
+        const int index = buf.m_indices_fetched_per_mb.Get(s, 0);
+        buf.m_max_sample_length =
+          std::max(buf.m_max_sample_length, dr->get_sample_length(index));
+      }
+    }
+
+    if (use_cache && !cache_hit) {
+      cache_mini_batch(buf, local_input_buffers, cursor, mode);
     }
 
     bool data_valid = (buf.m_num_samples_fetched > 0);
+    if (data_valid && telemetry_enabled()) {
+      size_t bytes = 0;
+      for (const auto& b : buf.m_input_buffers) {
+        bytes += b.second->LocalHeight() * buf.m_num_samples_fetched;
+      }
+      telemetry_add(telemetry_value::input_samples, buf.m_num_samples_fetched);
+      telemetry_add(telemetry_value::input_bytes, bytes * sizeof(IODataType));
+    }
     if (data_valid) {
       //      m_num_data_per_epoch+=num_samples_fetched; /// BVE FIXME need to
       //      change how this is shared
@@ -193,6 +315,129 @@ int buffered_data_coordinator<TensorDataType>::fetch_to_local_matrix(
   return buf.m_num_samples_fetched;
 }
 
+template <typename TensorDataType>
+bool buffered_data_coordinator<TensorDataType>::use_mini_batch_cache(
+  generic_data_reader* dr,
+  execution_mode mode) const
+{
+  // Positions only name the same samples in every pass when the
+  // reader does not shuffle
+  return m_mini_batch_cache_budget > 0 &&
+         (mode == execution_mode::validation ||
+          mode == execution_mode::testing) &&
+         !dr->is_shuffled();
+}
+
+template <typename TensorDataType>
+bool buffered_data_coordinator<TensorDataType>::load_cached_mini_batch(
+  data_buffer<IODataType>& buf,
+  std::map<data_field_type, CPUMat*>& local_buffers,
+  const mini_batch_cursor& cursor,
+  El::Int mb_size,
+  execution_mode mode)
+{
+  const auto& cache = m_mini_batch_cache[mode];
+  const auto it = cache.find(cursor.pos);
+  if (it == cache.end() || it->second.num_samples != mb_size) {
+    return false;
+  }
+  const cached_mini_batch& cached = it->second;
+  if (buf.m_indices_fetched_per_mb.Height() < mb_size) {
+    return false;
+  }
+  for (const auto& [data_field, mat] : local_buffers) {
+    const auto field = cached.fields.find(data_field);
+    if (field == cached.fields.end() ||
+        field->second.Height() != mat->Height() || mat->Width() < mb_size) {
+      return false;
+    }
+  }
+  for (auto& [data_field, mat] : local_buffers) {
+    auto mat_v = El::View(*mat, El::ALL, El::IR(0, mb_size));
+    El::Copy(cached.fields.at(data_field), mat_v);
+  }
+  auto indices_v =
+    El::View(buf.m_indices_fetched_per_mb, El::IR(0, mb_size), El::ALL);
+  El::Copy(cached.indices, indices_v);
+  buf.m_num_samples_fetched = mb_size;
+  return true;
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::cache_mini_batch(
+  const data_buffer<IODataType>& buf,
+  const std::map<data_field_type, CPUMat*>& local_buffers,
+  const mini_batch_cursor& cursor,
+  execution_mode mode)
+{
+  const El::Int num_samples = buf.m_num_samples_fetched;
+  // Fields shipped to the GPU raw or generated there are not in the
+  // local buffers
+  if (num_samples <= 0 || local_buffers.size() != buf.m_input_buffers.size()) {
+    return;
+  }
+  size_t size = sizeof(El::Int) * num_samples;
+  for (const auto& [data_field, mat] : local_buffers) {
+    size += sizeof(DataType) * mat->Height() * num_samples;
+  }
+  auto& cache = m_mini_batch_cache[mode];
+  const auto old = cache.find(cursor.pos);
+  if (old != cache.end()) {
+    // The mini-batch size changed since it was cached
+    m_mini_batch_cache_size -= sizeof(El::Int) * old->second.num_samples;
+    for (const auto& [data_field, mat] : old->second.fields) {
+      m_mini_batch_cache_size -= sizeof(DataType) * mat.Height() * mat.Width();
+    }
+    cache.erase(old);
+  }
+  if (m_mini_batch_cache_size + size > m_mini_batch_cache_budget) {
+    return;
+  }
+  cached_mini_batch& cached = cache[cursor.pos];
+  cached.num_samples = num_samples;
+  El::Copy(El::LockedView(buf.m_indices_fetched_per_mb,
+                          El::IR(0, num_samples),
+                          El::ALL),
+           cached.indices);
+  for (const auto& [data_field, mat] : local_buffers) {
+    El::Copy(El::LockedView(*mat, El::ALL, El::IR(0, num_samples)),
+             cached.fields[data_field]);
+  }
+  m_mini_batch_cache_size += size;
+}
+
+template <typename TensorDataType>
+io_worker_pool* buffered_data_coordinator<TensorDataType>::get_io_worker_pool(
+  generic_data_reader* dr,
+  const std::map<data_field_type, CPUMat*>& local_buffers,
+  execution_mode mode)
+{
+  if (m_num_io_worker_processes <= 0 || !dr->supports_io_worker_processes()) {
+    return nullptr;
+  }
+  auto& pool = m_io_worker_pools[mode];
+  if (pool == nullptr) {
+    // Callers hold dr_mutex, so no I/O thread is running while the
+    // workers are forked
+    std::map<data_field_type, El::Int> field_heights;
+    El::Int max_samples = 0;
+    for (const auto& [data_field, mat] : local_buffers) {
+      field_heights[data_field] = mat->Height();
+      max_samples = std::max(max_samples, mat->Width());
+    }
+    const El::Int max_mini_batch_size = get_trainer().get_max_mini_batch_size();
+    max_samples =
+      std::max(max_samples,
+               El::Int{(max_mini_batch_size + dr->m_sample_stride - 1) /
+                       dr->m_sample_stride});
+    pool = std::make_unique<io_worker_pool>(*dr,
+                                            m_num_io_worker_processes,
+                                            field_heights,
+                                            max_samples);
+  }
+  return pool.get();
+}
+
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::fp_setup_data(
   data_buffer<IODataType>& buffer,
@@ -209,17 +454,99 @@ void buffered_data_coordinator<TensorDataType>::fp_setup_data(
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::fetch_data_in_background(
   int future_active_buffer,
+  mini_batch_cursor cursor,
   execution_mode mode)
 {
   int active_buffer_idx = future_active_buffer % m_data_buffers.size();
   data_buffer_map_t& buffer_map = m_data_buffers[active_buffer_idx];
   std::lock_guard<std::mutex> guard(dr_mutex);
-  int mini_batch_size = get_current_mini_batch_size(mode);
-  fp_setup_data(*buffer_map[mode], mini_batch_size);
-  fetch_to_local_matrix(buffer_map, mode);
+  io_stage_scope fetch_timer(&m_io_statistics.at(mode), io_stage::fetch);
+#ifdef LBANN_HAS_GPU
+  buffer_map[mode]->release_device_staging();
+#endif // LBANN_HAS_GPU
+  fp_setup_data(*buffer_map[mode], cursor.current_mini_batch_size);
+  fetch_to_local_matrix(buffer_map, cursor, mode);
+#ifdef LBANN_HAS_GPU
+  // Copy to the device now so that the transfer overlaps with
+  // the steps that are still executing
+  buffer_map[mode]->stage_to_device();
+#endif // LBANN_HAS_GPU
   return;
 }
 
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::queue_background_fetches(
+  execution_mode mode)
+{
+  generic_data_reader* dr = get_data_reader(mode);
+  const int active_idx = this->get_active_buffer_idx(mode);
+  const int num_buffers = m_data_buffers.size();
+  int& last_queued = m_last_queued_buffer[mode];
+
+  // The reader is positioned at the mini-batch after the active one,
+  // so buffer active_idx + 1 + ahead holds the mini-batch that is
+  // 'ahead' steps past the reader.  The queued count only depends on
+  // the step, so every rank takes part in the same exchanges.
+  const bool cross_epoch = dr->supports_cross_epoch_fetch();
+  io_statistics* exchange_stats =
+    dr->data_store_active() ? &m_io_statistics.at(mode) : nullptr;
+  for (int buffer_idx = std::max(active_idx, last_queued) + 1;
+       buffer_idx < active_idx + num_buffers;
+       ++buffer_idx) {
+    const int ahead = buffer_idx - active_idx - 1;
+    mini_batch_cursor cursor;
+    if (!dr->get_mini_batch_cursor(ahead, cursor, cross_epoch)) {
+      break;
+    }
+    if (cursor.next_epoch && !dr->next_epoch_is_shuffled()) {
+      // Fetches queued during the previous epoch may still read the
+      // indices that are about to be reshuffled
+      collect_background_data_fetch(mode);
+      dr->shuffle_next_epoch_indices();
+    }
+    if (dr->data_store_active()) {
+      // The exchange replaces the samples that queued fetches read
+      collect_background_data_fetch(mode);
+    }
+    {
+      io_stage_scope exchange_timer(exchange_stats, io_stage::exchange);
+      dr->start_data_store_mini_batch_exchange(ahead);
+      dr->finish_data_store_mini_batch_exchange();
+    }
+    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
+      std::bind(&buffered_data_coordinator::fetch_data_in_background,
+                this,
+                buffer_idx,
+                cursor,
+                mode));
+    data_buffer<IODataType>& io_buffer =
+      get_data_buffer(m_data_buffers[buffer_idx % num_buffers], mode);
+    io_buffer.set_data_fetch_future(std::move(background_fetch_done));
+    io_buffer.set_fetch_data_in_background(true);
+    last_queued = buffer_idx;
+  }
+}
+
+template <typename TensorDataType>
+void buffered_data_coordinator<TensorDataType>::queue_validation_fetches()
+{
+  // Start on the validation set while the last training steps run
+  generic_data_reader* train_dr = get_data_reader(execution_mode::training);
+  generic_data_reader* valid_dr =
+    get_data_reader(execution_mode::validation);
+  if (valid_dr == nullptr || valid_dr->is_load_deferred() ||
+      !valid_dr->supports_cross_epoch_fetch() ||
+      !at_new_epoch(execution_mode::validation)) {
+    return;
+  }
+  mini_batch_cursor cursor;
+  const int tail = m_data_buffers.size() - 1;
+  if (train_dr->get_mini_batch_cursor(tail, cursor)) {
+    return;
+  }
+  queue_background_fetches(execution_mode::validation);
+}
+
 /// Check for each buffer if there is an outstanding fetch request
 template <typename TensorDataType>
 void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(
@@ -230,6 +557,9 @@ void buffered_data_coordinator<TensorDataType>::collect_background_data_fetch(
     if (it != buffer_map.end()) {
       data_buffer<IODataType>& io_buffer = *buffer_map[mode];
       if (io_buffer.is_data_fetched_in_background()) {
+        io_stage_scope blocked_timer(&m_io_statistics.at(mode),
+                                     io_stage::blocked);
+        telemetry_timer wait_timer(telemetry_value::data_wait_seconds);
         io_buffer.get_data_fetch_future().get();
         io_buffer.set_fetch_data_in_background(false);
       }
@@ -244,27 +574,45 @@ void buffered_data_coordinator<TensorDataType>::fetch_data(execution_mode mode)
   increment_active_buffer_idx(mode);
 
   data_buffer<IODataType>& active_buffer = get_active_buffer(mode);
-
-  // If there is no valid data and there is not already a background
-  // thread to fetch the data, queue up the background thread
-  if (active_buffer.num_samples_ready() == 0 &&
-      !active_buffer.is_data_fetched_in_background()) {
-    // Start data store exchange if necessary (this should be move
-    // earlier as a future optimization)
-    get_data_reader(mode)->start_data_store_mini_batch_exchange();
-    // Finish data store exchange before accessing samples
-    get_data_reader(mode)->finish_data_store_mini_batch_exchange();
+  const int active_idx = this->get_active_buffer_idx(mode);
+
+  // If the active buffer was not queued during a previous step,
+  // queue up the background thread for it now
+  if (active_idx > m_last_queued_buffer[mode]) {
+    generic_data_reader* dr = get_data_reader(mode);
+    if (dr->data_store_active()) {
+      collect_background_data_fetch(mode);
+    }
+    {
+      io_stage_scope exchange_timer(
+        dr->data_store_active() ? &m_io_statistics.at(mode) : nullptr,
+        io_stage::exchange);
+      // Start data store exchange if necessary
+      dr->start_data_store_mini_batch_exchange();
+      // Finish data store exchange before accessing samples
+      dr->finish_data_store_mini_batch_exchange();
+    }
+    mini_batch_cursor cursor;
+    if (!dr->get_mini_batch_cursor(0, cursor)) {
+      LBANN_ERROR("data reader for ",
+                  to_string(mode),
+                  " is positioned past the end of its epoch");
+    }
     std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
       std::bind(&buffered_data_coordinator::fetch_data_in_background,
                 this,
-                this->get_active_buffer_idx(mode),
+                active_idx,
+                cursor,
                 mode));
     active_buffer.set_data_fetch_future(std::move(background_fetch_done));
     active_buffer.set_fetch_data_in_background(true);
+    m_last_queued_buffer[mode] = active_idx;
   }
 
   // Wait for the background thread to complete fetching the data
   if (active_buffer.is_data_fetched_in_background()) {
+    io_stage_scope blocked_timer(&m_io_statistics.at(mode), io_stage::blocked);
+    telemetry_timer wait_timer(telemetry_value::data_wait_seconds);
     active_buffer.get_data_fetch_future().get();
     active_buffer.set_fetch_data_in_background(false);
   }
@@ -297,24 +645,15 @@ bool buffered_data_coordinator<TensorDataType>::epoch_complete(
   // This is because the data reader has state about the current step
   // in epoch.  In a future PR this state should be moved to the data
   // coordinator
-  if (!m_data_set_processed && m_trainer->background_io_activity_allowed()) {
-    int next_active_buffer = this->get_active_buffer_idx(mode) + 1;
-    // Start data store exchange if necessary (this should be move
-    // earlier as a future optimization)
-    get_data_reader(mode)->start_data_store_mini_batch_exchange();
-    // Finish data store exchange before accessing samples
-    get_data_reader(mode)->finish_data_store_mini_batch_exchange();
-    std::future<void> background_fetch_done = get_io_thread_pool().submit_job(
-      std::bind(&buffered_data_coordinator::fetch_data_in_background,
-                this,
-                next_active_buffer,
-                mode));
-    data_buffer_map_t& next_io_buffer_map =
-      m_data_buffers[next_active_buffer % m_data_buffers.size()];
-    data_buffer<IODataType>& next_io_buffer =
-      get_data_buffer(next_io_buffer_map, mode);
-    next_io_buffer.set_data_fetch_future(std::move(background_fetch_done));
-    next_io_buffer.set_fetch_data_in_background(true);
+  if (m_trainer->background_io_activity_allowed()) {
+    // Readers that shuffle ahead keep fetching across the boundary
+    if (!m_data_set_processed ||
+        get_data_reader(mode)->supports_cross_epoch_fetch()) {
+      queue_background_fetches(mode);
+    }
+    if (mode == execution_mode::training && !m_data_set_processed) {
+      queue_validation_fetches();
+    }
   }
   return m_data_set_processed;
 }
@@ -397,6 +736,13 @@ buffered_data_coordinator<TensorDataType>::get_sample_indices_per_mb(
       .get_sample_indices_per_mb(mode));
 }
 
+template <typename TensorDataType>
+int buffered_data_coordinator<TensorDataType>::get_max_sample_length(
+  execution_mode mode) const
+{
+  return get_active_buffer(mode).m_max_sample_length;
+}
+
 template <typename TensorDataType>
 bool buffered_data_coordinator<TensorDataType>::update_data_set(
   generic_data_reader* data_reader,
@@ -428,7 +774,44 @@ void buffered_data_coordinator<TensorDataType>::distribute_from_local_matrix(
   if (buf.m_input_buffers.find(data_field) == buf.m_input_buffers.end()) {
     LBANN_ERROR("Unknown data_field_type value requested: " + data_field);
   }
-  view_or_copy_tensor(*buf.m_input_buffers[data_field], input_buffer);
+  // Distribute only the columns of the current micro-batch
+  std::unique_ptr<AbsDistMatrixType> micro_batch_view;
+  auto source =
+    [&](AbsDistMatrixType const& full) -> AbsDistMatrixType const& {
+    if (this->m_num_micro_batches == 1) {
+      return full;
+    }
+    micro_batch_view.reset(full.Construct(full.Grid(), full.Root()));
+    El::LockedView(*micro_batch_view,
+                   full,
+                   El::ALL,
+                   this->get_current_micro_batch_range(mode));
+    return *micro_batch_view;
+  };
+#ifdef LBANN_HAS_GPU
+  if (input_buffer.GetLocalDevice() == El::Device::GPU) {
+    // Copy from the staged device buffer, waiting on the staging
+    // stream rather than copying from the host on the compute stream
+    if (!buf.has_device_buffer(data_field)) {
+      buf.initialize_device_buffer_for_data_field(data_field, this->m_comm);
+    }
+    if (!buf.is_staged_on_device(data_field)) {
+      buf.stage_to_device(data_field);
+    }
+    auto compute_sync_info = gpu::get_sync_info(input_buffer);
+    El::AddSynchronizationPoint(buf.get_copy_sync_info(), compute_sync_info);
+    do_tensor_copy(source(*buf.m_device_buffers[data_field]), input_buffer);
+    // Later staging copies must not overwrite the device buffer
+    // before this copy is done
+    El::AddSynchronizationPoint(compute_sync_info, buf.get_copy_sync_info());
+  }
+  else {
+    view_or_copy_tensor(source(*buf.m_input_buffers[data_field]),
+                        input_buffer);
+  }
+#else
+  view_or_copy_tensor(source(*buf.m_input_buffers[data_field]), input_buffer);
+#endif // LBANN_HAS_GPU
 #ifdef LBANN_HAS_DISTCONV
   if (dc::is_cosmoflow_parallel_io_enabled() &&
       data_field == INPUT_DATA_TYPE_RESPONSES) {
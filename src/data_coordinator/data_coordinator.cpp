@@ -31,6 +31,7 @@
 #include <lbann/trainers/trainer.hpp>
 #include <lbann/utils/distconv.hpp>
 #include <lbann/utils/serialize.hpp>
+#include <lbann/utils/timer.hpp>
 
 namespace lbann {
 
@@ -55,6 +56,9 @@ data_coordinator::data_coordinator(const data_coordinator& other)
   : m_comm(other.m_comm),
     m_datasets(other.m_datasets),
     m_data_readers(other.m_data_readers),
+    m_max_mini_batch_size(other.m_max_mini_batch_size),
+    m_shard_eval_across_trainers(other.m_shard_eval_across_trainers),
+    m_io_statistics(other.m_io_statistics),
     m_data_set_processed(other.m_data_set_processed),
     m_execution_context(other.m_execution_context)
 {
@@ -87,12 +91,28 @@ void data_coordinator::setup(
   std::map<execution_mode, generic_data_reader*> data_readers)
 {
   m_io_thread_pool = &io_thread_pool;
+  m_max_mini_batch_size = max_mini_batch_size;
 
   m_data_readers = data_readers;
 
-  // Initialize the data sets
+  // Split the evaluation sets across trainers. Deferred readers are
+  // split when they are loaded.
+  m_shard_eval_across_trainers =
+    (global_argument_parser().get<bool>(
+       LBANN_OPTION_SHARD_EVAL_ACROSS_TRAINERS) &&
+     m_comm->get_num_trainers() > 1);
+  for (auto m : {execution_mode::validation, execution_mode::testing}) {
+    if (is_sharded_across_trainers(m) && m_data_readers.count(m) &&
+        m_data_readers[m] && !m_data_readers[m]->is_load_deferred()) {
+      m_data_readers[m]->shard_across_trainers();
+    }
+  }
+
+  // Initialize the data sets. Deferred readers are set up when they
+  // are loaded.
   for (auto m : execution_mode_iterator()) {
-    if (this->m_data_readers.count(m)) {
+    if (this->m_data_readers.count(m) && m_data_readers[m] &&
+        !m_data_readers[m]->is_load_deferred()) {
       this->m_datasets[m].total_samples() = m_data_readers[m]->get_num_data();
     }
   }
@@ -101,7 +121,7 @@ void data_coordinator::setup(
   // ones will null data readers.  Fix this in next PR.
   // Setup data readers
   for (auto&& dr : m_data_readers) {
-    if (!dr.second)
+    if (!dr.second || dr.second->is_load_deferred())
       continue;
     dr.second->setup(m_io_thread_pool->get_num_threads(), m_io_thread_pool);
   }
@@ -110,7 +130,7 @@ void data_coordinator::setup(
    *  and validation given a specified mini-batch size.
    */
   for (auto&& dr : m_data_readers) {
-    if (!dr.second)
+    if (!dr.second || dr.second->is_load_deferred())
       continue;
     calculate_num_iterations_per_epoch(max_mini_batch_size, dr.second);
   }
@@ -125,13 +145,49 @@ void data_coordinator::setup(
       std::cout << "\nUSING DATA STORE!\n\n";
     }
     for (auto&& r : m_data_readers) {
-      if (!r.second)
+      if (!r.second || r.second->is_load_deferred())
         continue;
       r.second->setup_data_store(max_mini_batch_size);
     }
   }
 }
 
+void data_coordinator::load_deferred_reader(execution_mode mode)
+{
+  generic_data_reader* dr = get_data_reader(mode);
+  if (dr == nullptr || !dr->is_load_deferred()) {
+    return;
+  }
+  const double start = get_time();
+  dr->load();
+  dr->set_load_deferred(false);
+  if (is_sharded_across_trainers(mode)) {
+    dr->shard_across_trainers();
+  }
+  m_datasets[mode].total_samples() = dr->get_num_data();
+  dr->setup(m_io_thread_pool->get_num_threads(), m_io_thread_pool);
+  calculate_num_iterations_per_epoch(m_max_mini_batch_size, dr);
+  auto& arg_parser = global_argument_parser();
+  if (arg_parser.get<bool>(LBANN_OPTION_USE_DATA_STORE) ||
+      arg_parser.get<bool>(LBANN_OPTION_PRELOAD_DATA_STORE) ||
+      arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_CACHE) ||
+      arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_SPILL) != "") {
+    dr->setup_data_store(m_max_mini_batch_size);
+  }
+  if (m_comm->am_world_master()) {
+    std::cout << "Loaded the " << to_string(mode) << " data reader ("
+              << dr->get_num_data() << " samples) in " << get_time() - start
+              << "s" << std::endl;
+  }
+}
+
+bool data_coordinator::is_sharded_across_trainers(execution_mode mode) const
+{
+  return (m_shard_eval_across_trainers &&
+          (mode == execution_mode::validation ||
+           mode == execution_mode::testing));
+}
+
 void data_coordinator::calculate_num_iterations_per_epoch(
   int max_mini_batch_size,
   generic_data_reader* data_reader)
@@ -207,6 +263,8 @@ void data_coordinator::calculate_num_iterations_per_epoch(
     data_reader->get_stride_to_next_mini_batch());
   data_reader->set_global_mini_batch_size(max_mini_batch_size);
   data_reader->set_global_last_mini_batch_size(last_mini_batch_size);
+  // The initial shuffle ran before the mini-batch stride was known
+  data_reader->bucket_shuffled_indices();
   return;
 }
 
@@ -492,6 +550,34 @@ long data_coordinator::get_total_num_samples(execution_mode m) const
   }
 }
 
+io_stage_summary data_coordinator::get_io_stage_summary(execution_mode mode,
+                                                        io_stage stage)
+{
+  io_stage_summary summary;
+  for (const auto& thread_summary : get_io_thread_summaries(mode, stage)) {
+    summary.add(thread_summary);
+  }
+  std::lock_guard<std::mutex> guard(dr_mutex);
+  summary.add(m_io_statistics.at(mode)[stage]);
+  return summary;
+}
+
+std::vector<io_stage_summary>
+data_coordinator::get_io_thread_summaries(execution_mode mode, io_stage stage)
+{
+  std::vector<io_stage_summary> summaries;
+  const generic_data_reader* dr = get_data_reader(mode);
+  if (dr == nullptr) {
+    return summaries;
+  }
+  std::lock_guard<std::mutex> guard(dr_mutex);
+  for (const auto& stats : dr->get_io_thread_statistics()) {
+    summaries.emplace_back();
+    summaries.back().add(stats[stage]);
+  }
+  return summaries;
+}
+
 long data_coordinator::update_num_samples_processed(execution_mode mode,
                                                     long num_samples)
 {
@@ -508,7 +594,7 @@ bool data_coordinator::is_execution_mode_valid(execution_mode mode) const
 void data_coordinator::calculate_num_iterations_per_epoch(int mini_batch_size)
 {
   for (auto&& dr : m_data_readers) {
-    if (!dr.second)
+    if (!dr.second || dr.second->is_load_deferred())
       continue;
     calculate_num_iterations_per_epoch(mini_batch_size, dr.second);
   }
@@ -616,6 +702,36 @@ int data_coordinator::get_current_mini_batch_size(execution_mode mode) const
                                   : 0;
 }
 
+void data_coordinator::set_micro_batch(int index, int num_micro_batches)
+{
+  if (num_micro_batches < 1 || index < 0 || index >= num_micro_batches) {
+    LBANN_ERROR("invalid micro-batch ",
+                index,
+                " of ",
+                num_micro_batches,
+                " micro-batches");
+  }
+  m_micro_batch_index = index;
+  m_num_micro_batches = num_micro_batches;
+}
+
+El::IR data_coordinator::get_current_micro_batch_range(
+  execution_mode mode) const
+{
+  const El::Int mini_batch_size = get_current_mini_batch_size(mode);
+  const El::Int begin =
+    mini_batch_size * m_micro_batch_index / m_num_micro_batches;
+  const El::Int end =
+    mini_batch_size * (m_micro_batch_index + 1) / m_num_micro_batches;
+  return El::IR(begin, end);
+}
+
+int data_coordinator::get_current_micro_batch_size(execution_mode mode) const
+{
+  const auto range = get_current_micro_batch_range(mode);
+  return range.end - range.beg;
+}
+
 int data_coordinator::get_global_mini_batch_size(execution_mode mode) const
 {
   const generic_data_reader* data_reader = get_data_reader(mode);
@@ -673,11 +789,13 @@ bool data_coordinator::save_to_checkpoint_shared(persist& p) const
       (it->second)->save_to_checkpoint_shared(p, execution_mode::training);
     }
     it = this->m_data_readers.find(execution_mode::testing);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)->save_to_checkpoint_shared(p, execution_mode::testing);
     }
     it = this->m_data_readers.find(execution_mode::validation);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)->save_to_checkpoint_shared(p, execution_mode::validation);
     }
 
@@ -702,11 +820,13 @@ bool data_coordinator::load_from_checkpoint_shared(persist& p)
       (it->second)->load_from_checkpoint_shared(p, execution_mode::training);
     }
     it = this->m_data_readers.find(execution_mode::testing);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)->load_from_checkpoint_shared(p, execution_mode::testing);
     }
     it = this->m_data_readers.find(execution_mode::validation);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)->load_from_checkpoint_shared(p, execution_mode::validation);
     }
 
@@ -741,11 +861,13 @@ bool data_coordinator::save_to_checkpoint_distributed(persist& p) const
       (it->second)->save_to_checkpoint_distributed(p, execution_mode::training);
     }
     it = this->m_data_readers.find(execution_mode::testing);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)->save_to_checkpoint_distributed(p, execution_mode::testing);
     }
     it = this->m_data_readers.find(execution_mode::validation);
-    if ((it != this->m_data_readers.end()) && it->second) {
+    if ((it != this->m_data_readers.end()) && it->second &&
+        !it->second->is_load_deferred()) {
       (it->second)
         ->save_to_checkpoint_distributed(p, execution_mode::validation);
     }
@@ -765,11 +887,13 @@ bool data_coordinator::load_from_checkpoint_distributed(persist& p)
     (it->second)->load_from_checkpoint_distributed(p, execution_mode::training);
   }
   it = this->m_data_readers.find(execution_mode::testing);
-  if ((it != this->m_data_readers.end()) && it->second) {
+  if ((it != this->m_data_readers.end()) && it->second &&
+      !it->second->is_load_deferred()) {
     (it->second)->load_from_checkpoint_distributed(p, execution_mode::testing);
   }
   it = this->m_data_readers.find(execution_mode::validation);
-  if ((it != this->m_data_readers.end()) && it->second) {
+  if ((it != this->m_data_readers.end()) && it->second &&
+      !it->second->is_load_deferred()) {
     (it->second)
       ->load_from_checkpoint_distributed(p, execution_mode::validation);
   }
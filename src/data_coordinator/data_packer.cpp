@@ -113,14 +113,62 @@ size_t lbann::data_packer::extract_data_field_from_sample(
   case conduit::DataType::UINT32_ID:
     write_column(X_column, data_field_node.as_uint32_ptr(), n_elts);
     break;
+  case conduit::DataType::UINT8_ID:
+    write_column(X_column, data_field_node.as_uint8_ptr(), n_elts);
+    break;
   default:
-    LBANN_ERROR("unknown dtype; not float32/64, int32/64, or uint32/64; dtype "
-                "is reported to be: ",
+    LBANN_ERROR("unknown dtype; not float32/64, int32/64, uint32/64, or "
+                "uint8; dtype is reported to be: ",
                 data_field_node.dtype().name());
   }
   return n_elts;
 }
 
+bool lbann::data_packer::extract_raw_data_field_from_samples(
+  std::vector<conduit::Node> const& samples,
+  data_field_type const& data_field,
+  El::Matrix<uint8_t>& X)
+{
+  LBANN_ASSERT_DEBUG(samples.size() <= static_cast<size_t>(X.Width()));
+  for (size_t mb_idx = 0UL; mb_idx < samples.size(); ++mb_idx) {
+    conduit::Node const& sample = samples[mb_idx];
+    if (sample.number_of_children() != 1)
+      LBANN_ERROR("Unsupported number of samples per Conduit node");
+    auto const sample_path =
+      conduit::utils::join_path(sample.child(0).name(), data_field);
+    if (!sample.has_path(sample_path))
+      LBANN_ERROR("Conduit node has no such path: ", sample_path);
+
+    conduit::Node const& data_field_node = sample[sample_path];
+    if (data_field_node.dtype().id() != conduit::DataType::UINT8_ID) {
+      // Samples of a field share a type, so only the first can differ
+      if (mb_idx != 0) {
+        LBANN_ERROR("data field ",
+                    data_field,
+                    " is uint8 in some samples but ",
+                    data_field_node.dtype().name(),
+                    " in ",
+                    sample_path);
+      }
+      return false;
+    }
+    size_t const n_elts = data_field_node.dtype().number_of_elements();
+    if (n_elts != static_cast<size_t>(X.Height())) {
+      LBANN_ERROR(
+        "data field ",
+        data_field,
+        " has ",
+        n_elts,
+        " elements, but the matrix only has a linearized size (height) of ",
+        X.Height());
+    }
+    write_column(X.Buffer() + X.LDim() * mb_idx,
+                 data_field_node.as_uint8_ptr(),
+                 n_elts);
+  }
+  return true;
+}
+
 #if 0
 size_t data_packer::transform_data_fields(std::map<data_field_type, CPUMat*>& input_buffers,
                                           std::map<data_field_type, transform::transform_pipeline>& input_transformatons)
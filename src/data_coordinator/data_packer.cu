@@ -0,0 +1,133 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/data_coordinator/data_packer.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+__global__ void convert_raw_kernel(El::Int height,
+                                   El::Int width,
+                                   const uint8_t* __restrict__ raw,
+                                   DataType* __restrict__ out,
+                                   El::Int out_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  for (El::Int i = gid; i < size; i += nthreads) {
+    const El::Int row = i % height;
+    const El::Int col = i / height;
+    out[row + col * out_ldim] = static_cast<DataType>(raw[i]);
+  }
+}
+
+/** One thread per output value, so that the writes are coalesced. */
+__global__ void convert_raw_image_kernel(data_packer::raw_image_conversion conv,
+                                         El::Int num_samples,
+                                         const uint8_t* __restrict__ raw,
+                                         DataType* __restrict__ out,
+                                         El::Int out_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  const El::Int channel_size = El::Int(conv.height) * conv.width;
+  const El::Int sample_size = channel_size * conv.channels;
+  const El::Int size = sample_size * num_samples;
+  for (El::Int i = gid; i < size; i += nthreads) {
+    const El::Int sample = i / sample_size;
+    const El::Int pos = i % sample_size;
+    const int channel = pos / channel_size;
+    const El::Int row = (pos % channel_size) % conv.height;
+    const El::Int col = (pos % channel_size) / conv.height;
+    const uint8_t x =
+      raw[sample * sample_size + (row * conv.width + col) * conv.channels +
+          channel];
+    out[pos + sample * out_ldim] =
+      conv.scales[channel] * static_cast<DataType>(x) + conv.shifts[channel];
+  }
+}
+
+} // namespace
+
+void data_packer::convert_raw_image_batch(
+  uint8_t const* raw,
+  raw_image_conversion const& conv,
+  El::Int num_samples,
+  El::Matrix<DataType, El::Device::GPU>& X)
+{
+  const El::Int height = El::Int(conv.channels) * conv.height * conv.width;
+  X.Resize(height, num_samples);
+  if (X.IsEmpty()) {
+    return;
+  }
+  const El::Int size = height * num_samples;
+  const El::Int block_size = 256;
+  dim3 grid_dims((size + block_size - 1) / block_size);
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(convert_raw_image_kernel,
+                              grid_dims,
+                              block_size,
+                              0,
+                              gpu::get_sync_info(X),
+                              conv,
+                              num_samples,
+                              raw,
+                              X.Buffer(),
+                              X.LDim());
+}
+
+void data_packer::convert_raw_data_field(
+  uint8_t const* raw,
+  El::Int height,
+  El::Int width,
+  El::Matrix<DataType, El::Device::GPU>& X)
+{
+  X.Resize(height, width);
+  if (X.IsEmpty()) {
+    return;
+  }
+  const El::Int size = height * width;
+  const El::Int block_size = 256;
+  dim3 grid_dims((size + block_size - 1) / block_size);
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(convert_raw_kernel,
+                              grid_dims,
+                              block_size,
+                              0,
+                              gpu::get_sync_info(X),
+                              height,
+                              width,
+                              raw,
+                              X.Buffer(),
+                              X.LDim());
+}
+
+} // namespace lbann
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_coordinator/io_statistics.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace lbann {
+
+std::string to_string(io_stage stage)
+{
+  switch (stage) {
+  case io_stage::read:
+    return "read";
+  case io_stage::decode:
+    return "decode";
+  case io_stage::transform:
+    return "transform";
+  case io_stage::sample:
+    return "sample";
+  case io_stage::pack:
+    return "pack";
+  case io_stage::exchange:
+    return "exchange";
+  case io_stage::fetch:
+    return "fetch";
+  case io_stage::blocked:
+    return "blocked";
+  default:
+    LBANN_ERROR("Invalid I/O stage");
+  }
+}
+
+const char* get_io_stage_region(io_stage stage)
+{
+  switch (stage) {
+  case io_stage::read:
+    return "io read";
+  case io_stage::decode:
+    return "io decode";
+  case io_stage::transform:
+    return "io transform";
+  case io_stage::sample:
+    return "io sample";
+  case io_stage::pack:
+    return "io pack";
+  case io_stage::exchange:
+    return "io exchange";
+  case io_stage::fetch:
+    return "io fetch";
+  case io_stage::blocked:
+    return "io blocked";
+  default:
+    LBANN_ERROR("Invalid I/O stage");
+  }
+}
+
+double io_stage_timer::stop() noexcept
+{
+  if (!m_timer.running()) {
+    return 0.;
+  }
+  const double elapsed = m_timer.stop();
+  ++m_histogram[bin(elapsed)];
+  return elapsed;
+}
+
+void io_stage_timer::reset_statistics() noexcept
+{
+  m_timer.reset_statistics();
+  m_histogram.fill(0);
+}
+
+size_t io_stage_timer::bin(double seconds) noexcept
+{
+  size_t b = 0;
+  while (b < num_bins - 1 && seconds >= bin_upper_bound(b)) {
+    ++b;
+  }
+  return b;
+}
+
+double io_stage_timer::bin_upper_bound(size_t bin) noexcept
+{
+  return std::ldexp(1.e-6, static_cast<int>(bin));
+}
+
+void io_statistics::reset_statistics() noexcept
+{
+  for (auto& t : m_timers) {
+    t.reset_statistics();
+  }
+}
+
+void io_stage_summary::add(const io_stage_timer& timer)
+{
+  samples += timer.samples();
+  total_time += timer.total_time();
+  max = std::max(max, timer.max());
+  for (size_t b = 0; b < histogram.size(); ++b) {
+    histogram[b] += timer.histogram()[b];
+  }
+}
+
+void io_stage_summary::add(const io_stage_summary& other)
+{
+  samples += other.samples;
+  total_time += other.total_time;
+  max = std::max(max, other.max);
+  for (size_t b = 0; b < histogram.size(); ++b) {
+    histogram[b] += other.histogram[b];
+  }
+}
+
+double io_stage_summary::quantile(double q) const
+{
+  if (samples == 0) {
+    return 0.;
+  }
+  const double target = q * static_cast<double>(samples);
+  size_t count = 0;
+  for (size_t b = 0; b < histogram.size(); ++b) {
+    count += histogram[b];
+    if (static_cast<double>(count) >= target) {
+      return std::min(io_stage_timer::bin_upper_bound(b), max);
+    }
+  }
+  return max;
+}
+
+namespace {
+thread_local io_statistics* thread_io_stats = nullptr;
+} // namespace
+
+io_statistics* get_thread_io_statistics() noexcept { return thread_io_stats; }
+
+thread_io_statistics_scope::thread_io_statistics_scope(
+  io_statistics& stats) noexcept
+  : m_previous(thread_io_stats)
+{
+  thread_io_stats = &stats;
+}
+
+thread_io_statistics_scope::~thread_io_statistics_scope() noexcept
+{
+  thread_io_stats = m_previous;
+}
+
+} // namespace lbann
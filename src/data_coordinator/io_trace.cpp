@@ -0,0 +1,211 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_coordinator/io_trace.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+
+namespace details {
+std::atomic<bool> io_trace_on{false};
+} // namespace details
+
+namespace {
+
+/** Events of one thread. Only the thread appends to it, but
+ *  io_trace_write reads it, hence the lock. */
+struct thread_trace
+{
+  std::mutex mutex;
+  std::vector<io_trace_event> events;
+  /** File name indices used by this thread, to avoid the global lock */
+  std::unordered_map<std::string, uint32_t> files;
+  uint32_t id = 0;
+};
+
+struct trace_state
+{
+  std::mutex mutex;
+  /** Owned here so events outlive their threads */
+  std::vector<std::unique_ptr<thread_trace>> threads;
+  std::vector<std::string> files;
+  std::unordered_map<std::string, uint32_t> file_ids;
+  double origin = 0.;
+};
+
+trace_state& get_trace_state()
+{
+  static trace_state state;
+  return state;
+}
+
+thread_trace& get_thread_trace()
+{
+  thread_local thread_trace* trace = nullptr;
+  if (trace == nullptr) {
+    auto& state = get_trace_state();
+    std::lock_guard<std::mutex> lk(state.mutex);
+    state.threads.push_back(std::make_unique<thread_trace>());
+    trace = state.threads.back().get();
+    trace->id = static_cast<uint32_t>(state.threads.size() - 1);
+  }
+  return *trace;
+}
+
+uint32_t get_file_id(thread_trace& trace, const std::string& file)
+{
+  const auto it = trace.files.find(file);
+  if (it != trace.files.end()) {
+    return it->second;
+  }
+  auto& state = get_trace_state();
+  std::lock_guard<std::mutex> lk(state.mutex);
+  const auto [global, inserted] =
+    state.file_ids.emplace(file, static_cast<uint32_t>(state.files.size()));
+  if (inserted) {
+    state.files.push_back(file);
+  }
+  trace.files.emplace(file, global->second);
+  return global->second;
+}
+
+} // namespace
+
+std::string to_string(io_trace_op op)
+{
+  switch (op) {
+  case io_trace_op::open:
+    return "open";
+  case io_trace_op::read:
+    return "read";
+  case io_trace_op::close:
+    return "close";
+  default:
+    LBANN_ERROR("Invalid I/O trace operation");
+  }
+}
+
+void io_trace_start()
+{
+  auto& state = get_trace_state();
+  {
+    std::lock_guard<std::mutex> lk(state.mutex);
+    if (state.origin == 0.) {
+      state.origin = get_time();
+    }
+  }
+  details::io_trace_on.store(true);
+}
+
+void io_trace_stop() { details::io_trace_on.store(false); }
+
+void io_trace_record(io_trace_op op,
+                     const std::string& file,
+                     uint64_t offset,
+                     uint64_t length,
+                     double start,
+                     double latency)
+{
+  if (!details::io_trace_on.load(std::memory_order_acquire)) {
+    return;
+  }
+  auto& trace = get_thread_trace();
+  io_trace_event event = {};
+  event.start = start - get_trace_state().origin;
+  event.latency = static_cast<float>(latency);
+  event.file = get_file_id(trace, file);
+  event.offset = offset;
+  event.length = length;
+  event.thread = trace.id;
+  event.op = static_cast<uint8_t>(op);
+  std::lock_guard<std::mutex> lk(trace.mutex);
+  trace.events.push_back(event);
+}
+
+void io_trace_write(const std::string& path)
+{
+  auto& state = get_trace_state();
+  std::vector<std::string> files;
+  std::vector<io_trace_event> events;
+  uint32_t num_threads = 0;
+  {
+    std::lock_guard<std::mutex> lk(state.mutex);
+    files = state.files;
+    num_threads = static_cast<uint32_t>(state.threads.size());
+    for (auto& t : state.threads) {
+      std::lock_guard<std::mutex> thread_lk(t->mutex);
+      events.insert(events.end(), t->events.begin(), t->events.end());
+    }
+  }
+  std::stable_sort(events.begin(),
+                   events.end(),
+                   [](const io_trace_event& a, const io_trace_event& b) {
+                     return a.start < b.start;
+                   });
+
+  io_trace_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, "LBIOTRCE", sizeof(h.magic));
+  h.version = 1;
+  h.num_threads = num_threads;
+  h.num_files = files.size();
+  h.num_events = events.size();
+  h.files_offset = sizeof(h);
+  uint64_t files_size = 0;
+  for (const auto& f : files) {
+    files_size += sizeof(uint32_t) + f.size();
+  }
+  h.events_offset = (h.files_offset + files_size + 7) / 8 * 8;
+
+  std::ofstream out(path, std::ios::binary);
+  if (!out) {
+    LBANN_ERROR("could not open I/O trace file ", path);
+  }
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  for (const auto& f : files) {
+    const uint32_t length = static_cast<uint32_t>(f.size());
+    out.write(reinterpret_cast<const char*>(&length), sizeof(length));
+    out.write(f.data(), f.size());
+  }
+  const char zeros[8] = {};
+  out.write(zeros, h.events_offset - h.files_offset - files_size);
+  out.write(reinterpret_cast<const char*>(events.data()),
+            events.size() * sizeof(io_trace_event));
+  out.close();
+  if (!out) {
+    LBANN_ERROR("failed writing I/O trace file ", path);
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,285 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_coordinator/io_worker_pool.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <tuple>
+
+namespace lbann {
+
+namespace {
+
+/** Sent to a worker ahead of the indices of its samples */
+struct request_header
+{
+  uint64_t fetch_sequence;
+  int64_t first_sample;
+  int64_t count;
+};
+
+/** Field offsets in the shared region are kept cache line aligned */
+constexpr size_t shared_alignment = 64;
+
+bool send_all(int fd, const void* data, size_t size)
+{
+  const char* ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::send(fd, ptr, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool recv_all(int fd, void* data, size_t size)
+{
+  char* ptr = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::recv(fd, ptr, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+} // namespace
+
+io_worker_pool::io_worker_pool(
+  generic_data_reader& reader,
+  int num_workers,
+  const std::map<data_field_type, El::Int>& field_heights,
+  El::Int max_samples)
+  : m_max_samples(max_samples)
+{
+  if (num_workers < 1) {
+    LBANN_ERROR("an I/O worker pool needs at least one worker, but ",
+                num_workers,
+                " were requested");
+  }
+  for (const auto& [data_field, height] : field_heights) {
+    m_fields[data_field] = {height, m_shared_size};
+    const size_t field_size = sizeof(DataType) * height * max_samples;
+    m_shared_size += (field_size + shared_alignment - 1) / shared_alignment *
+                     shared_alignment;
+  }
+  if (m_shared_size > 0) {
+    m_shared = ::mmap(nullptr,
+                      m_shared_size,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS,
+                      -1,
+                      0);
+    if (m_shared == MAP_FAILED) {
+      m_shared = nullptr;
+      LBANN_ERROR("could not map ",
+                  m_shared_size,
+                  " bytes for I/O workers: ",
+                  std::strerror(errno));
+    }
+  }
+
+  for (int w = 0; w < num_workers; ++w) {
+    int sockets[2];
+    if (::socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) != 0) {
+      LBANN_ERROR("could not connect to an I/O worker: ",
+                  std::strerror(errno));
+    }
+    const pid_t pid = ::fork();
+    if (pid < 0) {
+      ::close(sockets[0]);
+      ::close(sockets[1]);
+      LBANN_ERROR("could not fork an I/O worker: ", std::strerror(errno));
+    }
+    if (pid == 0) {
+      ::close(sockets[0]);
+      for (const auto& other : m_workers) {
+        ::close(other.fd);
+      }
+      run_worker(reader, sockets[1]);
+    }
+    ::close(sockets[1]);
+    m_workers.push_back({pid, sockets[0]});
+  }
+}
+
+io_worker_pool::~io_worker_pool()
+{
+  // Workers exit once they see the end of their request stream
+  for (const auto& w : m_workers) {
+    ::close(w.fd);
+  }
+  for (const auto& w : m_workers) {
+    while (::waitpid(w.pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+  }
+  if (m_shared != nullptr) {
+    ::munmap(m_shared, m_shared_size);
+  }
+}
+
+std::map<data_field_type, CPUMat>
+io_worker_pool::get_shared_views(El::Int first, El::Int count)
+{
+  std::map<data_field_type, CPUMat> views;
+  for (const auto& [data_field, layout] : m_fields) {
+    auto* base = reinterpret_cast<DataType*>(static_cast<char*>(m_shared) +
+                                             layout.offset);
+    views.emplace(std::piecewise_construct,
+                  std::forward_as_tuple(data_field),
+                  std::forward_as_tuple(layout.height,
+                                        count,
+                                        base + first * layout.height,
+                                        std::max(layout.height, El::Int{1})));
+  }
+  return views;
+}
+
+void io_worker_pool::run_worker(generic_data_reader& reader, int fd)
+{
+  std::vector<int> indices;
+  for (;;) {
+    request_header request;
+    if (!recv_all(fd, &request, sizeof(request))) {
+      break;
+    }
+    indices.resize(request.count);
+    if (!recv_all(fd, indices.data(), sizeof(int) * indices.size())) {
+      break;
+    }
+    int status = 0;
+    try {
+      auto views = get_shared_views(request.first_sample, request.count);
+      std::map<data_field_type, CPUMat*> buffers;
+      for (auto& [data_field, view] : views) {
+        buffers[data_field] = &view;
+      }
+      reader.fetch_samples(buffers,
+                           indices.data(),
+                           request.count,
+                           request.fetch_sequence,
+                           request.first_sample);
+    }
+    catch (const std::exception& e) {
+      std::cerr << "I/O worker " << ::getpid() << ": " << e.what()
+                << std::endl;
+      status = -1;
+    }
+    if (!send_all(fd, &status, sizeof(status))) {
+      break;
+    }
+  }
+  // Skip the exit handlers of the training process, e.g. MPI's
+  ::_exit(0);
+}
+
+void io_worker_pool::fetch(std::map<data_field_type, CPUMat*>& input_buffers,
+                           const std::vector<int>& indices,
+                           size_t fetch_sequence)
+{
+  const El::Int num_samples = indices.size();
+  if (num_samples > m_max_samples) {
+    LBANN_ERROR("I/O workers can load ",
+                m_max_samples,
+                " samples at a time, but ",
+                num_samples,
+                " were requested");
+  }
+  for (const auto& [data_field, buf] : input_buffers) {
+    const auto layout = m_fields.find(data_field);
+    if (layout == m_fields.end() ||
+        layout->second.height != buf->Height() ||
+        buf->Width() < num_samples) {
+      LBANN_ERROR("I/O workers were not set up for a ",
+                  buf->Height(),
+                  " x ",
+                  buf->Width(),
+                  " buffer for data field ",
+                  data_field);
+    }
+  }
+
+  // Give each worker a contiguous run of samples
+  const El::Int num_workers = m_workers.size();
+  const El::Int run = (num_samples + num_workers - 1) / num_workers;
+  El::Int num_requests = 0;
+  for (El::Int first = 0; first < num_samples; first += run) {
+    const request_header request{fetch_sequence,
+                                 first,
+                                 std::min(run, num_samples - first)};
+    const int fd = m_workers[num_requests].fd;
+    if (!send_all(fd, &request, sizeof(request)) ||
+        !send_all(fd, &indices[first], sizeof(int) * request.count)) {
+      LBANN_ERROR("lost the connection to I/O worker ",
+                  m_workers[num_requests].pid);
+    }
+    ++num_requests;
+  }
+  bool valid = true;
+  for (El::Int w = 0; w < num_requests; ++w) {
+    int status = -1;
+    if (!recv_all(m_workers[w].fd, &status, sizeof(status))) {
+      LBANN_ERROR("lost the connection to I/O worker ", m_workers[w].pid);
+    }
+    valid = valid && status == 0;
+  }
+  if (!valid) {
+    LBANN_ERROR("I/O workers failed to load a mini-batch");
+  }
+
+  for (auto& [data_field, buf] : input_buffers) {
+    const field_layout& layout = m_fields.at(data_field);
+    const auto* src = reinterpret_cast<const DataType*>(
+      static_cast<const char*>(m_shared) + layout.offset);
+    for (El::Int s = 0; s < num_samples; ++s) {
+      std::copy_n(src + s * layout.height, layout.height, buf->Buffer(0, s));
+    }
+  }
+}
+
+} // namespace lbann
@@ -0,0 +1,86 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/data_coordinator/io_statistics.hpp"
+
+TEST_CASE("I/O stage histogram bins", "[data_coordinator][io_statistics]")
+{
+  using lbann::io_stage_timer;
+
+  CHECK(io_stage_timer::bin(0.) == 0);
+  CHECK(io_stage_timer::bin(0.5e-6) == 0);
+  CHECK(io_stage_timer::bin(1.5e-6) == 1);
+  CHECK(io_stage_timer::bin(3.e-6) == 2);
+  CHECK(io_stage_timer::bin(1.e3) == io_stage_timer::num_bins - 1);
+
+  // Each bin's upper bound falls in the next bin
+  for (size_t b = 0; b + 1 < io_stage_timer::num_bins; ++b) {
+    CHECK(io_stage_timer::bin(io_stage_timer::bin_upper_bound(b)) == b + 1);
+  }
+}
+
+TEST_CASE("I/O stage summaries", "[data_coordinator][io_statistics]")
+{
+  lbann::io_statistics stats;
+  lbann::io_stage_summary summary;
+
+  SECTION("Empty summary")
+  {
+    summary.add(stats[lbann::io_stage::sample]);
+    CHECK(summary.samples == 0);
+    CHECK(summary.mean() == 0.);
+    CHECK(summary.quantile(0.5) == 0.);
+  }
+
+  SECTION("Scopes record into the thread's statistics")
+  {
+    CHECK(lbann::get_thread_io_statistics() == nullptr);
+    {
+      // Not recording: no effect
+      lbann::io_stage_scope t(lbann::io_stage::read);
+    }
+    {
+      lbann::thread_io_statistics_scope scope(stats);
+      CHECK(lbann::get_thread_io_statistics() == &stats);
+      for (int i = 0; i < 4; ++i) {
+        lbann::io_stage_scope t(lbann::io_stage::read);
+      }
+    }
+    CHECK(lbann::get_thread_io_statistics() == nullptr);
+    CHECK(stats[lbann::io_stage::read].samples() == 4);
+    CHECK(stats[lbann::io_stage::decode].samples() == 0);
+
+    summary.add(stats[lbann::io_stage::read]);
+    summary.add(summary);
+    CHECK(summary.samples == 8);
+    CHECK(summary.quantile(1.) <= summary.max);
+
+    stats.reset_statistics();
+    CHECK(stats[lbann::io_stage::read].samples() == 0);
+  }
+}
@@ -28,12 +28,15 @@
 
 #include "lbann/data_readers/data_reader.hpp"
 #include "lbann/comm_impl.hpp"
+#include "lbann/data_readers/sample_list_binary.hpp"
 #include "lbann/data_coordinator/data_coordinator.hpp"
 #include "lbann/data_store/data_store_conduit.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/io/persist_impl.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 #include "lbann/utils/timer.hpp"
@@ -41,6 +44,10 @@
 #include "conduit/conduit_node.hpp"
 
 #include <future>
+#include <map>
+#include <numeric>
+#include <random>
+#include <unordered_map>
 #include <omp.h>
 
 namespace lbann {
@@ -48,6 +55,24 @@ namespace lbann {
 #undef DEBUG
 // #define DEBUG
 
+namespace {
+
+/** Order-independent fingerprint of a set of sample indices */
+uint64_t index_set_fingerprint(std::vector<int> const& indices)
+{
+  uint64_t sum = 0;
+  for (int index : indices) {
+    // splitmix64 finalizer
+    uint64_t z = static_cast<uint64_t>(index) + 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    sum += z ^ (z >> 31);
+  }
+  return sum;
+}
+
+} // namespace
+
 generic_data_reader::~generic_data_reader()
 {
   if (m_data_store != nullptr) {
@@ -59,10 +84,33 @@ generic_data_reader::~generic_data_reader()
 template <class Archive>
 void generic_data_reader::serialize(Archive& ar)
 {
+  // The shuffled indices are not stored: the restarted reader has the
+  // same index set after setup, and the order of the epoch is drawn
+  // again from the shuffle seed. The set's size and fingerprint check
+  // that it is the same.
+  uint64_t num_indices = m_shuffled_indices.size();
+  uint64_t index_set_hash = index_set_fingerprint(m_shuffled_indices);
   ar(CEREAL_NVP(m_current_mini_batch_idx),
      CEREAL_NVP(m_current_pos),
-     CEREAL_NVP(m_shuffled_indices),
+     CEREAL_NVP(m_shuffle_seed),
+     CEREAL_NVP(m_shuffle_epoch),
+     CEREAL_NVP(num_indices),
+     CEREAL_NVP(index_set_hash),
+     CEREAL_NVP(m_permutation),
      CEREAL_NVP(m_supported_input_types));
+  if constexpr (utils::IsInputArchive<Archive>) {
+    if (num_indices != m_shuffled_indices.size() ||
+        index_set_hash != index_set_fingerprint(m_shuffled_indices)) {
+      LBANN_ERROR("the ",
+                  m_shuffled_indices.size(),
+                  " samples of the reader for role ",
+                  get_role(),
+                  " are not the ",
+                  num_indices,
+                  " samples it had when it was checkpointed");
+    }
+    restore_epoch_order();
+  }
 }
 
 void generic_data_reader::shuffle_indices()
@@ -70,12 +118,154 @@ void generic_data_reader::shuffle_indices()
   shuffle_indices(get_data_seq_generator());
 }
 
+rng_gen generic_data_reader::get_epoch_shuffle_generator(uint64_t epoch) const
+{
+  const uint64_t seed = hash_combine(m_shuffle_seed, epoch);
+  std::seed_seq seq{static_cast<uint32_t>(seed),
+                    static_cast<uint32_t>(seed >> 32)};
+  return rng_gen(seq);
+}
+
+void generic_data_reader::restore_epoch_order()
+{
+  // The order of the first epoch is the one drawn during setup, and
+  // permutation shuffles never reorder the indices
+  if (!m_shuffle || m_shuffle_epoch == 0 || m_permutation.size() != 0) {
+    return;
+  }
+  std::sort(m_shuffled_indices.begin(), m_shuffled_indices.end());
+  auto gen = get_epoch_shuffle_generator(m_shuffle_epoch);
+  shuffle_indices(gen);
+  if (m_data_store != nullptr) {
+    m_data_store->localize_shuffled_indices(m_shuffled_indices);
+    m_data_store->set_shuffled_indices(&m_shuffled_indices);
+  }
+}
+
 void generic_data_reader::shuffle_indices(rng_gen& gen)
 {
+  // Subsets and splits are cut from the shuffled indices, so this
+  // always reorders them
+  m_permutation = feistel_permutation();
   // Shuffle the data
   if (m_shuffle) {
-    std::shuffle(m_shuffled_indices.begin(), m_shuffled_indices.end(), gen);
+    shuffle_index_order(m_shuffled_indices, gen);
+  }
+}
+
+void generic_data_reader::shuffle_index_order(std::vector<int>& indices,
+                                              rng_gen& gen) const
+{
+  if (!shuffle_indices_by_file(indices, gen)) {
+    std::shuffle(indices.begin(), indices.end(), gen);
+  }
+  bucket_indices_by_length(indices);
+}
+
+bool generic_data_reader::shuffle_indices_by_file(std::vector<int>& indices,
+                                                  rng_gen& gen) const
+{
+  const int window =
+    global_argument_parser().get<int>(LBANN_OPTION_SHUFFLE_FILE_WINDOW);
+  if (window <= 0 || !has_sample_files()) {
+    return false;
+  }
+
+  std::unordered_map<size_t, size_t> file_slot;
+  std::vector<std::vector<int>> by_file;
+  for (int index : indices) {
+    auto it = file_slot.emplace(get_sample_file_id(index), by_file.size());
+    if (it.second) {
+      by_file.emplace_back();
+    }
+    by_file[it.first->second].push_back(index);
+  }
+  std::shuffle(by_file.begin(), by_file.end(), gen);
+  for (auto& samples : by_file) {
+    std::shuffle(samples.begin(), samples.end(), gen);
+  }
+
+  // Each active file is drawn from at its next unused sample
+  std::vector<std::pair<size_t, size_t>> active; // (file, next sample)
+  size_t next_file = 0;
+  for (; next_file < by_file.size() && active.size() < size_t(window);
+       ++next_file) {
+    active.emplace_back(next_file, 0);
+  }
+  for (auto out = indices.begin(); out != indices.end(); ++out) {
+    std::uniform_int_distribution<size_t> pick(0, active.size() - 1);
+    auto& a = active[pick(gen)];
+    const auto& samples = by_file[a.first];
+    *out = samples[a.second++];
+    if (a.second == samples.size()) {
+      if (next_file < by_file.size()) {
+        a = std::make_pair(next_file++, size_t{0});
+      }
+      else {
+        a = active.back();
+        active.pop_back();
+      }
+    }
+  }
+  return true;
+}
+
+void generic_data_reader::bucket_shuffled_indices()
+{
+  bucket_indices_by_length(m_shuffled_indices);
+}
+
+bool generic_data_reader::bucket_indices_by_length(
+  std::vector<int>& indices) const
+{
+  const int window_batches =
+    global_argument_parser().get<int>(LBANN_OPTION_SEQUENCE_BUCKET_WINDOW);
+  const size_t mb_size = m_stride_to_next_mini_batch;
+  if (window_batches <= 0 || mb_size == 0 || !m_shuffle ||
+      !has_sample_lengths()) {
+    return false;
+  }
+
+  // A trailing partial mini-batch stays where it is
+  const size_t num_full = (indices.size() / mb_size) * mb_size;
+  const size_t window = mb_size * window_batches;
+  std::vector<std::pair<int, size_t>> keyed; // (length, drawn position)
+  std::vector<size_t> batch_order;
+  std::vector<int> bucketed;
+  for (size_t begin = 0; begin < num_full; begin += window) {
+    const size_t end = std::min(begin + window, num_full);
+    keyed.clear();
+    for (size_t j = begin; j < end; ++j) {
+      keyed.emplace_back(get_sample_length(indices[j]), j);
+    }
+    std::sort(keyed.begin(), keyed.end());
+
+    // Visit the sorted mini-batches in the order of their earliest
+    // drawn member, so that their order stays random without drawing
+    // from the data sequence generator again
+    const size_t num_batches = (end - begin) / mb_size;
+    std::vector<size_t> first_drawn(num_batches, end);
+    for (size_t k = 0; k < keyed.size(); ++k) {
+      auto& f = first_drawn[k / mb_size];
+      f = std::min(f, keyed[k].second);
+    }
+    batch_order.resize(num_batches);
+    std::iota(batch_order.begin(), batch_order.end(), 0);
+    std::sort(batch_order.begin(),
+              batch_order.end(),
+              [&first_drawn](size_t a, size_t b) {
+                return first_drawn[a] < first_drawn[b];
+              });
+
+    bucketed.clear();
+    for (const auto& b : batch_order) {
+      for (size_t k = b * mb_size; k < (b + 1) * mb_size; ++k) {
+        bucketed.push_back(indices[keyed[k].second]);
+      }
+    }
+    std::copy(bucketed.begin(), bucketed.end(), indices.begin() + begin);
   }
+  return true;
 }
 
 void generic_data_reader::setup(int num_io_threads,
@@ -93,28 +283,45 @@ void generic_data_reader::setup(int num_io_threads,
 
   set_initial_position();
 
+  m_shuffle_seed = get_data_seq_generator()();
+  m_shuffle_epoch = 0;
   shuffle_indices();
 
   m_io_thread_pool = io_thread_pool;
+  m_io_thread_statistics.assign(io_thread_pool != nullptr
+                                  ? io_thread_pool->get_num_threads()
+                                  : num_io_threads,
+                                io_statistics{});
 }
 
 int lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
                                       El::Matrix<El::Int>& indices_fetched,
                                       size_t mb_size)
+{
+  return fetch(samples, indices_fetched, mb_size, m_current_pos);
+}
+
+int lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
+                                      El::Matrix<El::Int>& indices_fetched,
+                                      size_t mb_size,
+                                      int pos,
+                                      bool next_epoch)
 {
   // Check to make sure that a valid map was passed
   if (samples.empty()) {
     LBANN_ERROR("fetch function called with no valid buffers");
   }
 
-  if (!position_valid()) {
-    if (position_is_overrun()) {
+  m_fetch_pos = pos;
+  select_fetch_epoch(next_epoch);
+  if (!position_valid(pos)) {
+    if (position_is_overrun(pos)) {
       return 0;
     }
     else {
       LBANN_ERROR(std::string{} +
                   "generic data reader load error: !position_valid" +
-                  " -- current pos = " + std::to_string(m_current_pos) +
+                  " -- current pos = " + std::to_string(pos) +
                   " and there are " +
                   std::to_string(m_shuffled_indices.size()) + " indices");
     }
@@ -126,6 +333,12 @@ int lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
        t++) {
     preprocess_data_source(t);
   }
+  prepare_mini_batch(mb_size);
+
+  // The I/O threads claim samples from a shared cursor
+  std::atomic<El::Int> fetch_cursor{0};
+  m_fetch_cursor = &fetch_cursor;
+  ++m_fetch_sequence;
 
   // Fetch data is executed by the thread pool so it has to dispatch
   // work to other threads in the thread pool and do some work locally
@@ -155,6 +368,7 @@ int lbann::generic_data_reader::fetch(std::vector<conduit::Node>& samples,
 
   // Wait for all of the threads to finish
   m_io_thread_pool->finish_work_group();
+  m_fetch_cursor = nullptr;
 
   /// Allow each thread to perform any postprocessing necessary on the
   /// data source prior to fetching data
@@ -170,6 +384,16 @@ int lbann::generic_data_reader::fetch(
   std::map<data_field_type, CPUMat*>& input_buffers,
   El::Matrix<El::Int>& indices_fetched,
   size_t mb_size)
+{
+  return fetch(input_buffers, indices_fetched, mb_size, m_current_pos);
+}
+
+int lbann::generic_data_reader::fetch(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  El::Matrix<El::Int>& indices_fetched,
+  size_t mb_size,
+  int pos,
+  bool next_epoch)
 {
   // Check to make sure that a valid map was passed
   if (input_buffers.empty()) {
@@ -204,7 +428,7 @@ int lbann::generic_data_reader::fetch(
   }
 
 #ifdef DEBUG
-  if (m_current_pos == 0) {
+  if (pos == 0) {
     if (get_comm()->am_world_master()) {
       std::cout << "role: " << get_role()
                 << " model: " << get_trainer().get_name()
@@ -217,14 +441,16 @@ int lbann::generic_data_reader::fetch(
   }
 #endif
 
-  if (!position_valid()) {
-    if (position_is_overrun()) {
+  m_fetch_pos = pos;
+  select_fetch_epoch(next_epoch);
+  if (!position_valid(pos)) {
+    if (position_is_overrun(pos)) {
       return 0;
     }
     else {
       LBANN_ERROR(std::string{} +
                   "generic data reader load error: !position_valid" +
-                  " -- current pos = " + std::to_string(m_current_pos) +
+                  " -- current pos = " + std::to_string(pos) +
                   " and there are " +
                   std::to_string(m_shuffled_indices.size()) + " indices");
     }
@@ -236,6 +462,12 @@ int lbann::generic_data_reader::fetch(
        t++) {
     preprocess_data_source(t);
   }
+  prepare_mini_batch(mb_size);
+
+  // The I/O threads claim samples from a shared cursor
+  std::atomic<El::Int> fetch_cursor{0};
+  m_fetch_cursor = &fetch_cursor;
+  ++m_fetch_sequence;
 
   // BVE FIXME - for the time being certain data fields, such as the
   // labels have to be zeroed out because they will typically only
@@ -276,6 +508,7 @@ int lbann::generic_data_reader::fetch(
 
   // Wait for all of the threads to finish
   m_io_thread_pool->finish_work_group();
+  m_fetch_cursor = nullptr;
 
   /// Allow each thread to perform any postprocessing necessary on the
   /// data source prior to fetching data
@@ -287,21 +520,147 @@ int lbann::generic_data_reader::fetch(
   return mb_size;
 }
 
-void lbann::generic_data_reader::start_data_store_mini_batch_exchange()
+#ifdef LBANN_HAS_GPU
+int lbann::generic_data_reader::fetch_to_device(
+  El::Matrix<DataType, El::Device::GPU>& X,
+  El::Matrix<El::Int>& indices_fetched,
+  size_t mb_size,
+  int pos,
+  bool next_epoch)
 {
-  int loaded_batch_size = get_loaded_mini_batch_size();
+  if (X.Height() == 0 || X.Width() == 0) {
+    LBANN_ERROR("fetch_to_device called with invalid buffer: h=",
+                X.Height(),
+                " x ",
+                X.Width());
+  }
+  m_fetch_pos = pos;
+  select_fetch_epoch(next_epoch);
+  if (!position_valid(pos)) {
+    if (position_is_overrun(pos)) {
+      return 0;
+    }
+    LBANN_ERROR("generic data reader load error: !position_valid",
+                " -- current pos = ",
+                pos,
+                " and there are ",
+                m_shuffled_indices.size(),
+                " indices");
+  }
+  prepare_mini_batch(mb_size);
+  ++m_fetch_sequence;
+  fetch_data_block_to_device(X, mb_size, indices_fetched);
+  return mb_size;
+}
+#endif // LBANN_HAS_GPU
 
+void lbann::generic_data_reader::start_data_store_mini_batch_exchange(
+  int steps_ahead)
+{
   // Make sure that every rank participates in the data store prior
   // to seeing if the local rank's position is valid.  Note that
   // every rank will hold data that may be used in the last mini-batch
   if (data_store_active()) {
-    m_data_store->start_exchange_mini_batch_data(m_current_pos - m_base_offset -
-                                                   m_model_offset,
-                                                 loaded_batch_size);
+    mini_batch_cursor cursor;
+    if (!get_mini_batch_cursor(steps_ahead, cursor)) {
+      LBANN_ERROR("mini-batch ",
+                  steps_ahead,
+                  " steps ahead is past the end of the epoch; role: ",
+                  get_role());
+    }
+    auto upcoming = get_upcoming_mini_batches(
+      steps_ahead + m_data_store->get_num_upcoming_mini_batches());
+    upcoming.erase(upcoming.begin(),
+                   upcoming.begin() +
+                     std::min(upcoming.size(),
+                              static_cast<size_t>(steps_ahead)));
+    m_data_store->start_exchange_mini_batch_data(
+      cursor.pos - m_base_offset - m_model_offset,
+      cursor.loaded_mini_batch_size,
+      upcoming);
   }
   return;
 }
 
+bool lbann::generic_data_reader::get_mini_batch_cursor(
+  int n,
+  mini_batch_cursor& cursor,
+  bool cross_epoch) const
+{
+  // Same replay as get_upcoming_mini_batches(), but the epoch bound is
+  // the step count alone so that every rank reaches the same answer
+  int pos = m_current_pos;
+  int current_mb_idx = m_current_mini_batch_idx;
+  int loaded_mb_idx = m_loaded_mini_batch_idx;
+  bool next_epoch = false;
+  for (int k = 0; k < n; ++k) {
+    ++current_mb_idx;
+    if ((current_mb_idx + m_iteration_stride - 1) ==
+        (m_num_iterations_per_epoch - 1)) {
+      pos += m_stride_to_last_mini_batch;
+    }
+    else {
+      pos += m_stride_to_next_mini_batch;
+    }
+    loaded_mb_idx += m_iteration_stride;
+    if (current_mb_idx >= m_num_iterations_per_epoch) {
+      if (!cross_epoch || next_epoch) {
+        return false;
+      }
+      // Same reset as update() and set_initial_position()
+      next_epoch = true;
+      pos = m_base_offset + m_model_offset;
+      loaded_mb_idx = m_reset_mini_batch_index;
+      current_mb_idx = 0;
+    }
+  }
+  if (current_mb_idx >= m_num_iterations_per_epoch) {
+    return false;
+  }
+  cursor.next_epoch = next_epoch;
+  cursor.pos = pos;
+  cursor.loaded_mini_batch_size =
+    (loaded_mb_idx >= (m_num_iterations_per_epoch - 1)) ? m_last_mini_batch_size
+                                                        : m_mini_batch_size;
+  cursor.current_mini_batch_size =
+    (current_mb_idx == (m_num_iterations_per_epoch - 1))
+      ? m_last_mini_batch_size + m_world_master_mini_batch_adjustment
+      : m_mini_batch_size;
+  return true;
+}
+
+std::vector<std::pair<size_t, size_t>>
+lbann::generic_data_reader::get_upcoming_mini_batches(int n) const
+{
+  // Replays the position updates performed by update() and
+  // get_next_position(), without modifying the reader's state
+  std::vector<std::pair<size_t, size_t>> upcoming;
+  int pos = m_current_pos;
+  int current_mb_idx = m_current_mini_batch_idx;
+  int loaded_mb_idx = m_loaded_mini_batch_idx;
+  for (int k = 0; k < n; ++k) {
+    ++current_mb_idx;
+    if ((current_mb_idx + m_iteration_stride - 1) ==
+        (m_num_iterations_per_epoch - 1)) {
+      pos += m_stride_to_last_mini_batch;
+    }
+    else {
+      pos += m_stride_to_next_mini_batch;
+    }
+    loaded_mb_idx += m_iteration_stride;
+    if (current_mb_idx >= m_num_iterations_per_epoch ||
+        loaded_mb_idx >= m_num_iterations_per_epoch ||
+        static_cast<size_t>(pos) >= m_shuffled_indices.size()) {
+      break;
+    }
+    const int mb_size = (loaded_mb_idx >= (m_num_iterations_per_epoch - 1))
+                          ? m_last_mini_batch_size
+                          : m_mini_batch_size;
+    upcoming.emplace_back(pos - m_base_offset - m_model_offset, mb_size);
+  }
+  return upcoming;
+}
+
 void lbann::generic_data_reader::finish_data_store_mini_batch_exchange()
 {
   // Make sure that every rank participates in the data store prior
@@ -321,77 +680,86 @@ bool lbann::generic_data_reader::fetch_data_block(
   El::Matrix<El::Int>& indices_fetched)
 {
   locked_io_rng_ref io_rng = set_io_generators_local_index(block_offset);
+  thread_io_statistics_scope io_stats(m_io_thread_statistics.at(block_offset));
 
   //  CPUMat& X
-  for (int s = block_offset; s < mb_size; s += block_stride) {
-    int n = m_current_pos + (s * m_sample_stride);
-    int index = m_shuffled_indices[n];
+  for (El::Int s = claim_next_sample(); s < mb_size; s = claim_next_sample()) {
+    io_stage_scope sample_timer(io_stage::sample);
+    int n = m_fetch_pos + (s * m_sample_stride);
+    int index = get_fetch_index(n);
     indices_fetched.Set(s, 0, index);
+    fetch_sample_fields(input_buffers, index, s);
+  }
 
-    for (auto& [data_field, buf] : input_buffers) {
-      bool valid = false;
-      if (data_field == INPUT_DATA_TYPE_SAMPLES) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_datum(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+  return true;
+}
+
+void lbann::generic_data_reader::fetch_sample_fields(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  int index,
+  El::Int mb_idx)
+{
+  for (auto& [data_field, buf] : input_buffers) {
+    bool valid = false;
+    if (data_field == INPUT_DATA_TYPE_SAMPLES) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_sample_fields function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_label(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+      valid = fetch_datum(*buf, index, mb_idx);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_response(*buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
-        }
+    }
+    else if (data_field == INPUT_DATA_TYPE_LABELS && has_labels()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_sample_fields function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
       }
-      else if (has_data_field(data_field)) {
-        if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
-          LBANN_ERROR(
-            "fetch_data_block function called with invalid buffer: h=",
-            buf->Height(),
-            " x ",
-            buf->Width());
-        }
-        valid = fetch_data_field(data_field, *buf, index, s);
-        if (!valid) {
-          LBANN_ERROR("invalid datum (index ",
-                      std::to_string(index),
-                      ") for field ",
-                      data_field);
-        }
+      valid = fetch_label(*buf, index, mb_idx);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
-      else {
-        LBANN_ERROR("Unsupported data_field ", data_field);
+    }
+    else if (data_field == INPUT_DATA_TYPE_RESPONSES && has_responses()) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_sample_fields function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_response(*buf, index, mb_idx);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ", std::to_string(index), ")");
       }
     }
+    else if (has_data_field(data_field)) {
+      if (buf == nullptr || buf->Height() == 0 || buf->Width() == 0) {
+        LBANN_ERROR(
+          "fetch_sample_fields function called with invalid buffer: h=",
+          buf->Height(),
+          " x ",
+          buf->Width());
+      }
+      valid = fetch_data_field(data_field, *buf, index, mb_idx);
+      if (!valid) {
+        LBANN_ERROR("invalid datum (index ",
+                    std::to_string(index),
+                    ") for field ",
+                    data_field);
+      }
+    }
+    else {
+      LBANN_ERROR("Unsupported data_field ", data_field);
+    }
   }
-
-  return true;
 }
 
 bool lbann::generic_data_reader::fetch_data_block_conduit(
@@ -409,10 +777,12 @@ bool lbann::generic_data_reader::fetch_data_block_conduit(
                 " is smaller than mini-batch size",
                 mb_size);
   }
+  thread_io_statistics_scope io_stats(m_io_thread_statistics.at(block_offset));
   //  CPUMat& X
-  for (int s = block_offset; s < mb_size; s += block_stride) {
-    int n = m_current_pos + (s * m_sample_stride);
-    int index = m_shuffled_indices[n];
+  for (El::Int s = claim_next_sample(); s < mb_size; s = claim_next_sample()) {
+    io_stage_scope sample_timer(io_stage::sample);
+    int n = m_fetch_pos + (s * m_sample_stride);
+    int index = get_fetch_index(n);
     indices_fetched.Set(s, 0, index);
 
     auto& sample = samples[s];
@@ -424,6 +794,132 @@ bool lbann::generic_data_reader::fetch_data_block_conduit(
   return true;
 }
 
+void generic_data_reader::shuffle_next_epoch_indices()
+{
+  if (m_next_epoch_is_shuffled) {
+    return;
+  }
+  if (!supports_cross_epoch_fetch()) {
+    LBANN_ERROR("reader for role ",
+                get_role(),
+                " cannot shuffle ahead of the end of its epoch");
+  }
+  // Draws from the data sequence generator exactly as update() would
+  if (use_permutation_shuffle()) {
+    m_next_permutation = feistel_permutation(m_shuffled_indices.size(),
+                                             get_data_seq_generator()());
+    m_next_epoch_is_shuffled = true;
+    return;
+  }
+  m_next_permutation = feistel_permutation();
+  m_next_shuffled_indices = m_shuffled_indices;
+  if (m_shuffle) {
+    // Each epoch's order only depends on the index set, the seed and
+    // the epoch, so it can be drawn again on restart
+    std::sort(m_next_shuffled_indices.begin(), m_next_shuffled_indices.end());
+    auto gen = get_epoch_shuffle_generator(m_shuffle_epoch + 1);
+    shuffle_index_order(m_next_shuffled_indices, gen);
+  }
+  m_next_epoch_is_shuffled = true;
+}
+
+bool generic_data_reader::use_permutation_shuffle() const
+{
+  return m_shuffle && m_data_store == nullptr &&
+         supports_cross_epoch_fetch() &&
+         global_argument_parser().get<bool>(LBANN_OPTION_PERMUTATION_SHUFFLE) &&
+         global_argument_parser().get<int>(
+           LBANN_OPTION_SEQUENCE_BUCKET_WINDOW) <= 0 &&
+         (global_argument_parser().get<int>(
+            LBANN_OPTION_SHUFFLE_FILE_WINDOW) <= 0 ||
+          !has_sample_files());
+}
+
+void generic_data_reader::select_fetch_epoch(bool next_epoch)
+{
+  if (next_epoch && !m_next_epoch_is_shuffled) {
+    LBANN_ERROR("fetching from the next epoch before its indices are "
+                "shuffled; role: ",
+                get_role());
+  }
+  if (!next_epoch) {
+    m_fetch_indices = &m_shuffled_indices;
+    m_fetch_permutation = &m_permutation;
+  }
+  else if (m_next_permutation.size() != 0) {
+    // The permutation reorders the same indices in every epoch
+    m_fetch_indices = &m_shuffled_indices;
+    m_fetch_permutation = &m_next_permutation;
+  }
+  else {
+    m_fetch_indices = &m_next_shuffled_indices;
+    m_fetch_permutation = &m_next_permutation;
+  }
+}
+
+El::Int generic_data_reader::claim_next_sample()
+{
+  if (m_fetch_cursor == nullptr) {
+    LBANN_ERROR("samples can only be claimed while a mini-batch is fetched");
+  }
+  const El::Int s = m_fetch_cursor->fetch_add(1, std::memory_order_relaxed);
+  seed_io_generators_for_sample(hash_combine(m_fetch_sequence, s));
+  return s;
+}
+
+std::vector<int> generic_data_reader::get_mini_batch_indices(int pos,
+                                                             El::Int mb_size,
+                                                             bool next_epoch)
+{
+  select_fetch_epoch(next_epoch);
+  if (!position_valid(pos)) {
+    if (position_is_overrun(pos)) {
+      return {};
+    }
+    LBANN_ERROR("generic data reader load error: !position_valid",
+                " -- current pos = ",
+                pos,
+                " and there are ",
+                m_shuffled_indices.size(),
+                " indices");
+  }
+  std::vector<int> indices(mb_size);
+  for (El::Int s = 0; s < mb_size; ++s) {
+    const int n = pos + s * m_sample_stride;
+    if (static_cast<size_t>(n) >= m_shuffled_indices.size()) {
+      LBANN_ERROR("mini-batch position ", n, " is past the end of the epoch");
+    }
+    indices[s] = get_fetch_index(n);
+  }
+  return indices;
+}
+
+void generic_data_reader::fetch_samples(
+  std::map<data_field_type, CPUMat*>& input_buffers,
+  const int* indices,
+  El::Int count,
+  size_t fetch_sequence,
+  El::Int first_sample)
+{
+  preprocess_data_source(0);
+  {
+    locked_io_rng_ref io_rng = set_io_generators_local_index(0);
+    thread_io_statistics_scope io_stats(m_io_thread_statistics.at(0));
+    if (has_labels() &&
+        input_buffers.find(INPUT_DATA_TYPE_LABELS) != input_buffers.end()) {
+      auto& buf = input_buffers[INPUT_DATA_TYPE_LABELS];
+      El::Zeros_seq(*buf, buf->Height(), buf->Width());
+    }
+    for (El::Int s = 0; s < count; ++s) {
+      io_stage_scope sample_timer(io_stage::sample);
+      seed_io_generators_for_sample(
+        hash_combine(fetch_sequence, first_sample + s));
+      fetch_sample_fields(input_buffers, indices[s], s);
+    }
+  }
+  postprocess_data_source(0);
+}
+
 bool generic_data_reader::update(bool is_active_reader)
 {
   bool reader_not_done = true; // BVE The sense of this should be fixed
@@ -457,7 +953,34 @@ bool generic_data_reader::update(bool is_active_reader)
         std::to_string(m_stride_to_last_mini_batch));
     }
 
-    shuffle_indices();
+    if (m_next_epoch_is_shuffled) {
+      // Copy rather than swap: fetches of the next epoch that are
+      // already in flight read m_next_shuffled_indices or
+      // m_next_permutation
+      if (m_next_permutation.size() != 0) {
+        m_permutation = m_next_permutation;
+      }
+      else {
+        m_permutation = feistel_permutation();
+        m_shuffled_indices = m_next_shuffled_indices;
+      }
+      m_next_epoch_is_shuffled = false;
+    }
+    else if (use_permutation_shuffle()) {
+      m_permutation = feistel_permutation(m_shuffled_indices.size(),
+                                          get_data_seq_generator()());
+    }
+    else {
+      if (m_shuffle) {
+        std::sort(m_shuffled_indices.begin(), m_shuffled_indices.end());
+      }
+      auto gen = get_epoch_shuffle_generator(m_shuffle_epoch + 1);
+      shuffle_indices(gen);
+    }
+    ++m_shuffle_epoch;
+    if (m_data_store != nullptr) {
+      m_data_store->localize_shuffled_indices(m_shuffled_indices);
+    }
     if (priming_data_store()) {
       m_data_store->set_shuffled_indices(&m_shuffled_indices);
     }
@@ -696,6 +1219,7 @@ void generic_data_reader::use_unused_index_set(execution_mode m)
   }
 
   m_shuffled_indices.swap(m_unused_indices[m]);
+  m_permutation = feistel_permutation();
   if (m_data_store != nullptr) {
     /// Update the data store's pointer to the shuffled indices
     m_data_store->set_shuffled_indices(&m_shuffled_indices);
@@ -705,6 +1229,53 @@ void generic_data_reader::use_unused_index_set(execution_mode m)
     m_unused_indices[m]); // Trick to force memory reallocation
 }
 
+void generic_data_reader::shard_across_trainers()
+{
+  lbann_comm& comm = *get_comm();
+  const int num_trainers = comm.get_num_trainers();
+  if (num_trainers == 1) {
+    return;
+  }
+
+  // The shards are cut from the sorted indices, so every trainer must
+  // start from the same set
+  const El::mpi::Comm& c = comm.get_intertrainer_comm();
+  uint64_t fingerprint[2] = {m_shuffled_indices.size(),
+                             index_set_fingerprint(m_shuffled_indices)};
+  uint64_t root_fingerprint[2] = {fingerprint[0], fingerprint[1]};
+  comm.broadcast<uint64_t>(0, root_fingerprint, 2, c);
+  const int same = (root_fingerprint[0] == fingerprint[0] &&
+                    root_fingerprint[1] == fingerprint[1]);
+  if (comm.allreduce(same, c, El::mpi::MIN) == 0) {
+    LBANN_ERROR("the ",
+                get_role(),
+                " samples differ between trainers, so they cannot be "
+                "split across trainers (trainers must be initialized "
+                "identically to carve the same validation set)");
+  }
+  if (m_shuffled_indices.size() < static_cast<size_t>(num_trainers)) {
+    LBANN_ERROR("cannot split the ",
+                m_shuffled_indices.size(),
+                " ",
+                get_role(),
+                " samples across ",
+                num_trainers,
+                " trainers");
+  }
+
+  std::sort(m_shuffled_indices.begin(), m_shuffled_indices.end());
+  size_t num_kept = 0;
+  for (size_t i = comm.get_trainer_rank(); i < m_shuffled_indices.size();
+       i += num_trainers) {
+    m_shuffled_indices[num_kept++] = m_shuffled_indices[i];
+  }
+  m_shuffled_indices.resize(num_kept);
+  shuffle_indices();
+  if (m_data_store != nullptr) {
+    m_data_store->set_shuffled_indices(&m_shuffled_indices);
+  }
+}
+
 bool generic_data_reader::save_to_checkpoint_shared(persist& p,
                                                     execution_mode mode)
 {
@@ -793,6 +1364,89 @@ void generic_data_reader::do_preload_data_store()
   LBANN_ERROR("Not implemented.");
 }
 
+void generic_data_reader::prepare_mini_batch(El::Int mb_size)
+{
+  const int num_positions = static_cast<int>(m_fetch_indices->size());
+  std::vector<int> indices, next_indices;
+  indices.reserve(mb_size);
+  for (El::Int s = 0; s < mb_size; ++s) {
+    indices.push_back(get_fetch_index(m_fetch_pos + s * m_sample_stride));
+  }
+  // The next mini-batch is assumed to be as large as this one
+  const int next_pos = m_fetch_pos + m_stride_to_next_mini_batch;
+  for (El::Int s = 0; s < mb_size; ++s) {
+    const int pos = next_pos + s * m_sample_stride;
+    if (pos >= num_positions) {
+      break;
+    }
+    next_indices.push_back(get_fetch_index(pos));
+  }
+  prepare_samples(indices, next_indices);
+}
+
+void generic_data_reader::preload_data_store_in_parallel(
+  const std::function<size_t(int)>& group_of,
+  const std::function<void(const std::vector<int>&)>& load_group,
+  bool allow_threads)
+{
+  const int rank = m_comm->get_rank_in_trainer();
+  std::map<size_t, std::vector<int>> groups;
+  for (const auto& index : m_shuffled_indices) {
+    if (m_data_store->get_index_owner(index) == rank) {
+      groups[group_of(index)].push_back(index);
+    }
+  }
+
+  auto& arg_parser = global_argument_parser();
+  if (!allow_threads || groups.size() < 2 ||
+      arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_NO_THREAD)) {
+    for (const auto& g : groups) {
+      load_group(g.second);
+    }
+    return;
+  }
+
+  std::unique_ptr<thread_pool> io_thread_pool =
+    construct_io_thread_pool(m_comm, false);
+  const int num_threads = static_cast<int>(io_thread_pool->get_num_threads());
+
+  // largest groups first, each onto the least loaded thread
+  std::vector<const std::vector<int>*> order;
+  order.reserve(groups.size());
+  for (const auto& g : groups) {
+    order.push_back(&g.second);
+  }
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [](const std::vector<int>* a, const std::vector<int>* b) {
+                     return a->size() > b->size();
+                   });
+  std::vector<std::vector<const std::vector<int>*>> work(num_threads);
+  std::vector<size_t> load(num_threads, 0);
+  for (const auto* g : order) {
+    const int t = std::distance(load.begin(),
+                                std::min_element(load.begin(), load.end()));
+    work[t].push_back(g);
+    load[t] += g->size();
+  }
+
+  auto run = [&load_group](const std::vector<const std::vector<int>*>& w) {
+    for (const auto* g : w) {
+      load_group(*g);
+    }
+    return true;
+  };
+  const int me = io_thread_pool->get_local_thread_id();
+  for (int t = 0; t < num_threads; t++) {
+    if (t != me) {
+      io_thread_pool->submit_job_to_work_group(
+        [&run, &work, t]() { return run(work[t]); });
+    }
+  }
+  run(work[me]);
+  io_thread_pool->finish_work_group();
+}
+
 void generic_data_reader::set_file_dir(std::string s)
 {
   if (endsWith(s, "/")) {
@@ -830,6 +1484,24 @@ std::string generic_data_reader::get_data_sample_list() const
   return m_data_sample_list;
 }
 
+std::pair<std::string, bool> generic_data_reader::find_sample_list_cache(
+  const std::string& sample_list_file) const
+{
+  const std::string cache_dir =
+    global_argument_parser().get<std::string>(LBANN_OPTION_SAMPLE_LIST_CACHE);
+  if (cache_dir.empty() || sample_list_binary::is_binary(sample_list_file)) {
+    return std::make_pair(std::string{}, false);
+  }
+  const std::string cache_file =
+    sample_list_cache_path(cache_dir, sample_list_file);
+  int cached = 0;
+  if (m_comm->am_trainer_master()) {
+    cached = file::file_exists(cache_file) ? 1 : 0;
+  }
+  m_comm->trainer_broadcast(m_comm->get_trainer_master(), cached);
+  return std::make_pair(cache_file, cached != 0);
+}
+
 void generic_data_reader::keep_sample_order(bool same_order)
 {
   // The sample_list::keep_sample_order() should be called using this
@@ -963,6 +1635,7 @@ void generic_data_reader::setup_data_store(int mini_batch_size)
   }
 
   m_data_store->setup(mini_batch_size);
+  m_data_store->localize_shuffled_indices(m_shuffled_indices);
 }
 
 bool generic_data_reader::data_store_active() const
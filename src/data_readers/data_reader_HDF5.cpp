@@ -27,9 +27,11 @@
 #include "conduit/conduit_relay_mpi.hpp"
 
 #include "lbann/data_readers/data_reader_HDF5.hpp"
+#include "lbann/data_coordinator/io_trace.hpp"
 #include "lbann/data_readers/data_reader_sample_list_impl.hpp"
 #include "lbann/data_readers/sample_list_impl.hpp"
 #include "lbann/data_readers/sample_list_open_files_impl.hpp"
+#include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/timer.hpp"
 
 namespace lbann {
@@ -49,6 +51,40 @@ std::vector<ToType> do_coerce(FromType const* const data_in,
   return std::vector<ToType>{data_in, data_in + num_elements};
 }
 
+/** @brief Closes an HDF5 group when it goes out of scope */
+struct hdf5_group_closer
+{
+  hid_t id;
+  ~hdf5_group_closer() { H5Gclose(id); }
+};
+
+/** @brief Record the read of an HDF5 dataset in the I/O trace
+ *
+ *  The offset in the file is only known for contiguous datasets;
+ *  chunked and compact ones are recorded at an unknown offset.
+ */
+void trace_hdf5_read(hid_t group, const std::string& path, double start)
+{
+  const double latency = get_time() - start;
+  const ssize_t name_length = H5Fget_name(group, nullptr, 0);
+  std::string file(std::max<ssize_t>(name_length, 0), '\0');
+  if (name_length > 0) {
+    H5Fget_name(group, file.data(), file.size() + 1);
+  }
+  uint64_t offset = io_trace_unknown_offset;
+  uint64_t length = 0;
+  const hid_t dataset = H5Dopen2(group, path.c_str(), H5P_DEFAULT);
+  if (dataset >= 0) {
+    const haddr_t addr = H5Dget_offset(dataset);
+    if (addr != HADDR_UNDEF) {
+      offset = addr;
+    }
+    length = H5Dget_storage_size(dataset);
+    H5Dclose(dataset);
+  }
+  io_trace_record(io_trace_op::read, file, offset, length, start, latency);
+}
+
 template <typename T>
 void do_normalize(T* const data,
                   double const scale,
@@ -84,8 +120,7 @@ void do_repack_image(T* const src_buf,
                      int const n_channels)
 {
   size_t const size = n_rows * n_cols;
-  std::vector<T> work;
-  work.reserve(n_elts);
+  std::vector<T> work(n_elts);
   T* const dst_buf = work.data();
   for (size_t row = 0; row < n_rows; ++row) {
     for (size_t col = 0; col < n_cols; ++col) {
@@ -114,6 +149,61 @@ void do_repack_image(T* const src_buf,
   std::copy_n(dst_buf, n_elts, src_buf);
 }
 
+/** Normalizes a float or double leaf; a single channel uses the
+ *  scalar kernel */
+void normalize_leaf(conduit::Node& leaf,
+                    const double* scale,
+                    const double* bias,
+                    size_t const n_channels)
+{
+  void* vals = leaf.element_ptr(0);
+  size_t const n_elements = leaf.dtype().number_of_elements();
+  if (leaf.dtype().is_float32()) {
+    float* data = reinterpret_cast<float*>(vals);
+    if (n_channels == 1) {
+      do_normalize(data, scale[0], bias[0], n_elements);
+    }
+    else {
+      do_normalize(data, scale, bias, n_elements, n_channels);
+    }
+  }
+  else if (leaf.dtype().is_float64()) {
+    double* data = reinterpret_cast<double*>(vals);
+    if (n_channels == 1) {
+      do_normalize(data, scale[0], bias[0], n_elements);
+    }
+    else {
+      do_normalize(data, scale, bias, n_elements, n_channels);
+    }
+  }
+  else {
+    LBANN_ERROR(
+      "Only float and double are currently supported for normalization");
+  }
+}
+
+/** Repacks a float or double HWC image leaf to CHW */
+void repack_leaf(conduit::Node& leaf,
+                 size_t const n_rows,
+                 size_t const n_cols,
+                 int const n_channels)
+{
+  void* vals = leaf.element_ptr(0);
+  size_t const n_elements = leaf.dtype().number_of_elements();
+  if (leaf.dtype().is_float32()) {
+    float* data = reinterpret_cast<float*>(vals);
+    do_repack_image(data, n_elements, n_rows, n_cols, n_channels);
+  }
+  else if (leaf.dtype().is_float64()) {
+    double* data = reinterpret_cast<double*>(vals);
+    do_repack_image(data, n_elements, n_rows, n_cols, n_channels);
+  }
+  else {
+    LBANN_ERROR(
+      "Only float and double are currently supported for normalization");
+  }
+}
+
 } // namespace
 
 template <typename T>
@@ -200,6 +290,7 @@ void hdf5_data_reader::copy_members(const hdf5_data_reader& rhs)
   m_experiment_schema = rhs.m_experiment_schema;
   m_data_schema = rhs.m_data_schema;
   m_useme_node_map = rhs.m_useme_node_map;
+  m_field_plans = rhs.m_field_plans;
   // m_data_map should not be copied, as it contains pointers, and is only
   // needed for setting up other structures during load
 
@@ -285,6 +376,14 @@ void hdf5_data_reader::load_schema(std::string filename, conduit::Node& schema)
     m_comm->get_trainer_comm().GetMPIComm());
 }
 
+namespace {
+#ifdef H5_HAVE_THREADSAFE
+constexpr bool hdf5_is_thread_safe = true;
+#else
+constexpr bool hdf5_is_thread_safe = false;
+#endif // H5_HAVE_THREADSAFE
+} // namespace
+
 void hdf5_data_reader::do_preload_data_store()
 {
   double tm1 = get_time();
@@ -293,34 +392,33 @@ void hdf5_data_reader::do_preload_data_store()
               << get_role() << std::endl;
   }
 
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
-    }
-    try {
-      conduit::Node& node = m_data_store->get_empty_node(index);
-      load_sample(node, index);
-      m_data_store->set_preloaded_conduit_node(index, node);
-    }
-    catch (conduit::Error const& e) {
-      LBANN_ERROR("trying to load the node ",
-                  index,
-                  " and caught conduit exception: ",
-                  e.what());
-    }
-  }
-  // Once all of the data has been preloaded, close all of the file handles
-
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
-    }
-    close_file(index); // data_reader_sample_list::close_file
-  }
+  // Each group is one file, opened with a handle private to the loading
+  // thread; the sample list's open-file bookkeeping is not thread safe
+  preload_data_store_in_parallel(
+    [this](int index) {
+      return static_cast<size_t>(m_sample_list[index].first);
+    },
+    [this](const std::vector<int>& indices) {
+      const auto file_id = m_sample_list[indices.front()].first;
+      const std::string path = m_sample_list.get_samples_file_path(file_id);
+      hid_t file_handle = conduit::relay::io::hdf5_open_file_for_read(path);
+      for (int index : indices) {
+        try {
+          conduit::Node& node = m_data_store->get_empty_node(index);
+          load_sample(node, file_handle, m_sample_list[index].second, index);
+          m_data_store->set_preloaded_conduit_node(index, node);
+        }
+        catch (conduit::Error const& e) {
+          conduit::relay::io::hdf5_close_file(file_handle);
+          LBANN_ERROR("trying to load the node ",
+                      index,
+                      " and caught conduit exception: ",
+                      e.what());
+        }
+      }
+      conduit::relay::io::hdf5_close_file(file_handle);
+    },
+    hdf5_is_thread_safe);
 
   size_t nn = m_data_store->get_num_global_indices();
   if (get_comm()->am_world_master()) {
@@ -338,50 +436,61 @@ void hdf5_data_reader::load_sample(conduit::Node& node,
                                    bool ignore_failure)
 {
   auto [file_handle, sample_name] = data_reader_sample_list::open_file(index);
-  // load data for the field names specified in the user's experiment-schema
-  for (auto& [pathname, path_node] : m_useme_node_map) {
-    // do not load a "packed" field, as it doesn't exist on disk!
-    if (!is_composite_node(path_node)) {
-
-      // check that the requested data (pathname) exists on disk
-      const std::string original_path = "/" + sample_name + "/" + pathname;
-      if (!conduit::relay::io::hdf5_has_path(file_handle, original_path)) {
-        if (ignore_failure) {
-          continue;
-        }
-        LBANN_ERROR("hdf5_has_path failed for path: ", original_path);
-      }
-
-      // get the new path-name (prepend the index)
-      std::ostringstream ss2;
-      ss2 << LBANN_DATA_ID_STR(index) << '/' << pathname;
-      const std::string new_pathname(ss2.str());
-
-      // note: this will throw an exception if the child node doesn't exist
-      const conduit::Node& metadata = path_node.child(s_metadata_node_name);
-
-      // optionally coerce the data, e.g, from double to float, per settings
-      // in the experiment_schema
-      if (metadata.has_child(s_coerce_name)) {
-        coerce(metadata, file_handle, original_path, new_pathname, node);
-      }
-      else {
-        conduit::relay::io::hdf5_read(file_handle,
-                                      original_path,
-                                      node[new_pathname]);
-      }
+  load_sample(node, file_handle, sample_name, index, ignore_failure);
+}
 
-      // optionally normalize
-      if (metadata.has_child("scale")) {
-        normalize(node, new_pathname, metadata);
+void hdf5_data_reader::load_sample(conduit::Node& node,
+                                   hid_t file_handle,
+                                   const std::string& sample_name,
+                                   size_t index,
+                                   bool ignore_failure)
+{
+  // Fields are looked up relative to the sample's group, so the path
+  // from the file root is only resolved once per sample
+  const std::string group_path = "/" + sample_name;
+  const hid_t sample_group =
+    conduit::relay::io::hdf5_has_path(file_handle, group_path)
+      ? H5Gopen2(file_handle, group_path.c_str(), H5P_DEFAULT)
+      : hid_t{-1};
+  if (sample_group < 0) {
+    if (!ignore_failure) {
+      LBANN_ERROR("failed to open the group of sample: ", group_path);
+    }
+    pack(node, index);
+    return;
+  }
+  const hdf5_group_closer close_sample_group{sample_group};
+
+  // load data for the field names specified in the user's experiment-schema;
+  // "packed" fields don't exist on disk, so they have no plan
+  conduit::Node& sample = node[LBANN_DATA_ID_STR(index)];
+  for (const field_plan& plan : m_field_plans) {
+    // check that the requested data (pathname) exists on disk
+    if (!conduit::relay::io::hdf5_has_path(sample_group, plan.pathname)) {
+      if (ignore_failure) {
+        continue;
       }
+      LBANN_ERROR("hdf5_has_path failed for path: ",
+                  group_path,
+                  "/",
+                  plan.pathname);
+    }
 
-      // for images
-      if (metadata.has_child("channels") &&
-          metadata["channels"].as_int64() > 1) {
-        repack_image(node, new_pathname, metadata);
-      }
+    // optionally coerce the data, e.g, from double to float, per settings
+    // in the experiment_schema
+    conduit::Node& leaf = sample[plan.pathname];
+    const double read_start = io_trace_enabled() ? get_time() : 0.;
+    if (plan.coerce_to != field_plan::coercion::none) {
+      coerce(plan.coerce_to, sample_group, plan.pathname, leaf);
+    }
+    else {
+      conduit::relay::io::hdf5_read(sample_group, plan.pathname, leaf);
     }
+    if (io_trace_enabled()) {
+      trace_hdf5_read(sample_group, plan.pathname, read_start);
+    }
+
+    process_field(leaf, plan);
   }
 
   pack(node, index);
@@ -391,71 +500,126 @@ void hdf5_data_reader::normalize(conduit::Node& node,
                                  const std::string& path,
                                  const conduit::Node& metadata)
 {
-  void* vals = node[path].element_ptr(0);
-  size_t n_elements = node[path].dtype().number_of_elements();
+  const field_plan plan = compile_field_plan(path, metadata);
+  if (!plan.scale.empty()) {
+    normalize_leaf(node[path],
+                   plan.scale.data(),
+                   plan.bias.data(),
+                   plan.scale.size());
+  }
+}
 
-  // treat this as a multi-channel image
-  if (metadata.has_child("channels")) {
+void hdf5_data_reader::process_field(conduit::Node& leaf,
+                                     const field_plan& plan)
+{
+  if (!plan.scale.empty()) {
+    normalize_leaf(leaf,
+                   plan.scale.data(),
+                   plan.bias.data(),
+                   plan.scale.size());
+  }
+  if (plan.repack) {
+    repack_leaf(leaf, plan.rows, plan.cols, plan.channels);
+  }
+}
 
-    // get number of channels, with sanity checking
-    int64_t n_channels = metadata["channels"].value();
-    int sanity = metadata["scale"].dtype().number_of_elements();
-    if (sanity != n_channels) {
-      LBANN_ERROR("sanity: ",
-                  sanity,
-                  " should equal ",
-                  n_channels,
-                  " but instead is: ",
-                  n_channels);
+hdf5_data_reader::field_plan
+hdf5_data_reader::compile_field_plan(const std::string& pathname,
+                                     const conduit::Node& metadata) const
+{
+  field_plan plan;
+  plan.pathname = pathname;
+
+  if (metadata.has_child(s_coerce_name)) {
+    // I don't know why, but conduit includes quotes around the string,
+    // even when they're not in the json file -- so need to strip them off
+    const std::string& cc = metadata[s_coerce_name].to_string();
+    const std::string& coerce_to = cc.substr(1, cc.size() - 2);
+    if (coerce_to == "float") {
+      plan.coerce_to = field_plan::coercion::to_float;
     }
-
-    // sanity check; TODO: implement for other formats when needed
-    if (n_channels > 1 && !metadata.has_child("hwc")) {
-      LBANN_ERROR("we only currently know how to deal with HWC input images");
+    else if (coerce_to == "double") {
+      plan.coerce_to = field_plan::coercion::to_double;
     }
-
-    // get the scale and bias arrays
-    const double* scale = metadata["scale"].as_double_ptr();
-    std::vector<double> b(n_channels, 0);
-    const double* bias = b.data();
-    if (metadata.has_child("bias")) {
-      bias = metadata["bias"].as_double_ptr();
+    else {
+      LBANN_ERROR("Un-implemented type requested for coercion: ",
+                  coerce_to,
+                  "; you need to update the data reader to support this");
     }
+  }
 
-    // perform the normalization
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
-    }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements, n_channels);
+  if (metadata.has_child("channels")) {
+    plan.channels = metadata["channels"].to_int64();
+  }
+
+  if (metadata.has_child("scale")) {
+    // treat this as a multi-channel image
+    if (metadata.has_child("channels")) {
+      // get number of channels, with sanity checking
+      int sanity = metadata["scale"].dtype().number_of_elements();
+      if (sanity != plan.channels) {
+        LBANN_ERROR("sanity: ",
+                    sanity,
+                    " should equal ",
+                    plan.channels,
+                    " but instead is: ",
+                    plan.channels);
+      }
+
+      // sanity check; TODO: implement for other formats when needed
+      if (plan.channels > 1 && !metadata.has_child("hwc")) {
+        LBANN_ERROR("we only currently know how to deal with HWC input images");
+      }
+
+      const double* scale = metadata["scale"].as_double_ptr();
+      plan.scale.assign(scale, scale + plan.channels);
+      if (metadata.has_child("bias")) {
+        const double* bias = metadata["bias"].as_double_ptr();
+        plan.bias.assign(bias, bias + plan.channels);
+      }
+      else {
+        plan.bias.assign(plan.channels, 0.0);
+      }
     }
+
+    // 1D case
     else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
+      double scale = metadata["scale"].value();
+      double bias = 0;
+      if (metadata.has_child("bias")) {
+        bias = metadata["bias"].value();
+      }
+      plan.scale.assign(1, scale);
+      plan.bias.assign(1, bias);
     }
   }
 
-  // 1D case
-  else {
-    double scale = metadata["scale"].value();
-    double bias = 0;
-    if (metadata.has_child("bias")) {
-      bias = metadata["bias"].value();
-    }
-
-    if (node[path].dtype().is_float32()) {
-      float* data = reinterpret_cast<float*>(vals);
-      do_normalize(data, scale, bias, n_elements);
+  // for images
+  if (plan.channels > 1) {
+    if (!metadata.has_child("hwc")) {
+      LBANN_ERROR("we only currently know how to deal with HWC input images");
     }
-    else if (node[path].dtype().is_float64()) {
-      double* data = reinterpret_cast<double*>(vals);
-      do_normalize(data, scale, bias, n_elements);
+    if (!metadata.has_child("dims")) {
+      LBANN_ERROR("your metadata is missing 'dims' for an image");
     }
-    else {
-      LBANN_ERROR(
-        "Only float and double are currently supported for normalization");
+    const conduit::int64* dims = metadata["dims"].as_int64_ptr();
+    plan.repack = true;
+    plan.rows = dims[0];
+    plan.cols = dims[1];
+  }
+
+  return plan;
+}
+
+void hdf5_data_reader::compile_field_plans()
+{
+  m_field_plans.clear();
+  for (const auto& [pathname, path_node] : m_useme_node_map) {
+    // do not load a "packed" field, as it doesn't exist on disk!
+    if (!is_composite_node(path_node)) {
+      // note: this will throw an exception if the child node doesn't exist
+      const conduit::Node& metadata = path_node.child(s_metadata_node_name);
+      m_field_plans.push_back(compile_field_plan(pathname, metadata));
     }
   }
 }
@@ -508,6 +672,7 @@ void hdf5_data_reader::parse_schemas()
   }
 
   construct_linearized_size_lookup_tables();
+  compile_field_plans();
 }
 
 // recursive
@@ -739,6 +904,15 @@ void hdf5_data_reader::coerce(const conduit::Node& metadata,
                               const std::string& original_path,
                               const std::string& new_pathname,
                               conduit::Node& node)
+{
+  const field_plan plan = compile_field_plan(original_path, metadata);
+  coerce(plan.coerce_to, file_handle, original_path, node[new_pathname]);
+}
+
+void hdf5_data_reader::coerce(field_plan::coercion coerce_to,
+                              hid_t file_handle,
+                              const std::string& original_path,
+                              conduit::Node& leaf)
 {
   conduit::Node tmp;
   conduit::relay::io::hdf5_read(file_handle, original_path, tmp);
@@ -755,29 +929,24 @@ void hdf5_data_reader::coerce(const conduit::Node& metadata,
       "source data is not float or data; please update the data reader");
   }
 
-  // I don't know why, but conduit includes quotes around the string,
-  // even when they're not in the json file -- so need to strip them off
-  const std::string& cc = metadata[s_coerce_name].to_string();
-  const std::string& coerce_to = cc.substr(1, cc.size() - 2);
-
   // this is just ugly, but I don't know how to make it better; would
   // like to have a single call to do_coerce<>
-  if (coerce_to == "float") {
-    node[new_pathname] =
-      (from_is_float
-         ? do_coerce<float>(reinterpret_cast<float*>(vals), num_elements)
-         : do_coerce<float>(reinterpret_cast<double*>(vals), num_elements));
-  }
-  else if (coerce_to == "double") {
-    node[new_pathname] =
-      (from_is_float
-         ? do_coerce<double>(reinterpret_cast<float*>(vals), num_elements)
-         : do_coerce<double>(reinterpret_cast<double*>(vals), num_elements));
-  }
-  else {
-    LBANN_ERROR("Un-implemented type requested for coercion: ",
-                coerce_to,
-                "; you need to update the data reader to support this");
+  switch (coerce_to) {
+  case field_plan::coercion::to_float:
+    leaf = (from_is_float
+              ? do_coerce<float>(reinterpret_cast<float*>(vals), num_elements)
+              : do_coerce<float>(reinterpret_cast<double*>(vals),
+                                 num_elements));
+    break;
+  case field_plan::coercion::to_double:
+    leaf = (from_is_float
+              ? do_coerce<double>(reinterpret_cast<float*>(vals), num_elements)
+              : do_coerce<double>(reinterpret_cast<double*>(vals),
+                                  num_elements));
+    break;
+  case field_plan::coercion::none:
+    leaf = tmp;
+    break;
   }
 }
 
@@ -800,26 +969,9 @@ void hdf5_data_reader::repack_image(conduit::Node& node,
   }
   // ==== end: sanity checking
 
-  void* vals = node[path].element_ptr(0);
-  size_t n_bytes = node[path].dtype().number_of_elements() *
-                   node[path].dtype().element_bytes();
   int64_t n_channels = metadata["channels"].value();
   const conduit::int64* dims = metadata["dims"].as_int64_ptr();
-  const int row_dim = dims[0];
-  const int col_dim = dims[1];
-
-  if (node[path].dtype().is_float32()) {
-    float* data = reinterpret_cast<float*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
-  }
-  else if (node[path].dtype().is_float64()) {
-    double* data = reinterpret_cast<double*>(vals);
-    do_repack_image(data, n_bytes, row_dim, col_dim, n_channels);
-  }
-  else {
-    LBANN_ERROR(
-      "Only float and double are currently supported for normalization");
-  }
+  repack_leaf(node[path], dims[0], dims[1], n_channels);
 }
 
 const std::vector<int> hdf5_data_reader::get_data_dims(std::string name) const
@@ -919,8 +1071,66 @@ void hdf5_data_reader::construct_linearized_size_lookup_tables(
   }
 }
 
+void hdf5_data_reader::prepare_samples(const std::vector<int>& indices,
+                                       const std::vector<int>& next_indices)
+{
+  data_reader_sample_list::prepare_samples(indices, next_indices);
+  m_mini_batch_samples.clear();
+  if (m_data_store == nullptr) {
+    return;
+  }
+
+  // Group the samples that are left on disk by the file holding them
+  std::map<size_t, std::vector<int>> files;
+  for (const int index : indices) {
+    if (!m_data_store->is_cached(index)) {
+      files[m_sample_list[index].first].push_back(index);
+    }
+  }
+
+  // Allocate every node first; the I/O threads then only look them up
+  for (const auto& [file_id, indices] : files) {
+    for (int index : indices) {
+      m_mini_batch_samples[index];
+    }
+  }
+  for (auto& [file_id, indices] : files) {
+    // Data ids follow the order of the samples in their file
+    std::sort(indices.begin(), indices.end());
+    const hid_t file_handle =
+      data_reader_sample_list::open_file(indices.front()).first;
+    for (int index : indices) {
+      try {
+        load_sample(m_mini_batch_samples.at(index),
+                    file_handle,
+                    m_sample_list[index].second,
+                    index);
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR("trying to load the node ",
+                    index,
+                    " and caught conduit exception: ",
+                    e.what());
+      }
+    }
+  }
+}
+
 bool hdf5_data_reader::fetch_conduit_node(conduit::Node& sample, int data_id)
 {
+  if (!get_data_store().is_cached(data_id)) {
+    const auto loaded = m_mini_batch_samples.find(data_id);
+    if (loaded != m_mini_batch_samples.end()) {
+      sample = loaded->second;
+      return true;
+    }
+    // the data store is over its memory budget and left this sample on
+    // disk; the sample list's file handles are shared by the I/O threads
+    static std::mutex uncached_mutex;
+    std::lock_guard<std::mutex> lock(uncached_mutex);
+    load_sample(sample, data_id);
+    return true;
+  }
   // get the pathname to the data, and verify it exists in the conduit::Node
   const conduit::Node& node = get_data_store().get_conduit_node(data_id);
   sample = node;
@@ -28,13 +28,54 @@
 
 #include "lbann/data_readers/data_reader_csv.hpp"
 #include "lbann/comm_impl.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/lbann_library.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
+#include "lbann/utils/timer.hpp"
 
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
 #include <unordered_set>
 
 namespace lbann {
 
+static_assert(sizeof(csv_column_header) == 128,
+              "unexpected csv_column_header size");
+
+namespace {
+
+/// Columns of the cache start on this boundary
+constexpr size_t column_alignment = 64;
+
+size_t align_column(size_t offset)
+{
+  return (offset + column_alignment - 1) / column_alignment *
+         column_alignment;
+}
+
+/// Start of the line after the one containing @c p
+const char* next_line(const char* p, const char* end)
+{
+  const void* nl = std::memchr(p, '\n', end - p);
+  return nl == nullptr ? end : static_cast<const char*>(nl) + 1;
+}
+
+/// End of the line starting at @c p, excluding the newline
+const char* line_end(const char* p, const char* end)
+{
+  const void* nl = std::memchr(p, '\n', end - p);
+  return nl == nullptr ? end : static_cast<const char*>(nl);
+}
+
+} // namespace
+
 csv_reader::csv_reader(bool shuffle) : generic_data_reader(shuffle)
 {
   // By default assume that there are labels in the CSV data set
@@ -59,6 +100,8 @@ csv_reader::csv_reader(const csv_reader& other)
     m_index(other.m_index),
     m_labels(other.m_labels),
     m_responses(other.m_responses),
+    m_column_cache(other.m_column_cache),
+    m_columns(other.m_columns),
     m_col_transforms(other.m_col_transforms),
     m_label_transform(other.m_label_transform),
     m_response_transform(other.m_response_transform)
@@ -86,6 +129,8 @@ csv_reader& csv_reader::operator=(const csv_reader& other)
   m_index = other.m_index;
   m_labels = other.m_labels;
   m_responses = other.m_responses;
+  m_column_cache = other.m_column_cache;
+  m_columns = other.m_columns;
   m_col_transforms = other.m_col_transforms;
   m_label_transform = other.m_label_transform;
   m_response_transform = other.m_response_transform;
@@ -110,6 +155,20 @@ void csv_reader::load()
 {
   bool master = m_comm->am_world_master();
   setup_ifstreams();
+  if (global_argument_parser().get<bool>(LBANN_OPTION_CSV_COLUMN_CACHE)) {
+    // Values are cached after conversion, and custom column transforms
+    // cannot be told apart when checking whether a cache is current
+    if (!m_col_transforms.empty()) {
+      if (master) {
+        LBANN_WARNING("csv_reader: column transforms are set, so the column "
+                      "cache is not used for ",
+                      get_data_filename());
+      }
+    }
+    else if (load_column_cache()) {
+      return;
+    }
+  }
   std::ifstream& ifs = *m_ifstreams[0];
   const El::mpi::Comm& world_comm = m_comm->get_world_comm();
   // Parse the header to determine how many columns there are.
@@ -287,6 +346,12 @@ void csv_reader::setup(int num_io_threads,
 
 bool csv_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx)
 {
+  if (m_column_cache != nullptr) {
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+      X(i, mb_idx) = m_columns[i][data_id];
+    }
+    return true;
+  }
   auto line = fetch_line_label_response(data_id);
   // TODO: Avoid unneeded copies.
   for (size_t i = 0; i < line.size(); ++i) {
@@ -339,6 +404,13 @@ std::vector<DataType> csv_reader::fetch_line(int data_id)
 
 std::vector<DataType> csv_reader::fetch_line_label_response(int data_id)
 {
+  if (m_column_cache != nullptr) {
+    std::vector<DataType> parsed_line(m_columns.size());
+    for (size_t i = 0; i < m_columns.size(); ++i) {
+      parsed_line[i] = m_columns[i][data_id];
+    }
+    return parsed_line;
+  }
   std::string line = fetch_raw_line(data_id);
   std::vector<DataType> parsed_line;
   // Note: load already verified that every line is properly formatted.
@@ -410,6 +482,402 @@ void csv_reader::skip_rows(std::ifstream& s, int rows)
   }
 }
 
+csv_column_header
+csv_reader::expected_column_header(const std::string& csv_path) const
+{
+  csv_column_header h;
+  std::memset(&h, 0, sizeof(h));
+  std::memcpy(h.magic, "LBCSVCOL", sizeof(h.magic));
+  h.version = 1;
+  h.value_size = sizeof(DataType);
+  struct stat st;
+  if (stat(csv_path.c_str(), &st) != 0) {
+    LBANN_ERROR("csv_reader: failed to stat ", csv_path);
+  }
+  h.csv_size = st.st_size;
+  h.csv_mtime = st.st_mtime;
+  h.skip_rows = m_skip_rows;
+  h.skip_cols = m_skip_cols;
+  h.label_col = m_label_col;
+  h.response_col = m_response_col;
+  h.has_header = m_has_header;
+  h.disable_labels = m_disable_labels;
+  h.disable_responses = m_disable_responses;
+  h.separator = m_separator;
+  std::strncpy(h.reader_type, get_type().c_str(), sizeof(h.reader_type) - 1);
+  return h;
+}
+
+bool csv_reader::is_column_cache_current(const std::string& csv_path,
+                                         const std::string& cache_path) const
+{
+  std::ifstream in(cache_path, std::ios::binary);
+  csv_column_header h;
+  if (!in.read(reinterpret_cast<char*>(&h), sizeof(h))) {
+    return false;
+  }
+  const csv_column_header e = expected_column_header(csv_path);
+  return std::memcmp(h.magic, e.magic, sizeof(h.magic)) == 0 &&
+         h.version == e.version && h.value_size == e.value_size &&
+         h.csv_size == e.csv_size && h.csv_mtime == e.csv_mtime &&
+         h.skip_rows == e.skip_rows && h.skip_cols == e.skip_cols &&
+         h.label_col == e.label_col && h.response_col == e.response_col &&
+         h.has_header == e.has_header &&
+         h.disable_labels == e.disable_labels &&
+         h.disable_responses == e.disable_responses &&
+         h.separator == e.separator &&
+         std::strncmp(h.reader_type, e.reader_type, sizeof(h.reader_type)) ==
+           0;
+}
+
+void csv_reader::write_column_cache(const std::string& csv_path,
+                                    const std::string& cache_path)
+{
+  csv_column_header header = expected_column_header(csv_path);
+  std::shared_ptr<const void> text_map;
+  size_t text_size;
+  std::tie(text_map, text_size) = file::map_read_only(csv_path);
+  madvise(const_cast<void*>(text_map.get()), text_size, MADV_SEQUENTIAL);
+  const char* const text = static_cast<const char*>(text_map.get());
+  const char* const end = text + text_size;
+
+  // Parse the header to determine how many columns there are
+  const char* p = text;
+  for (int i = 0; i < m_skip_rows; ++i) {
+    if (p == end) {
+      LBANN_ERROR("csv_reader: error on skipping rows");
+    }
+    p = next_line(p, end);
+  }
+  if (p == end) {
+    LBANN_ERROR("csv_reader: failed to read header in ", csv_path);
+  }
+  const int num_cols = std::count(p, line_end(p, end), m_separator) + 1;
+  if (m_skip_cols >= num_cols) {
+    LBANN_ERROR("csv_reader: asked to skip more columns than are present");
+  }
+  const int label_col = m_label_col < 0 ? num_cols - 1 : m_label_col;
+  if (!m_disable_labels && label_col >= num_cols) {
+    LBANN_ERROR("csv_reader: label column ", label_col, " is not present");
+  }
+  const int response_col = m_response_col < 0 ? num_cols - 1 : m_response_col;
+  if (!m_disable_responses && response_col >= num_cols) {
+    LBANN_ERROR("csv_reader: response column ",
+                response_col,
+                " is not present");
+  }
+  const char* const rows_begin = m_has_header ? next_line(p, end) : p;
+  if (rows_begin == end) {
+    LBANN_ERROR("csv_reader: reached EOF after reading header");
+  }
+
+  // The same columns that fetch_line_label_response returns, then the
+  // label and the response
+  std::vector<csv_column_entry> table;
+  std::vector<int> data_slot(num_cols, -1);
+  for (int col = 0; col < num_cols; ++col) {
+    if ((!m_disable_labels && col == label_col) ||
+        (!m_disable_responses && col == response_col) || col < m_skip_cols) {
+      continue;
+    }
+    data_slot[col] = table.size();
+    table.push_back({csv_column_entry::DATA, col, 0});
+  }
+  const size_t num_data_columns = table.size();
+  if (!m_disable_labels) {
+    table.push_back({csv_column_entry::LABEL, label_col, 0});
+  }
+  if (!m_disable_responses) {
+    table.push_back({csv_column_entry::RESPONSE, response_col, 0});
+  }
+
+  // Split the rows into one chunk per thread at line boundaries
+  std::unique_ptr<thread_pool> io_thread_pool =
+    construct_io_thread_pool(m_comm, false);
+  const int num_threads = static_cast<int>(io_thread_pool->get_num_threads());
+  auto run_on_threads = [&io_thread_pool,
+                         num_threads](const std::function<void(int)>& f) {
+    const int me = io_thread_pool->get_local_thread_id();
+    for (int t = 0; t < num_threads; ++t) {
+      if (t != me) {
+        io_thread_pool->submit_job_to_work_group([&f, t]() {
+          f(t);
+          return true;
+        });
+      }
+    }
+    f(me);
+    io_thread_pool->finish_work_group();
+  };
+  std::vector<const char*> chunks(num_threads + 1, end);
+  chunks[0] = rows_begin;
+  for (int t = 1; t < num_threads; ++t) {
+    const char* b = rows_begin + (end - rows_begin) * t / num_threads;
+    // A chunk starts at the first line that begins at or after b
+    chunks[t] = (b == rows_begin ? b : next_line(b - 1, end));
+    chunks[t] = std::max(chunks[t], chunks[t - 1]);
+  }
+  std::vector<size_t> first_row(num_threads + 1, 0);
+  run_on_threads([&](int t) {
+    size_t n = 0;
+    for (const char* line = chunks[t]; line < chunks[t + 1];
+         line = next_line(line, end)) {
+      ++n;
+    }
+    first_row[t + 1] = n;
+  });
+  for (int t = 0; t < num_threads; ++t) {
+    first_row[t + 1] += first_row[t];
+  }
+  const size_t num_rows = first_row[num_threads];
+
+  size_t offset = align_column(sizeof(header) +
+                               table.size() * sizeof(csv_column_entry));
+  for (auto& column : table) {
+    column.offset = offset;
+    const size_t value_size = (column.kind == csv_column_entry::LABEL
+                                 ? sizeof(int32_t)
+                                 : sizeof(DataType));
+    offset += align_column(num_rows * value_size);
+  }
+  header.num_rows = num_rows;
+  header.num_cols = num_cols;
+  header.num_columns = table.size();
+
+  // Columns are written in place into a temporary file, which is renamed
+  // once complete so that concurrent runs never see a partial cache
+  const std::string tmp_path =
+    cache_path + ".tmp" + std::to_string(static_cast<long>(getpid()));
+  const int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    LBANN_ERROR("csv_reader: failed to create ", tmp_path);
+  }
+  void* out_map = MAP_FAILED;
+  if (ftruncate(fd, offset) == 0) {
+    out_map = mmap(nullptr, offset, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  }
+  if (out_map == MAP_FAILED) {
+    close(fd);
+    unlink(tmp_path.c_str());
+    LBANN_ERROR("csv_reader: failed to allocate ", offset, " bytes for ",
+                tmp_path);
+  }
+  char* const out = static_cast<char*>(out_map);
+  try {
+    std::vector<DataType*> data(num_data_columns);
+    for (size_t i = 0; i < num_data_columns; ++i) {
+      data[i] = reinterpret_cast<DataType*>(out + table[i].offset);
+    }
+    int32_t* labels = nullptr;
+    DataType* responses = nullptr;
+    for (size_t i = num_data_columns; i < table.size(); ++i) {
+      if (table[i].kind == csv_column_entry::LABEL) {
+        labels = reinterpret_cast<int32_t*>(out + table[i].offset);
+      }
+      else {
+        responses = reinterpret_cast<DataType*>(out + table[i].offset);
+      }
+    }
+
+    // Each thread converts the rows of its chunk
+    std::vector<std::exception_ptr> errors(num_threads);
+    std::vector<std::unordered_set<int>> label_classes(num_threads);
+    run_on_threads([&](int t) {
+      std::string field;
+      size_t row = first_row[t];
+      try {
+        for (const char* line = chunks[t]; line < chunks[t + 1];
+             line = next_line(line, end), ++row) {
+          const char* const eol = line_end(line, end);
+          if (std::count(line, eol, m_separator) + 1 != num_cols) {
+            LBANN_ERROR("csv_reader: line ",
+                        row + 1,
+                        " does not have right number of entries");
+          }
+          const char* f = line;
+          for (int col = 0; col < num_cols; ++col) {
+            // The last column ends at the end of the line
+            const char* const fe = std::find(f, eol, m_separator);
+            const bool is_label = (labels != nullptr && col == label_col);
+            const bool is_response =
+              (responses != nullptr && col == response_col);
+            if (!is_label && !is_response && data_slot[col] < 0) {
+              f = fe + 1;
+              continue;
+            }
+            field.assign(f, fe);
+            f = fe + 1;
+            if (is_label) {
+              const int label = m_label_transform(field);
+              labels[row] = label;
+              label_classes[t].insert(label);
+            }
+            if (is_response) {
+              responses[row] = m_response_transform(field);
+            }
+            if (data_slot[col] >= 0) {
+              // No easy way to parameterize based on DataType, so always
+              // use double.
+              try {
+                data[data_slot[col]][row] = std::stod(field);
+              }
+              catch (std::logic_error&) {
+                LBANN_ERROR("csv_reader: could not convert '", field, "'");
+              }
+            }
+          }
+        }
+      }
+      catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+    for (const auto& e : errors) {
+      if (e != nullptr) {
+        std::rethrow_exception(e);
+      }
+    }
+
+    if (labels != nullptr) {
+      // Ensure the classes begin with 0, and there are no gaps.
+      std::unordered_set<int> classes;
+      for (const auto& c : label_classes) {
+        classes.insert(c.begin(), c.end());
+      }
+      auto minmax = std::minmax_element(classes.begin(), classes.end());
+      if (classes.empty() || *minmax.first != 0) {
+        LBANN_ERROR("csv_reader: classes are not indexed from 0");
+      }
+      if (*minmax.second != (int)classes.size() - 1) {
+        LBANN_ERROR("csv_reader: label classes are not contiguous");
+      }
+      header.num_labels = classes.size();
+    }
+
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + sizeof(header),
+                table.data(),
+                table.size() * sizeof(csv_column_entry));
+  }
+  catch (...) {
+    munmap(out_map, offset);
+    close(fd);
+    unlink(tmp_path.c_str());
+    throw;
+  }
+  // Make the cache visible to the other ranks before it is renamed
+  munmap(out_map, offset);
+  const bool synced = (fsync(fd) == 0);
+  close(fd);
+  if (!synced || std::rename(tmp_path.c_str(), cache_path.c_str()) != 0) {
+    unlink(tmp_path.c_str());
+    LBANN_ERROR("csv_reader: failed to write ", cache_path);
+  }
+}
+
+bool csv_reader::load_column_cache()
+{
+  const bool master = m_comm->am_world_master();
+  const El::mpi::Comm& world_comm = m_comm->get_world_comm();
+  const std::string csv_path = get_file_dir() + get_data_filename();
+  const std::string cache_path = csv_path + ".lbcol";
+
+  // The world master converts the CSV file once; later runs reuse it
+  int usable = 1;
+  if (master && !is_column_cache_current(csv_path, cache_path)) {
+    double tm1 = get_time();
+    try {
+      write_column_cache(csv_path, cache_path);
+      std::cout << "csv_reader: wrote " << cache_path << " in "
+                << get_time() - tm1 << "s" << std::endl;
+    }
+    catch (lbann_exception const& e) {
+      LBANN_WARNING("csv_reader: could not build the column cache (",
+                    e.what(),
+                    "); parsing the text of ",
+                    csv_path);
+      usable = 0;
+    }
+  }
+  m_comm->broadcast<int>(0, usable, world_comm);
+  if (!usable) {
+    return false;
+  }
+
+  size_t size;
+  std::tie(m_column_cache, size) = file::map_read_only(cache_path);
+  const char* const base = static_cast<const char*>(m_column_cache.get());
+  csv_column_header header;
+  if (size < sizeof(header)) {
+    LBANN_ERROR(cache_path, " is too small to be a CSV column cache");
+  }
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, "LBCSVCOL", sizeof(header.magic)) != 0 ||
+      header.version != 1 || header.value_size != sizeof(DataType)) {
+    LBANN_ERROR(cache_path, " is not a CSV column cache of this build");
+  }
+  if (size < sizeof(header) + header.num_columns * sizeof(csv_column_entry)) {
+    LBANN_ERROR(cache_path, " is truncated");
+  }
+  std::vector<csv_column_entry> table(header.num_columns);
+  std::memcpy(table.data(),
+              base + sizeof(header),
+              table.size() * sizeof(csv_column_entry));
+
+  m_num_cols = header.num_cols;
+  m_label_col = m_label_col < 0 ? m_num_cols - 1 : m_label_col;
+  m_response_col = m_response_col < 0 ? m_num_cols - 1 : m_response_col;
+  m_num_labels = header.num_labels;
+  m_num_samples = header.num_rows;
+  const int num_samples_to_use = get_absolute_sample_count();
+  if (num_samples_to_use > 0 && num_samples_to_use < m_num_samples) {
+    m_num_samples = num_samples_to_use;
+  }
+  if (master) {
+    std::cerr << "num samples: " << m_num_samples << "\n";
+  }
+
+  m_columns.clear();
+  m_labels.clear();
+  m_responses.clear();
+  for (const auto& column : table) {
+    const size_t value_size = (column.kind == csv_column_entry::LABEL
+                                 ? sizeof(int32_t)
+                                 : sizeof(DataType));
+    if (column.offset + header.num_rows * value_size > size) {
+      LBANN_ERROR(cache_path, " is truncated");
+    }
+    const char* const values = base + column.offset;
+    switch (column.kind) {
+    case csv_column_entry::DATA:
+      m_columns.push_back(reinterpret_cast<const DataType*>(values));
+      break;
+    case csv_column_entry::LABEL: {
+      const int32_t* labels = reinterpret_cast<const int32_t*>(values);
+      m_labels.assign(labels, labels + m_num_samples);
+      break;
+    }
+    case csv_column_entry::RESPONSE: {
+      const DataType* responses = reinterpret_cast<const DataType*>(values);
+      m_responses.assign(responses, responses + m_num_samples);
+      break;
+    }
+    default:
+      LBANN_ERROR(cache_path, " has a column of unknown kind ", column.kind);
+    }
+  }
+  madvise(const_cast<void*>(m_column_cache.get()),
+          size,
+          is_shuffled() ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+  // Reset indices.
+  m_shuffled_indices.resize(m_num_samples);
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  resize_shuffled_indices();
+  select_subset_of_data();
+  return true;
+}
+
 void csv_reader::setup_ifstreams()
 {
   if (m_io_thread_pool != nullptr) {
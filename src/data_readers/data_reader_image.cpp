@@ -396,7 +396,9 @@ void image_data_reader::load_list_of_samples(const std::string sample_list_file)
 
   std::vector<char> buffer;
 
-  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE)) {
+  // A binary sample list is memory mapped by every rank instead
+  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE) &&
+      !sample_list_binary::is_binary(sample_list_file)) {
     if (m_comm->am_trainer_master()) {
       load_file(sample_list_file, buffer);
     }
@@ -0,0 +1,239 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+//
+// data_reader_image_shards .hpp .cpp - data reader class for image datasets
+//                                      packed into shard files
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/data_readers/data_reader_image_shards.hpp"
+#include "lbann/data_coordinator/io_trace.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/file_utils.hpp"
+#include "lbann/utils/image.hpp"
+#include "lbann/utils/options.hpp"
+#include "lbann/utils/threads/thread_pool.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <numeric>
+#include <random>
+#include <unistd.h>
+
+namespace lbann {
+
+image_shard_reader::image_shard_reader(bool shuffle)
+  : imagenet_reader(shuffle)
+{}
+
+image_shard_reader::shard_files::~shard_files()
+{
+  for (int fd : fds) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+int image_shard_reader::shard_files::get(int shard)
+{
+  std::lock_guard<std::mutex> lock(mutex);
+  if (fds[shard] < 0) {
+    fds[shard] = open(paths[shard].c_str(), O_RDONLY);
+    if (fds[shard] < 0) {
+      LBANN_ERROR("can't open shard file: ",
+                  paths[shard],
+                  "; ",
+                  std::strerror(errno));
+    }
+  }
+  return fds[shard];
+}
+
+void image_shard_reader::load()
+{
+  auto& arg_parser = global_argument_parser();
+  m_readahead_size =
+    arg_parser.get<size_t>(LBANN_OPTION_SHARD_READAHEAD_SIZE);
+  m_shuffle_buffer_size =
+    std::max(arg_parser.get<int>(LBANN_OPTION_SHARD_SHUFFLE_BUFFER), 1);
+
+  read_shard_index(get_file_dir() + get_data_filename());
+
+  // reset indices
+  m_shuffled_indices.clear();
+  m_shuffled_indices.resize(m_records.size());
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  resize_shuffled_indices();
+
+  select_subset_of_data();
+}
+
+void image_shard_reader::read_shard_index(const std::string& index_file)
+{
+  std::ifstream in(index_file);
+  if (!in) {
+    LBANN_ERROR("can't open shard index: ", index_file);
+  }
+  std::string magic;
+  int version = 0;
+  size_t num_shards = 0;
+  if (!(in >> magic >> version >> num_shards) || magic != "image_shards" ||
+      version != 1) {
+    LBANN_ERROR(index_file, " is not a version 1 image shard index");
+  }
+
+  const std::string shard_dir = file::extract_parent_directory(index_file);
+  m_shard_files = std::make_shared<shard_files>();
+  m_shard_files->fds.assign(num_shards, -1);
+  m_shard_ends.assign(num_shards, 0);
+  m_records.clear();
+  m_labels.clear();
+  for (size_t shard = 0; shard < num_shards; ++shard) {
+    std::string shard_file;
+    size_t num_records = 0;
+    if (!(in >> shard_file >> num_records)) {
+      LBANN_ERROR("shard index ", index_file, " is truncated at shard ", shard);
+    }
+    m_shard_files->paths.push_back(file::join_path(shard_dir, shard_file));
+    for (size_t r = 0; r < num_records; ++r) {
+      shard_record record{static_cast<int>(shard), 0, 0};
+      label_t label = 0;
+      if (!(in >> record.offset >> record.size >> label)) {
+        LBANN_ERROR("shard index ",
+                    index_file,
+                    " is truncated at record ",
+                    r,
+                    " of shard ",
+                    shard_file);
+      }
+      m_shard_ends[shard] =
+        std::max(m_shard_ends[shard], record.offset + record.size);
+      m_records.push_back(record);
+      m_labels.push_back(label);
+    }
+  }
+}
+
+void image_shard_reader::setup(int num_io_threads,
+                               observer_ptr<thread_pool> io_thread_pool)
+{
+  imagenet_reader::setup(num_io_threads, io_thread_pool);
+  m_readahead.assign(io_thread_pool != nullptr
+                       ? io_thread_pool->get_num_threads()
+                       : std::max(num_io_threads, 1),
+                     readahead_block{});
+}
+
+void image_shard_reader::shuffle_index_order(std::vector<int>& indices,
+                                             rng_gen& gen) const
+{
+  // Visit the shards in a random order, each front to back; records
+  // are numbered in the order of their shard
+  std::vector<std::vector<int>> by_shard(m_shard_ends.size());
+  for (int index : indices) {
+    by_shard[m_records[index].shard].push_back(index);
+  }
+  std::vector<size_t> shard_order(by_shard.size());
+  std::iota(shard_order.begin(), shard_order.end(), 0);
+  std::shuffle(shard_order.begin(), shard_order.end(), gen);
+  auto out = indices.begin();
+  for (size_t shard : shard_order) {
+    std::sort(by_shard[shard].begin(), by_shard[shard].end());
+    out = std::copy(by_shard[shard].begin(), by_shard[shard].end(), out);
+  }
+
+  // Shuffle buffer: each position draws one of the next
+  // m_shuffle_buffer_size samples of that stream
+  for (size_t i = 0; i + 1 < indices.size(); ++i) {
+    const size_t window = std::min(m_shuffle_buffer_size, indices.size() - i);
+    std::uniform_int_distribution<size_t> pick(0, window - 1);
+    std::swap(indices[i], indices[i + pick(gen)]);
+  }
+}
+
+uint8_t* image_shard_reader::read_record(const shard_record& record)
+{
+  const size_t tid =
+    m_io_thread_pool != nullptr ? m_io_thread_pool->get_local_thread_id() : 0;
+  if (tid >= m_readahead.size()) {
+    LBANN_ERROR("no readahead block for I/O thread ", tid);
+  }
+  readahead_block& block = m_readahead[tid];
+  if (block.shard != record.shard || record.offset < block.begin ||
+      record.offset + record.size > block.begin + block.data.size()) {
+    const uint64_t length =
+      std::max<uint64_t>(record.size,
+                         std::min<uint64_t>(m_readahead_size,
+                                            m_shard_ends[record.shard] -
+                                              record.offset));
+    const int fd = m_shard_files->get(record.shard);
+    block.shard = -1;
+    block.begin = record.offset;
+    block.data.resize(length);
+    io_trace_scope trace(io_trace_op::read,
+                         m_shard_files->paths[record.shard],
+                         block.begin,
+                         length);
+    for (uint64_t done = 0; done < length;) {
+      const ssize_t n =
+        pread(fd, block.data.data() + done, length - done, block.begin + done);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        LBANN_ERROR("failed to read ",
+                    length,
+                    " bytes at offset ",
+                    block.begin,
+                    " of shard ",
+                    m_shard_files->paths[record.shard],
+                    n < 0 ? std::string("; ") + std::strerror(errno)
+                          : std::string("; unexpected end of file"));
+      }
+      done += n;
+    }
+    block.shard = record.shard;
+  }
+  return block.data.data() + (record.offset - block.begin);
+}
+
+bool image_shard_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx)
+{
+  const shard_record& record = m_records[data_id];
+  uint8_t* encoded = nullptr;
+  {
+    io_stage_scope read_timer(io_stage::read);
+    encoded = read_record(record);
+  }
+  El::Matrix<uint8_t> encoded_image(record.size, 1, encoded, record.size);
+  decode_datum(encoded_image, X, mb_idx);
+
+  return true;
+}
+
+} // namespace lbann
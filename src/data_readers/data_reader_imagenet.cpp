@@ -27,13 +27,27 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_imagenet.hpp"
+#include "lbann/data_coordinator/data_packer.hpp"
 #include "lbann/data_readers/sample_list_impl.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/file_utils.hpp"
 #include "lbann/utils/image.hpp"
+#include "lbann/utils/opencv.hpp"
+
+#include <opencv2/imgproc.hpp>
+
+#include <algorithm>
+#include <cmath>
 
 namespace lbann {
 
-imagenet_reader::imagenet_reader(bool shuffle) : image_data_reader(shuffle)
+imagenet_reader::imagenet_reader(bool shuffle)
+  : image_data_reader(shuffle),
+    m_fused_decode(
+      global_argument_parser().get<bool>(LBANN_OPTION_FUSED_IMAGE_DECODE)),
+    m_image_cache_short_side(
+      global_argument_parser().get<int>(LBANN_OPTION_IMAGE_CACHE_SHORT_SIDE))
 {
   set_defaults();
 }
@@ -57,15 +71,14 @@ CPUMat imagenet_reader::create_datum_view(CPUMat& X, const int mb_idx) const
 
 bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx)
 {
-  El::Matrix<uint8_t> image;
-  std::vector<size_t> dims;
+  El::Matrix<uint8_t> encoded_image;
   const auto file_id = m_sample_list[data_id].first;
   const std::string filename = m_sample_list.get_samples_filename(file_id);
   const std::string image_path = get_file_dir() + filename;
 
+  conduit::Node node;
   if (m_data_store != nullptr) {
     bool have_node = true;
-    conduit::Node node;
     if (m_data_store->is_local_cache()) {
       if (m_data_store->has_conduit_node(data_id)) {
         const conduit::Node& ds_node = m_data_store->get_conduit_node(data_id);
@@ -98,30 +111,154 @@ bool imagenet_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx)
         }
       }
       m_issue_warning = false;
-      load_image(image_path, image, dims);
+      io_stage_scope read_timer(io_stage::read);
+      load_encoded_image(image_path, encoded_image);
       have_node = false;
     }
 
     if (have_node) {
-      char* buf = node[LBANN_DATA_ID_STR(data_id) + "/buffer"].value();
-      size_t size = node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"].value();
-      El::Matrix<uint8_t> encoded_image(size,
-                                        1,
-                                        reinterpret_cast<uint8_t*>(buf),
-                                        size);
-      decode_image(encoded_image, image, dims);
+      const std::string key = LBANN_DATA_ID_STR(data_id);
+      char* buf = node[key + "/buffer"].value();
+      size_t size = node[key + "/buffer_size"].value();
+      if (node.has_path(key + "/dims")) {
+        // The image was decoded when it was cached. Transforms work in
+        // place, so they get a copy.
+        const conduit::uint64* cached_dims =
+          node[key + "/dims"].as_uint64_ptr();
+        std::vector<size_t> dims(cached_dims, cached_dims + 3);
+        auto image = transform::scratch_arena::get().acquire(size);
+        std::copy_n(reinterpret_cast<const uint8_t*>(buf),
+                    size,
+                    image.Buffer());
+        io_stage_scope transform_timer(io_stage::transform);
+        transform_datum(image, dims, 0, X, mb_idx);
+        return true;
+      }
+      encoded_image.Attach(size, 1, reinterpret_cast<uint8_t*>(buf), size);
     }
   }
 
   // this block fires if not using data store
   else {
-    load_image(image_path, image, dims);
+    io_stage_scope read_timer(io_stage::read);
+    load_encoded_image(image_path, encoded_image);
   }
 
+  decode_datum(encoded_image, X, mb_idx);
+
+  return true;
+}
+
+void imagenet_reader::decode_datum(El::Matrix<uint8_t>& encoded_image,
+                                   CPUMat& X,
+                                   int mb_idx)
+{
+  // The image buffer is recycled once the pipeline has used it.
+  El::Matrix<uint8_t> image = transform::scratch_arena::get().acquire(0);
+  std::vector<size_t> dims;
+  size_t begin = 0;
+  {
+    io_stage_scope decode_timer(io_stage::decode);
+    if (m_fused_decode) {
+      begin = m_transform_pipeline.decode(encoded_image, image, dims);
+    }
+    else {
+      decode_image(encoded_image, image, dims);
+    }
+  }
+  io_stage_scope transform_timer(io_stage::transform);
+  transform_datum(image, dims, begin, X, mb_idx);
+}
+
+void imagenet_reader::transform_datum(El::Matrix<uint8_t>& image,
+                                      std::vector<size_t>& dims,
+                                      size_t begin,
+                                      CPUMat& X,
+                                      int mb_idx)
+{
+#ifdef LBANN_HAS_GPU
+  if (m_raw_samples != nullptr) {
+    // The GPU does the layout conversion and the transforms after it
+    m_transform_pipeline.apply_raw_image_head(image, dims, begin);
+    const El::Int size = image.Height() * image.Width();
+    if (!image.Contiguous() || size != m_raw_samples->Height()) {
+      LBANN_ERROR("transformed image has ",
+                  size,
+                  " values but samples have ",
+                  m_raw_samples->Height());
+    }
+    std::copy_n(image.LockedBuffer(),
+                size,
+                m_raw_samples->Buffer() + mb_idx * m_raw_samples->LDim());
+    transform::scratch_arena::get().release(std::move(image));
+    return;
+  }
+#endif // LBANN_HAS_GPU
   auto X_v = create_datum_view(X, mb_idx);
-  m_transform_pipeline.apply(image, X_v, dims);
+  m_transform_pipeline.apply(image, X_v, dims, begin);
+}
 
+void imagenet_reader::load_conduit_node_from_file(int data_id,
+                                                  conduit::Node& node)
+{
+  image_data_reader::load_conduit_node_from_file(data_id, node);
+  if (m_image_cache_short_side <= 0) {
+    return;
+  }
+  const std::string key = LBANN_DATA_ID_STR(data_id);
+  char* buf = node[key + "/buffer"].value();
+  size_t size = node[key + "/buffer_size"].value();
+  El::Matrix<uint8_t> encoded(size, 1, reinterpret_cast<uint8_t*>(buf), size);
+  El::Matrix<uint8_t> image;
+  std::vector<size_t> dims;
+  decode_image(encoded, image, dims);
+
+  // Only shrink; the random crops still see at least the cached size.
+  const size_t short_side = static_cast<size_t>(m_image_cache_short_side);
+  const size_t height = dims[1], width = dims[2];
+  if (std::min(height, width) > short_side) {
+    const double ratio =
+      static_cast<double>(short_side) / std::min(height, width);
+    std::vector<size_t> new_dims = {
+      dims[0],
+      std::max<size_t>(1, std::lround(height * ratio)),
+      std::max<size_t>(1, std::lround(width * ratio))};
+    El::Matrix<uint8_t> resized(get_linear_size(new_dims), 1);
+    cv::Mat src = utils::get_opencv_mat(image, dims);
+    cv::Mat dst = utils::get_opencv_mat(resized, new_dims);
+    cv::resize(src, dst, dst.size(), 0, 0, cv::INTER_AREA);
+    image = std::move(resized);
+    dims = new_dims;
+  }
+
+  const char* pixels = reinterpret_cast<const char*>(image.LockedBuffer());
+  const size_t num_pixels = get_linear_size(dims);
+  node[key + "/buffer"].set(std::vector<char>(pixels, pixels + num_pixels));
+  node[key + "/buffer_size"] = num_pixels;
+  node[key + "/dims"].set(
+    std::vector<conduit::uint64>(dims.begin(), dims.end()));
+}
+
+#ifdef LBANN_HAS_GPU
+bool imagenet_reader::get_raw_image_conversion(
+  data_packer::raw_image_conversion& conv) const
+{
+  if (m_image_num_channels > conv.max_channels) {
+    return false;
+  }
+  std::vector<DataType> scales, shifts;
+  if (!m_transform_pipeline.get_raw_image_tail(m_image_num_channels,
+                                               scales,
+                                               shifts)) {
+    return false;
+  }
+  conv.channels = m_image_num_channels;
+  conv.height = m_image_height;
+  conv.width = m_image_width;
+  std::copy(scales.begin(), scales.end(), conv.scales);
+  std::copy(shifts.begin(), shifts.end(), conv.shifts);
   return true;
 }
+#endif // LBANN_HAS_GPU
 
 } // namespace lbann
@@ -194,6 +194,9 @@ data_reader_jag_conduit::operator=(const data_reader_jag_conduit& rhs)
 
   generic_data_reader::operator=(rhs);
 
+  // The background read and open bundles belong to this instance
+  release_open_bundles();
+  m_mini_batch_samples.clear();
   copy_members(rhs);
 
   return (*this);
@@ -201,6 +204,7 @@ data_reader_jag_conduit::operator=(const data_reader_jag_conduit& rhs)
 
 data_reader_jag_conduit::~data_reader_jag_conduit()
 {
+  release_open_bundles();
   // if (m_data_store != nullptr) {
   //   delete m_data_store;
   // }
@@ -913,18 +917,9 @@ void data_reader_jag_conduit::do_preload_data_store()
     LBANN_WARNING("starting preload for role: ", get_role());
   }
 
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
-    }
+  auto load_one = [this, &key](const file_handle_t& h, int index) {
     try {
-      const sample_t& s = m_sample_list[index];
-      const std::string& sample_name = s.second;
-      sample_file_id_t id = s.first;
-      m_sample_list.open_samples_file_handle(index);
-      auto h = m_sample_list.get_samples_file_handle(id);
+      const std::string& sample_name = m_sample_list[index].second;
       conduit::Node& node = m_data_store->get_empty_node(index);
 
       preload_helper(h, sample_name, m_output_scalar_prefix, index, node);
@@ -939,16 +934,41 @@ void data_reader_jag_conduit::do_preload_data_store()
       LBANN_ERROR(" :: trying to load the node " + std::to_string(index) +
                   " with key " + key + " and got " + e.what());
     }
-  }
-  /// Once all of the data has been preloaded, close all of the file handles
-  for (size_t idx = 0; idx < m_shuffled_indices.size(); idx++) {
-    int index = m_shuffled_indices[idx];
-    if (m_data_store->get_index_owner(index) !=
-        get_comm()->get_rank_in_trainer()) {
-      continue;
-    }
-    m_sample_list.close_samples_file_handle(index, true);
-  }
+  };
+
+  // Samples are grouped by file, so each file is opened once
+  auto group_of = [this](int index) {
+    return static_cast<size_t>(m_sample_list[index].first);
+  };
+#if defined(_USE_IO_HANDLE_) || !defined(H5_HAVE_THREADSAFE)
+  // Files go through the sample list's (not thread safe) handle
+  // bookkeeping, so groups are loaded one after another
+  preload_data_store_in_parallel(
+    group_of,
+    [this, &load_one](const std::vector<int>& indices) {
+      m_sample_list.open_samples_file_handle(indices.front());
+      auto h = m_sample_list.get_samples_file_handle(
+        m_sample_list[indices.front()].first);
+      for (int index : indices) {
+        load_one(h, index);
+      }
+      m_sample_list.close_samples_file_handle(indices.front(), true);
+    },
+    false);
+#else
+  // Each loading thread opens its own handle to the files it loads
+  preload_data_store_in_parallel(
+    group_of,
+    [this, &load_one](const std::vector<int>& indices) {
+      const std::string path = m_sample_list.get_samples_file_path(
+        m_sample_list[indices.front()].first);
+      hid_t h = conduit::relay::io::hdf5_open_file_for_read(path);
+      for (int index : indices) {
+        load_one(h, index);
+      }
+      conduit::relay::io::hdf5_close_file(h);
+    });
+#endif // _USE_IO_HANDLE_ || !H5_HAVE_THREADSAFE
 
   if (get_comm()->am_world_master() ||
       (arg_parser.get<bool>(LBANN_OPTION_LTFB_VERBOSE) &&
@@ -1015,20 +1035,25 @@ void data_reader_jag_conduit::load_list_of_samples(
 
   std::vector<char> buffer;
 
-  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE)) {
+  // Load the sample list, or its binary copy if one is cached
+  const auto [cache_file, cached] = find_sample_list_cache(sample_list_file);
+  const std::string& list_file = cached ? cache_file : sample_list_file;
+  // A binary sample list is memory mapped by every rank instead
+  if (arg_parser.get<bool>(LBANN_OPTION_LOAD_FULL_SAMPLE_LIST_ONCE) &&
+      !sample_list_binary::is_binary(list_file)) {
     if (m_comm->am_trainer_master()) {
-      load_file(sample_list_file, buffer);
+      load_file(list_file, buffer);
     }
     m_comm->trainer_broadcast(m_comm->get_trainer_master(), buffer);
 
     vectorwrapbuf<char> strmbuf(buffer);
     std::istream iss(&strmbuf);
 
-    m_sample_list.set_sample_list_name(sample_list_file);
+    m_sample_list.set_sample_list_name(list_file);
     m_sample_list.load(iss, *(this->m_comm), true);
   }
   else {
-    m_sample_list.load(sample_list_file, *(this->m_comm), true);
+    m_sample_list.load(list_file, *(this->m_comm), true);
   }
 
   double tm2 = get_time();
@@ -1059,6 +1084,26 @@ void data_reader_jag_conduit::load_list_of_samples(
     std::cout << "Time to gather sample list '" << sample_list_file
               << "': " << tm4 - tm3 << std::endl;
   }
+
+  if (!cache_file.empty() && !cached && get_comm()->am_world_master()) {
+    try {
+      m_sample_list.write_binary(cache_file);
+    }
+    catch (lbann_exception const& e) {
+      LBANN_WARNING("could not cache sample list ",
+                    sample_list_file,
+                    ": ",
+                    e.what());
+    }
+  }
+
+  const std::string stage_dir = arg_parser.get<std::string>(
+    LBANN_OPTION_STAGE_DIR);
+  if (!stage_dir.empty()) {
+    m_sample_list.stage_files(stage_dir,
+                              m_comm->get_procs_per_trainer(),
+                              m_comm->get_rank_in_trainer());
+  }
 }
 
 void data_reader_jag_conduit::load_list_of_samples_from_archive(
@@ -1625,6 +1670,147 @@ bool data_reader_jag_conduit::fetch(
   return true;
 }
 
+void data_reader_jag_conduit::release_open_bundles()
+{
+  if (m_readahead.valid()) {
+    m_readahead.wait();
+    m_readahead = std::future<mini_batch_samples_t>();
+  }
+  for (const auto& bundle : m_open_bundles) {
+    conduit::relay::io::hdf5_close_file(bundle.second);
+  }
+  m_open_bundles.clear();
+}
+
+#ifndef _USE_IO_HANDLE_
+hid_t data_reader_jag_conduit::get_open_bundle(sample_file_id_t id)
+{
+  for (auto it = m_open_bundles.begin(); it != m_open_bundles.end(); ++it) {
+    if (it->first == id) {
+      m_open_bundles.splice(m_open_bundles.begin(), m_open_bundles, it);
+      return it->second;
+    }
+  }
+  const std::string path = m_sample_list.get_samples_file_path(id);
+  const hid_t h = conduit::relay::io::hdf5_open_file_for_read(path);
+  m_open_bundles.emplace_front(id, h);
+
+  auto& arg_parser = global_argument_parser();
+  const size_t max_open = std::max(
+    arg_parser.get<size_t>(LBANN_OPTION_JAG_OPEN_BUNDLES),
+    static_cast<size_t>(1));
+  while (m_open_bundles.size() > max_open) {
+    conduit::relay::io::hdf5_close_file(m_open_bundles.back().second);
+    m_open_bundles.pop_back();
+  }
+  return h;
+}
+
+void data_reader_jag_conduit::load_mini_batch_samples(
+  std::vector<int> indices,
+  mini_batch_samples_t& samples)
+{
+  // Visit the bundles one after another, and the samples of a bundle in
+  // the order they are stored
+  std::sort(indices.begin(), indices.end(), [this](int a, int b) {
+    return std::make_pair(m_sample_list[a].first, a) <
+           std::make_pair(m_sample_list[b].first, b);
+  });
+
+  for (size_t begin = 0; begin < indices.size();) {
+    const sample_file_id_t id = m_sample_list[indices[begin]].first;
+    size_t end = begin + 1;
+    while (end < indices.size() && m_sample_list[indices[end]].first == id) {
+      ++end;
+    }
+
+    hid_t h;
+    try {
+      h = get_open_bundle(id);
+    }
+    catch (conduit::Error const&) {
+      // Leave the bundle to the per-sample path and its error handling
+      begin = end;
+      continue;
+    }
+    for (size_t i = begin; i < end; ++i) {
+      const int index = indices[i];
+      const std::string& sample_name = m_sample_list[index].second;
+      if (!has_path(h, sample_name)) {
+        continue;
+      }
+      try {
+        conduit::Node& node = samples[index];
+        preload_helper(h, sample_name, m_output_scalar_prefix, index, node);
+        preload_helper(h, sample_name, m_input_prefix, index, node);
+        for (const auto& t : m_emi_image_keys) {
+          const std::string field_name = m_output_image_prefix + t;
+          preload_helper(h, sample_name, field_name, index, node);
+        }
+      }
+      catch (conduit::Error const& e) {
+        LBANN_ERROR("trying to load the node ",
+                    index,
+                    " from ",
+                    m_sample_list.get_samples_filename(id),
+                    " and caught conduit exception: ",
+                    e.what());
+      }
+    }
+    begin = end;
+  }
+}
+
+#endif // _USE_IO_HANDLE_
+
+void data_reader_jag_conduit::prepare_samples(
+  const std::vector<int>& indices,
+  const std::vector<int>& next_indices)
+{
+  m_sample_list.advance_file_usage_step();
+  m_mini_batch_samples.clear();
+  if (data_store_active()) {
+    return;
+  }
+#ifdef _USE_IO_HANDLE_
+  // Samples are fetched through the sample list's handles
+  m_sample_list.open_samples_file_handles(indices);
+  m_sample_list.open_samples_file_handles(next_indices);
+#else
+  // Take what the background read has loaded; if the order changed
+  // since it started, the samples it did not cover are read here
+  mini_batch_samples_t ahead;
+  if (m_readahead.valid()) {
+    ahead = m_readahead.get();
+  }
+  std::vector<int> missing;
+  for (const int index : indices) {
+    auto it = ahead.find(index);
+    if (it != ahead.end()) {
+      m_mini_batch_samples[index] = std::move(it->second);
+    }
+    else {
+      missing.push_back(index);
+    }
+  }
+  if (!missing.empty()) {
+    load_mini_batch_samples(std::move(missing), m_mini_batch_samples);
+  }
+
+#ifdef H5_HAVE_THREADSAFE
+  // Read the next mini-batch of this pass while the I/O threads and the
+  // model work on this one
+  if (!next_indices.empty()) {
+    m_readahead = std::async(std::launch::async, [this, next_indices]() {
+      mini_batch_samples_t samples;
+      load_mini_batch_samples(next_indices, samples);
+      return samples;
+    });
+  }
+#endif // H5_HAVE_THREADSAFE
+#endif // _USE_IO_HANDLE_
+}
+
 bool data_reader_jag_conduit::fetch_datum(CPUMat& X, int data_id, int mb_idx)
 {
   int tid = m_io_thread_pool->get_local_thread_id();
@@ -1633,10 +1819,15 @@ bool data_reader_jag_conduit::fetch_datum(CPUMat& X, int data_id, int mb_idx)
   bool ok = true;
   // Create a node to hold all of the data
   conduit::Node node;
+  const auto loaded = m_mini_batch_samples.find(data_id);
+  const bool preread = (loaded != m_mini_batch_samples.end());
   if (data_store_active()) {
     const conduit::Node& ds_node = m_data_store->get_conduit_node(data_id);
     node.set_external(ds_node);
   }
+  else if (preread) {
+    node.set_external(loaded->second);
+  }
   else {
     m_sample_list.open_samples_file_handle(data_id);
   }
@@ -1652,7 +1843,9 @@ bool data_reader_jag_conduit::fetch_datum(CPUMat& X, int data_id, int mb_idx)
     m_data_store->set_conduit_node(data_id, node);
   }
 
-  m_sample_list.close_samples_file_handle(data_id, true);
+  if (!preread) {
+    m_sample_list.close_samples_file_handle(data_id, true);
+  }
   m_using_random_node.erase(m_io_thread_pool->get_local_thread_id());
   return ok;
 }
@@ -1667,10 +1860,14 @@ bool data_reader_jag_conduit::fetch_response(CPUMat& X, int data_id, int mb_idx)
   bool ok = true;
   // Create a node to hold all of the data
   conduit::Node node;
+  const auto loaded = m_mini_batch_samples.find(data_id);
   if (m_data_store != nullptr && c.get_epoch() > 0) {
     const conduit::Node& ds_node = m_data_store->get_conduit_node(data_id);
     node.set_external(ds_node);
   }
+  else if (loaded != m_mini_batch_samples.end()) {
+    node.set_external(loaded->second);
+  }
   for (size_t i = 0u; ok && (i < X_v.size()); ++i) {
     ok = fetch(X_v[i], data_id, node, 0, tid, m_dependent[i], "response");
   }
@@ -111,6 +111,19 @@ void data_reader_merge_features::setup(int num_io_threads,
   }
 }
 
+void data_reader_merge_features::prepare_samples(
+  const std::vector<int>& indices,
+  const std::vector<int>& next_indices)
+{
+  // The subsidiary readers share our sample indices
+  for (auto&& reader : m_data_readers) {
+    reader->prepare_samples(indices, next_indices);
+  }
+  if (m_label_reader != nullptr) {
+    m_label_reader->prepare_samples(indices, next_indices);
+  }
+}
+
 bool data_reader_merge_features::fetch_datum(CPUMat& X, int data_id, int mb_idx)
 {
   int start = 0;
@@ -29,6 +29,8 @@
 #include "lbann/data_readers/data_reader_merge_samples.hpp"
 #include "lbann/utils/options.hpp"
 
+#include <algorithm>
+
 namespace lbann {
 
 data_reader_merge_samples::data_reader_merge_samples(
@@ -125,45 +127,68 @@ void data_reader_merge_samples::load()
   setup_indices(global_num_samples);
 }
 
-bool data_reader_merge_samples::fetch_datum(CPUMat& X, int data_id, int mb_idx)
+void data_reader_merge_samples::setup(int num_io_threads,
+                                      observer_ptr<thread_pool> io_thread_pool)
 {
-  // Find the right data reader to delegate to.
-  for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_datum(X, data_id, mb_idx);
-    }
+  generic_compound_data_reader::setup(num_io_threads, io_thread_pool);
+  for (auto&& reader : m_data_readers) {
+    reader->setup(num_io_threads, io_thread_pool);
   }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
 }
 
-bool data_reader_merge_samples::fetch_label(CPUMat& Y, int data_id, int mb_idx)
+size_t data_reader_merge_samples::find_reader(int& data_id) const
 {
-  // Find the right data reader to delegate to.
+  // m_num_samples_psum starts with 0, so the reader holding data_id is
+  // the one before the first partial sum above it
+  const auto it = std::upper_bound(m_num_samples_psum.begin(),
+                                   m_num_samples_psum.end(),
+                                   data_id);
+  if (data_id < 0 || it == m_num_samples_psum.end()) {
+    throw lbann_exception("data_reader_merge_samples: do not have data ID " +
+                          std::to_string(data_id));
+  }
+  const size_t i = std::distance(m_num_samples_psum.begin(), it) - 1;
+  data_id -= m_num_samples_psum[i];
+  return i;
+}
+
+void data_reader_merge_samples::prepare_samples(
+  const std::vector<int>& indices,
+  const std::vector<int>& next_indices)
+{
+  std::vector<std::vector<int>> local(m_data_readers.size());
+  std::vector<std::vector<int>> local_next(m_data_readers.size());
+  for (int data_id : indices) {
+    const size_t i = find_reader(data_id);
+    local[i].push_back(data_id);
+  }
+  for (int data_id : next_indices) {
+    const size_t i = find_reader(data_id);
+    local_next[i].push_back(data_id);
+  }
   for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_label(Y, data_id, mb_idx);
-    }
+    m_data_readers[i]->prepare_samples(local[i], local_next[i]);
   }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
+}
+
+bool data_reader_merge_samples::fetch_datum(CPUMat& X, int data_id, int mb_idx)
+{
+  const size_t i = find_reader(data_id);
+  return m_data_readers[i]->fetch_datum(X, data_id, mb_idx);
+}
+
+bool data_reader_merge_samples::fetch_label(CPUMat& Y, int data_id, int mb_idx)
+{
+  const size_t i = find_reader(data_id);
+  return m_data_readers[i]->fetch_label(Y, data_id, mb_idx);
 }
 
 bool data_reader_merge_samples::fetch_response(CPUMat& Y,
                                                int data_id,
                                                int mb_idx)
 {
-  // Find the right data reader to delegate to.
-  for (size_t i = 0; i < m_data_readers.size(); ++i) {
-    if (data_id < m_num_samples_psum[i + 1]) {
-      data_id -= m_num_samples_psum[i];
-      return m_data_readers[i]->fetch_response(Y, data_id, mb_idx);
-    }
-  }
-  throw lbann_exception("data_reader_merge_samples: do not have data ID " +
-                        std::to_string(data_id));
+  const size_t i = find_reader(data_id);
+  return m_data_readers[i]->fetch_response(Y, data_id, mb_idx);
 }
 
 } // namespace lbann
@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_mesh.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/utils/glob.hpp"
 #include "lbann/utils/threads/thread_pool.hpp"
 
@@ -43,12 +44,17 @@ void mesh_reader::load()
     throw lbann_exception("mesh_reader: data shape must be non-zero");
   }
   // Compute total number of samples based on number of targets.
-  std::vector<std::string> matches =
-    glob(get_file_dir() + m_target_name + m_suffix + "/*.bin");
-  if (matches.size() == 0) {
+  // Only the trainer master lists the directory.
+  int num_matches = 0;
+  if (m_comm->am_trainer_master()) {
+    num_matches = static_cast<int>(
+      glob(get_file_dir() + m_target_name + m_suffix + "/*.bin").size());
+  }
+  m_comm->trainer_broadcast(m_comm->get_trainer_master(), num_matches);
+  if (num_matches == 0) {
     throw lbann_exception("mesh_reader: could not find any targets");
   }
-  m_num_samples = matches.size();
+  m_num_samples = num_matches;
   // Set up the format string.
   if (std::pow(10, m_index_length) <= m_num_samples) {
     throw lbann_exception("mesh_reader: index length too small");
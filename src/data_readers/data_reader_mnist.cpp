@@ -63,7 +63,10 @@ bool mnist_reader::fetch_datum(CPUMat& X, int data_id, int mb_idx)
   std::vector<size_t> dims = {1ull,
                               static_cast<size_t>(m_image_height),
                               static_cast<size_t>(m_image_width)};
-  m_transform_pipeline.apply(pixel_col, dims);
+  {
+    io_stage_scope transform_timer(io_stage::transform);
+    m_transform_pipeline.apply(pixel_col, dims);
+  }
   return true;
 }
 
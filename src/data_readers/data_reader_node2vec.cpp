@@ -32,9 +32,13 @@
 #include <dist/node2vec_rw/node2vec_rw.hpp>
 #include <havoqgt/delegate_partitioned_graph.hpp>
 #include <havoqgt/distributed_db.hpp>
+#ifdef LBANN_HAS_GPU
+#include "lbann/data_readers/node2vec_gpu_walker.hpp"
+#endif // LBANN_HAS_GPU
 
 #include <algorithm>
 #include <numeric>
+#include <tuple>
 
 namespace lbann {
 
@@ -75,6 +79,93 @@ using node2vec_reader_impl::EdgeWeightData;
 using node2vec_reader_impl::RandomWalker;
 using Graph = RandomWalker::graph_type;
 using Vertex = RandomWalker::vertex_type;
+
+#ifdef LBANN_HAS_GPU
+/** Gather the edges of every rank into a graph indexed by vertex
+ *  label (labels are assumed to be 0, ..., num_vertices-1) and copy
+ *  it to the GPU */
+std::unique_ptr<node2vec_gpu_walker>
+make_gpu_walker(const lbann_comm& comm,
+                const Graph& graph,
+                const EdgeWeightData::BaseType& edge_weights,
+                const std::vector<size_t>& local_vertex_global_indices,
+                size_t walk_length,
+                double return_param,
+                double inout_param,
+                size_t num_negative_samples)
+{
+  // Local edges; the edges of a delegate vertex are split across ranks
+  std::vector<El::Int> sources, targets;
+  std::vector<float> weights;
+  auto add_edges = [&](const Vertex& vertex) {
+    const El::Int source = graph.locator_to_label(vertex);
+    for (auto e = graph.edges_begin(vertex); e != graph.edges_end(vertex);
+         ++e) {
+      sources.push_back(source);
+      targets.push_back(graph.locator_to_label(e.target()));
+      weights.push_back(edge_weights[e]);
+    }
+  };
+  for (auto it = graph.vertices_begin(); it != graph.vertices_end(); ++it) {
+    add_edges(*it);
+  }
+  for (auto it = graph.delegate_vertices_begin();
+       it != graph.delegate_vertices_end();
+       ++it) {
+    add_edges(*it);
+  }
+
+  // Every rank holds the whole graph
+  std::vector<int> counts(comm.get_procs_per_trainer());
+  std::vector<int> displs(counts.size(), 0);
+  comm.trainer_all_gather(static_cast<int>(sources.size()), counts);
+  std::partial_sum(counts.begin(), counts.end() - 1, displs.begin() + 1);
+  const size_t num_edges = displs.back() + counts.back();
+  std::vector<El::Int> all_sources(num_edges), all_targets(num_edges);
+  std::vector<float> all_weights(num_edges);
+  comm.trainer_all_gather(sources, all_sources, counts, displs);
+  comm.trainer_all_gather(targets, all_targets, counts, displs);
+  comm.trainer_all_gather(weights, all_weights, counts, displs);
+
+  El::Int max_label = 0;
+  for (size_t e = 0; e < num_edges; ++e) {
+    max_label = std::max({max_label, all_sources[e], all_targets[e]});
+  }
+  for (const auto& v : local_vertex_global_indices) {
+    max_label = std::max(max_label, static_cast<El::Int>(v));
+  }
+  const size_t num_vertices = max_label + 1;
+
+  // Compressed sparse rows with sorted neighbors
+  std::vector<El::Int> order(num_edges);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](El::Int a, El::Int b) {
+    return std::tie(all_sources[a], all_targets[a]) <
+           std::tie(all_sources[b], all_targets[b]);
+  });
+  std::vector<El::Int> offsets(num_vertices + 1, 0);
+  std::vector<El::Int> csr_targets(num_edges);
+  std::vector<float> csr_weights(num_edges);
+  for (size_t e = 0; e < num_edges; ++e) {
+    ++offsets[all_sources[e] + 1];
+    csr_targets[e] = all_targets[order[e]];
+    csr_weights[e] = all_weights[order[e]];
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+  std::vector<El::Int> local_vertices(local_vertex_global_indices.begin(),
+                                      local_vertex_global_indices.end());
+  return std::make_unique<node2vec_gpu_walker>(offsets,
+                                               csr_targets,
+                                               csr_weights,
+                                               local_vertices,
+                                               walk_length,
+                                               return_param,
+                                               inout_param,
+                                               num_negative_samples);
+}
+#endif // LBANN_HAS_GPU
+
 } // namespace
 
 node2vec_reader::node2vec_reader(std::string graph_file,
@@ -82,19 +173,30 @@ node2vec_reader::node2vec_reader(std::string graph_file,
                                  size_t walk_length,
                                  double return_param,
                                  double inout_param,
-                                 size_t num_negative_samples)
+                                 size_t num_negative_samples,
+                                 bool gpu_walks)
   : generic_data_reader(true),
     m_graph_file(std::move(graph_file)),
     m_epoch_size{epoch_size},
     m_walk_length{walk_length},
     m_return_param{return_param},
     m_inout_param{inout_param},
-    m_num_negative_samples{num_negative_samples}
-{}
+    m_num_negative_samples{num_negative_samples},
+    m_gpu_walks{gpu_walks}
+{
+#ifndef LBANN_HAS_GPU
+  if (m_gpu_walks) {
+    LBANN_ERROR("node2vec GPU walks require LBANN to be built with GPUs");
+  }
+#endif // LBANN_HAS_GPU
+}
 
 node2vec_reader::~node2vec_reader()
 {
   // Deallocate objects in right order
+#ifdef LBANN_HAS_GPU
+  m_gpu_walker.reset();
+#endif // LBANN_HAS_GPU
   m_random_walker.reset();
   m_edge_weight_data.reset();
   m_distributed_database.reset();
@@ -187,6 +289,31 @@ bool node2vec_reader::fetch_data_block(CPUMat& X,
   return true;
 }
 
+#ifdef LBANN_HAS_GPU
+bool node2vec_reader::fetch_data_block_to_device(
+  El::Matrix<DataType, El::Device::GPU>& X,
+  El::Int mb_size,
+  El::Matrix<El::Int>& indices_fetched)
+{
+  const auto io_rng = set_io_generators_local_index(0);
+  auto& gen = get_io_generator();
+  const uint64_t seed = (static_cast<uint64_t>(gen()) << 32) | gen();
+  m_gpu_walker->generate(X, mb_size, seed);
+
+  // Visits are counted on the GPU. Estimate the local ones, assuming
+  // walks spread evenly, so the counts are only copied back when the
+  // noise distribution is due to be recomputed.
+  m_total_visit_count += mb_size * m_walk_length *
+                         m_local_vertex_global_indices.size() /
+                         m_gpu_walker->get_num_vertices();
+  if (m_total_visit_count > 2 * m_noise_visit_count) {
+    m_gpu_walker->accumulate_visit_counts(m_local_vertex_visit_counts);
+    update_noise_distribution();
+  }
+  return true;
+}
+#endif // LBANN_HAS_GPU
+
 bool node2vec_reader::fetch_label(CPUMat& Y, int data_id, int col)
 {
   return true;
@@ -256,6 +383,19 @@ void node2vec_reader::load()
     m_local_vertex_visit_counts.push_back(degree + 1);
   }
 
+#ifdef LBANN_HAS_GPU
+  if (m_gpu_walks) {
+    m_gpu_walker = make_gpu_walker(comm,
+                                   graph,
+                                   *edge_weight_data,
+                                   m_local_vertex_global_indices,
+                                   m_walk_length,
+                                   m_return_param,
+                                   m_inout_param,
+                                   m_num_negative_samples);
+  }
+#endif // LBANN_HAS_GPU
+
   // Compute noise distribution for negative sampling
   update_noise_distribution();
 
@@ -351,6 +491,11 @@ void node2vec_reader::update_noise_distribution()
                  m_local_vertex_noise_distribution.end(),
                  m_local_vertex_noise_distribution.begin(),
                  [&scale](const double& x) -> double { return scale * x; });
+#ifdef LBANN_HAS_GPU
+  if (m_gpu_walker != nullptr) {
+    m_gpu_walker->set_noise_distribution(m_local_vertex_noise_distribution);
+  }
+#endif // LBANN_HAS_GPU
 }
 
 } // namespace lbann
@@ -27,9 +27,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_numpy.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 #include <cnpy.h>
 #include <cstdio>
 #include <string>
+#include <sys/mman.h>
 #include <unordered_set>
 
 namespace lbann {
@@ -43,7 +46,8 @@ numpy_reader::numpy_reader(const numpy_reader& other)
     m_num_samples(other.m_num_samples),
     m_num_features(other.m_num_features),
     m_num_labels(other.m_num_labels),
-    m_data(other.m_data)
+    m_data(other.m_data),
+    m_mapped_data(other.m_mapped_data)
 {}
 
 numpy_reader& numpy_reader::operator=(const numpy_reader& other)
@@ -53,6 +57,7 @@ numpy_reader& numpy_reader::operator=(const numpy_reader& other)
   m_num_features = other.m_num_features;
   m_num_labels = other.m_num_labels;
   m_data = other.m_data;
+  m_mapped_data = other.m_mapped_data;
   return *this;
 }
 
@@ -68,7 +73,17 @@ void numpy_reader::load()
   }
   ifs.close();
 
-  m_data = cnpy::npy_load(infile);
+  if (global_argument_parser().get<bool>(LBANN_OPTION_MMAP_NUMPY)) {
+    m_mapped_data = cnpy_utils::mmap_npy(infile);
+    m_data = m_mapped_data.header;
+    m_mapped_data.advise(0,
+                         m_data.num_vals,
+                         m_shuffle ? MADV_RANDOM : MADV_SEQUENTIAL);
+  }
+  else {
+    m_mapped_data = cnpy_utils::mapped_array();
+    m_data = cnpy::npy_load(infile);
+  }
   m_num_samples = m_data.shape[0];
   m_num_features = std::accumulate(m_data.shape.begin() + 1,
                                    m_data.shape.end(),
@@ -98,11 +113,11 @@ void numpy_reader::load()
     std::unordered_set<int> label_classes;
     for (int i = 0; i < m_num_samples; ++i) {
       if (m_data.word_size == 4) {
-        float* data = m_data.data<float>() + i * (m_num_features + 1);
+        const float* data = data_ptr<float>() + i * (m_num_features + 1);
         label_classes.insert((int)data[m_num_features + 1]);
       }
       else if (m_data.word_size == 8) {
-        double* data = m_data.data<double>() + i * (m_num_features + 1);
+        const double* data = data_ptr<double>() + i * (m_num_features + 1);
         label_classes.insert((int)data[m_num_features + 1]);
       }
     }
@@ -130,6 +145,20 @@ void numpy_reader::load()
   select_subset_of_data();
 }
 
+void numpy_reader::prepare_samples(const std::vector<int>& indices,
+                                   const std::vector<int>& next_indices)
+{
+  if (!m_mapped_data.is_mapped()) {
+    return;
+  }
+  const size_t row_size = m_data.num_vals / m_num_samples;
+  for (const auto* batch : {&indices, &next_indices}) {
+    for (const int index : *batch) {
+      m_mapped_data.advise(index * row_size, row_size, MADV_WILLNEED);
+    }
+  }
+}
+
 bool numpy_reader::fetch_datum(Mat& X, int data_id, int mb_idx)
 {
   int features_size = m_num_features;
@@ -138,13 +167,13 @@ bool numpy_reader::fetch_datum(Mat& X, int data_id, int mb_idx)
     features_size += 1;
   }
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * features_size;
+    const float* data = data_ptr<float>() + data_id * features_size;
     for (int j = 0; j < m_num_features; ++j) {
       X(j, mb_idx) = data[j];
     }
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * features_size;
+    const double* data = data_ptr<double>() + data_id * features_size;
     for (int j = 0; j < m_num_features; ++j) {
       X(j, mb_idx) = data[j];
     }
@@ -159,11 +188,11 @@ bool numpy_reader::fetch_label(Mat& Y, int data_id, int mb_idx)
   }
   int label = 0;
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * (m_num_features + 1);
+    const float* data = data_ptr<float>() + data_id * (m_num_features + 1);
     label = (int)data[m_num_features + 1];
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * (m_num_features + 1);
+    const double* data = data_ptr<double>() + data_id * (m_num_features + 1);
     label = (int)data[m_num_features + 1];
   }
   Y(label, mb_idx) = 1;
@@ -177,11 +206,11 @@ bool numpy_reader::fetch_response(Mat& Y, int data_id, int mb_idx)
   }
   auto response = DataType(0);
   if (m_data.word_size == 4) {
-    float* data = m_data.data<float>() + data_id * (m_num_features + 1);
+    const float* data = data_ptr<float>() + data_id * (m_num_features + 1);
     response = (DataType)data[m_num_features + 1];
   }
   else if (m_data.word_size == 8) {
-    double* data = m_data.data<double>() + data_id * (m_num_features + 1);
+    const double* data = data_ptr<double>() + data_id * (m_num_features + 1);
     response = (DataType)data[m_num_features + 1];
   }
   Y(0, mb_idx) = response;
@@ -28,9 +28,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/data_readers/data_reader_numpy_npz.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 #include <cnpy.h>
 #include <cstdio>
 #include <string>
+#include <sys/mman.h>
 #include <unordered_set>
 
 namespace lbann {
@@ -54,6 +57,9 @@ numpy_npz_reader::numpy_npz_reader(const numpy_npz_reader& other)
     m_data(other.m_data),
     m_labels(other.m_labels),
     m_responses(other.m_responses),
+    m_mapped_data(other.m_mapped_data),
+    m_mapped_labels(other.m_mapped_labels),
+    m_mapped_responses(other.m_mapped_responses),
     m_scaling_factor_int16(other.m_scaling_factor_int16)
 {}
 
@@ -67,6 +73,9 @@ numpy_npz_reader& numpy_npz_reader::operator=(const numpy_npz_reader& other)
   m_data = other.m_data;
   m_labels = other.m_labels;
   m_responses = other.m_responses;
+  m_mapped_data = other.m_mapped_data;
+  m_mapped_labels = other.m_mapped_labels;
+  m_mapped_responses = other.m_mapped_responses;
   m_scaling_factor_int16 = other.m_scaling_factor_int16;
   return *this;
 }
@@ -83,21 +92,38 @@ void numpy_npz_reader::load()
   }
   ifs.close();
 
-  const cnpy::npz_t npz = cnpy::npz_load(infile);
+  const bool mmap_npz =
+    global_argument_parser().get<bool>(LBANN_OPTION_MMAP_NUMPY);
+  cnpy::npz_t npz;
+  std::map<std::string, cnpy_utils::mapped_array> mapped_npz;
+  if (mmap_npz) {
+    mapped_npz = cnpy_utils::mmap_npz(infile);
+  }
+  else {
+    npz = cnpy::npz_load(infile);
+  }
 
-  std::vector<std::tuple<const bool, const std::string, cnpy::NpyArray&>>
+  std::vector<std::tuple<const bool,
+                         const std::string,
+                         cnpy::NpyArray&,
+                         cnpy_utils::mapped_array&>>
     npyLoadList;
-  npyLoadList.push_back(std::forward_as_tuple(true, NPZ_KEY_DATA, m_data));
+  npyLoadList.push_back(
+    std::forward_as_tuple(true, NPZ_KEY_DATA, m_data, m_mapped_data));
   npyLoadList.push_back(
     std::forward_as_tuple(m_supported_input_types[INPUT_DATA_TYPE_LABELS],
                           NPZ_KEY_LABELS,
-                          m_labels));
+                          m_labels,
+                          m_mapped_labels));
   npyLoadList.push_back(
     std::forward_as_tuple(m_supported_input_types[INPUT_DATA_TYPE_RESPONSES],
                           NPZ_KEY_RESPONSES,
-                          m_responses));
+                          m_responses,
+                          m_mapped_responses));
   for (const auto& npyLoad : npyLoadList) {
     // Check whether the tensor have to be loaded.
+    cnpy_utils::mapped_array& mapped = std::get<3>(npyLoad);
+    mapped = cnpy_utils::mapped_array();
     if (!std::get<0>(npyLoad)) {
       continue;
     }
@@ -106,9 +132,17 @@ void numpy_npz_reader::load()
     const std::string key = std::get<1>(npyLoad);
     cnpy::NpyArray& ary = std::get<2>(npyLoad);
     const auto i = npz.find(key);
+    const auto m = mapped_npz.find(key);
     if (i != npz.end()) {
       ary = i->second;
     }
+    else if (m != mapped_npz.end()) {
+      mapped = m->second;
+      ary = mapped.header;
+      mapped.advise(0,
+                    ary.num_vals,
+                    m_shuffle ? MADV_RANDOM : MADV_SEQUENTIAL);
+    }
     else {
       throw lbann_exception(
         std::string{} + __FILE__ + " " + std::to_string(__LINE__) +
@@ -153,7 +187,7 @@ void numpy_npz_reader::load()
       throw lbann_exception(
         "numpy_npz_reader: label numpy array should be in int32");
     }
-    int* data = m_labels.data<int>();
+    const int* data = data_ptr<int>(m_labels, m_mapped_labels);
     for (int i = 0; i < m_num_samples; ++i) {
       label_classes.insert((int)data[i]);
     }
@@ -178,13 +212,33 @@ void numpy_npz_reader::load()
   select_subset_of_data();
 }
 
+void numpy_npz_reader::prepare_samples(const std::vector<int>& indices,
+                                       const std::vector<int>& next_indices)
+{
+  if (!m_mapped_data.is_mapped()) {
+    return;
+  }
+  for (const auto* batch : {&indices, &next_indices}) {
+    for (const size_t index : *batch) {
+      m_mapped_data.advise(index * m_num_features,
+                           m_num_features,
+                           MADV_WILLNEED);
+      m_mapped_labels.advise(index, 1, MADV_WILLNEED);
+      m_mapped_responses.advise(index * m_num_response_features,
+                                m_num_response_features,
+                                MADV_WILLNEED);
+    }
+  }
+}
+
 bool numpy_npz_reader::fetch_datum(Mat& X, int data_id, int mb_idx)
 {
   Mat X_v = El::View(X, El::IR(0, X.Height()), El::IR(mb_idx, mb_idx + 1));
 
   if (m_data.word_size == 2) {
     // Convert int16 to DataType.
-    const short* data = m_data.data<short>() + data_id * m_num_features;
+    const short* data =
+      data_ptr<short>(m_data, m_mapped_data) + data_id * m_num_features;
     DataType* dest = X_v.Buffer();
 
     // OPTIMIZE
@@ -193,12 +247,13 @@ bool numpy_npz_reader::fetch_datum(Mat& X, int data_id, int mb_idx)
       dest[j] = data[j] * m_scaling_factor_int16;
   }
   else {
-    void* data = NULL;
+    const void* data = NULL;
     if (m_data.word_size == 4) {
-      data = (void*)(m_data.data<float>() + data_id * m_num_features);
+      data = data_ptr<float>(m_data, m_mapped_data) + data_id * m_num_features;
     }
     else if (m_data.word_size == 8) {
-      data = (void*)(m_data.data<double>() + data_id * m_num_features);
+      data =
+        data_ptr<double>(m_data, m_mapped_data) + data_id * m_num_features;
     }
     std::memcpy(X_v.Buffer(), data, m_num_features * m_data.word_size);
   }
@@ -210,7 +265,7 @@ bool numpy_npz_reader::fetch_label(Mat& Y, int data_id, int mb_idx)
   if (!m_supported_input_types[INPUT_DATA_TYPE_LABELS]) {
     throw lbann_exception("numpy_npz_reader: do not have labels");
   }
-  const int label = m_labels.data<int>()[data_id];
+  const int label = data_ptr<int>(m_labels, m_mapped_labels)[data_id];
   Y(label, mb_idx) = 1;
   return true;
 }
@@ -224,8 +279,8 @@ bool numpy_npz_reader::fetch_response(Mat& Y, int data_id, int mb_idx)
   Mat Y_v = El::View(Y, El::IR(0, Y.Height()), El::IR(mb_idx, mb_idx + 1));
   if (m_responses.word_size == 2) {
     // Convert int16 to DataType.
-    const short* data =
-      m_responses.data<short>() + data_id * m_num_response_features;
+    const short* data = data_ptr<short>(m_responses, m_mapped_responses) +
+                        data_id * m_num_response_features;
     DataType* dest = Y_v.Buffer();
     // OPTIMIZE
     LBANN_OMP_PARALLEL_FOR
@@ -234,14 +289,14 @@ bool numpy_npz_reader::fetch_response(Mat& Y, int data_id, int mb_idx)
     return true;
   }
 
-  void* responses = NULL;
+  const void* responses = NULL;
   if (m_responses.word_size == 4) {
-    responses =
-      (void*)(m_responses.data<float>() + data_id * m_num_response_features);
+    responses = data_ptr<float>(m_responses, m_mapped_responses) +
+                data_id * m_num_response_features;
   }
   else if (m_responses.word_size == 8) {
-    responses =
-      (void*)(m_responses.data<double>() + data_id * m_num_response_features);
+    responses = data_ptr<double>(m_responses, m_mapped_responses) +
+                data_id * m_num_response_features;
   }
   std::memcpy(Y_v.Buffer(),
               responses,
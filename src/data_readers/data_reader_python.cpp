@@ -27,7 +27,9 @@
 #include "lbann/data_readers/data_reader_python.hpp"
 #include "lbann/execution_algorithms/execution_context.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/dim_helpers.hpp"
+#include "lbann/utils/options.hpp"
 #ifdef LBANN_HAS_EMBEDDED_PYTHON
 #include <algorithm>
 #include <cstdio>
@@ -45,7 +47,8 @@ python_reader::python_reader(std::string module,
                              std::string sample_function,
                              std::string num_samples_function,
                              std::string sample_dims_function,
-                             bool shuffle)
+                             bool shuffle,
+                             std::string sample_batch_function)
   : generic_data_reader(shuffle)
 {
 
@@ -78,9 +81,13 @@ python_reader::python_reader(std::string module,
   }
   python::check_error();
 
-  // Get sample access function
+  // Get sample access functions
   m_sample_function =
     PyObject_GetAttrString(data_module, sample_function.c_str());
+  if (!sample_batch_function.empty()) {
+    m_sample_batch_function =
+      PyObject_GetAttrString(data_module, sample_batch_function.c_str());
+  }
 }
 
 python_reader::~python_reader()
@@ -139,15 +146,26 @@ bool python_reader::fetch_data_block(
   }
 
   // Get arguments for sample access function
+  // Note: The mini-batch is split into one contiguous chunk of samples
+  // per worker process.
+  const El::Int num_chunks = std::min(m_num_worker_processes, mb_size);
   python::object args_list = PyList_New(0);
-  for (El::Int i = 0; i < mb_size; ++i) {
-    El::Int sample_index =
-      m_shuffled_indices[m_current_pos + i * m_sample_stride];
-    El::Int array_offset = sample_size * i;
-    PyList_Append(
-      args_list,
-      python::object(Py_BuildValue("(l,l)", sample_index, array_offset)));
-    indices_fetched.Set(i, 0, sample_index);
+  for (El::Int chunk = 0; chunk < num_chunks; ++chunk) {
+    const El::Int begin = mb_size * chunk / num_chunks;
+    const El::Int end = mb_size * (chunk + 1) / num_chunks;
+    python::object sample_indices = PyList_New(0);
+    for (El::Int i = begin; i < end; ++i) {
+      El::Int sample_index =
+        get_fetch_index(m_fetch_pos + i * m_sample_stride);
+      PyList_Append(sample_indices,
+                    python::object(static_cast<long>(sample_index)));
+      indices_fetched.Set(i, 0, sample_index);
+    }
+    El::Int array_offset = sample_size * begin;
+    PyList_Append(args_list,
+                  python::object(Py_BuildValue("(O,l)",
+                                               sample_indices.get(),
+                                               array_offset)));
   }
 
   // Get samples using Python process pool
@@ -234,6 +252,15 @@ void python_reader::setup(int num_io_threads,
                          sample_func_name.c_str(),
                          m_sample_function);
   python::check_error();
+  const std::string batch_func_name =
+    ("_DATA_READER_PYTHON_CPP_sample_batch_function" +
+     std::to_string(instance_id));
+  PyObject_SetAttrString(main_module,
+                         batch_func_name.c_str(),
+                         m_sample_batch_function != nullptr
+                           ? m_sample_batch_function.get()
+                           : Py_None);
+  python::check_error();
   const std::string shared_array_name =
     ("_DATA_READER_PYTHON_CPP_shared_memory_array" +
      std::to_string(instance_id));
@@ -242,36 +269,49 @@ void python_reader::setup(int num_io_threads,
                          m_shared_memory_array);
   python::check_error();
 
-  // Create wrapper around sample function
-  // Note: We attempt accessing the sample with the buffer protocol
+  // Create wrapper around sample functions
+  // Note: We attempt accessing the samples with the buffer protocol
   // since they can be copied more efficiently. If this fails, we just
   // iterate through the sample entries.
   /// @todo Handle multi-dimensional NumPy arrays.
   const std::string wrapper_func_name =
     ("_DATA_READER_PYTHON_CPP_sample_function" + std::to_string(instance_id));
   std::string wrapper_func_def = R"(
-def @wrapper_func@(sample_index, array_offset):
-    """Get data sample and copy to shared memory array."""
-
-    # Get sample
-    sample = @sample_func@(sample_index)
+def @wrapper_func@(sample_indices, array_offset):
+    """Get data samples and copy to shared memory array."""
+
+    # Note: ctypes arrays explicitly specify their endianness, but
+    # memoryview copies only work when the endianness is
+    # explicitly set to the system default. We need to do some
+    # type casting to get around this excessive error checking.
+    output_buffer = memoryview(@shared_array@)
+    output_buffer = output_buffer.cast('B').cast('@datatype_typecode@')
+
+    # Get all samples with one call if possible
+    if @batch_func@ is not None:
+        samples = @batch_func@(sample_indices)
+        size = len(sample_indices) * @sample_size@
+        try:
+            input_buffer = memoryview(samples)
+            input_buffer = input_buffer.cast('B').cast('@datatype_typecode@')
+            output_buffer[array_offset:array_offset+size] = input_buffer
+            return
+        except:
+            pass
+    else:
+        samples = (@sample_func@(i) for i in sample_indices)
 
-    # Copy entries from sample to shared memory array
+    # Copy entries from each sample to shared memory array
     # Note: We attempt to copy via the buffer protocol since it is
     # much more efficient than naively looping through the arrays.
-    try:
-        # Note: ctypes arrays explicitly specify their endianness, but
-        # memoryview copies only work when the endianness is
-        # explicitly set to the system default. We need to do some
-        # type casting to get around this excessive error checking.
-        input_buffer = memoryview(sample)
-        output_buffer = memoryview(@shared_array@)
-        output_buffer = output_buffer[array_offset:array_offset+@sample_size@]
-        output_buffer = output_buffer.cast('B').cast('@datatype_typecode@')
-        output_buffer[:] = input_buffer
-    except:
-        for i, val in enumerate(sample):
-            @shared_array@[i + array_offset] = val
+    for sample in samples:
+        try:
+            end = array_offset + @sample_size@
+            output_buffer[array_offset:end] = memoryview(sample)
+        except:
+            for i, val in enumerate(sample):
+                @shared_array@[i + array_offset] = val
+        array_offset += @sample_size@
 )";
   wrapper_func_def = std::regex_replace(wrapper_func_def,
                                         std::regex("\\@wrapper_func\\@"),
@@ -279,6 +319,9 @@ def @wrapper_func@(sample_index, array_offset):
   wrapper_func_def = std::regex_replace(wrapper_func_def,
                                         std::regex("\\@sample_func\\@"),
                                         sample_func_name);
+  wrapper_func_def = std::regex_replace(wrapper_func_def,
+                                        std::regex("\\@batch_func\\@"),
+                                        batch_func_name);
   wrapper_func_def = std::regex_replace(wrapper_func_def,
                                         std::regex("\\@shared_array\\@"),
                                         shared_array_name);
@@ -321,10 +364,18 @@ def @init_func@():
     PyObject_GetAttrString(main_module, init_func_name.c_str());
 
   // Start Python process pool
+  // Note: --num_io_worker_processes sizes the pool, since the samples
+  // are loaded by the worker processes rather than by the I/O threads.
+  const int num_io_worker_processes =
+    global_argument_parser().get<int>(LBANN_OPTION_NUM_IO_WORKER_PROCESSES);
+  m_num_worker_processes = std::max(
+    num_io_worker_processes > 0 ? num_io_worker_processes : num_io_threads,
+    1);
   m_process_pool = PyObject_CallMethod(multiprocessing_module,
                                        "Pool",
                                        "(L,O)",
-                                       num_io_threads,
+                                       static_cast<long long>(
+                                         m_num_worker_processes),
                                        init_func.get());
 }
 
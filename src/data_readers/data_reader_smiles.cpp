@@ -39,8 +39,11 @@
 #include "lbann/utils/vectorwrapbuf.hpp"
 #include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <mutex>
 #include <random>
+#include <sys/mman.h>
+#include <tuple>
 
 namespace lbann {
 
@@ -84,6 +87,11 @@ void smiles_data_reader::copy_members(const smiles_data_reader& rhs)
   m_bos = rhs.m_bos;
   m_eos = rhs.m_eos;
   m_metadata_filename = rhs.m_metadata_filename;
+  m_pretokenized = rhs.m_pretokenized;
+  m_token_mapping = rhs.m_token_mapping;
+  m_token_lengths = rhs.m_token_lengths;
+  m_tokens = rhs.m_tokens;
+  m_token_size = rhs.m_token_size;
   m_missing_char_in_vocab_count = rhs.m_missing_char_in_vocab_count;
   m_missing_chars = rhs.m_missing_chars;
   m_vocab = rhs.m_vocab;
@@ -101,6 +109,11 @@ void smiles_data_reader::load()
     std::cout << "starting load for role: " << get_role() << std::endl;
   }
 
+  if (m_pretokenized) {
+    load_pretokenized();
+    return;
+  }
+
   double tm1 = get_time();
   auto& arg_parser = global_argument_parser();
 
@@ -150,6 +163,107 @@ void smiles_data_reader::load()
   print_statistics();
 }
 
+void smiles_data_reader::load_pretokenized()
+{
+  double tm1 = get_time();
+  set_use_data_store(false);
+
+  const std::string path = get_file_dir() + get_data_filename();
+  size_t size;
+  std::tie(m_token_mapping, size) = file::map_read_only(path);
+  const char* const base = static_cast<const char*>(m_token_mapping.get());
+
+  smiles_token_header header;
+  if (size < sizeof(header)) {
+    LBANN_ERROR(path, " is too small to be a pre-tokenized SMILES corpus");
+  }
+  std::memcpy(&header, base, sizeof(header));
+  if (std::memcmp(header.magic, "LBSMITOK", sizeof(header.magic)) != 0) {
+    LBANN_ERROR(path, " is not a pre-tokenized SMILES corpus");
+  }
+  if (header.version != 1) {
+    LBANN_ERROR(path, " has unsupported version ", header.version);
+  }
+  if (header.token_size != sizeof(uint16_t) &&
+      header.token_size != sizeof(uint32_t)) {
+    LBANN_ERROR(path, " has unsupported token size ", header.token_size);
+  }
+  if (header.row_width < 2) {
+    LBANN_ERROR(path, " has rows too narrow for <bos> and <eos>");
+  }
+  const size_t num_samples = header.num_samples;
+  const size_t expected = sizeof(header) + num_samples * sizeof(uint32_t) +
+                          num_samples * header.row_width * header.token_size;
+  if (size != expected) {
+    LBANN_ERROR(path,
+                " has ",
+                size,
+                " bytes; expected ",
+                expected,
+                " for ",
+                num_samples,
+                " samples");
+  }
+
+  auto& arg_parser = global_argument_parser();
+  const int seq_len = arg_parser.get<int>(LBANN_OPTION_SEQUENCE_LENGTH);
+  const int row_seq_len = header.row_width - 2;
+  if (m_sequence_length == 0 && seq_len != -1) {
+    m_sequence_length = seq_len;
+  }
+  if (m_sequence_length != 0 && m_sequence_length != row_seq_len) {
+    LBANN_ERROR("sequence length is ",
+                m_sequence_length,
+                " but ",
+                path,
+                " was tokenized with sequence length ",
+                row_seq_len);
+  }
+  set_sequence_length(row_seq_len);
+  m_token_size = header.token_size;
+  m_pad = header.pad;
+  m_unk = header.unk;
+  m_bos = header.bos;
+  m_eos = header.eos;
+  m_token_lengths = reinterpret_cast<const uint32_t*>(base + sizeof(header));
+  m_tokens = base + sizeof(header) + num_samples * sizeof(uint32_t);
+  madvise(const_cast<char*>(base),
+          size,
+          is_shuffled() ? MADV_RANDOM : MADV_SEQUENTIAL);
+
+  m_shuffled_indices.clear();
+  m_shuffled_indices.resize(num_samples);
+  std::iota(m_shuffled_indices.begin(), m_shuffled_indices.end(), 0);
+  resize_shuffled_indices();
+  select_subset_of_data();
+
+  if (get_comm()->am_world_master()) {
+    std::cout << "time to map pre-tokenized corpus: " << get_time() - tm1
+              << std::endl;
+  }
+  print_statistics();
+}
+
+void smiles_data_reader::shuffle_indices(rng_gen& gen)
+{
+  if (m_pretokenized) {
+    generic_data_reader::shuffle_indices(gen);
+  }
+  else {
+    data_reader_sample_list::shuffle_indices(gen);
+  }
+}
+
+void smiles_data_reader::bucket_shuffled_indices()
+{
+  if (m_pretokenized) {
+    generic_data_reader::bucket_shuffled_indices();
+  }
+  else {
+    data_reader_sample_list::bucket_shuffled_indices();
+  }
+}
+
 void smiles_data_reader::do_preload_data_store()
 {
   double tm1 = get_time();
@@ -310,6 +424,22 @@ std::set<int> smiles_data_reader::get_my_indices() const
 
 bool smiles_data_reader::fetch_datum(Mat& X, int data_id, int mb_idx)
 {
+  if (m_pretokenized) {
+    // The row is already encoded and padded to the row width
+    const size_t width = m_linearized_data_size;
+    const char* const row = m_tokens + data_id * width * m_token_size;
+    DataType* const out = X.Buffer(0, mb_idx);
+    if (m_token_size == sizeof(uint16_t)) {
+      const auto* tokens = reinterpret_cast<const uint16_t*>(row);
+      std::copy(tokens, tokens + width, out);
+    }
+    else {
+      const auto* tokens = reinterpret_cast<const uint32_t*>(row);
+      std::copy(tokens, tokens + width, out);
+    }
+    return true;
+  }
+
   if (!data_store_active()) {
     LBANN_ERROR(
       "it should be impossible you you to be here; please contact Dave Hysom");
@@ -370,6 +500,11 @@ void smiles_data_reader::print_statistics() const
     std::cerr << std::endl;
   }
 
+  if (m_pretokenized) {
+    std::cerr << "======================================================\n\n";
+    return;
+  }
+
   // +4 for <bos>, <eos>, <unk>, <pad>
   std::cerr << "vocab size: " << m_vocab.size() + 4 << std::endl
             << "    (includes +4 for <bos>, <eos>, <pad>, <unk>)" << std::endl
@@ -809,6 +944,10 @@ void smiles_data_reader::read_metadata_file(
 void smiles_data_reader::use_unused_index_set(execution_mode m)
 {
   data_reader_sample_list::use_unused_index_set(m);
+  if (m_pretokenized) {
+    print_statistics();
+    return;
+  }
   // Clear the existing data structures
   m_index_to_local_id.clear();
   m_local_to_index.clear();
@@ -840,6 +979,20 @@ void smiles_data_reader::get_sample_origin(const size_t index_in,
   filename_out = t3->second;
 }
 
+int smiles_data_reader::get_sample_length(int index) const
+{
+  if (m_tokens != nullptr) {
+    return m_token_lengths[index];
+  }
+  offset_map_t::const_iterator iter = m_sample_offsets.find(index);
+  if (iter == m_sample_offsets.end()) {
+    LBANN_ERROR("index ", index, " not found in m_sample_offsets");
+  }
+  // encode_smiles() truncates to the sequence length
+  const int num_chars = iter->second.second;
+  return std::min(num_chars + 2, m_linearized_data_size);
+}
+
 void smiles_data_reader::set_offset(size_t index,
                                     long long offset,
                                     unsigned short length)
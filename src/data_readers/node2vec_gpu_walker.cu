@@ -0,0 +1,375 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/data_readers/node2vec_gpu_walker.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+namespace {
+
+/** Walk steps are redrawn at most this many times before the last
+ *  draw is accepted; likewise for repeated negative samples */
+constexpr int max_attempts = 32;
+
+__device__ __forceinline__ uint64_t splitmix64(uint64_t& state)
+{
+  uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/** Uniform in [0,1) */
+__device__ __forceinline__ float uniform(uint64_t& state)
+{
+  return (splitmix64(state) >> 40) * (1.f / 16777216.f);
+}
+
+/** Index of the first entry of the sorted range that is > value */
+template <typename T>
+__device__ El::Int upper_bound(const T* first, El::Int n, T value)
+{
+  El::Int lo = 0;
+  while (n > 0) {
+    const El::Int half = n / 2;
+    if (first[lo + half] <= value) {
+      lo += half + 1;
+      n -= half + 1;
+    }
+    else {
+      n = half;
+    }
+  }
+  return lo;
+}
+
+__device__ bool contains(const El::Int* first, El::Int n, El::Int value)
+{
+  const El::Int pos = upper_bound(first, n, value);
+  return pos > 0 && first[pos - 1] == value;
+}
+
+__device__ bool contains(const DataType* first, size_t n, DataType value)
+{
+  for (size_t i = 0; i < n; ++i) {
+    if (first[i] == value) {
+      return true;
+    }
+  }
+  return false;
+}
+
+__global__ void walk_kernel(const El::Int* __restrict__ offsets,
+                            const El::Int* __restrict__ targets,
+                            const float* __restrict__ cum_weights,
+                            const El::Int* __restrict__ local_vertices,
+                            const El::Int* __restrict__ local_index,
+                            const double* __restrict__ noise_cdf,
+                            unsigned long long* __restrict__ visit_counts,
+                            El::Int num_local_vertices,
+                            size_t walk_length,
+                            float inv_return_param,
+                            float inv_inout_param,
+                            float max_bias,
+                            size_t num_negative_samples,
+                            uint64_t seed,
+                            El::Int mb_size,
+                            DataType* __restrict__ X,
+                            El::Int ldim)
+{
+  const El::Int j = threadIdx.x + blockIdx.x * blockDim.x;
+  if (j >= mb_size) {
+    return;
+  }
+  uint64_t state = seed ^ (0xD1B54A32D192ED03ull * (j + 1));
+  splitmix64(state);
+  DataType* const col = X + j * ldim;
+  DataType* const walk = col + num_negative_samples;
+
+  // Biased second-order walk from a random local vertex
+  El::Int cur = local_vertices[gpu_lib::min(
+    static_cast<El::Int>(uniform(state) * num_local_vertices),
+    num_local_vertices - 1)];
+  El::Int prev = -1;
+  for (size_t i = 0; i < walk_length; ++i) {
+    if (i > 0) {
+      const El::Int begin = offsets[cur];
+      const El::Int end = offsets[cur + 1];
+      El::Int next = cur;
+      if (end > begin) {
+        const float total = cum_weights[end - 1];
+        for (int attempt = 0;; ++attempt) {
+          // First-order draw in proportion to the edge weight
+          const float r = uniform(state) * total;
+          const El::Int e = gpu_lib::min(
+            begin + upper_bound(cum_weights + begin, end - begin, r),
+            end - 1);
+          next = targets[e];
+          if (prev < 0 || attempt == max_attempts) {
+            break;
+          }
+          // Accept in proportion to the node2vec bias
+          float bias = inv_inout_param;
+          if (next == prev) {
+            bias = inv_return_param;
+          }
+          else if (contains(targets + offsets[prev],
+                            offsets[prev + 1] - offsets[prev],
+                            next)) {
+            bias = 1.f;
+          }
+          if (uniform(state) * max_bias < bias) {
+            break;
+          }
+        }
+      }
+      prev = cur;
+      cur = next;
+    }
+    walk[i] = static_cast<DataType>(cur);
+    const El::Int li = local_index[cur];
+    if (li >= 0) {
+      atomicAdd(&visit_counts[li], 1ull);
+    }
+  }
+
+  // Negative samples that are not in the walk nor repeated
+  for (size_t k = 0; k < num_negative_samples; ++k) {
+    DataType v = 0;
+    for (int attempt = 0; attempt <= max_attempts; ++attempt) {
+      const El::Int li =
+        gpu_lib::min(upper_bound(noise_cdf,
+                                 num_local_vertices,
+                                 static_cast<double>(uniform(state))),
+                     num_local_vertices - 1);
+      v = static_cast<DataType>(local_vertices[li]);
+      if (!contains(walk, walk_length, v) && !contains(col, k, v)) {
+        break;
+      }
+    }
+    col[k] = v;
+  }
+}
+
+template <typename T>
+void copy_to_device(hydrogen::simple_buffer<T, El::Device::GPU>& buffer,
+                    const std::vector<T>& host,
+                    const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  hydrogen::gpu::Copy1DToDevice(host.data(),
+                                buffer.data(),
+                                host.size(),
+                                sync_info);
+}
+
+/** Stream owned by the walker; destroyed after its buffers */
+struct owned_sync_info
+{
+  owned_sync_info() : sync_info(El::CreateNewSyncInfo<El::Device::GPU>()) {}
+  ~owned_sync_info() { El::DestroySyncInfo(sync_info); }
+  El::SyncInfo<El::Device::GPU> sync_info;
+};
+
+} // namespace
+
+struct node2vec_gpu_walker::device_data
+{
+  device_data(size_t num_vertices, size_t num_edges, size_t num_local)
+    : offsets(num_vertices + 1, stream.sync_info),
+      targets(num_edges, stream.sync_info),
+      cum_weights(num_edges, stream.sync_info),
+      local_vertices(num_local, stream.sync_info),
+      local_index(num_vertices, stream.sync_info),
+      noise_cdf(num_local, stream.sync_info),
+      visit_counts(num_local, stream.sync_info)
+  {}
+
+  owned_sync_info stream;
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> offsets;
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> targets;
+  /** Inclusive prefix sums of the edge weights within each row */
+  hydrogen::simple_buffer<float, El::Device::GPU> cum_weights;
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> local_vertices;
+  /** Local index of each vertex; -1 for remote vertices */
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> local_index;
+  hydrogen::simple_buffer<double, El::Device::GPU> noise_cdf;
+  hydrogen::simple_buffer<unsigned long long, El::Device::GPU> visit_counts;
+  /** Recorded after the last walk kernel */
+  gpu_lib::event_wrapper generated;
+};
+
+node2vec_gpu_walker::node2vec_gpu_walker(
+  const std::vector<El::Int>& offsets,
+  const std::vector<El::Int>& targets,
+  const std::vector<float>& weights,
+  const std::vector<El::Int>& local_vertices,
+  size_t walk_length,
+  double return_param,
+  double inout_param,
+  size_t num_negative_samples)
+  : m_num_vertices(offsets.empty() ? 0 : offsets.size() - 1),
+    m_num_local_vertices(local_vertices.size()),
+    m_walk_length(walk_length),
+    m_return_param(return_param),
+    m_inout_param(inout_param),
+    m_num_negative_samples(num_negative_samples)
+{
+  if (m_num_local_vertices == 0) {
+    LBANN_ERROR("node2vec GPU walker needs local vertices");
+  }
+  if (offsets.empty() || targets.size() != weights.size() ||
+      static_cast<size_t>(offsets.back()) != targets.size()) {
+    LBANN_ERROR("inconsistent CSR graph for node2vec GPU walker");
+  }
+
+  std::vector<float> cum_weights(weights.size());
+  for (size_t v = 0; v < m_num_vertices; ++v) {
+    float sum = 0.f;
+    for (El::Int e = offsets[v]; e < offsets[v + 1]; ++e) {
+      sum += weights[e];
+      cum_weights[e] = sum;
+    }
+  }
+  std::vector<El::Int> local_index(m_num_vertices, -1);
+  for (size_t i = 0; i < m_num_local_vertices; ++i) {
+    local_index.at(local_vertices[i]) = i;
+  }
+
+  hydrogen::gpu::SetDevice(hydrogen::gpu::DefaultDevice());
+  m_data = std::make_unique<device_data>(m_num_vertices,
+                                         targets.size(),
+                                         m_num_local_vertices);
+  auto& d = *m_data;
+  const auto& sync_info = d.stream.sync_info;
+  copy_to_device(d.offsets, offsets, sync_info);
+  copy_to_device(d.targets, targets, sync_info);
+  copy_to_device(d.cum_weights, cum_weights, sync_info);
+  copy_to_device(d.local_vertices, local_vertices, sync_info);
+  copy_to_device(d.local_index, local_index, sync_info);
+  copy_to_device(d.visit_counts,
+                 std::vector<unsigned long long>(m_num_local_vertices, 0),
+                 sync_info);
+  El::Synchronize(sync_info);
+}
+
+node2vec_gpu_walker::~node2vec_gpu_walker()
+{
+  if (m_data) {
+    m_data->generated.synchronize();
+    El::Synchronize(m_data->stream.sync_info);
+  }
+}
+
+void node2vec_gpu_walker::set_noise_distribution(
+  const std::vector<double>& cdf)
+{
+  if (cdf.size() != m_num_local_vertices) {
+    LBANN_ERROR("expected a noise distribution over ",
+                m_num_local_vertices,
+                " local vertices, got ",
+                cdf.size());
+  }
+  auto& d = *m_data;
+  // The previous distribution may still be in use
+  d.generated.synchronize();
+  copy_to_device(d.noise_cdf, cdf, d.stream.sync_info);
+  El::Synchronize(d.stream.sync_info);
+}
+
+void node2vec_gpu_walker::generate(El::Matrix<DataType, El::Device::GPU>& X,
+                                   El::Int mb_size,
+                                   uint64_t seed)
+{
+  if (static_cast<size_t>(X.Height()) !=
+        m_num_negative_samples + m_walk_length ||
+      X.Width() < mb_size) {
+    LBANN_ERROR("node2vec GPU walker got a ",
+                X.Height(),
+                " x ",
+                X.Width(),
+                " matrix for ",
+                mb_size,
+                " samples");
+  }
+  if (mb_size == 0) {
+    return;
+  }
+  auto& d = *m_data;
+  auto sync_info = gpu::get_sync_info(X);
+  const float inv_p = 1.f / m_return_param;
+  const float inv_q = 1.f / m_inout_param;
+  const float max_bias = std::max({inv_p, 1.f, inv_q});
+  constexpr El::Int block_size = 128;
+  dim3 grid_dims((mb_size + block_size - 1) / block_size);
+  hydrogen::gpu::LaunchKernel(walk_kernel,
+                              grid_dims,
+                              block_size,
+                              0,
+                              sync_info,
+                              d.offsets.data(),
+                              d.targets.data(),
+                              d.cum_weights.data(),
+                              d.local_vertices.data(),
+                              d.local_index.data(),
+                              d.noise_cdf.data(),
+                              d.visit_counts.data(),
+                              static_cast<El::Int>(m_num_local_vertices),
+                              m_walk_length,
+                              inv_p,
+                              inv_q,
+                              max_bias,
+                              m_num_negative_samples,
+                              seed,
+                              mb_size,
+                              X.Buffer(),
+                              X.LDim());
+  d.generated.record(sync_info.Stream());
+}
+
+void node2vec_gpu_walker::accumulate_visit_counts(std::vector<size_t>& counts)
+{
+  auto& d = *m_data;
+  std::vector<unsigned long long> host(m_num_local_vertices);
+  d.generated.synchronize();
+  hydrogen::gpu::Copy1DToHost(d.visit_counts.data(),
+                              host.data(),
+                              host.size(),
+                              d.stream.sync_info);
+  El::Synchronize(d.stream.sync_info);
+  for (size_t i = 0; i < host.size(); ++i) {
+    counts[i] += host[i];
+  }
+  std::fill(host.begin(), host.end(), 0);
+  copy_to_device(d.visit_counts, host, d.stream.sync_info);
+  El::Synchronize(d.stream.sync_info);
+}
+
+} // namespace lbann
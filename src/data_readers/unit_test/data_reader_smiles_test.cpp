@@ -206,3 +206,64 @@ CC(=O)N[C@@H]1[C@@H](O)C[C@@](O)(C(=O)N2CC (=O)NCC2C(N)=O)O[C@H]1[C@H](O)[C@H](O
     CHECK(str == smiles_str.substr(line_len + 1, sample_two_valid_chars));
   }
 }
+
+TEST_CASE("SMILES length bucketing", "[data_reader][smiles]")
+{
+  auto& arg_parser = lbann::global_argument_parser();
+  arg_parser.clear();
+  lbann::construct_all_options();
+  char const* argv[] = {"data_reader_smiles_test.exe",
+                        "--sequence_bucket_window=2"};
+  int const argc = sizeof(argv) / sizeof(argv[0]);
+  REQUIRE_NOTHROW(arg_parser.parse(argc, argv));
+
+  auto smiles = std::make_unique<lbann::smiles_data_reader>(true);
+  smiles->set_linearized_data_size(102);
+  const int num_samples = 17;
+  const int mb_size = 4;
+  std::vector<int> indices;
+  for (int i = 0; i < num_samples; ++i) {
+    smiles->set_offset(i, 0, (i * 7) % num_samples);
+    indices.push_back(num_samples - 1 - i);
+  }
+  smiles->set_shuffled_indices(indices);
+  smiles->set_stride_to_next_mini_batch(mb_size);
+
+  REQUIRE(smiles->has_sample_lengths());
+  CHECK(smiles->get_sample_length(3) == 3 * 7 % num_samples + 2);
+
+  smiles->bucket_shuffled_indices();
+  auto bucketed = smiles->get_shuffled_indices();
+
+  // The trailing partial mini-batch is untouched
+  CHECK(bucketed.back() == indices.back());
+
+  // Each window holds the same samples, and its mini-batches do not
+  // overlap in length
+  const int window = 2 * mb_size;
+  for (int begin = 0; begin + window <= num_samples; begin += window) {
+    std::vector<int> a(indices.begin() + begin,
+                       indices.begin() + begin + window);
+    std::vector<int> b(bucketed.begin() + begin,
+                       bucketed.begin() + begin + window);
+    std::sort(a.begin(), a.end());
+    std::sort(b.begin(), b.end());
+    CHECK(a == b);
+
+    auto lengths = [&](int first) {
+      std::vector<int> l;
+      for (int j = first; j < first + mb_size; ++j) {
+        l.push_back(smiles->get_sample_length(bucketed[j]));
+      }
+      return l;
+    };
+    const auto l0 = lengths(begin);
+    const auto l1 = lengths(begin + mb_size);
+    const bool ordered =
+      *std::max_element(l0.begin(), l0.end()) <=
+        *std::min_element(l1.begin(), l1.end()) ||
+      *std::max_element(l1.begin(), l1.end()) <=
+        *std::min_element(l0.begin(), l0.end());
+    CHECK(ordered);
+  }
+}
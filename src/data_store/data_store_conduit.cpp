@@ -46,8 +46,11 @@
 #include <sys/statvfs.h>
 #include <unistd.h>
 #include <unordered_set>
+#include <zlib.h>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
 
 namespace lbann {
 
@@ -101,12 +104,76 @@ data_store_conduit::data_store_conduit(generic_data_reader* reader)
   }
   if (arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_SPILL) != "") {
     setup_spill(arg_parser.get<std::string>(LBANN_OPTION_DATA_STORE_SPILL));
+    m_spill_segments =
+      arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_SPILL_SEGMENTS);
+    m_spill_cache_capacity =
+      static_cast<size_t>(std::max(
+        0,
+        arg_parser.get<int>(LBANN_OPTION_DATA_STORE_SPILL_CACHE_MB))) *
+      1024 * 1024;
+    m_spill_prefetch_depth =
+      std::max(0, arg_parser.get<int>(LBANN_OPTION_DATA_STORE_SPILL_PREFETCH));
   }
 
   set_is_local_cache(arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_CACHE));
+  m_share_cache_across_trainers =
+    is_local_cache() &&
+    arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_CACHE_SHARED);
   set_is_preloading(arg_parser.get<bool>(LBANN_OPTION_PRELOAD_DATA_STORE));
   set_is_explicitly_loading(!is_preloading());
 
+  m_compress = arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_COMPRESS) &&
+               is_preloading() && !is_local_cache() && !m_spill;
+  if (arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_COMPRESS) && !m_compress) {
+    PROFILE("--data_store_compress is only supported when preloading "
+            "without local cache or spilling; ignoring");
+  }
+  if (m_compress) {
+    // compressed samples differ in size
+    m_node_sizes_vary = true;
+  }
+
+  m_use_arena = arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_ARENA) &&
+                is_preloading() && !is_local_cache() && !m_spill &&
+                !m_compress;
+  if (arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_ARENA) && !m_use_arena) {
+    PROFILE("--data_store_arena is only supported when preloading without "
+            "local cache or spilling; ignoring");
+  }
+
+  const int budget_mb =
+    arg_parser.get<int>(LBANN_OPTION_DATA_STORE_MEM_BUDGET_MB);
+  if (budget_mb > 0) {
+    if (!is_preloading() || is_local_cache() || m_spill) {
+      PROFILE("--data_store_mem_budget_mb is only supported when preloading "
+              "without local cache or spilling; ignoring");
+    }
+    else if (!m_reader->supports_partial_data_store()) {
+      PROFILE("--data_store_mem_budget_mb is not supported by the ",
+              m_reader->get_type(),
+              " reader; ignoring");
+    }
+    else {
+      m_mem_budget_per_rank = static_cast<size_t>(budget_mb) * 1024 * 1024 /
+                              std::max(1, m_comm->get_procs_per_node());
+    }
+  }
+
+  m_locality_aware =
+    arg_parser.get<bool>(LBANN_OPTION_DATA_STORE_LOCALITY_AWARE);
+  m_locality_randomness = std::min(
+    1.,
+    std::max(0.,
+             static_cast<double>(arg_parser.get<float>(
+               LBANN_OPTION_DATA_STORE_LOCALITY_RANDOMNESS))));
+
+  m_exchange_lookahead = std::max(
+    1,
+    arg_parser.get<int>(LBANN_OPTION_DATA_STORE_EXCHANGE_LOOKAHEAD));
+  if (m_spill && m_exchange_lookahead > 1) {
+    PROFILE("--data_store_exchange_lookahead is ignored when spilling");
+  }
+
   if (is_local_cache()) {
     PROFILE("data_store_conduit is running in local_cache mode");
   }
@@ -131,18 +198,30 @@ data_store_conduit::~data_store_conduit()
   if (m_profile) {
     m_profile->close();
   }
+  // n.b. the segment name was unlinked as soon as all local ranks
+  //      had mapped it, so unmapping is all that is left to do
   if (m_is_local_cache && m_mem_seg) {
-    int sanity = shm_unlink(m_seg_name.c_str());
-    if (sanity != 0) {
-      std::cout << "\nWARNING: shm_unlink failed in "
-                   "data_store_conduit::~data_store_conduit()\n";
-    }
-    sanity = munmap(reinterpret_cast<void*>(m_mem_seg), m_mem_seg_length);
+    int sanity = munmap(reinterpret_cast<void*>(m_mem_seg), m_mem_seg_length);
     if (sanity != 0) {
       std::cout << "\nWARNING: munmap failed in "
                    "data_store_conduit::~data_store_conduit()\n";
     }
   }
+  if (m_have_node_local_comms) {
+    El::mpi::Free(m_trainer_node_comm);
+    El::mpi::Free(m_node_leaders_comm);
+  }
+  if (m_spill_prefetch.valid()) {
+    m_spill_prefetch.wait();
+  }
+  if (m_spill_write_fd != -1) {
+    close(m_spill_write_fd);
+  }
+  for (int fd : m_spill_read_fds) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
 }
 
 void data_store_conduit::setup_checkpoint_test()
@@ -220,6 +299,8 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_mem_seg_length = rhs.m_mem_seg_length;
   m_seg_name = rhs.m_seg_name;
   m_image_offsets = rhs.m_image_offsets;
+  m_share_cache_across_trainers = rhs.m_share_cache_across_trainers;
+  m_is_cache_writer = rhs.m_is_cache_writer;
 
   // This needs to be false, to ensure a carved out validation set
   // check for sufficient samples
@@ -231,6 +312,21 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_cur_spill_dir_integer = rhs.m_cur_spill_dir_integer;
   m_cur_spill_dir = rhs.m_cur_spill_dir;
   m_num_files_in_cur_spill_dir = rhs.m_num_files_in_cur_spill_dir;
+  // descriptors and the DRAM tier are not shared; the copy reopens the
+  // segments on demand
+  m_spill_segments = rhs.m_spill_segments;
+  m_spill_index = rhs.m_spill_index;
+  m_spill_cur_segment = rhs.m_spill_cur_segment;
+  m_spill_segment_bytes = m_spill_max_segment_bytes;
+  m_spill_cache_capacity = rhs.m_spill_cache_capacity;
+  m_spill_prefetch_depth = rhs.m_spill_prefetch_depth;
+
+  m_use_arena = rhs.m_use_arena;
+  m_arena_expected_num_samples = rhs.m_arena_expected_num_samples;
+  m_arena_slabs = rhs.m_arena_slabs;
+  m_arena_slab_capacity = rhs.m_arena_slab_capacity;
+  m_arena_slab_fill = rhs.m_arena_slab_fill;
+  m_arena_ptrs = rhs.m_arena_ptrs;
 
   /// Clear the pointer to the data reader, this cannot be copied
   m_reader = nullptr;
@@ -241,9 +337,6 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_minibatch_data = rhs.m_minibatch_data;
   m_send_buffer = rhs.m_send_buffer;
   m_send_buffer_2 = rhs.m_send_buffer_2;
-  m_send_requests = rhs.m_send_requests;
-  m_recv_requests = rhs.m_recv_requests;
-  m_recv_buffer = rhs.m_recv_buffer;
   m_outgoing_msg_sizes = rhs.m_outgoing_msg_sizes;
   m_incoming_msg_sizes = rhs.m_incoming_msg_sizes;
   m_compacted_sample_size = rhs.m_compacted_sample_size;
@@ -251,6 +344,14 @@ void data_store_conduit::copy_members(const data_store_conduit& rhs)
   m_indices_to_recv = rhs.m_indices_to_recv;
 
   m_mini_batch_data_exchange_started = rhs.m_mini_batch_data_exchange_started;
+  m_exchange_lookahead = rhs.m_exchange_lookahead;
+  m_mem_budget_per_rank = rhs.m_mem_budget_per_rank;
+  m_cached_bytes = rhs.m_cached_bytes;
+  m_dropped_samples = rhs.m_dropped_samples;
+  m_uncached = rhs.m_uncached;
+  m_compress = rhs.m_compress;
+  m_locality_aware = rhs.m_locality_aware;
+  m_locality_randomness = rhs.m_locality_randomness;
 
   open_informational_files();
 }
@@ -267,11 +368,8 @@ void data_store_conduit::setup_data_store_buffers()
   // allocate buffers that are used in exchange_data()
   m_send_buffer.resize(m_np_in_trainer);
   m_send_buffer_2.resize(m_np_in_trainer);
-  m_send_requests.resize(m_np_in_trainer);
-  m_recv_requests.resize(m_np_in_trainer);
   m_outgoing_msg_sizes.resize(m_np_in_trainer);
   m_incoming_msg_sizes.resize(m_np_in_trainer);
-  m_recv_buffer.resize(m_np_in_trainer);
 }
 
 void data_store_conduit::spill_preloaded_conduit_node(int data_id,
@@ -291,6 +389,13 @@ void data_store_conduit::spill_preloaded_conduit_node(int data_id,
     m_sample_sizes[data_id] = n3.total_bytes_compact();
   }
 
+  if (m_spill_segments) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    spill_to_segment(n3, data_id);
+    m_data.erase(data_id);
+    return;
+  }
+
   {
     std::lock_guard<std::mutex> lock(m_mutex);
     spill_conduit_node(node, data_id);
@@ -325,6 +430,41 @@ void data_store_conduit::set_preloaded_conduit_node(int data_id,
     return;
   }
 
+  if (m_mem_budget_per_rank > 0) {
+    // first come, first cached: samples that would exceed the budget are
+    // left to the reader's regular path
+    const size_t sz = node.total_bytes_compact();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_cached_bytes + sz > m_mem_budget_per_rank) {
+      m_data.erase(data_id);
+      m_dropped_samples.push_back(data_id);
+      return;
+    }
+    m_cached_bytes += sz;
+  }
+
+  if (m_use_arena && !m_node_sizes_vary) {
+    conduit::Node n2;
+    build_node_for_sending(node, n2); // node == m_data[data_id]
+    error_check_compacted_node(n2, data_id);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    set_arena_node(data_id, n2);
+    return;
+  }
+
+  if (m_compress) {
+    conduit::Node n2;
+    build_node_for_sending(node, n2); // node == m_data[data_id]
+    std::vector<El::byte> z;
+    compress_packed_node(n2, z);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    conduit::Node& stored = m_data[data_id];
+    stored.set(conduit::DataType::uint8(z.size()));
+    std::memcpy(stored.data_ptr(), z.data(), z.size());
+    m_sample_sizes[data_id] = z.size();
+    return;
+  }
+
   {
     conduit::Node n2 = node; // node == m_data[data_id]
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -378,6 +518,70 @@ void data_store_conduit::error_check_compacted_node(const conduit::Node& nd,
   }
 }
 
+El::byte* data_store_conduit::allocate_arena_slot()
+{
+  if (m_compacted_sample_size <= 0) {
+    LBANN_ERROR("m_compacted_sample_size must be set before allocating space "
+                "in the arena; role: ",
+                m_reader->get_role());
+  }
+  if (m_arena_slabs.empty() ||
+      m_arena_slab_fill == m_arena_slab_capacity.back()) {
+    const size_t num_samples =
+      (m_arena_slabs.empty()
+         ? std::max(m_arena_expected_num_samples, m_arena_min_slab_samples)
+         : m_arena_min_slab_samples);
+    const size_t num_bytes = num_samples * m_compacted_sample_size;
+    m_arena_slabs.emplace_back(new El::byte[num_bytes]);
+    m_arena_slab_capacity.push_back(num_samples);
+    m_arena_slab_fill = 0;
+  }
+  const size_t stride = m_compacted_sample_size;
+  El::byte* slot = m_arena_slabs.back().get() + m_arena_slab_fill * stride;
+  ++m_arena_slab_fill;
+  return slot;
+}
+
+void data_store_conduit::set_arena_node(int data_id,
+                                        const conduit::Node& packed)
+{
+  if (m_arena_ptrs.find(data_id) != m_arena_ptrs.end()) {
+    LBANN_ERROR("duplicate data_id: ", data_id, " in the data store arena");
+  }
+  El::byte* slot = allocate_arena_slot();
+  std::memcpy(slot, packed.contiguous_data_ptr(), m_compacted_sample_size);
+  m_arena_ptrs[data_id] = slot;
+  // replace the owned node with a view over the arena; this releases the
+  // per-sample allocation made by the data reader
+  m_data[data_id].set_external(packed.schema(), slot);
+}
+
+const El::byte* data_store_conduit::get_packed_sample_ptr(int data_id)
+{
+  if (m_use_arena) {
+    auto it = m_arena_ptrs.find(data_id);
+    if (it != m_arena_ptrs.end()) {
+      return it->second;
+    }
+  }
+  if (m_data.find(data_id) == m_data.end()) {
+    LBANN_ERROR("failed to find data_id: ", data_id, " in m_data");
+  }
+  const conduit::Node& n = m_data[data_id];
+  if (!n.is_contiguous()) {
+    LBANN_ERROR("data_id: ", data_id, " does not have a contiguous layout");
+  }
+  if (n.data_ptr() == nullptr) {
+    LBANN_ERROR("data_id: ", data_id, " does not have a valid data pointer");
+  }
+  if (n.contiguous_data_ptr() == nullptr) {
+    LBANN_ERROR("data_id: ",
+                data_id,
+                " does not have a valid contiguous data pointer");
+  }
+  return reinterpret_cast<const El::byte*>(n.data_ptr());
+}
+
 // n.b. Do not put any PROFILE or DEBUG_DS statements in this method,
 //      since the threading from the data_reader will cause you grief
 void data_store_conduit::set_conduit_node(int data_id,
@@ -491,6 +695,13 @@ const conduit::Node& data_store_conduit::get_conduit_node(int data_id) const
   // we need to check m_data
   if (t2 == m_minibatch_data.end()) {
     iterator_t t3 = m_data.find(data_id);
+    if (t3 != m_data.end() && m_compress) {
+      LBANN_ERROR("data_id: ",
+                  data_id,
+                  " is stored compressed and only available after it has "
+                  "been exchanged; role: ",
+                  m_reader->get_role());
+    }
     if (t3 != m_data.end()) {
       return t3->second["data"];
     }
@@ -584,10 +795,21 @@ void data_store_conduit::start_exchange_data_by_sample(size_t current_pos,
 
   int num_recv_req = build_indices_i_will_recv(current_pos, mb_size);
 
-  m_send_requests.resize(num_send_req);
-  m_recv_requests.resize(num_recv_req);
-  m_recv_buffer.resize(num_recv_req);
-  m_recv_data_ids.resize(num_recv_req);
+  m_exchanges_in_flight.emplace_back();
+  exchange_state& x = m_exchanges_in_flight.back();
+  x.current_pos = current_pos;
+  x.mb_size = mb_size;
+  x.is_packed = use_packed_exchange(mb_size);
+  if (x.is_packed) {
+    start_exchange_packed_data(x);
+    m_start_snd_rcv_time += (get_time() - tm5);
+    return;
+  }
+
+  x.send_requests.resize(num_send_req);
+  x.recv_requests.resize(num_recv_req);
+  x.recv_buffer.resize(num_recv_req);
+  x.recv_data_ids.resize(num_recv_req);
 
   //========================================================================
   // part 2: exchange the actual data
@@ -604,19 +826,7 @@ void data_store_conduit::start_exchange_data_by_sample(size_t current_pos,
                     p,
                     " in m_data");
       }
-      const conduit::Node& n = m_data[index];
-      const El::byte* s = reinterpret_cast<const El::byte*>(n.data_ptr());
-      if (!n.is_contiguous()) {
-        LBANN_ERROR("data_id: ", index, " does not have a contiguous layout");
-      }
-      if (n.data_ptr() == nullptr) {
-        LBANN_ERROR("data_id: ", index, " does not have a valid data pointer");
-      }
-      if (n.contiguous_data_ptr() == nullptr) {
-        LBANN_ERROR("data_id: ",
-                    index,
-                    " does not have a valid contiguous data pointer");
-      }
+      const El::byte* s = get_packed_sample_ptr(index);
 
       size_t sz = m_compacted_sample_size;
 
@@ -635,17 +845,17 @@ void data_store_conduit::start_exchange_data_by_sample(size_t current_pos,
                                        sz,
                                        p,
                                        index,
-                                       m_send_requests[ss++],
+                                       x.send_requests[ss++],
                                        m_comm->get_trainer_comm());
     }
   }
 
   // sanity checks
-  if (ss != m_send_requests.size()) {
-    LBANN_ERROR("ss != m_send_requests.size; ss: ",
+  if (ss != x.send_requests.size()) {
+    LBANN_ERROR("ss != x.send_requests.size; ss: ",
                 ss,
-                " m_send_requests.size: ",
-                m_send_requests.size());
+                " x.send_requests.size: ",
+                x.send_requests.size());
   }
 
   // start recvs for incoming data
@@ -674,31 +884,31 @@ void data_store_conduit::start_exchange_data_by_sample(size_t current_pos,
         sz = m_sample_sizes[index];
       }
 
-      m_recv_buffer[ss].set(conduit::DataType::uint8(sz));
-      El::byte* r = reinterpret_cast<El::byte*>(m_recv_buffer[ss].data_ptr());
+      x.recv_buffer[ss].set(conduit::DataType::uint8(sz));
+      El::byte* r = reinterpret_cast<El::byte*>(x.recv_buffer[ss].data_ptr());
       m_comm->nb_tagged_recv<El::byte>(r,
                                        sz,
                                        p,
                                        index,
-                                       m_recv_requests[ss],
+                                       x.recv_requests[ss],
                                        m_comm->get_trainer_comm());
-      m_recv_data_ids[ss] = index;
+      x.recv_data_ids[ss] = index;
       ++ss;
     }
   }
 
   // sanity checks
-  if (ss != m_recv_buffer.size()) {
-    LBANN_ERROR("ss != m_recv_buffer.size; ss: ",
+  if (ss != x.recv_buffer.size()) {
+    LBANN_ERROR("ss != x.recv_buffer.size; ss: ",
                 ss,
-                " m_recv_buffer.size: ",
-                m_recv_buffer.size());
+                " x.recv_buffer.size: ",
+                x.recv_buffer.size());
   }
-  if (m_recv_requests.size() != m_recv_buffer.size()) {
-    LBANN_ERROR("m_recv_requests.size != m_recv_buffer.size; m_recv_requests: ",
-                m_recv_requests.size(),
-                " m_recv_buffer.size: ",
-                m_recv_buffer.size());
+  if (x.recv_requests.size() != x.recv_buffer.size()) {
+    LBANN_ERROR("x.recv_requests.size != x.recv_buffer.size; recv_requests: ",
+                x.recv_requests.size(),
+                " x.recv_buffer.size: ",
+                x.recv_buffer.size());
   }
 
   m_start_snd_rcv_time += (get_time() - tm5);
@@ -706,10 +916,16 @@ void data_store_conduit::start_exchange_data_by_sample(size_t current_pos,
 
 void data_store_conduit::finish_exchange_data_by_sample()
 {
+  if (m_exchanges_in_flight.empty()) {
+    LBANN_ERROR("there is no exchange in flight to finish; role: ",
+                m_reader->get_role());
+  }
+  exchange_state& x = m_exchanges_in_flight.front();
+
   // wait for all msgs to complete
   double tm5 = get_time();
-  m_comm->wait_all(m_send_requests);
-  m_comm->wait_all(m_recv_requests);
+  m_comm->wait_all(x.send_requests);
+  m_comm->wait_all(x.recv_requests);
   m_comm->trainer_barrier();
   m_wait_all_time += (get_time() - tm5);
 
@@ -717,23 +933,38 @@ void data_store_conduit::finish_exchange_data_by_sample()
   // part 3: construct the Nodes needed by me for the current minibatch
 
   tm5 = get_time();
-  conduit::Node nd;
   m_minibatch_data.clear();
-  for (size_t j = 0; j < m_recv_buffer.size(); j++) {
-    conduit::uint8* n_buff_ptr = (conduit::uint8*)m_recv_buffer[j].data_ptr();
-    conduit::Node n_msg;
-    n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
-    n_buff_ptr += 8;
-    n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
-    conduit::Schema rcv_schema;
-    conduit::Generator gen(n_msg["schema"].as_char8_str());
-    gen.walk(rcv_schema);
-    n_buff_ptr += n_msg["schema"].total_bytes_compact();
-    n_msg["data"].set_external(rcv_schema, n_buff_ptr);
-
-    int data_id = m_recv_data_ids[j];
-    m_minibatch_data[data_id].set_external(n_msg["data"]);
+  if (x.is_packed) {
+    finish_exchange_packed_data(x);
+  }
+  else if (m_compress) {
+    const int n = x.recv_buffer.size();
+    x.decompressed.resize(n);
+    int num_failed = 0;
+    LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : num_failed))
+    for (int j = 0; j < n; j++) {
+      if (!decompress_packed_node(x.recv_buffer[j], x.decompressed[j])) {
+        ++num_failed;
+      }
+    }
+    if (num_failed != 0) {
+      LBANN_ERROR("failed to inflate ", num_failed, " received samples");
+    }
+    for (int j = 0; j < n; j++) {
+      unpack_sample((conduit::uint8*)x.decompressed[j].data(),
+                    m_minibatch_data[x.recv_data_ids[j]]);
+    }
   }
+  else {
+    for (size_t j = 0; j < x.recv_buffer.size(); j++) {
+      int data_id = x.recv_data_ids[j];
+      unpack_sample((conduit::uint8*)x.recv_buffer[j].data_ptr(),
+                    m_minibatch_data[data_id]);
+    }
+  }
+  // m_minibatch_data views x's receive buffers; keep them alive
+  m_finished_exchange = std::move(x);
+  m_exchanges_in_flight.pop_front();
   m_rebuild_time += (get_time() - tm5);
 
   if (m_spill) {
@@ -742,6 +973,180 @@ void data_store_conduit::finish_exchange_data_by_sample()
   }
 }
 
+void data_store_conduit::compress_packed_node(const conduit::Node& packed,
+                                              std::vector<El::byte>& out)
+{
+  const conduit::int64 len = packed.total_bytes_compact();
+  uLongf zlen = compressBound(len);
+  out.resize(sizeof(conduit::int64) + zlen);
+  std::memcpy(out.data(), &len, sizeof(conduit::int64));
+  int rc = compress2(reinterpret_cast<Bytef*>(out.data()) +
+                       sizeof(conduit::int64),
+                     &zlen,
+                     static_cast<const Bytef*>(packed.contiguous_data_ptr()),
+                     len,
+                     Z_BEST_SPEED);
+  if (rc != Z_OK) {
+    LBANN_ERROR("zlib compress2 failed with code ", rc);
+  }
+  out.resize(sizeof(conduit::int64) + zlen);
+}
+
+bool data_store_conduit::decompress_packed_node(const conduit::Node& in,
+                                                std::vector<El::byte>& out)
+{
+  const size_t in_len = in.dtype().number_of_elements();
+  if (in_len < sizeof(conduit::int64)) {
+    return false;
+  }
+  const Bytef* p = static_cast<const Bytef*>(in.data_ptr());
+  conduit::int64 len;
+  std::memcpy(&len, p, sizeof(conduit::int64));
+  out.resize(len);
+  uLongf out_len = len;
+  int rc = uncompress(reinterpret_cast<Bytef*>(out.data()),
+                      &out_len,
+                      p + sizeof(conduit::int64),
+                      in_len - sizeof(conduit::int64));
+  return rc == Z_OK && out_len == static_cast<uLongf>(len);
+}
+
+void data_store_conduit::unpack_sample(const conduit::uint8* buf,
+                                       conduit::Node& node)
+{
+  conduit::uint8* n_buff_ptr = const_cast<conduit::uint8*>(buf);
+  conduit::Node n_msg;
+  n_msg["schema_len"].set_external((conduit::int64*)n_buff_ptr);
+  n_buff_ptr += 8;
+  n_msg["schema"].set_external_char8_str((char*)(n_buff_ptr));
+  conduit::Schema rcv_schema;
+  conduit::Generator gen(n_msg["schema"].as_char8_str());
+  gen.walk(rcv_schema);
+  n_buff_ptr += n_msg["schema"].total_bytes_compact();
+  n_msg["data"].set_external(rcv_schema, n_buff_ptr);
+  node.set_external(n_msg["data"]);
+}
+
+bool data_store_conduit::use_packed_exchange(size_t mb_size) const
+{
+  if (m_node_sizes_vary) {
+    return false;
+  }
+  // a peer receives at most mb_size samples per exchange
+  return get_packed_msg_size(mb_size) <= static_cast<size_t>(INT_MAX);
+}
+
+size_t data_store_conduit::get_packed_msg_size(size_t n) const
+{
+  return sizeof(conduit::int64) * (n + 1) + n * m_compacted_sample_size;
+}
+
+void data_store_conduit::discard_exchanges_in_flight()
+{
+  for (auto& x : m_exchanges_in_flight) {
+    m_comm->wait_all(x.send_requests);
+    m_comm->wait_all(x.recv_requests);
+  }
+  m_exchanges_in_flight.clear();
+}
+
+void data_store_conduit::start_exchange_packed_data(exchange_state& x)
+{
+  const size_t sz = m_compacted_sample_size;
+  const size_t header_len = sizeof(conduit::int64);
+
+  size_t num_send_msgs = 0;
+  size_t num_recv_msgs = 0;
+  for (int p = 0; p < m_np_in_trainer; p++) {
+    num_send_msgs += (m_indices_to_send[p].empty() ? 0 : 1);
+    num_recv_msgs += (m_indices_to_recv[p].empty() ? 0 : 1);
+  }
+  x.send_requests.resize(num_send_msgs);
+  x.recv_requests.resize(num_recv_msgs);
+  x.packed_send_buffers.resize(m_np_in_trainer);
+  x.packed_recv_buffers.resize(m_np_in_trainer);
+  x.indices_to_recv = m_indices_to_recv;
+
+  // post recvs first, so that incoming messages land directly in place
+  size_t ss = 0;
+  for (int p = 0; p < m_np_in_trainer; p++) {
+    const size_t n = m_indices_to_recv[p].size();
+    if (n == 0) {
+      continue;
+    }
+    std::vector<El::byte>& buf = x.packed_recv_buffers[p];
+    buf.resize(get_packed_msg_size(n));
+    m_comm->nb_tagged_recv<El::byte>(buf.data(),
+                                     buf.size(),
+                                     p,
+                                     m_packed_exchange_tag,
+                                     x.recv_requests[ss++],
+                                     m_comm->get_trainer_comm());
+  }
+
+  // pack and send outgoing data
+  ss = 0;
+  for (int p = 0; p < m_np_in_trainer; p++) {
+    const std::unordered_set<int>& indices = m_indices_to_send[p];
+    const size_t n = indices.size();
+    if (n == 0) {
+      continue;
+    }
+    std::vector<El::byte>& buf = x.packed_send_buffers[p];
+    buf.resize(get_packed_msg_size(n));
+    conduit::int64* header = reinterpret_cast<conduit::int64*>(buf.data());
+    El::byte* samples = buf.data() + header_len * (n + 1);
+    header[0] = n;
+    size_t k = 0;
+    for (auto index : indices) {
+      header[k + 1] = index;
+      std::memcpy(samples + k * sz, get_packed_sample_ptr(index), sz);
+      ++k;
+    }
+    m_comm->nb_tagged_send<El::byte>(buf.data(),
+                                     buf.size(),
+                                     p,
+                                     m_packed_exchange_tag,
+                                     x.send_requests[ss++],
+                                     m_comm->get_trainer_comm());
+  }
+}
+
+void data_store_conduit::finish_exchange_packed_data(exchange_state& x)
+{
+  const size_t sz = m_compacted_sample_size;
+  const size_t header_len = sizeof(conduit::int64);
+  for (int p = 0; p < m_np_in_trainer; p++) {
+    const std::unordered_set<int>& indices = x.indices_to_recv[p];
+    const size_t n = indices.size();
+    if (n == 0) {
+      continue;
+    }
+    const std::vector<El::byte>& buf = x.packed_recv_buffers[p];
+    const conduit::int64* header =
+      reinterpret_cast<const conduit::int64*>(buf.data());
+    if (static_cast<size_t>(header[0]) != n) {
+      LBANN_ERROR("packed message from P_",
+                  p,
+                  " contains ",
+                  header[0],
+                  " samples, but ",
+                  n,
+                  " were expected; role: ",
+                  m_reader->get_role());
+    }
+    const El::byte* samples = buf.data() + header_len * (n + 1);
+    for (size_t k = 0; k < n; ++k) {
+      const int data_id = header[k + 1];
+      if (indices.find(data_id) == indices.end()) {
+        LBANN_ERROR("received unexpected data_id: ", data_id, " from P_", p);
+      }
+      unpack_sample(reinterpret_cast<const conduit::uint8*>(samples + k * sz),
+                    m_minibatch_data[data_id]);
+    }
+  }
+}
+
 int data_store_conduit::build_indices_i_will_recv(int current_pos, int mb_size)
 {
   m_indices_to_recv.clear();
@@ -749,16 +1154,13 @@ int data_store_conduit::build_indices_i_will_recv(int current_pos, int mb_size)
   int k = 0;
   for (int i = current_pos; i < current_pos + mb_size; ++i) {
     auto index = (*m_shuffled_indices)[i];
-#ifdef LBANN_HAS_DISTCONV
-    int num_ranks_in_partition = dc::get_number_of_io_partitions();
-#else
-    int num_ranks_in_partition = 1;
-#endif // LBANN_HAS_DISTCONV
-    if ((((i % m_owner_map_mb_size) % m_num_partitions_in_trainer) *
-           num_ranks_in_partition +
-         m_offset_in_partition) == m_rank_in_trainer) {
+    if (get_consumer_rank(i) == m_rank_in_trainer) {
       auto key = std::make_pair(index, m_offset_in_partition);
       int owner = m_owner[key];
+      if (owner < 0) {
+        // not cached; the reader loads it from file
+        continue;
+      }
       m_indices_to_recv[owner].insert(index);
       k++;
     }
@@ -788,16 +1190,7 @@ int data_store_conduit::build_indices_i_will_send(int current_pos, int mb_size)
       is_mine = true;
     }
     if (is_mine) {
-#ifdef LBANN_HAS_DISTCONV
-      int num_ranks_in_partition = dc::get_number_of_io_partitions();
-#else
-      int num_ranks_in_partition = 1;
-#endif // LBANN_HAS_DISTCONV
-      m_indices_to_send[(((i % m_owner_map_mb_size) %
-                          m_num_partitions_in_trainer) *
-                           num_ranks_in_partition +
-                         m_offset_in_partition)]
-        .insert(index);
+      m_indices_to_send[get_consumer_rank(i)].insert(index);
 
       // Sanity check
       auto key = std::make_pair(index, m_offset_in_partition);
@@ -817,6 +1210,18 @@ int data_store_conduit::build_indices_i_will_send(int current_pos, int mb_size)
   return k;
 }
 
+int data_store_conduit::get_consumer_rank(int pos) const
+{
+#ifdef LBANN_HAS_DISTCONV
+  int num_ranks_in_partition = dc::get_number_of_io_partitions();
+#else
+  int num_ranks_in_partition = 1;
+#endif // LBANN_HAS_DISTCONV
+  return ((pos % m_owner_map_mb_size) % m_num_partitions_in_trainer) *
+           num_ranks_in_partition +
+         m_offset_in_partition;
+}
+
 void data_store_conduit::build_preloaded_owner_map(
   const std::vector<int>& per_rank_list_sizes)
 {
@@ -833,10 +1238,116 @@ void data_store_conduit::build_preloaded_owner_map(
     auto key = std::make_pair((*m_shuffled_indices)[i], m_offset_in_partition);
     m_owner[key] = owning_rank;
   }
+  if (m_rank_in_trainer < static_cast<int>(per_rank_list_sizes.size())) {
+    m_arena_expected_num_samples = per_rank_list_sizes[m_rank_in_trainer];
+  }
   PROFILE("build_preloaded_owner_map; m_owner_maps_were_exchanged = true");
   m_owner_maps_were_exchanged = true;
 }
 
+void data_store_conduit::localize_shuffled_indices(std::vector<int>& indices)
+{
+  if (!m_locality_aware || !m_owner_maps_were_exchanged || is_local_cache() ||
+      m_owner_map_mb_size <= 0) {
+    return;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  // consumer ranks then depend on the I/O partition, so ranks would not
+  // agree on a single permutation
+  if (dc::get_number_of_io_partitions() > 1) {
+    return;
+  }
+#endif // LBANN_HAS_DISTCONV
+  double tm1 = get_time();
+
+  // node-local fallback needs to know which ranks share a node; every
+  // rank in the trainer reaches this point with the same state
+  setup_node_local_comms();
+  std::unordered_map<int, std::vector<int>> ranks_on_node;
+  for (int p = 0; p < m_np_in_trainer; p++) {
+    ranks_on_node[m_node_leader_of_rank[p]].push_back(p);
+  }
+
+  const size_t n = indices.size();
+  const size_t window = m_owner_map_mb_size;
+  size_t num_local = 0;
+  size_t num_node_local = 0;
+  std::vector<std::vector<size_t>> free_slots(m_np_in_trainer);
+  std::vector<int> placed(window);
+  std::vector<bool> is_placed(window);
+  for (size_t start = 0; start < n; start += window) {
+    const size_t len = std::min(window, n - start);
+    for (auto& t : free_slots) {
+      t.clear();
+    }
+    // slots are handed out from the back, so push them in reverse to keep
+    // the shuffled order of the slots each rank consumes
+    for (size_t j = len; j-- > 0;) {
+      free_slots[get_consumer_rank(start + j)].push_back(j);
+    }
+    std::fill(is_placed.begin(), is_placed.end(), false);
+
+    // the tail of the (already shuffled) window keeps its random placement
+    const size_t num_to_localize =
+      len - static_cast<size_t>(m_locality_randomness * len);
+    std::vector<int> leftovers;
+    for (size_t j = 0; j < len; j++) {
+      const int index = indices[start + j];
+      int owner = -1;
+      if (j < num_to_localize) {
+        auto t = m_owner.find(std::make_pair(index, m_offset_in_partition));
+        if (t != m_owner.end()) {
+          owner = t->second;
+        }
+      }
+      if (owner >= 0 && !free_slots[owner].empty()) {
+        const size_t slot = free_slots[owner].back();
+        free_slots[owner].pop_back();
+        placed[slot] = index;
+        is_placed[slot] = true;
+        ++num_local;
+        continue;
+      }
+      if (owner >= 0) {
+        bool found = false;
+        for (int p : ranks_on_node[m_node_leader_of_rank[owner]]) {
+          if (!free_slots[p].empty()) {
+            const size_t slot = free_slots[p].back();
+            free_slots[p].pop_back();
+            placed[slot] = index;
+            is_placed[slot] = true;
+            ++num_node_local;
+            found = true;
+            break;
+          }
+        }
+        if (found) {
+          continue;
+        }
+      }
+      leftovers.push_back(index);
+    }
+
+    // whatever could not be localized fills the remaining slots in order
+    size_t k = 0;
+    for (size_t j = 0; j < len; j++) {
+      if (!is_placed[j]) {
+        placed[j] = leftovers[k++];
+      }
+    }
+    std::copy(placed.begin(), placed.begin() + len, indices.begin() + start);
+  }
+
+  PROFILE("localize_shuffled_indices; samples consumed by owner: ",
+          num_local,
+          " by a rank on the owner's node: ",
+          num_node_local,
+          " of ",
+          n,
+          "; time: ",
+          get_time() - tm1);
+}
+
 const conduit::Node& data_store_conduit::get_random_node() const
 {
   size_t sz = m_data.size();
@@ -1152,6 +1663,9 @@ void data_store_conduit::set_is_explicitly_loading(bool flag)
 void data_store_conduit::set_loading_is_complete()
 {
   PROFILE("set_loading_is_complete()");
+  if (m_mem_budget_per_rank > 0 && is_preloading()) {
+    finalize_partial_cache();
+  }
   m_loading_is_complete = true;
   set_is_preloading(false);
   set_is_explicitly_loading(false);
@@ -1162,6 +1676,36 @@ void data_store_conduit::set_loading_is_complete()
   }
 }
 
+void data_store_conduit::finalize_partial_cache()
+{
+  std::vector<int> counts(m_np_in_trainer);
+  m_comm->all_gather(static_cast<int>(m_dropped_samples.size()),
+                     counts,
+                     m_comm->get_trainer_comm());
+  std::vector<int> displs(m_np_in_trainer, 0);
+  for (int p = 1; p < m_np_in_trainer; p++) {
+    displs[p] = displs[p - 1] + counts[p - 1];
+  }
+  std::vector<int> dropped(displs.back() + counts.back());
+  m_comm->all_gather(m_dropped_samples,
+                     dropped,
+                     counts,
+                     displs,
+                     m_comm->get_trainer_comm());
+
+  for (int id : dropped) {
+    m_owner[std::make_pair(id, m_offset_in_partition)] = -1;
+    m_uncached.insert(id);
+  }
+  m_dropped_samples.clear();
+  PROFILE("memory budget per rank: ",
+          m_mem_budget_per_rank,
+          " bytes; cached: ",
+          m_cached_bytes,
+          " bytes; samples left to the reader: ",
+          m_uncached.size());
+}
+
 bool data_store_conduit::is_fully_loaded() const
 {
   if (m_loading_is_complete) {
@@ -1257,6 +1801,21 @@ void data_store_conduit::compute_image_offsets(
   std::vector<std::vector<int>>& indices)
 {
   size_t offset = 0;
+  if (m_share_cache_across_trainers) {
+    // Trainers shuffle differently, so a shared segment is laid out
+    // by sample id
+    std::vector<int> ids;
+    ids.reserve(sizes.size());
+    for (auto&& t : sizes) {
+      ids.push_back(t.first);
+    }
+    std::sort(ids.begin(), ids.end());
+    for (auto idx : ids) {
+      m_image_offsets[idx] = offset;
+      offset += sizes[idx];
+    }
+    return;
+  }
   for (size_t p = 0; p < indices.size(); p++) {
     for (auto idx : indices[p]) {
       if (sizes.find(idx) == sizes.end()) {
@@ -1269,6 +1828,55 @@ void data_store_conduit::compute_image_offsets(
   }
 }
 
+void data_store_conduit::setup_node_local_comms()
+{
+  if (m_have_node_local_comms) {
+    return;
+  }
+
+  // The node communicator may contain ranks from several trainers;
+  // the segment is shared only by ranks of this trainer
+  El::mpi::Split(m_comm->get_node_comm(),
+                 m_comm->get_trainer_rank(),
+                 m_comm->get_rank_in_node(),
+                 m_trainer_node_comm);
+  m_rank_in_trainer_node = El::mpi::Rank(m_trainer_node_comm);
+
+  const bool is_leader = (m_rank_in_trainer_node == 0);
+  El::mpi::Split(m_comm->get_trainer_comm(),
+                 is_leader ? 0 : 1,
+                 m_rank_in_trainer,
+                 m_node_leaders_comm);
+  m_have_node_local_comms = true;
+
+  // every rank learns which leader speaks for its node ...
+  int my_leader = is_leader ? El::mpi::Rank(m_node_leaders_comm) : -1;
+  m_comm->broadcast<int>(0, &my_leader, 1, m_trainer_node_comm);
+
+  // ... and for every other rank in the trainer
+  m_node_leader_of_rank.resize(m_np_in_trainer);
+  m_comm->all_gather(&my_leader,
+                     1,
+                     m_node_leader_of_rank.data(),
+                     1,
+                     m_comm->get_trainer_comm());
+
+  if (m_share_cache_across_trainers) {
+    // A trainer within a node needs no exchange between nodes, so the
+    // trainer of the node's first rank can fill the segment alone
+    const auto& node_comm = m_comm->get_node_comm();
+    const int in_node =
+      (El::mpi::Size(m_trainer_node_comm) == m_np_in_trainer);
+    if (m_comm->allreduce(in_node, node_comm, El::mpi::MIN) == 0) {
+      LBANN_ERROR("--data_store_cache_shared requires every trainer to fit "
+                  "in a node");
+    }
+    int writer = m_comm->get_trainer_rank();
+    m_comm->broadcast<int>(0, &writer, 1, node_comm);
+    m_is_cache_writer = (writer == m_comm->get_trainer_rank());
+  }
+}
+
 void data_store_conduit::allocate_shared_segment(
   map_is_t& sizes,
   std::vector<std::vector<int>>& indices)
@@ -1302,55 +1910,65 @@ void data_store_conduit::allocate_shared_segment(
     LBANN_ERROR("insufficient available memory:\n", msg.str());
   }
 
-  // need to ensure name is unique across all data readers
-  m_seg_name = "/our_town_" + m_reader->get_role();
-
-  // in case a previous run was aborted, attempt to remove the file, which
-  // may or may not exist
-  shm_unlink(m_seg_name.c_str());
-  int node_id = m_comm->get_rank_in_node();
-  if (node_id == 0) {
-    std::remove(m_seg_name.c_str());
-  }
-  m_comm->trainer_barrier();
+  setup_node_local_comms();
+  const auto& seg_comm = (m_share_cache_across_trainers
+                            ? m_comm->get_node_comm()
+                            : m_trainer_node_comm);
+  const bool is_leader = (El::mpi::Rank(seg_comm) == 0);
+
+  if (m_share_cache_across_trainers) {
+    // Trainers that share the segment must cache the same samples
+    uint64_t fingerprint = 0;
+    for (auto&& t : sizes) {
+      uint64_t z = (static_cast<uint64_t>(t.first) << 32) ^ t.second;
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+      fingerprint += z ^ (z >> 31);
+    }
+    uint64_t leader_fingerprint = fingerprint;
+    m_comm->broadcast<uint64_t>(0, &leader_fingerprint, 1, seg_comm);
+    const int same = (leader_fingerprint == fingerprint);
+    if (m_comm->allreduce(same, seg_comm, El::mpi::MIN) == 0) {
+      LBANN_ERROR("--data_store_cache_shared requires the trainers on a "
+                  "node to read the same ",
+                  m_reader->get_role(),
+                  " data set");
+    }
+  }
+
+  // need to ensure name is unique across all data readers, trainers,
+  // and jobs that share the node; the leader's pid disambiguates jobs
+  int leader_pid = getpid();
+  m_comm->broadcast<int>(0, &leader_pid, 1, seg_comm);
+  m_seg_name = "/lbann_data_store_" + m_reader->get_role() + "_" +
+               (m_share_cache_across_trainers
+                  ? std::string("node")
+                  : std::to_string(m_comm->get_trainer_rank())) +
+               "_" + std::to_string(leader_pid);
 
   int shm_fd = -1;
 
-  if (node_id == 0) {
-    shm_fd = shm_open(m_seg_name.c_str(), O_CREAT | O_RDWR | O_EXCL, 0666);
+  // Every local rank maps the segment for writing while loading, since
+  // each rank copies the samples it reads directly into the segment;
+  // the mapping is made read-only once loading is complete
+  if (is_leader) {
+    shm_fd = shm_open(m_seg_name.c_str(), O_CREAT | O_RDWR | O_EXCL, 0600);
     if (shm_fd == -1) {
-      LBANN_ERROR("shm_open failed");
+      LBANN_ERROR("shm_open failed for filename: ", m_seg_name);
     }
     int v = ftruncate(shm_fd, size);
     if (v != 0) {
       LBANN_ERROR("ftruncate failed for size: ", size);
     }
-    void* m = mmap(0, size, PROT_WRITE | PROT_READ, MAP_SHARED, shm_fd, 0);
-    if (m == MAP_FAILED) {
-      LBANN_ERROR("mmap failed");
-    }
-    m_mem_seg = reinterpret_cast<char*>(m);
-    std::fill_n(m_mem_seg, m_mem_seg_length, 1);
-    int sanity =
-      msync(static_cast<void*>(m_mem_seg), m_mem_seg_length, MS_SYNC);
-    if (sanity != 0) {
-      LBANN_ERROR("msync failed");
-    }
   }
 
-  m_comm->barrier(m_comm->get_node_comm());
+  m_comm->barrier(seg_comm);
 
-  if (node_id != 0) {
-    shm_fd = shm_open(m_seg_name.c_str(), O_RDONLY, 0666);
+  if (!is_leader) {
+    shm_fd = shm_open(m_seg_name.c_str(), O_RDWR, 0600);
     if (shm_fd == -1) {
       LBANN_ERROR("shm_open failed for filename: ", m_seg_name);
     }
-    void* m = mmap(0, size, PROT_READ, MAP_SHARED, shm_fd, 0);
-    if (m == MAP_FAILED) {
-      LBANN_ERROR("mmap failed");
-    }
-    m_mem_seg = reinterpret_cast<char*>(m);
-
     struct stat b;
     int sanity = fstat(shm_fd, &b);
     if (sanity == -1) {
@@ -1360,7 +1978,21 @@ void data_store_conduit::allocate_shared_segment(
       LBANN_ERROR("b.st_size= ", b.st_size, " should be equal to ", size);
     }
   }
+
+  void* m = mmap(0, size, PROT_WRITE | PROT_READ, MAP_SHARED, shm_fd, 0);
+  if (m == MAP_FAILED) {
+    LBANN_ERROR("mmap failed");
+  }
+  m_mem_seg = reinterpret_cast<char*>(m);
   close(shm_fd);
+
+  // Once every local rank has mapped the segment the name is no longer
+  // needed; unlinking now ensures the segment is reclaimed even if the
+  // job is aborted
+  m_comm->barrier(seg_comm);
+  if (is_leader) {
+    shm_unlink(m_seg_name.c_str());
+  }
 }
 
 void data_store_conduit::preload_local_cache() { exchange_local_caches(); }
@@ -1385,21 +2017,27 @@ void data_store_conduit::exchange_local_caches()
   allocate_shared_segment(m_sample_sizes, indices);
   PROFILE("  allocate_shared_segment time: ", (get_time() - tm1));
 
-  std::vector<char> work;
-  if (!is_explicitly_loading()) {
-    tm1 = get_time();
-    read_files(work, m_sample_sizes, indices[m_rank_in_trainer]);
-    PROFILE("  read_files time: ", (get_time() - tm1));
-  }
-
   tm1 = get_time();
   compute_image_offsets(m_sample_sizes, indices);
   PROFILE("  compute_image_offsets time: ", (get_time() - tm1));
 
+  if (!is_explicitly_loading() && m_is_cache_writer) {
+    tm1 = get_time();
+    read_files(m_sample_sizes, indices[m_rank_in_trainer]);
+    PROFILE("  read_files time: ", (get_time() - tm1));
+  }
+
   tm1 = get_time();
-  exchange_images(work, m_sample_sizes, indices);
+  exchange_images(m_sample_sizes, indices);
   PROFILE("  exchange_images time: ", (get_time() - tm1));
 
+  // the cache is complete; local ranks only ever read from it hereafter
+  if (mprotect(reinterpret_cast<void*>(m_mem_seg),
+               m_mem_seg_length,
+               PROT_READ) != 0) {
+    LBANN_ERROR("mprotect failed for the shared segment: ", m_seg_name);
+  }
+
   tm1 = get_time();
   build_conduit_nodes(m_sample_sizes);
   PROFILE("  build_conduit_nodes time: ", (get_time() - tm1));
@@ -1412,24 +2050,13 @@ void data_store_conduit::exchange_local_caches()
   }
 }
 
-void data_store_conduit::read_files(std::vector<char>& work,
-                                    map_is_t& sizes,
-                                    std::vector<int>& indices)
+void data_store_conduit::read_files(map_is_t& sizes, std::vector<int>& indices)
 {
-
-  // reserve space for reading this proc's files into a contiguous memory space
-  size_t n = 0;
-  for (size_t j = 0; j < indices.size(); ++j) {
-    n += sizes[indices[j]];
-  }
-  work.resize(n);
-
   // get the list of images from the data reader
   image_data_reader* image_reader = dynamic_cast<image_data_reader*>(m_reader);
   const auto& sample_list = image_reader->get_sample_list();
 
-  // read the images
-  size_t offset = 0;
+  // read the images directly into their final location in the segment
   PROFILE("  my num files: ", indices.size());
   for (size_t j = 0; j < indices.size(); ++j) {
     int idx = indices[j];
@@ -1438,9 +2065,11 @@ void data_store_conduit::read_files(std::vector<char>& work,
     const std::string fn = m_reader->get_file_dir() + '/' +
                            sample_list.get_samples_filename(file_id);
     std::ifstream in(fn, std::ios::in | std::ios::binary);
-    in.read(work.data() + offset, s);
+    if (!in) {
+      LBANN_ERROR("failed to open ", fn, " for reading");
+    }
+    in.read(m_mem_seg + m_image_offsets[idx], s);
     in.close();
-    offset += s;
   }
 }
 
@@ -1469,118 +2098,65 @@ void data_store_conduit::build_conduit_nodes(map_is_t& sizes)
   }
 }
 
-void data_store_conduit::fillin_shared_images(char* images,
-                                              size_t size,
-                                              size_t offset)
-{
-  PROFILE("  fillin_shared_images; size: ",
-          utils::commify(size),
-          " offset: ",
-          utils::commify(offset));
-  memcpy(reinterpret_cast<void*>(m_mem_seg + offset),
-         reinterpret_cast<const void*>(images),
-         size);
-}
-
-void data_store_conduit::exchange_images(std::vector<char>& work,
-                                         map_is_t& image_sizes,
+void data_store_conduit::exchange_images(map_is_t& image_sizes,
                                          std::vector<std::vector<int>>& indices)
 {
-
-  // If explicitly loading we need to build "work" (the vector to be broadcast);
-  // if preloading, this has already been built in read_files()
-  if (is_explicitly_loading()) {
-    if (work.size() != 0) {
-      LBANN_ERROR("work.size() != 0, but it should be");
-    }
-
-    // Compute the required buffer size
-    size_t n = 0;
-    for (const auto& t : m_data) {
-      int data_id = t.first;
-      size_t sz = t.second[LBANN_DATA_ID_STR(data_id) + "/buffer_size"].value();
-      n += sz;
-    }
-    work.resize(n);
-    PROFILE("  size required for my work buffer: ", work.size());
-
-    // Copy the images into the work vector
-    size_t offset2 = 0;
+  // If explicitly loading, the images are in m_data and must be copied
+  // into the segment; if preloading, read_files() has already put them there
+  if (is_explicitly_loading() && m_is_cache_writer) {
     for (const auto& t : m_data) {
       int data_id = t.first;
       const conduit::Node& node = t.second;
       const char* buf = node[LBANN_DATA_ID_STR(data_id) + "/buffer"].value();
       size_t sz = node[LBANN_DATA_ID_STR(data_id) + "/buffer_size"].value();
-      memcpy(work.data() + offset2, reinterpret_cast<const void*>(buf), sz);
-      offset2 += sz;
-      if (offset2 > work.size()) {
-        LBANN_ERROR("offset >= work.size(); offset: ",
-                    offset2,
-                    " work.size(): ",
-                    work.size(),
-                    " sz: ",
-                    sz);
+      if (m_image_offsets.find(data_id) == m_image_offsets.end()) {
+        LBANN_ERROR("m_image_offsets.find(data_id) == m_image_offsets.end() "
+                    "for data_id: ",
+                    data_id);
       }
-    }
-  }
-
-  int node_rank = m_comm->get_rank_in_node();
-  std::vector<char> work2;
-  size_t offset = 0;
-  for (int p = 0; p < m_np_in_trainer; p++) {
-    // Count the number of bytes to be broadcast by P_p
-    size_t bytes = 0;
-    for (auto idx : indices[p]) {
-      bytes += image_sizes[idx];
-    }
-    // PROFILE("  \nP_", p, " has ", utils::commify(bytes), " bytes to bcast");
-
-    // Set up the rounds; due to MPI yuckiness, can bcast at most INT_MAX bytes
-    // in a single broadcast
-    std::vector<int> rounds;
-    int n = bytes / INT_MAX;
-    if (n < 0) {
-      LBANN_ERROR(
-        "(n < 0; that shouldn't be possible; please contact Dave Hysom");
-    }
-    for (int k = 0; k < n; k++) {
-      rounds.push_back(INT_MAX);
-    }
-    int remainder = bytes - (n * INT_MAX);
-    rounds.push_back(remainder);
-
-    /*
-    PROFILE("  rounds: ");
-    for (auto t : rounds) {
-      PROFILE("    ", t);
-    }
-    */
-
-    // Broadcast the rounds of data
-    int work_vector_offset = 0;
-    for (size_t i = 0; i < rounds.size(); i++) {
-      int sz = rounds[i];
-      // PROFILE("  bcasting ", utils::commify(sz), " bytes");
-      if (m_rank_in_trainer == p) {
-        m_comm->trainer_broadcast<char>(p,
-                                        work.data() + work_vector_offset,
-                                        sz);
-        if (node_rank == 0) {
-          fillin_shared_images(work.data() + work_vector_offset, sz, offset);
-        }
+      memcpy(m_mem_seg + m_image_offsets[data_id],
+             reinterpret_cast<const void*>(buf),
+             sz);
+    }
+  }
+  m_comm->barrier(m_trainer_node_comm);
+
+  // At this point each node's segment holds the images read by the ranks
+  // on that node. Node leaders exchange the remainder, broadcasting
+  // directly from and into their segments; P_p's images occupy a
+  // contiguous region, since compute_image_offsets() lays them out in
+  // rank order
+  if (m_rank_in_trainer_node == 0 && El::mpi::Size(m_node_leaders_comm) > 1) {
+    size_t offset = 0;
+    for (int p = 0; p < m_np_in_trainer; p++) {
+      // Count the number of bytes to be broadcast from P_p's node
+      size_t bytes = 0;
+      for (auto idx : indices[p]) {
+        bytes += image_sizes[idx];
       }
-      else {
-        work2.resize(sz);
-        m_comm->trainer_broadcast<char>(p, work2.data(), sz);
-        if (node_rank == 0) {
-          fillin_shared_images(work2.data(), sz, offset);
-        }
+      const int root = m_node_leader_of_rank[p];
+
+      // due to MPI yuckiness, can bcast at most INT_MAX bytes
+      // in a single broadcast
+      size_t sent = 0;
+      while (sent < bytes) {
+        const size_t remaining = bytes - sent;
+        const int sz =
+          static_cast<int>(std::min(remaining, static_cast<size_t>(INT_MAX)));
+        m_comm->broadcast<char>(root,
+                                m_mem_seg + offset + sent,
+                                sz,
+                                m_node_leaders_comm);
+        sent += sz;
       }
-      work_vector_offset += sz;
-      offset += sz;
+      offset += bytes;
     }
   }
-  m_comm->barrier(m_comm->get_node_comm());
+  m_comm->barrier(m_trainer_node_comm);
+  // The other trainers of the node wait for the one filling the cache
+  if (m_share_cache_across_trainers) {
+    m_comm->barrier(m_comm->get_node_comm());
+  }
 }
 
 void data_store_conduit::exchange_owner_maps()
@@ -1795,8 +2371,10 @@ void data_store_conduit::profile_timing()
   }
 }
 
-void data_store_conduit::start_exchange_mini_batch_data(size_t current_pos,
-                                                        size_t mb_size)
+void data_store_conduit::start_exchange_mini_batch_data(
+  size_t current_pos,
+  size_t mb_size,
+  const std::vector<std::pair<size_t, size_t>>& upcoming)
 {
   if (is_local_cache() && is_fully_loaded()) {
     return;
@@ -1841,8 +2419,34 @@ void data_store_conduit::start_exchange_mini_batch_data(size_t current_pos,
     */
   }
 
-  start_exchange_data_by_sample(current_pos, mb_size);
+  // A prefetched exchange is only usable if every rank predicted the same
+  // schedule; otherwise drain whatever is in flight and start over
+  if (!m_exchanges_in_flight.empty() &&
+      (m_exchanges_in_flight.front().current_pos != current_pos ||
+       m_exchanges_in_flight.front().mb_size != mb_size)) {
+    PROFILE("prefetched exchange does not match position ",
+            current_pos,
+            "; discarding ",
+            m_exchanges_in_flight.size(),
+            " exchanges in flight");
+    discard_exchanges_in_flight();
+  }
+  if (m_exchanges_in_flight.empty()) {
+    start_exchange_data_by_sample(current_pos, mb_size);
+  }
+  for (const auto& mb : upcoming) {
+    if (static_cast<int>(m_exchanges_in_flight.size()) >=
+        get_exchange_lookahead()) {
+      break;
+    }
+    if (mb.first > m_exchanges_in_flight.back().current_pos) {
+      start_exchange_data_by_sample(mb.first, mb.second);
+    }
+  }
   m_mini_batch_data_exchange_started = true;
+  if (m_spill_segments) {
+    start_spill_prefetch(upcoming);
+  }
   m_exchange_time += (get_time() - tm1);
 }
 
@@ -1999,6 +2603,10 @@ void data_store_conduit::write_checkpoint(std::string dir_name)
   if (m_is_spilled) {
     return;
   }
+  if (m_compress) {
+    LBANN_ERROR("checkpointing a data store that holds compressed samples "
+                "(--data_store_compress) is not supported");
+  }
   double tm1 = get_time();
   setup_spill(dir_name);
 
@@ -2007,6 +2615,13 @@ void data_store_conduit::write_checkpoint(std::string dir_name)
 
   // save conduit Nodes
   m_metadata << get_conduit_dir() << "\n";
+  if (m_use_arena && !m_arena_ptrs.empty() &&
+      m_arena_ptrs.size() == m_data.size()) {
+    write_snapshot();
+    m_metadata.close();
+    PROFILE("time to write snapshot: ", (get_time() - tm1));
+    return;
+  }
   DEBUG_DS("m_data.size: ", m_data.size());
   for (auto t : m_data) {
     spill_conduit_node(t.second["data"], t.first);
@@ -2047,6 +2662,152 @@ void data_store_conduit::save_state()
   os.close();
 }
 
+namespace {
+constexpr conduit::int64 snapshot_magic = 0x4c424e4e44535331; // "LBNNDSS1"
+constexpr conduit::int64 snapshot_version = 1;
+constexpr size_t snapshot_header_len = 5;
+constexpr size_t snapshot_alignment = 4096;
+} // namespace
+
+std::string data_store_conduit::get_snapshot_fn() const
+{
+  return m_spill_dir_base + "/snapshot_" + m_reader->get_role() + "_" +
+         std::to_string(m_rank_in_world) + ".bin";
+}
+
+void data_store_conduit::get_packed_schema(const El::byte* buf,
+                                           conduit::Schema& s)
+{
+  const char* json =
+    reinterpret_cast<const char*>(buf + sizeof(conduit::int64));
+  conduit::Schema s_data;
+  conduit::Generator gen(json);
+  gen.walk(s_data);
+
+  // same layout as built by build_node_for_sending()
+  conduit::Schema s_msg;
+  s_msg["schema_len"].set(conduit::DataType::int64());
+  s_msg["schema"].set(conduit::DataType::char8_str(std::strlen(json) + 1));
+  s_msg["data"].set(s_data);
+  s_msg.compact_to(s);
+}
+
+void data_store_conduit::write_snapshot()
+{
+  const std::string fn = get_snapshot_fn();
+  std::ofstream out(fn, std::ios::binary);
+  if (!out) {
+    LBANN_ERROR("failed to open ", fn, " for writing");
+  }
+
+  // samples are written in arena order, so the writes below walk the
+  // slabs sequentially
+  std::vector<std::pair<El::byte*, int>> order;
+  order.reserve(m_arena_ptrs.size());
+  for (const auto& t : m_arena_ptrs) {
+    order.emplace_back(t.second, t.first);
+  }
+  std::sort(order.begin(), order.end());
+
+  const size_t n = order.size();
+  const size_t ids_end = sizeof(conduit::int64) * (snapshot_header_len + n);
+  const size_t data_offset =
+    ((ids_end + snapshot_alignment - 1) / snapshot_alignment) *
+    snapshot_alignment;
+  std::vector<conduit::int64> header = {snapshot_magic,
+                                        snapshot_version,
+                                        static_cast<conduit::int64>(n),
+                                        m_compacted_sample_size,
+                                        static_cast<conduit::int64>(
+                                          data_offset)};
+  std::vector<conduit::int64> ids(n);
+  for (size_t j = 0; j < n; j++) {
+    ids[j] = order[j].second;
+  }
+  std::vector<char> pad(data_offset - ids_end, 0);
+  out.write(reinterpret_cast<const char*>(header.data()),
+            header.size() * sizeof(conduit::int64));
+  out.write(reinterpret_cast<const char*>(ids.data()),
+            ids.size() * sizeof(conduit::int64));
+  out.write(pad.data(), pad.size());
+  for (const auto& t : order) {
+    out.write(reinterpret_cast<const char*>(t.first), m_compacted_sample_size);
+  }
+  if (!out) {
+    LBANN_ERROR("failed to write snapshot ", fn);
+  }
+  out.close();
+  PROFILE("wrote snapshot of ", n, " samples to ", fn);
+}
+
+bool data_store_conduit::load_snapshot()
+{
+  const std::string fn = get_snapshot_fn();
+  if (!file::file_exists(fn)) {
+    return false;
+  }
+  int fd = open(fn.c_str(), O_RDONLY);
+  if (fd == -1) {
+    LBANN_ERROR("failed to open ", fn, "; ", strerror(errno));
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    LBANN_ERROR("fstat failed for ", fn, "; ", strerror(errno));
+  }
+  const size_t len = st.st_size;
+  if (len < sizeof(conduit::int64) * snapshot_header_len) {
+    close(fd);
+    LBANN_ERROR(fn, " is too short to be a data store snapshot");
+  }
+
+  // MAP_PRIVATE: conduit wants non-const pointers, but nothing writes to
+  // the samples, so pages stay shared with the page cache
+  void* v = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (v == MAP_FAILED) {
+    LBANN_ERROR("failed to mmap ", fn, "; ", strerror(errno));
+  }
+  std::shared_ptr<El::byte[]> mapping(static_cast<El::byte*>(v),
+                                      [len](El::byte* p) { munmap(p, len); });
+
+  const conduit::int64* header =
+    reinterpret_cast<const conduit::int64*>(mapping.get());
+  const conduit::int64 n = header[2];
+  const conduit::int64 sample_size = header[3];
+  const conduit::int64 data_offset = header[4];
+  if (header[0] != snapshot_magic || header[1] != snapshot_version) {
+    LBANN_ERROR(fn,
+                " is not a data store snapshot of version ",
+                snapshot_version);
+  }
+  if (sample_size != m_compacted_sample_size ||
+      static_cast<size_t>(data_offset + n * sample_size) > len) {
+    LBANN_ERROR(fn,
+                " is inconsistent with the checkpointed state; sample size: ",
+                sample_size,
+                " expected: ",
+                m_compacted_sample_size);
+  }
+
+  const conduit::int64* ids = header + snapshot_header_len;
+  El::byte* data = mapping.get() + data_offset;
+  m_data.clear();
+  conduit::Schema s;
+  for (conduit::int64 j = 0; j < n; j++) {
+    El::byte* slot = data + j * sample_size;
+    get_packed_schema(slot, s);
+    m_arena_ptrs[ids[j]] = slot;
+    m_data[ids[j]].set_external(s, slot);
+  }
+  m_arena_slabs.push_back(std::move(mapping));
+  m_arena_slab_capacity.push_back(n);
+  m_arena_slab_fill = n;
+  m_use_arena = true;
+  PROFILE("mapped snapshot of ", n, " samples from ", fn);
+  return true;
+}
+
 void data_store_conduit::load_checkpoint(std::string dir_name,
                                          generic_data_reader* reader)
 {
@@ -2133,6 +2894,19 @@ void data_store_conduit::load_checkpoint(std::string dir_name,
     LBANN_ERROR("conduit_dir != base_dir (", conduit_dir, ", ", base_dir);
   }
 
+  // Nodes are reloaded as owned copies, so any arena views are stale
+  m_arena_ptrs.clear();
+  m_arena_slabs.clear();
+  m_arena_slab_capacity.clear();
+  m_arena_slab_fill = 0;
+
+  if (load_snapshot()) {
+    metadata.close();
+    m_was_loaded_from_file = true;
+    PROFILE("time to load snapshot: ", (get_time() - tm1));
+    return;
+  }
+
   // Load conduit Nodes
   std::string tmp;
   int sample_id;
@@ -2229,6 +3003,23 @@ void data_store_conduit::load_spilled_conduit_nodes()
 {
   m_data.clear();
 
+  if (m_spill_segments) {
+    // the samples needed now were prefetched during the previous step
+    if (m_spill_prefetch.valid()) {
+      m_spill_prefetch.get();
+    }
+    std::vector<El::byte> buf;
+    for (const auto& v : m_indices_to_send) {
+      for (const auto& id : v) {
+        read_spilled_sample(id, buf);
+        conduit::Node node;
+        unpack_sample(reinterpret_cast<conduit::uint8*>(buf.data()), node);
+        build_node_for_sending(node, m_data[id]);
+      }
+    }
+    return;
+  }
+
   for (const auto& v : m_indices_to_send) {
     for (const auto& id : v) {
       map_ii_t::const_iterator it = m_spilled_nodes.find(id);
@@ -2249,6 +3040,163 @@ void data_store_conduit::load_spilled_conduit_nodes()
   }
 }
 
+std::string data_store_conduit::get_spill_segment_fn(int segment) const
+{
+  return get_conduit_dir() + "/segment_" + std::to_string(segment);
+}
+
+void data_store_conduit::spill_to_segment(const conduit::Node& packed,
+                                          int data_id)
+{
+  if (!m_metadata.is_open()) {
+    LBANN_ERROR("metadata file is not open");
+  }
+  const size_t len = packed.total_bytes_compact();
+  if (m_spill_write_fd == -1 ||
+      m_spill_segment_bytes + len > m_spill_max_segment_bytes) {
+    if (m_spill_write_fd != -1) {
+      close(m_spill_write_fd);
+    }
+    ++m_spill_cur_segment;
+    const std::string fn = get_spill_segment_fn(m_spill_cur_segment);
+    m_spill_write_fd =
+      open(fn.c_str(), O_WRONLY | O_CREAT | O_APPEND, S_IRUSR | S_IWUSR);
+    if (m_spill_write_fd == -1) {
+      LBANN_ERROR("failed to open ", fn, "; ", strerror(errno));
+    }
+    m_spill_segment_bytes = 0;
+  }
+
+  const char* ptr = reinterpret_cast<const char*>(packed.data_ptr());
+  size_t written = 0;
+  while (written < len) {
+    ssize_t n = write(m_spill_write_fd, ptr + written, len - written);
+    if (n == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LBANN_ERROR("failed to write sample ",
+                  data_id,
+                  " to spill segment ",
+                  m_spill_cur_segment,
+                  "; ",
+                  strerror(errno));
+    }
+    written += n;
+  }
+
+  spill_extent& e = m_spill_index[data_id];
+  e.segment = m_spill_cur_segment;
+  e.offset = m_spill_segment_bytes;
+  e.length = len;
+  m_spill_segment_bytes += len;
+  m_spilled_nodes[data_id] = m_spill_cur_segment;
+  m_metadata << e.segment << " " << e.offset << " " << e.length << " "
+             << data_id << "\n";
+}
+
+void data_store_conduit::cache_spilled_sample(int data_id,
+                                              std::vector<El::byte>&& buf)
+{
+  std::lock_guard<std::mutex> lock(m_spill_mutex);
+  if (m_spill_cache_map.find(data_id) != m_spill_cache_map.end()) {
+    return;
+  }
+  m_spill_cache_bytes += buf.size();
+  m_spill_cache.emplace_front(data_id, std::move(buf));
+  m_spill_cache_map[data_id] = m_spill_cache.begin();
+  while (m_spill_cache_bytes > m_spill_cache_capacity &&
+         !m_spill_cache.empty()) {
+    auto& victim = m_spill_cache.back();
+    m_spill_cache_bytes -= victim.second.size();
+    m_spill_cache_map.erase(victim.first);
+    m_spill_cache.pop_back();
+  }
+}
+
+void data_store_conduit::read_spilled_sample(int data_id,
+                                             std::vector<El::byte>& buf)
+{
+  auto e = m_spill_index.find(data_id);
+  if (e == m_spill_index.end()) {
+    LBANN_ERROR("sample ", data_id, " was never spilled");
+  }
+  const spill_extent& x = e->second;
+
+  int fd;
+  {
+    std::lock_guard<std::mutex> lock(m_spill_mutex);
+    auto t = m_spill_cache_map.find(data_id);
+    if (t != m_spill_cache_map.end()) {
+      m_spill_cache.splice(m_spill_cache.begin(), m_spill_cache, t->second);
+      buf = t->second->second;
+      return;
+    }
+    if (static_cast<int>(m_spill_read_fds.size()) <= x.segment) {
+      m_spill_read_fds.resize(x.segment + 1, -1);
+    }
+    if (m_spill_read_fds[x.segment] == -1) {
+      const std::string fn = get_spill_segment_fn(x.segment);
+      m_spill_read_fds[x.segment] = open(fn.c_str(), O_RDONLY);
+      if (m_spill_read_fds[x.segment] == -1) {
+        LBANN_ERROR("failed to open ", fn, "; ", strerror(errno));
+      }
+    }
+    fd = m_spill_read_fds[x.segment];
+  }
+
+  // pread does not move a shared file offset, so several threads may
+  // read from one descriptor
+  buf.resize(x.length);
+  size_t got = 0;
+  while (got < x.length) {
+    ssize_t n = pread(fd, buf.data() + got, x.length - got, x.offset + got);
+    if (n == -1 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      LBANN_ERROR("failed to read sample ",
+                  data_id,
+                  " from spill segment ",
+                  x.segment,
+                  "; ",
+                  (n == 0 ? "unexpected end of file" : strerror(errno)));
+    }
+    got += n;
+  }
+}
+
+void data_store_conduit::start_spill_prefetch(
+  const std::vector<std::pair<size_t, size_t>>& upcoming)
+{
+  if (m_spill_prefetch.valid()) {
+    m_spill_prefetch.get();
+  }
+  std::vector<int> ids;
+  const size_t n = std::min(upcoming.size(),
+                            static_cast<size_t>(m_spill_prefetch_depth));
+  for (size_t j = 0; j < n; j++) {
+    const size_t end = std::min(upcoming[j].first + upcoming[j].second,
+                                m_shuffled_indices->size());
+    for (size_t i = upcoming[j].first; i < end; i++) {
+      const int index = (*m_shuffled_indices)[i];
+      if (m_spill_index.find(index) != m_spill_index.end()) {
+        ids.push_back(index);
+      }
+    }
+  }
+  if (ids.empty()) {
+    return;
+  }
+  m_spill_prefetch = std::async(std::launch::async, [this, ids]() {
+    for (int id : ids) {
+      std::vector<El::byte> buf;
+      read_spilled_sample(id, buf);
+      cache_spilled_sample(id, std::move(buf));
+    }
+  });
+}
+
 void data_store_conduit::open_informational_files()
 {
   auto& arg_parser = global_argument_parser();
@@ -2490,7 +3438,13 @@ void data_store_conduit::verify_sample_size()
 size_t data_store_conduit::get_mem_usage()
 {
   size_t r = 0;
+  for (size_t j = 0; j < m_arena_slabs.size(); ++j) {
+    r += m_arena_slab_capacity[j] * m_compacted_sample_size;
+  }
   for (const auto& t : m_data) {
+    if (m_arena_ptrs.find(t.first) != m_arena_ptrs.end()) {
+      continue;
+    }
     const conduit::Node& nd = t.second;
     if (!nd.is_contiguous()) {
       LBANN_ERROR("node does not have a contiguous layout");
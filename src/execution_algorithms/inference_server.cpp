@@ -0,0 +1,382 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/inference_server.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/timer.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace lbann {
+
+namespace {
+
+/** "LBIR" in little-endian byte order */
+constexpr uint32_t request_magic = 0x5249424c;
+/** Largest request payload accepted, in bytes */
+constexpr uint64_t max_request_bytes = uint64_t{1} << 30;
+
+constexpr uint32_t status_ok = 0;
+constexpr uint32_t status_bad_request = 1;
+constexpr uint32_t status_stopping = 2;
+
+bool read_all(int fd, void* data, size_t size)
+{
+  auto* ptr = static_cast<char*>(data);
+  while (size > 0) {
+    const ssize_t n = recv(fd, ptr, size, 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool write_all(int fd, const void* data, size_t size)
+{
+  const auto* ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t n = send(fd, ptr, size, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    ptr += n;
+    size -= n;
+  }
+  return true;
+}
+
+bool write_reply(int fd,
+                 uint32_t status,
+                 uint32_t num_samples,
+                 uint32_t output_size,
+                 const std::vector<float>& outputs)
+{
+  const uint32_t header[3] = {status, num_samples, output_size};
+  return (write_all(fd, header, sizeof(header)) &&
+          write_all(fd, outputs.data(), outputs.size() * sizeof(float)));
+}
+
+} // namespace
+
+inference_server::inference_server(lbann_comm* comm,
+                                   observer_ptr<model> m,
+                                   size_t sample_size,
+                                   inference_server_config config)
+  : m_comm(comm),
+    m_model(m),
+    m_sample_size(sample_size),
+    m_config(std::move(config)),
+    m_samples(comm->get_trainer_grid())
+{
+  if (m_comm->get_num_trainers() != 1) {
+    LBANN_ERROR("the inference server requires a single trainer");
+  }
+  if (m_sample_size == 0 || m_config.max_batch == 0) {
+    LBANN_ERROR("invalid inference server sample size (",
+                m_sample_size,
+                ") or maximum batch size (",
+                m_config.max_batch,
+                ")");
+  }
+  if (!m_comm->am_world_master()) {
+    return;
+  }
+
+  m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (m_listen_fd < 0) {
+    LBANN_ERROR("could not create inference server socket: ",
+                std::strerror(errno));
+  }
+  const int one = 1;
+  setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  addr.sin_port = htons(static_cast<uint16_t>(m_config.port));
+  if (bind(m_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) <
+        0 ||
+      listen(m_listen_fd, SOMAXCONN) < 0) {
+    const std::string err = std::strerror(errno);
+    close(m_listen_fd);
+    LBANN_ERROR("could not listen on port ", m_config.port, ": ", err);
+  }
+  m_listener = std::thread(&inference_server::listen_loop, this);
+}
+
+inference_server::~inference_server()
+{
+  if (!m_comm->am_world_master()) {
+    return;
+  }
+  stop();
+  shutdown(m_listen_fd, SHUT_RDWR);
+  if (m_listener.joinable()) {
+    m_listener.join();
+  }
+  close(m_listen_fd);
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    for (const int fd : m_connection_fds) {
+      if (fd >= 0) {
+        shutdown(fd, SHUT_RDWR);
+      }
+    }
+  }
+  for (auto& t : m_connections) {
+    t.join();
+  }
+}
+
+void inference_server::run()
+{
+  const bool master = m_comm->am_world_master();
+  while (true) {
+    std::vector<std::unique_ptr<pending_request>> batch;
+    uint64_t num_samples = 0;
+    if (master) {
+      batch = next_batch();
+      for (const auto& r : batch) {
+        num_samples += r->num_samples;
+      }
+    }
+    m_comm->trainer_broadcast(0, num_samples);
+    if (num_samples == 0) {
+      break;
+    }
+
+    // Each rank holds the whole batch
+    m_samples.Resize(num_samples, m_sample_size);
+    auto& local = m_samples.Matrix();
+    if (master) {
+      El::Int row = 0;
+      for (const auto& r : batch) {
+        for (size_t i = 0; i < r->num_samples; ++i, ++row) {
+          const float* sample = r->samples.data() + i * m_sample_size;
+          for (size_t j = 0; j < m_sample_size; ++j) {
+            local(row, j) = sample[j];
+          }
+        }
+      }
+    }
+    m_comm->trainer_broadcast(0,
+                              local.Buffer(),
+                              static_cast<int>(local.LDim() * local.Width()));
+    run_batch(num_samples);
+
+    if (master) {
+      const auto output_size = static_cast<size_t>(m_outputs.Width());
+      El::Int row = 0;
+      for (auto& r : batch) {
+        response reply;
+        reply.output_size = output_size;
+        reply.outputs.resize(r->num_samples * output_size);
+        for (size_t i = 0; i < r->num_samples; ++i, ++row) {
+          for (size_t j = 0; j < output_size; ++j) {
+            reply.outputs[i * output_size + j] = m_outputs(row, j);
+          }
+        }
+        r->reply.set_value(std::move(reply));
+      }
+    }
+  }
+
+  // Requests queued when the server stopped are not run
+  std::lock_guard<std::mutex> lk(m_mutex);
+  for (auto& r : m_pending) {
+    response reply;
+    reply.status = status_stopping;
+    r->reply.set_value(std::move(reply));
+  }
+  m_pending.clear();
+  m_num_pending_samples = 0;
+}
+
+void inference_server::stop()
+{
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_all();
+}
+
+auto inference_server::next_batch()
+  -> std::vector<std::unique_ptr<pending_request>>
+{
+  std::unique_lock<std::mutex> lk(m_mutex);
+  m_cv.wait(lk, [&] { return m_stop || !m_pending.empty(); });
+  // Wait for a full batch, or until the oldest request is due
+  const double deadline = (m_stop ? 0. : m_pending.front()->arrival) +
+                          m_config.max_latency;
+  while (!m_stop && m_num_pending_samples < m_config.max_batch) {
+    const double wait = deadline - get_time();
+    if (wait <= 0.) {
+      break;
+    }
+    m_cv.wait_for(lk, std::chrono::duration<double>(wait));
+  }
+  std::vector<std::unique_ptr<pending_request>> batch;
+  if (m_stop) {
+    return batch;
+  }
+
+  // A request larger than a batch is run on its own
+  size_t num_samples = 0;
+  while (!m_pending.empty() &&
+         (batch.empty() || num_samples + m_pending.front()->num_samples <=
+                             m_config.max_batch)) {
+    num_samples += m_pending.front()->num_samples;
+    batch.push_back(std::move(m_pending.front()));
+    m_pending.pop_front();
+  }
+  m_num_pending_samples -= num_samples;
+  return batch;
+}
+
+void inference_server::run_batch(size_t num_samples)
+{
+  m_outputs = m_algorithm.infer_outputs(m_model,
+                                        m_samples,
+                                        m_config.max_batch,
+                                        m_config.output_layer);
+  if (static_cast<size_t>(m_outputs.Height()) != num_samples) {
+    LBANN_ERROR("inference returned ",
+                m_outputs.Height(),
+                " outputs for ",
+                num_samples,
+                " samples");
+  }
+}
+
+void inference_server::listen_loop()
+{
+  while (true) {
+    const int fd = accept(m_listen_fd, nullptr, nullptr);
+    if (fd < 0 && errno == EINTR) {
+      continue;
+    }
+    if (fd < 0) {
+      break;
+    }
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_stop) {
+      close(fd);
+      break;
+    }
+    const int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    m_connection_fds.push_back(fd);
+    m_connections.emplace_back(&inference_server::serve_connection,
+                               this,
+                               fd);
+  }
+}
+
+void inference_server::serve_connection(int fd)
+{
+  const std::vector<float> no_outputs;
+  uint32_t header[3];
+  while (read_all(fd, header, sizeof(header))) {
+    const uint32_t num_samples = header[1];
+    const uint32_t sample_size = header[2];
+    if (header[0] != request_magic) {
+      write_reply(fd, status_bad_request, 0, 0, no_outputs);
+      break;
+    }
+    if (num_samples == 0) {
+      stop();
+      write_reply(fd, status_ok, 0, 0, no_outputs);
+      break;
+    }
+    const uint64_t bytes = uint64_t{num_samples} * sample_size * sizeof(float);
+    if (sample_size != m_sample_size || bytes > max_request_bytes) {
+      write_reply(fd, status_bad_request, num_samples, 0, no_outputs);
+      break;
+    }
+    std::vector<float> samples(uint64_t{num_samples} * sample_size);
+    if (!read_all(fd, samples.data(), bytes)) {
+      break;
+    }
+    const response reply = submit(std::move(samples), num_samples);
+    if (!write_reply(fd,
+                     reply.status,
+                     num_samples,
+                     reply.output_size,
+                     reply.outputs) ||
+        reply.status != status_ok) {
+      break;
+    }
+  }
+
+  // The destructor may be shutting the connection down
+  std::lock_guard<std::mutex> lk(m_mutex);
+  for (auto& f : m_connection_fds) {
+    if (f == fd) {
+      close(fd);
+      f = -1;
+    }
+  }
+}
+
+auto inference_server::submit(std::vector<float> samples, size_t num_samples)
+  -> response
+{
+  auto request = std::make_unique<pending_request>();
+  request->samples = std::move(samples);
+  request->num_samples = num_samples;
+  request->arrival = get_time();
+  auto reply = request->reply.get_future();
+  {
+    std::lock_guard<std::mutex> lk(m_mutex);
+    if (m_stop) {
+      response stopping;
+      stopping.status = status_stopping;
+      return stopping;
+    }
+    m_num_pending_samples += num_samples;
+    m_pending.push_back(std::move(request));
+  }
+  m_cv.notify_all();
+  return reply.get();
+}
+
+} // namespace lbann
@@ -48,8 +48,10 @@
 
 #include "lbann/proto/training_algorithm.pb.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <limits>
+#include <numeric>
 
 namespace lbann {
 
@@ -77,7 +79,12 @@ KFAC::KFAC(std::string name,
            bool distribute_precondition_compute,
            bool use_eigen_decomposition,
            bool enable_copy_errors,
-           bool enable_copy_activations)
+           bool enable_copy_activations,
+           bool split_large_inverses,
+           bool async_inverse,
+           size_t eigenbasis_update_interval,
+           kfac::kfac_communication_precision communication_precision,
+           size_t max_batched_inverse_size)
 
   : TrainingAlgorithm{std::move(name)},
     m_stopping_criteria{std::move(stop)},
@@ -102,7 +109,12 @@ KFAC::KFAC(std::string name,
     m_enable_copy_errors{enable_copy_errors},
     m_enable_copy_activations{enable_copy_activations},
     m_use_eigen_decomposition{use_eigen_decomposition},
-    m_use_KFAC_epoch{std::move(kfac_use_interval)}
+    m_eigenbasis_update_interval{eigenbasis_update_interval},
+    m_communication_precision{communication_precision},
+    m_max_batched_inverse_size{max_batched_inverse_size},
+    m_use_KFAC_epoch{std::move(kfac_use_interval)},
+    m_split_large_inverses{split_large_inverses},
+    m_async_inverse{async_inverse}
 {}
 
 std::string KFAC::get_type() const { return "KFAC"; }
@@ -184,6 +196,7 @@ void KFAC::train(ExeContextType& kfac_context,
     if (train_mini_batch(kfac_context, model, dc)) {
       // Finalize epoch
       sgd_context.inc_epoch();
+      model.flush_statistics();
 
       m_time_span_inverse_comm = 0;
       m_time_span_backward_comm = 0;
@@ -439,7 +452,7 @@ bool KFAC::train_mini_batch(ExeContextType& kfac_context,
         model.get_objective_function()->compute_weight_regularization();
 
         // Finish evaluation.
-        model.get_objective_function()->finish_evaluation(
+        model.get_objective_function()->finish_evaluation_deferred(
           execution_mode::training,
           sgd_context.get_current_mini_batch_size());
         model.evaluate_metrics(execution_mode::training,
@@ -525,6 +538,129 @@ void KFAC::do_batch_end_cbs(model& model)
 // Sub-grid implementation
 // =============================================
 
+void KFAC::update_kronecker_inverses(ExeContextType& context,
+                                     lbann_comm& comm)
+{
+  // Printed inverses must be computed before the blocks return
+  context.m_max_batched_inverse_size =
+    (m_print_matrix || m_print_matrix_summary ? 0
+                                              : m_max_batched_inverse_size);
+  for (auto& block : context.m_blocks) {
+    if (!block->is_inverse_proc_rank(comm.get_rank_in_trainer()))
+      continue;
+
+    prof_region_begin(("kfac-inverse/" + block->get_name()).c_str(),
+                      prof_color,
+                      prof_sync);
+    // TODO: Add kfac_block::is_bn?
+    const bool is_bn =
+      dynamic_cast<kfac_block_bn<Device>*>(block.get()) != nullptr;
+    const bool is_gru =
+      dynamic_cast<kfac_block_gru<Device>*>(block.get()) != nullptr;
+    block->update_kronecker_inverse(
+      &comm,
+      m_use_pi,
+      is_bn ? context.m_damping_bn_act : context.m_damping_act,
+      is_bn ? context.m_damping_bn_err : context.m_damping_err,
+      is_gru ? m_learning_rate_factor_gru : m_learning_rate_factor,
+      m_use_eigen_decomposition,
+      m_print_matrix,
+      m_print_matrix_summary,
+      m_print_time);
+    prof_region_end(("kfac-inverse/" + block->get_name()).c_str(), prof_sync);
+  }
+  prof_region_begin("kfac-inverse/batched", prof_color, prof_sync);
+  context.flush_inverse_requests(comm.am_trainer_master() && m_print_time);
+  prof_region_end("kfac-inverse/batched", prof_sync);
+}
+
+void KFAC::start_async_inverse(ExeContextType& context, lbann_comm& comm)
+{
+  update_kronecker_inverses(context, comm);
+  m_async_inverse_buffer_size = 0;
+  for (auto& block : context.m_blocks)
+    m_async_inverse_buffer_size += block->get_inverse_matrices_size(&comm);
+  El::Matrix<DataType, Device>& async_buffer =
+    context.get_workspace_matrix("async_inverse_buffer",
+                                 m_async_inverse_buffer_size,
+                                 1);
+  kfac::start_allgather_inverse_matrices(context.m_blocks,
+                                         async_buffer,
+                                         &comm,
+                                         m_async_inverse_req);
+  m_async_inverse_pending = true;
+}
+
+void KFAC::balance_inverse_proc_ranks(ExeContextType& context,
+                                      lbann_comm& comm)
+{
+  std::vector<std::vector<double>> costs;
+  for (const auto& block : context.m_blocks)
+    costs.push_back(block->get_inverse_costs());
+  if (costs == m_inverse_costs)
+    return;
+  m_inverse_costs = costs;
+
+  const size_t num_procs = comm.get_procs_per_trainer();
+  double total_cost = 0;
+  for (const auto& block_costs : costs)
+    for (const auto& cost : block_costs)
+      total_cost += cost;
+  // Sub-grids exchange the inverses of whole blocks, so factors are
+  // only split without them
+  const bool enable_split =
+    m_split_large_inverses && comm.get_grid_type() == GridType::NO_GRID;
+
+  // An inverse is a whole block (factor -1) or one of its factors
+  struct inverse_job
+  {
+    double cost;
+    size_t block;
+    int factor;
+  };
+  std::vector<inverse_job> jobs;
+  for (size_t i = 0; i < costs.size(); ++i) {
+    const double block_cost =
+      std::accumulate(costs[i].begin(), costs[i].end(), 0.0);
+    if (enable_split && costs[i].size() > 1 &&
+        block_cost > total_cost / num_procs) {
+      for (size_t j = 0; j < costs[i].size(); ++j)
+        jobs.push_back({costs[i][j], i, static_cast<int>(j)});
+    }
+    else {
+      jobs.push_back({block_cost, i, -1});
+    }
+  }
+  std::stable_sort(jobs.begin(),
+                   jobs.end(),
+                   [](const inverse_job& a, const inverse_job& b) {
+                     return a.cost > b.cost;
+                   });
+
+  std::vector<double> loads(num_procs, 0.0);
+  std::vector<std::vector<size_t>> ranks;
+  for (const auto& block_costs : costs)
+    ranks.emplace_back(block_costs.size(), 0);
+  for (const auto& job : jobs) {
+    const auto least_loaded = std::min_element(loads.begin(), loads.end());
+    const size_t rank = std::distance(loads.begin(), least_loaded);
+    loads[rank] += job.cost;
+    if (job.factor < 0)
+      std::fill(ranks[job.block].begin(), ranks[job.block].end(), rank);
+    else
+      ranks[job.block][job.factor] = rank;
+  }
+  for (size_t i = 0; i < context.m_blocks.size(); ++i)
+    context.m_blocks[i]->set_inverse_proc_ranks(ranks[i]);
+
+  if (comm.am_trainer_master() && total_cost > 0) {
+    const double max_load = *std::max_element(loads.begin(), loads.end());
+    std::cout << "K-FAC: balanced " << jobs.size() << " inverses over "
+              << num_procs << " processes, max/mean load = "
+              << max_load / (total_cost / num_procs) << std::endl;
+  }
+}
+
 void KFAC::allgather_precondition_gradient(lbann_comm& comm,
                                            ExeContextType& context)
 {
@@ -1350,13 +1486,18 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
           output_size);
       }
 
+      block->set_eigenbasis_update_interval(m_eigenbasis_update_interval);
       context.m_blocks.push_back(std::move(block));
-      if (m_inverse_strategy != kfac::kfac_inverse_strategy::ROOT)
+      if (m_inverse_strategy != kfac::kfac_inverse_strategy::ROOT &&
+          m_inverse_strategy != kfac::kfac_inverse_strategy::BALANCED)
         proc_rank = (proc_rank + 1) % num_procs;
 
       prof_region_end(("kfac-setup/" + l->get_name()).c_str(), prof_sync);
     }
 
+    if (m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED)
+      balance_inverse_proc_ranks(context, comm);
+
     if (comm.am_trainer_master()) {
       for (const auto& block : context.m_blocks)
         std::cout << "K-FAC setup: " << block->get_info() << std::endl;
@@ -1380,9 +1521,12 @@ void KFAC::on_forward_prop_end(ExeContextType& context, model& model)
   for (auto& block : context.m_blocks)
     block->on_forward_prop_end(&comm);
 
-  if (context.get_step() > 1 and
+  // Inverses are only sent after the secondary grid updated them
+  if (context.get_step() > 1 and m_inverse_exchange_required and
       (comm.get_grid_type() == GridType::PRIMARY_GRID or
        comm.get_grid_type() == GridType::SECONDARY_GRID)) {
+    m_inverse_exchange_required = false;
+    m_inverse_exchange_started = true;
     auto t_start = std::chrono::high_resolution_clock::now();
     start_send_recv_inverse_matrices(context, &comm);
     auto t_stop = std::chrono::high_resolution_clock::now();
@@ -1466,9 +1610,15 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
         std::min((double)num_steps / m_update_interval_steps, 1.0);
   }
 
-  if (context.get_step() > 1 and
-      (comm.get_grid_type() == GridType::PRIMARY_GRID or
-       comm.get_grid_type() == GridType::SECONDARY_GRID)) {
+  const bool is_kronecker_update_required =
+    ((num_steps % context.m_update_interval) == 0 || !m_has_kronecker_inverse);
+  // The first inverses are gathered before they are used
+  const bool is_async_inverse = m_async_inverse &&
+                                comm.get_grid_type() == GridType::NO_GRID &&
+                                m_has_kronecker_inverse;
+
+  if (m_inverse_exchange_started) {
+    m_inverse_exchange_started = false;
     auto t_start = std::chrono::high_resolution_clock::now();
 
     end_send_recv_inverse_matrices(context, &comm);
@@ -1517,9 +1667,6 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
     // Step 1: Ensure that each process has averaged Kronecker factors
     // for the model-parallel part.
     // const bool is_first_step = (!m_has_kronecker_inverse);
-    const bool is_kronecker_update_required =
-      ((num_steps % context.m_update_interval) == 0 ||
-       !m_has_kronecker_inverse);
     if (is_kronecker_update_required) {
       prof_region_begin("kfac-update", prof_color, prof_sync);
 
@@ -1571,7 +1718,8 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       kfac::reduce_scatter_blocks(buffers,
                                   global_buffer,
                                   &comm,
-                                  reduce_scatter_mode);
+                                  reduce_scatter_mode,
+                                  m_communication_precision);
       prof_region_end("kfac-update/reduce-scatter", prof_sync);
 
 #ifdef LBANN_NVPROF
@@ -1602,62 +1750,61 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       prof_region_end("kfac-update", prof_sync);
     }
 
+    // Factor shapes are known once the averages are computed
+    if (m_inverse_strategy == kfac::kfac_inverse_strategy::BALANCED &&
+        comm.get_grid_type() == GridType::NO_GRID)
+      balance_inverse_proc_ranks(context, comm);
+
     // Step 2: Model-parallel inverse computation
     prof_region_begin("kfac-inverse", prof_color, prof_sync);
-    for (auto& block : context.m_blocks) {
-      if (!is_kronecker_update_required ||
-          (size_t)comm.get_rank_in_trainer() != block->get_inverse_proc_rank())
-        continue;
-
-      prof_region_begin(("kfac-inverse/" + block->get_name()).c_str(),
-                        prof_color,
-                        prof_sync);
-      // TODO: Add kfac_block::is_bn?
-      const bool is_bn =
-        dynamic_cast<kfac_block_bn<Device>*>(block.get()) != nullptr;
-      const bool is_gru =
-        dynamic_cast<kfac_block_gru<Device>*>(block.get()) != nullptr;
-      block->update_kronecker_inverse(
-        &comm,
-        m_use_pi,
-        is_bn ? context.m_damping_bn_act : context.m_damping_act,
-        is_bn ? context.m_damping_bn_err : context.m_damping_err,
-        is_gru ? m_learning_rate_factor_gru : m_learning_rate_factor,
-        m_use_eigen_decomposition,
-        m_print_matrix,
-        m_print_matrix_summary,
-        m_print_time);
-      prof_region_end(("kfac-inverse/" + block->get_name()).c_str(), prof_sync);
+    if (is_async_inverse) {
+      // Precondition with the inverses gathered since the last update
+      if (m_async_inverse_pending) {
+        El::Matrix<DataType, Device>& async_buffer =
+          context.get_workspace_matrix("async_inverse_buffer",
+                                       m_async_inverse_buffer_size,
+                                       1);
+        kfac::end_allgather_inverse_matrices(context.m_blocks,
+                                             async_buffer,
+                                             &comm,
+                                             m_async_inverse_req);
+        m_async_inverse_pending = false;
+      }
     }
+    else {
+      if (is_kronecker_update_required)
+        update_kronecker_inverses(context, comm);
+
+      // allgather inverse matrices
+      if (is_first_step and false) {
+        kfac::allgather_inverse_matrices_sizes(context.m_blocks,
+                                               m_inverse_matrices_size,
+                                               &comm);
+        int block_number = 0;
+        for (auto& block : context.m_blocks) {
+          block->resize_inverse_matrices_size(m_inverse_matrices_size,
+                                              block_number);
+          block_number++;
+        }
+      }
+
+      int global_buffer_inverses_size = 0;
 
-    // allgather inverse matrices
-    if (is_first_step and false) {
-      kfac::allgather_inverse_matrices_sizes(context.m_blocks,
-                                             m_inverse_matrices_size,
-                                             &comm);
-      int block_number = 0;
       for (auto& block : context.m_blocks) {
-        block->resize_inverse_matrices_size(m_inverse_matrices_size,
-                                            block_number);
-        block_number++;
+        global_buffer_inverses_size += block->get_inverse_matrices_size(&comm);
       }
-    }
 
-    int global_buffer_inverses_size = 0;
+      El::Matrix<DataType, Device>& global_buffer_inverse =
+        context.get_workspace_matrix("allgather_inverse_recv_buffer",
+                                     global_buffer_inverses_size,
+                                     1);
+      kfac::allgather_inverse_matrices(context.m_blocks,
+                                       global_buffer_inverse,
+                                       &comm,
+                                       m_communication_precision);
 
-    for (auto& block : context.m_blocks) {
-      global_buffer_inverses_size += block->get_inverse_matrices_size(&comm);
+      m_has_kronecker_inverse = true;
     }
-
-    El::Matrix<DataType, Device>& global_buffer_inverse =
-      context.get_workspace_matrix("allgather_inverse_recv_buffer",
-                                   global_buffer_inverses_size,
-                                   1);
-    kfac::allgather_inverse_matrices(context.m_blocks,
-                                     global_buffer_inverse,
-                                     &comm);
-
-    m_has_kronecker_inverse = true;
     prof_region_end("kfac-inverse", prof_sync);
 
 #ifdef LBANN_NVPROF
@@ -1703,6 +1850,9 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
       if (m_distribute_precondition_compute)
         allgather_precondition_gradient(comm, context);
     }
+    // Compute and gather the next inverses while training continues
+    if (is_async_inverse && is_kronecker_update_required)
+      start_async_inverse(context, comm);
     if (comm.get_grid_type() == GridType::PRIMARY_GRID and
         this->m_enable_copy_errors == false) {
       for (auto& block : context.m_blocks) {
@@ -1712,6 +1862,9 @@ void KFAC::on_backward_prop_end(ExeContextType& context, model& model)
     }
   }
 
+  if (is_kronecker_update_required)
+    m_inverse_exchange_required = true;
+
   if (is_first_step) {
     int kfac_inverse_size = 0;
     for (auto& block : context.m_blocks) {
@@ -1852,6 +2005,12 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
   const bool enable_copy_errors = kfac_params.enable_copy_errors();
   const bool enable_copy_activations = kfac_params.enable_copy_activations();
   const bool use_eigen_decomposition = kfac_params.use_eigen_decomposition();
+  const bool split_large_inverses = kfac_params.split_large_inverses();
+  const bool async_inverse = kfac_params.async_inverse();
+  const size_t eigenbasis_update_interval =
+    El::Max(kfac_params.eigenbasis_update_interval(), 1);
+  const size_t max_batched_inverse_size =
+    El::Max(kfac_params.max_batched_inverse_size(), 0);
 
   const std::string inverse_strategy_str = kfac_params.inverse_strategy();
   kfac::kfac_inverse_strategy inverse_strategy;
@@ -1861,12 +2020,28 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
     inverse_strategy = kfac::kfac_inverse_strategy::EACH;
   else if (inverse_strategy_str == "root")
     inverse_strategy = kfac::kfac_inverse_strategy::ROOT;
+  else if (inverse_strategy_str == "balanced")
+    inverse_strategy = kfac::kfac_inverse_strategy::BALANCED;
   else {
     std::stringstream err;
     err << "Invalid inverse strategy type: " << inverse_strategy_str;
     LBANN_ERROR(err.str());
   }
 
+  const std::string communication_precision_str =
+    kfac_params.communication_precision();
+  kfac::kfac_communication_precision communication_precision;
+  if (communication_precision_str == "" ||
+      communication_precision_str == "fp32")
+    communication_precision = kfac::kfac_communication_precision::FULL;
+  else if (communication_precision_str == "fp16")
+    communication_precision = kfac::kfac_communication_precision::HALF;
+  else {
+    std::stringstream err;
+    err << "Invalid communication precision: " << communication_precision_str;
+    LBANN_ERROR(err.str());
+  }
+
   const std::vector<std::string> disable_layers =
     parse_list<std::string>(kfac_params.disable_layers());
 
@@ -1900,5 +2075,10 @@ lbann::make<lbann::KFAC>(google::protobuf::Message const& msg_in)
                                     distribute_precondition_compute,
                                     use_eigen_decomposition,
                                     enable_copy_errors,
-                                    enable_copy_activations);
+                                    enable_copy_activations,
+                                    split_large_inverses,
+                                    async_inverse,
+                                    eigenbasis_update_interval,
+                                    communication_precision,
+                                    max_batched_inverse_size);
 }
@@ -89,6 +89,30 @@ KFACExecutionContext::get_workspace_matrix(const std::string& key,
   return ret;
 }
 
+bool KFACExecutionContext::defer_inverse(const inverse_request& request)
+{
+  if ((size_t)request.A->Height() > m_max_batched_inverse_size)
+    return false;
+  m_inverse_requests.push_back(request);
+  return true;
+}
+
+void KFACExecutionContext::flush_inverse_requests(const bool report_time)
+{
+  if (m_inverse_requests.empty())
+    return;
+  // The batched inversion sizes the buffer itself
+  const std::string key = "batched_inverse_buffer";
+  const auto it = m_workspace.find(key);
+  auto& workspace =
+    (it != m_workspace.end() ? it->second : get_workspace_matrix(key, 0, 1));
+  get_matrix_inverses_batched(m_inverse_requests,
+                              workspace,
+                              report_time,
+                              El::SyncInfoFromMatrix(workspace));
+  m_inverse_requests.clear();
+}
+
 // =============================================
 // Checkpointing and serialization
 // =============================================
@@ -27,6 +27,7 @@
 
 #include "lbann/execution_algorithms/kfac/kfac_block.hpp"
 #include "lbann/execution_algorithms/kfac/execution_context.hpp"
+#include "lbann/execution_algorithms/kfac/kfac_util.hpp"
 
 namespace lbann {
 
@@ -53,6 +54,67 @@ El::SyncInfo<El::Device::GPU> kfac_block<El::Device::GPU>::get_sync_info()
 }
 #endif // LBANN_HAS_GPU
 
+template <El::Device Device>
+void kfac_block<Device>::get_matrix_inverse_batched(
+  El::AbstractMatrix<DataType>& Ainv,
+  El::AbstractMatrix<DataType>& Linv,
+  const El::AbstractMatrix<DataType>& A,
+  const bool report_time,
+  const DataType damping,
+  const DataType damping_bn_err,
+  const bool is_bn)
+{
+  // The execution context only batches matrices on its own device
+  if (Device == kfac::Device &&
+      m_context->defer_inverse(
+        kfac::inverse_request{&Ainv, &A, damping, damping_bn_err, is_bn}))
+    return;
+  kfac::get_matrix_inverse(Ainv,
+                           Linv,
+                           A,
+                           report_time,
+                           damping,
+                           damping_bn_err,
+                           is_bn,
+                           get_sync_info());
+}
+
+template <El::Device Device>
+void kfac_block<Device>::get_matrix_inverse_cached_eigen(
+  const std::string& key,
+  El::AbstractMatrix<DataType>& Ainv,
+  El::Matrix<DataType, Device>& W,
+  const El::AbstractMatrix<DataType>& A,
+  const bool report_time,
+  const DataType damping,
+  const DataType damping_bn_err,
+  const bool is_bn)
+{
+  const auto& sync_info = get_sync_info();
+  const size_t height = A.Height();
+  auto& Q = get_workspace_matrix(key + "_eigenvectors", height, height);
+  auto& w = get_workspace_matrix(key + "_eigenvalues", height, 1);
+
+  auto age = m_eigenbasis_age.find(key);
+  if (age == m_eigenbasis_age.end() ||
+      age->second >= m_eigenbasis_update_interval) {
+    kfac::get_matrix_eigen_decomposition(Q, w, W, A, report_time, sync_info);
+    m_eigenbasis_age[key] = 1;
+  }
+  else {
+    kfac::get_matrix_eigenvalues_in_basis(w, W, Q, A, sync_info);
+    age->second++;
+  }
+  kfac::get_matrix_inverse_from_eigen(Ainv,
+                                      W,
+                                      Q,
+                                      w,
+                                      damping,
+                                      damping_bn_err,
+                                      is_bn,
+                                      sync_info);
+}
+
 template <El::Device Device>
 void kfac_block<Device>::compute_local_kronecker_factors(lbann_comm* comm,
                                                          bool print_matrix,
@@ -198,24 +198,24 @@ void kfac_block_bn<Device>::update_kronecker_inverse(
     this->get_workspace_matrix("bn_FLinv", Fave.Height(), Fave.Height());
 
   if (use_eigen_decomposition) {
-    kfac::get_matrix_inverse_eigen(Finv,
-                                   FLinv,
-                                   Fave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_act),
-                                   DataType(damping_err),
-                                   true,
-                                   sync_info);
+    this->get_matrix_inverse_cached_eigen(
+      "bn_F",
+      Finv,
+      FLinv,
+      Fave,
+      comm->am_trainer_master() && print_time,
+      DataType(damping_act),
+      DataType(damping_err),
+      true);
   }
   else {
-    kfac::get_matrix_inverse(Finv,
-                             FLinv,
-                             Fave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act),
-                             DataType(damping_err),
-                             true,
-                             sync_info);
+    this->get_matrix_inverse_batched(Finv,
+                                     FLinv,
+                                     Fave,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_act),
+                                     DataType(damping_err),
+                                     true);
   }
 
   // dump L2 norm of matrices
@@ -766,6 +766,13 @@ int kfac_block_bn<Device>::get_inverse_matrices_size(lbann_comm* comm)
   return inverse_size;
 }
 
+template <El::Device Device>
+std::vector<double> kfac_block_bn<Device>::get_inverse_costs() const
+{
+  const double height = m_num_channels * 2;
+  return {height * height * height};
+}
+
 template class kfac_block_bn<El::Device::CPU>;
 #ifdef LBANN_HAS_GPU
 template class kfac_block_bn<El::Device::GPU>;
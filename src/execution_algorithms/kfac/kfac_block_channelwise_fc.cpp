@@ -28,6 +28,8 @@
 #include "lbann/execution_algorithms/kfac/kfac_block_channelwise_fc.hpp"
 #include "lbann/execution_algorithms/kfac/kfac_util.hpp"
 #include "lbann/layers/data_type_layer.hpp"
+#include "lbann/utils/batched_gemm.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 
 namespace lbann {
 
@@ -49,48 +51,19 @@ void kfac_block_channelwise_fc<Device>::compute_local_kronecker_factors(
     this->m_child_local_errors[0]->Matrix();
 
   const auto mini_batch_size = dtl_parent.get_activations().Width();
-  const auto local_batch_size = local_activations.Width();
 
-  const auto input_dims = this->m_layer->get_input_dims();   // CHW
-  const auto output_dims = this->m_layer->get_output_dims(); // CH'W'
-  const size_t num_input_channels = input_dims[0];
-
-  const auto& input_channel_size = std::accumulate(input_dims.begin() + 1,
-                                                   input_dims.end(),
-                                                   1,
-                                                   std::multiplies<size_t>());
-  const auto& output_channel_size = std::accumulate(output_dims.begin() + 1,
-                                                    output_dims.end(),
-                                                    1,
-                                                    std::multiplies<size_t>());
+  const auto input_dims = this->m_layer->get_input_dims(); // CHW
+  const El::Int num_input_channels = input_dims[0];
 
+  // Note: Packed tensors are viewed in place rather than copied.
   El::Matrix<DataType, Device> local_activations_reshaped,
     local_errors_reshaped;
-
-  if (local_activations.Contiguous() and false) {
-    local_activations_reshaped.LockedAttach(input_channel_size,
-                                            local_batch_size *
-                                              num_input_channels,
-                                            local_activations.LockedBuffer(),
-                                            input_channel_size);
-  }
-  else {
-    El::Copy(local_activations, local_activations_reshaped);
-    local_activations_reshaped.Resize(input_channel_size,
-                                      local_batch_size * num_input_channels);
-  }
-
-  if (local_errors.Contiguous() and false) {
-    local_errors_reshaped.LockedAttach(output_channel_size,
-                                       local_batch_size * num_input_channels,
-                                       local_errors.LockedBuffer(),
-                                       output_channel_size);
-  }
-  else {
-    El::Copy(local_errors, local_errors_reshaped);
-    local_errors_reshaped.Resize(output_channel_size,
-                                 local_batch_size * num_input_channels);
-  }
+  get_channelwise_matrix(local_activations,
+                         num_input_channels,
+                         local_activations_reshaped);
+  get_channelwise_matrix(local_errors,
+                         num_input_channels,
+                         local_errors_reshaped);
 
   m_height_A = local_activations_reshaped.Height();
   if (m_has_bias)
@@ -101,24 +74,34 @@ void kfac_block_channelwise_fc<Device>::compute_local_kronecker_factors(
   auto& G = this->get_workspace_matrix("G", m_height_G, m_height_G);
 
   if (m_has_bias) {
-    auto& local_activations_with_ones =
-      this->get_workspace_matrix("local_activations_with_ones",
-                                 local_activations_reshaped.Height() + 1,
-                                 local_activations_reshaped.Width());
-    auto local_activations_dst =
-      El::View(local_activations_with_ones,
-               El::IR(0, local_activations_reshaped.Height()),
-               El::ALL);
-    El::Copy(local_activations_reshaped, local_activations_dst);
-    auto local_activations_ones =
-      El::View(local_activations_with_ones,
-               El::IR(local_activations_reshaped.Height(),
-                      local_activations_reshaped.Height() + 1),
-               El::ALL);
-    El::Ones(local_activations_ones, 1, local_activations_reshaped.Width());
-    get_kronecker_factor_fc(A,
-                            local_activations_with_ones,
-                            1.0 / mini_batch_size);
+    // The bias is a constant input of one, so the factor is assembled
+    // from blocks instead of copying the activations next to a row
+    // of ones: [ X X^T, X 1 ; 1^T X^T, N ] / mini_batch_size.
+    const El::Int height = local_activations_reshaped.Height();
+    const El::Int width = local_activations_reshaped.Width();
+    const DataType alpha = 1.0 / mini_batch_size;
+    auto A_xx = El::View(A, El::IR(0, height), El::IR(0, height));
+    auto A_x1 = El::View(A, El::IR(0, height), El::IR(height, height + 1));
+    auto A_1x = El::View(A, El::IR(height, height + 1), El::IR(0, height));
+    auto A_11 =
+      El::View(A, El::IR(height, height + 1), El::IR(height, height + 1));
+    auto& ones = this->get_workspace_matrix("ones", width, 1);
+    El::Fill(ones, El::TypeTraits<DataType>::One());
+    get_kronecker_factor_fc(A_xx, local_activations_reshaped, alpha);
+    El::Gemv(El::NORMAL,
+             alpha,
+             local_activations_reshaped,
+             ones,
+             El::TypeTraits<DataType>::Zero(),
+             A_x1);
+    El::Gemm(El::TRANSPOSE,
+             El::TRANSPOSE,
+             alpha,
+             ones,
+             local_activations_reshaped,
+             El::TypeTraits<DataType>::Zero(),
+             A_1x);
+    El::Fill(A_11, DataType(alpha * width));
   }
   else {
     get_kronecker_factor_fc(A,
@@ -229,8 +212,6 @@ void kfac_block_channelwise_fc<Device>::update_kronecker_inverse(
   const bool print_time)
 {
 
-  const auto& sync_info = this->get_sync_info();
-
   // TODO: Refactoring
   const auto& Aave = m_kronecker_average_A;
   const auto& Gave = m_kronecker_average_G;
@@ -268,40 +249,40 @@ void kfac_block_channelwise_fc<Device>::update_kronecker_inverse(
     this->get_workspace_matrix("GLinv", Gave.Height(), Gave.Height());
 
   if (use_eigen_decomposition) {
-    kfac::get_matrix_inverse_eigen(Ainv,
-                                   ALinv,
-                                   Aave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_act * pi),
-                                   0,
-                                   false,
-                                   sync_info);
-    kfac::get_matrix_inverse_eigen(Ginv,
-                                   GLinv,
-                                   Gave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_err / pi),
-                                   0,
-                                   false,
-                                   sync_info);
+    this->get_matrix_inverse_cached_eigen(
+      "A",
+      Ainv,
+      ALinv,
+      Aave,
+      comm->am_trainer_master() && print_time,
+      DataType(damping_act * pi),
+      0,
+      false);
+    this->get_matrix_inverse_cached_eigen(
+      "G",
+      Ginv,
+      GLinv,
+      Gave,
+      comm->am_trainer_master() && print_time,
+      DataType(damping_err / pi),
+      0,
+      false);
   }
   else {
-    kfac::get_matrix_inverse(Ainv,
-                             ALinv,
-                             Aave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
-    kfac::get_matrix_inverse(Ginv,
-                             GLinv,
-                             Gave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_err / pi),
-                             0,
-                             false,
-                             sync_info);
+    this->get_matrix_inverse_batched(Ainv,
+                                     ALinv,
+                                     Aave,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_act * pi),
+                                     0,
+                                     false);
+    this->get_matrix_inverse_batched(Ginv,
+                                     GLinv,
+                                     Gave,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_err / pi),
+                                     0,
+                                     false);
   }
 
   if (print_matrix_summary) {
@@ -1078,6 +1059,21 @@ int kfac_block_channelwise_fc<Device>::get_inverse_matrices_size(
   return my_height_A * my_height_A + my_height_G * my_height_G;
 }
 
+template <El::Device Device>
+std::vector<double>
+kfac_block_channelwise_fc<Device>::get_inverse_costs() const
+{
+  const auto input_dims = this->m_layer->get_input_dims();
+  const auto output_dims = this->m_layer->get_output_dims();
+  double height_A = get_linear_size_as<double>(input_dims.size() - 1,
+                                               &input_dims[1]);
+  const double height_G = get_linear_size_as<double>(output_dims.size() - 1,
+                                                     &output_dims[1]);
+  if (m_has_bias)
+    height_A++;
+  return {height_A * height_A * height_A + height_G * height_G * height_G};
+}
+
 template <El::Device Device>
 int kfac_block_channelwise_fc<Device>::set_inverse_matrices(
   El::Matrix<DataType, Device>& workspace,
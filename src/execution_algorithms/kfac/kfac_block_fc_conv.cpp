@@ -279,41 +279,52 @@ void kfac_block_fc_conv<Device>::update_kronecker_inverse(
   auto& GLinv =
     this->get_workspace_matrix("GLinv", Gave.Height(), Gave.Height());
 
+  // The factors may be inverted on separate processes
+  const size_t rank = comm->get_rank_in_trainer();
+  m_own_inverse_A = (rank == this->get_inverse_proc_rank());
+  m_own_inverse_G = (rank == m_inverse_proc_rank_G);
+
   if (use_eigen_decomposition) {
-    kfac::get_matrix_inverse_eigen(Ainv,
-                                   ALinv,
-                                   Aave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_act * pi),
-                                   0,
-                                   false,
-                                   sync_info);
-    kfac::get_matrix_inverse_eigen(Ginv,
-                                   GLinv,
-                                   Gave,
-                                   comm->am_trainer_master() && print_time,
-                                   DataType(damping_err / pi),
-                                   0,
-                                   false,
-                                   sync_info);
+    if (m_own_inverse_A)
+      this->get_matrix_inverse_cached_eigen(
+        "A",
+        Ainv,
+        ALinv,
+        Aave,
+        comm->am_trainer_master() && print_time,
+        DataType(damping_act * pi),
+        0,
+        false);
+    if (m_own_inverse_G)
+      this->get_matrix_inverse_cached_eigen(
+        "G",
+        Ginv,
+        GLinv,
+        Gave,
+        comm->am_trainer_master() && print_time,
+        DataType(damping_err / pi),
+        0,
+        false);
   }
   else {
-    kfac::get_matrix_inverse(Ainv,
-                             ALinv,
-                             Aave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
-    kfac::get_matrix_inverse(Ginv,
-                             GLinv,
-                             Gave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_err / pi),
-                             0,
-                             false,
-                             sync_info);
+    if (m_own_inverse_A)
+      kfac::get_matrix_inverse(Ainv,
+                               ALinv,
+                               Aave,
+                               comm->am_trainer_master() && print_time,
+                               DataType(damping_act * pi),
+                               0,
+                               false,
+                               sync_info);
+    if (m_own_inverse_G)
+      kfac::get_matrix_inverse(Ginv,
+                               GLinv,
+                               Gave,
+                               comm->am_trainer_master() && print_time,
+                               DataType(damping_err / pi),
+                               0,
+                               false,
+                               sync_info);
   }
 
   if (print_matrix_summary) {
@@ -1059,41 +1070,25 @@ int kfac_block_fc_conv<Device>::get_inverse_matrices(
   El::Matrix<DataType, Device>& output,
   int offset)
 {
-  const int size_Ainv =
-    m_kronecker_inverse_A.Height() * m_kronecker_inverse_A.Width();
-  const int size_Ginv =
-    m_kronecker_inverse_G.Height() * m_kronecker_inverse_G.Width();
+  // The inverses are symmetric, so only their lower triangles are sent
+  const int height_Ainv = m_kronecker_inverse_A.Height();
+  const int height_Ginv = m_kronecker_inverse_G.Height();
+  const int size_Ainv = height_Ainv * (height_Ainv + 1) / 2;
+  const int size_Ginv = height_Ginv * (height_Ginv + 1) / 2;
 
   El::SyncInfo<Device> sync_info = El::SyncInfoFromMatrix(output);
 
-  {
+  // Factors inverted elsewhere are left to their processes
+  if (m_own_inverse_A) {
     auto view = El::View(output, El::IR(offset, offset + size_Ainv), El::ALL);
-    // El::Copy(m_kronecker_inverse_A, view);
-    El::copy::util::InterleaveMatrix(size_Ainv,
-                                     1,
-                                     m_kronecker_inverse_A.LockedBuffer(),
-                                     1,
-                                     size_Ainv,
-                                     output.Buffer(offset, 0),
-                                     1,
-                                     size_Ainv,
-                                     sync_info);
+    kfac::pack_lower_tri(view, m_kronecker_inverse_A, sync_info);
   }
 
   offset += size_Ainv;
 
-  {
+  if (m_own_inverse_G) {
     auto view = El::View(output, El::IR(offset, offset + size_Ginv), El::ALL);
-    // El::Copy(m_kronecker_inverse_G, view);
-    El::copy::util::InterleaveMatrix(size_Ginv,
-                                     1,
-                                     m_kronecker_inverse_G.LockedBuffer(),
-                                     1,
-                                     size_Ginv,
-                                     output.Buffer(offset, 0),
-                                     1,
-                                     size_Ginv,
-                                     sync_info);
+    kfac::pack_lower_tri(view, m_kronecker_inverse_G, sync_info);
   }
   return offset + size_Ginv;
 }
@@ -1130,7 +1125,8 @@ template <El::Device Device>
 int kfac_block_fc_conv<Device>::get_inverse_matrices_size(lbann_comm* comm)
 {
   if (this->m_Ainv_height > 0) {
-    return m_Ainv_height * m_Ainv_width + m_Ginv_height * m_Ginv_width;
+    return m_Ainv_height * (m_Ainv_height + 1) / 2 +
+           m_Ginv_height * (m_Ginv_height + 1) / 2;
   }
   const auto input_dims = this->m_layer->get_input_dims(); // CHW
   const size_t num_input_channels = input_dims[0];
@@ -1169,7 +1165,49 @@ int kfac_block_fc_conv<Device>::get_inverse_matrices_size(lbann_comm* comm)
   this->m_Ginv_height = my_height_G;
   this->m_Ginv_width = my_height_G;
 
-  return my_height_A * my_height_A + my_height_G * my_height_G;
+  return my_height_A * (my_height_A + 1) / 2 +
+         my_height_G * (my_height_G + 1) / 2;
+}
+
+template <El::Device Device>
+std::vector<double> kfac_block_fc_conv<Device>::get_inverse_costs() const
+{
+  // Estimate the factor heights if they are not computed yet
+  double height_A = m_kronecker_average_A.Height();
+  double height_G = m_kronecker_average_G.Height();
+  if (height_A == 0) {
+    if (m_is_conv) {
+      const auto l_conv = dynamic_cast<
+        convolution_layer<DataType, data_layout::DATA_PARALLEL, Device>*>(
+        this->m_layer);
+      height_A = static_cast<double>(this->m_layer->get_input_dims()[0]) *
+                 get_linear_size(l_conv->get_conv_dims());
+      height_G = this->m_layer->get_output_dims()[0];
+    }
+    else {
+      height_A = this->m_input_size;
+      height_G = this->m_output_size;
+    }
+    if (m_has_bias)
+      height_A++;
+  }
+  // Cholesky factorization and triangular inverse are cubic
+  return {height_A * height_A * height_A, height_G * height_G * height_G};
+}
+
+template <El::Device Device>
+void kfac_block_fc_conv<Device>::set_inverse_proc_ranks(
+  const std::vector<size_t>& ranks)
+{
+  this->m_inverse_proc_rank = ranks.at(0);
+  m_inverse_proc_rank_G = ranks.size() > 1 ? ranks[1] : ranks[0];
+}
+
+template <El::Device Device>
+bool kfac_block_fc_conv<Device>::is_inverse_proc_rank(size_t rank) const
+{
+  return rank == this->get_inverse_proc_rank() ||
+         rank == m_inverse_proc_rank_G;
 }
 
 template <El::Device Device>
@@ -1196,33 +1234,21 @@ int kfac_block_fc_conv<Device>::set_inverse_matrices(
   m_kronecker_inverse_A.Resize(m_Ainv_height, m_Ainv_width);
   m_kronecker_inverse_G.Resize(m_Ginv_height, m_Ginv_width);
 
-  const int size_Ainv = m_Ainv_height * m_Ainv_width;
-  const int size_Ginv = m_Ginv_height * m_Ginv_width;
+  const int size_Ainv = m_Ainv_height * (m_Ainv_height + 1) / 2;
+  const int size_Ginv = m_Ginv_height * (m_Ginv_height + 1) / 2;
 
   {
-    El::copy::util::InterleaveMatrix(size_Ainv,
-                                     1,
-                                     workspace.LockedBuffer(offset, 0),
-                                     1,
-                                     size_Ainv,
-                                     m_kronecker_inverse_A.Buffer(),
-                                     1,
-                                     size_Ainv,
-                                     sync_infoA);
+    const auto view =
+      El::LockedView(workspace, El::IR(offset, offset + size_Ainv), El::ALL);
+    kfac::unpack_lower_tri(m_kronecker_inverse_A, view, sync_infoA);
   }
 
   offset += size_Ainv;
 
   {
-    El::copy::util::InterleaveMatrix(size_Ginv,
-                                     1,
-                                     workspace.LockedBuffer(offset, 0),
-                                     1,
-                                     size_Ginv,
-                                     m_kronecker_inverse_G.Buffer(),
-                                     1,
-                                     size_Ginv,
-                                     sync_infoG);
+    const auto view =
+      El::LockedView(workspace, El::IR(offset, offset + size_Ginv), El::ALL);
+    kfac::unpack_lower_tri(m_kronecker_inverse_G, view, sync_infoG);
   }
   return offset + size_Ginv;
 }
@@ -583,22 +583,20 @@ void kfac_block_gru<Device>::update_kronecker_inverse(
     this->get_workspace_matrix("ALinv_x", Aave_x.Height(), Aave_x.Height());
 
   if (use_eigen_decomposition) {
-    kfac::get_matrix_inverse(Ainv_h,
-                             ALinv_h,
-                             Aave_h,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
-    kfac::get_matrix_inverse(Ainv_x,
-                             ALinv_x,
-                             Aave_x,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_act * pi),
-                             0,
-                             false,
-                             sync_info);
+    this->get_matrix_inverse_batched(Ainv_h,
+                                     ALinv_h,
+                                     Aave_h,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_act * pi),
+                                     0,
+                                     false);
+    this->get_matrix_inverse_batched(Ainv_x,
+                                     ALinv_x,
+                                     Aave_x,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_act * pi),
+                                     0,
+                                     false);
   }
   else {
     kfac::get_matrix_inverse_eigen(Ainv_h,
@@ -646,14 +644,13 @@ void kfac_block_gru<Device>::update_kronecker_inverse(
     auto& GLinv = this->get_workspace_matrix(std::string("GLinv_" + mname),
                                              Gave.Height(),
                                              Gave.Height());
-    kfac::get_matrix_inverse(Ginv,
-                             GLinv,
-                             Gave,
-                             comm->am_trainer_master() && print_time,
-                             DataType(damping_err / pi),
-                             0,
-                             false,
-                             sync_info);
+    this->get_matrix_inverse_batched(Ginv,
+                                     GLinv,
+                                     Gave,
+                                     comm->am_trainer_master() && print_time,
+                                     DataType(damping_err / pi),
+                                     0,
+                                     false);
   }
 
   if (!this->m_has_kronecker_inverse)
@@ -914,6 +911,23 @@ int kfac_block_gru<Device>::get_inverse_matrices_size(lbann_comm* comm)
   return inverse_size;
 }
 
+template <El::Device Device>
+std::vector<double> kfac_block_gru<Device>::get_inverse_costs() const
+{
+  const double input_size = get_input_size();
+  const double hidden_size = get_hidden_size();
+  double cost = 0;
+  for (auto& matrix_type : kfac_gru_util::LEARNABLE_MATRICES) {
+    const double height = kfac_gru_util::is_matrix_height_hidden(matrix_type)
+                            ? hidden_size
+                            : input_size;
+    cost += height * height * height;
+  }
+  cost += input_size * input_size * input_size;
+  cost += hidden_size * hidden_size * hidden_size;
+  return {cost};
+}
+
 template <El::Device Device>
 std::vector<std::tuple<std::string, size_t, size_t>>
 kfac_block_gru<Device>::get_internal_matrix_info() const
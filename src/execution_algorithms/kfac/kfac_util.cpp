@@ -36,6 +36,9 @@
 #include <core/imports/mpi.hpp>
 #include <iomanip>
 #include <iterator>
+#include <map>
+#include <tuple>
+#include <type_traits>
 
 namespace lbann {
 namespace kfac {
@@ -339,6 +342,193 @@ void get_matrix_inverse_eigen(El::AbstractMatrix<DataType>& Ainv,
   El::Synchronize(sync_info);
 }
 
+template <>
+void get_matrix_inverses_batched(
+  const std::vector<inverse_request>& requests,
+  El::Matrix<DataType, El::Device::CPU>& workspace,
+  const bool report_time,
+  const El::SyncInfo<El::Device::CPU>& sync_info)
+{
+  // There is no launch overhead to save on CPU
+  for (const auto& request : requests) {
+    workspace.Resize(request.A->Height(), request.A->Height());
+    get_matrix_inverse(*request.Ainv,
+                       workspace,
+                       *request.A,
+                       report_time,
+                       request.damping,
+                       request.damping_bn_err,
+                       request.is_bn,
+                       sync_info);
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+template <>
+void get_matrix_inverses_batched(
+  const std::vector<inverse_request>& requests,
+  El::Matrix<DataType, El::Device::GPU>& workspace,
+  const bool report_time,
+  const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  using GPUMat = El::Matrix<DataType, El::Device::GPU>;
+
+  // Group the matrices by size and damping
+  using group_key = std::tuple<El::Int, DataType, DataType, bool>;
+  std::map<group_key, std::vector<const inverse_request*>> groups;
+  for (const auto& request : requests)
+    groups[group_key(request.A->Height(),
+                     request.damping,
+                     request.damping_bn_err,
+                     request.is_bn)]
+      .push_back(&request);
+
+  // Each group stores its factors, their inverses, then the inverses
+  // of the matrices, one matrix per column
+  El::Int workspace_size = 0;
+  for (const auto& [key, group] : groups)
+    workspace_size += 3 * std::get<0>(key) * std::get<0>(key) * group.size();
+  if (workspace.Height() != workspace_size || workspace.Width() != 1) {
+    // Make sure that no kernels are using this workspace.
+    El::Synchronize(sync_info);
+    workspace.Resize(workspace_size, 1);
+  }
+
+  El::Int offset = 0;
+  for (const auto& [key, group] : groups) {
+    const double t_start = get_time();
+    const auto [n, damping, damping_bn_err, is_bn] = key;
+    const El::Int batch_size = group.size();
+    const El::Int size = n * n;
+
+    GPUMat L, Linv, Ainv;
+    L.Attach(size, batch_size, workspace.Buffer(offset, 0), size);
+    offset += size * batch_size;
+    Linv.Attach(size, batch_size, workspace.Buffer(offset, 0), size);
+    offset += size * batch_size;
+    Ainv.Attach(size, batch_size, workspace.Buffer(offset, 0), size);
+    offset += size * batch_size;
+    for (El::Int b = 0; b < batch_size; ++b) {
+      GPUMat A_b;
+      A_b.Attach(n, n, L.Buffer(0, b), n);
+      El::Copy(*group[b]->A, A_b);
+    }
+
+    batched_cholesky_inverse(L,
+                             Linv,
+                             n,
+                             batch_size,
+                             damping,
+                             damping_bn_err,
+                             is_bn,
+                             sync_info);
+    hydrogen::gpu_blas::GemmStridedBatched(hydrogen::TransposeMode::TRANSPOSE,
+                                           hydrogen::TransposeMode::NORMAL,
+                                           n,
+                                           n,
+                                           n,
+                                           El::TypeTraits<DataType>::One(),
+                                           Linv.LockedBuffer(),
+                                           n,
+                                           size,
+                                           Linv.LockedBuffer(),
+                                           n,
+                                           size,
+                                           El::TypeTraits<DataType>::Zero(),
+                                           Ainv.Buffer(),
+                                           n,
+                                           size,
+                                           batch_size,
+                                           sync_info);
+
+    for (El::Int b = 0; b < batch_size; ++b) {
+      GPUMat Ainv_b;
+      Ainv_b.LockedAttach(n, n, Ainv.LockedBuffer(0, b), n);
+      El::Copy(Ainv_b, *group[b]->Ainv);
+    }
+
+    if (report_time) {
+      El::Synchronize(sync_info);
+      std::cout << "K-FAC: get_matrix_inverses_batched of " << batch_size
+                << " " << n << "x" << n << " matrices"
+                << " (damping=" << damping
+                << "): t=" << (get_time() - t_start) << std::endl;
+    }
+  }
+}
+#endif // LBANN_HAS_GPU
+
+template <El::Device Device>
+void get_matrix_eigen_decomposition(El::Matrix<DataType, Device>& Q,
+                                    El::Matrix<DataType, Device>& w,
+                                    El::Matrix<DataType, Device>& W,
+                                    const El::AbstractMatrix<DataType>& A,
+                                    const bool report_time,
+                                    const El::SyncInfo<Device>& sync_info)
+{
+  assert(A.Height() == A.Width());
+  El::Copy(A, W);
+
+  const double t_start = get_time();
+
+  El::HermitianEigCtrl<DataType> ctrl;
+  El::HermitianEig(El::UpperOrLowerNS::LOWER, W, w, Q, ctrl);
+
+  if (report_time) {
+    El::Synchronize(sync_info);
+    std::cout << "K-FAC: get_matrix_eigen_decomposition of"
+              << " " << A.Height() << "x" << A.Width() << " using Hydrogen: "
+              << " t_syevd=" << (get_time() - t_start) << std::endl;
+  }
+}
+
+template <El::Device Device>
+void get_matrix_eigenvalues_in_basis(El::Matrix<DataType, Device>& w,
+                                     El::Matrix<DataType, Device>& W,
+                                     const El::Matrix<DataType, Device>& Q,
+                                     const El::AbstractMatrix<DataType>& A,
+                                     const El::SyncInfo<Device>& sync_info)
+{
+  assert(A.Height() == Q.Height());
+  El::Gemm(El::NORMAL,
+           El::NORMAL,
+           El::TypeTraits<DataType>::One(),
+           A,
+           Q,
+           El::TypeTraits<DataType>::Zero(),
+           W);
+  w.Resize(Q.Width(), 1);
+  column_dots<Device>(w, Q, W, sync_info);
+}
+
+template <El::Device Device>
+void get_matrix_inverse_from_eigen(El::AbstractMatrix<DataType>& Ainv,
+                                   El::Matrix<DataType, Device>& W,
+                                   const El::Matrix<DataType, Device>& Q,
+                                   const El::Matrix<DataType, Device>& w,
+                                   const DataType damping,
+                                   const DataType damping_bn_err,
+                                   const bool is_bn,
+                                   const El::SyncInfo<Device>& sync_info)
+{
+  assert(Ainv.Height() == Q.Height());
+  assert(Ainv.Width() == Q.Height());
+  El::Copy(Q, W);
+  scale_columns_by_inverse<Device>(W,
+                                   w,
+                                   damping,
+                                   damping_bn_err,
+                                   is_bn,
+                                   sync_info);
+  El::Gemm(El::NORMAL,
+           El::TRANSPOSE,
+           El::TypeTraits<DataType>::One(),
+           W,
+           Q,
+           El::TypeTraits<DataType>::Zero(),
+           Ainv);
+}
+
 template <El::Device Device>
 std::string get_matrix_stat(const El::Matrix<DataType, Device>& X,
                             const char* name)
@@ -377,12 +567,69 @@ bool is_reduce_scatter_buffer_required(const kfac_reduce_scatter_mode mode)
   LBANN_ERROR("Invalid reduce-scatter mode");
 }
 
+namespace {
+/** @brief The fp16 type of a device, or void if it has none. */
+template <El::Device Device>
+struct half_comm_type
+{
+  using type = void;
+};
+#ifdef LBANN_HAS_HALF
+template <>
+struct half_comm_type<El::Device::CPU>
+{
+  using type = cpu_fp16;
+};
+#endif // LBANN_HAS_HALF
+#if defined LBANN_HAS_GPU && defined LBANN_HAS_GPU_FP16
+template <>
+struct half_comm_type<El::Device::GPU>
+{
+  using type = fp16;
+};
+#endif // defined LBANN_HAS_GPU && defined LBANN_HAS_GPU_FP16
+} // namespace
+
+template <El::Device Device>
+void allreduce_buffer(El::Matrix<DataType, Device>& buffer,
+                      lbann_comm* comm,
+                      const kfac_communication_precision precision,
+                      const bool scale)
+{
+  if (precision == kfac_communication_precision::FULL) {
+    comm->allreduce((El::AbstractMatrix<DataType>&)buffer,
+                    comm->get_KFAC_comm());
+    return;
+  }
+
+  using HalfType = typename half_comm_type<Device>::type;
+  if constexpr (std::is_void_v<HalfType>) {
+    LBANN_ERROR("K-FAC half-precision communication requires fp16 support");
+  }
+  else {
+    const DataType num_procs = comm->get_procs_per_trainer();
+    if (scale)
+      El::Scale(DataType(1) / num_procs, buffer);
+    El::Matrix<HalfType, Device> half_buffer;
+#ifdef HYDROGEN_HAVE_CUB
+    half_buffer.SetMemoryMode(1); // Use CUB GPU memory pool if possible
+#endif                            // HYDROGEN_HAVE_CUB
+    El::Copy(buffer, half_buffer);
+    comm->allreduce((El::AbstractMatrix<HalfType>&)half_buffer,
+                    comm->get_KFAC_comm());
+    El::Copy(half_buffer, buffer);
+    if (scale)
+      El::Scale(num_procs, buffer);
+  }
+}
+
 template <El::Device Device>
 void reduce_scatter_blocks(
   const std::vector<std::pair<size_t, El::AbstractMatrix<DataType>*>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
   lbann_comm* comm,
-  const kfac_reduce_scatter_mode mode)
+  const kfac_reduce_scatter_mode mode,
+  const kfac_communication_precision precision)
 {
 
   if (mode == kfac_reduce_scatter_mode::REDUCE) {
@@ -423,8 +670,7 @@ void reduce_scatter_blocks(
   }
 
   if (mode == kfac_reduce_scatter_mode::ALLREDUCE) {
-    comm->allreduce((El::AbstractMatrix<DataType>&)global_buffer,
-                    comm->get_KFAC_comm());
+    allreduce_buffer(global_buffer, comm, precision, true);
   }
   else {
     std::vector<size_t> recv_sizes;
@@ -584,11 +830,45 @@ void allgather_inverse_matrices_sizes(
                   comm->get_KFAC_comm());
 }
 
+template <El::Device Device>
+void start_allgather_inverse_matrices(
+  const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
+  El::Matrix<DataType, Device>& global_buffer,
+  lbann_comm* comm,
+  Al::request& req)
+{
+  El::Zeros(global_buffer, global_buffer.Height(), global_buffer.Width());
+  size_t offset = 0;
+  for (auto& block : blocks) {
+    if (block->is_inverse_proc_rank(comm->get_rank_in_trainer()))
+      offset = block->get_inverse_matrices(global_buffer, offset);
+    else
+      offset += block->get_inverse_matrices_size(comm);
+  }
+  comm->nb_allreduce((El::AbstractMatrix<DataType>&)global_buffer,
+                     comm->get_KFAC_comm(),
+                     req);
+}
+
+template <El::Device Device>
+void end_allgather_inverse_matrices(
+  const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
+  El::Matrix<DataType, Device>& global_buffer,
+  lbann_comm* comm,
+  Al::request& req)
+{
+  comm->wait(req);
+  size_t offset = 0;
+  for (auto& block : blocks)
+    offset = block->set_inverse_matrices(global_buffer, offset, comm);
+}
+
 template <El::Device Device>
 void allgather_inverse_matrices(
   const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,
   El::Matrix<DataType, Device>& global_buffer,
-  lbann_comm* comm)
+  lbann_comm* comm,
+  const kfac_communication_precision precision)
 {
 
   {
@@ -596,7 +876,7 @@ void allgather_inverse_matrices(
     size_t offset = 0;
     for (auto& block : blocks) {
       const bool is_my_block =
-        (block->get_inverse_proc_rank() == (size_t)comm->get_rank_in_trainer());
+        block->is_inverse_proc_rank(comm->get_rank_in_trainer());
       if (is_my_block) {
         offset = block->get_inverse_matrices(global_buffer, offset);
       }
@@ -606,8 +886,8 @@ void allgather_inverse_matrices(
     }
   }
 
-  comm->allreduce((El::AbstractMatrix<DataType>&)global_buffer,
-                  comm->get_KFAC_comm());
+  // Each entry has a single owner, so the sum needs no scaling
+  allreduce_buffer(global_buffer, comm, precision, false);
   {
     size_t offset = 0;
     for (auto& block : blocks) {
@@ -1478,6 +1758,43 @@ void add_to_diagonal(El::Matrix<DataType, El::Device::CPU>& A,
     A(i, i) += (is_bn && i >= A.Height() / 2 ? damping_bn_err : damping);
 }
 
+template <>
+void scale_columns_by_inverse(El::Matrix<DataType, El::Device::CPU>& A,
+                              const El::Matrix<DataType, El::Device::CPU>& B,
+                              const DataType damping,
+                              const DataType damping_bn_err,
+                              const bool is_bn,
+                              const El::SyncInfo<El::Device::CPU>& sync_info)
+{
+  const auto height = A.Height();
+  const auto width = A.Width();
+#pragma omp parallel for
+  for (int j = 0; j < width; j++) {
+    const DataType scale =
+      DataType(1) /
+      (B(j) + (is_bn && j >= width / 2 ? damping_bn_err : damping));
+    for (int i = 0; i < height; i++)
+      A(i, j) *= scale;
+  }
+}
+
+template <>
+void column_dots(El::Matrix<DataType, El::Device::CPU>& dots,
+                 const El::Matrix<DataType, El::Device::CPU>& A,
+                 const El::Matrix<DataType, El::Device::CPU>& B,
+                 const El::SyncInfo<El::Device::CPU>& sync_info)
+{
+  const auto height = A.Height();
+  const auto width = A.Width();
+#pragma omp parallel for
+  for (int j = 0; j < width; j++) {
+    DataType sum = 0;
+    for (int i = 0; i < height; i++)
+      sum += A(i, j) * B(i, j);
+    dots(j) = sum;
+  }
+}
+
 template <>
 void make_diagonal(El::Matrix<DataType, El::Device::CPU>& A,
                    El::Matrix<DataType, El::Device::CPU>& B,
@@ -1575,6 +1892,28 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
     T damping_bn_err,                                                          \
     bool is_bn,                                                                \
     const El::SyncInfo<Device>& sync_info);                                    \
+  template void get_matrix_eigen_decomposition(                                \
+    El::Matrix<T, Device>& Q,                                                  \
+    El::Matrix<T, Device>& w,                                                  \
+    El::Matrix<T, Device>& W,                                                  \
+    const El::AbstractMatrix<T>& A,                                            \
+    bool report_time,                                                          \
+    const El::SyncInfo<Device>& sync_info);                                    \
+  template void get_matrix_eigenvalues_in_basis(                               \
+    El::Matrix<T, Device>& w,                                                  \
+    El::Matrix<T, Device>& W,                                                  \
+    const El::Matrix<T, Device>& Q,                                            \
+    const El::AbstractMatrix<T>& A,                                            \
+    const El::SyncInfo<Device>& sync_info);                                    \
+  template void get_matrix_inverse_from_eigen(                                 \
+    El::AbstractMatrix<T>& Ainv,                                               \
+    El::Matrix<T, Device>& W,                                                  \
+    const El::Matrix<T, Device>& Q,                                            \
+    const El::Matrix<T, Device>& w,                                            \
+    T damping,                                                                 \
+    T damping_bn_err,                                                          \
+    bool is_bn,                                                                \
+    const El::SyncInfo<Device>& sync_info);                                    \
   template std::string get_matrix_stat(const El::Matrix<T, Device>& X,         \
                                        const char* name);                      \
   template void allreduce_lower_tri(El::AbstractMatrix<T>& A,                  \
@@ -1585,7 +1924,12 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
     const std::vector<std::pair<size_t, El::AbstractMatrix<T>*>>& blocks,      \
     El::Matrix<T, Device>& global_buffer,                                      \
     lbann_comm* comm,                                                          \
-    const kfac_reduce_scatter_mode mode);                                      \
+    const kfac_reduce_scatter_mode mode,                                       \
+    const kfac_communication_precision precision);                             \
+  template void allreduce_buffer(El::Matrix<T, Device>& buffer,                \
+                                 lbann_comm* comm,                             \
+                                 kfac_communication_precision precision,       \
+                                 bool scale);                                  \
   template void allgather_blocks(                                              \
     const std::vector<std::pair<size_t, El::AbstractMatrix<T>*>>& blocks,      \
     El::Matrix<T, Device>& local_buffer,                                       \
@@ -1599,7 +1943,18 @@ void unpack_lower_tri(El::Matrix<DataType, El::Device::CPU>& A,
   template void allgather_inverse_matrices(                                    \
     const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,            \
     El::Matrix<T, Device>& global_buffer,                                      \
-    lbann_comm* comm);
+    lbann_comm* comm,                                                          \
+    kfac_communication_precision precision);                                   \
+  template void start_allgather_inverse_matrices(                              \
+    const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,            \
+    El::Matrix<T, Device>& global_buffer,                                      \
+    lbann_comm* comm,                                                          \
+    Al::request& req);                                                         \
+  template void end_allgather_inverse_matrices(                                \
+    const std::vector<std::shared_ptr<kfac_block<Device>>>& blocks,            \
+    El::Matrix<T, Device>& global_buffer,                                      \
+    lbann_comm* comm,                                                          \
+    Al::request& req);
 #define PROTO_DEVICECOMM(T, Device)                                            \
   template void TranslateBetweenGridsVCAsync(                                  \
     const El::DistMatrix<T, El::STAR, El::VC, El::ELEMENT, Device>& A,         \
@@ -65,6 +65,90 @@ __global__ void kfac_make_diagonal_kernel(TensorDataType* __restrict__ A,
   }
 }
 
+template <typename TensorDataType>
+__global__ void
+kfac_scale_columns_by_inverse_kernel(TensorDataType* __restrict__ A,
+                                     const TensorDataType* __restrict__ B,
+                                     const size_t height,
+                                     const size_t width,
+                                     const TensorDataType value,
+                                     const TensorDataType value_bn_err,
+                                     const bool is_bn)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  if (gid < height * width) {
+    const size_t col = gid / height;
+    A[gid] /= B[col] + (is_bn && col >= width / 2 ? value_bn_err : value);
+  }
+}
+
+template <typename TensorDataType>
+__global__ void kfac_column_dots_kernel(TensorDataType* __restrict__ dots,
+                                        const TensorDataType* __restrict__ A,
+                                        const TensorDataType* __restrict__ B,
+                                        const size_t height,
+                                        const size_t width)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  if (gid < width) {
+    TensorDataType sum = 0;
+    for (size_t i = 0; i < height; i++)
+      sum += A[i + gid * height] * B[i + gid * height];
+    dots[gid] = sum;
+  }
+}
+
+/** @brief One block per matrix: lower Cholesky factorization of a
+ *  damped matrix in place, then the inverse of the factor by forward
+ *  substitution, one column per thread. Meant for small matrices. */
+template <typename TensorDataType>
+__global__ void
+kfac_batched_cholesky_inverse_kernel(TensorDataType* __restrict__ A,
+                                     TensorDataType* __restrict__ Linv,
+                                     const size_t height,
+                                     const TensorDataType value,
+                                     const TensorDataType value_bn_err,
+                                     const bool is_bn)
+{
+  const size_t size = height * height;
+  TensorDataType* __restrict__ L = A + blockIdx.x * size;
+  TensorDataType* __restrict__ X = Linv + blockIdx.x * size;
+
+  for (size_t i = threadIdx.x; i < height; i += blockDim.x)
+    L[i + i * height] += (is_bn && i >= height / 2 ? value_bn_err : value);
+  __syncthreads();
+
+  for (size_t j = 0; j < height; j++) {
+    if (threadIdx.x == 0)
+      L[j + j * height] = gpu_lib::sqrt(L[j + j * height]);
+    __syncthreads();
+    const TensorDataType diag = L[j + j * height];
+    for (size_t i = j + 1 + threadIdx.x; i < height; i += blockDim.x)
+      L[i + j * height] /= diag;
+    __syncthreads();
+    const size_t trailing = height - j - 1;
+    for (size_t k = threadIdx.x; k < trailing * trailing; k += blockDim.x) {
+      const size_t row = j + 1 + k % trailing;
+      const size_t col = j + 1 + k / trailing;
+      if (row >= col)
+        L[row + col * height] -= L[row + j * height] * L[col + j * height];
+    }
+    __syncthreads();
+  }
+
+  for (size_t col = threadIdx.x; col < height; col += blockDim.x) {
+    for (size_t row = 0; row < height; row++) {
+      TensorDataType x = (row == col ? 1 : 0);
+      if (row >= col) {
+        for (size_t k = col; k < row; k++)
+          x -= L[row + k * height] * X[k + col * height];
+        x /= L[row + row * height];
+      }
+      X[row + col * height] = x;
+    }
+  }
+}
+
 template <typename TensorDataType>
 __global__ void kfac_fill_upper_tri_kernel(TensorDataType* __restrict__ A,
                                            const size_t height)
@@ -202,6 +286,85 @@ void make_diagonal(El::Matrix<DataType, El::Device::GPU>& A,
   }
 }
 
+template <>
+void scale_columns_by_inverse(
+  El::Matrix<DataType, El::Device::GPU>& A,
+  const El::Matrix<DataType, El::Device::GPU>& B,
+  const DataType damping,
+  const DataType damping_bn_err,
+  const bool is_bn,
+  const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const size_t height = A.Height();
+  const size_t width = A.Width();
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (height * width + block_size - 1) / block_size;
+  if (grid_size > 0) {
+    hydrogen::gpu::LaunchKernel(kfac_scale_columns_by_inverse_kernel<DataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                sync_info,
+                                A.Buffer(),
+                                B.LockedBuffer(),
+                                height,
+                                width,
+                                damping,
+                                damping_bn_err,
+                                is_bn);
+  }
+}
+
+template <>
+void column_dots(El::Matrix<DataType, El::Device::GPU>& dots,
+                 const El::Matrix<DataType, El::Device::GPU>& A,
+                 const El::Matrix<DataType, El::Device::GPU>& B,
+                 const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const size_t height = A.Height();
+  const size_t width = A.Width();
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (width + block_size - 1) / block_size;
+  if (grid_size > 0) {
+    hydrogen::gpu::LaunchKernel(kfac_column_dots_kernel<DataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                sync_info,
+                                dots.Buffer(),
+                                A.LockedBuffer(),
+                                B.LockedBuffer(),
+                                height,
+                                width);
+  }
+}
+
+template <>
+void batched_cholesky_inverse(El::Matrix<DataType, El::Device::GPU>& A,
+                              El::Matrix<DataType, El::Device::GPU>& Linv,
+                              const El::Int n,
+                              const El::Int batch_size,
+                              const DataType damping,
+                              const DataType damping_bn_err,
+                              const bool is_bn,
+                              const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  constexpr size_t block_size = 256;
+  if (n > 0 && batch_size > 0) {
+    hydrogen::gpu::LaunchKernel(kfac_batched_cholesky_inverse_kernel<DataType>,
+                                batch_size,
+                                block_size,
+                                0,
+                                sync_info,
+                                A.Buffer(),
+                                Linv.Buffer(),
+                                n,
+                                damping,
+                                damping_bn_err,
+                                is_bn);
+  }
+}
+
 template <typename TensorDataType>
 struct inverse_op_gpu
 {
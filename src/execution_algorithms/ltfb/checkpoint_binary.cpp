@@ -37,12 +37,14 @@ namespace lbann {
 
 namespace ltfb {
 
-CheckpointBinary::CheckpointBinary(std::set<std::string> const& weights_names)
-  : BaseType(weights_names)
+CheckpointBinary::CheckpointBinary(std::set<std::string> const& weights_names,
+                                   bool compress)
+  : BaseType(weights_names), compress_{compress}
 {}
 
-CheckpointBinary::CheckpointBinary(std::set<std::string>&& weights_names)
-  : BaseType(std::move(weights_names))
+CheckpointBinary::CheckpointBinary(std::set<std::string>&& weights_names,
+                                   bool compress)
+  : BaseType(std::move(weights_names)), compress_{compress}
 {}
 
 std::unique_ptr<model>
@@ -69,7 +71,7 @@ CheckpointBinary::get_partner_model(model const& m,
       }
     }
   }
-  exchange(comm, partner_model, partner_trainer);
+  exchange(comm, partner_model, partner_trainer, compress_);
   restore_model_weights(partner_model, restore_weights);
 
   return partner_model_ptr;
@@ -27,6 +27,7 @@
 #define LBANN_SRC_EXECUTION_ALGORITHMS_LTFB_CHECKPOINT_COMMON_HPP_INCLUDED
 
 #include "lbann/models/model.hpp"
+#include "lbann/utils/compression.hpp"
 #include "lbann/weights/data_type_weights_impl.hpp"
 
 #include <unordered_set>
@@ -160,9 +161,14 @@ inline static std::string sendrecv_string(lbann_comm const& c,
   return tgt;
 }
 
+// Exchange an object with the partner trainer. If compress is set,
+// the serialized object is compressed with zlib on the trainer
+// master; both partners must agree on it.
 template <typename T>
-inline static void
-exchange(lbann_comm const& c, T& object, El::Int partner_trainer)
+inline static void exchange(lbann_comm const& c,
+                            T& object,
+                            El::Int partner_trainer,
+                            bool compress = false)
 {
   std::ostringstream oss;
   {
@@ -172,7 +178,15 @@ exchange(lbann_comm const& c, T& object, El::Int partner_trainer)
   }
   c.trainer_barrier(); // I don't think this is necessary
   {
-    std::istringstream iss{sendrecv_string(c, oss.str(), partner_trainer)};
+    std::string str = oss.str();
+    if (compress && c.am_trainer_master()) {
+      str = utils::compress_string(str);
+    }
+    str = sendrecv_string(c, str, partner_trainer);
+    if (compress && c.am_trainer_master()) {
+      str = utils::decompress_string(str);
+    }
+    std::istringstream iss{std::move(str)};
     RootedBinaryInputArchive ar(iss, c.get_trainer_grid());
     ar(object);
   }
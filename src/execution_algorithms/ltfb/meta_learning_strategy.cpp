@@ -26,6 +26,7 @@
 #include "lbann/execution_algorithms/ltfb/meta_learning_strategy.hpp"
 #include "lbann/execution_algorithms/ltfb/random_pairwise_exchange.hpp"
 #include "lbann/execution_algorithms/ltfb/regularized_evolution.hpp"
+#include "lbann/execution_algorithms/ltfb/successive_halving.hpp"
 #include "lbann/execution_algorithms/ltfb/truncation_selection_exchange.hpp"
 #include "lbann/utils/make_abstract.hpp"
 #include "lbann/utils/protobuf.hpp"
@@ -45,6 +46,8 @@ lbann::ltfb::MetaLearningStrategyFactory build_default_factory()
                            lbann::make<TruncationSelectionExchange>);
   factory.register_builder("RegularizedEvolution",
                            lbann::make<RegularizedEvolution>);
+  factory.register_builder("SuccessiveHalving",
+                           lbann::make<SuccessiveHalving>);
   return factory;
 }
 
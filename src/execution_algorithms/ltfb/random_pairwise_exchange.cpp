@@ -38,6 +38,7 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/protobuf.hpp"
+#include "lbann/weights/flat_weights_state.hpp"
 
 #include "lbann/proto/training_algorithm.pb.h"
 
@@ -132,6 +133,29 @@ bool local_wins(EvalType local,
   return false; // Silence compiler warning about no return.
 }
 
+/** @brief Copy the weights of a winning model into the local model
+ *         in place.
+ *
+ *  Only done if every process of the trainer has packed flat weights
+ *  state with the same layout in both models. Otherwise nothing is
+ *  copied and false is returned.
+ */
+bool copy_flat_weights_state(model& m, model& winner)
+{
+  auto* state = m.get_flat_weights_state();
+  auto* winner_state = winner.get_flat_weights_state();
+  const bool local =
+    (state != nullptr && winner_state != nullptr &&
+     state->get_layout_hash() == winner_state->get_layout_hash() &&
+     state->is_packed() && winner_state->is_packed());
+  auto const& comm = *m.get_comm();
+  if (comm.trainer_allreduce(static_cast<int>(local), El::mpi::MIN) == 0) {
+    return false;
+  }
+  state->copy_from(*winner_state);
+  return true;
+}
+
 } // namespace
 
 // RandomPairwiseExchange implementation
@@ -303,6 +327,11 @@ void RandomPairwiseExchange::select_next(model& m,
 
   LBANN_LOG_WORLD_MASTER(comm, message_prefix, "starting tournament...");
 
+  if (m_comm_algo->is_asynchronous()) {
+    select_next_async(m, ctxt, dc, message_prefix);
+    return;
+  }
+
   int const local_trainer = comm.get_trainer_rank();
   int const partner_trainer = get_partner_trainer(comm);
 
@@ -328,7 +357,10 @@ void RandomPairwiseExchange::select_next(model& m,
     (local_is_better(local_scores, partner_scores) ? local_trainer
                                                    : partner_trainer);
 
-  if (tournament_winner == partner_trainer) {
+  // A model whose layers don't change only needs the winning weights
+  bool const keep_layers = !m_mutate_algo->changes_model();
+  if (tournament_winner == partner_trainer &&
+      !(keep_layers && copy_flat_weights_state(m, *partner_model))) {
     m = std::move(*partner_model);
 
     // Winning model mutates according to mutation strategy
@@ -341,6 +373,9 @@ void RandomPairwiseExchange::select_next(model& m,
             trainer.get_grids(),
             /*force*/ true);
   }
+  if (keep_layers) {
+    m_comm_algo->release_partner_model(std::move(partner_model));
+  }
 
   LBANN_LOG_TRAINER_MASTER(comm,
                            message_prefix,
@@ -359,6 +394,65 @@ void RandomPairwiseExchange::select_next(model& m,
                            ")");
 }
 
+void RandomPairwiseExchange::select_next_async(
+  model& m,
+  ltfb::LTFBExecutionContext& ctxt,
+  data_coordinator& dc,
+  std::string const& message_prefix) const
+{
+  auto const& comm = *(m.get_comm());
+  int const local_trainer = comm.get_trainer_rank();
+
+  // The partner's model was sent at the previous tournament and
+  // arrived while this trainer trained. The first tournament only
+  // starts an exchange.
+  El::Int partner_trainer = -1;
+  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "finishing model exchange...");
+  model* partner_model = m_comm_algo->finish_partner_exchange(partner_trainer);
+  if (partner_model != nullptr) {
+    LBANN_LOG_WORLD_MASTER(comm, message_prefix, "evaluating local model...");
+    auto const local_scores = evaluate_model(m, ctxt, dc);
+    LBANN_LOG_WORLD_MASTER(comm,
+                           message_prefix,
+                           "evaluating partner model...");
+    auto const partner_scores = evaluate_model(*partner_model, ctxt, dc);
+    El::Int const tournament_winner =
+      (local_is_better(local_scores, partner_scores) ? local_trainer
+                                                     : partner_trainer);
+    if (tournament_winner == partner_trainer &&
+        !(!m_mutate_algo->changes_model() &&
+          copy_flat_weights_state(m, *partner_model))) {
+      // Copy, so the shadow model keeps receiving exchanges
+      m = *partner_model;
+      m_mutate_algo->mutate(m, ctxt.get_step());
+      auto& trainer = get_trainer();
+      auto&& metadata = dc.get_dr_metadata();
+      m.setup(trainer.get_max_mini_batch_size(),
+              metadata,
+              trainer.get_grids(),
+              /*force*/ true);
+    }
+    LBANN_LOG_TRAINER_MASTER(comm,
+                             message_prefix,
+                             "trainer ",
+                             local_trainer,
+                             " selected model from trainer ",
+                             tournament_winner,
+                             " (trainer ",
+                             local_trainer,
+                             " score = ",
+                             stringify(local_scores),
+                             ", trainer ",
+                             partner_trainer,
+                             " score = ",
+                             stringify(partner_scores),
+                             ")");
+  }
+
+  LBANN_LOG_WORLD_MASTER(comm, message_prefix, "starting model exchange...");
+  m_comm_algo->start_partner_exchange(m, get_partner_trainer(comm));
+}
+
 } // namespace ltfb
 } // namespace lbann
 
@@ -378,9 +472,10 @@ make_checkpoint_binary(std::set<std::string> weights_names,
 {
   using CkptBinary =
     lbann_data::RandomPairwiseExchange::ExchangeStrategy::CheckpointBinary;
-  LBANN_ASSERT(dynamic_cast<CkptBinary const*>(&msg));
+  auto const& params = dynamic_cast<CkptBinary const&>(msg);
   return std::make_unique<lbann::ltfb::CheckpointBinary>(
-    std::move(weights_names));
+    std::move(weights_names),
+    params.compress());
 }
 
 std::unique_ptr<lbann::ltfb::CheckpointFile>
@@ -401,9 +496,22 @@ make_sendrecv_weights(std::set<std::string> weights_names,
   using SendRecvWeights =
     lbann_data::RandomPairwiseExchange::ExchangeStrategy::SendRecvWeights;
   auto const& params = dynamic_cast<SendRecvWeights const&>(msg);
+  auto const& precision = params.communication_precision();
+  if (!precision.empty() && precision != "fp32" && precision != "fp16") {
+    LBANN_ERROR("invalid sendrecv_weights communication precision \"",
+                precision,
+                "\" (expected \"fp32\" or \"fp16\")");
+  }
+  bool const half_precision = (precision == "fp16");
+  if (half_precision && params.asynchronous()) {
+    LBANN_ERROR("sendrecv_weights does not support fp16 communication "
+                "in asynchronous exchanges");
+  }
   return std::make_unique<lbann::ltfb::SendRecvWeights>(
     std::move(weights_names),
-    params.exchange_hyperparameters());
+    params.exchange_hyperparameters(),
+    params.asynchronous(),
+    half_precision);
 }
 
 lbann::ltfb::RandomPairwiseExchange::metric_strategy
@@ -70,7 +70,8 @@ RegularizedEvolution::RegularizedEvolution(RegularizedEvolution const& other)
   : m_mutate_algo{other.m_mutate_algo->clone()},
     m_metric_name{other.m_metric_name},
     m_metric_strategy{other.m_metric_strategy},
-    m_sample_size{other.m_sample_size}
+    m_sample_size{other.m_sample_size},
+    m_tournament_mini_batches{other.m_tournament_mini_batches}
 {}
 
 EvalType RegularizedEvolution::evaluate_model(model& m,
@@ -94,7 +95,13 @@ EvalType RegularizedEvolution::evaluate_model(model& m,
   m.mark_data_store_explicitly_loading(execution_mode::tournament);
 
   // Evaluate model on test (or validation?) set
-  get_trainer().evaluate(&m, execution_mode::tournament);
+  get_trainer().evaluate(&m,
+                         execution_mode::tournament,
+                         m_tournament_mini_batches);
+  if (m_tournament_mini_batches > 0) {
+    // Don't leave a fetch of the partial epoch running during training
+    dc.collect_background_data_fetch(execution_mode::tournament);
+  }
 
   // Get metric values
   bool found_metric = false;
@@ -274,9 +281,11 @@ lbann::make<lbann::ltfb::RegularizedEvolution>(
 
   using MutationStrategyType = lbann::ltfb::MutationStrategy;
 
-  return std::make_unique<lbann::ltfb::RegularizedEvolution>(
+  auto strategy = std::make_unique<lbann::ltfb::RegularizedEvolution>(
     msg.metric_name(),
     to_lbann(msg.metric_strategy()),
     make_abstract<MutationStrategyType>(msg.mutation_strategy()),
     msg.sample_size());
+  strategy->set_tournament_mini_batches(msg.tournament_mini_batches());
+  return strategy;
 }
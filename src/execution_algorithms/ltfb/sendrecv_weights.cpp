@@ -34,6 +34,7 @@
 #include "lbann/optimizers/sgd.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/weights/data_type_weights_impl.hpp"
+#include "lbann/weights/flat_weights_state.hpp"
 
 #include "checkpoint_common.hpp"
 
@@ -55,20 +56,74 @@ bool have_same_optimizer_type(lbann::lbann_comm const& c,
              El::SyncInfo<El::Device::CPU>{});
   return my_type_hash == other_type_hash;
 }
+
+/** @brief Whether every process of this trainer and of the partner
+ *         trainer has packed flat state with the same layout as its
+ *         counterpart.
+ */
+bool can_exchange_flat_state(lbann::lbann_comm const& c,
+                             lbann::flat_weights_state& state,
+                             El::Int partner_trainer,
+                             bool source_packed = true)
+{
+  const int rank = c.get_rank_in_trainer();
+  std::size_t const mine[2] = {source_packed && state.is_packed(),
+                               state.get_layout_hash()};
+  std::size_t other[2] = {0, 0};
+  c.sendrecv(mine,
+             2,
+             partner_trainer,
+             rank,
+             other,
+             2,
+             partner_trainer,
+             rank,
+             El::SyncInfo<El::Device::CPU>{});
+  const bool local =
+    (mine[0] != 0 && other[0] != 0 && mine[1] == other[1]);
+  return c.trainer_allreduce(static_cast<int>(local), El::mpi::MIN) != 0;
+}
+
+/** @brief Rank in the world of this process's counterpart in the
+ *         partner trainer.
+ */
+El::Int get_partner_rank_in_world(lbann::lbann_comm const& c,
+                                  El::Int partner_trainer)
+{
+  const bool subgrid = c.get_grid_type() != lbann::GridType::NO_GRID;
+  return (partner_trainer * c.get_procs_per_trainer() * (subgrid ? 2 : 1) +
+          c.get_rank_in_trainer());
+}
 } // namespace
 
 namespace lbann {
 namespace ltfb {
 
 SendRecvWeights::SendRecvWeights(std::set<std::string> const& weights_names,
-                                 bool exchange_hyperparameters)
-  : BaseType(weights_names), exchange_hyperparams_{exchange_hyperparameters}
+                                 bool exchange_hyperparameters,
+                                 bool asynchronous,
+                                 bool half_precision)
+  : BaseType(weights_names),
+    exchange_hyperparams_{exchange_hyperparameters},
+    asynchronous_{asynchronous},
+    half_precision_{half_precision}
 {}
 
 SendRecvWeights::SendRecvWeights(std::set<std::string>&& weights_names,
-                                 bool exchange_hyperparameters)
+                                 bool exchange_hyperparameters,
+                                 bool asynchronous,
+                                 bool half_precision)
   : BaseType(std::move(weights_names)),
-    exchange_hyperparams_{exchange_hyperparameters}
+    exchange_hyperparams_{exchange_hyperparameters},
+    asynchronous_{asynchronous},
+    half_precision_{half_precision}
+{}
+
+SendRecvWeights::SendRecvWeights(SendRecvWeights const& other)
+  : BaseType(other),
+    exchange_hyperparams_{other.exchange_hyperparams_},
+    asynchronous_{other.asynchronous_},
+    half_precision_{other.half_precision_}
 {}
 
 std::unique_ptr<model>
@@ -77,21 +132,48 @@ SendRecvWeights::get_partner_model(model const& m,
                                    size_t /*step*/)
 {
   auto& comm = *m.get_comm();
+  auto* flat_state = m.get_flat_weights_state();
+  const bool flat_exchange = (flat_state != nullptr &&
+                              this->weights_names().empty() &&
+                              !exchange_hyperparams_);
 
-  // Start by copying this model, then do the exchange.
-  auto partner_model_ptr = std::make_unique<model>(m);
+  // Start from a copy of this model, then do the exchange. A pooled
+  // copy with the same layout only needs the local state.
+  std::unique_ptr<model> partner_model_ptr;
+  if (flat_exchange && pooled_model_ != nullptr) {
+    auto* pooled_state = pooled_model_->get_flat_weights_state();
+    if (pooled_state != nullptr &&
+        pooled_state->get_layout_hash() == flat_state->get_layout_hash() &&
+        pooled_state->is_packed() && flat_state->is_packed()) {
+      pooled_state->copy_from(*flat_state);
+      partner_model_ptr = std::move(pooled_model_);
+    }
+  }
+  pooled_model_.reset();
+  const bool reused = (partner_model_ptr != nullptr);
+  if (!reused) {
+    partner_model_ptr = std::make_unique<model>(m);
+  }
   model& partner_model = *partner_model_ptr;
 
   // Get partner process
-  const El::Int rank_in_trainer = comm.get_rank_in_trainer();
-  const El::Int procs_per_trainer = comm.get_procs_per_trainer();
-
-  const bool subgrid = m.get_comm()->get_grid_type() != GridType::NO_GRID;
   const El::Int partner_rank_in_world =
-    (partner_trainer * procs_per_trainer * (subgrid ? 2 : 1) + rank_in_trainer);
-  auto& w = comm.get_world_comm();
+    get_partner_rank_in_world(comm, partner_trainer);
   comm.intertrainer_barrier();
 
+  // Exchange all values and optimizer state at once if they are in
+  // flat buffers with the same layout as the partner's
+  if (flat_exchange) {
+    if (!reused) {
+      partner_model.setup_flat_weights_state();
+    }
+    auto& partner_state = *partner_model.get_flat_weights_state();
+    if (can_exchange_flat_state(comm, partner_state, partner_trainer)) {
+      partner_state.sendrecv(comm, partner_rank_in_world, half_precision_);
+      return partner_model_ptr;
+    }
+  }
+
   // Exchange weights with partner
   for (auto&& w_ptr : partner_model.get_weights()) {
     // Skip weights if name isn't in list
@@ -154,6 +236,28 @@ SendRecvWeights::get_partner_model(model const& m,
       using AdamType = adam<TensorDataType>;
       auto* send_adam = dynamic_cast<AdamType*>(send_weights.get_optimizer());
       auto* recv_adam = dynamic_cast<AdamType*>(recv_weights.get_optimizer());
+      if (send_adam != nullptr && recv_adam != nullptr &&
+          send_adam->get_compressed_moment1() != nullptr &&
+          recv_adam->get_compressed_moment1() != nullptr) {
+        auto exchange_state = [&](compressed_state& send_state,
+                                  compressed_state& recv_state) {
+          El::SendRecv(send_state.get_codes(),
+                       recv_state.get_codes(),
+                       comm.get_world_comm(),
+                       partner_rank_in_world,
+                       partner_rank_in_world);
+          El::SendRecv(send_state.get_scales(),
+                       recv_state.get_scales(),
+                       comm.get_world_comm(),
+                       partner_rank_in_world,
+                       partner_rank_in_world);
+        };
+        exchange_state(*send_adam->get_compressed_moment1(),
+                       *recv_adam->get_compressed_moment1());
+        exchange_state(*send_adam->get_compressed_moment2(),
+                       *recv_adam->get_compressed_moment2());
+        continue;
+      }
       if (send_adam != nullptr && recv_adam != nullptr) {
         El::SendRecv(send_adam->get_moment1().LockedMatrix(),
                      recv_adam->get_moment1().Matrix(),
@@ -173,6 +277,69 @@ SendRecvWeights::get_partner_model(model const& m,
   return partner_model_ptr;
 }
 
+void SendRecvWeights::release_partner_model(std::unique_ptr<model> m)
+{
+  pooled_model_ = std::move(m);
+}
+
+void SendRecvWeights::start_partner_exchange(model const& m,
+                                             El::Int partner_trainer)
+{
+  if (pending_partner_ >= 0) {
+    LBANN_ERROR("a model exchange is already in progress");
+  }
+  auto& comm = *m.get_comm();
+  pending_partner_ = partner_trainer;
+
+  // Only complete flat state is exchanged in the background
+  auto* flat_state = m.get_flat_weights_state();
+  if (flat_state == nullptr || !this->weights_names().empty() ||
+      exchange_hyperparams_) {
+    shadow_model_ = get_partner_model(m, partner_trainer, 0);
+    return;
+  }
+
+  // Reuse the shadow model unless the local layout changed, e.g.
+  // because a mutated model won the last tournament
+  if (shadow_model_ != nullptr) {
+    auto* shadow_state = shadow_model_->get_flat_weights_state();
+    if (shadow_state == nullptr ||
+        shadow_state->get_layout_hash() != flat_state->get_layout_hash()) {
+      shadow_model_.reset();
+    }
+  }
+  if (shadow_model_ == nullptr) {
+    shadow_model_ = std::make_unique<model>(m);
+    shadow_model_->setup_flat_weights_state();
+  }
+
+  auto& shadow_state = *shadow_model_->get_flat_weights_state();
+  if (!can_exchange_flat_state(comm,
+                               shadow_state,
+                               partner_trainer,
+                               flat_state->is_packed())) {
+    shadow_model_ = get_partner_model(m, partner_trainer, 0);
+    return;
+  }
+  shadow_state.start_sendrecv(*flat_state,
+                              comm,
+                              get_partner_rank_in_world(comm, partner_trainer));
+}
+
+model* SendRecvWeights::finish_partner_exchange(El::Int& partner_trainer)
+{
+  partner_trainer = pending_partner_;
+  if (pending_partner_ < 0) {
+    return nullptr;
+  }
+  pending_partner_ = -1;
+  auto* shadow_state = shadow_model_->get_flat_weights_state();
+  if (shadow_state != nullptr && shadow_state->is_sendrecv_pending()) {
+    shadow_state->finish_sendrecv();
+  }
+  return shadow_model_.get();
+}
+
 } // namespace ltfb
 
 } // namespace lbann
@@ -0,0 +1,317 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/execution_algorithms/ltfb/mutation_strategy.hpp"
+
+#include "lbann/execution_algorithms/ltfb/successive_halving.hpp"
+
+#include "checkpoint_common.hpp"
+
+#include "lbann/base.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/data_coordinator/data_coordinator.hpp"
+#include "lbann/metrics/metric.hpp"
+#include "lbann/models/model.hpp"
+#include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+#include "lbann/proto/training_algorithm.pb.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lbann {
+namespace ltfb {
+
+// SuccessiveHalving Implementation
+
+SuccessiveHalving::SuccessiveHalving(
+  std::string metric_name,
+  metric_strategy winner_strategy,
+  std::unique_ptr<MutationStrategy> mutate_algo,
+  size_t reduction_factor,
+  size_t min_rounds,
+  size_t max_rungs)
+  : m_mutate_algo{std::move(mutate_algo)},
+    m_metric_name{std::move(metric_name)},
+    m_metric_strategy{winner_strategy},
+    m_reduction_factor{reduction_factor},
+    m_min_rounds{min_rounds},
+    m_max_rungs{max_rungs}
+{
+  if (m_reduction_factor < 2) {
+    LBANN_ERROR("successive halving reduction factor must be at least 2 ",
+                "(got ",
+                m_reduction_factor,
+                ")");
+  }
+  if (m_min_rounds == 0) {
+    LBANN_ERROR("successive halving needs at least one round before "
+                "the first rung");
+  }
+}
+
+SuccessiveHalving::SuccessiveHalving(SuccessiveHalving const& other)
+  : m_mutate_algo{other.m_mutate_algo->clone()},
+    m_metric_name{other.m_metric_name},
+    m_metric_strategy{other.m_metric_strategy},
+    m_reduction_factor{other.m_reduction_factor},
+    m_min_rounds{other.m_min_rounds},
+    m_max_rungs{other.m_max_rungs},
+    m_trial_rounds{other.m_trial_rounds},
+    m_rung_scores{other.m_rung_scores}
+{}
+
+EvalType SuccessiveHalving::evaluate_model(model& m,
+                                           LTFBExecutionContext& ctxt,
+                                           data_coordinator& dc) const
+{
+  // Make sure data readers finish asynchronous work
+  const auto original_mode = ctxt.get_execution_mode();
+  dc.collect_background_data_fetch(original_mode);
+
+  if (!dc.is_execution_mode_valid(execution_mode::tournament)) {
+    LBANN_ERROR("Successive halving requires ",
+                to_string(execution_mode::tournament),
+                " execution mode");
+  }
+
+  // Mark the data store as loading - Note that this is a temporary fix
+  // for the current use of the tournament
+  m.mark_data_store_explicitly_loading(execution_mode::tournament);
+
+  get_trainer().evaluate(&m, execution_mode::tournament);
+
+  // Get metric value
+  bool found_metric = false;
+  EvalType score = 0.f;
+  for (const auto& met : m.get_metrics()) {
+    if (met->name() == m_metric_name) {
+      found_metric = true;
+      score = met->get_mean_value(execution_mode::tournament);
+      break;
+    }
+  }
+  if (!found_metric) {
+    LBANN_ERROR("could not find metric \"",
+                m_metric_name,
+                "\" in model \"",
+                m.get_name(),
+                "\"");
+  }
+
+  m.make_data_store_preloaded(execution_mode::tournament);
+
+  // Clean up and return metric score
+  m.reset_mode(ctxt, original_mode);
+  dc.reset_mode(ctxt);
+  return score;
+}
+
+bool SuccessiveHalving::is_better(EvalType a, EvalType b) const noexcept
+{
+  return (m_metric_strategy == metric_strategy::HIGHER_IS_BETTER ? a > b
+                                                                 : a < b);
+}
+
+bool SuccessiveHalving::is_promoted(EvalType score, size_t rung) const
+{
+  // Keep the top ceil(n/reduction_factor) scores, so a lone trial at
+  // a rung continues
+  auto const& scores = m_rung_scores[rung];
+  const size_t keep =
+    (scores.size() + m_reduction_factor - 1) / m_reduction_factor;
+  const auto num_better =
+    std::count_if(scores.cbegin(), scores.cend(), [&](EvalType s) {
+      return is_better(s, score);
+    });
+  return static_cast<size_t>(num_better) < keep;
+}
+
+void SuccessiveHalving::select_next(model& m,
+                                    ltfb::LTFBExecutionContext& ctxt,
+                                    data_coordinator& dc) const
+{
+  auto const& comm = *(m.get_comm());
+  const size_t num_trainers = comm.get_num_trainers();
+  const size_t trainer_id = comm.get_trainer_rank();
+  auto const step = ctxt.get_step();
+  if (m_trial_rounds.size() != num_trainers) {
+    m_trial_rounds.assign(num_trainers, 0);
+  }
+  m_rung_scores.resize(m_max_rungs);
+
+  const EvalType score = evaluate_model(m, ctxt, dc);
+
+  // Gather the scores of all trainers
+  std::vector<EvalType> scores(num_trainers);
+  comm.trainer_barrier();
+  if (comm.am_trainer_master()) {
+    comm.all_gather<EvalType>(score, scores, comm.get_intertrainer_comm());
+  }
+  comm.trainer_broadcast(comm.get_trainer_master(),
+                         scores.data(),
+                         num_trainers);
+
+  // Record the scores of the trials that reached a rung. Trials that
+  // reach the same rung in the same round are judged together.
+  std::vector<int> trial_rung(num_trainers, -1);
+  for (size_t t = 0; t < num_trainers; ++t) {
+    ++m_trial_rounds[t];
+    size_t milestone = m_min_rounds;
+    for (size_t rung = 0; rung < m_max_rungs; ++rung) {
+      if (m_trial_rounds[t] == milestone) {
+        trial_rung[t] = static_cast<int>(rung);
+        m_rung_scores[rung].push_back(scores[t]);
+        break;
+      }
+      milestone *= m_reduction_factor;
+    }
+  }
+  std::vector<bool> terminated(num_trainers, false);
+  for (size_t t = 0; t < num_trainers; ++t) {
+    if (trial_rung[t] >= 0) {
+      terminated[t] = !is_promoted(scores[t], trial_rung[t]);
+    }
+  }
+
+  // The best surviving trainer seeds the new trials. If every trial
+  // was terminated, the best one survives.
+  int donor_id = -1;
+  for (size_t t = 0; t < num_trainers; ++t) {
+    if (!terminated[t] &&
+        (donor_id < 0 || is_better(scores[t], scores[donor_id]))) {
+      donor_id = static_cast<int>(t);
+    }
+  }
+  if (donor_id < 0) {
+    donor_id = static_cast<int>(
+      std::distance(scores.cbegin(),
+                    std::min_element(scores.cbegin(),
+                                     scores.cend(),
+                                     [&](EvalType a, EvalType b) {
+                                       return is_better(a, b);
+                                     })));
+    terminated[donor_id] = false;
+  }
+
+  if (comm.am_world_master()) {
+    std::cout << "Successive halving step " << step << " - terminated:";
+    for (size_t t = 0; t < num_trainers; ++t) {
+      if (terminated[t]) {
+        std::cout << " " << t;
+      }
+    }
+    std::cout << ", new trials start from trainer " << donor_id
+              << " (score " << scores[donor_id] << ")" << std::endl;
+  }
+
+  // Send the donor's model to the trainers of the terminated trials
+  const bool any_terminated =
+    std::find(terminated.cbegin(), terminated.cend(), true) !=
+    terminated.cend();
+  if (trainer_id == static_cast<size_t>(donor_id) && any_terminated) {
+    auto model_string = pack(m);
+    if (comm.am_trainer_master()) {
+      for (size_t t = 0; t < num_trainers; ++t) {
+        if (terminated[t]) {
+          send_string(comm, model_string, t);
+        }
+      }
+    }
+  }
+  if (terminated[trainer_id]) {
+    std::string rcv_str;
+    if (comm.am_trainer_master()) {
+      rcv_str = recv_string(comm, donor_id);
+    }
+    unpack(m, rcv_str);
+
+    // Mutate the model of the new trial
+    m_mutate_algo->mutate(m, step);
+
+    auto& trainer = get_trainer();
+    auto&& metadata = trainer.get_data_coordinator().get_dr_metadata();
+    m.setup(trainer.get_max_mini_batch_size(),
+            metadata,
+            trainer.get_grids(),
+            /*force*/ true);
+  }
+
+  // Terminated trials start over
+  for (size_t t = 0; t < num_trainers; ++t) {
+    if (terminated[t]) {
+      m_trial_rounds[t] = 0;
+    }
+  }
+}
+
+} // namespace ltfb
+} // namespace lbann
+
+namespace {
+
+lbann::ltfb::SuccessiveHalving::metric_strategy
+to_lbann(lbann_data::SuccessiveHalving::MetricStrategy strategy)
+{
+  using LBANNEnumType = lbann::ltfb::SuccessiveHalving::metric_strategy;
+  using ProtoEnumType = lbann_data::SuccessiveHalving::MetricStrategy;
+  switch (strategy) {
+  case ProtoEnumType::SuccessiveHalving_MetricStrategy_LOWER_IS_BETTER:
+    return LBANNEnumType::LOWER_IS_BETTER;
+  case ProtoEnumType::SuccessiveHalving_MetricStrategy_HIGHER_IS_BETTER:
+    return LBANNEnumType::HIGHER_IS_BETTER;
+  default:
+    LBANN_ERROR("Unknown enum value: ", static_cast<int>(strategy));
+  }
+  return LBANNEnumType::LOWER_IS_BETTER;
+}
+
+} // namespace
+
+template <>
+std::unique_ptr<lbann::ltfb::SuccessiveHalving>
+lbann::make<lbann::ltfb::SuccessiveHalving>(
+  google::protobuf::Message const& msg_in)
+{
+  auto const& params = dynamic_cast<google::protobuf::Any const&>(msg_in);
+  lbann_data::SuccessiveHalving msg;
+  LBANN_ASSERT(params.UnpackTo(&msg));
+
+  using MutationStrategyType = lbann::ltfb::MutationStrategy;
+
+  return std::make_unique<lbann::ltfb::SuccessiveHalving>(
+    msg.metric_name(),
+    to_lbann(msg.metric_strategy()),
+    make_abstract<MutationStrategyType>(msg.mutation_strategy()),
+    msg.reduction_factor() > 0 ? msg.reduction_factor() : 3,
+    msg.min_rounds() > 0 ? msg.min_rounds() : 1,
+    msg.max_rungs() > 0 ? msg.max_rungs() : 4);
+}
@@ -89,7 +89,9 @@ TruncationSelectionExchange::TruncationSelectionExchange(
 
 TruncationSelectionExchange::TruncationSelectionExchange(
   TruncationSelectionExchange const& other)
-  : m_metrics{other.m_metrics}, m_truncation_k{other.m_truncation_k}
+  : m_metrics{other.m_metrics},
+    m_truncation_k{other.m_truncation_k},
+    m_tournament_mini_batches{other.m_tournament_mini_batches}
 {}
 
 EvalType TruncationSelectionExchange::evaluate_model(model& m,
@@ -112,7 +114,13 @@ EvalType TruncationSelectionExchange::evaluate_model(model& m,
   m.mark_data_store_explicitly_loading(execution_mode::tournament);
 
   // Evaluate model on validation set
-  get_trainer().evaluate(&m, execution_mode::tournament);
+  get_trainer().evaluate(&m,
+                         execution_mode::tournament,
+                         m_tournament_mini_batches);
+  if (m_tournament_mini_batches > 0) {
+    // Don't leave a fetch of the partial epoch running during training
+    dc.collect_background_data_fetch(execution_mode::tournament);
+  }
 
   // Get metric values
   bool found_metric = false;
@@ -282,7 +290,9 @@ lbann::make<lbann::ltfb::TruncationSelectionExchange>(
                    return ValueType{kvp.first, to_lbann(kvp.second)};
                  });
 
-  return std::make_unique<lbann::ltfb::TruncationSelectionExchange>(
+  auto strategy = std::make_unique<lbann::ltfb::TruncationSelectionExchange>(
     std::move(metric_map),
     msg.truncation_k());
+  strategy->set_tournament_mini_batches(msg.tournament_mini_batches());
+  return strategy;
 }
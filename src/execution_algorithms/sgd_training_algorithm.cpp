@@ -28,13 +28,18 @@
 
 #include "lbann/base.hpp"
 #include "lbann/callbacks/callback.hpp"
+#include "lbann/comm.hpp"
 #include "lbann/data_coordinator/data_coordinator.hpp"
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/layers/layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
+#include "lbann/utils/options.hpp"
+#include "lbann/utils/telemetry.hpp"
 #include "lbann/utils/timer_map.hpp"
 
 #include "lbann/proto/training_algorithm.pb.h"
@@ -42,9 +47,83 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 
 namespace lbann {
 
+namespace {
+
+/** @brief Whether a training step can be captured in GPU graphs.
+ *  @details Every layer must run on the GPU and no callback may
+ *  inspect tensors during the step. Communication and subgraph
+ *  parallelism synchronize with the host, so they are excluded, as
+ *  is gradient clipping, whose scale changes every step.
+ */
+bool can_capture_training_step(model& m)
+{
+#ifdef LBANN_HAS_CUDA
+  if (m.get_comm()->get_procs_per_trainer() != 1 ||
+      m.is_subgraph_parallelism_enabled()) {
+    return false;
+  }
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    if (m.get_layer(i).get_device_allocation() != El::Device::GPU) {
+      return false;
+    }
+  }
+  for (const auto& cb : m.get_callbacks()) {
+    if (!cb->supports_gpu_graph_capture()) {
+      return false;
+    }
+  }
+  for (const auto* w : m.get_weights()) {
+    const auto* opt = w->get_optimizer();
+    if (opt != nullptr && opt->get_clip_gradient_norm() > 0.) {
+      return false;
+    }
+  }
+  return true;
+#else
+  return false;
+#endif // LBANN_HAS_CUDA
+}
+
+#ifdef LBANN_HAS_CUDA
+/** @brief Capture the GPU work of @c f in @c graph and launch it.
+ *  @details The host code in @c f runs as usual, so kernel arguments
+ *  that change from step to step are picked up. A step that cannot
+ *  be captured (e.g. because it synchronizes with the host) cannot
+ *  be replayed either, so it is an error.
+ */
+template <typename F>
+void run_in_gpu_graph(cuda::ExecutableGraph& graph, F&& f)
+{
+  const auto stream = hydrogen::cuda::GetDefaultStream();
+  try {
+    f([stream] {
+      cuda::Graph::begin_capture(stream, cudaStreamCaptureModeRelaxed);
+    });
+    graph.update(cuda::Graph::end_capture(stream));
+  }
+  catch (const std::exception& e) {
+    cudaStreamCaptureStatus status = cudaStreamCaptureStatusNone;
+    if (cudaStreamIsCapturing(stream, &status) == cudaSuccess &&
+        status != cudaStreamCaptureStatusNone) {
+      cudaGraph_t discarded = nullptr;
+      static_cast<void>(cudaStreamEndCapture(stream, &discarded));
+      cuda::Graph temp(discarded);
+    }
+    LBANN_ERROR("could not capture the training step in a CUDA graph (",
+                e.what(),
+                "); run without --",
+                LBANN_OPTION_GPU_GRAPH_TRAINING);
+  }
+  graph.launch(stream);
+}
+#endif // LBANN_HAS_CUDA
+
+} // namespace
+
 SGDTrainingAlgorithm::SGDTrainingAlgorithm(
   std::string name,
   std::unique_ptr<SGDTerminationCriteria> stop,
@@ -57,6 +136,49 @@ SGDTrainingAlgorithm::SGDTrainingAlgorithm(
     m_suppress_timer{suppress_timer}
 {}
 
+void SGDTrainingAlgorithm::set_loss_scaling(EvalType initial_scale,
+                                            EvalType growth_factor,
+                                            EvalType backoff_factor,
+                                            size_t growth_interval)
+{
+  if (initial_scale < EvalType(0) || growth_factor < EvalType(1) ||
+      backoff_factor <= EvalType(0) || backoff_factor > EvalType(1) ||
+      growth_interval == 0) {
+    LBANN_ERROR("invalid loss scaling parameters (initial scale ",
+                initial_scale,
+                ", growth factor ",
+                growth_factor,
+                ", backoff factor ",
+                backoff_factor,
+                ", growth interval ",
+                growth_interval,
+                ")");
+  }
+  m_loss_scaling =
+    (initial_scale != EvalType(0) && initial_scale != EvalType(1));
+  m_loss_scale = m_loss_scaling ? initial_scale : EvalType(1);
+  m_loss_scale_growth = growth_factor;
+  m_loss_scale_backoff = backoff_factor;
+  m_loss_scale_interval = growth_interval;
+  m_good_steps = 0;
+}
+
+void SGDTrainingAlgorithm::set_num_micro_batches(size_t num_micro_batches)
+{
+  if (num_micro_batches == 0) {
+    LBANN_ERROR("SGD needs at least one micro-batch per mini-batch");
+  }
+  m_num_micro_batches = num_micro_batches;
+}
+
+void SGDTrainingAlgorithm::set_num_accumulation_steps(size_t num_steps)
+{
+  if (num_steps == 0) {
+    LBANN_ERROR("SGD needs at least one mini-batch per weight update");
+  }
+  m_num_accumulation_steps = num_steps;
+}
+
 ////////////////////////////////////////////////////////////
 // Evaluation and training
 ////////////////////////////////////////////////////////////
@@ -112,6 +234,18 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
   // Run callbacks.
   do_train_begin_cbs(model, ScopeTimer{train_timer, "train_begin callbacks"});
 
+  m_gpu_graph =
+    (global_argument_parser().get<bool>(LBANN_OPTION_GPU_GRAPH_TRAINING) &&
+     can_capture_training_step(model));
+  m_gpu_graph_mini_batch_size = 0;
+  if (global_argument_parser().get<bool>(LBANN_OPTION_GPU_GRAPH_TRAINING) &&
+      !m_gpu_graph && model.get_comm()->am_trainer_master()) {
+    std::cout << "SGD::" << this->get_name() << ": training steps will "
+              << "not be captured in GPU graphs (requires CUDA, one rank "
+              << "per trainer, GPU layers only and no callbacks that "
+              << "inspect tensors during the step)" << std::endl;
+  }
+
   // Start iterating
   bool is_start_of_epoch = true;
   c.start_timer();
@@ -136,6 +270,7 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
       // Finalize epoch
       c.inc_epoch();
       model.reconcile_weight_values();
+      model.flush_statistics();
       do_epoch_end_cbs(model, ScopeTimer{train_timer, "epoch_end callbacks"});
 
       // Evaluate on validation set
@@ -144,6 +279,7 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
       // move out of the main training cycle and become part of an
       // "evaluation policy" or something of that nature, ideally with
       // its own context that we needn't know about.
+      dc.load_deferred_reader(execution_mode::validation);
       if (dc.is_execution_mode_valid(execution_mode::validation)) {
         evaluate(evaluation_context,
                  model,
@@ -168,6 +304,7 @@ void SGDTrainingAlgorithm::train(SGDExecutionContext& c,
   // Reset the model back to the training execution context prior to
   // end of training callbacks
   model.reset_mode(c, execution_mode::training);
+  model.flush_statistics();
   do_train_end_cbs(model, ScopeTimer{train_timer, "train_end callbacks"});
 }
 
@@ -188,8 +325,15 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
                      ScopeTimer{timer, "batch_begin callbacks"});
 
   bool finished = false;
+  const double step_start = (telemetry_enabled() ? get_time() : -1.);
 
   dc.fetch_data(execution_mode::training);
+  // Graph capture is limited to one whole mini-batch per step
+  const size_t num_micro_batches = m_num_micro_batches;
+  const size_t num_steps = m_num_accumulation_steps;
+  const bool capture = (num_micro_batches == 1 && num_steps == 1 &&
+                        use_gpu_graph(c.get_current_mini_batch_size()));
+  size_t num_accumulated = 0;
 
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
   LBANN_OMP_PARALLEL
@@ -197,39 +341,96 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
 #pragma omp single
     {
 #endif
-      // Forward prop step
       model.clear_gradients();
-      {
-        ScopeTimer _{timer, "forward prop*"};
-        model.forward_prop(execution_mode::training);
+      // Weight gradients are accumulated over the micro-batches, and
+      // then over the accumulated mini-batches. The input layers
+      // normalize the objective function by the whole mini-batch, so
+      // the sum over micro-batches is the mini-batch gradient.
+      while (!finished && num_accumulated < num_steps) {
+        if (num_accumulated > 0) {
+          dc.fetch_data(execution_mode::training);
+        }
+        ++num_accumulated;
+        for (size_t k = 0; k < num_micro_batches; ++k) {
+          const bool last_micro_batch = (k + 1 == num_micro_batches);
+          dc.set_micro_batch(k, num_micro_batches);
+
+          // Forward prop step. The input layers copy from the data
+          // coordinator's staging buffers, so they are not captured.
+          {
+            ScopeTimer _{timer, "forward prop*"};
+            run_training_phase(capture, 0, [&](auto const& begin_capture) {
+              model.forward_prop(execution_mode::training, begin_capture);
+            });
+          }
+
+          // check if the data coordinator has finished the epoch and
+          // kickoff background I/O. This replaces the active buffer,
+          // so it waits for the last micro-batch.
+          if (last_micro_batch) {
+            finished = dc.epoch_complete(execution_mode::training);
+          }
+
+          // Only the last backprop before the update launches the
+          // gradient allreduces
+          const bool last = (last_micro_batch &&
+                             (finished || num_accumulated == num_steps));
+          model.defer_gradient_allreduces(!last);
+
+          // Result is not needed until the end of the mini-batch.
+          model.get_objective_function()->start_evaluation(
+            execution_mode::training,
+            c.get_current_mini_batch_size());
+
+          // Backward prop step
+          model.get_objective_function()->differentiate(m_loss_scale);
+          {
+            ScopeTimer _{timer, "back prop*"};
+            run_training_phase(capture, 1, [&](auto const& begin_capture) {
+              begin_capture();
+              model.backward_prop();
+            });
+          }
+          if (last) {
+            model.get_objective_function()->compute_weight_regularization(
+              m_loss_scale * num_accumulated);
+          }
+
+          // Finish evaluation.
+          model.get_objective_function()->finish_evaluation_deferred(
+            execution_mode::training,
+            c.get_current_mini_batch_size());
+          model.evaluate_metrics(execution_mode::training,
+                                 c.get_current_mini_batch_size());
+        }
       }
-
-      // check if the data coordinator has finished the epoch and kickoff
-      // background I/O
-      finished = dc.epoch_complete(execution_mode::training);
-
-      // Result is not needed until the end of the mini-batch.
-      model.get_objective_function()->start_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-
-      // Backward prop step
-      model.get_objective_function()->differentiate();
-      {
-        ScopeTimer _{timer, "back prop*"};
-        model.backward_prop();
+      dc.set_micro_batch(0, 1);
+
+      // Update step, skipped if loss scaling found non-finite
+      // gradients. Accumulated mini-batch gradients are averaged,
+      // then clipped.
+      if (!m_loss_scaling) {
+        if (num_accumulated > 1) {
+          model.unscale_gradients(num_accumulated);
+        }
+        model.clip_gradients();
+        run_training_phase(capture, 2, [&](auto const& begin_capture) {
+          begin_capture();
+          model.update_weights();
+        });
+      }
+      else if (model.unscale_gradients(m_loss_scale * num_accumulated)) {
+        model.clip_gradients();
+        model.update_weights();
+        if (++m_good_steps >= m_loss_scale_interval) {
+          m_loss_scale *= m_loss_scale_growth;
+          m_good_steps = 0;
+        }
+      }
+      else {
+        m_loss_scale *= m_loss_scale_backoff;
+        m_good_steps = 0;
       }
-      model.get_objective_function()->compute_weight_regularization();
-
-      // Finish evaluation.
-      model.get_objective_function()->finish_evaluation(
-        execution_mode::training,
-        c.get_current_mini_batch_size());
-      model.evaluate_metrics(execution_mode::training,
-                             c.get_current_mini_batch_size());
-
-      // Update step
-      model.update_weights();
       model.update_layers();
 #if defined(LBANN_HAVE_OMP_TASKLOOP)
     }
@@ -237,12 +438,43 @@ bool SGDTrainingAlgorithm::train_mini_batch(SGDExecutionContext& c,
 #endif
 
   c.inc_step();
+  if (step_start >= 0.) {
+    telemetry_add_seconds(telemetry_value::step_seconds,
+                          get_time() - step_start);
+    telemetry_add(telemetry_value::training_steps, 1);
+    telemetry_add(telemetry_value::training_samples,
+                  c.get_current_mini_batch_size() * num_accumulated);
+  }
   do_batch_end_cbs(model,
                    execution_mode::training,
                    ScopeTimer{timer, "batch_end callbacks"});
   return finished;
 }
 
+bool SGDTrainingAlgorithm::use_gpu_graph(size_t mini_batch_size)
+{
+  if (!m_gpu_graph) {
+    return false;
+  }
+  const bool warm = (mini_batch_size == m_gpu_graph_mini_batch_size);
+  m_gpu_graph_mini_batch_size = mini_batch_size;
+  return warm;
+}
+
+template <typename F>
+void SGDTrainingAlgorithm::run_training_phase(bool capture,
+                                              size_t phase,
+                                              F&& f)
+{
+#ifdef LBANN_HAS_CUDA
+  if (capture) {
+    run_in_gpu_graph(m_gpu_graphs[phase], std::forward<F>(f));
+    return;
+  }
+#endif // LBANN_HAS_CUDA
+  f([] {});
+}
+
 void SGDTrainingAlgorithm::evaluate(SGDExecutionContext& c,
                                     model& model,
                                     data_coordinator& dc,
@@ -261,6 +493,7 @@ void SGDTrainingAlgorithm::evaluate(SGDExecutionContext& c,
   model.reset_mode(c, mode);
   // Ensure that the data coordinator has the right execution context
   dc.reset_mode(c);
+  dc.load_deferred_reader(mode);
   // Return early if execution mode is invalid
   if (!dc.is_execution_mode_valid(mode))
     return;
@@ -281,11 +514,99 @@ void SGDTrainingAlgorithm::evaluate(SGDExecutionContext& c,
                             ScopeTimer{eval_timer, "eval minibatch"}))
       c.inc_epoch();
   }
+  model.flush_statistics();
+  if (dc.is_sharded_across_trainers(mode)) {
+    model.reduce_epoch_statistics_across_trainers(mode);
+  }
   do_evaluate_end_cbs(model,
                       mode,
                       ScopeTimer{eval_timer, "eval_end callbacks"});
 }
 
+void SGDTrainingAlgorithm::evaluate_ensemble(
+  std::vector<SGDExecutionContext*> const& contexts,
+  std::vector<model*> const& models,
+  data_coordinator& dc,
+  execution_mode mode,
+  SGDTerminationCriteria const& term)
+{
+  if (models.empty()) {
+    return;
+  }
+  if (contexts.size() != models.size()) {
+    LBANN_ERROR("evaluating an ensemble of ",
+                models.size(),
+                " models with ",
+                contexts.size(),
+                " execution contexts");
+  }
+  ScopeTimer eval_timer{
+    m_timers,
+    build_string("evaluate_ensemble(", to_string(mode), ")")};
+
+  // The data coordinator follows the first model, see evaluate
+  auto& dc_context = *contexts.front();
+  for (size_t i = 0; i < models.size(); ++i) {
+    models[i]->reset_epoch_statistics(mode);
+    models[i]->reset_mode(*contexts[i], mode);
+  }
+  dc.reset_mode(dc_context);
+  dc.load_deferred_reader(mode);
+  if (!dc.is_execution_mode_valid(mode))
+    return;
+  if (mode != execution_mode::validation &&
+      mode != execution_mode::tournament && mode != execution_mode::testing) {
+    LBANN_ERROR("invalid execution mode for evaluation");
+  }
+
+  for (auto* m : models) {
+    do_evaluate_begin_cbs(*m,
+                          mode,
+                          ScopeTimer{eval_timer, "eval_begin callbacks"});
+  }
+  while (!term(dc_context)) {
+    ScopeTimer timer{eval_timer, "eval minibatch"};
+    for (size_t i = 0; i < models.size(); ++i) {
+      models[i]->reset_mode(*contexts[i], mode);
+      do_batch_begin_cbs(*models[i],
+                         mode,
+                         ScopeTimer{timer, "batch_begin callbacks"});
+    }
+    dc.reset_mode(dc_context);
+    dc.fetch_data(mode);
+    for (auto* m : models) {
+      m->forward_prop(mode);
+    }
+    const bool finished = dc.epoch_complete(mode);
+    for (size_t i = 0; i < models.size(); ++i) {
+      auto& m = *models[i];
+      auto& c = *contexts[i];
+      m.get_objective_function()->start_evaluation(
+        mode,
+        c.get_current_mini_batch_size());
+      m.get_objective_function()->finish_evaluation_deferred(
+        mode,
+        c.get_current_mini_batch_size());
+      m.evaluate_metrics(mode, c.get_current_mini_batch_size());
+      m.update_layers();
+      c.inc_step();
+      do_batch_end_cbs(m, mode, ScopeTimer{timer, "batch_end callbacks"});
+      if (finished) {
+        c.inc_epoch();
+      }
+    }
+  }
+  for (auto* m : models) {
+    m->flush_statistics();
+    if (dc.is_sharded_across_trainers(mode)) {
+      m->reduce_epoch_statistics_across_trainers(mode);
+    }
+    do_evaluate_end_cbs(*m,
+                        mode,
+                        ScopeTimer{eval_timer, "eval_end callbacks"});
+  }
+}
+
 bool SGDTrainingAlgorithm::evaluate_mini_batch(SGDExecutionContext& c,
                                                model& model,
                                                data_coordinator& dc,
@@ -304,7 +625,7 @@ bool SGDTrainingAlgorithm::evaluate_mini_batch(SGDExecutionContext& c,
   model.get_objective_function()->start_evaluation(
     mode,
     c.get_current_mini_batch_size());
-  model.get_objective_function()->finish_evaluation(
+  model.get_objective_function()->finish_evaluation_deferred(
     mode,
     c.get_current_mini_batch_size());
   model.evaluate_metrics(mode, c.get_current_mini_batch_size());
@@ -505,8 +826,23 @@ lbann::make<lbann::SGDTrainingAlgorithm>(
   auto stopping =
     term_criteria_factory().create_object(stopping_criteria.criterion_case(),
                                           stopping_criteria);
-  return std::make_unique<SGDTrainingAlgorithm>(
-    params.name(),
-    std::move(stopping),
-    sgd_params.suppress_timer_output());
+  auto sgd =
+    std::make_unique<SGDTrainingAlgorithm>(params.name(),
+                                           std::move(stopping),
+                                           sgd_params.suppress_timer_output());
+  if (sgd_params.has_loss_scaling()) {
+    auto const& ls = sgd_params.loss_scaling();
+    sgd->set_loss_scaling(
+      ls.initial_scale(),
+      ls.growth_factor() != 0. ? ls.growth_factor() : 2.,
+      ls.backoff_factor() != 0. ? ls.backoff_factor() : 0.5,
+      ls.growth_interval() != 0 ? ls.growth_interval() : 2000);
+  }
+  if (sgd_params.num_micro_batches() != 0) {
+    sgd->set_num_micro_batches(sgd_params.num_micro_batches());
+  }
+  if (sgd_params.num_accumulation_steps() != 0) {
+    sgd->set_num_accumulation_steps(sgd_params.num_accumulation_steps());
+  }
+  return sgd;
 }
@@ -132,4 +132,24 @@ TEST_CASE("Test batch_function_inference_algorithm", "[inference]")
       REQUIRE(labels(i) == i);
     }
   }
+
+  SECTION("Verify inference output tensors")
+  {
+    El::Fill(data, zero);
+    El::FillDiagonal(data, one);
+
+    // Mini-batches smaller than the sample count are stitched together
+    auto outputs = inf_alg.infer_outputs(model.get(), data, 3);
+
+    REQUIRE(outputs.Height() == mbs_class_n);
+    REQUIRE(outputs.Width() == mbs_class_n);
+    const DataType e = std::exp(one);
+    for (int i = 0; i < outputs.Height(); i++) {
+      for (int j = 0; j < outputs.Width(); j++) {
+        const DataType expected =
+          (i == j ? e : one) / (e + (mbs_class_n - 1));
+        REQUIRE(outputs(i, j) == Approx(expected));
+      }
+    }
+  }
 }
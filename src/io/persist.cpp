@@ -30,12 +30,14 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 
 #define LBANN_PERSIST_INSTANTIATE
 #include "lbann/io/file_io.hpp"
 #include "lbann/io/persist.hpp"
 #include "lbann/io/persist_impl.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
 
 #include <fcntl.h>
 #include <sys/stat.h>
@@ -306,6 +308,248 @@ void lbann::persist::close_checkpoint()
   }
 }
 
+std::unique_ptr<std::ostream>
+lbann::persist::open_output(const std::string& filename)
+{
+  if (m_defer_writes) {
+    auto data = std::make_shared<std::stringbuf>();
+    m_deferred_files.push_back({filename, data});
+    return std::make_unique<std::ostream>(data.get());
+  }
+  return std::make_unique<std::ofstream>(filename);
+}
+
+std::vector<lbann::persist::deferred_file>
+lbann::persist::take_deferred_files()
+{
+  std::vector<deferred_file> files;
+  files.swap(m_deferred_files);
+  return files;
+}
+
+void lbann::persist::defer_file(deferred_file file)
+{
+  m_deferred_files.push_back(std::move(file));
+}
+
+void lbann::write_deferred_files(
+  std::vector<persist::deferred_file> const& files)
+{
+  for (auto const& file : files) {
+    std::ofstream os(file.filename);
+    if (!os.is_open()) {
+      throw NonexistentArchiveFile(file.filename);
+    }
+    // Copy the contents rather than reading the buffer, which may be
+    // shared with another write
+    const auto data = file.data->str();
+    os.write(data.data(), data.size());
+    os.close();
+    if (os.fail()) {
+      LBANN_ERROR("failed to write checkpoint file ", file.filename);
+    }
+  }
+}
+
+namespace {
+
+/** Leads a file container, which is followed by the files' contents */
+struct file_container_header
+{
+  char magic[8];         /**< "LBCKPCTR" */
+  uint64_t version;      /**< format version, currently 1 */
+  uint64_t num_files;    /**< number of index entries */
+  uint64_t index_offset; /**< offset of the index from the file start */
+};
+
+/** Index entry, followed by the file's relative path */
+struct file_container_entry
+{
+  uint64_t offset;      /**< offset of the contents from the file start */
+  uint64_t size;        /**< size of the contents */
+  uint64_t name_length; /**< length of the relative path */
+};
+
+constexpr char file_container_magic[] = "LBCKPCTR";
+
+/** Path of @c filename relative to @c dir, if it is in @c dir
+ *
+ *  Checkpoint paths are built by concatenation, so they are compared
+ *  as strings.
+ */
+bool get_relative_path(const std::string& dir,
+                       const std::string& filename,
+                       std::string& relative)
+{
+  if (dir.empty() || filename.compare(0, dir.size(), dir) != 0) {
+    return false;
+  }
+  if (dir.back() != '/' &&
+      (filename.size() == dir.size() || filename[dir.size()] != '/')) {
+    return false;
+  }
+  relative = filename.substr(dir.size());
+  return true;
+}
+
+/** Read the index of a file container
+ *
+ *  Maps relative paths to the offsets and sizes of the files'
+ *  contents. Throws NonexistentArchiveFile if there is no container.
+ */
+std::map<std::string, std::pair<uint64_t, uint64_t>>
+read_file_container_index(const std::string& filename)
+{
+  std::ifstream is(filename, std::ios::binary);
+  if (!is.is_open()) {
+    throw lbann::NonexistentArchiveFile(filename);
+  }
+  file_container_header header;
+  is.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!is || std::memcmp(header.magic,
+                         file_container_magic,
+                         sizeof(header.magic)) != 0) {
+    LBANN_ERROR(filename, " is not a checkpoint file container");
+  }
+  if (header.version != 1) {
+    LBANN_ERROR("unsupported version ",
+                header.version,
+                " of checkpoint file container ",
+                filename);
+  }
+  std::map<std::string, std::pair<uint64_t, uint64_t>> index;
+  is.seekg(header.index_offset);
+  for (uint64_t i = 0; i < header.num_files; ++i) {
+    file_container_entry entry;
+    is.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+    std::string name(entry.name_length, '\0');
+    is.read(&name[0], name.size());
+    if (!is) {
+      LBANN_ERROR("failed to read the index of ", filename);
+    }
+    index[name] = {entry.offset, entry.size};
+  }
+  return index;
+}
+
+} // namespace
+
+std::string lbann::get_file_container_filename(const std::string& dir)
+{
+  return dir + "/checkpoint_files.bin";
+}
+
+void lbann::write_file_container(
+  std::ostream& os,
+  const std::string& dir,
+  std::vector<persist::deferred_file> const& files)
+{
+  file_container_header header;
+  std::memcpy(header.magic, file_container_magic, sizeof(header.magic));
+  header.version = 1;
+  header.num_files = files.size();
+  header.index_offset = 0;
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // Contents, each in one large write
+  std::vector<file_container_entry> entries;
+  std::vector<std::string> names;
+  uint64_t offset = sizeof(header);
+  for (auto const& file : files) {
+    std::string name;
+    if (!get_relative_path(dir, file.filename, name)) {
+      LBANN_ERROR("checkpoint file ",
+                  file.filename,
+                  " is not in the file container directory ",
+                  dir);
+    }
+    names.push_back(name);
+    const auto& data = file.data->str();
+    os.write(data.data(), data.size());
+    entries.push_back({offset, data.size(), names.back().size()});
+    offset += data.size();
+  }
+
+  // Index
+  header.index_offset = offset;
+  for (size_t i = 0; i < entries.size(); ++i) {
+    os.write(reinterpret_cast<const char*>(&entries[i]), sizeof(entries[i]));
+    os.write(names[i].data(), names[i].size());
+  }
+  os.seekp(0);
+  os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  if (os.fail()) {
+    LBANN_ERROR("failed to write the file container of ", dir);
+  }
+}
+
+void lbann::persist::open_file_container(const std::string& dir)
+{
+  close_file_container();
+  const auto filename = get_file_container_filename(dir);
+  m_container_index = read_file_container_index(filename);
+  m_container_dir = dir;
+  m_container_filename = filename;
+}
+
+void lbann::locate_checkpoint_file(const std::string& dir,
+                                   const std::string& filename,
+                                   std::string& path,
+                                   uint64_t& offset,
+                                   uint64_t& size)
+{
+  const auto container = get_file_container_filename(dir);
+  std::string name;
+  if (file::file_exists(container) &&
+      get_relative_path(dir, filename, name)) {
+    const auto index = read_file_container_index(container);
+    auto it = index.find(name);
+    if (it == index.end()) {
+      throw NonexistentArchiveFile(filename);
+    }
+    path = container;
+    offset = it->second.first;
+    size = it->second.second;
+    return;
+  }
+  std::ifstream is(filename, std::ios::binary | std::ios::ate);
+  if (!is.is_open()) {
+    throw NonexistentArchiveFile(filename);
+  }
+  path = filename;
+  offset = 0;
+  size = static_cast<uint64_t>(is.tellg());
+}
+
+void lbann::persist::close_file_container()
+{
+  m_container_dir.clear();
+  m_container_filename.clear();
+  m_container_index.clear();
+}
+
+std::unique_ptr<std::istream>
+lbann::persist::open_input(const std::string& filename)
+{
+  std::string name;
+  if (get_relative_path(m_container_dir, filename, name)) {
+    auto it = m_container_index.find(name);
+    if (it == m_container_index.end()) {
+      throw NonexistentArchiveFile(filename);
+    }
+    // Only read this file's bytes
+    std::string data(it->second.second, '\0');
+    std::ifstream is(m_container_filename, std::ios::binary);
+    is.seekg(it->second.first);
+    is.read(&data[0], data.size());
+    if (!is) {
+      LBANN_ERROR("failed to read ", filename, " from ", m_container_filename);
+    }
+    return std::make_unique<std::istringstream>(std::move(data));
+  }
+  return std::make_unique<std::ifstream>(filename);
+}
+
 void lbann::persist::open_restart(const std::string& dir)
 {
   // copy checkpoint directory
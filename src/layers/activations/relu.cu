@@ -113,9 +113,33 @@ void relu_layer<TensorDataType, Layout, Device>::bp_compute()
     this->get_error_signals());
 }
 
+template <typename TensorDataType, El::Device Device>
+void fused_relu_fp_compute(El::AbstractDistMatrix<TensorDataType>& activations)
+{
+  gpu_lib::apply_entrywise_unary_operator<op, TensorDataType>(activations,
+                                                              activations);
+}
+
+template <typename TensorDataType, El::Device Device>
+void fused_relu_bp_compute(
+  const El::AbstractDistMatrix<TensorDataType>& activations,
+  El::AbstractDistMatrix<TensorDataType>& gradient_wrt_output)
+{
+  // The outputs are positive exactly where the inputs were
+  gpu_lib::apply_entrywise_binary_operator<op_backprop, TensorDataType>(
+    activations,
+    gradient_wrt_output,
+    gradient_wrt_output);
+}
+
 #define PROTO(T)                                                               \
   template class relu_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>;   \
-  template class relu_layer<T, data_layout::MODEL_PARALLEL, El::Device::GPU>
+  template class relu_layer<T, data_layout::MODEL_PARALLEL, El::Device::GPU>;  \
+  template void fused_relu_fp_compute<T, El::Device::GPU>(                     \
+    El::AbstractDistMatrix<T>&);                                               \
+  template void fused_relu_bp_compute<T, El::Device::GPU>(                     \
+    const El::AbstractDistMatrix<T>&,                                          \
+    El::AbstractDistMatrix<T>&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
@@ -53,6 +53,8 @@ void Layer::serialize(ArchiveT& ar)
   //   m_bp_compute_time
   //   m_update_time
   //   m_parallel_strategy
+  //   m_recompute_activations
+  //   m_offload_activations
 }
 
 } // namespace lbann
@@ -29,6 +29,7 @@
 #include "matrix_builder.hpp"
 
 #include "lbann/execution_algorithms/sgd_execution_context.hpp"
+#include "lbann/layers/activations/relu.hpp"
 #include "lbann/layers/data_type_layer.hpp"
 #ifdef LBANN_HAS_DISTCONV
 #include "lbann/layers/data_type_distconv_adapter.hpp"
@@ -36,11 +37,15 @@
 #include "lbann/models/model.hpp"
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
 #include "lbann/utils/options.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/utils/telemetry.hpp"
 #include "lbann/utils/tensor_impl.hpp"
 #include "lbann/utils/timer.hpp"
 
+#include <type_traits>
+
 namespace {
 template <typename MatrixPtrT>
 std::vector<MatrixPtrT> copy_all(std::vector<MatrixPtrT> const& in)
@@ -109,6 +114,7 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
   const auto& mini_batch_size = c.get_current_mini_batch_size();
   fp_setup_inputs(mini_batch_size);
   fp_setup_outputs(mini_batch_size);
+  apply_gpu_sync_info_();
 
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
@@ -125,6 +131,9 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
   // Apply layer's compute function
   const auto fp_compute_start = get_time();
   fp_compute();
+  if (m_fused_relu) {
+    fp_fused_relu_();
+  }
   m_fp_compute_time += get_time() - fp_compute_start;
 
 #ifdef LBANN_HAS_DISTCONV
@@ -142,7 +151,18 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::forward_prop()
   }
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
 
-  m_fp_time += get_time() - fp_start;
+  const auto fp_time = get_time() - fp_start;
+  m_fp_time += fp_time;
+  if (telemetry_enabled()) {
+    telemetry_add_seconds(telemetry_value::forward_prop_seconds, fp_time);
+#ifdef LBANN_HAS_GPU
+    // Activations are live after forward prop, so this is near the peak
+    if (using_gpus()) {
+      telemetry_update_max(telemetry_value::gpu_memory_high_water_bytes,
+                           gpu_lib::get_memory_pool_usage().live_bytes);
+    }
+#endif // LBANN_HAS_GPU
+  }
 }
 
 template <typename InputTensorDataType, typename OutputTensorDataType>
@@ -155,7 +175,10 @@ void data_type_layer<InputTensorDataType,
   const auto& c =
     static_cast<SGDExecutionContext&>(m_model->get_execution_context());
   const auto& mini_batch_size = c.get_current_mini_batch_size();
-  bp_setup_gradient_wrt_inputs(mini_batch_size);
+  if (!m_inplace_error_signals) {
+    bp_setup_gradient_wrt_inputs(mini_batch_size);
+  }
+  apply_gpu_sync_info_();
 
 #if defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
   // Synchronize GPUs and check for errors
@@ -171,6 +194,9 @@ void data_type_layer<InputTensorDataType,
 
   // Backprop the compute function.
   const auto bp_compute_start = get_time();
+  if (m_fused_relu) {
+    bp_fused_relu_();
+  }
   bp_compute();
   m_bp_compute_time += get_time() - bp_compute_start;
 
@@ -189,7 +215,9 @@ void data_type_layer<InputTensorDataType,
   }
 #endif // defined(LBANN_HAS_GPU) && defined(LBANN_DEBUG)
 
-  m_bp_time += get_time() - bp_start;
+  const auto bp_time = get_time() - bp_start;
+  m_bp_time += bp_time;
+  telemetry_add_seconds(telemetry_value::backward_prop_seconds, bp_time);
 }
 
 template <typename InputTensorDataType, typename OutputTensorDataType>
@@ -200,16 +228,11 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
   // Summarize activation matrices
   const int num_children = get_num_children();
   for (int i = 0; i < num_children; ++i) {
-    OutputAbsDistMatReadProxyType<El::Device::CPU> acts(*m_outputs[i]);
     std::string prefix = m_name + "/activations";
     if (num_children > 1) {
       prefix += std::to_string(i);
     }
-    summarizer.reduce_mean(prefix + "/mean", acts.GetLocked(), step);
-    summarizer.reduce_min(prefix + "/min", acts.GetLocked(), step);
-    summarizer.reduce_max(prefix + "/max", acts.GetLocked(), step);
-    summarizer.reduce_stdev(prefix + "/stdev", acts.GetLocked(), step);
-    summarizer.reduce_2norm(prefix + "/2norm2", acts.GetLocked(), step);
+    summarizer.reduce_statistics(prefix, *m_outputs[i], step);
   }
 
   // Summarize error signal matrices
@@ -218,19 +241,11 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
     if (!m_gradient_wrt_inputs[i])
       continue;
 
-    InputAbsDistMatReadProxyType<El::Device::CPU> error_signals(
-      *m_gradient_wrt_inputs[i]);
     std::string prefix = m_name + "/error_signals";
     if (num_parents > 1) {
       prefix += std::to_string(i);
     }
-    summarizer.reduce_mean(prefix + "/mean", error_signals.GetLocked(), step);
-    summarizer.reduce_min(prefix + "/min", error_signals.GetLocked(), step);
-    summarizer.reduce_max(prefix + "/max", error_signals.GetLocked(), step);
-    summarizer.reduce_stdev(prefix + "/stdev", error_signals.GetLocked(), step);
-    summarizer.reduce_2norm(prefix + "/2norm2",
-                            error_signals.GetLocked(),
-                            step);
+    summarizer.reduce_statistics(prefix, *m_gradient_wrt_inputs[i], step);
   }
 }
 
@@ -491,6 +506,197 @@ void data_type_layer<InputTensorDataType,
   m_persistent_error_signals = flag;
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType,
+                     OutputTensorDataType>::free_activations()
+{
+  for (auto& output : m_outputs) {
+    if (!output->Viewing()) {
+      output->Empty();
+    }
+  }
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType,
+                     OutputTensorDataType>::has_activation_views() const
+{
+  for (const auto& output : m_outputs) {
+    if (output->Viewing()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+size_t data_type_layer<InputTensorDataType,
+                       OutputTensorDataType>::get_activations_memory() const
+{
+  size_t size = 0;
+  for (const auto& output : m_outputs) {
+    if (!output->Viewing()) {
+      size += (output->LocalHeight() * output->LocalWidth() *
+               sizeof(OutputTensorDataType));
+    }
+  }
+  return size;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+compute_cost data_type_layer<InputTensorDataType,
+                             OutputTensorDataType>::get_forward_prop_cost()
+  const
+{
+  double input_size = 0., output_size = 0.;
+  for (const auto& input : m_inputs) {
+    input_size += input->LocalHeight() * input->LocalWidth();
+  }
+  for (const auto& output : m_outputs) {
+    output_size += output->LocalHeight() * output->LocalWidth();
+  }
+  double weights_size = 0.;
+  for (size_t i = 0; i < num_weights(); ++i) {
+    if (has_weights(i)) {
+      weights_size += get_weights(i).get_size();
+    }
+  }
+  compute_cost cost;
+  cost.flops = output_size;
+  cost.bytes = ((input_size + weights_size) * sizeof(InputTensorDataType) +
+                output_size * sizeof(OutputTensorDataType));
+  return cost;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+compute_cost data_type_layer<InputTensorDataType,
+                             OutputTensorDataType>::get_backward_prop_cost()
+  const
+{
+  double input_size = 0., output_size = 0.;
+  for (const auto& input : m_inputs) {
+    input_size += input->LocalHeight() * input->LocalWidth();
+  }
+  for (const auto& output : m_outputs) {
+    output_size += output->LocalHeight() * output->LocalWidth();
+  }
+  double weights_size = 0.;
+  for (size_t i = 0; i < num_weights(); ++i) {
+    if (has_weights(i)) {
+      weights_size += get_weights(i).get_size();
+    }
+  }
+  compute_cost cost;
+  cost.flops = input_size;
+  cost.bytes = ((2. * input_size + 2. * weights_size) *
+                  sizeof(InputTensorDataType) +
+                output_size * sizeof(OutputTensorDataType));
+  return cost;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType,
+                     OutputTensorDataType>::refresh_inputs()
+{
+  const auto& c =
+    static_cast<SGDExecutionContext&>(m_model->get_execution_context());
+  fp_setup_inputs(c.get_current_mini_batch_size());
+  apply_gpu_sync_info_();
+}
+
+#ifdef LBANN_HAS_GPU
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  offload_activations(El::SyncInfo<El::Device::GPU> const& copy)
+{
+  using GPUMatType = El::Matrix<OutputTensorDataType, El::Device::GPU>;
+  m_offloaded_outputs.resize(m_outputs.size());
+  m_offloaded_output_dims.assign(m_outputs.size(), {0, 0});
+  bool offloaded = false;
+  for (size_t i = 0; i < m_outputs.size(); ++i) {
+    const auto& output = *m_outputs[i];
+    if (output.GetLocalDevice() != El::Device::GPU || output.Viewing() ||
+        (output.LocalWidth() > 1 && output.LDim() != output.LocalHeight())) {
+      continue;
+    }
+    const auto& local = static_cast<const GPUMatType&>(output.LockedMatrix());
+    auto& host = m_offloaded_outputs[i];
+    if (host.IsEmpty()) {
+      host.SetMemoryMode(1); // Pinned memory
+    }
+    host.Resize(local.Height(), local.Width());
+    El::AddSynchronizationPoint(El::SyncInfoFromMatrix(local), copy);
+    gpu_lib::mem_copy_async(host.Buffer(),
+                            local.LockedBuffer(),
+                            (local.Height() * local.Width() *
+                             sizeof(OutputTensorDataType)),
+                            gpu_lib::GPU_MEMCPY_DEVICE_TO_HOST,
+                            copy.Stream());
+    m_offloaded_output_dims[i] = {output.Height(), output.Width()};
+    offloaded = true;
+  }
+  return offloaded;
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  free_offloaded_activations(El::SyncInfo<El::Device::GPU> const& copy)
+{
+  using GPUMatType = El::Matrix<OutputTensorDataType, El::Device::GPU>;
+  for (size_t i = 0; i < m_offloaded_output_dims.size(); ++i) {
+    if (m_offloaded_output_dims[i].second == 0) {
+      continue;
+    }
+    // The memory pool may hand the buffer to later work on the
+    // tensor's stream, which must not overtake the copy
+    auto& output = *m_outputs[i];
+    const auto& local = static_cast<const GPUMatType&>(output.LockedMatrix());
+    El::AddSynchronizationPoint(copy, El::SyncInfoFromMatrix(local));
+    output.Empty();
+  }
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  restore_activations(El::SyncInfo<El::Device::GPU> const& copy)
+{
+  using GPUMatType = El::Matrix<OutputTensorDataType, El::Device::GPU>;
+  for (size_t i = 0; i < m_offloaded_output_dims.size(); ++i) {
+    const auto& [height, width] = m_offloaded_output_dims[i];
+    if (width == 0) {
+      continue;
+    }
+    auto& output = *m_outputs[i];
+    output.Resize(height, width);
+    auto& local = static_cast<GPUMatType&>(output.Matrix());
+    const auto& host = m_offloaded_outputs[i];
+    El::AddSynchronizationPoint(El::SyncInfoFromMatrix(local), copy);
+    gpu_lib::mem_copy_async(local.Buffer(),
+                            host.LockedBuffer(),
+                            (host.Height() * host.Width() *
+                             sizeof(OutputTensorDataType)),
+                            gpu_lib::GPU_MEMCPY_HOST_TO_DEVICE,
+                            copy.Stream());
+  }
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  wait_for_restored_activations(El::SyncInfo<El::Device::GPU> const& copy)
+{
+  using GPUMatType = El::Matrix<OutputTensorDataType, El::Device::GPU>;
+  for (size_t i = 0; i < m_offloaded_output_dims.size(); ++i) {
+    if (m_offloaded_output_dims[i].second == 0) {
+      continue;
+    }
+    const auto& local =
+      static_cast<const GPUMatType&>(m_outputs[i]->LockedMatrix());
+    El::AddSynchronizationPoint(copy, El::SyncInfoFromMatrix(local));
+    m_offloaded_output_dims[i] = {0, 0};
+  }
+}
+#endif // LBANN_HAS_GPU
+
 namespace {
 
 // Some indirection around building matrices to keep things tidy in
@@ -975,6 +1181,23 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
       continue;
 #endif // LBANN_HAS_DISTCONV
     auto& output = get_activations(i);
+
+    // Write directly into the child's tensor if it allows it
+    auto& child = const_cast<Layer&>(get_child_layer(i));
+    El::Range<El::Int> rows;
+    auto* buffer =
+      dynamic_cast<OutputAbsDistMatrixType*>(
+        child.get_parent_output_buffer(*this, mini_batch_size, rows));
+    if (buffer != nullptr) {
+      output.Empty(false);
+      if (align_outputs) {
+        output.AlignWith(alignment_dist);
+      }
+      if (output.DistData() == buffer->DistData()) {
+        El::View(output, *buffer, rows, El::ALL);
+        continue;
+      }
+    }
     if (output.Viewing()) {
       LBANN_ERROR(get_name(),
                   " fp_setup_outputs should be overridden",
@@ -1121,6 +1344,162 @@ void data_type_layer<InputTensorDataType,
   }
 }
 
+namespace {
+
+/** @brief Whether the ReLU kernels are instantiated for a type.
+ *
+ *  The CPU and GPU half-precision types only exist on their own
+ *  device.
+ */
+template <typename TensorDataType, El::Device Device>
+constexpr bool has_fused_relu_kernels()
+{
+#ifdef LBANN_HAS_HALF
+  if constexpr (Device != El::Device::CPU &&
+                std::is_same_v<TensorDataType, cpu_fp16>) {
+    return false;
+  }
+#endif // LBANN_HAS_HALF
+#ifdef LBANN_HAS_GPU_FP16
+  if constexpr (Device == El::Device::CPU &&
+                std::is_same_v<TensorDataType, fp16>) {
+    return false;
+  }
+#endif // LBANN_HAS_GPU_FP16
+  return true;
+}
+
+template <El::Device Device, typename TensorDataType>
+void fused_relu_fp_on_device(El::AbstractDistMatrix<TensorDataType>& output)
+{
+  if constexpr (has_fused_relu_kernels<TensorDataType, Device>()) {
+    fused_relu_fp_compute<TensorDataType, Device>(output);
+  }
+  else {
+    LBANN_ERROR("fused ReLU is not supported for ",
+                TypeName<TensorDataType>(),
+                " on this device");
+  }
+}
+
+template <El::Device Device, typename TensorDataType>
+void fused_relu_bp_on_device(
+  const El::AbstractDistMatrix<TensorDataType>& output,
+  El::AbstractDistMatrix<TensorDataType>& gradient_wrt_output)
+{
+  if constexpr (has_fused_relu_kernels<TensorDataType, Device>()) {
+    fused_relu_bp_compute<TensorDataType, Device>(output, gradient_wrt_output);
+  }
+  else {
+    LBANN_ERROR("fused ReLU is not supported for ",
+                TypeName<TensorDataType>(),
+                " on this device");
+  }
+}
+
+} // namespace
+
+#ifdef LBANN_HAS_GPU
+namespace {
+template <typename T>
+void set_matrix_sync_info(El::AbstractDistMatrix<T>& mat,
+                          El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  if constexpr (El::IsStorageType<T, El::Device::GPU>::value) {
+    if (mat.GetLocalDevice() == El::Device::GPU) {
+      El::SetSyncInfo(
+        static_cast<El::Matrix<T, El::Device::GPU>&>(mat.Matrix()),
+        sync_info);
+    }
+  }
+}
+} // namespace
+#endif // LBANN_HAS_GPU
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType,
+                     OutputTensorDataType>::apply_gpu_sync_info_()
+{
+#ifdef LBANN_HAS_GPU
+  if (!this->m_gpu_sync_info) {
+    return;
+  }
+  const auto& sync_info = *this->m_gpu_sync_info;
+  for (auto* tensors : {&m_inputs, &m_gradient_wrt_inputs}) {
+    for (auto& t : *tensors) {
+      if (t) {
+        set_matrix_sync_info(*t, sync_info);
+      }
+    }
+  }
+  for (auto* tensors : {&m_outputs, &m_gradient_wrt_outputs}) {
+    for (auto& t : *tensors) {
+      if (t) {
+        set_matrix_sync_info(*t, sync_info);
+      }
+    }
+  }
+  for (auto& wp : m_weights_proxy) {
+    wp.set_sync_info(sync_info);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  fp_fused_relu_()
+{
+#ifdef LBANN_HAS_DISTCONV
+  if (distconv_enabled()) {
+    LBANN_ERROR("fused ReLU is not supported with distconv (layer \"",
+                get_name(),
+                "\")");
+  }
+#endif // LBANN_HAS_DISTCONV
+  auto& output = *m_outputs[0];
+  switch (this->get_device_allocation()) {
+  case El::Device::CPU:
+    fused_relu_fp_on_device<El::Device::CPU>(output);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    fused_relu_fp_on_device<El::Device::GPU>(output);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for layer \"", get_name(), "\"");
+  }
+}
+
+template <typename InputTensorDataType, typename OutputTensorDataType>
+void data_type_layer<InputTensorDataType, OutputTensorDataType>::
+  bp_fused_relu_()
+{
+  // The gradient may be a view into the child's error signal, which
+  // must not be modified
+  auto& gradient_wrt_output = m_gradient_wrt_outputs[0];
+  if (gradient_wrt_output->Viewing()) {
+    std::unique_ptr<OutputAbsDistMatrixType> copy(
+      gradient_wrt_output->Construct(gradient_wrt_output->Grid(),
+                                     gradient_wrt_output->Root()));
+    El::Copy(*gradient_wrt_output, *copy);
+    gradient_wrt_output = std::move(copy);
+  }
+  const auto& output = *m_outputs[0];
+  switch (this->get_device_allocation()) {
+  case El::Device::CPU:
+    fused_relu_bp_on_device<El::Device::CPU>(output, *gradient_wrt_output);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    fused_relu_bp_on_device<El::Device::GPU>(output, *gradient_wrt_output);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device for layer \"", get_name(), "\"");
+  }
+}
+
 void attempt_view_error_signal(Layer& parent,
                                const Layer& child,
                                const BaseDistMat& signal)
@@ -1170,10 +1549,55 @@ void data_type_layer<InputTensorDataType, OutputTensorDataType>::
   }
 }
 
+template <typename InputTensorDataType, typename OutputTensorDataType>
+bool data_type_layer<InputTensorDataType,
+                     OutputTensorDataType>::reuse_prev_error_signal_()
+{
+  if constexpr (!std::is_same_v<InputTensorDataType, OutputTensorDataType>) {
+    return false;
+  }
+  else {
+    if (!this->supports_inplace_backprop() || m_persistent_error_signals ||
+        this->has_fused_relu() || get_num_parents() != 1 ||
+        get_num_children() != 1 ||
+        this->get_parallel_strategy().enable_subgraph) {
+      return false;
+    }
+#ifdef LBANN_HAS_DISTCONV
+    if (distconv_enabled()) {
+      return false;
+    }
+#endif // LBANN_HAS_DISTCONV
+
+    // Views may belong to the child layer and must not be modified
+    auto& prev_error_signal = m_gradient_wrt_outputs[0];
+    const auto& input = get_prev_activations(0);
+    if (!prev_error_signal || prev_error_signal->Viewing() ||
+        !(prev_error_signal->DistData() == input.DistData()) ||
+        prev_error_signal->Height() != input.Height() ||
+        prev_error_signal->Width() != input.Width()) {
+      return false;
+    }
+
+    // Take ownership of the previous error signal and read it
+    // through a view
+    auto& error_signal = m_gradient_wrt_inputs[0];
+    error_signal = std::move(prev_error_signal);
+    prev_error_signal.reset(
+      error_signal->Construct(error_signal->Grid(), error_signal->Root()));
+    El::LockedView(*prev_error_signal, *error_signal);
+    return true;
+  }
+}
+
 template <typename InputTensorDataType, typename OutputTensorDataType>
 void data_type_layer<InputTensorDataType,
                      OutputTensorDataType>::allocate_new_gradients_()
 {
+  m_inplace_error_signals = reuse_prev_error_signal_();
+  if (m_inplace_error_signals) {
+    return;
+  }
   auto parents = get_parent_layers();
   for (int i = 0; i < get_num_parents(); ++i) {
 #ifdef LBANN_HAS_DISTCONV
@@ -224,6 +224,40 @@ void distconv_adapter::setup_tensor_shuffle()
   }
 }
 
+void distconv_adapter::set_decomposition(int samples,
+                                         int depth,
+                                         int height,
+                                         int width)
+{
+  auto& ps = layer().get_parallel_strategy();
+  ps.sample_groups = ps.sample_splits = samples;
+  ps.depth_groups = ps.depth_splits = depth;
+  ps.height_groups = ps.height_splits = height;
+  ps.width_groups = ps.width_splits = width;
+  ps.channel_groups = ps.channel_splits = 1;
+  ps.filter_groups = ps.filter_splits = 1;
+}
+
+void distconv_adapter::autotune_parallel_strategy()
+{
+  // These layers do not support spatial decomposition
+  const auto layer_type = layer().get_type();
+  if (layer_type == "channel-wise fully-connected" ||
+      layer_type == "matmul") {
+    return;
+  }
+  for (const auto* parent : layer().get_parent_layers()) {
+    if (parent->distconv_enabled()) {
+      const auto& ps = parent->get_parallel_strategy();
+      set_decomposition(ps.sample_groups,
+                        ps.depth_groups,
+                        ps.height_groups,
+                        ps.width_groups);
+      return;
+    }
+  }
+}
+
 void distconv_adapter::adjust_parallel_strategy()
 {
   auto& ps = layer().get_parallel_strategy();
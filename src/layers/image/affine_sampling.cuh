@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_LAYERS_IMAGE_AFFINE_SAMPLING_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_IMAGE_AFFINE_SAMPLING_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/layers/image/cutout.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/philox.hpp"
+
+namespace lbann {
+namespace internal {
+
+/** @brief Bilinear interpolation between four neighboring pixels
+ *
+ *  @c unit_x and @c unit_y are the position of the interpolation
+ *  point relative to @c pixel00.
+ */
+template <typename TensorDataType>
+__device__ __forceinline__ TensorDataType
+bilinear_interpolate(const TensorDataType& pixel00,
+                     const TensorDataType& pixel01,
+                     const TensorDataType& pixel10,
+                     const TensorDataType& pixel11,
+                     const TensorDataType& unit_x,
+                     const TensorDataType& unit_y)
+{
+  const TensorDataType one = 1.;
+  return (pixel00 * (one - unit_x) * (one - unit_y) +
+          pixel01 * unit_x * (one - unit_y) +
+          pixel10 * (one - unit_x) * unit_y + pixel11 * unit_x * unit_y);
+}
+
+/** @brief Per-sample parameters of an affine image transformation
+ *
+ *  Each parameter is a column of a local matrix, one per sample.
+ *  Null parameters are not applied.
+ */
+template <typename TensorDataType>
+struct affine_sampling_params
+{
+  /** Clockwise rotation angle in degrees. */
+  const TensorDataType* angles = nullptr;
+  El::Int angles_ldim = 0;
+  /** (X,Y) shear factors. */
+  const TensorDataType* shears = nullptr;
+  El::Int shears_ldim = 0;
+  /** (X,Y) translations. */
+  const TensorDataType* translations = nullptr;
+  El::Int translations_ldim = 0;
+  /** Side length of the square set to zero. */
+  const TensorDataType* cutouts = nullptr;
+  El::Int cutouts_ldim = 0;
+  /** Stream of the cutout centers, and global index of the first
+   *  local sample and between local samples. */
+  philox::stream cutout_stream;
+  El::Int sample_shift = 0;
+  El::Int sample_stride = 1;
+};
+
+namespace kernel {
+
+/** @brief Apply rotation, shear, translation and cutout in one pass
+ *
+ *  Each output pixel is the bilinear interpolation of the input at
+ *  its rotated, sheared and translated position, or zero if that
+ *  position is outside the image or the pixel is in the cutout
+ *  square. Entries are handled with a grid-stride loop over the whole
+ *  mini-batch.
+ */
+template <typename TensorDataType>
+__global__ void
+affine_sampling(El::Int num_samples,
+                El::Int num_channels,
+                El::Int height,
+                El::Int width,
+                const TensorDataType* __restrict__ input,
+                El::Int input_ldim,
+                TensorDataType* __restrict__ output,
+                El::Int output_ldim,
+                affine_sampling_params<TensorDataType> params)
+{
+  const TensorDataType zero = 0.;
+  const TensorDataType rad_per_degree = M_PI / 180.;
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int image_size = height * width;
+  const El::Int size = num_samples * num_channels * image_size;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+
+    // Indices
+    const El::Int sample = pos / (num_channels * image_size);
+    const El::Int channel = (pos / image_size) % num_channels;
+    const El::Int output_row = (pos / width) % height;
+    const El::Int output_col = pos % width;
+    const auto* input_image =
+      &input[sample * input_ldim + channel * image_size];
+    auto& result = output[sample * output_ldim + channel * image_size +
+                          output_row * width + output_col];
+
+    // Cutout
+    if (params.cutouts != nullptr) {
+      const auto& cutout = params.cutouts[sample * params.cutouts_ldim];
+      El::Int row_center, col_center;
+      cutout_center(params.cutout_stream,
+                    params.sample_shift + sample * params.sample_stride,
+                    height,
+                    width,
+                    row_center,
+                    col_center);
+      const El::Int col_start = gpu_lib::max(
+        static_cast<El::Int>(col_center - cutout / TensorDataType(2.)),
+        El::Int(0));
+      const El::Int col_end =
+        gpu_lib::min(static_cast<El::Int>(col_start + cutout), width - 1);
+      const El::Int row_start = gpu_lib::max(
+        static_cast<El::Int>(row_center - cutout / TensorDataType(2.)),
+        El::Int(0));
+      const El::Int row_end =
+        gpu_lib::min(static_cast<El::Int>(row_start + cutout), height - 1);
+      if (output_col >= col_start && output_col < col_end &&
+          output_row >= row_start && output_row < row_end) {
+        result = zero;
+        continue;
+      }
+    }
+    if (params.angles == nullptr) {
+      result = input_image[output_row * width + output_col];
+      continue;
+    }
+
+    // Rotate point relative to image center
+    const El::Int col_center = width / 2;
+    const El::Int row_center = height / 2;
+    const auto angle_rad =
+      params.angles[sample * params.angles_ldim] * rad_per_degree;
+    const auto sin_angle = gpu_lib::sin(angle_rad);
+    const auto cos_angle = gpu_lib::cos(angle_rad);
+    const TensorDataType drow(output_row - row_center);
+    const TensorDataType dcol(output_col - col_center);
+    auto x = drow * sin_angle + dcol * cos_angle + TensorDataType(col_center);
+    auto y = drow * cos_angle - dcol * sin_angle + TensorDataType(row_center);
+
+    // Shear and translate the rotated point
+    if (params.shears != nullptr) {
+      const auto* shear = &params.shears[sample * params.shears_ldim];
+      const auto sheared_x = x + shear[0] * y;
+      const auto sheared_y = y + shear[1] * x;
+      x = sheared_x;
+      y = sheared_y;
+    }
+    if (params.translations != nullptr) {
+      const auto* translation =
+        &params.translations[sample * params.translations_ldim];
+      x += translation[0];
+      y += translation[1];
+    }
+
+    // Bilinear interpolation, with zeros outside the image
+    const auto input_col = static_cast<El::Int>(gpu_lib::floor(x));
+    const auto input_row = static_cast<El::Int>(gpu_lib::floor(y));
+    if (input_col >= 0 && input_col < width - 1 && input_row >= 0 &&
+        input_row < height - 1) {
+      const auto* pixels = &input_image[input_row * width + input_col];
+      result = bilinear_interpolate(pixels[0],
+                                    pixels[1],
+                                    pixels[width],
+                                    pixels[width + 1],
+                                    x - TensorDataType(input_col),
+                                    y - TensorDataType(input_row));
+    }
+    else {
+      result = zero;
+    }
+  }
+}
+
+} // namespace kernel
+
+/** @brief Launch the fused affine sampling kernel on a mini-batch of
+ *  CHW images. */
+template <typename TensorDataType>
+void affine_sampling_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  const std::vector<int>& dims,
+  const affine_sampling_params<TensorDataType>& params,
+  const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const El::Int num_samples = input.Width();
+  const El::Int size = input.Height() * num_samples;
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  const El::Int grid_size =
+    std::min((size + block_size - 1) / block_size, El::Int(65535));
+  hydrogen::gpu::LaunchKernel(kernel::affine_sampling<TensorDataType>,
+                              grid_size,
+                              block_size,
+                              0,
+                              sync_info,
+                              num_samples,
+                              El::Int(dims[0]),
+                              El::Int(dims[1]),
+                              El::Int(dims[2]),
+                              input.LockedBuffer(),
+                              input.LDim(),
+                              output.Buffer(),
+                              output.LDim(),
+                              params);
+}
+
+} // namespace internal
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_IMAGE_AFFINE_SAMPLING_CUH_INCLUDED
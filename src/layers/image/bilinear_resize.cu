@@ -28,6 +28,8 @@
 #include "lbann/layers/image/bilinear_resize_impl.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "affine_sampling.cuh"
+
 namespace lbann {
 
 namespace {
@@ -47,7 +49,6 @@ __global__ void fp_kernel(El::Int num_samples,
 
   // Useful constants
   const TensorDataType half = 0.5;
-  const TensorDataType one = 1.;
   const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
   const El::Int num_threads = blockDim.x * gridDim.x;
 
@@ -101,9 +102,12 @@ __global__ void fp_kernel(El::Int num_samples,
              output_row * output_width + output_col];
 
     // Bilinear interpolation
-    result = (pixel00 * (one - unit_x) * (one - unit_y) +
-              pixel01 * unit_x * (one - unit_y) +
-              pixel10 * (one - unit_x) * unit_y + pixel11 * unit_x * unit_y);
+    result = internal::bilinear_interpolate(pixel00,
+                                            pixel01,
+                                            pixel10,
+                                            pixel11,
+                                            unit_x,
+                                            unit_y);
   }
 }
 
@@ -41,4 +41,4 @@ void composite_image_transformation_layer<TensorDataType, Layout, Device>::
 } // namespace lbann
 
 #define LBANN_LAYER_NAME composite_image_transformation_layer
-#include <lbann/macros/register_layer_with_cereal_data_parallel_cpu_only.hpp>
+#include <lbann/macros/register_layer_with_cereal_data_parallel_no_half.hpp>
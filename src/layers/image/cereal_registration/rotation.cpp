@@ -40,4 +40,4 @@ void rotation_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
 } // namespace lbann
 
 #define LBANN_LAYER_NAME rotation_layer
-#include <lbann/macros/register_layer_with_cereal_data_parallel_cpu_only.hpp>
+#include <lbann/macros/register_layer_with_cereal_data_parallel_no_half.hpp>
@@ -25,48 +25,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define LBANN_COMPOSITE_IMAGE_TRANSFORMATION_LAYER_INSTANTIATE
-#include "lbann/layers/image/composite_image_transformation.hpp"
-#include "lbann/proto/datatype_helpers.hpp"
-#include "lbann/utils/exception.hpp"
+#include "lbann/layers/image/composite_image_transformation_impl.hpp"
 
-#include "lbann/proto/layers.pb.h"
 #include <math.h>
 
 namespace lbann {
 
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void composite_image_transformation_layer<TensorDataType, Layout, Device>::
-  setup_dims(DataReaderMetaData& dr_metadata)
-{
-  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
-
-  // Get input dimensions
-  auto dims = this->get_input_dims(0);
-
-  // Check that dimensions are valid
-  if (dims.size() != 3) {
-    std::ostringstream ss;
-    for (size_t i = 0; i < dims.size(); ++i) {
-      ss << (i > 0 ? " x " : "") << dims[i];
-    }
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "expects a 3D input in CHW format, ",
-                "but input dimensions are ",
-                ss.str());
-  }
-}
-
-template <typename T, data_layout L, El::Device D>
-void composite_image_transformation_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
-{
-  proto.set_datatype(proto::ProtoDataType<T>);
-  proto.mutable_composite_image_transformation();
-}
-
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void composite_image_transformation_layer<TensorDataType, Layout, Device>::
   fp_compute()
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_COMPOSITE_IMAGE_TRANSFORMATION_LAYER_INSTANTIATE
+#include "lbann/layers/image/composite_image_transformation_impl.hpp"
+
+#include "affine_sampling.cuh"
+
+namespace lbann {
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void composite_image_transformation_layer<TensorDataType, Layout, Device>::
+  fp_compute()
+{
+  const auto& local_input = this->get_local_prev_activations();
+  const auto& local_angles = this->get_local_prev_activations(1);
+  const auto& local_shears = this->get_local_prev_activations(2);
+  const auto& local_translations = this->get_local_prev_activations(3);
+  auto& local_output = this->get_local_activations();
+
+  internal::affine_sampling_params<TensorDataType> params;
+  params.angles = local_angles.LockedBuffer();
+  params.angles_ldim = local_angles.LDim();
+  params.shears = local_shears.LockedBuffer();
+  params.shears_ldim = local_shears.LDim();
+  params.translations = local_translations.LockedBuffer();
+  params.translations_ldim = local_translations.LDim();
+
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                     gpu::get_sync_info(local_input),
+                                     gpu::get_sync_info(local_angles),
+                                     gpu::get_sync_info(local_shears),
+                                     gpu::get_sync_info(local_translations));
+  internal::affine_sampling_gpu(local_input,
+                                local_output,
+                                this->get_input_dims(0),
+                                params,
+                                multisync);
+}
+
+#define PROTO(T)                                                               \
+  template class composite_image_transformation_layer<                         \
+    T,                                                                         \
+    data_layout::DATA_PARALLEL,                                                \
+    El::Device::GPU>
+
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
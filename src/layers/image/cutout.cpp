@@ -25,75 +25,24 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define LBANN_CUTOUT_LAYER_INSTANTIATE
-#include "lbann/layers/image/cutout.hpp"
-#include "lbann/proto/datatype_helpers.hpp"
-
-#include "lbann/proto/layers.pb.h"
-#include "lbann/proto/lbann.pb.h"
-
-#include "lbann/utils/exception.hpp"
+#include "lbann/layers/image/cutout_impl.hpp"
+#include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/models/model.hpp"
 
 #include <algorithm>
 #include <math.h>
 
 namespace lbann {
 
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void cutout_layer<TensorDataType, Layout, Device>::setup_dims(
-  DataReaderMetaData& dr_metadata)
-{
-  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
-
-  // Get input dimensions
-  auto dims = this->get_input_dims(0);
-  const auto& cutout_length = this->get_input_dims(1);
-
-  // Check that dimensions are valid
-  if (dims.size() != 3) {
-    std::ostringstream ss;
-    for (size_t i = 0; i < dims.size(); ++i) {
-      ss << (i > 0 ? " x " : "") << dims[i];
-    }
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "expects a 3D input in CHW format, ",
-                "but input dimensions are ",
-                ss.str());
-  }
-  if (cutout_length.size() > 1 || cutout_length[0] != 1) {
-    std::ostringstream ss;
-    for (size_t i = 0; i < cutout_length.size(); ++i) {
-      ss << (i > 0 ? " x " : "") << cutout_length[i];
-    }
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "expects a scalar input for the cutout length, ",
-                "but input dimensions are ",
-                ss.str());
-  }
-}
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void cutout_layer<TensorDataType, Layout, Device>::write_specific_proto(
-  lbann_data::Layer& proto) const
-{
-  proto.set_datatype(proto::ProtoDataType<TensorDataType>);
-  proto.mutable_cutout();
-}
-
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void cutout_layer<TensorDataType, Layout, Device>::fp_compute()
 {
 
   // Useful constants
   constexpr DataType zero = 0;
-  constexpr DataType one = 1;
 
   // Input and output tensors
+  const auto& input = this->get_prev_activations();
   const auto& local_input = this->get_local_prev_activations();
   auto& local_output = this->get_local_activations();
 
@@ -107,13 +56,13 @@ void cutout_layer<TensorDataType, Layout, Device>::fp_compute()
   // Get cutout length
   const auto& cutouts = this->get_local_prev_activations(1);
 
-  // RNG
-  std::random_device rd;
-  std::mt19937 gen(rd());
-  std::uniform_real_distribution<DataType> uni(zero, one);
-
-  const El::Int col_center = uni(gen) * input_width;
-  const El::Int row_center = uni(gen) * input_height;
+  // Each sample draws its center at its global index
+  const auto& context = this->m_model->get_execution_context();
+  const auto stream = make_philox_stream(m_seed,
+                                         context.get_step(),
+                                         context.get_execution_mode());
+  const El::Int sample_shift = input.RowShift();
+  const El::Int sample_stride = input.RowStride();
 
   // Perform cutout
   LBANN_OMP_PARALLEL_FOR_COLLAPSE4
@@ -123,6 +72,13 @@ void cutout_layer<TensorDataType, Layout, Device>::fp_compute()
         for (El::Int output_col = 0; output_col < input_width; ++output_col) {
 
           const auto& cutout = cutouts.Get(0, sample);
+          El::Int row_center, col_center;
+          cutout_center(stream,
+                        sample_shift + sample * sample_stride,
+                        input_height,
+                        input_width,
+                        row_center,
+                        col_center);
 
           const El::Int col_start =
             std::max(static_cast<El::Int>(col_center - cutout / 2), El::Int(0));
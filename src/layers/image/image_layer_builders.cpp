@@ -58,17 +58,17 @@ lbann::build_composite_image_transformation_layer_from_pbuf(
   lbann_comm* comm,
   lbann_data::Layer const&)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU) {
+  if constexpr (L == data_layout::DATA_PARALLEL) {
     if constexpr (std::is_same_v<T, float>)
       return std::make_unique<
         composite_image_transformation_layer<float,
                                              data_layout::DATA_PARALLEL,
-                                             El::Device::CPU>>(comm);
+                                             D>>(comm);
     else if constexpr (std::is_same_v<T, double>)
       return std::make_unique<
         composite_image_transformation_layer<double,
                                              data_layout::DATA_PARALLEL,
-                                             El::Device::CPU>>(comm);
+                                             D>>(comm);
     else
       LBANN_ERROR("composite_image_transformation_layer is only supported for "
                   "\"float\" and \"double\".");
@@ -76,7 +76,7 @@ lbann::build_composite_image_transformation_layer_from_pbuf(
   else {
     (void)comm;
     LBANN_ERROR("composite image transformation layer is only supported with "
-                "a data-parallel layout and on CPU");
+                "a data-parallel layout");
     return nullptr;
   }
 }
@@ -86,15 +86,13 @@ std::unique_ptr<lbann::Layer>
 lbann::build_rotation_layer_from_pbuf(lbann_comm* comm,
                                       lbann_data::Layer const&)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU)
+  if constexpr (L == data_layout::DATA_PARALLEL)
     if constexpr (std::is_same_v<T, float>)
       return std::make_unique<
-        rotation_layer<float, data_layout::DATA_PARALLEL, El::Device::CPU>>(
-        comm);
+        rotation_layer<float, data_layout::DATA_PARALLEL, D>>(comm);
     else if constexpr (std::is_same_v<T, double>)
       return std::make_unique<
-        rotation_layer<double, data_layout::DATA_PARALLEL, El::Device::CPU>>(
-        comm);
+        rotation_layer<double, data_layout::DATA_PARALLEL, D>>(comm);
     else {
       (void)comm;
       LBANN_ERROR(
@@ -102,8 +100,7 @@ lbann::build_rotation_layer_from_pbuf(lbann_comm* comm,
     }
   else {
     (void)comm;
-    LBANN_ERROR("rotation layer is only supported with a data-parallel layout "
-                "and on CPU");
+    LBANN_ERROR("rotation layer is only supported with a data-parallel layout");
     return nullptr;
   }
 }
@@ -112,14 +109,13 @@ template <typename T, lbann::data_layout L, El::Device D>
 std::unique_ptr<lbann::Layer>
 lbann::build_cutout_layer_from_pbuf(lbann_comm* comm, lbann_data::Layer const&)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU)
+  if constexpr (L == data_layout::DATA_PARALLEL)
     if constexpr (std::is_same_v<T, float>)
       return std::make_unique<
-        cutout_layer<float, data_layout::DATA_PARALLEL, El::Device::CPU>>(comm);
+        cutout_layer<float, data_layout::DATA_PARALLEL, D>>(comm);
     else if constexpr (std::is_same_v<T, double>)
       return std::make_unique<
-        cutout_layer<double, data_layout::DATA_PARALLEL, El::Device::CPU>>(
-        comm);
+        cutout_layer<double, data_layout::DATA_PARALLEL, D>>(comm);
     else {
       (void)comm;
       LBANN_ERROR(
@@ -127,8 +123,7 @@ lbann::build_cutout_layer_from_pbuf(lbann_comm* comm, lbann_data::Layer const&)
     }
   else {
     (void)comm;
-    LBANN_ERROR("cutout layer is only supported with a data-parallel layout "
-                "and on CPU");
+    LBANN_ERROR("cutout layer is only supported with a data-parallel layout");
     return nullptr;
   }
 }
@@ -25,62 +25,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define LBANN_ROTATION_LAYER_INSTANTIATE
-#include "lbann/layers/image/rotation.hpp"
-#include "lbann/utils/exception.hpp"
+#include "lbann/layers/image/rotation_impl.hpp"
 
-#include "lbann/proto/datatype_helpers.hpp"
-#include "lbann/proto/layers.pb.h"
 #include <math.h>
 
 namespace lbann {
 
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void rotation_layer<TensorDataType, Layout, Device>::setup_dims(
-  DataReaderMetaData& dr_metadata)
-{
-  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
-
-  // Get input dimensions
-  auto dims = this->get_input_dims(0);
-  const auto& angle_dims = this->get_input_dims(1);
-
-  // Check that dimensions are valid
-  if (dims.size() != 3) {
-    std::ostringstream ss;
-    for (size_t i = 0; i < dims.size(); ++i) {
-      ss << (i > 0 ? " x " : "") << dims[i];
-    }
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "expects a 3D input in CHW format, ",
-                "but input dimensions are ",
-                ss.str());
-  }
-  if (angle_dims.size() > 1 || angle_dims[0] != 1) {
-    std::ostringstream ss;
-    for (size_t i = 0; i < angle_dims.size(); ++i) {
-      ss << (i > 0 ? " x " : "") << angle_dims[i];
-    }
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "expects a scalar input for the angle, ",
-                "but input dimensions are ",
-                ss.str());
-  }
-}
-
-template <typename T, data_layout L, El::Device D>
-void rotation_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
-{
-  proto.set_datatype(proto::ProtoDataType<T>);
-  proto.mutable_rotation();
-}
-
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void rotation_layer<TensorDataType, Layout, Device>::fp_compute()
 {
@@ -35,7 +35,8 @@ void input_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
   using DataTypeLayer = data_type_layer<TensorDataType>;
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
-     CEREAL_NVP(m_data_field));
+     CEREAL_NVP(m_data_field),
+     CEREAL_NVP(m_synthetic));
 }
 
 } // namespace lbann
@@ -39,6 +39,8 @@
 #include "lbann/trainers/trainer.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/protobuf.hpp"
+#include "lbann/utils/random.hpp"
+#include "lbann/utils/random_number_generators.hpp"
 #include "lbann/utils/serialize.hpp"
 
 template <typename T, lbann::data_layout L, El::Device D>
@@ -56,7 +58,10 @@ lbann::build_input_layer_from_pbuf(lbann_comm* comm,
   if constexpr (std::is_same_v<T, DataType> &&
                 (L == data_layout::DATA_PARALLEL)) {
     return std::make_unique<
-      input_layer<DataType, data_layout::DATA_PARALLEL, D>>(comm, data_field);
+      input_layer<DataType, data_layout::DATA_PARALLEL, D>>(
+      comm,
+      data_field,
+      params.synthetic());
   }
   else {
     (void)comm;
@@ -68,12 +73,38 @@ lbann::build_input_layer_from_pbuf(lbann_comm* comm,
 
 namespace lbann {
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+input_layer<TensorDataType, T_layout, Dev>::input_layer(
+  const input_layer& other)
+  : data_type_layer<TensorDataType>(other),
+    m_samples_loaded(other.m_samples_loaded),
+    m_data_field(other.m_data_field),
+    m_synthetic(other.m_synthetic),
+    m_synthetic_outputs(other.m_synthetic_outputs
+                          ? other.m_synthetic_outputs->Copy()
+                          : nullptr)
+{}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+auto input_layer<TensorDataType, T_layout, Dev>::operator=(
+  const input_layer& other) -> input_layer&
+{
+  data_type_layer<TensorDataType>::operator=(other);
+  m_samples_loaded = other.m_samples_loaded;
+  m_data_field = other.m_data_field;
+  m_synthetic = other.m_synthetic;
+  m_synthetic_outputs.reset(
+    other.m_synthetic_outputs ? other.m_synthetic_outputs->Copy() : nullptr);
+  return *this;
+}
+
 template <typename T, data_layout L, El::Device D>
 void input_layer<T, L, D>::write_specific_proto(lbann_data::Layer& proto) const
 {
   proto.set_datatype(proto::ProtoDataType<T>);
   auto* msg = proto.mutable_input();
   msg->set_data_field(m_data_field);
+  msg->set_synthetic(m_synthetic);
 }
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -101,6 +132,53 @@ void input_layer<TensorDataType, T_layout, Dev>::setup_data(
     auto& output = this->get_activations(i);
     output.Resize(output.Height(), max_mini_batch_size);
   }
+
+  if (m_synthetic) {
+    setup_synthetic_outputs(max_mini_batch_size);
+  }
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void input_layer<TensorDataType, T_layout, Dev>::setup_synthetic_outputs(
+  size_t max_mini_batch_size)
+{
+  const auto& output = this->get_activations();
+  const El::Int height = output.Height();
+  const El::Int width = max_mini_batch_size;
+  m_synthetic_outputs.reset(output.Construct(output.Grid(), output.Root()));
+  auto& synthetic = *m_synthetic_outputs;
+  if (m_data_field == INPUT_DATA_TYPE_LABELS) {
+    // Random one-hot vectors, so that classification objectives and
+    // metrics see valid targets. They are built once on the host.
+    El::DistMatrix<TensorDataType,
+                   El::STAR,
+                   El::VC,
+                   El::ELEMENT,
+                   El::Device::CPU>
+      labels(output.Grid(), output.Root());
+    El::Zeros(labels, height, width);
+    if (height > 0) {
+      auto& local_labels = labels.Matrix();
+      auto& gen = get_fast_generator();
+      for (El::Int j = 0; j < local_labels.Width(); ++j) {
+        local_labels(fast_rand_int(gen, height), j) =
+          El::TypeTraits<TensorDataType>::One();
+      }
+    }
+    El::Copy(labels, synthetic);
+  }
+  else {
+    // Drawn in place on the layer's device
+    synthetic.Resize(height, width);
+    const auto stream =
+      make_philox_stream(draw_philox_seed(*this->get_comm()),
+                         0,
+                         execution_mode::training);
+    philox_gaussian_fill(synthetic,
+                         El::TypeTraits<TensorDataType>::Zero(),
+                         El::TypeTraits<TensorDataType>::One(),
+                         stream);
+  }
 }
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -118,11 +196,13 @@ void input_layer<TensorDataType, T_layout, Dev>::fp_setup_outputs(
       data_coordinator& dc = get_trainer().get_data_coordinator();
       // Determine model mini-batch size and effective mini-batch size
       // Note: If inter-model communication is activated, the effective
-      // mini-batch is equal to the global mini-batch size.
+      // mini-batch is equal to the global mini-batch size. With
+      // micro-batching, gradients are accumulated over the
+      // micro-batches and normalized by the whole mini-batch.
       /// @todo This functionality should probably be moved elsewhere
-      mini_batch_size = dc.get_current_mini_batch_size(mode);
+      mini_batch_size = dc.get_current_micro_batch_size(mode);
 
-      effective_mini_batch_size = mini_batch_size;
+      effective_mini_batch_size = dc.get_current_mini_batch_size(mode);
       for (auto&& cb : this->m_model->get_callbacks()) {
         if (dynamic_cast<callback::imcomm*>(cb) != nullptr) {
           effective_mini_batch_size =
@@ -143,7 +223,14 @@ void input_layer<TensorDataType, T_layout, Dev>::fp_setup_outputs(
   // is necessary to setup the size of the matrix.
   for (int i = 0; i < this->get_num_children(); ++i) {
     auto& output = this->get_activations(i);
-    if (!output.Viewing()) {
+    if (m_synthetic) {
+      // Every step views the leading columns of the same mini-batch
+      El::LockedView(output,
+                     *m_synthetic_outputs,
+                     El::ALL,
+                     El::IR(0, mini_batch_size));
+    }
+    else if (!output.Viewing()) {
       output.Empty(false);
       output.Resize(this->get_output_size(i), mini_batch_size);
     }
@@ -153,7 +240,7 @@ void input_layer<TensorDataType, T_layout, Dev>::fp_setup_outputs(
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void input_layer<TensorDataType, T_layout, Dev>::fp_compute()
 {
-  if (!this->m_samples_loaded) {
+  if (!this->m_samples_loaded && !m_synthetic) {
     execution_mode const mode =
       this->m_model->get_execution_context().get_execution_mode();
     buffered_data_coordinator<TensorDataType>& dc =
@@ -71,6 +71,9 @@ Layer::Layer(const Layer& other)
     m_expected_num_child_layers(other.m_expected_num_child_layers),
     m_model(other.m_model),
     m_frozen(other.m_frozen),
+    m_fused_relu(other.m_fused_relu),
+    m_recompute_activations(other.m_recompute_activations),
+    m_offload_activations(other.m_offload_activations),
     m_fp_time(other.m_fp_time),
     m_fp_compute_time(other.m_fp_compute_time),
     m_bp_time(other.m_bp_time),
@@ -92,6 +95,9 @@ Layer& Layer::operator=(const Layer& other)
   m_expected_num_child_layers = other.m_expected_num_child_layers;
   m_model = other.m_model;
   m_frozen = other.m_frozen;
+  m_fused_relu = other.m_fused_relu;
+  m_recompute_activations = other.m_recompute_activations;
+  m_offload_activations = other.m_offload_activations;
   m_fp_time = other.m_fp_time;
   m_fp_compute_time = other.m_fp_compute_time;
   m_bp_time = other.m_bp_time;
@@ -224,6 +230,11 @@ description Layer::get_description() const
     desc.add("Frozen");
   }
 
+  // Activation fusion
+  if (m_fused_relu) {
+    desc.add("Fused ReLU");
+  }
+
 #ifdef LBANN_HAS_DISTCONV
   if (distconv_enabled()) {
     const auto& ps = get_parallel_strategy();
@@ -250,6 +261,22 @@ lbann_comm* Layer::get_comm() const
   return m_model->get_comm();
 }
 
+const El::mpi::Comm* Layer::get_sequence_comm() const
+{
+  const int num_splits = m_parallel_strategy.sequence_splits;
+  if (num_splits <= 1) {
+    return nullptr;
+  }
+  if (m_grid_tag > 0) {
+    LBANN_ERROR(get_type(),
+                " layer \"",
+                get_name(),
+                "\" splits sequences, ",
+                "which is only supported on the trainer grid");
+  }
+  return &get_comm()->get_sequence_comm(num_splits);
+}
+
 int Layer::get_grid_tag() const noexcept { return m_grid_tag; }
 
 void Layer::set_grid_tag(int tag) { m_grid_tag = tag; }
@@ -430,6 +457,17 @@ bool Layer::is_frozen() const
   return m_frozen;
 }
 
+void Layer::set_fused_relu(bool fused)
+{
+  if (fused && !supports_fused_relu()) {
+    LBANN_ERROR(get_type(),
+                " layer \"",
+                get_name(),
+                "\" does not support a fused ReLU");
+  }
+  m_fused_relu = fused;
+}
+
 void Layer::setup(size_t max_mini_batch_size,
                   DataReaderMetaData& dr_metadata,
                   const std::vector<El::Grid*>& grids)
@@ -669,6 +707,8 @@ void Layer::write_proto(lbann_data::Layer& proto)
   proto.set_data_layout(to_string(this->get_data_layout()));
   if (this->get_hint_layer())
     proto.set_hint_layer(this->get_hint_layer()->get_name());
+  proto.set_recompute_activations(m_recompute_activations);
+  proto.set_offload_activations(m_offload_activations);
   // FIXME(KLG): Ignore for now. (Tom's problem)
   // proto.set_parallel_strategy();
 
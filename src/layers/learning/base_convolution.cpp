@@ -29,6 +29,7 @@
 #include "lbann/layers/layer.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/optimizers/optimizer_impl.hpp"
+#include "lbann/utils/conv_algo_cache.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/exception.hpp"
@@ -48,12 +49,100 @@
 
 #include <omp.h>
 
+#include <algorithm>
+#include <functional>
 #include <sstream>
 #include <string>
 #include <vector>
 
 namespace lbann {
 
+namespace {
+
+/** @brief Most entries in the workspaces of the im2col GEMM algorithm.
+ *  @details Larger mini-batches are split into blocks.
+ */
+constexpr El::Int max_im2col_workspace_size = El::Int(1) << 24;
+
+/** @brief Reuse the algorithm tuned for a larger mini-batch.
+ *
+ *  An algorithm chosen for a mini-batch also supports fewer samples
+ *  within the same workspace, so the last partial mini-batch of an
+ *  epoch and shrinking mini-batch schedules do not tune again. The
+ *  algorithm of the smallest larger mini-batch is closest to the best
+ *  one. Returns false if no larger mini-batch has been tuned.
+ */
+template <typename AlgoMap>
+bool reuse_larger_mini_batch_algo(AlgoMap& algos, int local_mini_batch_size)
+{
+  auto best = algos.end();
+  for (auto it = algos.begin(); it != algos.end(); ++it) {
+    if (it->first > local_mini_batch_size &&
+        (best == algos.end() || it->first < best->first)) {
+      best = it;
+    }
+  }
+  if (best == algos.end()) {
+    return false;
+  }
+  const auto algo = best->second;
+  algos[local_mini_batch_size] = algo;
+  return true;
+}
+
+/** Number of samples to handle with one GEMM, given the workspace
+ *  entries each sample needs. */
+El::Int get_im2col_block_size(El::Int sample_size, El::Int local_width)
+{
+  const El::Int block_size =
+    max_im2col_workspace_size / std::max(sample_size, El::Int(1));
+  return std::max(El::Int(1), std::min(block_size, local_width));
+}
+
+/** @brief Stack the channels of a block of samples.
+ *  @details Column c of stacked holds channel c of columns [start,
+ *  start + block_width) of mat, one sample after the other.
+ */
+template <typename MatrixType>
+void stack_sample_channels(const MatrixType& mat,
+                           El::Int start,
+                           El::Int block_width,
+                           El::Int channel_size,
+                           El::Int num_channels,
+                           MatrixType& stacked)
+{
+  stacked.Resize(channel_size * block_width, num_channels);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < block_width; ++j) {
+    for (El::Int c = 0; c < num_channels; ++c) {
+      std::copy_n(mat.LockedBuffer(c * channel_size, start + j),
+                  channel_size,
+                  stacked.Buffer(j * channel_size, c));
+    }
+  }
+}
+
+/** Inverse of stack_sample_channels. */
+template <typename MatrixType>
+void unstack_sample_channels(const MatrixType& stacked,
+                             El::Int start,
+                             El::Int block_width,
+                             El::Int channel_size,
+                             El::Int num_channels,
+                             MatrixType& mat)
+{
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < block_width; ++j) {
+    for (El::Int c = 0; c < num_channels; ++c) {
+      std::copy_n(stacked.LockedBuffer(j * channel_size, c),
+                  channel_size,
+                  mat.Buffer(c * channel_size, start + j));
+    }
+  }
+}
+
+} // namespace
+
 template <typename TensorDataType, El::Device Device>
 base_convolution_layer<TensorDataType, Device>::base_convolution_layer(
   int num_data_dims,
@@ -102,6 +191,7 @@ base_convolution_layer<TensorDataType, Device>::base_convolution_layer(
     m_strides(other.m_strides),
     m_dilations(other.m_dilations),
     m_groups(other.m_groups),
+    m_channels_last(other.m_channels_last),
     m_bias_scaling_factor(other.m_bias_scaling_factor)
 #ifdef LBANN_HAS_DNN_LIB
     ,
@@ -133,6 +223,7 @@ auto base_convolution_layer<TensorDataType, Device>::operator=(
   m_strides = other.m_strides;
   m_dilations = other.m_dilations;
   m_groups = other.m_groups;
+  m_channels_last = other.m_channels_last;
   m_bias_scaling_factor = other.m_bias_scaling_factor;
 
 #ifdef LBANN_HAS_DNN_LIB
@@ -208,6 +299,9 @@ base_convolution_layer<TensorDataType, Device>::get_description() const
   // Groups
   desc.add("Groups", m_groups);
 
+  // Memory layout
+  desc.add("Channels last", m_channels_last);
+
   // Bias
   ss.str(std::string{});
   ss.clear();
@@ -323,6 +417,12 @@ void base_convolution_layer<TensorDataType, Device>::setup_dims(
         << "but only one group is currently supported on CPU";
     LBANN_ERROR(err.str());
   }
+  if (Device == El::Device::CPU && m_channels_last) {
+    err << this->get_type() << " layer \"" << this->get_name() << "\" "
+        << "stores tensors channels-last, "
+        << "which is not yet supported on CPU";
+    LBANN_ERROR(err.str());
+  }
 }
 
 template <typename TensorDataType, El::Device Device>
@@ -355,11 +455,13 @@ void base_convolution_layer<TensorDataType, Device>::setup_data(
   else {
     this->set_num_weights(1);
   }
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  using MasterWeights = data_type_weights<MasterDataType>;
   if (!this->has_weights(0)) {
-    auto w = std::make_shared<WeightsType>(*this->get_comm());
-    auto init = std::make_unique<he_initializer<TensorDataType>>(
+    auto w = std::make_shared<MasterWeights>(*this->get_comm());
+    auto init = std::make_unique<he_initializer<MasterDataType>>(
       probability_distribution::gaussian);
-    auto opt = this->m_model->template create_optimizer<TensorDataType>();
+    auto opt = this->m_model->template create_optimizer<MasterDataType>();
 
     w->set_name(this->get_name() + "_kernel");
     w->set_initializer(std::move(init));
@@ -385,8 +487,8 @@ void base_convolution_layer<TensorDataType, Device>::setup_data(
   // Set up bias if needed.
   if (m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero()) {
     if (!this->has_weights(1)) {
-      auto w = std::make_shared<WeightsType>(*this->get_comm());
-      auto opt = this->m_model->template create_optimizer<TensorDataType>();
+      auto w = std::make_shared<MasterWeights>(*this->get_comm());
+      auto opt = this->m_model->template create_optimizer<MasterDataType>();
       w->set_name(this->get_name() + "_bias");
       w->set_optimizer(std::move(opt));
       this->set_weights(1, w);
@@ -433,13 +535,18 @@ void base_convolution_layer<TensorDataType, Device>::setup_gpu()
   LBANN_ERROR("DNN library not detected");
 #else
 
+  // Algorithms tuned by earlier runs
+  conv_algo_cache::load(*this->get_comm());
+
   const auto& output_dims = this->get_output_dims();
   const auto& kernel_dims = this->get_kernel_dims();
 
   // Set kernel descriptor
   m_kernel_dnn_desc.set(dnn_lib::get_data_type<TensorDataType>(),
-                        dnn_lib::DNN_TENSOR_NCHW,
+                        (m_channels_last ? dnn_lib::DNN_TENSOR_NHWC
+                                         : dnn_lib::DNN_TENSOR_NCHW),
                         kernel_dims);
+  m_tensors_dnn_desc.set_channels_last(m_channels_last);
 
   // Set convolution descriptor
   m_convolution_dnn_desc.set(m_pads,
@@ -834,33 +941,48 @@ void base_convolution_layer<TensorDataType, Device>::apply_convolution_im2col(
   const int m = output_size / output_dims[0];
   const int n = output_dims[0];
   const int k = kernel_size / output_dims[0];
-  DMatDT<Device> input_col, output_col;
-  DMatDT<Device> im2col_matrix(k, m);
+  DMatDT<Device> input_col, im2col_matrix;
   const DMatDT<Device> kernel_matrix(k, n, local_kernel.LockedBuffer(), k);
 
-  // Iterate through input columns
-  for (El::Int col = 0; col < local_width; ++col) {
-
-    // Construct im2col matrix from current input column
-    El::LockedView(input_col, local_input, El::ALL, El::IR(col));
-    im2col<TensorDataType>(input_col,
-                           im2col_matrix,
-                           input_dims[0],
-                           input_dims.size() - 1,
-                           &input_dims[1],
-                           m_pads.data(),
-                           &kernel_dims[2],
-                           m_strides.data());
-
-    // Apply convolution to current input column
-    output_col.Attach(m, n, local_output.Buffer(0, col), m);
+  // Iterate through blocks of input columns
+  const El::Int block_size =
+    get_im2col_block_size(El::Int(k) * m + El::Int(m) * n, local_width);
+  for (El::Int start = 0; start < local_width; start += block_size) {
+    const El::Int block_width = std::min(block_size, local_width - start);
+
+    // Construct im2col matrices of the block side by side
+    m_im2col_workspace.Resize(k, m * block_width);
+    for (El::Int j = 0; j < block_width; ++j) {
+      El::LockedView(input_col, local_input, El::ALL, El::IR(start + j));
+      El::View(im2col_matrix,
+               m_im2col_workspace,
+               El::ALL,
+               El::IR(j * m, (j + 1) * m));
+      im2col<TensorDataType>(input_col,
+                             im2col_matrix,
+                             input_dims[0],
+                             input_dims.size() - 1,
+                             &input_dims[1],
+                             m_pads.data(),
+                             &kernel_dims[2],
+                             m_strides.data());
+    }
+
+    // Apply convolution to the whole block with one GEMM
+    m_gemm_workspace.Resize(m * block_width, n);
     El::Gemm(El::TRANSPOSE,
              El::NORMAL,
              El::TypeTraits<TensorDataType>::One(),
-             im2col_matrix,
+             m_im2col_workspace,
              kernel_matrix,
              El::TypeTraits<TensorDataType>::Zero(),
-             output_col);
+             m_gemm_workspace);
+    unstack_sample_channels(m_gemm_workspace,
+                            start,
+                            block_width,
+                            m,
+                            n,
+                            local_output);
   }
 }
 
@@ -897,34 +1019,48 @@ void base_convolution_layer<TensorDataType, Device>::
   const int m = kernel_size / input_dims[0];
   const int n = input_size / input_dims[0];
   const int k = input_dims[0];
-  DMatDT<Device> input_col, output_col;
-  DMatDT<Device> im2col_matrix(m, n);
+  DMatDT<Device> output_col, im2col_matrix;
   const DMatDT<Device> kernel_matrix(m, k, local_kernel.LockedBuffer(), m);
 
-  // Iterate through input columns
-  for (El::Int col = 0; col < local_width; ++col) {
-
-    // Apply transposed convolution to current input column
-    input_col.LockedAttach(n, k, local_input.LockedBuffer(0, col), n);
+  // Iterate through blocks of input columns
+  const El::Int block_size =
+    get_im2col_block_size(El::Int(m) * n + El::Int(n) * k, local_width);
+  for (El::Int start = 0; start < local_width; start += block_size) {
+    const El::Int block_width = std::min(block_size, local_width - start);
+
+    // Apply transposed convolution to the whole block with one GEMM
+    stack_sample_channels(local_input,
+                          start,
+                          block_width,
+                          n,
+                          k,
+                          m_gemm_workspace);
+    m_im2col_workspace.Resize(m, n * block_width);
     El::Gemm(El::NORMAL,
              El::TRANSPOSE,
              El::TypeTraits<TensorDataType>::One(),
              kernel_matrix,
-             input_col,
+             m_gemm_workspace,
              El::TypeTraits<TensorDataType>::Zero(),
-             im2col_matrix);
+             m_im2col_workspace);
 
     // Perform col2im to accumulate contributions from each kernel
     // position
-    El::View(output_col, local_output, El::ALL, El::IR(col));
-    col2im<TensorDataType>(im2col_matrix,
-                           output_col,
-                           output_dims[0],
-                           output_dims.size() - 1,
-                           &output_dims[1],
-                           m_pads.data(),
-                           &kernel_dims[2],
-                           m_strides.data());
+    for (El::Int j = 0; j < block_width; ++j) {
+      El::LockedView(im2col_matrix,
+                     m_im2col_workspace,
+                     El::ALL,
+                     El::IR(j * n, (j + 1) * n));
+      El::View(output_col, local_output, El::ALL, El::IR(start + j));
+      col2im<TensorDataType>(im2col_matrix,
+                             output_col,
+                             output_dims[0],
+                             output_dims.size() - 1,
+                             &output_dims[1],
+                             m_pads.data(),
+                             &kernel_dims[2],
+                             m_strides.data());
+    }
   }
 }
 
@@ -1040,59 +1176,90 @@ void base_convolution_layer<TensorDataType, Device>::compute_gradients_im2col(
   auto& kernel_gradient =
     kernel_optimizer->get_gradient_buffer(dst_scale, gradient_scale, true);
   El::Scale(dst_scale, kernel_gradient);
-  DMatDT<Device> im2col_matrix(m, k);
   DMatDT<Device> kernel_gradient_matrix(m, n, kernel_gradient.Buffer(), m);
 
-  // Compute kernel gradient contributions from each data sample
-  for (El::Int col = 0; col < local_width; ++col) {
-    if (using_transposed_convolution) {
-      const DMatDT<Device> input_col(k, n, local_input.LockedBuffer(0, col), k);
-      const DMatDT<Device> gradient_wrt_output_col =
-        El::LockedView(local_gradient_wrt_output, El::ALL, El::IR(col));
-      im2col<TensorDataType>(gradient_wrt_output_col,
+  // The im2col matrices are built from the output gradient for
+  // transposed convolution and from the input otherwise
+  const DMatDT<Device>& im2col_input =
+    (using_transposed_convolution ? local_gradient_wrt_output : local_input);
+  const DMatDT<Device>& gemm_input =
+    (using_transposed_convolution ? local_input : local_gradient_wrt_output);
+  const auto& im2col_dims =
+    (using_transposed_convolution ? output_dims : input_dims);
+
+  // Compute kernel gradient contributions from blocks of data samples
+  DMatDT<Device> im2col_input_col, im2col_matrix;
+  const El::Int block_size =
+    get_im2col_block_size(El::Int(m) * k + El::Int(k) * n, local_width);
+  for (El::Int start = 0; start < local_width; start += block_size) {
+    const El::Int block_width = std::min(block_size, local_width - start);
+    m_im2col_workspace.Resize(m, k * block_width);
+    for (El::Int j = 0; j < block_width; ++j) {
+      El::LockedView(im2col_input_col,
+                     im2col_input,
+                     El::ALL,
+                     El::IR(start + j));
+      El::View(im2col_matrix,
+               m_im2col_workspace,
+               El::ALL,
+               El::IR(j * k, (j + 1) * k));
+      im2col<TensorDataType>(im2col_input_col,
                              im2col_matrix,
-                             num_output_channels,
-                             output_dims.size() - 1,
-                             &output_dims[1],
+                             im2col_dims[0],
+                             im2col_dims.size() - 1,
+                             &im2col_dims[1],
                              m_pads.data(),
                              &kernel_dims[2],
                              m_strides.data());
-      El::Gemm(El::NORMAL,
-               El::NORMAL,
-               gradient_scale,
-               im2col_matrix,
-               input_col,
-               El::TypeTraits<TensorDataType>::One(),
-               kernel_gradient_matrix);
-    }
-    else {
-      const DMatDT<Device> input_col =
-        El::LockedView(local_input, El::ALL, El::IR(col));
-      const DMatDT<Device> gradient_wrt_output_col(
-        k,
-        n,
-        local_gradient_wrt_output.LockedBuffer(0, col),
-        k);
-      im2col<TensorDataType>(input_col,
-                             im2col_matrix,
-                             num_input_channels,
-                             input_dims.size() - 1,
-                             &input_dims[1],
-                             m_pads.data(),
-                             &kernel_dims[2],
-                             m_strides.data());
-      El::Gemm(El::NORMAL,
-               El::NORMAL,
-               gradient_scale,
-               im2col_matrix,
-               gradient_wrt_output_col,
-               El::TypeTraits<TensorDataType>::One(),
-               kernel_gradient_matrix);
     }
+    stack_sample_channels(gemm_input,
+                          start,
+                          block_width,
+                          k,
+                          n,
+                          m_gemm_workspace);
+    El::Gemm(El::NORMAL,
+             El::NORMAL,
+             gradient_scale,
+             m_im2col_workspace,
+             m_gemm_workspace,
+             El::TypeTraits<TensorDataType>::One(),
+             kernel_gradient_matrix);
   }
 }
 
 #ifdef LBANN_HAS_DNN_LIB
+template <typename TensorDataType, El::Device Device>
+std::string base_convolution_layer<TensorDataType, Device>::get_algo_cache_key(
+  const std::string& pass,
+  int local_mini_batch_size,
+  size_t ws_size) const
+{
+  auto dims_str = [](std::ostream& os, const std::vector<int>& dims) {
+    for (size_t i = 0; i < dims.size(); ++i) {
+      os << (i == 0 ? "" : "x") << dims[i];
+    }
+    os << ' ';
+  };
+  std::ostringstream key;
+  key << pass << ' ' << this->get_type() << ' ' << TypeName<TensorDataType>()
+      << ' ';
+  dims_str(key, this->get_input_dims());
+  dims_str(key, this->get_output_dims());
+  dims_str(key, this->get_kernel_dims());
+  dims_str(key, m_pads);
+  dims_str(key, m_strides);
+  dims_str(key, m_dilations);
+  key << m_groups << ' ' << static_cast<int>(m_convolution_math_type) << ' '
+      << (m_channels_last ? "nhwc " : "") << local_mini_batch_size << ' '
+      << ws_size << ' ';
+#ifdef LBANN_DETERMINISTIC
+  key << "deterministic ";
+#endif
+  key << dnn_lib::get_algorithm_cache_tag();
+  return key.str();
+}
+
 template <typename TensorDataType, El::Device Device>
 fwd_conv_alg
 base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
@@ -1108,6 +1275,18 @@ base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
   TensorDataType* ws)
 {
   if (m_fwd_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (reuse_larger_mini_batch_algo(m_fwd_dnn_algos,
+                                     local_mini_batch_size)) {
+      return m_fwd_dnn_algos[local_mini_batch_size];
+    }
+    const std::string key =
+      get_algo_cache_key("fwd", local_mini_batch_size, ws_size);
+    int cached_algo;
+    if (conv_algo_cache::find(key, cached_algo)) {
+      m_fwd_dnn_algos[local_mini_batch_size] =
+        static_cast<fwd_conv_alg>(cached_algo);
+      return m_fwd_dnn_algos[local_mini_batch_size];
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
@@ -1125,6 +1304,10 @@ base_convolution_layer<TensorDataType, Device>::get_forward_algo_dnn(
                                  output,
                                  ws_size,
                                  ws);
+    conv_algo_cache::insert(
+      *this->get_comm(),
+      key,
+      static_cast<int>(m_fwd_dnn_algos[local_mini_batch_size]));
   }
   return m_fwd_dnn_algos[local_mini_batch_size];
 }
@@ -1144,6 +1327,18 @@ base_convolution_layer<TensorDataType, Device>::get_backward_data_algo_dnn(
   TensorDataType* ws)
 {
   if (m_bwd_data_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (reuse_larger_mini_batch_algo(m_bwd_data_dnn_algos,
+                                     local_mini_batch_size)) {
+      return m_bwd_data_dnn_algos[local_mini_batch_size];
+    }
+    const std::string key =
+      get_algo_cache_key("bwd_data", local_mini_batch_size, ws_size);
+    int cached_algo;
+    if (conv_algo_cache::find(key, cached_algo)) {
+      m_bwd_data_dnn_algos[local_mini_batch_size] =
+        static_cast<bwd_data_conv_alg>(cached_algo);
+      return m_bwd_data_dnn_algos[local_mini_batch_size];
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
@@ -1161,6 +1356,10 @@ base_convolution_layer<TensorDataType, Device>::get_backward_data_algo_dnn(
                                       error_signal,
                                       ws_size,
                                       ws);
+    conv_algo_cache::insert(
+      *this->get_comm(),
+      key,
+      static_cast<int>(m_bwd_data_dnn_algos[local_mini_batch_size]));
   }
   return m_bwd_data_dnn_algos[local_mini_batch_size];
 }
@@ -1179,6 +1378,18 @@ base_convolution_layer<TensorDataType, Device>::get_backward_filter_algo_dnn(
   TensorDataType* ws)
 {
   if (m_bwd_filter_dnn_algos.count(local_mini_batch_size) == 0) {
+    if (reuse_larger_mini_batch_algo(m_bwd_filter_dnn_algos,
+                                     local_mini_batch_size)) {
+      return m_bwd_filter_dnn_algos[local_mini_batch_size];
+    }
+    const std::string key =
+      get_algo_cache_key("bwd_filter", local_mini_batch_size, ws_size);
+    int cached_algo;
+    if (conv_algo_cache::find(key, cached_algo)) {
+      m_bwd_filter_dnn_algos[local_mini_batch_size] =
+        static_cast<bwd_filter_conv_alg>(cached_algo);
+      return m_bwd_filter_dnn_algos[local_mini_batch_size];
+    }
 #ifdef LBANN_DETERMINISTIC
     bool deterministic = true;
 #else
@@ -1203,6 +1414,10 @@ base_convolution_layer<TensorDataType, Device>::get_backward_filter_algo_dnn(
                                         kernel_gradient.Buffer(),
                                         ws_size,
                                         ws);
+    conv_algo_cache::insert(
+      *this->get_comm(),
+      key,
+      static_cast<int>(m_bwd_filter_dnn_algos[local_mini_batch_size]));
   }
   return m_bwd_filter_dnn_algos[local_mini_batch_size];
 }
@@ -1413,6 +1628,173 @@ void base_convolution_adapter<TensorDataType,
   }
 }
 
+template <typename TensorDataType, El::Device Device>
+void base_convolution_adapter<TensorDataType,
+                              Device>::autotune_parallel_strategy()
+{
+  auto& l = dynamic_cast<base_convolution_layer<TensorDataType, Device>&>(
+    this->layer());
+  const auto& costs = dc::get_cost_measurements();
+  const int num_procs = l.get_comm()->get_procs_per_trainer();
+  const auto mini_batch_size =
+    static_cast<int>(l.get_model()->get_max_mini_batch_size_distconv());
+  const auto input_dims = l.get_input_dims();
+  const auto output_dims = l.get_output_dims();
+  const auto kernel_dims = l.get_kernel_dims();
+  const auto num_spatial_dims = input_dims.size() - 1;
+  const double elem_size = sizeof(TensorDataType);
+  if (num_spatial_dims < 2) {
+    return;
+  }
+
+  // Halo width of each spatial dimension
+  std::vector<int> halos(num_spatial_dims);
+  for (size_t i = 0; i < num_spatial_dims; ++i) {
+    halos[i] = (kernel_dims[i + 2] - 1) / 2 * l.get_dilations()[i];
+  }
+  // Flops of the forward, backward data and backward filter
+  // convolutions of a sample
+  const double sample_flops =
+    3.0 * 2.0 * get_linear_size_as<double>(output_dims) *
+    get_linear_size_as<double>(kernel_dims.size() - 1, &kernel_dims[1]);
+
+  const ParallelStrategy* parent_ps = nullptr;
+  for (const auto* parent : l.get_parent_layers()) {
+    if (parent->distconv_enabled()) {
+      parent_ps = &parent->get_parallel_strategy();
+      break;
+    }
+  }
+
+  // Modelled time of a training step with the given process groups
+  // of the sample and spatial dimensions, or a negative value if
+  // the decomposition is not supported. The weight gradient
+  // allreduce costs the same for all decompositions and is left out.
+  auto step_time = [&](int samples, const std::vector<int>& groups) {
+    if (samples > mini_batch_size) {
+      return -1.0;
+    }
+    const double local_samples =
+      (mini_batch_size + samples - 1) / samples;
+    std::vector<double> local_input(num_spatial_dims);
+    std::vector<double> local_output(num_spatial_dims);
+    double interior = 1.0;
+    for (size_t i = 0; i < num_spatial_dims; ++i) {
+      if (input_dims[i + 1] % groups[i] != 0 ||
+          output_dims[i + 1] % groups[i] != 0 ||
+          input_dims[i + 1] / groups[i] <= 2 * halos[i]) {
+        return -1.0;
+      }
+      local_input[i] = input_dims[i + 1] / groups[i];
+      local_output[i] = output_dims[i + 1] / groups[i];
+      if (groups[i] > 1) {
+        interior *= (local_input[i] - 2 * halos[i]) / local_input[i];
+      }
+    }
+    const double compute_time = local_samples * sample_flops /
+                                (num_procs / samples) * costs.flop_time;
+
+    // Halos of the activations in forward prop and of the error
+    // signals in backprop
+    double halo_elems = 0.0, halo_msgs = 0.0;
+    for (size_t i = 0; i < num_spatial_dims; ++i) {
+      if (groups[i] == 1 || halos[i] == 0) {
+        continue;
+      }
+      double input_face = local_samples * input_dims[0];
+      double output_face = local_samples * output_dims[0];
+      for (size_t j = 0; j < num_spatial_dims; ++j) {
+        if (j != i) {
+          input_face *= local_input[j];
+          output_face *= local_output[j];
+        }
+      }
+      halo_elems += 2 * halos[i] * (input_face + output_face);
+      halo_msgs += 4;
+    }
+    double halo_time = (halo_msgs * costs.latency +
+                        halo_elems * elem_size * costs.byte_time);
+    if (dc::is_halo_exchange_overlapped()) {
+      halo_time = std::max(halo_time - interior * compute_time, 0.0);
+    }
+
+    // Shuffle of the activations and error signals if the parent is
+    // decomposed differently
+    double shuffle_time = 0.0;
+    if (parent_ps != nullptr) {
+      const bool same =
+        parent_ps->sample_groups == samples &&
+        parent_ps->height_groups == groups[num_spatial_dims - 2] &&
+        parent_ps->width_groups == groups[num_spatial_dims - 1] &&
+        (num_spatial_dims < 3 || parent_ps->depth_groups == groups[0]);
+      if (!same) {
+        double local_elems = local_samples * input_dims[0];
+        for (const auto& d : local_input) {
+          local_elems *= d;
+        }
+        shuffle_time = 2 * (num_procs * costs.latency +
+                            local_elems * elem_size * costs.byte_time);
+      }
+    }
+    return compute_time + halo_time + shuffle_time;
+  };
+
+  // Enumerate the factorizations of the number of processes,
+  // preferring sample decomposition on ties since it needs no halo
+  double best_time = -1.0;
+  int best_samples = 0;
+  std::vector<int> best_groups;
+  std::vector<int> groups(num_spatial_dims, 1);
+  std::function<void(int, size_t, int)> search =
+    [&](int samples, size_t dim, int procs) {
+      if (dim + 1 == num_spatial_dims) {
+        groups[dim] = procs;
+        const double time = step_time(samples, groups);
+        if (time >= 0.0 && (best_time < 0.0 || time < best_time)) {
+          best_time = time;
+          best_samples = samples;
+          best_groups = groups;
+        }
+        return;
+      }
+      for (int g = 1; g <= procs; ++g) {
+        if (procs % g == 0) {
+          groups[dim] = g;
+          search(samples, dim + 1, procs / g);
+        }
+      }
+    };
+  for (int samples = num_procs; samples >= 1; --samples) {
+    if (num_procs % samples == 0) {
+      search(samples, 0, num_procs / samples);
+    }
+  }
+  if (best_time < 0.0) {
+    if (l.get_comm()->am_trainer_master()) {
+      LBANN_WARNING("[",
+                    l.get_name(),
+                    "]: no supported decomposition found, keeping the "
+                    "parallel strategy ",
+                    l.get_parallel_strategy());
+    }
+    return;
+  }
+
+  this->set_decomposition(best_samples,
+                          num_spatial_dims == 3 ? best_groups[0] : 1,
+                          best_groups[num_spatial_dims - 2],
+                          best_groups[num_spatial_dims - 1]);
+  if (l.get_comm()->am_trainer_master()) {
+    LBANN_MSG("[",
+              l.get_name(),
+              "]: autotuned parallel strategy ",
+              l.get_parallel_strategy(),
+              ", modelled step time ",
+              best_time,
+              " s");
+  }
+}
+
 #define PROTO_DEVICE(T, Device)                                                \
   template class base_convolution_adapter<T, Device>
 
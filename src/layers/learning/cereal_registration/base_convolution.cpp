@@ -43,6 +43,7 @@ void base_convolution_layer<TensorDataType, Device>::serialize(ArchiveT& ar)
      CEREAL_NVP(m_strides),
      CEREAL_NVP(m_dilations),
      CEREAL_NVP(m_groups),
+     CEREAL_NVP(m_channels_last),
      CEREAL_NVP(m_bias_scaling_factor));
   /// @todo Consider serializing m_convolution_math_type
 }
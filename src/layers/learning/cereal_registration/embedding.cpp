@@ -37,7 +37,10 @@ void embedding_layer<TensorDataType, Layout, Device>::serialize(ArchiveT& ar)
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_num_embeddings),
      CEREAL_NVP(m_embedding_dim),
-     CEREAL_NVP(m_padding_idx));
+     CEREAL_NVP(m_padding_idx),
+     CEREAL_NVP(m_sparse_sgd),
+     CEREAL_NVP(m_learning_rate),
+     CEREAL_NVP(m_hash_indices));
 }
 
 } // namespace lbann
@@ -38,7 +38,8 @@ void fully_connected_layer<TensorDataType, Layout, Device>::serialize(
   ar(::cereal::make_nvp("DataTypeLayer",
                         ::cereal::base_class<DataTypeLayer>(this)),
      CEREAL_NVP(m_bias_scaling_factor),
-     CEREAL_NVP(m_transpose));
+     CEREAL_NVP(m_transpose),
+     CEREAL_NVP(m_tensor_parallel));
 }
 
 } // namespace lbann
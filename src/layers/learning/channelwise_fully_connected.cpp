@@ -27,6 +27,7 @@
 #define LBANN_CHANNELWISE_FULLY_CONNECTED_LAYER_INSTANTIATE
 #include "lbann/layers/learning/channelwise_fully_connected.hpp"
 #include "lbann/models/model.hpp"
+#include "lbann/utils/batched_gemm.hpp"
 #include "lbann/weights/initializer.hpp"
 #include "lbann/weights/variance_scaling_initializers.hpp"
 
@@ -562,7 +563,8 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
                                                     std::multiplies<size_t>());
 
   // Set number of weights
-  using WeightsType = data_type_weights<TensorDataType>;
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  using MasterWeights = data_type_weights<MasterDataType>;
   if ((m_has_bias && this->num_weights() > 2) ||
       (!m_has_bias && this->num_weights() > 1)) {
     LBANN_ERROR("attempted to setup ",
@@ -579,10 +581,10 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
 
   // Create default linearity weights if needed
   if (!this->has_weights(0)) {
-    auto w = std::make_shared<WeightsType>(*this->get_comm());
-    auto init = std::make_unique<he_initializer<TensorDataType>>(
+    auto w = std::make_shared<MasterWeights>(*this->get_comm());
+    auto init = std::make_unique<he_initializer<MasterDataType>>(
       probability_distribution::gaussian);
-    auto opt = this->m_model->template create_optimizer<TensorDataType>();
+    auto opt = this->m_model->template create_optimizer<MasterDataType>();
     w->set_name(this->get_name() + "_linearity_weights");
     w->set_initializer(std::move(init));
     w->set_optimizer(std::move(opt));
@@ -612,8 +614,8 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
     dist.colDist = El::STAR;
     dist.rowDist = El::STAR;
     if (!this->has_weights(1)) {
-      auto w = std::make_shared<WeightsType>(*this->get_comm());
-      auto opt = this->m_model->template create_optimizer<TensorDataType>();
+      auto w = std::make_shared<MasterWeights>(*this->get_comm());
+      auto opt = this->m_model->template create_optimizer<MasterDataType>();
       w->set_name(this->get_name() + "_bias_weights");
       w->set_optimizer(std::move(opt));
       this->set_weights(1, w);
@@ -664,68 +666,23 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
     dynamic_cast<const LocalMat&>(linearity.LockedMatrix());
 
   // Tensor dimensions
-  const auto& local_mini_batch_size = local_input.Width();
-  const auto& input_dims = this->get_input_dims();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = input_dims[0];
-  const auto& input_channel_size = std::accumulate(input_dims.begin() + 1,
-                                                   input_dims.end(),
-                                                   1,
-                                                   std::multiplies<size_t>());
-  const auto& output_channel_size = std::accumulate(output_dims.begin() + 1,
-                                                    output_dims.end(),
-                                                    1,
-                                                    std::multiplies<size_t>());
+  const auto& num_channels = this->get_input_dims()[0];
 
-  // Reshape input and output tensors
-  // Note: [mini_batch_size,num_channels,*] -> [mini_batch_size*num_channels,*]
-  LocalMat local_input_reshaped, local_output_reshaped;
-  if (local_input.Contiguous()) {
-    local_input_reshaped.LockedAttach(input_channel_size,
-                                      local_mini_batch_size * num_channels,
-                                      local_input.LockedBuffer(),
-                                      input_channel_size);
-  }
-  else {
-    El::Copy(local_input, local_input_reshaped);
-    local_input_reshaped.Resize(input_channel_size,
-                                local_mini_batch_size * num_channels);
-  }
-  if (local_output.Contiguous()) {
-    local_output_reshaped.Attach(output_channel_size,
-                                 local_mini_batch_size * num_channels,
-                                 local_output.Buffer(),
-                                 output_channel_size);
-  }
-  else {
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "has a non-contiguous output tensor");
-  }
-  // Apply linearity
-  El::Gemm(m_transpose ? El::TRANSPOSE : El::NORMAL,
-           El::NORMAL,
-           one,
-           local_linearity,
-           local_input_reshaped,
-           zero,
-           reinterpret_cast<LocalMat&>(local_output_reshaped));
-
-  // Apply bias
+  // Apply linearity and bias
+  // Note: The bias is broadcast into the output so that the GEMM can
+  // accumulate onto it.
   if (m_has_bias) {
     const auto& bias = this->weights_values(1);
-    LocalMat ones(local_mini_batch_size * num_channels, 1);
-    El::Fill(ones, one);
-    El::Gemm(El::NORMAL,
-             El::TRANSPOSE,
-             one,
-             reinterpret_cast<const LocalMat&>(bias.LockedMatrix()),
-             ones,
-             one,
-             reinterpret_cast<LocalMat&>(local_output_reshaped));
-  }
+    fill_channelwise_bias(dynamic_cast<const LocalMat&>(bias.LockedMatrix()),
+                          local_output);
+  }
+  channelwise_gemm(m_transpose ? El::TRANSPOSE : El::NORMAL,
+                   one,
+                   local_linearity,
+                   local_input,
+                   m_has_bias ? one : zero,
+                   local_output,
+                   num_channels);
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -757,68 +714,24 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
     dynamic_cast<const LocalMat&>(linearity.LockedMatrix());
 
   // Tensor dimensions
-  const auto& local_mini_batch_size = local_input.Width();
-  const auto& input_dims = this->get_input_dims();
-  const auto& output_dims = this->get_output_dims();
-  const auto& num_channels = input_dims[0];
-  const auto& input_channel_size = std::accumulate(input_dims.begin() + 1,
-                                                   input_dims.end(),
-                                                   1,
-                                                   std::multiplies<size_t>());
-  const auto& output_channel_size = std::accumulate(output_dims.begin() + 1,
-                                                    output_dims.end(),
-                                                    1,
-                                                    std::multiplies<size_t>());
-
-  // Reshape input and output tensors
-  // Note: [mini_batch_size,num_channels,*] -> [mini_batch_size*num_channels,*]
-  LocalMat local_input_reshaped, local_output_grad_reshaped,
-    local_input_grad_reshaped;
-  if (local_input.Contiguous()) {
-    local_input_reshaped.LockedAttach(input_channel_size,
-                                      local_mini_batch_size * num_channels,
-                                      local_input.LockedBuffer(),
-                                      input_channel_size);
-  }
-  else {
-    El::Copy(local_input, local_input_reshaped);
-    local_input_reshaped.Resize(input_channel_size,
-                                local_mini_batch_size * num_channels);
-  }
-  if (local_output_grad.Contiguous()) {
-    local_output_grad_reshaped.LockedAttach(output_channel_size,
-                                            local_mini_batch_size *
-                                              num_channels,
-                                            local_output_grad.LockedBuffer(),
-                                            output_channel_size);
-  }
-  else {
-    El::Copy(local_output_grad, local_output_grad_reshaped);
-    local_output_grad_reshaped.Resize(output_channel_size,
-                                      local_mini_batch_size * num_channels);
-  }
-  if (local_input_grad.Contiguous()) {
-    local_input_grad_reshaped.Attach(input_channel_size,
-                                     local_mini_batch_size * num_channels,
-                                     local_input_grad.Buffer(),
-                                     input_channel_size);
-  }
-  else {
-    LBANN_ERROR(this->get_type(),
-                " layer \"",
-                this->get_name(),
-                "\" ",
-                "has a non-contiguous gradient w.r.t. input tensor");
-  }
+  const auto& num_channels = this->get_input_dims()[0];
 
   // Compute gradient w.r.t. input
-  El::Gemm(m_transpose ? El::NORMAL : El::TRANSPOSE,
-           El::NORMAL,
-           one,
-           local_linearity,
-           local_output_grad_reshaped,
-           zero,
-           reinterpret_cast<LocalMat&>(local_input_grad_reshaped));
+  channelwise_gemm(m_transpose ? El::NORMAL : El::TRANSPOSE,
+                   one,
+                   local_linearity,
+                   local_output_grad,
+                   zero,
+                   local_input_grad,
+                   num_channels);
+
+  // Reshape input and output gradient tensors
+  // Note: [mini_batch_size,num_channels,*] -> [mini_batch_size*num_channels,*]
+  LocalMat local_input_reshaped, local_output_grad_reshaped;
+  get_channelwise_matrix(local_input, num_channels, local_input_reshaped);
+  get_channelwise_matrix(local_output_grad,
+                         num_channels,
+                         local_output_grad_reshaped);
 
   // Compute gradient w.r.t. linearity
   auto* linearity_optimizer = this->get_weights(0).get_optimizer();
@@ -854,7 +767,13 @@ void channelwise_fully_connected_layer<TensorDataType, Layout, Device>::
       TensorDataType dst_scale, gradient_scale;
       auto& bias_gradient =
         bias_optimizer->get_gradient_buffer(dst_scale, gradient_scale, true);
-      LocalMat ones(local_mini_batch_size * num_channels, 1);
+      LocalMat ones;
+#ifdef HYDROGEN_HAVE_CUB
+      if constexpr (Device == El::Device::GPU) {
+        ones.SetMemoryMode(1); // CUB GPU memory pool
+      }
+#endif // HYDROGEN_HAVE_CUB
+      ones.Resize(local_output_grad_reshaped.Width(), 1);
       El::Fill(ones, one);
       El::Gemv(El::NORMAL,
                gradient_scale,
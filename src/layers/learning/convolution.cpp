@@ -31,10 +31,15 @@
 
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/protobuf.hpp"
+#include "lbann/weights/initializer.hpp"
+#include "lbann/weights/weights_helpers.hpp"
 
 #include "lbann/proto/layers.pb.h"
 
+#include <type_traits>
+
 #ifdef LBANN_HAS_ONNX
 #include <onnx/onnx_pb.h>
 #endif // LBANN_HAS_ONNX
@@ -173,6 +178,114 @@ void convolution_layer<TensorDataType, Layout, Device>::bp_compute()
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool convolution_layer<TensorDataType, Layout, Device>::fold_inference_affine(
+  std::vector<double> const& scale,
+  std::vector<double> const& shift)
+{
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  using ScalingType =
+    typename base_convolution_layer<TensorDataType, Device>::ScalingType;
+  if constexpr (!std::is_floating_point_v<MasterDataType>) {
+    return false;
+  }
+  else {
+    const bool has_bias =
+      (this->m_bias_scaling_factor != El::TypeTraits<ScalingType>::Zero());
+    if (scale.size() != size_t(this->m_output_channels) ||
+        shift.size() != scale.size() || this->num_weights() < 1 ||
+        !this->has_weights(0) || !this->get_weights(0).has_values() ||
+        (has_bias && (this->num_weights() < 2 || !this->has_weights(1) ||
+                      !this->get_weights(1).has_values()))) {
+      return false;
+    }
+
+    // The kernel is stored with the output channel varying slowest
+    using weights_details::apply_channelwise_affine;
+    apply_channelwise_affine<MasterDataType>(this->get_weights(0),
+                                             scale,
+                                             {},
+                                             false);
+    if (has_bias) {
+      const double bias_scale = this->m_bias_scaling_factor;
+      std::vector<double> bias_shift(shift.size());
+      for (size_t c = 0; c < shift.size(); ++c) {
+        bias_shift[c] = shift[c] / bias_scale;
+      }
+      apply_channelwise_affine<MasterDataType>(this->get_weights(1),
+                                               scale,
+                                               bias_shift,
+                                               false);
+    }
+    else {
+      auto w =
+        std::make_shared<data_type_weights<MasterDataType>>(*this->get_comm());
+      w->set_name(this->get_name() + "_bias");
+      w->set_initializer(std::make_unique<value_initializer<MasterDataType>>(
+        std::vector<MasterDataType>(shift.begin(), shift.end())));
+      w->freeze();
+      this->m_bias_scaling_factor = El::TypeTraits<ScalingType>::One();
+      this->set_num_weights(2);
+      this->set_weights(1, w);
+      this->m_model->add_weights(std::move(w));
+    }
+    return true;
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+bool convolution_layer<TensorDataType, Layout, Device>::
+  quantize_inference_weights(std::vector<double>& scale)
+{
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  if constexpr (!std::is_floating_point_v<MasterDataType>) {
+    return false;
+  }
+  else {
+    if (this->num_weights() < 1 || !this->has_weights(0) ||
+        !this->get_weights(0).has_values()) {
+      return false;
+    }
+    scale = weights_details::quantize_channelwise_int8<MasterDataType>(
+      this->get_weights(0),
+      this->m_output_channels,
+      false);
+    return true;
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+compute_cost
+convolution_layer<TensorDataType, Layout, Device>::get_forward_prop_cost()
+  const
+{
+  // Each output entry is a dot product with a slice of the kernel,
+  // plus the bias
+  const auto kernel_dims = get_kernel_dims();
+  const auto slice_size =
+    get_linear_size_as<double>(kernel_dims.size() - 1, &kernel_dims[1]);
+  const auto& output = this->get_local_activations();
+  const double output_size = output.Height() * output.Width();
+  auto cost = data_type_layer<TensorDataType>::get_forward_prop_cost();
+  cost.flops = output_size * (2. * slice_size + 1.);
+  return cost;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+compute_cost
+convolution_layer<TensorDataType, Layout, Device>::get_backward_prop_cost()
+  const
+{
+  const auto kernel_dims = get_kernel_dims();
+  const auto slice_size =
+    get_linear_size_as<double>(kernel_dims.size() - 1, &kernel_dims[1]);
+  const auto& output = this->get_local_activations();
+  const double output_size = output.Height() * output.Width();
+  auto cost = data_type_layer<TensorDataType>::get_backward_prop_cost();
+  cost.flops = output_size * (4. * slice_size + 1.);
+  return cost;
+}
+
 #ifdef LBANN_HAS_ONNX
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void convolution_layer<TensorDataType, Layout, Device>::fill_onnx_node(
@@ -245,6 +358,7 @@ void convolution_layer<T, L, D>::write_specific_proto(
   auto const has_bias = (this->num_weights() > 1UL);
   msg->mutable_has_bias()->set_value(has_bias);
   protobuf::assign_to_repeated(*msg->mutable_dilation(), this->get_dilations());
+  msg->set_channels_last(this->m_channels_last);
 #ifdef LBANN_HAS_DNN_LIB
   msg->set_conv_tensor_op_mode(
     dnn_lib::convert_to_proto_math_type(this->m_convolution_math_type));
@@ -264,6 +378,10 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 bool convolution_layer<TensorDataType, Layout, Device>::is_distconv_supported()
   const
 {
+  if (this->m_channels_last) {
+    dc::MPIRootPrintStreamDebug() << "Channels-last tensors not supported";
+    return false;
+  }
   const auto& kernel_dims = get_kernel_dims();
   for (int i = 0; i < dc::get_num_spatial_dims(*this); i++) {
     if (kernel_dims[2 + i] != kernel_dims[2]) {
@@ -451,6 +569,7 @@ struct ConvLayerBuilder
         ensure_dims(params.dilation(), /*default=*/1),
         num_groups,
         bias);
+    ret->set_channels_last(params.channels_last());
 #ifdef LBANN_HAS_DNN_LIB
     ret->set_dnn_math_mode(
       dnn_lib::convert_to_dnn_math_type(params.conv_tensor_op_mode()));
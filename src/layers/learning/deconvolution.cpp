@@ -32,6 +32,7 @@
 
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/proto_common.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/protobuf.hpp"
 
@@ -238,12 +239,53 @@ void deconvolution_layer<TensorDataType, Layout, Device>::bp_compute()
   }
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+compute_cost
+deconvolution_layer<TensorDataType, Layout, Device>::get_forward_prop_cost()
+  const
+{
+  // Each input entry is scattered with a slice of the kernel, then
+  // the bias is added
+  const auto kernel_dims = get_kernel_dims();
+  const auto slice_size =
+    get_linear_size_as<double>(kernel_dims.size() - 1, &kernel_dims[1]);
+  const auto& input = this->get_local_prev_activations();
+  const auto& output = this->get_local_activations();
+  const double input_size = input.Height() * input.Width();
+  const double output_size = output.Height() * output.Width();
+  auto cost = data_type_layer<TensorDataType>::get_forward_prop_cost();
+  cost.flops = 2. * input_size * slice_size + output_size;
+  return cost;
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+compute_cost
+deconvolution_layer<TensorDataType, Layout, Device>::get_backward_prop_cost()
+  const
+{
+  const auto kernel_dims = get_kernel_dims();
+  const auto slice_size =
+    get_linear_size_as<double>(kernel_dims.size() - 1, &kernel_dims[1]);
+  const auto& input = this->get_local_prev_activations();
+  const auto& output = this->get_local_activations();
+  const double input_size = input.Height() * input.Width();
+  const double output_size = output.Height() * output.Width();
+  auto cost = data_type_layer<TensorDataType>::get_backward_prop_cost();
+  cost.flops = 4. * input_size * slice_size + output_size;
+  return cost;
+}
+
 #if defined LBANN_HAS_DISTCONV
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 bool deconvolution_layer<TensorDataType, Layout, Device>::
   is_distconv_supported() const
 {
+  if (this->m_channels_last) {
+    dc::MPIPrintStreamDebug()
+      << this->get_name() << " unsupported as tensors are channels-last";
+    return false;
+  }
   const auto& kernel_dims = get_kernel_dims();
   for (int i = 0; i < dc::get_num_spatial_dims(*this); i++) {
     auto pad = this->m_pads[i];
@@ -430,8 +472,9 @@ struct Builder<TensorDataType, data_layout::DATA_PARALLEL, Device>
     using LayerType =
       deconvolution_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>;
     auto ret = make_unique<LayerType>(std::forward<Args>(args)...);
-#ifdef LBANN_HAS_DNN_LIB
     const auto& params = proto_layer.deconvolution();
+    ret->set_channels_last(params.channels_last());
+#ifdef LBANN_HAS_DNN_LIB
     ret->set_dnn_math_mode(
       dnn_lib::convert_to_dnn_math_type(params.conv_tensor_op_mode()));
 #endif // LBANN_HAS_DNN_LIB
@@ -503,6 +546,7 @@ void deconvolution_layer<T, L, D>::write_specific_proto(
   auto const has_bias = (this->num_weights() > 1UL);
   msg->mutable_has_bias()->set_value(has_bias);
   protobuf::assign_to_repeated(*msg->mutable_dilation(), this->get_dilations());
+  msg->set_channels_last(this->m_channels_last);
 #ifdef LBANN_HAS_DNN_LIB
   msg->set_conv_tensor_op_mode(
     dnn_lib::convert_to_proto_math_type(this->m_convolution_math_type));
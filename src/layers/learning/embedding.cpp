@@ -52,7 +52,7 @@ void embedding_layer<TensorDataType, Layout, Device>::fp_compute()
                local_output,
                El::IR(i * m_embedding_dim, (i + 1) * m_embedding_dim),
                El::IR(j));
-      const El::Int ind = static_cast<El::Int>(std::floor(local_input(i, j)));
+      const El::Int ind = get_index(local_input(i, j));
       if (0 <= ind && ind < static_cast<El::Int>(this->m_num_embeddings)) {
         El::LockedView(embedding_v, local_embeddings, El::ALL, El::IR(ind));
         El::Copy(embedding_v, output_v);
@@ -73,6 +73,14 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute()
   // Embedding layer is not differentiable w.r.t. inputs
   El::Zero(this->get_error_signals());
 
+  // Sparse SGD is applied in update_compute
+  if (m_sparse_sgd) {
+    if (!this->get_weights(0).is_frozen()) {
+      gather_sparse_gradients();
+    }
+    return;
+  }
+
   // Nothing to be done if embeddings are not being optimized
   if (this->get_weights(0).get_optimizer() == nullptr) {
     return;
@@ -95,7 +103,7 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute()
   MatType embedding_grad_v, output_grad_v;
   for (size_t j = 0; j < local_mini_batch_size; ++j) {
     for (size_t i = 0; i < input_size; ++i) {
-      const El::Int ind = static_cast<El::Int>(std::floor(local_input(i, j)));
+      const El::Int ind = get_index(local_input(i, j));
       if (0 <= ind && ind < static_cast<El::Int>(this->m_num_embeddings) &&
           ind != this->m_padding_idx) {
         El::LockedView(output_grad_v,
@@ -112,6 +120,73 @@ void embedding_layer<TensorDataType, Layout, Device>::bp_compute()
                       true);
 }
 
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void embedding_layer<TensorDataType, Layout, Device>::get_local_indices(
+  std::vector<El::Int>& indices)
+{
+  using MatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto& local_input =
+    dynamic_cast<const MatType&>(this->get_local_prev_activations());
+  const size_t input_size = this->get_input_size();
+  const size_t local_mini_batch_size = local_input.Width();
+  indices.assign(input_size * local_mini_batch_size, -1);
+  for (size_t j = 0; j < local_mini_batch_size; ++j) {
+    for (size_t i = 0; i < input_size; ++i) {
+      const El::Int ind = get_index(local_input(i, j));
+      if (0 <= ind && ind < static_cast<El::Int>(this->m_num_embeddings) &&
+          ind != this->m_padding_idx) {
+        indices[i + j * input_size] = ind;
+      }
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void embedding_layer<TensorDataType, Layout, Device>::
+  accumulate_sparse_gradients(const std::vector<int>& positions,
+                              El::Matrix<TensorDataType, Device>& grads)
+{
+  using MatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const TensorDataType one = El::TypeTraits<TensorDataType>::One();
+  const auto& local_output_grad =
+    dynamic_cast<const MatType&>(this->get_local_prev_error_signals());
+  const size_t input_size = this->get_input_size();
+  const size_t local_mini_batch_size = local_output_grad.Width();
+  MatType grad_v, output_grad_v;
+  for (size_t j = 0; j < local_mini_batch_size; ++j) {
+    for (size_t i = 0; i < input_size; ++i) {
+      const int pos = positions[i + j * input_size];
+      if (pos >= 0) {
+        El::LockedView(output_grad_v,
+                       local_output_grad,
+                       El::IR(i * m_embedding_dim, (i + 1) * m_embedding_dim),
+                       El::IR(j));
+        El::View(grad_v, grads, El::ALL, El::IR(pos));
+        El::Axpy(one, output_grad_v, grad_v);
+      }
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void embedding_layer<TensorDataType, Layout, Device>::apply_sparse_sgd_step(
+  El::Matrix<TensorDataType, Device>& embeddings)
+{
+  // Note: Every process applies the gathered gradients in the same
+  // order, so the copies of the embeddings stay identical.
+  using MatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto scale = -El::To<TensorDataType>(m_learning_rate);
+  MatType grad_v, embedding_v;
+  for (size_t k = 0; k < m_sparse_indices.size(); ++k) {
+    const El::Int ind = m_sparse_indices[k];
+    if (ind >= 0) {
+      El::LockedView(grad_v, m_sparse_grads, El::ALL, El::IR(k));
+      El::View(embedding_v, embeddings, El::ALL, El::IR(ind));
+      El::Axpy(scale, grad_v, embedding_v);
+    }
+  }
+}
+
 // Explicit instantiation
 #define PROTO(T)                                                               \
   template class embedding_layer<T, data_layout::DATA_PARALLEL, El::Device::CPU>
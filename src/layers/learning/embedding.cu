@@ -28,11 +28,30 @@
 #include "lbann/layers/learning/embedding.hpp"
 #include "lbann/optimizers/optimizer_impl.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/md5.hpp"
 
 namespace lbann {
 
 namespace {
 
+/** @brief Embedding index of an input value
+ *
+ *  With hashed indices, the MD5 hash of the value modulo the number
+ *  of embeddings. The index may be out-of-range.
+ */
+template <typename TensorDataType>
+__device__ __forceinline__ El::Int get_index(const TensorDataType& x,
+                                             bool hash_indices,
+                                             El::Int num_embeddings)
+{
+  if (hash_indices) {
+    return num_embeddings > 0
+             ? static_cast<El::Int>(md5::hash64(x) % num_embeddings)
+             : El::Int(-1);
+  }
+  return static_cast<El::Int>(x);
+}
+
 /** @brief Kernel for forward prop
  *
  *  Block dimensions: bsize x 1 x 1
@@ -41,6 +60,7 @@ namespace {
  */
 template <typename TensorDataType>
 __global__ void fp_kernel(El::Int num_embeddings,
+                          bool hash_indices,
                           El::Int embedding_dim,
                           El::Int input_size,
                           El::Int mini_batch_size,
@@ -59,9 +79,10 @@ __global__ void fp_kernel(El::Int num_embeddings,
   const El::Int nthreadsz = blockDim.z * gridDim.z;
   for (El::Int k = gidz; k < mini_batch_size; k += nthreadsz) {
     for (El::Int j = gidy; j < input_size; j += nthreadsy) {
+      const El::Int ind =
+        get_index(indices[j + k * indices_ldim], hash_indices, num_embeddings);
       for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
         auto& y = output[i + j * embedding_dim + k * output_ldim];
-        const El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
         if (0 <= ind && ind < num_embeddings) {
           y = embeddings[i + ind * embeddings_ldim];
         }
@@ -81,6 +102,7 @@ __global__ void fp_kernel(El::Int num_embeddings,
  */
 template <typename TensorDataType>
 __global__ void bp_kernel(El::Int num_embeddings,
+                          bool hash_indices,
                           El::Int embedding_dim,
                           El::Int input_size,
                           El::Int mini_batch_size,
@@ -100,8 +122,9 @@ __global__ void bp_kernel(El::Int num_embeddings,
   const El::Int nthreadsz = blockDim.z * gridDim.z;
   for (El::Int k = gidz; k < mini_batch_size; k += nthreadsz) {
     for (El::Int j = gidy; j < input_size; j += nthreadsy) {
+      const El::Int ind =
+        get_index(indices[j + k * indices_ldim], hash_indices, num_embeddings);
       for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
-        const El::Int ind = static_cast<El::Int>(indices[j + k * indices_ldim]);
         if (0 <= ind && ind < num_embeddings && ind != padding_idx) {
           const auto& dy =
             output_grad[i + j * embedding_dim + k * output_grad_ldim];
@@ -113,6 +136,115 @@ __global__ void bp_kernel(El::Int num_embeddings,
   }
 }
 
+/** @brief Kernel for converting embedding indices
+ *
+ *  Out-of-range indices and the padding index are set to -1.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (input_size / bsize) x mini_batch_size x 1
+ */
+template <typename TensorDataType>
+__global__ void indices_kernel(El::Int num_embeddings,
+                               bool hash_indices,
+                               El::Int input_size,
+                               El::Int mini_batch_size,
+                               El::Int padding_idx,
+                               const TensorDataType* __restrict__ input,
+                               El::Int input_ldim,
+                               El::Int* __restrict__ indices)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int j = gidy; j < mini_batch_size; j += nthreadsy) {
+    for (El::Int i = gidx; i < input_size; i += nthreadsx) {
+      const El::Int ind =
+        get_index(input[i + j * input_ldim], hash_indices, num_embeddings);
+      const bool valid =
+        (0 <= ind && ind < num_embeddings && ind != padding_idx);
+      indices[i + j * input_size] = valid ? ind : El::Int(-1);
+    }
+  }
+}
+
+/** @brief Kernel for accumulating sparse gradients
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (embedding_dim / bsize) x input_size x mini_batch_size
+ */
+template <typename TensorDataType>
+__global__ void
+sparse_bp_kernel(El::Int embedding_dim,
+                 El::Int input_size,
+                 El::Int mini_batch_size,
+                 const int* __restrict__ positions,
+                 const TensorDataType* __restrict__ output_grad,
+                 El::Int output_grad_ldim,
+                 TensorDataType* __restrict__ sparse_grads,
+                 El::Int sparse_grads_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int gidz = threadIdx.z + blockIdx.z * blockDim.z;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  const El::Int nthreadsz = blockDim.z * gridDim.z;
+  for (El::Int k = gidz; k < mini_batch_size; k += nthreadsz) {
+    for (El::Int j = gidy; j < input_size; j += nthreadsy) {
+      const int pos = positions[j + k * input_size];
+      if (pos < 0) {
+        continue;
+      }
+      for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
+        const auto& dy =
+          output_grad[i + j * embedding_dim + k * output_grad_ldim];
+        auto& dw = sparse_grads[i + pos * sparse_grads_ldim];
+        gpu_lib::atomic_add(&dw, dy);
+      }
+    }
+  }
+}
+
+/** @brief Kernel for sparse SGD
+ *
+ *  The gradients for each embedding vector are applied in a fixed
+ *  order so that every process computes the same embeddings.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (embedding_dim / bsize) x num_rows x 1
+ */
+template <typename TensorDataType>
+__global__ void sgd_kernel(TensorDataType learning_rate,
+                           El::Int embedding_dim,
+                           El::Int num_rows,
+                           const El::Int* __restrict__ rows,
+                           const El::Int* __restrict__ offsets,
+                           const El::Int* __restrict__ columns,
+                           const TensorDataType* __restrict__ sparse_grads,
+                           El::Int sparse_grads_ldim,
+                           TensorDataType* __restrict__ embeddings,
+                           El::Int embeddings_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const El::Int nthreadsy = blockDim.y * gridDim.y;
+  for (El::Int j = gidy; j < num_rows; j += nthreadsy) {
+    auto* __restrict__ w = &embeddings[rows[j] * embeddings_ldim];
+    for (El::Int i = gidx; i < embedding_dim; i += nthreadsx) {
+      auto x = w[i];
+      for (El::Int k = offsets[j]; k < offsets[j + 1]; ++k) {
+        x -= learning_rate * sparse_grads[i + columns[k] * sparse_grads_ldim];
+      }
+      w[i] = x;
+    }
+  }
+}
+
 } // namespace
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -146,6 +278,7 @@ void embedding_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                 0,
                                 multisync,
                                 this->m_num_embeddings,
+                                this->m_hash_indices,
                                 this->m_embedding_dim,
                                 input_size,
                                 local_mini_batch_size,
@@ -166,6 +299,14 @@ void embedding_layer<TensorDataType, T_layout, Dev>::bp_compute()
   // Embedding layer is not differentiable w.r.t. inputs
   El::Zero(this->get_error_signals());
 
+  // Sparse SGD is applied in update_compute
+  if (m_sparse_sgd) {
+    if (!this->get_weights(0).is_frozen()) {
+      gather_sparse_gradients();
+    }
+    return;
+  }
+
   // Nothing to be done if embeddings are not being optimized
   if (this->get_weights(0).get_optimizer() == nullptr) {
     return;
@@ -200,6 +341,7 @@ void embedding_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                 0,
                                 multisync,
                                 this->m_num_embeddings,
+                                this->m_hash_indices,
                                 this->m_embedding_dim,
                                 input_size,
                                 local_mini_batch_size,
@@ -216,6 +358,177 @@ void embedding_layer<TensorDataType, T_layout, Dev>::bp_compute()
                       true);
 }
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void embedding_layer<TensorDataType, T_layout, Dev>::get_local_indices(
+  std::vector<El::Int>& indices)
+{
+  using MatType = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& local_input =
+    dynamic_cast<const MatType&>(this->get_local_prev_activations());
+  const auto& input_size = this->get_input_size();
+  const auto& local_mini_batch_size = local_input.Width();
+  indices.resize(input_size * local_mini_batch_size);
+  if (indices.empty()) {
+    return;
+  }
+
+  // Convert indices on GPU
+  auto sync_info = gpu::get_sync_info(local_input);
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> device_indices(
+    indices.size(),
+    sync_info);
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (input_size + block_size - 1) / block_size;
+  grid_dims.y = std::min(local_mini_batch_size, El::Int(65535));
+  hydrogen::gpu::LaunchKernel(indices_kernel<TensorDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              sync_info,
+                              this->m_num_embeddings,
+                              this->m_hash_indices,
+                              input_size,
+                              local_mini_batch_size,
+                              this->m_padding_idx,
+                              local_input.LockedBuffer(),
+                              local_input.LDim(),
+                              device_indices.data());
+
+  // Copy indices to host
+  hydrogen::gpu::Copy1DToHost(device_indices.data(),
+                              indices.data(),
+                              indices.size(),
+                              sync_info);
+  gpu_lib::event_wrapper event;
+  event.record(sync_info.Stream());
+  event.synchronize();
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void embedding_layer<TensorDataType, T_layout, Dev>::
+  accumulate_sparse_gradients(const std::vector<int>& positions,
+                              El::Matrix<TensorDataType, Dev>& grads)
+{
+  using MatType = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& local_output_grad =
+    dynamic_cast<const MatType&>(this->get_local_prev_error_signals());
+  const auto& input_size = this->get_input_size();
+  const auto& local_mini_batch_size = local_output_grad.Width();
+  if (positions.empty()) {
+    return;
+  }
+
+  // Copy positions to GPU
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(grads),
+                                     gpu::get_sync_info(local_output_grad));
+  auto sync_info = gpu::get_sync_info(grads);
+  hydrogen::simple_buffer<int, El::Device::GPU> device_positions(
+    positions.size(),
+    sync_info);
+  hydrogen::gpu::Copy1DToDevice(positions.data(),
+                                device_positions.data(),
+                                positions.size(),
+                                sync_info);
+
+  // Launch GPU kernel
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (this->m_embedding_dim + block_size - 1) / block_size;
+  grid_dims.y = input_size;
+  grid_dims.z = local_mini_batch_size;
+  hydrogen::gpu::LaunchKernel(sparse_bp_kernel<TensorDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              this->m_embedding_dim,
+                              input_size,
+                              local_mini_batch_size,
+                              device_positions.data(),
+                              local_output_grad.LockedBuffer(),
+                              local_output_grad.LDim(),
+                              grads.Buffer(),
+                              grads.LDim());
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void embedding_layer<TensorDataType, T_layout, Dev>::apply_sparse_sgd_step(
+  El::Matrix<TensorDataType, Dev>& embeddings)
+{
+
+  // Group gathered gradients by embedding vector
+  // Note: Workspace contains row indices, offsets, and gradient
+  // columns.
+  std::vector<El::Int> columns;
+  columns.reserve(m_sparse_indices.size());
+  for (size_t k = 0; k < m_sparse_indices.size(); ++k) {
+    if (m_sparse_indices[k] >= 0) {
+      columns.push_back(k);
+    }
+  }
+  std::stable_sort(columns.begin(),
+                   columns.end(),
+                   [this](El::Int a, El::Int b) {
+                     return m_sparse_indices[a] < m_sparse_indices[b];
+                   });
+  std::vector<El::Int> rows, offsets;
+  for (size_t k = 0; k < columns.size(); ++k) {
+    const El::Int ind = m_sparse_indices[columns[k]];
+    if (rows.empty() || rows.back() != ind) {
+      rows.push_back(ind);
+      offsets.push_back(k);
+    }
+  }
+  offsets.push_back(columns.size());
+  const El::Int num_rows = rows.size();
+  std::vector<El::Int> workspace;
+  workspace.reserve(rows.size() + offsets.size() + columns.size());
+  workspace.insert(workspace.end(), rows.begin(), rows.end());
+  workspace.insert(workspace.end(), offsets.begin(), offsets.end());
+  workspace.insert(workspace.end(), columns.begin(), columns.end());
+
+  // Copy workspace to GPU
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(embeddings),
+                                     gpu::get_sync_info(m_sparse_grads));
+  auto sync_info = gpu::get_sync_info(embeddings);
+  hydrogen::simple_buffer<El::Int, El::Device::GPU> device_workspace(
+    workspace.size(),
+    sync_info);
+  hydrogen::gpu::Copy1DToDevice(workspace.data(),
+                                device_workspace.data(),
+                                workspace.size(),
+                                sync_info);
+  const El::Int* device_rows = device_workspace.data();
+  const El::Int* device_offsets = device_rows + rows.size();
+  const El::Int* device_columns = device_offsets + offsets.size();
+
+  // Launch GPU kernel
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (this->m_embedding_dim + block_size - 1) / block_size;
+  grid_dims.y = std::min(num_rows, El::Int(65535));
+  hydrogen::gpu::LaunchKernel(
+    sgd_kernel<TensorDataType>,
+    grid_dims,
+    block_dims,
+    0,
+    multisync,
+    El::To<TensorDataType>(m_learning_rate),
+    this->m_embedding_dim,
+    num_rows,
+    device_rows,
+    device_offsets,
+    device_columns,
+    m_sparse_grads.LockedBuffer(),
+    m_sparse_grads.LDim(),
+    embeddings.Buffer(),
+    embeddings.LDim());
+}
+
 // Explicit instantiation
 #define PROTO(T)                                                               \
   template class embedding_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
@@ -73,7 +73,12 @@ build_embedding_layer_from_pbuf(lbann_comm* comm,
   const size_t embedding_dim = params.embedding_dim();
   const El::Int padding_idx =
     (params.has_padding_idx() ? params.padding_idx().value() : -1);
-  return BuilderType::Build(num_embeddings, embedding_dim, padding_idx);
+  return BuilderType::Build(num_embeddings,
+                            embedding_dim,
+                            padding_idx,
+                            params.sparse_sgd(),
+                            params.learning_rate(),
+                            params.hash_indices());
 }
 
 #define PROTO_DEVICE(T, Device) LBANN_LAYER_BUILDER_ETI(embedding, T, Device)
@@ -30,6 +30,7 @@
 #include "lbann/optimizers/optimizer_impl.hpp"
 #include "lbann/weights/initializer.hpp"
 #include "lbann/weights/variance_scaling_initializers.hpp"
+#include "lbann/weights/weights_helpers.hpp"
 
 #include "lbann/proto/datatype_helpers.hpp"
 
@@ -37,6 +38,7 @@
 
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 namespace lbann {
 
@@ -45,10 +47,12 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   int output_size,
   bool transpose,
   WeightsType* weight,
-  bool has_bias)
+  bool has_bias,
+  tensor_parallel_mode tensor_parallel)
   : data_type_layer<TensorDataType>(nullptr),
     m_bias_gradient(nullptr),
-    m_transpose(transpose)
+    m_transpose(transpose),
+    m_tensor_parallel(tensor_parallel)
 {
 
   // Initialize output tensor dimensions
@@ -69,7 +73,10 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::fully_connected_layer(
   const fully_connected_layer& other)
   : data_type_layer<TensorDataType>(other),
     m_bias_scaling_factor(other.m_bias_scaling_factor),
-    m_transpose(other.m_transpose)
+    m_transpose(other.m_transpose),
+    m_tensor_parallel(other.m_tensor_parallel),
+    m_gathered_input(other.m_gathered_input ? other.m_gathered_input->Copy()
+                                            : nullptr)
 {
 
   // Deep matrix copies
@@ -86,6 +93,9 @@ auto fully_connected_layer<TensorDataType, T_layout, Dev>::operator=(
   data_type_layer<TensorDataType>::operator=(other);
   m_bias_scaling_factor = other.m_bias_scaling_factor;
   m_transpose = other.m_transpose;
+  m_tensor_parallel = other.m_tensor_parallel;
+  m_gathered_input.reset(
+    other.m_gathered_input ? other.m_gathered_input->Copy() : nullptr);
 
   // Deep matrix copies
   deallocate_matrices();
@@ -113,9 +123,136 @@ fully_connected_layer<TensorDataType, T_layout, Dev>::get_description() const
        ? "disabled"
        : "enabled");
   desc.add("Bias", bias_str);
+  switch (m_tensor_parallel) {
+  case tensor_parallel_mode::COLUMN:
+    desc.add("Tensor parallel", "column");
+    break;
+  case tensor_parallel_mode::ROW:
+    desc.add("Tensor parallel", "row");
+    break;
+  default:
+    break;
+  }
   return desc;
 }
 
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::
+  fold_inference_affine(std::vector<double> const& scale,
+                        std::vector<double> const& shift)
+{
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  if constexpr (!std::is_floating_point_v<MasterDataType>) {
+    return false;
+  }
+  else {
+    const bool has_bias =
+      (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero());
+    if (scale.empty() || shift.size() != scale.size() ||
+        this->num_weights() < 1 || !this->has_weights(0) ||
+        !this->get_weights(0).has_values() ||
+        (has_bias && (this->num_weights() < 2 || !this->has_weights(1) ||
+                      !this->get_weights(1).has_values()))) {
+      return false;
+    }
+
+    // Outputs index the rows of the linearity, or its columns if it
+    // is transposed
+    using weights_details::apply_channelwise_affine;
+    apply_channelwise_affine<MasterDataType>(this->get_weights(0),
+                                             scale,
+                                             {},
+                                             m_transpose);
+    if (has_bias) {
+      const double bias_scale = m_bias_scaling_factor;
+      std::vector<double> bias_shift(shift.size());
+      for (size_t c = 0; c < shift.size(); ++c) {
+        bias_shift[c] = shift[c] / bias_scale;
+      }
+      apply_channelwise_affine<MasterDataType>(this->get_weights(1),
+                                               scale,
+                                               bias_shift,
+                                               false);
+    }
+    else {
+      // The bias has one entry per output, so expand the channels
+      const El::Int num_outputs =
+        (m_transpose ? this->get_weights(0).get_values().Width()
+                     : this->get_weights(0).get_values().Height());
+      const El::Int per_channel = num_outputs / El::Int(shift.size());
+      std::vector<MasterDataType> bias(num_outputs);
+      for (El::Int i = 0; i < num_outputs; ++i) {
+        bias[i] = static_cast<MasterDataType>(shift[i / per_channel]);
+      }
+      auto w =
+        std::make_shared<data_type_weights<MasterDataType>>(*this->get_comm());
+      w->set_name(this->get_name() + "_bias");
+      w->set_initializer(
+        std::make_unique<value_initializer<MasterDataType>>(std::move(bias)));
+      w->freeze();
+      m_bias_scaling_factor = El::TypeTraits<TensorDataType>::One();
+      this->set_num_weights(2);
+      this->set_weights(1, w);
+      this->m_model->add_weights(std::move(w));
+    }
+    return true;
+  }
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+bool fully_connected_layer<TensorDataType, T_layout, Dev>::
+  quantize_inference_weights(std::vector<double>& scale)
+{
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  if constexpr (!std::is_floating_point_v<MasterDataType>) {
+    return false;
+  }
+  else {
+    if (this->num_weights() < 1 || !this->has_weights(0) ||
+        !this->get_weights(0).has_values()) {
+      return false;
+    }
+    // Outputs index the rows of the linearity, or its columns if it
+    // is transposed
+    const auto& linearity = this->get_weights(0).get_values();
+    const El::Int num_outputs =
+      (m_transpose ? linearity.Width() : linearity.Height());
+    scale = weights_details::quantize_channelwise_int8<MasterDataType>(
+      this->get_weights(0),
+      num_outputs,
+      m_transpose);
+    return true;
+  }
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+compute_cost
+fully_connected_layer<TensorDataType, T_layout, Dev>::get_forward_prop_cost()
+  const
+{
+  // Each local output entry is a dot product with a full input
+  // sample, plus the bias
+  const auto& output = this->get_local_activations();
+  const double output_size = output.Height() * output.Width();
+  const double input_size = this->get_input_size();
+  auto cost = data_type_layer<TensorDataType>::get_forward_prop_cost();
+  cost.flops = output_size * (2. * input_size + 1.);
+  return cost;
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+compute_cost
+fully_connected_layer<TensorDataType, T_layout, Dev>::get_backward_prop_cost()
+  const
+{
+  const auto& output = this->get_local_activations();
+  const double output_size = output.Height() * output.Width();
+  const double input_size = this->get_input_size();
+  auto cost = data_type_layer<TensorDataType>::get_backward_prop_cost();
+  cost.flops = output_size * (4. * input_size + 1.);
+  return cost;
+}
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
   size_t max_mini_batch_size)
@@ -123,6 +260,8 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
 
   // Initialize default weights if none are provided
+  using MasterDataType = MasterWeightsType<TensorDataType>;
+  using MasterWeights = data_type_weights<MasterDataType>;
   if (this->num_weights() > 2) {
     LBANN_ERROR("attempted to setup ",
                 this->get_name(),
@@ -135,10 +274,10 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
     this->set_num_weights(1);
   }
   if (!this->has_weights(0)) {
-    auto w = std::make_shared<WeightsType>(*this->get_comm());
-    auto init = std::make_unique<he_initializer<TensorDataType>>(
+    auto w = std::make_shared<MasterWeights>(*this->get_comm());
+    auto init = std::make_unique<he_initializer<MasterDataType>>(
       probability_distribution::gaussian);
-    auto opt = this->m_model->template create_optimizer<TensorDataType>();
+    auto opt = this->m_model->template create_optimizer<MasterDataType>();
     w->set_name(this->get_name() + "_linearity_weights");
     w->set_initializer(std::move(init));
     w->set_optimizer(std::move(opt));
@@ -160,8 +299,28 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
   std::vector<size_t> output_dims(output_dims_.begin(), output_dims_.end());
 
   // Setup linearity weights
+  // Note: Tensor parallel layers split the output (column) or input
+  // (row) features of the weights like the features of the
+  // activations, and replicate them over the grid columns.
   auto linearity_dist = this->get_prev_activations().DistData();
-  if (linearity_dist.colDist != El::MC || linearity_dist.rowDist != El::MR) {
+  if (m_tensor_parallel != tensor_parallel_mode::NONE) {
+    if (T_layout != data_layout::MODEL_PARALLEL) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" is tensor parallel, ",
+                  "which requires the model-parallel data layout");
+    }
+    const bool split_rows =
+      ((m_tensor_parallel == tensor_parallel_mode::COLUMN) != m_transpose);
+    const int align = linearity_dist.colAlign;
+    linearity_dist.colDist = (split_rows ? El::MC : El::STAR);
+    linearity_dist.rowDist = (split_rows ? El::STAR : El::MC);
+    linearity_dist.colAlign = (split_rows ? align : 0);
+    linearity_dist.rowAlign = (split_rows ? 0 : align);
+  }
+  else if (linearity_dist.colDist != El::MC ||
+           linearity_dist.rowDist != El::MR) {
     linearity_dist.colDist = El::STAR;
     linearity_dist.rowDist = El::STAR;
   }
@@ -172,12 +331,17 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
     linearity_weights.set_dims(output_dims, input_dims);
   }
   linearity_weights.set_matrix_distribution(linearity_dist);
+  if (m_tensor_parallel == tensor_parallel_mode::COLUMN) {
+    auto gathered_dist = this->get_prev_activations().DistData();
+    gathered_dist.colDist = El::STAR;
+    m_gathered_input.reset(AbsDistMatrixType::Instantiate(gathered_dist));
+  }
 
   // Set up bias if needed.
   if (m_bias_scaling_factor != El::TypeTraits<TensorDataType>::Zero()) {
     if (!this->has_weights(1)) {
-      auto w = std::make_shared<WeightsType>(*this->get_comm());
-      auto opt = this->m_model->template create_optimizer<TensorDataType>();
+      auto w = std::make_shared<MasterWeights>(*this->get_comm());
+      auto opt = this->m_model->template create_optimizer<MasterDataType>();
       w->set_name(this->get_name() + "_bias_weights");
       w->set_optimizer(std::move(opt));
       this->set_weights(1, w);
@@ -246,6 +410,148 @@ void fully_connected_layer<TensorDataType, T_layout, Dev>::setup_data(
   }
 }
 
+namespace {
+
+/** @brief Distributed matrix replicated over the grid columns
+ *
+ *  Has the distribution of @c like with the features gathered.
+ */
+template <typename TensorDataType>
+std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+make_gathered(const El::AbstractDistMatrix<TensorDataType>& like)
+{
+  auto dist = like.DistData();
+  dist.colDist = El::STAR;
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> mat(
+    El::AbstractDistMatrix<TensorDataType>::Instantiate(dist));
+  mat->Resize(like.Height(), like.Width());
+  return mat;
+}
+
+/** @brief Apply a tensor parallel linearity
+ *
+ *  Column-parallel layers gather the input and multiply it by the
+ *  local output rows of the weights. Row-parallel layers multiply the
+ *  local input rows by the local columns of the weights and
+ *  reduce-scatter the partial products.
+ */
+template <typename TensorDataType>
+void fp_linearity_tensor_parallel(
+  tensor_parallel_mode mode,
+  bool transpose,
+  const El::AbstractDistMatrix<TensorDataType>& linearity,
+  const El::AbstractDistMatrix<TensorDataType>& input,
+  El::AbstractDistMatrix<TensorDataType>& output,
+  El::AbstractDistMatrix<TensorDataType>* gathered_input)
+{
+  const auto op = (transpose ? El::TRANSPOSE : El::NORMAL);
+  if (mode == tensor_parallel_mode::COLUMN) {
+    El::Copy(input, *gathered_input);
+    El::Gemm(op,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             linearity.LockedMatrix(),
+             gathered_input->LockedMatrix(),
+             El::TypeTraits<TensorDataType>::Zero(),
+             output.Matrix());
+  }
+  else {
+    auto partial = make_gathered(output);
+    El::Gemm(op,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             linearity.LockedMatrix(),
+             input.LockedMatrix(),
+             El::TypeTraits<TensorDataType>::Zero(),
+             partial->Matrix());
+    El::Contract(*partial, output);
+  }
+}
+
+/** @brief Gradients w.r.t. a tensor parallel linearity and its input
+ *
+ *  Column-parallel layers reuse the input gathered in forward prop
+ *  and reduce-scatter the partial input gradients. Row-parallel
+ *  layers gather the output gradient, and the rest is local. Linearity
+ *  gradients are only reduced over the grid columns, which hold the
+ *  same weights for different samples.
+ */
+template <typename TensorDataType>
+void bp_linearity_tensor_parallel(
+  tensor_parallel_mode mode,
+  bool transpose,
+  const El::AbstractDistMatrix<TensorDataType>& linearity,
+  data_type_optimizer<TensorDataType>* linearity_optimizer,
+  const El::AbstractDistMatrix<TensorDataType>& input,
+  const El::AbstractDistMatrix<TensorDataType>& gradient_wrt_output,
+  El::AbstractDistMatrix<TensorDataType>& gradient_wrt_input,
+  const El::AbstractDistMatrix<TensorDataType>* gathered_input)
+{
+  const bool column = (mode == tensor_parallel_mode::COLUMN);
+  std::unique_ptr<El::AbstractDistMatrix<TensorDataType>>
+    gathered_gradient_wrt_output;
+  if (!column) {
+    gathered_gradient_wrt_output = make_gathered(gradient_wrt_output);
+    El::Copy(gradient_wrt_output, *gathered_gradient_wrt_output);
+  }
+  const auto& local_input =
+    (column ? gathered_input->LockedMatrix() : input.LockedMatrix());
+  const auto& local_gradient_wrt_output =
+    (column ? gradient_wrt_output.LockedMatrix()
+            : gathered_gradient_wrt_output->LockedMatrix());
+
+  // Compute gradient w.r.t. linearity if needed
+  if (linearity_optimizer != nullptr) {
+    TensorDataType dst_scale = El::TypeTraits<TensorDataType>::Zero(),
+                   gradient_scale = El::TypeTraits<TensorDataType>::One();
+    auto& linearity_gradient =
+      linearity_optimizer->get_gradient_buffer(dst_scale, gradient_scale, true);
+    if (transpose) {
+      El::Gemm(El::NORMAL,
+               El::TRANSPOSE,
+               gradient_scale,
+               local_input,
+               local_gradient_wrt_output,
+               dst_scale,
+               linearity_gradient.Matrix());
+    }
+    else {
+      El::Gemm(El::NORMAL,
+               El::TRANSPOSE,
+               gradient_scale,
+               local_gradient_wrt_output,
+               local_input,
+               dst_scale,
+               linearity_gradient.Matrix());
+    }
+  }
+
+  // Compute gradient w.r.t. input
+  const auto op = (transpose ? El::NORMAL : El::TRANSPOSE);
+  if (column) {
+    auto partial = make_gathered(gradient_wrt_input);
+    El::Gemm(op,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             linearity.LockedMatrix(),
+             local_gradient_wrt_output,
+             El::TypeTraits<TensorDataType>::Zero(),
+             partial->Matrix());
+    El::Contract(*partial, gradient_wrt_input);
+  }
+  else {
+    El::Gemm(op,
+             El::NORMAL,
+             El::TypeTraits<TensorDataType>::One(),
+             linearity.LockedMatrix(),
+             local_gradient_wrt_output,
+             El::TypeTraits<TensorDataType>::Zero(),
+             gradient_wrt_input.Matrix());
+  }
+}
+
+} // namespace
+
 /** CPU implementation of forward prop computation. */
 template <typename TensorDataType>
 void fp_compute_impl(fully_connected_layer<TensorDataType,
@@ -263,7 +569,15 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
   if (!linearity.Participating()) {
     return;
   }
-  if (linearity.DistSize() == 1) {
+  if (l.m_tensor_parallel != tensor_parallel_mode::NONE) {
+    fp_linearity_tensor_parallel(l.m_tensor_parallel,
+                                 l.m_transpose,
+                                 linearity,
+                                 input,
+                                 output,
+                                 l.m_gathered_input.get());
+  }
+  else if (linearity.DistSize() == 1) {
     El::Gemm(l.m_transpose ? El::TRANSPOSE : El::NORMAL,
              El::NORMAL,
              El::TypeTraits<TensorDataType>::One(),
@@ -331,6 +645,19 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
+  // Compute gradients w.r.t. tensor parallel linearity and input
+  if (l.m_tensor_parallel != tensor_parallel_mode::NONE) {
+    bp_linearity_tensor_parallel(l.m_tensor_parallel,
+                                 l.m_transpose,
+                                 linearity,
+                                 l.get_weights(0).get_optimizer(),
+                                 input,
+                                 gradient_wrt_output,
+                                 gradient_wrt_input,
+                                 l.m_gathered_input.get());
+    return;
+  }
+
   // Compute gradient w.r.t. linearity if needed
   // Note: Perform GEMMs independently if possible
   auto* linearity_optimizer = l.get_weights(0).get_optimizer();
@@ -642,7 +969,15 @@ void fp_compute_impl(fully_connected_layer<TensorDataType,
   if (!linearity.Participating()) {
     return;
   }
-  if (linearity.DistSize() == 1) {
+  if (l.m_tensor_parallel != tensor_parallel_mode::NONE) {
+    fp_linearity_tensor_parallel(l.m_tensor_parallel,
+                                 l.m_transpose,
+                                 linearity,
+                                 input,
+                                 output,
+                                 l.m_gathered_input.get());
+  }
+  else if (linearity.DistSize() == 1) {
     El::Gemm(l.m_transpose ? El::TRANSPOSE : El::NORMAL,
              El::NORMAL,
              El::TypeTraits<TensorDataType>::One(),
@@ -730,6 +1065,19 @@ void bp_compute_impl(fully_connected_layer<TensorDataType,
     }
   }
 
+  // Compute gradients w.r.t. tensor parallel linearity and input
+  if (l.m_tensor_parallel != tensor_parallel_mode::NONE) {
+    bp_linearity_tensor_parallel(l.m_tensor_parallel,
+                                 l.m_transpose,
+                                 linearity,
+                                 l.get_weights(0).get_optimizer(),
+                                 input,
+                                 gradient_wrt_output,
+                                 gradient_wrt_input,
+                                 l.m_gathered_input.get());
+    return;
+  }
+
   // Compute gradient w.r.t. linearity if needed
   // Note: Perform GEMMs independently if possible
   auto* linearity_optimizer = l.get_weights(0).get_optimizer();
@@ -818,6 +1166,16 @@ void fully_connected_layer<T, L, D>::write_specific_proto(
   auto const has_bias = (this->num_weights() > 1UL);
   msg->set_has_bias(has_bias);
   msg->set_transpose(m_transpose);
+  switch (m_tensor_parallel) {
+  case tensor_parallel_mode::COLUMN:
+    msg->set_tensor_parallel("column");
+    break;
+  case tensor_parallel_mode::ROW:
+    msg->set_tensor_parallel("row");
+    break;
+  default:
+    break;
+  }
 }
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -938,10 +1296,25 @@ build_fully_connected_layer_from_pbuf(lbann_comm* comm,
 {
   using LayerType = fully_connected_layer<TensorDataType, layout, device>;
   const auto& params = layer_msg.fully_connected();
+  auto tensor_parallel = tensor_parallel_mode::NONE;
+  if (params.tensor_parallel() == "column") {
+    tensor_parallel = tensor_parallel_mode::COLUMN;
+  }
+  else if (params.tensor_parallel() == "row") {
+    tensor_parallel = tensor_parallel_mode::ROW;
+  }
+  else if (!params.tensor_parallel().empty()) {
+    LBANN_ERROR("invalid tensor parallel partitioning (\"",
+                params.tensor_parallel(),
+                "\") for fully-connected layer \"",
+                layer_msg.name(),
+                "\"");
+  }
   return std::make_unique<LayerType>(params.num_neurons(),
                                      params.transpose(),
                                      nullptr,
-                                     params.has_bias());
+                                     params.has_bias(),
+                                     tensor_parallel);
 }
 
 #define PROTO_DEVICE(T, Device)                                                \
@@ -50,7 +50,8 @@ gru_layer<TensorDataType, Layout, Device>::gru_layer(size_t hidden_size,
     m_hidden_size{hidden_size},
     m_num_layers{num_layers}
 {
-  this->m_expected_num_parent_layers = 2;
+  // Input sequence, initial hidden state, optional sequence lengths
+  this->m_expected_num_parent_layers = -1;
 }
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -176,6 +177,15 @@ void gru_layer<TensorDataType, Layout, Device>::setup_dims(
   }
 
   // Check input dims
+  const int num_inputs = this->get_num_parents();
+  if (num_inputs != 2 && num_inputs != 3) {
+    LBANN_ERROR(this->get_type(),
+                " layer \"",
+                this->get_name(),
+                "\" ",
+                "expects 2 or 3 parent layers, but found ",
+                num_inputs);
+  }
   const auto& input0_dims = this->get_input_dims(0);
   const auto& input1_dims = this->get_input_dims(1);
   auto dims_to_str = [](const std::vector<int>& dims) -> std::string {
@@ -216,6 +226,26 @@ void gru_layer<TensorDataType, Layout, Device>::setup_dims(
                 dims_to_str(input1_dims));
   }
 
+  if (num_inputs == 3) {
+    if (Device != El::Device::GPU) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" ",
+                  "only supports sequence lengths with cuDNN");
+    }
+    if (this->get_input_size(2) != 1) {
+      LBANN_ERROR(this->get_type(),
+                  " layer \"",
+                  this->get_name(),
+                  "\" ",
+                  "expected one sequence length per sample, ",
+                  "but recieved a tensor with ",
+                  "dimensions of ",
+                  dims_to_str(this->get_input_dims(2)));
+    }
+  }
+
   // Set output dims
   const std::vector<int> output_dims = {input0_dims[0],
                                         static_cast<int>(m_hidden_size)};
@@ -306,6 +336,31 @@ void gru_layer<TensorDataType, Layout, Device>::setup_data(
 // Forward prop and back prop
 // =========================================================
 
+namespace {
+
+/** @brief Check whether weights have changed since they were packed.
+ *
+ *  @param versions Weights values versions at the last packing (see
+ *                  weights::get_values_version). Updated to the
+ *                  current versions.
+ *  @returns Whether any of the layer's weights have changed.
+ */
+bool update_packed_weights_versions(const Layer& l,
+                                    std::vector<size_t>& versions)
+{
+  const size_t num_weights = l.num_weights();
+  bool changed = (versions.size() != num_weights);
+  versions.resize(num_weights);
+  for (size_t i = 0; i < num_weights; ++i) {
+    const auto version = l.get_weights(i).get_values_version();
+    changed = changed || version != versions[i];
+    versions[i] = version;
+  }
+  return changed;
+}
+
+} // namespace
+
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void gru_layer<TensorDataType, Layout, Device>::fp_compute()
 {
@@ -610,20 +665,25 @@ void fp_compute_impl(
     output_sequence.Buffer(),
     stream);
 
-  // Pack weights into workspace buffer
-  std::vector<LocalMat> weights_list;
-  for (int i = 0; i < 4 * num_layers; ++i) {
-    const auto& w =
-      dynamic_cast<const LocalMat&>(l.weights_values(i).LockedMatrix());
-    weights_list.emplace_back(El::LockedView(w));
+  // Pack weights into workspace buffer, if they have changed
+  if (update_packed_weights_versions(l,
+                                     onednn_objects.packed_weights_versions)) {
+    std::vector<LocalMat> weights_list;
+    for (int i = 0; i < 4 * num_layers; ++i) {
+      const auto& w =
+        dynamic_cast<const LocalMat&>(l.weights_values(i).LockedMatrix());
+      weights_list.emplace_back(El::LockedView(w));
+    }
+    pack_onednn_weights<TensorDataType>(
+      input_size,
+      hidden_size,
+      num_layers,
+      onednn_objects.forward_ih_matrix_weights,
+      onednn_objects.forward_hh_matrix_weights,
+      onednn_objects.bias_weights,
+      weights_list);
+    onednn_objects.backward_weights_stale = true;
   }
-  pack_onednn_weights<TensorDataType>(input_size,
-                                      hidden_size,
-                                      num_layers,
-                                      onednn_objects.forward_ih_matrix_weights,
-                                      onednn_objects.forward_hh_matrix_weights,
-                                      onednn_objects.bias_weights,
-                                      weights_list);
 
   // Construct operation descriptor and primitive descriptor
   ::dnnl::lbr_gru_forward::desc gru_forward_desc(
@@ -876,7 +936,8 @@ void bp_compute_impl(
     init_hidden_grad.Buffer(),
     stream);
 
-  // Reorder matrix weights from LDIGO to LDGOI format
+  // Reorder matrix weights from LDIGO to LDGOI format, if they
+  // were repacked in forward prop
   auto&& forward_ih_matrix_weights =
     onednn_objects.forward_ih_matrix_weights.get();
   auto&& backward_ih_matrix_weights =
@@ -885,18 +946,21 @@ void bp_compute_impl(
     onednn_objects.forward_hh_matrix_weights.get();
   auto&& backward_hh_matrix_weights =
     onednn_objects.backward_hh_matrix_weights.get();
-  ::dnnl::reorder reorder_ih_matrix_weights_primitive(
-    forward_ih_matrix_weights,
-    backward_ih_matrix_weights);
-  ::dnnl::reorder reorder_hh_matrix_weights_primitive(
-    forward_hh_matrix_weights,
-    backward_hh_matrix_weights);
-  reorder_ih_matrix_weights_primitive.execute(stream,
-                                              forward_ih_matrix_weights,
-                                              backward_ih_matrix_weights);
-  reorder_hh_matrix_weights_primitive.execute(stream,
-                                              forward_hh_matrix_weights,
-                                              backward_hh_matrix_weights);
+  if (onednn_objects.backward_weights_stale) {
+    ::dnnl::reorder reorder_ih_matrix_weights_primitive(
+      forward_ih_matrix_weights,
+      backward_ih_matrix_weights);
+    ::dnnl::reorder reorder_hh_matrix_weights_primitive(
+      forward_hh_matrix_weights,
+      backward_hh_matrix_weights);
+    reorder_ih_matrix_weights_primitive.execute(stream,
+                                                forward_ih_matrix_weights,
+                                                backward_ih_matrix_weights);
+    reorder_hh_matrix_weights_primitive.execute(stream,
+                                                forward_hh_matrix_weights,
+                                                backward_hh_matrix_weights);
+    onednn_objects.backward_weights_stale = false;
+  }
 
   // Clear weights gradients
   std::memset(
@@ -1173,8 +1237,44 @@ void fp_compute_impl(
   auto& cudnn_objects = *l.m_cudnn_objects;
   const auto data_type = dnn_lib::get_data_type<TensorDataType>();
 
+  // Get sequence lengths
+  // Note: Padding samples in the workspace only need one timestep
+  // if the sequence lengths are given.
+  const bool has_sequence_lengths = (l.get_num_parents() == 3);
+  std::vector<int32_t> sequence_lengths(workspace_mini_batch_size,
+                                        sequence_length);
+  if (has_sequence_lengths) {
+    const auto& lengths = l.get_local_prev_activations(2);
+    std::vector<TensorDataType> cpu_lengths(mini_batch_size);
+    CHECK_CUDA(cudaMemcpy2DAsync(cpu_lengths.data(),
+                                 sizeof(TensorDataType),
+                                 lengths.LockedBuffer(),
+                                 lengths.LDim() * sizeof(TensorDataType),
+                                 sizeof(TensorDataType),
+                                 mini_batch_size,
+                                 cudaMemcpyDeviceToHost,
+                                 stream));
+    CHECK_CUDA(cudaStreamSynchronize(stream));
+    for (size_t j = 0; j < workspace_mini_batch_size; ++j) {
+      const long length =
+        (j < mini_batch_size ? std::lround(static_cast<float>(cpu_lengths[j]))
+                             : 1);
+      if (length < 1 || length > static_cast<long>(sequence_length)) {
+        LBANN_ERROR(l.get_type(),
+                    " layer \"",
+                    l.get_name(),
+                    "\" ",
+                    "got a sequence length of ",
+                    length,
+                    ", which is not in [1,",
+                    sequence_length,
+                    "]");
+      }
+      sequence_lengths[j] = length;
+    }
+  }
+
   // Configure input and output tensor descriptors
-  std::vector<int> sequence_lengths(workspace_mini_batch_size, sequence_length);
   cudnn_objects.input_desc.set(data_type,
                                CUDNN_RNN_DATA_LAYOUT_BATCH_MAJOR_UNPACKED,
                                sequence_length,
@@ -1213,13 +1313,18 @@ void fp_compute_impl(
   if (cudnn_objects.gpu_sequence_lengths.size() < workspace_mini_batch_size) {
     /// @todo Handle synchronization
     cudnn_objects.gpu_sequence_lengths.allocate(workspace_mini_batch_size);
-    std::vector<int32_t> cpu_sequence_lengths(workspace_mini_batch_size,
-                                              sequence_length);
-    CHECK_CUDA(cudaMemcpyAsync(cudnn_objects.gpu_sequence_lengths.data(),
-                               cpu_sequence_lengths.data(),
-                               cpu_sequence_lengths.size() * sizeof(int32_t),
-                               cudaMemcpyHostToDevice,
-                               stream));
+    cudnn_objects.cpu_sequence_lengths.clear();
+  }
+  sequence_lengths.resize(cudnn_objects.gpu_sequence_lengths.size(),
+                          sequence_length);
+  if (cudnn_objects.cpu_sequence_lengths != sequence_lengths) {
+    cudnn_objects.cpu_sequence_lengths = std::move(sequence_lengths);
+    CHECK_CUDA(cudaMemcpyAsync(
+      cudnn_objects.gpu_sequence_lengths.data(),
+      cudnn_objects.cpu_sequence_lengths.data(),
+      cudnn_objects.cpu_sequence_lengths.size() * sizeof(int32_t),
+      cudaMemcpyHostToDevice,
+      stream));
     CHECK_CUDA(cudaStreamSynchronize(stream));
   }
 
@@ -1237,6 +1342,10 @@ void fp_compute_impl(
                                                  workspace_mini_batch_size);
   El::Zero(cudnn_objects.input_sequence_workspace);
   El::Zero(cudnn_objects.init_hidden_workspace);
+  if (has_sequence_lengths) {
+    // cuDNN does not write outputs past the sequence lengths
+    El::Zero(cudnn_objects.output_sequence_workspace);
+  }
   auto input_sequence_workspace_ =
     cudnn_objects.input_sequence_workspace(El::ALL, El::IR(0, mini_batch_size));
   El::Copy(input_sequence, input_sequence_workspace_);
@@ -1248,33 +1357,45 @@ void fp_compute_impl(
     cudnn_objects.init_hidden_workspace.Buffer(),
     {hidden_size, workspace_mini_batch_size * hidden_size, one});
 
-  // Pack weights into workspace buffer
+  // Pack weights into workspace buffer, if they have changed
   /// @todo Handle synchronization
   size_t weights_size;
   CHECK_CUDNN(
     cudnnGetRNNWeightSpaceSize(handle, cudnn_objects.rnn_desc, &weights_size));
-  cudnn_objects.weights_workspace.allocate(weights_size);
-  std::vector<LocalMat> weights_list;
-  for (size_t i = 0; i < 4 * num_layers; ++i) {
-    const auto& w =
-      dynamic_cast<const LocalMat&>(l.weights_values(i).LockedMatrix());
-    weights_list.emplace_back(El::LockedView(w));
+  if (cudnn_objects.weights_workspace.size() != weights_size) {
+    cudnn_objects.weights_workspace.allocate(weights_size);
+    cudnn_objects.packed_weights_versions.clear();
+  }
+  if (update_packed_weights_versions(l,
+                                     cudnn_objects.packed_weights_versions)) {
+    std::vector<LocalMat> weights_list;
+    for (size_t i = 0; i < 4 * num_layers; ++i) {
+      const auto& w =
+        dynamic_cast<const LocalMat&>(l.weights_values(i).LockedMatrix());
+      weights_list.emplace_back(El::LockedView(w));
+    }
+    pack_cudnn_rnn_weights<TensorDataType>(
+      handle,
+      cudnn_objects.rnn_desc,
+      sync_info,
+      input_size,
+      hidden_size,
+      num_layers,
+      cudnn_objects.weights_workspace.data(),
+      cudnn_objects.weights_workspace.size(),
+      weights_list);
   }
-  pack_cudnn_rnn_weights<TensorDataType>(handle,
-                                         cudnn_objects.rnn_desc,
-                                         sync_info,
-                                         input_size,
-                                         hidden_size,
-                                         num_layers,
-                                         cudnn_objects.weights_workspace.data(),
-                                         cudnn_objects.weights_workspace.size(),
-                                         weights_list);
 
 #if !defined(LBANN_DEBUG) // Disable CUDA graphs
 
   // Compute hash with cuDNN function arguments
+  // Note: The sequence lengths are baked into the RNN data
+  // descriptors.
   size_t hash{0};
   hash = hash_combine(hash, cudnn_objects.gpu_sequence_lengths.data());
+  for (const auto& length : cudnn_objects.cpu_sequence_lengths) {
+    hash = hash_combine(hash, length);
+  }
   hash =
     hash_combine(hash, cudnn_objects.input_sequence_workspace.LockedBuffer());
   hash = hash_combine(hash, cudnn_objects.init_hidden_workspace.LockedBuffer());
@@ -1526,6 +1647,11 @@ void bp_compute_impl(
                                                     hidden_size,
                                                   num_layers);
   El::Zero(cudnn_objects.output_sequence_grad_workspace);
+  const bool has_sequence_lengths = (l.get_num_parents() == 3);
+  if (has_sequence_lengths) {
+    // cuDNN does not write gradients past the sequence lengths
+    El::Zero(cudnn_objects.input_sequence_grad_workspace);
+  }
   auto output_sequence_grad_workspace_ =
     cudnn_objects.output_sequence_grad_workspace(El::ALL,
                                                  El::IR(0, mini_batch_size));
@@ -1533,8 +1659,11 @@ void bp_compute_impl(
 
   // Initialize workspace for weight gradients
   // Note: Weights have already been packed in forward prop
-  cudnn_objects.weights_grad_workspace.allocate(
-    cudnn_objects.weights_workspace.size());
+  if (cudnn_objects.weights_grad_workspace.size() !=
+      cudnn_objects.weights_workspace.size()) {
+    cudnn_objects.weights_grad_workspace.allocate(
+      cudnn_objects.weights_workspace.size());
+  }
   CHECK_CUDA(cudaMemsetAsync(cudnn_objects.weights_grad_workspace.data(),
                              0,
                              cudnn_objects.weights_grad_workspace.size(),
@@ -1545,6 +1674,9 @@ void bp_compute_impl(
   // Compute hash with cuDNN function arguments
   size_t hash{0};
   hash = hash_combine(hash, cudnn_objects.gpu_sequence_lengths.data());
+  for (const auto& length : cudnn_objects.cpu_sequence_lengths) {
+    hash = hash_combine(hash, length);
+  }
   hash =
     hash_combine(hash, cudnn_objects.input_sequence_workspace.LockedBuffer());
   hash =
@@ -1657,6 +1789,9 @@ void bp_compute_impl(
     {hidden_size, workspace_mini_batch_size * hidden_size, one},
     init_hidden_grad.Buffer(),
     {static_cast<size_t>(init_hidden_grad.LDim()), hidden_size, one});
+  if (has_sequence_lengths) {
+    El::Zero(l.get_local_error_signals(2));
+  }
 }
 
 #endif // LBANN_GRU_LAYER_CUDNN_SUPPORTED
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+#ifdef LBANN_USE_CATCH2_V3
+#include <catch2/benchmark/catch_benchmark.hpp>
+#endif // LBANN_USE_CATCH2_V3
+
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+
+#include <h2/meta/TypeList.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+// Benchmarks are hidden; run them with
+//   mpi-catch-tests "[benchmark]"
+//
+// These time the local GEMMs of a data-parallel fully-connected layer:
+// the forward prop (W x), the weight gradient (dy x^T) and the input
+// gradient (W^T dy).
+
+namespace {
+
+template <typename T, El::Device D>
+struct GemmBenchmark
+{
+  using value_type = T;
+  static constexpr El::Device device = D;
+};
+
+template <typename T>
+using GemmBenchmarkAllDevices = h2::meta::TL<
+#ifdef LBANN_HAS_GPU
+  GemmBenchmark<T, El::Device::GPU>,
+#endif // LBANN_HAS_GPU
+  GemmBenchmark<T, El::Device::CPU>>;
+
+using AllGemmBenchmarks =
+  h2::meta::tlist::Append<GemmBenchmarkAllDevices<float>,
+                          GemmBenchmarkAllDevices<double>>;
+
+template <El::Device D>
+void synchronize()
+{
+#ifdef LBANN_HAS_GPU
+  if constexpr (D == El::Device::GPU) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+}
+
+/** Input features, output features and mini-batch size. */
+std::vector<std::array<El::Int, 3>> const shapes = {{1024, 1024, 128},
+                                                    {4096, 1024, 256}};
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("Fully-connected layer benchmarks",
+                        "[.benchmark][mpi][layer][fully_connected]",
+                        AllGemmBenchmarks)
+{
+  using T = typename TestType::value_type;
+  constexpr auto D = TestType::device;
+  using MatType = El::Matrix<T, D>;
+  const auto one = El::TypeTraits<T>::One();
+  const auto zero = El::TypeTraits<T>::Zero();
+
+  for (auto const& [input_size, output_size, mini_batch_size] : shapes) {
+    MatType w(output_size, input_size), dw(output_size, input_size),
+      x(input_size, mini_batch_size), dx(input_size, mini_batch_size),
+      y(output_size, mini_batch_size), dy(output_size, mini_batch_size);
+    El::MakeUniform(w);
+    El::MakeUniform(x);
+    El::MakeUniform(dy);
+    synchronize<D>();
+    const std::string shape = " " + std::to_string(input_size) + "x" +
+                              std::to_string(output_size) + "x" +
+                              std::to_string(mini_batch_size);
+
+    BENCHMARK("fully_connected fp" + shape)
+    {
+      El::Gemm(El::NORMAL, El::NORMAL, one, w, x, zero, y);
+      synchronize<D>();
+    };
+    BENCHMARK("fully_connected bp weights" + shape)
+    {
+      El::Gemm(El::NORMAL, El::TRANSPOSE, one, dy, x, zero, dw);
+      synchronize<D>();
+    };
+    BENCHMARK("fully_connected bp input" + shape)
+    {
+      El::Gemm(El::TRANSPOSE, El::NORMAL, one, w, dy, zero, dx);
+      synchronize<D>();
+    };
+  }
+}
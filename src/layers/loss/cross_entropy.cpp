@@ -44,22 +44,31 @@ void local_fp_cpu(const El::AbstractMatrix<TensorDataType>& local_prediction,
   const El::Int local_height = local_prediction.Height();
   const El::Int local_width = local_prediction.Width();
 
+  // With integer labels, only read the prediction of each label
+  if (use_labels) {
+    const El::Int num_channels = local_height / spatial_sample_size;
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      TensorDataType sum = zero;
+      for (El::Int offset = 0; offset < spatial_sample_size; ++offset) {
+        const El::Int label = local_ground_truth(offset, col);
+        if (0 <= label && label < num_channels) {
+          const auto& x =
+            local_prediction(label * spatial_sample_size + offset, col);
+          sum += -std::log(x);
+        }
+      }
+      local_contribution(0, col) = sum;
+    }
+    return;
+  }
+
   // Compute local contribution to cross entropy
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
     TensorDataType sum = zero;
     for (El::Int row = 0; row < local_height; ++row) {
-
-      TensorDataType xhat;
-      if (use_labels) {
-        const auto channel = row / spatial_sample_size;
-        const auto offset = row % spatial_sample_size;
-        const int truth_label = local_ground_truth(offset, col);
-        xhat = TensorDataType(truth_label == channel ? 1. : 0.);
-      }
-      else {
-        xhat = local_ground_truth(row, col);
-      }
+      const auto& xhat = local_ground_truth(row, col);
       if (xhat > zero) {
         const auto& x = local_prediction(row, col);
 #ifdef LBANN_DEBUG
@@ -90,27 +99,36 @@ void local_bp_cpu(
   const El::Int local_height = local_prediction.Height();
   const El::Int local_width = local_prediction.Width();
 
+  // With integer labels, only the entries of the labels are nonzero.
+  // Ignore dxhat.
+  if (use_labels) {
+    El::Zero(local_gradient_wrt_prediction);
+    const El::Int num_channels = local_height / spatial_sample_size;
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      const auto& dy = local_gradient_wrt_output(0, col);
+      for (El::Int offset = 0; offset < spatial_sample_size; ++offset) {
+        const El::Int label = local_ground_truth(offset, col);
+        if (0 <= label && label < num_channels) {
+          const El::Int row = label * spatial_sample_size + offset;
+          const auto& x = local_prediction(row, col);
+          local_gradient_wrt_prediction(row, col) = -dy / x;
+        }
+      }
+    }
+    return;
+  }
+
   // Compute gradients
   LBANN_OMP_PARALLEL_FOR_COLLAPSE2
   for (El::Int col = 0; col < local_width; ++col) {
     for (El::Int row = 0; row < local_height; ++row) {
-
       const auto& dy = local_gradient_wrt_output(0, col);
       auto& dx = local_gradient_wrt_prediction(row, col);
       const auto& x = local_prediction(row, col);
-      TensorDataType xhat;
-      if (use_labels) {
-        // Ignore dxhat when use_labels is enabled
-        const auto channel = row / spatial_sample_size;
-        const auto offset = row % spatial_sample_size;
-        const int truth_label = local_ground_truth(offset, col);
-        xhat = TensorDataType(truth_label == channel ? 1. : 0.);
-      }
-      else {
-        xhat = local_ground_truth(row, col);
-        auto& dxhat = local_gradient_wrt_ground_truth(row, col);
-        dxhat = -dy * std::log(x);
-      }
+      const auto& xhat = local_ground_truth(row, col);
+      auto& dxhat = local_gradient_wrt_ground_truth(row, col);
+      dxhat = -dy * std::log(x);
       dx = (xhat > zero) ? -dy * xhat / x : zero;
     }
   }
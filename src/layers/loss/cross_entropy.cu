@@ -91,6 +91,37 @@ __global__ void fp_kernel(int height,
   }
 }
 
+/** Cross entropy with integer labels as ground truth.
+ *  Only the predicted probability of each label is read, so the cost
+ *  does not grow with the number of channels. Out-of-range labels are
+ *  ignored.
+ */
+template <typename TensorDataType>
+__global__ void fp_labels_kernel(int num_channels,
+                                 int width,
+                                 int spatial_sample_size,
+                                 const TensorDataType* __restrict__ prediction,
+                                 int prediction_ldim,
+                                 const TensorDataType* __restrict__ labels,
+                                 int labels_ldim,
+                                 TensorDataType* __restrict__ contribution)
+{
+  const int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const int nthreadsx = blockDim.x * gridDim.x;
+  for (int col = blockIdx.y; col < width; col += gridDim.y) {
+    for (int offset = gidx; offset < spatial_sample_size;
+         offset += nthreadsx) {
+      const int label = labels[offset + col * labels_ldim];
+      if (0 <= label && label < num_channels) {
+        const auto& x =
+          prediction[label * spatial_sample_size + offset +
+                     col * prediction_ldim];
+        gpu_lib::atomic_add(&contribution[col], -gpu_lib::log(x));
+      }
+    }
+  }
+}
+
 template <typename TensorDataType>
 void local_fp_gpu(const El::AbstractMatrix<TensorDataType>& local_prediction,
                   const El::AbstractMatrix<TensorDataType>& local_ground_truth,
@@ -101,7 +132,30 @@ void local_fp_gpu(const El::AbstractMatrix<TensorDataType>& local_prediction,
   El::Zero(local_contribution);
   const auto& height = local_prediction.Height();
   const auto& width = local_prediction.Width();
-  if (height > 0 && width > 0) {
+  if (use_labels && height > 0 && width > 0) {
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_contribution),
+                                       gpu::get_sync_info(local_prediction),
+                                       gpu::get_sync_info(local_ground_truth));
+    const int block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (spatial_sample_size + block_size - 1) / block_size;
+    grid_dims.y = std::min(width, El::Int(65535));
+    hydrogen::gpu::LaunchKernel(fp_labels_kernel<TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height / spatial_sample_size,
+                                width,
+                                spatial_sample_size,
+                                local_prediction.LockedBuffer(),
+                                local_prediction.LDim(),
+                                local_ground_truth.LockedBuffer(),
+                                local_ground_truth.LDim(),
+                                local_contribution.Buffer());
+  }
+  else if (height > 0 && width > 0) {
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_contribution),
                                        gpu::get_sync_info(local_prediction),
                                        gpu::get_sync_info(local_ground_truth));
@@ -176,6 +230,40 @@ bp_kernel(int height,
   }
 }
 
+/** Gradient of cross entropy with integer labels as ground truth.
+ *  The gradient w.r.t. prediction is assumed to be zero on input,
+ *  and only the entries of the labels are set.
+ */
+template <typename TensorDataType>
+__global__ void
+bp_labels_kernel(int num_channels,
+                 int width,
+                 int spatial_sample_size,
+                 const TensorDataType* __restrict__ prediction,
+                 int prediction_ldim,
+                 const TensorDataType* __restrict__ labels,
+                 int labels_ldim,
+                 const TensorDataType* __restrict__ gradient_wrt_output,
+                 TensorDataType* __restrict__ gradient_wrt_prediction,
+                 int gradient_wrt_prediction_ldim)
+{
+  const int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const int nthreadsx = blockDim.x * gridDim.x;
+  for (int col = blockIdx.y; col < width; col += gridDim.y) {
+    const auto& dy = gradient_wrt_output[col];
+    for (int offset = gidx; offset < spatial_sample_size;
+         offset += nthreadsx) {
+      const int label = labels[offset + col * labels_ldim];
+      if (0 <= label && label < num_channels) {
+        const int row = label * spatial_sample_size + offset;
+        const auto& x = prediction[row + col * prediction_ldim];
+        gradient_wrt_prediction[row + col * gradient_wrt_prediction_ldim] =
+          -dy / x;
+      }
+    }
+  }
+}
+
 template <typename TensorDataType>
 void local_bp_gpu(
   const El::AbstractMatrix<TensorDataType>& local_prediction,
@@ -188,7 +276,37 @@ void local_bp_gpu(
 {
   const auto& height = local_prediction.Height();
   const auto& width = local_prediction.Width();
-  if (height > 0 && width > 0) {
+  if (use_labels) {
+    El::Zero(local_gradient_wrt_prediction);
+  }
+  if (use_labels && height > 0 && width > 0) {
+    auto multisync =
+      El::MakeMultiSync(gpu::get_sync_info(local_gradient_wrt_prediction),
+                        gpu::get_sync_info(local_gradient_wrt_output),
+                        gpu::get_sync_info(local_prediction),
+                        gpu::get_sync_info(local_ground_truth));
+    const int block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = (spatial_sample_size + block_size - 1) / block_size;
+    grid_dims.y = std::min(width, El::Int(65535));
+    hydrogen::gpu::LaunchKernel(bp_labels_kernel<TensorDataType>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                height / spatial_sample_size,
+                                width,
+                                spatial_sample_size,
+                                local_prediction.LockedBuffer(),
+                                local_prediction.LDim(),
+                                local_ground_truth.LockedBuffer(),
+                                local_ground_truth.LDim(),
+                                local_gradient_wrt_output.LockedBuffer(),
+                                local_gradient_wrt_prediction.Buffer(),
+                                local_gradient_wrt_prediction.LDim());
+  }
+  else if (height > 0 && width > 0) {
     auto multisync =
       El::MakeMultiSync(gpu::get_sync_info(local_gradient_wrt_prediction),
                         gpu::get_sync_info(local_gradient_wrt_ground_truth),
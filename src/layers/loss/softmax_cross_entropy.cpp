@@ -0,0 +1,215 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_SOFTMAX_CROSS_ENTROPY_LAYER_INSTANTIATE
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace lbann {
+
+namespace {
+
+/** Number of logits that are reduced together.
+ *
+ *  A block is small enough to stay in cache between computing its
+ *  maximum and summing its exponentials, so the logits are only read
+ *  from memory once. Within a block, the loops have no dependences
+ *  the compiler cannot vectorize.
+ */
+constexpr El::Int block_size = 512;
+
+/** Class index of a label, or -1 if it is not a valid class. */
+template <typename AccT>
+El::Int get_class_index(AccT label, El::Int num_classes)
+{
+  return ((label >= AccT(0) && label < static_cast<AccT>(num_classes))
+            ? static_cast<El::Int>(label)
+            : -1);
+}
+
+} // namespace
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void softmax_cross_entropy_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  using AccT = AccumulateDataType;
+
+  // Local matrices
+  const auto& local_logits =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_truth =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  auto& local_output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Dimensions
+  const El::Int num_classes = local_logits.Height();
+  const El::Int local_mini_batch_size = local_logits.Width();
+  const bool use_labels = m_use_labels;
+  m_statistics.Resize(2, local_mini_batch_size);
+
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_mini_batch_size; ++col) {
+    const TensorDataType* __restrict__ x = local_logits.LockedBuffer(0, col);
+    const TensorDataType* __restrict__ y = local_truth.LockedBuffer(0, col);
+
+    // Online softmax over blocks of logits. The dot product with the
+    // ground truth is accumulated in the same pass.
+    AccT max_x = -std::numeric_limits<AccT>::infinity();
+    AccT sum_exp = 0;
+    AccT dot = 0;
+    AccT sum_y = 0;
+    for (El::Int begin = 0; begin < num_classes; begin += block_size) {
+      const El::Int end = std::min(begin + block_size, num_classes);
+      AccT block_max = -std::numeric_limits<AccT>::infinity();
+      for (El::Int i = begin; i < end; ++i) {
+        block_max = std::max(block_max, static_cast<AccT>(x[i]));
+      }
+      if (block_max > max_x) {
+        sum_exp *= std::exp(max_x - block_max);
+        max_x = block_max;
+      }
+      AccT block_sum = 0;
+      for (El::Int i = begin; i < end; ++i) {
+        block_sum += std::exp(static_cast<AccT>(x[i]) - max_x);
+      }
+      sum_exp += block_sum;
+      if (!use_labels) {
+        for (El::Int i = begin; i < end; ++i) {
+          const auto yi = static_cast<AccT>(y[i]);
+          dot += yi * static_cast<AccT>(x[i]);
+          sum_y += yi;
+        }
+      }
+    }
+    const AccT logsumexp = max_x + std::log(sum_exp);
+
+    // Loss is -sum(y * (x - logsumexp))
+    AccT loss = 0;
+    if (use_labels) {
+      const auto index =
+        get_class_index(static_cast<AccT>(y[0]), num_classes);
+      if (index >= 0) {
+        loss = logsumexp - static_cast<AccT>(x[index]);
+        sum_y = 1;
+      }
+    }
+    else {
+      loss = sum_y * logsumexp - dot;
+    }
+    local_output(0, col) = static_cast<TensorDataType>(loss);
+    m_statistics(0, col) = logsumexp;
+    m_statistics(1, col) = sum_y;
+  }
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void softmax_cross_entropy_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
+  using AccT = AccumulateDataType;
+
+  // Local matrices
+  const auto& local_logits =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_truth =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& local_output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+  auto& local_logits_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+  auto& local_truth_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+
+  // Dimensions
+  const El::Int num_classes = local_logits.Height();
+  const El::Int local_mini_batch_size = local_logits.Width();
+  const bool use_labels = m_use_labels;
+
+  // Class indices are not differentiable
+  if (use_labels) {
+    El::Zero(local_truth_grad);
+  }
+
+  // dL/dx = dL/dloss * (softmax(x) * sum(y) - y)
+  // dL/dy = dL/dloss * (logsumexp - x)
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int col = 0; col < local_mini_batch_size; ++col) {
+    const TensorDataType* __restrict__ x = local_logits.LockedBuffer(0, col);
+    const TensorDataType* __restrict__ y = local_truth.LockedBuffer(0, col);
+    TensorDataType* __restrict__ dx = local_logits_grad.Buffer(0, col);
+    const auto dloss = static_cast<AccT>(local_output_grad(0, col));
+    const AccT logsumexp = m_statistics(0, col);
+    const AccT scale = dloss * m_statistics(1, col);
+    if (use_labels) {
+      for (El::Int i = 0; i < num_classes; ++i) {
+        const auto p = std::exp(static_cast<AccT>(x[i]) - logsumexp);
+        dx[i] = static_cast<TensorDataType>(scale * p);
+      }
+      const auto index =
+        get_class_index(static_cast<AccT>(y[0]), num_classes);
+      if (index >= 0) {
+        dx[index] = static_cast<TensorDataType>(static_cast<AccT>(dx[index]) -
+                                                dloss);
+      }
+    }
+    else {
+      TensorDataType* __restrict__ dy = local_truth_grad.Buffer(0, col);
+      for (El::Int i = 0; i < num_classes; ++i) {
+        const auto xi = static_cast<AccT>(x[i]);
+        const auto yi = static_cast<AccT>(y[i]);
+        const auto p = std::exp(xi - logsumexp);
+        dx[i] = static_cast<TensorDataType>(scale * p - dloss * yi);
+        dy[i] = static_cast<TensorDataType>(dloss * (logsumexp - xi));
+      }
+    }
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class softmax_cross_entropy_layer<T,                                \
+                                             data_layout::DATA_PARALLEL,       \
+                                             El::Device::CPU>
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,348 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_SOFTMAX_CROSS_ENTROPY_LAYER_INSTANTIATE
+#include "lbann/layers/loss/softmax_cross_entropy.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Partial online softmax statistics
+ *
+ *  @c sum_exp is the sum of @f$ e^{x_i - \text{max}} @f$ over the
+ *  logits seen so far. @c dot and @c sum_y accumulate the dot product
+ *  of the logits with the ground truth and the sum of the ground
+ *  truth.
+ */
+template <typename AccT>
+struct softmax_statistics
+{
+  AccT max;
+  AccT sum_exp;
+  AccT dot;
+  AccT sum_y;
+};
+
+/** @brief Merge partial online softmax statistics */
+template <typename AccT>
+struct merge_statistics
+{
+  __device__ __forceinline__ softmax_statistics<AccT>
+  operator()(const softmax_statistics<AccT>& a,
+             const softmax_statistics<AccT>& b) const
+  {
+    // Empty partials have a max of -inf, so they are skipped to
+    // avoid evaluating -inf - -inf
+    softmax_statistics<AccT> c;
+    c.max = gpu_lib::max(a.max, b.max);
+    c.sum_exp =
+      ((a.sum_exp > AccT(0) ? a.sum_exp * gpu_lib::exp(a.max - c.max)
+                            : AccT(0)) +
+       (b.sum_exp > AccT(0) ? b.sum_exp * gpu_lib::exp(b.max - c.max)
+                            : AccT(0)));
+    c.dot = a.dot + b.dot;
+    c.sum_y = a.sum_y + b.sum_y;
+    return c;
+  }
+};
+
+/** @brief Forward prop
+ *
+ *  Each block computes the loss for one sample, reading each logit
+ *  once with an online softmax.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: local_mini_batch_size x 1 x 1
+ */
+template <size_t bsize, typename T, typename AccT>
+__global__ void fp_kernel(El::Int num_classes,
+                          El::Int local_mini_batch_size,
+                          bool use_labels,
+                          const T* __restrict__ logits,
+                          El::Int logits_ldim,
+                          const T* __restrict__ truth,
+                          El::Int truth_ldim,
+                          T* __restrict__ output,
+                          El::Int output_ldim,
+                          AccT* __restrict__ statistics,
+                          El::Int statistics_ldim)
+{
+  const El::Int tid = threadIdx.x;
+  for (El::Int col = blockIdx.x; col < local_mini_batch_size;
+       col += gridDim.x) {
+    const T* __restrict__ x = &logits[col * logits_ldim];
+    const T* __restrict__ y = &truth[col * truth_ldim];
+
+    // Each thread accumulates statistics for a strided subset of the
+    // logits
+    softmax_statistics<AccT> stats;
+    stats.max = -gpu_lib::infinity<AccT>();
+    stats.sum_exp = AccT(0);
+    stats.dot = AccT(0);
+    stats.sum_y = AccT(0);
+    for (El::Int i = tid; i < num_classes; i += bsize) {
+      const auto xi = static_cast<AccT>(x[i]);
+      if (xi > stats.max) {
+        stats.sum_exp = stats.sum_exp * gpu_lib::exp(stats.max - xi) + AccT(1);
+        stats.max = xi;
+      }
+      else {
+        stats.sum_exp += gpu_lib::exp(xi - stats.max);
+      }
+      if (!use_labels) {
+        const auto yi = static_cast<AccT>(y[i]);
+        stats.dot += yi * xi;
+        stats.sum_y += yi;
+      }
+    }
+    stats =
+      gpu_lib::block_reduce<bsize, 1, 1, softmax_statistics<AccT>,
+                            merge_statistics<AccT>>(stats);
+
+    // Loss is -sum(y * (x - logsumexp))
+    if (tid == 0) {
+      const AccT logsumexp = stats.max + gpu_lib::log(stats.sum_exp);
+      AccT loss = AccT(0);
+      AccT sum_y = stats.sum_y;
+      if (use_labels) {
+        const auto label = static_cast<AccT>(y[0]);
+        if (label >= AccT(0) && label < static_cast<AccT>(num_classes)) {
+          const auto index = static_cast<El::Int>(label);
+          loss = logsumexp - static_cast<AccT>(x[index]);
+          sum_y = AccT(1);
+        }
+      }
+      else {
+        loss = sum_y * logsumexp - stats.dot;
+      }
+      output[col * output_ldim] = static_cast<T>(loss);
+      statistics[col * statistics_ldim] = logsumexp;
+      statistics[col * statistics_ldim + 1] = sum_y;
+    }
+
+    // Shared memory for the reduction is reused by the next sample
+    __syncthreads();
+  }
+}
+
+/** @brief Backprop
+ *
+ *  dL/dx = dL/dloss * (softmax(x) * sum(y) - y)
+ *  dL/dy = dL/dloss * (logsumexp - x)
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (num_classes / bsize) x local_mini_batch_size x 1
+ */
+template <typename T, typename AccT>
+__global__ void bp_kernel(El::Int num_classes,
+                          El::Int local_mini_batch_size,
+                          bool use_labels,
+                          const T* __restrict__ logits,
+                          El::Int logits_ldim,
+                          const T* __restrict__ truth,
+                          El::Int truth_ldim,
+                          const T* __restrict__ output_grad,
+                          El::Int output_grad_ldim,
+                          const AccT* __restrict__ statistics,
+                          El::Int statistics_ldim,
+                          T* __restrict__ logits_grad,
+                          El::Int logits_grad_ldim,
+                          T* __restrict__ truth_grad,
+                          El::Int truth_grad_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  for (El::Int col = blockIdx.y; col < local_mini_batch_size;
+       col += gridDim.y) {
+    const T* __restrict__ x = &logits[col * logits_ldim];
+    const T* __restrict__ y = &truth[col * truth_ldim];
+    T* __restrict__ dx = &logits_grad[col * logits_grad_ldim];
+    const auto dloss = static_cast<AccT>(output_grad[col * output_grad_ldim]);
+    const AccT logsumexp = statistics[col * statistics_ldim];
+    const AccT scale = dloss * statistics[col * statistics_ldim + 1];
+    El::Int index = -1;
+    if (use_labels) {
+      const auto label = static_cast<AccT>(y[0]);
+      if (label >= AccT(0) && label < static_cast<AccT>(num_classes)) {
+        index = static_cast<El::Int>(label);
+      }
+    }
+    for (El::Int i = gidx; i < num_classes; i += nthreadsx) {
+      const auto xi = static_cast<AccT>(x[i]);
+      const auto p = gpu_lib::exp(xi - logsumexp);
+      if (use_labels) {
+        dx[i] = static_cast<T>(scale * p - (i == index ? dloss : AccT(0)));
+      }
+      else {
+        const auto yi = static_cast<AccT>(y[i]);
+        dx[i] = static_cast<T>(scale * p - dloss * yi);
+        truth_grad[i + col * truth_grad_ldim] =
+          static_cast<T>(dloss * (logsumexp - xi));
+      }
+    }
+  }
+}
+
+} // namespace
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void softmax_cross_entropy_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  using AccT = AccumulateDataType;
+
+  // Local matrices
+  const auto& local_logits =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_truth =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  auto& local_output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Dimensions
+  const El::Int num_classes = local_logits.Height();
+  const El::Int local_mini_batch_size = local_logits.Width();
+  m_statistics.Resize(2, local_mini_batch_size);
+  if (local_logits.IsEmpty()) {
+    return;
+  }
+
+  // Launch GPU kernel
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                     gpu::get_sync_info(m_statistics),
+                                     gpu::get_sync_info(local_logits),
+                                     gpu::get_sync_info(local_truth));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = local_mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(fp_kernel<block_size, TensorDataType, AccT>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_classes,
+                              local_mini_batch_size,
+                              m_use_labels,
+                              local_logits.LockedBuffer(),
+                              local_logits.LDim(),
+                              local_truth.LockedBuffer(),
+                              local_truth.LDim(),
+                              local_output.Buffer(),
+                              local_output.LDim(),
+                              m_statistics.Buffer(),
+                              m_statistics.LDim());
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void softmax_cross_entropy_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+
+  // Local matrices
+  const auto& local_logits =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(0));
+  const auto& local_truth =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations(1));
+  const auto& local_output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+  auto& local_logits_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(0));
+  auto& local_truth_grad =
+    dynamic_cast<LocalMat&>(this->get_local_error_signals(1));
+
+  // Class indices are not differentiable
+  if (m_use_labels) {
+    El::Zero(local_truth_grad);
+  }
+
+  // Dimensions
+  const El::Int num_classes = local_logits.Height();
+  const El::Int local_mini_batch_size = local_logits.Width();
+  if (local_logits.IsEmpty()) {
+    return;
+  }
+
+  // Launch GPU kernel
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_logits_grad),
+                                     gpu::get_sync_info(local_truth_grad),
+                                     gpu::get_sync_info(local_logits),
+                                     gpu::get_sync_info(local_truth),
+                                     gpu::get_sync_info(local_output_grad),
+                                     gpu::get_sync_info(m_statistics));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (num_classes + block_size - 1) / block_size;
+  grid_dims.y = local_mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(bp_kernel<TensorDataType, AccumulateDataType>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_classes,
+                              local_mini_batch_size,
+                              m_use_labels,
+                              local_logits.LockedBuffer(),
+                              local_logits.LDim(),
+                              local_truth.LockedBuffer(),
+                              local_truth.LDim(),
+                              local_output_grad.LockedBuffer(),
+                              local_output_grad.LDim(),
+                              m_statistics.LockedBuffer(),
+                              m_statistics.LDim(),
+                              local_logits_grad.Buffer(),
+                              local_logits_grad.LDim(),
+                              local_truth_grad.Buffer(),
+                              local_truth_grad.LDim());
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class softmax_cross_entropy_layer<T,                                \
+                                             data_layout::DATA_PARALLEL,       \
+                                             El::Device::GPU>
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
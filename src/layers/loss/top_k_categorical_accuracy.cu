@@ -30,102 +30,10 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
-#include <thrust/iterator/discard_iterator.h>
-#include <thrust/sort.h>
-
 namespace lbann {
 
 namespace {
 
-/** Sparse vector entry. */
-template <typename TensorDataType>
-struct entry
-{
-  /** Vector entry value. */
-  TensorDataType value;
-  /** Vector entry index. */
-  El::Int index;
-};
-
-/** Comparison operation to sort sparse vector entries.
- *  Entries are sorted by value in decreasing order, with ties broken
- *  in favor of entries with smaller indices.
- */
-template <typename TensorDataType>
-struct entry_compare : ::thrust::binary_function<entry<TensorDataType>,
-                                                 entry<TensorDataType>,
-                                                 bool>
-{
-  __host__ __device__ bool operator()(const entry<TensorDataType>& a,
-                                      const entry<TensorDataType>& b) const
-  {
-    return a.value > b.value || (a.value == b.value && a.index < b.index);
-  }
-};
-
-/** Convert columns of a dense matrix into sparse vectors.
- *  The matrix and vectors are both distributed, so entry indices in
- *  the sparse vectors correspond to global row indices in the dense
- *  matrix.
- */
-template <typename TensorDataType>
-__global__ void dense_matrix_to_sparse_vectors(
-  El::Int local_vector_size,
-  El::Int local_matrix_height,
-  El::Int local_matrix_width,
-  El::Int global_matrix_height,
-  El::Int global_matrix_col_shift,
-  El::Int global_matrix_col_stride,
-  const TensorDataType* __restrict__ local_matrix,
-  El::Int local_matrix_ldim,
-  entry<TensorDataType>* __restrict__ local_entries,
-  El::Int local_entries_ldim)
-{
-  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int num_threads = blockDim.x * gridDim.x;
-  const El::Int num_local_entries = local_vector_size * local_matrix_width;
-  for (El::Int i = gid; i < num_local_entries; i += num_threads) {
-    const auto& local_row = i % local_vector_size;
-    const auto& local_col = i / local_vector_size;
-    auto& current_entry =
-      local_entries[local_row + local_col * local_entries_ldim];
-    if (local_row < local_matrix_height) {
-      const auto& global_row =
-        (global_matrix_col_shift + local_row * global_matrix_col_stride);
-      current_entry.value =
-        local_matrix[local_row + local_col * local_matrix_ldim];
-      current_entry.index = global_row;
-    }
-    else {
-      current_entry.value = -gpu_lib::infinity<TensorDataType>();
-      current_entry.index = global_matrix_height;
-    }
-  }
-}
-
-/** Fill an array with a corresponding tensor index.
- *  Consider a d(1) x d(2) x ... x d(n) tensor with entry indices
- *  denoted with (i(1), ..., i(n)). This tensor is contiguous in
- *  memory with d(1) as the most major dimension and d(n) as the most
- *  minor (e.g. d(1) is the width and d(2) is the height for a
- *  column-major matrix). Given some k, this kernel sets each entry in
- *  the tensor to i(k). Using this notation:
- *    tensor_size = d(1) * ... * d(n)
- *    dim         = d(k)
- *    dim_stride  = d(k+1) * ... * d(n)
- */
-__global__ void fill_with_tensor_index(El::Int tensor_size,
-                                       El::Int dim,
-                                       El::Int dim_stride,
-                                       El::Int* tensor)
-{
-  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int num_threads = blockDim.x * gridDim.x;
-  for (El::Int i = gid; i < tensor_size; i += num_threads) {
-    tensor[i] = (i / dim_stride) % dim;
-  }
-}
-
 /** Get indices corresponding to one-hot matrix.
  *  Each column of the input matrix is interpreted as a one-hot
  *  vector. Note that we may get race conditions if a matrix column is
@@ -156,36 +64,110 @@ one_hot_matrix_to_indices(El::Int local_height,
   }
 }
 
+/** Get the prediction for each column's label.
+ *  The prediction is negative infinity if the label's row is not
+ *  owned by this process.
+ */
+template <typename TensorDataType>
+__global__ void
+get_label_predictions(El::Int local_height,
+                      El::Int local_width,
+                      El::Int global_matrix_col_shift,
+                      El::Int global_matrix_col_stride,
+                      const El::Int* __restrict__ label_indices,
+                      const TensorDataType* __restrict__ local_predictions,
+                      El::Int local_predictions_ldim,
+                      TensorDataType* __restrict__ label_predictions)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  for (El::Int col = gid; col < local_width; col += num_threads) {
+    const auto& offset = label_indices[col] - global_matrix_col_shift;
+    const auto& local_row = offset / global_matrix_col_stride;
+    auto value = -gpu_lib::infinity<TensorDataType>();
+    if (offset >= 0 && offset % global_matrix_col_stride == 0 &&
+        local_row < local_height) {
+      value = local_predictions[local_row + col * local_predictions_ldim];
+    }
+    label_predictions[col] = value;
+  }
+}
+
+/** Count the entries ranked ahead of each column's label.
+ *  Entries are ranked by value in decreasing order, with ties broken
+ *  in favor of entries with smaller indices, so the label is in the
+ *  top-k entries if fewer than k entries are ranked ahead of it.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: local_width x 1 x 1
+ */
+template <size_t bsize, typename TensorDataType>
+__global__ void
+count_entries_ahead(El::Int local_height,
+                    El::Int local_width,
+                    El::Int global_matrix_col_shift,
+                    El::Int global_matrix_col_stride,
+                    const El::Int* __restrict__ label_indices,
+                    const TensorDataType* __restrict__ label_predictions,
+                    const TensorDataType* __restrict__ local_predictions,
+                    El::Int local_predictions_ldim,
+                    El::Int* __restrict__ counts)
+{
+  for (El::Int col = blockIdx.x; col < local_width; col += gridDim.x) {
+    const auto& label_index = label_indices[col];
+    const auto& label_value = label_predictions[col];
+    const auto* __restrict__ x =
+      &local_predictions[col * local_predictions_ldim];
+    El::Int count = 0;
+    for (El::Int row = threadIdx.x; row < local_height; row += bsize) {
+      const auto& value = x[row];
+      const auto& global_row =
+        global_matrix_col_shift + row * global_matrix_col_stride;
+      if (value > label_value ||
+          (value == label_value && global_row < label_index)) {
+        ++count;
+      }
+    }
+    count = gpu_lib::block_reduce<bsize, 1, 1>(count);
+    if (threadIdx.x == 0) {
+      counts[col] = count;
+    }
+
+    // Shared memory for the reduction is reused by the next column
+    __syncthreads();
+  }
+}
+
 /** Compute categorical accuracy for each matrix column.
- *  Loss is one if the label index matches one of the top-k entries
+ *  Loss is one if fewer than k entries are ranked ahead of the label
  *  and is otherwise zero.
  */
 template <typename TensorDataType>
-__global__ void compute_categorical_accuracy(
-  El::Int k,
-  El::Int width,
-  El::Int max_entry,
-  const entry<TensorDataType>* __restrict__ top_entries,
-  El::Int top_entries_ldim,
-  const El::Int* __restrict__ label_indices,
-  TensorDataType* __restrict__ loss,
-  El::Int loss_stride)
+__global__ void
+compute_categorical_accuracy(El::Int k,
+                             El::Int width,
+                             El::Int max_entry,
+                             const El::Int* __restrict__ counts,
+                             const El::Int* __restrict__ label_indices,
+                             TensorDataType* __restrict__ loss,
+                             El::Int loss_stride)
 {
   const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
   const El::Int num_threads = blockDim.x * gridDim.x;
-  const El::Int num_entries = width * k;
-  for (El::Int i = gid; i < num_entries; i += num_threads) {
-    const auto& ind = i % k;
-    const auto& col = i / k;
-    const auto& label_index = label_indices[col];
-    if (top_entries[ind + col * top_entries_ldim].index == label_index &&
-        label_index <= max_entry) {
+  for (El::Int col = gid; col < width; col += num_threads) {
+    if (counts[col] < k && label_indices[col] <= max_entry) {
       loss[col * loss_stride] = TensorDataType(1.0);
     }
   }
 }
 
-/** GPU implementation of top-k categorical accuracy layer forward prop. */
+/** GPU implementation of top-k categorical accuracy layer forward prop.
+ *
+ *  Instead of sorting each column, count the entries that are ranked
+ *  ahead of the label. This reads each prediction once and only
+ *  communicates a few values per column.
+ */
 template <typename TensorDataType>
 void fp_gpu(lbann_comm& comm,
             El::Int k,
@@ -226,8 +208,6 @@ void fp_gpu(lbann_comm& comm,
                                      gpu::get_sync_info(local_predictions),
                                      gpu::get_sync_info(local_labels));
   El::SyncInfo<El::Device::GPU> const& sync_info = multisync;
-  auto&& stream = sync_info.Stream();
-  gpu_lib::thrust::allocator<> alloc(stream);
 
   // Get label indices
   gpu_lib::thrust::vector<El::Int> label_indices(local_width, height);
@@ -256,114 +236,71 @@ void fp_gpu(lbann_comm& comm,
                        sync_info);
   }
 
-  // Find top-k entries in each column of local prediction matrix
-  gpu_lib::thrust::vector<entry<TensorDataType>> top_entries(local_width * k);
+  // Get the prediction for each label
+  El::Matrix<TensorDataType, El::Device::GPU> label_predictions;
+  El::SetSyncInfo(label_predictions, sync_info);
+  label_predictions.Resize(1, local_width);
   {
-    const auto& num_local_entries_per_col = std::max(local_height, k);
-    const auto& num_local_entries = local_width * num_local_entries_per_col;
     const auto& block_dim = 256;
-    const auto& grid_dim = (num_local_entries + block_dim - 1) / block_dim;
-    gpu_lib::thrust::vector<entry<TensorDataType>> local_entries(
-      num_local_entries);
-    gpu_lib::thrust::vector<El::Int> local_entries_cols(num_local_entries);
-    hydrogen::gpu::LaunchKernel(dense_matrix_to_sparse_vectors<TensorDataType>,
+    const auto& grid_dim = (local_width + block_dim - 1) / block_dim;
+    hydrogen::gpu::LaunchKernel(get_label_predictions<TensorDataType>,
                                 grid_dim,
                                 block_dim,
                                 0,
                                 sync_info,
-                                num_local_entries_per_col,
                                 local_height,
                                 local_width,
-                                height,
                                 predictions.ColShift(),
                                 predictions.ColStride(),
+                                label_indices.data().get(),
                                 local_predictions.LockedBuffer(),
                                 local_predictions.LDim(),
-                                local_entries.data().get(),
-                                num_local_entries_per_col);
-    hydrogen::gpu::LaunchKernel(fill_with_tensor_index,
-                                grid_dim,
-                                block_dim,
-                                0,
-                                sync_info,
-                                num_local_entries,
-                                local_width,
-                                num_local_entries_per_col,
-                                local_entries_cols.data().get());
-    ::thrust::sort_by_key(alloc.system(),
-                          local_entries.begin(),
-                          local_entries.end(),
-                          local_entries_cols.begin(),
-                          entry_compare<TensorDataType>());
-    ::thrust::stable_sort_by_key(alloc.system(),
-                                 local_entries_cols.begin(),
-                                 local_entries_cols.end(),
-                                 local_entries.begin());
-    hydrogen::gpu::Copy2DIntraDevice(local_entries.data().get(),
-                                     num_local_entries_per_col,
-                                     top_entries.data().get(),
-                                     k,
-                                     k,
-                                     local_width,
-                                     sync_info);
+                                label_predictions.Buffer());
+    if (col_comm_size > 1) {
+      comm.allreduce(static_cast<El::AbstractMatrix<TensorDataType>&>(
+                       label_predictions),
+                     col_comm,
+                     El::mpi::MAX);
+    }
   }
 
-  // Find top-k entries in each column of global prediction matrix
-  if (col_comm_size > 1) {
-    const auto& num_entries_per_rank = local_width * k;
-    const auto& num_entries = col_comm_size * num_entries_per_rank;
-    const auto& block_dim = 256;
-    const auto& grid_dim = (num_entries + block_dim - 1) / block_dim;
-    if (col_comm_rank != col_comm_root) {
-      comm.gather(reinterpret_cast<El::byte*>(top_entries.data().get()),
-                  top_entries.size() * sizeof(entry<TensorDataType>),
-                  col_comm_root,
-                  col_comm,
-                  sync_info);
-    }
-    else {
-      gpu_lib::thrust::vector<entry<TensorDataType>> global_top_entries(
-        num_entries);
-      gpu_lib::thrust::vector<El::Int> global_top_entries_cols(num_entries);
-      comm.gather(reinterpret_cast<El::byte*>(top_entries.data().get()),
-                  top_entries.size() * sizeof(entry<TensorDataType>),
-                  reinterpret_cast<El::byte*>(global_top_entries.data().get()),
-                  col_comm,
-                  sync_info);
-      hydrogen::gpu::LaunchKernel(fill_with_tensor_index,
-                                  grid_dim,
-                                  block_dim,
-                                  0,
-                                  multisync,
-                                  num_entries,
-                                  local_width,
-                                  k,
-                                  global_top_entries_cols.data().get());
-      ::thrust::sort_by_key(alloc.system(),
-                            global_top_entries.begin(),
-                            global_top_entries.end(),
-                            global_top_entries_cols.begin(),
-                            entry_compare<TensorDataType>());
-      ::thrust::stable_sort_by_key(alloc.system(),
-                                   global_top_entries_cols.begin(),
-                                   global_top_entries_cols.end(),
-                                   global_top_entries.begin());
-      hydrogen::gpu::Copy2DIntraDevice(top_entries.data().get(),
-                                       k,
-                                       global_top_entries.data().get(),
-                                       col_comm_size * k,
-                                       k,
-                                       local_width,
-                                       sync_info);
+  // Count entries ranked ahead of each label
+  gpu_lib::thrust::vector<El::Int> counts(local_width, 0);
+  {
+    constexpr size_t block_size = 256;
+    dim3 block_dims, grid_dims;
+    block_dims.x = block_size;
+    grid_dims.x = local_width;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(
+      count_entries_ahead<block_size, TensorDataType>,
+      grid_dims,
+      block_dims,
+      0,
+      sync_info,
+      local_height,
+      local_width,
+      predictions.ColShift(),
+      predictions.ColStride(),
+      label_indices.data().get(),
+      label_predictions.LockedBuffer(),
+      local_predictions.LockedBuffer(),
+      local_predictions.LDim(),
+      counts.data().get());
+    if (col_comm_size > 1) {
+      El::mpi::AllReduce(counts.data().get(),
+                         counts.size(),
+                         El::mpi::SUM,
+                         col_comm,
+                         sync_info);
     }
   }
 
   // Compute categorical accuracy
   El::Zero(loss);
   if (col_comm_rank == col_comm_root) {
-    const auto& num_entries = local_width * k;
     const auto& block_dim = 256;
-    const auto& grid_dim = (num_entries + block_dim - 1) / block_dim;
+    const auto& grid_dim = (local_width + block_dim - 1) / block_dim;
     hydrogen::gpu::LaunchKernel(compute_categorical_accuracy<TensorDataType>,
                                 grid_dim,
                                 block_dim,
@@ -372,8 +309,7 @@ void fp_gpu(lbann_comm& comm,
                                 k,
                                 local_width,
                                 height - 1,
-                                top_entries.data().get(),
-                                k,
+                                counts.data().get(),
                                 label_indices.data().get(),
                                 local_loss.Buffer(),
                                 local_loss.LDim());
@@ -27,13 +27,16 @@
 #define LBANN_MATMUL_LAYER_INSTANTIATE
 #include "lbann/layers/math/matmul.hpp"
 #include "lbann/proto/datatype_helpers.hpp"
+#include "lbann/utils/batched_gemm.hpp"
 #include "lbann/utils/exception.hpp"
 
 #ifdef LBANN_HAS_GPU
 #include "lbann/utils/gpu/helpers.hpp"
 #endif // LBANN_HAS_GPU
 #include "lbann/proto/layers.pb.h"
+#include <algorithm>
 #include <iostream>
+#include <vector>
 
 namespace lbann {
 
@@ -159,230 +162,231 @@ matmul_layer<TensorDataType, Layout, Device>::get_distconv_adapter()
 
 #endif //  LBANN_HAS_DISTCONV
 
-template <typename TensorDataType>
-void fp_compute_impl(
-  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::CPU>& l,
-  bool transpose_input0,
-  bool transpose_input1)
+namespace {
+
+/** @brief Matrices in a mini-batch tensor
+ *
+ *  Matrices are stored in Fortran layout. Matrix (d, j) starts at
+ *  buffer + d * depth_stride + j * sample_stride, where d indexes the
+ *  first tensor dimension and j indexes the mini-batch samples. A
+ *  depth stride of zero means one matrix per sample that is broadcast
+ *  over the first tensor dimension.
+ */
+template <typename PtrT>
+struct strided_matrices
+{
+  PtrT buffer;
+  El::Int ldim;
+  El::Int depth_stride;
+  El::Int sample_stride;
+};
+
+/** @brief Get strided matrices for a local mini-batch matrix */
+template <typename MatT>
+auto get_strided_matrices(MatT& local_mat,
+                          const std::vector<int>& dims,
+                          El::Int depth)
 {
+  const El::Int height = *(dims.rbegin() + 1);
+  const El::Int width = *(dims.rbegin());
+  const El::Int mat_depth = (dims.size() > 2) ? *(dims.rbegin() + 2) : 1;
+  using PtrT = decltype(local_mat.Buffer());
+  return strided_matrices<PtrT>{local_mat.Buffer(),
+                                width,
+                                (mat_depth == 1 && depth > 1) ? 0
+                                                              : height * width,
+                                local_mat.LDim()};
+}
+template <typename MatT>
+auto get_locked_strided_matrices(const MatT& local_mat,
+                                 const std::vector<int>& dims,
+                                 El::Int depth)
+{
+  const El::Int height = *(dims.rbegin() + 1);
+  const El::Int width = *(dims.rbegin());
+  const El::Int mat_depth = (dims.size() > 2) ? *(dims.rbegin() + 2) : 1;
+  using PtrT = decltype(local_mat.LockedBuffer());
+  return strided_matrices<PtrT>{local_mat.LockedBuffer(),
+                                width,
+                                (mat_depth == 1 && depth > 1) ? 0
+                                                              : height * width,
+                                local_mat.LDim()};
+}
 
-  // Local data
-  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
-  const auto& local_input0 =
-    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
-  const auto& local_input1 =
-    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
-  auto& local_output = dynamic_cast<LocalMat&>(l.get_local_activations());
-  const auto& local_mini_batch_size = local_input0.Width();
-
-  if (!local_input0.Contiguous() || !local_input1.Contiguous() ||
-      !local_output.Contiguous()) {
-    LBANN_ERROR(l.get_type(),
-                " layer \"",
-                l.get_name(),
-                "\" ",
-                "has non-contiguous data buffers");
+/** @brief GEMMs over a mini-batch of tensors
+ *
+ *  Computes C(d,j) = op(A(d,j)) * op(B(d,j)) for each matrix index d
+ *  and mini-batch sample j. Batches are issued with as few
+ *  strided-batched GEMMs as the strides allow. If the output is
+ *  broadcast (depth stride of zero), the products are instead
+ *  summed over d, i.e. the gradient w.r.t. a broadcast input.
+ */
+template <typename T, typename SyncInfoT>
+void batched_gemm(El::Orientation transa,
+                  El::Orientation transb,
+                  El::Int m,
+                  El::Int n,
+                  El::Int k,
+                  const strided_matrices<const T*>& A,
+                  const strided_matrices<const T*>& B,
+                  const strided_matrices<T*>& C,
+                  El::Int depth,
+                  El::Int mini_batch_size,
+                  const SyncInfoT& sync_info)
+{
+  const auto zero = El::TypeTraits<T>::Zero();
+  const auto one = El::TypeTraits<T>::One();
+  auto is_packed = [depth](const auto& X) {
+    return X.depth_stride * depth == X.sample_stride;
+  };
+  if (depth > 1 && C.depth_stride == 0) {
+    // Sum over matrix index, with one batch per matrix index
+    for (El::Int d = 0; d < depth; ++d) {
+      gemm_strided_batched(transa,
+                           transb,
+                           m,
+                           n,
+                           k,
+                           one,
+                           A.buffer + d * A.depth_stride,
+                           A.ldim,
+                           A.sample_stride,
+                           B.buffer + d * B.depth_stride,
+                           B.ldim,
+                           B.sample_stride,
+                           d == 0 ? zero : one,
+                           C.buffer,
+                           C.ldim,
+                           C.sample_stride,
+                           mini_batch_size,
+                           sync_info);
+    }
   }
-  // Matrix dimensions
-  const auto input0_dims = l.get_input_dims(0);
-  const auto input1_dims = l.get_input_dims(1);
-  const auto output_dims = l.get_output_dims();
-  // Check if matrix is 3D or 2D
-  const El::Int mat_depth =
-    (input0_dims.size() > 2) ? *(input0_dims.rbegin() + 2) : 1;
-
-  const El::Int input0_height = *(input0_dims.rbegin() + 1);
-  const El::Int input0_width = *(input0_dims.rbegin());
-  const El::Int input1_height = *(input1_dims.rbegin() + 1);
-  const El::Int input1_width = *(input1_dims.rbegin());
-  const El::Int output_height = *(output_dims.rbegin() + 1);
-  const El::Int output_width = *(output_dims.rbegin());
-
-  // Compute matrix multiplication for each mini-batch sample
-  // Note: Elemental matrices are in Fortran layout while LBANN
-  // tensors are in C layout.
-
-  // Calculate stride for each matrix depending on the depth
-  const auto input0_stride = input0_height * input0_width;
-  const auto input1_stride = input1_height * input1_width;
-  const auto output_stride = output_height * output_width;
-
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int j = 0; j < mat_depth; ++j) {
-    auto input0_buffer_start = j * input0_stride;
-    auto input1_buffer_start = j * input1_stride;
-    auto output_buffer_start = j * output_stride;
-    for (El::Int i = 0; i < local_mini_batch_size; ++i) {
-      LocalMat input0_v, input1_v, output_v;
-      input0_v.LockedAttach(input0_width,
-                            input0_height,
-                            local_input0.LockedBuffer(input0_buffer_start, i),
-                            input0_width);
-      input1_v.LockedAttach(input1_width,
-                            input1_height,
-                            local_input1.LockedBuffer(input1_buffer_start, i),
-                            input1_width);
-      output_v.Attach(output_width,
-                      output_height,
-                      local_output.Buffer(output_buffer_start, i),
-                      output_width);
-      El::Gemm(transpose_input1 ? El::TRANSPOSE : El::NORMAL,
-               transpose_input0 ? El::TRANSPOSE : El::NORMAL,
-               El::TypeTraits<TensorDataType>::One(),
-               input1_v,
-               input0_v,
-               El::TypeTraits<TensorDataType>::Zero(),
-               output_v);
+  else if (is_packed(A) && is_packed(B) && is_packed(C)) {
+    // All matrices are evenly spaced
+    gemm_strided_batched(transa,
+                         transb,
+                         m,
+                         n,
+                         k,
+                         one,
+                         A.buffer,
+                         A.ldim,
+                         A.depth_stride,
+                         B.buffer,
+                         B.ldim,
+                         B.depth_stride,
+                         zero,
+                         C.buffer,
+                         C.ldim,
+                         C.depth_stride,
+                         depth * mini_batch_size,
+                         sync_info);
+  }
+  else if (depth <= mini_batch_size) {
+    // One batch over mini-batch samples per matrix index
+    for (El::Int d = 0; d < depth; ++d) {
+      gemm_strided_batched(transa,
+                           transb,
+                           m,
+                           n,
+                           k,
+                           one,
+                           A.buffer + d * A.depth_stride,
+                           A.ldim,
+                           A.sample_stride,
+                           B.buffer + d * B.depth_stride,
+                           B.ldim,
+                           B.sample_stride,
+                           zero,
+                           C.buffer + d * C.depth_stride,
+                           C.ldim,
+                           C.sample_stride,
+                           mini_batch_size,
+                           sync_info);
+    }
+  }
+  else {
+    // One batch over matrix indices per mini-batch sample
+    for (El::Int j = 0; j < mini_batch_size; ++j) {
+      gemm_strided_batched(transa,
+                           transb,
+                           m,
+                           n,
+                           k,
+                           one,
+                           A.buffer + j * A.sample_stride,
+                           A.ldim,
+                           A.depth_stride,
+                           B.buffer + j * B.sample_stride,
+                           B.ldim,
+                           B.depth_stride,
+                           zero,
+                           C.buffer + j * C.sample_stride,
+                           C.ldim,
+                           C.depth_stride,
+                           depth,
+                           sync_info);
     }
   }
 }
 
-template <typename TensorDataType>
-void bp_compute_impl(
-  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::CPU>& l,
-  bool transpose_input0,
-  bool transpose_input1)
+/** @brief Synchronization object for GEMMs on CPU */
+template <typename T, typename... Ts>
+El::SyncInfo<El::Device::CPU>
+get_gemm_sync_info(const El::Matrix<T, El::Device::CPU>& C,
+                   const El::Matrix<Ts, El::Device::CPU>&...)
 {
+  return El::SyncInfoFromMatrix(C);
+}
 
-  // Local data
-  using LocalMat = El::Matrix<TensorDataType, El::Device::CPU>;
-  const auto& local_input0 =
-    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
-  const auto& local_input1 =
-    dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
-  const auto& local_output_grad =
-    dynamic_cast<const LocalMat&>(l.get_local_prev_error_signals());
-  auto& local_input0_grad =
-    dynamic_cast<LocalMat&>(l.get_local_error_signals(0));
-  auto& local_input1_grad =
-    dynamic_cast<LocalMat&>(l.get_local_error_signals(1));
-  const auto& local_mini_batch_size = local_input0.Width();
-  if (!local_input0.Contiguous() || !local_input1.Contiguous() ||
-      !local_output_grad.Contiguous() || !local_input0_grad.Contiguous() ||
-      !local_input1_grad.Contiguous()) {
-    LBANN_ERROR(l.get_type(),
-                " layer \"",
-                l.get_name(),
-                "\" ",
-                "has non-contiguous data buffers");
-  }
-  // Matrix dimensions
-  const auto input0_dims = l.get_input_dims(0);
-  const auto input1_dims = l.get_input_dims(1);
-  const auto output_dims = l.get_output_dims();
-  // Check if matrix is 3D or 2D
-  const El::Int mat_depth =
-    (input0_dims.size() > 2) ? *(input0_dims.rbegin() + 2) : 1;
-
-  const El::Int input0_height = *(input0_dims.rbegin() + 1);
-  const El::Int input0_width = *(input0_dims.rbegin());
-  const El::Int input1_height = *(input1_dims.rbegin() + 1);
-  const El::Int input1_width = *(input1_dims.rbegin());
-  const El::Int output_height = *(output_dims.rbegin() + 1);
-  const El::Int output_width = *(output_dims.rbegin());
-
-  // Compute gradients for each mini-batch sample
-  // Note: Elemental matrices are in Fortran layout while LBANN
-  // tensors are in C layout.
+#ifdef LBANN_HAS_GPU
+/** @brief Synchronization object for GEMMs on GPU
+ *
+ *  The SyncInfo of the C matrix leads the way!
+ */
+template <typename T, typename... Ts>
+auto get_gemm_sync_info(const El::Matrix<T, El::Device::GPU>& C,
+                        const El::Matrix<Ts, El::Device::GPU>&... others)
+{
+  return El::MakeMultiSync(gpu::get_sync_info(C),
+                           gpu::get_sync_info(others)...);
+}
+#endif // LBANN_HAS_GPU
 
-  // Calculate stride for each matrix depending on the depth
-  const auto input0_stride = input0_height * input0_width;
-  const auto input1_stride = input1_height * input1_width;
-  const auto output_stride = output_height * output_width;
-
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int j = 0; j < mat_depth; ++j) {
-    auto input0_buffer_start = j * input0_stride;
-    auto input1_buffer_start = j * input1_stride;
-    auto output_buffer_start = j * output_stride;
-    for (El::Int i = 0; i < local_mini_batch_size; ++i) {
-      LocalMat input0_v, input1_v, output_grad_v, input0_grad_v, input1_grad_v;
-      input0_v.LockedAttach(input0_width,
-                            input0_height,
-                            local_input0.LockedBuffer(input0_buffer_start, i),
-                            input0_width);
-      input1_v.LockedAttach(input1_width,
-                            input1_height,
-                            local_input1.LockedBuffer(input1_buffer_start, i),
-                            input1_width);
-      output_grad_v.LockedAttach(
-        output_width,
-        output_height,
-        local_output_grad.LockedBuffer(output_buffer_start, i),
-        output_width);
-      input0_grad_v.Attach(input0_width,
-                           input0_height,
-                           local_input0_grad.Buffer(input0_buffer_start, i),
-                           input0_width);
-      input1_grad_v.Attach(input1_width,
-                           input1_height,
-                           local_input1_grad.Buffer(input1_buffer_start, i),
-                           input1_width);
-      if (transpose_input0) {
-        El::Gemm(El::TRANSPOSE,
-                 transpose_input1 ? El::TRANSPOSE : El::NORMAL,
-                 El::TypeTraits<TensorDataType>::One(),
-                 output_grad_v,
-                 input1_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input0_grad_v);
-      }
-      else {
-        El::Gemm(transpose_input1 ? El::NORMAL : El::TRANSPOSE,
-                 El::NORMAL,
-                 El::TypeTraits<TensorDataType>::One(),
-                 input1_v,
-                 output_grad_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input0_grad_v);
-      }
-      if (transpose_input1) {
-        El::Gemm(transpose_input0 ? El::TRANSPOSE : El::NORMAL,
-                 El::TRANSPOSE,
-                 El::TypeTraits<TensorDataType>::One(),
-                 input0_v,
-                 output_grad_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input1_grad_v);
-      }
-      else {
-        El::Gemm(El::NORMAL,
-                 transpose_input0 ? El::NORMAL : El::TRANSPOSE,
-                 El::TypeTraits<TensorDataType>::One(),
-                 output_grad_v,
-                 input0_v,
-                 El::TypeTraits<TensorDataType>::Zero(),
-                 input1_grad_v);
-      }
-    }
-  }
+/** @brief Number of matrices in the first tensor dimension
+ *
+ *  A 2D input, or a 3D input with a first dimension of one, is
+ *  broadcast to the other input.
+ */
+El::Int get_depth(const std::vector<int>& input0_dims,
+                  const std::vector<int>& input1_dims)
+{
+  const El::Int input0_depth =
+    (input0_dims.size() > 2) ? *(input0_dims.rbegin() + 2) : 1;
+  const El::Int input1_depth =
+    (input1_dims.size() > 2) ? *(input1_dims.rbegin() + 2) : 1;
+  return std::max(input0_depth, input1_depth);
 }
 
-#ifdef LBANN_HAS_GPU
-template <typename TensorDataType>
+} // namespace
+
+template <typename TensorDataType, El::Device Device>
 void fp_compute_impl(
-  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::GPU>& l,
+  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>& l,
   bool transpose_input0,
   bool transpose_input1)
 {
 
   // Local data
-  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  using LocalMat = El::Matrix<TensorDataType, Device>;
   const auto& local_input0 =
     dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
   const auto& local_input1 =
     dynamic_cast<const LocalMat&>(l.get_local_prev_activations(1));
   auto& local_output = dynamic_cast<LocalMat&>(l.get_local_activations());
-  const auto& local_mini_batch_size = local_input0.Width();
-
-  if (!local_input0.Contiguous() || !local_input1.Contiguous() ||
-      !local_output.Contiguous()) {
-    LBANN_ERROR(l.get_type(),
-                " layer \"",
-                l.get_name(),
-                "\" ",
-                "has non-contiguous data buffers");
-  }
+  const El::Int local_mini_batch_size = local_input0.Width();
+
   // Return immediately if nothing needs to be done
   if (local_mini_batch_size < 1) {
     return;
@@ -392,64 +396,38 @@ void fp_compute_impl(
   const auto input0_dims = l.get_input_dims(0);
   const auto input1_dims = l.get_input_dims(1);
   const auto output_dims = l.get_output_dims();
-  // Check if matrix is 3D or 2D
-  const El::Int mat_depth =
-    (input0_dims.size() > 2) ? *(input0_dims.rbegin() + 2) : 1;
-
+  const El::Int depth = get_depth(input0_dims, input1_dims);
   const El::Int input0_height = *(input0_dims.rbegin() + 1);
   const El::Int input0_width = *(input0_dims.rbegin());
-  const El::Int input1_height = *(input1_dims.rbegin() + 1);
-  const El::Int input1_width = *(input1_dims.rbegin());
   const El::Int output_height = *(output_dims.rbegin() + 1);
   const El::Int output_width = *(output_dims.rbegin());
 
-  const auto num_matrices = mat_depth * local_mini_batch_size;
-  const auto input0_stride = input0_height * input0_width;
-  const auto input1_stride = input1_height * input1_width;
-  const auto output_stride = output_height * output_width;
-
-  // Compute gradients for each mini-batch sample
-  // Note: cuBLAS expects matrices in Fortran layout while LBANN
+  // Compute matrix multiplication for each mini-batch sample
+  // Note: BLAS expects matrices in Fortran layout while LBANN
   // tensors are in C layout.
-  {
-    using namespace hydrogen;
-    auto multisync = MakeMultiSync(gpu::get_sync_info(local_output),
-                                   gpu::get_sync_info(local_input0),
-                                   gpu::get_sync_info(local_input1));
-
-    gpu_blas::GemmStridedBatched(
-      transpose_input1 ? TransposeMode::TRANSPOSE : TransposeMode::NORMAL,
-      transpose_input0 ? TransposeMode::TRANSPOSE : TransposeMode::NORMAL,
-      output_width,
-      output_height,
-      transpose_input0 ? input0_height : input0_width,
-      El::TypeTraits<TensorDataType>::One(),
-      local_input1.LockedBuffer(),
-      input1_width,
-      input1_stride,
-      local_input0.LockedBuffer(),
-      input0_width,
-      input0_stride,
-      El::TypeTraits<TensorDataType>::Zero(),
-      local_output.Buffer(),
-      output_width,
-      output_stride,
-      num_matrices,
-      multisync);
-  }
+  auto sync_info = get_gemm_sync_info(local_output, local_input0, local_input1);
+  batched_gemm(transpose_input1 ? El::TRANSPOSE : El::NORMAL,
+               transpose_input0 ? El::TRANSPOSE : El::NORMAL,
+               output_width,
+               output_height,
+               transpose_input0 ? input0_height : input0_width,
+               get_locked_strided_matrices(local_input1, input1_dims, depth),
+               get_locked_strided_matrices(local_input0, input0_dims, depth),
+               get_strided_matrices(local_output, output_dims, depth),
+               depth,
+               local_mini_batch_size,
+               sync_info);
 }
-#endif // LBANN_HAS_GPU
 
-#ifdef LBANN_HAS_GPU
-template <typename TensorDataType>
+template <typename TensorDataType, El::Device Device>
 void bp_compute_impl(
-  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, El::Device::GPU>& l,
+  matmul_layer<TensorDataType, data_layout::DATA_PARALLEL, Device>& l,
   bool transpose_input0,
   bool transpose_input1)
 {
 
   // Local data
-  using LocalMat = El::Matrix<TensorDataType, El::Device::GPU>;
+  using LocalMat = El::Matrix<TensorDataType, Device>;
   const auto& local_input0 =
     dynamic_cast<const LocalMat&>(l.get_local_prev_activations(0));
   const auto& local_input1 =
@@ -460,151 +438,100 @@ void bp_compute_impl(
     dynamic_cast<LocalMat&>(l.get_local_error_signals(0));
   auto& local_input1_grad =
     dynamic_cast<LocalMat&>(l.get_local_error_signals(1));
-  const auto& local_mini_batch_size = local_input0.Width();
+  const El::Int local_mini_batch_size = local_input0.Width();
 
   // Return immediately if nothing needs to be done
   if (local_mini_batch_size < 1) {
     return;
   }
 
-  if (!local_input0.Contiguous() || !local_input1.Contiguous() ||
-      !local_output_grad.Contiguous() || !local_input0_grad.Contiguous() ||
-      !local_input1_grad.Contiguous()) {
-    LBANN_ERROR(l.get_type(),
-                " layer \"",
-                l.get_name(),
-                "\" ",
-                "has non-contiguous data buffers");
-  }
   // Matrix dimensions
   const auto input0_dims = l.get_input_dims(0);
   const auto input1_dims = l.get_input_dims(1);
   const auto output_dims = l.get_output_dims();
-
-  // Check if matrix is 3D or 2D
-  const El::Int mat_depth =
-    (input0_dims.size() > 2) ? *(input0_dims.rbegin() + 2) : 1;
-
+  const El::Int depth = get_depth(input0_dims, input1_dims);
   const El::Int input0_height = *(input0_dims.rbegin() + 1);
   const El::Int input0_width = *(input0_dims.rbegin());
   const El::Int input1_height = *(input1_dims.rbegin() + 1);
   const El::Int input1_width = *(input1_dims.rbegin());
   const El::Int output_height = *(output_dims.rbegin() + 1);
   const El::Int output_width = *(output_dims.rbegin());
-
-  const auto num_matrices = mat_depth * local_mini_batch_size;
-  const auto input0_stride = input0_height * input0_width;
-  const auto input1_stride = input1_height * input1_width;
-  const auto output_stride = output_height * output_width;
-
-  const auto input0_grad_stride = input0_stride;
-  const auto input1_grad_stride = input1_stride;
-  const auto output_grad_stride = output_stride;
+  const auto input0 =
+    get_locked_strided_matrices(local_input0, input0_dims, depth);
+  const auto input1 =
+    get_locked_strided_matrices(local_input1, input1_dims, depth);
+  const auto output_grad =
+    get_locked_strided_matrices(local_output_grad, output_dims, depth);
 
   // Compute gradients for each mini-batch sample
-  // Note: cuBLAS expects matrices in Fortran layout while LBANN
-  // tensors are in C layout.
+  // Note: BLAS expects matrices in Fortran layout while LBANN
+  // tensors are in C layout. Gradients w.r.t. broadcast inputs are
+  // summed over the first tensor dimension.
   {
-    using namespace hydrogen;
-    // The SyncInfo of the C matrix leads the way!
-    auto multisync = MakeMultiSync(gpu::get_sync_info(local_input0_grad),
-                                   gpu::get_sync_info(local_input1),
-                                   gpu::get_sync_info(local_output_grad));
-
+    auto sync_info =
+      get_gemm_sync_info(local_input0_grad, local_input1, local_output_grad);
+    const auto input0_grad =
+      get_strided_matrices(local_input0_grad, input0_dims, depth);
     if (transpose_input0) {
-      gpu_blas::GemmStridedBatched(TransposeMode::TRANSPOSE,
-                                   transpose_input1 ? TransposeMode::TRANSPOSE
-                                                    : TransposeMode::NORMAL,
-                                   input0_width,
-                                   input0_height,
-                                   output_width,
-                                   El::TypeTraits<TensorDataType>::One(),
-                                   local_output_grad.LockedBuffer(),
-                                   output_width,
-                                   output_grad_stride,
-                                   local_input1.LockedBuffer(),
-                                   input1_width,
-                                   input1_stride,
-                                   El::TypeTraits<TensorDataType>::Zero(),
-                                   local_input0_grad.Buffer(),
-                                   input0_width,
-                                   input0_grad_stride,
-                                   num_matrices,
-                                   multisync);
+      batched_gemm(El::TRANSPOSE,
+                   transpose_input1 ? El::TRANSPOSE : El::NORMAL,
+                   input0_width,
+                   input0_height,
+                   output_width,
+                   output_grad,
+                   input1,
+                   input0_grad,
+                   depth,
+                   local_mini_batch_size,
+                   sync_info);
     }
     else {
-      gpu_blas::GemmStridedBatched(transpose_input1 ? TransposeMode::NORMAL
-                                                    : TransposeMode::TRANSPOSE,
-                                   TransposeMode::NORMAL,
-                                   input0_width,
-                                   input0_height,
-                                   output_width,
-                                   El::TypeTraits<TensorDataType>::One(),
-                                   local_input1.LockedBuffer(),
-                                   input1_width,
-                                   input1_stride,
-                                   local_output_grad.LockedBuffer(),
-                                   output_width,
-                                   output_grad_stride,
-                                   El::TypeTraits<TensorDataType>::Zero(),
-                                   local_input0_grad.Buffer(),
-                                   input0_width,
-                                   input0_grad_stride,
-                                   num_matrices,
-                                   multisync);
+      batched_gemm(transpose_input1 ? El::NORMAL : El::TRANSPOSE,
+                   El::NORMAL,
+                   input0_width,
+                   input0_height,
+                   output_width,
+                   input1,
+                   output_grad,
+                   input0_grad,
+                   depth,
+                   local_mini_batch_size,
+                   sync_info);
     }
   }
   {
-    using namespace hydrogen;
-    // The SyncInfo of the C matrix leads the way!
-    auto multisync = MakeMultiSync(gpu::get_sync_info(local_input1_grad),
-                                   gpu::get_sync_info(local_input0),
-                                   gpu::get_sync_info(local_output_grad));
+    auto sync_info =
+      get_gemm_sync_info(local_input1_grad, local_input0, local_output_grad);
+    const auto input1_grad =
+      get_strided_matrices(local_input1_grad, input1_dims, depth);
     if (transpose_input1) {
-      gpu_blas::GemmStridedBatched(transpose_input0 ? TransposeMode::TRANSPOSE
-                                                    : TransposeMode::NORMAL,
-                                   TransposeMode::TRANSPOSE,
-                                   input1_width,
-                                   input1_height,
-                                   output_height,
-                                   El::TypeTraits<TensorDataType>::One(),
-                                   local_input0.LockedBuffer(),
-                                   input0_width,
-                                   input0_stride,
-                                   local_output_grad.LockedBuffer(),
-                                   output_width,
-                                   output_grad_stride,
-                                   El::TypeTraits<TensorDataType>::Zero(),
-                                   local_input1_grad.Buffer(),
-                                   input1_width,
-                                   input1_grad_stride,
-                                   num_matrices,
-                                   multisync);
+      batched_gemm(transpose_input0 ? El::TRANSPOSE : El::NORMAL,
+                   El::TRANSPOSE,
+                   input1_width,
+                   input1_height,
+                   output_height,
+                   input0,
+                   output_grad,
+                   input1_grad,
+                   depth,
+                   local_mini_batch_size,
+                   sync_info);
     }
     else {
-      gpu_blas::GemmStridedBatched(TransposeMode::NORMAL,
-                                   transpose_input0 ? TransposeMode::NORMAL
-                                                    : TransposeMode::TRANSPOSE,
-                                   input1_width,
-                                   input1_height,
-                                   output_height,
-                                   El::TypeTraits<TensorDataType>::One(),
-                                   local_output_grad.LockedBuffer(),
-                                   output_width,
-                                   output_grad_stride,
-                                   local_input0.LockedBuffer(),
-                                   input0_width,
-                                   input0_stride,
-                                   El::TypeTraits<TensorDataType>::Zero(),
-                                   local_input1_grad.Buffer(),
-                                   input1_width,
-                                   input1_grad_stride,
-                                   num_matrices,
-                                   multisync);
+      batched_gemm(El::NORMAL,
+                   transpose_input0 ? El::NORMAL : El::TRANSPOSE,
+                   input1_width,
+                   input1_height,
+                   output_height,
+                   output_grad,
+                   input0,
+                   input1_grad,
+                   depth,
+                   local_mini_batch_size,
+                   sync_info);
     }
   }
 }
-#endif // LBANN_HAS_GPU
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void matmul_layer<TensorDataType, Layout, Device>::setup_dims(
@@ -645,30 +572,38 @@ void matmul_layer<TensorDataType, Layout, Device>::setup_dims(
   };
 
   // Check input dimensions
-  if (input0_dims.size() != input1_dims.size()) {
-    LBANN_ERROR("input tensors in ",
-                print_name(),
-                " "
-                "have different numbers of dimensions ",
-                "(",
-                print_inputs(),
-                ")");
+  // Note: A 2D input, or a 3D input with a first dimension of one, is
+  // broadcast over the first dimension of the other input.
+  for (const auto& dims : {input0_dims, input1_dims}) {
+    if (dims.size() != 2 && dims.size() != 3) {
+      LBANN_ERROR("input tensors in ",
+                  print_name(),
+                  " are not 2D or 3D",
+                  "(",
+                  print_inputs(),
+                  ")");
+    }
   }
-
-  if (input0_dims.size() != 2 && input0_dims.size() != 3) {
+  const auto input0_depth = (input0_dims.size() > 2) ? input0_dims[0] : 1;
+  const auto input1_depth = (input1_dims.size() > 2) ? input1_dims[0] : 1;
+  if (input0_depth != input1_depth && input0_depth != 1 &&
+      input1_depth != 1) {
     LBANN_ERROR("input tensors in ",
                 print_name(),
-                " are not 2D or 3D",
+                " ",
+                "have incompatible first dimensions ",
                 "(",
                 print_inputs(),
                 ")");
   }
 #ifdef LBANN_HAS_DISTCONV
   if (this->distconv_enabled()) {
-    if (input0_dims.size() != 3) {
+    if (input0_dims.size() != 3 || input1_dims.size() != 3 ||
+        input0_depth != input1_depth) {
       LBANN_ERROR("input tensors in ",
                   print_name(),
-                  " must be 3D when distconv is enabled",
+                  " must be 3D with matching first dimensions ",
+                  "when distconv is enabled",
                   "(",
                   print_inputs(),
                   ")");
@@ -695,7 +630,11 @@ void matmul_layer<TensorDataType, Layout, Device>::setup_dims(
   }
 
   // Set output dimensions
-  std::vector<int> output_dims(input0_dims);
+  std::vector<int> output_dims(
+    input0_dims.size() >= input1_dims.size() ? input0_dims : input1_dims);
+  if (output_dims.size() > 2) {
+    output_dims[0] = std::max(input0_depth, input1_depth);
+  }
   *(output_dims.rbegin() + 1) = (m_transpose_a ? input0_width : input0_height);
   *(output_dims.rbegin()) = (m_transpose_b ? input1_height : input1_width);
   this->set_output_dims(output_dims);
@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_ARGMIN_LAYER_INSTANTIATE
+#include "lbann/layers/misc/argmin_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Whether (a, a_index) comes before (b, b_index): a minimum value,
+ *  with ties going to the lower index. */
+template <typename TensorDataType>
+__device__ __forceinline__ bool is_better(const TensorDataType& a,
+                                          El::Int a_index,
+                                          const TensorDataType& b,
+                                          El::Int b_index)
+{
+  return (a < b) || (!(b < a) && a_index < b_index);
+}
+
+/** Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: 1 x min(width, max_grid_y) x 1
+ *
+ *  Each block finds the minimum entry of whole columns.
+ */
+template <typename TensorDataType, El::Int bsize>
+__global__ void fp_kernel(El::Int height,
+                          El::Int width,
+                          const TensorDataType* __restrict__ input,
+                          El::Int input_ldim,
+                          TensorDataType* __restrict__ output,
+                          El::Int output_ldim)
+{
+  const El::Int tid = threadIdx.x;
+  __shared__ TensorDataType shared_vals[bsize];
+  __shared__ El::Int shared_inds[bsize];
+  for (El::Int col = blockIdx.y; col < width; col += gridDim.y) {
+
+    // Find minimum entry in each thread's rows
+    TensorDataType best_val = input[col * input_ldim];
+    El::Int best_ind = 0;
+    for (El::Int row = tid; row < height; row += bsize) {
+      const auto& val = input[row + col * input_ldim];
+      if (is_better(val, row, best_val, best_ind)) {
+        best_val = val;
+        best_ind = row;
+      }
+    }
+
+    // Shared memory reduction to get minimum entry of column
+    shared_vals[tid] = best_val;
+    shared_inds[tid] = best_ind;
+    for (El::Int stride = bsize / 2; stride > 0; stride /= 2) {
+      __syncthreads();
+      if (tid < stride) {
+        const auto& val = shared_vals[tid + stride];
+        const auto& ind = shared_inds[tid + stride];
+        if (is_better(val, ind, shared_vals[tid], shared_inds[tid])) {
+          shared_vals[tid] = val;
+          shared_inds[tid] = ind;
+        }
+      }
+    }
+    if (tid == 0) {
+      output[col * output_ldim] = TensorDataType(shared_inds[0]);
+    }
+    __syncthreads();
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void argmin_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+  const auto& local_input =
+    dynamic_cast<const GPUMatType&>(this->get_local_prev_activations());
+  auto& local_output = dynamic_cast<GPUMatType&>(this->get_local_activations());
+  const El::Int local_height = local_input.Height();
+  const El::Int local_width = local_input.Width();
+  if (local_height <= 0 || local_width <= 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.y = std::min(local_width, El::Int(65535));
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                     gpu::get_sync_info(local_input));
+  hydrogen::gpu::LaunchKernel(fp_kernel<TensorDataType, block_size>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              local_height,
+                              local_width,
+                              local_input.LockedBuffer(),
+                              local_input.LDim(),
+                              local_output.Buffer(),
+                              local_output.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template class argmin_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_ATTENTION_LAYER_INSTANTIATE
+#include "lbann/layers/misc/attention_impl.hpp"
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace lbann {
+
+namespace {
+
+/** Dot product of two vectors. */
+template <typename AccT, typename T>
+AccT dot(El::Int size, const T* __restrict__ x, const T* __restrict__ y)
+{
+  AccT sum = 0;
+  for (El::Int k = 0; k < size; ++k) {
+    sum += static_cast<AccT>(x[k]) * static_cast<AccT>(y[k]);
+  }
+  return sum;
+}
+
+} // namespace
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::fp_block(
+  const LocalMat& queries,
+  const LocalMat& keys,
+  const LocalMat& values,
+  bool causal,
+  LocalMat& output,
+  LocalAccMat& logsumexp)
+{
+  using AccT = AccumulateDataType;
+
+  // Dimensions
+  const El::Int vector_size = this->get_input_dims(0)[1];
+  const El::Int num_queries = queries.Height() / vector_size;
+  const El::Int num_keys = keys.Height() / vector_size;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = vector_size / num_heads;
+  const El::Int local_mini_batch_size = queries.Width();
+  const AccT scale = AccT(1) / std::sqrt(static_cast<AccT>(head_size));
+  logsumexp.Resize(num_queries * num_heads, local_mini_batch_size);
+
+  // Online softmax over keys for each query
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < local_mini_batch_size; ++j) {
+    for (El::Int h = 0; h < num_heads; ++h) {
+      std::vector<AccT> acc(head_size);
+      const El::Int offset = h * head_size;
+      for (El::Int i = 0; i < num_queries; ++i) {
+        const auto* q = queries.LockedBuffer(i * vector_size + offset, j);
+        AccT maxval = -std::numeric_limits<AccT>::infinity();
+        AccT denom = 0;
+        std::fill(acc.begin(), acc.end(), AccT(0));
+        const El::Int key_end = causal ? std::min(i + 1, num_keys) : num_keys;
+        for (El::Int k = 0; k < key_end; ++k) {
+          const auto* key = keys.LockedBuffer(k * vector_size + offset, j);
+          const auto* v = values.LockedBuffer(k * vector_size + offset, j);
+          const AccT s = scale * dot<AccT>(head_size, q, key);
+          if (s > maxval) {
+            const AccT rescale = std::exp(maxval - s);
+            denom *= rescale;
+            for (auto& a : acc) {
+              a *= rescale;
+            }
+            maxval = s;
+          }
+          const AccT p = std::exp(s - maxval);
+          denom += p;
+          for (El::Int d = 0; d < head_size; ++d) {
+            acc[d] += p * static_cast<AccT>(v[d]);
+          }
+        }
+        auto* y = output.Buffer(i * vector_size + offset, j);
+        for (El::Int d = 0; d < head_size; ++d) {
+          y[d] = denom > AccT(0) ? static_cast<TensorDataType>(acc[d] / denom)
+                                 : El::TypeTraits<TensorDataType>::Zero();
+        }
+        logsumexp(i * num_heads + h, j) =
+          denom > AccT(0) ? maxval + std::log(denom)
+                          : std::numeric_limits<AccT>::infinity();
+      }
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::fp_merge(
+  const LocalMat& block_output,
+  const LocalAccMat& block_logsumexp,
+  LocalMat& output,
+  LocalAccMat& logsumexp)
+{
+  using AccT = AccumulateDataType;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = this->get_input_dims(0)[1] / num_heads;
+  const El::Int num_vectors = logsumexp.Height();
+  const El::Int local_mini_batch_size = logsumexp.Width();
+  constexpr AccT inf = std::numeric_limits<AccT>::infinity();
+
+  // Weight outputs by their share of the softmax denominator
+  //   lse = log(exp(lse_a) + exp(lse_b))
+  //   y = exp(lse_a - lse) y_a + exp(lse_b - lse) y_b
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < local_mini_batch_size; ++j) {
+    for (El::Int idx = 0; idx < num_vectors; ++idx) {
+      const AccT a = logsumexp(idx, j);
+      const AccT b = block_logsumexp(idx, j);
+      if (b == inf) {
+        continue;
+      }
+      const auto* y_b = block_output.LockedBuffer(idx * head_size, j);
+      auto* y = output.Buffer(idx * head_size, j);
+      if (a == inf) {
+        std::copy(y_b, y_b + head_size, y);
+        logsumexp(idx, j) = b;
+        continue;
+      }
+      const AccT maxval = std::max(a, b);
+      const AccT w_a = std::exp(a - maxval);
+      const AccT w_b = std::exp(b - maxval);
+      const AccT denom = w_a + w_b;
+      for (El::Int d = 0; d < head_size; ++d) {
+        y[d] = static_cast<TensorDataType>(
+          (w_a * static_cast<AccT>(y[d]) + w_b * static_cast<AccT>(y_b[d])) /
+          denom);
+      }
+      logsumexp(idx, j) = maxval + std::log(denom);
+    }
+  }
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::bp_dots(
+  const LocalMat& output,
+  const LocalMat& output_grad,
+  LocalAccMat& dots)
+{
+  using AccT = AccumulateDataType;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = this->get_input_dims(0)[1] / num_heads;
+  const El::Int num_vectors = output.Height() / head_size;
+  const El::Int local_mini_batch_size = output.Width();
+  dots.Resize(num_vectors, local_mini_batch_size);
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < local_mini_batch_size; ++j) {
+    for (El::Int idx = 0; idx < num_vectors; ++idx) {
+      dots(idx, j) = dot<AccT>(head_size,
+                               output_grad.LockedBuffer(idx * head_size, j),
+                               output.LockedBuffer(idx * head_size, j));
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::bp_block(
+  const LocalMat& queries,
+  const LocalMat& keys,
+  const LocalMat& values,
+  const LocalMat& output_grad,
+  const LocalAccMat& dots,
+  bool causal,
+  bool accumulate,
+  LocalMat& queries_grad,
+  LocalMat& keys_grad,
+  LocalMat& values_grad)
+{
+  using AccT = AccumulateDataType;
+
+  // Dimensions
+  const El::Int vector_size = this->get_input_dims(0)[1];
+  const El::Int num_queries = queries.Height() / vector_size;
+  const El::Int num_keys = keys.Height() / vector_size;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = vector_size / num_heads;
+  const El::Int local_mini_batch_size = queries.Width();
+  const AccT scale = AccT(1) / std::sqrt(static_cast<AccT>(head_size));
+
+  // Recompute attention probabilities from log-sum-exp
+  //   dV_k = sum_i p_ik dY_i
+  //   dS_ik = p_ik (dY_i . V_k - dY_i . Y_i)
+  //   dQ_i = scale * sum_k dS_ik K_k
+  //   dK_k = scale * sum_i dS_ik Q_i
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < local_mini_batch_size; ++j) {
+    for (El::Int h = 0; h < num_heads; ++h) {
+      std::vector<AccT> dq(head_size);
+      std::vector<AccT> dk(num_keys * head_size, AccT(0));
+      std::vector<AccT> dv(num_keys * head_size, AccT(0));
+      const El::Int offset = h * head_size;
+      for (El::Int i = 0; i < num_queries; ++i) {
+        const auto* q = queries.LockedBuffer(i * vector_size + offset, j);
+        const auto* dy =
+          output_grad.LockedBuffer(i * vector_size + offset, j);
+        const AccT lse = m_logsumexp(i * num_heads + h, j);
+        const AccT dy_dot_y = dots(i * num_heads + h, j);
+        std::fill(dq.begin(), dq.end(), AccT(0));
+        const El::Int key_end = causal ? std::min(i + 1, num_keys) : num_keys;
+        for (El::Int k = 0; k < key_end; ++k) {
+          const auto* key = keys.LockedBuffer(k * vector_size + offset, j);
+          const auto* v = values.LockedBuffer(k * vector_size + offset, j);
+          const AccT p =
+            std::exp(scale * dot<AccT>(head_size, q, key) - lse);
+          const AccT ds = p * (dot<AccT>(head_size, dy, v) - dy_dot_y);
+          for (El::Int d = 0; d < head_size; ++d) {
+            dv[k * head_size + d] += p * static_cast<AccT>(dy[d]);
+            dk[k * head_size + d] += scale * ds * static_cast<AccT>(q[d]);
+            dq[d] += scale * ds * static_cast<AccT>(key[d]);
+          }
+        }
+        auto* dq_out = queries_grad.Buffer(i * vector_size + offset, j);
+        for (El::Int d = 0; d < head_size; ++d) {
+          dq_out[d] = static_cast<TensorDataType>(
+            accumulate ? static_cast<AccT>(dq_out[d]) + dq[d] : dq[d]);
+        }
+      }
+      for (El::Int k = 0; k < num_keys; ++k) {
+        auto* dk_out = keys_grad.Buffer(k * vector_size + offset, j);
+        auto* dv_out = values_grad.Buffer(k * vector_size + offset, j);
+        for (El::Int d = 0; d < head_size; ++d) {
+          AccT dk_kd = dk[k * head_size + d];
+          AccT dv_kd = dv[k * head_size + d];
+          if (accumulate) {
+            dk_kd += static_cast<AccT>(dk_out[d]);
+            dv_kd += static_cast<AccT>(dv_out[d]);
+          }
+          dk_out[d] = static_cast<TensorDataType>(dk_kd);
+          dv_out[d] = static_cast<TensorDataType>(dv_kd);
+        }
+      }
+    }
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class attention_layer<T, data_layout::DATA_PARALLEL, El::Device::CPU>
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
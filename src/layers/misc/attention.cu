@@ -0,0 +1,897 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_ATTENTION_LAYER_INSTANTIATE
+#include "lbann/layers/misc/attention_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Maximum shared memory per block for attention kernels. */
+constexpr size_t max_shared_memory = 48 * 1024;
+
+/** @brief Choose number of rows in a tile.
+ *
+ *  Each block holds @c padded_rows tiles with padded rows and
+ *  @c rows tiles with unpadded rows in shared memory. The tile size is
+ *  also the block size.
+ */
+template <typename AccT>
+size_t
+get_tile_size(size_t padded_rows, size_t rows, size_t head_size, size_t extra)
+{
+  const size_t row_size =
+    (padded_rows * (head_size + 1) + rows * head_size + extra) * sizeof(AccT);
+  size_t tile_size = 64;
+  while (tile_size > 1 && tile_size * row_size > max_shared_memory) {
+    tile_size /= 2;
+  }
+  if (tile_size * row_size > max_shared_memory) {
+    LBANN_ERROR("attention head size (",
+                head_size,
+                ") is too large for GPU shared memory");
+  }
+  return tile_size;
+}
+
+/** @brief Load vectors for one head into a shared memory tile.
+ *
+ *  Rows past @c num_rows are filled with zeros.
+ */
+template <typename T, typename AccT>
+__device__ __forceinline__ void load_tile(El::Int row_start,
+                                          El::Int num_rows,
+                                          El::Int tile_size,
+                                          El::Int head_size,
+                                          El::Int vector_size,
+                                          const T* __restrict__ x,
+                                          AccT* __restrict__ tile,
+                                          El::Int tile_ldim)
+{
+  for (El::Int idx = threadIdx.x; idx < tile_size * head_size;
+       idx += blockDim.x) {
+    const El::Int row = idx / head_size;
+    const El::Int d = idx % head_size;
+    const El::Int i = row_start + row;
+    tile[row * tile_ldim + d] =
+      (i < num_rows ? static_cast<AccT>(x[i * vector_size + d]) : AccT(0));
+  }
+}
+
+template <typename AccT>
+__device__ __forceinline__ AccT dot(El::Int size,
+                                    const AccT* __restrict__ x,
+                                    const AccT* __restrict__ y)
+{
+  AccT sum = 0;
+  for (El::Int d = 0; d < size; ++d) {
+    sum += x[d] * y[d];
+  }
+  return sum;
+}
+
+/** @brief Forward prop
+ *
+ *  Each thread computes the output for one query with an online
+ *  softmax over tiles of keys and values.
+ *
+ *  Block dimensions: tile_size x 1 x 1
+ *
+ *  Grid dimensions: (num_queries / tile_size) x num_heads x mini_batch_size
+ */
+template <typename T, typename AccT>
+__global__ void fp_kernel(El::Int num_queries,
+                          El::Int num_keys,
+                          El::Int num_heads,
+                          El::Int head_size,
+                          El::Int mini_batch_size,
+                          bool causal,
+                          AccT scale,
+                          const T* __restrict__ queries,
+                          El::Int queries_ldim,
+                          const T* __restrict__ keys,
+                          El::Int keys_ldim,
+                          const T* __restrict__ values,
+                          El::Int values_ldim,
+                          T* __restrict__ output,
+                          El::Int output_ldim,
+                          AccT* __restrict__ logsumexp,
+                          El::Int logsumexp_ldim)
+{
+  extern __shared__ __align__(16) unsigned char shared_buffer[];
+  const El::Int tile_size = blockDim.x;
+  const El::Int ldim = head_size + 1;
+  auto* q_tile = reinterpret_cast<AccT*>(shared_buffer);
+  auto* acc_tile = q_tile + tile_size * ldim;
+  auto* k_tile = acc_tile + tile_size * ldim;
+  auto* v_tile = k_tile + tile_size * head_size;
+  auto* q = &q_tile[threadIdx.x * ldim];
+  auto* acc = &acc_tile[threadIdx.x * ldim];
+  const El::Int vector_size = num_heads * head_size;
+
+  for (El::Int j = blockIdx.z; j < mini_batch_size; j += gridDim.z) {
+    for (El::Int h = blockIdx.y; h < num_heads; h += gridDim.y) {
+      const El::Int offset = h * head_size;
+      for (El::Int query_start = blockIdx.x * tile_size;
+           query_start < num_queries;
+           query_start += gridDim.x * tile_size) {
+        const El::Int i = query_start + threadIdx.x;
+        const bool active = (i < num_queries);
+
+        // Load queries
+        __syncthreads();
+        load_tile(query_start,
+                  num_queries,
+                  tile_size,
+                  head_size,
+                  vector_size,
+                  &queries[offset + j * queries_ldim],
+                  q_tile,
+                  ldim);
+        for (El::Int d = 0; d < head_size; ++d) {
+          acc[d] = AccT(0);
+        }
+
+        // Online softmax over tiles of keys
+        AccT maxval = -gpu_lib::infinity<AccT>();
+        AccT denom = 0;
+        const El::Int key_end =
+          (causal ? gpu_lib::min(num_keys, query_start + tile_size)
+                  : num_keys);
+        for (El::Int key_start = 0; key_start < key_end;
+             key_start += tile_size) {
+          __syncthreads();
+          load_tile(key_start,
+                    num_keys,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &keys[offset + j * keys_ldim],
+                    k_tile,
+                    head_size);
+          load_tile(key_start,
+                    num_keys,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &values[offset + j * values_ldim],
+                    v_tile,
+                    head_size);
+          __syncthreads();
+          if (!active) {
+            continue;
+          }
+          El::Int tile_end = gpu_lib::min(tile_size, num_keys - key_start);
+          if (causal) {
+            tile_end = gpu_lib::min(tile_end, i - key_start + 1);
+          }
+          for (El::Int k = 0; k < tile_end; ++k) {
+            const AccT s = scale * dot(head_size, q, &k_tile[k * head_size]);
+            if (s > maxval) {
+              const AccT rescale = gpu_lib::exp(maxval - s);
+              denom *= rescale;
+              for (El::Int d = 0; d < head_size; ++d) {
+                acc[d] *= rescale;
+              }
+              maxval = s;
+            }
+            const AccT p = gpu_lib::exp(s - maxval);
+            denom += p;
+            for (El::Int d = 0; d < head_size; ++d) {
+              acc[d] += p * v_tile[k * head_size + d];
+            }
+          }
+        }
+
+        // Write output and log-sum-exp
+        if (active) {
+          auto* y = &output[i * vector_size + offset + j * output_ldim];
+          for (El::Int d = 0; d < head_size; ++d) {
+            y[d] = static_cast<T>(denom > AccT(0) ? acc[d] / denom : AccT(0));
+          }
+          logsumexp[i * num_heads + h + j * logsumexp_ldim] =
+            (denom > AccT(0) ? maxval + gpu_lib::log(denom)
+                             : gpu_lib::infinity<AccT>());
+        }
+      }
+    }
+  }
+}
+
+/** @brief Merge the attention to another block into the output
+ *
+ *  Outputs are weighted by their share of the softmax denominator:
+ *    lse = log(exp(lse_a) + exp(lse_b))
+ *    y = exp(lse_a - lse) y_a + exp(lse_b - lse) y_b
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (num_vectors / bsize) x mini_batch_size x 1
+ */
+template <typename T, typename AccT>
+__global__ void fp_merge_kernel(El::Int num_vectors,
+                                El::Int head_size,
+                                El::Int mini_batch_size,
+                                const T* __restrict__ block_output,
+                                El::Int block_output_ldim,
+                                const AccT* __restrict__ block_logsumexp,
+                                El::Int block_logsumexp_ldim,
+                                T* __restrict__ output,
+                                El::Int output_ldim,
+                                AccT* __restrict__ logsumexp,
+                                El::Int logsumexp_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  const AccT inf = gpu_lib::infinity<AccT>();
+  for (El::Int j = blockIdx.y; j < mini_batch_size; j += gridDim.y) {
+    for (El::Int idx = gidx; idx < num_vectors; idx += nthreadsx) {
+      const AccT a = logsumexp[idx + j * logsumexp_ldim];
+      const AccT b = block_logsumexp[idx + j * block_logsumexp_ldim];
+      if (b == inf) {
+        continue;
+      }
+      const auto* y_b = &block_output[idx * head_size + j * block_output_ldim];
+      auto* y = &output[idx * head_size + j * output_ldim];
+      if (a == inf) {
+        for (El::Int d = 0; d < head_size; ++d) {
+          y[d] = y_b[d];
+        }
+        logsumexp[idx + j * logsumexp_ldim] = b;
+        continue;
+      }
+      const AccT maxval = gpu_lib::max(a, b);
+      const AccT w_a = gpu_lib::exp(a - maxval);
+      const AccT w_b = gpu_lib::exp(b - maxval);
+      const AccT denom = w_a + w_b;
+      for (El::Int d = 0; d < head_size; ++d) {
+        y[d] = static_cast<T>((w_a * static_cast<AccT>(y[d]) +
+                               w_b * static_cast<AccT>(y_b[d])) /
+                              denom);
+      }
+      logsumexp[idx + j * logsumexp_ldim] = maxval + gpu_lib::log(denom);
+    }
+  }
+}
+
+/** @brief Dot products between outputs and output gradients
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (num_queries * num_heads / bsize) x mini_batch_size x 1
+ */
+template <typename T, typename AccT>
+__global__ void bp_dot_kernel(El::Int num_queries,
+                              El::Int num_heads,
+                              El::Int head_size,
+                              El::Int mini_batch_size,
+                              const T* __restrict__ output,
+                              El::Int output_ldim,
+                              const T* __restrict__ output_grad,
+                              El::Int output_grad_ldim,
+                              AccT* __restrict__ dots,
+                              El::Int dots_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  for (El::Int j = blockIdx.y; j < mini_batch_size; j += gridDim.y) {
+    for (El::Int idx = gidx; idx < num_queries * num_heads;
+         idx += nthreadsx) {
+      const auto* y = &output[idx * head_size + j * output_ldim];
+      const auto* dy = &output_grad[idx * head_size + j * output_grad_ldim];
+      AccT sum = 0;
+      for (El::Int d = 0; d < head_size; ++d) {
+        sum += static_cast<AccT>(y[d]) * static_cast<AccT>(dy[d]);
+      }
+      dots[idx + j * dots_ldim] = sum;
+    }
+  }
+}
+
+/** @brief Backprop for keys and values
+ *
+ *  Each thread accumulates the gradients for one key and value over
+ *  tiles of queries, recomputing the attention probabilities. If
+ *  @c accumulate is true, then the gradients are added to the
+ *  existing ones.
+ *
+ *  Block dimensions: tile_size x 1 x 1
+ *
+ *  Grid dimensions: (num_keys / tile_size) x num_heads x mini_batch_size
+ */
+template <typename T, typename AccT>
+__global__ void bp_keys_kernel(El::Int num_queries,
+                               El::Int num_keys,
+                               El::Int num_heads,
+                               El::Int head_size,
+                               El::Int mini_batch_size,
+                               bool causal,
+                               bool accumulate,
+                               AccT scale,
+                               const T* __restrict__ queries,
+                               El::Int queries_ldim,
+                               const T* __restrict__ keys,
+                               El::Int keys_ldim,
+                               const T* __restrict__ values,
+                               El::Int values_ldim,
+                               const T* __restrict__ output_grad,
+                               El::Int output_grad_ldim,
+                               const AccT* __restrict__ logsumexp,
+                               const AccT* __restrict__ dots,
+                               El::Int stats_ldim,
+                               T* __restrict__ keys_grad,
+                               El::Int keys_grad_ldim,
+                               T* __restrict__ values_grad,
+                               El::Int values_grad_ldim)
+{
+  extern __shared__ __align__(16) unsigned char shared_buffer[];
+  const El::Int tile_size = blockDim.x;
+  const El::Int ldim = head_size + 1;
+  auto* k_tile = reinterpret_cast<AccT*>(shared_buffer);
+  auto* v_tile = k_tile + tile_size * ldim;
+  auto* dk_tile = v_tile + tile_size * ldim;
+  auto* dv_tile = dk_tile + tile_size * ldim;
+  auto* q_tile = dv_tile + tile_size * ldim;
+  auto* dy_tile = q_tile + tile_size * head_size;
+  auto* lse_tile = dy_tile + tile_size * head_size;
+  auto* dots_tile = lse_tile + tile_size;
+  auto* key = &k_tile[threadIdx.x * ldim];
+  auto* v = &v_tile[threadIdx.x * ldim];
+  auto* dk = &dk_tile[threadIdx.x * ldim];
+  auto* dv = &dv_tile[threadIdx.x * ldim];
+  const El::Int vector_size = num_heads * head_size;
+
+  for (El::Int j = blockIdx.z; j < mini_batch_size; j += gridDim.z) {
+    for (El::Int h = blockIdx.y; h < num_heads; h += gridDim.y) {
+      const El::Int offset = h * head_size;
+      for (El::Int key_start = blockIdx.x * tile_size; key_start < num_keys;
+           key_start += gridDim.x * tile_size) {
+        const El::Int k = key_start + threadIdx.x;
+        const bool active = (k < num_keys);
+
+        // Load keys and values
+        __syncthreads();
+        load_tile(key_start,
+                  num_keys,
+                  tile_size,
+                  head_size,
+                  vector_size,
+                  &keys[offset + j * keys_ldim],
+                  k_tile,
+                  ldim);
+        load_tile(key_start,
+                  num_keys,
+                  tile_size,
+                  head_size,
+                  vector_size,
+                  &values[offset + j * values_ldim],
+                  v_tile,
+                  ldim);
+        for (El::Int d = 0; d < head_size; ++d) {
+          dk[d] = AccT(0);
+          dv[d] = AccT(0);
+        }
+
+        // Accumulate gradients over tiles of queries
+        // Note: With a causal mask, earlier queries don't attend to
+        // this tile of keys.
+        const El::Int query_begin = (causal ? key_start : 0);
+        for (El::Int query_start = query_begin; query_start < num_queries;
+             query_start += tile_size) {
+          __syncthreads();
+          load_tile(query_start,
+                    num_queries,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &queries[offset + j * queries_ldim],
+                    q_tile,
+                    head_size);
+          load_tile(query_start,
+                    num_queries,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &output_grad[offset + j * output_grad_ldim],
+                    dy_tile,
+                    head_size);
+          for (El::Int row = threadIdx.x; row < tile_size; row += blockDim.x) {
+            const El::Int i = query_start + row;
+            const El::Int stats_idx = i * num_heads + h + j * stats_ldim;
+            lse_tile[row] =
+              (i < num_queries ? logsumexp[stats_idx]
+                               : gpu_lib::infinity<AccT>());
+            dots_tile[row] = (i < num_queries ? dots[stats_idx] : AccT(0));
+          }
+          __syncthreads();
+          if (!active) {
+            continue;
+          }
+          const El::Int tile_end =
+            gpu_lib::min(tile_size, num_queries - query_start);
+          for (El::Int row = 0; row < tile_end; ++row) {
+            if (causal && k > query_start + row) {
+              continue;
+            }
+            const auto* q = &q_tile[row * head_size];
+            const auto* dy = &dy_tile[row * head_size];
+            const AccT p =
+              gpu_lib::exp(scale * dot(head_size, q, key) - lse_tile[row]);
+            const AccT ds = p * (dot(head_size, dy, v) - dots_tile[row]);
+            for (El::Int d = 0; d < head_size; ++d) {
+              dv[d] += p * dy[d];
+              dk[d] += scale * ds * q[d];
+            }
+          }
+        }
+
+        // Write gradients
+        if (active) {
+          auto* dk_out =
+            &keys_grad[k * vector_size + offset + j * keys_grad_ldim];
+          auto* dv_out =
+            &values_grad[k * vector_size + offset + j * values_grad_ldim];
+          for (El::Int d = 0; d < head_size; ++d) {
+            AccT dk_d = dk[d];
+            AccT dv_d = dv[d];
+            if (accumulate) {
+              dk_d += static_cast<AccT>(dk_out[d]);
+              dv_d += static_cast<AccT>(dv_out[d]);
+            }
+            dk_out[d] = static_cast<T>(dk_d);
+            dv_out[d] = static_cast<T>(dv_d);
+          }
+        }
+      }
+    }
+  }
+}
+
+/** @brief Backprop for queries
+ *
+ *  Each thread accumulates the gradient for one query over tiles of
+ *  keys and values, recomputing the attention probabilities. If
+ *  @c accumulate is true, then the gradient is added to the existing
+ *  one.
+ *
+ *  Block dimensions: tile_size x 1 x 1
+ *
+ *  Grid dimensions: (num_queries / tile_size) x num_heads x mini_batch_size
+ */
+template <typename T, typename AccT>
+__global__ void bp_queries_kernel(El::Int num_queries,
+                                  El::Int num_keys,
+                                  El::Int num_heads,
+                                  El::Int head_size,
+                                  El::Int mini_batch_size,
+                                  bool causal,
+                                  bool accumulate,
+                                  AccT scale,
+                                  const T* __restrict__ queries,
+                                  El::Int queries_ldim,
+                                  const T* __restrict__ keys,
+                                  El::Int keys_ldim,
+                                  const T* __restrict__ values,
+                                  El::Int values_ldim,
+                                  const T* __restrict__ output_grad,
+                                  El::Int output_grad_ldim,
+                                  const AccT* __restrict__ logsumexp,
+                                  const AccT* __restrict__ dots,
+                                  El::Int stats_ldim,
+                                  T* __restrict__ queries_grad,
+                                  El::Int queries_grad_ldim)
+{
+  extern __shared__ __align__(16) unsigned char shared_buffer[];
+  const El::Int tile_size = blockDim.x;
+  const El::Int ldim = head_size + 1;
+  auto* q_tile = reinterpret_cast<AccT*>(shared_buffer);
+  auto* dy_tile = q_tile + tile_size * ldim;
+  auto* dq_tile = dy_tile + tile_size * ldim;
+  auto* k_tile = dq_tile + tile_size * ldim;
+  auto* v_tile = k_tile + tile_size * head_size;
+  auto* q = &q_tile[threadIdx.x * ldim];
+  auto* dy = &dy_tile[threadIdx.x * ldim];
+  auto* dq = &dq_tile[threadIdx.x * ldim];
+  const El::Int vector_size = num_heads * head_size;
+
+  for (El::Int j = blockIdx.z; j < mini_batch_size; j += gridDim.z) {
+    for (El::Int h = blockIdx.y; h < num_heads; h += gridDim.y) {
+      const El::Int offset = h * head_size;
+      for (El::Int query_start = blockIdx.x * tile_size;
+           query_start < num_queries;
+           query_start += gridDim.x * tile_size) {
+        const El::Int i = query_start + threadIdx.x;
+        const bool active = (i < num_queries);
+
+        // Load queries and output gradients
+        __syncthreads();
+        load_tile(query_start,
+                  num_queries,
+                  tile_size,
+                  head_size,
+                  vector_size,
+                  &queries[offset + j * queries_ldim],
+                  q_tile,
+                  ldim);
+        load_tile(query_start,
+                  num_queries,
+                  tile_size,
+                  head_size,
+                  vector_size,
+                  &output_grad[offset + j * output_grad_ldim],
+                  dy_tile,
+                  ldim);
+        for (El::Int d = 0; d < head_size; ++d) {
+          dq[d] = AccT(0);
+        }
+        const El::Int stats_idx = i * num_heads + h + j * stats_ldim;
+        const AccT lse =
+          (active ? logsumexp[stats_idx] : gpu_lib::infinity<AccT>());
+        const AccT dy_dot_y = (active ? dots[stats_idx] : AccT(0));
+
+        // Accumulate gradient over tiles of keys
+        const El::Int key_end =
+          (causal ? gpu_lib::min(num_keys, query_start + tile_size)
+                  : num_keys);
+        for (El::Int key_start = 0; key_start < key_end;
+             key_start += tile_size) {
+          __syncthreads();
+          load_tile(key_start,
+                    num_keys,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &keys[offset + j * keys_ldim],
+                    k_tile,
+                    head_size);
+          load_tile(key_start,
+                    num_keys,
+                    tile_size,
+                    head_size,
+                    vector_size,
+                    &values[offset + j * values_ldim],
+                    v_tile,
+                    head_size);
+          __syncthreads();
+          if (!active) {
+            continue;
+          }
+          El::Int tile_end = gpu_lib::min(tile_size, num_keys - key_start);
+          if (causal) {
+            tile_end = gpu_lib::min(tile_end, i - key_start + 1);
+          }
+          for (El::Int k = 0; k < tile_end; ++k) {
+            const auto* key = &k_tile[k * head_size];
+            const auto* v = &v_tile[k * head_size];
+            const AccT p = gpu_lib::exp(scale * dot(head_size, q, key) - lse);
+            const AccT ds = p * (dot(head_size, dy, v) - dy_dot_y);
+            for (El::Int d = 0; d < head_size; ++d) {
+              dq[d] += scale * ds * key[d];
+            }
+          }
+        }
+
+        // Write gradient
+        if (active) {
+          auto* dq_out =
+            &queries_grad[i * vector_size + offset + j * queries_grad_ldim];
+          for (El::Int d = 0; d < head_size; ++d) {
+            dq_out[d] = static_cast<T>(
+              accumulate ? static_cast<AccT>(dq_out[d]) + dq[d] : dq[d]);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+// =========================================================
+// Forward prop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::fp_block(
+  const LocalMat& queries,
+  const LocalMat& keys,
+  const LocalMat& values,
+  bool causal,
+  LocalMat& output,
+  LocalAccMat& logsumexp)
+{
+  using AccT = AccumulateDataType;
+
+  // Dimensions
+  const El::Int vector_size = this->get_input_dims(0)[1];
+  const El::Int num_queries = queries.Height() / vector_size;
+  const El::Int num_keys = keys.Height() / vector_size;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = vector_size / num_heads;
+  const El::Int local_mini_batch_size = queries.Width();
+  const AccT scale = AccT(1) / std::sqrt(static_cast<AccT>(head_size));
+  logsumexp.Resize(num_queries * num_heads, local_mini_batch_size);
+  if (queries.IsEmpty()) {
+    return;
+  }
+
+  // Launch GPU kernel
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(logsumexp),
+                                     gpu::get_sync_info(queries),
+                                     gpu::get_sync_info(keys),
+                                     gpu::get_sync_info(values));
+  const size_t tile_size = get_tile_size<AccT>(2, 2, head_size, 0);
+  dim3 block_dims, grid_dims;
+  block_dims.x = tile_size;
+  grid_dims.x = (num_queries + tile_size - 1) / tile_size;
+  grid_dims.y = num_heads;
+  grid_dims.z = local_mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    fp_kernel<TensorDataType, AccT>,
+    grid_dims,
+    block_dims,
+    tile_size * (2 * (head_size + 1) + 2 * head_size) * sizeof(AccT),
+    multisync,
+    num_queries,
+    num_keys,
+    num_heads,
+    head_size,
+    local_mini_batch_size,
+    causal,
+    scale,
+    queries.LockedBuffer(),
+    queries.LDim(),
+    keys.LockedBuffer(),
+    keys.LDim(),
+    values.LockedBuffer(),
+    values.LDim(),
+    output.Buffer(),
+    output.LDim(),
+    logsumexp.Buffer(),
+    logsumexp.LDim());
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::fp_merge(
+  const LocalMat& block_output,
+  const LocalAccMat& block_logsumexp,
+  LocalMat& output,
+  LocalAccMat& logsumexp)
+{
+  using AccT = AccumulateDataType;
+  const El::Int head_size = this->get_input_dims(0)[1] / m_num_heads;
+  const El::Int num_vectors = logsumexp.Height();
+  const El::Int local_mini_batch_size = logsumexp.Width();
+  if (logsumexp.IsEmpty()) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(logsumexp),
+                                     gpu::get_sync_info(block_output),
+                                     gpu::get_sync_info(block_logsumexp));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (num_vectors + block_size - 1) / block_size;
+  grid_dims.y = local_mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(fp_merge_kernel<TensorDataType, AccT>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_vectors,
+                              head_size,
+                              local_mini_batch_size,
+                              block_output.LockedBuffer(),
+                              block_output.LDim(),
+                              block_logsumexp.LockedBuffer(),
+                              block_logsumexp.LDim(),
+                              output.Buffer(),
+                              output.LDim(),
+                              logsumexp.Buffer(),
+                              logsumexp.LDim());
+}
+
+// =========================================================
+// Backprop
+// =========================================================
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::bp_dots(
+  const LocalMat& output,
+  const LocalMat& output_grad,
+  LocalAccMat& dots)
+{
+  using AccT = AccumulateDataType;
+  const El::Int vector_size = this->get_input_dims(0)[1];
+  const El::Int num_queries = output.Height() / vector_size;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = vector_size / num_heads;
+  const El::Int local_mini_batch_size = output.Width();
+  dots.Resize(num_queries * num_heads, local_mini_batch_size);
+  if (output.IsEmpty()) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(dots),
+                                     gpu::get_sync_info(output),
+                                     gpu::get_sync_info(output_grad));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (num_queries * num_heads + block_size - 1) / block_size;
+  grid_dims.y = local_mini_batch_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(bp_dot_kernel<TensorDataType, AccT>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_queries,
+                              num_heads,
+                              head_size,
+                              local_mini_batch_size,
+                              output.LockedBuffer(),
+                              output.LDim(),
+                              output_grad.LockedBuffer(),
+                              output_grad.LDim(),
+                              dots.Buffer(),
+                              dots.LDim());
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void attention_layer<TensorDataType, Layout, Device>::bp_block(
+  const LocalMat& queries,
+  const LocalMat& keys,
+  const LocalMat& values,
+  const LocalMat& output_grad,
+  const LocalAccMat& dots,
+  bool causal,
+  bool accumulate,
+  LocalMat& queries_grad,
+  LocalMat& keys_grad,
+  LocalMat& values_grad)
+{
+  using AccT = AccumulateDataType;
+
+  // Dimensions
+  const El::Int vector_size = this->get_input_dims(0)[1];
+  const El::Int num_queries = queries.Height() / vector_size;
+  const El::Int num_keys = keys.Height() / vector_size;
+  const El::Int num_heads = m_num_heads;
+  const El::Int head_size = vector_size / num_heads;
+  const El::Int local_mini_batch_size = queries.Width();
+  const AccT scale = AccT(1) / std::sqrt(static_cast<AccT>(head_size));
+  if (queries.IsEmpty()) {
+    return;
+  }
+
+  // GPU objects
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(queries_grad),
+                                     gpu::get_sync_info(keys_grad),
+                                     gpu::get_sync_info(values_grad),
+                                     gpu::get_sync_info(m_logsumexp),
+                                     gpu::get_sync_info(dots),
+                                     gpu::get_sync_info(queries),
+                                     gpu::get_sync_info(keys),
+                                     gpu::get_sync_info(values),
+                                     gpu::get_sync_info(output_grad));
+
+  // Gradients w.r.t. keys and values
+  {
+    const size_t tile_size = get_tile_size<AccT>(4, 2, head_size, 2);
+    dim3 block_dims, grid_dims;
+    block_dims.x = tile_size;
+    grid_dims.x = (num_keys + tile_size - 1) / tile_size;
+    grid_dims.y = num_heads;
+    grid_dims.z = local_mini_batch_size;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(
+      bp_keys_kernel<TensorDataType, AccT>,
+      grid_dims,
+      block_dims,
+      tile_size * (4 * (head_size + 1) + 2 * head_size + 2) * sizeof(AccT),
+      multisync,
+      num_queries,
+      num_keys,
+      num_heads,
+      head_size,
+      local_mini_batch_size,
+      causal,
+      accumulate,
+      scale,
+      queries.LockedBuffer(),
+      queries.LDim(),
+      keys.LockedBuffer(),
+      keys.LDim(),
+      values.LockedBuffer(),
+      values.LDim(),
+      output_grad.LockedBuffer(),
+      output_grad.LDim(),
+      m_logsumexp.LockedBuffer(),
+      dots.LockedBuffer(),
+      dots.LDim(),
+      keys_grad.Buffer(),
+      keys_grad.LDim(),
+      values_grad.Buffer(),
+      values_grad.LDim());
+  }
+
+  // Gradient w.r.t. queries
+  {
+    const size_t tile_size = get_tile_size<AccT>(3, 2, head_size, 0);
+    dim3 block_dims, grid_dims;
+    block_dims.x = tile_size;
+    grid_dims.x = (num_queries + tile_size - 1) / tile_size;
+    grid_dims.y = num_heads;
+    grid_dims.z = local_mini_batch_size;
+    gpu_lib::clip_grid_dims(grid_dims);
+    hydrogen::gpu::LaunchKernel(
+      bp_queries_kernel<TensorDataType, AccT>,
+      grid_dims,
+      block_dims,
+      tile_size * (3 * (head_size + 1) + 2 * head_size) * sizeof(AccT),
+      multisync,
+      num_queries,
+      num_keys,
+      num_heads,
+      head_size,
+      local_mini_batch_size,
+      causal,
+      accumulate,
+      scale,
+      queries.LockedBuffer(),
+      queries.LDim(),
+      keys.LockedBuffer(),
+      keys.LDim(),
+      values.LockedBuffer(),
+      values.LDim(),
+      output_grad.LockedBuffer(),
+      output_grad.LDim(),
+      m_logsumexp.LockedBuffer(),
+      dots.LockedBuffer(),
+      dots.LDim(),
+      queries_grad.Buffer(),
+      queries_grad.LDim());
+  }
+}
+
+// =========================================================
+// Explicit template instantiation
+// =========================================================
+
+#define PROTO(T)                                                               \
+  template class attention_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
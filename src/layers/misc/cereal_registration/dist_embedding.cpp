@@ -27,8 +27,6 @@
 #include "lbann/utils/serialize.hpp"
 #include <lbann/layers/misc/dist_embedding.hpp>
 
-#if defined(LBANN_HAS_SHMEM) || defined(LBANN_HAS_NVSHMEM)
-
 namespace lbann {
 
 template <typename TensorDataType, data_layout Layout, El::Device Device>
@@ -49,6 +47,7 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::serialize(
   //   m_workspace_buffer_size
   //   m_metadata_buffer_size
   //   m_nb_barrier_request
+  //   MPI backend workspaces
 }
 
 } // namespace lbann
@@ -64,15 +63,11 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::serialize(
     ::lbann::dist_embedding_layer<TYPE LBANN_COMMA LAYOUT LBANN_COMMA DEVICE>, \
     "dist_embedding_layer (" #TYPE "," #LAYOUT "," #DEVICE ")");
 
-#ifdef LBANN_HAS_SHMEM
 PROTO_DEVICE(float, lbann::data_layout::DATA_PARALLEL, El::Device::CPU)
 PROTO_DEVICE(double, lbann::data_layout::DATA_PARALLEL, El::Device::CPU)
-#endif // LBANN_HAS_SHMEM
 #ifdef LBANN_HAS_NVSHMEM
 PROTO_DEVICE(float, lbann::data_layout::DATA_PARALLEL, El::Device::GPU)
 PROTO_DEVICE(double, lbann::data_layout::DATA_PARALLEL, El::Device::GPU)
 #endif // LBANN_HAS_NVSHMEM
 
 LBANN_REGISTER_DYNAMIC_INIT(dist_embedding_layer);
-
-#endif // defined(LBANN_HAS_SHMEM) || defined(LBANN_HAS_NVSHMEM)
@@ -32,8 +32,11 @@ namespace lbann {
 namespace {
 
 /** CPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Each column is shifted by its first local entries, which keeps
+ *  the one-pass sums as accurate as a two-pass algorithm. If the
+ *  inputs are split between processes, each process packs its
+ *  count, means and co-moment into its own rows of @c partials and
+ *  the rows of all processes are combined after an allreduce.
  */
 template <typename TensorDataType>
 void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input0,
@@ -41,9 +44,11 @@ void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input0,
             El::AbstractDistMatrix<TensorDataType>& output,
             El::AbstractDistMatrix<TensorDataType>& means,
             El::AbstractDistMatrix<TensorDataType>& workspace,
+            El::AbstractDistMatrix<TensorDataType>& partials,
             bool biased)
 {
   using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
 
   // Local matrices
   const auto& local_input0 =
@@ -52,47 +57,87 @@ void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input0,
     static_cast<const CPUMatType&>(input1.LockedMatrix());
   auto& local_means = static_cast<CPUMatType&>(means.Matrix());
   auto& local_workspace = static_cast<CPUMatType&>(workspace.Matrix());
+  auto& local_partials = static_cast<CPUMatType&>(partials.Matrix());
 
   // Dimensions
   const auto& height = input0.Height();
   const auto& width = input0.Width();
   const auto& local_height = local_input0.Height();
   const auto& local_width = local_input0.Width();
+  const TensorDataType scale =
+    El::To<TensorDataType>(biased ? height : height - 1);
 
-  // Compute column-wise mean
+  // Column-wise statistics
   means.Empty(false);
   means.AlignWith(input0);
   means.Resize(2, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    TensorDataType sum0 = El::TypeTraits<TensorDataType>::Zero(),
-                   sum1 = El::TypeTraits<TensorDataType>::Zero();
-    for (El::Int row = 0; row < local_height; ++row) {
-      sum0 += local_input0(row, col);
-      sum1 += local_input1(row, col);
-    }
-    local_means(0, col) = sum0 / height;
-    local_means(1, col) = sum1 / height;
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise covariance
   workspace.Empty(false);
   workspace.AlignWith(input0);
   workspace.Resize(1, width);
+  const El::Int num_procs = means.RedundantSize();
+  const El::Int slot = 4 * means.RedundantRank();
+  if (num_procs > 1) {
+    partials.Empty(false);
+    partials.AlignWith(input0);
+    El::Zeros(partials, 4 * num_procs, width);
+  }
+
+  // Compute local count, means and co-moment
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto& mean0 = local_means(0, col);
-    const auto& mean1 = local_means(1, col);
-    TensorDataType sum = El::TypeTraits<TensorDataType>::Zero();
+    const auto shift0 = local_height > 0 ? local_input0(0, col) : zero;
+    const auto shift1 = local_height > 0 ? local_input1(0, col) : zero;
+    TensorDataType sum0 = zero, sum1 = zero, prodsum = zero;
     for (El::Int row = 0; row < local_height; ++row) {
-      const auto& x0 = local_input0(row, col);
-      const auto& x1 = local_input1(row, col);
-      sum += (x0 - mean0) * (x1 - mean1);
+      const auto& diff0 = local_input0(row, col) - shift0;
+      const auto& diff1 = local_input1(row, col) - shift1;
+      sum0 += diff0;
+      sum1 += diff1;
+      prodsum += diff0 * diff1;
+    }
+    const auto count = El::To<TensorDataType>(local_height);
+    const auto mean_diff0 = local_height > 0 ? sum0 / count : zero;
+    const auto mean_diff1 = local_height > 0 ? sum1 / count : zero;
+    const auto comoment = prodsum - sum0 * mean_diff1;
+    if (num_procs == 1) {
+      local_means(0, col) = shift0 + mean_diff0;
+      local_means(1, col) = shift1 + mean_diff1;
+      local_workspace(0, col) = comoment / scale;
+    }
+    else {
+      local_partials(slot, col) = count;
+      local_partials(slot + 1, col) = shift0 + mean_diff0;
+      local_partials(slot + 2, col) = shift1 + mean_diff1;
+      local_partials(slot + 3, col) = comoment;
+    }
+  }
+
+  // Combine statistics of all processes
+  if (num_procs > 1) {
+    El::AllReduce(partials, partials.RedundantComm());
+    const auto total = El::To<TensorDataType>(height);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      TensorDataType mean0 = zero, mean1 = zero;
+      for (El::Int i = 0; i < num_procs; ++i) {
+        const auto& count = local_partials(4 * i, col);
+        mean0 += count * local_partials(4 * i + 1, col);
+        mean1 += count * local_partials(4 * i + 2, col);
+      }
+      mean0 /= total;
+      mean1 /= total;
+      TensorDataType comoment = zero;
+      for (El::Int i = 0; i < num_procs; ++i) {
+        comoment += local_partials(4 * i + 3, col) +
+                    local_partials(4 * i, col) *
+                      (local_partials(4 * i + 1, col) - mean0) *
+                      (local_partials(4 * i + 2, col) - mean1);
+      }
+      local_means(0, col) = mean0;
+      local_means(1, col) = mean1;
+      local_workspace(0, col) = comoment / scale;
     }
-    local_workspace(0, col) = sum / (biased ? height : height - 1);
   }
-  El::AllReduce(workspace, workspace.RedundantComm());
   El::Copy(workspace, output);
 }
 
@@ -162,6 +207,7 @@ void covariance_layer<TensorDataType, Layout, Device>::fp_compute()
          this->get_activations(),
          *this->m_means,
          *this->m_workspace,
+         *this->m_partials,
          this->m_biased);
 }
 
@@ -32,110 +32,120 @@ namespace lbann {
 
 namespace {
 
-/** Compute local contributions to means.
- *  Computes column-wise sums of two input matrices and multiplies
- *  them by a scaling factor (which should be
- *  1/height). 'contribution' is interpreted as a 2 x width matrix
- *  where the first row corresponds to 'input0' and the second row to
- *  'input1'.
+/** Compute column-wise statistics in one pass.
+ *  Each block handles whole columns, shifted by their first
+ *  entries. With one process, the means and covariance are written
+ *  to @c means (a 2 x width matrix) and @c covariances. Otherwise
+ *  the count, means and co-moment are written to rows @c slot to
+ *  @c slot+3 of @c partials.
  */
 template <typename TensorDataType, El::Int block_size>
 __global__ void
-mean_contribution_kernel(El::Int height,
-                         El::Int width,
-                         TensorDataType scale,
-                         const TensorDataType* __restrict__ input0,
-                         El::Int input0_ldim,
-                         const TensorDataType* __restrict__ input1,
-                         El::Int input1_ldim,
-                         TensorDataType* __restrict__ contribution)
+covariance_moments_kernel(El::Int height,
+                          El::Int width,
+                          TensorDataType scale,
+                          const TensorDataType* __restrict__ input0,
+                          El::Int input0_ldim,
+                          const TensorDataType* __restrict__ input1,
+                          El::Int input1_ldim,
+                          TensorDataType* __restrict__ means,
+                          TensorDataType* __restrict__ covariances,
+                          TensorDataType* __restrict__ partials,
+                          El::Int partials_ldim,
+                          El::Int slot)
 {
 
   // Indices
   const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
   const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
 
-  // Compute local contribution for each matrix column
+  __shared__ TensorDataType shared_sum0[block_size];
+  __shared__ TensorDataType shared_sum1[block_size];
+  __shared__ TensorDataType shared_prodsum[block_size];
   for (El::Int col = bidy; col < width; col += gridDim.y) {
+    const auto shift0 =
+      height > 0 ? input0[col * input0_ldim] : TensorDataType(0.f);
+    const auto shift1 =
+      height > 0 ? input1[col * input1_ldim] : TensorDataType(0.f);
 
-    // Compute contributions for each thread
-    TensorDataType private_contribution0 = 0;
-    TensorDataType private_contribution1 = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      private_contribution0 += input0[row + col * input0_ldim];
-      private_contribution1 += input1[row + col * input1_ldim];
+    // Compute shifted sums for each thread
+    TensorDataType private_sum0 = 0, private_sum1 = 0, private_prodsum = 0;
+    for (El::Int row = tid; row < height; row += block_size) {
+      const auto& diff0 = input0[row + col * input0_ldim] - shift0;
+      const auto& diff1 = input1[row + col * input1_ldim] - shift1;
+      private_sum0 += diff0;
+      private_sum1 += diff1;
+      private_prodsum += diff0 * diff1;
     }
 
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution0[block_size];
-    __shared__ TensorDataType shared_contribution1[block_size];
-    shared_contribution0[tid] = private_contribution0;
-    shared_contribution1[tid] = private_contribution1;
+    // Shared memory reduction to get sums for the column
+    shared_sum0[tid] = private_sum0;
+    shared_sum1[tid] = private_sum1;
+    shared_prodsum[tid] = private_prodsum;
     for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
       __syncthreads();
       if (tid < stride) {
-        shared_contribution0[tid] += shared_contribution0[tid + stride];
-        shared_contribution1[tid] += shared_contribution1[tid + stride];
+        shared_sum0[tid] += shared_sum0[tid + stride];
+        shared_sum1[tid] += shared_sum1[tid + stride];
+        shared_prodsum[tid] += shared_prodsum[tid + stride];
       }
     }
     if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[2 * col],
-                          scale * shared_contribution0[0]);
-      gpu_lib::atomic_add(&contribution[2 * col + 1],
-                          scale * shared_contribution1[0]);
+      const TensorDataType count = TensorDataType(height);
+      const auto mean_diff0 =
+        height > 0 ? shared_sum0[0] / count : TensorDataType(0.f);
+      const auto mean_diff1 =
+        height > 0 ? shared_sum1[0] / count : TensorDataType(0.f);
+      const auto comoment = shared_prodsum[0] - shared_sum0[0] * mean_diff1;
+      if (partials == nullptr) {
+        means[2 * col] = shift0 + mean_diff0;
+        means[2 * col + 1] = shift1 + mean_diff1;
+        covariances[col] = comoment / scale;
+      }
+      else {
+        partials[slot + col * partials_ldim] = count;
+        partials[slot + 1 + col * partials_ldim] = shift0 + mean_diff0;
+        partials[slot + 2 + col * partials_ldim] = shift1 + mean_diff1;
+        partials[slot + 3 + col * partials_ldim] = comoment;
+      }
     }
+    __syncthreads();
   }
 }
 
-/** Compute local contributions to covariances. */
-template <typename TensorDataType, El::Int block_size>
+/** Combine the statistics of @c num_procs processes, packed as
+ *  count, means and co-moment. */
+template <typename TensorDataType>
 __global__ void
-covariance_contribution_kernel(El::Int height,
-                               El::Int width,
-                               TensorDataType scale,
-                               const TensorDataType* __restrict__ input0,
-                               El::Int input0_ldim,
-                               const TensorDataType* __restrict__ input1,
-                               El::Int input1_ldim,
-                               const TensorDataType* __restrict__ means,
-                               TensorDataType* __restrict__ contribution)
+covariance_combine_kernel(El::Int num_procs,
+                          El::Int width,
+                          TensorDataType total,
+                          TensorDataType scale,
+                          const TensorDataType* __restrict__ partials,
+                          El::Int partials_ldim,
+                          TensorDataType* __restrict__ means,
+                          TensorDataType* __restrict__ covariances)
 {
-
-  // Indices
-  const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
-  const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
-
-  // Compute local contribution for each matrix column
-  for (El::Int col = bidy; col < width; col += gridDim.y) {
-    const auto& mean0 = means[2 * col];
-    const auto& mean1 = means[2 * col + 1];
-
-    // Compute contributions for each thread
-    TensorDataType private_contribution = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      const auto& x0 = input0[row + col * input0_ldim];
-      const auto& x1 = input1[row + col * input1_ldim];
-      private_contribution += (x0 - mean0) * (x1 - mean1);
-    }
-
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution[block_size];
-    shared_contribution[tid] = private_contribution;
-    for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
-      __syncthreads();
-      if (tid < stride) {
-        shared_contribution[tid] += shared_contribution[tid + stride];
-      }
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  for (El::Int col = gid; col < width; col += nthreads) {
+    const auto* stats = &partials[col * partials_ldim];
+    TensorDataType mean0 = 0, mean1 = 0;
+    for (El::Int i = 0; i < num_procs; ++i) {
+      mean0 += stats[4 * i] * stats[4 * i + 1];
+      mean1 += stats[4 * i] * stats[4 * i + 2];
     }
-    if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[col], scale * shared_contribution[0]);
+    mean0 /= total;
+    mean1 /= total;
+    TensorDataType comoment = 0;
+    for (El::Int i = 0; i < num_procs; ++i) {
+      comoment += stats[4 * i + 3] + stats[4 * i] *
+                                       (stats[4 * i + 1] - mean0) *
+                                       (stats[4 * i + 2] - mean1);
     }
+    means[2 * col] = mean0;
+    means[2 * col + 1] = mean1;
+    covariances[col] = comoment / scale;
   }
 }
 
@@ -175,8 +185,10 @@ __global__ void covariance_backprop_kernel(
 }
 
 /** GPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Columns are shifted by their first local entries, which keeps
+ *  the one-pass sums as accurate as a two-pass algorithm. If the
+ *  inputs are split between processes, their statistics are packed
+ *  into @c partials, allreduced and combined.
  */
 template <typename TensorDataType>
 void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
@@ -184,6 +196,7 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
             El::AbstractDistMatrix<TensorDataType>& output,
             El::AbstractDistMatrix<TensorDataType>& means,
             El::AbstractDistMatrix<TensorDataType>& workspace,
+            El::AbstractDistMatrix<TensorDataType>& partials,
             bool biased)
 {
 
@@ -199,64 +212,43 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
   auto& local_workspace =
     static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
       workspace.Matrix());
+  auto& local_partials =
+    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+      partials.Matrix());
 
   // Dimensions
   const auto& height = input0.Height();
   const auto& width = input0.Width();
   const auto& local_height = local_input0.Height();
   const auto& local_width = local_input0.Width();
+  const auto scale =
+    biased ? TensorDataType(height) : TensorDataType(height - 1);
 
-  // Compute column-wise mean
+  // Column-wise statistics
   means.Empty(false);
   means.AlignWith(input0);
-  El::Zeros(means, 2, width);
-  if (!local_input0.IsEmpty()) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_means),
-                                       gpu::get_sync_info(local_input0),
-                                       gpu::get_sync_info(local_input1));
-    constexpr El::Int block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() / TensorDataType(height);
-    hydrogen::gpu::LaunchKernel(
-      mean_contribution_kernel<TensorDataType, block_size>,
-      grid_dims,
-      block_dims,
-      0,
-      multisync,
-      local_height,
-      local_width,
-      scale,
-      local_input0.LockedBuffer(),
-      local_input0.LDim(),
-      local_input1.LockedBuffer(),
-      local_input1.LDim(),
-      local_means.Buffer());
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise covariance
+  means.Resize(2, width);
   workspace.Empty(false);
   workspace.AlignWith(input0);
-  El::Zeros(workspace, 1, width);
-  if (!local_input0.IsEmpty()) {
+  workspace.Resize(1, width);
+  const El::Int num_procs = means.RedundantSize();
+  if (num_procs > 1) {
+    partials.Empty(false);
+    partials.AlignWith(input0);
+    El::Zeros(partials, 4 * num_procs, width);
+  }
+  if (local_width > 0) {
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
                                        gpu::get_sync_info(local_means),
+                                       gpu::get_sync_info(local_partials),
                                        gpu::get_sync_info(local_input0),
                                        gpu::get_sync_info(local_input1));
     constexpr El::Int block_size = 256;
     dim3 block_dims, grid_dims;
     block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() /
-      (biased ? TensorDataType(height) : TensorDataType(height - 1));
+    grid_dims.y = std::min(local_width, El::Int(65535));
     hydrogen::gpu::LaunchKernel(
-      covariance_contribution_kernel<TensorDataType, block_size>,
+      covariance_moments_kernel<TensorDataType, block_size>,
       grid_dims,
       block_dims,
       0,
@@ -268,10 +260,38 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input0,
       local_input0.LDim(),
       local_input1.LockedBuffer(),
       local_input1.LDim(),
-      local_means.LockedBuffer(),
-      local_workspace.Buffer());
+      local_means.Buffer(),
+      local_workspace.Buffer(),
+      num_procs > 1 ? local_partials.Buffer() : nullptr,
+      local_partials.LDim(),
+      4 * means.RedundantRank());
+  }
+
+  // Combine statistics of all processes
+  if (num_procs > 1) {
+    El::AllReduce(partials, partials.RedundantComm());
+    if (local_width > 0) {
+      auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
+                                         gpu::get_sync_info(local_means),
+                                         gpu::get_sync_info(local_partials));
+      constexpr El::Int block_size = 256;
+      const El::Int grid_size = (local_width + block_size - 1) / block_size;
+      hydrogen::gpu::LaunchKernel(
+        covariance_combine_kernel<TensorDataType>,
+        grid_size,
+        block_size,
+        0,
+        multisync,
+        num_procs,
+        local_width,
+        TensorDataType(height),
+        scale,
+        local_partials.LockedBuffer(),
+        local_partials.LDim(),
+        local_means.Buffer(),
+        local_workspace.Buffer());
+    }
   }
-  El::AllReduce(workspace, workspace.RedundantComm());
   El::Copy(workspace, output);
 }
 
@@ -363,6 +383,7 @@ void covariance_layer<TensorDataType, Layout, Device>::fp_compute()
          this->get_activations(),
          *this->m_means,
          *this->m_workspace,
+         *this->m_partials,
          this->m_biased);
 }
 
@@ -52,41 +52,6 @@ struct FFTBackendT<T, El::Device::CPU>
   using type = lbann::fftw::FFTWWrapper<T>;
 };
 
-using namespace El;
-// Updates B(i,j) = func(A(i,j), B(i,j));
-template <typename S, typename T, typename F>
-void Combine(Matrix<S, Device::CPU> const& A, Matrix<T, Device::CPU>& B, F func)
-{
-  EL_DEBUG_CSE;
-  const Int m = A.Height();
-  const Int n = A.Width();
-
-  if (B.Height() != m || B.Width() != n)
-    LBANN_ERROR("B must be the same size as A.");
-
-  S const* ABuf = A.LockedBuffer();
-  T* BBuf = B.Buffer();
-  Int const ALDim = A.LDim();
-  Int const BLDim = B.LDim();
-
-  // Use entry-wise parallelization for column vectors. Otherwise
-  // use column-wise parallelization.
-  if (n == 1) {
-    EL_PARALLEL_FOR
-    for (Int i = 0; i < m; ++i) {
-      BBuf[i] = func(ABuf[i], BBuf[i]);
-    }
-  }
-  else {
-    EL_PARALLEL_FOR_COLLAPSE2
-    for (Int j = 0; j < n; ++j) {
-      for (Int i = 0; i < m; ++i) {
-        BBuf[i + j * BLDim] = func(ABuf[i + j * ALDim], BBuf[i + j * BLDim]);
-      }
-    }
-  }
-}
-
 #ifdef LBANN_HAS_GPU
 
 template <typename T>
@@ -102,55 +67,133 @@ struct FFTBackendT<T, El::Device::GPU>
 namespace lbann {
 namespace internal {
 
-template <typename T>
-static void Abs(El::Matrix<El::Complex<T>, El::Device::CPU> const& in,
-                El::Matrix<T, El::Device::CPU>& out)
+/** @brief Index tables for the Hermitian-packed spectrum of a sample.
+ *
+ *  The DFT of a real signal is Hermitian: the entry at index -k (mod
+ *  the dimensions) is the conjugate of the entry at k. A
+ *  real-to-complex transform only computes the first n/2+1 entries of
+ *  the last dimension of each feature map.
+ *
+ *  @param full_dims Sample dimensions, starting with the number of
+ *                   feature maps.
+ *  @param full_to_half For each entry of the full spectrum, the
+ *                      half-spectrum entry with the same absolute
+ *                      value.
+ *  @param half_to_full For each entry of the half spectrum, the
+ *                      full-spectrum entry at the same index.
+ *  @param half_to_mirror For each entry of the half spectrum, the
+ *                        full-spectrum entry at its negated index.
+ */
+static void
+build_r2c_index_tables(std::vector<int> const& full_dims,
+                       El::Matrix<El::Int, El::Device::CPU>& full_to_half,
+                       El::Matrix<El::Int, El::Device::CPU>& half_to_full,
+                       El::Matrix<El::Int, El::Device::CPU>& half_to_mirror)
 {
-  using ComplexT = El::Complex<T>;
-  El::EntrywiseMap(in,
-                   out,
-                   std::function<T(ComplexT const&)>(
-                     [](ComplexT const& x) { return El::Abs(x); }));
+  auto const half_dims = fft::get_r2c_output_dims(full_dims);
+  auto const full_strides = get_packed_strides(full_dims);
+  auto const half_strides = get_packed_strides(half_dims);
+  int const full_size = get_linear_size(full_dims);
+  int const half_size = get_linear_size(half_dims);
+  size_t const ndims = full_dims.size();
+  full_to_half.Resize(full_size, 1);
+  half_to_full.Resize(half_size, 1);
+  half_to_mirror.Resize(half_size, 1);
+  for (int i = 0; i < full_size; ++i) {
+    int rem = i, k = 0, half = 0, mirror_half = 0, mirror_full = 0;
+    for (size_t d = 0; d < ndims; ++d) {
+      k = rem / full_strides[d];
+      rem %= full_strides[d];
+      // The feature map index is not negated
+      int const m = (d == 0 ? k : (full_dims[d] - k) % full_dims[d]);
+      half += k * half_strides[d];
+      mirror_half += m * half_strides[d];
+      mirror_full += m * full_strides[d];
+    }
+    if (k < half_dims.back()) {
+      full_to_half(i, 0) = half;
+      half_to_full(half, 0) = i;
+      half_to_mirror(half, 0) = mirror_full;
+    }
+    else {
+      full_to_half(i, 0) = mirror_half;
+    }
+  }
 }
 
 template <typename T>
-static void ApplyAbsGradientUpdate(
-  El::Matrix<T, El::Device::CPU> const& grad_wrt_output,
-  El::Matrix<El::Complex<T>, El::Device::CPU>& input_output)
+static void R2CAbs(El::Matrix<El::Complex<T>, El::Device::CPU> const& in,
+                   El::Matrix<El::Int, El::Device::CPU> const& full_to_half,
+                   El::Matrix<T, El::Device::CPU>& out)
 {
-  using ComplexT = El::Complex<T>;
-  Combine(grad_wrt_output, input_output, [](T const& dy, ComplexT const& x) {
-    return (x == ComplexT(T(0)) ? ComplexT(T(0))
-                                : El::Conj(x * (dy / El::Abs(x))));
-  });
+  El::Int const height = out.Height();
+  El::Int const width = out.Width();
+  El::Int const in_ldim = in.LDim();
+  El::Int const out_ldim = out.LDim();
+  auto const* in_buf = in.LockedBuffer();
+  auto const* map = full_to_half.LockedBuffer();
+  auto* out_buf = out.Buffer();
+  EL_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      out_buf[i + j * out_ldim] = El::Abs(in_buf[map[i] + j * in_ldim]);
+    }
+  }
 }
 
+/** @brief Gradient of R2CAbs, as a Hermitian-packed spectrum.
+ *
+ *  The gradient w.r.t. the real input is the real part of the DFT of
+ *  conj(x_k) dy_k / |x_k|. Since the input is real, this is the
+ *  inverse complex-to-real DFT of x_k (dy_k + dy_{-k}) / (2 |x_k|),
+ *  which is Hermitian.
+ */
 template <typename T>
-static void MyRealPart(El::Matrix<El::Complex<T>, El::Device::CPU> const& in,
-                       El::Matrix<T, El::Device::CPU>& out)
+static void ApplyR2CAbsGradientUpdate(
+  El::Matrix<T, El::Device::CPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::CPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::CPU> const& half_to_mirror,
+  El::Matrix<El::Complex<T>, El::Device::CPU>& input_output)
 {
-  // out should be setup, so make sure no resize will happen.
-  if ((in.Height() != out.Height()) || (in.Width() != out.Width()))
-    LBANN_ERROR("Incompatible matrix dimensions.");
-  El::RealPart(in, out);
+  using ComplexT = El::Complex<T>;
+  El::Int const height = input_output.Height();
+  El::Int const width = input_output.Width();
+  El::Int const dy_ldim = grad_wrt_output.LDim();
+  El::Int const x_ldim = input_output.LDim();
+  auto const* dy_buf = grad_wrt_output.LockedBuffer();
+  auto const* full = half_to_full.LockedBuffer();
+  auto const* mirror = half_to_mirror.LockedBuffer();
+  auto* x_buf = input_output.Buffer();
+  EL_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      auto& x = x_buf[i + j * x_ldim];
+      T const abs_x = El::Abs(x);
+      T const dy =
+        dy_buf[full[i] + j * dy_ldim] + dy_buf[mirror[i] + j * dy_ldim];
+      x = (abs_x == T(0) ? ComplexT(T(0)) : x * (dy / (T(2) * abs_x)));
+    }
+  }
 }
 
 #ifdef LBANN_HAS_GPU
 // Have to instantiate this in device-compiled code.
-void Abs(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
-         El::Matrix<float, El::Device::GPU>& out);
-void Abs(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
-         El::Matrix<double, El::Device::GPU>& out);
-void ApplyAbsGradientUpdate(
+void R2CAbs(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
+            El::Matrix<El::Int, El::Device::GPU> const& full_to_half,
+            El::Matrix<float, El::Device::GPU>& out);
+void R2CAbs(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
+            El::Matrix<El::Int, El::Device::GPU> const& full_to_half,
+            El::Matrix<double, El::Device::GPU>& out);
+void ApplyR2CAbsGradientUpdate(
   El::Matrix<float, El::Device::GPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_mirror,
   El::Matrix<El::Complex<float>, El::Device::GPU>& input_output);
-void ApplyAbsGradientUpdate(
+void ApplyR2CAbsGradientUpdate(
   El::Matrix<double, El::Device::GPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_mirror,
   El::Matrix<El::Complex<double>, El::Device::GPU>& input_output);
-void MyRealPart(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
-                El::Matrix<float, El::Device::GPU>& out);
-void MyRealPart(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
-                El::Matrix<double, El::Device::GPU>& out);
 #endif // LBANN_HAS_GPU
 
 } // namespace internal
@@ -168,6 +211,7 @@ class dft_abs_impl
   using ComplexT = El::Complex<T>;
   using RealMatType = El::Matrix<T, D>;
   using ComplexMatType = El::Matrix<ComplexT, D>;
+  using IndexMatType = El::Matrix<El::Int, D>;
 
 public:
   /** @brief Constructor.
@@ -176,7 +220,18 @@ public:
    *        change, while we assume the sample dims stay constant and
    *        are the same for each sample.
    */
-  dft_abs_impl(std::vector<int> const& dims) : full_dims_{dims} {}
+  dft_abs_impl(std::vector<int> const& dims) : full_dims_{dims}
+  {
+    El::Matrix<El::Int, El::Device::CPU> full_to_half, half_to_full,
+      half_to_mirror;
+    internal::build_r2c_index_tables(full_dims_,
+                                     full_to_half,
+                                     half_to_full,
+                                     half_to_mirror);
+    El::Copy(full_to_half, full_to_half_);
+    El::Copy(half_to_full, half_to_full_);
+    El::Copy(half_to_mirror, half_to_mirror_);
+  }
 
   ~dft_abs_impl() {}
 
@@ -185,20 +240,22 @@ public:
   dft_abs_impl(dft_abs_impl const& other) : dft_abs_impl(other.full_dims_) {}
 
   /** @brief Compute the action of forward propagation.
-   *  @details This is a DFT followed by and entrywise Abs() application.
+   *  @details This is a real-to-complex DFT followed by an entrywise
+   *           Abs() application. Only half of the spectrum is
+   *           computed; the other half is its mirror image.
    *  @param input The (real) input to the DFT.
    *  @param output The (real) output of the Abs() operation.
    */
   void do_fp_compute(RealMatType const& input, RealMatType& output) const
   {
-    // Copy to complex values
-    El::Copy(input, workspace_);
+    // The FFT buffers are the ones the plans were made with
+    El::Copy(input, real_workspace_);
 
     // This does the first part: the DFT
-    fft_impl_.compute_forward(workspace_);
+    fft_impl_.compute_forward(real_workspace_, workspace_);
 
     // Now output the absolute value -- keep it real!
-    internal::Abs(workspace_, output);
+    internal::R2CAbs(workspace_, full_to_half_, output);
   }
 
   void do_bp_compute(RealMatType const& local_grad_wrt_output,
@@ -206,20 +263,20 @@ public:
   {
     // Similarly, back-prop happens in two parts. The first stage
     // applies the gradient of the absolute value, producing a
-    // complex-valued input to the DFT part.
+    // Hermitian-packed input to the DFT part.
     //
-    // Precondition: workspace_bp_ is assumed to be filled with the
+    // Precondition: workspace_ is assumed to be filled with the
     // output of the forward-prop FFT (i.e., the input to the implicit
     // "Abs" calculation).
-    internal::ApplyAbsGradientUpdate(local_grad_wrt_output, workspace_);
-
-    // Next we apply the gradient of the DFT, which is... just the
-    // DFT. Aren't linear operators fun??
-    fft_impl_.compute_forward(workspace_);
-
-    // Finally, we need to transform the output of the DFT, which is
-    // complex valued, back to the real world.
-    internal::MyRealPart(workspace_, local_grad_wrt_input);
+    internal::ApplyR2CAbsGradientUpdate(local_grad_wrt_output,
+                                     half_to_full_,
+                                     half_to_mirror_,
+                                     workspace_);
+
+    // Next we apply the gradient of the DFT. The result is real, so
+    // it is a complex-to-real transform.
+    fft_impl_.compute_backward(workspace_, real_workspace_);
+    El::Copy(real_workspace_, local_grad_wrt_input);
   }
 
   void setup_fp(RealMatType const& input)
@@ -228,12 +285,16 @@ public:
       LBANN_ERROR("Invalid input size.");
 
     auto const num_samples = input.Width();
-    auto const output_height = get_linear_size(full_dims_);
+    auto const input_height = get_linear_size(full_dims_);
+    auto const output_height =
+      get_linear_size(fft::get_r2c_output_dims(full_dims_));
 
-    // Nothing to do; short-circuit.
+    // Plans are cached, so this is cheap after the first minibatch
+    // of each size.
+    real_workspace_.Resize(input_height, num_samples);
     workspace_.Resize(output_height, num_samples);
-    fft_impl_.setup_forward(workspace_, full_dims_);
-    fft_impl_.setup_backward(workspace_, full_dims_);
+    fft_impl_.setup_forward(real_workspace_, workspace_, full_dims_);
+    fft_impl_.setup_backward(workspace_, real_workspace_, full_dims_);
   }
 
   void setup_bp(RealMatType const& grad_wrt_output) const
@@ -252,9 +313,15 @@ public:
   }
 
 private:
-  FFTBackend<El::Complex<T>, D> fft_impl_;
-  /** @brief Cache the output of the fp DFT. */
+  FFTBackend<T, D> fft_impl_;
+  /** @brief Cache the output of the fp DFT (half spectrum). */
   mutable El::Matrix<El::Complex<T>, D> workspace_;
+  /** @brief Real side of the DFT. */
+  mutable El::Matrix<T, D> real_workspace_;
+  /** @brief See internal::build_r2c_index_tables. */
+  IndexMatType full_to_half_;
+  IndexMatType half_to_full_;
+  IndexMatType half_to_mirror_;
   std::vector<int> full_dims_;
 
 }; // struct dft_abs_impl
@@ -293,7 +360,7 @@ template <typename T, El::Device D>
 void dft_abs_layer<T, D>::bp_compute()
 {
   using LocalMatT = El::Matrix<T, D>;
-  pimpl_->setup_fp(
+  pimpl_->setup_bp(
     static_cast<LocalMatT const&>(this->get_local_prev_error_signals()));
   pimpl_->do_bp_compute(
     static_cast<LocalMatT const&>(this->get_local_prev_error_signals()),
@@ -24,63 +24,180 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 #include <El.hpp>
+#include <El.hpp>
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include <thrust/complex.h>
 
 namespace lbann {
 namespace internal {
-// Have to instantiate this in device-compiled code.
-void Abs(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
-         El::Matrix<float, El::Device::GPU>& out)
+namespace {
+
+/** Unpack the absolute value of a Hermitian-packed spectrum.
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename T>
+__global__ void r2c_abs_kernel(size_t height,
+                               size_t width,
+                               const thrust::complex<T>* __restrict__ in,
+                               size_t in_ldim,
+                               const El::Int* __restrict__ full_to_half,
+                               T* __restrict__ out,
+                               size_t out_ldim)
 {
-  El::EntrywiseMap(in, out, [] __device__(thrust::complex<float> const& x) {
-    return thrust::abs(x);
-  });
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      const auto& x = in[full_to_half[row] + col * in_ldim];
+      out[row + col * out_ldim] = thrust::abs(x);
+    }
+  }
 }
-void Abs(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
-         El::Matrix<double, El::Device::GPU>& out)
+
+/** Gradient of r2c_abs_kernel, as a Hermitian-packed spectrum.
+ *
+ *  x_k <- x_k * (dy_k + dy_{-k}) / (2 |x_k|)
+ *
+ *  Block dimensions: bsize x 1 x 1
+ *
+ *  Grid dimensions: (height / bsize) x width x 1
+ */
+template <typename T>
+__global__ void r2c_abs_grad_kernel(size_t height,
+                                    size_t width,
+                                    const T* __restrict__ grad_wrt_output,
+                                    size_t grad_wrt_output_ldim,
+                                    const El::Int* __restrict__ half_to_full,
+                                    const El::Int* __restrict__ half_to_mirror,
+                                    thrust::complex<T>* __restrict__ x,
+                                    size_t x_ldim)
 {
-  El::EntrywiseMap(in, out, [] __device__(thrust::complex<double> const& x) {
-    return thrust::abs(x);
-  });
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t col = gidy; col < width; col += nthreadsy) {
+    const auto* dy = grad_wrt_output + col * grad_wrt_output_ldim;
+    for (size_t row = gidx; row < height; row += nthreadsx) {
+      auto& xk = x[row + col * x_ldim];
+      const T abs_xk = thrust::abs(xk);
+      const T dyk = dy[half_to_full[row]] + dy[half_to_mirror[row]];
+      xk = (abs_xk == T(0) ? thrust::complex<T>(T(0))
+                           : xk * (dyk / (T(2) * abs_xk)));
+    }
+  }
 }
-void MyRealPart(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
-                El::Matrix<float, El::Device::GPU>& out)
+
+template <typename T>
+void R2CAbsImpl(El::Matrix<El::Complex<T>, El::Device::GPU> const& in,
+                El::Matrix<El::Int, El::Device::GPU> const& full_to_half,
+                El::Matrix<T, El::Device::GPU>& out)
+{
+  if (out.IsEmpty())
+    return;
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(out),
+                                     gpu::get_sync_info(in),
+                                     gpu::get_sync_info(full_to_half));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (out.Height() + block_size - 1) / block_size;
+  grid_dims.y = out.Width();
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    r2c_abs_kernel<T>,
+    grid_dims,
+    block_dims,
+    0,
+    multisync,
+    out.Height(),
+    out.Width(),
+    reinterpret_cast<const thrust::complex<T>*>(in.LockedBuffer()),
+    in.LDim(),
+    full_to_half.LockedBuffer(),
+    out.Buffer(),
+    out.LDim());
+}
+
+template <typename T>
+void ApplyR2CAbsGradientUpdateImpl(
+  El::Matrix<T, El::Device::GPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_mirror,
+  El::Matrix<El::Complex<T>, El::Device::GPU>& input_output)
+{
+  if (input_output.IsEmpty())
+    return;
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(input_output),
+                      gpu::get_sync_info(grad_wrt_output),
+                      gpu::get_sync_info(half_to_full),
+                      gpu::get_sync_info(half_to_mirror));
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (input_output.Height() + block_size - 1) / block_size;
+  grid_dims.y = input_output.Width();
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    r2c_abs_grad_kernel<T>,
+    grid_dims,
+    block_dims,
+    0,
+    multisync,
+    input_output.Height(),
+    input_output.Width(),
+    grad_wrt_output.LockedBuffer(),
+    grad_wrt_output.LDim(),
+    half_to_full.LockedBuffer(),
+    half_to_mirror.LockedBuffer(),
+    reinterpret_cast<thrust::complex<T>*>(input_output.Buffer()),
+    input_output.LDim());
+}
+
+} // namespace
+
+// Have to instantiate this in device-compiled code.
+void R2CAbs(El::Matrix<El::Complex<float>, El::Device::GPU> const& in,
+            El::Matrix<El::Int, El::Device::GPU> const& full_to_half,
+            El::Matrix<float, El::Device::GPU>& out)
 {
-  El::EntrywiseMap(in, out, [] __device__(thrust::complex<float> const& x) {
-    return x.real();
-  });
+  R2CAbsImpl(in, full_to_half, out);
 }
-void MyRealPart(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
-                El::Matrix<double, El::Device::GPU>& out)
+void R2CAbs(El::Matrix<El::Complex<double>, El::Device::GPU> const& in,
+            El::Matrix<El::Int, El::Device::GPU> const& full_to_half,
+            El::Matrix<double, El::Device::GPU>& out)
 {
-  El::EntrywiseMap(in, out, [] __device__(thrust::complex<float> const& x) {
-    return x.real();
-  });
+  R2CAbsImpl(in, full_to_half, out);
 }
-void ApplyAbsGradientUpdate(
+void ApplyR2CAbsGradientUpdate(
   El::Matrix<float, El::Device::GPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_mirror,
   El::Matrix<El::Complex<float>, El::Device::GPU>& input_output)
 {
-  using ComplexT = thrust::complex<float>;
-  El::Combine(grad_wrt_output,
-              input_output,
-              [] __device__(float const& dy, ComplexT const& x) {
-                return (x == ComplexT(0.f)
-                          ? ComplexT(0.f)
-                          : thrust::conj(x * (dy / thrust::abs(x))));
-              });
+  ApplyR2CAbsGradientUpdateImpl(grad_wrt_output,
+                                half_to_full,
+                                half_to_mirror,
+                                input_output);
 }
-void ApplyAbsGradientUpdate(
+void ApplyR2CAbsGradientUpdate(
   El::Matrix<double, El::Device::GPU> const& grad_wrt_output,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_full,
+  El::Matrix<El::Int, El::Device::GPU> const& half_to_mirror,
   El::Matrix<El::Complex<double>, El::Device::GPU>& input_output)
 {
-  using ComplexT = thrust::complex<double>;
-  El::Combine(grad_wrt_output,
-              input_output,
-              [] __device__(double const& dy, ComplexT const& x) {
-                return (x == ComplexT(0.0)
-                          ? ComplexT(0.0)
-                          : thrust::conj(x * (dy / thrust::abs(x))));
-              });
+  ApplyR2CAbsGradientUpdateImpl(grad_wrt_output,
+                                half_to_full,
+                                half_to_mirror,
+                                input_output);
 }
 } // namespace internal
-} // namespace lbann
\ No newline at end of file
+} // namespace lbann
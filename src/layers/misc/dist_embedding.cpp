@@ -335,6 +335,261 @@ void dist_embedding_layer<TensorDataType, Layout, Device>::
   }
 }
 
+} // namespace lbann
+#else // LBANN_HAS_SHMEM
+
+// =========================================================
+// CPU layer implementation with MPI all-to-all
+// =========================================================
+
+namespace lbann {
+
+namespace {
+
+/** Compute displacements from counts. */
+std::vector<int> get_displacements(const std::vector<int>& counts,
+                                   int scale = 1)
+{
+  std::vector<int> displs(counts.size(), 0);
+  for (size_t i = 1; i < counts.size(); ++i) {
+    displs[i] = displs[i - 1] + counts[i - 1] * scale;
+  }
+  return displs;
+}
+
+/** Scale counts by the size of embedding vectors. */
+std::vector<int> scale_counts(const std::vector<int>& counts, int scale)
+{
+  std::vector<int> scaled(counts);
+  for (auto& count : scaled) {
+    count *= scale;
+  }
+  return scaled;
+}
+
+} // namespace
+
+// ---------------------------------------------
+// Life cycle and setup
+// ---------------------------------------------
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+dist_embedding_layer<TensorDataType, Layout, Device>::~dist_embedding_layer()
+{}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::
+  attach_embeddings_to_shmem_buffer()
+{
+  // Embeddings are accessed with MPI collectives, so they don't need
+  // to be in a SHMEM buffer
+}
+
+// ---------------------------------------------
+// Forward prop
+// ---------------------------------------------
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+
+  // Data matrices
+  const auto& embeddings = this->weights_values(0);
+  const auto& local_embeddings =
+    dynamic_cast<const LocalMat&>(embeddings.LockedMatrix());
+  const auto& local_input =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_activations());
+  auto& local_output = dynamic_cast<LocalMat&>(this->get_local_activations());
+
+  // Dimensions
+  const size_t input_size = this->get_input_size();
+  const size_t local_mini_batch_size = local_input.Width();
+  const int embedding_dim = m_embedding_dim;
+
+  // Figure out which process owns each embedding vector
+  auto& comm = *this->get_comm();
+  const auto& dist_comm = embeddings.DistComm();
+  const size_t num_procs = El::mpi::Size(dist_comm);
+  std::vector<El::Int> indices(input_size * local_mini_batch_size, -1);
+  std::vector<int> owners(input_size * local_mini_batch_size, -1);
+  m_send_counts.assign(num_procs, 0);
+  for (size_t j = 0; j < local_mini_batch_size; ++j) {
+    for (size_t i = 0; i < input_size; ++i) {
+      const El::Int global_index =
+        static_cast<El::Int>(std::floor(local_input(i, j)));
+      if (0 <= global_index &&
+          global_index < static_cast<El::Int>(m_num_embeddings)) {
+        const auto owner = embeddings.Owner(0, global_index);
+        indices[i + j * input_size] = embeddings.LocalCol(global_index, owner);
+        owners[i + j * input_size] = owner;
+        ++m_send_counts[owner];
+      }
+    }
+  }
+
+  // Sort requests by owner process
+  const auto send_displs = get_displacements(m_send_counts);
+  const size_t num_requests = send_displs.back() + m_send_counts.back();
+  std::vector<El::Int> send_indices(num_requests);
+  m_request_positions.resize(num_requests);
+  {
+    auto offsets = send_displs;
+    for (size_t k = 0; k < indices.size(); ++k) {
+      if (owners[k] >= 0) {
+        const auto pos = offsets[owners[k]]++;
+        send_indices[pos] = indices[k];
+        m_request_positions[pos] = k;
+      }
+    }
+  }
+
+  // Send requests to owner processes
+  m_recv_counts.assign(num_procs, 0);
+  {
+    const std::vector<int> ones(num_procs, 1);
+    const auto displs = get_displacements(ones);
+    comm.all_to_all(m_send_counts.data(),
+                    ones,
+                    displs,
+                    m_recv_counts.data(),
+                    ones,
+                    displs,
+                    dist_comm);
+  }
+  const auto recv_displs = get_displacements(m_recv_counts);
+  const size_t num_requested = recv_displs.back() + m_recv_counts.back();
+  m_requested_indices.resize(num_requested);
+  comm.all_to_all(send_indices.data(),
+                  m_send_counts,
+                  send_displs,
+                  m_requested_indices.data(),
+                  m_recv_counts,
+                  recv_displs,
+                  dist_comm);
+
+  // Send requested embedding vectors
+  LocalMat send_vectors(m_embedding_dim, num_requested, m_embedding_dim);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t k = 0; k < num_requested; ++k) {
+    const auto* x = local_embeddings.LockedBuffer(0, m_requested_indices[k]);
+    std::copy(x, x + m_embedding_dim, send_vectors.Buffer(0, k));
+  }
+  LocalMat recv_vectors(m_embedding_dim, num_requests, m_embedding_dim);
+  comm.all_to_all(send_vectors.LockedBuffer(),
+                  scale_counts(m_recv_counts, embedding_dim),
+                  get_displacements(m_recv_counts, embedding_dim),
+                  recv_vectors.Buffer(),
+                  scale_counts(m_send_counts, embedding_dim),
+                  get_displacements(m_send_counts, embedding_dim),
+                  dist_comm);
+
+  // Copy embedding vectors to output tensor
+  El::Zero(local_output);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t pos = 0; pos < num_requests; ++pos) {
+    const size_t k = m_request_positions[pos];
+    const size_t i = k % input_size;
+    const size_t j = k / input_size;
+    const auto* x = recv_vectors.LockedBuffer(0, pos);
+    auto* y = local_output.Buffer(i * embedding_dim, j);
+    std::copy(x, x + m_embedding_dim, y);
+  }
+}
+
+// ---------------------------------------------
+// Backprop
+// ---------------------------------------------
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+
+  // Data matrices
+  const auto& embeddings = this->weights_values(0);
+  const auto& local_output_grad =
+    dynamic_cast<const LocalMat&>(this->get_local_prev_error_signals());
+
+  // Dimensions
+  const size_t input_size = this->get_input_size();
+  const size_t num_requests = m_request_positions.size();
+  const size_t num_requested = m_requested_indices.size();
+  const int embedding_dim = m_embedding_dim;
+
+  // Send gradients to owner processes
+  auto& comm = *this->get_comm();
+  LocalMat send_grads(m_embedding_dim, num_requests, m_embedding_dim);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t pos = 0; pos < num_requests; ++pos) {
+    const size_t k = m_request_positions[pos];
+    const size_t i = k % input_size;
+    const size_t j = k / input_size;
+    const auto* dy = local_output_grad.LockedBuffer(i * embedding_dim, j);
+    std::copy(dy, dy + m_embedding_dim, send_grads.Buffer(0, pos));
+  }
+  m_requested_grads.Resize(m_embedding_dim, num_requested, m_embedding_dim);
+  comm.all_to_all(send_grads.LockedBuffer(),
+                  scale_counts(m_send_counts, embedding_dim),
+                  get_displacements(m_send_counts, embedding_dim),
+                  m_requested_grads.Buffer(),
+                  scale_counts(m_recv_counts, embedding_dim),
+                  get_displacements(m_recv_counts, embedding_dim),
+                  embeddings.DistComm());
+
+  // Use dense optimizer if needed
+  if (!m_sparse_sgd) {
+
+    // Create buffer for dense gradients
+    std::unique_ptr<El::AbstractDistMatrix<TensorDataType>> embeddings_grad(
+      embeddings.Construct(embeddings.Grid(), embeddings.Root()));
+    embeddings_grad->AlignWith(embeddings);
+    El::Zeros(*embeddings_grad, embeddings.Height(), embeddings.Width());
+    auto& local_embeddings_grad =
+      dynamic_cast<LocalMat&>(embeddings_grad->Matrix());
+
+    // Apply SGD step to convert sparse gradients to dense gradients
+    apply_sparse_sgd_step(num_requested, local_embeddings_grad);
+
+    // Send dense gradients to dense optimizer
+    auto* opt = this->get_weights(0).get_optimizer();
+    if (opt != nullptr) {
+      opt->add_to_gradient(*embeddings_grad);
+    }
+  }
+}
+
+// ---------------------------------------------
+// Sparse SGD
+// ---------------------------------------------
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void dist_embedding_layer<TensorDataType, Layout, Device>::
+  apply_sparse_sgd_step(size_t num_gradients, LocalMat& local_embeddings)
+{
+  // Note: All gradients received during backprop are applied, so
+  // num_gradients is ignored. Each thread updates a contiguous range
+  // of local embedding vectors so that repeated indices don't race.
+  const size_t num_requested = m_requested_indices.size();
+  const size_t num_omp_threads = omp_get_max_threads();
+  const size_t embeddings_per_thread =
+    (local_embeddings.Width() + num_omp_threads - 1) / num_omp_threads;
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t thread = 0; thread < num_omp_threads; ++thread) {
+    const El::Int index_start = thread * embeddings_per_thread;
+    const El::Int index_end = (thread + 1) * embeddings_per_thread;
+    for (size_t i = 0; i < num_requested; ++i) {
+      const auto& index = m_requested_indices[i];
+      if (index_start <= index && index < index_end) {
+        const auto* dw = m_requested_grads.LockedBuffer(0, i);
+        auto* w = local_embeddings.Buffer(0, index);
+        EL_SIMD
+        for (size_t k = 0; k < m_embedding_dim; ++k) {
+          w[k] -= m_learning_rate * dw[k];
+        }
+      }
+    }
+  }
+}
+
 } // namespace lbann
 #endif // LBANN_HAS_SHMEM
 
@@ -383,10 +638,8 @@ struct Builder
       return std::make_unique<LayerType>(std::forward<Args>(args)...);         \
     }                                                                          \
   }
-#ifdef LBANN_HAS_SHMEM
 DEFINE_BUILDER(float, El::Device::CPU);
 DEFINE_BUILDER(double, El::Device::CPU);
-#endif // LBANN_HAS_SHMEM
 #if defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
 DEFINE_BUILDER(float, El::Device::GPU);
 DEFINE_BUILDER(double, El::Device::GPU);
@@ -415,14 +668,12 @@ build_dist_embedding_layer_from_pbuf(lbann_comm* comm,
 // ---------------------------------------------
 
 /// @todo fp16
-#ifdef LBANN_HAS_SHMEM
 template class dist_embedding_layer<float,
                                     data_layout::DATA_PARALLEL,
                                     El::Device::CPU>;
 template class dist_embedding_layer<double,
                                     data_layout::DATA_PARALLEL,
                                     El::Device::CPU>;
-#endif // LBANN_HAS_SHMEM
 #if defined(LBANN_HAS_GPU) && defined(LBANN_HAS_NVSHMEM)
 extern template class dist_embedding_layer<float,
                                            data_layout::DATA_PARALLEL,
@@ -28,6 +28,7 @@
 
 #include "lbann/layers/misc/argmax.hpp"
 #include "lbann/layers/misc/argmin.hpp"
+#include "lbann/layers/misc/attention.hpp"
 #include "lbann/layers/misc/channelwise_mean.hpp"
 #include "lbann/layers/misc/channelwise_softmax.hpp"
 #include "lbann/layers/misc/covariance.hpp"
@@ -161,13 +162,12 @@ std::unique_ptr<lbann::Layer>
 lbann::build_argmax_layer_from_pbuf(lbann_comm* comm,
                                     lbann_data::Layer const& /*proto_layer*/)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU)
+  if constexpr (L == data_layout::DATA_PARALLEL)
     return std::make_unique<
-      argmax_layer<T, data_layout::DATA_PARALLEL, El::Device::CPU>>(comm);
+      argmax_layer<T, data_layout::DATA_PARALLEL, D>>(comm);
   else {
     (void)comm;
-    LBANN_ERROR(
-      "argmax layer is only supported with a data-parallel layout and on CPU");
+    LBANN_ERROR("argmax layer is only supported with a data-parallel layout");
     return nullptr;
   }
 }
@@ -177,13 +177,12 @@ std::unique_ptr<lbann::Layer>
 lbann::build_argmin_layer_from_pbuf(lbann_comm* comm,
                                     lbann_data::Layer const& /*proto_layer*/)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU)
+  if constexpr (L == data_layout::DATA_PARALLEL)
     return std::make_unique<
-      argmin_layer<T, data_layout::DATA_PARALLEL, El::Device::CPU>>(comm);
+      argmin_layer<T, data_layout::DATA_PARALLEL, D>>(comm);
   else {
     (void)comm;
-    LBANN_ERROR(
-      "argmin layer is only supported with a data-parallel layout and on CPU");
+    LBANN_ERROR("argmin layer is only supported with a data-parallel layout");
     return nullptr;
   }
 }
@@ -205,6 +204,27 @@ std::unique_ptr<lbann::Layer> lbann::build_channelwise_mean_layer_from_pbuf(
   }
 }
 
+template <typename T, lbann::data_layout L, El::Device D>
+std::unique_ptr<lbann::Layer>
+lbann::build_attention_layer_from_pbuf(lbann_comm* comm,
+                                       lbann_data::Layer const& proto_layer)
+{
+  if constexpr (L == data_layout::DATA_PARALLEL) {
+    const auto& params = proto_layer.attention();
+    return std::make_unique<attention_layer<T, data_layout::DATA_PARALLEL, D>>(
+      comm,
+      params.num_heads(),
+      params.causal());
+  }
+  else {
+    (void)comm;
+    (void)proto_layer;
+    LBANN_ERROR("attention layer is only supported with "
+                "a data-parallel layout");
+    return nullptr;
+  }
+}
+
 template <typename T, lbann::data_layout L, El::Device D>
 std::unique_ptr<lbann::Layer>
 lbann::build_channelwise_softmax_layer_from_pbuf(lbann_comm* comm,
@@ -336,6 +356,7 @@ namespace lbann {
 #define PROTO_DEVICE(T, Device)                                                \
   LBANN_LAYER_BUILDER_ETI(argmax, T, Device);                                  \
   LBANN_LAYER_BUILDER_ETI(argmin, T, Device);                                  \
+  LBANN_LAYER_BUILDER_ETI(attention, T, Device);                               \
   LBANN_LAYER_BUILDER_ETI(channelwise_mean, T, Device);                        \
   LBANN_LAYER_BUILDER_ETI(channelwise_softmax, T, Device);                     \
   LBANN_LAYER_BUILDER_ETI(covariance, T, Device);                              \
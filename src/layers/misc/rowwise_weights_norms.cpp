@@ -29,46 +29,6 @@
 
 namespace lbann {
 
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void rowwise_weights_norms_layer<TensorDataType, Layout, Device>::row_sqsums(
-  const El::Matrix<TensorDataType, Device>& mat,
-  El::Matrix<TensorDataType, Device>& row_sqsums)
-{
-
-  // Matrix data
-  const size_t height = mat.Height();
-  const size_t width = mat.Width();
-  const TensorDataType* __restrict__ mat_buf = mat.LockedBuffer();
-  const size_t mat_ldim = mat.LDim();
-  TensorDataType* __restrict__ row_sqsums_buf = row_sqsums.Buffer();
-
-  // Block size for loops
-  // Note: x86 cache lines are 64B
-  constexpr size_t _bsize = 64 / sizeof(TensorDataType);
-  constexpr size_t bsize = _bsize > 1 ? _bsize : 1;
-
-  // Compute sums of squares for each row
-  El::Zero(row_sqsums);
-  LBANN_OMP_PARALLEL_FOR
-  for (size_t row_start = 0; row_start < height; row_start += bsize) {
-    const size_t row_end = std::min(row_start + bsize, height);
-    for (size_t col = 0; col < width; ++col) {
-      for (size_t row = row_start; row < row_end; ++row) {
-        const auto& x = mat_buf[row + col * mat_ldim];
-        auto& y = row_sqsums_buf[row];
-        y += x * x;
-      }
-    }
-  }
-}
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void rowwise_weights_norms_layer<TensorDataType, Layout, Device>::sqrt(
-  El::Matrix<TensorDataType, Device>& mat)
-{
-  El::EntrywiseMap(mat, {[](TensorDataType const& a) { return El::Sqrt(a); }});
-}
-
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void rowwise_weights_norms_layer<TensorDataType, Layout, Device>::divide(
   El::Matrix<TensorDataType, Device>& numer,
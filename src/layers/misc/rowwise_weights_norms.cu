@@ -32,117 +32,6 @@ namespace lbann {
 
 namespace {
 
-/**
- *  Block dimensions: bdimx x bdimy x 1
- *
- *  Grid dimensions: (height/bdimx) x (width/bdimy) x 1
- */
-template <typename T>
-__global__ void row_sqsums_kernel(size_t height,
-                                  size_t width,
-                                  const T* __restrict__ mat,
-                                  size_t mat_ldim,
-                                  T* __restrict__ row_sqsums)
-{
-
-  // Indices
-  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
-  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
-  const size_t nthreadsx = blockDim.x * gridDim.x;
-  const size_t nthreadsy = blockDim.y * gridDim.y;
-
-  // Accumulate sum of squares for each matrix row
-  for (size_t row = gidx; row < height; row += nthreadsx) {
-    T sqsum{0};
-    for (size_t col = gidy; col < width; col += nthreadsy) {
-      const auto& x = mat[row + col * mat_ldim];
-      sqsum += x * x;
-    }
-    gpu_lib::atomic_add(&row_sqsums[row], sqsum);
-  }
-}
-
-} // namespace
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void rowwise_weights_norms_layer<TensorDataType, Layout, Device>::row_sqsums(
-  const El::Matrix<TensorDataType, Device>& mat,
-  El::Matrix<TensorDataType, Device>& row_sqsums)
-{
-
-  // Launch kernel
-  El::Zero(row_sqsums);
-  if (!mat.IsEmpty()) {
-    auto multisync = El::MakeMultiSync(gpu::get_sync_info(row_sqsums),
-                                       gpu::get_sync_info(mat));
-    constexpr size_t block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    block_dims.y = 1;
-    grid_dims.x = (mat.Height() + block_dims.x - 1) / block_dims.x;
-    grid_dims.y = (mat.Width() / 64 + block_dims.y - 1) / block_dims.y;
-    grid_dims.y = El::Min(El::Max(grid_dims.y, 1), 65536);
-    hydrogen::gpu::LaunchKernel(row_sqsums_kernel<TensorDataType>,
-                                grid_dims,
-                                block_dims,
-                                0,
-                                multisync,
-                                static_cast<size_t>(mat.Height()),
-                                static_cast<size_t>(mat.Width()),
-                                mat.LockedBuffer(),
-                                static_cast<size_t>(mat.LDim()),
-                                row_sqsums.Buffer());
-  }
-}
-
-namespace {
-
-/**
- *  Block dimensions: bdim x 1 x 1
- *
- *  Grid dimensions: (size/bdim) x 1 x 1
- */
-template <typename T>
-__global__ void sqrt_kernel(size_t size, T* __restrict__ buf)
-{
-  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
-  const size_t nthreads = blockDim.x * gridDim.x;
-  for (size_t i = gid; i < size; i += nthreads) {
-    auto& x = buf[i];
-    x = gpu_lib::sqrt(x);
-  }
-}
-
-} // namespace
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void rowwise_weights_norms_layer<TensorDataType, Layout, Device>::sqrt(
-  El::Matrix<TensorDataType, Device>& mat)
-{
-
-  // Check that matrix is valid
-  if (!mat.Contiguous()) {
-    LBANN_ERROR("matrix is not contiguous");
-  }
-
-  // Launch kernel
-  if (!mat.IsEmpty()) {
-    constexpr size_t block_size = 256;
-    dim3 block_dims, grid_dims;
-    block_dims.x = block_size;
-    grid_dims.x = (mat.Height() * mat.Width() + block_size - 1) / block_size;
-    hydrogen::gpu::LaunchKernel(sqrt_kernel<TensorDataType>,
-                                grid_dims,
-                                block_dims,
-                                0,
-                                gpu::get_sync_info(mat),
-                                static_cast<size_t>(mat.Height() * mat.Width()),
-                                mat.Buffer());
-  }
-}
-
-namespace {
-
 /**
  *  Block dimensions: bdim x 1 x 1
  *
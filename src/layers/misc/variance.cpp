@@ -32,59 +32,98 @@ namespace lbann {
 namespace {
 
 /** CPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Each column is shifted by its first local entry, which keeps the
+ *  one-pass sums as accurate as a two-pass algorithm. If the input
+ *  is split between processes, each process packs its count, mean
+ *  and sum of squared deviations into its own rows of @c partials
+ *  and the rows of all processes are combined after an allreduce.
  */
 template <typename TensorDataType>
 void fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input,
             El::AbstractDistMatrix<TensorDataType>& output,
             El::AbstractDistMatrix<TensorDataType>& means,
             El::AbstractDistMatrix<TensorDataType>& workspace,
+            El::AbstractDistMatrix<TensorDataType>& partials,
             bool biased)
 {
   using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+  const auto zero = El::TypeTraits<TensorDataType>::Zero();
 
   // Local matrices
   const auto& local_input =
     static_cast<const CPUMatType&>(input.LockedMatrix());
   auto& local_means = static_cast<CPUMatType&>(means.Matrix());
   auto& local_workspace = static_cast<CPUMatType&>(workspace.Matrix());
+  auto& local_partials = static_cast<CPUMatType&>(partials.Matrix());
 
   // Dimensions
   const auto& height = input.Height();
   const auto& width = input.Width();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
+  const TensorDataType scale =
+    El::To<TensorDataType>(biased ? height : height - 1);
 
-  // Compute column-wise mean
+  // Column-wise statistics
   means.Empty(false);
   means.AlignWith(input);
   means.Resize(1, width);
-  LBANN_OMP_PARALLEL_FOR
-  for (El::Int col = 0; col < local_width; ++col) {
-    TensorDataType sum = El::To<TensorDataType>(0);
-    for (El::Int row = 0; row < local_height; ++row) {
-      sum += local_input(row, col);
-    }
-    local_means(0, col) = sum / height;
-  }
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise variance
   workspace.Empty(false);
   workspace.AlignWith(input);
   workspace.Resize(1, width);
+  const El::Int num_procs = means.RedundantSize();
+  const El::Int slot = 3 * means.RedundantRank();
+  if (num_procs > 1) {
+    partials.Empty(false);
+    partials.AlignWith(input);
+    El::Zeros(partials, 3 * num_procs, width);
+  }
+
+  // Compute local count, mean and sum of squared deviations
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    const auto& mean = local_means(0, col);
-    TensorDataType sum = El::To<TensorDataType>(0);
+    const auto shift = local_height > 0 ? local_input(0, col) : zero;
+    TensorDataType sum = zero, sqsum = zero;
     for (El::Int row = 0; row < local_height; ++row) {
-      const auto& diff = local_input(row, col) - mean;
-      sum += diff * diff;
+      const auto& diff = local_input(row, col) - shift;
+      sum += diff;
+      sqsum += diff * diff;
+    }
+    const auto count = El::To<TensorDataType>(local_height);
+    const auto mean_diff = local_height > 0 ? sum / count : zero;
+    const auto m2 = sqsum - sum * mean_diff;
+    if (num_procs == 1) {
+      local_means(0, col) = shift + mean_diff;
+      local_workspace(0, col) = m2 / scale;
+    }
+    else {
+      local_partials(slot, col) = count;
+      local_partials(slot + 1, col) = shift + mean_diff;
+      local_partials(slot + 2, col) = m2;
+    }
+  }
+
+  // Combine statistics of all processes
+  if (num_procs > 1) {
+    El::AllReduce(partials, partials.RedundantComm());
+    const auto total = El::To<TensorDataType>(height);
+    LBANN_OMP_PARALLEL_FOR
+    for (El::Int col = 0; col < local_width; ++col) {
+      TensorDataType mean = zero;
+      for (El::Int i = 0; i < num_procs; ++i) {
+        mean += local_partials(3 * i, col) * local_partials(3 * i + 1, col);
+      }
+      mean /= total;
+      TensorDataType m2 = zero;
+      for (El::Int i = 0; i < num_procs; ++i) {
+        const auto& diff = local_partials(3 * i + 1, col) - mean;
+        m2 += local_partials(3 * i + 2, col) +
+              local_partials(3 * i, col) * diff * diff;
+      }
+      local_means(0, col) = mean;
+      local_workspace(0, col) = m2 / scale;
     }
-    local_workspace(0, col) = sum / (biased ? height : height - 1);
   }
-  El::AllReduce(workspace, workspace.RedundantComm());
   El::Copy(workspace, output);
 }
 
@@ -143,6 +182,7 @@ void variance_layer<TensorDataType, Layout, Device>::fp_compute()
          this->get_activations(),
          *this->m_means,
          *this->m_workspace,
+         *this->m_partials,
          this->m_biased);
 }
 
@@ -32,47 +32,103 @@ namespace lbann {
 
 namespace {
 
+/** Compute column-wise statistics in one pass.
+ *  Each block handles whole columns, shifted by their first
+ *  entry. With one process, the mean and variance are written to
+ *  @c means and @c variances. Otherwise the count, mean and sum of
+ *  squared deviations are written to rows @c slot to @c slot+2 of
+ *  @c partials.
+ */
 template <typename TensorDataType, El::Int block_size>
 __global__ void
-variance_contribution_kernel(El::Int height,
-                             El::Int width,
-                             TensorDataType scale,
-                             const TensorDataType* __restrict__ input,
-                             El::Int input_ldim,
-                             const TensorDataType* __restrict__ means,
-                             TensorDataType* __restrict__ contribution)
+variance_moments_kernel(El::Int height,
+                        El::Int width,
+                        TensorDataType scale,
+                        const TensorDataType* __restrict__ input,
+                        El::Int input_ldim,
+                        TensorDataType* __restrict__ means,
+                        TensorDataType* __restrict__ variances,
+                        TensorDataType* __restrict__ partials,
+                        El::Int partials_ldim,
+                        El::Int slot)
 {
 
   // Indices
   const El::Int tid = threadIdx.x;
-  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
   const El::Int bidy = blockIdx.y;
-  const El::Int nthreadsx = blockDim.x * gridDim.x;
 
-  // Compute local contribution for each matrix column
+  __shared__ TensorDataType shared_sum[block_size];
+  __shared__ TensorDataType shared_sqsum[block_size];
   for (El::Int col = bidy; col < width; col += gridDim.y) {
-    const auto& mean = means[col];
+    const auto shift =
+      height > 0 ? input[col * input_ldim] : TensorDataType(0.f);
 
-    // Compute contributions for each thread
-    TensorDataType private_contribution = 0;
-    for (El::Int row = gidx; row < height; row += nthreadsx) {
-      const auto& diff = input[row + col * input_ldim] - mean;
-      private_contribution += diff * diff;
+    // Compute shifted sums for each thread
+    TensorDataType private_sum = 0, private_sqsum = 0;
+    for (El::Int row = tid; row < height; row += block_size) {
+      const auto& diff = input[row + col * input_ldim] - shift;
+      private_sum += diff;
+      private_sqsum += diff * diff;
     }
 
-    // Shared memory reduction to get contribution for each block
-    /// @todo unroll loops
-    __shared__ TensorDataType shared_contribution[block_size];
-    shared_contribution[tid] = private_contribution;
+    // Shared memory reduction to get sums for the column
+    shared_sum[tid] = private_sum;
+    shared_sqsum[tid] = private_sqsum;
     for (El::Int stride = block_size / 2; stride > 0; stride /= 2) {
       __syncthreads();
       if (tid < stride) {
-        shared_contribution[tid] += shared_contribution[tid + stride];
+        shared_sum[tid] += shared_sum[tid + stride];
+        shared_sqsum[tid] += shared_sqsum[tid + stride];
       }
     }
     if (tid == 0) {
-      gpu_lib::atomic_add(&contribution[col], scale * shared_contribution[0]);
+      const auto& sum = shared_sum[0];
+      const TensorDataType count = TensorDataType(height);
+      const auto mean_diff = height > 0 ? sum / count : TensorDataType(0.f);
+      const auto m2 = shared_sqsum[0] - sum * mean_diff;
+      if (partials == nullptr) {
+        means[col] = shift + mean_diff;
+        variances[col] = m2 / scale;
+      }
+      else {
+        partials[slot + col * partials_ldim] = count;
+        partials[slot + 1 + col * partials_ldim] = shift + mean_diff;
+        partials[slot + 2 + col * partials_ldim] = m2;
+      }
+    }
+    __syncthreads();
+  }
+}
+
+/** Combine the statistics of @c num_procs processes, packed as
+ *  count, mean and sum of squared deviations. */
+template <typename TensorDataType>
+__global__ void
+variance_combine_kernel(El::Int num_procs,
+                        El::Int width,
+                        TensorDataType total,
+                        TensorDataType scale,
+                        const TensorDataType* __restrict__ partials,
+                        El::Int partials_ldim,
+                        TensorDataType* __restrict__ means,
+                        TensorDataType* __restrict__ variances)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  for (El::Int col = gid; col < width; col += nthreads) {
+    const auto* stats = &partials[col * partials_ldim];
+    TensorDataType mean = 0;
+    for (El::Int i = 0; i < num_procs; ++i) {
+      mean += stats[3 * i] * stats[3 * i + 1];
     }
+    mean /= total;
+    TensorDataType m2 = 0;
+    for (El::Int i = 0; i < num_procs; ++i) {
+      const auto& diff = stats[3 * i + 1] - mean;
+      m2 += stats[3 * i + 2] + stats[3 * i] * diff * diff;
+    }
+    means[col] = mean;
+    variances[col] = m2 / scale;
   }
 }
 
@@ -103,14 +159,17 @@ variance_backprop_kernel(El::Int height,
 }
 
 /** GPU forward prop implementation.
- *  We use a two-pass algorithm since it is more numerically stable
- *  than the naive single-pass algorithm.
+ *  Columns are shifted by their first local entry, which keeps the
+ *  one-pass sums as accurate as a two-pass algorithm. If the input
+ *  is split between processes, their statistics are packed into
+ *  @c partials, allreduced and combined.
  */
 template <typename TensorDataType>
 void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
             El::AbstractDistMatrix<TensorDataType>& output,
             El::AbstractDistMatrix<TensorDataType>& means,
             El::AbstractDistMatrix<TensorDataType>& workspace,
+            El::AbstractDistMatrix<TensorDataType>& partials,
             bool biased)
 {
 
@@ -123,49 +182,42 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
   auto& local_workspace =
     static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
       workspace.Matrix());
+  auto& local_partials =
+    static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+      partials.Matrix());
 
   // Dimensions
   const auto& height = input.Height();
   const auto& width = input.Width();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
+  const auto scale =
+    biased ? TensorDataType(height) : TensorDataType(height - 1);
 
-  // Compute column-wise mean
+  // Column-wise statistics
   means.Empty(false);
   means.AlignWith(input);
   means.Resize(1, width);
-  El::Matrix<TensorDataType, El::Device::GPU> ones;
-#ifdef HYDROGEN_HAVE_CUB
-  ones.SetMemoryMode(1); // Use CUB GPU memory pool
-#endif                   // HYDROGEN_HAVE_CUB
-  ones.Resize(local_height, 1);
-  El::Fill(ones, El::TypeTraits<TensorDataType>::One());
-  El::Gemv(El::TRANSPOSE,
-           El::TypeTraits<TensorDataType>::One() / TensorDataType(height),
-           local_input,
-           ones,
-           El::TypeTraits<TensorDataType>::Zero(),
-           local_means);
-  El::AllReduce(means, means.RedundantComm());
-
-  // Compute column-wise variance
   workspace.Empty(false);
   workspace.AlignWith(input);
-  El::Zeros(workspace, 1, width);
-  if (!local_input.IsEmpty()) {
+  workspace.Resize(1, width);
+  const El::Int num_procs = means.RedundantSize();
+  if (num_procs > 1) {
+    partials.Empty(false);
+    partials.AlignWith(input);
+    El::Zeros(partials, 3 * num_procs, width);
+  }
+  if (local_width > 0) {
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
                                        gpu::get_sync_info(local_means),
+                                       gpu::get_sync_info(local_partials),
                                        gpu::get_sync_info(local_input));
     constexpr El::Int block_size = 256;
     dim3 block_dims, grid_dims;
     block_dims.x = block_size;
-    grid_dims.x = (local_height + block_size - 1) / block_size;
-    grid_dims.y = local_width;
-    const auto& scale =
-      El::TypeTraits<TensorDataType>::One() /
-      (biased ? TensorDataType(height) : TensorDataType(height - 1));
+    grid_dims.y = std::min(local_width, El::Int(65535));
     hydrogen::gpu::LaunchKernel(
-      variance_contribution_kernel<TensorDataType, block_size>,
+      variance_moments_kernel<TensorDataType, block_size>,
       grid_dims,
       block_dims,
       0,
@@ -175,10 +227,38 @@ void fp_gpu(const El::AbstractDistMatrix<TensorDataType>& input,
       scale,
       local_input.LockedBuffer(),
       local_input.LDim(),
-      local_means.LockedBuffer(),
-      local_workspace.Buffer());
+      local_means.Buffer(),
+      local_workspace.Buffer(),
+      num_procs > 1 ? local_partials.Buffer() : nullptr,
+      local_partials.LDim(),
+      3 * means.RedundantRank());
+  }
+
+  // Combine statistics of all processes
+  if (num_procs > 1) {
+    El::AllReduce(partials, partials.RedundantComm());
+    if (local_width > 0) {
+      auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_workspace),
+                                         gpu::get_sync_info(local_means),
+                                         gpu::get_sync_info(local_partials));
+      constexpr El::Int block_size = 256;
+      const El::Int grid_size = (local_width + block_size - 1) / block_size;
+      hydrogen::gpu::LaunchKernel(
+        variance_combine_kernel<TensorDataType>,
+        grid_size,
+        block_size,
+        0,
+        multisync,
+        num_procs,
+        local_width,
+        TensorDataType(height),
+        scale,
+        local_partials.LockedBuffer(),
+        local_partials.LDim(),
+        local_means.Buffer(),
+        local_workspace.Buffer());
+    }
   }
-  El::AllReduce(workspace, workspace.RedundantComm());
   El::Copy(workspace, output);
 }
 
@@ -255,6 +335,7 @@ void variance_layer<TensorDataType, Layout, Device>::fp_compute()
          this->get_activations(),
          *this->m_means,
          *this->m_workspace,
+         *this->m_partials,
          this->m_biased);
 }
 
@@ -53,6 +53,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
   const auto& output_dims = this->get_output_dims();
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
+  const El::Int channel_stride = m_channels_last ? 1 : channel_size;
+  const El::Int spatial_stride = m_channels_last ? num_channels : 1;
 
   // Compute statistics
   if (is_training) {
@@ -64,16 +66,19 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
       ValuesGetter::mutable_values(this->get_weights(2)).Matrix();
     auto& local_running_var =
       ValuesGetter::mutable_values(this->get_weights(3)).Matrix();
-    // Compute sums and sums of squares
+    // Compute sums and sums of squares in one pass. Inputs are
+    // shifted by the running mean, which is the same on every rank in
+    // the statistics group, to avoid cancellation in the variance.
     LBANN_OMP_PARALLEL_FOR
     for (El::Int channel = 0; channel < num_channels; ++channel) {
+      const TensorDataType shift = local_running_mean(channel, 0);
       TensorDataType sum = zero;
       TensorDataType sqsum = zero;
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel + 1) * channel_size;
+      const auto& row_start = channel * channel_stride;
+      const auto& row_end = row_start + channel_size * spatial_stride;
       for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
-          const auto& x = local_input(row, col);
+        for (El::Int row = row_start; row < row_end; row += spatial_stride) {
+          const auto& x = local_input(row, col) - shift;
           sum += x;
           sqsum += x * x;
         }
@@ -114,20 +119,22 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
 
     // Compute minibatch statistics
     if (num_per_sum <= 1) {
+      El::Axpy(one, local_running_mean, local_mean);
       El::Fill(local_var, one);
     }
     else {
       LBANN_OMP_PARALLEL_FOR
       for (El::Int channel = 0; channel < num_channels; ++channel) {
         auto num_per_sum_dt = El::To<TensorDataType>(num_per_sum);
-        const auto& mean = local_mean(channel, 0) / num_per_sum_dt;
+        auto mean = local_mean(channel, 0) / num_per_sum_dt;
         const auto& sqmean = local_var(channel, 0) / num_per_sum_dt;
         auto var = num_per_sum_dt * (sqmean - mean * mean) /
                    (num_per_sum_dt - El::TypeTraits<TensorDataType>::One());
         var = std::max(var, this->m_epsilon);
+        auto& running_mean = local_running_mean(channel, 0);
+        mean += running_mean;
         local_mean(channel, 0) = mean;
         local_var(channel, 0) = var;
-        auto& running_mean = local_running_mean(channel, 0);
         auto& running_var = local_running_var(channel, 0);
         running_mean =
           this->m_decay * running_mean + (one - this->m_decay) * mean;
@@ -159,10 +166,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
     const auto& bias = local_bias(channel, 0);
 
     // Apply batch normalization to inputs in channel
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel + 1) * channel_size;
+    const auto& row_start = channel * channel_stride;
+    const auto& row_end = row_start + channel_size * spatial_stride;
     for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
+      for (El::Int row = row_start; row < row_end; row += spatial_stride) {
         const auto& x = local_input(row, col);
         const auto& xhat = (x - mean) * inv_stdev;
         auto& y = local_output(row, col);
@@ -202,6 +209,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
   const auto& output_dims = this->get_output_dims();
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
+  const El::Int channel_stride = m_channels_last ? 1 : channel_size;
+  const El::Int spatial_stride = m_channels_last ? num_channels : 1;
 
   // Compute local gradients
   LBANN_OMP_PARALLEL_FOR
@@ -220,10 +229,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
     TensorDataType dbias = El::TypeTraits<TensorDataType>::Zero();
 
     // Compute gradient contributions from local entries
-    const auto& row_start = channel * channel_size;
-    const auto& row_end = (channel + 1) * channel_size;
+    const auto& row_start = channel * channel_stride;
+    const auto& row_end = row_start + channel_size * spatial_stride;
     for (El::Int col = 0; col < local_width; ++col) {
-      for (El::Int row = row_start; row < row_end; ++row) {
+      for (El::Int row = row_start; row < row_end; row += spatial_stride) {
         const auto& x = local_input(row, col);
         const auto& xhat = (x - mean) * inv_stdev;
         const auto& dy = local_gradient_wrt_output(row, col);
@@ -309,10 +318,10 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
       const auto& dvar_term = dvar * 2 / (num_per_sum - 1);
 
       // Compute error signal for current channel
-      const auto& row_start = channel * channel_size;
-      const auto& row_end = (channel + 1) * channel_size;
+      const auto& row_start = channel * channel_stride;
+      const auto& row_end = row_start + channel_size * spatial_stride;
       for (El::Int col = 0; col < local_width; ++col) {
-        for (El::Int row = row_start; row < row_end; ++row) {
+        for (El::Int row = row_start; row < row_end; row += spatial_stride) {
           const auto& x = local_input(row, col);
           const auto& dy = local_gradient_wrt_output(row, col);
           const auto& dxhat = dy * scale;
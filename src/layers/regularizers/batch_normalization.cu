@@ -55,7 +55,9 @@ struct array_sum
 
 /** Accumulate sums and sums of squares for each channel.
  *
- *  On input, sums and sqsums are assumed to be filled with zeros.
+ *  Inputs are shifted by the running mean to avoid cancellation when
+ *  the variance is computed. On input, sums and sqsums are assumed to
+ *  be filled with zeros.
  *
  *  Block dimensions: bsize x 1 x 1
  *
@@ -65,8 +67,11 @@ template <typename TensorDataType, int bdimx>
 __global__ void fp_sums_kernel(int mini_batch_size,
                                int num_channels,
                                int channel_size,
+                               int channel_stride,
+                               int spatial_stride,
                                const TensorDataType* __restrict__ data,
                                int data_ldim,
+                               const TensorDataType* __restrict__ shifts,
                                TensorDataType* __restrict__ sums,
                                TensorDataType* __restrict__ sqsums)
 {
@@ -83,6 +88,7 @@ __global__ void fp_sums_kernel(int mini_batch_size,
   for (int channel = gidy; channel < num_channels; channel += nthreadsy) {
 
     // Accumulate sums and perform block-wide reduction
+    const auto shift = shifts[channel];
     using array_t = gpu_lib::array<TensorDataType, 2>;
     using array_sum_t = array_sum<TensorDataType, 2>;
     array_t sum_sqsum;
@@ -90,7 +96,8 @@ __global__ void fp_sums_kernel(int mini_batch_size,
     sum_sqsum[1] = TensorDataType(0);
     for (int i = gidx; i < channel_size; i += nthreadsx) {
       for (int j = 0; j < mini_batch_size; ++j) {
-        const auto& x = data[i + channel * channel_size + j * data_ldim];
+        const auto& offset = i * spatial_stride + channel * channel_stride;
+        const auto x = data[offset + j * data_ldim] - shift;
         sum_sqsum[0] += x;
         sum_sqsum[1] += x * x;
       }
@@ -110,7 +117,8 @@ __global__ void fp_sums_kernel(int mini_batch_size,
 /** Compute statistics for each channel.
  *
  *  On input, global_mean and global_var are assumed to contain sums
- *  and squares of sums, respectively.
+ *  and squares of sums, respectively, of inputs shifted by the
+ *  running mean.
  *
  *  Block dimensions: bsize x 1 x 1
  *
@@ -134,16 +142,17 @@ fp_statistics_kernel(int num_sums,
 
     TensorDataType num_per_sum_dt = TensorDataType(num_per_sum);
     // Compute mean and variance
-    const auto& mean = global_mean[i] / num_per_sum_dt;
+    const auto& shifted_mean = global_mean[i] / num_per_sum_dt;
     const auto& sqmean = global_var[i] / num_per_sum_dt;
-    auto var =
-      num_per_sum_dt * (sqmean - mean * mean) / TensorDataType(num_per_sum - 1);
+    auto var = num_per_sum_dt * (sqmean - shifted_mean * shifted_mean) /
+               TensorDataType(num_per_sum - 1);
     var = var > epsilon ? var : epsilon;
+    auto& running_mean = global_running_mean[i];
+    const auto mean = shifted_mean + running_mean;
     global_mean[i] = mean;
     global_var[i] = var;
 
     // Compute running statistics
-    auto& running_mean = global_running_mean[i];
     auto& running_var = global_running_var[i];
     running_mean = decay * running_mean + (TensorDataType(1.0) - decay) * mean;
     running_var = decay * running_var + (TensorDataType(1.0) - decay) * var;
@@ -165,6 +174,8 @@ __global__ void
 fp_output_kernel(int mini_batch_size,
                  int num_channels,
                  int channel_size,
+                 int channel_stride,
+                 int spatial_stride,
                  const TensorDataType* __restrict__ global_input,
                  int input_ldim,
                  const TensorDataType* __restrict__ global_mean,
@@ -192,10 +203,11 @@ fp_output_kernel(int mini_batch_size,
     const auto& bias = global_bias[k];
     for (auto j = gidy; j < mini_batch_size; j += nthreadsy) {
       for (auto i = gidx; i < channel_size; i += nthreadsx) {
-        const auto& x = global_input[i + k * channel_size + j * input_ldim];
+        const auto& offset = i * spatial_stride + k * channel_stride;
+        const auto& x = global_input[offset + j * input_ldim];
         const auto& xhat = (x - mean) * inv_stdev;
         const auto& y = scale * xhat + bias;
-        global_output[i + k * channel_size + j * output_ldim] = y;
+        global_output[offset + j * output_ldim] = y;
       }
     }
   }
@@ -222,6 +234,8 @@ __global__ void bp_statistics_grad_kernel(
   int mini_batch_size,
   int num_channels,
   int channel_size,
+  int channel_stride,
+  int spatial_stride,
   const TensorDataType* __restrict__ global_input,
   int input_ldim,
   const TensorDataType* __restrict__ global_gradient_wrt_output,
@@ -267,12 +281,11 @@ __global__ void bp_statistics_grad_kernel(
     sums[3] = TensorDataType(0);
     for (int i = gidx; i < channel_size; i += nthreadsx) {
       for (int j = 0; j < mini_batch_size; ++j) {
-        const auto& x =
-          global_input[i + channel * channel_size + j * input_ldim];
+        const auto& offset = i * spatial_stride + channel * channel_stride;
+        const auto& x = global_input[offset + j * input_ldim];
         const auto& xhat = (x - mean) * inv_stdev;
         const auto& dy =
-          global_gradient_wrt_output[i + channel * channel_size +
-                                     j * gradient_wrt_output_ldim];
+          global_gradient_wrt_output[offset + j * gradient_wrt_output_ldim];
         sums[0] += dy * xhat;
         sums[1] += dy;
         const auto& dxhat = dy * scale;
@@ -309,6 +322,8 @@ __global__ void bp_input_grad_kernel(
   int mini_batch_size,
   int num_channels,
   int channel_size,
+  int channel_stride,
+  int spatial_stride,
   int num_per_sum,
   const TensorDataType* __restrict__ global_input,
   int input_ldim,
@@ -344,13 +359,13 @@ __global__ void bp_input_grad_kernel(
       dvar * TensorDataType(2) / TensorDataType(num_per_sum - 1);
     for (auto j = gidy; j < mini_batch_size; j += nthreadsy) {
       for (auto i = gidx; i < channel_size; i += nthreadsx) {
-        const auto& x = global_input[i + k * channel_size + j * input_ldim];
+        const auto& offset = i * spatial_stride + k * channel_stride;
+        const auto& x = global_input[offset + j * input_ldim];
         const auto& dy =
-          global_gradient_wrt_output[i + k * channel_size +
-                                     j * gradient_wrt_output_ldim];
+          global_gradient_wrt_output[offset + j * gradient_wrt_output_ldim];
         const auto& dxhat = dy * scale;
-        auto& dx = global_gradient_wrt_input[i + k * channel_size +
-                                             j * gradient_wrt_input_ldim];
+        auto& dx =
+          global_gradient_wrt_input[offset + j * gradient_wrt_input_ldim];
         dx = dxhat * inv_stdev + dmean_term + dvar_term * (x - mean);
       }
     }
@@ -510,6 +525,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
   const auto& output_dims = this->get_output_dims();
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
+  const int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   // Compute statistics
   if (is_training) {
@@ -527,9 +544,11 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
     El::Zero(local_mean);
     El::Zero(local_var);
     if (!local_input.IsEmpty()) {
-      auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_mean),
-                                         gpu::get_sync_info(local_var),
-                                         gpu::get_sync_info(local_input));
+      auto multisync =
+        El::MakeMultiSync(gpu::get_sync_info(local_mean),
+                          gpu::get_sync_info(local_var),
+                          gpu::get_sync_info(local_running_mean),
+                          gpu::get_sync_info(local_input));
       const El::Int block_size = 256;
       dim3 block_dims, grid_dims;
       block_dims.x = block_size;
@@ -544,8 +563,11 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                   local_width,
                                   num_channels,
                                   channel_size,
+                                  channel_stride,
+                                  spatial_stride,
                                   local_input.LockedBuffer(),
                                   local_input.LDim(),
+                                  local_running_mean.LockedBuffer(),
                                   local_mean.Buffer(),
                                   local_var.Buffer());
     }
@@ -582,6 +604,7 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
 
     // Compute minibatch statistics
     if (num_per_sum <= 1) {
+      El::Axpy(TensorDataType(1.0), local_running_mean, local_mean);
       El::Fill(local_var, TensorDataType(1.0));
     }
     else if (num_channels > 0) {
@@ -639,6 +662,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::fp_compute()
                                 local_width,
                                 num_channels,
                                 channel_size,
+                                channel_stride,
+                                spatial_stride,
                                 local_input.LockedBuffer(),
                                 local_input.LDim(),
                                 local_mean.LockedBuffer(),
@@ -688,6 +713,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
   const auto& output_dims = this->get_output_dims();
   const auto& num_channels = output_dims[0];
   const auto& channel_size = this->get_output_size() / num_channels;
+  const int channel_stride = this->m_channels_last ? 1 : channel_size;
+  const int spatial_stride = this->m_channels_last ? num_channels : 1;
 
   // Compute local gradients
   // Compute gradients w.r.t. batch norm parameters
@@ -720,6 +747,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
       local_width,
       num_channels,
       channel_size,
+      channel_stride,
+      spatial_stride,
       local_input.LockedBuffer(),
       local_input.LDim(),
       local_gradient_wrt_output.LockedBuffer(),
@@ -801,6 +830,8 @@ void batch_normalization_layer<TensorDataType, T_layout, Dev>::bp_compute()
                                 local_width,
                                 num_channels,
                                 channel_size,
+                                channel_stride,
+                                spatial_stride,
                                 num_per_sum,
                                 local_input.LockedBuffer(),
                                 local_input.LDim(),
@@ -74,13 +74,15 @@ std::unique_ptr<lbann::Layer> lbann::build_batch_normalization_layer_from_pbuf(
         batch_normalization_layer<float, data_layout::DATA_PARALLEL, D>>(
         decay,
         epsilon,
-        statistics_group_size);
+        statistics_group_size,
+        params.channels_last());
     else
       return std::make_unique<
         batch_normalization_layer<double, data_layout::DATA_PARALLEL, D>>(
         decay,
         epsilon,
-        statistics_group_size);
+        statistics_group_size,
+        params.channels_last());
   }
   else {
     LBANN_ERROR("batch normalization layer is only supported for \"float\" and "
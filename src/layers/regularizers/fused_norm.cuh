@@ -0,0 +1,331 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_SRC_LAYERS_REGULARIZERS_FUSED_NORM_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_REGULARIZERS_FUSED_NORM_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace internal {
+
+/** @brief Type used to accumulate normalization statistics.
+ *
+ *  Sums of squares overflow and lose precision quickly in half
+ *  precision, so they are accumulated in single precision.
+ */
+template <typename TensorDataType>
+struct norm_accumulator
+{
+  using type = TensorDataType;
+};
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+struct norm_accumulator<fp16>
+{
+  using type = float;
+};
+#endif // LBANN_HAS_GPU_FP16
+
+namespace kernel {
+
+/** @brief Sum over the x-dimension of a GPU block.
+ *
+ *  Every thread in the block must enter this function. The sum over
+ *  threads with the same y-index is returned on all of them.
+ *
+ *  @tparam bdimx x-dimension of block. Must be a power of 2.
+ *  @tparam bdimy y-dimension of block.
+ */
+template <size_t bdimx, size_t bdimy, typename T>
+__device__ __forceinline__ T row_sum(T val)
+{
+  __shared__ T shared_vals[bdimy][bdimx];
+  const size_t tidx = threadIdx.x;
+  const size_t tidy = threadIdx.y;
+  shared_vals[tidy][tidx] = val;
+  for (size_t stride = bdimx / 2; stride > 0; stride /= 2) {
+    __syncthreads();
+    if (tidx < stride) {
+      shared_vals[tidy][tidx] += shared_vals[tidy][tidx + stride];
+    }
+  }
+  __syncthreads();
+  val = shared_vals[tidy][0];
+  __syncthreads();
+  return val;
+}
+
+/** @brief Fused normalization forward prop.
+ *
+ *  Each column of the input is split into num_groups contiguous
+ *  groups of group_size entries, and each group is normalized:
+ *
+ *  y_i = (x_i - mean) / sqrt(var + epsilon)
+ *
+ *  The statistics of a group are computed and applied by the
+ *  bdimx threads of one block row, so no intermediate buffers or
+ *  atomics are needed.
+ *
+ *  Block dimensions: bdimx x bdimy x 1
+ *
+ *  Grid dimensions: (num_rows / bdimy) x 1 x 1
+ */
+template <size_t bdimx, size_t bdimy, typename TensorDataType>
+__global__ void fused_norm_fp_kernel(size_t num_rows,
+                                     size_t num_groups,
+                                     size_t group_size,
+                                     TensorDataType epsilon,
+                                     const TensorDataType* __restrict__ input,
+                                     size_t input_ldim,
+                                     TensorDataType* __restrict__ output,
+                                     size_t output_ldim)
+{
+  using AccT = typename norm_accumulator<TensorDataType>::type;
+  const AccT scale = AccT(1) / AccT(group_size);
+  const size_t nrowsy = bdimy * gridDim.x;
+  for (size_t row0 = bdimy * blockIdx.x; row0 < num_rows; row0 += nrowsy) {
+    const size_t row = row0 + threadIdx.y;
+    const bool valid = row < num_rows;
+    const size_t offset = group_size * (row % num_groups);
+    const auto* x = input + (row / num_groups) * input_ldim + offset;
+    auto* y = output + (row / num_groups) * output_ldim + offset;
+
+    // Compute statistics
+    AccT sum(0), sqsum(0);
+    if (valid) {
+      for (size_t i = threadIdx.x; i < group_size; i += bdimx) {
+        const AccT xi(x[i]);
+        sum += xi;
+        sqsum += xi * xi;
+      }
+    }
+    const AccT mean = row_sum<bdimx, bdimy>(sum) * scale;
+    const AccT sqmean = row_sum<bdimx, bdimy>(sqsum) * scale;
+    const AccT var = gpu_lib::max(sqmean - mean * mean, AccT(0));
+    const AccT inv_stdev = gpu_lib::rsqrt(var + AccT(epsilon));
+
+    // Normalize
+    if (valid) {
+      for (size_t i = threadIdx.x; i < group_size; i += bdimx) {
+        y[i] = TensorDataType((AccT(x[i]) - mean) * inv_stdev);
+      }
+    }
+  }
+}
+
+/** @brief Fused normalization backprop.
+ *
+ *  The group statistics are recomputed from the input, in the same
+ *  pass that accumulates the gradients w.r.t. them:
+ *
+ *  dL/dmean = - sum(dL/dy_i) / sqrt(var+epsilon)
+ *
+ *  dL/dvar = - sum(dL/dy_i * (x_i-mean)) * (var+epsilon)^(-3/2) / 2
+ *
+ *  dL/dx_i = ( dL/dy_i / sqrt(var+epsilon)
+ *              + dL/dmean / n
+ *              + dL/dvar * (x_i - mean) * 2/n )
+ *
+ *  Block dimensions: bdimx x bdimy x 1
+ *
+ *  Grid dimensions: (num_rows / bdimy) x 1 x 1
+ */
+template <size_t bdimx, size_t bdimy, typename TensorDataType>
+__global__ void
+fused_norm_bp_kernel(size_t num_rows,
+                     size_t num_groups,
+                     size_t group_size,
+                     TensorDataType epsilon,
+                     const TensorDataType* __restrict__ input,
+                     size_t input_ldim,
+                     const TensorDataType* __restrict__ output_grad,
+                     size_t output_grad_ldim,
+                     TensorDataType* __restrict__ input_grad,
+                     size_t input_grad_ldim)
+{
+  using AccT = typename norm_accumulator<TensorDataType>::type;
+  const AccT scale = AccT(1) / AccT(group_size);
+  const size_t nrowsy = bdimy * gridDim.x;
+  for (size_t row0 = bdimy * blockIdx.x; row0 < num_rows; row0 += nrowsy) {
+    const size_t row = row0 + threadIdx.y;
+    const bool valid = row < num_rows;
+    const size_t col = row / num_groups;
+    const size_t offset = group_size * (row % num_groups);
+    const auto* x = input + col * input_ldim + offset;
+    const auto* dy = output_grad + col * output_grad_ldim + offset;
+    auto* dx = input_grad + col * input_grad_ldim + offset;
+
+    // Accumulate sums
+    // Note: sum(dy*(x-mean)) = sum(dy*x) - mean*sum(dy)
+    AccT sum(0), sqsum(0), dysum(0), dyxsum(0);
+    if (valid) {
+      for (size_t i = threadIdx.x; i < group_size; i += bdimx) {
+        const AccT xi(x[i]);
+        const AccT dyi(dy[i]);
+        sum += xi;
+        sqsum += xi * xi;
+        dysum += dyi;
+        dyxsum += dyi * xi;
+      }
+    }
+    const AccT mean = row_sum<bdimx, bdimy>(sum) * scale;
+    const AccT sqmean = row_sum<bdimx, bdimy>(sqsum) * scale;
+    dysum = row_sum<bdimx, bdimy>(dysum);
+    dyxsum = row_sum<bdimx, bdimy>(dyxsum);
+    const AccT var = gpu_lib::max(sqmean - mean * mean, AccT(0));
+    const AccT inv_stdev = gpu_lib::rsqrt(var + AccT(epsilon));
+    const AccT dmean = -dysum * inv_stdev;
+    const AccT dvar = -(dyxsum - mean * dysum) * inv_stdev * inv_stdev *
+                      inv_stdev / AccT(2);
+
+    // Compute gradient w.r.t. input
+    if (valid) {
+      for (size_t i = threadIdx.x; i < group_size; i += bdimx) {
+        const AccT xi(x[i]);
+        const AccT dyi(dy[i]);
+        dx[i] = TensorDataType(dyi * inv_stdev + dmean * scale +
+                               dvar * (xi - mean) * AccT(2) * scale);
+      }
+    }
+  }
+}
+
+} // namespace kernel
+
+/** @brief Whether a group is normalized by a warp-sized block row.
+ *
+ *  Short groups would leave most of a full block idle, so several of
+ *  them share a block.
+ */
+inline bool use_warp_per_group(size_t group_size)
+{
+  return group_size <= 512;
+}
+
+/** @brief Normalize contiguous groups in each column of a matrix.
+ *
+ *  Each local column of the input is split into num_groups groups of
+ *  group_size entries. Statistics are accumulated in
+ *  norm_accumulator<TensorDataType>::type and the whole computation
+ *  is one kernel launch.
+ */
+template <typename TensorDataType>
+void fused_norm_fp(size_t num_groups,
+                   size_t group_size,
+                   TensorDataType epsilon,
+                   const El::Matrix<TensorDataType, El::Device::GPU>& input,
+                   El::Matrix<TensorDataType, El::Device::GPU>& output)
+{
+  const size_t num_rows = num_groups * input.Width();
+  if (num_rows == 0 || group_size == 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(input));
+  const bool warp_per_group = use_warp_per_group(group_size);
+  constexpr size_t warp_bdimx = 32, warp_bdimy = 8, block_bdimx = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = warp_per_group ? warp_bdimx : block_bdimx;
+  block_dims.y = warp_per_group ? warp_bdimy : 1;
+  grid_dims.x = (num_rows + block_dims.y - 1) / block_dims.y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto kernel =
+    (warp_per_group
+       ? kernel::fused_norm_fp_kernel<warp_bdimx, warp_bdimy, TensorDataType>
+       : kernel::fused_norm_fp_kernel<block_bdimx, 1, TensorDataType>);
+  hydrogen::gpu::LaunchKernel(kernel,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_rows,
+                              num_groups,
+                              group_size,
+                              epsilon,
+                              input.LockedBuffer(),
+                              input.LDim(),
+                              output.Buffer(),
+                              output.LDim());
+}
+
+/** @brief Backprop of fused_norm_fp.
+ *
+ *  The statistics are recomputed from the input, so nothing needs to
+ *  be kept from forward prop.
+ */
+template <typename TensorDataType>
+void fused_norm_bp(
+  size_t num_groups,
+  size_t group_size,
+  TensorDataType epsilon,
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  const El::Matrix<TensorDataType, El::Device::GPU>& output_grad,
+  El::Matrix<TensorDataType, El::Device::GPU>& input_grad)
+{
+  const size_t num_rows = num_groups * input.Width();
+  if (num_rows == 0 || group_size == 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(input_grad),
+                                     gpu::get_sync_info(output_grad),
+                                     gpu::get_sync_info(input));
+  const bool warp_per_group = use_warp_per_group(group_size);
+  constexpr size_t warp_bdimx = 32, warp_bdimy = 8, block_bdimx = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = warp_per_group ? warp_bdimx : block_bdimx;
+  block_dims.y = warp_per_group ? warp_bdimy : 1;
+  grid_dims.x = (num_rows + block_dims.y - 1) / block_dims.y;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto kernel =
+    (warp_per_group
+       ? kernel::fused_norm_bp_kernel<warp_bdimx, warp_bdimy, TensorDataType>
+       : kernel::fused_norm_bp_kernel<block_bdimx, 1, TensorDataType>);
+  hydrogen::gpu::LaunchKernel(kernel,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              num_rows,
+                              num_groups,
+                              group_size,
+                              epsilon,
+                              input.LockedBuffer(),
+                              input.LDim(),
+                              output_grad.LockedBuffer(),
+                              output_grad.LDim(),
+                              input_grad.Buffer(),
+                              input_grad.LDim());
+}
+
+} // namespace internal
+} // namespace lbann
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_REGULARIZERS_FUSED_NORM_CUH_INCLUDED
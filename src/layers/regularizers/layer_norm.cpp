@@ -39,6 +39,7 @@ namespace {
 /** @brief Forward prop */
 template <typename TensorDataType>
 void fp_impl(lbann_comm& comm,
+             const El::mpi::Comm* sequence_comm,
              TensorDataType epsilon,
              const El::AbstractDistMatrix<TensorDataType>& input,
              El::AbstractDistMatrix<TensorDataType>& output,
@@ -46,6 +47,15 @@ void fp_impl(lbann_comm& comm,
 {
   using CPUMatType = El::Matrix<TensorDataType, El::Device::CPU>;
 
+  if (sequence_comm != nullptr &&
+      input.Width() % El::mpi::Size(*sequence_comm) != 0) {
+    LBANN_ERROR("layer norm got a mini-batch of ",
+                input.Width(),
+                " sequence shards, which is not a multiple of the ",
+                El::mpi::Size(*sequence_comm),
+                " shards per sequence");
+  }
+
   // Workspace buffer
   statistics.Empty(false);
   statistics.AlignWith(input);
@@ -60,7 +70,10 @@ void fp_impl(lbann_comm& comm,
   auto local_vars = El::LockedView(local_statistics, El::IR(1), El::ALL);
 
   // Dimensions
-  const El::Int sample_size = input.Height();
+  // Note: The shards of a sequence are normalized together.
+  const El::Int sample_size =
+    input.Height() *
+    (sequence_comm != nullptr ? El::mpi::Size(*sequence_comm) : 1);
   const El::Int local_num_samples = local_input.Width();
   const El::Int local_sample_size = local_input.Height();
 
@@ -77,6 +90,9 @@ void fp_impl(lbann_comm& comm,
     }
   }
   comm.allreduce(statistics, statistics.RedundantComm(), El::mpi::SUM);
+  if (sequence_comm != nullptr) {
+    comm.allreduce(statistics, *sequence_comm, El::mpi::SUM);
+  }
 
   // Compute statistics from sums
   //   mean = sum(x_i) / n
@@ -117,6 +133,7 @@ void fp_impl(lbann_comm& comm,
 /** @brief Backprop */
 template <typename TensorDataType>
 void bp_impl(lbann_comm& comm,
+             const El::mpi::Comm* sequence_comm,
              TensorDataType epsilon,
              const El::AbstractDistMatrix<TensorDataType>& input,
              const El::AbstractDistMatrix<TensorDataType>& output_grad,
@@ -147,7 +164,10 @@ void bp_impl(lbann_comm& comm,
   auto local_vars_grad = El::View(local_statistics_grad, El::IR(1), El::ALL);
 
   // Dimensions
-  const El::Int sample_size = input.Height();
+  // Note: The shards of a sequence are normalized together.
+  const El::Int sample_size =
+    input.Height() *
+    (sequence_comm != nullptr ? El::mpi::Size(*sequence_comm) : 1);
   const El::Int local_num_samples = local_input.Width();
   const El::Int local_sample_size = local_input.Height();
 
@@ -182,6 +202,9 @@ void bp_impl(lbann_comm& comm,
   comm.allreduce(statistics_grad,
                  statistics_grad.RedundantComm(),
                  El::mpi::SUM);
+  if (sequence_comm != nullptr) {
+    comm.allreduce(statistics_grad, *sequence_comm, El::mpi::SUM);
+  }
 
   // Compute gradient w.r.t. input
   //   dL/dx_i = ( dL/dy_i / sqrt(var+epsilon)
@@ -212,6 +235,7 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void layer_norm_layer<TensorDataType, Layout, Device>::fp_compute()
 {
   fp_impl(*this->get_comm(),
+          this->get_sequence_comm(),
           this->m_epsilon,
           this->get_prev_activations(),
           this->get_activations(),
@@ -222,6 +246,7 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void layer_norm_layer<TensorDataType, Layout, Device>::bp_compute()
 {
   bp_impl(*this->get_comm(),
+          this->get_sequence_comm(),
           this->m_epsilon,
           this->get_prev_activations(),
           this->get_prev_error_signals(),
@@ -29,6 +29,8 @@
 #include "lbann/layers/regularizers/layer_norm.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "fused_norm.cuh"
+
 #ifdef LBANN_HAS_DISTCONV
 #include "lbann/layers/data_type_distconv_adapter.hpp"
 #endif // LBANN_HAS_DISTCONV
@@ -177,6 +179,7 @@ __global__ void fp_output_kernel(size_t local_num_samples,
 /** @brief Forward prop */
 template <typename TensorDataType>
 void fp_impl(lbann_comm& comm,
+             const El::mpi::Comm* sequence_comm,
              TensorDataType epsilon,
              const El::AbstractDistMatrix<TensorDataType>& input,
              El::AbstractDistMatrix<TensorDataType>& output,
@@ -184,6 +187,26 @@ void fp_impl(lbann_comm& comm,
 {
   using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
 
+  if (sequence_comm != nullptr &&
+      input.Width() % El::mpi::Size(*sequence_comm) != 0) {
+    LBANN_ERROR("layer norm got a mini-batch of ",
+                input.Width(),
+                " sequence shards, which is not a multiple of the ",
+                El::mpi::Size(*sequence_comm),
+                " shards per sequence");
+  }
+
+  // Normalize in one kernel if samples are not split between ranks
+  if (input.ColStride() == 1 && sequence_comm == nullptr) {
+    internal::fused_norm_fp(
+      1,
+      input.Height(),
+      epsilon,
+      dynamic_cast<const GPUMatType&>(input.LockedMatrix()),
+      dynamic_cast<GPUMatType&>(output.Matrix()));
+    return;
+  }
+
   // Workspace buffer
   statistics.Empty(false);
   statistics.AlignWith(input);
@@ -198,7 +221,10 @@ void fp_impl(lbann_comm& comm,
   auto local_vars = El::View(local_statistics, El::IR(1), El::ALL);
 
   // Dimensions
-  const size_t sample_size = input.Height();
+  // Note: The shards of a sequence are normalized together.
+  const size_t sample_size =
+    input.Height() *
+    (sequence_comm != nullptr ? El::mpi::Size(*sequence_comm) : 1);
   const size_t local_num_samples = local_input.Width();
   const size_t local_sample_size = local_input.Height();
 
@@ -232,6 +258,9 @@ void fp_impl(lbann_comm& comm,
                                 local_vars.LDim());
   }
   comm.allreduce(statistics, statistics.RedundantComm(), El::mpi::SUM);
+  if (sequence_comm != nullptr) {
+    comm.allreduce(statistics, *sequence_comm, El::mpi::SUM);
+  }
 
   // Compute statistics from sums
   if (sample_size <= 1) {
@@ -411,6 +440,7 @@ bp_input_grad_kernel(unsigned long long sample_size,
 /** @brief Backprop */
 template <typename TensorDataType>
 void bp_impl(lbann_comm& comm,
+             const El::mpi::Comm* sequence_comm,
              TensorDataType epsilon,
              const El::AbstractDistMatrix<TensorDataType>& input,
              const El::AbstractDistMatrix<TensorDataType>& output_grad,
@@ -420,6 +450,18 @@ void bp_impl(lbann_comm& comm,
 {
   using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
 
+  // Statistics are recomputed in the fused kernel, see fp_impl
+  if (input.ColStride() == 1 && sequence_comm == nullptr) {
+    internal::fused_norm_bp(
+      1,
+      input.Height(),
+      epsilon,
+      dynamic_cast<const GPUMatType&>(input.LockedMatrix()),
+      dynamic_cast<const GPUMatType&>(output_grad.LockedMatrix()),
+      dynamic_cast<GPUMatType&>(input_grad.Matrix()));
+    return;
+  }
+
   // Workspace buffer
   statistics_grad.Empty(false);
   statistics_grad.AlignWith(input);
@@ -441,7 +483,10 @@ void bp_impl(lbann_comm& comm,
   auto local_vars_grad = El::View(local_statistics_grad, El::IR(1), El::ALL);
 
   // Dimensions
-  const size_t sample_size = input.Height();
+  // Note: The shards of a sequence are normalized together.
+  const size_t sample_size =
+    input.Height() *
+    (sequence_comm != nullptr ? El::mpi::Size(*sequence_comm) : 1);
   const size_t local_num_samples = local_input.Width();
   const size_t local_sample_size = local_input.Height();
 
@@ -490,6 +535,9 @@ void bp_impl(lbann_comm& comm,
   comm.allreduce(statistics_grad,
                  statistics_grad.RedundantComm(),
                  El::mpi::SUM);
+  if (sequence_comm != nullptr) {
+    comm.allreduce(statistics_grad, *sequence_comm, El::mpi::SUM);
+  }
 
   // Compute gradient w.r.t. input
   if (!local_input_grad.IsEmpty()) {
@@ -536,6 +584,7 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void layer_norm_layer<TensorDataType, Layout, Device>::fp_compute()
 {
   fp_impl(*this->get_comm(),
+          this->get_sequence_comm(),
           this->m_epsilon,
           this->get_prev_activations(),
           this->get_activations(),
@@ -546,6 +595,7 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void layer_norm_layer<TensorDataType, Layout, Device>::bp_compute()
 {
   bp_impl(*this->get_comm(),
+          this->get_sequence_comm(),
           this->m_epsilon,
           this->get_prev_activations(),
           this->get_prev_error_signals(),
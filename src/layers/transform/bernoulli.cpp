@@ -40,9 +40,13 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void bernoulli_layer<TensorDataType, Layout, Device>::fp_compute()
 {
   auto& output = this->get_activations();
-  if (this->m_model->get_execution_context().get_execution_mode() ==
-      execution_mode::training) {
-    bernoulli_fill(output, output.Height(), output.Width(), m_prob);
+  const auto& context = this->m_model->get_execution_context();
+  const auto mode = context.get_execution_mode();
+  if (mode == execution_mode::training) {
+    philox_bernoulli_fill(
+      output,
+      m_prob,
+      make_philox_stream(m_seed, context.get_step(), mode));
   }
   else {
     El::Zero(output);
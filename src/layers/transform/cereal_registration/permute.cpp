@@ -54,6 +54,7 @@ void PermuteLayer<T>::PermuteImpl::load(ArchiveT& ar)
   std::vector<int> perm;
   ar(perm);
   DevImplT{RowMajor(std::move(perm))}.swap(m_device_impl);
+  m_is_batched_transpose = false;
 }
 
 template <typename T>
@@ -41,55 +41,56 @@ namespace lbann {
 
 namespace {
 
-/** CPU implementation of evaluation layer forward prop. */
-template <typename TensorDataType, typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<TensorDataType>& input,
-            EvalDataType& value,
-            Al::request& req)
+/** CPU implementation of evaluation layer forward prop.
+ *  Returns the sum of the local input entries.
+ */
+template <typename TensorDataType>
+EvalType fp_cpu(const El::AbstractDistMatrix<TensorDataType>& input)
 {
   const auto& local_input = input.LockedMatrix();
   const auto& local_height = local_input.Height();
   const auto& local_width = local_input.Width();
-  const auto& mini_batch_size = input.Width();
-  value = El::TypeTraits<EvalDataType>::Zero();
-  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : value) collapse(2))
+  EvalType sum = El::TypeTraits<EvalType>::Zero();
+  LBANN_OMP_PARALLEL_FOR_ARGS(reduction(+ : sum) collapse(2))
   for (El::Int col = 0; col < local_width; ++col) {
     for (El::Int row = 0; row < local_height; ++row) {
-      value += local_input(row, col);
+      sum += local_input(row, col);
     }
   }
-  value = value / mini_batch_size;
-  comm.nb_allreduce(&value, 1, input.DistComm(), req);
+  return sum;
 }
 
 #ifdef LBANN_HAS_HALF
-template <typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<cpu_fp16>& input,
-            EvalDataType& value,
-            Al::request& req)
+EvalType fp_cpu(const El::AbstractDistMatrix<cpu_fp16>& input)
 {
   LBANN_ERROR("This function is not supported in FP16 on CPUs");
+  return El::TypeTraits<EvalType>::Zero();
 }
 #endif // LBANN_HAS_HALF
 
 #ifdef LBANN_HAS_GPU_FP16
-template <typename EvalDataType>
-void fp_cpu(lbann_comm& comm,
-            const El::AbstractDistMatrix<fp16>& input,
-            EvalDataType& value,
-            Al::request& req)
+EvalType fp_cpu(const El::AbstractDistMatrix<fp16>& input)
 {
   LBANN_ERROR("This function is not supported in FP16 on CPUs");
+  return El::TypeTraits<EvalType>::Zero();
 }
 #endif // LBANN_HAS_GPU_HALF
 
 #ifdef LBANN_HAS_GPU
-/** GPU implementation of evaluation layer forward prop. */
+/** GPU implementation of evaluation layer forward prop.
+ *  The sum of the local input entries is kept in @c local_sum. If
+ *  @c reduce_value is set, the mean value is reduced into
+ *  @c value_d and copied to @c value asynchronously. If
+ *  @c defer_reduction is also set, the local mean is stored in
+ *  @c value_d and the caller reduces it.
+ */
 template <typename TensorDataType, typename EvalDataType>
 void fp_gpu(lbann_comm& comm,
             const El::AbstractDistMatrix<TensorDataType>& input,
+            El::Matrix<EvalType, El::Device::GPU>& local_sum,
+            bool reduce_value,
+            bool defer_reduction,
+            El::Matrix<EvalType, El::Device::GPU>& value_d,
             EvalDataType& value,
             gpu_lib::event_wrapper& copy_event)
 {
@@ -173,10 +174,24 @@ void fp_gpu(lbann_comm& comm,
   // Restore the host pointer mode
   hydrogen::gpu_blas::SetPointerMode(hydrogen::PointerMode::HOST);
 
+  // Keep the local sum for accumulation
+  El::SetSyncInfo(local_sum, sync_info);
+  El::Copy(sum_d, local_sum);
+  if (!reduce_value) {
+    return;
+  }
+
   // Compute average value across mini-batch
   El::Scale(one / El::To<EvalDataType>(mini_batch_size), sum_d);
+  if (defer_reduction) {
+    El::SetSyncInfo(value_d, sync_info);
+    El::Copy(sum_d, value_d);
+    return;
+  }
   comm.allreduce(static_cast<El::AbstractMatrix<EvalDataType>&>(sum_d),
                  input.DistComm());
+  El::SetSyncInfo(value_d, sync_info);
+  El::Copy(sum_d, value_d);
   hydrogen::gpu::Copy1DToHost(sum_d.LockedBuffer(), &value, 1, sync_info);
   copy_event.record(sync_info.Stream());
 }
@@ -185,6 +200,10 @@ void fp_gpu(lbann_comm& comm,
 template <typename EvalDataType>
 void fp_gpu(lbann_comm& comm,
             const El::AbstractDistMatrix<cpu_fp16>& input,
+            El::Matrix<EvalType, El::Device::GPU>& local_sum,
+            bool reduce_value,
+            bool defer_reduction,
+            El::Matrix<EvalType, El::Device::GPU>& value_d,
             EvalDataType& value,
             gpu_lib::event_wrapper& copy_event)
 {
@@ -199,6 +218,153 @@ void fp_gpu(lbann_comm& comm,
 
 } // namespace
 
+// =============================================
+// Shared reduction of evaluated values
+// =============================================
+
+evaluation_reducer::slot
+evaluation_reducer::add_slot(El::Device device, const El::mpi::Comm& comm)
+{
+  const auto key = std::make_pair(device, &comm);
+  auto it = m_group_ids.find(key);
+  if (it == m_group_ids.end()) {
+    it = m_group_ids.emplace(key, m_groups.size()).first;
+    m_groups.emplace_back(std::make_unique<group>());
+    m_groups.back()->device = device;
+    m_groups.back()->comm = &comm;
+  }
+  auto& g = *m_groups[it->second];
+  if (g.started) {
+    wait(g);
+  }
+  slot s;
+  s.group = it->second;
+  s.row = g.values.Height();
+  const auto height = s.row + 1;
+#ifdef LBANN_HAS_GPU
+  if (device == El::Device::GPU) {
+    g.values.SetMemoryMode(1); // Use pinned memory on host
+    El::Zeros(g.values_d, height, 1);
+  }
+#endif // LBANN_HAS_GPU
+  El::Zeros(g.values, height, 1);
+  g.started = false;
+  g.done = false;
+  return s;
+}
+
+void evaluation_reducer::set_local_value(const slot& s, EvalType value)
+{
+  auto& g = *m_groups[s.group];
+  if (g.device != El::Device::CPU) {
+    LBANN_ERROR("expected a value on the host");
+  }
+  if (g.started) {
+    // Finish the last reduction before overwriting its buffer
+    wait(g);
+    g.started = false;
+    g.done = false;
+  }
+  g.values(s.row, 0) = value;
+}
+
+EvalType evaluation_reducer::get_value(const slot& s)
+{
+  auto& g = *m_groups[s.group];
+  wait(g);
+  return g.values(s.row, 0);
+}
+
+#ifdef LBANN_HAS_GPU
+void evaluation_reducer::set_local_value(
+  const slot& s,
+  const El::Matrix<EvalType, El::Device::GPU>& value)
+{
+  auto& g = *m_groups[s.group];
+  if (g.device != El::Device::GPU) {
+    LBANN_ERROR("expected a value on the device");
+  }
+  // The copy is ordered after the last reduction on the stream
+  g.started = false;
+  g.done = false;
+  El::SetSyncInfo(g.values_d, gpu::get_sync_info(value));
+  auto&& entry = g.values_d(El::IR(s.row, s.row + 1), El::ALL);
+  El::Copy(value, entry);
+}
+
+void evaluation_reducer::get_value(
+  const slot& s,
+  El::Matrix<EvalType, El::Device::GPU>& value)
+{
+  auto& g = *m_groups[s.group];
+  start(g);
+  El::SetSyncInfo(value, gpu::get_sync_info(g.values_d));
+  El::Copy(g.values_d(El::IR(s.row, s.row + 1), El::ALL), value);
+}
+#endif // LBANN_HAS_GPU
+
+void evaluation_reducer::start()
+{
+  for (auto& g : m_groups) {
+    start(*g);
+  }
+}
+
+void evaluation_reducer::start(group& g)
+{
+  if (g.started) {
+    return;
+  }
+  const auto size = g.values.Height();
+  switch (g.device) {
+  case El::Device::CPU:
+    m_comm.nb_allreduce(g.values.Buffer(), size, *g.comm, g.req);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU: {
+    m_comm.allreduce(static_cast<El::AbstractMatrix<EvalType>&>(g.values_d),
+                     *g.comm);
+    auto sync_info = gpu::get_sync_info(g.values_d);
+    hydrogen::gpu::Copy1DToHost(g.values_d.LockedBuffer(),
+                                g.values.Buffer(),
+                                size,
+                                sync_info);
+    g.copy_event.record(sync_info.Stream());
+    break;
+  }
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  g.started = true;
+  g.done = false;
+}
+
+void evaluation_reducer::wait(group& g)
+{
+  start(g);
+  if (g.done) {
+    return;
+  }
+  switch (g.device) {
+  case El::Device::CPU:
+    m_comm.wait(g.req);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    g.copy_event.synchronize();
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  g.done = true;
+}
+
+// =============================================
+// Evaluation layer
+// =============================================
+
 template <typename T, data_layout L, El::Device D>
 void evaluation_layer<T, L, D>::write_specific_proto(
   lbann_data::Layer& proto) const
@@ -209,26 +375,115 @@ void evaluation_layer<T, L, D>::write_specific_proto(
 
 template <typename TensorDataType>
 EvalType abstract_evaluation_layer<TensorDataType>::get_value(bool scaled)
+{
+  if (m_value_pending) {
+    // Wait for the shared reduction
+    m_value(0, 0) = El::To<EvalDataType>(m_reducer->get_value(m_reducer_slot));
+#ifdef LBANN_HAS_GPU
+    if (this->get_device_allocation() == El::Device::GPU) {
+      m_reducer->get_value(m_reducer_slot, m_value_d);
+    }
+#endif // LBANN_HAS_GPU
+    m_value_pending = false;
+  }
+  else if (!m_value_computed) {
+    // Reduce the local sum of the last forward prop now, and in
+    // forward prop from now on
+    const auto& input = this->get_prev_activations();
+    EvalType local_sum = m_local_sum;
+#ifdef LBANN_HAS_GPU
+    if (this->get_device_allocation() == El::Device::GPU) {
+      auto sync_info = gpu::get_sync_info(m_local_sum_d);
+      hydrogen::gpu::Copy1DToHost(m_local_sum_d.LockedBuffer(),
+                                  &local_sum,
+                                  1,
+                                  sync_info);
+      El::Synchronize(sync_info);
+    }
+#endif // LBANN_HAS_GPU
+    const auto sum = this->get_comm()->allreduce(local_sum, input.DistComm());
+    m_value(0, 0) = El::To<EvalDataType>(sum / input.Width());
+    m_value_computed = true;
+    m_value_required = true;
+  }
+  else {
+    switch (this->get_device_allocation()) {
+    case El::Device::CPU:
+      this->get_comm()->wait(m_allreduce_req);
+      break;
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU:
+      this->m_copy_event.synchronize();
+      break;
+#endif // LBANN_HAS_GPU
+    default:
+      LBANN_ERROR("invalid device");
+    }
+  }
+  if (scaled) {
+    return El::To<EvalDataType>(m_scale) * El::To<EvalDataType>(m_value(0, 0));
+  }
+  else {
+    return m_value(0, 0);
+  }
+}
+
+template <typename TensorDataType>
+void abstract_evaluation_layer<TensorDataType>::accumulate_local_sum()
 {
   switch (this->get_device_allocation()) {
   case El::Device::CPU:
-    this->get_comm()->wait(m_allreduce_req);
+    m_accumulated_local_sum += m_local_sum;
     break;
 #ifdef LBANN_HAS_GPU
   case El::Device::GPU:
-    this->m_copy_event.synchronize();
+    El::SetSyncInfo(m_accumulated_local_sum_d,
+                    gpu::get_sync_info(m_local_sum_d));
+    El::Axpy(El::TypeTraits<EvalType>::One(),
+             m_local_sum_d,
+             m_accumulated_local_sum_d);
     break;
 #endif // LBANN_HAS_GPU
   default:
     LBANN_ERROR("invalid device");
   }
-  if (scaled) {
-    return El::To<EvalDataType>(m_scale) * El::To<EvalDataType>(m_value(0, 0));
+}
+
+template <typename TensorDataType>
+EvalType abstract_evaluation_layer<TensorDataType>::take_accumulated_local_sum()
+{
+  EvalType sum = m_accumulated_local_sum;
+  m_accumulated_local_sum = El::TypeTraits<EvalType>::Zero();
+#ifdef LBANN_HAS_GPU
+  if (this->get_device_allocation() == El::Device::GPU) {
+    auto sync_info = gpu::get_sync_info(m_accumulated_local_sum_d);
+    hydrogen::gpu::Copy1DToHost(m_accumulated_local_sum_d.LockedBuffer(),
+                                &sum,
+                                1,
+                                sync_info);
+    El::Zero(m_accumulated_local_sum_d);
+    El::Synchronize(sync_info);
   }
-  else {
-    return m_value(0, 0);
+#endif // LBANN_HAS_GPU
+  return sum;
+}
+
+#ifdef LBANN_HAS_GPU
+template <typename TensorDataType>
+bool abstract_evaluation_layer<TensorDataType>::accumulate_value(
+  El::Matrix<EvalType, El::Device::GPU>& sum,
+  EvalType weight)
+{
+  if (this->get_device_allocation() != El::Device::GPU || !m_value_computed) {
+    return false;
+  }
+  if (m_value_pending) {
+    m_reducer->get_value(m_reducer_slot, m_value_d);
   }
+  El::Axpy(weight * m_scale, m_value_d, sum);
+  return true;
 }
+#endif // LBANN_HAS_GPU
 
 template <typename TensorDataType>
 abstract_evaluation_layer<TensorDataType>::abstract_evaluation_layer(
@@ -265,32 +520,67 @@ void abstract_evaluation_layer<TensorDataType>::setup_data(
   data_type_layer<TensorDataType>::setup_data(max_mini_batch_size);
 #ifdef LBANN_HAS_GPU
   m_value.SetMemoryMode(1); // Use pinned memory on host
-#endif                      // LBANN_HAS_GPU
+  if (this->get_device_allocation() == El::Device::GPU) {
+    El::Zeros(m_local_sum_d, 1, 1);
+    El::Zeros(m_accumulated_local_sum_d, 1, 1);
+    El::Zeros(m_value_d, 1, 1);
+  }
+#endif // LBANN_HAS_GPU
   El::Zeros(m_value, 1, 1);
+  m_value_computed = false;
+  m_value_pending = false;
+  m_reducer = (this->m_model != nullptr
+                 ? this->m_model->get_evaluation_reducer()
+                 : nullptr);
+  if (m_reducer != nullptr) {
+    m_reducer_slot =
+      m_reducer->add_slot(this->get_device_allocation(),
+                          this->get_prev_activations().DistComm());
+  }
+  m_local_sum = El::TypeTraits<EvalType>::Zero();
+  m_accumulated_local_sum = El::TypeTraits<EvalType>::Zero();
 }
 
 template <typename TensorDataType>
 void abstract_evaluation_layer<TensorDataType>::fp_compute()
 {
   switch (this->get_device_allocation()) {
-  case El::Device::CPU:
+  case El::Device::CPU: {
     this->get_comm()->wait(m_allreduce_req);
-    fp_cpu(*this->get_comm(),
-           this->get_prev_activations(),
-           m_value(0, 0),
-           m_allreduce_req);
+    const auto& input = this->get_prev_activations();
+    m_local_sum = fp_cpu(input);
+    if (m_value_required && m_reducer != nullptr) {
+      m_reducer->set_local_value(m_reducer_slot, m_local_sum / input.Width());
+    }
+    else if (m_value_required) {
+      m_value(0, 0) = El::To<EvalDataType>(m_local_sum / input.Width());
+      this->get_comm()->nb_allreduce(&m_value(0, 0),
+                                     1,
+                                     input.DistComm(),
+                                     m_allreduce_req);
+    }
     break;
+  }
 #ifdef LBANN_HAS_GPU
   case El::Device::GPU:
     fp_gpu(*this->get_comm(),
            this->get_prev_activations(),
+           m_local_sum_d,
+           m_value_required,
+           m_reducer != nullptr,
+           m_value_d,
            m_value(0, 0),
            m_copy_event);
+    if (m_value_required && m_reducer != nullptr) {
+      m_reducer->set_local_value(m_reducer_slot, m_value_d);
+    }
     break;
 #endif // LBANN_HAS_GPU
   default:
     LBANN_ERROR("invalid device");
   }
+  m_value_computed = m_value_required;
+  m_value_pending = m_value_required && m_reducer != nullptr;
 }
 
 template <typename TensorDataType>
@@ -37,13 +37,16 @@ template <typename TensorDataType, data_layout Layout, El::Device Device>
 void gaussian_layer<TensorDataType, Layout, Device>::fp_compute()
 {
   auto& output = this->get_activations();
-  const auto& mode =
-    this->m_model->get_execution_context().get_execution_mode();
+  const auto& context = this->m_model->get_execution_context();
+  const auto mode = context.get_execution_mode();
   if (m_training_only && (mode != execution_mode::training)) {
     El::Fill(output, m_mean);
   }
   else {
-    gaussian_fill(output, output.Height(), output.Width(), m_mean, m_stdev);
+    philox_gaussian_fill(output,
+                         m_mean,
+                         m_stdev,
+                         make_philox_stream(m_seed, context.get_step(), mode));
   }
 }
 
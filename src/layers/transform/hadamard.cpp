@@ -27,29 +27,69 @@
 #define LBANN_HADAMARD_LAYER_INSTANTIATE
 #include "lbann/layers/transform/hadamard.hpp"
 
-#include "lbann/proto/datatype_helpers.hpp"
 #include <lbann/proto/proto_common.hpp>
 
-#include "lbann/proto/layers.pb.h"
-#include "lbann/proto/lbann.pb.h"
-
 namespace lbann {
 
 LBANN_LAYER_DEFAULT_BUILDER(hadamard)
 
-template <typename T, data_layout L, El::Device D>
-void hadamard_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void hadamard_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  auto& output = this->get_activations();
+  switch (this->get_num_parents()) {
+  case 0:
+    El::Fill(output, El::TypeTraits<TensorDataType>::One());
+    break;
+  case 1:
+    El::LockedView(output, this->get_prev_activations());
+    break;
+  default:
+    El::Hadamard(this->get_prev_activations(0),
+                 this->get_prev_activations(1),
+                 output);
+    for (int i = 2; i < this->get_num_parents(); ++i) {
+      El::Hadamard(this->get_prev_activations(i), output, output);
+    }
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void hadamard_layer<TensorDataType, Layout, Device>::bp_compute()
 {
-  proto.set_datatype(proto::ProtoDataType<T>);
-  proto.mutable_hadamard();
+  const int num_parents = this->get_num_parents();
+  const auto& gradient_wrt_output = this->get_prev_error_signals();
+  switch (num_parents) {
+  case 0:
+    break;
+  case 1:
+    El::LockedView(this->get_error_signals(), gradient_wrt_output);
+    break;
+  default:
+    for (int i = 0; i < num_parents; ++i) {
+      auto& gradient_wrt_input = this->get_error_signals(i);
+      El::Copy(gradient_wrt_output, gradient_wrt_input);
+      for (int j = 0; j < num_parents; ++j) {
+        if (i != j) {
+          El::Hadamard(this->get_prev_activations(j),
+                       gradient_wrt_input,
+                       gradient_wrt_input);
+        }
+      }
+    }
+  }
 }
 
-#define PROTO_DEVICE(T, Device)                                                \
-  template class hadamard_layer<T, data_layout::DATA_PARALLEL, Device>;        \
-  template class hadamard_layer<T, data_layout::MODEL_PARALLEL, Device>;       \
-  LBANN_LAYER_BUILDER_ETI(hadamard, T, Device)
+#define PROTO(T)                                                               \
+  template class hadamard_layer<T,                                             \
+                                data_layout::DATA_PARALLEL,                    \
+                                El::Device::CPU>;                              \
+  template class hadamard_layer<T,                                             \
+                                data_layout::MODEL_PARALLEL,                   \
+                                El::Device::CPU>;                              \
+  LBANN_LAYER_BUILDER_ETI(hadamard, T, El::Device::CPU)
 
-#include "lbann/macros/instantiate_device.hpp"
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
 
 } // namespace lbann
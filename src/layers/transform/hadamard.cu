@@ -0,0 +1,234 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_HADAMARD_LAYER_INSTANTIATE
+#include "lbann/layers/transform/hadamard.hpp"
+
+#include "nary_entrywise.cuh"
+
+#include <lbann/proto/proto_common.hpp>
+
+namespace lbann {
+
+LBANN_LAYER_DEFAULT_BUILDER(hadamard)
+
+namespace {
+
+using internal::matrix_list;
+using internal::max_nary_matrices;
+
+/** @brief Multiply the output by a group of inputs
+ *
+ *  The output is overwritten by the first group of inputs.
+ */
+template <typename TensorDataType>
+__global__ void fp_kernel(El::Int height,
+                          El::Int width,
+                          matrix_list<const TensorDataType> inputs,
+                          bool accumulate,
+                          TensorDataType* __restrict__ output,
+                          El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % height;
+    const El::Int col = pos / height;
+    auto& y = output[row + col * output_ldim];
+    TensorDataType prod = accumulate ? y : TensorDataType(1.f);
+    for (int i = 0; i < inputs.size; ++i) {
+      prod *= inputs(i, row, col);
+    }
+    y = prod;
+  }
+}
+
+/** @brief Gradients with respect to all inputs
+ *
+ *  The gradient of input i is the output gradient times the product
+ *  of the other inputs, computed from prefix and suffix products so
+ *  each input is read once.
+ */
+template <typename TensorDataType>
+__global__ void bp_kernel(El::Int height,
+                          El::Int width,
+                          matrix_list<const TensorDataType> inputs,
+                          const TensorDataType* __restrict__ output_grad,
+                          El::Int output_grad_ldim,
+                          matrix_list<TensorDataType> input_grads)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  const int num_inputs = inputs.size;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % height;
+    const El::Int col = pos / height;
+    TensorDataType x[max_nary_matrices];
+    TensorDataType suffix[max_nary_matrices];
+#pragma unroll
+    for (int i = 0; i < max_nary_matrices; ++i) {
+      if (i < num_inputs) {
+        x[i] = inputs(i, row, col);
+      }
+    }
+    suffix[num_inputs - 1] = 1.f;
+#pragma unroll
+    for (int i = max_nary_matrices - 2; i >= 0; --i) {
+      if (i < num_inputs - 1) {
+        suffix[i] = suffix[i + 1] * x[i + 1];
+      }
+    }
+    TensorDataType prefix = output_grad[row + col * output_grad_ldim];
+#pragma unroll
+    for (int i = 0; i < max_nary_matrices; ++i) {
+      if (i < num_inputs) {
+        input_grads(i, row, col) = prefix * suffix[i];
+        prefix *= x[i];
+      }
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void hadamard_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  const int num_parents = this->get_num_parents();
+  auto& output = this->get_activations();
+  switch (num_parents) {
+  case 0:
+    El::Fill(output, El::TypeTraits<TensorDataType>::One());
+    return;
+  case 1:
+    El::LockedView(output, this->get_prev_activations());
+    return;
+  default:
+    break;
+  }
+
+  // Multiply groups of inputs into the output
+  auto& local_output = output.Matrix();
+  const El::Int height = local_output.Height();
+  const El::Int width = local_output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  auto sync_info = gpu::get_sync_info(local_output);
+  for (int i = 0; i < num_parents; i += max_nary_matrices) {
+    matrix_list<const TensorDataType> inputs;
+    for (int j = i; j < std::min(i + max_nary_matrices, num_parents); ++j) {
+      inputs.push_back(this->get_local_prev_activations(j));
+    }
+    hydrogen::gpu::LaunchKernel(
+      fp_kernel<TensorDataType>,
+      internal::nary_grid_size(height, width, block_size),
+      block_size,
+      0,
+      sync_info,
+      height,
+      width,
+      inputs,
+      i > 0,
+      local_output.Buffer(),
+      local_output.LDim());
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void hadamard_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  const int num_parents = this->get_num_parents();
+  const auto& output_grad = this->get_prev_error_signals();
+  switch (num_parents) {
+  case 0:
+    return;
+  case 1:
+    El::LockedView(this->get_error_signals(), output_grad);
+    return;
+  default:
+    break;
+  }
+
+  // Fall back to one pass per input if the inputs do not fit in one
+  // kernel
+  if (num_parents > max_nary_matrices) {
+    for (int i = 0; i < num_parents; ++i) {
+      auto& input_grad = this->get_error_signals(i);
+      El::Copy(output_grad, input_grad);
+      for (int j = 0; j < num_parents; ++j) {
+        if (i != j) {
+          El::Hadamard(this->get_prev_activations(j), input_grad, input_grad);
+        }
+      }
+    }
+    return;
+  }
+
+  // Compute all gradients in one kernel
+  const auto& local_output_grad = output_grad.LockedMatrix();
+  const El::Int height = local_output_grad.Height();
+  const El::Int width = local_output_grad.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  matrix_list<const TensorDataType> inputs;
+  matrix_list<TensorDataType> input_grads;
+  for (int i = 0; i < num_parents; ++i) {
+    inputs.push_back(this->get_local_prev_activations(i));
+    input_grads.push_back(this->get_local_error_signals(i));
+  }
+  constexpr El::Int block_size = 256;
+  hydrogen::gpu::LaunchKernel(
+    bp_kernel<TensorDataType>,
+    internal::nary_grid_size(height, width, block_size),
+    block_size,
+    0,
+    gpu::get_sync_info(local_output_grad),
+    height,
+    width,
+    inputs,
+    local_output_grad.LockedBuffer(),
+    local_output_grad.LDim(),
+    input_grads);
+}
+
+#define PROTO(T)                                                               \
+  template class hadamard_layer<T,                                             \
+                                data_layout::DATA_PARALLEL,                    \
+                                El::Device::GPU>;                              \
+  template class hadamard_layer<T,                                             \
+                                data_layout::MODEL_PARALLEL,                   \
+                                El::Device::GPU>;                              \
+  LBANN_LAYER_BUILDER_ETI(hadamard, T, El::Device::GPU)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_LAYERS_TRANSFORM_NARY_ENTRYWISE_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_TRANSFORM_NARY_ENTRYWISE_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace internal {
+
+/** @brief Most matrices passed to one n-ary entry-wise kernel
+ *
+ *  Layers with more inputs launch one kernel per group of inputs.
+ */
+constexpr int max_nary_matrices = 8;
+
+/** @brief Local matrices with the same dimensions
+ *
+ *  Passed by value as a kernel argument, so launching a kernel does
+ *  not need a device workspace.
+ */
+template <typename TensorDataType>
+struct matrix_list
+{
+  TensorDataType* buffers[max_nary_matrices];
+  El::Int ldims[max_nary_matrices];
+  int size = 0;
+
+  template <typename MatrixType>
+  void push_back(MatrixType& mat)
+  {
+    buffers[size] = mat.Buffer();
+    ldims[size] = mat.LDim();
+    ++size;
+  }
+  template <typename MatrixType>
+  void push_back(const MatrixType& mat)
+  {
+    buffers[size] = mat.LockedBuffer();
+    ldims[size] = mat.LDim();
+    ++size;
+  }
+
+  __device__ __forceinline__ TensorDataType& operator()(int i,
+                                                        El::Int row,
+                                                        El::Int col) const
+  {
+    return buffers[i][row + col * ldims[i]];
+  }
+};
+
+/** Grid size of a grid-stride loop over the entries of a matrix */
+inline El::Int nary_grid_size(El::Int height, El::Int width, El::Int bdim)
+{
+  return std::min((height * width + bdim - 1) / bdim, El::Int(65535));
+}
+
+} // namespace internal
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_TRANSFORM_NARY_ENTRYWISE_CUH_INCLUDED
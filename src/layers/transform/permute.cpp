@@ -58,6 +58,10 @@ PermuteLayer<T>::PermuteImpl::setup_dims(std::vector<int> const& input_dims)
 {
   using IndexType = typename DimsType::value_type;
   m_device_impl.set_dims(RowMajor(vec_convert<IndexType>(input_dims)));
+  m_is_batched_transpose =
+    get_batched_transpose_shape(m_device_impl.perm(),
+                                m_device_impl.input_dims(),
+                                m_transpose_shape);
   return vec_convert<int>(RowMajor(m_device_impl.output_dims()).get());
 }
 
@@ -67,7 +71,18 @@ void PermuteLayer<T>::PermuteImpl::forward_prop(MatType const& input,
 {
   if (input.Width() == El::Int{0} || output.Width() == El::Int{0})
     return;
-  m_device_impl.permute(input, output);
+  if (m_is_batched_transpose) {
+    auto const& shape = m_transpose_shape;
+    batched_transpose(shape.inner,
+                      shape.rows,
+                      shape.cols,
+                      shape.batch,
+                      input,
+                      output);
+  }
+  else {
+    m_device_impl.permute(input, output);
+  }
 }
 
 // Activations don't actually matter here...
@@ -77,7 +92,18 @@ void PermuteLayer<T>::PermuteImpl::backward_prop(MatType const& grad_wrt_out,
 {
   if (grad_wrt_out.Width() == El::Int{0} || grad_wrt_in.Width() == El::Int{0})
     return;
-  m_device_impl.inverse_permute(grad_wrt_out, grad_wrt_in);
+  if (m_is_batched_transpose) {
+    auto const shape = m_transpose_shape.transposed();
+    batched_transpose(shape.inner,
+                      shape.rows,
+                      shape.cols,
+                      shape.batch,
+                      grad_wrt_out,
+                      grad_wrt_in);
+  }
+  else {
+    m_device_impl.inverse_permute(grad_wrt_out, grad_wrt_in);
+  }
 }
 
 template <typename T>
@@ -102,6 +128,8 @@ template <typename T>
 void PermuteLayer<T>::PermuteImpl::swap(PermuteImpl& other)
 {
   std::swap(m_device_impl, other.m_device_impl);
+  std::swap(m_transpose_shape, other.m_transpose_shape);
+  std::swap(m_is_batched_transpose, other.m_is_batched_transpose);
 }
 
 // PermuteLayer Implementation
@@ -173,6 +201,12 @@ description PermuteLayer<T>::get_description() const
   return desc;
 }
 
+template <typename T>
+std::vector<int> PermuteLayer<T>::get_axis_permutation() const
+{
+  return m_impl->get_perm();
+}
+
 template <typename T>
 void PermuteLayer<T>::setup_dims(DataReaderMetaData& dr_metadata)
 {
@@ -0,0 +1,200 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "batched_transpose.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+constexpr int tile_dim = 32;
+constexpr int block_rows = 8;
+
+/** Transpose packed matrices through a shared memory tile.
+ *
+ *  Each block handles one tile of each matrix. Reads go along the
+ *  input rows and writes along the output rows, so both are
+ *  coalesced. The tile has an extra column to avoid shared memory
+ *  bank conflicts.
+ */
+template <typename T>
+__global__ void tiled_transpose_kernel(El::Int rows,
+                                       El::Int cols,
+                                       El::Int batch,
+                                       El::Int num_samples,
+                                       const T* __restrict__ input,
+                                       El::Int input_ldim,
+                                       T* __restrict__ output,
+                                       El::Int output_ldim)
+{
+  __shared__ T tile[tile_dim][tile_dim + 1];
+
+  const El::Int row0 = blockIdx.x * tile_dim;
+  const El::Int col0 = blockIdx.y * tile_dim;
+  const El::Int matrix_size = rows * cols;
+  const El::Int num_matrices = batch * num_samples;
+  for (El::Int k = blockIdx.z; k < num_matrices; k += gridDim.z) {
+    const El::Int sample = k / batch;
+    const El::Int offset = (k % batch) * matrix_size;
+    const T* x = input + sample * input_ldim + offset;
+    T* y = output + sample * output_ldim + offset;
+
+    // Read tile, with threads along the input rows
+    for (int j = threadIdx.y; j < tile_dim; j += block_rows) {
+      const El::Int row = row0 + threadIdx.x;
+      const El::Int col = col0 + j;
+      if (row < rows && col < cols) {
+        tile[j][threadIdx.x] = x[row + col * rows];
+      }
+    }
+    __syncthreads();
+
+    // Write transposed tile, with threads along the output rows
+    for (int j = threadIdx.y; j < tile_dim; j += block_rows) {
+      const El::Int row = row0 + j;
+      const El::Int col = col0 + threadIdx.x;
+      if (row < rows && col < cols) {
+        y[col + row * cols] = tile[threadIdx.x][j];
+      }
+    }
+    __syncthreads();
+  }
+}
+
+/** Transpose packed matrices whose entries are contiguous blocks.
+ *
+ *  Threads go along the output, and consecutive threads read from
+ *  the same block, so reads are coalesced within a block.
+ */
+template <typename T>
+__global__ void blocked_transpose_kernel(El::Int inner,
+                                         El::Int rows,
+                                         El::Int cols,
+                                         El::Int batch,
+                                         El::Int num_samples,
+                                         const T* __restrict__ input,
+                                         El::Int input_ldim,
+                                         T* __restrict__ output,
+                                         El::Int output_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int sample_size = inner * rows * cols * batch;
+  const El::Int size = sample_size * num_samples;
+  for (El::Int pos = gidx; pos < size; pos += num_threads) {
+    const El::Int sample = pos / sample_size;
+    const El::Int output_index = pos % sample_size;
+    El::Int index = output_index;
+    const El::Int e = index % inner;
+    index /= inner;
+    const El::Int c = index % cols;
+    index /= cols;
+    const El::Int r = index % rows;
+    const El::Int b = index / rows;
+    const El::Int input_index = e + inner * (r + rows * (c + cols * b));
+    output[output_index + sample * output_ldim] =
+      input[input_index + sample * input_ldim];
+  }
+}
+
+} // namespace
+
+template <typename T>
+void batched_transpose(El::Int inner,
+                       El::Int rows,
+                       El::Int cols,
+                       El::Int batch,
+                       El::Matrix<T, El::Device::GPU> const& input,
+                       El::Matrix<T, El::Device::GPU>& output)
+{
+  if (input.IsEmpty()) {
+    return;
+  }
+  if (rows == 1 || cols == 1) {
+    El::Copy(input, output);
+    return;
+  }
+
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(output), gpu::get_sync_info(input));
+  const El::Int num_samples = input.Width();
+  if (inner == 1) {
+    constexpr El::Int max_grid_dim_z = 65535;
+    dim3 block_dims, grid_dims;
+    block_dims.x = tile_dim;
+    block_dims.y = block_rows;
+    grid_dims.x = (rows + tile_dim - 1) / tile_dim;
+    grid_dims.y = (cols + tile_dim - 1) / tile_dim;
+    grid_dims.z = std::min(batch * num_samples, max_grid_dim_z);
+    hydrogen::gpu::LaunchKernel(tiled_transpose_kernel<T>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                multisync,
+                                rows,
+                                cols,
+                                batch,
+                                num_samples,
+                                input.LockedBuffer(),
+                                input.LDim(),
+                                output.Buffer(),
+                                output.LDim());
+  }
+  else {
+    constexpr El::Int block_size = 256;
+    const El::Int size = inner * rows * cols * batch * num_samples;
+    const El::Int grid_size = (size + block_size - 1) / block_size;
+    hydrogen::gpu::LaunchKernel(blocked_transpose_kernel<T>,
+                                grid_size,
+                                block_size,
+                                0,
+                                multisync,
+                                inner,
+                                rows,
+                                cols,
+                                batch,
+                                num_samples,
+                                input.LockedBuffer(),
+                                input.LDim(),
+                                output.Buffer(),
+                                output.LDim());
+  }
+}
+
+#define PROTO(T)                                                               \
+  template void batched_transpose(El::Int,                                     \
+                                  El::Int,                                     \
+                                  El::Int,                                     \
+                                  El::Int,                                     \
+                                  El::Matrix<T, El::Device::GPU> const&,       \
+                                  El::Matrix<T, El::Device::GPU>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
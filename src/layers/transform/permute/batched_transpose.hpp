@@ -0,0 +1,50 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#ifndef LBANN_SRC_LAYERS_TRANSFORM_PERMUTE_BATCHED_TRANSPOSE_HPP_INCLUDED
+#define LBANN_SRC_LAYERS_TRANSFORM_PERMUTE_BATCHED_TRANSPOSE_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+
+namespace lbann {
+
+/** @brief Permute each column of a matrix as a batched transpose.
+ *
+ *  Each column is a packed column-major tensor of shape (inner, rows,
+ *  cols, batch), and is written to the output with the rows and cols
+ *  axes swapped (see BatchedTransposeShape). When @c inner is 1, the
+ *  entries go through shared memory tiles so that both the reads and
+ *  the writes are coalesced.
+ */
+template <typename T>
+void batched_transpose(El::Int inner,
+                       El::Int rows,
+                       El::Int cols,
+                       El::Int batch,
+                       El::Matrix<T, El::Device::GPU> const& input,
+                       El::Matrix<T, El::Device::GPU>& output);
+
+} // namespace lbann
+#endif // LBANN_SRC_LAYERS_TRANSFORM_PERMUTE_BATCHED_TRANSPOSE_HPP_INCLUDED
@@ -36,6 +36,7 @@
 #include "cutt_permuteimpl.hpp"
 #endif
 
+#include "batched_transpose.hpp"
 #include "tensor_dims_utils.hpp"
 
 #include <cereal/cereal.hpp>
@@ -88,6 +89,14 @@ public:
 
 private:
   DeviceImplType m_device_impl;
+  /** Shape of the permutation as a batched transpose. Only valid if
+   *  @c m_is_batched_transpose is set.
+   */
+  BatchedTransposeShape m_transpose_shape;
+  /** Whether the permutation is done with the batched transpose
+   *  kernel rather than the tensor library.
+   */
+  bool m_is_batched_transpose = false;
 
 }; // class PermuteImpl
 
@@ -29,6 +29,8 @@
 #include "lbann/utils/exception.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -356,6 +358,123 @@ static auto permute_dims(ColMajorDims<IndexT> const& in,
   return ColMajor(permute_impl(in.get(), perm.get()));
 }
 
+///@}
+/** @name Batched matrix transposes */
+///@{
+
+/** @brief A permutation written as a batched matrix transpose.
+ *
+ *  The tensor is viewed as a packed column-major tensor of shape
+ *  (inner, rows, cols, batch), and the permutation swaps the rows
+ *  and cols axes. Contiguous blocks of @c inner entries move
+ *  together. The identity permutation has rows = cols = 1.
+ */
+struct BatchedTransposeShape
+{
+  int64_t inner = 1;
+  int64_t rows = 1;
+  int64_t cols = 1;
+  int64_t batch = 1;
+
+  /** @brief Shape of the inverse permutation. */
+  BatchedTransposeShape transposed() const
+  {
+    return BatchedTransposeShape{inner, cols, rows, batch};
+  }
+};
+
+/** @brief Write a permutation as a batched matrix transpose.
+ *
+ *  Unit dimensions are dropped, and axes that are adjacent in both
+ *  the input and the output are merged. This covers the 2D
+ *  transpose, swapping the last two axes of a 3D tensor (with or
+ *  without the leading batch axis), and any other permutation that
+ *  swaps two blocks of axes.
+ *
+ *  @returns Whether the permutation has this form.
+ */
+template <typename IndexT>
+static bool get_batched_transpose_shape(ColMajorPerm const& perm,
+                                        ColMajorDims<IndexT> const& dims,
+                                        BatchedTransposeShape& shape)
+{
+  std::vector<int> const& perm_vec = perm.get();
+  std::vector<IndexT> const& dim_vec = dims.get();
+  size_t const ndims = dim_vec.size();
+  if (perm_vec.size() != ndims)
+    return false;
+
+  // Drop unit dimensions and renumber the remaining axes
+  std::vector<int> new_axis(ndims, -1);
+  std::vector<int64_t> in_dims;
+  for (size_t ii = 0UL; ii < ndims; ++ii) {
+    if (dim_vec[ii] != 1) {
+      new_axis[ii] = static_cast<int>(in_dims.size());
+      in_dims.push_back(dim_vec[ii]);
+    }
+  }
+  std::vector<int> squeezed_perm;
+  for (size_t ii = 0UL; ii < ndims; ++ii)
+    if (new_axis[perm_vec[ii]] >= 0)
+      squeezed_perm.push_back(new_axis[perm_vec[ii]]);
+
+  // Merge output axes that are also adjacent in the input
+  std::vector<int> group_first_axis;
+  std::vector<int64_t> group_dims;
+  for (size_t ii = 0UL; ii < squeezed_perm.size(); ++ii) {
+    if (ii > 0UL && squeezed_perm[ii] == squeezed_perm[ii - 1] + 1) {
+      group_dims.back() *= in_dims[squeezed_perm[ii]];
+    }
+    else {
+      group_first_axis.push_back(squeezed_perm[ii]);
+      group_dims.push_back(in_dims[squeezed_perm[ii]]);
+    }
+  }
+
+  // Permutation of the merged axes, and their input dimensions
+  size_t const ngroups = group_first_axis.size();
+  std::vector<int> order(ngroups);
+  std::iota(begin(order), end(order), 0);
+  std::sort(begin(order), end(order), [&](int const& a, int const& b) {
+    return group_first_axis[a] < group_first_axis[b];
+  });
+  std::vector<int> merged_perm(ngroups);
+  std::vector<int64_t> merged_dims(ngroups);
+  for (size_t ii = 0UL; ii < ngroups; ++ii) {
+    merged_perm[order[ii]] = static_cast<int>(ii);
+    merged_dims[ii] = group_dims[order[ii]];
+  }
+
+  shape = BatchedTransposeShape{};
+  if (ngroups <= 1UL) {
+    shape.inner = (ngroups == 1UL ? merged_dims[0] : 1);
+  }
+  else if (merged_perm == std::vector<int>{1, 0}) {
+    shape.rows = merged_dims[0];
+    shape.cols = merged_dims[1];
+  }
+  else if (merged_perm == std::vector<int>{1, 0, 2}) {
+    shape.rows = merged_dims[0];
+    shape.cols = merged_dims[1];
+    shape.batch = merged_dims[2];
+  }
+  else if (merged_perm == std::vector<int>{0, 2, 1}) {
+    shape.inner = merged_dims[0];
+    shape.rows = merged_dims[1];
+    shape.cols = merged_dims[2];
+  }
+  else if (merged_perm == std::vector<int>{0, 2, 1, 3}) {
+    shape.inner = merged_dims[0];
+    shape.rows = merged_dims[1];
+    shape.cols = merged_dims[2];
+    shape.batch = merged_dims[3];
+  }
+  else {
+    return false;
+  }
+  return true;
+}
+
 ///@}
 
 #endif // SRC_LAYERS_TRANSFORM_TENSOR_DIMS_UTILS_HPP_INCLUDED
@@ -389,6 +389,7 @@ void pooling_layer<T, L, D>::write_specific_proto(
   protobuf::assign_to_repeated(*msg->mutable_pool_dims(), m_pool_dims);
   protobuf::assign_to_repeated(*msg->mutable_pool_pads(), m_pads);
   protobuf::assign_to_repeated(*msg->mutable_pool_strides(), m_strides);
+  msg->set_channels_last(m_channels_last);
 }
 
 #ifdef LBANN_HAS_DISTCONV
@@ -413,7 +414,8 @@ pooling_layer<TensorDataType, T_layout, Dev>::get_distconv_adapter() const
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 bool pooling_layer<TensorDataType, T_layout, Dev>::is_distconv_supported() const
 {
-  if (Dev != El::Device::GPU || T_layout != data_layout::DATA_PARALLEL) {
+  if (Dev != El::Device::GPU || T_layout != data_layout::DATA_PARALLEL ||
+      m_channels_last) {
     return false;
   }
 
@@ -615,7 +617,8 @@ build_pooling_layer_from_pbuf(lbann_comm* comm,
                               protobuf::to_vector<int>(params.pool_dims()),
                               protobuf::to_vector<int>(params.pool_pads()),
                               protobuf::to_vector<int>(params.pool_strides()),
-                              mode);
+                              mode,
+                              params.channels_last());
   }
   else {
     return BuilderType::Build(comm,
@@ -623,7 +626,8 @@ build_pooling_layer_from_pbuf(lbann_comm* comm,
                               params.pool_dims_i(),
                               params.pool_pads_i(),
                               params.pool_strides_i(),
-                              mode);
+                              mode,
+                              params.channels_last());
   }
 }
 
@@ -25,69 +25,10 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #define LBANN_REDUCTION_LAYER_INSTANTIATE
-#include "lbann/layers/transform/reduction.hpp"
-#include "lbann/proto/datatype_helpers.hpp"
-#include "lbann/proto/proto_common.hpp"
-
-#include "lbann/proto/layers.pb.h"
+#include "lbann/layers/transform/reduction_impl.hpp"
 
 namespace lbann {
 
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-reduction_layer<TensorDataType, Layout, Device>::reduction_layer(
-  reduction_mode mode)
-  : data_type_layer<TensorDataType>(nullptr), m_mode(mode)
-{
-  if (mode == reduction_mode::INVALID) {
-    LBANN_ERROR("invalid reduction mode");
-  }
-}
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-std::unique_ptr<Layer>
-build_reduction_layer_from_pbuf(lbann_comm* comm,
-                                lbann_data::Layer const& proto_layer)
-{
-  using LayerType = reduction_layer<TensorDataType, Layout, Device>;
-  LBANN_ASSERT_MSG_HAS_FIELD(proto_layer, reduction);
-  const auto& params = proto_layer.reduction();
-  const std::string mode_str = params.mode();
-  reduction_mode mode = reduction_mode::INVALID;
-  if (mode_str == "sum" || mode_str.empty()) {
-    mode = reduction_mode::SUM;
-  }
-  if (mode_str == "mean" || mode_str == "average") {
-    mode = reduction_mode::AVERAGE;
-  }
-  return std::make_unique<LayerType>(mode);
-}
-
-template <typename T, data_layout L, El::Device D>
-void reduction_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
-{
-  proto.set_datatype(proto::ProtoDataType<T>);
-  auto* msg = proto.mutable_reduction();
-  switch (m_mode) {
-  case reduction_mode::SUM:
-    msg->set_mode("sum");
-    break;
-  case reduction_mode::AVERAGE:
-    msg->set_mode("mean");
-    break;
-  default:
-    msg->set_mode("invalid");
-  }
-}
-
-template <typename TensorDataType, data_layout Layout, El::Device Device>
-void reduction_layer<TensorDataType, Layout, Device>::setup_dims(
-  DataReaderMetaData& dr_metadata)
-{
-  data_type_layer<TensorDataType>::setup_dims(dr_metadata);
-  this->set_output_dims({1});
-}
-
 template <typename TensorDataType, data_layout Layout, El::Device Device>
 void reduction_layer<TensorDataType, Layout, Device>::fp_compute()
 {
@@ -198,10 +139,16 @@ void reduction_layer<TensorDataType, Layout, Device>::bp_compute()
   }
 }
 
-#define PROTO_DEVICE(T, Device)                                                \
-  template class reduction_layer<T, data_layout::DATA_PARALLEL, Device>;       \
-  template class reduction_layer<T, data_layout::MODEL_PARALLEL, Device>;      \
-  LBANN_LAYER_BUILDER_ETI(reduction, T, Device)
-#include "lbann/macros/instantiate_device.hpp"
+#define PROTO(T)                                                               \
+  template class reduction_layer<T,                                            \
+                                 data_layout::DATA_PARALLEL,                   \
+                                 El::Device::CPU>;                             \
+  template class reduction_layer<T,                                            \
+                                 data_layout::MODEL_PARALLEL,                  \
+                                 El::Device::CPU>;                             \
+  LBANN_LAYER_BUILDER_ETI(reduction, T, El::Device::CPU)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
 
 } // namespace lbann
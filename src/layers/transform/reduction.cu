@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_REDUCTION_LAYER_INSTANTIATE
+#include "lbann/layers/transform/reduction_impl.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Scaled sum of each matrix column
+ *
+ *  Each block reduces one column at a time in shared memory, so the
+ *  column is read once with coalesced accesses.
+ */
+template <size_t bdim, typename TensorDataType>
+__global__ void column_sums_kernel(El::Int height,
+                                   El::Int width,
+                                   TensorDataType scale,
+                                   const TensorDataType* __restrict__ input,
+                                   El::Int input_ldim,
+                                   TensorDataType* __restrict__ sums,
+                                   El::Int sums_ldim)
+{
+  __shared__ TensorDataType shared_sums[bdim];
+  const size_t tid = threadIdx.x;
+  for (El::Int col = blockIdx.x; col < width; col += gridDim.x) {
+    TensorDataType sum = 0.f;
+    for (El::Int row = tid; row < height; row += bdim) {
+      sum += input[row + col * input_ldim];
+    }
+    shared_sums[tid] = sum;
+    for (size_t stride = bdim / 2; stride > 0; stride /= 2) {
+      __syncthreads();
+      if (tid < stride) {
+        shared_sums[tid] += shared_sums[tid + stride];
+      }
+    }
+    if (tid == 0) {
+      sums[col * sums_ldim] = scale * shared_sums[0];
+    }
+    __syncthreads();
+  }
+}
+
+/** @brief Fill each matrix column with a scaled entry of a row vector */
+template <typename TensorDataType>
+__global__ void expand_columns_kernel(El::Int height,
+                                      El::Int width,
+                                      TensorDataType scale,
+                                      const TensorDataType* __restrict__ values,
+                                      El::Int values_ldim,
+                                      TensorDataType* __restrict__ output,
+                                      El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % height;
+    const El::Int col = pos / height;
+    output[row + col * output_ldim] = scale * values[col * values_ldim];
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void reduction_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+
+  // Data matrices
+  using LocalMat = El::Matrix<TensorDataType, Device>;
+  const auto& input = this->get_prev_activations();
+  auto& output = this->get_activations();
+  const auto& local_input = input.LockedMatrix();
+
+  // Create workspace buffers
+  LocalMat local_reduction;
+  const auto& col_comm = input.ColComm();
+  const auto col_rank = El::mpi::Rank(col_comm);
+  const auto owner_rank = output.RowOwner(0);
+  if (col_rank == owner_rank) {
+    El::View(local_reduction, output.Matrix());
+  }
+  else {
+    local_reduction.Resize(1, input.LocalWidth());
+  }
+
+  // Compute local reductions
+  auto scale = El::TypeTraits<TensorDataType>::One();
+  switch (m_mode) {
+  case reduction_mode::SUM:
+    break;
+  case reduction_mode::AVERAGE:
+    scale /= El::To<TensorDataType>(input.Height());
+    break;
+  default:
+    LBANN_ERROR("invalid reduction mode");
+  }
+  const El::Int width = local_input.Width();
+  if (width > 0) {
+    constexpr size_t block_size = 256;
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_reduction),
+                                       gpu::get_sync_info(local_input));
+    hydrogen::gpu::LaunchKernel(
+      column_sums_kernel<block_size, TensorDataType>,
+      std::min(width, El::Int(65535)),
+      block_size,
+      0,
+      multisync,
+      local_input.Height(),
+      width,
+      scale,
+      local_input.LockedBuffer(),
+      local_input.LDim(),
+      local_reduction.Buffer(),
+      local_reduction.LDim());
+  }
+
+  // Accumulate local reductions in output matrix
+  /// @todo Replace with Reduce when supported in Hydrogen.
+  El::AllReduce(local_reduction, col_comm, El::mpi::SUM);
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void reduction_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+
+  // Data matrices
+  using LocalMat = El::Matrix<TensorDataType, Device>;
+  const auto& output_grad = this->get_prev_error_signals();
+  auto& input_grad = this->get_error_signals();
+  auto& local_input_grad = input_grad.Matrix();
+
+  // Create workspace buffers
+  LocalMat local_output_grad;
+  const auto& col_comm = input_grad.ColComm();
+  const auto col_rank = El::mpi::Rank(col_comm);
+  const auto owner_rank = output_grad.RowOwner(0);
+  if (col_rank == owner_rank) {
+    El::LockedView(local_output_grad, output_grad.LockedMatrix());
+  }
+  else {
+    local_output_grad.Resize(1, input_grad.LocalWidth());
+  }
+  /** @todo (tym1 3/12/21): We are working around a bug in Hydrogen.
+   *  Broadcast with Matrix<T,D> is not instatiated. */
+  El::Broadcast(
+    static_cast<El::AbstractMatrix<TensorDataType>&>(local_output_grad),
+    col_comm,
+    owner_rank);
+
+  // Populate error signals
+  auto scale = El::TypeTraits<TensorDataType>::One();
+  switch (m_mode) {
+  case reduction_mode::SUM:
+    break;
+  case reduction_mode::AVERAGE:
+    scale /= El::To<TensorDataType>(input_grad.Height());
+    break;
+  default:
+    LBANN_ERROR("invalid reduction mode");
+  }
+  const El::Int height = local_input_grad.Height();
+  const El::Int width = local_input_grad.Width();
+  if (height > 0 && width > 0) {
+    constexpr El::Int block_size = 256;
+    const El::Int grid_size =
+      std::min((height * width + block_size - 1) / block_size, El::Int(65535));
+    auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_input_grad),
+                                       gpu::get_sync_info(local_output_grad));
+    hydrogen::gpu::LaunchKernel(expand_columns_kernel<TensorDataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                multisync,
+                                height,
+                                width,
+                                scale,
+                                local_output_grad.LockedBuffer(),
+                                local_output_grad.LDim(),
+                                local_input_grad.Buffer(),
+                                local_input_grad.LDim());
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class reduction_layer<T,                                            \
+                                 data_layout::DATA_PARALLEL,                   \
+                                 El::Device::GPU>;                             \
+  template class reduction_layer<T,                                            \
+                                 data_layout::MODEL_PARALLEL,                  \
+                                 El::Device::GPU>;                             \
+  LBANN_LAYER_BUILDER_ETI(reduction, T, El::Device::GPU)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -28,6 +28,8 @@
 #include "lbann/layers/transform/scatter.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "sorted_scatter.cuh"
+
 #if defined(LBANN_HAS_DISTCONV) && defined(LBANN_HAS_NVSHMEM)
 #include "lbann/utils/nvshmem.hpp"
 #endif
@@ -234,7 +236,22 @@ void scatter_layer<TensorDataType, Layout, Device>::fp_compute()
     grid_dims.z = (local_mini_batch_size + block_dims.z - 1) / block_dims.z;
     gpu_lib::clip_grid_dims(grid_dims);
 
-    if (has_row_vectors) {
+    const size_t num_entries = num_rows * values_size;
+    const size_t num_targets = num_output_rows * output_size;
+    if (internal::use_sorted_scatter(num_entries, num_targets)) {
+      internal::sorted_scatter3d(
+        has_row_vectors,
+        local_indices.LockedBuffer(),
+        Dim2{static_cast<size_t>(local_indices.LDim()), 1},
+        local_values.LockedBuffer(),
+        Dim3{local_mini_batch_size, num_rows, values_size},
+        Dim3{static_cast<size_t>(local_values.LDim()), value_stride_2, 1},
+        local_output.Buffer(),
+        Dim3{local_mini_batch_size, num_output_rows, output_size},
+        Dim3{static_cast<size_t>(local_output.LDim()), output_stride_2, 1},
+        multisync);
+    }
+    else if (has_row_vectors) {
       hydrogen::gpu::LaunchKernel(
         scatter3d_kernel<TensorDataType, true>,
         grid_dims,
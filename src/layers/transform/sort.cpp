@@ -27,6 +27,10 @@
 #define LBANN_SORT_LAYER_INSTANTIATE
 #include "lbann/layers/transform/sort_impl.hpp"
 
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
 namespace lbann {
 
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
@@ -41,25 +45,27 @@ void sort_layer<TensorDataType, T_layout, Dev>::fp_compute()
   const auto& local_width = local_input.Width();
 
   // Sort each matrix column
+  // Note: Row indices are sorted in a contiguous buffer, which is
+  // much cheaper than building a node-based container.
+  const bool descending = this->m_descending;
   LBANN_OMP_PARALLEL_FOR
   for (El::Int col = 0; col < local_width; ++col) {
-    std::multimap<DataType, El::Int> sorted_list;
-    for (El::Int row = 0; row < local_height; ++row) {
-      sorted_list.emplace(local_input(row, col), row);
-    }
-    if (this->m_descending) {
-      auto&& it = sorted_list.rbegin();
-      for (El::Int row = 0; row < local_height; ++row, ++it) {
-        local_output(row, col) = it->first;
-        local_indices(row, col) = it->second;
-      }
+    const TensorDataType* x = local_input.LockedBuffer(0, col);
+    std::vector<El::Int> rows(local_height);
+    std::iota(rows.begin(), rows.end(), El::Int(0));
+    if (descending) {
+      std::stable_sort(rows.begin(), rows.end(), [x](El::Int a, El::Int b) {
+        return x[a] > x[b];
+      });
     }
     else {
-      auto&& it = sorted_list.begin();
-      for (El::Int row = 0; row < local_height; ++row, ++it) {
-        local_output(row, col) = it->first;
-        local_indices(row, col) = it->second;
-      }
+      std::stable_sort(rows.begin(), rows.end(), [x](El::Int a, El::Int b) {
+        return x[a] < x[b];
+      });
+    }
+    for (El::Int row = 0; row < local_height; ++row) {
+      local_output(row, col) = x[rows[row]];
+      local_indices(row, col) = rows[row];
     }
   }
 }
@@ -36,12 +36,47 @@ namespace thrust_gpu = thrust::cuda;
 namespace thrust_gpu = thrust::hip;
 #endif
 #include <thrust/device_ptr.h>
+#include <thrust/iterator/zip_iterator.h>
 #include <thrust/scatter.h>
 #include <thrust/sequence.h>
 #include <thrust/sort.h>
+#include <thrust/transform.h>
 
 namespace lbann {
 
+namespace {
+
+/** Tallest columns that are sorted together.
+ *
+ *  Sorting all columns at once costs two sorts of the whole matrix,
+ *  which only pays off when per-column launches dominate, i.e. for
+ *  short columns. Tall columns are already sorted efficiently one at
+ *  a time.
+ */
+constexpr El::Int max_batched_sort_height = 1 << 16;
+
+/** Column of an entry in a contiguous column-major matrix. */
+struct column_index
+{
+  El::Int height;
+  __host__ __device__ El::Int operator()(El::Int i) const
+  {
+    return i / height;
+  }
+};
+
+/** Row of an entry in a contiguous column-major matrix. */
+struct row_index
+{
+  El::Int height;
+  __host__ __device__ El::Int operator()(El::Int i) const
+  {
+    return i % height;
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType, data_layout T_layout, El::Device Dev>
 void sort_layer<TensorDataType, T_layout, Dev>::fp_compute()
 {
@@ -60,6 +95,67 @@ void sort_layer<TensorDataType, T_layout, Dev>::fp_compute()
   auto&& stream = sync_info.Stream();
   gpu_lib::thrust::allocator<> alloc(stream);
 
+  // Sort all matrix columns at once
+  // Note: Entries are sorted by value and then stably sorted by
+  // column, so the cost is two radix sorts of the whole local matrix
+  // instead of one sort launch per column.
+  if (local_width > 1 && local_height <= max_batched_sort_height) {
+    const El::Int size = local_height * local_width;
+    El::SetSyncInfo(m_sort_values, sync_info);
+    El::SetSyncInfo(m_sort_indices, sync_info);
+    El::SetSyncInfo(m_sort_columns, sync_info);
+    m_sort_values.Resize(size, 1);
+    m_sort_indices.Resize(size, 1);
+    m_sort_columns.Resize(size, 1);
+    El::Matrix<TensorDataType, El::Device::GPU> values;
+    values.Attach(local_height,
+                  local_width,
+                  m_sort_values.Buffer(),
+                  local_height);
+    El::Copy(local_input, values);
+    ::thrust::device_ptr<TensorDataType> vals(m_sort_values.Buffer());
+    ::thrust::device_ptr<El::Int> inds(m_sort_indices.Buffer());
+    ::thrust::device_ptr<El::Int> cols(m_sort_columns.Buffer());
+    ::thrust::sequence(thrust_gpu::par(alloc).on(stream), inds, inds + size);
+    if (this->m_descending) {
+      ::thrust::stable_sort_by_key(thrust_gpu::par(alloc).on(stream),
+                                   vals,
+                                   vals + size,
+                                   inds,
+                                   ::thrust::greater<TensorDataType>());
+    }
+    else {
+      ::thrust::stable_sort_by_key(thrust_gpu::par(alloc).on(stream),
+                                   vals,
+                                   vals + size,
+                                   inds,
+                                   ::thrust::less<TensorDataType>());
+    }
+    ::thrust::transform(thrust_gpu::par(alloc).on(stream),
+                        inds,
+                        inds + size,
+                        cols,
+                        column_index{local_height});
+    ::thrust::stable_sort_by_key(
+      thrust_gpu::par(alloc).on(stream),
+      cols,
+      cols + size,
+      ::thrust::make_zip_iterator(::thrust::make_tuple(vals, inds)));
+    ::thrust::transform(thrust_gpu::par(alloc).on(stream),
+                        inds,
+                        inds + size,
+                        inds,
+                        row_index{local_height});
+    El::Matrix<El::Int, El::Device::GPU> indices;
+    indices.Attach(local_height,
+                   local_width,
+                   m_sort_indices.Buffer(),
+                   local_height);
+    El::Copy(values, local_output);
+    El::Copy(indices, local_indices);
+    return;
+  }
+
   // Sort each matrix column
   El::Copy(local_input, local_output);
   for (El::Int col = 0; col < local_width; ++col) {
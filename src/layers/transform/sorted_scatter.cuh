@@ -0,0 +1,244 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef LBANN_SRC_LAYERS_TRANSFORM_SORTED_SCATTER_CUH_INCLUDED
+#define LBANN_SRC_LAYERS_TRANSFORM_SORTED_SCATTER_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+#include <thrust/functional.h>
+#include <thrust/reduce.h>
+#include <thrust/sort.h>
+
+namespace lbann {
+namespace internal {
+
+/** @brief Whether a 3D scatter should avoid atomic adds.
+ *
+ *  Atomic adds serialize on colliding targets and their order varies
+ *  between runs. When each sample scatters more entries than it has
+ *  targets, collisions are guaranteed, so the entries are sorted by
+ *  target and summed in a fixed order instead. Deterministic builds
+ *  always sort.
+ *
+ *  @param num_entries Entries scattered by each sample.
+ *  @param num_targets Output entries of each sample.
+ */
+inline bool use_sorted_scatter(size_t num_entries, size_t num_targets)
+{
+#ifdef LBANN_DETERMINISTIC
+  return true;
+#else
+  return num_entries > num_targets;
+#endif // LBANN_DETERMINISTIC
+}
+
+namespace kernel {
+
+/** @brief Compute the output offset of each scattered entry.
+ *
+ *  Entries are flattened in (batch, row, column) order and packed
+ *  into contiguous key/value buffers. Entries with out-of-bounds
+ *  indices get a negative key.
+ */
+template <typename T, bool has_row_vectors>
+__global__ void
+scatter3d_keys_kernel(const T* __restrict__ indices,
+                      gpu_lib::array<size_t, 2> indices_strides,
+                      const T* __restrict__ values,
+                      gpu_lib::array<size_t, 3> values_dims,
+                      gpu_lib::array<size_t, 3> values_strides,
+                      gpu_lib::array<size_t, 3> output_dims,
+                      gpu_lib::array<size_t, 3> output_strides,
+                      El::Int* __restrict__ keys,
+                      T* __restrict__ sorted_values)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = gridDim.x * blockDim.x;
+  const auto num_rows = values_dims[1];
+  const auto num_value_columns = values_dims[2];
+  const auto size = values_dims[0] * num_rows * num_value_columns;
+  const auto bounds = has_row_vectors ? output_dims[1] : output_dims[2];
+  for (size_t pos = gid; pos < size; pos += nthreads) {
+    const auto i = pos % num_value_columns;
+    const auto row = (pos / num_value_columns) % num_rows;
+    const auto batch = pos / (num_value_columns * num_rows);
+    const auto axis = has_row_vectors ? row : i;
+    const auto ind = static_cast<El::Int>(gpu_lib::floor(
+      indices[batch * indices_strides[0] + axis * indices_strides[1]]));
+    El::Int key = -1;
+    if (0 <= ind && ind < static_cast<El::Int>(bounds)) {
+      const auto output_axis_1 =
+        has_row_vectors ? ind : static_cast<El::Int>(row);
+      const auto output_axis_2 =
+        has_row_vectors ? static_cast<El::Int>(i) : ind;
+      key = batch * output_strides[0] + output_axis_1 * output_strides[1] +
+            output_axis_2 * output_strides[2];
+    }
+    keys[pos] = key;
+    sorted_values[pos] = values[batch * values_strides[0] +
+                                row * values_strides[1] +
+                                i * values_strides[2]];
+  }
+}
+
+/** @brief Add per-target sums into the output buffer. */
+template <typename T>
+__global__ void add_at_keys_kernel(size_t size,
+                                   const El::Int* __restrict__ keys,
+                                   const T* __restrict__ sums,
+                                   T* __restrict__ output)
+{
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = gridDim.x * blockDim.x;
+  for (size_t pos = gid; pos < size; pos += nthreads) {
+    const auto& key = keys[pos];
+    if (key >= 0) {
+      output[key] += sums[pos];
+    }
+  }
+}
+
+/** Sum of two entries. */
+struct add_op
+{
+  template <typename T>
+  __device__ __forceinline__ T operator()(const T& x, const T& y) const
+  {
+    return x + y;
+  }
+};
+
+} // namespace kernel
+
+/** @brief Scatter-add a 3D tensor without atomics.
+ *
+ *  Computes the same result as an atomic scatter:
+ *
+ *  output(k,indices(k,j),j) += values(k,j,i) if has_row_vectors
+ *  output(k,j,indices(k,i)) += values(k,j,i) otherwise
+ *
+ *  Entries are stable-sorted by output offset and each run of equal
+ *  offsets is reduced, so every target is summed in the same order
+ *  on each run and a target with many contributions costs a segment
+ *  of a parallel reduction rather than a chain of serialized atomics.
+ */
+template <typename T>
+void sorted_scatter3d(bool has_row_vectors,
+                      const T* indices,
+                      gpu_lib::array<size_t, 2> indices_strides,
+                      const T* values,
+                      gpu_lib::array<size_t, 3> values_dims,
+                      gpu_lib::array<size_t, 3> values_strides,
+                      T* output,
+                      gpu_lib::array<size_t, 3> output_dims,
+                      gpu_lib::array<size_t, 3> output_strides,
+                      const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  const size_t size = values_dims[0] * values_dims[1] * values_dims[2];
+  if (size == 0) {
+    return;
+  }
+  auto stream = sync_info.Stream();
+  gpu_lib::thrust::allocator<> alloc(stream);
+  gpu_lib::thrust::vector<El::Int> keys(size);
+  gpu_lib::thrust::vector<T> sorted_values(size);
+  gpu_lib::thrust::vector<El::Int> unique_keys(size);
+  gpu_lib::thrust::vector<T> sums(size);
+
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (size + block_size - 1) / block_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  if (has_row_vectors) {
+    hydrogen::gpu::LaunchKernel(kernel::scatter3d_keys_kernel<T, true>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                indices,
+                                indices_strides,
+                                values,
+                                values_dims,
+                                values_strides,
+                                output_dims,
+                                output_strides,
+                                keys.data().get(),
+                                sorted_values.data().get());
+  }
+  else {
+    hydrogen::gpu::LaunchKernel(kernel::scatter3d_keys_kernel<T, false>,
+                                grid_dims,
+                                block_dims,
+                                0,
+                                sync_info,
+                                indices,
+                                indices_strides,
+                                values,
+                                values_dims,
+                                values_strides,
+                                output_dims,
+                                output_strides,
+                                keys.data().get(),
+                                sorted_values.data().get());
+  }
+
+  // Stable sort keeps the entries of each target in input order
+  ::thrust::stable_sort_by_key(alloc.system(),
+                               keys.begin(),
+                               keys.end(),
+                               sorted_values.begin());
+  const auto ends = ::thrust::reduce_by_key(alloc.system(),
+                                            keys.begin(),
+                                            keys.end(),
+                                            sorted_values.begin(),
+                                            unique_keys.begin(),
+                                            sums.begin(),
+                                            ::thrust::equal_to<El::Int>(),
+                                            kernel::add_op());
+  const size_t num_unique = ends.first - unique_keys.begin();
+  grid_dims.x = (num_unique + block_size - 1) / block_size;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(kernel::add_at_keys_kernel<T>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              sync_info,
+                              num_unique,
+                              unique_keys.data().get(),
+                              sums.data().get(),
+                              output);
+}
+
+} // namespace internal
+} // namespace lbann
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_LAYERS_TRANSFORM_SORTED_SCATTER_CUH_INCLUDED
@@ -42,6 +42,8 @@
 #include "lbann/layers/transform/unpooling.hpp"
 
 #include "lbann/execution_algorithms/execution_context.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 
 #include "lbann/utils/protobuf.hpp"
 
@@ -70,9 +72,12 @@ std::unique_ptr<lbann::Layer>
 lbann::build_concatenate_layer_from_pbuf(lbann_comm* comm,
                                          lbann_data::Layer const& proto_layer)
 {
-  return std::make_unique<concatenate_layer<T, L, D>>(
+  auto layer = std::make_unique<concatenate_layer<T, L, D>>(
     comm,
     proto_layer.concatenation().axis());
+  layer->set_view_inputs(
+    global_argument_parser().get<bool>(LBANN_OPTION_CONCAT_SLICE_VIEWS));
+  return layer;
 }
 
 template <typename T, lbann::data_layout L, El::Device D>
@@ -239,6 +244,8 @@ lbann::build_slice_layer_from_pbuf(lbann_comm* comm,
       params.axis(),
       protobuf::to_vector<size_t>(params.slice_points()));
   }
+  layer->set_view_outputs(
+    global_argument_parser().get<bool>(LBANN_OPTION_CONCAT_SLICE_VIEWS));
   return layer;
 }
 
@@ -295,14 +302,14 @@ std::unique_ptr<lbann::Layer>
 lbann::build_unpooling_layer_from_pbuf(lbann_comm* comm,
                                        lbann_data::Layer const& proto_layer)
 {
-  if constexpr (L == data_layout::DATA_PARALLEL && D == El::Device::CPU) {
-    return std::make_unique<
-      unpooling_layer<T, data_layout::DATA_PARALLEL, El::Device::CPU>>(comm);
+  if constexpr (L == data_layout::DATA_PARALLEL) {
+    return std::make_unique<unpooling_layer<T, data_layout::DATA_PARALLEL, D>>(
+      comm);
   }
   else {
     (void)comm;
     LBANN_ERROR("unpooling layer is only supported with "
-                "a data-parallel layout and on CPU");
+                "a data-parallel layout");
     return nullptr;
   }
 }
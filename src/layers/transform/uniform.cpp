@@ -40,13 +40,16 @@ void uniform_layer<TensorDataType, L, D>::fp_compute()
   const auto& mean = (m_max + m_min) / El::To<TensorDataType>(2);
   const auto& radius = (m_max - m_min) / El::To<TensorDataType>(2);
   auto& output = this->get_activations();
-  const auto& mode =
-    this->m_model->get_execution_context().get_execution_mode();
+  const auto& context = this->m_model->get_execution_context();
+  const auto mode = context.get_execution_mode();
   if (m_training_only && (mode != execution_mode::training)) {
     El::Fill(output, mean);
   }
   else {
-    uniform_fill(output, output.Height(), output.Width(), mean, radius);
+    philox_uniform_fill(output,
+                        mean,
+                        radius,
+                        make_philox_stream(m_seed, context.get_step(), mode));
   }
 }
 
@@ -160,3 +160,110 @@ TEST_CASE("Permuting dimensions", "[permute][dim utils]")
   auto const pdims = permute_dims(dims, perm);
   CHECK(pdims.get() == std::vector<int>{9, 7, 5, 3});
 }
+
+TEST_CASE("Batched transpose shapes", "[permute][dim utils]")
+{
+  BatchedTransposeShape shape;
+
+  SECTION("2D transpose")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({1, 0}));
+    REQUIRE(get_batched_transpose_shape(perm, dims, shape));
+    CHECK(shape.inner == 1);
+    CHECK(shape.rows == 5);
+    CHECK(shape.cols == 4);
+    CHECK(shape.batch == 1);
+  }
+  SECTION("Swap the last two axes")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{3, 4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({0, 2, 1}));
+    REQUIRE(get_batched_transpose_shape(perm, dims, shape));
+    CHECK(shape.inner == 1);
+    CHECK(shape.rows == 5);
+    CHECK(shape.cols == 4);
+    CHECK(shape.batch == 3);
+  }
+  SECTION("Swap the first two axes")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{3, 4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({1, 0, 2}));
+    REQUIRE(get_batched_transpose_shape(perm, dims, shape));
+    CHECK(shape.inner == 5);
+    CHECK(shape.rows == 4);
+    CHECK(shape.cols == 3);
+    CHECK(shape.batch == 1);
+  }
+  SECTION("Adjacent axes are merged")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{2, 3, 4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({2, 3, 0, 1}));
+    REQUIRE(get_batched_transpose_shape(perm, dims, shape));
+    CHECK(shape.inner == 1);
+    CHECK(shape.rows == 20);
+    CHECK(shape.cols == 6);
+    CHECK(shape.batch == 1);
+  }
+  SECTION("Unit dimensions are dropped")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{1, 4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({1, 0, 2}));
+    REQUIRE(get_batched_transpose_shape(perm, dims, shape));
+    CHECK(shape.inner == 20);
+    CHECK(shape.rows == 1);
+    CHECK(shape.cols == 1);
+  }
+  SECTION("Two independent transposes")
+  {
+    auto const dims = ColMajor(RowMajor(std::vector<int>{2, 3, 4, 5}));
+    auto const perm = ColMajorPerm(RowMajorPerm({1, 0, 3, 2}));
+    CHECK_FALSE(get_batched_transpose_shape(perm, dims, shape));
+  }
+}
+
+// Checks the batched transpose against the definition of the
+// permutation, output[i] = input[perm[i]], for every permutation of a
+// fourth-order tensor that can be written as one.
+TEST_CASE("Batched transposes match permutations", "[permute][dim utils]")
+{
+  auto const dims = ColMajor(std::vector<int>{2, 3, 4, 5});
+  auto const in_strides = get_strides(dims).get();
+  int const size = 2 * 3 * 4 * 5;
+
+  ColMajorPerm perm({0, 1, 2, 3});
+  auto& perm_v = perm.get();
+  size_t count = 0;
+  do {
+    BatchedTransposeShape shape;
+    if (!get_batched_transpose_shape(perm, dims, shape))
+      continue;
+    INFO(stringify_vec(perm_v));
+    ++count;
+    REQUIRE(shape.inner * shape.rows * shape.cols * shape.batch == size);
+
+    auto const out_dims = permute_dims(dims, perm).get();
+    bool all_match = true;
+    for (int out_idx = 0; out_idx < size; ++out_idx) {
+      // Input entry from the definition of the permutation
+      int in_idx = 0;
+      for (int ii = 0, tmp = out_idx; ii < 4; ++ii) {
+        in_idx += (tmp % out_dims[ii]) * in_strides[perm_v[ii]];
+        tmp /= out_dims[ii];
+      }
+      // Input entry from the batched transpose
+      int64_t tmp = out_idx;
+      auto const e = tmp % shape.inner;
+      tmp /= shape.inner;
+      auto const c = tmp % shape.cols;
+      tmp /= shape.cols;
+      auto const r = tmp % shape.rows;
+      auto const b = tmp / shape.rows;
+      auto const transpose_idx =
+        e + shape.inner * (r + shape.rows * (c + shape.cols * b));
+      all_match = all_match && (transpose_idx == in_idx);
+    }
+    CHECK(all_match);
+  } while (std::next_permutation(begin(perm_v), end(perm_v)));
+  CHECK(count == 11);
+}
@@ -26,19 +26,139 @@
 
 #define LBANN_UNPOOLING_LAYER_INSTANTIATE
 #include "lbann/layers/transform/unpooling.hpp"
-#include "lbann/proto/datatype_helpers.hpp"
-#include "lbann/proto/layers.pb.h"
 
 namespace lbann {
 
-template <typename T, data_layout L, El::Device D>
-void unpooling_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::fp_compute()
 {
-  proto.set_datatype(proto::ProtoDataType<T>);
-  proto.mutable_unpooling();
-  // Unused
-  // msg->set_num_dims(this->get_output_dims().size());
+  fp_compute_im2col();
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::bp_compute()
+{
+  bp_compute_im2col();
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::fp_compute_im2col()
+{
+
+  using DMatDT = El::Matrix<TensorDataType, Dev>;
+
+  // Get pooling layer
+  const auto& hint_layer =
+    dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
+
+  // Get local matrices
+  const DMatDT& prev_activations_local = this->get_local_prev_activations();
+  DMatDT& activations_local = this->get_local_activations();
+
+  // Get parameters
+  const int local_width = prev_activations_local.Width();
+  const auto& output_dims = this->get_output_dims();
+  const int num_channels = output_dims[0];
+  const int num_per_input_channel = this->get_input_size() / num_channels;
+  const int pool_size = hint_layer.m_pool_size;
+
+  // Initialize im2col matrix
+  DMatDT im2col_mat(pool_size * num_channels, num_per_input_channel);
+
+  // Iterate through data samples
+  for (int sample = 0; sample < local_width; ++sample) {
+
+    // Clear im2col matrix
+    El::Zero(im2col_mat);
+
+    // Populate im2col matrix
+    const TensorDataType* prev_activations_buffer =
+      prev_activations_local.LockedBuffer(0, sample);
+    const int* indices_buffer =
+      &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
+    LBANN_OMP_PARALLEL_FOR
+    for (int channel = 0; channel < num_channels; ++channel) {
+      for (int j = 0; j < num_per_input_channel; ++j) {
+        const int input_index = j + channel * num_per_input_channel;
+        const int max_index = indices_buffer[input_index];
+        TensorDataType* im2col_buffer =
+          im2col_mat.Buffer(channel * pool_size, j);
+        im2col_buffer[max_index] = prev_activations_buffer[input_index];
+      }
+    }
+
+    // Convert im2col matrix to output matrix
+    DMatDT output_mat = El::View(activations_local, El::ALL, El::IR(sample));
+    col2im<TensorDataType>(
+      im2col_mat,
+      output_mat,
+      num_channels,
+      output_dims.size() - 1,
+      &output_dims[1],
+      hint_layer.m_pads.data(),
+      hint_layer.m_pool_dims.data(),
+      hint_layer.m_strides.data(),
+      [](TensorDataType const& a, TensorDataType const& b) {
+        return std::max(a, b);
+      });
+  }
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::bp_compute_im2col()
+{
+
+  using DMatDT = El::Matrix<TensorDataType, Dev>;
+
+  // Get pooling layer
+  const auto& hint_layer =
+    dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
+
+  // Get local matrices
+  const DMatDT& prev_error_signal_local =
+    this->get_local_prev_error_signals();
+  DMatDT& error_signal_local = this->get_local_error_signals();
+
+  // Get parameters
+  const int local_width = prev_error_signal_local.Width();
+  const auto& output_dims = this->get_output_dims();
+  const int num_channels = output_dims[0];
+  const int num_per_output_channel = this->get_input_size() / num_channels;
+  const int pool_size = hint_layer.m_pool_size;
+
+  // Initialize im2col matrix
+  DMatDT im2col_mat(pool_size * num_channels, num_per_output_channel);
+
+  // Iterate through data samples
+  for (int sample = 0; sample < local_width; ++sample) {
+
+    // Construct im2col matrix from input
+    const DMatDT& input_mat =
+      El::LockedView(prev_error_signal_local, El::ALL, El::IR(sample));
+    im2col<TensorDataType>(input_mat,
+                           im2col_mat,
+                           num_channels,
+                           output_dims.size() - 1,
+                           &output_dims[1],
+                           hint_layer.m_pads.data(),
+                           hint_layer.m_pool_dims.data(),
+                           hint_layer.m_strides.data());
+
+    // Propagate error signal based on pooling layer
+    TensorDataType* output_buffer = error_signal_local.Buffer(0, sample);
+    const int* indices_buffer =
+      &hint_layer.m_max_pool_indices[sample * this->get_input_size()];
+    LBANN_OMP_PARALLEL_FOR
+    for (int channel = 0; channel < num_channels; ++channel) {
+      for (int j = 0; j < num_per_output_channel; ++j) {
+        const int output_index = j + channel * num_per_output_channel;
+        const int max_index = indices_buffer[output_index];
+        TensorDataType* im2col_buffer =
+          im2col_mat.Buffer(channel * pool_size, j);
+        output_buffer[output_index] = im2col_buffer[max_index];
+      }
+    }
+  }
 }
 
 #define PROTO(T)                                                               \
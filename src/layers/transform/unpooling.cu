@@ -0,0 +1,302 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_UNPOOLING_LAYER_INSTANTIATE
+#include "lbann/layers/transform/unpooling.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Geometry of the pooling windows
+ *
+ *  Tensors with fewer than 3 spatial dimensions are padded with
+ *  leading unit dimensions.
+ */
+struct pool_geometry
+{
+  El::Int im_dims[3];
+  El::Int pooled_dims[3];
+  El::Int window_dims[3];
+  El::Int pads[3];
+  El::Int strides[3];
+};
+
+/** @brief Location of the maximum in a pooling window
+ *
+ *  Window entries are scanned in the same order as im2col and the
+ *  first maximum wins, as in the CPU pooling layer. Padding entries
+ *  are zero.
+ *
+ *  @returns Spatial index of the maximum in @c im, or -1 if it is a
+ *  padding entry.
+ */
+template <typename TensorDataType>
+__device__ El::Int window_argmax(const TensorDataType* __restrict__ im,
+                                 const pool_geometry& geom,
+                                 El::Int pos0,
+                                 El::Int pos1,
+                                 El::Int pos2)
+{
+  const El::Int start0 = pos0 * geom.strides[0] - geom.pads[0];
+  const El::Int start1 = pos1 * geom.strides[1] - geom.pads[1];
+  const El::Int start2 = pos2 * geom.strides[2] - geom.pads[2];
+  TensorDataType max_entry;
+  El::Int max_index = -1;
+  bool first = true;
+  for (El::Int i0 = start0; i0 < start0 + geom.window_dims[0]; ++i0) {
+    for (El::Int i1 = start1; i1 < start1 + geom.window_dims[1]; ++i1) {
+      for (El::Int i2 = start2; i2 < start2 + geom.window_dims[2]; ++i2) {
+        const bool inside = (0 <= i0 && i0 < geom.im_dims[0] && 0 <= i1 &&
+                             i1 < geom.im_dims[1] && 0 <= i2 &&
+                             i2 < geom.im_dims[2]);
+        const El::Int index =
+          inside ? (i0 * geom.im_dims[1] + i1) * geom.im_dims[2] + i2 : -1;
+        const TensorDataType entry = inside ? im[index] : TensorDataType(0.f);
+        if (first || entry > max_entry) {
+          max_entry = entry;
+          max_index = index;
+          first = false;
+        }
+      }
+    }
+  }
+  return max_index;
+}
+
+/** @brief Scatter each entry to the maximum of its pooling window
+ *
+ *  Each output entry gathers from the windows that contain it and
+ *  keeps the largest contribution, as col2im does on CPU. Windows
+ *  whose maximum is elsewhere contribute zero.
+ */
+template <typename TensorDataType>
+__global__ void fp_kernel(pool_geometry geom,
+                          El::Int num_channels,
+                          El::Int num_samples,
+                          const TensorDataType* __restrict__ pool_input,
+                          El::Int pool_input_ldim,
+                          const TensorDataType* __restrict__ input,
+                          El::Int input_ldim,
+                          TensorDataType* __restrict__ output,
+                          El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int im_size = geom.im_dims[0] * geom.im_dims[1] * geom.im_dims[2];
+  const El::Int pooled_size =
+    geom.pooled_dims[0] * geom.pooled_dims[1] * geom.pooled_dims[2];
+  const El::Int size = im_size * num_channels * num_samples;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % (im_size * num_channels);
+    const El::Int sample = pos / (im_size * num_channels);
+    const El::Int channel = row / im_size;
+    const El::Int index = row % im_size;
+    const El::Int im_pos[3] = {index / (geom.im_dims[1] * geom.im_dims[2]),
+                               (index / geom.im_dims[2]) % geom.im_dims[1],
+                               index % geom.im_dims[2]};
+
+    // Pooling windows containing the entry
+    El::Int first[3], last[3];
+    for (int d = 0; d < 3; ++d) {
+      const El::Int offset = im_pos[d] + geom.pads[d];
+      first[d] = gpu_lib::max(
+        (offset - geom.window_dims[d] + geom.strides[d]) / geom.strides[d],
+        El::Int(0));
+      last[d] = gpu_lib::min(offset / geom.strides[d],
+                             geom.pooled_dims[d] - El::Int(1));
+    }
+
+    const auto* im =
+      &pool_input[sample * pool_input_ldim + channel * im_size];
+    const auto* x = &input[sample * input_ldim + channel * pooled_size];
+    TensorDataType result = 0.f;
+    bool initialized = false;
+    for (El::Int p0 = first[0]; p0 <= last[0]; ++p0) {
+      for (El::Int p1 = first[1]; p1 <= last[1]; ++p1) {
+        for (El::Int p2 = first[2]; p2 <= last[2]; ++p2) {
+          const El::Int pooled_index =
+            (p0 * geom.pooled_dims[1] + p1) * geom.pooled_dims[2] + p2;
+          const bool is_max = window_argmax(im, geom, p0, p1, p2) == index;
+          const TensorDataType contribution =
+            is_max ? x[pooled_index] : TensorDataType(0.f);
+          if (!initialized || contribution > result) {
+            result = contribution;
+            initialized = true;
+          }
+        }
+      }
+    }
+    output[row + sample * output_ldim] = result;
+  }
+}
+
+/** @brief Gather the gradient at the maximum of each pooling window */
+template <typename TensorDataType>
+__global__ void bp_kernel(pool_geometry geom,
+                          El::Int num_channels,
+                          El::Int num_samples,
+                          const TensorDataType* __restrict__ pool_input,
+                          El::Int pool_input_ldim,
+                          const TensorDataType* __restrict__ output_grad,
+                          El::Int output_grad_ldim,
+                          TensorDataType* __restrict__ input_grad,
+                          El::Int input_grad_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int im_size = geom.im_dims[0] * geom.im_dims[1] * geom.im_dims[2];
+  const El::Int pooled_size =
+    geom.pooled_dims[0] * geom.pooled_dims[1] * geom.pooled_dims[2];
+  const El::Int size = pooled_size * num_channels * num_samples;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % (pooled_size * num_channels);
+    const El::Int sample = pos / (pooled_size * num_channels);
+    const El::Int channel = row / pooled_size;
+    const El::Int index = row % pooled_size;
+    const El::Int p0 = index / (geom.pooled_dims[1] * geom.pooled_dims[2]);
+    const El::Int p1 = (index / geom.pooled_dims[2]) % geom.pooled_dims[1];
+    const El::Int p2 = index % geom.pooled_dims[2];
+    const El::Int channel_offset = channel * im_size;
+    const El::Int max_index = window_argmax(
+      &pool_input[sample * pool_input_ldim + channel_offset],
+      geom,
+      p0,
+      p1,
+      p2);
+    input_grad[row + sample * input_grad_ldim] =
+      (max_index >= 0
+         ? output_grad[sample * output_grad_ldim + channel_offset + max_index]
+         : TensorDataType(0.f));
+  }
+}
+
+/** Pad tensor dimensions to 3 spatial dimensions */
+template <typename PoolLayerType>
+pool_geometry get_pool_geometry(const PoolLayerType& pool_layer,
+                                const std::vector<int>& im_dims,
+                                const std::vector<int>& pooled_dims)
+{
+  pool_geometry geom;
+  const int num_dims = im_dims.size() - 1;
+  for (int d = 0; d < 3; ++d) {
+    const int i = d - (3 - num_dims);
+    geom.im_dims[d] = i < 0 ? 1 : im_dims[i + 1];
+    geom.pooled_dims[d] = i < 0 ? 1 : pooled_dims[i + 1];
+    geom.window_dims[d] = i < 0 ? 1 : pool_layer.m_pool_dims[i];
+    geom.pads[d] = i < 0 ? 0 : pool_layer.m_pads[i];
+    geom.strides[d] = i < 0 ? 1 : pool_layer.m_strides[i];
+  }
+  return geom;
+}
+
+El::Int get_grid_size(El::Int size, El::Int block_size)
+{
+  return std::min((size + block_size - 1) / block_size, El::Int(65535));
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::fp_compute()
+{
+  const auto& hint_layer =
+    dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
+  const auto& local_pool_input = hint_layer.get_local_prev_activations();
+  const auto& local_input = this->get_local_prev_activations();
+  auto& local_output = this->get_local_activations();
+  const auto& output_dims = this->get_output_dims();
+  const auto geom =
+    get_pool_geometry(hint_layer, output_dims, this->get_input_dims());
+
+  const El::Int size = local_output.Height() * local_output.Width();
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_output),
+                                     gpu::get_sync_info(local_input),
+                                     gpu::get_sync_info(local_pool_input));
+  hydrogen::gpu::LaunchKernel(fp_kernel<TensorDataType>,
+                              get_grid_size(size, block_size),
+                              block_size,
+                              0,
+                              multisync,
+                              geom,
+                              El::Int(output_dims[0]),
+                              local_output.Width(),
+                              local_pool_input.LockedBuffer(),
+                              local_pool_input.LDim(),
+                              local_input.LockedBuffer(),
+                              local_input.LDim(),
+                              local_output.Buffer(),
+                              local_output.LDim());
+}
+
+template <typename TensorDataType, data_layout T_layout, El::Device Dev>
+void unpooling_layer<TensorDataType, T_layout, Dev>::bp_compute()
+{
+  const auto& hint_layer =
+    dynamic_cast<const PoolLayerType&>(*this->get_hint_layer());
+  const auto& local_pool_input = hint_layer.get_local_prev_activations();
+  const auto& local_output_grad = this->get_local_prev_error_signals();
+  auto& local_input_grad = this->get_local_error_signals();
+  const auto& output_dims = this->get_output_dims();
+  const auto geom =
+    get_pool_geometry(hint_layer, output_dims, this->get_input_dims());
+
+  const El::Int size = local_input_grad.Height() * local_input_grad.Width();
+  if (size == 0) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(local_input_grad),
+                                     gpu::get_sync_info(local_output_grad),
+                                     gpu::get_sync_info(local_pool_input));
+  hydrogen::gpu::LaunchKernel(bp_kernel<TensorDataType>,
+                              get_grid_size(size, block_size),
+                              block_size,
+                              0,
+                              multisync,
+                              geom,
+                              El::Int(output_dims[0]),
+                              local_input_grad.Width(),
+                              local_pool_input.LockedBuffer(),
+                              local_pool_input.LDim(),
+                              local_output_grad.LockedBuffer(),
+                              local_output_grad.LDim(),
+                              local_input_grad.Buffer(),
+                              local_input_grad.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template class unpooling_layer<T, data_layout::DATA_PARALLEL, El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -49,20 +49,40 @@ build_weighted_sum_layer_from_pbuf(lbann_comm* comm,
   return std::make_unique<LayerType>(comm, scaling_factors);
 }
 
-template <typename T, data_layout L, El::Device D>
-void weighted_sum_layer<T, L, D>::write_specific_proto(
-  lbann_data::Layer& proto) const
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void weighted_sum_layer<TensorDataType, Layout, Device>::fp_compute()
 {
-  proto.set_datatype(proto::ProtoDataType<T>);
-  auto* msg = proto.mutable_weighted_sum();
-  protobuf::assign_to_repeated(*msg->mutable_scaling_factors(),
-                               m_scaling_factors);
+  auto& output = this->get_activations();
+  El::Zero(output);
+  for (int i = 0; i < this->get_num_parents(); ++i) {
+    El::Axpy(m_scaling_factors[i], this->get_prev_activations(i), output);
+  }
 }
 
-#define PROTO_DEVICE(T, Device)                                                \
-  template class weighted_sum_layer<T, data_layout::DATA_PARALLEL, Device>;    \
-  template class weighted_sum_layer<T, data_layout::MODEL_PARALLEL, Device>;   \
-  LBANN_LAYER_BUILDER_ETI(weighted_sum, T, Device)
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void weighted_sum_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  const auto& gradient_wrt_output = this->get_prev_error_signals();
+  for (int i = 0; i < this->get_num_parents(); ++i) {
+    auto& gradient_wrt_input = this->get_error_signals(i);
+    El::Zero(gradient_wrt_input);
+    El::Axpy(m_scaling_factors[i], gradient_wrt_output, gradient_wrt_input);
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class weighted_sum_layer<T,                                         \
+                                    data_layout::DATA_PARALLEL,                \
+                                    El::Device::CPU>;                          \
+  template class weighted_sum_layer<T,                                         \
+                                    data_layout::MODEL_PARALLEL,               \
+                                    El::Device::CPU>
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+
+#define PROTO_DEVICE(T, Device) LBANN_LAYER_BUILDER_ETI(weighted_sum, T, Device)
 
 #include "lbann/macros/instantiate_device.hpp"
 
@@ -0,0 +1,179 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_WEIGHTED_SUM_LAYER_INSTANTIATE
+#include "lbann/layers/transform/weighted_sum.hpp"
+
+#include "nary_entrywise.cuh"
+
+namespace lbann {
+
+namespace {
+
+using internal::matrix_list;
+using internal::max_nary_matrices;
+
+/** Scaling factors of a group of matrices */
+template <typename TensorDataType>
+struct scaling_factors
+{
+  TensorDataType values[max_nary_matrices];
+};
+
+/** @brief Add a group of scaled inputs to the output
+ *
+ *  The output is overwritten by the first group of inputs.
+ */
+template <typename TensorDataType>
+__global__ void fp_kernel(El::Int height,
+                          El::Int width,
+                          matrix_list<const TensorDataType> inputs,
+                          scaling_factors<TensorDataType> scales,
+                          bool accumulate,
+                          TensorDataType* __restrict__ output,
+                          El::Int output_ldim)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % height;
+    const El::Int col = pos / height;
+    auto& y = output[row + col * output_ldim];
+    TensorDataType sum = accumulate ? y : TensorDataType(0.f);
+    for (int i = 0; i < inputs.size; ++i) {
+      sum += scales.values[i] * inputs(i, row, col);
+    }
+    y = sum;
+  }
+}
+
+/** @brief Scale the output gradient into a group of input gradients */
+template <typename TensorDataType>
+__global__ void bp_kernel(El::Int height,
+                          El::Int width,
+                          const TensorDataType* __restrict__ output_grad,
+                          El::Int output_grad_ldim,
+                          scaling_factors<TensorDataType> scales,
+                          matrix_list<TensorDataType> input_grads)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int num_threads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  for (El::Int pos = gid; pos < size; pos += num_threads) {
+    const El::Int row = pos % height;
+    const El::Int col = pos / height;
+    const auto& dy = output_grad[row + col * output_grad_ldim];
+    for (int i = 0; i < input_grads.size; ++i) {
+      input_grads(i, row, col) = scales.values[i] * dy;
+    }
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void weighted_sum_layer<TensorDataType, Layout, Device>::fp_compute()
+{
+  const int num_parents = this->get_num_parents();
+  auto& local_output = this->get_local_activations();
+  const El::Int height = local_output.Height();
+  const El::Int width = local_output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  auto sync_info = gpu::get_sync_info(local_output);
+  for (int i = 0; i < num_parents; i += max_nary_matrices) {
+    matrix_list<const TensorDataType> inputs;
+    scaling_factors<TensorDataType> scales;
+    for (int j = i; j < std::min(i + max_nary_matrices, num_parents); ++j) {
+      scales.values[inputs.size] = El::To<TensorDataType>(m_scaling_factors[j]);
+      inputs.push_back(this->get_local_prev_activations(j));
+    }
+    hydrogen::gpu::LaunchKernel(
+      fp_kernel<TensorDataType>,
+      internal::nary_grid_size(height, width, block_size),
+      block_size,
+      0,
+      sync_info,
+      height,
+      width,
+      inputs,
+      scales,
+      i > 0,
+      local_output.Buffer(),
+      local_output.LDim());
+  }
+}
+
+template <typename TensorDataType, data_layout Layout, El::Device Device>
+void weighted_sum_layer<TensorDataType, Layout, Device>::bp_compute()
+{
+  const int num_parents = this->get_num_parents();
+  const auto& local_output_grad = this->get_local_prev_error_signals();
+  const El::Int height = local_output_grad.Height();
+  const El::Int width = local_output_grad.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  constexpr El::Int block_size = 256;
+  auto sync_info = gpu::get_sync_info(local_output_grad);
+  for (int i = 0; i < num_parents; i += max_nary_matrices) {
+    matrix_list<TensorDataType> input_grads;
+    scaling_factors<TensorDataType> scales;
+    for (int j = i; j < std::min(i + max_nary_matrices, num_parents); ++j) {
+      scales.values[input_grads.size] =
+        El::To<TensorDataType>(m_scaling_factors[j]);
+      input_grads.push_back(this->get_local_error_signals(j));
+    }
+    hydrogen::gpu::LaunchKernel(
+      bp_kernel<TensorDataType>,
+      internal::nary_grid_size(height, width, block_size),
+      block_size,
+      0,
+      sync_info,
+      height,
+      width,
+      local_output_grad.LockedBuffer(),
+      local_output_grad.LDim(),
+      scales,
+      input_grads);
+  }
+}
+
+#define PROTO(T)                                                               \
+  template class weighted_sum_layer<T,                                         \
+                                    data_layout::DATA_PARALLEL,                \
+                                    El::Device::GPU>;                          \
+  template class weighted_sum_layer<T,                                         \
+                                    data_layout::MODEL_PARALLEL,               \
+                                    El::Device::GPU>
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
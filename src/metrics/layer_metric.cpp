@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/metrics/layer_metric.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/io/persist_impl.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
@@ -101,15 +102,47 @@ void layer_metric::setup(model& m)
 EvalType layer_metric::evaluate(execution_mode mode, int mini_batch_size)
 {
   const auto& start = get_time();
-  auto value =
-    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer())
-      .get_value(false);
+  if (m_pending_num_samples > 0 && mode != m_pending_mode) {
+    flush_pending_statistics();
+  }
+  dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer())
+    .accumulate_local_sum();
+  m_pending_mode = mode;
+  m_pending_num_samples += mini_batch_size;
   get_evaluate_time() += get_time() - start;
-  if (m_unit == "%") {
-    value *= 100;
+  return EvalType(0);
+}
+
+void layer_metric::pack_pending_statistics(std::vector<EvalType>& buffer)
+{
+  // Clear the accumulated sum even if there are no pending samples
+  const auto sum =
+    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer())
+      .take_accumulated_local_sum();
+  buffer.push_back(m_pending_num_samples > 0 ? sum : EvalType(0));
+}
+
+size_t layer_metric::unpack_pending_statistics(const EvalType* buffer)
+{
+  if (m_pending_num_samples > 0) {
+    auto sum = buffer[0];
+    if (m_unit == "%") {
+      sum *= 100;
+    }
+    get_statistics()[m_pending_mode].add_value(sum, m_pending_num_samples);
   }
-  get_statistics()[mode].add_value(value * mini_batch_size, mini_batch_size);
-  return value;
+  m_pending_num_samples = 0;
+  return 1;
+}
+
+void layer_metric::flush_pending_statistics()
+{
+  std::vector<EvalType> buffer;
+  pack_pending_statistics(buffer);
+  get_comm().allreduce(buffer.data(),
+                       static_cast<int>(buffer.size()),
+                       get_comm().get_trainer_comm());
+  unpack_pending_statistics(buffer.data());
 }
 
 EvalType layer_metric::evaluate_compute(const AbsDistMat& prediction,
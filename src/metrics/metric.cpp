@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/metrics/metric.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/models/model.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
@@ -60,6 +61,15 @@ void metric_statistics::reset()
   m_num_samples = 0;
 }
 
+void metric_statistics::allreduce(const lbann_comm& comm,
+                                  const El::mpi::Comm& c)
+{
+  EvalType values[2] = {m_sum, static_cast<EvalType>(m_num_samples)};
+  comm.allreduce(values, 2, c);
+  m_sum = values[0];
+  m_num_samples = static_cast<int>(values[1]);
+}
+
 metric::metric(lbann_comm* comm) : m_comm(comm) {}
 
 template <class Archive>
@@ -90,6 +100,11 @@ int metric::get_statistics_num_samples(execution_mode mode) const
   }
 }
 
+void metric::reduce_statistics_across_trainers(execution_mode mode)
+{
+  m_statistics[mode].allreduce(*m_comm, m_comm->get_intertrainer_comm());
+}
+
 std::vector<ViewingLayerPtr> metric::get_layer_pointers() const { return {}; }
 
 void metric::set_layer_pointers(std::vector<ViewingLayerPtr> layers)
@@ -42,25 +42,37 @@
 #include "lbann/metrics/layer_metric.hpp"
 #include "lbann/objective_functions/layer_term.hpp"
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/optimizers/optimizer.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/description.hpp"
 #include "lbann/utils/distconv.hpp"
 #include "lbann/utils/graph.hpp"
 #include "lbann/utils/omp_diagnostics.hpp"
 #include "lbann/utils/onnx_utils.hpp"
+#include "lbann/utils/options.hpp"
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/serialization/dist_matrix_index.hpp"
 #include "lbann/utils/summary_impl.hpp"
+#include "lbann/weights/flat_weights_state.hpp"
+#include "lbann/weights/weights_snapshot.hpp"
 
 #include "lbann/proto/model.pb.h"
 #include "lbann/proto/optimizers.pb.h"
 
 #include <algorithm>
+#include <cmath>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <map>
 #include <memory>
 #include <sstream>
 #include <string>
+#include <typeindex>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace lbann {
 
@@ -89,7 +101,8 @@ model::model(const model& other)
   : m_execution_context(other.m_execution_context),
     m_comm(other.m_comm),
     m_name(other.m_name),
-    m_model_is_setup(false)
+    m_model_is_setup(false),
+    m_inference_only(other.m_inference_only)
 {
 
   // Deep copies
@@ -153,6 +166,15 @@ model& model::operator=(const model& other)
   m_comm = other.m_comm;
   m_name = other.m_name;
   m_model_is_setup = false;
+  m_inference_only = other.m_inference_only;
+  m_plan_activation_memory = false;
+#ifdef LBANN_HAS_GPU
+  m_branch_streams.clear();
+#endif // LBANN_HAS_GPU
+  m_gradient_buckets.reset();
+  m_evaluation_reducer.reset();
+  m_flat_weights_state.reset();
+  m_frozen_values_files.clear();
 
   // Deep copies
   m_execution_context = other.m_execution_context;
@@ -172,6 +194,7 @@ model& model::operator=(const model& other)
   // Copy layers
   std::unordered_map<Layer*, ViewingLayerPtr> layer_map;
   m_layers.clear();
+  m_layer_indices.clear();
   m_layers.reserve(other.m_layers.size());
   for (const auto& other_layer : other.m_layers) {
     if (other_layer == nullptr) {
@@ -188,6 +211,7 @@ model& model::operator=(const model& other)
   // Copy weights
   std::unordered_map<weights*, ViewingWeightsPtr> weights_map;
   m_weights.clear();
+  m_weights_indices.clear();
   m_weights.reserve(other.m_weights.size());
   for (const auto& other_weights : other.m_weights) {
     if (other_weights == nullptr) {
@@ -423,7 +447,9 @@ std::vector<ViewingWeightsPtr> model::get_weights_pointers() const
 }
 
 #ifdef LBANN_HAS_ONNX
-void model::serialize_to_onnx(onnx::ModelProto& mp)
+void model::serialize_to_onnx(onnx::ModelProto& mp,
+                              std::string const& data_dir,
+                              std::string const& data_location)
 {
   mp.set_ir_version(7);
   auto* opset = mp.add_opset_import();
@@ -444,8 +470,25 @@ void model::serialize_to_onnx(onnx::ModelProto& mp)
   auto* gp = mp.mutable_graph();
   gp->set_name(this->get_name());
 
-  for (auto const* weights : this->get_weights()) {
-    weights->fill_onnx_node(*gp);
+  if (data_dir.empty()) {
+    for (auto const* weights : this->get_weights()) {
+      weights->fill_onnx_node(*gp);
+    }
+  }
+  else {
+    // Make sure the directory exists before the weights are written
+    if (m_comm->am_trainer_master()) {
+      file::make_directory(data_dir);
+    }
+    m_comm->trainer_barrier();
+    int writer = 0;
+    for (auto const* weights : this->get_weights()) {
+      const auto filename = weights->get_name() + ".bin";
+      weights->fill_onnx_node(*gp,
+                              writer++,
+                              file::join_path(data_dir, filename),
+                              file::join_path(data_location, filename));
+    }
   }
 
   auto const layers = this->get_layers();
@@ -473,26 +516,21 @@ void model::add_layer(OwningLayerPtr&& ptr)
   }
 
   // Check that the new layer name is unique
-  // Note: Adding layers is O(n^2), but this is unlikely to be a
-  // bottleneck. If it is, consider maintaining a hash table
-  // containing all layer names (and properly updating it during
-  // copies and pointer remaps).
   const auto& name = ptr->get_name();
-  for (const auto& l : m_layers) {
-    if (l->get_name() == name) {
-      LBANN_ERROR("attempted to add layer \"",
-                  name,
-                  "\" to ",
-                  "model \"",
-                  get_name(),
-                  "\", ",
-                  "but the model already contains a layer with that name");
-    }
+  if (find_layer_index(name) >= 0) {
+    LBANN_ERROR("attempted to add layer \"",
+                name,
+                "\" to ",
+                "model \"",
+                get_name(),
+                "\", ",
+                "but the model already contains a layer with that name");
   }
 
   // Add layer to model
   m_layers.emplace_back(std::move(ptr));
   m_layers.back()->set_model(this);
+  m_layer_indices.emplace(m_layers.back()->get_name(), get_num_layers() - 1);
 }
 
 void model::add_weights(OwningWeightsPtr&& ptr)
@@ -507,43 +545,59 @@ void model::add_weights(OwningWeightsPtr&& ptr)
   }
 
   // Check that the new weights name is unique
-  // Note: Adding weights is O(n^2), but this is unlikely to be a
-  // bottleneck. If it is, consider maintaining a hash table
-  // containing all weights names (and properly updating it during
-  // copies and pointer remaps).
   const auto& name = ptr->get_name();
-  for (const auto& w : m_weights) {
-    if (w->get_name() == name) {
-      LBANN_ERROR("attempted to add weights \"",
-                  name,
-                  "\" to ",
-                  "model \"",
-                  get_name(),
-                  "\", ",
-                  "but the model already contains weights with that name");
-    }
+  if (find_weights_index(name) >= 0) {
+    LBANN_ERROR("attempted to add weights \"",
+                name,
+                "\" to ",
+                "model \"",
+                get_name(),
+                "\", ",
+                "but the model already contains weights with that name");
   }
 
   // Add weights to model
   m_weights.emplace_back(std::move(ptr));
+  m_weights_indices.emplace(m_weights.back()->get_name(),
+                            m_weights.size() - 1);
 }
 
 void model::remove_weights(std::string const& removable_weight_name)
 {
-  auto const removable_weight_iterator =
-    std::find_if(cbegin(m_weights),
-                 cend(m_weights),
-                 [&removable_weight_name](auto const& w) {
-                   return w->get_name() == removable_weight_name;
-                 });
-  if (removable_weight_iterator != cend(m_weights))
-    m_weights.erase(removable_weight_iterator);
-  else
+  const auto index = find_weights_index(removable_weight_name);
+  if (index < 0) {
     LBANN_ERROR("Attempted to remove weight",
                 " \"",
                 removable_weight_name,
                 "\", ",
                 "but no such weight exists");
+  }
+  m_weights.erase(m_weights.cbegin() + index);
+  m_weights_indices.clear();
+}
+
+El::Int model::find_layer_index(std::string const& name) const
+{
+  if (m_layer_indices.empty()) {
+    m_layer_indices.reserve(m_layers.size());
+    for (size_t i = 0; i < m_layers.size(); ++i) {
+      m_layer_indices.emplace(m_layers[i]->get_name(), i);
+    }
+  }
+  const auto it = m_layer_indices.find(name);
+  return it != m_layer_indices.end() ? it->second : -1;
+}
+
+El::Int model::find_weights_index(std::string const& name) const
+{
+  if (m_weights_indices.empty()) {
+    m_weights_indices.reserve(m_weights.size());
+    for (size_t i = 0; i < m_weights.size(); ++i) {
+      m_weights_indices.emplace(m_weights[i]->get_name(), i);
+    }
+  }
+  const auto it = m_weights_indices.find(name);
+  return it != m_weights_indices.end() ? it->second : -1;
 }
 
 void model::add_callback(std::shared_ptr<callback_base> cb)
@@ -594,11 +648,16 @@ void model::copy_trained_weights_from(std::vector<weights*>& new_weights)
   }
 }
 
-void model::swap_layers(model& other) { std::swap(m_layers, other.m_layers); }
+void model::swap_layers(model& other)
+{
+  std::swap(m_layers, other.m_layers);
+  std::swap(m_layer_indices, other.m_layer_indices);
+}
 
 void model::swap_weights(model& other)
 {
   std::swap(m_weights, other.m_weights);
+  std::swap(m_weights_indices, other.m_weights_indices);
 }
 
 void model::swap_metrics(model& other)
@@ -631,6 +690,7 @@ void model::reorder_layers(const std::vector<El::Int>& gather_indices)
     reordered_layers[i] = std::move(m_layers[gather_indices[i]]);
   }
   m_layers = std::move(reordered_layers);
+  m_layer_indices.clear();
 
   // Check that layer list has no null pointers
   for (const auto& l : m_layers) {
@@ -726,15 +786,32 @@ void model::setup(size_t max_mini_batch_size,
   // Setup layers
 
   setup_layer_topology();
+  if (m_inference_only) {
+    setup_inference_graph();
+  }
+  if (global_argument_parser().get<bool>(LBANN_OPTION_FUSE_RELU)) {
+    fuse_relu_layers();
+  }
+  if (global_argument_parser().get<bool>(LBANN_OPTION_FOLD_PERMUTES)) {
+    fold_permute_layers();
+  }
   setup_layer_execution_order();
   if (this->is_subgraph_parallelism_enabled()) {
     setup_subgrids();
   }
 
+  setup_pipeline_stages(grids_);
+  setup_evaluation_reducer();
   setup_layers(max_mini_batch_size, dr_metadata, grids_);
+  setup_activation_recomputation();
+  setup_activation_memory_plan();
+  setup_branch_streams();
+  setup_activation_offload();
 
   // Setup weights
   setup_weights();
+  setup_gradient_buckets();
+  setup_flat_weights_state();
 
   // Setup objective function
   m_objective_function->setup(*this);
@@ -828,6 +905,229 @@ void model::setup_layer_topology()
   add_split_layers(layer_names);
 }
 
+std::unordered_set<const Layer*> model::get_referenced_layers() const
+{
+  std::unordered_set<const Layer*> referenced_layers;
+  if (m_objective_function != nullptr) {
+    for (const auto& ptr : m_objective_function->get_layer_pointers()) {
+      referenced_layers.insert(ptr.lock().get());
+    }
+  }
+  for (const auto& m : m_metrics) {
+    for (const auto& ptr : m->get_layer_pointers()) {
+      referenced_layers.insert(ptr.lock().get());
+    }
+  }
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    referenced_layers.insert(get_layer(i).get_hint_layer());
+  }
+  return referenced_layers;
+}
+
+void model::fuse_relu_layers()
+{
+
+  // Layers that are referred to by something other than their
+  // parents and children
+  const auto referenced_layers = get_referenced_layers();
+
+  // Find ReLU layers that can be folded into their parents
+  std::vector<El::Int> fused_layers;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    const auto& l = get_layer(i);
+    if (l.get_type() != "ReLU" || l.get_num_parents() != 1 ||
+        l.get_num_children() != 1 || l.num_weights() != 0 ||
+        referenced_layers.count(&l) > 0) {
+      continue;
+    }
+    auto& parent = const_cast<Layer&>(l.get_parent_layer(0));
+    if (!parent.supports_fused_relu() || parent.has_fused_relu() ||
+        parent.get_num_children() != 1 ||
+        parent.get_datatype_name() != l.get_datatype_name() ||
+        parent.get_data_layout() != l.get_data_layout() ||
+        parent.get_device_allocation() != l.get_device_allocation()) {
+      continue;
+    }
+    parent.set_fused_relu(true);
+    fused_layers.push_back(i);
+  }
+
+  // Remove the folded layers with a single pass over the layer list
+  std::vector<bool> is_fused(get_num_layers(), false);
+  for (const auto& i : fused_layers) {
+    unlink_layer(i);
+    is_fused[i] = true;
+  }
+  std::vector<El::Int> kept_layers;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    if (!is_fused[i]) {
+      kept_layers.push_back(i);
+    }
+  }
+  if (!fused_layers.empty()) {
+    reorder_layers(kept_layers);
+  }
+  if (!fused_layers.empty() && m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" fused "
+              << fused_layers.size() << " ReLU layers into "
+              << "the layers that produce their inputs" << std::endl;
+  }
+}
+
+void model::fold_permute_layers()
+{
+  const auto referenced_layers = get_referenced_layers();
+  auto is_removable = [&referenced_layers](const Layer& l) {
+    return (l.get_num_parents() == 1 && l.get_num_children() == 1 &&
+            l.num_weights() == 0 && referenced_layers.count(&l) == 0);
+  };
+
+  std::vector<bool> is_removed(get_num_layers(), false);
+  size_t num_cancelled = 0;
+  size_t num_folded = 0;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    const auto& l = get_layer(i);
+    const auto perm = l.get_axis_permutation();
+    if (is_removed[i] || perm.empty() || !is_removable(l)) {
+      continue;
+    }
+    auto& child = const_cast<Layer&>(l.get_child_layer(0));
+    const auto child_index = find_layer_index(child.get_name());
+
+    // Remove a permute layer followed by its inverse
+    const auto child_perm = child.get_axis_permutation();
+    if (child_perm.size() == perm.size() && is_removable(child) &&
+        !is_removed[child_index]) {
+      bool is_inverse = true;
+      for (size_t j = 0; j < perm.size(); ++j) {
+        is_inverse = is_inverse && (perm[child_perm[j]] == static_cast<int>(j));
+      }
+      if (is_inverse) {
+        unlink_layer(i);
+        unlink_layer(child_index);
+        is_removed[i] = true;
+        is_removed[child_index] = true;
+        num_cancelled += 2;
+        continue;
+      }
+    }
+
+    // Fold a swap of the last two axes into the child
+    const size_t n = perm.size();
+    bool is_transpose = (n >= 2 && perm[n - 2] == static_cast<int>(n - 1) &&
+                         perm[n - 1] == static_cast<int>(n - 2));
+    for (size_t j = 0; j + 2 < n; ++j) {
+      is_transpose = is_transpose && (perm[j] == static_cast<int>(j));
+    }
+    if (is_transpose &&
+        child.fold_input_transpose(child.find_parent_layer_index(l))) {
+      unlink_layer(i);
+      is_removed[i] = true;
+      ++num_folded;
+    }
+  }
+
+  // Remove the folded layers with a single pass over the layer list
+  std::vector<El::Int> kept_layers;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    if (!is_removed[i]) {
+      kept_layers.push_back(i);
+    }
+  }
+  if (num_cancelled + num_folded > 0) {
+    reorder_layers(kept_layers);
+  }
+  if (num_cancelled + num_folded > 0 && m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" removed " << num_cancelled
+              << " permute layers that cancel out and folded " << num_folded
+              << " into the layers that consume their outputs" << std::endl;
+  }
+}
+
+void model::setup_inference_graph()
+{
+
+  // Strip training state
+  for (auto* w : get_weights()) {
+    w->set_optimizer(nullptr);
+    w->freeze();
+  }
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    get_layer(i).freeze();
+  }
+
+  // Layers that are referred to by something other than their
+  // parents and children
+  std::unordered_set<const Layer*> referenced_layers;
+  if (m_objective_function != nullptr) {
+    for (const auto& ptr : m_objective_function->get_layer_pointers()) {
+      referenced_layers.insert(ptr.lock().get());
+    }
+  }
+  for (const auto& m : m_metrics) {
+    for (const auto& ptr : m->get_layer_pointers()) {
+      referenced_layers.insert(ptr.lock().get());
+    }
+  }
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    referenced_layers.insert(get_layer(i).get_hint_layer());
+  }
+
+  // Find dropout and batch normalization layers that can be removed
+  std::vector<El::Int> removed_layers;
+  size_t num_dropout = 0, num_folded = 0;
+  std::vector<double> scale, shift;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    const auto& l = get_layer(i);
+    const auto type = l.get_type();
+    if ((type != "dropout" && type != "batch normalization") ||
+        l.get_num_parents() != 1 || l.get_num_children() != 1 ||
+        l.has_fused_relu() || referenced_layers.count(&l) > 0) {
+      continue;
+    }
+    if (type == "dropout") {
+      if (l.num_weights() == 0) {
+        removed_layers.push_back(i);
+        ++num_dropout;
+      }
+      continue;
+    }
+    auto& parent = const_cast<Layer&>(l.get_parent_layer(0));
+    if (parent.get_num_children() != 1 ||
+        referenced_layers.count(&parent) > 0 ||
+        parent.get_datatype_name() != l.get_datatype_name() ||
+        parent.get_data_layout() != l.get_data_layout() ||
+        parent.get_device_allocation() != l.get_device_allocation() ||
+        !l.get_inference_affine(scale, shift) ||
+        !parent.fold_inference_affine(scale, shift)) {
+      continue;
+    }
+    removed_layers.push_back(i);
+    ++num_folded;
+  }
+
+  // Remove the layers with a single pass over the layer list
+  std::vector<bool> is_removed(get_num_layers(), false);
+  for (const auto& i : removed_layers) {
+    unlink_layer(i);
+    is_removed[i] = true;
+  }
+  std::vector<El::Int> kept_layers;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    if (!is_removed[i]) {
+      kept_layers.push_back(i);
+    }
+  }
+  if (!removed_layers.empty()) {
+    reorder_layers(kept_layers);
+  }
+  if (m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" compiled for inference: "
+              << "removed " << num_dropout << " dropout layers and folded "
+              << num_folded << " batch normalization layers" << std::endl;
+  }
+}
+
 void model::get_parent_subgrid_tags(int layer_index)
 {
   // Finds sub-graph tags of parents
@@ -1663,6 +1963,52 @@ void model::ensure_input_layers_first()
   reorder_layers(gather_indices);
 }
 
+void model::setup_pipeline_stages(const std::vector<El::Grid*>& grids)
+{
+  const int num_stages = static_cast<int>(grids.size()) - 1;
+  if (!global_argument_parser().get<bool>(LBANN_OPTION_PIPELINE_STAGES) ||
+      num_stages < 1 || this->is_subgraph_parallelism_enabled()) {
+    return;
+  }
+
+  // Layers placed by the user or that read data stay where they are
+  std::vector<Layer*> stage_layers;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    auto& l = get_layer(i);
+    if (l.get_grid_tag() < 0 && l.get_type() != "input") {
+      stage_layers.push_back(&l);
+    }
+  }
+  if (stage_layers.empty()) {
+    return;
+  }
+
+  // Contiguous runs of the execution order, one per sub-grid
+  const size_t num_layers = stage_layers.size();
+  std::vector<size_t> stage_begin(num_stages + 1, num_layers);
+  for (size_t i = num_layers; i-- > 0;) {
+    const int stage = static_cast<int>(i * num_stages / num_layers);
+    stage_layers[i]->set_grid_tag(stage + 1);
+    stage_begin[stage] = i;
+  }
+  for (int s = num_stages; s-- > 0;) {
+    stage_begin[s] = std::min(stage_begin[s], stage_begin[s + 1]);
+  }
+
+  if (m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" pipeline stages:";
+    for (int s = 0; s < num_stages; ++s) {
+      if (stage_begin[s] < stage_begin[s + 1]) {
+        std::cout << " [grid " << s + 1 << ": \""
+                  << stage_layers[stage_begin[s]]->get_name() << "\" to \""
+                  << stage_layers[stage_begin[s + 1] - 1]->get_name()
+                  << "\"]";
+      }
+    }
+    std::cout << std::endl;
+  }
+}
+
 void model::setup_layers(size_t max_mini_batch_size,
                          DataReaderMetaData& dr_metadata,
                          const std::vector<El::Grid*>& grids_)
@@ -1676,6 +2022,474 @@ void model::setup_layers(size_t max_mini_batch_size,
   }
 }
 
+void model::setup_activation_recomputation()
+{
+  m_recompute_segments.clear();
+  m_recompute_segment_of_layer.assign(get_num_layers(), -1);
+  m_discard_activations.assign(get_num_layers(), false);
+  if (this->is_subgraph_parallelism_enabled()) {
+    return;
+  }
+
+  // Segments are runs of consecutive layers that are marked for
+  // recomputation. Layers without parents are never recomputed since
+  // forward prop would fetch new data.
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    const auto& l = get_layer(i);
+    if (!l.get_recompute_activations() || l.get_num_parents() == 0) {
+      continue;
+    }
+    if (i == 0 || m_recompute_segment_of_layer[i - 1] < 0) {
+      m_recompute_segments.emplace_back(i, i);
+    }
+    m_recompute_segments.back().second = i + 1;
+    m_recompute_segment_of_layer[i] = m_recompute_segments.size() - 1;
+  }
+
+  // Outputs can be discarded if they are only needed within the
+  // segment, which is forward propagated again before its backprop
+  std::unordered_map<const Layer*, El::Int> segment_of_layer;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    segment_of_layer[&get_layer(i)] = m_recompute_segment_of_layer[i];
+  }
+  size_t num_discarded = 0;
+  for (El::Int i = 0; i < get_num_layers(); ++i) {
+    const auto& l = get_layer(i);
+    const auto segment = m_recompute_segment_of_layer[i];
+    if (segment < 0 || l.get_num_children() == 0) {
+      continue;
+    }
+    bool discard = true;
+    for (const auto* child : l.get_child_layers()) {
+      discard = discard && segment_of_layer.at(child) == segment;
+    }
+    m_discard_activations[i] = discard;
+    num_discarded += discard ? 1 : 0;
+  }
+  if (!m_recompute_segments.empty() && m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" recomputes the outputs of "
+              << num_discarded << " layers in " << m_recompute_segments.size()
+              << " segments during backprop" << std::endl;
+  }
+}
+
+void model::discard_activations(El::Int segment)
+{
+  const auto& [begin, end] = m_recompute_segments[segment];
+  for (El::Int i = begin; i < end; ++i) {
+    if (m_discard_activations[i]) {
+      get_layer(i).free_activations();
+    }
+  }
+}
+
+void model::recompute_activations(El::Int segment)
+{
+  const auto& [begin, end] = m_recompute_segments[segment];
+  for (El::Int i = begin; i < end; ++i) {
+    wait_for_branch_streams(i, false);
+    get_layer(i).forward_prop();
+  }
+}
+
+namespace {
+
+/** @brief Tensor in an activation memory plan
+ *  @details Alive from time @c begin to time @c end, inclusive.
+ */
+struct planned_tensor
+{
+  El::Int begin;
+  El::Int end;
+  size_t size;
+  size_t offset;
+};
+
+/** @brief Assign arena offsets to tensors
+ *
+ *  Tensors whose lifetimes overlap get disjoint ranges, so the arena
+ *  size is the memory needed with buffer reuse. Tensors are placed
+ *  by decreasing size at the lowest offset that does not collide
+ *  with an already placed tensor of overlapping lifetime, a greedy
+ *  coloring of the interval graph.
+ *
+ *  @returns Arena size
+ */
+size_t plan_arena(std::vector<planned_tensor>& tensors)
+{
+  std::vector<planned_tensor*> order;
+  for (auto& t : tensors) {
+    order.push_back(&t);
+  }
+  std::stable_sort(order.begin(),
+                   order.end(),
+                   [](const planned_tensor* a, const planned_tensor* b) {
+                     return a->size > b->size;
+                   });
+  size_t arena_size = 0;
+  std::vector<const planned_tensor*> placed, live;
+  for (auto* t : order) {
+    live.clear();
+    for (const auto* p : placed) {
+      if (p->begin <= t->end && t->begin <= p->end) {
+        live.push_back(p);
+      }
+    }
+    std::sort(live.begin(),
+              live.end(),
+              [](const planned_tensor* a, const planned_tensor* b) {
+                return a->offset < b->offset;
+              });
+    size_t offset = 0;
+    for (const auto* p : live) {
+      if (offset + t->size <= p->offset) {
+        break;
+      }
+      offset = std::max(offset, p->offset + p->size);
+    }
+    t->offset = offset;
+    arena_size = std::max(arena_size, offset + t->size);
+    placed.push_back(t);
+  }
+  return arena_size;
+}
+
+} // namespace
+
+void model::setup_activation_memory_plan()
+{
+  const El::Int num_layers = get_num_layers();
+  const auto& arg_parser = global_argument_parser();
+  m_plan_activation_memory =
+    ((m_inference_only ||
+      arg_parser.get<bool>(LBANN_OPTION_PLAN_ACTIVATION_MEMORY)) &&
+     !this->is_subgraph_parallelism_enabled());
+  m_release_after_fp.assign(num_layers, {});
+  m_release_neighbors.assign(num_layers, {});
+  m_activations_released.assign(num_layers, false);
+  m_deferred_releases.assign(num_layers, {});
+  if (!m_plan_activation_memory) {
+    return;
+  }
+
+  std::unordered_map<const Layer*, El::Int> layer_index;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    layer_index[&get_layer(i)] = i;
+  }
+
+  // Forward prop of layer i happens at time i and its backprop at
+  // time 2*num_layers-1-i. Each layer's outputs form one tensor and
+  // the error signals it receives form another, which is produced by
+  // the first child to backprop and consumed by the layer's backprop.
+  // Layers without parents are never released since their outputs
+  // are filled from outside the model.
+  std::map<El::Device, std::vector<planned_tensor>> eval_tensors;
+  std::map<El::Device, std::vector<planned_tensor>> train_tensors;
+  const El::Int bp_time = 2 * num_layers - 1;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    for (const auto* parent : l.get_parent_layers()) {
+      m_release_neighbors[i].push_back(layer_index.at(parent));
+    }
+    for (const auto* child : l.get_child_layers()) {
+      m_release_neighbors[i].push_back(layer_index.at(child));
+    }
+    if (l.get_num_children() == 0) {
+      continue;
+    }
+    El::Int last_child = i;
+    for (const auto* child : l.get_child_layers()) {
+      last_child = std::max(last_child, layer_index.at(child));
+    }
+    const size_t size = l.get_activations_memory();
+    const auto device = l.get_device_allocation();
+    if (l.get_num_parents() > 0) {
+      m_release_after_fp[last_child].push_back(i);
+      eval_tensors[device].push_back({i, last_child, size, 0});
+      train_tensors[device].push_back({i, bp_time - i, size, 0});
+    }
+    else {
+      eval_tensors[device].push_back({i, bp_time, size, 0});
+      train_tensors[device].push_back({i, bp_time, size, 0});
+    }
+    train_tensors[device].push_back(
+      {bp_time - last_child, bp_time - i, size, 0});
+  }
+
+  // Report planned peak memory of each device
+  if (m_comm->am_trainer_master()) {
+    auto report = [this](const char* mode,
+                         std::map<El::Device, std::vector<planned_tensor>>&
+                           tensors_per_device) {
+      for (auto& [device, tensors] : tensors_per_device) {
+        size_t total = 0;
+        for (const auto& t : tensors) {
+          total += t.size;
+        }
+        const double mib = 1024. * 1024.;
+        std::cout << "model \"" << get_name() << "\" " << mode << " "
+                  << (device == El::Device::CPU ? "CPU" : "GPU")
+                  << " activation memory: planned peak "
+                  << plan_arena(tensors) / mib << " MiB, "
+                  << total / mib << " MiB without reuse" << std::endl;
+      }
+    };
+    report("training", train_tensors);
+    report("evaluation", eval_tensors);
+  }
+}
+
+void model::release_activations(El::Int layer)
+{
+  if (m_activations_released[layer]) {
+    return;
+  }
+  for (const auto& neighbor : m_release_neighbors[layer]) {
+    if (!m_activations_released[neighbor] &&
+        get_layer(neighbor).has_activation_views()) {
+      m_deferred_releases[neighbor].push_back(layer);
+      return;
+    }
+  }
+  get_layer(layer).free_activations();
+  m_activations_released[layer] = true;
+  auto deferred = std::move(m_deferred_releases[layer]);
+  m_deferred_releases[layer].clear();
+  for (const auto& i : deferred) {
+    release_activations(i);
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+namespace {
+
+/** @brief Streams for concurrent layer branches
+ *  @details Shared by all models and kept for the life of the
+ *  process. The first stream is the default one.
+ */
+std::vector<El::SyncInfo<El::Device::GPU>> const&
+get_branch_streams(size_t num_streams)
+{
+  static std::vector<El::SyncInfo<El::Device::GPU>> streams;
+  if (streams.empty()) {
+    streams.push_back(El::gpu::DefaultSyncInfo());
+  }
+  while (streams.size() < num_streams) {
+    streams.push_back(El::CreateNewSyncInfo<El::Device::GPU>());
+  }
+  return streams;
+}
+
+/** @brief Stream for copies of offloaded activations
+ *  @details Shared by all models and kept for the life of the
+ *  process.
+ */
+El::SyncInfo<El::Device::GPU> const& get_offload_stream()
+{
+  static const auto stream = El::CreateNewSyncInfo<El::Device::GPU>();
+  return stream;
+}
+
+} // namespace
+#endif // LBANN_HAS_GPU
+
+void model::setup_activation_offload()
+{
+  const El::Int num_layers = get_num_layers();
+  m_offload_activations.assign(num_layers, false);
+  m_offload_children.assign(num_layers, {});
+  m_offload_free_after_fp.assign(num_layers, {});
+  m_offload_restore_before_bp.assign(num_layers, {});
+  m_offload_wait_before_bp.assign(num_layers, {});
+  m_activations_offloaded.assign(num_layers, false);
+#ifdef LBANN_HAS_GPU
+  if (this->is_subgraph_parallelism_enabled()) {
+    return;
+  }
+  std::unordered_map<const Layer*, El::Int> layer_index;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    layer_index[&get_layer(i)] = i;
+  }
+
+  // The outputs are needed until the last child's forward prop, and
+  // again from its backprop. Freeing them while a child's outputs
+  // view them (e.g. split or identity) would free nothing.
+  size_t num_offloaded = 0;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    if (!l.get_offload_activations() || l.get_num_children() == 0 ||
+        l.get_device_allocation() != El::Device::GPU ||
+        m_recompute_segment_of_layer[i] >= 0) {
+      continue;
+    }
+    std::vector<El::Int> children;
+    bool viewed = false;
+    for (const auto* child : l.get_child_layers()) {
+      children.push_back(layer_index.at(child));
+      viewed = viewed || child->has_activation_views();
+    }
+    if (viewed) {
+      continue;
+    }
+    const auto last_child = *std::max_element(children.begin(),
+                                              children.end());
+    m_offload_activations[i] = true;
+    m_offload_children[i] = std::move(children);
+    m_offload_free_after_fp[last_child].push_back(i);
+    m_offload_restore_before_bp[std::min(last_child + 1, num_layers - 1)]
+      .push_back(i);
+    m_offload_wait_before_bp[last_child].push_back(i);
+    ++num_offloaded;
+  }
+  if (num_offloaded > 0 && m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\" offloads the outputs of "
+              << num_offloaded << " layers to host memory in training"
+              << std::endl;
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::free_offloaded_activations(El::Int layer)
+{
+#ifdef LBANN_HAS_GPU
+  // Children on other branch streams may still be reading the outputs
+  wait_for_branch_streams(layer, true);
+  get_layer(layer).free_offloaded_activations(get_offload_stream());
+#endif // LBANN_HAS_GPU
+}
+
+void model::wait_for_restored_activations(El::Int layer)
+{
+#ifdef LBANN_HAS_GPU
+  const auto& copy = get_offload_stream();
+  get_layer(layer).wait_for_restored_activations(copy);
+  for (const auto& child : m_offload_children[layer]) {
+    if (!m_branch_streams.empty()) {
+      El::AddSynchronizationPoint(
+        copy,
+        m_branch_streams[m_stream_of_layer[child]]);
+    }
+    get_layer(child).refresh_inputs();
+  }
+  m_activations_offloaded[layer] = false;
+#endif // LBANN_HAS_GPU
+}
+
+void model::setup_branch_streams()
+{
+#ifdef LBANN_HAS_GPU
+  const El::Int num_layers = get_num_layers();
+  const int num_streams =
+    global_argument_parser().get<int>(LBANN_OPTION_NUM_BRANCH_STREAMS);
+  m_branch_streams.clear();
+  m_stream_of_layer.assign(num_layers, 0);
+  m_fp_stream_waits.assign(num_layers, {});
+  m_bp_stream_waits.assign(num_layers, {});
+  if (num_streams < 2 || m_inference_only ||
+      this->is_subgraph_parallelism_enabled()) {
+    return;
+  }
+#ifdef LBANN_HAS_DISTCONV
+  for (El::Int i = 0; i < num_layers; ++i) {
+    if (get_layer(i).distconv_enabled()) {
+      return;
+    }
+  }
+#endif // LBANN_HAS_DISTCONV
+
+  std::unordered_map<const Layer*, El::Int> layer_index;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    layer_index[&get_layer(i)] = i;
+  }
+
+  // A layer continues the stream of its first parent unless an
+  // earlier child already does. Then it begins a branch on the next
+  // non-default stream. CPU layers and layers without parents stay
+  // on the default stream.
+  std::vector<bool> continued(num_layers, false);
+  size_t num_branches = 0;
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    if (l.get_device_allocation() != El::Device::GPU ||
+        l.get_num_parents() == 0) {
+      continue;
+    }
+    const auto parent = layer_index.at(l.get_parent_layers().front());
+    if (!continued[parent]) {
+      continued[parent] = true;
+      m_stream_of_layer[i] = m_stream_of_layer[parent];
+    }
+    else {
+      m_stream_of_layer[i] = 1 + num_branches++ % (num_streams - 1);
+    }
+  }
+  if (num_branches == 0) {
+    return;
+  }
+
+  // Waits on the streams of parents in forward prop and of children
+  // in backprop
+  for (El::Int i = 0; i < num_layers; ++i) {
+    const auto& l = get_layer(i);
+    auto add_wait = [this, i](std::vector<size_t>& waits, El::Int j) {
+      const auto stream = m_stream_of_layer[j];
+      if (stream != m_stream_of_layer[i] &&
+          std::find(waits.begin(), waits.end(), stream) == waits.end()) {
+        waits.push_back(stream);
+      }
+    };
+    for (const auto* parent : l.get_parent_layers()) {
+      add_wait(m_fp_stream_waits[i], layer_index.at(parent));
+    }
+    for (const auto* child : l.get_child_layers()) {
+      add_wait(m_bp_stream_waits[i], layer_index.at(child));
+    }
+  }
+
+  m_branch_streams = get_branch_streams(num_streams);
+  for (El::Int i = 0; i < num_layers; ++i) {
+    auto& l = get_layer(i);
+    if (l.get_device_allocation() == El::Device::GPU) {
+      l.set_gpu_sync_info(m_branch_streams[m_stream_of_layer[i]]);
+    }
+  }
+  if (m_comm->am_trainer_master()) {
+    std::cout << "model \"" << get_name() << "\": " << num_branches
+              << " layer branches run on " << num_streams - 1
+              << " streams besides the default one" << std::endl;
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::wait_for_branch_streams(El::Int layer, bool backward)
+{
+#ifdef LBANN_HAS_GPU
+  if (m_branch_streams.empty()) {
+    return;
+  }
+  const auto& sync_info = m_branch_streams[m_stream_of_layer[layer]];
+  const auto& waits =
+    (backward ? m_bp_stream_waits[layer] : m_fp_stream_waits[layer]);
+  for (const auto& stream : waits) {
+    El::AddSynchronizationPoint(m_branch_streams[stream], sync_info);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void model::sync_branch_streams(bool join)
+{
+#ifdef LBANN_HAS_GPU
+  for (size_t i = 1; i < m_branch_streams.size(); ++i) {
+    if (join) {
+      El::AddSynchronizationPoint(m_branch_streams[i], m_branch_streams[0]);
+    }
+    else {
+      El::AddSynchronizationPoint(m_branch_streams[0], m_branch_streams[i]);
+    }
+  }
+#endif // LBANN_HAS_GPU
+}
+
 void model::setup_weights()
 {
 
@@ -1686,6 +2500,7 @@ void model::setup_weights()
             [](const OwningWeightsPtr& x, const OwningWeightsPtr& y) {
               return x->get_name().compare(y->get_name()) < 0;
             });
+  m_weights_indices.clear();
 
   // Setup weights
   for (auto&& w : m_weights) {
@@ -1693,6 +2508,52 @@ void model::setup_weights()
   }
 }
 
+void model::setup_gradient_buckets()
+{
+  const auto bucket_mb =
+    global_argument_parser().get<int>(LBANN_OPTION_GRADIENT_BUCKET_MB);
+  m_gradient_buckets.reset();
+  if (bucket_mb > 0) {
+    m_gradient_buckets = std::make_shared<gradient_bucket_manager>(
+      *m_comm,
+      static_cast<size_t>(bucket_mb) << 20);
+  }
+  for (auto&& w : m_weights) {
+    auto* opt = w->get_optimizer();
+    if (opt != nullptr) {
+      opt->set_gradient_buckets(m_gradient_buckets.get());
+    }
+  }
+}
+
+void model::setup_evaluation_reducer()
+{
+  m_evaluation_reducer.reset();
+  if (global_argument_parser().get<bool>(
+        LBANN_OPTION_PACK_EVALUATION_VALUES)) {
+    m_evaluation_reducer = std::make_shared<evaluation_reducer>(*m_comm);
+  }
+}
+
+void model::setup_flat_weights_state()
+{
+  m_flat_weights_state.reset();
+  if (global_argument_parser().get<bool>(LBANN_OPTION_FLAT_WEIGHTS_STATE)) {
+    m_flat_weights_state = std::make_shared<flat_weights_state>(get_weights());
+  }
+}
+
+void model::take_weights_snapshot(weights_snapshot& snapshot,
+                                  bool optimizer_state)
+{
+  snapshot.take(get_weights(), optimizer_state);
+}
+
+void model::restore_weights_snapshot(weights_snapshot& snapshot)
+{
+  snapshot.restore(get_weights());
+}
+
 void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
                                   std::unordered_set<std::string>& layer_names)
 {
@@ -1714,11 +2575,9 @@ void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
 
         // Get viewing pointer to layer
         ViewingLayerPtr l_view_ptr;
-        for (auto& l : m_layers) {
-          if (l.get() == l_raw_ptr) {
-            l_view_ptr = l;
-            break;
-          }
+        const auto l_index = find_layer_index(l_raw_ptr->get_name());
+        if (l_index >= 0 && m_layers[l_index].get() == l_raw_ptr) {
+          l_view_ptr = m_layers[l_index];
         }
         if (l_view_ptr.lock().get() == nullptr) {
           LBANN_ERROR(get_name(),
@@ -1775,11 +2634,9 @@ void model::add_evaluation_layers(std::unordered_set<Layer*>& layer_set,
 
         // Get viewing pointer to layer
         ViewingLayerPtr l_view_ptr;
-        for (auto& l : m_layers) {
-          if (l.get() == l_raw_ptr) {
-            l_view_ptr = l;
-            break;
-          }
+        const auto l_index = find_layer_index(l_raw_ptr->get_name());
+        if (l_index >= 0 && m_layers[l_index].get() == l_raw_ptr) {
+          l_view_ptr = m_layers[l_index];
         }
         if (l_view_ptr.lock().get() == nullptr) {
           LBANN_ERROR(get_name(),
@@ -1933,6 +2790,8 @@ void model::add_split_layers(std::unordered_set<std::string>& layer_names)
       ParallelStrategy& ps = split->get_parallel_strategy();
       ParallelStrategy& orig_ps = l.get_parallel_strategy();
       ps = orig_ps;
+      split->set_recompute_activations(l.get_recompute_activations());
+      split->set_offload_activations(l.get_offload_activations());
 
       // Setup relationships between split layer and child layers
       for (int j = 0; j < l.get_num_children(); ++j) {
@@ -1957,13 +2816,8 @@ void model::insert_layer(OwningLayerPtr&& new_layer,
 {
 
   // Find preceding layer after which to insert new layer
-  int preceding_layer_index = -1;
-  for (int i = 0; i < this->get_num_layers(); ++i) {
-    if (this->get_layer(i).get_name() == preceding_layer_name) {
-      preceding_layer_index = i;
-      break;
-    }
-  }
+  const El::Int preceding_layer_index =
+    find_layer_index(preceding_layer_name);
   if (preceding_layer_index < 0) {
     LBANN_ERROR("Attempted to insert layer after ",
                 "layer \"",
@@ -1999,13 +2853,8 @@ void model::remove_layer(std::string const& removable_layer_name)
 {
 
   // Find index of removable layer
-  int removable_layer_index = -1;
-  for (int i = 0; i < this->get_num_layers(); ++i) {
-    if (this->get_layer(i).get_name() == removable_layer_name) {
-      removable_layer_index = i;
-      break;
-    }
-  }
+  const El::Int removable_layer_index =
+    find_layer_index(removable_layer_name);
   if (removable_layer_index < 0) {
     LBANN_ERROR("Attempted to remove layer",
                 " \"",
@@ -2013,8 +2862,16 @@ void model::remove_layer(std::string const& removable_layer_name)
                 "\", ",
                 "but no such layer exists");
   }
+  unlink_layer(removable_layer_index);
+
+  // Destroy memory of removable layer - for now, remove from m_layers
+  m_layers.erase(m_layers.cbegin() + removable_layer_index);
+  m_layer_indices.clear();
+}
 
-  auto& l = get_layer(removable_layer_index);
+void model::unlink_layer(El::Int index)
+{
+  auto& l = get_layer(index);
 
   // Set checks to ensure there is only one parent and one child
   LBANN_ASSERT(l.get_num_parents() == 1);
@@ -2037,14 +2894,10 @@ void model::remove_layer(std::string const& removable_layer_name)
 
   // Remove weights for the old layer
   // NOTE : We assume that layers do not share weights
-  auto old_weights_ptrs =
-    m_layers[removable_layer_index]->get_weights_pointers();
+  auto old_weights_ptrs = m_layers[index]->get_weights_pointers();
   for (auto const& w : old_weights_ptrs) {
     this->remove_weights(std::shared_ptr<weights>(w)->get_name());
   }
-
-  // Destroy memory of removable layer - for now, remove from m_layers
-  m_layers.erase(m_layers.cbegin() + removable_layer_index);
 }
 
 void model::replace_layer(OwningLayerPtr&& new_layer,
@@ -2052,14 +2905,7 @@ void model::replace_layer(OwningLayerPtr&& new_layer,
 {
 
   // Find old layer
-  int old_layer_index = -1;
-  for (int i = 0; i < this->get_num_layers(); ++i) {
-    if (this->get_layer(i).get_name() == old_layer_name) {
-      old_layer_index = i;
-      break;
-    }
-  }
-
+  const El::Int old_layer_index = find_layer_index(old_layer_name);
   if (old_layer_index < 0) {
     LBANN_ERROR("Attempted to replace layer",
                 " \"",
@@ -2100,6 +2946,7 @@ void model::replace_layer(OwningLayerPtr&& new_layer,
 
   // Destroy memory of old layer - for now, remove from m_layers
   m_layers.erase(m_layers.cbegin() + old_layer_index);
+  m_layer_indices.clear();
 
   // Add new layer to layer list
   add_layer(std::move(new_layer));
@@ -2153,12 +3000,43 @@ void model::reset_mode(ExecutionContext& context, execution_mode mode)
 // At the end of the epoch, clean up the objective function and metrics
 void model::reset_epoch_statistics(execution_mode mode)
 {
+  // Pending statistics may belong to an interrupted epoch in another
+  // mode
+  flush_statistics();
   get_objective_function()->reset_statistics(mode);
   for (const auto& m : m_metrics) {
     m->reset_statistics(mode);
   }
 }
 
+void model::reduce_epoch_statistics_across_trainers(execution_mode mode)
+{
+  get_objective_function()->reduce_statistics_across_trainers(mode,
+                                                              *get_comm());
+  for (const auto& m : m_metrics) {
+    m->reduce_statistics_across_trainers(mode);
+  }
+}
+
+void model::flush_statistics()
+{
+  m_objective_function->flush_statistics();
+  std::vector<EvalType> buffer;
+  for (const auto& m : m_metrics) {
+    m->pack_pending_statistics(buffer);
+  }
+  if (buffer.empty()) {
+    return;
+  }
+  m_comm->allreduce(buffer.data(),
+                    static_cast<int>(buffer.size()),
+                    m_comm->get_trainer_comm());
+  size_t offset = 0;
+  for (const auto& m : m_metrics) {
+    offset += m->unpack_pending_statistics(buffer.data() + offset);
+  }
+}
+
 void model::evaluate_metrics(execution_mode mode,
                              size_t current_mini_batch_size)
 {
@@ -2177,12 +3055,40 @@ void model::clear_gradients()
   }
 }
 
-void model::forward_prop(execution_mode mode)
+void model::defer_gradient_allreduces(bool defer)
+{
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr) {
+      opt->set_gradient_allreduce_deferred(defer);
+    }
+  }
+}
+
+void model::forward_prop(execution_mode mode,
+                         std::function<void()> const& after_inputs)
 {
   do_model_forward_prop_begin_cbs(mode);
+  update_weights_row_norms();
+  if (m_plan_activation_memory) {
+    m_activations_released.assign(get_num_layers(), false);
+    for (auto& deferred : m_deferred_releases) {
+      deferred.clear();
+    }
+  }
 
+  // Input layers always come first (see ensure_input_layers_first)
+  bool inputs_done = false;
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     auto& l = get_layer(i);
+    if (!inputs_done && l.get_type() != "input") {
+      if (after_inputs) {
+        after_inputs();
+      }
+      sync_branch_streams(false);
+      inputs_done = true;
+    }
+    wait_for_branch_streams(i, false);
 
     if (this->is_subgraph_parallelism_enabled()) {
       if (l.get_run_layer_in_subgraph() || l.get_name() == "layer1") {
@@ -2200,6 +3106,49 @@ void model::forward_prop(execution_mode mode)
       l.forward_prop();
       do_layer_forward_prop_end_cbs(mode, &l);
     }
+
+    // Discard outputs once their segment has been forward propagated
+    const auto segment =
+      (i < static_cast<El::Int>(m_recompute_segment_of_layer.size())
+         ? m_recompute_segment_of_layer[i]
+         : -1);
+    if (mode == execution_mode::training && segment >= 0 &&
+        i + 1 == m_recompute_segments[segment].second) {
+      discard_activations(segment);
+    }
+
+    // Copy outputs to host memory, and free them once the last child
+    // has been forward propagated
+#ifdef LBANN_HAS_GPU
+    if (mode == execution_mode::training &&
+        i < static_cast<El::Int>(m_offload_activations.size())) {
+      if (m_offload_activations[i]) {
+        m_activations_offloaded[i] =
+          l.offload_activations(get_offload_stream());
+      }
+      for (const auto& j : m_offload_free_after_fp[i]) {
+        if (m_activations_offloaded[j]) {
+          free_offloaded_activations(j);
+        }
+      }
+    }
+#endif // LBANN_HAS_GPU
+
+    // Free outputs whose last consumer has been forward propagated
+    if (m_plan_activation_memory && mode != execution_mode::training) {
+      for (const auto& j : m_release_after_fp[i]) {
+        release_activations(j);
+      }
+    }
+  }
+  if (!inputs_done && after_inputs) {
+    after_inputs();
+  }
+  sync_branch_streams(true);
+
+  // Reduce the values of the evaluation layers together
+  if (m_evaluation_reducer != nullptr) {
+    m_evaluation_reducer->start();
   }
   do_model_forward_prop_end_cbs(mode);
 }
@@ -2208,12 +3157,38 @@ void model::backward_prop()
 {
 
   do_model_backward_prop_begin_cbs();
+  sync_branch_streams(false);
 
   for (El::Int i = get_num_layers() - 1; i >= 0; --i) {
 
     // Perform backward prop step on current layer
     auto& l = get_layer(i);
 
+    // Recompute discarded outputs before backprop enters a segment
+    const auto segment =
+      (i < static_cast<El::Int>(m_recompute_segment_of_layer.size())
+         ? m_recompute_segment_of_layer[i]
+         : -1);
+    if (segment >= 0 && i + 1 == m_recompute_segments[segment].second) {
+      recompute_activations(segment);
+    }
+
+    // Copy offloaded outputs back ahead of their children's backprop
+#ifdef LBANN_HAS_GPU
+    if (i < static_cast<El::Int>(m_offload_activations.size())) {
+      for (const auto& j : m_offload_restore_before_bp[i]) {
+        if (m_activations_offloaded[j]) {
+          get_layer(j).restore_activations(get_offload_stream());
+        }
+      }
+      for (const auto& j : m_offload_wait_before_bp[i]) {
+        if (m_activations_offloaded[j]) {
+          wait_for_restored_activations(j);
+        }
+      }
+    }
+#endif // LBANN_HAS_GPU
+
     if (this->is_subgraph_parallelism_enabled()) {
 
       if (l.get_run_layer_in_subgraph()) {
@@ -2227,11 +3202,22 @@ void model::backward_prop()
       }
     }
     else {
+      wait_for_branch_streams(i, true);
       do_layer_backward_prop_begin_cbs(&l);
       l.back_prop();
       do_layer_backward_prop_end_cbs(&l);
     }
 
+    // Discard recomputed outputs once the segment is done
+    if (segment >= 0 && i == m_recompute_segments[segment].first) {
+      discard_activations(segment);
+    }
+
+    // Outputs are not needed after the layer's own backprop
+    if (m_plan_activation_memory && l.get_num_parents() > 0) {
+      release_activations(i);
+    }
+
     // Terminate early if all gradients have been computed
     bool all_gradients_computed = true;
     for (auto&& w : m_weights) {
@@ -2254,9 +3240,81 @@ void model::backward_prop()
     }
   }
 
+  // Copies back may still be in flight if backprop ended early. The
+  // outputs of layers that were not copied back are reallocated in
+  // the next forward prop.
+#ifdef LBANN_HAS_GPU
+  for (size_t i = 0; i < m_activations_offloaded.size(); ++i) {
+    if (m_activations_offloaded[i]) {
+      get_layer(i).wait_for_restored_activations(get_offload_stream());
+      m_activations_offloaded[i] = false;
+    }
+  }
+#endif // LBANN_HAS_GPU
+
+  sync_branch_streams(true);
+
+  // Buckets that are still open have all the gradients they will get
+  if (m_gradient_buckets != nullptr) {
+    m_gradient_buckets->seal();
+  }
+
   do_model_backward_prop_end_cbs();
 }
 
+bool model::unscale_gradients(EvalType scale)
+{
+  // Note: Every optimizer participates, since checking a gradient
+  // involves a collective over its weights' process grid.
+  int finite = 1;
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt != nullptr && !opt->unscale_gradient(scale)) {
+      finite = 0;
+    }
+  }
+  return m_comm->trainer_allreduce(finite, El::mpi::MIN) != 0;
+}
+
+void model::clip_gradients()
+{
+  // Group the optimizers by dynamic type, so each group computes its
+  // contribution to the norm in one pass
+  std::vector<std::type_index> types;
+  std::vector<std::vector<optimizer*>> groups;
+  for (auto&& w : m_weights) {
+    auto&& opt = w->get_optimizer();
+    if (opt == nullptr || opt->get_clip_gradient_norm() <= 0.) {
+      continue;
+    }
+    const std::type_index type(typeid(*opt));
+    auto it = std::find(types.begin(), types.end(), type);
+    if (it == types.end()) {
+      types.push_back(type);
+      groups.emplace_back();
+      it = std::prev(types.end());
+    }
+    groups[std::distance(types.begin(), it)].push_back(opt);
+  }
+  if (groups.empty()) {
+    return;
+  }
+
+  EvalType sqnorm = 0;
+  for (const auto& group : groups) {
+    sqnorm += group.front()->get_local_gradient_sqnorm(group);
+  }
+  const EvalType norm = std::sqrt(m_comm->trainer_allreduce(sqnorm));
+  for (const auto& group : groups) {
+    for (auto* opt : group) {
+      const EvalType threshold = opt->get_clip_gradient_norm();
+      if (norm > threshold) {
+        opt->set_gradient_scale(threshold / (norm + EvalType(1e-6)));
+      }
+    }
+  }
+}
+
 void model::update_weights()
 {
   do_model_optimize_begin_cbs();
@@ -2268,14 +3326,91 @@ void model::update_weights()
   // after a weights gradient has been computed. Thus, iterating in
   // reverse order will use gradients that have already finished their
   // allreduce, giving more time for more recent allreduces to finish.
+  // With fused steps, weights whose optimizers have the same dynamic
+  // type are updated together after the others.
+  // With overlapped steps, the allreduces of weights with local
+  // steps are all launched first, in the same order on every
+  // process, and the weights are updated as their allreduces
+  // complete. Waiting for them never launches communication, so
+  // processes may update them in different orders.
+  const bool fuse = global_argument_parser().get<bool>(
+    LBANN_OPTION_FUSE_OPTIMIZER_STEPS);
+  const bool overlap = global_argument_parser().get<bool>(
+    LBANN_OPTION_OVERLAP_OPTIMIZER_STEPS);
+  std::vector<std::type_index> fused_types;
+  std::vector<std::vector<weights*>> fused_weights;
+  std::vector<std::vector<optimizer*>> fused_optimizers;
+  std::vector<weights*> sequential_weights;
+  std::list<weights*> overlapped_weights;
   for (auto rit = m_weights.rbegin(); rit != m_weights.rend(); ++rit) {
     auto& w = **rit;
     auto&& opt = w.get_optimizer();
 
     if (opt != nullptr) {
-      do_weight_optimize_begin_cbs(&w);
-      opt->step();
-      do_weight_optimize_end_cbs(&w);
+      if (fuse && opt->can_fuse_step()) {
+        do_weight_optimize_begin_cbs(&w);
+        const std::type_index type(typeid(*opt));
+        auto it = std::find(fused_types.begin(), fused_types.end(), type);
+        if (it == fused_types.end()) {
+          fused_types.push_back(type);
+          fused_weights.emplace_back();
+          fused_optimizers.emplace_back();
+          it = std::prev(fused_types.end());
+        }
+        const auto group = std::distance(fused_types.begin(), it);
+        fused_weights[group].push_back(&w);
+        fused_optimizers[group].push_back(opt);
+      }
+      else if (overlap && opt->can_overlap_step()) {
+        opt->launch_gradient_allreduce();
+        overlapped_weights.push_back(&w);
+      }
+      else {
+        sequential_weights.push_back(&w);
+      }
+    }
+  }
+  auto step = [this](weights& w) {
+    do_weight_optimize_begin_cbs(&w);
+    w.get_optimizer()->step();
+    do_weight_optimize_end_cbs(&w);
+  };
+  // Update the overlapped weights whose allreduces have completed
+  auto step_ready = [&]() {
+    bool progress = false;
+    for (auto it = overlapped_weights.begin();
+         it != overlapped_weights.end();) {
+      if ((*it)->get_optimizer()->test_gradient_allreduce()) {
+        step(**it);
+        it = overlapped_weights.erase(it);
+        progress = true;
+      }
+      else {
+        ++it;
+      }
+    }
+    return progress;
+  };
+  for (auto* w : sequential_weights) {
+    step_ready();
+    step(*w);
+  }
+  while (!overlapped_weights.empty()) {
+    if (!step_ready()) {
+      step(*overlapped_weights.front());
+      overlapped_weights.pop_front();
+    }
+  }
+  for (size_t group = 0; group < fused_optimizers.size(); ++group) {
+    const auto& opts = fused_optimizers[group];
+    if (opts.size() == 1) {
+      opts.front()->step();
+    }
+    else {
+      opts.front()->fused_step(opts);
+    }
+    for (auto* w : fused_weights[group]) {
+      do_weight_optimize_end_cbs(w);
     }
   }
 
@@ -2314,6 +3449,19 @@ void model::reconcile_weight_values()
   }
 }
 
+void model::update_weights_row_norms()
+{
+  std::vector<weights*> normed_weights;
+  for (const auto& w : m_weights) {
+    if (w->has_row_norms()) {
+      normed_weights.push_back(w.get());
+    }
+  }
+  if (!normed_weights.empty()) {
+    normed_weights.front()->update_row_norms(normed_weights);
+  }
+}
+
 // =============================================
 // Callbacks
 // =============================================
@@ -2535,6 +3683,7 @@ struct lbann_model_header
 bool model::save_to_checkpoint_shared(persist& p)
 {
   const std::string trainer_dir = p.get_checkpoint_dir();
+  flush_statistics();
 
   // This "pushes" the model-specific directory to the "stack". After
   // the call, p.get_checkpoint_dir() returns the model-specific
@@ -2548,39 +3697,156 @@ bool model::save_to_checkpoint_shared(persist& p)
   m_comm->trainer_barrier();
 
   // Open the stream for writing
-  std::ofstream ofs;
+  std::unique_ptr<std::ostream> os;
   if (m_comm->am_trainer_master()) {
-    ofs.open(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    LBANN_ASSERT(ofs.good());
+    os = p.open_output(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    LBANN_ASSERT(os->good());
+  }
+  else {
+    os = std::make_unique<std::ofstream>();
+  }
+
+  // Frozen weights that have not changed since an earlier checkpoint
+  // wrote their values refer to it
+  std::vector<weights*> by_reference;
+  if (p.get_incremental_weights()) {
+    by_reference = save_frozen_weights_values(p);
+  }
+  for (auto* w : by_reference) {
+    w->set_values_by_reference(true);
   }
 
   // Write the checkpoint
   {
-    lbann::RootedBinaryOutputArchive ar(ofs, m_comm->get_trainer_grid());
+    lbann::RootedBinaryOutputArchive ar(*os, m_comm->get_trainer_grid());
     ar(*this);
   }
+  for (auto* w : by_reference) {
+    w->set_values_by_reference(false);
+  }
 
   p.open_checkpoint_dir(trainer_dir, false);
   return true;
 }
 
+std::vector<weights*> model::save_frozen_weights_values(persist& p)
+{
+  std::vector<weights*> frozen;
+  std::ostringstream index;
+  for (auto* w : get_weights()) {
+    if (!w->is_frozen()) {
+      m_frozen_values_files.erase(w->get_name());
+      continue;
+    }
+    // Every rank must agree on writing the values, which is collective
+    auto it = m_frozen_values_files.find(w->get_name());
+    int changed = (it == m_frozen_values_files.end() ||
+                   it->second.version != w->get_values_version());
+    changed = m_comm->trainer_allreduce(changed, El::mpi::MAX);
+    if (changed) {
+      const auto filename =
+        file::join_path(p.get_checkpoint_dir(), w->get_name() + ".values.bin");
+      std::unique_ptr<std::ostream> os;
+      if (m_comm->am_trainer_master()) {
+        os = p.open_output(filename);
+        LBANN_ASSERT(os->good());
+      }
+      else {
+        os = std::make_unique<std::ofstream>();
+      }
+      w->save_values(*os);
+      m_frozen_values_files[w->get_name()] = {w->get_values_version(),
+                                              filename};
+    }
+    index << w->get_name() << '\t'
+          << m_frozen_values_files[w->get_name()].filename << '\n';
+    frozen.push_back(w);
+  }
+  if (m_comm->am_trainer_master() && !frozen.empty()) {
+    auto os = p.open_output(
+      file::join_path(p.get_checkpoint_dir(), "frozen_weights.txt"));
+    *os << index.str();
+  }
+  return frozen;
+}
+
+void model::load_frozen_weights_values(persist& p)
+{
+  // Not every checkpoint refers to frozen weights
+  std::string index;
+  if (m_comm->am_trainer_master()) {
+    std::ifstream is(
+      file::join_path(p.get_checkpoint_dir(), "frozen_weights.txt"));
+    if (is.good()) {
+      std::ostringstream ss;
+      ss << is.rdbuf();
+      index = ss.str();
+    }
+  }
+  m_comm->trainer_broadcast(0, index);
+
+  const bool parallel = p.get_parallel_reads();
+  std::istringstream lines(index);
+  std::string name, filename;
+  while (std::getline(lines, name, '\t') && std::getline(lines, filename)) {
+    auto const all_weights = get_weights();
+    auto it = std::find_if(all_weights.begin(),
+                           all_weights.end(),
+                           [&name](auto const* w) {
+                             return w->get_name() == name;
+                           });
+    if (it == all_weights.end()) {
+      LBANN_ERROR("checkpoint refers to the values of weights \"",
+                  name,
+                  "\", which are not in model \"",
+                  get_name(),
+                  "\"");
+    }
+    std::unique_ptr<std::istream> is;
+    if (parallel || m_comm->am_trainer_master()) {
+      is = p.open_input(filename);
+      if (!is->good()) {
+        LBANN_ERROR("could not open ",
+                    filename,
+                    ", which holds the values of weights \"",
+                    name,
+                    "\"");
+      }
+    }
+    else {
+      is = std::make_unique<std::ifstream>();
+    }
+    (*it)->load_values(*is, parallel);
+    m_frozen_values_files[name] = {(*it)->get_values_version(), filename};
+  }
+}
+
 bool model::load_from_checkpoint_shared(persist& p)
 {
   const std::string trainer_dir = p.get_checkpoint_dir();
   p.open_restart(file::join_path(trainer_dir, get_name()));
   // Assume checkpoint reload from epoch end not step end
 
-  std::ifstream ifs;
-  if (m_comm->am_trainer_master()) {
-    ifs.open(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    LBANN_ASSERT(ifs.good());
+  // With parallel reads, every rank reads its part of the matrices
+  const bool parallel = p.get_parallel_reads();
+  std::unique_ptr<std::istream> is;
+  if (parallel || m_comm->am_trainer_master()) {
+    is = p.open_input(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    LBANN_ASSERT(is->good());
+  }
+  else {
+    is = std::make_unique<std::ifstream>();
   }
 
   // Restore the checkpoint
   {
-    lbann::RootedBinaryInputArchive ar(ifs, m_comm->get_trainer_grid());
+    lbann::RootedBinaryInputArchive ar(*is,
+                                       m_comm->get_trainer_grid(),
+                                       /*root=*/0,
+                                       parallel);
     ar(*this);
   }
+  load_frozen_weights_values(p);
 
   m_model_is_setup = false;
   p.set_restart_dir(trainer_dir);
@@ -2590,9 +3856,56 @@ bool model::load_from_checkpoint_shared(persist& p)
   return true;
 }
 
+namespace {
+
+/** @brief Archives of the ranks that wrote a distributed checkpoint.
+ *  @param dirs Checkpoint directories of the ranks
+ */
+std::vector<utils::dist_matrix_resharder::source>
+get_reshard_sources(std::string const& model_name,
+                    std::vector<std::string> const& dirs)
+{
+  std::vector<utils::dist_matrix_resharder::source> sources;
+  for (auto const& dir : dirs) {
+    const auto model_dir = file::join_path(dir, model_name);
+    utils::dist_matrix_resharder::source src;
+    uint64_t size;
+    locate_checkpoint_file(dir,
+                           file::join_path(model_dir, "model.bin"),
+                           src.filename,
+                           src.offset,
+                           size);
+    std::string index_filename;
+    uint64_t index_offset;
+    locate_checkpoint_file(dir,
+                           file::join_path(model_dir, "model.bin.index"),
+                           index_filename,
+                           index_offset,
+                           size);
+    std::ifstream is(index_filename, std::ios::binary);
+    is.seekg(index_offset);
+    El::Int num_procs;
+    src.records = utils::read_dist_matrix_index(is, num_procs);
+    if (num_procs != static_cast<El::Int>(dirs.size())) {
+      LBANN_ERROR("checkpoint index in ",
+                  model_dir,
+                  " was written by ",
+                  num_procs,
+                  " ranks, but ",
+                  dirs.size(),
+                  " rank directories were found");
+    }
+    sources.push_back(std::move(src));
+  }
+  return sources;
+}
+
+} // namespace
+
 bool model::save_to_checkpoint_distributed(persist& p)
 {
   const std::string trainer_dir = p.get_checkpoint_dir();
+  flush_statistics();
   p.open_checkpoint_dir(file::join_path(trainer_dir, get_name()), true);
 
   // Make sure that the master has had a chance to create the directories
@@ -2600,16 +3913,28 @@ bool model::save_to_checkpoint_distributed(persist& p)
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
   {
-    std::ofstream ofs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    cereal::BinaryOutputArchive ar(ofs);
-    ar(*this);
+    auto os =
+      p.open_output(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    // Where the distributed matrices are, so the checkpoint can be
+    // loaded by a different number of ranks
+    utils::dist_matrix_recorder recorder(*os);
+    {
+      cereal::BinaryOutputArchive ar(*os);
+      ar(*this);
+    }
+    auto index_os = p.open_output(
+      file::join_path(p.get_checkpoint_dir(), "model.bin.index"));
+    utils::write_dist_matrix_index(*index_os,
+                                   recorder.records(),
+                                   m_comm->get_procs_per_trainer());
   }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
   {
-    std::ofstream ofs_xml(file::join_path(p.get_checkpoint_dir(), "model.xml"));
-    cereal::XMLOutputArchive ar(ofs_xml);
+    auto os_xml =
+      p.open_output(file::join_path(p.get_checkpoint_dir(), "model.xml"));
+    cereal::XMLOutputArchive ar(*os_xml);
     ar(*this);
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
@@ -2625,8 +3950,15 @@ bool model::load_from_checkpoint_distributed(persist& p)
 
 #ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
   {
-    std::ifstream ifs(file::join_path(p.get_checkpoint_dir(), "model.bin"));
-    cereal::BinaryInputArchive ar(ifs);
+    auto is =
+      p.open_input(file::join_path(p.get_checkpoint_dir(), "model.bin"));
+    std::unique_ptr<utils::dist_matrix_resharder> resharder;
+    if (p.is_resharding()) {
+      resharder = std::make_unique<utils::dist_matrix_resharder>(
+        *is,
+        get_reshard_sources(get_name(), p.get_reshard_dirs()));
+    }
+    cereal::BinaryInputArchive ar(*is);
     ar(*this);
   }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
@@ -2742,6 +4074,15 @@ void model::setup_distconv()
 void model::setup_distributions()
 {
   tensor_overlap_constraints constraints;
+  // Choose decompositions in order, so layers can follow their
+  // parents
+  if (dc::is_decomposition_autotuned()) {
+    for (El::Int i = 0; i < get_num_layers(); ++i) {
+      if (!get_layer(i).distconv_enabled())
+        continue;
+      get_layer(i).get_distconv_adapter().autotune_parallel_strategy();
+    }
+  }
   // Initialize the distributions and constraints
   for (El::Int i = 0; i < get_num_layers(); ++i) {
     if (!get_layer(i).distconv_enabled())
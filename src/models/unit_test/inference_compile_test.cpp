@@ -0,0 +1,226 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/execution_algorithms/batch_functional_inference_algorithm.hpp>
+#include <lbann/models/model.hpp>
+#include <lbann/proto/factories.hpp>
+#include <lbann/utils/lbann_library.hpp>
+#include <lbann/utils/serialize.hpp>
+
+#include "lbann/proto/lbann.pb.h"
+#include <google/protobuf/text_format.h>
+
+namespace pb = ::google::protobuf;
+
+namespace {
+// Fully-connected layer without bias, followed by batch normalization
+// with non-trivial statistics and dropout, so that the inference
+// compile removes two layers and adds a bias to the first one
+std::string const model_prototext = R"ptext(
+model {
+  layer {
+    name: "input"
+    children: "fc"
+    input {
+      data_field: "samples"
+    }
+  }
+  layer {
+    name: "fc"
+    parents: "input"
+    children: "bn"
+    fully_connected {
+      num_neurons: 4
+      has_bias: false
+    }
+  }
+  layer {
+    name: "bn"
+    parents: "fc"
+    children: "dropout"
+    weights: "bn_scale"
+    weights: "bn_bias"
+    weights: "bn_mean"
+    weights: "bn_var"
+    batch_normalization {
+      decay: 0.9
+      epsilon: 1e-5
+    }
+  }
+  layer {
+    name: "dropout"
+    parents: "bn"
+    children: "prob"
+    dropout {
+      keep_prob: 0.5
+    }
+  }
+  layer {
+    name: "prob"
+    parents: "dropout"
+    softmax {
+    }
+  }
+  weights {
+    name: "bn_scale"
+    initializer {
+      value_initializer {
+        values: [0.5, 2.0, -1.0, 1.5]
+      }
+    }
+  }
+  weights {
+    name: "bn_bias"
+    initializer {
+      value_initializer {
+        values: [0.1, -0.2, 0.3, 0.0]
+      }
+    }
+  }
+  weights {
+    name: "bn_mean"
+    initializer {
+      value_initializer {
+        values: [1.0, -0.5, 0.25, 0.0]
+      }
+    }
+  }
+  weights {
+    name: "bn_var"
+    initializer {
+      value_initializer {
+        values: [4.0, 0.25, 1.0, 2.0]
+      }
+    }
+  }
+}
+)ptext";
+
+auto mock_datareader_metadata()
+{
+  lbann::DataReaderMetaData md;
+  auto& md_dims = md.data_dims;
+  md_dims[lbann::data_reader_target_mode::CLASSIFICATION] = {4};
+  md_dims[lbann::data_reader_target_mode::INPUT] = {1, 1, 4};
+  return md;
+}
+
+auto make_model(lbann::lbann_comm& comm)
+{
+  lbann_data::LbannPB my_proto;
+  if (!pb::TextFormat::ParseFromString(model_prototext, &my_proto))
+    throw "Parsing protobuf failed.";
+  // Construct a trainer so that the model can register the input layer
+  lbann::construct_trainer(&comm, my_proto.mutable_trainer(), my_proto);
+  auto metadata = mock_datareader_metadata();
+  auto my_model = lbann::proto::construct_model(&comm,
+                                                -1,
+                                                my_proto.optimizer(),
+                                                my_proto.trainer(),
+                                                my_proto.model());
+  my_model->setup(1UL, metadata, {&comm.get_trainer_grid()});
+  return my_model;
+}
+
+bool has_layer_type(lbann::model const& m, std::string const& type)
+{
+  for (El::Int i = 0; i < m.get_num_layers(); ++i) {
+    if (m.get_layer(i).get_type() == type) {
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+using unit_test::utilities::IsValidPtr;
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+TEST_CASE("Inference-only model compile", "[mpi][model][inference]")
+{
+  using DataType = float;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  // Restore a copy of the model with known weights values, as when
+  // loading a checkpoint
+  std::unique_ptr<lbann::model> model_src_ptr = make_model(comm),
+                                model_tgt_ptr;
+  std::stringstream ss;
+  {
+    lbann::RootedBinaryOutputArchive oarchive(ss, g);
+    REQUIRE_NOTHROW(oarchive(model_src_ptr));
+  }
+  {
+    lbann::RootedBinaryInputArchive iarchive(ss, g);
+    REQUIRE_NOTHROW(iarchive(model_tgt_ptr));
+    REQUIRE(IsValidPtr(model_tgt_ptr));
+  }
+  model_tgt_ptr->set_inference_only(true);
+  auto metadata = mock_datareader_metadata();
+  REQUIRE_NOTHROW(model_tgt_ptr->setup(1UL, metadata, {&g}));
+
+  SECTION("Dropout and batch normalization layers are removed")
+  {
+    CHECK(model_tgt_ptr->get_num_layers() == 3);
+    CHECK_FALSE(has_layer_type(*model_tgt_ptr, "dropout"));
+    CHECK_FALSE(has_layer_type(*model_tgt_ptr, "batch normalization"));
+    for (auto const* w : model_tgt_ptr->get_weights()) {
+      CHECK(w->is_frozen());
+    }
+  }
+
+  SECTION("Compiled model computes the same outputs")
+  {
+    El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>
+      data(4, 5, g);
+    for (El::Int j = 0; j < data.Width(); ++j) {
+      for (El::Int i = 0; i < data.Height(); ++i) {
+        data.Set(i, j, DataType(i + 1) * DataType(j % 3) - DataType(1));
+      }
+    }
+    auto inf_alg = lbann::batch_functional_inference_algorithm();
+    auto const expected = inf_alg.infer_outputs(model_src_ptr.get(), data, 2);
+    auto const outputs = inf_alg.infer_outputs(model_tgt_ptr.get(), data, 2);
+    REQUIRE(outputs.Height() == expected.Height());
+    REQUIRE(outputs.Width() == expected.Width());
+    for (El::Int i = 0; i < outputs.Height(); ++i) {
+      for (El::Int j = 0; j < outputs.Width(); ++j) {
+        CHECK(outputs(i, j) == Approx(expected(i, j)).epsilon(1e-4));
+      }
+    }
+  }
+}
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
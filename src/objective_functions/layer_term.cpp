@@ -86,6 +86,7 @@ void layer_term::setup(model& m)
   auto& eval =
     dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
   eval.set_scale(m_scale_factor);
+  eval.set_value_required(true);
   // get_evaluation_layer().set_scale(m_scale_factor);
 }
 
@@ -102,6 +103,20 @@ EvalType layer_term::finish_evaluation()
   return eval.get_value();
 }
 
+#ifdef LBANN_HAS_GPU
+bool layer_term::accumulate_value(El::Matrix<EvalType, El::Device::GPU>& sum,
+                                  EvalType weight)
+{
+  if (m_scale_factor == EvalType(0)) {
+    return true;
+  }
+  auto& eval =
+    dynamic_cast<abstract_evaluation_layer<DataType>&>(get_evaluation_layer());
+  eval.set_scale(m_scale_factor);
+  return eval.accumulate_value(sum, weight);
+}
+#endif // LBANN_HAS_GPU
+
 void layer_term::differentiate()
 {
   auto& eval =
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/objective_functions/objective_function.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/utils/profiling.hpp"
 #include "lbann/utils/serialize.hpp"
 #include "lbann/utils/timer.hpp"
@@ -32,6 +33,24 @@
 
 namespace lbann {
 
+namespace {
+
+/** Call @c f with the term's scale factor multiplied by @c scale. */
+template <typename F>
+void scaled_term_call(objective_function_term& term, EvalType scale, F&& f)
+{
+  if (scale == EvalType(1)) {
+    f();
+    return;
+  }
+  const auto scale_factor = term.get_scale_factor();
+  term.set_scale_factor(scale_factor * scale);
+  f();
+  term.set_scale_factor(scale_factor);
+}
+
+} // namespace
+
 objective_function::objective_function(const objective_function& other)
   : m_statistics(other.m_statistics),
     m_evaluation_time(other.m_evaluation_time),
@@ -52,6 +71,9 @@ objective_function::operator=(const objective_function& other)
   m_statistics = other.m_statistics;
   m_evaluation_time = other.m_evaluation_time;
   m_differentiation_time = other.m_differentiation_time;
+#ifdef LBANN_HAS_GPU
+  m_device_statistics.clear();
+#endif // LBANN_HAS_GPU
   return *this;
 }
 
@@ -120,7 +142,105 @@ EvalType objective_function::finish_evaluation(execution_mode mode,
   return value;
 }
 
-void objective_function::differentiate()
+void objective_function::finish_evaluation_deferred(execution_mode mode,
+                                                    int mini_batch_size)
+{
+#ifdef LBANN_HAS_GPU
+  const auto start_time = get_time();
+  auto& device_stats = get_device_statistics(mode);
+  EvalType value = EvalType(0);
+  prof_region_begin("obj-finish-eval", prof_colors[0], false);
+  for (auto&& term : m_terms) {
+    prof_region_begin(("obj-finish-eval-" + term->name()).c_str(),
+                      prof_colors[1],
+                      false);
+    if (!term->accumulate_value(device_stats.sum, mini_batch_size)) {
+      value += term->finish_evaluation();
+    }
+    prof_region_end(("obj-finish-eval-" + term->name()).c_str(), false);
+  }
+  prof_region_end("obj-finish-eval", false);
+  m_statistics[mode].add_value(mini_batch_size * value, mini_batch_size);
+  read_device_statistics(mode, false);
+  m_evaluation_time += get_time() - start_time;
+#else
+  finish_evaluation(mode, mini_batch_size);
+#endif // LBANN_HAS_GPU
+}
+
+void objective_function::flush_statistics()
+{
+#ifdef LBANN_HAS_GPU
+  for (auto& stats : m_device_statistics) {
+    read_device_statistics(stats.first, true);
+  }
+#endif // LBANN_HAS_GPU
+}
+
+void objective_function::reset_statistics()
+{
+  for (auto& stats : m_statistics) {
+    reset_statistics(stats.first);
+  }
+}
+
+void objective_function::reset_statistics(execution_mode mode)
+{
+#ifdef LBANN_HAS_GPU
+  // Discard values that are still on the device
+  if (m_device_statistics.count(mode) > 0) {
+    read_device_statistics(mode, true);
+  }
+#endif // LBANN_HAS_GPU
+  m_statistics[mode].reset();
+}
+
+#ifdef LBANN_HAS_GPU
+objective_function::device_statistics&
+objective_function::get_device_statistics(execution_mode mode)
+{
+  auto& stats = m_device_statistics[mode];
+  if (stats.sum.Height() == 0) {
+    stats.readback.SetMemoryMode(1); // Use pinned memory on host
+    El::Zeros(stats.readback, 1, 1);
+    El::Zeros(stats.sum, 1, 1);
+  }
+  return stats;
+}
+
+void objective_function::read_device_statistics(execution_mode mode,
+                                                bool wait)
+{
+  auto& stats = get_device_statistics(mode);
+  if (stats.reading) {
+    if (wait) {
+      stats.readback_event.synchronize();
+    }
+    else if (!stats.readback_event.query()) {
+      return;
+    }
+    m_statistics[mode].add_value(stats.readback(0, 0), 0);
+    stats.reading = false;
+  }
+
+  // Start reading the values added since the last read
+  auto sync_info = gpu::get_sync_info(stats.sum);
+  hydrogen::gpu::Copy1DToHost(stats.sum.LockedBuffer(),
+                              stats.readback.Buffer(),
+                              1,
+                              sync_info);
+  El::Zero(stats.sum);
+  stats.readback_event.record(sync_info.Stream());
+  stats.reading = true;
+  if (wait) {
+    stats.readback_event.synchronize();
+    m_statistics[mode].add_value(stats.readback(0, 0), 0);
+    stats.reading = false;
+  }
+}
+#endif // LBANN_HAS_GPU
+
+void objective_function::differentiate(EvalType gradient_scale)
 {
   const auto start_time = get_time();
   prof_region_begin("obj-differentiate", prof_colors[0], false);
@@ -128,14 +248,17 @@ void objective_function::differentiate()
     prof_region_begin(("obj-differentiate-" + term->name()).c_str(),
                       prof_colors[1],
                       false);
-    term->differentiate();
+    scaled_term_call(*term, gradient_scale, [&term]() {
+      term->differentiate();
+    });
     prof_region_end(("obj-differentiate-" + term->name()).c_str(), false);
   }
   prof_region_end("obj-differentiate", false);
   m_differentiation_time += get_time() - start_time;
 }
 
-void objective_function::compute_weight_regularization()
+void objective_function::compute_weight_regularization(
+  EvalType gradient_scale)
 {
   const auto start_time = get_time();
   prof_region_begin("obj-weight-regularization", prof_colors[0], false);
@@ -143,7 +266,9 @@ void objective_function::compute_weight_regularization()
     prof_region_begin(("obj-weight-regularization-" + term->name()).c_str(),
                       prof_colors[1],
                       false);
-    term->compute_weight_regularization();
+    scaled_term_call(*term, gradient_scale, [&term]() {
+      term->compute_weight_regularization();
+    });
     prof_region_end(("obj-weight-regularization-" + term->name()).c_str(),
                     false);
   }
@@ -174,6 +299,13 @@ int objective_function::get_statistics_num_samples(execution_mode mode) const
   }
 }
 
+void objective_function::reduce_statistics_across_trainers(
+  execution_mode mode,
+  const lbann_comm& comm)
+{
+  m_statistics[mode].allreduce(comm, comm.get_intertrainer_comm());
+}
+
 std::vector<ViewingLayerPtr> objective_function::get_layer_pointers() const
 {
   std::vector<ViewingLayerPtr> layers;
@@ -0,0 +1,174 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// Testing framework stuff
+#include "Catch2BasicSupport.hpp"
+#ifdef LBANN_USE_CATCH2_V3
+#include <catch2/benchmark/catch_benchmark.hpp>
+#endif // LBANN_USE_CATCH2_V3
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include "OperatorTraits.hpp"
+
+// CUT
+#include "lbann/operators/math/binary.hpp"
+#include "lbann/operators/math/clamp.hpp"
+#include "lbann/operators/math/unary.hpp"
+
+#include <h2/meta/Core.hpp>
+#include <h2/meta/TypeList.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace lbann;
+
+// Benchmarks are hidden; run them with
+//   mpi-catch-tests "[benchmark]"
+// Catch2 runs warm-up iterations and reports the mean and standard
+// deviation over its samples, with outliers. Pass --reporter JSON
+// (Catch2 3.4 or newer) or --reporter xml for machine-readable results.
+
+namespace {
+
+template <typename T, El::Device D>
+struct OperatorBenchmark
+{
+  using value_type = T;
+  static constexpr El::Device device = D;
+};
+
+template <typename T>
+using OperatorBenchmarkAllDevices = h2::meta::TL<
+#ifdef LBANN_HAS_GPU
+  OperatorBenchmark<T, El::Device::GPU>,
+#endif // LBANN_HAS_GPU
+  OperatorBenchmark<T, El::Device::CPU>>;
+
+using AllOperatorBenchmarks =
+  h2::meta::tlist::Append<OperatorBenchmarkAllDevices<float>,
+                          OperatorBenchmarkAllDevices<double>>;
+
+/** Wait for the kernels of an iteration, so they are timed. */
+template <El::Device D>
+void synchronize()
+{
+#ifdef LBANN_HAS_GPU
+  if constexpr (D == El::Device::GPU) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+}
+
+/** Feature and mini-batch sizes of the benchmarked tensors. */
+std::vector<std::pair<El::Int, El::Int>> const shapes = {{1024, 64},
+                                                         {16384, 128}};
+
+} // namespace
+
+TEMPLATE_LIST_TEST_CASE("Elementwise operator benchmarks",
+                        "[.benchmark][mpi][operator][math]",
+                        AllOperatorBenchmarks)
+{
+  using T = typename TestType::value_type;
+  constexpr auto D = TestType::device;
+  using MatType = DataParallelMatrixType<T, D>;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+
+  ExpOperator<T, D> exp_op;
+  TanhOperator<T, D> tanh_op;
+  ClampOperator<T, D> clamp_op(-0.5, 0.5);
+  AddOperator<T, D> add_op;
+  MultiplyOperator<T, D> multiply_op;
+
+  for (auto const& [height, width] : shapes) {
+    MatType x(height, width, g, 0), y(height, width, g, 0),
+      z(height, width, g, 0), dz(height, width, g, 0),
+      dx(height, width, g, 0), dy(height, width, g, 0);
+    El::MakeUniform(x);
+    El::MakeUniform(y);
+    El::MakeUniform(dz);
+    synchronize<D>();
+    const std::string shape =
+      " " + std::to_string(height) + "x" + std::to_string(width);
+
+    BENCHMARK("exp fp" + shape)
+    {
+      exp_op.fp_compute({x}, {z});
+      synchronize<D>();
+    };
+    BENCHMARK("exp bp" + shape)
+    {
+      exp_op.bp_compute({x}, {dz}, {dx});
+      synchronize<D>();
+    };
+    BENCHMARK("tanh fp" + shape)
+    {
+      tanh_op.fp_compute({x}, {z});
+      synchronize<D>();
+    };
+    BENCHMARK("tanh bp" + shape)
+    {
+      tanh_op.bp_compute({x}, {dz}, {dx});
+      synchronize<D>();
+    };
+    BENCHMARK("clamp fp" + shape)
+    {
+      clamp_op.fp_compute({x}, {z});
+      synchronize<D>();
+    };
+    BENCHMARK("clamp bp" + shape)
+    {
+      clamp_op.bp_compute({x}, {dz}, {dx});
+      synchronize<D>();
+    };
+    BENCHMARK("add fp" + shape)
+    {
+      add_op.fp_compute({x, y}, {z});
+      synchronize<D>();
+    };
+    BENCHMARK("add bp" + shape)
+    {
+      add_op.bp_compute({x, y}, {dz}, {dx, dy});
+      synchronize<D>();
+    };
+    BENCHMARK("multiply fp" + shape)
+    {
+      multiply_op.fp_compute({x, y}, {z});
+      synchronize<D>();
+    };
+    BENCHMARK("multiply bp" + shape)
+    {
+      multiply_op.bp_compute({x, y}, {dz}, {dx, dy});
+      synchronize<D>();
+    };
+  }
+}
@@ -28,19 +28,48 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/memory.hpp"
 
+#include "compressed_step.hpp"
+
 namespace lbann {
 
+namespace {
+
+/** @brief AdaGrad update of one entry with a compressed cache
+ *  @details The state is the cache.
+ */
+template <typename TensorDataType>
+struct adagrad_compressed_op
+{
+  TensorDataType learning_rate;
+  TensorDataType eps;
+  void operator()(TensorDataType& x,
+                  const TensorDataType& g,
+                  TensorDataType* cache) const
+  {
+    auto& c = cache[0];
+    c += g * g;
+    x -= learning_rate * g / (El::Sqrt(c) + eps);
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 adagrad<TensorDataType>::adagrad(TensorDataType learning_rate,
-                                 TensorDataType eps)
-  : BaseType(learning_rate), m_eps(eps)
+                                 TensorDataType eps,
+                                 optimizer_state_format state_format)
+  : BaseType(learning_rate), m_eps(eps), m_state_format(state_format)
 {}
 
 template <typename TensorDataType>
 adagrad<TensorDataType>::adagrad(const adagrad<TensorDataType>& other)
   : BaseType(other),
     m_eps(other.m_eps),
-    m_cache(other.m_cache ? other.m_cache->Copy() : nullptr)
+    m_cache(other.m_cache ? other.m_cache->Copy() : nullptr),
+    m_state_format(other.m_state_format),
+    m_compressed_cache(other.m_compressed_cache
+                         ? new compressed_state(*other.m_compressed_cache)
+                         : nullptr)
 {}
 
 template <typename TensorDataType>
@@ -50,6 +79,10 @@ adagrad<TensorDataType>::operator=(const adagrad<TensorDataType>& other)
   OptimizerType::operator=(other);
   m_eps = other.m_eps;
   m_cache.reset(other.m_cache ? other.m_cache->Copy() : nullptr);
+  m_state_format = other.m_state_format;
+  m_compressed_cache.reset(other.m_compressed_cache
+                             ? new compressed_state(*other.m_compressed_cache)
+                             : nullptr);
   return *this;
 }
 
@@ -58,6 +91,7 @@ description adagrad<TensorDataType>::get_description() const
 {
   auto desc = OptimizerType::get_description();
   desc.add("eps", m_eps);
+  desc.add("State format", to_string(m_state_format));
   return desc;
 }
 
@@ -67,6 +101,12 @@ void adagrad<TensorDataType>::setup(WeightsType* w)
   OptimizerType::setup(w);
   const auto& gradient = this->get_gradient();
   m_cache.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  if (m_state_format != optimizer_state_format::full) {
+    m_compressed_cache =
+      std::make_unique<compressed_state>(m_state_format, false);
+    m_compressed_cache->setup(gradient);
+    return;
+  }
   El::Zeros(*m_cache, gradient.Height(), gradient.Width());
 }
 
@@ -76,6 +116,8 @@ void adagrad<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
   auto* opt = proto.mutable_adagrad();
   opt->set_learn_rate(this->get_learning_rate());
   opt->set_eps(m_eps);
+  opt->set_state_format(
+    static_cast<lbann_data::OptimizerStateFormat>(m_state_format));
 }
 
 template <typename TensorDataType>
@@ -99,11 +141,42 @@ void adagrad<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+bool adagrad<TensorDataType>::add_fused_step_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  std::vector<fused_step_entry<TensorDataType>>& entries)
+{
+  if (m_compressed_cache != nullptr || !m_cache->Contiguous()) {
+    return false;
+  }
+  entries.push_back(
+    {values.Buffer(),
+     gradient.LockedBuffer(),
+     {m_cache->Buffer(), nullptr},
+     static_cast<size_t>(values.LocalHeight() * values.LocalWidth()),
+     {El::To<TensorDataType>(this->get_learning_rate()),
+      m_eps,
+      TensorDataType(0.),
+      TensorDataType(0.)}});
+  return true;
+}
+
 template <typename TensorDataType>
 void adagrad<TensorDataType>::step_compute_cpu(
   AbsDistMatrixType& values,
   const AbsDistMatrixType& gradient)
 {
+  if (m_compressed_cache != nullptr) {
+    const auto learning_rate =
+      El::To<TensorDataType>(this->get_learning_rate());
+    internal::compressed_step_cpu(
+      adagrad_compressed_op<TensorDataType>{learning_rate, m_eps},
+      values.Matrix(),
+      gradient.LockedMatrix(),
+      internal::compressed_states<1>{{m_compressed_cache->get_view()}});
+    return;
+  }
 
   // Get local matrix data
   const size_t local_height = values.LocalHeight();
@@ -117,16 +190,34 @@ void adagrad<TensorDataType>::step_compute_cpu(
 
   // Apply AdaGrad step
   const auto learning_rate = El::To<TensorDataType>(this->get_learning_rate());
-  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
-  for (size_t col = 0; col < local_width; ++col) {
-    for (size_t row = 0; row < local_height; ++row) {
-      auto& x = values_buffer[row + col * values_ldim];
-      const auto& g = gradient_buffer[row + col * gradient_ldim];
-      auto& c = cache_buffer[row + col * cache_ldim];
+  if (values.Contiguous() && gradient.Contiguous() &&
+      m_cache->Contiguous()) {
+
+    // Update with contiguous data
+    const size_t local_size = local_height * local_width;
+    LBANN_OMP_PARALLEL_FOR_SIMD
+    for (size_t i = 0; i < local_size; ++i) {
+      auto& x = values_buffer[i];
+      const auto& g = gradient_buffer[i];
+      auto& c = cache_buffer[i];
       c += g * g;
       x -= learning_rate * g / (El::Sqrt(c) + m_eps);
     }
   }
+  else {
+
+    // Update with non-contiguous data
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        auto& x = values_buffer[row + col * values_ldim];
+        const auto& g = gradient_buffer[row + col * gradient_ldim];
+        auto& c = cache_buffer[row + col * cache_ldim];
+        c += g * g;
+        x -= learning_rate * g / (El::Sqrt(c) + m_eps);
+      }
+    }
+  }
 }
 
 template <typename TensorDataType>
@@ -136,7 +227,8 @@ build_adagrad_optimizer_from_pbuf(google::protobuf::Message const& msg)
   const auto& params = dynamic_cast<lbann_data::Optimizer::AdaGrad const&>(msg);
   return std::make_unique<adagrad<TensorDataType>>(
     TensorDataType(params.learn_rate()),
-    TensorDataType(params.eps()));
+    TensorDataType(params.eps()),
+    static_cast<optimizer_state_format>(params.state_format()));
 }
 
 #define PROTO(T)                                                               \
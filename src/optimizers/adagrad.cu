@@ -27,6 +27,9 @@
 #include "lbann/optimizers/adagrad.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "compressed_step.hpp"
+#include "multi_tensor_apply.cuh"
+
 namespace lbann {
 
 namespace {
@@ -56,8 +59,64 @@ __global__ void adagrad_kernel(size_t height,
   }
 }
 
+/** @brief AdaGrad update of one entry in a fused step
+ *  @details The scalars are the learning rate and eps. The state is
+ *  the cache.
+ */
+template <typename TensorDataType>
+struct adagrad_fused_op
+{
+  fused_step_rounding rounding;
+  __device__ void operator()(fused_step_entry<TensorDataType> const& entry,
+                             size_t pos) const
+  {
+    const auto& learning_rate = entry.scalars[0];
+    const auto& eps = entry.scalars[1];
+    auto& x = entry.values[pos];
+    const auto g = (entry.gradient[pos] * entry.gradient_scale +
+                    entry.l2_scale * x);
+    auto& c = entry.state[0][pos];
+    c += g * g;
+    x = internal::fused_step_update(rounding,
+                                    pos,
+                                    x,
+                                    entry.decay_scale,
+                                    learning_rate * g /
+                                      (gpu_lib::sqrt(c) + eps));
+  }
+};
+
+/** @brief AdaGrad update of one entry with a compressed cache
+ *  @details The state is the cache.
+ */
+template <typename TensorDataType>
+struct adagrad_compressed_op
+{
+  TensorDataType learning_rate;
+  TensorDataType eps;
+  __device__ void operator()(TensorDataType& x,
+                             const TensorDataType& g,
+                             TensorDataType* cache) const
+  {
+    auto& c = cache[0];
+    c += g * g;
+    x -= learning_rate * g / (gpu_lib::sqrt(c) + eps);
+  }
+};
+
 } // namespace
 
+template <typename TensorDataType>
+void adagrad<TensorDataType>::fused_step_gpu(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  internal::multi_tensor_apply(
+    adagrad_fused_op<TensorDataType>{this->next_fused_step_rounding()},
+    entries,
+    sync_info);
+}
+
 template <typename TensorDataType>
 void adagrad<TensorDataType>::step_compute_gpu(
   AbsDistMatrixType& values,
@@ -66,6 +125,16 @@ void adagrad<TensorDataType>::step_compute_gpu(
   const size_t local_height = values.LocalHeight();
   const size_t local_width = values.LocalWidth();
   const size_t local_size = local_height * local_width;
+  if (m_compressed_cache != nullptr) {
+    const auto learning_rate =
+      El::To<TensorDataType>(this->get_learning_rate());
+    internal::compressed_step_gpu(
+      adagrad_compressed_op<TensorDataType>{learning_rate, m_eps},
+      values.Matrix(),
+      gradient.LockedMatrix(),
+      internal::compressed_states<1>{{m_compressed_cache->get_view()}});
+    return;
+  }
   if (local_size > 0) {
     auto multisync = El::MakeMultiSync(gpu::get_sync_info(values),
                                        gpu::get_sync_info(gradient));
@@ -96,11 +165,22 @@ void adagrad<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+template <>
+void adagrad<cpu_fp16>::fused_step_gpu(
+  std::vector<fused_step_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
-  template void adagrad<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,       \
-                                             const El::AbstractDistMatrix<T>&)
+  template void adagrad<T>::step_compute_gpu(                                  \
+    El::AbstractDistMatrix<T>&,                                                \
+    const El::AbstractDistMatrix<T>&);                                         \
+  template void adagrad<T>::fused_step_gpu(                                    \
+    std::vector<fused_step_entry<T>> const&,                                   \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
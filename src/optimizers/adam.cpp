@@ -31,14 +31,52 @@
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/options.hpp"
 
+#include "compressed_step.hpp"
+
 namespace lbann {
 
+namespace {
+
+/** @brief Adam update of one entry with compressed moment estimates
+ *  @details The states are the moment estimates.
+ */
+template <typename TensorDataType>
+struct adam_compressed_op
+{
+  TensorDataType correction;
+  TensorDataType eps;
+  TensorDataType beta1;
+  TensorDataType beta2;
+  void operator()(TensorDataType& x,
+                  const TensorDataType& gradient,
+                  TensorDataType* moments) const
+  {
+    static const auto one = TensorDataType(1.);
+    const auto& g = gradient + eps; // Avoid denormalized floats
+    if (std::isinf(g) || std::isnan(g)) {
+      return;
+    }
+    auto& m1 = moments[0];
+    auto& m2 = moments[1];
+    m1 = beta1 * m1 + (one - beta1) * g;
+    m2 = beta2 * m2 + (one - beta2) * g * g;
+    x -= correction * m1 / (El::Sqrt(m2) + eps);
+  }
+};
+
+} // namespace
+
 template <typename TensorDataType>
 adam<TensorDataType>::adam(TensorDataType learning_rate,
                            TensorDataType beta1,
                            TensorDataType beta2,
-                           TensorDataType eps)
-  : BaseType(learning_rate), m_beta1(beta1), m_beta2(beta2), m_eps(eps)
+                           TensorDataType eps,
+                           optimizer_state_format state_format)
+  : BaseType(learning_rate),
+    m_beta1(beta1),
+    m_beta2(beta2),
+    m_eps(eps),
+    m_state_format(state_format)
 {}
 
 template <typename TensorDataType>
@@ -50,7 +88,14 @@ adam<TensorDataType>::adam(const adam& other)
     m_current_beta1(other.m_current_beta1),
     m_current_beta2(other.m_current_beta2),
     m_moment1(other.m_moment1 ? other.m_moment1->Copy() : nullptr),
-    m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr)
+    m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr),
+    m_state_format(other.m_state_format),
+    m_compressed_moment1(other.m_compressed_moment1
+                           ? new compressed_state(*other.m_compressed_moment1)
+                           : nullptr),
+    m_compressed_moment2(other.m_compressed_moment2
+                           ? new compressed_state(*other.m_compressed_moment2)
+                           : nullptr)
 {}
 
 template <typename TensorDataType>
@@ -65,6 +110,15 @@ adam<TensorDataType>::operator=(const adam<TensorDataType>& other)
   m_current_beta2 = other.m_current_beta2;
   m_moment1.reset(other.m_moment1 ? other.m_moment1->Copy() : nullptr);
   m_moment2.reset(other.m_moment2 ? other.m_moment2->Copy() : nullptr);
+  m_state_format = other.m_state_format;
+  m_compressed_moment1.reset(
+    other.m_compressed_moment1
+      ? new compressed_state(*other.m_compressed_moment1)
+      : nullptr);
+  m_compressed_moment2.reset(
+    other.m_compressed_moment2
+      ? new compressed_state(*other.m_compressed_moment2)
+      : nullptr);
   return *this;
 }
 
@@ -75,6 +129,7 @@ description adam<TensorDataType>::get_description() const
   desc.add("beta1", m_beta1);
   desc.add("beta2", m_beta2);
   desc.add("eps", m_eps);
+  desc.add("State format", to_string(m_state_format));
   return desc;
 }
 
@@ -129,6 +184,15 @@ void adam<TensorDataType>::setup(WeightsType* w)
     }
   }
 #endif // LBANN_HAS_GPU
+  if (m_state_format != optimizer_state_format::full) {
+    m_compressed_moment1 =
+      std::make_unique<compressed_state>(m_state_format, true);
+    m_compressed_moment2 =
+      std::make_unique<compressed_state>(m_state_format, false);
+    m_compressed_moment1->setup(gradient);
+    m_compressed_moment2->setup(gradient);
+    return;
+  }
   El::Zeros(*m_moment1, gradient.Height(), gradient.Width());
   El::Zeros(*m_moment2, gradient.Height(), gradient.Width());
 }
@@ -141,20 +205,27 @@ void adam<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
   opt->set_beta1(m_beta1);
   opt->set_beta2(m_beta2);
   opt->set_eps(m_eps);
+  opt->set_state_format(
+    static_cast<lbann_data::OptimizerStateFormat>(m_state_format));
 }
 
 template <typename TensorDataType>
-void adam<TensorDataType>::step_compute(AbsDistMatrixType& values,
-                                        const AbsDistMatrixType& gradient)
+TensorDataType adam<TensorDataType>::advance_correction()
 {
   static const auto one = TensorDataType(1.);
 
   // Precompute the bias correction and learning rate.
   m_current_beta1 *= m_beta1;
   m_current_beta2 *= m_beta2;
-  const TensorDataType correction =
-    El::To<TensorDataType>(this->get_learning_rate()) *
-    (El::Sqrt(one - m_current_beta2) / (one - m_current_beta1));
+  return El::To<TensorDataType>(this->get_learning_rate()) *
+         (El::Sqrt(one - m_current_beta2) / (one - m_current_beta1));
+}
+
+template <typename TensorDataType>
+void adam<TensorDataType>::step_compute(AbsDistMatrixType& values,
+                                        const AbsDistMatrixType& gradient)
+{
+  const TensorDataType correction = advance_correction();
 
   switch (values.GetLocalDevice()) {
   case El::Device::CPU:
@@ -173,6 +244,26 @@ void adam<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+bool adam<TensorDataType>::add_fused_step_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  std::vector<fused_step_entry<TensorDataType>>& entries)
+{
+  if (m_compressed_moment1 != nullptr || !m_moment1->Contiguous() ||
+      !m_moment2->Contiguous()) {
+    return false;
+  }
+  const TensorDataType correction = advance_correction();
+  entries.push_back({values.Buffer(),
+                     gradient.LockedBuffer(),
+                     {m_moment1->Buffer(), m_moment2->Buffer()},
+                     static_cast<size_t>(values.LocalHeight() *
+                                         values.LocalWidth()),
+                     {correction, m_eps, m_beta1, m_beta2}});
+  return true;
+}
+
 template <typename TensorDataType>
 void adam<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient,
@@ -180,6 +271,16 @@ void adam<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
 {
   static const auto one = TensorDataType(1.);
 
+  if (m_compressed_moment1 != nullptr) {
+    internal::compressed_step_cpu(
+      adam_compressed_op<TensorDataType>{correction, m_eps, m_beta1, m_beta2},
+      values.Matrix(),
+      gradient.LockedMatrix(),
+      internal::compressed_states<2>{{m_compressed_moment1->get_view(),
+                                      m_compressed_moment2->get_view()}});
+    return;
+  }
+
   // Get local matrix data
   const size_t local_height = values.LocalHeight();
   const size_t local_width = values.LocalWidth();
@@ -191,20 +292,22 @@ void adam<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
   if (values.Contiguous() && gradient.Contiguous() && m_moment1->Contiguous() &&
       m_moment2->Contiguous()) {
 
-    // Update with contiguous data
+    // Update with contiguous data. Non-finite gradients are masked
+    // out rather than skipped, so the loop vectorizes.
     const size_t local_size = local_height * local_width;
-    LBANN_OMP_PARALLEL_FOR
+    LBANN_OMP_PARALLEL_FOR_SIMD
     for (size_t i = 0; i < local_size; ++i) {
       auto& x = values_buffer[i];
       const auto& g = gradient_buffer[i] + m_eps; // Avoid denormalized floats
-      if (std::isinf(g) || std::isnan(g)) {
-        continue;
-      }
+      const bool finite = std::isfinite(g);
       auto& m1 = moment1_buffer[i];
       auto& m2 = moment2_buffer[i];
-      m1 = m_beta1 * m1 + (one - m_beta1) * g;
-      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
-      x -= correction * m1 / (El::Sqrt(m2) + m_eps);
+      const auto new_m1 = m_beta1 * m1 + (one - m_beta1) * g;
+      const auto new_m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+      const auto new_x = x - correction * new_m1 / (El::Sqrt(new_m2) + m_eps);
+      m1 = finite ? new_m1 : m1;
+      m2 = finite ? new_m2 : m2;
+      x = finite ? new_x : x;
     }
   }
   else {
@@ -242,7 +345,8 @@ build_adam_optimizer_from_pbuf(google::protobuf::Message const& msg)
     TensorDataType(params.learn_rate()),
     TensorDataType(params.beta1()),
     TensorDataType(params.beta2()),
-    TensorDataType(params.eps()));
+    TensorDataType(params.eps()),
+    static_cast<optimizer_state_format>(params.state_format()));
 }
 
 #define PROTO(T)                                                               \
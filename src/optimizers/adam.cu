@@ -27,6 +27,9 @@
 #include "lbann/optimizers/adam.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "compressed_step.hpp"
+#include "multi_tensor_apply.cuh"
+
 namespace lbann {
 
 namespace {
@@ -92,8 +95,79 @@ adam_contiguous_kernel(size_t size,
   }
 }
 
+/** @brief Adam update of one entry in a fused step
+ *  @details The scalars are the correction, eps, beta1 and beta2. The
+ *  states are the moment estimates.
+ */
+template <typename TensorDataType>
+struct adam_fused_op
+{
+  fused_step_rounding rounding;
+  __device__ void operator()(fused_step_entry<TensorDataType> const& entry,
+                             size_t pos) const
+  {
+    const auto& correction = entry.scalars[0];
+    const auto& eps = entry.scalars[1];
+    const auto& beta1 = entry.scalars[2];
+    const auto& beta2 = entry.scalars[3];
+    auto& x = entry.values[pos];
+    const auto g = (entry.gradient[pos] * entry.gradient_scale +
+                    entry.l2_scale * x + eps);
+    if (gpu_lib::isinf(g) || gpu_lib::isnan(g)) {
+      return;
+    }
+    auto& m1 = entry.state[0][pos];
+    auto& m2 = entry.state[1][pos];
+    m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
+    m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
+    x = internal::fused_step_update(rounding,
+                                    pos,
+                                    x,
+                                    entry.decay_scale,
+                                    correction * m1 /
+                                      (gpu_lib::sqrt(m2) + eps));
+  }
+};
+
+/** @brief Adam update of one entry with compressed moment estimates
+ *  @details The states are the moment estimates.
+ */
+template <typename TensorDataType>
+struct adam_compressed_op
+{
+  TensorDataType correction;
+  TensorDataType eps;
+  TensorDataType beta1;
+  TensorDataType beta2;
+  __device__ void operator()(TensorDataType& x,
+                             const TensorDataType& gradient,
+                             TensorDataType* moments) const
+  {
+    const auto& g = gradient + eps;
+    if (gpu_lib::isinf(g) || gpu_lib::isnan(g)) {
+      return;
+    }
+    auto& m1 = moments[0];
+    auto& m2 = moments[1];
+    m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
+    m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
+    x -= correction * m1 / (gpu_lib::sqrt(m2) + eps);
+  }
+};
+
 } // namespace
 
+template <typename TensorDataType>
+void adam<TensorDataType>::fused_step_gpu(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  internal::multi_tensor_apply(
+    adam_fused_op<TensorDataType>{this->next_fused_step_rounding()},
+    entries,
+    sync_info);
+}
+
 template <typename TensorDataType>
 void adam<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient,
@@ -107,6 +181,16 @@ void adam<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
     return;
   }
 
+  if (m_compressed_moment1 != nullptr) {
+    internal::compressed_step_gpu(
+      adam_compressed_op<TensorDataType>{correction, m_eps, m_beta1, m_beta2},
+      values.Matrix(),
+      gradient.LockedMatrix(),
+      internal::compressed_states<2>{{m_compressed_moment1->get_view(),
+                                      m_compressed_moment2->get_view()}});
+    return;
+  }
+
   // Launch GPU kernel
   constexpr size_t block_size = 256;
   const size_t grid_size = (local_size + block_size - 1) / block_size;
@@ -160,12 +244,22 @@ void adam<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+template <>
+void adam<cpu_fp16>::fused_step_gpu(
+  std::vector<fused_step_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
   template void adam<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,          \
                                           const El::AbstractDistMatrix<T>&,    \
-                                          const T&)
+                                          const T&);                           \
+  template void adam<T>::fused_step_gpu(                                       \
+    std::vector<fused_step_entry<T>> const&,                                   \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
@@ -0,0 +1,235 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/compressed_state.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <algorithm>
+#include <type_traits>
+
+namespace lbann {
+
+namespace {
+
+std::unique_ptr<El::AbstractMatrix<float>> make_matrix(El::Device device)
+{
+  switch (device) {
+  case El::Device::CPU:
+    return std::make_unique<El::Matrix<float, El::Device::CPU>>();
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return std::make_unique<El::Matrix<float, El::Device::GPU>>();
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("unsupported device type (", to_string(device), ")");
+  }
+  return nullptr;
+}
+
+std::unique_ptr<El::AbstractMatrix<float>>
+copy_matrix(const El::AbstractMatrix<float>& other)
+{
+  auto mat = make_matrix(other.GetDevice());
+  El::Copy(other, *mat);
+  return mat;
+}
+
+} // namespace
+
+std::string to_string(optimizer_state_format f)
+{
+  switch (f) {
+  case optimizer_state_format::full:
+    return "full";
+  case optimizer_state_format::bf16:
+    return "bf16";
+  case optimizer_state_format::int8:
+    return "int8";
+  }
+  return "invalid optimizer_state_format";
+}
+
+compressed_state::compressed_state(optimizer_state_format format,
+                                   bool is_signed)
+  : m_format(format),
+    m_signed(is_signed),
+    m_codes(make_matrix(El::Device::CPU)),
+    m_scales(make_matrix(El::Device::CPU))
+{
+  if (m_format == optimizer_state_format::full) {
+    LBANN_ERROR("compressed optimizer state needs a bf16 or int8 format");
+  }
+}
+
+compressed_state::compressed_state(const compressed_state& other)
+  : m_format(other.m_format),
+    m_signed(other.m_signed),
+    m_global_height(other.m_global_height),
+    m_global_width(other.m_global_width),
+    m_height(other.m_height),
+    m_width(other.m_width),
+    m_size(other.m_size),
+    m_codes(copy_matrix(*other.m_codes)),
+    m_scales(copy_matrix(*other.m_scales))
+{}
+
+compressed_state& compressed_state::operator=(const compressed_state& other)
+{
+  m_format = other.m_format;
+  m_signed = other.m_signed;
+  m_global_height = other.m_global_height;
+  m_global_width = other.m_global_width;
+  m_height = other.m_height;
+  m_width = other.m_width;
+  m_size = other.m_size;
+  m_codes = copy_matrix(*other.m_codes);
+  m_scales = copy_matrix(*other.m_scales);
+  return *this;
+}
+
+size_t compressed_state::get_memory_usage() const
+{
+  return sizeof(float) * (m_codes->Height() + m_scales->Height());
+}
+
+compressed_state_view compressed_state::get_view()
+{
+  return {m_codes->Buffer(),
+          m_scales->IsEmpty() ? nullptr : m_scales->Buffer(),
+          m_format,
+          m_signed};
+}
+
+template <typename TensorDataType>
+void compressed_state::setup(const El::AbstractDistMatrix<TensorDataType>& like)
+{
+  if constexpr (!std::is_same_v<TensorDataType, float> &&
+                !std::is_same_v<TensorDataType, double>) {
+    LBANN_ERROR("optimizer state can only be stored as ",
+                to_string(m_format),
+                " for float or double weights");
+  }
+  m_global_height = like.Height();
+  m_global_width = like.Width();
+  m_height = like.LocalHeight();
+  m_width = like.LocalWidth();
+  m_size = m_height * m_width;
+  const size_t code_bytes =
+    m_size * (m_format == optimizer_state_format::bf16 ? 2 : 1);
+  const size_t num_blocks =
+    (m_size + compressed_state_block_size - 1) / compressed_state_block_size;
+  m_codes = make_matrix(like.GetLocalDevice());
+  m_scales = make_matrix(like.GetLocalDevice());
+  El::Zeros(*m_codes, (code_bytes + sizeof(float) - 1) / sizeof(float), 1);
+  if (m_format == optimizer_state_format::int8) {
+    El::Zeros(*m_scales, num_blocks, 1);
+  }
+}
+
+template <typename TensorDataType>
+void compressed_state::compress(El::AbstractDistMatrix<TensorDataType>& state)
+{
+  setup(state);
+
+  // Encode on the host, since this is only done for checkpoints
+  El::Matrix<TensorDataType, El::Device::CPU> state_cpu;
+  El::Copy(state.LockedMatrix(), state_cpu);
+  El::Matrix<float, El::Device::CPU> codes(m_codes->Height(), 1);
+  El::Matrix<float, El::Device::CPU> scales(m_scales->Height(), 1);
+  const compressed_state_view view = {codes.Buffer(),
+                                      scales.IsEmpty() ? nullptr
+                                                       : scales.Buffer(),
+                                      m_format,
+                                      m_signed};
+  auto entry = [&](size_t pos) {
+    return El::To<float>(state_cpu(pos % m_height, pos / m_height));
+  };
+  const size_t num_blocks =
+    (m_size + compressed_state_block_size - 1) / compressed_state_block_size;
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const size_t begin = block * compressed_state_block_size;
+    const size_t end =
+      std::min(begin + compressed_state_block_size, m_size);
+    float scale = 0.f;
+    for (size_t pos = begin; pos < end; ++pos) {
+      scale = std::max(scale, view.magnitude(entry(pos)));
+    }
+    if (view.scales != nullptr) {
+      view.scales[block] = scale;
+    }
+    for (size_t pos = begin; pos < end; ++pos) {
+      view.encode(pos, entry(pos), scale);
+    }
+  }
+  El::Copy(codes, *m_codes);
+  El::Copy(scales, *m_scales);
+  state.Empty();
+}
+
+template <typename TensorDataType>
+void compressed_state::decompress(
+  El::AbstractDistMatrix<TensorDataType>& state) const
+{
+  state.Resize(m_global_height, m_global_width);
+  if (state.LocalHeight() != m_height || state.LocalWidth() != m_width) {
+    LBANN_ERROR("attempted to decompress a ",
+                m_height,
+                " x ",
+                m_width,
+                " local optimizer state into a ",
+                state.LocalHeight(),
+                " x ",
+                state.LocalWidth(),
+                " local matrix");
+  }
+  El::Matrix<float, El::Device::CPU> codes, scales;
+  El::Copy(*m_codes, codes);
+  El::Copy(*m_scales, scales);
+  const compressed_state_view view = {codes.Buffer(),
+                                      scales.IsEmpty() ? nullptr
+                                                       : scales.Buffer(),
+                                      m_format,
+                                      m_signed};
+  El::Matrix<TensorDataType, El::Device::CPU> state_cpu(m_height, m_width);
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t pos = 0; pos < m_size; ++pos) {
+    state_cpu(pos % m_height, pos / m_height) =
+      El::To<TensorDataType>(view.decode(pos));
+  }
+  El::Copy(state_cpu, state.Matrix());
+}
+
+#define PROTO(T)                                                               \
+  template void compressed_state::setup(const El::AbstractDistMatrix<T>&);     \
+  template void compressed_state::compress(El::AbstractDistMatrix<T>&);        \
+  template void compressed_state::decompress(El::AbstractDistMatrix<T>&) const
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,205 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_OPTIMIZERS_COMPRESSED_STEP_HPP_INCLUDED
+#define LBANN_SRC_OPTIMIZERS_COMPRESSED_STEP_HPP_INCLUDED
+
+#include "lbann/base.hpp"
+#include "lbann/optimizers/compressed_state.hpp"
+
+#if defined __CUDACC__ || defined __HIPCC__
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // defined __CUDACC__ || defined __HIPCC__
+
+#include <algorithm>
+
+namespace lbann {
+namespace internal {
+
+/** @brief Compressed state tensors of an optimizer
+ *  @details Passed by value to the update kernel.
+ */
+template <int NumStates>
+struct compressed_states
+{
+  compressed_state_view views[NumStates];
+};
+
+/** @brief Apply an entrywise update with compressed optimizer state
+ *         on the CPU
+ *
+ *  Each block of state entries is decoded, updated with
+ *  @c op(x, g, state), and encoded again with the new scale of the
+ *  block.
+ */
+template <int NumStates, typename TensorDataType, typename Op>
+void compressed_step_cpu(Op const& op,
+                         El::AbstractMatrix<TensorDataType>& values,
+                         const El::AbstractMatrix<TensorDataType>& gradient,
+                         compressed_states<NumStates> const& states)
+{
+  constexpr size_t block_size = compressed_state_block_size;
+  const size_t height = values.Height();
+  const size_t size = height * values.Width();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const size_t values_ldim = values.LDim();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  const size_t gradient_ldim = gradient.LDim();
+  const size_t num_blocks = (size + block_size - 1) / block_size;
+  LBANN_OMP_PARALLEL_FOR
+  for (size_t block = 0; block < num_blocks; ++block) {
+    const size_t begin = block * block_size;
+    const size_t end = std::min(begin + block_size, size);
+    float updated[NumStates][block_size];
+    for (size_t pos = begin; pos < end; ++pos) {
+      const size_t row = pos % height;
+      const size_t col = pos / height;
+      auto& x = values_buffer[row + col * values_ldim];
+      const auto& g = gradient_buffer[row + col * gradient_ldim];
+      TensorDataType state[NumStates];
+      for (int s = 0; s < NumStates; ++s) {
+        state[s] = El::To<TensorDataType>(states.views[s].decode(pos));
+      }
+      op(x, g, state);
+      for (int s = 0; s < NumStates; ++s) {
+        updated[s][pos - begin] = El::To<float>(state[s]);
+      }
+    }
+    for (int s = 0; s < NumStates; ++s) {
+      const auto& view = states.views[s];
+      float scale = 0.f;
+      for (size_t pos = begin; pos < end; ++pos) {
+        scale = std::max(scale, view.magnitude(updated[s][pos - begin]));
+      }
+      if (view.scales != nullptr) {
+        view.scales[block] = scale;
+      }
+      for (size_t pos = begin; pos < end; ++pos) {
+        view.encode(pos, updated[s][pos - begin], scale);
+      }
+    }
+  }
+}
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+/** @brief Apply an entrywise update with compressed optimizer state
+ *  @details Each thread block handles one block of state entries, one
+ *  entry per thread, so the new scale is a block reduction.
+ */
+template <int NumStates, typename TensorDataType, typename Op>
+__global__ void
+compressed_step_kernel(Op op,
+                       size_t height,
+                       size_t size,
+                       TensorDataType* __restrict__ values,
+                       size_t values_ldim,
+                       const TensorDataType* __restrict__ gradient,
+                       size_t gradient_ldim,
+                       compressed_states<NumStates> states)
+{
+  constexpr size_t block_size = compressed_state_block_size;
+  const size_t tid = threadIdx.x;
+  const size_t num_blocks = (size + block_size - 1) / block_size;
+  __shared__ float shared_scale[block_size];
+  for (size_t block = blockIdx.x; block < num_blocks; block += gridDim.x) {
+    const size_t pos = block * block_size + tid;
+    const bool active = pos < size;
+    TensorDataType state[NumStates];
+    if (active) {
+      const size_t row = pos % height;
+      const size_t col = pos / height;
+      for (int s = 0; s < NumStates; ++s) {
+        state[s] = TensorDataType(states.views[s].decode(pos));
+      }
+      op(values[row + col * values_ldim],
+         gradient[row + col * gradient_ldim],
+         state);
+    }
+    for (int s = 0; s < NumStates; ++s) {
+      const auto& view = states.views[s];
+      const float x = active ? float(state[s]) : 0.f;
+      shared_scale[tid] = active ? view.magnitude(x) : 0.f;
+      for (size_t stride = block_size / 2; stride > 0; stride /= 2) {
+        __syncthreads();
+        if (tid < stride) {
+          shared_scale[tid] =
+            fmaxf(shared_scale[tid], shared_scale[tid + stride]);
+        }
+      }
+      __syncthreads();
+      const float scale = shared_scale[0];
+      if (tid == 0 && view.scales != nullptr) {
+        view.scales[block] = scale;
+      }
+      if (active) {
+        view.encode(pos, x, scale);
+      }
+      __syncthreads();
+    }
+  }
+}
+
+/** Launch @c compressed_step_kernel on the stream of the values */
+template <int NumStates, typename TensorDataType, typename Op>
+void compressed_step_gpu(Op const& op,
+                         El::AbstractMatrix<TensorDataType>& values,
+                         const El::AbstractMatrix<TensorDataType>& gradient,
+                         compressed_states<NumStates> const& states)
+{
+  const size_t height = values.Height();
+  const size_t size = height * values.Width();
+  if (size == 0) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(values),
+                                     gpu::get_sync_info(gradient));
+  dim3 block_dims, grid_dims;
+  block_dims.x = compressed_state_block_size;
+  grid_dims.x = (size + block_dims.x - 1) / block_dims.x;
+  gpu_lib::clip_grid_dims(grid_dims);
+  hydrogen::gpu::LaunchKernel(
+    compressed_step_kernel<NumStates, TensorDataType, Op>,
+    grid_dims,
+    block_dims,
+    0,
+    multisync,
+    op,
+    height,
+    size,
+    values.Buffer(),
+    static_cast<size_t>(values.LDim()),
+    gradient.LockedBuffer(),
+    static_cast<size_t>(gradient.LDim()),
+    states);
+}
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+
+} // namespace internal
+} // namespace lbann
+
+#endif // LBANN_SRC_OPTIMIZERS_COMPRESSED_STEP_HPP_INCLUDED
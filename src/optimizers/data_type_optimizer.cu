@@ -0,0 +1,70 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/data_type_optimizer.hpp"
+
+#include "multi_tensor_apply.cuh"
+
+namespace lbann {
+
+template <typename TensorDataType>
+EvalType data_type_optimizer<TensorDataType>::gradient_sqsum_gpu(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  El::Matrix<EvalType, El::Device::GPU> sqsum;
+#ifdef HYDROGEN_HAVE_CUB
+  sqsum.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                    // HYDROGEN_HAVE_CUB
+  El::SetSyncInfo(sqsum, sync_info);
+  El::Zeros(sqsum, 1, 1);
+  internal::multi_tensor_sqsum(entries, sqsum.Buffer(), sync_info);
+  EvalType value = 0;
+  hydrogen::gpu::Copy1DToHost(sqsum.LockedBuffer(), &value, 1, sync_info);
+  El::Synchronize(sync_info);
+  return value;
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+EvalType data_type_optimizer<cpu_fp16>::gradient_sqsum_gpu(
+  std::vector<fused_step_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+  return 0;
+}
+#endif // LBANN_HAS_HALF
+
+#define PROTO(T)                                                               \
+  template EvalType data_type_optimizer<T>::gradient_sqsum_gpu(                \
+    std::vector<fused_step_entry<T>> const&,                                   \
+    El::SyncInfo<El::Device::GPU> const&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
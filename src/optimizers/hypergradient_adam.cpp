@@ -63,7 +63,11 @@ hypergradient_adam<TensorDataType>::hypergradient_adam(
     m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr),
     m_old_gradient(other.m_old_gradient ? other.m_old_gradient->Copy()
                                         : nullptr)
-{}
+{
+#ifdef LBANN_HAS_GPU
+  El::Copy(other.m_device_learning_rate, m_device_learning_rate);
+#endif // LBANN_HAS_GPU
+}
 
 template <typename TensorDataType>
 hypergradient_adam<TensorDataType>&
@@ -81,6 +85,9 @@ hypergradient_adam<TensorDataType>::operator=(
   m_moment2.reset(other.m_moment2 ? other.m_moment2->Copy() : nullptr);
   m_old_gradient.reset(other.m_old_gradient ? other.m_old_gradient->Copy()
                                             : nullptr);
+#ifdef LBANN_HAS_GPU
+  El::Copy(other.m_device_learning_rate, m_device_learning_rate);
+#endif // LBANN_HAS_GPU
   return *this;
 }
 
@@ -95,6 +102,31 @@ description hypergradient_adam<TensorDataType>::get_description() const
   return desc;
 }
 
+template <typename TensorDataType>
+double hypergradient_adam<TensorDataType>::get_learning_rate() const
+{
+#ifdef LBANN_HAS_GPU
+  if (m_device_learning_rate.Height() > 0) {
+    El::Matrix<EvalType, El::Device::CPU> learning_rate;
+    El::Copy(m_device_learning_rate, learning_rate);
+    return learning_rate(0, 0);
+  }
+#endif // LBANN_HAS_GPU
+  return OptimizerType::get_learning_rate();
+}
+
+template <typename TensorDataType>
+void hypergradient_adam<TensorDataType>::set_learning_rate(
+  double learning_rate)
+{
+  OptimizerType::set_learning_rate(learning_rate);
+#ifdef LBANN_HAS_GPU
+  if (m_device_learning_rate.Height() > 0) {
+    El::Fill(m_device_learning_rate, El::To<EvalType>(learning_rate));
+  }
+#endif // LBANN_HAS_GPU
+}
+
 template <typename TensorDataType>
 void hypergradient_adam<TensorDataType>::setup(WeightsType* w)
 {
@@ -125,10 +157,6 @@ void hypergradient_adam<TensorDataType>::step_compute(
   AbsDistMatrixType& values,
   const AbsDistMatrixType& gradient)
 {
-  if (values.GetLocalDevice() != El::Device::CPU) {
-    LBANN_ERROR("hypergradient Adam is only supported on CPU");
-  }
-
   // Precompute the bias correction.
   m_current_beta1 *= m_beta1;
   m_current_beta2 *= m_beta2;
@@ -136,6 +164,29 @@ void hypergradient_adam<TensorDataType>::step_compute(
     El::Sqrt(TensorDataType(1.) - m_current_beta2) /
     (TensorDataType(1.) - m_current_beta1);
 
+  switch (values.GetLocalDevice()) {
+  case El::Device::CPU:
+    step_compute_cpu(values, gradient, correction);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    step_compute_gpu(values, gradient, correction);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    std::ostringstream err;
+    err << "unsupported device type "
+        << "(" << static_cast<int>(values.GetLocalDevice()) << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+template <typename TensorDataType>
+void hypergradient_adam<TensorDataType>::step_compute_cpu(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  const TensorDataType& correction)
+{
   // Get local matrix data
   const size_t local_height = values.LocalHeight();
   const size_t local_width = values.LocalWidth();
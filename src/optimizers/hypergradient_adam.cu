@@ -0,0 +1,224 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/hypergradient_adam.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Local contribution to the dot product of the gradient and of the
+ *  prior gradient estimate */
+template <size_t block_size, typename TensorDataType>
+__global__ void dot_kernel(size_t height,
+                           size_t width,
+                           const TensorDataType* __restrict__ gradient,
+                           size_t gradient_ldim,
+                           const TensorDataType* __restrict__ old_gradient,
+                           size_t old_gradient_ldim,
+                           EvalType* __restrict__ dot)
+{
+  const size_t tid = threadIdx.x;
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+
+  // Compute contributions for each thread
+  EvalType thread_dot = 0;
+  for (size_t pos = gid; pos < height * width; pos += nthreads) {
+    const auto& row = pos % height;
+    const auto& col = pos / height;
+    const auto& g = gradient[row + col * gradient_ldim];
+    const auto& old_g = old_gradient[row + col * old_gradient_ldim];
+    thread_dot += static_cast<EvalType>(g) * static_cast<EvalType>(old_g);
+  }
+
+  // Shared memory reduction to get contribution for each block
+  __shared__ EvalType shared_dot[block_size];
+  shared_dot[tid] = thread_dot;
+  for (size_t stride = block_size / 2; stride > 0; stride /= 2) {
+    __syncthreads();
+    if (tid < stride) {
+      shared_dot[tid] += shared_dot[tid + stride];
+    }
+  }
+  if (tid == 0) {
+    gpu_lib::atomic_add(dot, shared_dot[0]);
+  }
+}
+
+/** Hypergradient update of the learning rate */
+__global__ void learning_rate_kernel(EvalType hyper_learning_rate,
+                                     const EvalType* __restrict__ dot,
+                                     EvalType* __restrict__ learning_rate)
+{
+  *learning_rate += hyper_learning_rate * (*dot);
+}
+
+/** Adam step with the learning rate on the device */
+template <typename TensorDataType>
+__global__ void
+hypergradient_adam_kernel(size_t height,
+                          size_t width,
+                          TensorDataType correction,
+                          TensorDataType eps,
+                          TensorDataType beta1,
+                          TensorDataType beta2,
+                          const EvalType* __restrict__ learning_rate,
+                          TensorDataType* __restrict__ values,
+                          size_t values_ldim,
+                          const TensorDataType* __restrict__ gradient,
+                          size_t gradient_ldim,
+                          TensorDataType* __restrict__ moment1,
+                          size_t moment1_ldim,
+                          TensorDataType* __restrict__ moment2,
+                          size_t moment2_ldim,
+                          TensorDataType* __restrict__ old_gradient,
+                          size_t old_gradient_ldim)
+{
+  const auto lr = static_cast<TensorDataType>(*learning_rate);
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * width; pos += nthreads) {
+    const auto& row = pos % height;
+    const auto& col = pos / height;
+    auto& x = values[row + col * values_ldim];
+    const auto g = gradient[row + col * gradient_ldim] + eps;
+    auto& m1 = moment1[row + col * moment1_ldim];
+    auto& m2 = moment2[row + col * moment2_ldim];
+    auto& old_c = old_gradient[row + col * old_gradient_ldim];
+    m1 = beta1 * m1 + (TensorDataType(1) - beta1) * g;
+    m2 = beta2 * m2 + (TensorDataType(1) - beta2) * g * g;
+    old_c = correction * m1 / (gpu_lib::sqrt(m2) + eps);
+    x -= lr * old_c;
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void hypergradient_adam<TensorDataType>::step_compute_gpu(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  const TensorDataType& correction)
+{
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  const size_t local_size = local_height * local_width;
+  auto sync_info = gpu::get_sync_info(values);
+  auto multisync =
+    El::MakeMultiSync(sync_info, gpu::get_sync_info(gradient));
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (local_size + block_size - 1) / block_size;
+
+  // Move the learning rate to the device on the first step
+  const bool first_step = (m_device_learning_rate.Height() == 0);
+  const auto learning_rate = (first_step ? this->get_learning_rate() : 0.);
+  El::SetSyncInfo(m_device_learning_rate, sync_info);
+  if (first_step) {
+    El::Zeros(m_device_learning_rate, 1, 1);
+    this->set_learning_rate(learning_rate);
+  }
+
+  // Hypergradient of the learning rate. It stays on the device, so
+  // the step does not wait on the host.
+  El::Matrix<EvalType, El::Device::GPU> dot;
+#ifdef HYDROGEN_HAVE_CUB
+  dot.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                  // HYDROGEN_HAVE_CUB
+  El::SetSyncInfo(dot, sync_info);
+  El::Zeros(dot, 1, 1);
+  if (local_size > 0) {
+    hydrogen::gpu::LaunchKernel(dot_kernel<block_size, TensorDataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                multisync,
+                                local_height,
+                                local_width,
+                                gradient.LockedBuffer(),
+                                gradient.LDim(),
+                                m_old_gradient->LockedBuffer(),
+                                m_old_gradient->LDim(),
+                                dot.Buffer());
+  }
+  El::mpi::AllReduce(dot.Buffer(), 1, values.DistComm(), sync_info);
+  hydrogen::gpu::LaunchKernel(learning_rate_kernel,
+                              1,
+                              1,
+                              0,
+                              sync_info,
+                              El::To<EvalType>(m_hyper_learning_rate),
+                              dot.LockedBuffer(),
+                              m_device_learning_rate.Buffer());
+
+  // Hypergradient Adam step
+  if (local_size > 0) {
+    hydrogen::gpu::LaunchKernel(hypergradient_adam_kernel<TensorDataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                multisync,
+                                local_height,
+                                local_width,
+                                correction,
+                                m_eps,
+                                m_beta1,
+                                m_beta2,
+                                m_device_learning_rate.LockedBuffer(),
+                                values.Buffer(),
+                                values.LDim(),
+                                gradient.LockedBuffer(),
+                                gradient.LDim(),
+                                m_moment1->Buffer(),
+                                m_moment1->LDim(),
+                                m_moment2->Buffer(),
+                                m_moment2->LDim(),
+                                m_old_gradient->Buffer(),
+                                m_old_gradient->LDim());
+  }
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void hypergradient_adam<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
+                                                    const AbsDistMatrixType&,
+                                                    const cpu_fp16&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+#endif // LBANN_HAS_HALF
+
+#define PROTO(T)                                                               \
+  template void hypergradient_adam<T>::step_compute_gpu(                       \
+    El::AbstractDistMatrix<T>&,                                                \
+    const El::AbstractDistMatrix<T>&,                                          \
+    const T&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lamb_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+namespace lbann {
+
+template <typename TensorDataType>
+lamb<TensorDataType>::lamb(TensorDataType learning_rate,
+                           TensorDataType beta1,
+                           TensorDataType beta2,
+                           TensorDataType eps,
+                           TensorDataType weight_decay)
+  : BaseType(learning_rate),
+    m_beta1(beta1),
+    m_beta2(beta2),
+    m_eps(eps),
+    m_weight_decay(weight_decay)
+{}
+
+template <typename TensorDataType>
+lamb<TensorDataType>::lamb(const lamb& other)
+  : BaseType(other),
+    m_beta1(other.m_beta1),
+    m_beta2(other.m_beta2),
+    m_eps(other.m_eps),
+    m_weight_decay(other.m_weight_decay),
+    m_current_beta1(other.m_current_beta1),
+    m_current_beta2(other.m_current_beta2),
+    m_moment1(other.m_moment1 ? other.m_moment1->Copy() : nullptr),
+    m_moment2(other.m_moment2 ? other.m_moment2->Copy() : nullptr)
+{}
+
+template <typename TensorDataType>
+lamb<TensorDataType>&
+lamb<TensorDataType>::operator=(const lamb<TensorDataType>& other)
+{
+  OptimizerType::operator=(other);
+  m_beta1 = other.m_beta1;
+  m_beta2 = other.m_beta2;
+  m_eps = other.m_eps;
+  m_weight_decay = other.m_weight_decay;
+  m_current_beta1 = other.m_current_beta1;
+  m_current_beta2 = other.m_current_beta2;
+  m_moment1.reset(other.m_moment1 ? other.m_moment1->Copy() : nullptr);
+  m_moment2.reset(other.m_moment2 ? other.m_moment2->Copy() : nullptr);
+  return *this;
+}
+
+template <typename TensorDataType>
+description lamb<TensorDataType>::get_description() const
+{
+  auto desc = OptimizerType::get_description();
+  desc.add("beta1", m_beta1);
+  desc.add("beta2", m_beta2);
+  desc.add("eps", m_eps);
+  desc.add("Weight decay", m_weight_decay);
+  return desc;
+}
+
+template <typename TensorDataType>
+auto lamb<TensorDataType>::get_moment1() const -> const AbsDistMatrixType&
+{
+  if (m_moment1 == nullptr) {
+    LBANN_ERROR(this->get_type() + " optimizer " +
+                "attempted to access moment1 before it was setup");
+  }
+  return *m_moment1;
+}
+template <typename TensorDataType>
+auto lamb<TensorDataType>::get_moment1() -> AbsDistMatrixType&
+{
+  // Item 3, p. 23 in "Effective C++", 3rd ed., by Scott Meyers
+  return const_cast<AbsDistMatrixType&>(
+    static_cast<const lamb&>(*this).get_moment1());
+}
+template <typename TensorDataType>
+auto lamb<TensorDataType>::get_moment2() const -> const AbsDistMatrixType&
+{
+  if (m_moment2 == nullptr) {
+    LBANN_ERROR(this->get_type() + " optimizer " +
+                "attempted to access moment2 before it was setup");
+  }
+  return *m_moment2;
+}
+template <typename TensorDataType>
+auto lamb<TensorDataType>::get_moment2() -> AbsDistMatrixType&
+{
+  // Item 3, p. 23 in "Effective C++", 3rd ed., by Scott Meyers
+  return const_cast<AbsDistMatrixType&>(
+    static_cast<const lamb&>(*this).get_moment2());
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::setup(WeightsType* w)
+{
+  OptimizerType::setup(w);
+  const auto& gradient = this->get_gradient();
+  m_moment1.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  m_moment2.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  El::Zeros(*m_moment1, gradient.Height(), gradient.Width());
+  El::Zeros(*m_moment2, gradient.Height(), gradient.Width());
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
+{
+  auto* opt = proto.mutable_lamb();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_beta1(m_beta1);
+  opt->set_beta2(m_beta2);
+  opt->set_eps(m_eps);
+  opt->set_weight_decay(m_weight_decay);
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::step_compute(AbsDistMatrixType& values,
+                                        const AbsDistMatrixType& gradient)
+{
+  m_current_beta1 *= m_beta1;
+  m_current_beta2 *= m_beta2;
+
+  switch (values.GetLocalDevice()) {
+  case El::Device::CPU:
+    step_compute_cpu(values, gradient);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    step_compute_gpu(values, gradient);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    std::ostringstream err;
+    err << "unsupported device type "
+        << "(" << static_cast<int>(values.GetLocalDevice()) << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+template <typename TensorDataType>
+void lamb<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  static const auto one = TensorDataType(1.);
+
+  // Get local matrix data
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const size_t values_ldim = values.LDim();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  const size_t gradient_ldim = gradient.LDim();
+  auto* __restrict__ moment1_buffer = m_moment1->Buffer();
+  const size_t moment1_ldim = m_moment1->LDim();
+  auto* __restrict__ moment2_buffer = m_moment2->Buffer();
+  const size_t moment2_ldim = m_moment2->LDim();
+
+  // Contiguous tensors are updated in vectorized loops
+  const bool contiguous = (values.Contiguous() && gradient.Contiguous() &&
+                           m_moment1->Contiguous() && m_moment2->Contiguous());
+  const size_t local_size = local_height * local_width;
+
+  // Bias corrections
+  const auto correction1 = one / (one - m_current_beta1);
+  const auto correction2 = one / (one - m_current_beta2);
+
+  // Update moment estimates and compute the norms of the weights and
+  // of the update
+  EvalType values_sqsum = 0;
+  EvalType update_sqsum = 0;
+  if (contiguous) {
+    LBANN_OMP_PARALLEL_FOR_SIMD_ARGS(reduction(+ : values_sqsum, update_sqsum))
+    for (size_t i = 0; i < local_size; ++i) {
+      const auto& x = values_buffer[i];
+      const auto& g = gradient_buffer[i];
+      auto& m1 = moment1_buffer[i];
+      auto& m2 = moment2_buffer[i];
+      m1 = m_beta1 * m1 + (one - m_beta1) * g;
+      m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+      const auto r = El::To<EvalType>(
+        correction1 * m1 / (El::Sqrt(correction2 * m2) + m_eps) +
+        m_weight_decay * x);
+      values_sqsum += El::To<EvalType>(x) * El::To<EvalType>(x);
+      update_sqsum += r * r;
+    }
+  }
+  else {
+    LBANN_OMP_PARALLEL_FOR_ARGS(
+      reduction(+ : values_sqsum, update_sqsum) collapse(2))
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        const auto& x = values_buffer[row + col * values_ldim];
+        const auto& g = gradient_buffer[row + col * gradient_ldim];
+        auto& m1 = moment1_buffer[row + col * moment1_ldim];
+        auto& m2 = moment2_buffer[row + col * moment2_ldim];
+        m1 = m_beta1 * m1 + (one - m_beta1) * g;
+        m2 = m_beta2 * m2 + (one - m_beta2) * g * g;
+        const auto r = El::To<EvalType>(
+          correction1 * m1 / (El::Sqrt(correction2 * m2) + m_eps) +
+          m_weight_decay * x);
+        values_sqsum += El::To<EvalType>(x) * El::To<EvalType>(x);
+        update_sqsum += r * r;
+      }
+    }
+  }
+
+  // Pack to do one allreduce over the processes sharing the tensor
+  EvalType sqsums[2] = {values_sqsum, update_sqsum};
+  El::mpi::AllReduce(sqsums,
+                     2,
+                     values.DistComm(),
+                     El::SyncInfo<El::Device::CPU>{});
+  const EvalType values_norm = std::sqrt(sqsums[0]);
+  const EvalType update_norm = std::sqrt(sqsums[1]);
+  EvalType trust = 1;
+  if (values_norm > 0 && update_norm > 0) {
+    trust = values_norm / update_norm;
+  }
+
+  // Apply LAMB step
+  const auto local_learning_rate =
+    El::To<TensorDataType>(this->get_learning_rate() * trust);
+  if (contiguous) {
+    LBANN_OMP_PARALLEL_FOR_SIMD
+    for (size_t i = 0; i < local_size; ++i) {
+      auto& x = values_buffer[i];
+      const auto& m1 = moment1_buffer[i];
+      const auto& m2 = moment2_buffer[i];
+      const auto r = (correction1 * m1 / (El::Sqrt(correction2 * m2) + m_eps) +
+                      m_weight_decay * x);
+      x -= local_learning_rate * r;
+    }
+  }
+  else {
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        auto& x = values_buffer[row + col * values_ldim];
+        const auto& m1 = moment1_buffer[row + col * moment1_ldim];
+        const auto& m2 = moment2_buffer[row + col * moment2_ldim];
+        const auto r =
+          (correction1 * m1 / (El::Sqrt(correction2 * m2) + m_eps) +
+           m_weight_decay * x);
+        x -= local_learning_rate * r;
+      }
+    }
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lamb_optimizer_from_pbuf(google::protobuf::Message const& msg)
+{
+  const auto& params = dynamic_cast<lbann_data::Optimizer::LAMB const&>(msg);
+  return std::make_unique<lamb<TensorDataType>>(
+    TensorDataType(params.learn_rate()),
+    TensorDataType(params.beta1()),
+    TensorDataType(params.beta2()),
+    TensorDataType(params.eps()),
+    TensorDataType(params.weight_decay()));
+}
+
+#define PROTO(T)                                                               \
+  template class lamb<T>;                                                      \
+  template std::unique_ptr<optimizer> build_lamb_optimizer_from_pbuf<T>(       \
+    google::protobuf::Message const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
+
+#define LBANN_CLASS_NAME lamb
+#include <lbann/macros/register_template_class_with_cereal.hpp>
@@ -0,0 +1,252 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lars_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/memory.hpp"
+
+namespace lbann {
+
+template <typename TensorDataType>
+lars<TensorDataType>::lars(TensorDataType learning_rate,
+                           TensorDataType momentum,
+                           TensorDataType weight_decay,
+                           TensorDataType trust_coefficient,
+                           TensorDataType eps)
+  : BaseType(learning_rate),
+    m_momentum(momentum),
+    m_weight_decay(weight_decay),
+    m_trust_coefficient(trust_coefficient),
+    m_eps(eps)
+{}
+
+template <typename TensorDataType>
+lars<TensorDataType>::lars(const lars& other)
+  : BaseType(other),
+    m_momentum(other.m_momentum),
+    m_weight_decay(other.m_weight_decay),
+    m_trust_coefficient(other.m_trust_coefficient),
+    m_eps(other.m_eps),
+    m_velocity(other.m_velocity ? other.m_velocity->Copy() : nullptr)
+{}
+
+template <typename TensorDataType>
+lars<TensorDataType>&
+lars<TensorDataType>::operator=(const lars<TensorDataType>& other)
+{
+  OptimizerType::operator=(other);
+  m_momentum = other.m_momentum;
+  m_weight_decay = other.m_weight_decay;
+  m_trust_coefficient = other.m_trust_coefficient;
+  m_eps = other.m_eps;
+  m_velocity.reset(other.m_velocity ? other.m_velocity->Copy() : nullptr);
+  return *this;
+}
+
+template <typename TensorDataType>
+description lars<TensorDataType>::get_description() const
+{
+  auto desc = OptimizerType::get_description();
+  desc.add("Momentum", m_momentum);
+  desc.add("Weight decay", m_weight_decay);
+  desc.add("Trust coefficient", m_trust_coefficient);
+  desc.add("eps", m_eps);
+  return desc;
+}
+
+template <typename TensorDataType>
+auto lars<TensorDataType>::get_velocity() const -> const AbsDistMatrixType&
+{
+  if (m_velocity == nullptr) {
+    LBANN_ERROR(get_type() + " optimizer " +
+                "attempted to access velocity before it was setup");
+  }
+  return *m_velocity;
+}
+template <typename TensorDataType>
+auto lars<TensorDataType>::get_velocity() -> AbsDistMatrixType&
+{
+  // Item 3, p. 23 in "Effective C++", 3rd ed., by Scott Meyers
+  return const_cast<AbsDistMatrixType&>(
+    static_cast<const lars&>(*this).get_velocity());
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::setup(WeightsType* w)
+{
+  OptimizerType::setup(w);
+  const auto& gradient = this->get_gradient();
+  m_velocity.reset(AbsDistMatrixType::Instantiate(gradient.DistData()));
+  El::Zeros(*m_velocity, gradient.Height(), gradient.Width());
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::write_proto(lbann_data::Optimizer& proto) const
+{
+  auto* opt = proto.mutable_lars();
+  opt->set_learn_rate(this->get_learning_rate());
+  opt->set_momentum(m_momentum);
+  opt->set_weight_decay(m_weight_decay);
+  opt->set_trust_coefficient(m_trust_coefficient);
+  opt->set_eps(m_eps);
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute(AbsDistMatrixType& values,
+                                        const AbsDistMatrixType& gradient)
+{
+  switch (values.GetLocalDevice()) {
+  case El::Device::CPU:
+    step_compute_cpu(values, gradient);
+    break;
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    step_compute_gpu(values, gradient);
+    break;
+#endif // LBANN_HAS_GPU
+  default:
+    std::ostringstream err;
+    err << "unsupported device type "
+        << "(" << static_cast<int>(values.GetLocalDevice()) << ")";
+    LBANN_ERROR(err.str());
+  }
+}
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute_cpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+
+  // Get local matrix data
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  auto* __restrict__ values_buffer = values.Buffer();
+  const size_t values_ldim = values.LDim();
+  const auto* __restrict__ gradient_buffer = gradient.LockedBuffer();
+  const size_t gradient_ldim = gradient.LDim();
+  auto* __restrict__ velocity_buffer = m_velocity->Buffer();
+  const size_t velocity_ldim = m_velocity->LDim();
+
+  // Contiguous tensors are updated in vectorized loops
+  const bool contiguous = (values.Contiguous() && gradient.Contiguous() &&
+                           m_velocity->Contiguous());
+  const size_t local_size = local_height * local_width;
+
+  // Norms of the weights and of the gradient
+  EvalType values_sqsum = 0;
+  EvalType gradient_sqsum = 0;
+  if (contiguous) {
+    LBANN_OMP_PARALLEL_FOR_SIMD_ARGS(
+      reduction(+ : values_sqsum, gradient_sqsum))
+    for (size_t i = 0; i < local_size; ++i) {
+      const auto x = El::To<EvalType>(values_buffer[i]);
+      const auto g = El::To<EvalType>(gradient_buffer[i]);
+      values_sqsum += x * x;
+      gradient_sqsum += g * g;
+    }
+  }
+  else {
+    LBANN_OMP_PARALLEL_FOR_ARGS(
+      reduction(+ : values_sqsum, gradient_sqsum) collapse(2))
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        const auto x =
+          El::To<EvalType>(values_buffer[row + col * values_ldim]);
+        const auto g =
+          El::To<EvalType>(gradient_buffer[row + col * gradient_ldim]);
+        values_sqsum += x * x;
+        gradient_sqsum += g * g;
+      }
+    }
+  }
+  // Pack to do one allreduce over the processes sharing the tensor
+  EvalType sqsums[2] = {values_sqsum, gradient_sqsum};
+  El::mpi::AllReduce(sqsums,
+                     2,
+                     values.DistComm(),
+                     El::SyncInfo<El::Device::CPU>{});
+  const EvalType values_norm = std::sqrt(sqsums[0]);
+  const EvalType gradient_norm = std::sqrt(sqsums[1]);
+  EvalType trust = 1;
+  if (values_norm > 0 && gradient_norm > 0) {
+    trust = (El::To<EvalType>(m_trust_coefficient) * values_norm /
+             (gradient_norm + El::To<EvalType>(m_weight_decay) * values_norm +
+              El::To<EvalType>(m_eps)));
+  }
+
+  // Apply LARS step
+  const auto local_learning_rate =
+    El::To<TensorDataType>(this->get_learning_rate() * trust);
+  if (contiguous) {
+    LBANN_OMP_PARALLEL_FOR_SIMD
+    for (size_t i = 0; i < local_size; ++i) {
+      auto& x = values_buffer[i];
+      const auto& g = gradient_buffer[i];
+      auto& v = velocity_buffer[i];
+      v = m_momentum * v + local_learning_rate * (g + m_weight_decay * x);
+      x -= v;
+    }
+  }
+  else {
+    LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+    for (size_t col = 0; col < local_width; ++col) {
+      for (size_t row = 0; row < local_height; ++row) {
+        auto& x = values_buffer[row + col * values_ldim];
+        const auto& g = gradient_buffer[row + col * gradient_ldim];
+        auto& v = velocity_buffer[row + col * velocity_ldim];
+        v = m_momentum * v + local_learning_rate * (g + m_weight_decay * x);
+        x -= v;
+      }
+    }
+  }
+}
+
+template <typename TensorDataType>
+std::unique_ptr<optimizer>
+build_lars_optimizer_from_pbuf(google::protobuf::Message const& msg)
+{
+  const auto& params = dynamic_cast<lbann_data::Optimizer::LARS const&>(msg);
+  return std::make_unique<lars<TensorDataType>>(
+    TensorDataType(params.learn_rate()),
+    TensorDataType(params.momentum()),
+    TensorDataType(params.weight_decay()),
+    TensorDataType(params.trust_coefficient()),
+    TensorDataType(params.eps()));
+}
+
+#define PROTO(T)                                                               \
+  template class lars<T>;                                                      \
+  template std::unique_ptr<optimizer> build_lars_optimizer_from_pbuf<T>(       \
+    google::protobuf::Message const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
+
+#define LBANN_CLASS_NAME lars
+#include <lbann/macros/register_template_class_with_cereal.hpp>
@@ -0,0 +1,198 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/optimizers/lars.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Local contributions to the squared norms of the weights and of
+ *  the gradient */
+template <size_t block_size, typename TensorDataType>
+__global__ void sqsum_kernel(size_t height,
+                             size_t width,
+                             const TensorDataType* __restrict__ values,
+                             size_t values_ldim,
+                             const TensorDataType* __restrict__ gradient,
+                             size_t gradient_ldim,
+                             TensorDataType* __restrict__ sqsums)
+{
+  const size_t tid = threadIdx.x;
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+
+  // Compute contributions for each thread
+  TensorDataType values_sqsum = 0;
+  TensorDataType gradient_sqsum = 0;
+  for (size_t pos = gid; pos < height * width; pos += nthreads) {
+    const auto& row = pos % height;
+    const auto& col = pos / height;
+    const auto& x = values[row + col * values_ldim];
+    const auto& g = gradient[row + col * gradient_ldim];
+    values_sqsum += x * x;
+    gradient_sqsum += g * g;
+  }
+
+  // Shared memory reduction to get contribution for each block
+  __shared__ TensorDataType shared_values_sqsum[block_size];
+  __shared__ TensorDataType shared_gradient_sqsum[block_size];
+  shared_values_sqsum[tid] = values_sqsum;
+  shared_gradient_sqsum[tid] = gradient_sqsum;
+  for (size_t stride = block_size / 2; stride > 0; stride /= 2) {
+    __syncthreads();
+    if (tid < stride) {
+      shared_values_sqsum[tid] += shared_values_sqsum[tid + stride];
+      shared_gradient_sqsum[tid] += shared_gradient_sqsum[tid + stride];
+    }
+  }
+  if (tid == 0) {
+    gpu_lib::atomic_add(&sqsums[0], shared_values_sqsum[0]);
+    gpu_lib::atomic_add(&sqsums[1], shared_gradient_sqsum[0]);
+  }
+}
+
+/** LARS step with the trust ratio of the global squared norms */
+template <typename TensorDataType>
+__global__ void lars_kernel(size_t height,
+                            size_t width,
+                            TensorDataType learning_rate,
+                            TensorDataType momentum,
+                            TensorDataType weight_decay,
+                            TensorDataType trust_coefficient,
+                            TensorDataType eps,
+                            const TensorDataType* __restrict__ sqsums,
+                            TensorDataType* __restrict__ values,
+                            size_t values_ldim,
+                            const TensorDataType* __restrict__ gradient,
+                            size_t gradient_ldim,
+                            TensorDataType* __restrict__ velocity,
+                            size_t velocity_ldim)
+{
+  const TensorDataType zero = 0.;
+  const auto values_norm = gpu_lib::sqrt(sqsums[0]);
+  const auto gradient_norm = gpu_lib::sqrt(sqsums[1]);
+  auto local_learning_rate = learning_rate;
+  if (values_norm > zero && gradient_norm > zero) {
+    local_learning_rate *=
+      (trust_coefficient * values_norm /
+       (gradient_norm + weight_decay * values_norm + eps));
+  }
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  for (size_t pos = gid; pos < height * width; pos += nthreads) {
+    const auto& row = pos % height;
+    const auto& col = pos / height;
+    auto& x = values[row + col * values_ldim];
+    const auto& g = gradient[row + col * gradient_ldim];
+    auto& v = velocity[row + col * velocity_ldim];
+    v = momentum * v + local_learning_rate * (g + weight_decay * x);
+    x -= v;
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void lars<TensorDataType>::step_compute_gpu(AbsDistMatrixType& values,
+                                            const AbsDistMatrixType& gradient)
+{
+  const size_t local_height = values.LocalHeight();
+  const size_t local_width = values.LocalWidth();
+  const size_t local_size = local_height * local_width;
+  auto sync_info = gpu::get_sync_info(values);
+  auto multisync =
+    El::MakeMultiSync(sync_info, gpu::get_sync_info(gradient));
+  constexpr size_t block_size = 256;
+  const size_t grid_size = (local_size + block_size - 1) / block_size;
+
+  // Squared norms of the weights and of the gradient. They stay on
+  // the device, so the step does not wait on the host.
+  El::Matrix<TensorDataType, El::Device::GPU> sqsums;
+#ifdef HYDROGEN_HAVE_CUB
+  sqsums.SetMemoryMode(1); // Use CUB GPU memory pool
+#endif                     // HYDROGEN_HAVE_CUB
+  El::SetSyncInfo(sqsums, sync_info);
+  El::Zeros(sqsums, 2, 1);
+  if (local_size > 0) {
+    hydrogen::gpu::LaunchKernel(sqsum_kernel<block_size, TensorDataType>,
+                                grid_size,
+                                block_size,
+                                0,
+                                multisync,
+                                local_height,
+                                local_width,
+                                values.LockedBuffer(),
+                                values.LDim(),
+                                gradient.LockedBuffer(),
+                                gradient.LDim(),
+                                sqsums.Buffer());
+  }
+  El::mpi::AllReduce(sqsums.Buffer(), 2, values.DistComm(), sync_info);
+
+  // Apply LARS step
+  if (local_size > 0) {
+    hydrogen::gpu::LaunchKernel(
+      lars_kernel<TensorDataType>,
+      grid_size,
+      block_size,
+      0,
+      multisync,
+      local_height,
+      local_width,
+      El::To<TensorDataType>(this->get_learning_rate()),
+      m_momentum,
+      m_weight_decay,
+      m_trust_coefficient,
+      m_eps,
+      sqsums.LockedBuffer(),
+      values.Buffer(),
+      values.LDim(),
+      gradient.LockedBuffer(),
+      gradient.LDim(),
+      m_velocity->Buffer(),
+      m_velocity->LDim());
+  }
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void lars<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
+                                      const AbsDistMatrixType&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
+#endif // LBANN_HAS_HALF
+
+#define PROTO(T)                                                               \
+  template void lars<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,          \
+                                          const El::AbstractDistMatrix<T>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,280 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_APPLY_CUH_INCLUDED
+#define LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_APPLY_CUH_INCLUDED
+
+#if defined __CUDACC__ || defined __HIPCC__
+
+#include "lbann/base.hpp"
+#include "lbann/optimizers/data_type_optimizer.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+namespace internal {
+
+/** @brief Threads per block of a multi-tensor kernel */
+constexpr int multi_tensor_block_size = 256;
+/** @brief Entries processed by a block of a multi-tensor kernel */
+constexpr size_t multi_tensor_chunk_size = 16384;
+/** @brief Tensors per launch of a multi-tensor kernel */
+constexpr int multi_tensor_max_tensors = 32;
+static_assert(multi_tensor_max_tensors <= 256,
+              "multi-tensor indices do not fit in a byte");
+/** @brief Chunks, and hence blocks, per launch of a multi-tensor
+ *         kernel */
+constexpr int multi_tensor_max_chunks = 160;
+
+/** @brief Kernel argument of a multi-tensor launch
+ *  @details Passed by value, so it must fit in the kernel parameter
+ *  space. Tensor indices are stored in bytes to save room.
+ */
+template <typename TensorDataType>
+struct multi_tensor_args
+{
+  fused_step_entry<TensorDataType> tensors[multi_tensor_max_tensors];
+  unsigned char chunk_tensor[multi_tensor_max_chunks];
+  int chunk_index[multi_tensor_max_chunks];
+};
+
+/** @brief New value of an entry updated by a fused step
+ *
+ *  Returns @c x*scale-update. Only fp16 values are rounded
+ *  stochastically, see fused_step_rounding.
+ */
+template <typename TensorDataType>
+__device__ __forceinline__ TensorDataType
+fused_step_update(fused_step_rounding const& /*rounding*/,
+                  size_t /*pos*/,
+                  TensorDataType x,
+                  TensorDataType scale,
+                  TensorDataType update)
+{
+  return x * scale - update;
+}
+
+#ifdef LBANN_HAS_GPU_FP16
+/** @brief SplitMix64 finalizer */
+__device__ __forceinline__ uint64_t stochastic_rounding_hash(uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ull;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+  return x ^ (x >> 31);
+}
+
+template <>
+__device__ __forceinline__ fp16
+fused_step_update(fused_step_rounding const& rounding,
+                  size_t pos,
+                  fp16 x,
+                  fp16 scale,
+                  fp16 update)
+{
+  const float y = __half2float(x) * __half2float(scale) - __half2float(update);
+  if (!rounding.stochastic) {
+    return __float2half(y);
+  }
+  const fp16 down = __float2half_rd(y);
+  const fp16 up = __float2half_ru(y);
+  const float y_down = __half2float(down);
+  const float y_up = __half2float(up);
+  if (!(y_up > y_down)) {
+    return down; // Exact, or not finite
+  }
+  const uint64_t key =
+    ((static_cast<uint64_t>(__half_as_ushort(x)) << 16) |
+     static_cast<uint64_t>(__half_as_ushort(update))) ^
+    (static_cast<uint64_t>(pos) << 32);
+  const uint64_t bits = stochastic_rounding_hash(
+    rounding.seed ^ stochastic_rounding_hash(key));
+  // Uniform in [0,1) with 24 random bits
+  const float u = static_cast<float>(bits >> 40) * 0x1p-24f;
+  return (u * (y_up - y_down) < y - y_down) ? up : down;
+}
+#endif // LBANN_HAS_GPU_FP16
+
+/** @brief Apply an entrywise update to chunks of several tensors
+ *
+ *  Block @c b updates chunk @c chunk_index[b] of tensor
+ *  @c chunk_tensor[b]. @c op is called with the tensor's entry and
+ *  the position of the value being updated.
+ */
+template <typename TensorDataType, typename Op>
+__global__ void
+multi_tensor_apply_kernel(multi_tensor_args<TensorDataType> args, Op op)
+{
+  const auto& entry = args.tensors[args.chunk_tensor[blockIdx.x]];
+  const size_t begin = (static_cast<size_t>(args.chunk_index[blockIdx.x]) *
+                        multi_tensor_chunk_size);
+  const size_t end = (begin + multi_tensor_chunk_size < entry.size
+                        ? begin + multi_tensor_chunk_size
+                        : entry.size);
+  for (size_t pos = begin + threadIdx.x; pos < end; pos += blockDim.x) {
+    op(entry, pos);
+  }
+}
+
+/** @brief Add the sum of squares of the gradients in chunks of
+ *         several tensors to @c sqsum
+ *
+ *  Blocks are mapped to chunks as in multi_tensor_apply_kernel.
+ */
+template <typename TensorDataType>
+__global__ void
+multi_tensor_sqsum_kernel(multi_tensor_args<TensorDataType> args,
+                          EvalType* __restrict__ sqsum)
+{
+  const auto& entry = args.tensors[args.chunk_tensor[blockIdx.x]];
+  const size_t begin = (static_cast<size_t>(args.chunk_index[blockIdx.x]) *
+                        multi_tensor_chunk_size);
+  const size_t end = (begin + multi_tensor_chunk_size < entry.size
+                        ? begin + multi_tensor_chunk_size
+                        : entry.size);
+  EvalType thread_sqsum = 0;
+  for (size_t pos = begin + threadIdx.x; pos < end; pos += blockDim.x) {
+    const auto g = static_cast<EvalType>(entry.gradient[pos]);
+    thread_sqsum += g * g;
+  }
+
+  // Compute contributions for each block
+  __shared__ EvalType shared_sqsum[multi_tensor_block_size];
+  const size_t tid = threadIdx.x;
+  shared_sqsum[tid] = thread_sqsum;
+  for (size_t stride = multi_tensor_block_size / 2; stride > 0; stride /= 2) {
+    __syncthreads();
+    if (tid < stride) {
+      shared_sqsum[tid] += shared_sqsum[tid + stride];
+    }
+  }
+  if (tid == 0) {
+    gpu_lib::atomic_add(sqsum, shared_sqsum[0]);
+  }
+}
+
+/** @brief Pack the chunks of several tensors into kernel arguments
+ *
+ *  Tensors are split into chunks, which are packed into as few
+ *  launches as the kernel parameter space allows. @c launch is
+ *  called with the arguments and the number of chunks of each
+ *  launch.
+ */
+template <typename TensorDataType, typename Launch>
+void multi_tensor_pack(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  Launch const& launch)
+{
+  static_assert(sizeof(multi_tensor_args<TensorDataType>) <= 4000,
+                "multi-tensor kernel argument is too large");
+  multi_tensor_args<TensorDataType> args;
+  int num_tensors = 0;
+  int num_chunks = 0;
+  for (const auto& entry : entries) {
+    if (entry.size == 0) {
+      continue;
+    }
+    args.tensors[num_tensors] = entry;
+    const size_t entry_chunks =
+      (entry.size + multi_tensor_chunk_size - 1) / multi_tensor_chunk_size;
+    for (size_t chunk = 0; chunk < entry_chunks; ++chunk) {
+      args.chunk_tensor[num_chunks] = static_cast<unsigned char>(num_tensors);
+      args.chunk_index[num_chunks] = static_cast<int>(chunk);
+      ++num_chunks;
+      const bool last_chunk = (chunk + 1 == entry_chunks);
+      if (num_chunks == multi_tensor_max_chunks ||
+          (last_chunk && num_tensors + 1 == multi_tensor_max_tensors)) {
+        launch(args, num_chunks);
+        num_chunks = 0;
+        // A tensor with chunks left moves to the front of the next
+        // launch
+        if (last_chunk) {
+          num_tensors = -1;
+        }
+        else {
+          args.tensors[0] = entry;
+          num_tensors = 0;
+        }
+      }
+    }
+    ++num_tensors;
+  }
+  if (num_chunks > 0) {
+    launch(args, num_chunks);
+  }
+}
+
+/** @brief Apply an entrywise update to all the tensors of a fused
+ *         optimization step.
+ */
+template <typename TensorDataType, typename Op>
+void multi_tensor_apply(
+  Op const& op,
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  multi_tensor_pack(
+    entries,
+    [&](multi_tensor_args<TensorDataType> const& args, int num_chunks) {
+      hydrogen::gpu::LaunchKernel(
+        multi_tensor_apply_kernel<TensorDataType, Op>,
+        num_chunks,
+        multi_tensor_block_size,
+        0,
+        sync_info,
+        args,
+        op);
+    });
+}
+
+/** @brief Add the sum of squares of the gradients of several tensors
+ *         to @c sqsum
+ *
+ *  @c sqsum is in device memory.
+ */
+template <typename TensorDataType>
+void multi_tensor_sqsum(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  EvalType* sqsum,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  multi_tensor_pack(
+    entries,
+    [&](multi_tensor_args<TensorDataType> const& args, int num_chunks) {
+      hydrogen::gpu::LaunchKernel(multi_tensor_sqsum_kernel<TensorDataType>,
+                                  num_chunks,
+                                  multi_tensor_block_size,
+                                  0,
+                                  sync_info,
+                                  args,
+                                  sqsum);
+    });
+}
+
+} // namespace internal
+} // namespace lbann
+
+#endif // defined __CUDACC__ || defined __HIPCC__
+#endif // LBANN_SRC_OPTIMIZERS_MULTI_TENSOR_APPLY_CUH_INCLUDED
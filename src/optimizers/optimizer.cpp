@@ -57,6 +57,43 @@ void optimizer::finish_gradient_allreduce()
   }
 }
 
+void optimizer::launch_gradient_allreduce()
+{
+  for (auto& grad_mgr : gradients_) {
+    grad_mgr.second->launch_allreduce(*m_comm);
+  }
+}
+
+bool optimizer::test_gradient_allreduce()
+{
+  bool done = true;
+  for (auto& grad_mgr : gradients_) {
+    done = grad_mgr.second->test_allreduce(*m_comm) && done;
+  }
+  return done;
+}
+
+void optimizer::scale_gradient_contributions(EvalType alpha)
+{
+  for (auto& grad_mgr : gradients_) {
+    grad_mgr.second->scale(alpha);
+  }
+}
+
+void optimizer::fused_step(std::vector<optimizer*> const& group)
+{
+  for (auto* opt : group) {
+    opt->step();
+  }
+}
+
+EvalType optimizer::get_local_gradient_sqnorm(
+  std::vector<optimizer*> const& /*group*/)
+{
+  LBANN_ERROR(get_type(), " optimizer does not support gradient clipping");
+  return 0;
+}
+
 std::string to_string(optimizer_gradient_status status)
 {
   switch (status) {
@@ -79,7 +116,11 @@ optimizer::optimizer(const optimizer& other)
   : m_comm(other.m_comm),
     m_gradient_sources(other.m_gradient_sources),
     m_gradient_status(other.m_gradient_status),
-    m_step_time(other.m_step_time)
+    m_step_time(other.m_step_time),
+    m_clip_gradient_norm(other.m_clip_gradient_norm),
+    m_l2_regularization(other.m_l2_regularization),
+    m_decoupled_weight_decay(other.m_decoupled_weight_decay),
+    m_stochastic_rounding(other.m_stochastic_rounding)
 {
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
@@ -93,6 +134,10 @@ optimizer& optimizer::operator=(const optimizer& other)
   m_gradient_sources = other.m_gradient_sources;
   m_gradient_status = other.m_gradient_status;
   m_step_time = other.m_step_time;
+  m_clip_gradient_norm = other.m_clip_gradient_norm;
+  m_l2_regularization = other.m_l2_regularization;
+  m_decoupled_weight_decay = other.m_decoupled_weight_decay;
+  m_stochastic_rounding = other.m_stochastic_rounding;
   if (m_gradient_status == optimizer_gradient_status::allreduce_started) {
     LBANN_ERROR("attempted to copy optimizer while a "
                 "gradient allreduce is in progress");
@@ -109,6 +154,18 @@ void optimizer::serialize(Archive& ar)
 description optimizer::get_description() const
 {
   description desc(get_type() + " optimizer");
+  if (m_clip_gradient_norm > 0.) {
+    desc.add("Gradient norm threshold", m_clip_gradient_norm);
+  }
+  if (m_l2_regularization != 0.) {
+    desc.add("L2 regularization", m_l2_regularization);
+  }
+  if (m_decoupled_weight_decay != 0.) {
+    desc.add("Decoupled weight decay", m_decoupled_weight_decay);
+  }
+  if (m_stochastic_rounding) {
+    desc.add("Stochastic rounding", m_stochastic_rounding);
+  }
   return desc;
 }
 
@@ -128,11 +185,19 @@ void optimizer::remove_gradient_source(const void* source)
 {
   m_gradient_sources.erase(nullptr);
   m_gradient_sources.erase(source);
-  if (get_gradient_sources().empty()) {
+  if (get_gradient_sources().empty() && !m_gradient_allreduce_deferred) {
     start_gradient_allreduce();
   }
 }
 
+void gradient_bucket_manager::seal()
+{
+  for (auto& bucket : m_open_buckets) {
+    bucket.second->seal(m_comm);
+  }
+  m_open_buckets.clear();
+}
+
 } // namespace lbann
 
 #define LBANN_CLASS_NAME optimizer
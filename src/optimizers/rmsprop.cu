@@ -27,6 +27,9 @@
 #include "lbann/optimizers/rmsprop.hpp"
 #include "lbann/utils/gpu/helpers.hpp"
 
+#include "compressed_step.hpp"
+#include "multi_tensor_apply.cuh"
+
 namespace lbann {
 
 namespace {
@@ -57,8 +60,66 @@ __global__ void rmsprop_kernel(size_t height,
   }
 }
 
+/** @brief RMSprop update of one entry in a fused step
+ *  @details The scalars are the learning rate, the decay rate and
+ *  eps. The state is the cache.
+ */
+template <typename TensorDataType>
+struct rmsprop_fused_op
+{
+  fused_step_rounding rounding;
+  __device__ void operator()(fused_step_entry<TensorDataType> const& entry,
+                             size_t pos) const
+  {
+    const auto& learning_rate = entry.scalars[0];
+    const auto& decay_rate = entry.scalars[1];
+    const auto& eps = entry.scalars[2];
+    auto& x = entry.values[pos];
+    const auto g = (entry.gradient[pos] * entry.gradient_scale +
+                    entry.l2_scale * x);
+    auto& c = entry.state[0][pos];
+    c = decay_rate * c + (TensorDataType(1) - decay_rate) * g * g;
+    x = internal::fused_step_update(rounding,
+                                    pos,
+                                    x,
+                                    entry.decay_scale,
+                                    learning_rate * g /
+                                      (gpu_lib::sqrt(c) + eps));
+  }
+};
+
+/** @brief RMSprop update of one entry with a compressed cache
+ *  @details The state is the cache.
+ */
+template <typename TensorDataType>
+struct rmsprop_compressed_op
+{
+  TensorDataType learning_rate;
+  TensorDataType decay_rate;
+  TensorDataType eps;
+  __device__ void operator()(TensorDataType& x,
+                             const TensorDataType& g,
+                             TensorDataType* cache) const
+  {
+    auto& c = cache[0];
+    c = decay_rate * c + (TensorDataType(1.) - decay_rate) * g * g;
+    x -= learning_rate * g / (gpu_lib::sqrt(c) + eps);
+  }
+};
+
 } // namespace
 
+template <typename TensorDataType>
+void rmsprop<TensorDataType>::fused_step_gpu(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  internal::multi_tensor_apply(
+    rmsprop_fused_op<TensorDataType>{this->next_fused_step_rounding()},
+    entries,
+    sync_info);
+}
+
 template <typename TensorDataType>
 void rmsprop<TensorDataType>::step_compute_gpu(
   AbsDistMatrixType& values,
@@ -67,6 +128,16 @@ void rmsprop<TensorDataType>::step_compute_gpu(
   const size_t local_height = values.LocalHeight();
   const size_t local_width = values.LocalWidth();
   const size_t local_size = local_height * local_width;
+  if (m_compressed_cache != nullptr) {
+    const auto learning_rate =
+      El::To<TensorDataType>(this->get_learning_rate());
+    internal::compressed_step_gpu(
+      rmsprop_compressed_op<TensorDataType>{learning_rate, m_decay_rate, m_eps},
+      values.Matrix(),
+      gradient.LockedMatrix(),
+      internal::compressed_states<1>{{m_compressed_cache->get_view()}});
+    return;
+  }
   if (local_size > 0) {
     constexpr size_t block_size = 256;
     const size_t grid_size = (local_size + block_size - 1) / block_size;
@@ -98,11 +169,22 @@ void rmsprop<cpu_fp16>::step_compute_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+template <>
+void rmsprop<cpu_fp16>::fused_step_gpu(
+  std::vector<fused_step_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
-  template void rmsprop<T>::step_compute_gpu(El::AbstractDistMatrix<T>&,       \
-                                             const El::AbstractDistMatrix<T>&)
+  template void rmsprop<T>::step_compute_gpu(                                  \
+    El::AbstractDistMatrix<T>&,                                                \
+    const El::AbstractDistMatrix<T>&);                                         \
+  template void rmsprop<T>::fused_step_gpu(                                    \
+    std::vector<fused_step_entry<T>> const&,                                   \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
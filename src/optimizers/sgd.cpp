@@ -139,6 +139,29 @@ void sgd<TensorDataType>::step_compute(AbsDistMatrixType& values,
   }
 }
 
+template <typename TensorDataType>
+bool sgd<TensorDataType>::add_fused_step_entry(
+  AbsDistMatrixType& values,
+  const AbsDistMatrixType& gradient,
+  std::vector<fused_step_entry<TensorDataType>>& entries)
+{
+  // Vanilla SGD has no velocity
+  const bool vanilla = (m_momentum == TensorDataType(0.));
+  if (!vanilla && !m_velocity->Contiguous()) {
+    return false;
+  }
+  entries.push_back(
+    {values.Buffer(),
+     gradient.LockedBuffer(),
+     {vanilla ? nullptr : m_velocity->Buffer(), nullptr},
+     static_cast<size_t>(values.LocalHeight() * values.LocalWidth()),
+     {El::To<TensorDataType>(this->get_learning_rate()),
+      m_momentum,
+      TensorDataType(m_nesterov ? 1. : 0.),
+      TensorDataType(0.)}});
+  return true;
+}
+
 template <typename TensorDataType>
 void sgd<TensorDataType>::momentum_step_cpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient)
@@ -158,7 +181,7 @@ void sgd<TensorDataType>::momentum_step_cpu(AbsDistMatrixType& values,
     if (m_nesterov) {
 
       // Nesterov SGD for contiguous data
-      LBANN_OMP_PARALLEL_FOR
+      LBANN_OMP_PARALLEL_FOR_SIMD
       for (size_t i = 0; i < local_size; ++i) {
         auto& x = values_buffer[i];
         const auto& g = gradient_buffer[i];
@@ -170,7 +193,7 @@ void sgd<TensorDataType>::momentum_step_cpu(AbsDistMatrixType& values,
     else {
 
       // Momentum SGD with contiguous data
-      LBANN_OMP_PARALLEL_FOR
+      LBANN_OMP_PARALLEL_FOR_SIMD
       for (size_t i = 0; i < local_size; ++i) {
         auto& x = values_buffer[i];
         const auto& g = gradient_buffer[i];
@@ -26,6 +26,8 @@
 
 #include "lbann/optimizers/sgd.hpp"
 
+#include "multi_tensor_apply.cuh"
+
 namespace lbann {
 
 namespace {
@@ -99,8 +101,58 @@ __global__ void nesterov_kernel(size_t height,
   }
 }
 
+/** @brief SGD update of one entry in a fused step
+ *  @details The scalars are the learning rate, the momentum, and
+ *  whether Nesterov acceleration is used. The state is the velocity,
+ *  or null for vanilla SGD.
+ */
+template <typename TensorDataType>
+struct sgd_fused_op
+{
+  fused_step_rounding rounding;
+  __device__ void operator()(fused_step_entry<TensorDataType> const& entry,
+                             size_t pos) const
+  {
+    const auto& learning_rate = entry.scalars[0];
+    const auto& momentum = entry.scalars[1];
+    auto& x = entry.values[pos];
+    const auto g = (entry.gradient[pos] * entry.gradient_scale +
+                    entry.l2_scale * x);
+    TensorDataType update;
+    if (entry.state[0] == nullptr) {
+      update = learning_rate * g;
+    }
+    else {
+      auto& v = entry.state[0][pos];
+      v = momentum * v + g;
+      if (entry.scalars[2] != TensorDataType(0)) {
+        update = learning_rate * (momentum * v + g);
+      }
+      else {
+        update = learning_rate * v;
+      }
+    }
+    x = internal::fused_step_update(rounding,
+                                    pos,
+                                    x,
+                                    entry.decay_scale,
+                                    update);
+  }
+};
+
 } // namespace
 
+template <typename TensorDataType>
+void sgd<TensorDataType>::fused_step_gpu(
+  std::vector<fused_step_entry<TensorDataType>> const& entries,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  internal::multi_tensor_apply(
+    sgd_fused_op<TensorDataType>{this->next_fused_step_rounding()},
+    entries,
+    sync_info);
+}
+
 template <typename TensorDataType>
 void sgd<TensorDataType>::momentum_step_gpu(AbsDistMatrixType& values,
                                             const AbsDistMatrixType& gradient)
@@ -178,11 +230,21 @@ void sgd<cpu_fp16>::momentum_step_gpu(AbsDistMatrixType&,
 {
   LBANN_ERROR("Can't call this function with cpu_fp16!");
 }
+template <>
+void sgd<cpu_fp16>::fused_step_gpu(
+  std::vector<fused_step_entry<cpu_fp16>> const&,
+  El::SyncInfo<El::Device::GPU> const&)
+{
+  LBANN_ERROR("Can't call this function with cpu_fp16!");
+}
 #endif // LBANN_HAS_HALF
 
 #define PROTO(T)                                                               \
   template void sgd<T>::momentum_step_gpu(El::AbstractDistMatrix<T>&,          \
-                                          const El::AbstractDistMatrix<T>&)
+                                          const El::AbstractDistMatrix<T>&);   \
+  template void sgd<T>::fused_step_gpu(                                        \
+    std::vector<fused_step_entry<T>> const&,                                   \
+    El::SyncInfo<El::Device::GPU> const&)
 
 #define LBANN_INSTANTIATE_GPU_HALF
 #include "lbann/macros/instantiate.hpp"
@@ -43,7 +43,8 @@ struct AdamBuilder
       /*learning_rate=*/TensorDataType(3.f),
       /*beta1=*/TensorDataType(1.f),
       /*beta2=*/TensorDataType(4.f),
-      /*eps=*/TensorDataType(2.f));
+      /*eps=*/TensorDataType(2.f),
+      /*state_format=*/lbann::optimizer_state_format::int8);
 
     // These probably shouldn't be set here, but let's pretend
     // something's happened to perturb the state.
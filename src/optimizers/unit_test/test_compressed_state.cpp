@@ -0,0 +1,126 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+#include "Catch2BasicSupport.hpp"
+
+#include <lbann/optimizers/compressed_state.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+using lbann::compressed_state_block_size;
+using lbann::compressed_state_view;
+using lbann::optimizer_state_format;
+
+namespace {
+
+/** Encode a block of values with its scale, as the update kernels do */
+void encode_block(compressed_state_view const& view,
+                  std::vector<float> const& values)
+{
+  float scale = 0.f;
+  for (auto const& x : values) {
+    scale = std::max(scale, view.magnitude(x));
+  }
+  if (view.scales != nullptr) {
+    view.scales[0] = scale;
+  }
+  for (size_t pos = 0; pos < values.size(); ++pos) {
+    view.encode(pos, values[pos], scale);
+  }
+}
+
+} // namespace
+
+TEST_CASE("Compressed optimizer state codes", "[optimizer][compressed]")
+{
+  std::vector<float> values(compressed_state_block_size);
+  for (size_t i = 0; i < values.size(); ++i) {
+    values[i] = std::sin(0.1f * i) * std::pow(2.f, -float(i % 8));
+  }
+  float scale = 0.f;
+
+  SECTION("bf16 keeps 8 significant bits")
+  {
+    std::vector<uint16_t> codes(values.size());
+    compressed_state_view view = {codes.data(),
+                                  nullptr,
+                                  optimizer_state_format::bf16,
+                                  true};
+    encode_block(view, values);
+    for (size_t pos = 0; pos < values.size(); ++pos) {
+      CHECK(std::fabs(view.decode(pos) - values[pos]) <=
+            std::fabs(values[pos]) / 256.f);
+    }
+  }
+
+  SECTION("Signed int8 codes are within half a step of the values")
+  {
+    std::vector<int8_t> codes(values.size());
+    compressed_state_view view = {codes.data(),
+                                  &scale,
+                                  optimizer_state_format::int8,
+                                  true};
+    encode_block(view, values);
+    for (size_t pos = 0; pos < values.size(); ++pos) {
+      CHECK(std::fabs(view.decode(pos) - values[pos]) <=
+            scale / 254.f * 1.001f);
+    }
+  }
+
+  SECTION("Non-negative int8 codes never underestimate the values")
+  {
+    for (auto& x : values) {
+      x = x * x;
+    }
+    std::vector<uint8_t> codes(values.size());
+    compressed_state_view view = {codes.data(),
+                                  &scale,
+                                  optimizer_state_format::int8,
+                                  false};
+    encode_block(view, values);
+    for (size_t pos = 0; pos < values.size(); ++pos) {
+      const float x = view.decode(pos);
+      CHECK(x >= values[pos] * 0.999f);
+      CHECK(std::sqrt(x) - std::sqrt(values[pos]) <= scale / 255.f * 1.001f);
+    }
+  }
+
+  SECTION("Zero blocks decode to zero")
+  {
+    std::vector<float> zeros(values.size(), 0.f);
+    std::vector<int8_t> codes(values.size());
+    compressed_state_view view = {codes.data(),
+                                  &scale,
+                                  optimizer_state_format::int8,
+                                  true};
+    encode_block(view, zeros);
+    for (size_t pos = 0; pos < zeros.size(); ++pos) {
+      CHECK(view.decode(pos) == 0.f);
+    }
+  }
+}
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 // Get the declarations of all the builders for registration
+#include "lbann/callbacks/calibrate_quantization.hpp"
 #include "lbann/callbacks/callback.hpp"
 #include "lbann/callbacks/check_dataset.hpp"
 #include "lbann/callbacks/check_gradients.hpp"
@@ -37,6 +38,7 @@
 #include "lbann/callbacks/confusion_matrix.hpp"
 #include "lbann/callbacks/debug.hpp"
 #include "lbann/callbacks/debug_io.hpp"
+#include "lbann/callbacks/detect_stragglers.hpp"
 #include "lbann/callbacks/dump_error_signals.hpp"
 #include "lbann/callbacks/dump_gradients.hpp"
 #include "lbann/callbacks/dump_minibatch_sample_indices.hpp"
@@ -47,6 +49,7 @@
 #ifdef LBANN_HAS_ONNX
 #include "lbann/callbacks/export_onnx.hpp"
 #endif // LBANN_HAS_ONNX
+#include "lbann/callbacks/export_telemetry.hpp"
 #include "lbann/callbacks/alternate_updates.hpp"
 #include "lbann/callbacks/gpu_memory_usage.hpp"
 #include "lbann/callbacks/hang.hpp"
@@ -55,6 +58,7 @@
 #include "lbann/callbacks/load_model.hpp"
 #include "lbann/callbacks/ltfb.hpp"
 #include "lbann/callbacks/mixup.hpp"
+#include "lbann/callbacks/model_averaging.hpp"
 #include "lbann/callbacks/monitor_io.hpp"
 #include "lbann/callbacks/perturb_adam.hpp"
 #include "lbann/callbacks/perturb_dropout.hpp"
@@ -64,6 +68,7 @@
 #include "lbann/callbacks/print_statistics.hpp"
 #include "lbann/callbacks/profiler.hpp"
 #include "lbann/callbacks/replace_weights.hpp"
+#include "lbann/callbacks/roofline.hpp"
 #include "lbann/callbacks/save_images.hpp"
 #include "lbann/callbacks/save_model.hpp"
 #include "lbann/callbacks/save_topk_models.hpp"
@@ -110,6 +115,8 @@ void register_default_builders(factory_type& factory)
                            build_adaptive_learning_rate_callback_from_pbuf);
   factory.register_builder("CallbackAlternateUpdates",
                            build_alternate_updates_callback_from_pbuf);
+  factory.register_builder("CallbackCalibrateQuantization",
+                           build_calibrate_quantization_callback_from_pbuf);
   factory.register_builder("CallbackCheckDataset",
                            build_check_dataset_callback_from_pbuf);
   factory.register_builder("CallbackCheckGradients",
@@ -129,6 +136,8 @@ void register_default_builders(factory_type& factory)
   factory.register_builder("CallbackDebug", build_debug_callback_from_pbuf);
   factory.register_builder("CallbackDebugIO",
                            build_debug_io_callback_from_pbuf);
+  factory.register_builder("CallbackDetectStragglers",
+                           build_detect_stragglers_callback_from_pbuf);
   factory.register_builder("CallbackDispIOStats",
                            build_monitor_io_callback_from_pbuf);
   factory.register_builder("CallbackDropFixedLearningRate",
@@ -151,6 +160,8 @@ void register_default_builders(factory_type& factory)
   factory.register_builder("CallbackExportOnnx",
                            build_export_onnx_callback_from_pbuf);
 #endif // LBANN_HAS_ONNX
+  factory.register_builder("CallbackExportTelemetry",
+                           build_export_telemetry_callback_from_pbuf);
   factory.register_builder("CallbackGPUMemoryUsage",
                            build_gpu_memory_usage_callback_from_pbuf);
   factory.register_builder("CallbackHang", build_hang_callback_from_pbuf);
@@ -162,6 +173,8 @@ void register_default_builders(factory_type& factory)
   factory.register_builder("CallbackMinibatchSchedule",
                            build_minibatch_schedule_callback_from_pbuf);
   factory.register_builder("CallbackMixup", build_mixup_callback_from_pbuf);
+  factory.register_builder("CallbackModelAveraging",
+                           build_model_averaging_callback_from_pbuf);
   factory.register_builder(
     "CallbackOptimizerwiseAdaptiveLearningRate",
     build_optimizerwise_adaptive_learning_rate_callback_from_pbuf);
@@ -183,6 +196,8 @@ void register_default_builders(factory_type& factory)
                            build_profiler_callback_from_pbuf);
   factory.register_builder("CallbackReplaceWeights",
                            build_replace_weights_callback_from_pbuf);
+  factory.register_builder("CallbackRoofline",
+                           build_roofline_callback_from_pbuf);
   factory.register_builder("CallbackSaveImages",
                            build_save_images_callback_from_pbuf);
   factory.register_builder("CallbackSaveModel",
@@ -176,6 +176,7 @@ private:
     LBANN_REGISTER_BUILDER(L2Norm2, l2_norm2);
     LBANN_REGISTER_BUILDER(MeanAbsoluteError, mean_absolute_error);
     LBANN_REGISTER_BUILDER(MeanSquaredError, mean_squared_error);
+    LBANN_REGISTER_BUILDER(SoftmaxCrossEntropy, softmax_cross_entropy);
     LBANN_REGISTER_BUILDER(TopKCategoricalAccuracy, top_k_categorical_accuracy);
 
     // Regularizer layers
@@ -199,6 +200,7 @@ private:
     // Miscellaneous layers
     LBANN_REGISTER_BUILDER(Argmax, argmax);
     LBANN_REGISTER_BUILDER(Argmin, argmin);
+    LBANN_REGISTER_BUILDER(Attention, attention);
     LBANN_REGISTER_BUILDER(ChannelwiseMean, channelwise_mean);
     LBANN_REGISTER_BUILDER(ChannelwiseSoftmax, channelwise_softmax);
     LBANN_REGISTER_BUILDER(Covariance, covariance);
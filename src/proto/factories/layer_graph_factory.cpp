@@ -97,6 +97,15 @@ void setup_hints(
   }
 }
 
+/** Whether mixed precision runs the layer in FP16. */
+bool uses_mixed_precision(const lbann_data::Layer& proto_layer)
+{
+  return (proto_layer.has_convolution() || proto_layer.has_deconvolution() ||
+          proto_layer.has_fully_connected() ||
+          proto_layer.has_channelwise_fully_connected() ||
+          proto_layer.has_matmul() || proto_layer.has_attention());
+}
+
 } // namespace
 
 std::vector<OwningLayerPtr>
@@ -154,6 +163,13 @@ construct_layer_graph(lbann_comm* comm,
 #endif // LBANN_HAS_GPU
 
     auto proto_datatype = proto_layer.datatype();
+#ifdef LBANN_HAS_GPU_FP16
+    if (proto_model.mixed_precision() && device == El::Device::GPU &&
+        proto_datatype == lbann_data::FLOAT &&
+        uses_mixed_precision(proto_layer)) {
+      proto_datatype = lbann_data::FP16;
+    }
+#endif // LBANN_HAS_GPU_FP16
 
     // Construct layer
     OwningLayerPtr l;
@@ -192,6 +208,7 @@ construct_layer_graph(lbann_comm* comm,
     ps.replications = proto_layer.parallel_strategy().replications();
     ps.depth_groups = proto_layer.parallel_strategy().depth_groups();
     ps.depth_splits = proto_layer.parallel_strategy().depth_splits();
+    ps.sequence_splits = proto_layer.parallel_strategy().sequence_splits();
     ps.enable_subgraph = proto_layer.parallel_strategy().enable_subgraph();
     ps.sub_branch_tag = proto_layer.parallel_strategy().sub_branch_tag();
     ps.sub_branch_resource_percentage =
@@ -218,6 +235,8 @@ construct_layer_graph(lbann_comm* comm,
 #endif
       l->freeze();
     }
+    l->set_recompute_activations(proto_layer.recompute_activations());
+    l->set_offload_activations(proto_layer.offload_activations());
     // Add layer to list
     layers.emplace_back(std::move(l));
   }
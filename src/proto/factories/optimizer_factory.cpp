@@ -31,6 +31,8 @@
 #include "lbann/optimizers/adagrad.hpp"
 #include "lbann/optimizers/adam.hpp"
 #include "lbann/optimizers/hypergradient_adam.hpp"
+#include "lbann/optimizers/lamb.hpp"
+#include "lbann/optimizers/lars.hpp"
 #include "lbann/optimizers/rmsprop.hpp"
 #include "lbann/optimizers/sgd.hpp"
 
@@ -76,6 +78,8 @@ private:
     factory_.register_builder("RMSprop",
                               lbann::build_rmsprop_optimizer_from_pbuf<T>);
     factory_.register_builder("SGD", lbann::build_sgd_optimizer_from_pbuf<T>);
+    factory_.register_builder("LARS", lbann::build_lars_optimizer_from_pbuf<T>);
+    factory_.register_builder("LAMB", lbann::build_lamb_optimizer_from_pbuf<T>);
   }
 };
 
@@ -94,7 +98,14 @@ lbann::proto::construct_optimizer(const lbann_data::Optimizer& proto_opt)
 {
   auto const& factory = get_optimizer_factory<TensorDataType>();
   auto const& msg = protobuf::get_oneof_message(proto_opt, "optimizer_type");
-  return factory.create_object(msg.GetDescriptor()->name(), msg);
+  auto opt = factory.create_object(msg.GetDescriptor()->name(), msg);
+  if (opt != nullptr) {
+    opt->set_clip_gradient_norm(proto_opt.clip_gradient_norm());
+    opt->set_l2_regularization(proto_opt.l2_regularization());
+    opt->set_decoupled_weight_decay(proto_opt.decoupled_weight_decay());
+    opt->set_stochastic_rounding(proto_opt.stochastic_rounding());
+  }
+  return opt;
 }
 
 #define PROTO(T)                                                               \
@@ -31,6 +31,8 @@
 #include "lbann/proto/datatype_helpers.hpp"
 #include "lbann/proto/factories.hpp"
 #include "lbann/trainers/trainer.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/options.hpp"
 
 #include "lbann/proto/trainer.pb.h"
 
@@ -42,11 +44,15 @@ construct_trainer(lbann_comm* comm, const lbann_data::Trainer& proto_trainer)
 {
 
   auto proto_datatype = proto_trainer.data_coordinator().datatype();
+  const int num_io_buffers =
+    global_argument_parser().get<int>(LBANN_OPTION_NUM_IO_BUFFERS);
   std::unique_ptr<data_coordinator> dc;
 #define TEMPLATE_INSTANTIATION(TensorDataType)                                 \
   do {                                                                         \
     if (proto_datatype == TypeToProtoDataType<TensorDataType>::value) {        \
-      dc = std::make_unique<buffered_data_coordinator<TensorDataType>>(comm);  \
+      dc = std::make_unique<buffered_data_coordinator<TensorDataType>>(        \
+        comm,                                                                  \
+        num_io_buffers);                                                       \
     }                                                                          \
   } while (0)
 
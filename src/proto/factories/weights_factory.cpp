@@ -172,6 +172,7 @@ lbann::proto::construct_weights(lbann_comm* comm,
   // Set weights initializer and optimizer
   w->set_initializer(std::move(init));
   w->set_optimizer(std::move(opt));
+  w->set_offload_optimizer(proto_weights.offload_optimizer());
 
   return w;
 }
@@ -32,6 +32,7 @@
 #include "lbann/data_readers/data_reader_cifar10.hpp"
 #include "lbann/data_readers/data_reader_jag_conduit.hpp"
 #ifdef LBANN_HAS_OPENCV
+#include "lbann/data_readers/data_reader_image_shards.hpp"
 #include "lbann/data_readers/data_reader_imagenet.hpp"
 #endif // LBANN_HAS_OPENCV
 #include "lbann/data_readers/data_reader_mnist.hpp"
@@ -103,6 +104,13 @@ void init_image_data_reader(const lbann_data::Reader& pb_readme,
     reader = new imagenet_reader(shuffle);
 #else
     LBANN_ERROR("Imagenet reader not supported without OpenCV");
+#endif // LBANN_HAS_OPENCV
+  }
+  else if (name == "image_shards") {
+#ifdef LBANN_HAS_OPENCV
+    reader = new image_shard_reader(shuffle);
+#else
+    LBANN_ERROR("Image shard reader not supported without OpenCV");
 #endif // LBANN_HAS_OPENCV
   }
   else if (name == "jag_conduit") {
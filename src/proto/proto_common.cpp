@@ -45,6 +45,7 @@
 #include <google/protobuf/text_format.h>
 
 #include <functional>
+#include <limits>
 #include <memory>
 #include <sys/stat.h>
 #include <unordered_map>
@@ -74,8 +75,13 @@ void init_data_readers(
   // train set.
   bool separate_validation = false;
   bool separate_tournament = false;
+  bool has_train = false;
   for (int j = 0; j < size; j++) {
     const lbann_data::Reader& readme = d_reader.reader(j);
+    if (readme.role() == "train") {
+      has_train = true;
+      continue;
+    }
     if (readme.role() == "validate") {
       separate_validation = true;
       continue;
@@ -86,6 +92,12 @@ void init_data_readers(
     }
   }
 
+  // Evaluation readers can be loaded when they are first used, so
+  // that training starts without waiting for them
+  const bool defer_eval_load =
+    has_train &&
+    global_argument_parser().get<bool>(LBANN_OPTION_DEFER_EVAL_READER_LOAD);
+
   for (int j = 0; j < size; j++) {
     const lbann_data::Reader& readme = d_reader.reader(j);
 
@@ -108,6 +120,10 @@ void init_data_readers(
       reader->keep_sample_order(readme.sample_list_keep_order());
       set_transform_pipeline = false;
     }
+    else if (name == "image_shards") {
+      init_image_data_reader(readme, pb_metadata, master, reader);
+      set_transform_pipeline = false;
+    }
     else if (name == "jag_conduit") {
       init_image_data_reader(readme, pb_metadata, master, reader);
       set_transform_pipeline = false;
@@ -145,13 +161,19 @@ void init_data_readers(
         LBANN_ERROR("Unsupported data reader field label_filename = ",
                     readme.label_filename());
       }
-      if (readme.metadata_filename().empty()) {
-        LBANN_ERROR(
-          "Required SMILES data reader field metadata_filename is missing");
-      }
-      smiles->set_metadata_filename(readme.metadata_filename());
       reader = smiles;
-      reader->set_data_sample_list(readme.sample_list());
+      if (!readme.data_filename().empty()) {
+        // Pre-tokenized corpus written by tools/tokenize_smiles
+        smiles->set_pretokenized(true);
+      }
+      else {
+        if (readme.metadata_filename().empty()) {
+          LBANN_ERROR(
+            "Required SMILES data reader field metadata_filename is missing");
+        }
+        smiles->set_metadata_filename(readme.metadata_filename());
+        reader->set_data_sample_list(readme.sample_list());
+      }
     }
     else if (name == "hdf5_data_reader") {
       hdf5_data_reader* dr = new hdf5_data_reader(shuffle);
@@ -441,7 +463,8 @@ void init_data_readers(
                                  params.sample_function(),
                                  params.num_samples_function(),
                                  params.sample_dims_function(),
-                                 shuffle);
+                                 shuffle,
+                                 params.sample_batch_function());
 #else
       LBANN_ERROR("attempted to construct Python data reader, "
                   "but LBANN is not built with Python/C API");
@@ -455,7 +478,8 @@ void init_data_readers(
                                    params.walk_length(),
                                    params.return_param(),
                                    params.inout_param(),
-                                   params.num_negative_samples());
+                                   params.num_negative_samples(),
+                                   params.gpu_walks());
 #else
       LBANN_ERROR("attempted to construct node2vec data reader, "
                   "but LBANN is not built with "
@@ -519,7 +543,13 @@ void init_data_readers(
                                                readme.tournament_percent());
     }
 
-    reader->load();
+    if (defer_eval_load &&
+        (readme.role() == "test" || readme.role() == "validate")) {
+      reader->set_load_deferred(true);
+    }
+    else {
+      reader->load();
+    }
 
     if (readme.role() == "train") {
       data_readers[execution_mode::training] = reader;
@@ -566,6 +596,14 @@ void init_data_readers(
               *dynamic_cast<const imagenet_reader*>(reader));
 #else
             LBANN_ERROR("imagenet reader not supported without OpenCV.");
+#endif // LBANN_HAS_OPENCV
+          }
+          else if (name == "image_shards") {
+#ifdef LBANN_HAS_OPENCV
+            split_reader = new image_shard_reader(
+              *dynamic_cast<const image_shard_reader*>(reader));
+#else
+            LBANN_ERROR("image shard reader not supported without OpenCV.");
 #endif // LBANN_HAS_OPENCV
           }
           else if (name == "smiles") {
@@ -643,7 +681,8 @@ void init_data_readers(
                                              params.sample_function(),
                                              params.num_samples_function(),
                                              params.sample_dims_function(),
-                                             shuffle);
+                                             shuffle,
+                                             params.sample_batch_function());
             (*(python_reader*)split_reader) = (*(python_reader*)reader);
 #else
             LBANN_ERROR("attempted to construct Python data reader, "
@@ -706,14 +745,26 @@ void init_data_readers(
         (r_train == nullptr) ? 0u : r_train->get_num_data();
       const size_t num_validate =
         (r_validate == nullptr) ? 0u : r_validate->get_num_data();
-      std::cout << "Training using " << num_train << " samples." << std::endl
-                << "Validating using " << num_validate << " samples."
-                << std::endl;
+      std::cout << "Training using " << num_train << " samples." << std::endl;
+      if (r_validate != nullptr && r_validate->is_load_deferred()) {
+        std::cout << "Validation set will be loaded when first used."
+                  << std::endl;
+      }
+      else {
+        std::cout << "Validating using " << num_validate << " samples."
+                  << std::endl;
+      }
     }
     const generic_data_reader* r_test =
       peek_map(data_readers, execution_mode::testing);
-    const size_t num_test = (r_test == nullptr) ? 0u : r_test->get_num_data();
-    std::cout << "Testing using " << num_test << " samples." << std::endl;
+    if (r_test != nullptr && r_test->is_load_deferred()) {
+      std::cout << "Test set will be loaded when first used." << std::endl;
+    }
+    else {
+      const size_t num_test =
+        (r_test == nullptr) ? 0u : r_test->get_num_data();
+      std::cout << "Testing using " << num_test << " samples." << std::endl;
+    }
   }
   // remove null data_reader pointers if there is any
   for (auto it = data_readers.cbegin(); it != data_readers.cend();) {
@@ -746,7 +797,27 @@ void read_prototext_file(const std::string& fn,
       x->Close();
       delete x;
     });
-  bool success = google::protobuf::TextFormat::Parse(input.get(), &pb);
+  auto ends_with = [&fn](std::string const& suffix) {
+    return (fn.size() >= suffix.size() &&
+            fn.compare(fn.size() - suffix.size(), suffix.size(), suffix) == 0);
+  };
+  const bool binary = ends_with(".binpb") || ends_with(".pb");
+  bool success = false;
+  if (binary) {
+    // The default limit on the size of a message is too small for
+    // very large models
+    google::protobuf::io::CodedInputStream coded_input(input.get());
+#if GOOGLE_PROTOBUF_VERSION >= 3006000
+    coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max());
+#else
+    coded_input.SetTotalBytesLimit(std::numeric_limits<int>::max(), -1);
+#endif
+    success = (pb.ParseFromCodedStream(&coded_input) &&
+               coded_input.ConsumedEntireMessage());
+  }
+  else {
+    success = google::protobuf::TextFormat::Parse(input.get(), &pb);
+  }
   if (!success) {
     if (master) {
       err << __FILE__ << " " << __LINE__
@@ -301,11 +301,75 @@ void trainer::evaluate(observer_ptr<model> model,
 
   if (m_comm->get_grid_type() == GridType::NO_GRID or
       m_comm->get_grid_type() == GridType::PRIMARY_GRID) {
-    sgd->evaluate(*ctxt,
-                  *model,
-                  get_data_coordinator(),
-                  mode,
-                  EpochTerminationCriteria(/*num_epochs=*/1UL));
+    // A partial epoch stops after num_batches mini-batches; the next
+    // evaluation continues from there
+    get_data_coordinator().load_deferred_reader(mode);
+    const size_t epoch_batches =
+      get_data_coordinator().get_num_iterations_per_epoch(mode);
+    if (num_batches > 0 && static_cast<size_t>(num_batches) < epoch_batches) {
+      sgd->evaluate(*ctxt,
+                    *model,
+                    get_data_coordinator(),
+                    mode,
+                    BatchTerminationCriteria(num_batches));
+    }
+    else {
+      sgd->evaluate(*ctxt,
+                    *model,
+                    get_data_coordinator(),
+                    mode,
+                    EpochTerminationCriteria(/*num_epochs=*/1UL));
+    }
+  }
+}
+
+void trainer::evaluate_ensemble(std::vector<observer_ptr<model>> const& models,
+                                execution_mode mode,
+                                El::Int num_batches)
+{
+  if (models.empty()) {
+    return;
+  }
+  auto sgd = std::make_unique<SGDTrainingAlgorithm>(
+    "sgd_evaluate_ensemble",
+    std::make_unique<EpochTerminationCriteria>(/*num_epochs=*/1UL),
+    /*suppress_timer=*/true);
+  std::vector<std::unique_ptr<SGDExecutionContext>> ctxts;
+  std::vector<SGDExecutionContext*> ctxt_ptrs;
+  std::vector<model*> model_ptrs;
+  for (auto const& m : models) {
+    ctxts.push_back(sgd->get_new_execution_context());
+    ctxts.back()->set_execution_mode(mode);
+    m->reset_mode(*ctxts.back(), execution_mode::invalid);
+    ctxt_ptrs.push_back(ctxts.back().get());
+    model_ptrs.push_back(m);
+  }
+
+  DataReaderMetaData dr_metadata = get_data_coordinator().get_dr_metadata();
+  sgd->setup_models(models,
+                    get_max_mini_batch_size(),
+                    dr_metadata,
+                    get_grids());
+
+  if (m_comm->get_grid_type() == GridType::NO_GRID or
+      m_comm->get_grid_type() == GridType::PRIMARY_GRID) {
+    get_data_coordinator().load_deferred_reader(mode);
+    const size_t epoch_batches =
+      get_data_coordinator().get_num_iterations_per_epoch(mode);
+    if (num_batches > 0 && static_cast<size_t>(num_batches) < epoch_batches) {
+      sgd->evaluate_ensemble(ctxt_ptrs,
+                             model_ptrs,
+                             get_data_coordinator(),
+                             mode,
+                             BatchTerminationCriteria(num_batches));
+    }
+    else {
+      sgd->evaluate_ensemble(ctxt_ptrs,
+                             model_ptrs,
+                             get_data_coordinator(),
+                             mode,
+                             EpochTerminationCriteria(/*num_epochs=*/1UL));
+    }
   }
 }
 
@@ -115,6 +115,19 @@ void normalize::apply(utils::type_erased_matrix& data,
   }
 }
 
+void normalize::get_affine(size_t channel,
+                          size_t num_channels,
+                          DataType& a,
+                          DataType& b) const
+{
+  if (m_means.size() != 1 && m_means.size() != num_channels) {
+    LBANN_ERROR("Normalize channels does not match data");
+  }
+  const size_t i = (m_means.size() == 1 ? 0 : channel);
+  a = DataType(1) / m_stds[i];
+  b = -m_means[i] / m_stds[i];
+}
+
 std::unique_ptr<transform>
 build_normalize_transform_from_pbuf(google::protobuf::Message const& msg)
 {
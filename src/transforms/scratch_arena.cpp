@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/transforms/scratch_arena.hpp"
+
+namespace lbann {
+namespace transform {
+
+scratch_arena& scratch_arena::get()
+{
+  static thread_local scratch_arena arena;
+  return arena;
+}
+
+El::Matrix<uint8_t> scratch_arena::acquire(El::Int size)
+{
+  if (m_buffers.empty()) {
+    return El::Matrix<uint8_t>(size, 1);
+  }
+  El::Matrix<uint8_t> buf = std::move(m_buffers.back());
+  m_buffers.pop_back();
+  // Shrinking keeps the memory, so only larger images reallocate.
+  buf.Resize(size, 1);
+  return buf;
+}
+
+void scratch_arena::release(El::Matrix<uint8_t>&& buf)
+{
+  if (!buf.Viewing() && m_buffers.size() < max_buffers) {
+    m_buffers.emplace_back(std::move(buf));
+  }
+}
+
+void scratch_arena::replace(utils::type_erased_matrix& data,
+                            El::Matrix<uint8_t>&& buf)
+{
+  release(std::move(data.template get<uint8_t>()));
+  data.emplace<uint8_t>(std::move(buf));
+}
+
+} // namespace transform
+} // namespace lbann
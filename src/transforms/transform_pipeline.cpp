@@ -25,7 +25,12 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/transform_pipeline.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
+#include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
+#ifdef LBANN_HAS_OPENCV
+#include "lbann/utils/image.hpp"
+#endif // LBANN_HAS_OPENCV
 
 namespace lbann {
 namespace transform {
@@ -52,9 +57,7 @@ transform_pipeline::operator=(const transform_pipeline& other)
 void transform_pipeline::apply(utils::type_erased_matrix& data,
                                std::vector<size_t>& dims)
 {
-  for (auto& trans : m_transforms) {
-    trans->apply(data, dims);
-  }
+  apply_from(0, data, dims);
   assert_expected_out_dims(dims);
 }
 
@@ -67,16 +70,26 @@ void transform_pipeline::apply(CPUMat& data, std::vector<size_t>& dims)
 
 void transform_pipeline::apply(El::Matrix<uint8_t>& data,
                                CPUMat& out_data,
-                               std::vector<size_t>& dims)
+                               std::vector<size_t>& dims,
+                               size_t begin)
 {
   utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
   if (!m_transforms.empty()) {
     bool applied_non_inplace = false;
-    size_t i = 0;
+    size_t i = begin;
     for (; !applied_non_inplace && i < m_transforms.size(); ++i) {
       if (m_transforms[i]->supports_non_inplace()) {
         applied_non_inplace = true;
-        m_transforms[i]->apply(m, out_data, dims);
+        const size_t end = affine_run_end(i + 1);
+        if (end > i + 1 && m_transforms[i]->supports_affine_epilogue()) {
+          std::vector<DataType> scales, shifts;
+          compose_affine(i + 1, end, dims, scales, shifts);
+          m_transforms[i]->apply_with_affine(m, out_data, dims, scales, shifts);
+          i = end - 1;
+        }
+        else {
+          m_transforms[i]->apply(m, out_data, dims);
+        }
       }
       else {
         m_transforms[i]->apply(m, dims);
@@ -85,13 +98,13 @@ void transform_pipeline::apply(El::Matrix<uint8_t>& data,
     if (!applied_non_inplace) {
       LBANN_ERROR("No transform to go from uint8 -> DataType");
     }
+    // The image is now in out_data, so its buffer can be reused.
+    scratch_arena::get().release(std::move(m.template get<uint8_t>()));
     if (i < m_transforms.size()) {
       // Apply the remaining transforms.
       // TODO(pp): Prevent out_data from being resized/reallocated.
       m = utils::type_erased_matrix(std::move(out_data));
-      for (; i < m_transforms.size(); ++i) {
-        m_transforms[i]->apply(m, dims);
-      }
+      apply_from(i, m, dims);
       out_data = std::move(m.template get<DataType>());
     }
   }
@@ -101,6 +114,148 @@ void transform_pipeline::apply(El::Matrix<uint8_t>& data,
   assert_expected_out_dims(dims);
 }
 
+void transform_pipeline::apply_from(size_t i,
+                                    utils::type_erased_matrix& data,
+                                    std::vector<size_t>& dims)
+{
+  std::vector<DataType> scales, shifts;
+  while (i < m_transforms.size()) {
+    const size_t next = i + 1;
+    const size_t end = affine_run_end(next);
+    if (end > next && m_transforms[i]->supports_affine_epilogue()) {
+      // Fold the following affine transforms into this one.
+      compose_affine(next, end, dims, scales, shifts);
+      auto dst = CPUMat(get_linear_size(dims), 1);
+      m_transforms[i]->apply_with_affine(data, dst, dims, scales, shifts);
+      data.emplace<DataType>(std::move(dst));
+      i = end;
+    }
+    else if (m_transforms[i]->is_affine() && affine_run_end(i) > next) {
+      // Apply the whole run of affine transforms in one pass.
+      const size_t run_end = affine_run_end(i);
+      compose_affine(i, run_end, dims, scales, shifts);
+      auto& mat = data.template get<DataType>();
+      if (!mat.Contiguous()) {
+        LBANN_ERROR("Applying affine transforms to non-contiguous matrix not "
+                    "supported.");
+      }
+      DataType* __restrict__ buf = mat.Buffer();
+      const size_t size = mat.Height() * mat.Width();
+      const size_t channel_size = size / scales.size();
+      for (size_t channel = 0; channel < scales.size(); ++channel) {
+        const DataType a = scales[channel];
+        const DataType b = shifts[channel];
+        DataType* __restrict__ channel_buf = buf + channel * channel_size;
+        for (size_t j = 0; j < channel_size; ++j) {
+          channel_buf[j] = a * channel_buf[j] + b;
+        }
+      }
+      i = run_end;
+    }
+    else {
+      m_transforms[i]->apply(data, dims);
+      i = next;
+    }
+  }
+}
+
+#ifdef LBANN_HAS_OPENCV
+size_t transform_pipeline::decode(El::Matrix<uint8_t>& encoded,
+                                  El::Matrix<uint8_t>& data,
+                                  std::vector<size_t>& dims)
+{
+  if (!m_transforms.empty() && m_transforms.front()->supports_fused_decode()) {
+    utils::type_erased_matrix m =
+      utils::type_erased_matrix(El::Matrix<uint8_t>());
+    m_transforms.front()->apply_fused_decode(encoded, m, dims);
+    data = std::move(m.template get<uint8_t>());
+    return 1;
+  }
+  decode_image(encoded, data, dims);
+  return 0;
+}
+#endif // LBANN_HAS_OPENCV
+
+bool transform_pipeline::get_raw_image_tail(
+  size_t num_channels,
+  std::vector<DataType>& scales,
+  std::vector<DataType>& shifts) const
+{
+  const size_t tail = raw_image_tail();
+  if (tail == m_transforms.size()) {
+    return false;
+  }
+  // The layout conversion composes like the affine transforms after it.
+  compose_affine(tail,
+                 m_transforms.size(),
+                 {num_channels, 1, 1},
+                 scales,
+                 shifts);
+  return true;
+}
+
+void transform_pipeline::apply_raw_image_head(El::Matrix<uint8_t>& data,
+                                              std::vector<size_t>& dims,
+                                              size_t begin)
+{
+  const size_t tail = raw_image_tail();
+  if (tail == m_transforms.size()) {
+    LBANN_ERROR("Transform pipeline does not end in a raw image tail");
+  }
+  utils::type_erased_matrix m = utils::type_erased_matrix(std::move(data));
+  for (size_t i = begin; i < tail; ++i) {
+    m_transforms[i]->apply(m, dims);
+  }
+  data = std::move(m.template get<uint8_t>());
+  assert_expected_out_dims(dims);
+}
+
+size_t transform_pipeline::raw_image_tail() const
+{
+  size_t tail = m_transforms.size();
+  while (tail > 0 && m_transforms[tail - 1]->is_affine()) {
+    --tail;
+  }
+  if (tail == 0 || !m_transforms[tail - 1]->is_affine_layout_conversion()) {
+    return m_transforms.size();
+  }
+  --tail;
+  // The head must leave the image as uint8.
+  for (size_t i = 0; i < tail; ++i) {
+    if (m_transforms[i]->supports_non_inplace()) {
+      return m_transforms.size();
+    }
+  }
+  return tail;
+}
+
+size_t transform_pipeline::affine_run_end(size_t i) const
+{
+  while (i < m_transforms.size() && m_transforms[i]->is_affine()) {
+    ++i;
+  }
+  return i;
+}
+
+void transform_pipeline::compose_affine(size_t begin,
+                                        size_t end,
+                                        const std::vector<size_t>& dims,
+                                        std::vector<DataType>& scales,
+                                        std::vector<DataType>& shifts) const
+{
+  const size_t num_channels = (dims.size() == 3 ? dims[0] : 1);
+  scales.assign(num_channels, DataType(1));
+  shifts.assign(num_channels, DataType(0));
+  for (size_t i = begin; i < end; ++i) {
+    for (size_t channel = 0; channel < num_channels; ++channel) {
+      DataType a, b;
+      m_transforms[i]->get_affine(channel, num_channels, a, b);
+      scales[channel] *= a;
+      shifts[channel] = a * shifts[channel] + b;
+    }
+  }
+}
+
 void transform_pipeline::assert_expected_out_dims(
   const std::vector<size_t>& dims)
 {
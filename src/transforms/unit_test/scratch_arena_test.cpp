@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/transforms/scratch_arena.hpp>
+
+TEST_CASE("Testing scratch arena", "[preproc]")
+{
+  auto& arena = lbann::transform::scratch_arena::get();
+  auto buf = arena.acquire(16);
+  REQUIRE(buf.Height() == 16);
+  REQUIRE(buf.Width() == 1);
+  const uint8_t* ptr = buf.LockedBuffer();
+
+  SECTION("released buffers are reused without reallocating")
+  {
+    arena.release(std::move(buf));
+    auto smaller = arena.acquire(8);
+    REQUIRE(smaller.Height() == 8);
+    REQUIRE(smaller.LockedBuffer() == ptr);
+    arena.release(std::move(smaller));
+  }
+  SECTION("replacing data keeps its old buffer")
+  {
+    auto data = lbann::utils::type_erased_matrix(std::move(buf));
+    auto out = arena.acquire(4);
+    arena.replace(data, std::move(out));
+    REQUIRE(data.template get<uint8_t>().Height() == 4);
+    auto reused = arena.acquire(16);
+    REQUIRE(reused.LockedBuffer() == ptr);
+    arena.release(std::move(reused));
+  }
+  SECTION("views are not kept")
+  {
+    uint8_t values[4] = {};
+    arena.release(El::Matrix<uint8_t>(4, 1, values, 4));
+    auto other = arena.acquire(4);
+    REQUIRE(other.LockedBuffer() != values);
+    arena.release(std::move(other));
+    arena.release(std::move(buf));
+  }
+}
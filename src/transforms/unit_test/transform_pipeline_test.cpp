@@ -27,8 +27,10 @@
 #include "Catch2BasicSupport.hpp"
 
 // File being tested
+#include <lbann/transforms/normalize.hpp>
 #include <lbann/transforms/sample_normalize.hpp>
 #include <lbann/transforms/scale.hpp>
+#include <lbann/transforms/scale_and_translate.hpp>
 #include <lbann/transforms/transform_pipeline.hpp>
 #include <lbann/utils/memory.hpp>
 
@@ -66,3 +68,44 @@ TEST_CASE("Testing transform pipeline", "[preproc]")
     }
   }
 }
+
+TEST_CASE("Testing fused affine transforms", "[preproc]")
+{
+  lbann::transform::transform_pipeline p;
+  p.add_transform(std::make_unique<lbann::transform::scale>(2.0f));
+  p.add_transform(std::make_unique<lbann::transform::normalize>(
+    std::vector<float>({0.75f, 0.5f, 0.25f}),
+    std::vector<float>({1.0f, 2.0f, 4.0f})));
+  p.add_transform(
+    std::make_unique<lbann::transform::scale_and_translate>(2.0f, 1.0f));
+  lbann::CPUMat mat;
+  El::Ones(mat, 27, 1);
+  std::vector<size_t> dims = {3, 3, 3};
+
+  SECTION("applying the pipeline")
+  {
+    REQUIRE_NOTHROW(p.apply(mat, dims));
+
+    SECTION("pipeline does not change dims")
+    {
+      REQUIRE(dims[0] == 3);
+      REQUIRE(dims[1] == 3);
+      REQUIRE(dims[2] == 3);
+    }
+
+    SECTION("pipeline produces correct values")
+    {
+      const lbann::DataType expected[3] = {3.5f, 2.5f, 1.875f};
+      const lbann::DataType* buf = mat.LockedBuffer();
+      for (size_t i = 0; i < 27; ++i) {
+        REQUIRE(buf[i] == Approx(expected[i / 9]));
+      }
+    }
+  }
+
+  SECTION("mismatched channels")
+  {
+    dims = {27};
+    REQUIRE_THROWS(p.apply(mat, dims));
+  }
+}
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/adjust_contrast.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -64,7 +65,8 @@ void adjust_contrast::apply(utils::type_erased_matrix& data,
   else {
     std::vector<size_t> gray_dims = {1, dims[1], dims[2]};
     const size_t size = get_linear_size(gray_dims);
-    auto gray_real = El::Matrix<uint8_t>(size, 1);
+    auto& arena = scratch_arena::get();
+    auto gray_real = arena.acquire(size);
     cv::Mat gray = utils::get_opencv_mat(gray_real, gray_dims);
     cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
     const uint8_t* __restrict__ gray_buf = gray.ptr();
@@ -77,6 +79,7 @@ void adjust_contrast::apply(utils::type_erased_matrix& data,
     }
     gray_mean = static_cast<uint8_t>(
       std::round(static_cast<double>(sum) / static_cast<double>(size)));
+    arena.release(std::move(gray_real));
   }
   // Mix the gray mean with the original image.
   uint8_t* __restrict__ src_buf = src.ptr();
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/adjust_saturation.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -56,7 +57,8 @@ void adjust_saturation::apply(utils::type_erased_matrix& data,
     // the grayscale value of each pixel.
     std::vector<size_t> gray_dims = {1, dims[1], dims[2]};
     const size_t gray_size = get_linear_size(gray_dims);
-    auto gray_real = El::Matrix<uint8_t>(gray_size, 1);
+    auto& arena = scratch_arena::get();
+    auto gray_real = arena.acquire(gray_size);
     cv::Mat gray = utils::get_opencv_mat(gray_real, gray_dims);
     cv::cvtColor(src, gray, cv::COLOR_BGR2GRAY);
     const uint8_t* __restrict__ gray_buf = gray.ptr();
@@ -73,6 +75,7 @@ void adjust_saturation::apply(utils::type_erased_matrix& data,
       src_buf[src_base + 2] = cv::saturate_cast<uint8_t>(
         src_buf[src_base + 2] * m_factor + gray_buf[i] * one_minus_factor);
     }
+    arena.release(std::move(gray_real));
   }
 }
 
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/center_crop.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -47,7 +48,7 @@ void center_crop::apply(utils::type_erased_matrix& data,
     LBANN_ERROR(ss.str());
   }
   std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // Compute upper-left corner of crop.
   const size_t x = std::round(float(src.cols - m_w) / 2.0);
@@ -64,7 +65,7 @@ void center_crop::apply(utils::type_erased_matrix& data,
   }
   // Copy is needed to ensure this is continuous.
   src(cv::Rect(x, y, m_h, m_w)).copyTo(dst);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/colorize.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -41,10 +42,10 @@ void colorize::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims)
     return; // Already color.
   }
   std::vector<size_t> new_dims = {3, dims[1], dims[2]};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   cv::cvtColor(src, dst, cv::COLOR_GRAY2BGR);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
@@ -101,6 +101,19 @@ void normalize_to_lbann_layout::apply(utils::type_erased_matrix& data,
   }
 }
 
+void normalize_to_lbann_layout::get_affine(size_t channel,
+                                           size_t num_channels,
+                                           DataType& a,
+                                           DataType& b) const
+{
+  if (m_means.size() != 1 && m_means.size() != num_channels) {
+    LBANN_ERROR("Normalize channels does not match data");
+  }
+  const size_t i = (m_means.size() == 1 ? 0 : channel);
+  a = DataType(1) / (255.0f * m_stds[i]);
+  b = -m_means[i] / m_stds[i];
+}
+
 std::unique_ptr<transform> build_normalize_to_lbann_layout_transform_from_pbuf(
   google::protobuf::Message const& msg)
 {
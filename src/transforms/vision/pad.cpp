@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/pad.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -42,7 +43,7 @@ void pad::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims)
   std::vector<size_t> new_dims = {dims[0],
                                   dims[1] + m_p * 2,
                                   dims[2] + m_p * 2};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   cv::copyMakeBorder(src,
                      dst,
@@ -52,7 +53,7 @@ void pad::apply(utils::type_erased_matrix& data, std::vector<size_t>& dims)
                      m_p,
                      cv::BORDER_CONSTANT,
                      cv::Scalar(0));
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/random_affine.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -40,32 +41,36 @@ void random_affine::apply(utils::type_erased_matrix& data,
                           std::vector<size_t>& dims)
 {
   cv::Mat src = utils::get_opencv_mat(data, dims);
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, dims);
-  // Compute the random quantities for the transform.
+  // Compute the random quantities for the transform, from a batch of
+  // values in [0, 1).
+  float u[5];
+  transform::get_uniform_random(0.0f, 1.0f, u, 5);
+  auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
   // For converting to radians:
   constexpr float pi_rad = 3.14159265358979323846f / 180.0f;
   float angle = 0.0f;
   if (m_rotate_min != 0.0f || m_rotate_max != 0.0f) {
-    angle = transform::get_uniform_random(m_rotate_min, m_rotate_max) * pi_rad;
+    angle = lerp(m_rotate_min, m_rotate_max, u[0]) * pi_rad;
   }
   float translate_x = 0.0f;
   if (m_translate_h != 0.0f) {
     const float dx = dims[2] * m_translate_w;
-    translate_x = std::round(transform::get_uniform_random(-dx, dx));
+    translate_x = std::round(lerp(-dx, dx, u[1]));
   }
   float translate_y = 0.0f;
   if (m_translate_w != 0.0f) {
     const float dy = dims[1] * m_translate_h;
-    translate_y = std::round(transform::get_uniform_random(-dy, dy));
+    translate_y = std::round(lerp(-dy, dy, u[2]));
   }
   float scale = 1.0f;
   if (m_scale_min != 0.0f || m_scale_max != 0.0f) {
-    scale = transform::get_uniform_random(m_scale_min, m_scale_max);
+    scale = lerp(m_scale_min, m_scale_max, u[3]);
   }
   float shear = 0.0f;
   if (m_shear_min != 0.0f || m_shear_max != 0.0f) {
-    shear = transform::get_uniform_random(m_shear_min, m_shear_max) * pi_rad;
+    shear = lerp(m_shear_min, m_shear_max, u[4]) * pi_rad;
   }
   // Centering matrix:
   const float center_x = dims[2] * 0.5f + 0.5f;
@@ -106,7 +111,7 @@ void random_affine::apply(utils::type_erased_matrix& data,
                  dst.size(),
                  cv::INTER_LINEAR | cv::WARP_INVERSE_MAP,
                  cv::BORDER_REPLICATE);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
 }
 
 std::unique_ptr<transform>
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/random_crop.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -45,7 +46,7 @@ void random_crop::apply(utils::type_erased_matrix& data,
     LBANN_ERROR(ss.str());
   }
   std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // Select the upper-left corner of the crop.
   const size_t x = transform::get_uniform_random_int(0, dims[2] - m_w + 1);
@@ -62,7 +63,7 @@ void random_crop::apply(utils::type_erased_matrix& data,
   }
   // Copy is needed to ensure this is continuous.
   src(cv::Rect(x, y, m_h, m_w)).copyTo(dst);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
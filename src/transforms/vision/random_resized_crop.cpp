@@ -25,7 +25,9 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/random_resized_crop.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
+#include "lbann/utils/image.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
 
@@ -33,18 +35,24 @@
 
 #include <opencv2/imgproc.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace lbann {
 namespace transform {
 
-void random_resized_crop::apply(utils::type_erased_matrix& data,
-                                std::vector<size_t>& dims)
+void random_resized_crop::choose_crop(size_t height,
+                                      size_t width,
+                                      size_t& x,
+                                      size_t& y,
+                                      size_t& h,
+                                      size_t& w) const
 {
-  cv::Mat src = utils::get_opencv_mat(data, dims);
-  std::vector<size_t> new_dims = {dims[0], m_h, m_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
-  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
-  size_t x = 0, y = 0, h = 0, w = 0;
-  const size_t area = dims[1] * dims[2];
+  x = 0;
+  y = 0;
+  h = 0;
+  w = 0;
+  const size_t area = height * width;
   // There's a chance this can fail, so we only make ten attempts.
   for (int attempt = 0; attempt < 10; ++attempt) {
     const float target_area =
@@ -56,32 +64,39 @@ void random_resized_crop::apply(utils::type_erased_matrix& data,
     if (transform::get_bool_random(0.5)) {
       std::swap(w, h);
     }
-    if (w <= dims[2] && h <= dims[1]) {
-      x = transform::get_uniform_random_int(0, dims[2] - w + 1);
-      y = transform::get_uniform_random_int(0, dims[1] - h + 1);
-      break;
+    if (w <= width && h <= height) {
+      x = transform::get_uniform_random_int(0, width - w + 1);
+      y = transform::get_uniform_random_int(0, height - h + 1);
+      return;
     }
     // Reset.
     h = 0;
     w = 0;
   }
-  bool fallback = false;
   // Fallback.
-  if (h == 0) {
-    fallback = true;
-    w = std::min(dims[1], dims[2]);
-    h = w;
-    x = (dims[2] - w) / 2;
-    y = (dims[1] - h) / 2;
-  }
+  w = std::min(height, width);
+  h = w;
+  x = (width - w) / 2;
+  y = (height - h) / 2;
+}
+
+void random_resized_crop::apply(utils::type_erased_matrix& data,
+                                std::vector<size_t>& dims)
+{
+  cv::Mat src = utils::get_opencv_mat(data, dims);
+  std::vector<size_t> new_dims = {dims[0], m_h, m_w};
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
+  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
+  size_t x, y, h, w;
+  choose_crop(dims[1], dims[2], x, y, h, w);
   // Sanity check.
-  if (x >= static_cast<size_t>(src.cols) ||
+  if (h == 0 || w == 0 || x >= static_cast<size_t>(src.cols) ||
       y >= static_cast<size_t>(src.rows) ||
       (x + w) > static_cast<size_t>(src.cols) ||
       (y + h) > static_cast<size_t>(src.rows)) {
     std::stringstream ss;
     ss << "Bad crop dimensions for " << src.rows << "x" << src.cols << ": " << h
-       << "x" << w << " at (" << x << "," << y << ") fallback=" << fallback;
+       << "x" << w << " at (" << x << "," << y << ")";
     LBANN_ERROR(ss.str());
   }
   // This is just a view.
@@ -91,6 +106,53 @@ void random_resized_crop::apply(utils::type_erased_matrix& data,
   if (dst.ptr() != dst_real.Buffer()) {
     LBANN_ERROR("Did not resize into dst_real.");
   }
+  scratch_arena::get().replace(data, std::move(dst_real));
+  dims = new_dims;
+}
+
+void random_resized_crop::apply_fused_decode(El::Matrix<uint8_t>& encoded,
+                                             utils::type_erased_matrix& data,
+                                             std::vector<size_t>& dims)
+{
+  size_t full_h, full_w, channels;
+  if (!get_jpeg_size(encoded, full_h, full_w, channels)) {
+    El::Matrix<uint8_t> image = scratch_arena::get().acquire(0);
+    decode_image(encoded, image, dims);
+    data.emplace<uint8_t>(std::move(image));
+    apply(data, dims);
+    return;
+  }
+  size_t x, y, h, w;
+  choose_crop(full_h, full_w, x, y, h, w);
+  // Only decode as many pixels as the output needs.
+  int reduction = 1;
+  while (reduction < 8 && h >= 2 * reduction * m_h &&
+         w >= 2 * reduction * m_w) {
+    reduction *= 2;
+  }
+  auto& arena = scratch_arena::get();
+  El::Matrix<uint8_t> image = arena.acquire(0);
+  decode_image(encoded, image, dims, reduction);
+  // Map the crop onto the decoded image, whose size is rounded.
+  const double sy = static_cast<double>(dims[1]) / full_h;
+  const double sx = static_cast<double>(dims[2]) / full_w;
+  const size_t rx = std::min<size_t>(x * sx, dims[2] - 1);
+  const size_t ry = std::min<size_t>(y * sy, dims[1] - 1);
+  const size_t rw = std::clamp<size_t>(std::lround(w * sx), 1, dims[2] - rx);
+  const size_t rh = std::clamp<size_t>(std::lround(h * sy), 1, dims[1] - ry);
+
+  cv::Mat src = utils::get_opencv_mat(image, dims);
+  std::vector<size_t> new_dims = {dims[0], m_h, m_w};
+  auto dst_real = arena.acquire(get_linear_size(new_dims));
+  cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
+  // This is just a view.
+  cv::Mat tmp = src(cv::Rect(rx, ry, rw, rh));
+  cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
+  // Sanity check.
+  if (dst.ptr() != dst_real.Buffer()) {
+    LBANN_ERROR("Did not resize into dst_real.");
+  }
+  arena.release(std::move(image));
   data.emplace<uint8_t>(std::move(dst_real));
   dims = new_dims;
 }
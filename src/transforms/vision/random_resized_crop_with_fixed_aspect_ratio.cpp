@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/random_resized_crop_with_fixed_aspect_ratio.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -42,7 +43,7 @@ void random_resized_crop_with_fixed_aspect_ratio::apply(
 {
   cv::Mat src = utils::get_opencv_mat(data, dims);
   std::vector<size_t> new_dims = {dims[0], m_crop_h, m_crop_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // Compute the projected crop area in the original image, crop it, and resize.
   const float zoom =
@@ -70,7 +71,7 @@ void random_resized_crop_with_fixed_aspect_ratio::apply(
   // The crop is just a view.
   cv::Mat tmp = src(cv::Rect(x, y, zoom_crop_h, zoom_crop_w));
   cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
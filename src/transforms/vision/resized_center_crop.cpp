@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/transforms/vision/resized_center_crop.hpp"
+#include "lbann/transforms/scratch_arena.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -41,7 +42,7 @@ void resized_center_crop::apply(utils::type_erased_matrix& data,
 {
   cv::Mat src = utils::get_opencv_mat(data, dims);
   std::vector<size_t> new_dims = {dims[0], m_crop_h, m_crop_w};
-  auto dst_real = El::Matrix<uint8_t>(get_linear_size(new_dims), 1);
+  auto dst_real = scratch_arena::get().acquire(get_linear_size(new_dims));
   cv::Mat dst = utils::get_opencv_mat(dst_real, new_dims);
   // This computes the projected crop area in the original image, crops it,
   // then resizes it.
@@ -66,7 +67,7 @@ void resized_center_crop::apply(utils::type_erased_matrix& data,
   // The crop is just a view.
   cv::Mat tmp = src(cv::Rect(x, y, zoom_h, zoom_w));
   cv::resize(tmp, dst, dst.size(), 0, 0, cv::INTER_LINEAR);
-  data.emplace<uint8_t>(std::move(dst_real));
+  scratch_arena::get().replace(data, std::move(dst_real));
   dims = new_dims;
 }
 
@@ -29,6 +29,8 @@
 #include "lbann/utils/memory.hpp"
 #include "lbann/utils/opencv.hpp"
 
+#include "lbann/proto/transforms.pb.h"
+
 namespace lbann {
 namespace transform {
 
@@ -43,6 +45,17 @@ void to_lbann_layout::apply(utils::type_erased_matrix& data,
 void to_lbann_layout::apply(utils::type_erased_matrix& data,
                             CPUMat& out,
                             std::vector<size_t>& dims)
+{
+  const std::vector<DataType> scales(dims[0], DataType(1));
+  const std::vector<DataType> shifts(dims[0], DataType(0));
+  apply_with_affine(data, out, dims, scales, shifts);
+}
+
+void to_lbann_layout::apply_with_affine(utils::type_erased_matrix& data,
+                                        CPUMat& out,
+                                        std::vector<size_t>& dims,
+                                        const std::vector<DataType>& scales,
+                                        const std::vector<DataType>& shifts)
 {
   cv::Mat src = utils::get_opencv_mat(data, dims);
   if (!src.isContinuous()) {
@@ -52,41 +65,67 @@ void to_lbann_layout::apply(utils::type_erased_matrix& data,
   if (!out.Contiguous()) {
     LBANN_ERROR("ToLBANNLayout does not support non-contiguous destination.");
   }
+  if (scales.size() != dims[0] || shifts.size() != dims[0]) {
+    LBANN_ERROR("ToLBANNLayout affine map does not match the channels.");
+  }
   const uint8_t* __restrict__ src_buf = src.ptr();
   const size_t out_size = get_linear_size(dims);
   if (static_cast<size_t>(out.Height() * out.Width()) != out_size) {
     LBANN_ERROR("Transform output does not have sufficient space.");
   }
   DataType* __restrict__ dst_buf = out.Buffer();
-  const float scale = 1.0f / 255.0f;
-  if (dims[0] == 1) {
+  // Rescaling to [0, 1] is folded into the affine map.
+  const DataType scale = 1.0f / 255.0f;
+  if (m_channels_last && dims[0] > 1) {
+    // Interleaved channels, as in OpenCV, but with the LBANN ordering
+    // of pixels.
+    const size_t num_channels = dims[0];
+    for (size_t col = 0; col < dims[2]; ++col) {
+      for (size_t row = 0; row < dims[1]; ++row) {
+        const size_t src_base = num_channels * (row * dims[2] + col);
+        const size_t dst_base = num_channels * (row + col * dims[1]);
+        for (size_t c = 0; c < num_channels; ++c) {
+          dst_buf[dst_base + c] =
+            src_buf[src_base + c] * (scales[c] * scale) + shifts[c];
+        }
+      }
+    }
+  }
+  else if (dims[0] == 1) {
     // Greyscale.
+    const DataType a = scales[0] * scale;
+    const DataType b = shifts[0];
     for (size_t row = 0; row < dims[1]; ++row) {
       for (size_t col = 0; col < dims[2]; ++col) {
-        dst_buf[row + col * dims[1]] = src_buf[row * dims[2] + col] * scale;
+        dst_buf[row + col * dims[1]] = src_buf[row * dims[2] + col] * a + b;
       }
     }
   }
   else {
     // RGB/three-channel.
+    const DataType a0 = scales[0] * scale, b0 = shifts[0];
+    const DataType a1 = scales[1] * scale, b1 = shifts[1];
+    const DataType a2 = scales[2] * scale, b2 = shifts[2];
     const size_t size = dims[1] * dims[2];
     for (size_t row = 0; row < dims[1]; ++row) {
       for (size_t col = 0; col < dims[2]; ++col) {
         // Multiply by 3 because there are three channels.
         const size_t src_base = 3 * (row * dims[2] + col);
         const size_t dst_base = row + col * dims[1];
-        dst_buf[dst_base] = src_buf[src_base] * scale;
-        dst_buf[dst_base + size] = src_buf[src_base + 1] * scale;
-        dst_buf[dst_base + 2 * size] = src_buf[src_base + 2] * scale;
+        dst_buf[dst_base] = src_buf[src_base] * a0 + b0;
+        dst_buf[dst_base + size] = src_buf[src_base + 1] * a1 + b1;
+        dst_buf[dst_base + 2 * size] = src_buf[src_base + 2] * a2 + b2;
       }
     }
   }
 }
 
 std::unique_ptr<transform>
-build_to_lbann_layout_transform_from_pbuf(google::protobuf::Message const&)
+build_to_lbann_layout_transform_from_pbuf(google::protobuf::Message const& msg)
 {
-  return std::make_unique<to_lbann_layout>();
+  auto const& params =
+    dynamic_cast<lbann_data::Transform::ToLBANNLayout const&>(msg);
+  return std::make_unique<to_lbann_layout>(params.channels_last());
 }
 
 } // namespace transform
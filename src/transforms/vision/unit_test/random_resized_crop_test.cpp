@@ -31,6 +31,8 @@
 #include <lbann/transforms/vision/random_resized_crop.hpp>
 #include <lbann/utils/random_number_generators.hpp>
 
+#include <opencv2/imgcodecs.hpp>
+
 TEST_CASE("Testing random resized crop preprocessing", "[preproc]")
 {
   lbann::utils::type_erased_matrix mat =
@@ -176,3 +178,35 @@ TEST_CASE("Testing random resized crop preprocessing", "[preproc]")
     }
   }
 }
+
+TEST_CASE("Testing random resized crop fused with decoding", "[preproc]")
+{
+  lbann::locked_io_rng_ref io_rng = lbann::set_io_generators_local_index(0);
+  cv::Mat image(64, 64, CV_8UC3, cv::Scalar(128, 128, 128));
+  auto resize_cropper = lbann::transform::random_resized_crop(8, 8);
+
+  for (const char* ext : {".jpg", ".png"}) {
+    DYNAMIC_SECTION("decoding a " << ext)
+    {
+      std::vector<uint8_t> encoded_buf;
+      REQUIRE(cv::imencode(ext, image, encoded_buf));
+      El::Matrix<uint8_t> encoded(encoded_buf.size(), 1);
+      std::copy(encoded_buf.begin(), encoded_buf.end(), encoded.Buffer());
+      lbann::utils::type_erased_matrix mat =
+        lbann::utils::type_erased_matrix(El::Matrix<uint8_t>());
+      std::vector<size_t> dims;
+      REQUIRE_NOTHROW(resize_cropper.apply_fused_decode(encoded, mat, dims));
+      REQUIRE(dims[0] == 3);
+      REQUIRE(dims[1] == 8);
+      REQUIRE(dims[2] == 8);
+      auto& real_mat = mat.template get<uint8_t>();
+      apply_elementwise(real_mat,
+                        8,
+                        8,
+                        3,
+                        [](uint8_t& x, El::Int row, El::Int col, El::Int) {
+                          REQUIRE(static_cast<int>(x) == Approx(128).margin(2));
+                        });
+    }
+  }
+}
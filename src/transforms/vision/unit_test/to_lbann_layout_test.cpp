@@ -134,4 +134,51 @@ TEST_CASE("Testing to LBANN layout", "[preproc]")
       }
     }
   }
+
+  SECTION("matrix with three channels, channels-last")
+  {
+    zeros(mat.template get<uint8_t>(), 3, 3, 3);
+    apply_elementwise(
+      mat.template get<uint8_t>(),
+      3,
+      3,
+      3,
+      [](uint8_t& x, El::Int row, El::Int col, El::Int channel) {
+        if (row == 0) {
+          x = channel + 1;
+        }
+      });
+    std::vector<size_t> dims = {3, 3, 3};
+    auto tll = lbann::transform::to_lbann_layout(true);
+
+    SECTION("converting the matrix")
+    {
+      REQUIRE_NOTHROW(tll.apply(mat, dims));
+
+      SECTION("converting does not change dims")
+      {
+        REQUIRE(dims[0] == 3);
+        REQUIRE(dims[1] == 3);
+        REQUIRE(dims[2] == 3);
+      }
+      SECTION("converting interleaves the channels")
+      {
+        auto& real_mat = mat.template get<lbann::DataType>();
+        const lbann::DataType* buf = real_mat.LockedBuffer();
+        for (size_t col = 0; col < 3; ++col) {
+          for (size_t row = 0; row < 3; ++row) {
+            for (size_t channel = 0; channel < 3; ++channel) {
+              const lbann::DataType val = buf[3 * (row + col * 3) + channel];
+              if (row == 0) {
+                REQUIRE(val == (channel + 1) * (1.0f / 255.0f));
+              }
+              else {
+                REQUIRE(val == 0.0f);
+              }
+            }
+          }
+        }
+      }
+    }
+  }
 }
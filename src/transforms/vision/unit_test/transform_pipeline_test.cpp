@@ -29,6 +29,7 @@
 // File being tested
 #include "helper.hpp"
 #include <lbann/transforms/normalize.hpp>
+#include <lbann/transforms/sample_normalize.hpp>
 #include <lbann/transforms/scale.hpp>
 #include <lbann/transforms/transform_pipeline.hpp>
 #include <lbann/transforms/vision/resized_center_crop.hpp>
@@ -74,3 +75,83 @@ TEST_CASE("Testing vision transform pipeline", "[preproc]")
     }
   }
 }
+
+TEST_CASE("Testing vision transform pipeline into a matrix", "[preproc]")
+{
+  lbann::transform::transform_pipeline p;
+  p.add_transform(std::make_unique<lbann::transform::to_lbann_layout>());
+  p.add_transform(std::make_unique<lbann::transform::scale>(2.0f));
+  p.add_transform(std::make_unique<lbann::transform::normalize>(
+    std::vector<float>({0.5f, 0.25f, 0.0f}),
+    std::vector<float>({2.0f, 1.0f, 0.5f})));
+  El::Matrix<uint8_t> mat;
+  identity(mat, 3, 3, 3);
+  lbann::CPUMat out(3 * 3 * 3, 1);
+  std::vector<size_t> dims = {3, 3, 3};
+
+  SECTION("applying the pipeline")
+  {
+    REQUIRE_NOTHROW(p.apply(mat, out, dims));
+
+    SECTION("pipeline does not change dims")
+    {
+      REQUIRE(dims[0] == 3);
+      REQUIRE(dims[1] == 3);
+      REQUIRE(dims[2] == 3);
+    }
+    SECTION("pipeline produces correct values")
+    {
+      const float means[3] = {0.5f, 0.25f, 0.0f};
+      const float stds[3] = {2.0f, 1.0f, 0.5f};
+      for (size_t channel = 0; channel < 3; ++channel) {
+        const lbann::DataType one = (2.0f / 255.0f - means[channel]) /
+                                    stds[channel];
+        const lbann::DataType zero = -means[channel] / stds[channel];
+        for (El::Int col = 0; col < 3; ++col) {
+          for (El::Int row = 0; row < 3; ++row) {
+            REQUIRE(out(row + col * 3 + channel * 9, 0) ==
+                    Approx(row == col ? one : zero));
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_CASE("Testing raw image tail of vision transform pipeline", "[preproc]")
+{
+  lbann::transform::transform_pipeline p;
+  p.add_transform(
+    std::make_unique<lbann::transform::resized_center_crop>(7, 7, 3, 3));
+  p.add_transform(std::make_unique<lbann::transform::to_lbann_layout>());
+  p.add_transform(std::make_unique<lbann::transform::scale>(2.0f));
+  p.add_transform(std::make_unique<lbann::transform::normalize>(
+    std::vector<float>({0.5f, 0.25f, 0.0f}),
+    std::vector<float>({2.0f, 1.0f, 0.5f})));
+  std::vector<lbann::DataType> scales, shifts;
+
+  SECTION("the tail composes the conversion and the affine transforms")
+  {
+    REQUIRE(p.get_raw_image_tail(3, scales, shifts));
+    REQUIRE(scales.size() == 3);
+    REQUIRE(scales[0] == Approx(1.0f / 255.0f));
+    REQUIRE(shifts[0] == Approx(-0.25f));
+    REQUIRE(scales[2] == Approx(4.0f / 255.0f));
+    REQUIRE(shifts[2] == Approx(0.0f));
+  }
+  SECTION("the head leaves a cropped uint8 image")
+  {
+    El::Matrix<uint8_t> mat;
+    ones(mat, 5, 5, 3);
+    std::vector<size_t> dims = {3, 5, 5};
+    REQUIRE_NOTHROW(p.apply_raw_image_head(mat, dims));
+    REQUIRE(dims[1] == 3);
+    REQUIRE(dims[2] == 3);
+    REQUIRE(mat.Height() * mat.Width() == 27);
+  }
+  SECTION("a non-affine transform after the conversion has no tail")
+  {
+    p.add_transform(std::make_unique<lbann::transform::sample_normalize>());
+    REQUIRE_FALSE(p.get_raw_image_tail(3, scales, shifts));
+  }
+}
@@ -0,0 +1,275 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_BATCHED_GEMM_INSTANTIATE
+#include "lbann/utils/batched_gemm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#ifdef LBANN_HAS_GPU
+#include "lbann/utils/gpu/helpers.hpp"
+#endif // LBANN_HAS_GPU
+
+namespace lbann {
+
+namespace {
+
+/** @brief Synchronization object for channelwise GEMMs on CPU */
+template <typename T>
+El::SyncInfo<El::Device::CPU>
+get_channelwise_sync_info(El::Matrix<T, El::Device::CPU>& Y,
+                          const El::Matrix<T, El::Device::CPU>&,
+                          const El::Matrix<T, El::Device::CPU>&)
+{
+  return El::SyncInfoFromMatrix(Y);
+}
+
+#ifdef LBANN_HAS_GPU
+/** @brief Synchronization object for channelwise GEMMs on GPU */
+template <typename T>
+auto get_channelwise_sync_info(El::Matrix<T, El::Device::GPU>& Y,
+                               const El::Matrix<T, El::Device::GPU>& W,
+                               const El::Matrix<T, El::Device::GPU>& X)
+{
+  return El::MakeMultiSync(gpu::get_sync_info(Y),
+                           gpu::get_sync_info(W),
+                           gpu::get_sync_info(X));
+}
+#endif // LBANN_HAS_GPU
+
+} // namespace
+
+template <typename T>
+void gemm_strided_batched(El::Orientation transa,
+                          El::Orientation transb,
+                          El::Int m,
+                          El::Int n,
+                          El::Int k,
+                          T alpha,
+                          const T* A,
+                          El::Int lda,
+                          El::Int strideA,
+                          const T* B,
+                          El::Int ldb,
+                          El::Int strideB,
+                          T beta,
+                          T* C,
+                          El::Int ldc,
+                          El::Int strideC,
+                          El::Int batch_count,
+                          const El::SyncInfo<El::Device::CPU>&)
+{
+  using LocalMat = El::Matrix<T, El::Device::CPU>;
+  const bool normal_a = (transa == El::NORMAL);
+  const bool normal_b = (transb == El::NORMAL);
+  LBANN_OMP_PARALLEL_FOR
+  for (El::Int i = 0; i < batch_count; ++i) {
+    LocalMat A_v, B_v, C_v;
+    A_v.LockedAttach(normal_a ? m : k, normal_a ? k : m, A + i * strideA, lda);
+    B_v.LockedAttach(normal_b ? k : n, normal_b ? n : k, B + i * strideB, ldb);
+    C_v.Attach(m, n, C + i * strideC, ldc);
+    El::Gemm(transa, transb, alpha, A_v, B_v, beta, C_v);
+  }
+}
+
+#ifdef LBANN_HAS_GPU
+template <typename T>
+void gemm_strided_batched(El::Orientation transa,
+                          El::Orientation transb,
+                          El::Int m,
+                          El::Int n,
+                          El::Int k,
+                          T alpha,
+                          const T* A,
+                          El::Int lda,
+                          El::Int strideA,
+                          const T* B,
+                          El::Int ldb,
+                          El::Int strideB,
+                          T beta,
+                          T* C,
+                          El::Int ldc,
+                          El::Int strideC,
+                          El::Int batch_count,
+                          const El::SyncInfo<El::Device::GPU>& sync_info)
+{
+  using hydrogen::TransposeMode;
+  hydrogen::gpu_blas::GemmStridedBatched(
+    transa == El::NORMAL ? TransposeMode::NORMAL : TransposeMode::TRANSPOSE,
+    transb == El::NORMAL ? TransposeMode::NORMAL : TransposeMode::TRANSPOSE,
+    m,
+    n,
+    k,
+    alpha,
+    A,
+    lda,
+    strideA,
+    B,
+    ldb,
+    strideB,
+    beta,
+    C,
+    ldc,
+    strideC,
+    batch_count,
+    sync_info);
+}
+#endif // LBANN_HAS_GPU
+
+template <typename T, El::Device D>
+void channelwise_gemm(El::Orientation transw,
+                      T alpha,
+                      const El::Matrix<T, D>& W,
+                      const El::Matrix<T, D>& X,
+                      T beta,
+                      El::Matrix<T, D>& Y,
+                      El::Int num_channels)
+{
+
+  // Matrix dimensions
+  const El::Int m = (transw == El::NORMAL) ? W.Height() : W.Width();
+  const El::Int k = (transw == El::NORMAL) ? W.Width() : W.Height();
+  const El::Int mini_batch_size = X.Width();
+  if (X.Height() != k * num_channels || Y.Height() != m * num_channels ||
+      Y.Width() != mini_batch_size) {
+    LBANN_ERROR("channelwise GEMM got mismatched matrices ",
+                "(W is ",
+                W.Height(),
+                " x ",
+                W.Width(),
+                ", X is ",
+                X.Height(),
+                " x ",
+                X.Width(),
+                ", Y is ",
+                Y.Height(),
+                " x ",
+                Y.Width(),
+                ", ",
+                num_channels,
+                " channels)");
+  }
+  if (mini_batch_size == 0 || m == 0) {
+    return;
+  }
+
+  if (X.Contiguous() && Y.Contiguous()) {
+    // One GEMM over the channels of all samples
+    El::Matrix<T, D> X_v, Y_v;
+    X_v.LockedAttach(k, num_channels * mini_batch_size, X.LockedBuffer(), k);
+    Y_v.Attach(m, num_channels * mini_batch_size, Y.Buffer(), m);
+    El::Gemm(transw, El::NORMAL, alpha, W, X_v, beta, Y_v);
+  }
+  else {
+    // One GEMM per sample, reading and writing the strided columns
+    // in place
+    auto sync_info = get_channelwise_sync_info(Y, W, X);
+    gemm_strided_batched(transw,
+                         El::NORMAL,
+                         m,
+                         num_channels,
+                         k,
+                         alpha,
+                         W.LockedBuffer(),
+                         W.LDim(),
+                         El::Int(0),
+                         X.LockedBuffer(),
+                         k,
+                         X.LDim(),
+                         beta,
+                         Y.Buffer(),
+                         m,
+                         Y.LDim(),
+                         mini_batch_size,
+                         sync_info);
+  }
+}
+
+template <typename T>
+void fill_channelwise_bias(const El::Matrix<T, El::Device::CPU>& bias,
+                           El::Matrix<T, El::Device::CPU>& Y)
+{
+  const El::Int height = Y.Height();
+  const El::Int width = Y.Width();
+  const El::Int bias_size = bias.Height();
+  if (bias_size == 0 || height % bias_size != 0) {
+    LBANN_ERROR("can not fill a ",
+                height,
+                " x ",
+                width,
+                " matrix with a bias of size ",
+                bias_size);
+  }
+  const T* __restrict__ bias_buffer = bias.LockedBuffer();
+  T* __restrict__ Y_buffer = Y.Buffer();
+  const El::Int Y_ldim = Y.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      Y_buffer[i + j * Y_ldim] = bias_buffer[i % bias_size];
+    }
+  }
+}
+
+// Explicit template instantiation
+#define PROTO_DEVICE(T, Device)                                                \
+  template void gemm_strided_batched(El::Orientation,                         \
+                                     El::Orientation,                         \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     T,                                       \
+                                     const T*,                                \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     const T*,                                \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     T,                                       \
+                                     T*,                                      \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     El::Int,                                 \
+                                     const El::SyncInfo<Device>&);            \
+  template void channelwise_gemm(El::Orientation,                             \
+                                 T,                                           \
+                                 const El::Matrix<T, Device>&,                \
+                                 const El::Matrix<T, Device>&,                \
+                                 T,                                           \
+                                 El::Matrix<T, Device>&,                      \
+                                 El::Int)
+#include "lbann/macros/instantiate_device.hpp"
+#undef PROTO_DEVICE
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define PROTO(T)                                                               \
+  template void fill_channelwise_bias(const El::Matrix<T, El::Device::CPU>&,  \
+                                      El::Matrix<T, El::Device::CPU>&)
+#include "lbann/macros/instantiate.hpp"
+#undef PROTO
+#undef LBANN_INSTANTIATE_CPU_HALF
+
+} // namespace lbann
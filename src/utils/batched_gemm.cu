@@ -0,0 +1,104 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#define LBANN_BATCHED_GEMM_INSTANTIATE
+#include "lbann/utils/batched_gemm.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** Y(i,j) = bias(i % bias_size) */
+template <typename T>
+__global__ void fill_channelwise_bias_kernel(size_t height,
+                                             size_t width,
+                                             size_t bias_size,
+                                             const T* __restrict__ bias,
+                                             T* __restrict__ Y,
+                                             size_t Y_ldim)
+{
+  const size_t gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t gidy = threadIdx.y + blockIdx.y * blockDim.y;
+  const size_t nthreadsx = blockDim.x * gridDim.x;
+  const size_t nthreadsy = blockDim.y * gridDim.y;
+  for (size_t j = gidy; j < width; j += nthreadsy) {
+    for (size_t i = gidx; i < height; i += nthreadsx) {
+      Y[i + j * Y_ldim] = bias[i % bias_size];
+    }
+  }
+}
+
+} // namespace
+
+template <typename T>
+void fill_channelwise_bias(const El::Matrix<T, El::Device::GPU>& bias,
+                           El::Matrix<T, El::Device::GPU>& Y)
+{
+  const El::Int height = Y.Height();
+  const El::Int width = Y.Width();
+  const El::Int bias_size = bias.Height();
+  if (bias_size == 0 || height % bias_size != 0) {
+    LBANN_ERROR("can not fill a ",
+                height,
+                " x ",
+                width,
+                " matrix with a bias of size ",
+                bias_size);
+  }
+  if (Y.IsEmpty()) {
+    return;
+  }
+  constexpr size_t block_size = 256;
+  dim3 block_dims, grid_dims;
+  block_dims.x = block_size;
+  grid_dims.x = (height + block_size - 1) / block_size;
+  grid_dims.y = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  auto multisync =
+    El::MakeMultiSync(gpu::get_sync_info(Y), gpu::get_sync_info(bias));
+  hydrogen::gpu::LaunchKernel(fill_channelwise_bias_kernel<T>,
+                              grid_dims,
+                              block_dims,
+                              0,
+                              multisync,
+                              height,
+                              width,
+                              bias_size,
+                              bias.LockedBuffer(),
+                              Y.Buffer(),
+                              Y.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template void fill_channelwise_bias(const El::Matrix<T, El::Device::GPU>&,  \
+                                      El::Matrix<T, El::Device::GPU>&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -25,10 +25,174 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/utils/cnpy_utils.hpp"
+#include "lbann/utils/file_utils.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <sys/mman.h>
+#include <tuple>
 
 namespace lbann {
 namespace cnpy_utils {
 
+namespace {
+
+template <typename T>
+T read_le(const char* buf)
+{
+  T val = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    val |= static_cast<T>(static_cast<unsigned char>(buf[i])) << (8 * i);
+  }
+  return val;
+}
+
+/** Returns the value that follows @c key in a numpy header dictionary */
+std::string header_value(const std::string& header,
+                         const std::string& key,
+                         const std::string& filename)
+{
+  const size_t k = header.find("'" + key + "'");
+  const size_t colon = header.find(':', k);
+  if (k == std::string::npos || colon == std::string::npos) {
+    LBANN_ERROR("numpy header of ", filename, " has no '", key, "' entry");
+  }
+  const size_t begin = header.find_first_not_of(' ', colon + 1);
+  const size_t end =
+    header[begin] == '(' ? header.find(')', begin) + 1
+                         : header.find_first_of(",}", begin);
+  return header.substr(begin, end - begin);
+}
+
+/**
+ * Parses the numpy header at the start of @c buf (of @c avail bytes) into
+ * @c na, and returns the total size of the header and data in bytes.
+ */
+size_t parse_header(const char* buf,
+                    size_t avail,
+                    cnpy::NpyArray& na,
+                    const std::string& filename)
+{
+  if (avail < 10 || std::memcmp(buf, "\x93NUMPY", 6) != 0) {
+    LBANN_ERROR(filename, " does not contain a numpy array");
+  }
+  const int major_version = static_cast<unsigned char>(buf[6]);
+  const size_t prefix = (major_version == 1) ? 10 : 12;
+  const size_t header_len = (major_version == 1)
+                              ? read_le<uint16_t>(buf + 8)
+                              : read_le<uint32_t>(buf + 8);
+  if (prefix + header_len > avail) {
+    LBANN_ERROR("numpy header of ", filename, " is truncated");
+  }
+  const std::string header(buf + prefix, header_len);
+
+  const std::string descr = header_value(header, "descr", filename);
+  // descr looks like '<f4'; the byte order must match the host's
+  if (descr.size() < 4 || descr[1] == '>') {
+    LBANN_ERROR("unsupported numpy data type ", descr, " in ", filename);
+  }
+  na.word_size = std::stoul(descr.substr(3, descr.size() - 4));
+  na.fortran_order =
+    (header_value(header, "fortran_order", filename) == "True");
+
+  const std::string shape = header_value(header, "shape", filename);
+  na.shape.clear();
+  na.num_vals = 1;
+  for (size_t pos = 1; pos < shape.size();) {
+    const size_t next = shape.find_first_of(",)", pos);
+    const std::string dim = shape.substr(pos, next - pos);
+    if (dim.find_first_of("0123456789") != std::string::npos) {
+      na.shape.push_back(std::stoul(dim));
+      na.num_vals *= na.shape.back();
+    }
+    pos = next + 1;
+  }
+
+  const size_t n_bytes = prefix + header_len + na.num_vals * na.word_size;
+  if (n_bytes > avail) {
+    LBANN_ERROR("numpy data of ", filename, " is truncated");
+  }
+  return n_bytes;
+}
+
+} // namespace
+
+void mapped_array::advise(size_t first, size_t count, int advice) const
+{
+  if (!is_mapped() || count == 0) {
+    return;
+  }
+  static const uintptr_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(data) +
+                          first * header.word_size;
+  const uintptr_t end = begin + count * header.word_size;
+  const uintptr_t aligned = begin & ~(page_size - 1);
+  madvise(reinterpret_cast<void*>(aligned), end - aligned, advice);
+}
+
+mapped_array mmap_npy(const std::string& filename)
+{
+  mapped_array ary;
+  size_t size = 0;
+  std::tie(ary.mapping, size) = file::map_read_only(filename);
+  const char* const base = static_cast<const char*>(ary.mapping.get());
+  const size_t n_bytes = parse_header(base, size, ary.header, filename);
+  ary.data = base + n_bytes - ary.header.num_vals * ary.header.word_size;
+  return ary;
+}
+
+std::map<std::string, mapped_array> mmap_npz(const std::string& filename)
+{
+  auto [mapping, size] = file::map_read_only(filename);
+  const char* const base = static_cast<const char*>(mapping.get());
+
+  // Walk the local file headers of the zip archive; the central
+  // directory that follows them is not needed
+  std::map<std::string, mapped_array> members;
+  size_t offset = 0;
+  while (offset + 30 <= size &&
+         read_le<uint32_t>(base + offset) == 0x04034b50) {
+    const char* const entry = base + offset;
+    const uint16_t flags = read_le<uint16_t>(entry + 6);
+    const uint16_t method = read_le<uint16_t>(entry + 8);
+    const uint16_t name_len = read_le<uint16_t>(entry + 26);
+    const uint16_t extra_len = read_le<uint16_t>(entry + 28);
+    std::string name(entry + 30, name_len);
+    if (method != 0) {
+      LBANN_ERROR("member ",
+                  name,
+                  " of ",
+                  filename,
+                  " is compressed; only archives written by numpy.savez "
+                  "can be memory mapped");
+    }
+    if (flags & 0x8) {
+      LBANN_ERROR("member ",
+                  name,
+                  " of ",
+                  filename,
+                  " was streamed into the archive; only archives written "
+                  "by numpy.savez can be memory mapped");
+    }
+
+    const size_t data_offset = offset + 30 + name_len + extra_len;
+    mapped_array ary;
+    ary.mapping = mapping;
+    const size_t n_bytes = parse_header(base + data_offset,
+                                        size - data_offset,
+                                        ary.header,
+                                        filename + ":" + name);
+    ary.data = base + data_offset + n_bytes -
+               ary.header.num_vals * ary.header.word_size;
+    if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0) {
+      name.erase(name.size() - 4);
+    }
+    members[name] = std::move(ary);
+    offset = data_offset + n_bytes;
+  }
+  return members;
+}
+
 size_t compute_cnpy_array_offset(const cnpy::NpyArray& na,
                                  std::vector<size_t> indices)
 {
@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/compression.hpp"
+#include "lbann/utils/exception.hpp"
+
+#include <zlib.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace lbann {
+namespace utils {
+
+std::string compress_string(std::string const& data, int level)
+{
+  if (level < 1 || level > 9) {
+    LBANN_ERROR("invalid compression level (", level, ")");
+  }
+  const uint64_t size = data.size();
+  uLongf compressed_size = compressBound(data.size());
+  std::string out(sizeof(size) + compressed_size, '\0');
+  std::memcpy(&out[0], &size, sizeof(size));
+  const int rc =
+    compress2(reinterpret_cast<Bytef*>(&out[sizeof(size)]),
+              &compressed_size,
+              reinterpret_cast<Bytef const*>(data.data()),
+              data.size(),
+              level);
+  if (rc != Z_OK) {
+    LBANN_ERROR("zlib failed to compress ", size, " bytes (error ", rc, ")");
+  }
+  out.resize(sizeof(size) + compressed_size);
+  return out;
+}
+
+std::string decompress_string(std::string const& data)
+{
+  uint64_t size = 0;
+  if (data.size() < sizeof(size)) {
+    LBANN_ERROR("compressed buffer is too small (", data.size(), " bytes)");
+  }
+  std::memcpy(&size, data.data(), sizeof(size));
+  std::string out(size, '\0');
+  uLongf out_size = size;
+  const int rc =
+    uncompress(reinterpret_cast<Bytef*>(&out[0]),
+               &out_size,
+               reinterpret_cast<Bytef const*>(data.data() + sizeof(size)),
+               data.size() - sizeof(size));
+  if (rc != Z_OK || out_size != size) {
+    LBANN_ERROR("zlib failed to decompress ", size, " bytes (error ", rc, ")");
+  }
+  return out;
+}
+
+} // namespace utils
+} // namespace lbann
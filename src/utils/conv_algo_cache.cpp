@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/conv_algo_cache.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/argument_parser.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/options.hpp"
+
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace lbann {
+namespace conv_algo_cache {
+
+namespace {
+
+std::mutex cache_mutex;
+bool cache_loaded = false;
+std::string cache_filename;
+std::unordered_map<std::string, int> cache;
+
+/** Add the "<key>\t<algo>" lines of a cache file. */
+void parse_cache(const std::string& contents)
+{
+  std::istringstream in(contents);
+  std::string line;
+  while (std::getline(in, line)) {
+    const size_t tab = line.rfind('\t');
+    if (tab == std::string::npos || tab == 0) {
+      continue;
+    }
+    try {
+      cache[line.substr(0, tab)] = std::stoi(line.substr(tab + 1));
+    }
+    catch (const std::exception&) {
+      // Skip lines truncated by an interrupted run
+    }
+  }
+}
+
+} // namespace
+
+void load(lbann_comm& comm)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  if (cache_loaded) {
+    return;
+  }
+  cache_loaded = true;
+  cache_filename =
+    global_argument_parser().get<std::string>(LBANN_OPTION_CONV_ALGO_CACHE);
+  if (cache_filename.empty()) {
+    return;
+  }
+  std::vector<char> contents;
+  if (comm.am_world_master()) {
+    std::ifstream in(cache_filename, std::ios::binary);
+    if (in) {
+      contents.assign(std::istreambuf_iterator<char>(in),
+                      std::istreambuf_iterator<char>());
+    }
+  }
+  comm.world_broadcast(comm.get_world_master(), contents);
+  parse_cache(std::string(contents.begin(), contents.end()));
+}
+
+bool find(const std::string& key, int& algo)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  const auto it = cache.find(key);
+  if (it == cache.end()) {
+    return false;
+  }
+  algo = it->second;
+  return true;
+}
+
+void insert(const lbann_comm& comm, const std::string& key, int algo)
+{
+  std::lock_guard<std::mutex> lock(cache_mutex);
+  cache[key] = algo;
+  if (cache_filename.empty() || !comm.am_world_master()) {
+    return;
+  }
+  std::ofstream out(cache_filename, std::ios::app);
+  if (!(out << key << '\t' << algo << '\n')) {
+    LBANN_WARNING("could not write convolution algorithm cache ",
+                  cache_filename);
+  }
+}
+
+} // namespace conv_algo_cache
+} // namespace lbann
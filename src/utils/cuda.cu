@@ -54,6 +54,34 @@ dim3 max_grid_dims()
   return max_grid_dims_;
 }
 
+// -------------------------------------------------------------
+// Memory pool
+// -------------------------------------------------------------
+
+memory_pool_usage get_memory_pool_usage()
+{
+  memory_pool_usage usage;
+#ifdef HYDROGEN_HAVE_CUB
+  // Read without the pool's lock; the counters are only reported
+  int device = 0;
+  CHECK_CUDA(cudaGetDevice(&device));
+  auto const& cached_bytes = El::cub::MemoryPool().cached_bytes;
+  auto const it = cached_bytes.find(device);
+  if (it != cached_bytes.end()) {
+    usage.live_bytes = it->second.live;
+    usage.cached_bytes = it->second.free;
+  }
+#endif // HYDROGEN_HAVE_CUB
+  return usage;
+}
+
+void trim_memory_pool()
+{
+#ifdef HYDROGEN_HAVE_CUB
+  CHECK_CUDA(El::cub::MemoryPool().FreeAllCached());
+#endif // HYDROGEN_HAVE_CUB
+}
+
 } // namespace gpu_lib
 } // namespace lbann
 
@@ -64,15 +92,20 @@ namespace cuda {
 // event_wrapper
 // -------------------------------------------------------------
 
-event_wrapper::event_wrapper() : m_event(nullptr), m_stream(0)
+event_wrapper::event_wrapper() : event_wrapper(false) {}
+
+event_wrapper::event_wrapper(bool timing)
+  : m_event(nullptr), m_timing(timing), m_stream(0)
 {
-  CHECK_CUDA(cudaEventCreateWithFlags(&m_event, cudaEventDisableTiming));
+  const auto flags = m_timing ? cudaEventDefault : cudaEventDisableTiming;
+  CHECK_CUDA(cudaEventCreateWithFlags(&m_event, flags));
 }
 
 event_wrapper::event_wrapper(const event_wrapper& other)
-  : m_event(nullptr), m_stream(other.m_stream)
+  : m_event(nullptr), m_timing(other.m_timing), m_stream(other.m_stream)
 {
-  CHECK_CUDA(cudaEventCreateWithFlags(&m_event, cudaEventDisableTiming));
+  const auto flags = m_timing ? cudaEventDefault : cudaEventDisableTiming;
+  CHECK_CUDA(cudaEventCreateWithFlags(&m_event, flags));
   if (!other.query()) {
     record(m_stream);
   }
@@ -111,6 +144,13 @@ bool event_wrapper::query() const
 
 void event_wrapper::synchronize() { CHECK_CUDA(cudaEventSynchronize(m_event)); }
 
+float event_wrapper::elapsed_time(const event_wrapper& start) const
+{
+  float ms = 0.f;
+  CHECK_CUDA(cudaEventElapsedTime(&ms, start.m_event, m_event));
+  return ms;
+}
+
 cudaEvent_t& event_wrapper::get_event() { return m_event; }
 
 // -----------------------------
@@ -30,6 +30,8 @@
 #include "lbann/utils/dnn_lib/helpers.hpp"
 #endif // LBANN_HAS_DNN_LIB
 #include "lbann/layers/layer.hpp"
+#include "lbann/utils/timer.hpp"
+#include <algorithm>
 #include <cstdlib>
 
 #ifdef LBANN_HAS_DISTCONV
@@ -66,6 +68,11 @@ int opt_num_pre_generated_synthetic_data = 0;
 bool opt_deterministic = false;
 int opt_num_io_partitions = 1;
 bool opt_cosmoflow_parallel_io = false;
+bool opt_overlap_halo_exchange = false;
+bool opt_autotune_decomposition = false;
+
+bool costs_measured = false;
+cost_measurements measured_costs;
 
 void set_options()
 {
@@ -119,6 +126,12 @@ void set_options()
   if (env) {
     opt_cosmoflow_parallel_io = true;
   }
+  if (std::getenv("LBANN_DISTCONV_OVERLAP_HALO_EXCHANGE")) {
+    opt_overlap_halo_exchange = true;
+  }
+  if (std::getenv("LBANN_DISTCONV_AUTOTUNE_DECOMPOSITION")) {
+    opt_autotune_decomposition = true;
+  }
   options_set = true;
 }
 
@@ -144,6 +157,9 @@ void print_options(std::ostream& os)
     ss << "  deterministic: " << opt_deterministic << std::endl;
     ss << "  num_io_partitions: " << opt_num_io_partitions << std::endl;
     ss << "  cosmoflow_parallel_io: " << opt_cosmoflow_parallel_io << std::endl;
+    ss << "  overlap_halo_exchange: " << opt_overlap_halo_exchange << std::endl;
+    ss << "  autotune_decomposition: " << opt_autotune_decomposition
+       << std::endl;
     os << ss.str();
   }
 }
@@ -304,6 +320,9 @@ void initialize(MPI_Comm comm)
     new AlCommType(mpi_comm, default_hydrogen_stream());
   ::distconv::backend::Options backend_opts;
   backend_opts.m_deterministic = opt_deterministic;
+  // Convolutions compute the interior of their local tensors while
+  // the halo is exchanged, then the boundary
+  backend_opts.m_overlap_halo_exchange = opt_overlap_halo_exchange;
   backend_instance = new Backend(mpi_comm,
                                  lbann::dnn_lib::get_handle(),
                                  default_hydrogen_stream(),
@@ -381,6 +400,88 @@ int get_number_of_io_partitions() { return opt_num_io_partitions; }
 
 bool is_cosmoflow_parallel_io_enabled() { return opt_cosmoflow_parallel_io; }
 
+bool is_halo_exchange_overlapped() { return opt_overlap_halo_exchange; }
+
+bool is_decomposition_autotuned() { return opt_autotune_decomposition; }
+
+namespace {
+
+/** Seconds per exchange of @c size bytes with a neighbor rank,
+ *  maximized over the ranks.
+ */
+double time_exchange(size_t size, int reps)
+{
+  const int rank = get_mpi_rank();
+  const int num_ranks = get_mpi_num_ranks();
+  const int partner = ((rank ^ 1) < num_ranks) ? (rank ^ 1) : rank;
+  std::vector<char> send_buf(size, 0), recv_buf(size);
+  MPI_Barrier(get_mpi_comm());
+  const double start = get_time();
+  for (int i = 0; i < reps; ++i) {
+    MPI_Sendrecv(send_buf.data(),
+                 static_cast<int>(size),
+                 MPI_BYTE,
+                 partner,
+                 0,
+                 recv_buf.data(),
+                 static_cast<int>(size),
+                 MPI_BYTE,
+                 partner,
+                 0,
+                 get_mpi_comm(),
+                 MPI_STATUS_IGNORE);
+  }
+  double time = (get_time() - start) / reps;
+  MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, get_mpi_comm());
+  return time;
+}
+
+/** Seconds per flop of a GPU GEMM, maximized over the ranks. */
+double time_flop(int reps)
+{
+  constexpr El::Int size = 1024;
+  El::Matrix<float, El::Device::GPU> A(size, size), B(size, size),
+    C(size, size);
+  El::Fill(A, 1.f);
+  El::Fill(B, 1.f);
+  // Warm up the GEMM library
+  El::Gemm(El::NORMAL, El::NORMAL, 1.f, A, B, 0.f, C);
+  hydrogen::gpu::SynchronizeDevice();
+  const double start = get_time();
+  for (int i = 0; i < reps; ++i) {
+    El::Gemm(El::NORMAL, El::NORMAL, 1.f, A, B, 0.f, C);
+  }
+  hydrogen::gpu::SynchronizeDevice();
+  double time = (get_time() - start) / (reps * 2.0 * size * size * size);
+  MPI_Allreduce(MPI_IN_PLACE, &time, 1, MPI_DOUBLE, MPI_MAX, get_mpi_comm());
+  return time;
+}
+
+} // namespace
+
+const cost_measurements& get_cost_measurements()
+{
+  if (!costs_measured) {
+    constexpr size_t small_size = 8;
+    constexpr size_t large_size = 1 << 22;
+    const double small_time = time_exchange(small_size, 100);
+    const double large_time = time_exchange(large_size, 10);
+    measured_costs.latency = small_time;
+    measured_costs.byte_time = std::max(large_time - small_time, 0.0) /
+                               static_cast<double>(large_size - small_size);
+    measured_costs.flop_time = time_flop(10);
+    costs_measured = true;
+    if (is_mpi_root()) {
+      std::cout << "Distconv cost measurements: latency "
+                << measured_costs.latency << " s, "
+                << 1.0 / measured_costs.byte_time / 1e9 << " GB/s, "
+                << 1.0 / measured_costs.flop_time / 1e12 << " TFLOP/s"
+                << std::endl;
+    }
+  }
+  return measured_costs;
+}
+
 AlCommType& get_hosttransfer() { return *hosttransfer_comm_instance; }
 
 Backend& get_backend() { return *backend_instance; }
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/file_stager.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/file_utils.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace lbann {
+
+namespace {
+
+/// Size of the reads and writes of a copy
+constexpr size_t stage_buffer_size = 16 * 1024 * 1024;
+
+} // namespace
+
+file_stager::file_stager(const std::string& src_dir,
+                         const std::string& dst_dir,
+                         std::vector<std::string> files,
+                         std::vector<size_t> to_copy)
+  : m_src_dir(add_delimiter(src_dir)),
+    m_dst_dir(add_delimiter(dst_dir)),
+    m_files(std::move(files)),
+    m_staged(new std::atomic<bool>[m_files.size()]),
+    m_stop(false),
+    m_done(false)
+{
+  for (size_t i = 0; i < m_files.size(); ++i) {
+    m_staged[i] = false;
+  }
+  file::make_directory(m_dst_dir);
+  m_thread = std::thread(&file_stager::run, this, std::move(to_copy));
+}
+
+file_stager::~file_stager()
+{
+  m_stop = true;
+  if (m_thread.joinable()) {
+    m_thread.join();
+  }
+}
+
+std::string file_stager::path(size_t i) const
+{
+  const std::string local = m_dst_dir + m_files[i];
+  if (m_staged[i]) {
+    return local;
+  }
+  if (file::file_exists(local)) {
+    m_staged[i] = true;
+    return local;
+  }
+  return m_src_dir + m_files[i];
+}
+
+void file_stager::run(std::vector<size_t> to_copy)
+{
+  for (const size_t i : to_copy) {
+    if (m_stop) {
+      break;
+    }
+    try {
+      copy_file(i);
+    }
+    catch (lbann_exception const& e) {
+      // The file is then read from its original location
+      LBANN_WARNING("could not stage ", m_files[i], ": ", e.what());
+    }
+  }
+  m_done = true;
+}
+
+void file_stager::copy_file(size_t i)
+{
+  const std::string src = m_src_dir + m_files[i];
+  const std::string dst = m_dst_dir + m_files[i];
+
+  const int in = ::open(src.c_str(), O_RDONLY);
+  if (in < 0) {
+    LBANN_ERROR("can't open file: ", src, "; ", std::strerror(errno));
+  }
+  struct ::stat src_st, dst_st;
+  if (::fstat(in, &src_st) != 0) {
+    ::close(in);
+    LBANN_ERROR("can't stat file: ", src, "; ", std::strerror(errno));
+  }
+  // A copy left by an earlier job
+  if (::stat(dst.c_str(), &dst_st) == 0 && dst_st.st_size == src_st.st_size) {
+    ::close(in);
+    m_staged[i] = true;
+    return;
+  }
+  ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+  file::make_directory(file::extract_parent_directory(dst));
+  const std::string tmp = dst + ".tmp" + std::to_string(::getpid());
+  const int out = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (out < 0) {
+    ::close(in);
+    LBANN_ERROR("can't create file: ", tmp, "; ", std::strerror(errno));
+  }
+  auto fail = [&](const char* what, const std::string& path) {
+    const int err = errno;
+    ::close(in);
+    ::close(out);
+    std::remove(tmp.c_str());
+    LBANN_ERROR("failed to ", what, " ", path, "; ", std::strerror(err));
+  };
+
+  std::vector<char> buffer(stage_buffer_size);
+  for (;;) {
+    if (m_stop) {
+      errno = ECANCELED;
+      fail("copy", src);
+    }
+    const ssize_t n = ::read(in, buffer.data(), buffer.size());
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n < 0) {
+      fail("read", src);
+    }
+    if (n == 0) {
+      break;
+    }
+    for (ssize_t done = 0; done < n;) {
+      const ssize_t w = ::write(out, buffer.data() + done, n - done);
+      if (w < 0 && errno == EINTR) {
+        continue;
+      }
+      if (w < 0) {
+        fail("write", tmp);
+      }
+      done += w;
+    }
+  }
+  ::close(in);
+  if (::close(out) != 0 || std::rename(tmp.c_str(), dst.c_str()) != 0) {
+    const int err = errno;
+    std::remove(tmp.c_str());
+    LBANN_ERROR("failed to stage ", src, " as ", dst, "; ", std::strerror(err));
+  }
+  m_staged[i] = true;
+}
+
+} // namespace lbann
@@ -27,15 +27,20 @@
 /// @todo Rename this file to file.cpp.
 
 #include "lbann/utils/file_utils.hpp"
+#include "lbann/data_coordinator/io_trace.hpp"
 #include "lbann/utils/exception.hpp"
 
 #include <algorithm>
 #include <cstdlib>
+#include <cstring>
 #include <errno.h>
+#include <fcntl.h>
 #include <fstream>
 #include <libgen.h>
 #include <sstream>
+#include <sys/mman.h>
 #include <sys/stat.h>
+#include <unistd.h>
 
 namespace lbann {
 
@@ -187,6 +192,7 @@ bool create_dir(const std::string dirname)
 /// Load a file into a buffer
 bool load_file(const std::string filename, std::vector<char>& buf, bool append)
 {
+  io_trace_scope trace(io_trace_op::read, filename, 0);
   std::ifstream file(filename, std::ios::binary);
   if (!file.good()) {
     LBANN_ERROR("!file.good() for filename: ", filename);
@@ -204,6 +210,7 @@ bool load_file(const std::string filename, std::vector<char>& buf, bool append)
   }
   const size_t cur_size = buf.size();
   buf.resize(static_cast<size_t>(file_size) + cur_size);
+  trace.set_length(file_size);
 
   file.read(buf.data() + cur_size, file_size);
 
@@ -291,6 +298,34 @@ void remove_multiple_slashes(std::string& str)
   str = s.str();
 }
 
+std::pair<std::shared_ptr<const void>, size_t>
+map_read_only(const std::string& path)
+{
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    LBANN_ERROR("can't open file: ", path, "; ", std::strerror(errno));
+  }
+  struct ::stat st;
+  if (::fstat(fd, &st) != 0) {
+    ::close(fd);
+    LBANN_ERROR("can't stat file: ", path, "; ", std::strerror(errno));
+  }
+  const size_t size = st.st_size;
+  if (size == 0) {
+    ::close(fd);
+    LBANN_ERROR("can't map empty file: ", path);
+  }
+  void* const addr = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (addr == MAP_FAILED) {
+    LBANN_ERROR("failed to mmap ", path, "; ", std::strerror(errno));
+  }
+  return {std::shared_ptr<const void>(
+            addr,
+            [size](const void* p) { ::munmap(const_cast<void*>(p), size); }),
+          size};
+}
+
 } // namespace file
 
 } // namespace lbann
@@ -34,6 +34,19 @@
 namespace lbann {
 namespace graph {
 
+namespace {
+
+/** Neighbors of a node, without copying them like get_neighbors. */
+const std::set<El::Int>&
+neighbors_of(El::Int node, const std::map<El::Int, std::set<El::Int>>& edges)
+{
+  static const std::set<El::Int> no_neighbors;
+  const auto it = edges.find(node);
+  return it != edges.end() ? it->second : no_neighbors;
+}
+
+} // namespace
+
 void print(const std::set<El::Int>& nodes,
            const std::map<El::Int, std::set<El::Int>>& edges,
            std::ostream& os = std::cout)
@@ -62,7 +75,7 @@ bool is_closure(const std::set<El::Int>& nodes,
                 const std::map<El::Int, std::set<El::Int>>& edges)
 {
   for (const auto& node : nodes) {
-    for (const auto& neighbor : get_neighbors(node, edges)) {
+    for (const auto& neighbor : neighbors_of(node, edges)) {
       if (nodes.count(neighbor) == 0) {
         return false;
       }
@@ -78,7 +91,7 @@ bool is_topologically_sorted(const std::set<El::Int>& nodes,
     LBANN_ERROR("graph is not a closure");
   }
   for (const auto& node : nodes) {
-    const auto& neighbors = get_neighbors(node, edges);
+    const auto& neighbors = neighbors_of(node, edges);
     if (neighbors.size() > 0 && *neighbors.begin() <= node) {
       return false;
     }
@@ -116,7 +129,7 @@ bool is_cyclic(const std::set<El::Int>& nodes,
       else {
         is_visited[node] = true;
         search_stack.push(node);
-        for (const auto& neighbor : get_neighbors(node, edges)) {
+        for (const auto& neighbor : neighbors_of(node, edges)) {
           if (is_visited[neighbor] && !is_sorted[neighbor]) {
             return true;
           }
@@ -137,7 +150,7 @@ transpose(const std::set<El::Int>& nodes,
   }
   std::map<El::Int, std::set<El::Int>> transpose_edges;
   for (const auto& node : nodes) {
-    for (const auto& neighbor : get_neighbors(node, edges)) {
+    for (const auto& neighbor : neighbors_of(node, edges)) {
       transpose_edges[neighbor].insert(node);
     }
   }
@@ -150,7 +163,7 @@ induce_subgraph(const std::set<El::Int>& nodes,
 {
   std::map<El::Int, std::set<El::Int>> induced_edges;
   for (const auto& node : nodes) {
-    for (const auto& neighbor : get_neighbors(node, edges)) {
+    for (const auto& neighbor : neighbors_of(node, edges)) {
       if (nodes.count(neighbor) > 0) {
         induced_edges[node].insert(neighbor);
       }
@@ -174,7 +187,7 @@ breadth_first_search(El::Int root,
   while (!search_queue.empty()) {
     const auto& node = search_queue.front();
     search_queue.pop();
-    for (const auto& neighbor : get_neighbors(node, edges)) {
+    for (const auto& neighbor : neighbors_of(node, edges)) {
       if (!is_visited[neighbor]) {
         is_visited[neighbor] = true;
         sorted_nodes.push_back(neighbor);
@@ -212,7 +225,7 @@ depth_first_search(El::Int root,
         // Visit node and add neighbors to search stack
         is_visited[node] = true;
         search_stack.push(node);
-        for (const auto& neighbor : get_neighbors(node, edges)) {
+        for (const auto& neighbor : neighbors_of(node, edges)) {
           if (!is_visited[neighbor] && !is_sorted[neighbor]) {
             search_stack.push(neighbor);
           }
@@ -244,27 +257,41 @@ topological_sort(const std::set<El::Int>& nodes,
     return std::vector<El::Int>(nodes.begin(), nodes.end());
   }
 
-  // Perform depth-first searches on nodes
-  std::stack<El::Int> sorted_stack;
-  std::unordered_map<El::Int, bool> is_sorted;
+  // Perform depth-first searches on nodes. The searches share their
+  // state, so each node and edge is only visited once.
+  std::vector<El::Int> sorted_nodes;
+  sorted_nodes.reserve(nodes.size());
+  std::unordered_map<El::Int, bool> is_visited, is_sorted;
+  std::stack<El::Int> search_stack;
   for (const auto& root : nodes) {
-    if (!is_sorted[root]) {
-      const auto& dfs = depth_first_search(root, edges);
-      for (const auto& node : dfs) {
-        if (!is_sorted[node]) {
-          is_sorted[node] = true;
-          sorted_stack.push(node);
+    if (is_visited[root]) {
+      continue;
+    }
+    search_stack.push(root);
+    while (!search_stack.empty()) {
+      const auto node = search_stack.top();
+      search_stack.pop();
+      if (is_sorted[node]) {
+        continue;
+      }
+      if (is_visited[node]) {
+        is_sorted[node] = true;
+        sorted_nodes.push_back(node);
+      }
+      else {
+        is_visited[node] = true;
+        search_stack.push(node);
+        for (const auto& neighbor : neighbors_of(node, edges)) {
+          if (!is_visited[neighbor] && !is_sorted[neighbor]) {
+            search_stack.push(neighbor);
+          }
         }
       }
     }
   }
 
   // Reverse DFS post-order is topologically sorted
-  std::vector<El::Int> sorted_nodes;
-  while (!sorted_stack.empty()) {
-    sorted_nodes.push_back(sorted_stack.top());
-    sorted_stack.pop();
-  }
+  std::reverse(sorted_nodes.begin(), sorted_nodes.end());
   return sorted_nodes;
 }
 
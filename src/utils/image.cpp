@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/utils/image.hpp"
+#include "lbann/data_coordinator/io_trace.hpp"
 #include "lbann/utils/dim_helpers.hpp"
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/opencv.hpp"
@@ -41,6 +42,7 @@ void read_file_to_buf(const std::string& filename,
                       El::Matrix<uint8_t>& buf,
                       size_t& size)
 {
+  io_trace_scope trace(io_trace_op::read, filename, 0);
   FILE* f = fopen(filename.c_str(), "r");
   if (f == nullptr) {
     LBANN_ERROR("Could not open file " + filename);
@@ -54,6 +56,7 @@ void read_file_to_buf(const std::string& filename,
     LBANN_ERROR("Could not get offset in file " + filename);
   }
   size = static_cast<size_t>(size_);
+  trace.set_length(size);
   rewind(f);
   // Allocate sufficient space and read.
   buf.Resize(size, 1);
@@ -123,7 +126,8 @@ void guess_image_size(const El::Matrix<uint8_t>& buf_,
           memcpy(h_w, &buf[cur_pos], 4);
           height = ntohs(h_w[0]);
           width = ntohs(h_w[1]);
-          channels = 3; // Assume color.
+          // Number of components; anything but greyscale decodes as color.
+          channels = (buf[cur_pos + 4] == 1 ? 1 : 3);
           return;
         }
         else {
@@ -218,6 +222,47 @@ void opencv_decode(El::Matrix<uint8_t>& buf,
   }
 }
 
+// Decode a JPEG image at 1/reduction of its size, using libjpeg's
+// DCT scaling through OpenCV.
+void opencv_decode_reduced(El::Matrix<uint8_t>& buf,
+                           El::Matrix<uint8_t>& dst,
+                           std::vector<size_t>& dims,
+                           size_t channels,
+                           int reduction)
+{
+  int flags = 0;
+  switch (reduction) {
+  case 2:
+    flags = (channels == 1 ? cv::IMREAD_REDUCED_GRAYSCALE_2
+                           : cv::IMREAD_REDUCED_COLOR_2);
+    break;
+  case 4:
+    flags = (channels == 1 ? cv::IMREAD_REDUCED_GRAYSCALE_4
+                           : cv::IMREAD_REDUCED_COLOR_4);
+    break;
+  case 8:
+    flags = (channels == 1 ? cv::IMREAD_REDUCED_GRAYSCALE_8
+                           : cv::IMREAD_REDUCED_COLOR_8);
+    break;
+  default:
+    LBANN_ERROR("Unsupported image decode reduction ", reduction);
+  }
+  const size_t encoded_size = buf.Height() * buf.Width();
+  std::vector<size_t> buf_dims = {1, encoded_size, 1};
+  cv::Mat cv_encoded = utils::get_opencv_mat(buf, buf_dims);
+  cv::Mat decoded = cv::imdecode(cv_encoded, flags);
+  if (decoded.type() != CV_8UC1 && decoded.type() != CV_8UC3) {
+    LBANN_ERROR("Only support 8-bit 1- or 3-channel images, cannot load "
+                "encoded image");
+  }
+  dims = {decoded.type() == CV_8UC1 ? 1ull : 3ull,
+          static_cast<size_t>(decoded.rows),
+          static_cast<size_t>(decoded.cols)};
+  dst.Resize(get_linear_size(dims), 1);
+  cv::Mat cv_dst = utils::get_opencv_mat(dst, dims);
+  decoded.copyTo(cv_dst);
+}
+
 } // anonymous namespace
 
 void load_image(const std::string& filename,
@@ -238,6 +283,40 @@ void decode_image(El::Matrix<uint8_t>& src,
   opencv_decode(src, dst, dims, "encoded image");
 }
 
+void decode_image(El::Matrix<uint8_t>& src,
+                  El::Matrix<uint8_t>& dst,
+                  std::vector<size_t>& dims,
+                  int reduction)
+{
+  size_t height, width, channels;
+  if (reduction == 1 || !get_jpeg_size(src, height, width, channels)) {
+    opencv_decode(src, dst, dims, "encoded image");
+  }
+  else {
+    opencv_decode_reduced(src, dst, dims, channels, reduction);
+  }
+}
+
+void load_encoded_image(const std::string& filename, El::Matrix<uint8_t>& buf)
+{
+  size_t encoded_size;
+  read_file_to_buf(filename, buf, encoded_size);
+}
+
+bool get_jpeg_size(const El::Matrix<uint8_t>& src,
+                   size_t& height,
+                   size_t& width,
+                   size_t& channels)
+{
+  const size_t size = src.Height() * src.Width();
+  const uint8_t* buf = src.LockedBuffer();
+  if (size < 2 || buf[0] != 0xFF || buf[1] != 0xD8) {
+    return false;
+  }
+  guess_image_size(src, size, height, width, channels);
+  return height != 0 && width != 0;
+}
+
 void save_image(const std::string& filename,
                 El::Matrix<uint8_t>& src,
                 const std::vector<size_t>& dims)
@@ -46,6 +46,8 @@
 
 #include "lbann/proto/lbann.pb.h"
 #include "lbann/proto/model.pb.h"
+#include <algorithm>
+#include <cstdio>
 #include <cstdlib>
 #include <memory>
 
@@ -78,6 +80,7 @@ std::unique_ptr<model> load_inference_model(lbann_comm* lc,
   // Must use a mock datareader with input and output dims for setup
   // TODO: avoid need for datareader altogether
   auto dr_metadata = mock_dr_metadata(input_dims, output_dims);
+  m->set_inference_only(true);
   m->setup(mbs, dr_metadata, get_trainer().get_grids());
 
   return m;
@@ -103,13 +106,29 @@ int allocate_trainer_resources(lbann_comm* comm)
   if (procs_per_trainer == 0) {
     procs_per_trainer = comm->get_procs_in_world();
   }
+  const auto placement_name =
+    arg_parser.get<std::string>(LBANN_OPTION_TRAINER_PLACEMENT);
+  TrainerPlacement placement;
+  if (placement_name == "consecutive") {
+    placement = TrainerPlacement::CONSECUTIVE;
+  }
+  else if (placement_name == "node") {
+    placement = TrainerPlacement::NODE;
+  }
+  else if (placement_name == "group") {
+    placement = TrainerPlacement::GROUP;
+  }
+  else {
+    LBANN_ERROR("unknown trainer placement \"", placement_name, "\"");
+  }
 
   // Set up the communicator and get the grid based on the commandline spec.
   // We do not currently support splitting different trainers in different ways,
   // as this implies different grids.
   if (procs_per_trainer != comm->get_procs_per_trainer() ||
-      trainer_grid_height != comm->get_trainer_grid().Height()) {
-    comm->split_trainers(procs_per_trainer, trainer_grid_height);
+      trainer_grid_height != comm->get_trainer_grid().Height() ||
+      placement != TrainerPlacement::CONSECUTIVE) {
+    comm->split_trainers(procs_per_trainer, trainer_grid_height, placement);
   }
 
   // Split trainer when sub-grid parallelism is enabled
@@ -120,6 +139,9 @@ int allocate_trainer_resources(lbann_comm* comm)
                              trainer_topo_aware_subgrid);
   }
 
+  comm->set_hierarchical_allreduce(
+    arg_parser.get<bool>(LBANN_OPTION_HIERARCHICAL_ALLREDUCE));
+
   return procs_per_trainer;
 }
 
@@ -364,6 +386,30 @@ trainer& construct_trainer(lbann_comm* comm,
 }
 
 // Setup I/O thread pool that is shared across all models
+bool finish_resize_request(lbann_comm& comm, trainer& t)
+{
+  int requested = 0;
+  std::string request_file;
+  for (auto&& c : t.get_callbacks()) {
+    auto* const cb = dynamic_cast<callback::checkpoint*>(c);
+    if (cb != nullptr && !cb->get_resize_request_file().empty()) {
+      requested = std::max(requested, int{cb->resize_requested()});
+      request_file = cb->get_resize_request_file();
+    }
+  }
+  requested = comm.allreduce(requested, comm.get_world_comm(), El::mpi::MAX);
+  if (requested == 0) {
+    return false;
+  }
+  if (comm.am_world_master()) {
+    std::remove(request_file.c_str());
+    std::cout << "Training stopped for a resize request. Relaunch with "
+              << "the new number of ranks to resume from the checkpoint."
+              << std::endl;
+  }
+  return true;
+}
+
 std::unique_ptr<thread_pool> construct_io_thread_pool(lbann_comm* comm,
                                                       bool serialized_io)
 {
@@ -903,7 +903,8 @@ template <typename TensorDataType>
 void set_data_parallel_tensor_desc(
   TensorDescriptor& desc,
   std::vector<int> dims,
-  const El::AbstractMatrix<TensorDataType>& local_data)
+  const El::AbstractMatrix<TensorDataType>& local_data,
+  bool channels_last)
 {
 #ifdef LBANN_DEBUG
   if (local_data.GetDevice() != El::Device::GPU) {
@@ -911,12 +912,9 @@ void set_data_parallel_tensor_desc(
   }
 #endif // LBANN_DEBUG
   if (local_data.Height() > 0 && local_data.Width() > 0) {
-    std::vector<int> strides(dims.size(), 1);
-    for (int i = strides.size() - 1; i > 0; --i) {
-      strides[i - 1] = strides[i] * dims[i];
-    }
     dims.insert(dims.begin(), local_data.Width());
-    strides.insert(strides.begin(), local_data.LDim());
+    auto strides = get_packed_strides(dims, channels_last);
+    strides.front() = local_data.LDim();
     desc.set(get_data_type<TensorDataType>(), dims, strides);
   }
 }
@@ -936,7 +934,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_prev_activations(
   const auto& dims = this->m_layer->get_input_dims(parent_index);
   this->set_num_parents(this->m_layer->get_num_parents());
   auto& desc = this->m_prev_activations[parent_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                this->m_channels_last);
   return desc;
 }
 
@@ -952,7 +953,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_activations(
   const auto& dims = this->m_layer->get_output_dims(child_index);
   this->set_num_children(this->m_layer->get_num_children());
   auto& desc = this->m_activations[child_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                this->m_channels_last);
   return desc;
 }
 
@@ -969,7 +973,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_prev_error_signals(
   const auto& dims = this->m_layer->get_output_dims(child_index);
   this->set_num_children(this->m_layer->get_num_children());
   auto& desc = this->m_prev_error_signals[child_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                this->m_channels_last);
   return desc;
 }
 
@@ -985,7 +992,10 @@ data_parallel_layer_tensor_manager<TensorDataType>::get_error_signals(
   const auto& dims = this->m_layer->get_input_dims(parent_index);
   this->set_num_parents(this->m_layer->get_num_parents());
   auto& desc = this->m_error_signals[parent_index];
-  set_data_parallel_tensor_desc<TensorDataType>(desc, dims, local_data);
+  set_data_parallel_tensor_desc<TensorDataType>(desc,
+                                                dims,
+                                                local_data,
+                                                this->m_channels_last);
   return desc;
 }
 
@@ -1450,6 +1460,18 @@ get_bwd_filter_algo_autotune(bool deterministic,
 
 } // namespace
 
+std::string get_algorithm_cache_tag()
+{
+  size_t major, minor, patch;
+  CHECK_MIOPEN(miopenGetVersion(&major, &minor, &patch));
+  int device = 0;
+  hipDeviceProp_t prop;
+  CHECK_ROCM(hipGetDevice(&device));
+  CHECK_ROCM(hipGetDeviceProperties(&prop, device));
+  return "miopen-" + std::to_string(major) + "." + std::to_string(minor) +
+         "." + std::to_string(patch) + " " + prop.name;
+}
+
 fwd_conv_alg get_fwd_algorithm(bool autotune,
                                bool deterministic,
                                const TensorDescriptor& input_desc,
@@ -38,6 +38,13 @@ void construct_std_options()
     LBANN_OPTION_DISABLE_BACKGROUND_IO_ACTIVITY,
     {"--disable_background_io_activity"},
     "[STD] prevent the input layers from fetching data in the background");
+  arg_parser.add_flag(
+    LBANN_OPTION_CONCAT_SLICE_VIEWS,
+    {"--concat_slice_views"},
+    utils::ENV("LBANN_CONCAT_SLICE_VIEWS"),
+    "[STD] Parents of a concatenate layer write their outputs directly "
+    "into its output tensor and slice layers output views of their "
+    "input tensor, when the tensors are contiguous in each sample");
   arg_parser.add_flag(
     LBANN_OPTION_DISABLE_CUDA,
     {"--disable_cuda"},
@@ -49,10 +56,53 @@ void construct_std_options()
   arg_parser.add_flag(LBANN_OPTION_EXIT_AFTER_SETUP,
                       {"--exit_after_setup"},
                       "[STD] Forces exit after model setup");
+  arg_parser.add_flag(
+    LBANN_OPTION_FLAT_WEIGHTS_STATE,
+    {"--flat_weights_state"},
+    utils::ENV("LBANN_FLAT_WEIGHTS_STATE"),
+    "[STD] Store the values and optimizer state of all weights in a few "
+    "flat buffers, one per data type and device, so that LTFB exchanges "
+    "them with one message per buffer");
+  arg_parser.add_flag(
+    LBANN_OPTION_FOLD_PERMUTES,
+    {"--fold_permutes"},
+    utils::ENV("LBANN_FOLD_PERMUTES"),
+    "[STD] Remove permute layers that are followed by their inverse, and "
+    "fold permute layers that swap the last two axes into a matmul "
+    "layer's transpose flags");
+  arg_parser.add_flag(
+    LBANN_OPTION_FUSE_OPTIMIZER_STEPS,
+    {"--fuse_optimizer_steps"},
+    utils::ENV("LBANN_FUSE_OPTIMIZER_STEPS"),
+    "[STD] Update the GPU weights that have the same optimizer type and "
+    "data type with one multi-tensor kernel launch per step instead of "
+    "one launch per weights object");
+  arg_parser.add_flag(
+    LBANN_OPTION_FUSE_RELU,
+    {"--fuse_relu"},
+    utils::ENV("LBANN_FUSE_RELU"),
+    "[STD] Fold ReLU layers into a preceding convolution, fully-connected "
+    "or batch normalization layer, which then applies the ReLU in place. "
+    "The folded ReLU layers are removed from the model");
   arg_parser.add_flag(LBANN_OPTION_GENERATE_MULTI_PROTO,
                       {"--generate_multi_proto"},
                       "[STD] Enables loading of multiple prototext files for "
                       "model, datareader, optimizer, etc. input options");
+  arg_parser.add_flag(
+    LBANN_OPTION_GPU_GRAPH_TRAINING,
+    {"--gpu_graph_training"},
+    utils::ENV("LBANN_GPU_GRAPH_TRAINING"),
+    "[STD] After a warmup step, capture the forward prop, backward prop "
+    "and weight update of each training step in CUDA graphs and launch "
+    "them. Steps fall back to eager execution when the mini-batch size "
+    "changes, a callback inspects tensors during the step, or the model "
+    "uses CPU layers, subgraph parallelism or several ranks per trainer");
+  arg_parser.add_flag(
+    LBANN_OPTION_HIERARCHICAL_ALLREDUCE,
+    {"--hierarchical_allreduce"},
+    utils::ENV("LBANN_HIERARCHICAL_ALLREDUCE"),
+    "[STD] Do large allreduces as a reduce-scatter within each compute "
+    "node, an allreduce across nodes and an allgather within the node");
   arg_parser.add_flag(
     LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR_IS_COMPLETE,
     {"--load_model_weights_dir_is_complete"},
@@ -83,6 +133,38 @@ void construct_std_options()
     {"--no_im_comm"},
     "[STD] removed ImComm callback, if present; this is intended for "
     "running alexnet with a single model, but may be useful elsewhere");
+  arg_parser.add_flag(
+    LBANN_OPTION_OVERLAP_OPTIMIZER_STEPS,
+    {"--overlap_optimizer_steps"},
+    utils::ENV("LBANN_OVERLAP_OPTIMIZER_STEPS"),
+    "[STD] Update each weights object whose optimizer step is local as "
+    "soon as its gradient allreduce completes, while the allreduces of "
+    "other weights are in progress");
+  arg_parser.add_flag(
+    LBANN_OPTION_PACK_EVALUATION_VALUES,
+    {"--pack_evaluation_values"},
+    utils::ENV("LBANN_PACK_EVALUATION_VALUES"),
+    "[STD] Pack the values of all evaluation layers, i.e. the loss and "
+    "metric terms, into one buffer per device that is allreduced once "
+    "at the end of forward prop, instead of one allreduce per term");
+  arg_parser.add_flag(
+    LBANN_OPTION_PLAN_ACTIVATION_MEMORY,
+    {"--plan_activation_memory"},
+    utils::ENV("LBANN_PLAN_ACTIVATION_MEMORY"),
+    "[STD] Free each layer output at the end of its lifetime (after the "
+    "forward prop of its last child in evaluation, after the layer's "
+    "backprop in training) so the memory pool can reuse it, and report "
+    "the planned peak activation memory. Callbacks that read layer "
+    "outputs after forward prop may see empty tensors");
+  arg_parser.add_flag(
+    LBANN_OPTION_PIPELINE_STAGES,
+    {"--pipeline_stages"},
+    utils::ENV("LBANN_PIPELINE_STAGES"),
+    "[STD] Partition the layers into consecutive pipeline stages, one "
+    "per sub-grid (see --num-subgrids-block-order), with equal numbers "
+    "of layers. Activations and gradients are "
+    "transferred between stages; combine with SGD micro-batches so the "
+    "stages overlap. Layers with a grid tag keep it");
   arg_parser.add_flag(LBANN_OPTION_PRELOAD_DATA_STORE,
                       {"--preload_data_store"},
                       "[STD] Preloads the data store in-memory structure "
@@ -95,6 +177,14 @@ void construct_std_options()
     LBANN_OPTION_SERIALIZE_IO,
     {"--serialize_io"},
     "[STD] force data readers to use a single threaded for I/O");
+  arg_parser.add_flag(
+    LBANN_OPTION_SHARD_WEIGHTS,
+    {"--shard_weights"},
+    utils::ENV("LBANN_SHARD_WEIGHTS"),
+    "[STD] Store replicated weights that are being optimized, their "
+    "gradients and their optimizer state in shards across the processes "
+    "of the trainer. Gradients are reduce-scattered and the weights are "
+    "gathered before forward prop");
   arg_parser.add_flag(LBANN_OPTION_ST_ON,
                       {"--st_on"},
                       "[STD] Enable stack profiler tracing");
@@ -139,6 +229,15 @@ void construct_std_options()
                       "[STD] Initialize NVSHMEM when initializing LBANN");
 
   // Input options
+  arg_parser.add_option(
+    LBANN_OPTION_CALIPER_CONFIG,
+    {"--caliper_config"},
+    utils::ENV("LBANN_CALIPER_CONFIG"),
+    "[STD] Caliper measurement of the profiling regions, e.g. "
+    "\"runtime-report,topdown.toplevel\" for a report of the time and "
+    "PAPI counters of each region, aggregated across ranks. "
+    "Requires LBANN to be built with Caliper.",
+    "");
   arg_parser.add_option(
     LBANN_OPTION_CKPT_DIR,
     {"--checkpoint_dir", "--ckpt_dir"},
@@ -146,10 +245,35 @@ void construct_std_options()
     "Additionally, sets the output directory for dumping weights.\n"
     "Modifies callbacks: checkpoint, save_model, dump_weights\n",
     "");
+  arg_parser.add_option(
+    LBANN_OPTION_CONV_ALGO_CACHE,
+    {"--conv_algo_cache"},
+    utils::ENV("LBANN_CONV_ALGO_CACHE"),
+    "[STD] File in which convolution layers keep the DNN library "
+    "algorithms they pick by autotuning, so later runs skip the search",
+    "");
+  arg_parser.add_option(LBANN_OPTION_GRADIENT_BUCKET_MB,
+                        {"--gradient_bucket_mb"},
+                        utils::ENV("LBANN_GRADIENT_BUCKET_MB"),
+                        "[STD] Size, in MB, of the flat buffers into which "
+                        "the gradients of replicated weights are packed in "
+                        "reverse layer order, so that each buffer is "
+                        "allreduced as soon as all of its gradients are "
+                        "computed, e.g. 25 (0 allreduces every gradient "
+                        "on its own).",
+                        0);
   arg_parser.add_option(LBANN_OPTION_HYDROGEN_BLOCK_SIZE,
                         {"--hydrogen_block_size"},
                         "[STD] Block size for Hydrogen",
                         0);
+  arg_parser.add_option(
+    LBANN_OPTION_IO_THREAD_DEVICE,
+    {"--io_thread_device"},
+    utils::ENV("LBANN_IO_THREAD_DEVICE"),
+    "[STD] PCI bus id or OS name (e.g. mlx5_0) of the device whose cores "
+    "run the I/O threads and hold their buffers; defaults to the rank's "
+    "GPU (requires hwloc)",
+    "");
   arg_parser.add_option(
     LBANN_OPTION_LOAD_MODEL_WEIGHTS_DIR,
     {"--load_model_weights_dir"},
@@ -168,6 +292,14 @@ void construct_std_options()
                         {"--metadata"},
                         "[STD] Metadata input file",
                         "");
+  arg_parser.add_option(LBANN_OPTION_MINI_BATCH_CACHE_MB,
+                        {"--mini_batch_cache_mb"},
+                        utils::ENV("LBANN_MINI_BATCH_CACHE_MB"),
+                        "[STD] Host memory, in MB per rank, used to keep the "
+                        "packed mini-batches of unshuffled validation and "
+                        "test sets so later passes skip the data reader "
+                        "(0 disables the cache).",
+                        0);
   arg_parser.add_option(LBANN_OPTION_MINI_BATCH_SIZE,
                         {"--mini_batch_size"},
                         "[STD] Size of mini batches",
@@ -176,16 +308,39 @@ void construct_std_options()
                         {"--model"},
                         "[STD] Model input file",
                         "");
+  arg_parser.add_option(LBANN_OPTION_NUM_BRANCH_STREAMS,
+                        {"--num_branch_streams"},
+                        utils::ENV("LBANN_NUM_BRANCH_STREAMS"),
+                        "[STD] Number of GPU streams, including the default "
+                        "one, on which independent branches of the layer "
+                        "graph run concurrently (0 or 1 runs every layer "
+                        "on the default stream).",
+                        0);
   arg_parser.add_option(LBANN_OPTION_NUM_EPOCHS,
                         {"--num_epochs"},
                         "[STD] Number of epochs to train model",
                         -1);
+  arg_parser.add_option(LBANN_OPTION_NUM_IO_BUFFERS,
+                        {"--num_io_buffers"},
+                        utils::ENV("LBANN_NUM_IO_BUFFERS"),
+                        "[STD] Number of mini-batch buffers per execution "
+                        "mode; background I/O runs up to this many minus "
+                        "one mini-batches ahead of the model.",
+                        2);
   arg_parser.add_option(LBANN_OPTION_NUM_IO_THREADS,
                         {"--num_io_threads"},
                         utils::ENV("LBANN_NUM_IO_THREADS"),
                         "[STD] Number of threads available to both I/O and "
                         "initial data transformations for each rank.",
                         64);
+  arg_parser.add_option(LBANN_OPTION_NUM_IO_WORKER_PROCESSES,
+                        {"--num_io_worker_processes"},
+                        utils::ENV("LBANN_NUM_IO_WORKER_PROCESSES"),
+                        "[STD] Number of processes forked by each reading "
+                        "rank to load samples into shared memory, so that "
+                        "decoding does not compete with the training "
+                        "process (0 loads samples in the I/O threads).",
+                        0);
   arg_parser.add_option(LBANN_OPTION_NUM_PARALLEL_READERS,
                         {"--num_parallel_readers"},
                         "[STD] The number of parallel data readers",
@@ -238,6 +393,15 @@ void construct_std_options()
                         "[STD] Height of 2D process grid for each trainer. "
                         "Default grid is approximately square.",
                         -1);
+  arg_parser.add_option(
+    LBANN_OPTION_TRAINER_PLACEMENT,
+    {"--trainer_placement"},
+    utils::ENV("LBANN_TRAINER_PLACEMENT"),
+    "[STD] How ranks are placed in trainers: consecutive (world ranks in "
+    "order), node (trainers fill compute nodes) or group (trainers fill "
+    "the groups of nodes given by LBANN_TOPOLOGY_GROUP, e.g. switches). "
+    "Default is consecutive.",
+    "consecutive");
   arg_parser.add_option(LBANN_OPTION_TRAINER_PRIMARY_GRID_SIZE,
                         {"--trainer_primary_grid_size"},
                         utils::ENV("LBANN_TRAINER_PRIMARY_GRID_SIZE"),
@@ -271,9 +435,25 @@ void construct_datastore_options()
   auto& arg_parser = global_argument_parser();
 
   // Bool flags
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_ARENA,
+    {"--data_store_arena"},
+    "[DATASTORE] When preloading, pack fixed-size samples into contiguous "
+    "arena slabs instead of allocating one buffer per sample");
   arg_parser.add_flag(LBANN_OPTION_DATA_STORE_CACHE,
                       {"--data_store_cache"},
                       "[DATASTORE] TODO");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_CACHE_SHARED,
+    {"--data_store_cache_shared"},
+    "[DATASTORE] With --data_store_cache, the trainers on a node share "
+    "one cache, which the first of them fills. Every trainer must fit in "
+    "a node and read the same data set");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_COMPRESS,
+    {"--data_store_compress"},
+    "[DATASTORE] When preloading, keep samples zlib-compressed in memory; "
+    "they are sent compressed and inflated by the rank that uses them");
   arg_parser.add_flag(LBANN_OPTION_DATA_STORE_DEBUG,
                       {"--data_store_debug"},
                       "[DATASTORE] Enables data store debug output for each "
@@ -282,6 +462,11 @@ void construct_datastore_options()
     LBANN_OPTION_DATA_STORE_FAIL,
     {"--data_store_fail"},
     "[DATASTORE] Forces data store to fail, used for testing purposes");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_LOCALITY_AWARE,
+    {"--data_store_locality_aware"},
+    "[DATASTORE] Reorder each shuffled mini-batch so that ranks consume "
+    "samples they (or a rank on their node) already own");
   arg_parser.add_flag(
     LBANN_OPTION_DATA_STORE_MIN_MAX_TIMING,
     {"--data_store_min_max_timing"},
@@ -294,6 +479,12 @@ void construct_datastore_options()
                       {"--data_store_profile"},
                       "[DATASTORE] Enable data store profiling output for each "
                       "<P_0, reader_role> pair");
+  arg_parser.add_flag(
+    LBANN_OPTION_DATA_STORE_SPILL_SEGMENTS,
+    {"--data_store_spill_segments"},
+    "[DATASTORE] With --data_store_spill, append samples to large segment "
+    "files instead of writing one file per sample, and read them back "
+    "through a DRAM cache that is prefetched in the background");
   arg_parser.add_flag(LBANN_OPTION_DATA_STORE_TEST_CACHE,
                       {"--data_store_test_cache"},
                       "[DATASTORE] Perform checks on imagenet data store "
@@ -304,11 +495,42 @@ void construct_datastore_options()
     "[DATASTORE] Allows Conduit data store nodes to have non-uniform sizes");
 
   // Input options
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_EXCHANGE_LOOKAHEAD,
+    {"--data_store_exchange_lookahead"},
+    "[DATASTORE] Number of mini-batch exchanges the conduit data store "
+    "keeps in flight; values above 1 prefetch upcoming mini-batches",
+    1);
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_LOCALITY_RANDOMNESS,
+    {"--data_store_locality_randomness"},
+    "[DATASTORE] Fraction in [0,1] of each mini-batch that keeps its "
+    "shuffled placement when --data_store_locality_aware is given",
+    (float)0);
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_MEM_BUDGET_MB,
+    {"--data_store_mem_budget_mb"},
+    "[DATASTORE] Per-node memory budget in MB for preloaded samples; "
+    "samples that do not fit are read from file by the data reader. "
+    "0 means no budget",
+    0);
   arg_parser.add_option(
     LBANN_OPTION_DATA_STORE_SPILL,
     {"--data_store_spill"},
     "[DATASTORE] Base directory for conduit data store to spill data",
     "");
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_SPILL_CACHE_MB,
+    {"--data_store_spill_cache_mb"},
+    "[DATASTORE] Size in MB of the DRAM cache of spilled samples, used "
+    "with --data_store_spill_segments",
+    1024);
+  arg_parser.add_option(
+    LBANN_OPTION_DATA_STORE_SPILL_PREFETCH,
+    {"--data_store_spill_prefetch"},
+    "[DATASTORE] Number of upcoming mini-batches whose spilled samples "
+    "are prefetched, used with --data_store_spill_segments",
+    1);
   arg_parser.add_option(
     LBANN_OPTION_DATA_STORE_TEST_CHECKPOINT,
     {"--data_store_test_checkpoint"},
@@ -326,6 +548,23 @@ void construct_datareader_options()
     LBANN_OPTION_CHECK_DATA,
     {"--check_data"},
     "[DATAREADER] Checks if the data file exists for image datareader");
+  arg_parser.add_flag(
+    LBANN_OPTION_CSV_COLUMN_CACHE,
+    {"--csv_column_cache"},
+    utils::ENV("LBANN_CSV_COLUMN_CACHE"),
+    "[DATAREADER] CSV readers convert each file once into a columnar "
+    "binary cache next to it (<file>.lbcol) and memory map it");
+  arg_parser.add_flag(
+    LBANN_OPTION_DEFER_EVAL_READER_LOAD,
+    {"--defer_eval_reader_load"},
+    "[DATAREADER] Load the test and validation readers when they are "
+    "first used instead of before training starts");
+  arg_parser.add_flag(
+    LBANN_OPTION_FUSED_IMAGE_DECODE,
+    {"--fused_image_decode"},
+    "[DATAREADER] Image readers whose first transform is "
+    "random_resized_crop choose the crop from the JPEG header and decode "
+    "the image at a reduced DCT scale when the crop allows it");
   arg_parser.add_flag(
     LBANN_OPTION_KEEP_SAMPLE_ORDER,
     {"--keep_sample_order"},
@@ -340,10 +579,33 @@ void construct_datareader_options()
     {"--load_full_sample_list_once"},
     "[DATAREADER] Trainer master will load entire sample list into memory and "
     "then broadcast it to other workers within the trainer");
+  arg_parser.add_flag(
+    LBANN_OPTION_MMAP_NUMPY,
+    {"--mmap_numpy"},
+    "[DATAREADER] Numpy readers memory map uncompressed .npy files and "
+    ".npz members written by numpy.savez instead of loading them");
+  arg_parser.add_flag(
+    LBANN_OPTION_PERMUTATION_SHUFFLE,
+    {"--permutation_shuffle"},
+    "[DATAREADER] Reshuffle each epoch with a seeded permutation of sample "
+    "positions that is computed on demand instead of reordering the "
+    "sample indices");
   arg_parser.add_flag(
     LBANN_OPTION_QUIET,
     {"--quiet"},
     "[DATAREADER] Silences metadata output from HDF5 datareader");
+  arg_parser.add_flag(
+    LBANN_OPTION_RAW_INPUT_TRANSFER,
+    {"--raw_input_transfer"},
+    "[DATAREADER] Copy uint8 data fields to GPU input layers as bytes and "
+    "convert them to the compute type on the GPU; image readers also leave "
+    "to_lbann_layout and the affine transforms after it to the GPU");
+  arg_parser.add_flag(
+    LBANN_OPTION_SHARD_EVAL_ACROSS_TRAINERS,
+    {"--shard_eval_across_trainers"},
+    "[DATAREADER] Split the validation and test sets across trainers and "
+    "reduce their statistics across trainers. Only meaningful when every "
+    "trainer holds the same model");
   arg_parser.add_flag(LBANN_OPTION_WRITE_SAMPLE_LABEL_LIST,
                       {"--write_sample_label_list"},
                       "[DATAREADER] When enabled, the sample labels from image "
@@ -397,6 +659,20 @@ void construct_datareader_options()
                         {"--data_reader_percent"},
                         "[DATAREADER] Sets the percent of total samples to use",
                         (float)-1);
+  arg_parser.add_option(
+    LBANN_OPTION_IMAGE_CACHE_SHORT_SIDE,
+    {"--image_cache_short_side"},
+    utils::ENV("LBANN_IMAGE_CACHE_SHORT_SIDE"),
+    "[DATAREADER] ImageNet readers using the data store cache images "
+    "decoded and shrunk so their short side has this many pixels, so "
+    "only the first epoch decodes them. 0 caches the encoded images.",
+    0);
+  arg_parser.add_option(LBANN_OPTION_JAG_OPEN_BUNDLES,
+                        {"--jag_open_bundles"},
+                        utils::ENV("LBANN_JAG_OPEN_BUNDLES"),
+                        "[DATAREADER] Number of bundle files that the JAG "
+                        "conduit reader keeps open between mini-batches.",
+                        16UL);
   arg_parser.add_option(
     LBANN_OPTION_LABEL_FILENAME_TEST,
     {"--label_filename_test"},
@@ -427,6 +703,13 @@ void construct_datareader_options()
                         "[DATAREADER] Sets the filename for saving computed "
                         "number of samples per file for RAS lipid datatreader",
                         "");
+  arg_parser.add_option(LBANN_OPTION_SAMPLE_LIST_CACHE,
+                        {"--sample_list_cache"},
+                        utils::ENV("LBANN_SAMPLE_LIST_CACHE"),
+                        "[DATAREADER] Directory where multi-sample sample "
+                        "lists are kept in the binary format once they have "
+                        "been loaded, so later jobs skip scanning the files",
+                        "");
   arg_parser.add_option(
     LBANN_OPTION_SAMPLE_LIST_TEST,
     {"--sample_list_test"},
@@ -442,17 +725,48 @@ void construct_datareader_options()
     {"--sample_list_validate"},
     "[DATAREADER] Sets the datareader sample list for validation data",
     "");
+  arg_parser.add_option(LBANN_OPTION_SEQUENCE_BUCKET_WINDOW,
+                        {"--sequence_bucket_window"},
+                        "[DATAREADER] Number of mini-batches whose samples "
+                        "are grouped by sequence length after each shuffle "
+                        "(0 disables bucketing)",
+                        0);
   arg_parser.add_option(LBANN_OPTION_SEQUENCE_LENGTH,
                         {"--sequence_length", "--seq_len"},
                         "[DATAREADER] Sets the sequence length for RAS lipid "
                         "and SMILES datareaders",
                         -1);
+  arg_parser.add_option(LBANN_OPTION_SHARD_READAHEAD_SIZE,
+                        {"--shard_readahead_size"},
+                        utils::ENV("LBANN_SHARD_READAHEAD_SIZE"),
+                        "[DATAREADER] Bytes of a shard file that each I/O "
+                        "thread of the image shard reader reads at once.",
+                        16 * 1024 * 1024UL);
+  arg_parser.add_option(LBANN_OPTION_SHARD_SHUFFLE_BUFFER,
+                        {"--shard_shuffle_buffer"},
+                        "[DATAREADER] Number of samples that the image shard "
+                        "reader mixes after shuffling the order of its shards",
+                        4096);
+  arg_parser.add_option(LBANN_OPTION_SHUFFLE_FILE_WINDOW,
+                        {"--shuffle_file_window"},
+                        utils::ENV("LBANN_SHUFFLE_FILE_WINDOW"),
+                        "[DATAREADER] Number of files whose samples are mixed "
+                        "after shuffling the file order of readers with "
+                        "multi-sample files (0 shuffles samples uniformly)",
+                        0);
   arg_parser.add_option(LBANN_OPTION_SMILES_BUFFER_SIZE,
                         {"--smiles_buffer_size"},
                         utils::ENV("LBANN_SMILES_BUFFER_SIZE"),
                         "[DATAREADER] Size of the read buffer for the SMILES "
                         "data reader.",
                         16 * 1024 * 1024UL);
+  arg_parser.add_option(LBANN_OPTION_STAGE_DIR,
+                        {"--stage_dir"},
+                        utils::ENV("LBANN_STAGE_DIR"),
+                        "[DATAREADER] Node-local directory to which the ranks "
+                        "copy the files of sample lists in the background, "
+                        "reading each file from there once it is copied",
+                        "");
   arg_parser.add_option(LBANN_OPTION_VOCAB,
                         {"--vocab"},
                         "[DATAREADER] Sets the filename containing the "
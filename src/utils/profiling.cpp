@@ -28,10 +28,18 @@
 
 #include "lbann/utils/profiling.hpp"
 #include "lbann/base.hpp"
+#include "lbann/comm.hpp"
+#include "lbann/utils/argument_parser.hpp"
 #include "lbann/utils/exception.hpp"
+#include "lbann/utils/options.hpp"
 
 #if defined(LBANN_SCOREP)
 #include <scorep/SCOREP_User.h>
+#elif defined(LBANN_HAS_CALIPER)
+#include "lbann/utils/gpu/helpers.hpp"
+#include <caliper/cali-manager.h>
+#include <caliper/cali.h>
+#include <memory>
 #elif defined(LBANN_NVPROF)
 #include "cuda_profiler_api.h"
 #include "cuda_runtime.h"
@@ -48,10 +56,51 @@
 
 namespace {
 bool profiling_started = false;
-}
+#if defined(LBANN_HAS_CALIPER) && !defined(LBANN_SCOREP)
+std::unique_ptr<cali::ConfigManager> caliper_manager;
+#endif
+} // namespace
 
 namespace lbann {
 
+#if defined(LBANN_HAS_CALIPER) && !defined(LBANN_SCOREP)
+void prof_initialize()
+{
+  const auto config =
+    global_argument_parser().get<std::string>(LBANN_OPTION_CALIPER_CONFIG);
+  if (config.empty()) {
+    return;
+  }
+  caliper_manager = std::make_unique<cali::ConfigManager>();
+  caliper_manager->add(config.c_str());
+  if (caliper_manager->error()) {
+    LBANN_ERROR("invalid Caliper configuration \"",
+                config,
+                "\": ",
+                caliper_manager->error_msg());
+  }
+  caliper_manager->start();
+}
+void prof_finalize()
+{
+  if (caliper_manager != nullptr) {
+    caliper_manager->flush();
+    caliper_manager.reset();
+  }
+}
+#else
+void prof_initialize()
+{
+  const auto& arg_parser = global_argument_parser();
+  if (get_rank_in_world() == 0 &&
+      !arg_parser.get<std::string>(LBANN_OPTION_CALIPER_CONFIG).empty()) {
+    LBANN_WARNING("--caliper_config is ignored, since LBANN is not built "
+                  "with Caliper");
+  }
+}
+void prof_finalize() {}
+#endif
+
 #if defined(LBANN_SCOREP)
 void prof_start()
 {
@@ -69,6 +118,31 @@ void prof_region_end(const char* s, bool)
   SCOREP_USER_REGION_BY_NAME_END(s);
   return;
 }
+#elif defined(LBANN_HAS_CALIPER)
+// Caliper regions are always annotated, since they must be nested
+// properly, and are only measured when a configuration is given.
+// Caliper can forward them to NVTX or roctx, e.g. with the "nvtx"
+// configuration.
+void prof_start() { profiling_started = true; }
+void prof_stop() { profiling_started = false; }
+void prof_region_begin(const char* s, int, bool sync)
+{
+#ifdef LBANN_HAS_GPU
+  if (sync) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+  cali_begin_region(s);
+}
+void prof_region_end(const char* s, bool sync)
+{
+#ifdef LBANN_HAS_GPU
+  if (sync) {
+    hydrogen::gpu::SynchronizeDevice();
+  }
+#endif // LBANN_HAS_GPU
+  cali_end_region(s);
+}
 #elif defined(LBANN_NVPROF)
 void prof_start()
 {
@@ -27,6 +27,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "lbann/utils/protobuf_utils.hpp"
+#include "lbann/comm_impl.hpp"
 #include "lbann/proto/proto_common.hpp"
 
 #include "lbann/proto/lbann.pb.h" // Actually use LbannPB here
@@ -189,6 +190,45 @@ load_prototext(const bool master, const int trainer_rank)
   return models_out;
 }
 
+std::vector<std::unique_ptr<lbann_data::LbannPB>>
+load_prototext(lbann_comm const& comm, bool per_trainer)
+{
+  const bool root =
+    (per_trainer ? comm.am_trainer_master() : comm.am_world_master());
+  auto broadcast = [&](auto& val) {
+    if (per_trainer) {
+      comm.trainer_broadcast(comm.get_trainer_master(), val);
+    }
+    else {
+      comm.world_broadcast(comm.get_world_master(), val);
+    }
+  };
+
+  std::vector<std::unique_ptr<lbann_data::LbannPB>> models_out;
+  if (root) {
+    models_out =
+      load_prototext(comm.am_world_master(),
+                     per_trainer ? comm.get_trainer_rank() : 0);
+  }
+  int num_models = static_cast<int>(models_out.size());
+  broadcast(num_models);
+  models_out.resize(num_models);
+  for (auto& pb : models_out) {
+    std::string buf;
+    if (root) {
+      pb->SerializeToString(&buf);
+    }
+    broadcast(buf);
+    if (!root) {
+      pb = std::make_unique<lbann_data::LbannPB>();
+      if (!pb->ParseFromString(buf)) {
+        LBANN_ERROR("failed to parse the prototext broadcast by the root");
+      }
+    }
+  }
+  return models_out;
+}
+
 void verify_prototext(
   const bool master,
   const std::vector<std::unique_ptr<lbann_data::LbannPB>>& models)
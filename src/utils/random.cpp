@@ -26,13 +26,53 @@
 
 #include <omp.h>
 #define LBANN_RANDOM_INSTANTIATE
+#include "lbann/comm_impl.hpp"
 #include "lbann/io/file_io.hpp"
 #include "lbann/utils/hash.hpp"
 #include "lbann/utils/random.hpp"
+#include <sstream>
 #include <thread>
 
 namespace lbann {
 
+namespace {
+
+/** Write an RNG state with persist::open_output */
+template <typename RNG>
+void save_rng_state(persist& p, const std::string& filename, RNG const& rng)
+{
+  auto os = p.open_output(filename);
+  if (!os->good()) {
+    LBANN_ERROR("Failed to open ", filename);
+  }
+  *os << rng;
+  os->flush();
+  if (os->fail()) {
+    LBANN_ERROR("Failed to write ", filename);
+  }
+}
+
+/** Read an RNG state with persist::open_input */
+template <typename RNG>
+void load_rng_state(persist& p, const std::string& filename, RNG& rng)
+{
+  auto is = p.open_input(filename);
+  if (!is->good()) {
+    LBANN_ERROR("Failed to open ", filename);
+  }
+  *is >> rng;
+}
+
+template <typename RNG>
+std::string rng_state_string(RNG const& rng)
+{
+  std::ostringstream ss;
+  ss << rng;
+  return ss.str();
+}
+
+} // namespace
+
 bool save_rng_to_checkpoint(persist& p, lbann_comm* comm, bool is_distributed)
 {
   std::string dirname = std::string(p.m_checkpoint_dir) + "/rng_state";
@@ -51,101 +91,64 @@ bool save_rng_to_checkpoint(persist& p, lbann_comm* comm, bool is_distributed)
     comm->trainer_barrier();
   }
 
+  // The states are written with persist::open_output, so they can be
+  // kept in memory with the rest of the checkpoint
   if (comm == nullptr || comm->am_trainer_master() || is_distributed) {
     /// @todo - Note that the RNG with thread local data is not correct
-    rng_name = dirname + "/rng_seq_generator";
-    std::ofstream rng_seq(rng_name);
-    if (!rng_seq) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_seq << get_data_seq_generator();
-    rng_seq.close();
-
-    rng_name = dirname + "/EL_generator";
-    std::ofstream rng_EL(rng_name);
-    if (!rng_EL) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_EL << El::Generator();
-    rng_EL.close();
+    save_rng_state(p, dirname + "/rng_seq_generator", get_data_seq_generator());
+    save_rng_state(p, dirname + "/EL_generator", El::Generator());
   }
 
   for (int i = 0; i < get_num_io_generators(); i++) {
-    rng_name = dirname + "/rng_io_generator_" + rank_in_trainer + "_t" +
-               std::to_string(i);
-    std::ofstream rng_io(rng_name);
-    if (!rng_io) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_name = dirname + "/rng_fast_io_generator_" + rank_in_trainer + "_t" +
-               std::to_string(i);
-    std::ofstream rng_fast_io(rng_name);
-    if (!rng_fast_io) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-
     locked_io_rng_ref io_rng = set_io_generators_local_index(i);
-    rng_io << get_io_generator();
-    rng_fast_io << get_fast_io_generator();
-
-    rng_io.close();
-    rng_fast_io.close();
+    save_rng_state(p,
+                   dirname + "/rng_io_generator_" + rank_in_trainer + "_t" +
+                     std::to_string(i),
+                   get_io_generator());
+    save_rng_state(p,
+                   dirname + "/rng_fast_io_generator_" + rank_in_trainer +
+                     "_t" + std::to_string(i),
+                   get_fast_io_generator());
   }
 
 #ifdef _OPENMP
-#pragma omp parallel private(rng_name)
+  // Print the thread-local states in parallel, but open the files
+  // from one thread since persist is not thread-safe
+  std::vector<std::string> rng_states(omp_get_max_threads());
+  std::vector<std::string> rng_fast_states(rng_states.size());
+  std::vector<std::string> rng_ltfb_states(rng_states.size());
+  std::vector<char> has_state(rng_states.size(), 0);
+#pragma omp parallel
   {
-    rng_name = dirname + "/rng_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ofstream rng(rng_name);
-    if (!rng) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng << get_generator();
-    rng.close();
-
-    rng_name = dirname + "/rng_fast_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ofstream rng_fast(rng_name);
-    if (!rng_fast) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_fast << get_fast_generator();
-    rng_fast.close();
-
-    rng_name = dirname + "/rng_ltfb_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ofstream rng_ltfb(rng_name);
-    if (!rng_ltfb) {
-      LBANN_ERROR("Failed to open ", rng_name);
+    const int thread = omp_get_thread_num();
+    rng_states[thread] = rng_state_string(get_generator());
+    rng_fast_states[thread] = rng_state_string(get_fast_generator());
+    rng_ltfb_states[thread] = rng_state_string(get_ltfb_generator());
+    has_state[thread] = 1;
+  }
+  for (size_t thread = 0; thread < rng_states.size(); ++thread) {
+    if (!has_state[thread]) {
+      continue;
     }
-    rng_ltfb << get_ltfb_generator();
-    rng_ltfb.close();
+    const auto suffix = rank_in_trainer + "_" + std::to_string(thread);
+    save_rng_state(p, dirname + "/rng_generator_" + suffix, rng_states[thread]);
+    save_rng_state(p,
+                   dirname + "/rng_fast_generator_" + suffix,
+                   rng_fast_states[thread]);
+    save_rng_state(p,
+                   dirname + "/rng_ltfb_generator_" + suffix,
+                   rng_ltfb_states[thread]);
   }
 #else
-  rng_name = dirname + "/rng_generator_" + rank_in_trainer;
-  std::ofstream rng(rng_name);
-  if (!rng) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng << get_generator();
-  rng.close();
-
-  rng_name = dirname + "/rng_fast_generator_" + rank_in_trainer;
-  std::ofstream rng_fast(rng_name);
-  if (!rng_fast) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_fast << get_fast_generator();
-  rng_fast.close();
-
-  rng_name = dirname + "/rng_ltfb_generator_" + rank_in_trainer;
-  std::ofstream rng_ltfb(rng_name);
-  if (!rng_ltfb) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_ltfb << get_ltfb_generator();
-  rng_ltfb.close();
+  save_rng_state(p,
+                 dirname + "/rng_generator_" + rank_in_trainer,
+                 get_generator());
+  save_rng_state(p,
+                 dirname + "/rng_fast_generator_" + rank_in_trainer,
+                 get_fast_generator());
+  save_rng_state(p,
+                 dirname + "/rng_ltfb_generator_" + rank_in_trainer,
+                 get_ltfb_generator());
 #endif
 
   return true;
@@ -165,25 +168,17 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm)
 {
 
   std::string dirname = std::string(p.m_checkpoint_dir) + "/rng_state";
-  std::string rng_name;
 
   /// @todo - Note that the RNG with thread local data is not correct
-  rng_name = dirname + "/rng_seq_generator";
-  std::ifstream rng_seq(rng_name);
-  if (!rng_seq) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_seq >> get_data_seq_generator();
-
-  rng_name = dirname + "/EL_generator";
-  std::ifstream rng_EL(rng_name);
-  if (!rng_EL) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_EL >> El::Generator();
+  load_rng_state(p, dirname + "/rng_seq_generator", get_data_seq_generator());
+  load_rng_state(p, dirname + "/EL_generator", El::Generator());
 
   std::string rank_in_trainer;
-  if (comm == nullptr) {
+  if (p.is_resharding()) {
+    // The states of the old rank whose checkpoint is open
+    rank_in_trainer = std::to_string(p.get_reshard_source_rank());
+  }
+  else if (comm == nullptr) {
     rank_in_trainer = std::to_string(El::mpi::Rank(El::mpi::COMM_WORLD));
   }
   else {
@@ -191,72 +186,40 @@ bool load_rng_from_checkpoint(persist& p, const lbann_comm* comm)
   }
 
   for (int i = 0; i < get_num_io_generators(); i++) {
-    rng_name = dirname + "/rng_io_generator_" + rank_in_trainer + "_t" +
-               std::to_string(i);
-    std::ifstream rng_io(rng_name);
-    if (!rng_io) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_name = dirname + "/rng_fast_io_generator_" + rank_in_trainer + "_t" +
-               std::to_string(i);
-    std::ifstream rng_fast_io(rng_name);
-    if (!rng_fast_io) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-
     locked_io_rng_ref io_rng = set_io_generators_local_index(i);
-    rng_io >> get_io_generator();
-    rng_fast_io >> get_fast_io_generator();
+    load_rng_state(p,
+                   dirname + "/rng_io_generator_" + rank_in_trainer + "_t" +
+                     std::to_string(i),
+                   get_io_generator());
+    load_rng_state(p,
+                   dirname + "/rng_fast_io_generator_" + rank_in_trainer +
+                     "_t" + std::to_string(i),
+                   get_fast_io_generator());
   }
 
 #ifdef _OPENMP
-#pragma omp parallel private(rng_name)
+#pragma omp parallel
   {
-    rng_name = dirname + "/rng_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ifstream rng(rng_name);
-    if (!rng) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng >> get_generator();
-
-    rng_name = dirname + "/rng_fast_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ifstream rng_fast(rng_name);
-    if (!rng_fast) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_fast >> get_fast_generator();
-
-    rng_name = dirname + "/rng_ltfb_generator_" + rank_in_trainer + "_" +
-               std::to_string(omp_get_thread_num());
-    std::ifstream rng_ltfb(rng_name);
-    if (!rng_ltfb) {
-      LBANN_ERROR("Failed to open ", rng_name);
-    }
-    rng_ltfb >> get_ltfb_generator();
+    const auto suffix =
+      rank_in_trainer + "_" + std::to_string(omp_get_thread_num());
+    load_rng_state(p, dirname + "/rng_generator_" + suffix, get_generator());
+    load_rng_state(p,
+                   dirname + "/rng_fast_generator_" + suffix,
+                   get_fast_generator());
+    load_rng_state(p,
+                   dirname + "/rng_ltfb_generator_" + suffix,
+                   get_ltfb_generator());
   }
 #else
-  rng_name = dirname + "/rng_generator_" + rank_in_trainer;
-  std::ifstream rng(rng_name);
-  if (!rng) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng >> get_generator();
-
-  rng_name = dirname + "/rng_fast_generator_" + rank_in_trainer;
-  std::ifstream rng_fast(rng_name);
-  if (!rng_fast) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_fast >> get_fast_generator();
-
-  rng_name = dirname + "/rng_ltfb_generator_" + rank_in_trainer;
-  std::ifstream rng_ltfb(rng_name);
-  if (!rng_ltfb) {
-    LBANN_ERROR("Failed to open ", rng_name);
-  }
-  rng_ltfb >> get_ltfb_generator();
+  load_rng_state(p,
+                 dirname + "/rng_generator_" + rank_in_trainer,
+                 get_generator());
+  load_rng_state(p,
+                 dirname + "/rng_fast_generator_" + rank_in_trainer,
+                 get_fast_generator());
+  load_rng_state(p,
+                 dirname + "/rng_ltfb_generator_" + rank_in_trainer,
+                 get_ltfb_generator());
 #endif
   return true;
 }
@@ -496,6 +459,192 @@ void gaussian_fill_parallel(El::AbstractDistMatrix<TensorDataType>& mat,
                 0);
 }
 
+namespace {
+
+/** Real type used to draw random variables of a tensor type. */
+template <typename TensorDataType>
+using philox_real_type =
+  typename std::conditional<std::is_same<TensorDataType, double>::value,
+                            double,
+                            float>::type;
+
+/** Whether the GPU implementations support a tensor type. */
+template <typename TensorDataType>
+constexpr bool philox_gpu_type = true;
+#ifdef LBANN_HAS_HALF
+template <>
+constexpr bool philox_gpu_type<cpu_fp16> = false;
+#endif // LBANN_HAS_HALF
+
+template <typename TensorDataType>
+philox::index_map
+get_philox_index_map(const El::AbstractDistMatrix<TensorDataType>& mat)
+{
+  philox::index_map map;
+  map.col_shift = mat.ColShift();
+  map.col_stride = mat.ColStride();
+  map.row_shift = mat.RowShift();
+  map.row_stride = mat.RowStride();
+  map.height = mat.Height();
+  return map;
+}
+
+template <typename TensorDataType>
+void philox_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                 philox::distribution dist,
+                 double a,
+                 double b,
+                 const philox::stream& stream)
+{
+  const auto map = get_philox_index_map(mat);
+  if (mat.GetLocalDevice() == El::Device::GPU) {
+#ifdef LBANN_HAS_GPU
+    if constexpr (philox_gpu_type<TensorDataType>) {
+      details::philox_fill_gpu(
+        static_cast<El::Matrix<TensorDataType, El::Device::GPU>&>(
+          mat.Matrix()),
+        map,
+        dist,
+        a,
+        b,
+        stream);
+      return;
+    }
+#endif // LBANN_HAS_GPU
+    LBANN_ERROR("unsupported data type for GPU random matrices");
+  }
+
+  using RealType = philox_real_type<TensorDataType>;
+  const auto threshold = philox::bernoulli_threshold(a);
+  const RealType real_a =
+    (dist == philox::distribution::bernoulli ? RealType(1) : RealType(a));
+  const RealType real_b = b;
+  auto& local_mat = mat.Matrix();
+  auto* __restrict__ buffer = local_mat.Buffer();
+  const El::Int height = local_mat.Height();
+  const El::Int width = local_mat.Width();
+  const El::Int ldim = local_mat.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      const auto x = stream(map(i, j));
+      buffer[i + j * ldim] = static_cast<TensorDataType>(
+        philox::sample(dist, real_a, real_b, threshold, x));
+    }
+  }
+}
+
+} // namespace
+
+uint64_t draw_philox_seed(const lbann_comm& comm)
+{
+  uint64_t seed = 0;
+  if (comm.am_trainer_master()) {
+    auto& gen = get_generator();
+    seed = static_cast<uint64_t>(gen()) << 32;
+    seed |= static_cast<uint64_t>(gen());
+  }
+  comm.trainer_broadcast(comm.get_trainer_master(), seed);
+  return seed;
+}
+
+uint64_t draw_philox_seed(const El::Grid& grid)
+{
+  uint64_t seed = 0;
+  if (grid.Rank() == 0) {
+    auto& gen = get_generator();
+    seed = static_cast<uint64_t>(gen()) << 32;
+    seed |= static_cast<uint64_t>(gen());
+  }
+  El::mpi::Broadcast(seed, 0, grid.Comm(), El::SyncInfo<El::Device::CPU>{});
+  return seed;
+}
+
+template <typename TensorDataType>
+void philox_bernoulli_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                           double p,
+                           const philox::stream& stream)
+{
+  philox_fill(mat, philox::distribution::bernoulli, p, 0., stream);
+}
+
+template <typename TensorDataType>
+void philox_uniform_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                         TensorDataType center,
+                         TensorDataType radius,
+                         const philox::stream& stream)
+{
+  philox_fill(mat,
+              philox::distribution::uniform,
+              static_cast<double>(center),
+              static_cast<double>(radius),
+              stream);
+}
+
+template <typename TensorDataType>
+void philox_gaussian_fill(El::AbstractDistMatrix<TensorDataType>& mat,
+                          TensorDataType mean,
+                          TensorDataType stddev,
+                          const philox::stream& stream)
+{
+  philox_fill(mat,
+              philox::distribution::gaussian,
+              static_cast<double>(mean),
+              static_cast<double>(stddev),
+              stream);
+}
+
+template <typename TensorDataType>
+void philox_dropout(const El::AbstractDistMatrix<TensorDataType>& input,
+                    El::AbstractDistMatrix<TensorDataType>& output,
+                    double p,
+                    const philox::stream& stream)
+{
+  if (!El::mpi::Congruent(input.DistComm(), output.DistComm()) ||
+      input.ColAlign() != output.ColAlign() ||
+      input.RowAlign() != output.RowAlign() ||
+      input.GetLocalDevice() != output.GetLocalDevice()) {
+    LBANN_ERROR("dropout input and output are not distributed alike");
+  }
+  const auto map = get_philox_index_map(output);
+  if (output.GetLocalDevice() == El::Device::GPU) {
+#ifdef LBANN_HAS_GPU
+    if constexpr (philox_gpu_type<TensorDataType>) {
+      using GPUMatType = El::Matrix<TensorDataType, El::Device::GPU>;
+      details::philox_dropout_gpu(
+        static_cast<const GPUMatType&>(input.LockedMatrix()),
+        static_cast<GPUMatType&>(output.Matrix()),
+        map,
+        p,
+        stream);
+      return;
+    }
+#endif // LBANN_HAS_GPU
+    LBANN_ERROR("unsupported data type for GPU random matrices");
+  }
+
+  using RealType = philox_real_type<TensorDataType>;
+  const auto threshold = philox::bernoulli_threshold(p);
+  const auto scale = static_cast<RealType>(1. / p);
+  const auto& local_input = input.LockedMatrix();
+  auto& local_output = output.Matrix();
+  const auto* __restrict__ x = local_input.LockedBuffer();
+  auto* __restrict__ y = local_output.Buffer();
+  const El::Int height = local_output.Height();
+  const El::Int width = local_output.Width();
+  const El::Int x_ldim = local_input.LDim();
+  const El::Int y_ldim = local_output.LDim();
+  LBANN_OMP_PARALLEL_FOR_COLLAPSE2
+  for (El::Int j = 0; j < width; ++j) {
+    for (El::Int i = 0; i < height; ++i) {
+      const bool keep = stream(map(i, j)).x[0] < threshold;
+      const auto xi = static_cast<RealType>(x[i + j * x_ldim]);
+      y[i + j * y_ldim] =
+        static_cast<TensorDataType>(keep ? xi * scale : RealType(0));
+    }
+  }
+}
+
 #define PROTO(T)                                                               \
   template void gaussian_fill<T>(El::AbstractDistMatrix<T> & mat,              \
                                  El::Int m,                                    \
@@ -529,7 +678,22 @@ void gaussian_fill_parallel(El::AbstractDistMatrix<TensorDataType>& mat,
                                           El::Int m,                           \
                                           El::Int n,                           \
                                           T mean,                              \
-                                          T stddev)
+                                          T stddev);                           \
+  template void philox_bernoulli_fill<T>(El::AbstractDistMatrix<T> & mat,      \
+                                         double p,                             \
+                                         const philox::stream& stream);        \
+  template void philox_uniform_fill<T>(El::AbstractDistMatrix<T> & mat,        \
+                                       T center,                               \
+                                       T radius,                               \
+                                       const philox::stream& stream);          \
+  template void philox_gaussian_fill<T>(El::AbstractDistMatrix<T> & mat,       \
+                                        T mean,                                \
+                                        T stddev,                              \
+                                        const philox::stream& stream);         \
+  template void philox_dropout<T>(const El::AbstractDistMatrix<T>& input,      \
+                                  El::AbstractDistMatrix<T>& output,           \
+                                  double p,                                    \
+                                  const philox::stream& stream)
 
 #define LBANN_INSTANTIATE_CPU_HALF
 #define LBANN_INSTANTIATE_GPU_HALF
@@ -0,0 +1,189 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "lbann/utils/gpu/helpers.hpp"
+#include "lbann/utils/random.hpp"
+
+namespace lbann {
+namespace {
+
+template <typename Real, typename TensorDataType>
+__global__ void philox_fill_kernel(El::Int height,
+                                   El::Int width,
+                                   philox::index_map map,
+                                   philox::distribution dist,
+                                   Real a,
+                                   Real b,
+                                   uint64_t threshold,
+                                   philox::stream stream,
+                                   TensorDataType* __restrict__ buffer,
+                                   El::Int ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  for (El::Int j = blockIdx.y; j < width; j += gridDim.y) {
+    for (El::Int i = gidx; i < height; i += nthreadsx) {
+      const auto x = stream(map(i, j));
+      buffer[i + j * ldim] = static_cast<TensorDataType>(
+        philox::sample(dist, a, b, threshold, x));
+    }
+  }
+}
+
+template <typename Real, typename TensorDataType>
+__global__ void philox_dropout_kernel(El::Int height,
+                                      El::Int width,
+                                      philox::index_map map,
+                                      uint64_t threshold,
+                                      Real scale,
+                                      philox::stream stream,
+                                      const TensorDataType* __restrict__ x,
+                                      El::Int x_ldim,
+                                      TensorDataType* __restrict__ y,
+                                      El::Int y_ldim)
+{
+  const El::Int gidx = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreadsx = blockDim.x * gridDim.x;
+  for (El::Int j = blockIdx.y; j < width; j += gridDim.y) {
+    for (El::Int i = gidx; i < height; i += nthreadsx) {
+      const bool keep = stream(map(i, j)).x[0] < threshold;
+      const auto xi = static_cast<Real>(x[i + j * x_ldim]);
+      y[i + j * y_ldim] = static_cast<TensorDataType>(keep ? xi * scale
+                                                           : Real(0));
+    }
+  }
+}
+
+template <typename TensorDataType>
+using philox_real_type =
+  typename std::conditional<std::is_same<TensorDataType, double>::value,
+                            double,
+                            float>::type;
+
+dim3 get_grid_dims(El::Int height, El::Int width, size_t block_size)
+{
+  dim3 grid_dims;
+  grid_dims.x = (height + block_size - 1) / block_size;
+  grid_dims.y = width;
+  gpu_lib::clip_grid_dims(grid_dims);
+  return grid_dims;
+}
+
+} // namespace
+
+namespace details {
+
+template <typename TensorDataType>
+void philox_fill_gpu(El::Matrix<TensorDataType, El::Device::GPU>& mat,
+                     const philox::index_map& map,
+                     philox::distribution dist,
+                     double a,
+                     double b,
+                     const philox::stream& stream)
+{
+  using RealType = philox_real_type<TensorDataType>;
+  const El::Int height = mat.Height();
+  const El::Int width = mat.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  const auto threshold = philox::bernoulli_threshold(a);
+  const RealType real_a =
+    (dist == philox::distribution::bernoulli ? RealType(1) : RealType(a));
+  constexpr size_t block_size = 256;
+  hydrogen::gpu::LaunchKernel(
+    philox_fill_kernel<RealType, TensorDataType>,
+    get_grid_dims(height, width, block_size),
+    block_size,
+    0,
+    gpu::get_sync_info(mat),
+    height,
+    width,
+    map,
+    dist,
+    real_a,
+    RealType(b),
+    threshold,
+    stream,
+    mat.Buffer(),
+    mat.LDim());
+}
+
+template <typename TensorDataType>
+void philox_dropout_gpu(
+  const El::Matrix<TensorDataType, El::Device::GPU>& input,
+  El::Matrix<TensorDataType, El::Device::GPU>& output,
+  const philox::index_map& map,
+  double p,
+  const philox::stream& stream)
+{
+  using RealType = philox_real_type<TensorDataType>;
+  const El::Int height = output.Height();
+  const El::Int width = output.Width();
+  if (height < 1 || width < 1) {
+    return;
+  }
+  auto multisync = El::MakeMultiSync(gpu::get_sync_info(output),
+                                     gpu::get_sync_info(input));
+  constexpr size_t block_size = 256;
+  hydrogen::gpu::LaunchKernel(
+    philox_dropout_kernel<RealType, TensorDataType>,
+    get_grid_dims(height, width, block_size),
+    block_size,
+    0,
+    multisync,
+    height,
+    width,
+    map,
+    philox::bernoulli_threshold(p),
+    static_cast<RealType>(1. / p),
+    stream,
+    input.LockedBuffer(),
+    input.LDim(),
+    output.Buffer(),
+    output.LDim());
+}
+
+#define PROTO(T)                                                               \
+  template void philox_fill_gpu<T>(El::Matrix<T, El::Device::GPU> & mat,       \
+                                   const philox::index_map& map,               \
+                                   philox::distribution dist,                  \
+                                   double a,                                   \
+                                   double b,                                   \
+                                   const philox::stream& stream);              \
+  template void philox_dropout_gpu<T>(                                         \
+    const El::Matrix<T, El::Device::GPU>& input,                               \
+    El::Matrix<T, El::Device::GPU>& output,                                    \
+    const philox::index_map& map,                                              \
+    double p,                                                                  \
+    const philox::stream& stream)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace details
+} // namespace lbann
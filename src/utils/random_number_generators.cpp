@@ -28,8 +28,10 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/hash.hpp"
 #include <lbann/utils/memory.hpp>
+#include <algorithm>
 #include <omp.h>
 #include <thread>
+#include <vector>
 
 namespace {
 #ifdef __ICC
@@ -71,6 +73,47 @@ bool data_seq_generator_seed_inited = false;
 thread_local size_t local_io_generators_index = 0;
 std::vector<lbann::io_rng_t> io_generators;
 bool io_generators_inited = false;
+size_t io_generators_seed_base = 0;
+
+// Seed of the current sample, applied to the I/O generators when
+// they are next used
+thread_local size_t io_generators_pending_seed = 0;
+thread_local bool io_generators_seed_pending = false;
+
+// Key and per-tag counters of the current sample's stream
+thread_local uint64_t io_sample_key = 0;
+thread_local bool io_sample_key_set = false;
+thread_local std::vector<uint64_t> io_sample_counters;
+
+lbann::io_rng_t& get_owned_io_rng()
+{
+  lbann::io_rng_t& io_rng = ::io_generators[::local_io_generators_index];
+  if (io_rng.active_thread_id.load() != std::this_thread::get_id()) {
+    LBANN_ERROR("I/O RNG illegal thread access");
+  }
+  if (::io_generators_seed_pending) {
+    io_rng.generator.seed(::io_generators_pending_seed);
+    io_rng.fast_generator.seed(::io_generators_pending_seed);
+    ::io_generators_seed_pending = false;
+  }
+  return io_rng;
+}
+
+/** Reserve @c n blocks of a tag's stream and return the first. */
+uint64_t reserve_io_sample_blocks(uint32_t tag, uint64_t n)
+{
+  if (tag >= ::io_sample_counters.size()) {
+    ::io_sample_counters.resize(tag + 1, 0);
+  }
+  const uint64_t first = ::io_sample_counters[tag];
+  ::io_sample_counters[tag] += n;
+  return first;
+}
+
+uint64_t get_io_sample_key()
+{
+  return ::io_sample_key_set ? ::io_sample_key : ::io_generators_seed_base;
+}
 } // namespace
 
 namespace lbann {
@@ -122,24 +165,61 @@ locked_io_rng_ref set_io_generators_local_index(size_t idx)
   return locked_io_rng_ref(::io_generators[idx]);
 }
 
-rng_gen& get_io_generator()
+void seed_io_generators_for_sample(size_t key)
 {
   const size_t idx = ::local_io_generators_index;
   io_rng_t& io_rng = ::io_generators[idx];
   if (io_rng.active_thread_id.load() != std::this_thread::get_id()) {
     LBANN_ERROR("I/O RNG illegal thread access");
   }
-  return io_rng.generator;
+  // Seeding a Mersenne Twister is expensive, so it is deferred until
+  // the sample uses the generators
+  const size_t seed = hash_combine(::io_generators_seed_base, key);
+  ::io_generators_pending_seed = seed;
+  ::io_generators_seed_pending = true;
+  ::io_sample_key = seed;
+  ::io_sample_key_set = true;
+  std::fill(::io_sample_counters.begin(), ::io_sample_counters.end(), 0);
 }
 
-fast_rng_gen& get_fast_io_generator()
+philox::block draw_io_sample_block(uint32_t tag)
 {
-  const size_t idx = ::local_io_generators_index;
-  io_rng_t& io_rng = ::io_generators[idx];
-  if (io_rng.active_thread_id.load() != std::this_thread::get_id()) {
-    LBANN_ERROR("I/O RNG illegal thread access");
+  const uint64_t n = reserve_io_sample_blocks(tag, 1);
+  return philox::philox4x32(static_cast<uint32_t>(n),
+                            static_cast<uint32_t>(n >> 32),
+                            tag,
+                            0,
+                            get_io_sample_key());
+}
+
+void draw_io_sample_uniform(uint32_t tag,
+                            float a,
+                            float b,
+                            float* out,
+                            size_t n)
+{
+  const uint64_t first = reserve_io_sample_blocks(tag, (n + 3) / 4);
+  const uint64_t key = get_io_sample_key();
+  const float scale = (b - a) * (1.f / 16777216.f);
+  for (size_t i = 0; i < n; i += 4) {
+    const uint64_t c = first + i / 4;
+    const auto x = philox::philox4x32(static_cast<uint32_t>(c),
+                                      static_cast<uint32_t>(c >> 32),
+                                      tag,
+                                      0,
+                                      key);
+    const size_t count = std::min<size_t>(4, n - i);
+    for (size_t k = 0; k < count; ++k) {
+      out[i + k] = a + scale * static_cast<float>(x.x[k] >> 8);
+    }
   }
-  return io_rng.fast_generator;
+}
+
+rng_gen& get_io_generator() { return get_owned_io_rng().generator; }
+
+fast_rng_gen& get_fast_io_generator()
+{
+  return get_owned_io_rng().fast_generator;
 }
 
 void init_random(int seed, int num_io_RNGs, lbann_comm* comm)
@@ -215,6 +295,7 @@ void init_io_random(int seed, int num_io_RNGs)
     seed_base = rd();
   }
 
+  ::io_generators_seed_base = seed_base;
   ::io_generators.resize(num_io_RNGs);
   for (int i = 0; i < num_io_RNGs; i++) {
     auto& io_rng = ::io_generators[i];
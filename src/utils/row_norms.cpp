@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_ROW_NORMS_INSTANTIATE
+#include "lbann/utils/row_norms.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/omp_pragma.hpp"
+
+#include <algorithm>
+
+namespace lbann {
+
+template <typename T>
+void batched_row_sqsums(
+  std::vector<const El::Matrix<T, El::Device::CPU>*> const& mats,
+  std::vector<El::Matrix<T, El::Device::CPU>*> const& sqsums)
+{
+  if (mats.size() != sqsums.size()) {
+    LBANN_ERROR("got ",
+                mats.size(),
+                " matrices but ",
+                sqsums.size(),
+                " outputs for row sums of squares");
+  }
+
+  // Block size for loops
+  // Note: x86 cache lines are 64B
+  constexpr size_t _bsize = 64 / sizeof(T);
+  constexpr size_t bsize = _bsize > 1 ? _bsize : 1;
+
+  for (size_t i = 0; i < mats.size(); ++i) {
+    const auto& mat = *mats[i];
+    auto& row_sqsums = *sqsums[i];
+    El::Zeros(row_sqsums, mat.Height(), 1);
+
+    // Matrix data
+    const size_t height = mat.Height();
+    const size_t width = mat.Width();
+    const T* __restrict__ mat_buf = mat.LockedBuffer();
+    const size_t mat_ldim = mat.LDim();
+    T* __restrict__ row_sqsums_buf = row_sqsums.Buffer();
+
+    // Compute sums of squares for each row
+    LBANN_OMP_PARALLEL_FOR
+    for (size_t row_start = 0; row_start < height; row_start += bsize) {
+      const size_t row_end = std::min(row_start + bsize, height);
+      for (size_t col = 0; col < width; ++col) {
+        for (size_t row = row_start; row < row_end; ++row) {
+          const auto& x = mat_buf[row + col * mat_ldim];
+          auto& y = row_sqsums_buf[row];
+          y += x * x;
+        }
+      }
+    }
+  }
+}
+
+template <typename T>
+void batched_sqrt(std::vector<El::Matrix<T, El::Device::CPU>*> const& mats)
+{
+  for (auto* mat : mats) {
+    El::EntrywiseMap(*mat, {[](T const& a) { return El::Sqrt(a); }});
+  }
+}
+
+#define PROTO(T)                                                               \
+  template void batched_row_sqsums(                                            \
+    std::vector<const El::Matrix<T, El::Device::CPU>*> const&,                 \
+    std::vector<El::Matrix<T, El::Device::CPU>*> const&);                      \
+  template void batched_sqrt(                                                  \
+    std::vector<El::Matrix<T, El::Device::CPU>*> const&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+
+#define LBANN_ROW_NORMS_INSTANTIATE
+#include "lbann/utils/row_norms.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+namespace {
+
+/** @brief Matrices per launch of a batched kernel */
+constexpr int batched_max_matrices = 32;
+/** @brief Threads per block, each summing one row of a tile */
+constexpr size_t row_tile_size = 256;
+/** @brief Columns of a tile */
+constexpr size_t col_tile_size = 64;
+
+/** @brief Kernel argument of batched_row_sqsums_kernel
+ *
+ *  Matrix @c i is split into tiles, which are processed by virtual
+ *  blocks @c block_offsets[i] to @c block_offsets[i+1]-1.
+ */
+template <typename T>
+struct row_sqsums_args
+{
+  const T* mats[batched_max_matrices];
+  T* sqsums[batched_max_matrices];
+  size_t heights[batched_max_matrices];
+  size_t widths[batched_max_matrices];
+  size_t ldims[batched_max_matrices];
+  size_t block_offsets[batched_max_matrices + 1];
+  int num_mats;
+};
+
+/** @brief Kernel argument of batched_entrywise_kernel
+ *
+ *  Entries @c offsets[i] to @c offsets[i+1]-1 of the concatenated
+ *  buffers are in buffer @c i.
+ */
+template <typename T>
+struct entrywise_args
+{
+  T* bufs[batched_max_matrices];
+  size_t offsets[batched_max_matrices + 1];
+  int num_bufs;
+};
+
+/**
+ *  Block dimensions: row_tile_size x 1 x 1
+ *
+ *  Grid dimensions: num_blocks x 1 x 1
+ *
+ *  Blocks loop over the virtual blocks of all the matrices. Each
+ *  thread adds the sum of squares of a row of a tile to the output.
+ */
+template <typename T>
+__global__ void batched_row_sqsums_kernel(row_sqsums_args<T> args)
+{
+  const size_t num_blocks = args.block_offsets[args.num_mats];
+  for (size_t bid = blockIdx.x; bid < num_blocks; bid += gridDim.x) {
+    int i = 0;
+    while (bid >= args.block_offsets[i + 1]) {
+      ++i;
+    }
+    const size_t height = args.heights[i];
+    const size_t width = args.widths[i];
+    const size_t row_tiles = (height + row_tile_size - 1) / row_tile_size;
+    const size_t tile = bid - args.block_offsets[i];
+    const size_t row = (tile % row_tiles) * row_tile_size + threadIdx.x;
+    const size_t col_begin = (tile / row_tiles) * col_tile_size;
+    const size_t col_end =
+      (col_begin + col_tile_size < width ? col_begin + col_tile_size : width);
+    if (row < height) {
+      const auto* __restrict__ mat = args.mats[i];
+      const size_t ldim = args.ldims[i];
+      T sqsum{0};
+      for (size_t col = col_begin; col < col_end; ++col) {
+        const auto& x = mat[row + col * ldim];
+        sqsum += x * x;
+      }
+      gpu_lib::atomic_add(&args.sqsums[i][row], sqsum);
+    }
+  }
+}
+
+/** @brief Set entries to zero */
+template <typename T>
+struct zero_op
+{
+  __device__ __forceinline__ T operator()(const T&) const { return T{0}; }
+};
+
+/** @brief Square root of entries */
+template <typename T>
+struct sqrt_op
+{
+  __device__ __forceinline__ T operator()(const T& x) const
+  {
+    return gpu_lib::sqrt(x);
+  }
+};
+
+/**
+ *  Block dimensions: bdim x 1 x 1
+ *
+ *  Grid dimensions: (size/bdim) x 1 x 1
+ */
+template <typename T, typename Op>
+__global__ void batched_entrywise_kernel(entrywise_args<T> args, Op op)
+{
+  const size_t size = args.offsets[args.num_bufs];
+  const size_t gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const size_t nthreads = blockDim.x * gridDim.x;
+  int i = 0;
+  for (size_t pos = gid; pos < size; pos += nthreads) {
+    while (pos >= args.offsets[i + 1]) {
+      ++i;
+    }
+    auto& x = args.bufs[i][pos - args.offsets[i]];
+    x = op(x);
+  }
+}
+
+/** @brief Apply an entrywise operation to several contiguous
+ *         matrices, in one launch per 32 matrices */
+template <typename T, typename Op>
+void batched_entrywise(std::vector<El::Matrix<T, El::Device::GPU>*> const& mats,
+                       Op const& op,
+                       El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  entrywise_args<T> args;
+  args.num_bufs = 0;
+  args.offsets[0] = 0;
+  auto launch = [&]() {
+    const size_t size = args.offsets[args.num_bufs];
+    if (size > 0) {
+      constexpr size_t block_size = 256;
+      dim3 grid_dims((size + block_size - 1) / block_size);
+      gpu_lib::clip_grid_dims(grid_dims);
+      hydrogen::gpu::LaunchKernel(batched_entrywise_kernel<T, Op>,
+                                  grid_dims,
+                                  block_size,
+                                  0,
+                                  sync_info,
+                                  args,
+                                  op);
+    }
+    args.num_bufs = 0;
+  };
+  for (auto* mat : mats) {
+    if (mat->IsEmpty()) {
+      continue;
+    }
+    if (!mat->Contiguous()) {
+      LBANN_ERROR("matrix is not contiguous");
+    }
+    const int j = args.num_bufs++;
+    args.bufs[j] = mat->Buffer();
+    args.offsets[j + 1] = args.offsets[j] + mat->Height() * mat->Width();
+    if (args.num_bufs == batched_max_matrices) {
+      launch();
+    }
+  }
+  launch();
+}
+
+/** @brief Order a stream after the work on several streams */
+void synchronize_with(
+  std::vector<El::SyncInfo<El::Device::GPU>> const& sync_infos,
+  El::SyncInfo<El::Device::GPU> const& sync_info)
+{
+  for (const auto& si : sync_infos) {
+    if (si.Stream() != sync_info.Stream()) {
+      El::AddSynchronizationPoint(si, sync_info);
+    }
+  }
+}
+
+/** @brief Order several streams after the work on a stream */
+void synchronize_with(
+  El::SyncInfo<El::Device::GPU> const& sync_info,
+  std::vector<El::SyncInfo<El::Device::GPU>> const& sync_infos)
+{
+  for (const auto& si : sync_infos) {
+    if (si.Stream() != sync_info.Stream()) {
+      El::AddSynchronizationPoint(sync_info, si);
+    }
+  }
+}
+
+} // namespace
+
+template <typename T>
+void batched_row_sqsums(
+  std::vector<const El::Matrix<T, El::Device::GPU>*> const& mats,
+  std::vector<El::Matrix<T, El::Device::GPU>*> const& sqsums)
+{
+  if (mats.size() != sqsums.size()) {
+    LBANN_ERROR("got ",
+                mats.size(),
+                " matrices but ",
+                sqsums.size(),
+                " outputs for row sums of squares");
+  }
+  if (mats.empty()) {
+    return;
+  }
+
+  // Outputs are accumulated with atomics, so they are zeroed first
+  std::vector<El::SyncInfo<El::Device::GPU>> sync_infos;
+  for (size_t i = 0; i < mats.size(); ++i) {
+    sqsums[i]->Resize(mats[i]->Height(), 1);
+    sync_infos.push_back(gpu::get_sync_info(*sqsums[i]));
+    sync_infos.push_back(gpu::get_sync_info(*mats[i]));
+  }
+  const auto sync_info = sync_infos.front();
+  synchronize_with(sync_infos, sync_info);
+  batched_entrywise(sqsums, zero_op<T>{}, sync_info);
+
+  // Sums of squares
+  row_sqsums_args<T> args;
+  args.num_mats = 0;
+  args.block_offsets[0] = 0;
+  auto launch = [&]() {
+    const size_t num_blocks = args.block_offsets[args.num_mats];
+    if (num_blocks > 0) {
+      dim3 grid_dims(num_blocks);
+      gpu_lib::clip_grid_dims(grid_dims);
+      hydrogen::gpu::LaunchKernel(batched_row_sqsums_kernel<T>,
+                                  grid_dims,
+                                  row_tile_size,
+                                  0,
+                                  sync_info,
+                                  args);
+    }
+    args.num_mats = 0;
+  };
+  for (size_t i = 0; i < mats.size(); ++i) {
+    const auto& mat = *mats[i];
+    if (mat.IsEmpty()) {
+      continue;
+    }
+    const size_t height = mat.Height();
+    const size_t width = mat.Width();
+    const size_t row_tiles = (height + row_tile_size - 1) / row_tile_size;
+    const size_t col_tiles = (width + col_tile_size - 1) / col_tile_size;
+    const int j = args.num_mats++;
+    args.mats[j] = mat.LockedBuffer();
+    args.sqsums[j] = sqsums[i]->Buffer();
+    args.heights[j] = height;
+    args.widths[j] = width;
+    args.ldims[j] = mat.LDim();
+    args.block_offsets[j + 1] = args.block_offsets[j] + row_tiles * col_tiles;
+    if (args.num_mats == batched_max_matrices) {
+      launch();
+    }
+  }
+  launch();
+  synchronize_with(sync_info, sync_infos);
+}
+
+template <typename T>
+void batched_sqrt(std::vector<El::Matrix<T, El::Device::GPU>*> const& mats)
+{
+  if (mats.empty()) {
+    return;
+  }
+  std::vector<El::SyncInfo<El::Device::GPU>> sync_infos;
+  for (auto* mat : mats) {
+    sync_infos.push_back(gpu::get_sync_info(*mat));
+  }
+  const auto sync_info = sync_infos.front();
+  synchronize_with(sync_infos, sync_info);
+  batched_entrywise(mats, sqrt_op<T>{}, sync_info);
+  synchronize_with(sync_info, sync_infos);
+}
+
+#define PROTO(T)                                                               \
+  template void batched_row_sqsums(                                            \
+    std::vector<const El::Matrix<T, El::Device::GPU>*> const&,                 \
+    std::vector<El::Matrix<T, El::Device::GPU>*> const&);                      \
+  template void batched_sqrt(                                                  \
+    std::vector<El::Matrix<T, El::Device::GPU>*> const&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
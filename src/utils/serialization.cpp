@@ -31,6 +31,11 @@
  */
 
 #include "lbann/utils/serialize.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/serialization/dist_matrix_index.hpp"
+
+#include <cstring>
+#include <fstream>
 
 /** @namespace cereal
  *
@@ -108,5 +113,120 @@ grid_manager::grid_manager(El::Grid const& g) { push_grid_(g); }
 
 grid_manager::~grid_manager() { pop_grid_(); }
 
+namespace {
+dist_matrix_recorder* current_recorder_ = nullptr;
+dist_matrix_resharder* current_resharder_ = nullptr;
+
+constexpr char dist_matrix_index_magic[] = "LBDMIDX1";
+} // namespace
+
+dist_matrix_recorder::dist_matrix_recorder(std::ostream& os) : m_os{&os}
+{
+  if (current_recorder_ != nullptr) {
+    LBANN_ERROR("distributed matrices are already being recorded");
+  }
+  current_recorder_ = this;
+}
+
+dist_matrix_recorder::~dist_matrix_recorder() { current_recorder_ = nullptr; }
+
+dist_matrix_recorder* get_dist_matrix_recorder() noexcept
+{
+  return current_recorder_;
+}
+
+void write_dist_matrix_index(std::ostream& os,
+                             std::vector<dist_matrix_record> const& records,
+                             El::Int num_procs)
+{
+  const uint64_t header[] = {static_cast<uint64_t>(num_procs),
+                             records.size()};
+  os.write(dist_matrix_index_magic, 8);
+  os.write(reinterpret_cast<const char*>(header), sizeof(header));
+  os.write(reinterpret_cast<const char*>(records.data()),
+           records.size() * sizeof(dist_matrix_record));
+  if (os.fail()) {
+    LBANN_ERROR("failed to write a distributed matrix index");
+  }
+}
+
+std::vector<dist_matrix_record> read_dist_matrix_index(std::istream& is,
+                                                       El::Int& num_procs)
+{
+  char magic[8];
+  uint64_t header[2];
+  is.read(magic, sizeof(magic));
+  is.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (!is || std::memcmp(magic, dist_matrix_index_magic, 8) != 0) {
+    LBANN_ERROR("invalid distributed matrix index");
+  }
+  num_procs = static_cast<El::Int>(header[0]);
+  std::vector<dist_matrix_record> records(header[1]);
+  is.read(reinterpret_cast<char*>(records.data()),
+          records.size() * sizeof(dist_matrix_record));
+  if (!is) {
+    LBANN_ERROR("truncated distributed matrix index");
+  }
+  return records;
+}
+
+dist_matrix_resharder::dist_matrix_resharder(std::istream& primary,
+                                             std::vector<source> sources)
+  : m_primary{&primary},
+    m_sources{std::move(sources)},
+    m_streams(m_sources.size())
+{
+  if (current_resharder_ != nullptr) {
+    LBANN_ERROR("distributed matrices are already being resharded");
+  }
+  current_resharder_ = this;
+}
+
+dist_matrix_resharder::~dist_matrix_resharder()
+{
+  current_resharder_ = nullptr;
+}
+
+dist_matrix_record const& dist_matrix_resharder::record(size_t src,
+                                                        size_t matrix) const
+{
+  const auto& records = m_sources.at(src).records;
+  if (matrix >= records.size()) {
+    LBANN_ERROR("archive ",
+                m_sources[src].filename,
+                " has ",
+                records.size(),
+                " distributed matrices, but matrix ",
+                matrix,
+                " was loaded");
+  }
+  return records[matrix];
+}
+
+void dist_matrix_resharder::read(size_t src,
+                                 uint64_t offset,
+                                 void* data,
+                                 size_t size)
+{
+  auto& is = m_streams.at(src);
+  if (is == nullptr) {
+    is = std::make_unique<std::ifstream>(m_sources[src].filename,
+                                         std::ios::binary);
+  }
+  is->seekg(m_sources[src].offset + offset);
+  is->read(static_cast<char*>(data), size);
+  if (!*is) {
+    LBANN_ERROR("failed to read ",
+                size,
+                " bytes from ",
+                m_sources[src].filename);
+  }
+}
+
+dist_matrix_resharder* get_dist_matrix_resharder() noexcept
+{
+  return current_resharder_;
+}
+
 } // namespace utils
 } // namespace lbann
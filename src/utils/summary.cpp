@@ -42,6 +42,11 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm* comm)
 {
   if (m_comm->am_world_master()) {
     m_sw = new TBinf::SummaryWriter(logdir);
+    m_writer = std::thread([this]() {
+      while (auto op = m_writes.wait_and_pop()) {
+        (*op)();
+      }
+    });
   }
   else {
     m_sw = nullptr;
@@ -52,6 +57,10 @@ lbann_summary::lbann_summary(std::string logdir, lbann_comm* comm)
 lbann_summary::~lbann_summary()
 {
   flush();
+  if (m_writer.joinable()) {
+    m_writes.wake_all(true);
+    m_writer.join();
+  }
   if (m_sw != nullptr) {
     delete m_sw;
   }
@@ -76,195 +85,206 @@ void lbann_summary::report_image(std::string const& tag,
 
   auto uint8_img = get_uint8_t_image(image, dims);
   auto img_str = encode_image(uint8_img, dims, img_format);
-  m_sw->add_image(tag, img_str, dims, step);
+  write([this, tag, img_str = std::move(img_str), dims, step]() {
+    m_sw->add_image(tag, img_str, dims, step);
+  });
 }
 #endif // LBANN_HAS_OPENCV
 
 void lbann_summary::flush()
 {
-  flush_means();
-  flush_mins();
-  flush_maxes();
-  flush_stdevs();
-  flush_scalars();
-  flush_sum_scalars();
+  flush_reductions();
   flush_scalar_alls();
-  flush_histograms();
-  if (m_sw != nullptr) {
-    m_sw->flush();
-  }
+  write([this]() { m_sw->flush(); });
 }
 
-void lbann_summary::flush_means()
+void lbann_summary::flush_reductions()
 {
-  if (m_pending_means.empty()) {
-    return;
-  }
+#ifdef LBANN_HAS_GPU
+  copy_device_statistics();
+#endif // LBANN_HAS_GPU
+
+  // Pack everything combined with a sum, and everything combined
+  // with a minimum. Maxima are negated to share the minimum.
   std::vector<float> local_sums;
+  std::vector<float> local_mins;
   for (const auto& op : m_pending_means) {
     local_sums.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    // Compute the means in-place.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] /= m_pending_means[i].num;
-    }
-    gather_scalar_summary(m_pending_means, global_sums);
+  for (const auto& op : m_pending_stdevs) {
+    local_sums.push_back(op.local);
+    local_sums.push_back(op.local2);
   }
-  else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+  for (const auto& op : m_pending_sum_scalars) {
+    local_sums.push_back(op.local);
   }
-  m_pending_means.clear();
-}
-
-void lbann_summary::flush_mins()
-{
-  if (m_pending_mins.empty()) {
-    return;
+  for (const auto& op : m_pending_statistics) {
+    local_sums.push_back(op.sum);
+    local_sums.push_back(op.sqsum);
+  }
+  for (const auto& op : m_pending_histograms) {
+    local_sums.push_back(op.sum);
+    local_sums.push_back(op.sqsum);
+    local_sums.insert(local_sums.end(),
+                      op.buckets.begin(),
+                      op.buckets.begin() + m_histogram_buckets.size());
   }
-  std::vector<float> local_mins;
   for (const auto& op : m_pending_mins) {
     local_mins.push_back(op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_mins(local_mins.size());
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           global_mins.data(),
-                           El::mpi::MIN);
-    gather_scalar_summary(m_pending_mins, global_mins);
-  }
-  else {
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MIN);
-  }
-  m_pending_mins.clear();
-}
-
-void lbann_summary::flush_maxes()
-{
-  if (m_pending_maxes.empty()) {
-    return;
-  }
-  std::vector<float> local_maxes;
   for (const auto& op : m_pending_maxes) {
-    local_maxes.push_back(op.local);
+    local_mins.push_back(-op.local);
   }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_maxes(local_maxes.size());
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           global_maxes.data(),
-                           El::mpi::MAX);
-    gather_scalar_summary(m_pending_maxes, global_maxes);
+  for (const auto& op : m_pending_statistics) {
+    local_mins.push_back(op.min);
+    local_mins.push_back(-op.max);
   }
-  else {
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MAX);
+  for (const auto& op : m_pending_histograms) {
+    local_mins.push_back(op.min);
+    local_mins.push_back(-op.max);
   }
-  m_pending_maxes.clear();
-}
 
-void lbann_summary::flush_stdevs()
-{
-  if (m_pending_stdevs.empty()) {
-    return;
-  }
-  std::vector<float> local_sums;
-  std::vector<float> local_sqsums;
-  for (const auto& op : m_pending_stdevs) {
-    local_sums.push_back(op.local);
-    local_sqsums.push_back(op.local2);
-  }
   if (m_comm->am_trainer_master()) {
-    // Compute the model sample standard deviation as:
-    // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)]
-    // The n-1 is to use an unbiased variance estimate.
-    // This unrolls the usual formulation of standard deviation some, to avoid
-    // global operations when pushing the operation.
-    std::vector<float> global_sums(local_sums.size());
-    std::vector<float> global_sqsums(local_sqsums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           global_sqsums.data(),
-                           El::mpi::SUM);
-    // Re-use the global_sums vector for the standard deviation.
-    for (unsigned i = 0; i < global_sums.size(); ++i) {
-      global_sums[i] =
-        El::Sqrt((global_sqsums[i] -
-                  global_sums[i] * global_sums[i] / m_pending_stdevs[i].num) /
-                 (m_pending_stdevs[i].num - 1));
+    std::vector<float> sums(local_sums.size());
+    std::vector<float> mins(local_mins.size());
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(),
+                             local_sums.size(),
+                             sums.data(),
+                             El::mpi::SUM);
+    }
+    if (!local_mins.empty()) {
+      m_comm->trainer_reduce(local_mins.data(),
+                             local_mins.size(),
+                             mins.data(),
+                             El::mpi::MIN);
     }
-    gather_scalar_summary(m_pending_stdevs, global_sums);
-  }
-  else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-  }
-  m_pending_stdevs.clear();
-}
 
-void lbann_summary::flush_scalars()
-{
-  if (m_pending_scalars.empty()) {
-    return;
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> local_scalars;
+    // Compute the summaries of this model, in the order they are
+    // written. The sample standard deviation is computed as
+    // sqrt[1/(n-1) (sqsum - (1/n)*sum^2)], with n-1 for an unbiased
+    // variance estimate.
+    auto stdev = [](float sum, float sqsum, int num) {
+      return El::Sqrt((sqsum - sum * sum / num) / (num - 1));
+    };
+    const float* sum = sums.data();
+    const float* min = mins.data();
+    std::vector<float> model_values;
+    for (const auto& op : m_pending_means) {
+      model_values.push_back(*sum++ / op.num);
+    }
+    for (size_t i = 0; i < m_pending_mins.size(); ++i) {
+      model_values.push_back(*min++);
+    }
+    for (size_t i = 0; i < m_pending_maxes.size(); ++i) {
+      model_values.push_back(-*min++);
+    }
+    for (const auto& op : m_pending_stdevs) {
+      model_values.push_back(stdev(sum[0], sum[1], op.num));
+      sum += 2;
+    }
     for (const auto& op : m_pending_scalars) {
-      local_scalars.push_back(op.local);
+      model_values.push_back(op.local);
+    }
+    for (size_t i = 0; i < m_pending_sum_scalars.size(); ++i) {
+      model_values.push_back(*sum++);
+    }
+    for (const auto& op : m_pending_statistics) {
+      model_values.push_back(sum[0] / op.num);
+      model_values.push_back(min[0]);
+      model_values.push_back(-min[1]);
+      model_values.push_back(stdev(sum[0], sum[1], op.num));
+      model_values.push_back(sum[1]);
+      sum += 2;
+      min += 2;
+    }
+    for (size_t i = 0; i < m_pending_histograms.size(); ++i) {
+      model_values.push_back(min[0]);
+      model_values.push_back(-min[1]);
+      min += 2;
+      model_values.insert(model_values.end(),
+                          sum,
+                          sum + 2 + m_histogram_buckets.size());
+      sum += 2 + m_histogram_buckets.size();
     }
-    gather_scalar_summary(m_pending_scalars, local_scalars);
-  }
-  m_pending_scalars.clear();
-}
 
-void lbann_summary::flush_sum_scalars()
-{
-  if (m_pending_sum_scalars.empty()) {
-    return;
-  }
-  std::vector<float> local_sums;
-  for (const auto& op : m_pending_sum_scalars) {
-    local_sums.push_back(op.local);
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> global_sums(local_sums.size());
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           global_sums.data(),
-                           El::mpi::SUM);
-    gather_scalar_summary(m_pending_sum_scalars, global_sums);
+    // Gather to the world master for writing out.
+    if (m_comm->am_world_master()) {
+      std::vector<float> values(m_comm->get_num_trainers() *
+                                model_values.size());
+      if (!model_values.empty()) {
+        m_comm->intertrainer_gather(model_values.data(),
+                                    model_values.size(),
+                                    values.data());
+      }
+      const float* value = values.data();
+      for (int model = 0; model < m_comm->get_num_trainers(); ++model) {
+        for (const auto* ops : {&m_pending_means,
+                                &m_pending_mins,
+                                &m_pending_maxes,
+                                &m_pending_stdevs,
+                                &m_pending_scalars,
+                                &m_pending_sum_scalars}) {
+          for (const auto& op : *ops) {
+            write_scalar(prepend_model(op.tag, model), *value++, op.step);
+          }
+        }
+        for (const auto& op : m_pending_statistics) {
+          for (const auto* name : {"/mean", "/min", "/max", "/stdev",
+                                   "/2norm2"}) {
+            write_scalar(prepend_model(op.tag + name, model),
+                         *value++,
+                         op.step);
+          }
+        }
+        for (const auto& op : m_pending_histograms) {
+          std::vector<float> buckets(value + 4,
+                                     value + 4 + m_histogram_buckets.size());
+          write([this,
+                 tag = prepend_model(op.tag, model),
+                 buckets = std::move(buckets),
+                 min = value[0],
+                 max = value[1],
+                 num = op.num,
+                 sum = value[2],
+                 sqsum = value[3],
+                 step = op.step]() {
+            m_sw->add_histogram(tag, buckets, min, max, num, sum, sqsum, step);
+          });
+          value += 4 + m_histogram_buckets.size();
+        }
+      }
+    }
+    else if (!model_values.empty()) {
+      m_comm->intertrainer_gather(model_values.data(),
+                                  model_values.size(),
+                                  m_comm->get_intertrainer_master());
+    }
   }
   else {
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+    if (!local_sums.empty()) {
+      m_comm->trainer_reduce(local_sums.data(),
+                             local_sums.size(),
+                             m_comm->get_trainer_master(),
+                             El::mpi::SUM);
+    }
+    if (!local_mins.empty()) {
+      m_comm->trainer_reduce(local_mins.data(),
+                             local_mins.size(),
+                             m_comm->get_trainer_master(),
+                             El::mpi::MIN);
+    }
   }
+
+  m_pending_means.clear();
+  m_pending_mins.clear();
+  m_pending_maxes.clear();
+  m_pending_stdevs.clear();
+  m_pending_scalars.clear();
   m_pending_sum_scalars.clear();
+  m_pending_statistics.clear();
+  m_pending_histograms.clear();
+  // TODO: Support histograms on multiple models.
 }
 
 void lbann_summary::flush_scalar_alls()
@@ -288,11 +308,11 @@ void lbann_summary::flush_scalar_alls()
       int rank = i / local_scalars.size();
       int model = rank / m_comm->get_procs_per_trainer();
       int pos = i % local_scalars.size();
-      m_sw->add_scalar(prepend_model("rank" + std::to_string(rank) + "/" +
-                                       m_pending_scalar_alls[pos].tag,
-                                     model),
-                       scalars[i],
-                       m_pending_scalar_alls[pos].step);
+      write_scalar(prepend_model("rank" + std::to_string(rank) + "/" +
+                                   m_pending_scalar_alls[pos].tag,
+                                 model),
+                   scalars[i],
+                   m_pending_scalar_alls[pos].step);
     }
   }
   else {
@@ -304,173 +324,23 @@ void lbann_summary::flush_scalar_alls()
   m_pending_scalar_alls.clear();
 }
 
-void lbann_summary::flush_histograms()
+void lbann_summary::write(std::function<void()> op)
 {
-  if (m_pending_histograms.empty()) {
-    return;
-  }
-  std::vector<float> local_mins;
-  std::vector<float> local_maxes;
-  std::vector<float> local_sums;
-  std::vector<float> local_sqsums;
-  std::vector<float> buckets;
-  for (const auto& op : m_pending_histograms) {
-    local_mins.push_back(op.min);
-    local_maxes.push_back(op.max);
-    local_sums.push_back(op.sum);
-    local_sqsums.push_back(op.sqsum);
-    buckets.insert(buckets.end(), op.buckets.begin(), op.buckets.end());
-  }
-  if (m_comm->am_trainer_master()) {
-    std::vector<float> model_mins(local_mins.size());
-    std::vector<float> model_maxes(local_maxes.size());
-    std::vector<float> model_sums(local_sums.size());
-    std::vector<float> model_sqsums(local_sqsums.size());
-    std::vector<float> model_buckets(buckets.size());
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           model_mins.data(),
-                           El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           model_maxes.data(),
-                           El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(),
-                           model_sums.size(),
-                           model_sums.data());
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           model_sqsums.data());
-    m_comm->trainer_reduce(buckets.data(),
-                           buckets.size(),
-                           model_buckets.data());
-    // Gather to the world master for writing out.
-    if (m_comm->am_world_master()) {
-      std::vector<float> global_mins(m_comm->get_num_trainers() *
-                                     model_mins.size());
-      std::vector<float> global_maxes(m_comm->get_num_trainers() *
-                                      model_maxes.size());
-      std::vector<float> global_sums(m_comm->get_num_trainers() *
-                                     model_sums.size());
-      std::vector<float> global_sqsums(m_comm->get_num_trainers() *
-                                       model_sqsums.size());
-      std::vector<float> global_buckets(m_comm->get_num_trainers() *
-                                        model_buckets.size());
-      m_comm->intertrainer_gather(model_mins.data(),
-                                  model_mins.size(),
-                                  global_mins.data());
-      m_comm->intertrainer_gather(model_maxes.data(),
-                                  model_maxes.size(),
-                                  global_maxes.data());
-      m_comm->intertrainer_gather(model_sums.data(),
-                                  model_sums.size(),
-                                  global_sums.data());
-      m_comm->intertrainer_gather(model_sqsums.data(),
-                                  model_sqsums.size(),
-                                  global_sqsums.data());
-      m_comm->intertrainer_gather(model_buckets.data(),
-                                  model_buckets.size(),
-                                  global_buckets.data());
-      for (unsigned i = 0; i < global_mins.size(); ++i) {
-        int model = i / m_pending_histograms.size();
-        unsigned ops_pos = i % m_pending_histograms.size();
-        std::vector<float> tmp_buckets(
-          global_buckets.begin() + i * m_histogram_buckets.size(),
-          global_buckets.begin() + (i + 1) * m_histogram_buckets.size());
-        m_sw->add_histogram(
-          prepend_model(m_pending_histograms[ops_pos].tag, model),
-          tmp_buckets,
-          global_mins[i],
-          global_maxes[i],
-          m_pending_histograms[ops_pos].num,
-          global_sums[i],
-          global_sqsums[i],
-          m_pending_histograms[ops_pos].step);
-      }
-    }
-    else {
-      m_comm->intertrainer_gather(model_mins.data(),
-                                  model_mins.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_maxes.data(),
-                                  model_maxes.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sums.data(),
-                                  model_sums.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_sqsums.data(),
-                                  model_sqsums.size(),
-                                  m_comm->get_intertrainer_master());
-      m_comm->intertrainer_gather(model_buckets.data(),
-                                  model_buckets.size(),
-                                  m_comm->get_intertrainer_master());
-    }
-  }
-  else {
-    m_comm->trainer_reduce(local_mins.data(),
-                           local_mins.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MIN);
-    m_comm->trainer_reduce(local_maxes.data(),
-                           local_maxes.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::MAX);
-    m_comm->trainer_reduce(local_sums.data(),
-                           local_sums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(local_sqsums.data(),
-                           local_sqsums.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
-    m_comm->trainer_reduce(buckets.data(),
-                           buckets.size(),
-                           m_comm->get_trainer_master(),
-                           El::mpi::SUM);
+  if (m_sw != nullptr) {
+    m_writes.push(std::move(op));
   }
-  m_pending_histograms.clear();
 }
 
-std::string lbann_summary::prepend_model(const std::string tag, int model) const
+void lbann_summary::write_scalar(std::string tag, float value, int step)
 {
-  return "model" + std::to_string(model) + "/" + tag;
-}
-
-void lbann_summary::gather_scalar_summary(const std::vector<pending_op>& ops,
-                                          std::vector<float>& scalars)
-{
-  if (m_comm->am_world_master()) {
-    std::vector<float> data(m_comm->get_num_trainers() * scalars.size());
-    m_comm->intertrainer_gather(scalars.data(), scalars.size(), data.data());
-    for (unsigned i = 0; i < data.size(); ++i) {
-      int model = i / ops.size();
-      unsigned ops_pos = i % ops.size();
-      m_sw->add_scalar(prepend_model(ops[ops_pos].tag, model),
-                       data[i],
-                       ops[ops_pos].step);
-    }
-  }
-  else {
-    m_comm->intertrainer_gather(scalars.data(),
-                                scalars.size(),
-                                m_comm->get_intertrainer_master());
-  }
+  write([this, tag = std::move(tag), value, step]() {
+    m_sw->add_scalar(tag, value, step);
+  });
 }
 
-void lbann_summary::gather_scalar_summary(const std::string tag,
-                                          float s,
-                                          int step)
+std::string lbann_summary::prepend_model(const std::string tag, int model) const
 {
-  if (m_comm->am_world_master()) {
-    std::vector<float> data(m_comm->get_num_trainers());
-    m_comm->intertrainer_gather(s, data);
-    for (size_t model = 0; model < data.size(); ++model) {
-      m_sw->add_scalar(prepend_model(tag, model), data[model], step);
-    }
-  }
-  else {
-    m_comm->intertrainer_gather(s, m_comm->get_intertrainer_master());
-  }
+  return "model" + std::to_string(model) + "/" + tag;
 }
 
 #endif // LBANN_HAS_TBINF
@@ -0,0 +1,214 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/summary_impl.hpp"
+
+#include "lbann/utils/gpu/helpers.hpp"
+
+namespace lbann {
+
+#ifdef LBANN_HAS_TBINF
+
+namespace {
+
+constexpr int block_size = 256;
+/** Blocks per reduction; each block adds to the result atomically. */
+constexpr El::Int max_grid_size = 160;
+
+/** Atomic minimum of floats by their integer representations. */
+__device__ __forceinline__ void atomic_min(float* address, float val)
+{
+  if (val >= 0.f) {
+    atomicMin(reinterpret_cast<int*>(address), __float_as_int(val));
+  }
+  else {
+    atomicMax(reinterpret_cast<unsigned int*>(address), __float_as_uint(val));
+  }
+}
+
+/** Add the sum, sum of squares, minimum and negated maximum of a
+ *  matrix to stats. NaNs are ignored by the minima. */
+template <typename TensorDataType>
+__global__ void statistics_kernel(El::Int height,
+                                  El::Int width,
+                                  const TensorDataType* __restrict__ x,
+                                  El::Int ldx,
+                                  float* __restrict__ stats)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  const El::Int size = height * width;
+  float sum = 0.f;
+  float sqsum = 0.f;
+  float min = INFINITY;
+  float negmax = INFINITY;
+  for (El::Int pos = gid; pos < size; pos += nthreads) {
+    const auto row = pos % height;
+    const auto col = pos / height;
+    const auto val = static_cast<float>(x[row + col * ldx]);
+    sum += val;
+    sqsum += val * val;
+    min = fminf(min, val);
+    negmax = fminf(negmax, -val);
+  }
+
+  // Compute contributions for each block
+  __shared__ float shared_stats[4][block_size];
+  const int tid = threadIdx.x;
+  shared_stats[0][tid] = sum;
+  shared_stats[1][tid] = sqsum;
+  shared_stats[2][tid] = min;
+  shared_stats[3][tid] = negmax;
+  for (int stride = block_size / 2; stride > 0; stride /= 2) {
+    __syncthreads();
+    if (tid < stride) {
+      shared_stats[0][tid] += shared_stats[0][tid + stride];
+      shared_stats[1][tid] += shared_stats[1][tid + stride];
+      shared_stats[2][tid] =
+        fminf(shared_stats[2][tid], shared_stats[2][tid + stride]);
+      shared_stats[3][tid] =
+        fminf(shared_stats[3][tid], shared_stats[3][tid + stride]);
+    }
+  }
+  if (tid == 0) {
+    gpu_lib::atomic_add(&stats[0], shared_stats[0][0]);
+    gpu_lib::atomic_add(&stats[1], shared_stats[1][0]);
+    atomic_min(&stats[2], shared_stats[2][0]);
+    atomic_min(&stats[3], shared_stats[3][0]);
+  }
+}
+
+/** Set groups of four statistics to their identities. */
+__global__ void reset_statistics_kernel(El::Int size,
+                                        float* __restrict__ stats)
+{
+  const El::Int gid = threadIdx.x + blockIdx.x * blockDim.x;
+  const El::Int nthreads = blockDim.x * gridDim.x;
+  for (El::Int pos = gid; pos < size; pos += nthreads) {
+    stats[pos] = (pos % 4 < 2 ? 0.f : INFINITY);
+  }
+}
+
+void reset_statistics(El::Matrix<float, El::Device::GPU>& stats,
+                      El::Int begin,
+                      El::Int end)
+{
+  const El::Int size = end - begin;
+  if (size > 0) {
+    const El::Int grid_size =
+      std::min((size + block_size - 1) / block_size, max_grid_size);
+    hydrogen::gpu::LaunchKernel(reset_statistics_kernel,
+                                grid_size,
+                                block_size,
+                                0,
+                                El::SyncInfoFromMatrix(stats),
+                                size,
+                                stats.Buffer() + begin);
+  }
+}
+
+} // namespace
+
+template <typename TensorDataType>
+void lbann_summary::local_statistics_gpu(
+  const El::AbstractMatrix<TensorDataType>& mat,
+  pending_statistics& op)
+{
+  const auto& local_mat =
+    static_cast<const El::Matrix<TensorDataType, El::Device::GPU>&>(mat);
+
+  // Grow the device statistics, keeping the pending columns
+  const El::Int capacity = m_device_statistics.Height() / 4;
+  if (m_num_device_statistics == capacity) {
+    El::Matrix<float, El::Device::GPU> old_stats;
+    old_stats.SetSyncInfo(El::SyncInfoFromMatrix(m_device_statistics));
+    El::Copy(m_device_statistics, old_stats);
+    m_device_statistics.Resize(4 * std::max(2 * capacity, El::Int(16)), 1);
+    reset_statistics(m_device_statistics,
+                     old_stats.Height(),
+                     m_device_statistics.Height());
+    if (old_stats.Height() > 0) {
+      auto head = El::View(m_device_statistics,
+                           El::IR(0, old_stats.Height()),
+                           El::ALL);
+      El::Copy(old_stats, head);
+    }
+  }
+  op.column = m_num_device_statistics++;
+
+  const El::Int size = local_mat.Height() * local_mat.Width();
+  const El::Int grid_size =
+    std::min((size + block_size - 1) / block_size, max_grid_size);
+  auto multisync =
+    El::MakeMultiSync(El::SyncInfoFromMatrix(m_device_statistics),
+                      El::SyncInfoFromMatrix(local_mat));
+  hydrogen::gpu::LaunchKernel(statistics_kernel<TensorDataType>,
+                              grid_size,
+                              block_size,
+                              0,
+                              multisync,
+                              local_mat.Height(),
+                              local_mat.Width(),
+                              local_mat.LockedBuffer(),
+                              local_mat.LDim(),
+                              m_device_statistics.Buffer() + 4 * op.column);
+}
+
+void lbann_summary::copy_device_statistics()
+{
+  if (m_num_device_statistics == 0) {
+    return;
+  }
+  const El::Int size = 4 * m_num_device_statistics;
+  El::Matrix<float, El::Device::CPU> host_stats;
+  El::Copy(El::LockedView(m_device_statistics, El::IR(0, size), El::ALL),
+           host_stats);
+  El::Synchronize(El::SyncInfoFromMatrix(m_device_statistics));
+  for (auto& op : m_pending_statistics) {
+    if (op.column >= 0) {
+      const float* stats = host_stats.LockedBuffer() + 4 * op.column;
+      op.sum = stats[0];
+      op.sqsum = stats[1];
+      op.min = stats[2];
+      op.max = -stats[3];
+      op.column = -1;
+    }
+  }
+  reset_statistics(m_device_statistics, 0, size);
+  m_num_device_statistics = 0;
+}
+
+#define PROTO(T)                                                               \
+  template void lbann_summary::local_statistics_gpu<T>(                        \
+    const El::AbstractMatrix<T>&,                                              \
+    lbann_summary::pending_statistics&)
+
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+#endif // LBANN_HAS_TBINF
+
+} // namespace lbann
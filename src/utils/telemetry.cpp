@@ -0,0 +1,169 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/utils/telemetry.hpp"
+
+#include <iomanip>
+#include <limits>
+#include <ostream>
+
+namespace lbann {
+
+namespace details {
+std::atomic<bool> telemetry_enabled{false};
+std::array<std::atomic<uint64_t>, num_telemetry_values> telemetry_slots = {};
+} // namespace details
+
+namespace {
+
+constexpr double ns = 1e-9;
+// Name, help, counter, summed over ranks, scale
+const std::array<telemetry_info, num_telemetry_values> infos = {{
+  {"training_steps_total",
+   "Training steps taken",
+   true,
+   false,
+   1.},
+  {"training_samples_total",
+   "Samples trained on",
+   true,
+   false,
+   1.},
+  {"step_seconds_total",
+   "Host time in training steps, slowest rank",
+   true,
+   false,
+   ns},
+  {"data_wait_seconds_total",
+   "Time waiting for the input pipeline, slowest rank",
+   true,
+   false,
+   ns},
+  {"input_samples_total",
+   "Samples fetched by the input pipeline",
+   true,
+   true,
+   1.},
+  {"input_bytes_total",
+   "Bytes fetched by the input pipeline",
+   true,
+   true,
+   1.},
+  {"comm_bytes_sent_total",
+   "Bytes sent by communication",
+   true,
+   true,
+   1.},
+  {"comm_wait_seconds_total",
+   "Time blocked in communication, slowest rank",
+   true,
+   false,
+   ns},
+  {"forward_prop_seconds_total",
+   "Host time in layer forward prop, slowest rank",
+   true,
+   false,
+   ns},
+  {"backward_prop_seconds_total",
+   "Host time in layer back prop, slowest rank",
+   true,
+   false,
+   ns},
+  {"gpu_memory_high_water_bytes",
+   "Highest GPU memory pool usage, largest rank",
+   false,
+   false,
+   1.},
+}};
+
+} // namespace
+
+telemetry_info const& get_telemetry_info(telemetry_value value) noexcept
+{
+  return infos[static_cast<size_t>(value)];
+}
+
+void set_telemetry_enabled(bool enable) noexcept
+{
+  details::telemetry_enabled.store(enable, std::memory_order_relaxed);
+}
+
+telemetry_snapshot read_telemetry() noexcept
+{
+  telemetry_snapshot values;
+  for (size_t i = 0; i < num_telemetry_values; ++i) {
+    values[i] =
+      (details::telemetry_slots[i].load(std::memory_order_relaxed) *
+       infos[i].scale);
+  }
+  return values;
+}
+
+void reset_telemetry() noexcept
+{
+  for (auto& slot : details::telemetry_slots) {
+    slot.store(0, std::memory_order_relaxed);
+  }
+}
+
+void write_telemetry_prometheus(std::ostream& os,
+                                telemetry_snapshot const& values,
+                                std::string const& prefix,
+                                std::string const& labels)
+{
+  const auto precision = os.precision(std::numeric_limits<double>::digits10);
+  for (size_t i = 0; i < num_telemetry_values; ++i) {
+    const auto& info = infos[i];
+    const std::string name = prefix + info.name;
+    os << "# HELP " << name << " " << info.help << "\n"
+       << "# TYPE " << name << " " << (info.counter ? "counter" : "gauge")
+       << "\n"
+       << name;
+    if (!labels.empty()) {
+      os << "{" << labels << "}";
+    }
+    os << " " << values[i] << "\n";
+  }
+  os.precision(precision);
+}
+
+void write_telemetry_json(std::ostream& os,
+                          telemetry_snapshot const& values,
+                          std::string const& fields)
+{
+  const auto precision = os.precision(std::numeric_limits<double>::digits10);
+  os << "{" << fields;
+  for (size_t i = 0; i < num_telemetry_values; ++i) {
+    if (i > 0 || !fields.empty()) {
+      os << ",";
+    }
+    os << "\"" << infos[i].name << "\":" << values[i];
+  }
+  os << "}\n";
+  os.precision(precision);
+}
+
+} // namespace lbann
@@ -69,6 +69,17 @@ void check_hwloc_api_version()
 
 namespace lbann {
 
+namespace {
+
+/** @brief Jobs each worker queue holds before jobs overflow */
+constexpr size_t job_queue_capacity = 1024;
+
+/** @brief Pool and index of the worker running on this thread */
+thread_local thread_pool const* current_pool = nullptr;
+thread_local thread_pool::size_type current_worker = 0;
+
+} // namespace
+
 thread_pool::thread_pool()
   : thread_joiner_{threads_}, all_work_done_{false}, m_threads_offset{0}
 {}
@@ -79,14 +90,25 @@ thread_pool::thread_pool(size_type max_threads) : thread_pool()
   this->launch_threads(num_threads);
 }
 
+void thread_pool::setup_queues_(size_type num_threads)
+{
+  m_queues.clear();
+  for (size_type i = 0; i < num_threads; ++i) {
+    m_queues.emplace_back(
+      std::make_unique<lock_free_queue<type_erased_function>>(
+        job_queue_capacity));
+  }
+}
+
 void thread_pool::launch_threads(size_type num_threads)
 {
   threads_.reserve(num_threads);
+  setup_queues_(num_threads);
 
   // Try to launch each worker thread
   try {
     for (size_type cnt = 0; cnt < num_threads; ++cnt) {
-      threads_.emplace_back(&thread_pool::do_thread_work_, this);
+      threads_.emplace_back(&thread_pool::do_thread_work_, this, cnt);
     }
   }
   catch (...) {
@@ -111,6 +133,7 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int PU_offset)
 
 #if defined(LBANN_TOPO_AWARE)
   threads_.reserve(num_threads);
+  setup_queues_(num_threads);
   m_work_group.reserve(num_threads);
   m_thread_id_to_local_id_map.reserve(num_threads);
 
@@ -121,6 +144,8 @@ void thread_pool::launch_pinned_threads(size_type num_threads, int PU_offset)
   if (err) {
     LBANN_ERROR("hwloc_topology_init failed");
   }
+  // The GPU or NIC that feeds the rank is found through its PCI device
+  enable_io_device_discovery(topo);
   /* build the topology created and configured above */
   err = hwloc_topology_load(topo);
   if (err) {
@@ -191,10 +216,12 @@ void thread_pool::reap_threads()
   if (this->get_num_threads() == 0) {
     return;
   }
+  // Workers finish the queued jobs before they exit
   all_work_done_ = true;
-  do {
-    global_work_queue_.wake_all(true);
-  } while (!global_work_queue_.empty());
+  {
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+    m_job_available.notify_all();
+  }
 
   for (auto& t : threads_)
     if (t.joinable())
@@ -203,9 +230,9 @@ void thread_pool::reap_threads()
   m_work_group.clear();
   m_thread_id_to_local_id_map.clear();
   threads_.clear();
+  m_queues.clear();
   /// Reset the flag so that new threads can be started
   all_work_done_ = false;
-  global_work_queue_.set_stop_threads(false);
   return;
 }
 
@@ -216,14 +243,80 @@ void thread_pool::relaunch_pinned_threads(size_type num_threads)
   return;
 }
 
-void thread_pool::do_thread_work_()
+void thread_pool::push_job_(type_erased_function job)
 {
-  while (not all_work_done_) {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
+  // Workers keep the jobs they submit; other threads spread theirs
+  bool queued = false;
+  const size_type num_queues = m_queues.size();
+  if (num_queues > 0) {
+    const size_type first =
+      (current_pool == this
+         ? current_worker
+         : m_next_queue.fetch_add(1, std::memory_order_relaxed) % num_queues);
+    for (size_type i = 0; i < num_queues && !queued; ++i) {
+      queued = m_queues[(first + i) % num_queues]->try_push(job);
     }
   }
+  if (!queued) {
+    std::lock_guard<std::mutex> lk(m_overflow_mutex);
+    m_overflow_queue.push_back(std::move(job));
+    ++m_overflow_size;
+  }
+
+  // A worker counts itself as sleeping before it checks for pending
+  // jobs, so either it sees this job or it is notified
+  ++m_num_pending_jobs;
+  if (m_num_sleeping > 0) {
+    std::lock_guard<std::mutex> lk(m_sleep_mutex);
+    m_job_available.notify_one();
+  }
+}
+
+std::optional<type_erased_function> thread_pool::try_pop_job_(size_type tid)
+{
+  const size_type num_queues = m_queues.size();
+  for (size_type i = 0; i < num_queues; ++i) {
+    auto job = m_queues[(tid + i) % num_queues]->try_pop();
+    if (job) {
+      --m_num_pending_jobs;
+      return job;
+    }
+  }
+  if (m_overflow_size > 0) {
+    std::lock_guard<std::mutex> lk(m_overflow_mutex);
+    if (!m_overflow_queue.empty()) {
+      std::optional<type_erased_function> job(
+        std::move(m_overflow_queue.front()));
+      m_overflow_queue.pop_front();
+      --m_overflow_size;
+      --m_num_pending_jobs;
+      return job;
+    }
+  }
+  return std::nullopt;
+}
+
+void thread_pool::do_thread_work_(size_type tid)
+{
+  current_pool = this;
+  current_worker = tid;
+  while (true) {
+    auto job = try_pop_job_(tid);
+    if (job) {
+      (*job)();
+      continue;
+    }
+    std::unique_lock<std::mutex> lk(m_sleep_mutex);
+    ++m_num_sleeping;
+    m_job_available.wait(lk, [&] {
+      return m_num_pending_jobs > 0 || all_work_done_;
+    });
+    --m_num_sleeping;
+    if (all_work_done_ && m_num_pending_jobs <= 0) {
+      break;
+    }
+  }
+  current_pool = nullptr;
 }
 
 #if defined(LBANN_TOPO_AWARE)
@@ -233,6 +326,9 @@ void thread_pool::do_thread_work_pinned_thread_(int tid,
 {
   // Set the CPU affinity for the thread
   auto error = hwloc_set_cpubind(topo, cpuset, 0);
+  // Prefer the NUMA node of those cores for the memory the thread
+  // allocates; this is only a preference, so failures are ignored
+  hwloc_set_membind(topo, cpuset, HWLOC_MEMBIND_BIND, HWLOC_MEMBIND_THREAD);
   // Free the hwloc_cpuset_t structure once the thread is pinned
   hwloc_bitmap_free(cpuset);
   // assert(!err);
@@ -250,17 +346,15 @@ void thread_pool::do_thread_work_pinned_thread_(int tid,
     std::thread::id this_id = std::this_thread::get_id();
     m_thread_id_to_local_id_map[this_id] = tid;
   }
-  while (not all_work_done_) {
-    auto task = global_work_queue_.wait_and_pop();
-    if (task) {
-      (*task)();
-    }
-  }
+  do_thread_work_(tid);
 }
 #endif // LBANN_TOPO_AWARE
 
 int thread_pool::get_local_thread_id()
 {
+  if (current_pool == this) {
+    return static_cast<int>(current_worker);
+  }
   std::thread::id this_id = std::this_thread::get_id();
   return m_thread_id_to_local_id_map[this_id];
 }
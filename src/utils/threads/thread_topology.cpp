@@ -24,7 +24,9 @@
 // permissions and limitations under the license.
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <lbann/utils/argument_parser.hpp>
 #include <lbann/utils/exception.hpp>
+#include <lbann/utils/options.hpp>
 #include <lbann/utils/threads/thread_topology.hpp>
 
 #if defined(LBANN_TOPO_AWARE)
@@ -40,8 +42,12 @@
 #ifdef LBANN_HAS_CUDA
 #include <hydrogen/device/gpu/CUDA.hpp>
 #endif // LBANN_HAS_CUDA
+#if defined(LBANN_TOPO_AWARE) && defined(LBANN_HAS_ROCM)
+#include <hip/hip_runtime.h>
+#endif
 
 #include <iostream>
+#include <string>
 
 namespace lbann {
 
@@ -98,24 +104,145 @@ void hwloc_print_topo()
   std::cout << err << std::endl;
   return;
 }
+namespace {
+
+/** @brief Cores of the closest non-I/O ancestor of an I/O device
+ *  @param name PCI bus id (e.g. "0000:81:00.0") or OS device name
+ *              (e.g. "mlx5_0")
+ *  @return nullptr if the device is not in the topology
+ */
+hwloc_cpuset_t get_io_device_cpuset(hwloc_topology_t topo,
+                                    std::string const& name)
+{
+  hwloc_obj_t device = hwloc_get_pcidev_by_busidstring(topo, name.c_str());
+  for (hwloc_obj_t os = hwloc_get_next_osdev(topo, nullptr);
+       device == nullptr && os != nullptr;
+       os = hwloc_get_next_osdev(topo, os)) {
+    if (os->name != nullptr && name == os->name) {
+      device = os;
+    }
+  }
+  if (device == nullptr) {
+    return nullptr;
+  }
+  hwloc_obj_t ancestor = hwloc_get_non_io_ancestor_obj(topo, device);
+  if (ancestor == nullptr || ancestor->cpuset == nullptr) {
+    return nullptr;
+  }
+  return hwloc_bitmap_dup(ancestor->cpuset);
+}
+
+} // namespace
+
+void enable_io_device_discovery(hwloc_topology_t topo)
+{
+#if HWLOC_API_VERSION >= 0x00020000
+  hwloc_topology_set_io_types_filter(topo, HWLOC_TYPE_FILTER_KEEP_IMPORTANT);
+#else
+  hwloc_topology_set_flags(topo, HWLOC_TOPOLOGY_FLAG_IO_DEVICES);
+#endif
+}
+
 // Used by thread_pool.hpp also -- NOT static.
 hwloc_cpuset_t get_local_cpuset_for_current_thread(hwloc_topology_t topo)
 {
-  hwloc_cpuset_t local_cpuset = hwloc_bitmap_alloc();
-#ifdef LBANN_HAS_CUDA
+  hwloc_cpuset_t local_cpuset = nullptr;
+
+  // A device named by the user, e.g. the NIC the rank's data comes in
+  // through
+  const auto device =
+    global_argument_parser().get<std::string>(LBANN_OPTION_IO_THREAD_DEVICE);
+  if (!device.empty()) {
+    local_cpuset = get_io_device_cpuset(topo, device);
+    if (local_cpuset == nullptr) {
+      LBANN_WARNING("I/O thread device ", device, " was not found");
+    }
+  }
+
   // Find CPUs close to the GPU being used
-  hwloc_cudart_get_device_cpuset(topo,
-                                 hydrogen::gpu::DefaultDevice(),
-                                 local_cpuset);
-#else
-  hwloc_const_cpuset_t allowed_cpuset = hwloc_topology_get_allowed_cpuset(topo);
-  hwloc_bitmap_free(local_cpuset);
-  local_cpuset = hwloc_bitmap_dup(allowed_cpuset);
-  //  hwloc_bitmap_free(allowed_cpuset);
+#ifdef LBANN_HAS_CUDA
+  if (local_cpuset == nullptr) {
+    local_cpuset = hwloc_bitmap_alloc();
+    if (hwloc_cudart_get_device_cpuset(topo,
+                                       hydrogen::gpu::DefaultDevice(),
+                                       local_cpuset) != 0) {
+      hwloc_bitmap_free(local_cpuset);
+      local_cpuset = nullptr;
+    }
+  }
+#elif defined(LBANN_HAS_ROCM)
+  if (local_cpuset == nullptr) {
+    int gpu = 0;
+    char bus_id[32];
+    if (hipGetDevice(&gpu) == hipSuccess &&
+        hipDeviceGetPCIBusId(bus_id, sizeof(bus_id), gpu) == hipSuccess) {
+      local_cpuset = get_io_device_cpuset(topo, bus_id);
+    }
+  }
 #endif // LBANN_HAS_CUDA
+
+  hwloc_const_cpuset_t allowed_cpuset = hwloc_topology_get_allowed_cpuset(topo);
+  if (local_cpuset != nullptr) {
+    hwloc_bitmap_and(local_cpuset, local_cpuset, allowed_cpuset);
+    if (hwloc_bitmap_iszero(local_cpuset)) {
+      hwloc_bitmap_free(local_cpuset);
+      local_cpuset = nullptr;
+    }
+  }
+  if (local_cpuset == nullptr) {
+    local_cpuset = hwloc_bitmap_dup(allowed_cpuset);
+  }
   return local_cpuset;
 }
 
+io_local_memory_scope::io_local_memory_scope()
+{
+  if (hwloc_topology_init(&m_topo) != 0) {
+    m_topo = nullptr;
+    return;
+  }
+  enable_io_device_discovery(m_topo);
+  if (hwloc_topology_load(m_topo) != 0) {
+    return;
+  }
+  m_saved_cpuset = hwloc_bitmap_alloc();
+  if (hwloc_get_membind(m_topo,
+                        m_saved_cpuset,
+                        &m_saved_policy,
+                        HWLOC_MEMBIND_THREAD) != 0) {
+    return;
+  }
+  // Without HWLOC_MEMBIND_STRICT, allocations fall back to other
+  // nodes when the I/O node is full
+  hwloc_cpuset_t local_cpuset = get_local_cpuset_for_current_thread(m_topo);
+  m_bound = (hwloc_set_membind(m_topo,
+                               local_cpuset,
+                               HWLOC_MEMBIND_BIND,
+                               HWLOC_MEMBIND_THREAD) == 0);
+  hwloc_bitmap_free(local_cpuset);
+}
+
+io_local_memory_scope::~io_local_memory_scope()
+{
+  if (m_bound) {
+    hwloc_set_membind(m_topo,
+                      m_saved_cpuset,
+                      m_saved_policy,
+                      HWLOC_MEMBIND_THREAD);
+  }
+  if (m_saved_cpuset != nullptr) {
+    hwloc_bitmap_free(m_saved_cpuset);
+  }
+  if (m_topo != nullptr) {
+    hwloc_topology_destroy(m_topo);
+  }
+}
+
+#else
+
+io_local_memory_scope::io_local_memory_scope() {}
+io_local_memory_scope::~io_local_memory_scope() {}
+
 #endif // LBANN_TOPO_AWARE
 
 } // namespace lbann
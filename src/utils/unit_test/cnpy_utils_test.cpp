@@ -0,0 +1,147 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/cnpy_utils.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+
+// A version 1.0 .npy image of a 3x2 little-endian float array
+std::string make_npy(const std::vector<float>& vals)
+{
+  std::string header =
+    "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 2), }";
+  // numpy pads the header with spaces so the data is 64-byte aligned
+  while ((10 + header.size() + 1) % 64 != 0) {
+    header += ' ';
+  }
+  header += '\n';
+  std::string npy("\x93NUMPY\x01\x00", 8);
+  npy += static_cast<char>(header.size() & 0xff);
+  npy += static_cast<char>(header.size() >> 8);
+  npy += header;
+  npy.append(reinterpret_cast<const char*>(vals.data()),
+             vals.size() * sizeof(float));
+  return npy;
+}
+
+void append_le(std::string& buf, uint32_t val, int n_bytes)
+{
+  for (int i = 0; i < n_bytes; ++i) {
+    buf += static_cast<char>((val >> (8 * i)) & 0xff);
+  }
+}
+
+// A zip local file header for a stored member
+std::string make_local_header(const std::string& name, uint32_t size)
+{
+  std::string hdr;
+  append_le(hdr, 0x04034b50, 4); // signature
+  append_le(hdr, 20, 2);         // version needed
+  append_le(hdr, 0, 2);          // flags
+  append_le(hdr, 0, 2);          // method: stored
+  append_le(hdr, 0, 4);          // modification time and date
+  append_le(hdr, 0, 4);          // crc-32 (not checked)
+  append_le(hdr, size, 4);       // compressed size
+  append_le(hdr, size, 4);       // uncompressed size
+  append_le(hdr, name.size(), 2);
+  append_le(hdr, 0, 2); // extra field length
+  return hdr + name;
+}
+
+std::string write_temp_file(const std::string& suffix,
+                            const std::string& contents)
+{
+  const std::string filename =
+    (std::filesystem::temp_directory_path() /
+     ("lbann_cnpy_utils_test_" + std::to_string(getpid()) + suffix))
+      .string();
+  std::ofstream ofs(filename, std::ios::binary);
+  ofs << contents;
+  return filename;
+}
+
+} // namespace
+
+TEST_CASE("Memory-mapped numpy arrays", "[seq][utilities][numpy]")
+{
+  const std::vector<float> vals = {0.f, 1.f, 2.f, 3.f, 4.f, 5.f};
+  const std::string npy = make_npy(vals);
+
+  SECTION(".npy file")
+  {
+    const std::string filename = write_temp_file(".npy", npy);
+    {
+      const auto ary = lbann::cnpy_utils::mmap_npy(filename);
+      REQUIRE(ary.is_mapped());
+      CHECK(ary.header.shape == std::vector<size_t>{3, 2});
+      CHECK(ary.header.word_size == sizeof(float));
+      CHECK_FALSE(ary.header.fortran_order);
+      CHECK(ary.header.num_vals == vals.size());
+      CHECK(std::vector<float>(ary.as<float>(), ary.as<float>() + 6) == vals);
+      CHECK_NOTHROW(ary.advise(2, 4, 0));
+    }
+    std::remove(filename.c_str());
+  }
+
+  SECTION(".npz file with stored members")
+  {
+    const std::string npz = make_local_header("data.npy", npy.size()) + npy +
+                            make_local_header("labels.npy", npy.size()) +
+                            npy;
+    const std::string filename = write_temp_file(".npz", npz);
+    {
+      const auto members = lbann::cnpy_utils::mmap_npz(filename);
+      REQUIRE(members.size() == 2);
+      for (const auto* key : {"data", "labels"}) {
+        const auto& ary = members.at(key);
+        CHECK(ary.header.shape == std::vector<size_t>{3, 2});
+        CHECK(std::vector<float>(ary.as<float>(), ary.as<float>() + 6) ==
+              vals);
+      }
+    }
+    std::remove(filename.c_str());
+  }
+
+  SECTION("Truncated file")
+  {
+    const std::string filename =
+      write_temp_file(".npy", npy.substr(0, npy.size() - 4));
+    CHECK_THROWS(lbann::cnpy_utils::mmap_npy(filename));
+    std::remove(filename.c_str());
+  }
+}
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/compression.hpp>
+
+#include <lbann/utils/exception.hpp>
+
+TEST_CASE("Testing zlib compression of buffers", "[compression][utilities]")
+{
+  using lbann::utils::compress_string;
+  using lbann::utils::decompress_string;
+
+  SECTION("Empty buffer")
+  {
+    CHECK(decompress_string(compress_string("")).empty());
+  }
+
+  SECTION("Round trip")
+  {
+    std::string data;
+    for (int i = 0; i < 100000; ++i) {
+      data += static_cast<char>((i * 7) % 13);
+    }
+    for (int level : {1, 6, 9}) {
+      auto const compressed = compress_string(data, level);
+      CHECK(compressed.size() < data.size());
+      CHECK(decompress_string(compressed) == data);
+    }
+  }
+
+  SECTION("Invalid inputs")
+  {
+    CHECK_THROWS_AS(compress_string("abc", 0), lbann::exception);
+    CHECK_THROWS_AS(decompress_string("abc"), lbann::exception);
+    auto compressed = compress_string("abcdefgh");
+    compressed.resize(compressed.size() - 2);
+    CHECK_THROWS_AS(decompress_string(compressed), lbann::exception);
+  }
+}
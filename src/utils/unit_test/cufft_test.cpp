@@ -260,3 +260,68 @@ static_assert(El::IsComputeType<El::Complex<double>, El::Device::CPU>::value,
               "Complex should be a valid compute type on CPU");
 static_assert(El::IsComputeType<El::Complex<double>, El::Device::GPU>::value,
               "Complex should be a valid compute type on GPU");
+
+TEMPLATE_TEST_CASE("Testing cuFFT wrapper (R2C)",
+                   "[.cufft][fft][gpu][cuda][utilities][!nonportable]",
+                   float,
+                   double)
+{
+  using RealT = TestType;
+  using ComplexT = El::Complex<RealT>;
+
+  auto const ndims = GENERATE(1, 2);
+  auto const use_ldim = GENERATE(false, true);
+  CAPTURE(ndims, use_ldim);
+
+  lbann::cufft::cuFFTWrapper<RealT> cufft;
+  auto input_dims = get_input_dims(ndims);
+  auto output_dims = lbann::fft::get_r2c_output_dims(input_dims);
+
+  auto const input_matrix_height = lbann::get_linear_size(input_dims);
+  auto const output_matrix_height = lbann::get_linear_size(output_dims);
+  auto const ldim_offset = (use_ldim ? get_ldim_offset() : 0);
+
+  // Alternate between two minibatch sizes to exercise the plan cache
+  for (int const num_samples :
+       {get_num_samples(), 2 * get_num_samples(), get_num_samples()}) {
+    CAPTURE(num_samples);
+    El::Matrix<RealT, El::Device::GPU> input(input_matrix_height,
+                                             num_samples,
+                                             input_matrix_height +
+                                               ldim_offset),
+      input_bwd(input_matrix_height, num_samples);
+    El::Matrix<ComplexT, El::Device::GPU> r2c_output(output_matrix_height,
+                                                     num_samples,
+                                                     output_matrix_height +
+                                                       ldim_offset);
+    El::Matrix<RealT, El::Device::CPU> input_cpu(input_matrix_height,
+                                                 num_samples),
+      input_bwd_cpu(input_matrix_height, num_samples);
+
+    REQUIRE_NOTHROW(cufft.setup_forward(input, r2c_output, input_dims));
+    REQUIRE_NOTHROW(cufft.setup_backward(r2c_output, input_bwd, input_dims));
+
+    El::MakeUniform(input_cpu, RealT(0.f), RealT(1.f));
+    El::Copy(input_cpu, input);
+
+    // Round trip on the GPU
+    REQUIRE_NOTHROW(cufft.compute_forward(input, r2c_output));
+    REQUIRE_NOTHROW(cufft.compute_backward(r2c_output, input_bwd));
+
+    El::Copy(input_bwd, input_bwd_cpu);
+    El::gpu::SynchronizeDevice();
+
+    // cuFFT transforms are *not* normalized.
+    auto const scale_factor = RealT(
+      lbann::get_linear_size(input_dims.size() - 1, input_dims.data() + 1));
+    for (El::Int col = 0; col < num_samples; ++col) {
+      for (El::Int row = 0; row < input_matrix_height; ++row) {
+        CAPTURE(row, col);
+        CHECK(input_bwd_cpu.CRef(row, col) ==
+              Approx(scale_factor * input_cpu.CRef(row, col))
+                .epsilon(std::numeric_limits<RealT>::epsilon() * 1000)
+                .margin(std::numeric_limits<RealT>::epsilon() * 100));
+      }
+    }
+  }
+}
@@ -0,0 +1,67 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/feistel_permutation.hpp>
+
+#include <vector>
+
+TEST_CASE("Feistel permutation", "[random][utilities]")
+{
+  SECTION("Is a bijection of [0, size)")
+  {
+    for (uint64_t size : {1, 2, 3, 7, 64, 1000, 4097}) {
+      lbann::feistel_permutation perm(size, 12345);
+      CHECK(perm.size() == size);
+      std::vector<bool> seen(size, false);
+      for (uint64_t i = 0; i < size; ++i) {
+        const uint64_t j = perm(i);
+        REQUIRE(j < size);
+        CHECK_FALSE(seen[j]);
+        seen[j] = true;
+      }
+    }
+  }
+
+  SECTION("Depends only on the size and key")
+  {
+    lbann::feistel_permutation a(1000, 7), b(1000, 7), c(1000, 8);
+    size_t num_different = 0;
+    for (uint64_t i = 0; i < 1000; ++i) {
+      CHECK(a(i) == b(i));
+      num_different += (a(i) != c(i));
+    }
+    CHECK(num_different > 900);
+  }
+
+  SECTION("Default-constructed permutation is empty")
+  {
+    lbann::feistel_permutation perm;
+    CHECK(perm.size() == 0);
+  }
+}
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+#include <lbann/utils/graph.hpp>
+
+#include <numeric>
+
+using namespace lbann;
+
+namespace {
+
+using Edges = std::map<El::Int, std::set<El::Int>>;
+
+bool respects_edges(const std::vector<El::Int>& order, const Edges& edges)
+{
+  std::map<El::Int, size_t> position;
+  for (size_t i = 0; i < order.size(); ++i) {
+    position[order[i]] = i;
+  }
+  for (const auto& [node, neighbors] : edges) {
+    for (const auto& neighbor : neighbors) {
+      if (position.at(node) >= position.at(neighbor)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+TEST_CASE("Topological sort", "[graph][utilities]")
+{
+  SECTION("Sorted graphs keep their order")
+  {
+    std::set<El::Int> nodes = {0, 1, 2, 3};
+    Edges edges = {{0, {1, 2}}, {1, {3}}, {2, {3}}};
+    std::vector<El::Int> expected = {0, 1, 2, 3};
+    CHECK(graph::topological_sort(nodes, edges) == expected);
+  }
+
+  SECTION("Reversed chain")
+  {
+    std::set<El::Int> nodes;
+    Edges edges;
+    for (El::Int i = 0; i < 1000; ++i) {
+      nodes.insert(i);
+      if (i > 0) {
+        edges[i].insert(i - 1);
+      }
+    }
+    std::vector<El::Int> expected(1000);
+    std::iota(expected.rbegin(), expected.rend(), 0);
+    CHECK(graph::topological_sort(nodes, edges) == expected);
+  }
+
+  SECTION("Nodes appended after their children")
+  {
+    // Node 4 is a split between 0 and its children 1 and 2, and node
+    // 5 is a second source feeding 3
+    std::set<El::Int> nodes = {0, 1, 2, 3, 4, 5};
+    Edges edges = {{0, {4}}, {4, {1, 2}}, {1, {3}}, {2, {3}}, {5, {3}}};
+    const auto order = graph::topological_sort(nodes, edges);
+    CHECK(order.size() == nodes.size());
+    CHECK(std::set<El::Int>(order.begin(), order.end()) == nodes);
+    CHECK(respects_edges(order, edges));
+  }
+
+  SECTION("Cyclic graphs are rejected")
+  {
+    std::set<El::Int> nodes = {0, 1, 2};
+    Edges edges = {{0, {1}}, {1, {2}}, {2, {1}}};
+    CHECK_THROWS(graph::topological_sort(nodes, edges));
+  }
+}
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/md5.hpp>
+
+#include <cstring>
+#include <string>
+
+namespace {
+std::string to_hex(const lbann::md5::digest& d)
+{
+  const char* digits = "0123456789abcdef";
+  std::string out;
+  for (int i = 0; i < 4; ++i) {
+    for (int k = 0; k < 4; ++k) {
+      const unsigned byte = (d.state[i] >> (8 * k)) & 0xff;
+      out += digits[byte >> 4];
+      out += digits[byte & 0xf];
+    }
+  }
+  return out;
+}
+std::string md5_hex(const char* msg)
+{
+  return to_hex(
+    lbann::md5::hash(reinterpret_cast<const unsigned char*>(msg),
+                     std::strlen(msg)));
+}
+} // namespace
+
+TEST_CASE("MD5 hash", "[hash][utilities]")
+{
+  SECTION("Matches RFC 1321 test suite")
+  {
+    CHECK(md5_hex("") == "d41d8cd98f00b204e9800998ecf8427e");
+    CHECK(md5_hex("a") == "0cc175b9c0f1b6a831c399e269772661");
+    CHECK(md5_hex("abc") == "900150983cd24fb0d6963f7d28e17f72");
+    CHECK(md5_hex("message digest") == "f96b697d7cb7938d525a2f31aaf161d0");
+    CHECK(md5_hex("abcdefghijklmnopqrstuvwxyz") ==
+          "c3fcd3d76192e4007dfb496cca67e13b");
+  }
+
+  SECTION("Upper word of a value's hash")
+  {
+    CHECK(lbann::md5::hash64(3.0f) == 9493309540049775532ull);
+    CHECK(lbann::md5::hash64(3.0f) != lbann::md5::hash64(3.0));
+  }
+}
@@ -32,6 +32,11 @@
 #include <h2/meta/core/IfThenElse.hpp>
 #include <lbann/utils/onnx_utils.hpp>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
 float get_value(onnx::TensorProto const& p, size_t index, lbann::TypeTag<float>)
 {
   return p.float_data(index);
@@ -206,3 +211,63 @@ TEMPLATE_LIST_TEST_CASE("Serializing a DistMatrix to ONNX",
     }
   }
 }
+
+TEMPLATE_LIST_TEST_CASE("Serializing a DistMatrix to ONNX external data",
+                        "[onnx][utils]",
+                        AllTypes)
+{
+  using namespace El;
+  using DType = typename TestType::type;
+  using TrueDType = typename DataTypeForSavedValues<DType>::type;
+  constexpr auto Device = TestType::device;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& grid = comm.get_trainer_grid();
+  std::string const filename = "onnx_external_data_test.bin";
+  int const writer = grid.Size() - 1;
+
+  onnx::TensorProto proto;
+  auto const height = 2 * grid.Height();
+  auto const width = 3 * grid.Width();
+  std::vector<size_t> height_dims = {static_cast<size_t>(height)};
+  std::vector<size_t> width_dims = {static_cast<size_t>(width)};
+  DistMatrix<DType, MC, MR, ELEMENT, Device> m(grid, 0);
+  Uniform(m, height, width);
+  DistMatrix<TrueDType, STAR, STAR, ELEMENT, Device::CPU> m_true(grid, 0);
+  El::Copy(m, m_true);
+  REQUIRE_NOTHROW(lbann::serialize_to_onnx_external(m,
+                                                    height_dims,
+                                                    width_dims,
+                                                    writer,
+                                                    filename,
+                                                    "data.bin",
+                                                    proto));
+
+  // The message only describes the tensor
+  CHECK(proto.data_location() == onnx::TensorProto::EXTERNAL);
+  REQUIRE(proto.dims_size() == 2);
+  CHECK(proto.dims(0) == height);
+  CHECK(proto.dims(1) == width);
+  CHECK(proto.float_data_size() == 0);
+  CHECK(proto.double_data_size() == 0);
+  REQUIRE(proto.external_data_size() == 3);
+  CHECK(proto.external_data(0).value() == "data.bin");
+  auto const length = static_cast<size_t>(height * width) * sizeof(TrueDType);
+  CHECK(proto.external_data(2).value() == std::to_string(length));
+
+  // The file holds the values in row-major order
+  if (grid.VCRank() == writer) {
+    std::vector<TrueDType> values(height * width);
+    std::ifstream is(filename, std::ios::binary);
+    is.read(reinterpret_cast<char*>(values.data()), length);
+    REQUIRE(is.good());
+    for (Int row = 0; row < height; ++row) {
+      for (Int col = 0; col < width; ++col) {
+        INFO("(row, col) == (" << row << ", " << col << ")");
+        CHECK(values[row * width + col] == m_true.GetLocal(row, col));
+      }
+    }
+    is.close();
+    std::remove(filename.c_str());
+  }
+}
@@ -30,6 +30,8 @@
 #include <lbann/utils/random.hpp>
 
 #include <limits>
+#include <thread>
+#include <vector>
 
 constexpr size_t num_tests = 1000;
 
@@ -114,3 +116,51 @@ TEST_CASE("Testing random_uniform", "[random][utilities]")
     }
   }
 }
+
+TEST_CASE("Testing I/O sample streams", "[random][utilities]")
+{
+  lbann::init_io_random(7, 2);
+  // Draws a block with tag 0, then 6 uniform values with tag 1
+  auto draw = [](size_t idx, size_t key, std::vector<float>& out) {
+    auto io_rng = lbann::set_io_generators_local_index(idx);
+    lbann::seed_io_generators_for_sample(key);
+    const auto x = lbann::draw_io_sample_block(0);
+    out.assign(10, 0.0f);
+    for (size_t k = 0; k < 4; ++k) {
+      out[k] = static_cast<float>(x.x[k] >> 8);
+    }
+    lbann::draw_io_sample_uniform(1, -2.0f, 3.0f, out.data() + 4, 6);
+  };
+
+  SECTION("streams do not depend on the thread")
+  {
+    std::vector<float> a, b;
+    draw(0, 5, a);
+    std::thread t([&b, &draw]() { draw(1, 5, b); });
+    t.join();
+    REQUIRE(a == b);
+  }
+  SECTION("streams depend on the sample")
+  {
+    std::vector<float> a, b;
+    draw(0, 5, a);
+    draw(0, 6, b);
+    REQUIRE(a != b);
+  }
+  SECTION("batches match single blocks")
+  {
+    std::vector<float> a;
+    draw(0, 5, a);
+    auto io_rng = lbann::set_io_generators_local_index(0);
+    lbann::seed_io_generators_for_sample(5);
+    for (size_t i = 0; i < 6; i += 4) {
+      const auto x = lbann::draw_io_sample_block(1);
+      for (size_t k = 0; k < 4 && i + k < 6; ++k) {
+        const float u = static_cast<float>(x.x[k] >> 8) / 16777216.f;
+        REQUIRE(a[4 + i + k] == -2.0f + 5.0f * u);
+        REQUIRE(a[4 + i + k] >= -2.0f);
+        REQUIRE(a[4 + i + k] < 3.0f);
+      }
+    }
+  }
+}
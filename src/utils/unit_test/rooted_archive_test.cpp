@@ -29,6 +29,7 @@
 
 // #include <lbann/utils/exception.hpp>
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
+#include <lbann/comm_impl.hpp>
 #include <lbann/utils/serialize.hpp>
 
 // Use-cases:
@@ -216,3 +217,58 @@ TEMPLATE_LIST_TEST_CASE("Rooted archive adaptor and matrices",
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+using ParallelReadDistMatrixTypes =
+  h2::meta::TL<El::DistMatrix<float, El::MC, El::MR>,
+               El::DistMatrix<float, El::STAR, El::STAR>,
+               El::DistMatrix<float, El::VC, El::STAR>,
+               El::DistMatrix<float, El::STAR, El::VR>,
+               El::DistMatrix<double, El::MR, El::MC>>;
+
+TEMPLATE_LIST_TEST_CASE("Rooted archive parallel reads",
+                        "[mpi][cereal][archive]",
+                        ParallelReadDistMatrixTypes)
+{
+  using DistMatType = TestType;
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  DistMatType mat(13, 17, g), mat_restore(g);
+  int x = 13, y = -1;
+  std::string s = "after", s_restore;
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+  SECTION("Binary archive")
+  {
+    El::MakeUniform(mat);
+    std::stringstream ss;
+    {
+      lbann::RootedBinaryOutputArchive oarchive(ss, g);
+      REQUIRE_NOTHROW(oarchive(x, mat, s));
+    }
+
+    // Every process reads its own copy of the archive
+    std::string buf = ss.str();
+    comm.trainer_broadcast(0, buf);
+    std::istringstream is(buf);
+    {
+      lbann::RootedBinaryInputArchive iarchive(is, g, 0, true);
+      REQUIRE_NOTHROW(iarchive(y, mat_restore, s_restore));
+    }
+
+    CHECK(x == y);
+    CHECK(s == s_restore);
+    REQUIRE(mat.Height() == mat_restore.Height());
+    REQUIRE(mat.Width() == mat_restore.Width());
+    REQUIRE(mat.LocalHeight() == mat_restore.LocalHeight());
+    REQUIRE(mat.LocalWidth() == mat_restore.LocalWidth());
+    for (El::Int col = 0; col < mat.LocalWidth(); ++col) {
+      for (El::Int row = 0; row < mat.LocalHeight(); ++row) {
+        INFO("(Row,Col) = (" << row << "," << col << ")");
+        CHECK(mat.GetLocal(row, col) == mat_restore.GetLocal(row, col));
+      }
+    }
+  }
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
+}
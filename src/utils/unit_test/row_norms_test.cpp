@@ -0,0 +1,71 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/row_norms.hpp>
+
+// Other includes
+#include <El.hpp>
+
+TEMPLATE_TEST_CASE("Batched row norms on CPU",
+                   "[row_norms][la][utilities]",
+                   float,
+                   double)
+{
+  using MatType = El::Matrix<TestType, El::Device::CPU>;
+
+  // Matrices of different shapes, one of them a non-contiguous view
+  MatType a(3, 4), b_full(6, 2), b, c(5, 0);
+  for (El::Int j = 0; j < a.Width(); ++j) {
+    for (El::Int i = 0; i < a.Height(); ++i) {
+      a.Set(i, j, TestType(i + 1) * (j % 2 == 0 ? 1 : -1));
+    }
+  }
+  El::Fill(b_full, TestType(2));
+  El::View(b, b_full, El::IR(1, 4), El::ALL);
+  MatType a_norms, b_norms, c_norms;
+
+  lbann::batched_row_sqsums<TestType>({&a, &b, &c},
+                                      {&a_norms, &b_norms, &c_norms});
+  REQUIRE(a_norms.Height() == 3);
+  REQUIRE(b_norms.Height() == 3);
+  REQUIRE(c_norms.Height() == 5);
+  for (El::Int i = 0; i < a_norms.Height(); ++i) {
+    CHECK(a_norms(i, 0) == TestType(4 * (i + 1) * (i + 1)));
+    CHECK(b_norms(i, 0) == TestType(8));
+  }
+  for (El::Int i = 0; i < c_norms.Height(); ++i) {
+    CHECK(c_norms(i, 0) == TestType(0));
+  }
+
+  lbann::batched_sqrt<TestType>({&a_norms, &b_norms});
+  for (El::Int i = 0; i < a_norms.Height(); ++i) {
+    CHECK(a_norms(i, 0) == TestType(2 * (i + 1)));
+  }
+  CHECK(b_norms(0, 0) == El::Sqrt(TestType(8)));
+}
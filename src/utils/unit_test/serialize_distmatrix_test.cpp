@@ -27,8 +27,14 @@
 #include <lbann/base.hpp>
 
 #include <h2/patterns/multimethods/SwitchDispatcher.hpp>
+#include <lbann/utils/serialization/dist_matrix_index.hpp>
 #include <lbann/utils/serialize.hpp>
 
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
 #include "MPITestHelpers.hpp"
 
 // Enumerate all DistMatrix types. Start by getting all the
@@ -187,3 +193,74 @@ TEMPLATE_LIST_TEST_CASE("DistMatrix serialization with smart pointers",
   }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 }
+
+#ifdef LBANN_HAS_CEREAL_BINARY_ARCHIVES
+TEMPLATE_LIST_TEST_CASE("DistMatrix resharding",
+                        "[serialize][utils][distmatrix][mpi]",
+                        DistMatrixTypesWithDevice<float, El::Device::CPU>)
+{
+  using DistMatType = TestType;
+  using FullMatType = El::DistMatrix<float, El::STAR, El::STAR>;
+
+  auto& comm = ::unit_test::utilities::current_world_comm();
+  lbann::utils::grid_manager mgr(comm.get_trainer_grid());
+  const int rank = comm.get_rank_in_trainer();
+  const int num_ranks = comm.get_procs_per_trainer();
+  auto archive_name = [](int r) {
+    return "distmatrix_reshard_test_" + std::to_string(r) + ".bin";
+  };
+  auto index_name = [&](int r) { return archive_name(r) + ".index"; };
+
+  // Every rank saves its local entries, as in a distributed checkpoint
+  DistMatType mat(13, 7, lbann::utils::get_current_grid());
+  El::MakeUniform(mat);
+  {
+    std::ofstream os(archive_name(rank), std::ios::binary);
+    lbann::utils::dist_matrix_recorder recorder(os);
+    {
+      cereal::BinaryOutputArchive oarchive(os);
+      oarchive(mat);
+    }
+    std::ofstream index_os(index_name(rank), std::ios::binary);
+    lbann::utils::write_dist_matrix_index(index_os,
+                                          recorder.records(),
+                                          num_ranks);
+  }
+  comm.trainer_barrier();
+
+  // Load the whole matrix on every rank, which needs the entries of
+  // all the ranks
+  std::vector<lbann::utils::dist_matrix_resharder::source> sources;
+  for (int r = 0; r < num_ranks; ++r) {
+    std::ifstream index_is(index_name(r), std::ios::binary);
+    El::Int num_procs;
+    sources.push_back(
+      {archive_name(r),
+       0,
+       lbann::utils::read_dist_matrix_index(index_is, num_procs)});
+    REQUIRE(num_procs == num_ranks);
+    REQUIRE(sources.back().records.size() == 1);
+  }
+  FullMatType mat_restore(lbann::utils::get_current_grid());
+  {
+    std::ifstream is(archive_name(rank), std::ios::binary);
+    lbann::utils::dist_matrix_resharder resharder(is, std::move(sources));
+    cereal::BinaryInputArchive iarchive(is);
+    REQUIRE_NOTHROW(iarchive(mat_restore));
+  }
+
+  FullMatType expected(mat);
+  REQUIRE(mat_restore.Height() == expected.Height());
+  REQUIRE(mat_restore.Width() == expected.Width());
+  for (El::Int col = 0; col < expected.LocalWidth(); ++col) {
+    for (El::Int row = 0; row < expected.LocalHeight(); ++row) {
+      INFO("(Row,Col) = (" << row << "," << col << ")");
+      CHECK(expected.GetLocal(row, col) == mat_restore.GetLocal(row, col));
+    }
+  }
+
+  comm.trainer_barrier();
+  std::remove(archive_name(rank).c_str());
+  std::remove(index_name(rank).c_str());
+}
+#endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
@@ -0,0 +1,99 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "lbann/utils/telemetry.hpp"
+
+#include <sstream>
+
+using namespace lbann;
+
+TEST_CASE("Telemetry counters", "[utils][telemetry]")
+{
+  reset_telemetry();
+
+  SECTION("Updates are dropped while telemetry is not read")
+  {
+    set_telemetry_enabled(false);
+    telemetry_add(telemetry_value::input_bytes, 10);
+    telemetry_update_max(telemetry_value::gpu_memory_high_water_bytes, 10);
+    const auto values = read_telemetry();
+    for (const auto& v : values) {
+      CHECK(v == 0.);
+    }
+  }
+
+  SECTION("Counters, times and gauges")
+  {
+    set_telemetry_enabled(true);
+    telemetry_add(telemetry_value::input_bytes, 10);
+    telemetry_add(telemetry_value::input_bytes, 5);
+    telemetry_add_seconds(telemetry_value::step_seconds, 0.25);
+    telemetry_update_max(telemetry_value::gpu_memory_high_water_bytes, 7);
+    telemetry_update_max(telemetry_value::gpu_memory_high_water_bytes, 3);
+    const auto values = read_telemetry();
+    auto value = [&values](telemetry_value v) {
+      return values[static_cast<size_t>(v)];
+    };
+    CHECK(value(telemetry_value::input_bytes) == 15.);
+    CHECK(value(telemetry_value::step_seconds) == Approx(0.25));
+    CHECK(value(telemetry_value::gpu_memory_high_water_bytes) == 7.);
+    CHECK(value(telemetry_value::training_steps) == 0.);
+  }
+
+  set_telemetry_enabled(false);
+  reset_telemetry();
+}
+
+TEST_CASE("Telemetry export formats", "[utils][telemetry]")
+{
+  telemetry_snapshot values = {};
+  values[static_cast<size_t>(telemetry_value::training_steps)] = 4.;
+
+  SECTION("Prometheus text")
+  {
+    std::ostringstream ss;
+    write_telemetry_prometheus(ss, values, "lbann_", "trainer=\"0\"");
+    const auto text = ss.str();
+    CHECK(text.find("# TYPE lbann_training_steps_total counter\n") !=
+          std::string::npos);
+    CHECK(text.find("lbann_training_steps_total{trainer=\"0\"} 4\n") !=
+          std::string::npos);
+    CHECK(text.find("# TYPE lbann_gpu_memory_high_water_bytes gauge\n") !=
+          std::string::npos);
+  }
+
+  SECTION("JSON lines")
+  {
+    std::ostringstream ss;
+    write_telemetry_json(ss, values, "\"step\":4");
+    const auto line = ss.str();
+    CHECK(line.rfind("{\"step\":4,\"training_steps_total\":4,", 0) == 0);
+    CHECK(line.back() == '\n');
+    CHECK(line.find('\n') == line.size() - 1);
+  }
+}
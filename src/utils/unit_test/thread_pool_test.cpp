@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+// MUST include this
+#include "Catch2BasicSupport.hpp"
+
+// File being tested
+#include <lbann/utils/threads/lock_free_queue.hpp>
+#include <lbann/utils/threads/thread_pool.hpp>
+#include <lbann/utils/threads/type_erased_function.hpp>
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+TEST_CASE("Type-erased function", "[threads][utilities]")
+{
+  SECTION("Holds move-only functions")
+  {
+    auto value = std::make_unique<int>(3);
+    int result = 0;
+    lbann::type_erased_function f(
+      [v = std::move(value), &result] { result = *v; });
+    lbann::type_erased_function g(std::move(f));
+    g();
+    CHECK(result == 3);
+  }
+
+  SECTION("Holds functions larger than its buffer")
+  {
+    struct large_function
+    {
+      char padding[2 * lbann::type_erased_function::buffer_size];
+      int* count;
+      void operator()() { ++*count; }
+    };
+    int count = 0;
+    lbann::type_erased_function f(large_function{{}, &count});
+    lbann::type_erased_function g(std::move(f));
+    g();
+    f = std::move(g);
+    f();
+    CHECK(count == 2);
+  }
+}
+
+TEST_CASE("Lock-free queue", "[threads][utilities]")
+{
+  lbann::lock_free_queue<int> q(3);
+  int values[] = {1, 2, 3, 4, 5};
+  // Capacity is rounded up to 4
+  for (int i = 0; i < 4; ++i) {
+    CHECK(q.try_push(values[i]));
+  }
+  CHECK_FALSE(q.try_push(values[4]));
+  for (int i = 0; i < 4; ++i) {
+    auto v = q.try_pop();
+    REQUIRE(v);
+    CHECK(*v == values[i]);
+  }
+  CHECK_FALSE(q.try_pop());
+  CHECK(q.empty());
+}
+
+TEST_CASE("Thread pool", "[threads][utilities]")
+{
+  lbann::thread_pool pool(4);
+  REQUIRE(pool.get_num_threads() == 4);
+
+  SECTION("Runs every job")
+  {
+    // More jobs than the worker queues hold
+    std::atomic<long> sum{0};
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 10000; ++i) {
+      futures.emplace_back(pool.submit_job([&sum, i] { sum += i; }));
+    }
+    for (auto& f : futures) {
+      f.get();
+    }
+    CHECK(sum == 10000L * 9999L / 2);
+  }
+
+  SECTION("Runs jobs submitted by jobs")
+  {
+    auto f = pool.submit_job([&pool] {
+      return pool.submit_job([] { return 7; }).get();
+    });
+    CHECK(f.get() == 7);
+  }
+
+  SECTION("Finishes work groups")
+  {
+    std::atomic<int> count{0};
+    std::atomic<int> bad_ids{0};
+    for (int i = 0; i < 100; ++i) {
+      pool.submit_job_to_work_group([&] {
+        const int id = pool.get_local_thread_id();
+        bad_ids += (id < 0 || id >= 4);
+        ++count;
+        return true;
+      });
+    }
+    CHECK(pool.finish_work_group());
+    CHECK(count == 100);
+    CHECK(bad_ids == 0);
+  }
+
+  SECTION("Can be relaunched")
+  {
+    pool.relaunch_pinned_threads(2);
+    CHECK(pool.get_num_threads() == 2);
+    CHECK(pool.submit_job([] { return 1; }).get() == 1);
+  }
+}
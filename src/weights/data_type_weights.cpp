@@ -34,7 +34,10 @@
 #include "lbann/utils/exception.hpp"
 #include "lbann/utils/onnx_utils.hpp"
 #include "lbann/utils/options.hpp"
+#include "lbann/utils/row_norms.hpp"
 #include "lbann/weights/data_type_weights_impl.hpp"
+#include "lbann/weights/flat_weights_state.hpp"
+#include "lbann/weights/weights_snapshot.hpp"
 
 #include "lbann/proto/layers.pb.h"
 #include "lbann/proto/weights.pb.h"
@@ -73,6 +76,68 @@ std::string get_dims_string(const std::vector<size_t>& matrix_height_dims,
 
 namespace lbann {
 
+namespace {
+
+/** Compute the row norms of weights with values on a device.
+ *  Allocates the norms if needed. */
+template <typename TensorDataType, El::Device Device>
+void compute_local_row_norms(
+  std::vector<const El::AbstractDistMatrix<TensorDataType>*> const& values,
+  std::vector<std::unique_ptr<El::AbstractMatrix<TensorDataType>>*> const&
+    norms)
+{
+  using MatType = El::Matrix<TensorDataType, Device>;
+  std::vector<const MatType*> local_values;
+  std::vector<MatType*> local_norms;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto& local = static_cast<const MatType&>(values[i]->LockedMatrix());
+    auto& ptr = *norms[i];
+    if (ptr == nullptr || ptr->GetDevice() != Device) {
+      ptr = std::make_unique<MatType>();
+      El::SetSyncInfo(static_cast<MatType&>(*ptr),
+                      El::SyncInfoFromMatrix(local));
+    }
+    local_values.push_back(&local);
+    local_norms.push_back(static_cast<MatType*>(ptr.get()));
+  }
+  if (local_values.empty()) {
+    return;
+  }
+  batched_row_sqsums(local_values, local_norms);
+  for (size_t i = 0; i < values.size(); ++i) {
+    if (values[i]->RowStride() > 1) {
+      El::AllReduce(*local_norms[i], values[i]->RowComm(), El::mpi::SUM);
+    }
+  }
+  batched_sqrt(local_norms);
+}
+
+#ifdef LBANN_HAS_HALF
+template <>
+void compute_local_row_norms<cpu_fp16, El::Device::GPU>(
+  std::vector<const El::AbstractDistMatrix<cpu_fp16>*> const& values,
+  std::vector<std::unique_ptr<El::AbstractMatrix<cpu_fp16>>*> const&)
+{
+  if (!values.empty()) {
+    LBANN_ERROR("cpu_fp16 weights cannot have values on GPU");
+  }
+}
+#endif // LBANN_HAS_HALF
+
+#ifdef LBANN_HAS_GPU_FP16
+template <>
+void compute_local_row_norms<fp16, El::Device::CPU>(
+  std::vector<const El::AbstractDistMatrix<fp16>*> const& values,
+  std::vector<std::unique_ptr<El::AbstractMatrix<fp16>>*> const&)
+{
+  if (!values.empty()) {
+    LBANN_ERROR("fp16 weights cannot have values on CPU");
+  }
+}
+#endif // LBANN_HAS_GPU_FP16
+
+} // namespace
+
 template <typename TensorDataType>
 data_type_weights<TensorDataType>::data_type_weights(lbann_comm& comm)
   : BaseType(comm)
@@ -107,6 +172,8 @@ auto data_type_weights<TensorDataType>::operator=(const WeightsType& other)
   if (m_optimizer != nullptr) {
     m_optimizer->set_weights(this);
   }
+  m_row_norms.reset();
+  m_row_norms_version = 0;
 
   return *this;
 }
@@ -238,8 +305,18 @@ void data_type_weights<TensorDataType>::do_setup_()
     return;
   }
 
-  // Construct matrix for weights values
+  // Construct matrix for weights values. Replicated weights that are
+  // optimized may be stored as row shards, one per process.
   auto matrix_dist = this->get_matrix_distribution();
+  const bool shard =
+    (global_argument_parser().get<bool>(LBANN_OPTION_SHARD_WEIGHTS) &&
+     m_optimizer != nullptr && !this->is_frozen() &&
+     matrix_dist.colDist == El::STAR && matrix_dist.rowDist == El::STAR &&
+     matrix_dist.grid->Size() > 1);
+  this->set_sharded(shard);
+  if (shard) {
+    matrix_dist.colDist = El::VC;
+  }
   m_values.reset(AbsDistMatrixType::Instantiate(
     *matrix_dist.grid,
     matrix_dist.root,
@@ -259,6 +336,7 @@ void data_type_weights<TensorDataType>::do_setup_()
     }
   }
 #endif // LBANN_HAS_GPU
+  this->mark_values_modified();
   m_values->AlignWith(matrix_dist);
   m_values->Resize(this->get_matrix_height(), this->get_matrix_width());
 
@@ -283,6 +361,7 @@ void data_type_weights<TensorDataType>::do_setup_()
 template <typename TensorDataType>
 auto data_type_weights<TensorDataType>::get_values() -> AbsDistMatrixType&
 {
+  this->mark_values_modified();
   return const_cast<AbsDistMatrixType&>(
     static_cast<const data_type_weights&>(*this).get_values());
 }
@@ -435,20 +514,89 @@ void data_type_weights<TensorDataType>::reconcile_values(Al::request& req)
   }
 }
 
+// -----------------------------------------------
+// Row norms
+// -----------------------------------------------
+
+template <typename TensorDataType>
+auto data_type_weights<TensorDataType>::get_row_norms() const
+  -> const El::AbstractMatrix<TensorDataType>&
+{
+  if (m_row_norms_version != this->get_values_version()) {
+    compute_row_norms_({this});
+  }
+  return *m_row_norms;
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::update_row_norms(
+  std::vector<weights*> const& group)
+{
+  // Weights with other data types are computed separately
+  std::vector<weights*> others;
+  std::vector<const data_type_weights*> stale;
+  for (auto* w : group) {
+    const auto* dtw = dynamic_cast<const data_type_weights*>(w);
+    if (dtw == nullptr) {
+      others.push_back(w);
+    }
+    else if (dtw->m_row_norms_version != dtw->get_values_version()) {
+      stale.push_back(dtw);
+    }
+  }
+  if (!others.empty()) {
+    others.front()->update_row_norms(others);
+  }
+  compute_row_norms_(stale);
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::compute_row_norms_(
+  std::vector<const data_type_weights*> const& group)
+{
+  using AbsMatType = El::AbstractMatrix<TensorDataType>;
+  std::vector<const AbsDistMatrixType*> cpu_values, gpu_values;
+  std::vector<std::unique_ptr<AbsMatType>*> cpu_norms, gpu_norms;
+  for (const auto* w : group) {
+    const auto& values = w->get_values();
+    const bool on_cpu = (values.GetLocalDevice() == El::Device::CPU);
+    (on_cpu ? cpu_values : gpu_values).push_back(&values);
+    (on_cpu ? cpu_norms : gpu_norms).push_back(&w->m_row_norms);
+  }
+  compute_local_row_norms<TensorDataType, El::Device::CPU>(cpu_values,
+                                                           cpu_norms);
+#ifdef LBANN_HAS_GPU
+  compute_local_row_norms<TensorDataType, El::Device::GPU>(gpu_values,
+                                                           gpu_norms);
+#endif // LBANN_HAS_GPU
+  for (const auto* w : group) {
+    w->m_row_norms_version = w->get_values_version();
+  }
+}
+
 template <typename TensorDataType>
 void data_type_weights<TensorDataType>::write_proto(
   lbann_data::Weights& proto) const
 {
   proto.Clear();
   proto.set_name(this->get_name());
-  if (this->has_optimizer() == false)
+  if (this->has_optimizer() == false) {
     proto.mutable_optimizer()->mutable_no_optimizer();
-  else
-    this->get_optimizer()->write_proto(*proto.mutable_optimizer());
+  }
+  else {
+    const auto& opt = *this->get_optimizer();
+    auto& opt_msg = *proto.mutable_optimizer();
+    opt.write_proto(opt_msg);
+    opt_msg.set_clip_gradient_norm(opt.get_clip_gradient_norm());
+    opt_msg.set_l2_regularization(opt.get_l2_regularization());
+    opt_msg.set_decoupled_weight_decay(opt.get_decoupled_weight_decay());
+    opt_msg.set_stochastic_rounding(opt.get_stochastic_rounding());
+  }
 
   this->get_initializer()->write_proto(*proto.mutable_initializer());
 
   proto.set_datatype(proto::TypeToProtoDataType<TensorDataType>::value);
+  proto.set_offload_optimizer(this->get_offload_optimizer());
 }
 
 #ifdef LBANN_HAS_ONNX
@@ -467,6 +615,26 @@ void data_type_weights<T>::fill_onnx_node(onnx::GraphProto& graph) const
   initializer->set_name(this->get_name());
   initializer->set_doc_string(this->get_name() + " tensor values");
 }
+
+template <typename T>
+void data_type_weights<T>::fill_onnx_node(onnx::GraphProto& graph,
+                                          int writer,
+                                          std::string const& filename,
+                                          std::string const& location) const
+{
+  auto* initializer = graph.add_initializer();
+  auto const& values = this->get_values();
+  serialize_to_onnx_external(values,
+                             this->get_matrix_height_dims(),
+                             this->get_matrix_width_dims(),
+                             writer % values.Grid().Size(),
+                             filename,
+                             location,
+                             *initializer);
+
+  initializer->set_name(this->get_name());
+  initializer->set_doc_string(this->get_name() + " tensor values");
+}
 #endif // LBANN_HAS_ONNX
 
 template <typename TensorDataType>
@@ -506,6 +674,7 @@ bool data_type_weights<TensorDataType>::load_from_save(
       return false;
     }
     El::Read(*m_values, full_path, el_mode, true);
+    this->mark_values_modified();
   }
   return true;
 }
@@ -525,6 +694,68 @@ void data_type_weights<TensorDataType>::do_move_values_(
   data_type_weights& other)
 {
   m_values = std::move(other.m_values);
+  this->mark_values_modified();
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::add_to_flat_state(
+  flat_weights_state& state)
+{
+  // Sharded values are redistributed by their optimizer
+  if (m_values == nullptr || this->is_sharded()) {
+    return;
+  }
+  state.add(*m_values);
+  if (m_optimizer != nullptr) {
+    for (auto* tensor : m_optimizer->get_state_tensors()) {
+      if (tensor != nullptr) {
+        state.add(*tensor);
+      }
+    }
+  }
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::add_to_snapshot(
+  weights_snapshot& snapshot)
+{
+  if (m_values == nullptr) {
+    LBANN_ERROR("attempted to snapshot weights \"",
+                this->get_name(),
+                "\" before they are set up");
+  }
+  snapshot.add(*m_values);
+  if (snapshot.has_optimizer_state() && m_optimizer != nullptr) {
+    for (auto* tensor : m_optimizer->get_state_tensors()) {
+      if (tensor != nullptr) {
+        snapshot.add(*tensor);
+      }
+    }
+  }
+  if (snapshot.is_restoring()) {
+    this->mark_values_modified();
+  }
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::save_values(std::ostream& os) const
+{
+  RootedBinaryOutputArchive ar(os, this->get_comm().get_trainer_grid());
+  ar(*m_values);
+}
+
+template <typename TensorDataType>
+void data_type_weights<TensorDataType>::load_values(std::istream& is,
+                                                    bool parallel)
+{
+  {
+    RootedBinaryInputArchive ar(is,
+                                this->get_comm().get_trainer_grid(),
+                                /*root=*/0,
+                                parallel);
+    ar(*m_values);
+  }
+  this->mark_values_modified();
 }
 
 template <typename TensorDataType>
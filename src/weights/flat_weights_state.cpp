@@ -0,0 +1,460 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/weights/flat_weights_state.hpp"
+#include "lbann/comm_impl.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/utils/hash.hpp"
+#include "lbann/utils/typename.hpp"
+#include "lbann/weights/weights.hpp"
+
+#include <algorithm>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+namespace lbann {
+
+class flat_weights_state::buffer_base
+{
+public:
+  virtual ~buffer_base() = default;
+  /** @brief Move the added tensors into the buffer. */
+  virtual void pack() = 0;
+  virtual void start_check() = 0;
+  /** @brief Whether every tensor of the buffer was checked and is in
+   *         it.
+   */
+  virtual bool finish_check() const = 0;
+  virtual size_t layout_hash() const = 0;
+  virtual size_t local_bytes() const = 0;
+  virtual void sendrecv(lbann_comm& comm,
+                        El::Int partner_rank_in_world,
+                        bool half_precision) = 0;
+  /** @brief Post the messages of a non-blocking exchange.
+   *  @details @c source is a buffer of the same type and layout.
+   */
+  virtual void start_sendrecv(buffer_base const& source,
+                              lbann_comm& comm,
+                              El::Int partner_rank_in_world,
+                              int tag) = 0;
+  virtual void finish_sendrecv() = 0;
+  /** @brief Copy a buffer of the same type and layout. */
+  virtual void copy_from(buffer_base const& source) = 0;
+};
+
+namespace {
+
+template <typename TensorDataType>
+std::unique_ptr<El::AbstractMatrix<TensorDataType>>
+make_local_matrix(El::Device device)
+{
+  switch (device) {
+  case El::Device::CPU:
+    return std::make_unique<El::Matrix<TensorDataType, El::Device::CPU>>();
+#ifdef LBANN_HAS_GPU
+  case El::Device::GPU:
+    return std::make_unique<El::Matrix<TensorDataType, El::Device::GPU>>();
+#endif // LBANN_HAS_GPU
+  default:
+    LBANN_ERROR("invalid device");
+  }
+  return nullptr;
+}
+
+template <typename TensorDataType>
+size_t local_size(El::AbstractDistMatrix<TensorDataType> const& tensor)
+{
+  return tensor.LocalHeight() * tensor.LocalWidth();
+}
+
+/** @brief Flat buffer of the tensors with a data type and device */
+template <typename TensorDataType>
+class flat_buffer final : public flat_weights_state::buffer_base
+{
+public:
+  using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+
+  using HostMatType = El::Matrix<TensorDataType, El::Device::CPU>;
+
+  explicit flat_buffer(El::Device device) : m_device{device} {}
+  ~flat_buffer()
+  {
+    // The staging buffers must outlive the messages
+    if (m_pending_sendrecv) {
+      El::mpi::Wait(m_recv_request);
+      El::mpi::Wait(m_send_request);
+    }
+  }
+
+  El::Device get_device() const noexcept { return m_device; }
+
+  void add(AbsDistMatType& tensor)
+  {
+    m_pending.push_back(&tensor);
+    m_sizes.push_back(local_size(tensor));
+  }
+
+  /** @brief Check that a tensor is the next view of the buffer. */
+  void check(AbsDistMatType const& tensor)
+  {
+    const size_t i = m_num_checked++;
+    m_check_ok = (m_check_ok && i < m_offsets.size() &&
+                  local_size(tensor) == m_sizes[i] &&
+                  (m_sizes[i] == 0 || tensor.LockedBuffer() ==
+                                        m_data->LockedBuffer() + m_offsets[i]));
+  }
+
+  void pack() override
+  {
+    size_t total = 0;
+    m_offsets.clear();
+    for (const auto& size : m_sizes) {
+      m_offsets.push_back(total);
+      total += size;
+    }
+    m_data = make_local_matrix<TensorDataType>(m_device);
+    m_data->Resize(total, 1);
+
+    // The old storage is freed once every copy is done
+    std::vector<std::unique_ptr<AbsDistMatType>> old;
+    old.reserve(m_pending.size());
+    for (size_t i = 0; i < m_pending.size(); ++i) {
+      auto& tensor = *m_pending[i];
+      old.emplace_back(tensor.Copy());
+      tensor.Attach(tensor.Height(),
+                    tensor.Width(),
+                    tensor.Grid(),
+                    tensor.ColAlign(),
+                    tensor.RowAlign(),
+                    m_data->Buffer() + m_offsets[i],
+                    std::max(old.back()->LocalHeight(), El::Int(1)),
+                    tensor.Root());
+      El::Copy(old.back()->LockedMatrix(), tensor.Matrix());
+    }
+#ifdef LBANN_HAS_GPU
+    if (m_device == El::Device::GPU) {
+      hydrogen::gpu::SynchronizeDevice();
+    }
+#endif // LBANN_HAS_GPU
+    m_pending.clear();
+  }
+
+  void start_check() override
+  {
+    m_num_checked = 0;
+    m_check_ok = true;
+  }
+
+  bool finish_check() const override
+  {
+    return m_check_ok && m_num_checked == m_offsets.size();
+  }
+
+  size_t layout_hash() const override
+  {
+    size_t hash = std::hash<std::string>()(TypeName<TensorDataType>());
+    hash = hash_combine(hash, static_cast<int>(m_device));
+    for (const auto& size : m_sizes) {
+      hash = hash_combine(hash, size);
+    }
+    return hash;
+  }
+
+  size_t local_bytes() const override
+  {
+    return (m_data ? m_data->Height() : 0) * sizeof(TensorDataType);
+  }
+
+  void sendrecv(lbann_comm& comm,
+                El::Int partner_rank_in_world,
+                bool half_precision) override
+  {
+    if (m_data == nullptr || m_data->Height() == 0) {
+      return;
+    }
+    // fp16 buffers are sent as they are
+#ifdef LBANN_HAS_HALF
+    if (half_precision) {
+      if constexpr (std::is_floating_point_v<TensorDataType>) {
+        // Round on the host, where fp16 is always available
+        HostMatType values;
+        El::Matrix<cpu_fp16, El::Device::CPU> send, recv;
+        El::Copy(*m_data, values);
+        El::Copy(values, send);
+        recv.Resize(send.Height(), 1);
+        El::SendRecv(send,
+                     recv,
+                     comm.get_world_comm(),
+                     partner_rank_in_world,
+                     partner_rank_in_world);
+        El::Copy(recv, values);
+        El::Copy(values, *m_data);
+#ifdef LBANN_HAS_GPU
+        if (m_device == El::Device::GPU) {
+          hydrogen::gpu::SynchronizeDevice();
+        }
+#endif // LBANN_HAS_GPU
+        return;
+      }
+    }
+#else
+    if (half_precision) {
+      LBANN_ERROR("half-precision exchange requires fp16 support");
+    }
+#endif // LBANN_HAS_HALF
+    auto send = make_local_matrix<TensorDataType>(m_device);
+    El::Copy(*m_data, *send);
+    El::SendRecv(*send,
+                 *m_data,
+                 comm.get_world_comm(),
+                 partner_rank_in_world,
+                 partner_rank_in_world);
+  }
+
+  void start_sendrecv(buffer_base const& source,
+                      lbann_comm& comm,
+                      El::Int partner_rank_in_world,
+                      int tag) override
+  {
+    if (m_data == nullptr || m_data->Height() == 0) {
+      return;
+    }
+    const auto& source_data = *static_cast<flat_buffer const&>(source).m_data;
+    El::Copy(source_data, m_send);
+    m_recv.Resize(m_data->Height(), 1);
+#ifdef LBANN_HAS_GPU
+    if (m_device == El::Device::GPU) {
+      hydrogen::gpu::SynchronizeDevice();
+    }
+#endif // LBANN_HAS_GPU
+    const int count = static_cast<int>(m_data->Height());
+    const auto& world = comm.get_world_comm();
+    comm.nb_tagged_recv(m_recv.Buffer(),
+                        count,
+                        partner_rank_in_world,
+                        tag,
+                        m_recv_request,
+                        world);
+    comm.nb_tagged_send(m_send.LockedBuffer(),
+                        count,
+                        partner_rank_in_world,
+                        tag,
+                        m_send_request,
+                        world);
+    m_pending_sendrecv = true;
+  }
+
+  void copy_from(buffer_base const& source) override
+  {
+    if (m_data == nullptr || m_data->Height() == 0) {
+      return;
+    }
+    El::Copy(*static_cast<flat_buffer const&>(source).m_data, *m_data);
+#ifdef LBANN_HAS_GPU
+    if (m_device == El::Device::GPU) {
+      hydrogen::gpu::SynchronizeDevice();
+    }
+#endif // LBANN_HAS_GPU
+  }
+
+  void finish_sendrecv() override
+  {
+    if (!m_pending_sendrecv) {
+      return;
+    }
+    El::mpi::Wait(m_recv_request);
+    El::mpi::Wait(m_send_request);
+    m_pending_sendrecv = false;
+    El::Copy(m_recv, *m_data);
+#ifdef LBANN_HAS_GPU
+    if (m_device == El::Device::GPU) {
+      hydrogen::gpu::SynchronizeDevice();
+    }
+#endif // LBANN_HAS_GPU
+  }
+
+private:
+  El::Device m_device;
+  std::unique_ptr<El::AbstractMatrix<TensorDataType>> m_data;
+  /** @brief Snapshot sent by a non-blocking exchange. */
+  HostMatType m_send;
+  /** @brief Staging buffer of a non-blocking exchange. */
+  HostMatType m_recv;
+  El::mpi::Request<TensorDataType> m_send_request;
+  El::mpi::Request<TensorDataType> m_recv_request;
+  bool m_pending_sendrecv = false;
+  /** @brief Tensors waiting to be packed. */
+  std::vector<AbsDistMatType*> m_pending;
+  /** @brief Local size of each tensor. */
+  std::vector<size_t> m_sizes;
+  /** @brief Position of each tensor in the buffer. */
+  std::vector<size_t> m_offsets;
+  size_t m_num_checked = 0;
+  bool m_check_ok = true;
+};
+
+} // namespace
+
+flat_weights_state::flat_weights_state(std::vector<weights*> weights)
+  : m_weights{std::move(weights)}
+{
+  for (auto* w : m_weights) {
+    w->add_to_flat_state(*this);
+  }
+  for (auto& buffer : m_buffers) {
+    buffer->pack();
+  }
+}
+
+flat_weights_state::~flat_weights_state() = default;
+
+template <typename TensorDataType>
+void flat_weights_state::add(El::AbstractDistMatrix<TensorDataType>& tensor)
+{
+  if (tensor.Wrap() != El::ELEMENT) {
+    return;
+  }
+  if (!m_checking && tensor.Viewing()) {
+    return;
+  }
+
+  // Find the buffer of the data type and device
+  using BufferType = flat_buffer<TensorDataType>;
+  BufferType* buffer = nullptr;
+  for (auto& b : m_buffers) {
+    auto* typed = dynamic_cast<BufferType*>(b.get());
+    if (typed != nullptr && typed->get_device() == tensor.GetLocalDevice()) {
+      buffer = typed;
+      break;
+    }
+  }
+  if (m_checking) {
+    if (buffer == nullptr) {
+      m_check_failed = true;
+    }
+    else {
+      buffer->check(tensor);
+    }
+    return;
+  }
+  if (buffer == nullptr) {
+    m_buffers.emplace_back(
+      std::make_unique<BufferType>(tensor.GetLocalDevice()));
+    buffer = static_cast<BufferType*>(m_buffers.back().get());
+  }
+  buffer->add(tensor);
+}
+
+bool flat_weights_state::is_packed()
+{
+  m_checking = true;
+  m_check_failed = false;
+  for (auto& buffer : m_buffers) {
+    buffer->start_check();
+  }
+  for (auto* w : m_weights) {
+    w->add_to_flat_state(*this);
+  }
+  m_checking = false;
+  return (!m_check_failed &&
+          std::all_of(m_buffers.begin(), m_buffers.end(), [](auto const& b) {
+            return b->finish_check();
+          }));
+}
+
+size_t flat_weights_state::get_layout_hash() const
+{
+  size_t hash = m_buffers.size();
+  for (const auto& buffer : m_buffers) {
+    hash = hash_combine(hash, buffer->layout_hash());
+  }
+  return hash;
+}
+
+size_t flat_weights_state::get_local_bytes() const
+{
+  size_t bytes = 0;
+  for (const auto& buffer : m_buffers) {
+    bytes += buffer->local_bytes();
+  }
+  return bytes;
+}
+
+void flat_weights_state::sendrecv(lbann_comm& comm,
+                                  El::Int partner_rank_in_world,
+                                  bool half_precision)
+{
+  for (auto& buffer : m_buffers) {
+    buffer->sendrecv(comm, partner_rank_in_world, half_precision);
+  }
+}
+
+void flat_weights_state::copy_from(flat_weights_state const& source)
+{
+  if (source.get_layout_hash() != get_layout_hash()) {
+    LBANN_ERROR("flat weights states have different layouts");
+  }
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    m_buffers[i]->copy_from(*source.m_buffers[i]);
+  }
+}
+
+void flat_weights_state::start_sendrecv(flat_weights_state const& source,
+                                        lbann_comm& comm,
+                                        El::Int partner_rank_in_world)
+{
+  if (m_sendrecv_pending) {
+    LBANN_ERROR("flat weights state already has an exchange in progress");
+  }
+  if (source.get_layout_hash() != get_layout_hash()) {
+    LBANN_ERROR("flat weights states have different layouts");
+  }
+  for (size_t i = 0; i < m_buffers.size(); ++i) {
+    m_buffers[i]->start_sendrecv(*source.m_buffers[i],
+                                 comm,
+                                 partner_rank_in_world,
+                                 static_cast<int>(i));
+  }
+  m_sendrecv_pending = true;
+}
+
+void flat_weights_state::finish_sendrecv()
+{
+  for (auto& buffer : m_buffers) {
+    buffer->finish_sendrecv();
+  }
+  m_sendrecv_pending = false;
+}
+
+#define PROTO(T)                                                               \
+  template void flat_weights_state::add<T>(El::AbstractDistMatrix<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
@@ -270,11 +270,14 @@ description uniform_initializer<TensorDataType>::get_description() const
 template <typename TensorDataType>
 void uniform_initializer<TensorDataType>::fill(AbsDistMatrixType& matrix)
 {
-  uniform_fill(matrix,
-               matrix.Height(),
-               matrix.Width(),
-               (m_max + m_min) / El::To<TensorDataType>(2),
-               (m_max - m_min) / El::To<TensorDataType>(2));
+  // Each process draws its local entries on the matrix's device, so
+  // the values do not depend on the distribution
+  philox_uniform_fill(matrix,
+                      (m_max + m_min) / El::To<TensorDataType>(2),
+                      (m_max - m_min) / El::To<TensorDataType>(2),
+                      make_philox_stream(draw_philox_seed(matrix.Grid()),
+                                         0,
+                                         execution_mode::training));
 }
 
 template <typename TensorDataType>
@@ -298,11 +301,12 @@ description normal_initializer<TensorDataType>::get_description() const
 template <typename TensorDataType>
 void normal_initializer<TensorDataType>::fill(AbsDistMatrixType& matrix)
 {
-  gaussian_fill(matrix,
-                matrix.Height(),
-                matrix.Width(),
-                m_mean,
-                m_standard_deviation);
+  philox_gaussian_fill(matrix,
+                       m_mean,
+                       m_standard_deviation,
+                       make_philox_stream(draw_philox_seed(matrix.Grid()),
+                                          0,
+                                          execution_mode::training));
 }
 
 template <typename TensorDataType>
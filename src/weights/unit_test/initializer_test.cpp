@@ -0,0 +1,117 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/utils/random_number_generators.hpp>
+#include <lbann/weights/initializer.hpp>
+#include <lbann/weights/variance_scaling_initializers.hpp>
+
+namespace {
+
+using DataType = float;
+using StarStarMat =
+  El::DistMatrix<DataType, El::STAR, El::STAR, El::ELEMENT, El::Device::CPU>;
+using McMrMat =
+  El::DistMatrix<DataType, El::MC, El::MR, El::ELEMENT, El::Device::CPU>;
+
+/** Fill a replicated and a 2D-distributed matrix from the same
+ *  generator state and return both, replicated.
+ */
+void fill_both(lbann::data_type_weights_initializer<DataType>& init,
+               El::Grid const& g,
+               StarStarMat& replicated,
+               StarStarMat& distributed)
+{
+  El::Int const height = 13, width = 7;
+  replicated.SetGrid(g);
+  McMrMat mat(g);
+  replicated.Resize(height, width);
+  mat.Resize(height, width);
+
+  lbann::init_random(20231015);
+  init.fill(replicated);
+  lbann::init_random(20231015);
+  init.fill(mat);
+
+  distributed.SetGrid(g);
+  El::Copy(mat, distributed);
+}
+
+} // namespace
+
+TEST_CASE("Random initializers do not depend on the distribution",
+          "[mpi][weights][initializer]")
+{
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+  StarStarMat replicated, distributed;
+
+  SECTION("uniform")
+  {
+    lbann::uniform_initializer<DataType> init(-2.f, 3.f);
+    fill_both(init, g, replicated, distributed);
+    auto const& values = replicated.LockedMatrix();
+    for (El::Int j = 0; j < values.Width(); ++j) {
+      for (El::Int i = 0; i < values.Height(); ++i) {
+        CHECK(values(i, j) >= -2.f);
+        CHECK(values(i, j) <= 3.f);
+        CHECK(values(i, j) == distributed.LockedMatrix()(i, j));
+      }
+    }
+  }
+
+  SECTION("normal")
+  {
+    lbann::normal_initializer<DataType> init(1.f, 0.5f);
+    fill_both(init, g, replicated, distributed);
+    auto const& values = replicated.LockedMatrix();
+    for (El::Int j = 0; j < values.Width(); ++j) {
+      for (El::Int i = 0; i < values.Height(); ++i) {
+        CHECK(values(i, j) == distributed.LockedMatrix()(i, j));
+      }
+    }
+  }
+
+  SECTION("he normal")
+  {
+    lbann::he_initializer<DataType> init(
+      lbann::probability_distribution::gaussian);
+    init.set_fan_in(11);
+    init.set_fan_out(5);
+    fill_both(init, g, replicated, distributed);
+    auto const& values = replicated.LockedMatrix();
+    for (El::Int j = 0; j < values.Width(); ++j) {
+      for (El::Int i = 0; i < values.Height(); ++i) {
+        CHECK(values(i, j) == distributed.LockedMatrix()(i, j));
+      }
+    }
+  }
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "Catch2BasicSupport.hpp"
+
+#include "MPITestHelpers.hpp"
+#include "TestHelpers.hpp"
+
+#include <lbann/base.hpp>
+#include <lbann/weights/data_type_weights.hpp>
+#include <lbann/weights/initializer.hpp>
+#include <lbann/weights/weights_helpers.hpp>
+
+#include <cmath>
+#include <vector>
+
+TEST_CASE("Channelwise int8 quantization of weights",
+          "[mpi][weights][quantization]")
+{
+  using DataType = float;
+  using lbann::weights_details::quantize_channelwise_int8;
+  using lbann::weights_details::replicated_values;
+
+  auto& comm = unit_test::utilities::current_world_comm();
+  auto const& g = comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  // 2 x 3 matrix, stored column-major, with one channel per row
+  std::vector<DataType> const values = {1.0f, 0.3f, -0.5f, 0.01f, 0.25f, -2.0f};
+  lbann::data_type_weights<DataType> w(comm);
+  w.set_dims({2}, {3});
+  w.set_initializer(
+    std::make_unique<lbann::value_initializer<DataType>>(values));
+  w.setup();
+
+  auto const scale = quantize_channelwise_int8<DataType>(w, 2, false);
+  REQUIRE(scale.size() == 2);
+  CHECK(scale[0] == Approx(1.0 / 127));
+  CHECK(scale[1] == Approx(2.0 / 127));
+
+  SECTION("Values are on the grid and within half a step")
+  {
+    auto const q = replicated_values<DataType>(w);
+    for (El::Int j = 0; j < 3; ++j) {
+      for (El::Int i = 0; i < 2; ++i) {
+        const double x = q(i, j);
+        const double steps = x / scale[i];
+        CHECK(steps == Approx(std::round(steps)).margin(1e-3));
+        CHECK(std::abs(steps) <= 127.001);
+        CHECK(std::abs(x - values[i + 2 * j]) <= 0.5001 * scale[i]);
+      }
+    }
+    CHECK(q(0, 0) == Approx(1.0));
+    CHECK(q(1, 2) == Approx(-2.0));
+  }
+
+  SECTION("Quantizing again does not change the values")
+  {
+    auto const before = replicated_values<DataType>(w);
+    quantize_channelwise_int8<DataType>(w, 2, false);
+    auto const after = replicated_values<DataType>(w);
+    for (El::Int j = 0; j < 3; ++j) {
+      for (El::Int i = 0; i < 2; ++i) {
+        CHECK(after(i, j) == Approx(before(i, j)));
+      }
+    }
+  }
+
+  SECTION("Channels can index columns")
+  {
+    auto const column_scale = quantize_channelwise_int8<DataType>(w, 3, true);
+    CHECK(column_scale.size() == 3);
+    CHECK_THROWS(quantize_channelwise_int8<DataType>(w, 4, false));
+  }
+}
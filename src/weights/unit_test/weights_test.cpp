@@ -36,6 +36,7 @@
 #include <lbann/weights/data_type_weights.hpp>
 #include <lbann/weights/weights.hpp>
 #include <lbann/weights/weights_proxy.hpp>
+#include <lbann/weights/weights_snapshot.hpp>
 
 // Some convenience typedefs
 
@@ -138,6 +139,25 @@ TEST_CASE("Serializing weights", "[mpi][weights][serialize]")
       CHECK(IsValidPtr(dtw_tgt_ptr));
     }
   }
+
+  SECTION("Rooted binary archive with values by reference")
+  {
+    std::stringstream values_ss;
+    dtw_src.set_values_by_reference(true);
+    {
+      lbann::RootedBinaryOutputArchive oarchive(ss, g);
+      REQUIRE_NOTHROW(oarchive(dtw_src));
+    }
+    REQUIRE_NOTHROW(dtw_src.save_values(values_ss));
+    {
+      lbann::RootedBinaryInputArchive iarchive(ss, g);
+      REQUIRE_NOTHROW(iarchive(dtw_tgt));
+    }
+    CHECK(dtw_tgt.get_values().Height() == 0);
+    REQUIRE_NOTHROW(dtw_tgt.load_values(values_ss, /*parallel=*/false));
+    CHECK(dtw_tgt.get_values().Height() == El::Int(weights_height));
+    CHECK(dtw_tgt.get_values().Width() == El::Int(weights_width));
+  }
 #endif // LBANN_HAS_CEREAL_BINARY_ARCHIVES
 #ifdef LBANN_HAS_CEREAL_XML_ARCHIVES
   SECTION("XML archive")
@@ -171,3 +191,95 @@ TEST_CASE("Serializing weights", "[mpi][weights][serialize]")
   }
 #endif // LBANN_HAS_CEREAL_XML_ARCHIVES
 }
+
+TEST_CASE("Weights values versions", "[mpi][weights]")
+{
+  using DataType = float;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto dtw = make_weights<DataType>(world_comm, 3, 2);
+  dtw.setup();
+  auto const version = dtw.get_values_version();
+
+  SECTION("Const access keeps the version")
+  {
+    auto const& const_dtw = dtw;
+    (void)const_dtw.get_values();
+    CHECK(dtw.get_values_version() == version);
+  }
+
+  SECTION("Non-const access changes the version")
+  {
+    (void)dtw.get_values();
+    CHECK(dtw.get_values_version() != version);
+  }
+
+  SECTION("Versions are not shared by different weights")
+  {
+    auto other = make_weights<DataType>(world_comm, 3, 2);
+    other.setup();
+    CHECK(other.get_values_version() != version);
+  }
+}
+
+TEST_CASE("Weights snapshots", "[mpi][weights]")
+{
+  using DataType = float;
+
+  auto& world_comm = unit_test::utilities::current_world_comm();
+  auto const& g = world_comm.get_trainer_grid();
+  lbann::utils::grid_manager mgr(g);
+
+  auto dtw = make_weights<DataType>(world_comm, 3, 2);
+  dtw.setup();
+  std::vector<lbann::weights*> weights = {&dtw};
+
+  lbann::weights_snapshot snapshot(/*host=*/true);
+  CHECK(snapshot.empty());
+  REQUIRE_THROWS(snapshot.restore(weights));
+  snapshot.take(weights);
+  CHECK_FALSE(snapshot.empty());
+  CHECK(snapshot.get_local_bytes() ==
+        (dtw.get_values().LocalHeight() * dtw.get_values().LocalWidth() *
+         sizeof(DataType)));
+
+  SECTION("Restoring copies the values back")
+  {
+    El::Fill(dtw.get_values(), El::To<DataType>(4.f));
+    auto const version = dtw.get_values_version();
+    snapshot.restore(weights);
+    CHECK(dtw.get_values_version() != version);
+    auto const& local = dtw.get_values().LockedMatrix();
+    for (El::Int j = 0; j < local.Width(); ++j) {
+      for (El::Int i = 0; i < local.Height(); ++i) {
+        CHECK(local.Get(i, j) == El::To<DataType>(1.3));
+      }
+    }
+  }
+
+  SECTION("Restoring into other weights")
+  {
+    auto other = make_weights<DataType>(world_comm, 3, 2);
+    other.setup();
+    El::Fill(other.get_values(), El::To<DataType>(4.f));
+    std::vector<lbann::weights*> other_weights = {&other};
+    snapshot.restore(other_weights);
+    auto const& local = other.get_values().LockedMatrix();
+    for (El::Int j = 0; j < local.Width(); ++j) {
+      for (El::Int i = 0; i < local.Height(); ++i) {
+        CHECK(local.Get(i, j) == El::To<DataType>(1.3));
+      }
+    }
+  }
+
+  SECTION("Restoring into weights of another size fails")
+  {
+    auto other = make_weights<DataType>(world_comm, 5, 7);
+    other.setup();
+    std::vector<lbann::weights*> other_weights = {&other};
+    CHECK_THROWS(snapshot.restore(other_weights));
+  }
+}
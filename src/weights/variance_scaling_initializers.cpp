@@ -152,21 +152,23 @@ void variance_scaling_initializer<TensorDataType>::fill(
   // Get variance
   const auto& variance = get_variance(m_fan_in, m_fan_out);
 
-  // Fill matrix with values drawn from probability distribution
+  // Fill matrix with values drawn from probability distribution. Each
+  // process draws its local entries on the matrix's device.
+  const auto stream = make_philox_stream(draw_philox_seed(matrix.Grid()),
+                                         0,
+                                         execution_mode::training);
   switch (m_prob_dist) {
   case probability_distribution::gaussian:
-    gaussian_fill(matrix,
-                  matrix.Height(),
-                  matrix.Width(),
-                  TensorDataType(0.),
-                  El::Sqrt(variance));
+    philox_gaussian_fill(matrix,
+                         TensorDataType(0.),
+                         El::Sqrt(variance),
+                         stream);
     break;
   case probability_distribution::uniform:
-    uniform_fill(matrix,
-                 matrix.Height(),
-                 matrix.Width(),
-                 TensorDataType(0.),
-                 El::Sqrt(El::To<TensorDataType>(3) * variance));
+    philox_uniform_fill(matrix,
+                        TensorDataType(0.),
+                        El::Sqrt(El::To<TensorDataType>(3) * variance),
+                        stream);
     break;
   default:
     std::stringstream err;
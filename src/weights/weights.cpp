@@ -33,6 +33,7 @@
 #include "lbann/proto/layers.pb.h"
 
 #include <algorithm>
+#include <atomic>
 #include <sstream>
 #include <string>
 #include <utility>
@@ -62,11 +63,16 @@ std::string get_dims_string(const std::vector<size_t>& matrix_height_dims,
   return ss.str();
 }
 
+/** Source of weights values versions, shared by all weights objects */
+std::atomic<size_t> next_values_version{1};
+
 } // namespace
 
 weights::weights() : m_comm(nullptr), m_frozen(false)
 {
 
+  mark_values_modified();
+
   // Initialize weights name
   static int num_weights = 0;
   m_name = "weights" + std::to_string(num_weights);
@@ -85,6 +91,9 @@ template <typename ArchiveT>
 void weights::serialize(ArchiveT& ar)
 {
   ar(CEREAL_NVP(m_name), CEREAL_NVP(m_frozen));
+  if constexpr (utils::IsInputArchive<ArchiveT>) {
+    mark_values_modified();
+  }
 
   // What about:
   //   m_matrix_height_dims
@@ -92,6 +101,11 @@ void weights::serialize(ArchiveT& ar)
   //   m_matrix_dist
 }
 
+void weights::mark_values_modified()
+{
+  m_values_version = next_values_version++;
+}
+
 description weights::get_description() const
 {
   std::ostringstream ss;
@@ -112,6 +126,9 @@ description weights::get_description() const
   if (is_frozen()) {
     desc.add("Frozen");
   }
+  if (is_sharded()) {
+    desc.add("Sharded");
+  }
 
   // Derived class contribution
   do_augment_description_(desc);
@@ -0,0 +1,195 @@
+////////////////////////////////////////////////////////////////////////////////
+// Copyright (c) 2014-2023, Lawrence Livermore National Security, LLC.
+// Produced at the Lawrence Livermore National Laboratory.
+// Written by the LBANN Research Team (B. Van Essen, et al.) listed in
+// the CONTRIBUTORS file. <lbann-dev@llnl.gov>
+//
+// LLNL-CODE-697807.
+// All rights reserved.
+//
+// This file is part of LBANN: Livermore Big Artificial Neural Network
+// Toolkit. For details, see http://software.llnl.gov/LBANN or
+// https://github.com/LLNL/LBANN.
+//
+// Licensed under the Apache License, Version 2.0 (the "Licensee"); you
+// may not use this file except in compliance with the License.  You may
+// obtain a copy of the License at:
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or
+// implied. See the License for the specific language governing
+// permissions and limitations under the license.
+////////////////////////////////////////////////////////////////////////////////
+
+#include "lbann/weights/weights_snapshot.hpp"
+#include "lbann/utils/exception.hpp"
+#include "lbann/weights/weights.hpp"
+
+namespace lbann {
+
+class weights_snapshot::buffer_base
+{
+public:
+  virtual ~buffer_base() = default;
+  virtual size_t local_bytes() const = 0;
+  virtual bool on_device() const = 0;
+};
+
+namespace {
+
+/** @brief Copy of the local data of a tensor */
+template <typename TensorDataType>
+class snapshot_buffer final : public weights_snapshot::buffer_base
+{
+public:
+  using AbsDistMatType = El::AbstractDistMatrix<TensorDataType>;
+
+  explicit snapshot_buffer(El::Device device)
+  {
+    switch (device) {
+    case El::Device::CPU:
+      m_data = std::make_unique<El::Matrix<TensorDataType, El::Device::CPU>>();
+      break;
+#ifdef LBANN_HAS_GPU
+    case El::Device::GPU:
+      m_data = std::make_unique<El::Matrix<TensorDataType, El::Device::GPU>>();
+      break;
+#endif // LBANN_HAS_GPU
+    default:
+      LBANN_ERROR("invalid device");
+    }
+  }
+
+  bool matches(AbsDistMatType const& tensor) const
+  {
+    return (m_data->Height() == tensor.LocalHeight() &&
+            m_data->Width() == tensor.LocalWidth());
+  }
+
+  void take(AbsDistMatType const& tensor)
+  {
+    El::Copy(tensor.LockedMatrix(), *m_data);
+  }
+
+  void restore(AbsDistMatType& tensor) const
+  {
+    El::Copy(*m_data, tensor.Matrix());
+  }
+
+  size_t local_bytes() const override
+  {
+    return m_data->Height() * m_data->Width() * sizeof(TensorDataType);
+  }
+
+  bool on_device() const override
+  {
+    return m_data->GetDevice() != El::Device::CPU;
+  }
+
+private:
+  std::unique_ptr<El::AbstractMatrix<TensorDataType>> m_data;
+};
+
+} // namespace
+
+weights_snapshot::weights_snapshot(bool host) : m_host{host} {}
+
+weights_snapshot::~weights_snapshot() = default;
+
+void weights_snapshot::take(std::vector<weights*> const& weights,
+                            bool optimizer_state)
+{
+  m_optimizer_state = optimizer_state;
+  m_restoring = false;
+  m_next = 0;
+  for (auto* w : weights) {
+    w->add_to_snapshot(*this);
+  }
+  m_buffers.resize(m_next);
+  synchronize();
+  m_taken = true;
+}
+
+void weights_snapshot::restore(std::vector<weights*> const& weights)
+{
+  if (!m_taken) {
+    LBANN_ERROR("attempted to restore a weights snapshot before taking it");
+  }
+  m_restoring = true;
+  m_next = 0;
+  for (auto* w : weights) {
+    w->add_to_snapshot(*this);
+  }
+  m_restoring = false;
+  if (m_next != m_buffers.size()) {
+    LBANN_ERROR("weights snapshot has ",
+                m_buffers.size(),
+                " tensors, but it was restored into ",
+                m_next);
+  }
+  synchronize();
+}
+
+size_t weights_snapshot::get_local_bytes() const
+{
+  size_t bytes = 0;
+  for (const auto& buffer : m_buffers) {
+    bytes += buffer->local_bytes();
+  }
+  return bytes;
+}
+
+template <typename TensorDataType>
+void weights_snapshot::add(El::AbstractDistMatrix<TensorDataType>& tensor)
+{
+  using BufferType = snapshot_buffer<TensorDataType>;
+  const size_t i = m_next++;
+  auto* buffer = (i < m_buffers.size()
+                    ? dynamic_cast<BufferType*>(m_buffers[i].get())
+                    : nullptr);
+  if (m_restoring) {
+    if (buffer == nullptr || !buffer->matches(tensor)) {
+      LBANN_ERROR("tensor ",
+                  i,
+                  " does not match the weights snapshot it is restored from");
+    }
+    buffer->restore(tensor);
+    return;
+  }
+
+  // Reuse the buffer of the last snapshot if it has the same type
+  // and device, so the copy does not allocate
+  const auto device = (m_host ? El::Device::CPU : tensor.GetLocalDevice());
+  if (buffer == nullptr ||
+      buffer->on_device() != (device != El::Device::CPU)) {
+    auto new_buffer = std::make_unique<BufferType>(device);
+    buffer = new_buffer.get();
+    if (i < m_buffers.size()) {
+      m_buffers[i] = std::move(new_buffer);
+    }
+    else {
+      m_buffers.emplace_back(std::move(new_buffer));
+    }
+  }
+  buffer->take(tensor);
+}
+
+void weights_snapshot::synchronize() const
+{
+#ifdef LBANN_HAS_GPU
+  // Host buffers may also be copied to or from device tensors
+  hydrogen::gpu::SynchronizeDevice();
+#endif // LBANN_HAS_GPU
+}
+
+#define PROTO(T)                                                               \
+  template void weights_snapshot::add<T>(El::AbstractDistMatrix<T>&)
+
+#define LBANN_INSTANTIATE_CPU_HALF
+#define LBANN_INSTANTIATE_GPU_HALF
+#include "lbann/macros/instantiate.hpp"
+
+} // namespace lbann
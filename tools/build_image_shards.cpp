@@ -0,0 +1,120 @@
+// Packs the images of an image list ("<path> <label>" per line, as used by
+// the imagenet reader and partition_input_list) into shard files and writes
+// the index read by the image_shards data reader.
+//
+// Images are stored in list order; shuffle the list first (for example
+// with partition_input_list) so that each shard mixes the classes.
+
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+struct record {
+  unsigned long long offset;
+  unsigned long long size;
+  int label;
+};
+
+static string base_name(const string& path)
+{
+  const size_t pos = path.find_last_of('/');
+  return pos == string::npos ? path : path.substr(pos + 1);
+}
+
+static string shard_name(const string& basename, size_t shard)
+{
+  ostringstream ss;
+  ss << basename << '.' << setw(5) << setfill('0') << shard << ".shard";
+  return ss.str();
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 4) {
+    cout << "Usage .... exec image_list image_dir output_basename "
+            "[shard_size_mb (default 1024)]"
+         << endl;
+    exit(-1);
+  }
+
+  const string image_list = argv[1];
+  string image_dir = argv[2];
+  const string output_basename = argv[3];
+  const unsigned long long shard_size =
+    (argc > 4 ? atoll(argv[4]) : 1024ULL) * 1024 * 1024;
+  if (!image_dir.empty() && image_dir.back() != '/') {
+    image_dir += '/';
+  }
+
+  ifstream infile(image_list);
+  if (!infile) {
+    cout << "can't open image list : " << image_list << endl;
+    exit(1);
+  }
+
+  vector<pair<string, vector<record>>> shards;
+  ofstream shard_ofs;
+  unsigned long long shard_bytes = 0;
+  vector<char> buf;
+  string line;
+  size_t num_images = 0;
+  while (getline(infile, line)) {
+    const size_t pos = line.find_last_of(' ');
+    if (pos == string::npos) {
+      continue;
+    }
+    const string image = image_dir + line.substr(0, pos);
+    const int label = atoi(line.substr(pos + 1).c_str());
+
+    ifstream ifs(image, ios::binary);
+    if (!ifs) {
+      cout << "can't open image : " << image << endl;
+      exit(1);
+    }
+    buf.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+
+    // Start a new shard once the current one is full
+    if (shards.empty() ||
+        (shard_bytes > 0 && shard_bytes + buf.size() > shard_size)) {
+      const string name = shard_name(output_basename, shards.size());
+      shard_ofs.close();
+      shard_ofs.open(name, ios::binary);
+      if (!shard_ofs) {
+        cout << "can't open shard file : " << name << endl;
+        exit(1);
+      }
+      shards.emplace_back(base_name(name), vector<record>());
+      shard_bytes = 0;
+    }
+    shard_ofs.write(buf.data(), buf.size());
+    shards.back().second.push_back({shard_bytes, buf.size(), label});
+    shard_bytes += buf.size();
+    ++num_images;
+  }
+  shard_ofs.close();
+
+  const string index_file = output_basename + ".index";
+  ofstream index_ofs(index_file);
+  if (!index_ofs) {
+    cout << "can't open index file : " << index_file << endl;
+    exit(1);
+  }
+  index_ofs << "image_shards 1\n" << shards.size() << '\n';
+  for (const auto& shard : shards) {
+    index_ofs << shard.first << ' ' << shard.second.size() << '\n';
+    for (const auto& r : shard.second) {
+      index_ofs << r.offset << ' ' << r.size << ' ' << r.label << '\n';
+    }
+  }
+
+  cout << "Packed " << num_images << " images into " << shards.size()
+       << " shards; index: " << index_file << endl;
+  return 0;
+}
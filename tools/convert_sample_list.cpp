@@ -0,0 +1,318 @@
+// Converts a text sample list into the binary sample list that every
+// rank memory maps instead of parsing its slice of the text and then
+// gathering the slices of the other ranks.
+//
+// SINGLE-SAMPLE and inclusive multi-sample lists (MULTI-SAMPLE_INCLUSION,
+// MULTI-SAMPLE_INCLUSION_V2 and CONDUIT_HDF5_INCLUSION) are supported;
+// exclusive lists name the samples to skip, which can only be resolved
+// by opening the data files, so they are rejected. The sample list
+// directory and label file lines, and the per-file sample counts, are
+// kept. If every sample name is an integer, names are stored as int64
+// and "first ... last" ranges are expanded; otherwise they are stored
+// as strings, as written.
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Must match lbann::sample_list_binary_header
+struct sample_list_binary_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t num_files;
+  uint64_t num_samples;
+  uint64_t files_offset;
+  uint64_t samples_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t file_dir;
+  uint64_t file_dir_length;
+  uint64_t label_filename;
+  uint64_t label_filename_length;
+  uint64_t reserved[4];
+};
+static_assert(sizeof(sample_list_binary_header) == 128,
+              "unexpected header size");
+
+// Must match lbann::sample_list_binary_flags
+const uint32_t multi_sample = 1u;
+const uint32_t integral_names = 2u;
+const uint32_t unused_sample_fields = 4u;
+const uint32_t label_header = 8u;
+
+// Must match lbann::sample_list_binary_file
+struct sample_list_binary_file {
+  uint64_t name;
+  uint32_t name_length;
+  uint32_t reserved;
+  uint64_t first_sample;
+};
+
+// A sample is an integer value, or a string in the string table if
+// length is not integer_sample
+const uint64_t integer_sample = UINT64_MAX;
+struct sample_record {
+  uint64_t value;
+  uint64_t length;
+};
+
+static bool is_integer(const string& s)
+{
+  size_t i = (!s.empty() && s[0] == '-') ? 1 : 0;
+  if (i == s.size() || s.size() - i > 18) {
+    return false;
+  }
+  for (; i < s.size(); ++i) {
+    if (!isdigit(static_cast<unsigned char>(s[i]))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static uint64_t add_string(string& strings, const string& s)
+{
+  const uint64_t offset = strings.size();
+  strings += s;
+  return offset;
+}
+
+static string header_line(istream& in, const char* what)
+{
+  string line;
+  if (!getline(in, line) || line.empty()) {
+    cout << "missing " << what << " line in the sample list header" << endl;
+    exit(1);
+  }
+  return line;
+}
+
+static string first_token(const string& line)
+{
+  istringstream ss(line);
+  string token;
+  ss >> token;
+  return token;
+}
+
+static void write_padded(ofstream& out, const void* data, size_t size)
+{
+  static const char zeros[8] = {};
+  out.write(static_cast<const char*>(data), size);
+  out.write(zeros, (8 - size % 8) % 8);
+}
+
+int main(int argc, char** argv)
+{
+  if (argc != 3) {
+    cout << "Usage .... exec sample_list output_file" << endl;
+    exit(-1);
+  }
+
+  const string input = argv[1];
+  const string output_file = argv[2];
+  ifstream in(input);
+  if (!in) {
+    cout << "can't open sample list : " << input << endl;
+    exit(1);
+  }
+
+  sample_list_binary_header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "LBSMPLST", sizeof(h.magic));
+  h.version = 1;
+
+  string type = first_token(header_line(in, "sample list type"));
+  transform(type.begin(), type.end(), type.begin(), [](unsigned char c) {
+    return toupper(c);
+  });
+  if (type == "SINGLE-SAMPLE") {
+    h.flags = label_header;
+  }
+  else if (type == "MULTI-SAMPLE_INCLUSION") {
+    h.flags = multi_sample | unused_sample_fields | label_header;
+  }
+  else if (type == "MULTI-SAMPLE_INCLUSION_V2") {
+    h.flags = multi_sample;
+  }
+  else if (type == "CONDUIT_HDF5_INCLUSION") {
+    h.flags = multi_sample | unused_sample_fields;
+  }
+  else {
+    cout << "unsupported sample list type : " << type << endl;
+    exit(1);
+  }
+
+  size_t expected_samples = 0, expected_files = 0, excluded = 0;
+  {
+    istringstream ss(header_line(in, "sample count"));
+    if (h.flags & multi_sample) {
+      ss >> expected_samples;
+      if (h.flags & unused_sample_fields) {
+        ss >> excluded;
+      }
+    }
+    ss >> expected_files;
+    if (!(h.flags & multi_sample)) {
+      expected_samples = expected_files;
+    }
+  }
+  string strings;
+  const string file_dir = first_token(header_line(in, "data directory"));
+  h.file_dir = add_string(strings, file_dir);
+  h.file_dir_length = file_dir.size();
+  if (h.flags & label_header) {
+    const string label = first_token(header_line(in, "label file"));
+    h.label_filename = add_string(strings, label);
+    h.label_filename_length = label.size();
+  }
+
+  vector<sample_list_binary_file> files;
+  vector<sample_record> samples;
+  samples.reserve(expected_samples);
+  bool all_integers = true;
+  string line;
+  while (files.size() < expected_files && getline(in, line)) {
+    istringstream ss(line);
+    string filename;
+    if (!(ss >> filename)) {
+      continue;
+    }
+    sample_list_binary_file f = {};
+    f.name = add_string(strings, filename);
+    f.name_length = filename.size();
+    f.first_sample = samples.size();
+    files.push_back(f);
+    if (!(h.flags & multi_sample)) {
+      samples.push_back({files.size() - 1, integer_sample});
+      continue;
+    }
+
+    size_t included = 0, unused = 0;
+    ss >> included;
+    if (h.flags & unused_sample_fields) {
+      ss >> unused;
+    }
+    string name;
+    bool in_range = false;
+    while (ss >> name) {
+      if (name == "..." && !in_range && samples.size() > f.first_sample &&
+          samples.back().length == integer_sample) {
+        in_range = true;
+        continue;
+      }
+      if (in_range && is_integer(name)) {
+        const int64_t last = stoll(name);
+        for (int64_t v = static_cast<int64_t>(samples.back().value) + 1;
+             v <= last;
+             ++v) {
+          samples.push_back({static_cast<uint64_t>(v), integer_sample});
+        }
+        in_range = false;
+        continue;
+      }
+      if (in_range) {
+        cout << "sample range in " << filename << " does not end in an "
+             << "integer" << endl;
+        exit(1);
+      }
+      if (is_integer(name)) {
+        samples.push_back({static_cast<uint64_t>(stoll(name)),
+                           integer_sample});
+      }
+      else {
+        samples.push_back({add_string(strings, name), name.size()});
+        all_integers = false;
+      }
+    }
+    if (in_range) {
+      cout << "sample list terminated while in a range in " << filename
+           << endl;
+      exit(1);
+    }
+    if (samples.size() - f.first_sample != included) {
+      cout << "file " << filename << " lists "
+           << samples.size() - f.first_sample << " samples instead of "
+           << included << endl;
+      exit(1);
+    }
+  }
+  if (files.size() != expected_files ||
+      samples.size() != expected_samples) {
+    cout << "sample list has " << files.size() << " files and "
+         << samples.size() << " samples, but its header says "
+         << expected_files << " and " << expected_samples << endl;
+    exit(1);
+  }
+
+  // A single-sample list only names its files
+  if (!(h.flags & multi_sample)) {
+    all_integers = true;
+  }
+  else if (!all_integers) {
+    for (auto& s : samples) {
+      if (s.length == integer_sample) {
+        const string name = to_string(static_cast<int64_t>(s.value));
+        s = {add_string(strings, name), name.size()};
+      }
+    }
+  }
+  if (all_integers) {
+    h.flags |= integral_names;
+  }
+
+  h.num_files = files.size();
+  h.num_samples = samples.size();
+  sample_list_binary_file end = {};
+  end.first_sample = samples.size();
+  files.push_back(end);
+
+  const size_t sample_size = (all_integers ? sizeof(int64_t)
+                                           : sizeof(sample_record));
+  auto padded = [](size_t n) { return (n + 7) / 8 * 8; };
+  h.files_offset = sizeof(h);
+  h.samples_offset =
+    h.files_offset + padded(files.size() * sizeof(sample_list_binary_file));
+  h.strings_offset =
+    h.samples_offset + padded(samples.size() * sample_size);
+  h.strings_size = strings.size();
+
+  ofstream out(output_file, ios::binary);
+  if (!out) {
+    cout << "can't open output file : " << output_file << endl;
+    exit(1);
+  }
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  write_padded(out, files.data(), files.size() * sizeof(files[0]));
+  if (all_integers) {
+    vector<int64_t> values;
+    values.reserve(samples.size());
+    for (const auto& s : samples) {
+      values.push_back(static_cast<int64_t>(s.value));
+    }
+    write_padded(out, values.data(), values.size() * sizeof(int64_t));
+  }
+  else {
+    write_padded(out, samples.data(), samples.size() * sizeof(samples[0]));
+  }
+  out.write(strings.data(), strings.size());
+  out.close();
+  if (!out) {
+    cout << "failed writing " << output_file << endl;
+    exit(1);
+  }
+
+  cout << "wrote " << h.num_samples << " samples in " << h.num_files
+       << " files to " << output_file << endl;
+  return 0;
+}
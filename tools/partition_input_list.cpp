@@ -6,9 +6,112 @@
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <sstream>
+#include <tuple>
 
 using namespace std;
 
+/* Partitions a sample list into per-trainer sample lists, named as
+ * sample_list_per_trainer expects: t<trainer>_<name>.<ext> next to the
+ * output file <dir>/<name>.<ext>. Files are kept in order and split into
+ * contiguous runs of about the same number of samples, using the counts
+ * already in the list, so no data file is opened. This is how an
+ * existing list is re-partitioned for a different number of trainers.
+ */
+static int partition_sample_list(ifstream& infile,
+                                 const string& type_line,
+                                 const string& output_file,
+                                 int num_partition)
+{
+  string type;
+  istringstream(type_line) >> type;
+  transform(type.begin(), type.end(), type.begin(), ::toupper);
+  const bool multi_sample = (type != "SINGLE-SAMPLE");
+  const bool unused_fields = (type == "MULTI-SAMPLE_INCLUSION" ||
+                              type == "MULTI-SAMPLE_EXCLUSION" ||
+                              type == "CONDUIT_HDF5_INCLUSION" ||
+                              type == "CONDUIT_HDF5_EXCLUSION");
+  const bool label_line = (type == "SINGLE-SAMPLE" ||
+                           type == "MULTI-SAMPLE_INCLUSION" ||
+                           type == "MULTI-SAMPLE_EXCLUSION");
+
+  string counts_line, dir_line, label;
+  getline(infile, counts_line);
+  getline(infile, dir_line);
+  if (label_line) {
+    getline(infile, label);
+  }
+
+  // (line, included samples, excluded samples) per file
+  vector<tuple<string, size_t, size_t>> files;
+  size_t total = 0;
+  string line;
+  while (getline(infile, line)) {
+    istringstream ss(line);
+    string filename;
+    size_t included = 1, excluded = 0;
+    if (!(ss >> filename)) {
+      continue;
+    }
+    if (multi_sample) {
+      ss >> included;
+      if (unused_fields) {
+        ss >> excluded;
+      }
+    }
+    files.emplace_back(line, included, excluded);
+    total += included;
+  }
+
+  string dir, name;
+  const size_t slash = output_file.find_last_of('/');
+  dir = (slash == string::npos) ? string{} : output_file.substr(0, slash + 1);
+  name = output_file.substr(dir.size());
+
+  cout << "Partitioning " << files.size() << " files with " << total
+       << " samples into " << num_partition << " sample lists" << endl;
+  size_t f = 0;
+  size_t done = 0;
+  for (int p = 0; p < num_partition; p++) {
+    // Take files until this partition reaches its share of the samples
+    const size_t target = total * (p + 1) / num_partition;
+    const size_t first = f;
+    size_t included = 0, excluded = 0;
+    while (f < files.size() &&
+           (p + 1 == num_partition || done + get<1>(files[f]) <= target ||
+            f == first)) {
+      included += get<1>(files[f]);
+      excluded += get<2>(files[f]);
+      done += get<1>(files[f]);
+      ++f;
+    }
+
+    const string partition_file = dir + "t" + to_string(p) + "_" + name;
+    ofstream ofs(partition_file.c_str());
+    if (!ofs) {
+      cout << "can't open file : " << partition_file << endl;
+      exit(1);
+    }
+    ofs << type << '\n';
+    if (multi_sample) {
+      ofs << included << ' ';
+      if (unused_fields) {
+        ofs << excluded << ' ';
+      }
+    }
+    ofs << f - first << '\n' << dir_line << '\n';
+    if (label_line) {
+      ofs << label << '\n';
+    }
+    for (size_t i = first; i < f; ++i) {
+      ofs << get<0>(files[i]) << '\n';
+    }
+    cout << "Partitioned file name " << partition_file << ": " << f - first
+         << " files, " << included << " samples" << endl;
+  }
+  return 0;
+}
+
 int main( int argc, char** argv)
 {
   if(argc < 4) { 
@@ -21,6 +124,22 @@ int main( int argc, char** argv)
   int num_partition = atoi(argv[3]);
 
   std::ifstream infile(input_file);
+
+  // Sample lists start with their type
+  {
+    std::string first_line;
+    std::getline(infile, first_line);
+    std::string type;
+    std::istringstream(first_line) >> type;
+    std::transform(type.begin(), type.end(), type.begin(), ::toupper);
+    if (type == "SINGLE-SAMPLE" || type.rfind("MULTI-SAMPLE_", 0) == 0 ||
+        type.rfind("CONDUIT_HDF5_", 0) == 0) {
+      return partition_sample_list(infile, first_line, output_file,
+                                   num_partition);
+    }
+    infile.clear();
+    infile.seekg(0);
+  }
   std::vector<std::pair<std::string, int> > lines;
   std::string line;
   size_t pos;
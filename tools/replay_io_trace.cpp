@@ -0,0 +1,238 @@
+// Replays an I/O trace written by the monitor_io callback (trace_file),
+// so that a file system can be benchmarked with the access pattern of
+// a training run without running LBANN.
+//
+// Events are replayed in order of their start time. Each traced thread
+// is mapped to one of the replay threads (by default, as many as were
+// traced). An open event opens and closes the file, a read event reads
+// the same extent with pread (from the start of the file if its offset
+// was not known) and close events are skipped, since each replayed
+// open closes its file. With --timed, each event waits until its traced
+// start time; otherwise events are issued as fast as possible.
+//
+// Paths can be rewritten with --remap old_prefix:new_prefix to replay
+// against a copy of the data set.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using namespace std;
+
+// Must match lbann::io_trace_header
+struct io_trace_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_threads;
+  uint64_t num_files;
+  uint64_t num_events;
+  uint64_t files_offset;
+  uint64_t events_offset;
+  uint64_t reserved[2];
+};
+static_assert(sizeof(io_trace_header) == 64, "unexpected header size");
+
+// Must match lbann::io_trace_event
+struct io_trace_event {
+  double start;
+  float latency;
+  uint32_t file;
+  uint64_t offset;
+  uint64_t length;
+  uint32_t thread;
+  uint8_t op;
+  uint8_t reserved[3];
+};
+static_assert(sizeof(io_trace_event) == 40, "unexpected event size");
+
+// Must match lbann::io_trace_op
+const uint8_t op_open = 0;
+const uint8_t op_read = 1;
+const uint64_t unknown_offset = UINT64_MAX;
+
+struct replay_stats {
+  size_t ops = 0;
+  size_t failures = 0;
+  uint64_t bytes = 0;
+  double latency = 0.;
+  double traced_latency = 0.;
+};
+
+static double seconds_since(chrono::steady_clock::time_point t)
+{
+  return chrono::duration<double>(chrono::steady_clock::now() - t).count();
+}
+
+static bool replay_event(const io_trace_event& e,
+                         const string& file,
+                         vector<char>& buf)
+{
+  const int fd = open(file.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool ok = true;
+  if (e.op == op_read) {
+    buf.resize(max<size_t>(buf.size(), e.length));
+    const uint64_t begin = (e.offset == unknown_offset ? 0 : e.offset);
+    for (uint64_t done = 0; done < e.length;) {
+      const ssize_t n = pread(fd, buf.data(), e.length - done, begin + done);
+      if (n < 0 && errno == EINTR) {
+        continue;
+      }
+      if (n <= 0) {
+        ok = false;
+        break;
+      }
+      done += n;
+    }
+  }
+  close(fd);
+  return ok;
+}
+
+int main(int argc, char** argv)
+{
+  string input;
+  size_t num_threads = 0;
+  bool timed = false;
+  string remap_from, remap_to;
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if (arg == "--threads" && i + 1 < argc) {
+      num_threads = atol(argv[++i]);
+    }
+    else if (arg == "--timed") {
+      timed = true;
+    }
+    else if (arg == "--remap" && i + 1 < argc) {
+      const string remap = argv[++i];
+      const size_t colon = remap.find(':');
+      if (colon == string::npos) {
+        cout << "--remap takes old_prefix:new_prefix" << endl;
+        exit(1);
+      }
+      remap_from = remap.substr(0, colon);
+      remap_to = remap.substr(colon + 1);
+    }
+    else if (input.empty()) {
+      input = arg;
+    }
+    else {
+      input.clear();
+      break;
+    }
+  }
+  if (input.empty()) {
+    cout << "Usage .... exec [--threads N] [--timed] "
+            "[--remap old_prefix:new_prefix] trace_file"
+         << endl;
+    exit(-1);
+  }
+
+  ifstream in(input, ios::binary);
+  if (!in) {
+    cout << "can't open trace file : " << input << endl;
+    exit(1);
+  }
+  io_trace_header h;
+  in.read(reinterpret_cast<char*>(&h), sizeof(h));
+  if (!in || memcmp(h.magic, "LBIOTRCE", sizeof(h.magic)) != 0 ||
+      h.version != 1) {
+    cout << input << " is not a version 1 I/O trace" << endl;
+    exit(1);
+  }
+  vector<string> files(h.num_files);
+  in.seekg(h.files_offset);
+  for (auto& f : files) {
+    uint32_t length = 0;
+    in.read(reinterpret_cast<char*>(&length), sizeof(length));
+    f.resize(length);
+    in.read(&f[0], length);
+    if (!remap_from.empty() &&
+        f.compare(0, remap_from.size(), remap_from) == 0) {
+      f = remap_to + f.substr(remap_from.size());
+    }
+  }
+  vector<io_trace_event> events(h.num_events);
+  in.seekg(h.events_offset);
+  in.read(reinterpret_cast<char*>(events.data()),
+          events.size() * sizeof(io_trace_event));
+  if (!in) {
+    cout << "failed reading " << input << endl;
+    exit(1);
+  }
+  if (num_threads == 0) {
+    num_threads = max<size_t>(h.num_threads, 1);
+  }
+
+  vector<vector<size_t>> thread_events(num_threads);
+  for (size_t i = 0; i < events.size(); ++i) {
+    if (events[i].op == op_open || events[i].op == op_read) {
+      thread_events[events[i].thread % num_threads].push_back(i);
+    }
+  }
+
+  vector<replay_stats> stats(num_threads);
+  const auto begin = chrono::steady_clock::now();
+  vector<thread> threads;
+  for (size_t t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&, t]() {
+      vector<char> buf;
+      auto& s = stats[t];
+      for (const size_t i : thread_events[t]) {
+        const auto& e = events[i];
+        if (timed) {
+          const double wait = e.start - seconds_since(begin);
+          if (wait > 0.) {
+            this_thread::sleep_for(chrono::duration<double>(wait));
+          }
+        }
+        const auto start = chrono::steady_clock::now();
+        if (!replay_event(e, files[e.file], buf)) {
+          ++s.failures;
+        }
+        s.latency += seconds_since(start);
+        s.traced_latency += e.latency;
+        s.bytes += (e.op == op_read ? e.length : 0);
+        ++s.ops;
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  const double elapsed = seconds_since(begin);
+
+  replay_stats total;
+  for (const auto& s : stats) {
+    total.ops += s.ops;
+    total.failures += s.failures;
+    total.bytes += s.bytes;
+    total.latency += s.latency;
+    total.traced_latency += s.traced_latency;
+  }
+  const double ops = max<double>(total.ops, 1);
+  cout << "replayed " << total.ops << " operations on " << files.size()
+       << " files with " << num_threads << " threads in " << elapsed << "s"
+       << endl
+       << "read " << total.bytes << " bytes ("
+       << total.bytes / max(elapsed, 1.e-9) / 1.e6 << " MB/s)" << endl
+       << "mean latency " << 1.e3 * total.latency / ops << "ms (traced "
+       << 1.e3 * total.traced_latency / ops << "ms)" << endl;
+  if (total.failures > 0) {
+    cout << total.failures << " operations failed" << endl;
+    exit(1);
+  }
+  return 0;
+}
@@ -0,0 +1,206 @@
+// Encodes SMILES files into the pre-tokenized corpus read by the smiles
+// data reader when it is given a data_filename.
+//
+// Each non-empty line of an input file is one sample; the SMILES string
+// is the first field, ending at whitespace or a comma. Samples are encoded
+// as the reader's encode_smiles() does: <bos>, one token per character
+// (<unk> if it is not in the vocabulary), <eos>, then <pad> up to
+// sequence_length + 2 tokens. Longer strings are truncated.
+//
+// The vocabulary file has one "<token> <id>" pair per line and must
+// define <pad>, <unk>, <bos> and <eos>, as for the --vocab option.
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Must match lbann::smiles_token_header
+struct smiles_token_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t token_size;
+  uint64_t num_samples;
+  uint64_t row_width;
+  int32_t pad;
+  int32_t unk;
+  int32_t bos;
+  int32_t eos;
+  uint64_t reserved[2];
+};
+static_assert(sizeof(smiles_token_header) == 64, "unexpected header size");
+
+static bool is_delimiter(const char c)
+{
+  return isspace(static_cast<unsigned char>(c)) || c == ',';
+}
+
+static size_t field_length(const string& line)
+{
+  size_t n = 0;
+  while (n < line.size() && !is_delimiter(line[n])) {
+    ++n;
+  }
+  return n;
+}
+
+template <typename T>
+static void write_row(ofstream& out,
+                      const string& smiles,
+                      size_t length,
+                      const vector<int64_t>& vocab,
+                      const smiles_token_header& h,
+                      vector<T>& row)
+{
+  row.assign(h.row_width, static_cast<T>(h.pad));
+  row[0] = h.bos;
+  for (size_t j = 0; j < length; ++j) {
+    const int64_t id = vocab[static_cast<unsigned char>(smiles[j])];
+    row[j + 1] = static_cast<T>(id < 0 ? h.unk : id);
+  }
+  row[length + 1] = h.eos;
+  out.write(reinterpret_cast<const char*>(row.data()), row.size() * sizeof(T));
+}
+
+int main(int argc, char** argv)
+{
+  if (argc < 5) {
+    cout << "Usage .... exec vocab_file sequence_length output_file "
+            "smiles_file [smiles_file ...]"
+         << endl;
+    exit(-1);
+  }
+
+  const string vocab_file = argv[1];
+  const long sequence_length = atol(argv[2]);
+  const string output_file = argv[3];
+  const vector<string> inputs(argv + 4, argv + argc);
+  if (sequence_length <= 0) {
+    cout << "sequence_length must be positive" << endl;
+    exit(1);
+  }
+
+  // Read the vocabulary
+  ifstream vin(vocab_file);
+  if (!vin) {
+    cout << "can't open vocab file : " << vocab_file << endl;
+    exit(1);
+  }
+  smiles_token_header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, "LBSMITOK", sizeof(h.magic));
+  h.version = 1;
+  h.row_width = sequence_length + 2;
+  vector<int64_t> vocab(256, -1);
+  int64_t max_id = 0;
+  int found = 0;
+  string token;
+  int64_t id;
+  while (vin >> token >> id) {
+    if (id < 0) {
+      cout << "negative token id for " << token << endl;
+      exit(1);
+    }
+    max_id = max(max_id, id);
+    if (token.size() == 1) {
+      vocab[static_cast<unsigned char>(token[0])] = id;
+    }
+    int32_t* special = (token == "<pad>"   ? &h.pad
+                        : token == "<unk>" ? &h.unk
+                        : token == "<bos>" ? &h.bos
+                        : token == "<eos>" ? &h.eos
+                                           : nullptr);
+    if (special != nullptr) {
+      *special = id;
+      ++found;
+    }
+  }
+  if (found != 4) {
+    cout << "failed to find <pad>, <unk>, <bos> and <eos> in " << vocab_file
+         << endl;
+    exit(1);
+  }
+  h.token_size = (max_id <= UINT16_MAX ? 2 : 4);
+
+  // The lengths precede the rows, so count the samples first
+  string line;
+  for (const auto& input : inputs) {
+    ifstream in(input);
+    if (!in) {
+      cout << "can't open smiles file : " << input << endl;
+      exit(1);
+    }
+    while (getline(in, line)) {
+      if (field_length(line) > 0) {
+        ++h.num_samples;
+      }
+    }
+  }
+
+  ofstream out(output_file, ios::binary);
+  if (!out) {
+    cout << "can't open output file : " << output_file << endl;
+    exit(1);
+  }
+  out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+  // Placeholder for the lengths, which are written at the end
+  const vector<char> zeros(1 << 20, 0);
+  for (size_t left = h.num_samples * sizeof(uint32_t); left > 0;) {
+    const size_t n = min(left, zeros.size());
+    out.write(zeros.data(), n);
+    left -= n;
+  }
+
+  vector<uint32_t> lengths;
+  lengths.reserve(h.num_samples);
+  vector<uint16_t> row16;
+  vector<uint32_t> row32;
+  size_t num_truncated = 0;
+  for (const auto& input : inputs) {
+    ifstream in(input);
+    while (getline(in, line)) {
+      size_t length = field_length(line);
+      if (length == 0) {
+        continue;
+      }
+      if (length > static_cast<size_t>(sequence_length)) {
+        length = sequence_length;
+        ++num_truncated;
+      }
+      if (h.token_size == 2) {
+        write_row(out, line, length, vocab, h, row16);
+      }
+      else {
+        write_row(out, line, length, vocab, h, row32);
+      }
+      lengths.push_back(length + 2);
+    }
+  }
+  if (lengths.size() != h.num_samples) {
+    cout << "smiles files changed while they were read" << endl;
+    exit(1);
+  }
+
+  out.seekp(sizeof(h));
+  out.write(reinterpret_cast<const char*>(lengths.data()),
+            lengths.size() * sizeof(uint32_t));
+  out.close();
+  if (!out) {
+    cout << "failed writing " << output_file << endl;
+    exit(1);
+  }
+
+  cout << "wrote " << h.num_samples << " samples of " << h.row_width
+       << " tokens to " << output_file;
+  if (num_truncated > 0) {
+    cout << "; " << num_truncated << " were truncated";
+  }
+  cout << endl;
+  return 0;
+}